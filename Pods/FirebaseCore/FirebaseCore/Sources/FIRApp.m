@@ -41,6 +41,7 @@
 #import <GoogleUtilities/GULAppEnvironmentUtil.h>
 
 #import <objc/runtime.h>
+#import <os/signpost.h>
 
 // The kFIRService strings are only here while transitioning CoreDiagnostics from the Analytics
 // pod to a Core dependency. These symbols are not used and should be deleted after the transition.
@@ -135,6 +136,17 @@ static FIRApp *sDefaultApp;
                        @"from %@.",
                        kPlistURL];
   }
+  if (@available(iOS 12.0, macOS 10.14, tvOS 12.0, watchOS 5.0, *)) {
+    // Traced next to the Firestore startup phases when launched with the same argument.
+    if ([[NSProcessInfo processInfo].arguments containsObject:@"-FIRStartupTracingEnabled"]) {
+      os_log_t log = os_log_create("com.google.firebase.core", "Startup");
+      os_signpost_id_t signpostID = os_signpost_id_generate(log);
+      os_signpost_interval_begin(log, signpostID, "FirebaseApp configure");
+      [FIRApp configureWithOptions:options];
+      os_signpost_interval_end(log, signpostID, "FirebaseApp configure");
+      return;
+    }
+  }
   [FIRApp configureWithOptions:options];
 }
 
@@ -16,6 +16,7 @@
 
 #import "FIRDocumentSnapshot+Internal.h"
 
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -39,12 +40,12 @@
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
-#include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/exception.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/string_apple.h"
 
+using firebase::firestore::google_firestore_v1_MapValue;
 using firebase::firestore::google_firestore_v1_Value;
 using firebase::firestore::api::DocumentSnapshot;
 using firebase::firestore::api::Firestore;
@@ -56,8 +57,8 @@ using firebase::firestore::model::Document;
 using firebase::firestore::model::DocumentKey;
 using firebase::firestore::model::FieldPath;
 using firebase::firestore::model::ObjectValue;
-using firebase::firestore::remote::Serializer;
 using firebase::firestore::nanopb::MakeNSData;
+using firebase::firestore::nanopb::MakeStringView;
 using firebase::firestore::util::MakeNSString;
 using firebase::firestore::util::MakeString;
 using firebase::firestore::util::ThrowInvalidArgument;
@@ -65,17 +66,116 @@ using firebase::firestore::google_firestore_v1_Value;
 
 NS_ASSUME_NONNULL_BEGIN
 
+namespace {
+
+/** Stands in for fields that are absent from the document in the field value cache. */
+id MissingFieldMarker() {
+  static NSObject *marker = [[NSObject alloc] init];
+  return marker;
+}
+
+}  // namespace
+
+/**
+ * An immutable dictionary over the fields of a document that converts each field value to
+ * Foundation objects on first access, so that reading a few keys of the data of a large document
+ * doesn't convert all of it. Retains the snapshot, which owns the backing field values.
+ */
+@interface FSTLazyDocumentData : NSDictionary <NSString *, id>
+
+- (instancetype)initWithSnapshot:(const DocumentSnapshot &)snapshot
+                        mapValue:(const google_firestore_v1_MapValue &)mapValue
+                      dataWriter:(FSTUserDataWriter *)dataWriter;
+
+@end
+
+@implementation FSTLazyDocumentData {
+  DocumentSnapshot _snapshot;
+  google_firestore_v1_MapValue _mapValue;
+  FSTUserDataWriter *_dataWriter;
+
+  // Guarded by @synchronized(self), since immutable dictionaries may be read from any thread.
+  NSMutableDictionary<NSString *, id> *_convertedValues;
+  NSArray<NSString *> *_keys;
+}
+
+- (instancetype)initWithSnapshot:(const DocumentSnapshot &)snapshot
+                        mapValue:(const google_firestore_v1_MapValue &)mapValue
+                      dataWriter:(FSTUserDataWriter *)dataWriter {
+  if (self = [super init]) {
+    _snapshot = snapshot;
+    _mapValue = mapValue;
+    _dataWriter = dataWriter;
+  }
+  return self;
+}
+
+- (NSUInteger)count {
+  return _mapValue.fields_count;
+}
+
+- (nullable id)objectForKey:(id)key {
+  if (![key isKindOfClass:[NSString class]]) return nil;
+
+  @synchronized(self) {
+    id convertedValue = _convertedValues[key];
+    if (convertedValue) return convertedValue;
+
+    std::string fieldName = MakeString(key);
+    for (pb_size_t i = 0; i < _mapValue.fields_count; ++i) {
+      if (MakeStringView(_mapValue.fields[i].key) == fieldName) {
+        convertedValue = [_dataWriter convertedValue:_mapValue.fields[i].value];
+        if (!_convertedValues) {
+          _convertedValues = [NSMutableDictionary dictionary];
+        }
+        _convertedValues[key] = convertedValue;
+        return convertedValue;
+      }
+    }
+  }
+  return nil;
+}
+
+- (NSArray<NSString *> *)allKeys {
+  @synchronized(self) {
+    if (!_keys) {
+      NSMutableArray<NSString *> *keys = [NSMutableArray arrayWithCapacity:_mapValue.fields_count];
+      for (pb_size_t i = 0; i < _mapValue.fields_count; ++i) {
+        [keys addObject:MakeNSString(MakeStringView(_mapValue.fields[i].key))];
+      }
+      _keys = keys;
+    }
+    return _keys;
+  }
+}
+
+- (NSEnumerator<NSString *> *)keyEnumerator {
+  return [[self allKeys] objectEnumerator];
+}
+
+- (id)copyWithZone:(nullable NSZone *)zone {
+  return self;
+}
+
+@end
+
 @implementation FIRDocumentSnapshot {
   DocumentSnapshot _snapshot;
 
-  std::unique_ptr<Serializer> _serializer;
   FIRSnapshotMetadata *_cachedMetadata;
+
+  // Converted field values by server timestamp behavior and canonical field path. Fields are
+  // converted on first access, so reading a few fields of a large document only pays for those.
+  // Missing fields are stored as MissingFieldMarker(), since null field values convert to NSNull.
+  NSMutableDictionary<NSString *, id> *_cachedFieldValues;
+
+  // The data of the document by server timestamp behavior, handed out again by later `data` calls.
+  NSMutableDictionary<NSNumber *, NSDictionary<NSString *, id> *> *_cachedData;
 }
 
 - (instancetype)initWithSnapshot:(DocumentSnapshot &&)snapshot {
   if (self = [super init]) {
     _snapshot = std::move(snapshot);
-    _serializer.reset(new Serializer(_snapshot.firestore()->database_id()));
   }
   return self;
 }
@@ -92,7 +192,6 @@ NS_ASSUME_NONNULL_BEGIN
     wrapped = DocumentSnapshot::FromNoDocument(firestore.wrapped, std::move(documentKey),
                                                std::move(metadata));
   }
-  _serializer.reset(new Serializer(firestore.databaseID));
   return [self initWithSnapshot:std::move(wrapped)];
 }
 
@@ -153,13 +252,25 @@ NS_ASSUME_NONNULL_BEGIN
 
 - (nullable NSDictionary<NSString *, id> *)dataWithServerTimestampBehavior:
     (FIRServerTimestampBehavior)serverTimestampBehavior {
+  NSNumber *cacheKey = @(serverTimestampBehavior);
+  NSDictionary<NSString *, id> *cachedData = _cachedData[cacheKey];
+  if (cachedData) return cachedData;
+
   absl::optional<google_firestore_v1_Value> data = _snapshot.GetValue(FieldPath::EmptyPath());
   if (!data) return nil;
 
   FSTUserDataWriter *dataWriter =
       [[FSTUserDataWriter alloc] initWithFirestore:_snapshot.firestore()
                            serverTimestampBehavior:serverTimestampBehavior];
-  return [dataWriter convertedValue:*data];
+  NSDictionary<NSString *, id> *result =
+      [[FSTLazyDocumentData alloc] initWithSnapshot:_snapshot
+                                           mapValue:data->map_value
+                                         dataWriter:dataWriter];
+  if (!_cachedData) {
+    _cachedData = [NSMutableDictionary dictionary];
+  }
+  _cachedData[cacheKey] = result;
+  return result;
 }
 
 - (nullable id)valueForField:(id)field {
@@ -176,12 +287,29 @@ NS_ASSUME_NONNULL_BEGIN
   } else {
     ThrowInvalidArgument("Subscript key must be an NSString or FIRFieldPath.");
   }
+
+  NSString *cacheKey =
+      [NSString stringWithFormat:@"%ld:%s", static_cast<long>(serverTimestampBehavior),
+                                 fieldPath.CanonicalString().c_str()];
+  id cachedValue = _cachedFieldValues[cacheKey];
+  if (cachedValue) {
+    return cachedValue == MissingFieldMarker() ? nil : cachedValue;
+  }
+
+  id convertedValue = nil;
   absl::optional<google_firestore_v1_Value> fieldValue = _snapshot.GetValue(fieldPath);
-  if (!fieldValue) return nil;
-  FSTUserDataWriter *dataWriter =
-      [[FSTUserDataWriter alloc] initWithFirestore:_snapshot.firestore()
-                           serverTimestampBehavior:serverTimestampBehavior];
-  return [dataWriter convertedValue:*fieldValue];
+  if (fieldValue) {
+    FSTUserDataWriter *dataWriter =
+        [[FSTUserDataWriter alloc] initWithFirestore:_snapshot.firestore()
+                             serverTimestampBehavior:serverTimestampBehavior];
+    convertedValue = [dataWriter convertedValue:*fieldValue];
+  }
+
+  if (!_cachedFieldValues) {
+    _cachedFieldValues = [NSMutableDictionary dictionary];
+  }
+  _cachedFieldValues[cacheKey] = convertedValue ?: MissingFieldMarker();
+  return convertedValue;
 }
 
 - (nullable id)objectForKeyedSubscript:(id)key {
@@ -102,7 +102,9 @@ NS_ASSUME_NONNULL_BEGIN
         absl::StrAppend(&queue_name, ".", MakeString(self.app.name));
       }
 
-      auto executor = Executor::CreateSerial(queue_name.c_str());
+      // The worker queue raises snapshots, so it runs ahead of default work.
+      auto executor =
+          Executor::CreateSerial(queue_name.c_str(), Executor::Priority::kUserInitiated);
       auto workerQueue = AsyncQueue::Create(std::move(executor));
 
       id<FIRAuthInterop> auth = FIR_COMPONENT(FIRAuthInterop, self.app.container);
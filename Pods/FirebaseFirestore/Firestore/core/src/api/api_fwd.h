@@ -33,6 +33,7 @@ class Query;
 
 namespace api {
 
+class BulkWriter;
 class CollectionReference;
 class DocumentChange;
 class DocumentReference;
@@ -0,0 +1,78 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
+#define FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
+
+#include <memory>
+
+#include "Firestore/core/src/api/api_fwd.h"
+#include "Firestore/core/src/core/core_fwd.h"
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace api {
+
+/**
+ * Writes large numbers of documents independently of each other, each with
+ * its own result, for high-volume ingestion.
+ *
+ * Unlike `WriteBatch` the writes are neither atomic nor limited in number, and
+ * they are committed straight to the backend: they are not visible in the
+ * local cache until the backend sends them back, and they fail rather than
+ * wait while offline.
+ */
+class BulkWriter {
+ public:
+  explicit BulkWriter(std::shared_ptr<Firestore> firestore);
+
+  void SetData(const DocumentReference& reference,
+               core::ParsedSetData&& set_data,
+               util::StatusCallback callback);
+  void UpdateData(const DocumentReference& reference,
+                  core::ParsedUpdateData&& update_data,
+                  util::StatusCallback callback);
+  void DeleteData(const DocumentReference& reference,
+                  util::StatusCallback callback);
+
+  /**
+   * Notifies the callback once the writes scheduled so far have completed,
+   * with the writer's throughput so far.
+   */
+  void Flush(core::BulkWriterFlushCallback callback);
+
+  /** Flushes the writer; it can no longer be used afterwards. */
+  void Close(core::BulkWriterFlushCallback callback);
+
+  const std::shared_ptr<Firestore>& firestore() const {
+    return firestore_;
+  }
+
+ private:
+  std::shared_ptr<Firestore> firestore_;
+  std::shared_ptr<core::BulkWriter> bulk_writer_;
+  bool closed_ = false;
+
+  void VerifyNotClosed() const;
+  void ValidateReference(const DocumentReference& reference) const;
+};
+
+}  // namespace api
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_API_BULK_WRITER_H_
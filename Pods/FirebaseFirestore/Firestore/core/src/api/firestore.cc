@@ -18,12 +18,14 @@
 
 #include <utility>
 
+#include "Firestore/core/src/api/bulk_writer.h"
 #include "Firestore/core/src/api/collection_reference.h"
 #include "Firestore/core/src/api/document_reference.h"
 #include "Firestore/core/src/api/listener_registration.h"
 #include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/api/snapshots_in_sync_listener_registration.h"
 #include "Firestore/core/src/api/write_batch.h"
+#include "Firestore/core/src/bundle/bundle_reader.h"
 #include "Firestore/core/src/core/event_listener.h"
 #include "Firestore/core/src/core/firestore_client.h"
 #include "Firestore/core/src/core/query.h"
@@ -37,6 +39,7 @@
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/status.h"
 #include "absl/memory/memory.h"
 
@@ -150,6 +153,11 @@ WriteBatch Firestore::GetBatch() {
   return WriteBatch(shared_from_this());
 }
 
+BulkWriter Firestore::GetBulkWriter() {
+  EnsureClientConfigured();
+  return BulkWriter(shared_from_this());
+}
+
 core::Query Firestore::GetCollectionGroup(std::string collection_id) {
   EnsureClientConfigured();
 
@@ -252,12 +260,53 @@ std::shared_ptr<LoadBundleTask> Firestore::LoadBundle(
   return task;
 }
 
+std::shared_ptr<LoadBundleTask> Firestore::LoadBundle(
+    std::unique_ptr<util::ByteStream> bundle_data,
+    bundle::BundleFormat format) {
+  EnsureClientConfigured();
+
+  auto task = std::make_shared<LoadBundleTask>(user_executor_);
+  client_->LoadBundle(std::move(bundle_data), format, task);
+
+  return task;
+}
+
 void Firestore::GetNamedQuery(const std::string& name,
                               api::QueryCallback callback) {
   EnsureClientConfigured();
   client_->GetNamedQuery(name, std::move(callback));
 }
 
+util::MetricsSnapshot Firestore::GetMetrics() {
+  EnsureClientConfigured();
+  const std::shared_ptr<util::Metrics>& metrics = client_->metrics();
+  util::MetricsSnapshot result =
+      metrics ? metrics->Snapshot() : util::MetricsSnapshot{};
+  result.hash_tables = util::SampleHashTables();
+  result.cord_call_sites = util::SampleCordCallSites();
+  result.startup_phases = util::GetStartupTraceSummary();
+  return result;
+}
+
+void Firestore::ResetMetrics() {
+  EnsureClientConfigured();
+  if (client_->metrics()) {
+    client_->metrics()->Reset();
+  }
+}
+
+bool Firestore::SetHashTableSamplingEnabled(bool enabled) {
+  return util::SetHashTableSampling(enabled);
+}
+
+bool Firestore::SetCordSamplingInterval(int32_t mean_interval) {
+  return util::SetCordSampling(mean_interval);
+}
+
+void Firestore::SetStartupTracingEnabled(bool enabled) {
+  util::SetStartupTracingEnabled(enabled);
+}
+
 }  // namespace api
 }  // namespace firestore
 }  // namespace firebase
@@ -28,11 +28,16 @@
 #include "Firestore/core/src/credentials/credentials_fwd.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/util/byte_stream.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/status_fwd.h"
 
 namespace firebase {
 namespace firestore {
 
+namespace bundle {
+enum class BundleFormat;
+}  // namespace bundle
+
 namespace remote {
 class FirebaseMetadataProvider;
 }  // namespace remote
@@ -91,6 +96,7 @@ class Firestore : public std::enable_shared_from_this<Firestore> {
   CollectionReference GetCollection(const std::string& collection_path);
   DocumentReference GetDocument(const std::string& document_path);
   WriteBatch GetBatch();
+  BulkWriter GetBulkWriter();
   core::Query GetCollectionGroup(std::string collection_id);
 
   // TODO(dconeybe): Remove the default value of `max_attempts` once
@@ -110,8 +116,41 @@ class Firestore : public std::enable_shared_from_this<Firestore> {
 
   std::shared_ptr<api::LoadBundleTask> LoadBundle(
       std::unique_ptr<util::ByteStream> bundle_data);
+  std::shared_ptr<api::LoadBundleTask> LoadBundle(
+      std::unique_ptr<util::ByteStream> bundle_data,
+      bundle::BundleFormat format);
   void GetNamedQuery(const std::string& name, api::QueryCallback callback);
 
+  /**
+   * Returns the current values of the client's counters and latency
+   * histograms. All values are zero unless metrics are enabled in the
+   * settings.
+   */
+  util::MetricsSnapshot GetMetrics();
+
+  /** Sets all counters and histograms back to zero. */
+  void ResetMetrics();
+
+  /**
+   * Starts or stops sampling the process's hash tables into the `hash_tables`
+   * of `GetMetrics()`. Returns false if sampling isn't compiled in.
+   */
+  static bool SetHashTableSamplingEnabled(bool enabled);
+
+  /**
+   * Samples about one in `mean_interval` of the process's cords into the
+   * `cord_call_sites` of `GetMetrics()`, or none if zero. Returns false if
+   * sampling isn't compiled in.
+   */
+  static bool SetCordSamplingInterval(int32_t mean_interval);
+
+  /**
+   * Starts or stops tracing the phases of client startup into the
+   * `startup_phases` of `GetMetrics()`. Launching the app with
+   * `-FIRStartupTracingEnabled` also enables it, before any client starts.
+   */
+  static void SetStartupTracingEnabled(bool enabled);
+
   /**
    * Sets the language of the public API in the format of
    * "gl-<language>/<version>" where version might be blank, e.g. `gl-objc/`.
@@ -82,6 +82,7 @@ void LoadBundleTask::SetSuccess(LoadBundleTaskProgress success_progress) {
               "Calling SetSuccess() with a state that is not 'Success'");
   std::lock_guard<std::mutex> lock(mutex_);
 
+  UpdateRate(success_progress);
   progress_snapshot_ = success_progress;
   NotifyObservers();
 }
@@ -98,10 +99,24 @@ void LoadBundleTask::SetError(const util::Status& status) {
 void LoadBundleTask::UpdateProgress(LoadBundleTaskProgress progress) {
   std::lock_guard<std::mutex> lock(mutex_);
 
+  UpdateRate(progress);
   progress_snapshot_ = progress;
   NotifyObservers();
 }
 
+void LoadBundleTask::UpdateRate(LoadBundleTaskProgress& progress) {
+  auto now = std::chrono::steady_clock::now();
+  if (!start_time_.has_value()) {
+    start_time_ = now;
+  }
+
+  std::chrono::duration<double> elapsed = now - start_time_.value();
+  if (elapsed.count() > 0) {
+    progress.set_bytes_per_second(
+        static_cast<double>(progress.bytes_loaded()) / elapsed.count());
+  }
+}
+
 void LoadBundleTask::NotifyObservers() {
   for (const auto& entry : observers_) {
     const auto& observer = entry.second;
@@ -16,6 +16,7 @@
 #ifndef FIRESTORE_CORE_SRC_API_LOAD_BUNDLE_TASK_H_
 #define FIRESTORE_CORE_SRC_API_LOAD_BUNDLE_TASK_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <cstdint>
 #include <functional>
 #include <memory>
@@ -96,6 +97,19 @@ class LoadBundleTaskProgress {
     return total_bytes_;
   }
 
+  /**
+   * Returns the average rate at which the bundle has been loaded since the
+   * task started, in bytes per second. This is informational and not part of
+   * equality comparisons.
+   */
+  double bytes_per_second() const {
+    return bytes_per_second_;
+  }
+
+  void set_bytes_per_second(double bytes_per_second) {
+    bytes_per_second_ = bytes_per_second;
+  }
+
   /** Returns the current state of the task. */
   LoadBundleTaskState state() const {
     return state_;
@@ -118,6 +132,7 @@ class LoadBundleTaskProgress {
   uint32_t total_documents_ = 0;
   uint64_t bytes_loaded_ = 0;
   uint64_t total_bytes_ = 0;
+  double bytes_per_second_ = 0;
 
   LoadBundleTaskState state_ = LoadBundleTaskState::kInProgress;
   util::Status error_status_;
@@ -211,6 +226,9 @@ class LoadBundleTask {
   /** Notifies all observers with current `progress_snapshot_`. */
   void NotifyObservers();
 
+  /** Records the load rate of the given progress, starting the clock. */
+  void UpdateRate(LoadBundleTaskProgress& progress);
+
   LoadBundleHandle next_handle_ = 1;
 
   /** The executor to run all observers when notified. */
@@ -227,6 +245,9 @@ class LoadBundleTask {
 
   /** The last progress update. */
   LoadBundleTaskProgress progress_snapshot_;
+
+  /** When the first progress update was reported. */
+  absl::optional<std::chrono::steady_clock::time_point> start_time_;
 };
 
 }  // namespace api
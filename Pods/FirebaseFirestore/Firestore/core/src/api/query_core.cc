@@ -180,6 +180,25 @@ void Query::GetDocuments(Source source, QuerySnapshotListener&& callback) {
   listener_unowned->Resolve(std::move(registration));
 }
 
+void Query::Count(Source source, util::StatusOrCallback<int64_t>&& callback) {
+  ValidateHasExplicitOrderByForLimitToLast();
+  if (source == Source::Cache) {
+    firestore_->client()->CountDocumentsFromLocalCache(*this,
+                                                       std::move(callback));
+    return;
+  }
+
+  // TODO(c++14): move `callback` into lambda.
+  auto on_snapshot = [callback](StatusOr<QuerySnapshot> maybe_snapshot) {
+    if (!maybe_snapshot.ok()) {
+      callback(maybe_snapshot.status());
+      return;
+    }
+    callback(static_cast<int64_t>(maybe_snapshot.ValueOrDie().size()));
+  };
+  GetDocuments(source, EventListener<QuerySnapshot>::Create(on_snapshot));
+}
+
 std::unique_ptr<ListenerRegistration> Query::AddSnapshotListener(
     ListenOptions options, QuerySnapshotListener&& user_listener) {
   ValidateHasExplicitOrderByForLimitToLast();
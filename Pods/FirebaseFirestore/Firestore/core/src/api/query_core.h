@@ -26,6 +26,7 @@
 #include "Firestore/core/src/core/field_filter.h"
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/util/status_fwd.h"
 
 namespace firebase {
 namespace firestore {
@@ -67,6 +68,17 @@ class Query {
    */
   void GetDocuments(Source source, QuerySnapshotListener&& callback);
 
+  /**
+   * Counts the documents matching this query.
+   *
+   * With `Source::Cache` the count is computed by the local store, which
+   * avoids reading the documents when a field index serves the query.
+   * Otherwise the matching documents are fetched as by `GetDocuments`.
+   *
+   * @param callback a callback to execute with the number of documents.
+   */
+  void Count(Source source, util::StatusOrCallback<int64_t>&& callback);
+
   /**
    * Attaches a listener for QuerySnapshot events.
    *
@@ -27,16 +27,70 @@ constexpr bool Settings::DefaultSslEnabled;
 constexpr bool Settings::DefaultPersistenceEnabled;
 constexpr int64_t Settings::DefaultCacheSizeBytes;
 constexpr int64_t Settings::MinimumCacheSizeBytes;
+constexpr bool Settings::DefaultIndexAutoCreationEnabled;
+constexpr int64_t Settings::DefaultIndexBackfillDocumentsPerSecond;
+constexpr int64_t Settings::DefaultHotDocumentCacheSizeBytes;
+constexpr int64_t Settings::DefaultGcTimeBudgetMs;
+constexpr int64_t Settings::DefaultGroupCommitWindowMs;
+constexpr int64_t Settings::DefaultBundleDocumentsPerChunk;
+constexpr int64_t Settings::DefaultQueryResultCacheSize;
+constexpr bool Settings::DefaultSharedTargetsEnabled;
+constexpr int64_t Settings::DefaultLimboResolutionBatchSize;
+constexpr int64_t Settings::DefaultWritePipelineDepth;
+constexpr int64_t Settings::DefaultWriteRequestMaxBytes;
+constexpr bool Settings::DefaultTransactionReadReuseEnabled;
+constexpr int64_t Settings::DefaultCacheReadConcurrency;
+constexpr bool Settings::DefaultMetricsEnabled;
+constexpr bool Settings::DefaultFastReconnectEnabled;
+constexpr int64_t Settings::DefaultGrpcChannelCount;
+constexpr int64_t Settings::DefaultWriteCompressionThresholdBytes;
+constexpr bool Settings::DefaultAdaptiveBackoffEnabled;
+constexpr bool Settings::DefaultPrewarmEnabled;
 
 size_t Settings::Hash() const {
   return util::Hash(host_, ssl_enabled_, persistence_enabled_,
-                    cache_size_bytes_);
+                    cache_size_bytes_, index_auto_creation_enabled_,
+                    index_backfill_documents_per_second_,
+                    hot_document_cache_size_bytes_, gc_time_budget_ms_,
+                    group_commit_window_ms_, bundle_documents_per_chunk_,
+                    query_result_cache_size_, shared_targets_enabled_,
+                    limbo_resolution_batch_size_, write_pipeline_depth_,
+                    write_request_max_bytes_, transaction_read_reuse_enabled_,
+                    cache_read_concurrency_, metrics_enabled_,
+                    fast_reconnect_enabled_, grpc_channel_count_,
+                    write_compression_threshold_bytes_,
+                    adaptive_backoff_enabled_, prewarm_enabled_);
 }
 
 bool operator==(const Settings& lhs, const Settings& rhs) {
   return lhs.host_ == rhs.host_ && lhs.ssl_enabled_ == rhs.ssl_enabled_ &&
          lhs.persistence_enabled_ == rhs.persistence_enabled_ &&
-         lhs.cache_size_bytes_ == rhs.cache_size_bytes_;
+         lhs.cache_size_bytes_ == rhs.cache_size_bytes_ &&
+         lhs.index_auto_creation_enabled_ ==
+             rhs.index_auto_creation_enabled_ &&
+         lhs.index_backfill_documents_per_second_ ==
+             rhs.index_backfill_documents_per_second_ &&
+         lhs.hot_document_cache_size_bytes_ ==
+             rhs.hot_document_cache_size_bytes_ &&
+         lhs.gc_time_budget_ms_ == rhs.gc_time_budget_ms_ &&
+         lhs.group_commit_window_ms_ == rhs.group_commit_window_ms_ &&
+         lhs.bundle_documents_per_chunk_ == rhs.bundle_documents_per_chunk_ &&
+         lhs.query_result_cache_size_ == rhs.query_result_cache_size_ &&
+         lhs.shared_targets_enabled_ == rhs.shared_targets_enabled_ &&
+         lhs.limbo_resolution_batch_size_ ==
+             rhs.limbo_resolution_batch_size_ &&
+         lhs.write_pipeline_depth_ == rhs.write_pipeline_depth_ &&
+         lhs.write_request_max_bytes_ == rhs.write_request_max_bytes_ &&
+         lhs.transaction_read_reuse_enabled_ ==
+             rhs.transaction_read_reuse_enabled_ &&
+         lhs.cache_read_concurrency_ == rhs.cache_read_concurrency_ &&
+         lhs.metrics_enabled_ == rhs.metrics_enabled_ &&
+         lhs.fast_reconnect_enabled_ == rhs.fast_reconnect_enabled_ &&
+         lhs.grpc_channel_count_ == rhs.grpc_channel_count_ &&
+         lhs.write_compression_threshold_bytes_ ==
+             rhs.write_compression_threshold_bytes_ &&
+         lhs.adaptive_backoff_enabled_ == rhs.adaptive_backoff_enabled_ &&
+         lhs.prewarm_enabled_ == rhs.prewarm_enabled_;
 }
 
 }  // namespace api
@@ -40,6 +40,25 @@ class Settings {
   static constexpr int64_t DefaultCacheSizeBytes = 100 * 1024 * 1024;
   static constexpr int64_t MinimumCacheSizeBytes = 1 * 1024 * 1024;
   static constexpr int64_t CacheSizeUnlimited = -1;
+  static constexpr bool DefaultIndexAutoCreationEnabled = false;
+  static constexpr int64_t DefaultIndexBackfillDocumentsPerSecond = 500;
+  static constexpr int64_t DefaultHotDocumentCacheSizeBytes = 1 * 1024 * 1024;
+  static constexpr int64_t DefaultGcTimeBudgetMs = 0;
+  static constexpr int64_t DefaultGroupCommitWindowMs = 0;
+  static constexpr int64_t DefaultBundleDocumentsPerChunk = 0;
+  static constexpr int64_t DefaultQueryResultCacheSize = 0;
+  static constexpr bool DefaultSharedTargetsEnabled = false;
+  static constexpr int64_t DefaultLimboResolutionBatchSize = 0;
+  static constexpr int64_t DefaultWritePipelineDepth = 0;
+  static constexpr int64_t DefaultWriteRequestMaxBytes = 0;
+  static constexpr bool DefaultTransactionReadReuseEnabled = false;
+  static constexpr int64_t DefaultCacheReadConcurrency = 0;
+  static constexpr bool DefaultMetricsEnabled = false;
+  static constexpr bool DefaultFastReconnectEnabled = false;
+  static constexpr int64_t DefaultGrpcChannelCount = 1;
+  static constexpr int64_t DefaultWriteCompressionThresholdBytes = 0;
+  static constexpr bool DefaultAdaptiveBackoffEnabled = false;
+  static constexpr bool DefaultPrewarmEnabled = false;
 
   Settings() = default;
 
@@ -74,6 +93,232 @@ class Settings {
     return cache_size_bytes_ != CacheSizeUnlimited;
   }
 
+  /**
+   * Whether the client creates indexes for queries that repeatedly scan large
+   * parts of the local cache. Only takes effect with persistence enabled.
+   */
+  void set_index_auto_creation_enabled(bool value) {
+    index_auto_creation_enabled_ = value;
+  }
+  bool index_auto_creation_enabled() const {
+    return index_auto_creation_enabled_;
+  }
+
+  /**
+   * The maximum number of documents the background index backfill writes
+   * per second. Zero removes the limit.
+   */
+  void set_index_backfill_documents_per_second(int64_t value) {
+    index_backfill_documents_per_second_ = value;
+  }
+  int64_t index_backfill_documents_per_second() const {
+    return index_backfill_documents_per_second_;
+  }
+
+  /**
+   * The memory budget for decoded copies of recently read documents, kept in
+   * front of the persistent cache. Zero disables the in-memory copies.
+   */
+  void set_hot_document_cache_size_bytes(int64_t value) {
+    hot_document_cache_size_bytes_ = value;
+  }
+  int64_t hot_document_cache_size_bytes() const {
+    return hot_document_cache_size_bytes_;
+  }
+
+  /**
+   * The longest a single garbage collection turn may hold the worker queue.
+   * A positive budget spreads each collection over several short turns; zero
+   * collects in one pass.
+   */
+  void set_gc_time_budget_ms(int64_t value) {
+    gc_time_budget_ms_ = value;
+  }
+  int64_t gc_time_budget_ms() const {
+    return gc_time_budget_ms_;
+  }
+
+  /**
+   * How long the persistent cache may hold back writes of server state so
+   * that consecutive ones are written together. Local writes are never held
+   * back; zero writes everything immediately.
+   */
+  void set_group_commit_window_ms(int64_t value) {
+    group_commit_window_ms_ = value;
+  }
+  int64_t group_commit_window_ms() const {
+    return group_commit_window_ms_;
+  }
+
+  /**
+   * How many documents of a bundle are written to the cache at a time while
+   * the bundle is read. A positive value bounds the memory used to load large
+   * bundles; zero writes all documents once the whole bundle has been read.
+   */
+  void set_bundle_documents_per_chunk(int64_t value) {
+    bundle_documents_per_chunk_ = value;
+  }
+  int64_t bundle_documents_per_chunk() const {
+    return bundle_documents_per_chunk_;
+  }
+
+  /**
+   * How many recent query results the local store keeps to answer repeated
+   * reads of the same query from cache, until a change to the cache may
+   * affect them. Zero disables the query result cache.
+   */
+  void set_query_result_cache_size(int64_t value) {
+    query_result_cache_size_ = value;
+  }
+  int64_t query_result_cache_size() const {
+    return query_result_cache_size_;
+  }
+
+  /**
+   * Whether a query that only differs from an active listener's query by its
+   * limit, bounds or ordering is served from that listener's watch target
+   * instead of listening to the backend separately.
+   */
+  void set_shared_targets_enabled(bool value) {
+    shared_targets_enabled_ = value;
+  }
+  bool shared_targets_enabled() const {
+    return shared_targets_enabled_;
+  }
+
+  /**
+   * How many documents in limbo each limbo resolution target watches. Values
+   * above one resolve documents in batches, which speeds up resolving many
+   * documents after a large query reconnects; zero or one resolves each
+   * document with a target of its own.
+   */
+  void set_limbo_resolution_batch_size(int64_t value) {
+    limbo_resolution_batch_size_ = value;
+  }
+  int64_t limbo_resolution_batch_size() const {
+    return limbo_resolution_batch_size_;
+  }
+
+  /**
+   * How many mutation batches may await acknowledgement on the write stream
+   * at once. Zero uses the default of ten.
+   */
+  void set_write_pipeline_depth(int64_t value) {
+    write_pipeline_depth_ = value;
+  }
+  int64_t write_pipeline_depth() const {
+    return write_pipeline_depth_;
+  }
+
+  /**
+   * The size in bytes up to which consecutive small mutation batches share a
+   * single write request. Each batch is still acknowledged on its own. Zero
+   * sends every batch in a request of its own.
+   */
+  void set_write_request_max_bytes(int64_t value) {
+    write_request_max_bytes_ = value;
+  }
+  int64_t write_request_max_bytes() const {
+    return write_request_max_bytes_;
+  }
+
+  /**
+   * Whether a retried transaction reuses the reads of earlier attempts that
+   * didn't conflict and only fetches the contended documents again.
+   */
+  void set_transaction_read_reuse_enabled(bool value) {
+    transaction_read_reuse_enabled_ = value;
+  }
+  bool transaction_read_reuse_enabled() const {
+    return transaction_read_reuse_enabled_;
+  }
+
+  /**
+   * How many reads from the persistent cache may run at once on threads of
+   * their own, against snapshots, instead of on the worker queue. Zero runs
+   * them all on the worker queue.
+   */
+  void set_cache_read_concurrency(int64_t value) {
+    cache_read_concurrency_ = value;
+  }
+  int64_t cache_read_concurrency() const {
+    return cache_read_concurrency_;
+  }
+
+  /**
+   * Whether the client records counters and latency histograms of query
+   * execution, cache decoding, worker queue waits, the watch and write
+   * streams and garbage collection, readable through `Firestore::GetMetrics`.
+   */
+  void set_metrics_enabled(bool value) {
+    metrics_enabled_ = value;
+  }
+  bool metrics_enabled() const {
+    return metrics_enabled_;
+  }
+
+  /**
+   * Whether the watch stream re-sends the listen requests of all active
+   * queries together once it reconnects, and reconnects without backoff
+   * after failing shortly after the device's connectivity changed.
+   */
+  void set_fast_reconnect_enabled(bool value) {
+    fast_reconnect_enabled_ = value;
+  }
+  bool fast_reconnect_enabled() const {
+    return fast_reconnect_enabled_;
+  }
+
+  /**
+   * How many gRPC channels, each with a connection of its own, the client
+   * uses. With more than one, the watch and write streams keep a channel to
+   * themselves and other calls are spread over the rest, so that large reads
+   * do not delay them.
+   */
+  void set_grpc_channel_count(int64_t value) {
+    grpc_channel_count_ = value;
+  }
+  int64_t grpc_channel_count() const {
+    return grpc_channel_count_;
+  }
+
+  /**
+   * The size in bytes from which write requests are compressed with gzip.
+   * Compression trades CPU time for bandwidth, which pays off for large
+   * writes on slow or metered networks. Zero disables compression.
+   */
+  void set_write_compression_threshold_bytes(int64_t value) {
+    write_compression_threshold_bytes_ = value;
+  }
+  int64_t write_compression_threshold_bytes() const {
+    return write_compression_threshold_bytes_;
+  }
+
+  /**
+   * Whether the streams reconnect sooner after the device's connectivity
+   * changed and back off further while the backend is overloaded, instead of
+   * following a fixed backoff curve. The delays are reported as the
+   * `stream_backoff_millis` metric.
+   */
+  void set_adaptive_backoff_enabled(bool value) {
+    adaptive_backoff_enabled_ = value;
+  }
+  bool adaptive_backoff_enabled() const {
+    return adaptive_backoff_enabled_;
+  }
+
+  /**
+   * Whether the client starts connecting to the backend and fetching the
+   * credentials as soon as it starts, while the local cache opens, instead of
+   * when the first query or write needs them.
+   */
+  void set_prewarm_enabled(bool value) {
+    prewarm_enabled_ = value;
+  }
+  bool prewarm_enabled() const {
+    return prewarm_enabled_;
+  }
+
   friend bool operator==(const Settings& lhs, const Settings& rhs);
 
   size_t Hash() const;
@@ -83,6 +328,27 @@ class Settings {
   bool ssl_enabled_ = DefaultSslEnabled;
   bool persistence_enabled_ = DefaultPersistenceEnabled;
   int64_t cache_size_bytes_ = DefaultCacheSizeBytes;
+  bool index_auto_creation_enabled_ = DefaultIndexAutoCreationEnabled;
+  int64_t index_backfill_documents_per_second_ =
+      DefaultIndexBackfillDocumentsPerSecond;
+  int64_t hot_document_cache_size_bytes_ = DefaultHotDocumentCacheSizeBytes;
+  int64_t gc_time_budget_ms_ = DefaultGcTimeBudgetMs;
+  int64_t group_commit_window_ms_ = DefaultGroupCommitWindowMs;
+  int64_t bundle_documents_per_chunk_ = DefaultBundleDocumentsPerChunk;
+  int64_t query_result_cache_size_ = DefaultQueryResultCacheSize;
+  bool shared_targets_enabled_ = DefaultSharedTargetsEnabled;
+  int64_t limbo_resolution_batch_size_ = DefaultLimboResolutionBatchSize;
+  int64_t write_pipeline_depth_ = DefaultWritePipelineDepth;
+  int64_t write_request_max_bytes_ = DefaultWriteRequestMaxBytes;
+  bool transaction_read_reuse_enabled_ = DefaultTransactionReadReuseEnabled;
+  int64_t cache_read_concurrency_ = DefaultCacheReadConcurrency;
+  bool metrics_enabled_ = DefaultMetricsEnabled;
+  bool fast_reconnect_enabled_ = DefaultFastReconnectEnabled;
+  int64_t grpc_channel_count_ = DefaultGrpcChannelCount;
+  int64_t write_compression_threshold_bytes_ =
+      DefaultWriteCompressionThresholdBytes;
+  bool adaptive_backoff_enabled_ = DefaultAdaptiveBackoffEnabled;
+  bool prewarm_enabled_ = DefaultPrewarmEnabled;
 };
 
 }  // namespace api
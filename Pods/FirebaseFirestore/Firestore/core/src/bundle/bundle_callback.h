@@ -44,6 +44,14 @@ class BundleCallback {
       const model::MutableDocumentMap& documents,
       const std::string& bundle_id) = 0;
 
+  /**
+   * Applies further documents of a bundle whose first documents were applied
+   * by `ApplyBundledDocuments`, keeping those documents pinned as well.
+   */
+  virtual model::DocumentMap AppendBundledDocuments(
+      const model::MutableDocumentMap& documents,
+      const std::string& bundle_id) = 0;
+
   /** Saves the given NamedQuery to local persistence. */
   virtual void SaveNamedQuery(const NamedQuery& query,
                               const model::DocumentKeySet& keys) = 0;
@@ -38,6 +38,7 @@ using firestore::api::LoadBundleTaskState;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::MutableDocument;
+using model::MutableDocumentMap;
 using util::Status;
 using util::StatusOr;
 
@@ -55,7 +56,10 @@ Status BundleLoader::AddElementInternal(const BundleElement& element) {
       const auto& document_metadata =
           static_cast<const BundledDocumentMetadata&>(element);
       current_document_ = document_metadata.key();
-      documents_metadata_.emplace(document_metadata.key(), document_metadata);
+      for (const std::string& query : document_metadata.queries()) {
+        DocumentKeySet& keys = query_documents_[query];
+        keys = keys.insert(document_metadata.key());
+      }
 
       if (!document_metadata.exists()) {
         documents_ = documents_.insert(
@@ -110,11 +114,45 @@ StatusOr<absl::optional<LoadBundleTaskProgress>> BundleLoader::AddElement(
   }
 
   LoadBundleTaskProgress progress{
-      documents_.size(), metadata_.total_documents(), bytes_loaded_,
-      metadata_.total_bytes(), LoadBundleTaskState::kInProgress};
+      documents_applied_ + static_cast<uint32_t>(documents_.size()),
+      metadata_.total_documents(), bytes_loaded_, metadata_.total_bytes(),
+      LoadBundleTaskState::kInProgress};
+
+  if (documents_per_chunk_ > 0 && documents_.size() >= documents_per_chunk_) {
+    DocumentMap changes = ApplyDocuments();
+    if (!applied_changes_.has_value()) {
+      applied_changes_ = std::move(changes);
+    } else {
+      for (const auto& kv : changes) {
+        applied_changes_ = applied_changes_->insert(kv.first, kv.second);
+      }
+    }
+  }
+
   return {absl::make_optional(std::move(progress))};
 }
 
+absl::optional<DocumentMap> BundleLoader::TakeAppliedChanges() {
+  absl::optional<DocumentMap> result = std::move(applied_changes_);
+  applied_changes_ = absl::nullopt;
+  return result;
+}
+
+DocumentMap BundleLoader::ApplyDocuments() {
+  DocumentMap changes;
+  if (documents_applied_ == 0) {
+    changes =
+        callback_->ApplyBundledDocuments(documents_, metadata_.bundle_id());
+  } else if (!documents_.empty()) {
+    changes =
+        callback_->AppendBundledDocuments(documents_, metadata_.bundle_id());
+  }
+
+  documents_applied_ += static_cast<uint32_t>(documents_.size());
+  documents_ = MutableDocumentMap{};
+  return changes;
+}
+
 StatusOr<DocumentMap> BundleLoader::ApplyChanges() {
   if (current_document_ != absl::nullopt) {
     return StatusOr<DocumentMap>(
@@ -122,14 +160,13 @@ StatusOr<DocumentMap> BundleLoader::ApplyChanges() {
                "Bundled documents end with a document metadata "
                "element instead of a document."));
   }
-  if (metadata_.total_documents() != documents_.size()) {
+  if (metadata_.total_documents() != documents_applied_ + documents_.size()) {
     return StatusOr<DocumentMap>(
         Status(Error::kErrorInvalidArgument,
                "Loaded documents count is not the same as in metadata."));
   }
 
-  auto changes =
-      callback_->ApplyBundledDocuments(documents_, metadata_.bundle_id());
+  auto changes = ApplyDocuments();
   auto query_document_map = GetQueryDocumentMapping();
   for (const auto& named_query : queries_) {
     const auto& matching_keys = query_document_map[named_query.query_name()];
@@ -143,19 +180,10 @@ StatusOr<DocumentMap> BundleLoader::ApplyChanges() {
 
 std::unordered_map<std::string, DocumentKeySet>
 BundleLoader::GetQueryDocumentMapping() {
-  std::unordered_map<std::string, DocumentKeySet> result;
+  std::unordered_map<std::string, DocumentKeySet> result = query_documents_;
   for (const auto& named_query : queries_) {
     result.emplace(named_query.query_name(), DocumentKeySet{});
   }
-
-  for (const auto& doc_metadata : documents_metadata_) {
-    const auto& metadata = doc_metadata.second;
-    for (const auto& query : doc_metadata.second.queries()) {
-      auto inserted = result[query].insert(metadata.key());
-      result[query] = std::move(inserted);
-    }
-  }
-
   return result;
 }
 
@@ -59,6 +59,24 @@ class BundleLoader {
       : callback_(callback), metadata_(std::move(metadata)) {
   }
 
+  /**
+   * Creates a loader that applies the bundled documents to the callback in
+   * chunks of `documents_per_chunk` while the bundle is read, instead of
+   * holding all of them until `ApplyChanges`. Zero applies all documents at
+   * the end.
+   *
+   * Each chunk is committed on its own: if the bundle turns out to be invalid
+   * later, the documents applied so far stay in the cache, but the bundle is
+   * not recorded as loaded.
+   */
+  BundleLoader(BundleCallback* callback,
+               BundleMetadata metadata,
+               size_t documents_per_chunk)
+      : callback_(callback),
+        metadata_(std::move(metadata)),
+        documents_per_chunk_(documents_per_chunk) {
+  }
+
   /**
    * Adds an element from the bundle to the loader.
    *
@@ -69,9 +87,18 @@ class BundleLoader {
   AddElementResult AddElement(std::unique_ptr<BundleElement> element,
                               uint64_t byte_size);
 
+  /**
+   * Returns the document view changes of the chunks applied while adding
+   * elements since the last call, if any.
+   */
+  absl::optional<model::DocumentMap> TakeAppliedChanges();
+
   /**
    * Applies the loaded documents and queries to local store. Returns the
    * document view changes. If an error occurred, returns a not `ok()` status.
+   *
+   * When documents are applied in chunks, only the changes of the last chunk
+   * are returned; the others are returned by `TakeAppliedChanges`.
    */
   util::StatusOr<model::DocumentMap> ApplyChanges();
 
@@ -89,15 +116,20 @@ class BundleLoader {
    */
   util::Status AddElementInternal(const BundleElement& element);
 
+  /** Applies the documents loaded since the last chunk, if any. */
+  model::DocumentMap ApplyDocuments();
+
   BundleCallback* callback_ = nullptr;
   BundleMetadata metadata_;
+  size_t documents_per_chunk_ = 0;
   std::vector<NamedQuery> queries_;
-  std::unordered_map<model::DocumentKey,
-                     BundledDocumentMetadata,
-                     model::DocumentKeyHash>
-      documents_metadata_;
+  std::unordered_map<std::string, model::DocumentKeySet> query_documents_;
   model::MutableDocumentMap documents_;
 
+  // Documents of earlier chunks that have already been applied.
+  uint32_t documents_applied_ = 0;
+  absl::optional<model::DocumentMap> applied_changes_;
+
   uint64_t bytes_loaded_ = 0;
   absl::optional<model::DocumentKey> current_document_;
 };
@@ -18,6 +18,8 @@
 
 #include <algorithm>
 
+#include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/numbers.h"
 #include "absl/strings/string_view.h"
@@ -26,6 +28,8 @@ namespace firebase {
 namespace firestore {
 namespace bundle {
 
+using nanopb::Message;
+using nanopb::StringReader;
 using nlohmann::json;
 using util::ByteStream;
 using util::StreamReadResult;
@@ -37,6 +41,9 @@ json Parse(absl::string_view s) {
                      /*allow_exceptions=*/false);
 }
 
+// A varint encoding a 64-bit length takes at most 10 bytes.
+const size_t kMaxVarintLength = 10;
+
 }  // namespace
 
 BundleReader::BundleReader(BundleSerializer serializer,
@@ -44,6 +51,14 @@ BundleReader::BundleReader(BundleSerializer serializer,
     : serializer_(std::move(serializer)), input_(std::move(input)) {
 }
 
+BundleReader::BundleReader(BundleSerializer serializer,
+                           std::unique_ptr<ByteStream> input,
+                           BundleFormat format)
+    : serializer_(std::move(serializer)),
+      format_(format),
+      input_(std::move(input)) {
+}
+
 BundleMetadata BundleReader::GetBundleMetadata() {
   if (metadata_loaded_) {
     return metadata_;
@@ -68,6 +83,26 @@ std::unique_ptr<BundleElement> BundleReader::GetNextElement() {
 }
 
 std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
+  if (format_ == BundleFormat::kProto) {
+    std::string prefix;
+    absl::optional<size_t> length = ReadVarintLengthPrefix(prefix);
+    if (!length.has_value()) {
+      return nullptr;
+    }
+
+    buffer_.clear();
+    ReadToBuffer(length.value());
+    if (!reader_status_.ok()) {
+      return nullptr;
+    }
+
+    // metadata's size does not count in `bytes_read_`.
+    if (metadata_loaded_) {
+      bytes_read_ += prefix.size() + buffer_.size();
+    }
+    return DecodeBundleElementFromProtoBuffer();
+  }
+
   auto length_prefix = ReadLengthPrefix();
   if (!length_prefix.has_value()) {
     return nullptr;
@@ -81,7 +116,7 @@ std::unique_ptr<BundleElement> BundleReader::ReadNextElement() {
   }
 
   buffer_.clear();
-  ReadJsonToBuffer(prefix_value);
+  ReadToBuffer(prefix_value);
   if (!reader_status_.ok()) {
     return nullptr;
   }
@@ -114,7 +149,37 @@ absl::optional<std::string> BundleReader::ReadLengthPrefix() {
   return absl::make_optional(std::move(result).ValueOrDie());
 }
 
-void BundleReader::ReadJsonToBuffer(size_t required_size) {
+absl::optional<size_t> BundleReader::ReadVarintLengthPrefix(
+    std::string& prefix) {
+  uint64_t length = 0;
+  for (size_t i = 0; i < kMaxVarintLength; ++i) {
+    StreamReadResult result = input_->Read(1);
+    if (!result.ok()) {
+      reader_status_.Update(result.status());
+      return absl::nullopt;
+    }
+
+    if (result.ValueOrDie().empty()) {
+      // The end of the stream between elements ends the bundle.
+      if (i != 0) {
+        Fail("Bundle ends within a length prefix");
+      }
+      return absl::nullopt;
+    }
+
+    auto byte = static_cast<uint8_t>(result.ValueOrDie()[0]);
+    prefix.push_back(static_cast<char>(byte));
+    length |= static_cast<uint64_t>(byte & 0x7f) << (7 * i);
+    if ((byte & 0x80) == 0) {
+      return static_cast<size_t>(length);
+    }
+  }
+
+  Fail("Prefix is not a valid varint");
+  return absl::nullopt;
+}
+
+void BundleReader::ReadToBuffer(size_t required_size) {
   if (!reader_status_.ok()) {
     return;
   }
@@ -166,6 +231,43 @@ std::unique_ptr<BundleElement> BundleReader::DecodeBundleElementFromBuffer() {
   }
 }
 
+std::unique_ptr<BundleElement>
+BundleReader::DecodeBundleElementFromProtoBuffer() {
+  StringReader reader{buffer_};
+  auto element = Message<firestore_BundleElement>::TryParse(&reader);
+  if (!reader.ok()) {
+    Fail("Failed to parse bundle element proto");
+    return nullptr;
+  }
+
+  std::unique_ptr<BundleElement> result;
+  switch (element->which_element_type) {
+    case firestore_BundleElement_metadata_tag:
+      result = absl::make_unique<BundleMetadata>(
+          serializer_.DecodeBundleMetadata(reader, element->metadata));
+      break;
+    case firestore_BundleElement_named_query_tag:
+      result = absl::make_unique<NamedQuery>(
+          serializer_.DecodeNamedQuery(reader, element->named_query));
+      break;
+    case firestore_BundleElement_document_metadata_tag:
+      result = absl::make_unique<BundledDocumentMetadata>(
+          serializer_.DecodeDocumentMetadata(reader,
+                                             element->document_metadata));
+      break;
+    case firestore_BundleElement_document_tag:
+      result = absl::make_unique<BundleDocument>(
+          serializer_.DecodeDocument(reader, element->document));
+      break;
+    default:
+      Fail("Unrecognized BundleElement");
+      return nullptr;
+  }
+
+  reader_status_.Update(reader.status());
+  return result;
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
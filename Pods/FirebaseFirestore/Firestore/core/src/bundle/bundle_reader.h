@@ -30,8 +30,20 @@ namespace firebase {
 namespace firestore {
 namespace bundle {
 
+/** The encodings a bundle stream can use. */
+enum class BundleFormat {
+  /** Each element is a decimal length followed by a JSON object. */
+  kJson,
+
+  /**
+   * Each element is a varint length followed by a serialized
+   * `firestore.BundleElement` proto, as written by `writeDelimitedTo`.
+   */
+  kProto,
+};
+
 /**
- * Reads the length-prefixed JSON stream for Bundles.
+ * Reads the length-prefixed JSON or proto stream for Bundles.
  *
  * The class takes a bundle stream and presents abstractions to read bundled
  * elements out of the underlying content.
@@ -41,6 +53,10 @@ class BundleReader {
   BundleReader(BundleSerializer serializer,
                std::unique_ptr<util::ByteStream> input);
 
+  BundleReader(BundleSerializer serializer,
+               std::unique_ptr<util::ByteStream> input,
+               BundleFormat format);
+
   /**
    * Returns the metadata element from the bundle.
    *
@@ -97,10 +113,17 @@ class BundleReader {
    */
   absl::optional<std::string> ReadLengthPrefix();
 
+  /**
+   * Reads the varint length prefix of a proto element. Returns `nullopt` when
+   * at the end of stream or on failure; the prefix bytes are appended to
+   * `prefix`.
+   */
+  absl::optional<size_t> ReadVarintLengthPrefix(std::string& prefix);
+
   /**
    * Reads `required_size` number of chars from stream into internal `buffer_`.
    */
-  void ReadJsonToBuffer(size_t required_size);
+  void ReadToBuffer(size_t required_size);
 
   /**
    * Decodes internal `buffer_` into a `BundleElement`, returned as a unique_ptr
@@ -110,7 +133,11 @@ class BundleReader {
    */
   std::unique_ptr<BundleElement> DecodeBundleElementFromBuffer();
 
+  /** Like `DecodeBundleElementFromBuffer`, for proto elements. */
+  std::unique_ptr<BundleElement> DecodeBundleElementFromProtoBuffer();
+
   BundleSerializer serializer_;
+  BundleFormat format_ = BundleFormat::kJson;
   JsonReader json_reader_;
 
   // Input stream holding bundle data.
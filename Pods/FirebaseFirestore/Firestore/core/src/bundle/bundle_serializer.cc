@@ -855,6 +855,72 @@ BundleDocument BundleSerializer::DecodeDocument(JsonReader& reader,
       ObjectValue::FromMapValue(std::move(map_value))));
 }
 
+// Mark: Binary bundles
+
+BundleMetadata BundleSerializer::DecodeBundleMetadata(
+    nanopb::Reader& reader, const firestore_BundleMetadata& metadata) const {
+  return BundleMetadata(
+      rpc_serializer_.DecodeString(metadata.id), metadata.version,
+      rpc_serializer_.DecodeVersion(reader.context(), metadata.create_time),
+      metadata.total_documents, metadata.total_bytes);
+}
+
+NamedQuery BundleSerializer::DecodeNamedQuery(
+    nanopb::Reader& reader, firestore_NamedQuery& named_query) const {
+  firestore_BundledQuery& query = named_query.bundled_query;
+  // The QueryTarget oneof only has a single valid value.
+  if (query.which_query_type != firestore_BundledQuery_structured_query_tag) {
+    reader.Fail(
+        StringFormat("Unknown bundled query_type: %s", query.which_query_type));
+    return {};
+  }
+
+  LimitType limit_type =
+      query.limit_type == firestore_BundledQuery_LimitType_LAST
+          ? LimitType::Last
+          : LimitType::First;
+  Target target = rpc_serializer_.DecodeStructuredQuery(
+      reader.context(), query.parent, query.structured_query);
+
+  return NamedQuery(
+      rpc_serializer_.DecodeString(named_query.name),
+      BundledQuery(std::move(target), limit_type),
+      rpc_serializer_.DecodeVersion(reader.context(), named_query.read_time));
+}
+
+BundledDocumentMetadata BundleSerializer::DecodeDocumentMetadata(
+    nanopb::Reader& reader,
+    const firestore_BundledDocumentMetadata& document_metadata) const {
+  DocumentKey key =
+      rpc_serializer_.DecodeKey(reader.context(), document_metadata.name);
+  SnapshotVersion read_time = rpc_serializer_.DecodeVersion(
+      reader.context(), document_metadata.read_time);
+
+  std::vector<std::string> queries;
+  queries.reserve(document_metadata.queries_count);
+  for (pb_size_t i = 0; i < document_metadata.queries_count; ++i) {
+    queries.push_back(
+        rpc_serializer_.DecodeString(document_metadata.queries[i]));
+  }
+
+  return BundledDocumentMetadata(std::move(key), read_time,
+                                 document_metadata.exists, std::move(queries));
+}
+
+BundleDocument BundleSerializer::DecodeDocument(
+    nanopb::Reader& reader, google_firestore_v1_Document& document) const {
+  DocumentKey key = rpc_serializer_.DecodeKey(reader.context(), document.name);
+  SnapshotVersion update_time =
+      rpc_serializer_.DecodeVersion(reader.context(), document.update_time);
+  if (!reader.ok()) {
+    return {};
+  }
+
+  return BundleDocument(MutableDocument::FoundDocument(
+      std::move(key), update_time,
+      ObjectValue::FromFieldsEntry(document.fields, document.fields_count)));
+}
+
 }  // namespace bundle
 }  // namespace firestore
 }  // namespace firebase
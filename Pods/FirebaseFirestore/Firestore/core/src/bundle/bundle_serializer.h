@@ -21,6 +21,7 @@
 #include <utility>
 #include <vector>
 
+#include "Firestore/Protos/nanopb/firestore/bundle.nanopb.h"
 #include "Firestore/core/src/bundle/bundle_document.h"
 #include "Firestore/core/src/bundle/bundle_metadata.h"
 #include "Firestore/core/src/bundle/bundled_document_metadata.h"
@@ -29,6 +30,7 @@
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/nanopb/message.h"
+#include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/remote/serializer.h"
 #include "Firestore/core/src/util/read_context.h"
 #include "Firestore/third_party/nlohmann_json/json.hpp"
@@ -92,7 +94,10 @@ class JsonReader : public util::ReadContext {
   double DecodeDouble(const nlohmann::json& value);
 };
 
-/** A JSON serializer to deserialize Firestore Bundles. */
+/**
+ * A serializer to deserialize Firestore Bundles, either from their JSON form
+ * or from the binary form which holds `firestore_BundleElement` protos.
+ */
 class BundleSerializer {
  public:
   explicit BundleSerializer(remote::Serializer serializer)
@@ -110,6 +115,27 @@ class BundleSerializer {
   BundleDocument DecodeDocument(JsonReader& reader,
                                 const nlohmann::json& document) const;
 
+  BundleMetadata DecodeBundleMetadata(
+      nanopb::Reader& reader, const firestore_BundleMetadata& metadata) const;
+
+  /**
+   * Decodes the named query. Modifies the provided proto to release ownership
+   * of any Value messages.
+   */
+  NamedQuery DecodeNamedQuery(nanopb::Reader& reader,
+                              firestore_NamedQuery& named_query) const;
+
+  BundledDocumentMetadata DecodeDocumentMetadata(
+      nanopb::Reader& reader,
+      const firestore_BundledDocumentMetadata& document_metadata) const;
+
+  /**
+   * Decodes the document. Modifies the provided proto to release ownership of
+   * its fields.
+   */
+  BundleDocument DecodeDocument(nanopb::Reader& reader,
+                                google_firestore_v1_Document& document) const;
+
  private:
   BundledQuery DecodeBundledQuery(JsonReader& reader,
                                   const nlohmann::json& query) const;
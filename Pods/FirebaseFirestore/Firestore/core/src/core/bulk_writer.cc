@@ -0,0 +1,287 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/bulk_writer.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Firestore/core/src/remote/datastore.h"
+#include "Firestore/core/src/remote/remote_store.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+namespace {
+
+using remote::Datastore;
+using remote::RemoteStore;
+using util::AsyncQueue;
+using util::Status;
+using util::StatusCallback;
+using util::TimerId;
+
+namespace chr = std::chrono;
+
+/** The rate of writes a bulk writer starts at, per second. */
+constexpr double kInitialOperationsPerSecond = 500;
+
+/** The rate of writes a bulk writer never exceeds, per second. */
+constexpr double kMaxOperationsPerSecond = 10000;
+
+/** The rate of writes grows by `kRampUpFactor` once per `kRampUpInterval`. */
+constexpr double kRampUpFactor = 1.5;
+constexpr chr::minutes kRampUpInterval{5};
+
+/** The lowest fraction of the ramped-up rate that overload brings it to. */
+constexpr double kMinRateMultiplier = 0.1;
+
+/**
+ * Writes are committed in small groups, since a group fails as a whole and is
+ * then retried write by write.
+ */
+constexpr size_t kMaxWritesPerCommit = 20;
+constexpr size_t kMaxConcurrentCommits = 10;
+
+/** How many times a write is sent before its error is reported. */
+constexpr int kMaxAttempts = 10;
+
+}  // namespace
+
+BulkWriter::BulkWriter(const std::shared_ptr<AsyncQueue>& queue)
+    : queue_{queue}, backoff_{queue_, TimerId::RetryBulkWrite} {
+}
+
+void BulkWriter::Start(RemoteStore* remote_store) {
+  queue_->VerifyIsCurrentQueue();
+  remote_store_ = NOT_NULL(remote_store);
+  SendWrites();
+}
+
+void BulkWriter::Write(model::Mutation mutation, StatusCallback callback) {
+  queue_->VerifyIsCurrentQueue();
+
+  if (next_sequence_number_ == 0) {
+    start_time_ = chr::steady_clock::now();
+    last_refill_time_ = start_time_;
+    available_tokens_ = static_cast<double>(kMaxWritesPerCommit);
+  }
+
+  PendingWrite write;
+  write.mutation = std::move(mutation);
+  write.callback = std::move(callback);
+  write.sequence_number = next_sequence_number_++;
+  outstanding_writes_.insert(write.sequence_number);
+  pending_writes_.push_back(std::move(write));
+
+  SendWrites();
+}
+
+void BulkWriter::Flush(BulkWriterFlushCallback callback) {
+  queue_->VerifyIsCurrentQueue();
+
+  pending_flushes_.push_back(
+      PendingFlush{next_sequence_number_, std::move(callback)});
+  RaiseFlushes();
+}
+
+void BulkWriter::SendWrites() {
+  if (!remote_store_ || backing_off_) {
+    return;
+  }
+
+  while (!pending_writes_.empty() &&
+         in_flight_commits_ < kMaxConcurrentCommits) {
+    size_t available = AvailableWrites();
+    if (available == 0) {
+      ScheduleSend();
+      return;
+    }
+
+    // Take writes from the front until the group is full or a write has to
+    // wait for an earlier write to the same document.
+    std::vector<PendingWrite> group;
+    std::vector<model::Mutation> mutations;
+    size_t limit = std::min(available, kMaxWritesPerCommit);
+    while (!pending_writes_.empty() && group.size() < limit) {
+      PendingWrite& next = pending_writes_.front();
+      const model::DocumentKey& key = next.mutation.key();
+      if (in_flight_keys_.count(key) > 0 ||
+          (next.commit_alone && !group.empty())) {
+        break;
+      }
+
+      in_flight_keys_.insert(key);
+      mutations.push_back(next.mutation);
+      bool commit_alone = next.commit_alone;
+      group.push_back(std::move(next));
+      pending_writes_.pop_front();
+      if (commit_alone) {
+        break;
+      }
+    }
+
+    if (group.empty()) {
+      // The front write waits for a commit in flight, which sends again once
+      // it completes.
+      return;
+    }
+
+    available_tokens_ -= static_cast<double>(group.size());
+    ++in_flight_commits_;
+
+    auto shared_this = shared_from_this();
+    // TODO(c++14): move `group` into lambda.
+    auto shared_group =
+        std::make_shared<std::vector<PendingWrite>>(std::move(group));
+    remote_store_->CommitMutations(
+        mutations, [shared_this, shared_group](const Status& status) {
+          shared_this->HandleCommitResult(std::move(*shared_group), status);
+        });
+  }
+}
+
+void BulkWriter::HandleCommitResult(std::vector<PendingWrite> writes,
+                                    const Status& status) {
+  --in_flight_commits_;
+  for (const PendingWrite& write : writes) {
+    in_flight_keys_.erase(write.mutation.key());
+  }
+
+  if (status.ok()) {
+    backoff_.Reset();
+    for (PendingWrite& write : writes) {
+      ++stats_.documents_written;
+      CompleteWrite(write, status);
+    }
+  } else if (writes.size() > 1 && Datastore::IsPermanentWriteError(status)) {
+    // The group was rejected as a whole; find out which writes are at fault.
+    for (auto it = writes.rbegin(); it != writes.rend(); ++it) {
+      it->commit_alone = true;
+      pending_writes_.push_front(std::move(*it));
+    }
+  } else if (!Datastore::IsPermanentWriteError(status)) {
+    for (auto it = writes.rbegin(); it != writes.rend(); ++it) {
+      if (++it->attempts < kMaxAttempts) {
+        ++stats_.retries;
+        pending_writes_.push_front(std::move(*it));
+      } else {
+        ++stats_.documents_failed;
+        CompleteWrite(*it, status);
+      }
+    }
+
+    if (status.code() == Error::kErrorResourceExhausted) {
+      // The backend is overloaded: slow down and wait the longest.
+      backoff_.ResetToMax();
+      rate_multiplier_ = std::max(rate_multiplier_ / 2, kMinRateMultiplier);
+      available_tokens_ = 0;
+    }
+
+    backing_off_ = true;
+    send_operation_.Cancel();
+    auto shared_this = shared_from_this();
+    backoff_.BackoffAndRun([shared_this] {
+      shared_this->backing_off_ = false;
+      shared_this->SendWrites();
+    });
+  } else {
+    for (PendingWrite& write : writes) {
+      ++stats_.documents_failed;
+      CompleteWrite(write, status);
+    }
+  }
+
+  RaiseFlushes();
+  SendWrites();
+}
+
+void BulkWriter::CompleteWrite(PendingWrite& write, const Status& status) {
+  outstanding_writes_.erase(write.sequence_number);
+  if (write.callback) {
+    write.callback(status);
+  }
+}
+
+void BulkWriter::RaiseFlushes() {
+  while (!pending_flushes_.empty()) {
+    PendingFlush& flush = pending_flushes_.front();
+    if (!outstanding_writes_.empty() &&
+        *outstanding_writes_.begin() < flush.sequence_number) {
+      return;
+    }
+
+    BulkWriterFlushCallback callback = std::move(flush.callback);
+    pending_flushes_.pop_front();
+    if (callback) {
+      callback(CurrentStats());
+    }
+  }
+}
+
+size_t BulkWriter::AvailableWrites() {
+  auto now = chr::steady_clock::now();
+  double rate = CurrentOperationsPerSecond();
+  double elapsed_seconds =
+      chr::duration<double>(now - last_refill_time_).count();
+  last_refill_time_ = now;
+
+  // Allow bursts of up to a second's worth of writes.
+  available_tokens_ =
+      std::min(available_tokens_ + elapsed_seconds * rate, rate);
+  return available_tokens_ >= 1 ? static_cast<size_t>(available_tokens_) : 0;
+}
+
+double BulkWriter::CurrentOperationsPerSecond() const {
+  double intervals = chr::duration<double>(chr::steady_clock::now() -
+                                           start_time_) /
+                     kRampUpInterval;
+  double ramped_up = kInitialOperationsPerSecond *
+                     std::pow(kRampUpFactor, std::floor(intervals));
+  return std::min(ramped_up, kMaxOperationsPerSecond) * rate_multiplier_;
+}
+
+BulkWriterStats BulkWriter::CurrentStats() const {
+  BulkWriterStats stats = stats_;
+  double elapsed_seconds =
+      chr::duration<double>(chr::steady_clock::now() - start_time_).count();
+  if (next_sequence_number_ > 0 && elapsed_seconds > 0) {
+    stats.documents_per_second =
+        static_cast<double>(stats.documents_written) / elapsed_seconds;
+  }
+  return stats;
+}
+
+void BulkWriter::ScheduleSend() {
+  if (send_operation_) {
+    return;
+  }
+
+  double rate = CurrentOperationsPerSecond();
+  auto delay = chr::duration_cast<AsyncQueue::Milliseconds>(
+      chr::duration<double>((1 - available_tokens_) / rate));
+  auto shared_this = shared_from_this();
+  send_operation_ = queue_->EnqueueAfterDelay(
+      std::max(delay, AsyncQueue::Milliseconds(1)), TimerId::BulkWriterThrottle,
+      [shared_this] { shared_this->SendWrites(); });
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,180 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
+#define FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <set>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/core/core_fwd.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutation.h"
+#include "Firestore/core/src/remote/exponential_backoff.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/status_fwd.h"
+
+namespace firebase {
+namespace firestore {
+
+namespace remote {
+class RemoteStore;
+}  // namespace remote
+
+namespace core {
+
+/** Throughput counters of a `BulkWriter`, as of its latest flush. */
+struct BulkWriterStats {
+  /** The number of writes the backend applied. */
+  size_t documents_written = 0;
+
+  /** The number of writes that failed permanently or ran out of attempts. */
+  size_t documents_failed = 0;
+
+  /** The number of times a write was sent again after a retryable error. */
+  size_t retries = 0;
+
+  /** Applied writes per second since the first write was enqueued. */
+  double documents_per_second = 0;
+};
+
+/**
+ * BulkWriter commits large numbers of independent writes straight to the
+ * backend, with flow control of its own instead of the mutation queue's.
+ *
+ * Writes are not atomic with each other: they are committed in small groups,
+ * several groups at a time, and each write reports its own result. Because
+ * they never enter the mutation queue they are not applied to the local cache
+ * as overlays and are not retried across restarts; listeners see them once
+ * the backend does.
+ *
+ * The rate of writes starts at 500 per second and grows by half every five
+ * minutes, so that a large ingestion warms up the backend gradually. Writes to
+ * a document that has a write in flight wait for it, which keeps the writes to
+ * each document in order. All methods must be called on the worker queue.
+ *
+ * BulkWriter must be allocated via std::make_shared because the
+ * implementation uses std::shared_from_this to keep itself alive while
+ * commits are in flight.
+ */
+class BulkWriter : public std::enable_shared_from_this<BulkWriter> {
+ public:
+  explicit BulkWriter(const std::shared_ptr<util::AsyncQueue>& queue);
+
+  /**
+   * Starts committing through the given remote store. Writes scheduled before
+   * are held until then.
+   */
+  void Start(remote::RemoteStore* remote_store);
+
+  /**
+   * Schedules the given write. The callback is notified once the backend has
+   * applied it or once it failed for good.
+   */
+  void Write(model::Mutation mutation, util::StatusCallback callback);
+
+  /**
+   * Notifies the callback once every write scheduled so far has completed,
+   * with the throughput counters at that point.
+   */
+  void Flush(BulkWriterFlushCallback callback);
+
+ private:
+  struct PendingWrite {
+    model::Mutation mutation;
+    util::StatusCallback callback;
+    uint64_t sequence_number = 0;
+    int attempts = 0;
+
+    /**
+     * Set once the write failed as part of a group, so that it is retried in
+     * a commit of its own: the backend applies a commit atomically, so only a
+     * commit of a single write tells whether that write is at fault.
+     */
+    bool commit_alone = false;
+  };
+
+  struct PendingFlush {
+    uint64_t sequence_number = 0;
+    BulkWriterFlushCallback callback;
+  };
+
+  /** Sends as many groups of writes as flow control currently admits. */
+  void SendWrites();
+
+  void HandleCommitResult(std::vector<PendingWrite> writes,
+                          const util::Status& status);
+
+  void CompleteWrite(PendingWrite& write, const util::Status& status);
+
+  /** Notifies the flushes whose writes have all completed. */
+  void RaiseFlushes();
+
+  /**
+   * Refills the rate limiter and returns how many writes may be sent now.
+   */
+  size_t AvailableWrites();
+
+  double CurrentOperationsPerSecond() const;
+
+  BulkWriterStats CurrentStats() const;
+
+  /** Schedules `SendWrites` once the rate limiter admits another write. */
+  void ScheduleSend();
+
+  std::shared_ptr<util::AsyncQueue> queue_;
+  remote::RemoteStore* remote_store_ = nullptr;
+  remote::ExponentialBackoff backoff_;
+
+  std::deque<PendingWrite> pending_writes_;
+
+  /** The keys of the writes in flight, which hold back later writes to them. */
+  std::unordered_set<model::DocumentKey, model::DocumentKeyHash>
+      in_flight_keys_;
+  size_t in_flight_commits_ = 0;
+
+  /** Sequence numbers of the writes that have not completed yet. */
+  std::set<uint64_t> outstanding_writes_;
+  uint64_t next_sequence_number_ = 0;
+  std::deque<PendingFlush> pending_flushes_;
+
+  bool backing_off_ = false;
+  util::DelayedOperation send_operation_;
+
+  std::chrono::steady_clock::time_point start_time_;
+  std::chrono::steady_clock::time_point last_refill_time_;
+  double available_tokens_ = 0;
+
+  /**
+   * The rate halves after the backend reports that it is overloaded, and the
+   * ramp-up resumes from there.
+   */
+  double rate_multiplier_ = 1;
+
+  BulkWriterStats stats_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_BULK_WRITER_H_
@@ -40,6 +40,7 @@ using StatusCallback = std::function<void(Status)>;
 namespace core {
 
 class Bound;
+class BulkWriter;
 class DatabaseInfo;
 class Direction;
 class EventManager;
@@ -64,12 +65,16 @@ class DocumentViewChange;
 class DocumentViewChangeSet;
 class ViewSnapshot;
 
+struct BulkWriterStats;
+
 template <typename T>
 class AsyncEventListener;
 
 template <typename T>
 class EventListener;
 
+using BulkWriterFlushCallback = std::function<void(const BulkWriterStats&)>;
+
 using CollectionGroupId = std::shared_ptr<const std::string>;
 
 using FilterList = immutable::AppendOnlyList<Filter>;
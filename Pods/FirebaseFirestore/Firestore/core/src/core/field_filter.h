@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
 #include "Firestore/core/src/core/filter.h"
@@ -80,6 +81,14 @@ class FieldFilter : public Filter {
     return *(field_filter_rep().value_rhs_);
   }
 
+  /**
+   * Returns true if `comparison`, the result of comparing a field with
+   * `value()`, satisfies the relation operator of the filter.
+   */
+  bool MatchesComparison(util::ComparisonResult comparison) const {
+    return field_filter_rep().MatchesComparison(comparison);
+  }
+
  protected:
   class Rep : public Filter::Rep {
    public:
@@ -18,10 +18,25 @@
 
 #include <ostream>
 
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/mutable_document.h"
+
 namespace firebase {
 namespace firestore {
 namespace core {
 
+void Filter::Rep::RetainMatches(
+    const std::vector<model::MutableDocument>& documents,
+    std::vector<size_t>* candidates) const {
+  size_t kept = 0;
+  for (size_t index : *candidates) {
+    if (Matches(model::Document(documents[index]))) {
+      (*candidates)[kept++] = index;
+    }
+  }
+  candidates->resize(kept);
+}
+
 bool operator==(const Filter& lhs, const Filter& rhs) {
   return lhs.rep_ == nullptr
              ? rhs.rep_ == nullptr
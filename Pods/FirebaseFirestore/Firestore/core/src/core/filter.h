@@ -20,6 +20,7 @@
 #include <iosfwd>
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/model/model_fwd.h"
 
@@ -78,6 +79,16 @@ class Filter {
     return rep_->Matches(doc);
   }
 
+  /**
+   * Removes the indexes of the documents that don't match the filter from
+   * `candidates`, which index into `documents`. The remaining indexes keep
+   * their order.
+   */
+  void RetainMatches(const std::vector<model::MutableDocument>& documents,
+                     std::vector<size_t>* candidates) const {
+    rep_->RetainMatches(documents, candidates);
+  }
+
   /** A unique ID identifying the filter; used when serializing queries. */
   std::string CanonicalId() const {
     return rep_->CanonicalId();
@@ -115,6 +126,14 @@ class Filter {
     /** Returns true if a document matches the filter. */
     virtual bool Matches(const model::Document& doc) const = 0;
 
+    /**
+     * Batch form of `Matches`. The default implementation calls `Matches` for
+     * each candidate.
+     */
+    virtual void RetainMatches(
+        const std::vector<model::MutableDocument>& documents,
+        std::vector<size_t>* candidates) const;
+
     /** A unique ID identifying the filter; used when serializing queries. */
     virtual std::string CanonicalId() const = 0;
 
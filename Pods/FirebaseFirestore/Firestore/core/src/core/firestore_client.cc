@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/core/firestore_client.h"
 
+#include <algorithm>
 #include <functional>
 #include <future>  // NOLINT(build/c++11)
 #include <memory>
@@ -28,17 +29,22 @@
 #include "Firestore/core/src/api/query_snapshot.h"
 #include "Firestore/core/src/api/settings.h"
 #include "Firestore/core/src/bundle/bundle_reader.h"
+#include "Firestore/core/src/core/bulk_writer.h"
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/core/event_manager.h"
 #include "Firestore/core/src/core/query_listener.h"
 #include "Firestore/core/src/core/sync_engine.h"
 #include "Firestore/core/src/core/view.h"
 #include "Firestore/core/src/credentials/credentials_provider.h"
+#include "Firestore/core/src/index/geo_cell.h"
+#include "Firestore/core/src/local/index_backfiller_scheduler.h"
 #include "Firestore/core/src/local/leveldb_opener.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_snapshot_reader.h"
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/memory_persistence.h"
 #include "Firestore/core/src/local/query_engine.h"
 #include "Firestore/core/src/local/query_result.h"
@@ -56,6 +62,8 @@
 #include "Firestore/core/src/util/exception.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_apple.h"
@@ -75,8 +83,13 @@ using api::SnapshotMetadata;
 using credentials::AuthCredentialsProvider;
 using credentials::User;
 using firestore::Error;
+using local::IndexBackfillerScheduler;
+using local::IndexBackfillProgress;
 using local::LevelDbOpener;
+using local::LevelDbSnapshotReader;
+using local::LocalDocumentsView;
 using local::LocalStore;
+using local::LruGarbageCollector;
 using local::LruParams;
 using local::MemoryPersistence;
 using local::QueryEngine;
@@ -103,6 +116,51 @@ using util::TimerId;
 
 static const size_t kMaxConcurrentLimboResolutions = 100;
 
+namespace {
+
+StatusOr<DocumentSnapshot> ToDocumentSnapshot(const DocumentReference& doc,
+                                              const Document& document) {
+  if (document->is_found_document()) {
+    return DocumentSnapshot::FromDocument(
+        doc.firestore(), document,
+        SnapshotMetadata{document->has_local_mutations(),
+                         /*from_cache=*/true});
+  } else if (document->is_no_document()) {
+    return DocumentSnapshot::FromNoDocument(
+        doc.firestore(), doc.key(),
+        SnapshotMetadata{/*pending_writes=*/false,
+                         /*from_cache=*/true});
+  } else {
+    return Status{Error::kErrorUnavailable,
+                  "Failed to get document from cache. (However, this document "
+                  "may exist on the server. Run again without setting source "
+                  "to FirestoreSourceCache to attempt to retrieve the "
+                  "document "};
+  }
+}
+
+QuerySnapshot ToQuerySnapshot(const api::Query& query,
+                              const DocumentMap& documents,
+                              const DocumentKeySet& remote_keys) {
+  View view(query.query(), remote_keys);
+  ViewDocumentChanges view_doc_changes = view.ComputeDocumentChanges(documents);
+  ViewChange view_change = view.ApplyChanges(view_doc_changes);
+  HARD_ASSERT(
+      view_change.limbo_changes().empty(),
+      "View returned limbo documents during local-only query execution.");
+
+  HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
+
+  ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
+  SnapshotMetadata metadata(snapshot.has_pending_writes(),
+                            snapshot.from_cache());
+
+  return QuerySnapshot(query.firestore(), query.query(), std::move(snapshot),
+                       std::move(metadata));
+}
+
+}  // namespace
+
 std::shared_ptr<FirestoreClient> FirestoreClient::Create(
     const DatabaseInfo& database_info,
     const api::Settings& settings,
@@ -119,6 +177,11 @@ std::shared_ptr<FirestoreClient> FirestoreClient::Create(
       std::move(app_check_credentials_provider), std::move(user_executor),
       std::move(worker_queue), std::move(firebase_metadata_provider)));
 
+  if (settings.metrics_enabled()) {
+    shared_client->metrics_ = std::make_shared<util::Metrics>();
+    shared_client->worker_queue_->SetMetrics(shared_client->metrics_);
+  }
+
   std::weak_ptr<FirestoreClient> weak_client(shared_client);
   auto credential_change_listener = [weak_client, settings](User user) mutable {
     auto shared_client = weak_client.lock();
@@ -131,14 +194,15 @@ std::shared_ptr<FirestoreClient> FirestoreClient::Create(
       // it is invoked synchronously on the calling thread. This ensures that
       // the first item enqueued on the worker queue is
       // `FirestoreClient::Initialize()`.
-      shared_client->worker_queue_->Enqueue([shared_client, user, settings] {
+      shared_client->EnqueueUserOperation([shared_client, user, settings] {
         shared_client->Initialize(user, settings);
       });
     } else {
-      shared_client->worker_queue_->Enqueue([shared_client, user] {
+      shared_client->EnqueueUserOperation([shared_client, user] {
         shared_client->worker_queue_->VerifyIsCurrentQueue();
 
         LOG_DEBUG("Credential Changed. Current user: %s", user.uid());
+        shared_client->current_user_ = user;
         shared_client->sync_engine_->HandleCredentialChange(user);
       });
     }
@@ -180,16 +244,36 @@ FirestoreClient::FirestoreClient(
 void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   // Do all of our initialization on our own dispatch queue.
   worker_queue_->VerifyIsCurrentQueue();
+  util::StartupSpan initialize_span(util::StartupPhase::kClientInitialize);
   LOG_DEBUG("Initializing. Current user: %s", user.uid());
+  current_user_ = user;
 
   // Note: The initialization work must all be synchronous (we can't dispatch
   // more work) since external write/listen operations could get queued to run
   // before that subsequent work completes.
+  connectivity_monitor_ = ConnectivityMonitor::Create(worker_queue_);
+  util::StartupSpan grpc_init_span(util::StartupPhase::kGrpcInit);
+  auto datastore = std::make_shared<Datastore>(
+      database_info_, worker_queue_, auth_credentials_provider_,
+      app_check_credentials_provider_, connectivity_monitor_.get(),
+      firebase_metadata_provider_.get());
+  grpc_init_span.End();
+  datastore->SetChannelCount(static_cast<size_t>(
+      std::max<int64_t>(settings.grpc_channel_count(), 0)));
+  datastore->SetMetrics(metrics_.get());
+  if (settings.prewarm_enabled()) {
+    // Connect and fetch credentials on other threads while the local store
+    // starts up below.
+    datastore->Prewarm();
+  }
+
   if (settings.persistence_enabled()) {
     LevelDbOpener opener(database_info_);
 
+    util::StartupSpan open_span(util::StartupPhase::kLevelDbOpen);
     auto created =
         opener.Create(LruParams::WithCacheSize(settings.cache_size_bytes()));
+    open_span.End();
     // If leveldb fails to start then just throw up our hands: the error is
     // unrecoverable. There's nothing an end-user can do and nearly all
     // failures indicate the developer is doing something grossly wrong so we
@@ -199,8 +283,24 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
 
     auto ldb = std::move(created).ValueOrDie();
     lru_delegate_ = ldb->reference_delegate();
+    ldb->remote_document_cache()->set_metrics(metrics_.get());
+    ldb->remote_document_cache()->SetHotDocumentCacheSize(
+        static_cast<size_t>(
+            std::max<int64_t>(settings.hot_document_cache_size_bytes(), 0)));
+    if (settings.group_commit_window_ms() > 0) {
+      ldb->EnableGroupCommit(
+          worker_queue_,
+          std::chrono::milliseconds(settings.group_commit_window_ms()));
+    }
+
+    if (settings.cache_read_concurrency() > 0) {
+      snapshot_reader_ = absl::make_unique<LevelDbSnapshotReader>(
+          ldb.get(), static_cast<size_t>(settings.cache_read_concurrency()));
+    }
 
     persistence_ = std::move(ldb);
+    gc_time_budget_ = std::chrono::milliseconds(
+        std::max<int64_t>(settings.gc_time_budget_ms(), 0));
     if (settings.gc_enabled()) {
       ScheduleLruGarbageCollection();
     }
@@ -209,23 +309,36 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   }
 
   query_engine_ = absl::make_unique<QueryEngine>();
+  query_engine_->set_metrics(metrics_.get());
   local_store_ = absl::make_unique<LocalStore>(persistence_.get(),
                                                query_engine_.get(), user);
-  connectivity_monitor_ = ConnectivityMonitor::Create(worker_queue_);
-  auto datastore = std::make_shared<Datastore>(
-      database_info_, worker_queue_, auth_credentials_provider_,
-      app_check_credentials_provider_, connectivity_monitor_.get(),
-      firebase_metadata_provider_.get());
 
   remote_store_ = absl::make_unique<RemoteStore>(
       local_store_.get(), std::move(datastore), worker_queue_,
       connectivity_monitor_.get(), [this](OnlineState online_state) {
         sync_engine_->HandleOnlineStateChange(online_state);
       });
+  remote_store_->set_max_pending_writes(static_cast<size_t>(
+      std::max<int64_t>(settings.write_pipeline_depth(), 0)));
+  remote_store_->set_max_write_request_bytes(static_cast<size_t>(
+      std::max<int64_t>(settings.write_request_max_bytes(), 0)));
+  remote_store_->set_write_compression_threshold(static_cast<size_t>(
+      std::max<int64_t>(settings.write_compression_threshold_bytes(), 0)));
+  remote_store_->set_metrics(metrics_.get());
+  remote_store_->set_fast_reconnect_enabled(settings.fast_reconnect_enabled());
+  remote_store_->set_adaptive_backoff_enabled(
+      settings.adaptive_backoff_enabled());
 
   sync_engine_ =
       absl::make_unique<SyncEngine>(local_store_.get(), remote_store_.get(),
                                     user, kMaxConcurrentLimboResolutions);
+  sync_engine_->set_bundle_documents_per_chunk(static_cast<size_t>(
+      std::max<int64_t>(settings.bundle_documents_per_chunk(), 0)));
+  sync_engine_->set_shared_targets_enabled(settings.shared_targets_enabled());
+  sync_engine_->set_limbo_resolution_batch_size(static_cast<size_t>(
+      std::max<int64_t>(settings.limbo_resolution_batch_size(), 0)));
+  sync_engine_->set_transaction_read_reuse_enabled(
+      settings.transaction_read_reuse_enabled());
 
   event_manager_ = absl::make_unique<EventManager>(sync_engine_.get());
 
@@ -235,7 +348,20 @@ void FirestoreClient::Initialize(const User& user, const Settings& settings) {
   // NOTE: RemoteStore depends on LocalStore (for persisting stream tokens,
   // refilling mutation queue, etc.) so must be started after LocalStore.
   local_store_->Start();
+  local_store_->SetQueryResultCacheSize(static_cast<size_t>(
+      std::max<int64_t>(settings.query_result_cache_size(), 0)));
   remote_store_->Start();
+
+  if (settings.persistence_enabled()) {
+    local_store_->SetIndexAutoCreationEnabled(
+        settings.index_auto_creation_enabled());
+    index_backfiller_scheduler_ = absl::make_unique<IndexBackfillerScheduler>(
+        worker_queue_, local_store_.get());
+    index_backfiller_scheduler_->set_documents_per_second(
+        static_cast<size_t>(std::max<int64_t>(
+            settings.index_backfill_documents_per_second(), 0)));
+    index_backfiller_scheduler_->Start();
+  }
 }
 
 FirestoreClient::~FirestoreClient() {
@@ -296,9 +422,21 @@ void FirestoreClient::TerminateInternal() {
   // If we've scheduled LRU garbage collection, cancel it.
   lru_callback_.Cancel();
 
+  // If we've scheduled index backfilling, cancel it.
+  if (index_backfiller_scheduler_) {
+    index_backfiller_scheduler_->Stop();
+  }
+
   remote_store_->Shutdown();
+
+  // Snapshot reads have to finish before the database closes.
+  if (snapshot_reader_) {
+    snapshot_reader_->Dispose();
+  }
   persistence_->Shutdown();
 
+  index_backfiller_scheduler_.reset();
+  snapshot_reader_.reset();
   local_store_.reset();
   query_engine_.reset();
   event_manager_.reset();
@@ -309,15 +447,34 @@ void FirestoreClient::TerminateInternal() {
 
 /**
  * Schedules a callback to try running LRU garbage collection. Reschedules
- * itself after the GC has run.
+ * itself after the GC has run, after a short delay while an incremental
+ * collection is still unfinished.
  */
 void FirestoreClient::ScheduleLruGarbageCollection() {
   std::chrono::milliseconds delay =
       gc_has_run_ ? regular_gc_delay_ : initial_gc_delay_;
 
+  LruGarbageCollector* garbage_collector = lru_delegate_->garbage_collector();
+  if (garbage_collector->incremental_collection_in_progress()) {
+    delay = incremental_gc_delay_;
+  }
+
   lru_callback_ = worker_queue_->EnqueueAfterDelay(
-      delay, TimerId::GarbageCollectionDelay, [this] {
-        local_store_->CollectGarbage(lru_delegate_->garbage_collector());
+      delay, TimerId::GarbageCollectionDelay, AsyncQueue::Priority::kBackground,
+      [this, garbage_collector] {
+        {
+          util::ScopedLatency latency{
+              metrics_.get(), util::MetricHistogram::kGarbageCollectionMicros};
+          if (gc_time_budget_.count() > 0) {
+            local_store_->CollectGarbageIncrementally(garbage_collector,
+                                                      gc_time_budget_);
+          } else {
+            local_store_->CollectGarbage(garbage_collector);
+          }
+        }
+        if (metrics_) {
+          metrics_->Increment(util::MetricCounter::kGarbageCollections);
+        }
         gc_has_run_ = true;
         ScheduleLruGarbageCollection();
       });
@@ -326,7 +483,7 @@ void FirestoreClient::ScheduleLruGarbageCollection() {
 void FirestoreClient::DisableNetwork(StatusCallback callback) {
   VerifyNotTerminated();
 
-  worker_queue_->Enqueue([this, callback] {
+  EnqueueUserOperation([this, callback] {
     remote_store_->DisableNetwork();
     if (callback) {
       user_executor_->Execute([=] { callback(Status::OK()); });
@@ -337,7 +494,7 @@ void FirestoreClient::DisableNetwork(StatusCallback callback) {
 void FirestoreClient::EnableNetwork(StatusCallback callback) {
   VerifyNotTerminated();
 
-  worker_queue_->Enqueue([this, callback] {
+  EnqueueUserOperation([this, callback] {
     remote_store_->EnableNetwork();
     if (callback) {
       user_executor_->Execute([=] { callback(Status::OK()); });
@@ -355,7 +512,7 @@ void FirestoreClient::WaitForPendingWrites(StatusCallback callback) {
     }
   };
 
-  worker_queue_->Enqueue([this, async_callback] {
+  EnqueueUserOperation([this, async_callback] {
     sync_engine_->RegisterPendingWritesCallback(std::move(async_callback));
   });
 }
@@ -366,6 +523,11 @@ void FirestoreClient::VerifyNotTerminated() {
   }
 }
 
+void FirestoreClient::EnqueueUserOperation(
+    const AsyncQueue::Operation& operation) {
+  worker_queue_->Enqueue(AsyncQueue::Priority::kInteractive, operation);
+}
+
 bool FirestoreClient::is_terminated() const {
   // When the user calls `Terminate`, it puts the `AsyncQueue` into restricted
   // mode.
@@ -379,10 +541,15 @@ std::shared_ptr<QueryListener> FirestoreClient::ListenToQuery(
     Query query, ListenOptions options, ViewSnapshotSharedListener&& listener) {
   VerifyNotTerminated();
 
+  bool coalesce_snapshots = options.min_snapshot_interval().count() > 0;
   auto query_listener = QueryListener::Create(
       std::move(query), std::move(options), std::move(listener));
+  query_listener->set_metrics(metrics_.get());
 
-  worker_queue_->Enqueue([this, query_listener] {
+  EnqueueUserOperation([this, query_listener, coalesce_snapshots] {
+    if (coalesce_snapshots) {
+      query_listener->EnableSnapshotCoalescing(worker_queue_);
+    }
     event_manager_->AddQueryListener(std::move(query_listener));
   });
 
@@ -396,7 +563,7 @@ void FirestoreClient::RemoveListener(
   if (is_terminated()) {
     return;
   }
-  worker_queue_->Enqueue(
+  EnqueueUserOperation(
       [this, listener] { event_manager_->RemoveQueryListener(listener); });
 }
 
@@ -406,28 +573,28 @@ void FirestoreClient::GetDocumentFromLocalCache(
 
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, doc, shared_callback] {
-    Document document = local_store_->ReadDocument(doc.key());
-    StatusOr<DocumentSnapshot> maybe_snapshot;
-
-    if (document->is_found_document()) {
-      maybe_snapshot = DocumentSnapshot::FromDocument(
-          doc.firestore(), document,
-          SnapshotMetadata{document->has_local_mutations(),
-                           /*from_cache=*/true});
-    } else if (document->is_no_document()) {
-      maybe_snapshot = DocumentSnapshot::FromNoDocument(
-          doc.firestore(), doc.key(),
-          SnapshotMetadata{/*pending_writes=*/false,
-                           /*from_cache=*/true});
-    } else {
-      maybe_snapshot =
-          Status{Error::kErrorUnavailable,
-                 "Failed to get document from cache. (However, this document "
-                 "may exist on the server. Run again without setting source to "
-                 "FirestoreSourceCache to attempt to retrieve the document "};
+  EnqueueUserOperation([this, doc, shared_callback] {
+    if (snapshot_reader_) {
+      auto user_executor = user_executor_;
+      snapshot_reader_->Schedule(
+          current_user_,
+          [user_executor, doc,
+           shared_callback](StatusOr<LocalDocumentsView*> documents) {
+            StatusOr<DocumentSnapshot> maybe_snapshot =
+                documents.ok()
+                    ? ToDocumentSnapshot(
+                          doc, documents.ValueOrDie()->GetDocument(doc.key()))
+                    : StatusOr<DocumentSnapshot>(documents.status());
+            if (shared_callback) {
+              user_executor->Execute(
+                  [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
+            }
+          });
+      return;
     }
 
+    StatusOr<DocumentSnapshot> maybe_snapshot =
+        ToDocumentSnapshot(doc, local_store_->ReadDocument(doc.key()));
     if (shared_callback) {
       user_executor_->Execute(
           [=] { shared_callback->OnEvent(std::move(maybe_snapshot)); });
@@ -441,27 +608,71 @@ void FirestoreClient::GetDocumentsFromLocalCache(
 
   // TODO(c++14): move `callback` into lambda.
   auto shared_callback = absl::ShareUniquePtr(std::move(callback));
-  worker_queue_->Enqueue([this, query, shared_callback] {
+  EnqueueUserOperation([this, query, shared_callback] {
+    // Collection group queries need the index manager's collection parents,
+    // which only the worker queue reads.
+    if (snapshot_reader_ && !query.query().IsCollectionGroupQuery()) {
+      DocumentKeySet remote_keys =
+          local_store_->GetRemoteDocumentKeys(query.query());
+      auto user_executor = user_executor_;
+      snapshot_reader_->Schedule(
+          current_user_,
+          [user_executor, query, remote_keys,
+           shared_callback](StatusOr<LocalDocumentsView*> documents) {
+            StatusOr<QuerySnapshot> result = documents.status();
+            if (documents.ok()) {
+              DocumentMap matches =
+                  documents.ValueOrDie()->GetDocumentsMatchingQuery(
+                      query.query(), model::IndexOffset::None());
+              result = ToQuerySnapshot(query, matches, remote_keys);
+            }
+            if (shared_callback) {
+              user_executor->Execute(
+                  [=] { shared_callback->OnEvent(std::move(result)); });
+            }
+          });
+      return;
+    }
+
     QueryResult query_result = local_store_->ExecuteQuery(
         query.query(), /* use_previous_results= */ true);
+    QuerySnapshot result = ToQuerySnapshot(query, query_result.documents(),
+                                           query_result.remote_keys());
+    if (shared_callback) {
+      user_executor_->Execute(
+          [=] { shared_callback->OnEvent(std::move(result)); });
+    }
+  });
+}
 
-    View view(query.query(), query_result.remote_keys());
-    ViewDocumentChanges view_doc_changes =
-        view.ComputeDocumentChanges(query_result.documents());
-    ViewChange view_change = view.ApplyChanges(view_doc_changes);
-    HARD_ASSERT(
-        view_change.limbo_changes().empty(),
-        "View returned limbo documents during local-only query execution.");
-
-    HARD_ASSERT(view_change.snapshot().has_value(), "Expected a snapshot");
+void FirestoreClient::CountDocumentsFromLocalCache(
+    const api::Query& query, StatusOrCallback<int64_t>&& callback) {
+  VerifyNotTerminated();
 
-    ViewSnapshot snapshot = std::move(view_change.snapshot()).value();
-    SnapshotMetadata metadata(snapshot.has_pending_writes(),
-                              snapshot.from_cache());
+  // TODO(c++14): move `callback` into lambda.
+  EnqueueUserOperation([this, query, callback] {
+    auto count =
+        static_cast<int64_t>(local_store_->CountDocuments(query.query()));
+    if (callback) {
+      user_executor_->Execute([=] { callback(count); });
+    }
+  });
+}
 
-    QuerySnapshot result(query.firestore(), query.query(), std::move(snapshot),
-                         std::move(metadata));
+void FirestoreClient::GetDocumentsInRegionFromLocalCache(
+    const api::Query& query,
+    const model::FieldPath& field_path,
+    const index::GeoRegion& region,
+    QuerySnapshotListener&& callback) {
+  VerifyNotTerminated();
 
+  // TODO(c++14): move `callback` into lambda.
+  auto shared_callback = absl::ShareUniquePtr(std::move(callback));
+  EnqueueUserOperation([this, query, field_path, region, shared_callback] {
+    DocumentMap matches =
+        local_store_->GetDocumentsInRegion(query.query(), field_path, region);
+    QuerySnapshot result = ToQuerySnapshot(
+        query, matches, local_store_->GetRemoteDocumentKeys(query.query()));
     if (shared_callback) {
       user_executor_->Execute(
           [=] { shared_callback->OnEvent(std::move(result)); });
@@ -474,7 +685,7 @@ void FirestoreClient::WriteMutations(std::vector<Mutation>&& mutations,
   VerifyNotTerminated();
 
   // TODO(c++14): move `mutations` into lambda (C++14).
-  worker_queue_->Enqueue([this, mutations, callback]() mutable {
+  EnqueueUserOperation([this, mutations, callback]() mutable {
     if (mutations.empty()) {
       if (callback) {
         user_executor_->Execute([=] { callback(Status::OK()); });
@@ -503,37 +714,104 @@ void FirestoreClient::Transaction(int max_attempts,
     }
   };
 
-  worker_queue_->Enqueue([this, max_attempts, update_callback, async_callback] {
+  EnqueueUserOperation([this, max_attempts, update_callback, async_callback] {
     sync_engine_->Transaction(max_attempts, worker_queue_,
                               std::move(update_callback),
                               std::move(async_callback));
   });
 }
 
+std::shared_ptr<BulkWriter> FirestoreClient::CreateBulkWriter() {
+  VerifyNotTerminated();
+
+  auto bulk_writer = std::make_shared<BulkWriter>(worker_queue_);
+  EnqueueUserOperation(
+      [this, bulk_writer] { bulk_writer->Start(remote_store_.get()); });
+  return bulk_writer;
+}
+
+void FirestoreClient::BulkWrite(const std::shared_ptr<BulkWriter>& bulk_writer,
+                                Mutation&& mutation,
+                                StatusCallback callback) {
+  VerifyNotTerminated();
+
+  // TODO(c++14): move `mutation` into lambda (C++14).
+  EnqueueUserOperation([this, bulk_writer, mutation, callback]() mutable {
+    bulk_writer->Write(std::move(mutation), [this, callback](Status status) {
+      // Dispatch the result back onto the user dispatch queue.
+      if (callback) {
+        user_executor_->Execute([=] { callback(std::move(status)); });
+      }
+    });
+  });
+}
+
+void FirestoreClient::FlushBulkWriter(
+    const std::shared_ptr<BulkWriter>& bulk_writer,
+    BulkWriterFlushCallback callback) {
+  VerifyNotTerminated();
+
+  EnqueueUserOperation([this, bulk_writer, callback] {
+    bulk_writer->Flush([this, callback](const BulkWriterStats& stats) {
+      if (callback) {
+        user_executor_->Execute([=] { callback(stats); });
+      }
+    });
+  });
+}
+
 void FirestoreClient::AddSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& user_listener) {
-  worker_queue_->Enqueue([this, user_listener] {
+  EnqueueUserOperation([this, user_listener] {
     event_manager_->AddSnapshotsInSyncListener(std::move(user_listener));
   });
 }
 
 void FirestoreClient::RemoveSnapshotsInSyncListener(
     const std::shared_ptr<EventListener<Empty>>& user_listener) {
-  worker_queue_->Enqueue([this, user_listener] {
+  EnqueueUserOperation([this, user_listener] {
     event_manager_->RemoveSnapshotsInSyncListener(user_listener);
   });
 }
 
+void FirestoreClient::SetIndexBackfillProgressCallback(
+    std::function<void(const IndexBackfillProgress&)> callback) {
+  EnqueueUserOperation([this, callback] {
+    if (!index_backfiller_scheduler_) {
+      return;
+    }
+
+    if (!callback) {
+      index_backfiller_scheduler_->set_progress_callback(nullptr);
+      return;
+    }
+
+    std::shared_ptr<Executor> user_executor = user_executor_;
+    index_backfiller_scheduler_->set_progress_callback(
+        [user_executor, callback](const IndexBackfillProgress& progress) {
+          user_executor->Execute([callback, progress] { callback(progress); });
+        });
+  });
+}
+
+void FirestoreClient::LoadBundle(
+    std::unique_ptr<util::ByteStream> bundle_data,
+    std::shared_ptr<api::LoadBundleTask> result_task) {
+  LoadBundle(std::move(bundle_data), bundle::BundleFormat::kJson,
+             std::move(result_task));
+}
+
 void FirestoreClient::LoadBundle(
     std::unique_ptr<util::ByteStream> bundle_data,
+    bundle::BundleFormat format,
     std::shared_ptr<api::LoadBundleTask> result_task) {
   VerifyNotTerminated();
 
   bundle::BundleSerializer bundle_serializer(
       remote::Serializer(database_info_.database_id()));
   auto reader = std::make_shared<bundle::BundleReader>(
-      std::move(bundle_serializer), std::move(bundle_data));
-  worker_queue_->Enqueue([this, reader, result_task] {
+      std::move(bundle_serializer), std::move(bundle_data), format);
+  EnqueueUserOperation([this, reader, result_task] {
     sync_engine_->LoadBundle(std::move(reader), std::move(result_task));
   });
 }
@@ -562,7 +840,7 @@ void FirestoreClient::GetNamedQuery(const std::string& name,
         }
       };
 
-  worker_queue_->Enqueue([this, name, async_callback] {
+  EnqueueUserOperation([this, name, async_callback] {
     async_callback(local_store_->GetNamedQuery(name));
   });
 }
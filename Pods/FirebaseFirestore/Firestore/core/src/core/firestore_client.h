@@ -17,16 +17,19 @@
 #ifndef FIRESTORE_CORE_SRC_CORE_FIRESTORE_CLIENT_H_
 #define FIRESTORE_CORE_SRC_CORE_FIRESTORE_CLIENT_H_
 
+#include <functional>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "Firestore/core/src/api/api_fwd.h"
 #include "Firestore/core/src/api/load_bundle_task.h"
+#include "Firestore/core/src/bundle/bundle_reader.h"
 #include "Firestore/core/src/bundle/bundle_serializer.h"
 #include "Firestore/core/src/core/core_fwd.h"
 #include "Firestore/core/src/core/database_info.h"
 #include "Firestore/core/src/credentials/credentials_fwd.h"
+#include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/model/database_id.h"
 #include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/byte_stream.h"
@@ -39,14 +42,22 @@
 namespace firebase {
 namespace firestore {
 
+namespace index {
+class GeoRegion;
+}  // namespace index
+
 namespace local {
+class IndexBackfillerScheduler;
+class LevelDbSnapshotReader;
 class LocalStore;
 class LruDelegate;
 class Persistence;
 class QueryEngine;
+struct IndexBackfillProgress;
 }  // namespace local
 
 namespace model {
+class FieldPath;
 class Mutation;
 }  // namespace model
 
@@ -56,6 +67,10 @@ class FirebaseMetadataProvider;
 class RemoteStore;
 }  // namespace remote
 
+namespace util {
+class Metrics;
+}  // namespace util
+
 namespace core {
 
 /**
@@ -135,6 +150,24 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   void GetDocumentsFromLocalCache(const api::Query& query,
                                   api::QuerySnapshotListener&& callback);
 
+  /**
+   * Counts the documents in the cache that match the given query and passes
+   * the count to the callback.
+   */
+  void CountDocumentsFromLocalCache(const api::Query& query,
+                                    util::StatusOrCallback<int64_t>&& callback);
+
+  /**
+   * Retrieves the documents in the cache that match the given query and
+   * whose GeoPoint value at `field_path` lies within `region`, via the
+   * indicated callback.
+   */
+  void GetDocumentsInRegionFromLocalCache(
+      const api::Query& query,
+      const model::FieldPath& field_path,
+      const index::GeoRegion& region,
+      api::QuerySnapshotListener&& callback);
+
   /**
    * Write mutations. callback will be notified when it's written to the
    * backend.
@@ -150,6 +183,27 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
                    TransactionUpdateCallback update_callback,
                    TransactionResultCallback result_callback);
 
+  /**
+   * Creates a bulk writer that commits writes straight to the backend,
+   * bypassing the mutation queue.
+   */
+  std::shared_ptr<BulkWriter> CreateBulkWriter();
+
+  /**
+   * Schedules a write on the given bulk writer. callback will be notified
+   * when it's written to the backend or failed for good.
+   */
+  void BulkWrite(const std::shared_ptr<BulkWriter>& bulk_writer,
+                 model::Mutation&& mutation,
+                 util::StatusCallback callback);
+
+  /**
+   * Notifies callback once the writes scheduled so far on the given bulk
+   * writer have completed.
+   */
+  void FlushBulkWriter(const std::shared_ptr<BulkWriter>& bulk_writer,
+                       BulkWriterFlushCallback callback);
+
   /**
    * Adds a listener to be called when a snapshots-in-sync event fires.
    */
@@ -162,6 +216,13 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
   void RemoveSnapshotsInSyncListener(
       const std::shared_ptr<EventListener<util::Empty>>& listener);
 
+  /**
+   * Sets a callback that is invoked on the user executor with the progress of
+   * background index backfilling. Passing an empty callback removes it.
+   */
+  void SetIndexBackfillProgressCallback(
+      std::function<void(const local::IndexBackfillProgress&)> callback);
+
   /** The database ID of the DatabaseInfo this client was initialized with. */
   const model::DatabaseId& database_id() const {
     return database_info_.database_id();
@@ -178,9 +239,20 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void LoadBundle(std::unique_ptr<util::ByteStream> bundle_data,
                   std::shared_ptr<api::LoadBundleTask> result_task);
+  void LoadBundle(std::unique_ptr<util::ByteStream> bundle_data,
+                  bundle::BundleFormat format,
+                  std::shared_ptr<api::LoadBundleTask> result_task);
 
   void GetNamedQuery(const std::string& name, api::QueryCallback callback);
 
+  /**
+   * The counters and histograms of this client, or null if metrics are not
+   * enabled. Safe to read from any thread.
+   */
+  const std::shared_ptr<util::Metrics>& metrics() const {
+    return metrics_;
+  }
+
   /** For usage in this class and testing only. */
   const std::shared_ptr<util::AsyncQueue>& worker_queue() const {
     return worker_queue_;
@@ -202,6 +274,13 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   void VerifyNotTerminated();
 
+  /**
+   * Enqueues an operation on behalf of the user. These run ahead of the work
+   * the client schedules itself, such as applying remote events or garbage
+   * collection, while staying in order among themselves.
+   */
+  void EnqueueUserOperation(const util::AsyncQueue::Operation& operation);
+
   void TerminateInternal();
 
   void ScheduleLruGarbageCollection();
@@ -223,9 +302,17 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   std::unique_ptr<remote::FirebaseMetadataProvider> firebase_metadata_provider_;
 
+  // Set once in `Create`, before any component that records into it exists.
+  std::shared_ptr<util::Metrics> metrics_;
+
   std::unique_ptr<local::Persistence> persistence_;
   std::unique_ptr<local::LocalStore> local_store_;
   std::unique_ptr<local::QueryEngine> query_engine_;
+  std::unique_ptr<local::IndexBackfillerScheduler> index_backfiller_scheduler_;
+
+  // Runs reads from the persistent cache off the worker queue, if enabled.
+  std::unique_ptr<local::LevelDbSnapshotReader> snapshot_reader_;
+  credentials::User current_user_;
   std::unique_ptr<remote::ConnectivityMonitor> connectivity_monitor_;
   std::unique_ptr<remote::RemoteStore> remote_store_;
   std::unique_ptr<SyncEngine> sync_engine_;
@@ -233,6 +320,10 @@ class FirestoreClient : public std::enable_shared_from_this<FirestoreClient> {
 
   std::chrono::milliseconds initial_gc_delay_ = std::chrono::minutes(1);
   std::chrono::milliseconds regular_gc_delay_ = std::chrono::minutes(5);
+  // A positive budget splits each collection into turns at most this long,
+  // `incremental_gc_delay_` apart.
+  std::chrono::milliseconds gc_time_budget_{0};
+  std::chrono::milliseconds incremental_gc_delay_{50};
   bool gc_has_run_ = false;
   bool credentials_initialized_ = false;
   local::LruDelegate* _Nullable lru_delegate_;
@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_CORE_LISTEN_OPTIONS_H_
 #define FIRESTORE_CORE_SRC_CORE_LISTEN_OPTIONS_H_
 
+#include <chrono>  // NOLINT(build/c++11)
+
 namespace firebase {
 namespace firestore {
 namespace core {
@@ -34,13 +36,19 @@ class ListenOptions {
    *     documents changes.
    * @param wait_for_sync_when_online Wait for a sync with the server when
    *     online, but still raise events while offline
+   * @param min_snapshot_interval The minimum time between two raised
+   *     snapshots. Snapshots arriving sooner are merged into one snapshot that
+   *     is raised once the interval has passed. Zero raises every snapshot.
    */
   ListenOptions(bool include_query_metadata_changes,
                 bool include_document_metadata_changes,
-                bool wait_for_sync_when_online)
+                bool wait_for_sync_when_online,
+                std::chrono::milliseconds min_snapshot_interval =
+                    std::chrono::milliseconds(0))
       : include_query_metadata_changes_(include_query_metadata_changes),
         include_document_metadata_changes_(include_document_metadata_changes),
-        wait_for_sync_when_online_(wait_for_sync_when_online) {
+        wait_for_sync_when_online_(wait_for_sync_when_online),
+        min_snapshot_interval_(min_snapshot_interval) {
   }
 
   /**
@@ -78,10 +86,15 @@ class ListenOptions {
     return wait_for_sync_when_online_;
   }
 
+  std::chrono::milliseconds min_snapshot_interval() const {
+    return min_snapshot_interval_;
+  }
+
  private:
   bool include_query_metadata_changes_ = false;
   bool include_document_metadata_changes_ = false;
   bool wait_for_sync_when_online_ = false;
+  std::chrono::milliseconds min_snapshot_interval_{0};
 };
 
 }  // namespace core
@@ -17,15 +17,21 @@
 #include "Firestore/core/src/core/query.h"
 
 #include <algorithm>
+#include <memory>
 #include <ostream>
 
 #include "Firestore/core/src/core/bound.h"
 #include "Firestore/core/src/core/operator.h"
+#include "Firestore/core/src/core/query_matcher.h"
+#include "Firestore/core/src/index/firestore_index_value_writer.h"
+#include "Firestore/core/src/index/index_byte_encoder.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_set.h"
 #include "Firestore/core/src/model/field_path.h"
+#include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/model/value_util.h"
 #include "Firestore/core/src/util/equality.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/hashing.h"
@@ -42,8 +48,10 @@ using Type = Filter::Type;
 using model::Document;
 using model::DocumentComparator;
 using model::DocumentKey;
+using model::DocumentSortKey;
 using model::FieldPath;
 using model::ResourcePath;
+using model::TypeOrder;
 using util::ComparisonResult;
 
 Query::Query(ResourcePath path, std::string collection_group)
@@ -219,61 +227,94 @@ Query Query::AsCollectionQueryAtPath(ResourcePath path) const {
 // MARK: - Matching
 
 bool Query::Matches(const Document& doc) const {
-  return doc->is_found_document() && MatchesPathAndCollectionGroup(doc) &&
-         MatchesOrderBy(doc) && MatchesFilters(doc) && MatchesBounds(doc);
+  return matcher().Matches(doc);
 }
 
-bool Query::MatchesPathAndCollectionGroup(const Document& doc) const {
-  const ResourcePath& doc_path = doc->key().path();
-  if (collection_group_) {
-    // NOTE: path_ is currently always empty since we don't expose Collection
-    // Group queries rooted at a document path yet.
-    return doc->key().HasCollectionGroup(*collection_group_) &&
-           path_.IsPrefixOf(doc_path);
-  } else if (DocumentKey::IsDocumentKey(path_)) {
-    // Exact match for document queries.
-    return path_ == doc_path;
-  } else {
-    // Shallow ancestor queries by default.
-    return path_.IsImmediateParentOf(doc_path);
-  }
+std::vector<size_t> Query::MatchingIndexes(
+    const std::vector<model::MutableDocument>& documents) const {
+  return matcher().MatchingIndexes(documents);
 }
 
-bool Query::MatchesFilters(const Document& doc) const {
-  for (const auto& filter : filters_) {
-    if (!filter.Matches(doc)) return false;
+const QueryMatcher& Query::matcher() const {
+  if (memoized_matcher_ == nullptr) {
+    memoized_matcher_ = std::make_shared<const QueryMatcher>(*this);
   }
-  return true;
+  return *memoized_matcher_;
 }
 
-bool Query::MatchesOrderBy(const Document& doc) const {
-  for (const OrderBy& order_by : explicit_order_bys_) {
-    const FieldPath& field_path = order_by.field();
-    // order by key always matches
-    if (field_path != FieldPath::KeyFieldPath() &&
-        doc->field(field_path) == absl::nullopt) {
+namespace {
+
+// The labels that delimit the segments of the document key in a sort key, as
+// the index encoding delimits the segments of references.
+constexpr int64_t kSortKeySegmentLabel = 60;
+constexpr int64_t kSortKeyPathEnd = 2;
+
+/**
+ * Returns whether the index encoding of values of the given type sorts them
+ * the way `model::Compare` does. Server timestamps are encoded as the maps
+ * they are stored as, and references, arrays and maps as sequences that are
+ * not terminated the way the values are compared.
+ */
+bool HasSortableEncoding(TypeOrder type) {
+  switch (type) {
+    case TypeOrder::kNull:
+    case TypeOrder::kBoolean:
+    case TypeOrder::kNumber:
+    case TypeOrder::kTimestamp:
+    case TypeOrder::kString:
+    case TypeOrder::kBlob:
+      return true;
+    default:
       return false;
-    }
   }
-  return true;
 }
 
-bool Query::MatchesBounds(const Document& doc) const {
-  const OrderByList& ordering = order_bys();
-  if (start_at_ && !start_at_->SortsBeforeDocument(ordering, doc)) {
-    return false;
-  }
-  if (end_at_ && !end_at_->SortsAfterDocument(ordering, doc)) {
-    return false;
+/**
+ * Encodes the fields the given document is ordered by with the index value
+ * encoding, or returns null if one of them has no encoding that sorts like
+ * the values. Numbers are encoded as doubles, so large integers may encode
+ * the same and then tie.
+ */
+std::shared_ptr<const DocumentSortKey> EncodeSortKey(
+    const std::shared_ptr<const OrderByList>& ordering,
+    const Document& document) {
+  index::IndexEncodingBuffer buffer;
+  for (const OrderBy& order_by : *ordering) {
+    auto* encoder = buffer.ForKind(order_by.ascending()
+                                       ? model::Segment::Kind::kAscending
+                                       : model::Segment::Kind::kDescending);
+    if (order_by.field().IsKeyFieldPath()) {
+      // Each segment is labeled and the path terminated, so that a path sorts
+      // before the paths it is a prefix of in either direction.
+      for (const std::string& segment : document->key().path()) {
+        encoder->WriteLong(kSortKeySegmentLabel);
+        encoder->WriteString(segment);
+      }
+      encoder->WriteLong(kSortKeyPathEnd);
+      continue;
+    }
+
+    absl::optional<google_firestore_v1_Value> value =
+        document->field(order_by.field());
+    if (!value || !HasSortableEncoding(model::GetTypeOrder(*value))) {
+      return nullptr;
+    }
+    index::WriteIndexValue(*value, encoder);
   }
-  return true;
+
+  auto sort_key = std::make_shared<DocumentSortKey>();
+  sort_key->ordering = ordering;
+  sort_key->bytes = buffer.GetEncodedBytes();
+  return sort_key;
 }
 
+}  // namespace
+
 model::DocumentComparator Query::Comparator() const {
-  OrderByList ordering = order_bys();
+  auto ordering = std::make_shared<const OrderByList>(order_bys());
 
   bool has_key_ordering = false;
-  for (const OrderBy& order_by : ordering) {
+  for (const OrderBy& order_by : *ordering) {
     if (order_by.field() == FieldPath::KeyFieldPath()) {
       has_key_ordering = true;
       break;
@@ -286,11 +327,22 @@ model::DocumentComparator Query::Comparator() const {
 
   return DocumentComparator(
       [ordering](const Document& doc1, const Document& doc2) {
-        for (const OrderBy& order_by : ordering) {
+        const auto& key1 = doc1.sort_key();
+        const auto& key2 = doc2.sort_key();
+        if (key1 && key2 && key1->ordering == ordering &&
+            key2->ordering == ordering) {
+          int comp = key1->bytes.compare(key2->bytes);
+          if (comp != 0) return util::ComparisonResultFromInt(comp);
+        }
+
+        for (const OrderBy& order_by : *ordering) {
           ComparisonResult comp = order_by.Compare(doc1, doc2);
           if (!util::Same(comp)) return comp;
         }
         return ComparisonResult::Same;
+      },
+      [ordering](const Document& document) {
+        return EncodeSortKey(ordering, document);
       });
 }
 
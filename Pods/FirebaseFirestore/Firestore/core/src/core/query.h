@@ -37,6 +37,7 @@ namespace firestore {
 namespace core {
 
 class Bound;
+class QueryMatcher;
 
 using CollectionGroupId = std::shared_ptr<const std::string>;
 
@@ -225,6 +226,22 @@ class Query {
   /** Returns true if the document matches the constraints of this query. */
   bool Matches(const model::Document& doc) const;
 
+  /**
+   * Returns the indexes of the documents that match the constraints of this
+   * query, in increasing order. This is equivalent to calling `Matches` for
+   * each document, but evaluates the constraints that need per-filter setup
+   * one at a time over the whole batch.
+   */
+  std::vector<size_t> MatchingIndexes(
+      const std::vector<model::MutableDocument>& documents) const;
+
+  /**
+   * Returns the compiled form of this query's matching constraints, which is
+   * built on first use and reused by later calls to `Matches` and
+   * `MatchingIndexes`.
+   */
+  const QueryMatcher& matcher() const;
+
   /**
    * Returns a comparator that will sort documents according to the order by
    * clauses in this query.
@@ -247,11 +264,6 @@ class Query {
   size_t Hash() const;
 
  private:
-  bool MatchesPathAndCollectionGroup(const model::Document& doc) const;
-  bool MatchesFilters(const model::Document& doc) const;
-  bool MatchesOrderBy(const model::Document& doc) const;
-  bool MatchesBounds(const model::Document& doc) const;
-
   model::ResourcePath path_;
   std::shared_ptr<const std::string> collection_group_;
 
@@ -276,6 +288,9 @@ class Query {
 
   // The corresponding Target of this Query instance.
   mutable std::shared_ptr<const Target> memoized_target;
+
+  // The compiled matching constraints of this Query instance.
+  mutable std::shared_ptr<const QueryMatcher> memoized_matcher_;
 };
 
 bool operator==(const Query& lhs, const Query& rhs);
@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/core/query_listener.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 
@@ -31,6 +32,7 @@ namespace core {
 using model::OnlineState;
 using model::TargetId;
 using util::Status;
+using util::TimerId;
 
 std::shared_ptr<QueryListener> QueryListener::Create(
     Query query, ListenOptions options, ViewSnapshotSharedListener&& listener) {
@@ -97,9 +99,12 @@ bool QueryListener::OnViewSnapshot(ViewSnapshot snapshot) {
       RaiseInitialEvent(snapshot);
       raised_event = true;
     }
+  } else if (pending_snapshot_) {
+    // Everything received while a snapshot is pending is folded into it, so
+    // that its document set stays the latest one.
+    CoalesceSnapshot(snapshot);
   } else if (ShouldRaiseEvent(snapshot)) {
-    listener_->OnEvent(snapshot);
-    raised_event = true;
+    raised_event = RaiseOrCoalesceEvent(snapshot);
   }
 
   snapshot_ = std::move(snapshot);
@@ -107,9 +112,16 @@ bool QueryListener::OnViewSnapshot(ViewSnapshot snapshot) {
 }
 
 void QueryListener::OnError(Status error) {
+  pending_snapshot_operation_.Cancel();
+  pending_snapshot_.reset();
   listener_->OnEvent(std::move(error));
 }
 
+void QueryListener::EnableSnapshotCoalescing(
+    std::shared_ptr<util::AsyncQueue> queue) {
+  coalescing_queue_ = std::move(queue);
+}
+
 /**
  * Returns whether a snaphsot was raised.
  */
@@ -180,9 +192,91 @@ void QueryListener::RaiseInitialEvent(const ViewSnapshot& snapshot) {
       snapshot.query(), snapshot.documents(), snapshot.mutated_keys(),
       snapshot.from_cache(), snapshot.excludes_metadata_changes());
   raised_initial_event_ = true;
+  last_event_time_ = std::chrono::steady_clock::now();
+  if (metrics_) {
+    metrics_->RecordSince(util::MetricHistogram::kTimeToFirstSnapshotMicros,
+                          created_time_);
+  }
   listener_->OnEvent(std::move(modified_snapshot));
 }
 
+bool QueryListener::RaiseOrCoalesceEvent(const ViewSnapshot& snapshot) {
+  std::chrono::milliseconds interval = options_.min_snapshot_interval();
+  auto now = std::chrono::steady_clock::now();
+  if (!coalescing_queue_ || interval.count() <= 0 ||
+      now - last_event_time_ >= interval) {
+    last_event_time_ = now;
+    listener_->OnEvent(snapshot);
+    return true;
+  }
+
+  pending_snapshot_ = snapshot;
+  auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+      last_event_time_ + interval - now);
+  std::weak_ptr<QueryListener> weak_this = shared_from_this();
+  pending_snapshot_operation_ = coalescing_queue_->EnqueueAfterDelay(
+      std::max(delay, std::chrono::milliseconds(0)),
+      TimerId::ListenerSnapshotCoalescing, [weak_this] {
+        if (auto strong_this = weak_this.lock()) {
+          strong_this->RaisePendingSnapshot();
+        }
+      });
+  return false;
+}
+
+void QueryListener::CoalesceSnapshot(const ViewSnapshot& snapshot) {
+  const ViewSnapshot& pending = *pending_snapshot_;
+
+  // DocumentViewChangeSet folds successive changes to a document into one,
+  // e.g. an add followed by a modification is an add.
+  DocumentViewChangeSet change_set;
+  for (const DocumentViewChange& change : pending.document_changes()) {
+    change_set.AddChange(DocumentViewChange(change));
+  }
+  for (const DocumentViewChange& change : snapshot.document_changes()) {
+    change_set.AddChange(DocumentViewChange(change));
+  }
+
+  std::vector<DocumentViewChange> changes = change_set.GetChanges();
+  model::DocumentComparator comparator = query_.Comparator();
+  std::sort(changes.begin(), changes.end(),
+            [&comparator](const DocumentViewChange& lhs,
+                          const DocumentViewChange& rhs) {
+              int pos1 = GetDocumentViewChangeTypePosition(lhs.type());
+              int pos2 = GetDocumentViewChangeTypePosition(rhs.type());
+              if (pos1 != pos2) {
+                return pos1 < pos2;
+              }
+              return util::Ascending(
+                  comparator.Compare(lhs.document(), rhs.document()));
+            });
+
+  pending_snapshot_ = ViewSnapshot{
+      snapshot.query(),
+      snapshot.documents(),
+      pending.old_documents(),
+      std::move(changes),
+      snapshot.mutated_keys(),
+      snapshot.from_cache(),
+      pending.sync_state_changed() || snapshot.sync_state_changed(),
+      snapshot.excludes_metadata_changes()};
+}
+
+void QueryListener::RaisePendingSnapshot() {
+  if (!pending_snapshot_) return;
+
+  ViewSnapshot snapshot = std::move(*pending_snapshot_);
+  pending_snapshot_.reset();
+
+  // Each merged snapshot was either raisable or arrived while this one was
+  // pending, but their document changes may have cancelled out.
+  if (!snapshot.document_changes().empty() ||
+      options_.include_query_metadata_changes()) {
+    last_event_time_ = std::chrono::steady_clock::now();
+    listener_->OnEvent(std::move(snapshot));
+  }
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
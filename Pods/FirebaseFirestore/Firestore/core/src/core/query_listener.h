@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_CORE_QUERY_LISTENER_H_
 #define FIRESTORE_CORE_SRC_CORE_QUERY_LISTENER_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <memory>
 #include <utility>
 
@@ -24,6 +25,8 @@
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/core/view_snapshot.h"
 #include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/status_fwd.h"
 #include "absl/types/optional.h"
 
@@ -35,7 +38,7 @@ namespace core {
  * QueryListener takes a series of internal view snapshots and determines when
  * to raise user-facing events.
  */
-class QueryListener {
+class QueryListener : public std::enable_shared_from_this<QueryListener> {
  public:
   static std::shared_ptr<QueryListener> Create(
       Query query,
@@ -78,15 +81,42 @@ class QueryListener {
 
   virtual void OnError(util::Status error);
 
+  /**
+   * Lets this listener coalesce snapshots according to the minimum snapshot
+   * interval in its options, using `queue` to raise deferred snapshots. Must
+   * be called on `queue`, which must be the queue snapshots arrive on.
+   */
+  void EnableSnapshotCoalescing(std::shared_ptr<util::AsyncQueue> queue);
+
   /** Returns whether a snapshot was raised. */
   virtual bool OnOnlineStateChanged(model::OnlineState online_state);
 
+  /**
+   * Records the time until the first snapshot into the given metrics, counted
+   * from this call. `metrics` may be null.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+    if (metrics_) {
+      created_time_ = util::Metrics::Clock::now();
+    }
+  }
+
  private:
   bool ShouldRaiseInitialEvent(const ViewSnapshot& snapshot,
                                model::OnlineState online_state) const;
   bool ShouldRaiseEvent(const ViewSnapshot& snapshot) const;
   void RaiseInitialEvent(const ViewSnapshot& snapshot);
 
+  /**
+   * Raises `snapshot` now, or merges it into the pending snapshot if the last
+   * snapshot was raised less than the minimum snapshot interval ago. Returns
+   * true if an event was raised.
+   */
+  bool RaiseOrCoalesceEvent(const ViewSnapshot& snapshot);
+  void CoalesceSnapshot(const ViewSnapshot& snapshot);
+  void RaisePendingSnapshot();
+
   Query query_;
   ListenOptions options_;
 
@@ -107,6 +137,20 @@ class QueryListener {
   model::OnlineState online_state_ = model::OnlineState::Unknown;
 
   absl::optional<ViewSnapshot> snapshot_;
+
+  /** Set when snapshot coalescing is enabled. */
+  std::shared_ptr<util::AsyncQueue> coalescing_queue_;
+
+  /**
+   * The snapshot merged from all snapshots received since the last raised
+   * one, waiting for the minimum interval to pass.
+   */
+  absl::optional<ViewSnapshot> pending_snapshot_;
+  util::DelayedOperation pending_snapshot_operation_;
+  std::chrono::steady_clock::time_point last_event_time_;
+
+  util::Metrics* metrics_ = nullptr;
+  util::Metrics::Clock::time_point created_time_;
 };
 
 }  // namespace core
@@ -0,0 +1,163 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/core/query_matcher.h"
+
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+using model::Document;
+using model::DocumentKey;
+using model::FieldPath;
+using model::GetTypeOrder;
+using model::MutableDocument;
+using Operator = FieldFilter::Operator;
+
+QueryMatcher::QueryMatcher(const Query& query)
+    : path_(query.path()),
+      collection_group_(query.collection_group()),
+      ordering_(query.order_bys()),
+      start_at_(query.start_at()),
+      end_at_(query.end_at()) {
+  if (collection_group_) {
+    // NOTE: path_ is currently always empty since we don't expose Collection
+    // Group queries rooted at a document path yet.
+    path_mode_ = PathMode::kCollectionGroup;
+  } else if (DocumentKey::IsDocumentKey(path_)) {
+    path_mode_ = PathMode::kDocument;
+  } else {
+    path_mode_ = PathMode::kCollection;
+  }
+
+  for (const OrderBy& order_by : query.explicit_order_bys()) {
+    // order by key always matches
+    if (order_by.field() != FieldPath::KeyFieldPath()) {
+      order_by_fields_.push_back(order_by.field());
+    }
+  }
+
+  for (const Filter& filter : query.filters()) {
+    // Subclasses of FieldFilter have their own matching rules.
+    if (filter.type() != Filter::Type::kFieldFilter) {
+      other_filters_.push_back(filter);
+      continue;
+    }
+
+    FieldFilter field_filter(filter);
+    const google_firestore_v1_Value& value = field_filter.value();
+    comparisons_.push_back(Comparison{field_filter, filter.field(), &value,
+                                      field_filter.op() == Operator::NotEqual,
+                                      GetTypeOrder(value)});
+  }
+}
+
+bool QueryMatcher::Matches(const Document& doc) const {
+  if (!doc->is_found_document() || !MatchesPath(doc->key()) ||
+      !MatchesFields(doc.get())) {
+    return false;
+  }
+  for (const Filter& filter : other_filters_) {
+    if (!filter.Matches(doc)) return false;
+  }
+  return MatchesBounds(doc);
+}
+
+std::vector<size_t> QueryMatcher::MatchingIndexes(
+    const std::vector<MutableDocument>& documents) const {
+  std::vector<size_t> candidates;
+  candidates.reserve(documents.size());
+  for (size_t i = 0; i < documents.size(); ++i) {
+    const MutableDocument& doc = documents[i];
+    if (doc.is_found_document() && MatchesPath(doc.key()) &&
+        MatchesFields(doc)) {
+      candidates.push_back(i);
+    }
+  }
+
+  for (const Filter& filter : other_filters_) {
+    if (candidates.empty()) break;
+    filter.RetainMatches(documents, &candidates);
+  }
+
+  if (start_at_ || end_at_) {
+    size_t kept = 0;
+    for (size_t index : candidates) {
+      if (MatchesBounds(Document(documents[index]))) {
+        candidates[kept++] = index;
+      }
+    }
+    candidates.resize(kept);
+  }
+  return candidates;
+}
+
+bool QueryMatcher::MatchesPath(const DocumentKey& key) const {
+  const model::ResourcePath& doc_path = key.path();
+  switch (path_mode_) {
+    case PathMode::kCollectionGroup:
+      return key.HasCollectionGroup(*collection_group_) &&
+             path_.IsPrefixOf(doc_path);
+    case PathMode::kDocument:
+      return path_ == doc_path;
+    case PathMode::kCollection:
+      return path_.IsImmediateParentOf(doc_path);
+  }
+  UNREACHABLE();
+}
+
+bool QueryMatcher::MatchesFields(const MutableDocument& doc) const {
+  for (const FieldPath& field : order_by_fields_) {
+    if (doc.field(field) == absl::nullopt) return false;
+  }
+
+  for (const Comparison& comparison : comparisons_) {
+    absl::optional<google_firestore_v1_Value> lhs = doc.field(comparison.field);
+    if (!lhs) return false;
+
+    // Only compare types with matching backend order (such as double and int),
+    // except for NotEqual filters.
+    if (!comparison.any_type && GetTypeOrder(*lhs) != comparison.type_order) {
+      return false;
+    }
+    if (!comparison.filter.MatchesComparison(
+            model::Compare(*lhs, *comparison.value))) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool QueryMatcher::MatchesBounds(const Document& doc) const {
+  if (start_at_ && !start_at_->SortsBeforeDocument(ordering_, doc)) {
+    return false;
+  }
+  if (end_at_ && !end_at_->SortsAfterDocument(ordering_, doc)) {
+    return false;
+  }
+  return true;
+}
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
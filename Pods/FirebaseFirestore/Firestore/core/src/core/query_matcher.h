@@ -0,0 +1,119 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
+#define FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
+#include "Firestore/core/src/core/bound.h"
+#include "Firestore/core/src/core/field_filter.h"
+#include "Firestore/core/src/core/filter.h"
+#include "Firestore/core/src/core/order_by.h"
+#include "Firestore/core/src/immutable/append_only_list.h"
+#include "Firestore/core/src/model/field_path.h"
+#include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/resource_path.h"
+#include "Firestore/core/src/model/value_util.h"
+#include "Firestore/core/src/util/comparison.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace core {
+
+class Query;
+
+/**
+ * A compiled form of the matching constraints of a `Query`.
+ *
+ * `Query::Matches` re-interprets the query on every call: it re-derives how
+ * the path should be matched, walks the filter list dispatching through each
+ * filter, and rebuilds the full ordering for bounds checks. A QueryMatcher
+ * does all of that once, flattening plain field comparisons into a list with
+ * the type order of the constant precomputed. Filters with their own matching
+ * rules (array and `in` filters, key filters) are kept and evaluated as they
+ * are.
+ *
+ * A QueryMatcher gives exactly the same answers as the query it was compiled
+ * from. Obtain one through `Query::matcher()`, which compiles it on first use.
+ */
+class QueryMatcher {
+ public:
+  explicit QueryMatcher(const Query& query);
+
+  /** Returns true if the document matches the constraints of the query. */
+  bool Matches(const model::Document& doc) const;
+
+  /**
+   * Returns the indexes of the documents that match the constraints of the
+   * query, in increasing order.
+   */
+  std::vector<size_t> MatchingIndexes(
+      const std::vector<model::MutableDocument>& documents) const;
+
+ private:
+  enum class PathMode {
+    /** Matches documents in a collection group below `path_`. */
+    kCollectionGroup,
+    /** Matches the single document at `path_`. */
+    kDocument,
+    /** Matches documents that are immediate children of `path_`. */
+    kCollection,
+  };
+
+  /** A filter comparing a field with a constant using a relation operator. */
+  struct Comparison {
+    /** The filter this was compiled from, which owns `value`. */
+    FieldFilter filter;
+    model::FieldPath field;
+    const google_firestore_v1_Value* value;
+    /** True if the field may hold a value of any type (as for `!=`). */
+    bool any_type;
+    model::TypeOrder type_order;
+  };
+
+  bool MatchesPath(const model::DocumentKey& key) const;
+
+  /**
+   * Returns true if the document has all order-by fields and matches all
+   * flattened comparisons.
+   */
+  bool MatchesFields(const model::MutableDocument& doc) const;
+
+  bool MatchesBounds(const model::Document& doc) const;
+
+  PathMode path_mode_;
+  model::ResourcePath path_;
+  std::shared_ptr<const std::string> collection_group_;
+
+  std::vector<model::FieldPath> order_by_fields_;
+  std::vector<Comparison> comparisons_;
+  std::vector<Filter> other_filters_;
+
+  OrderByList ordering_;
+  absl::optional<Bound> start_at_;
+  absl::optional<Bound> end_at_;
+};
+
+}  // namespace core
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_CORE_QUERY_MATCHER_H_
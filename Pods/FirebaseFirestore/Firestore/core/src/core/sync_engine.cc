@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/core/sync_engine.h"
 
+#include <algorithm>
+
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
 #include "Firestore/core/src/bundle/bundle_element.h"
 #include "Firestore/core/src/bundle/bundle_loader.h"
@@ -34,8 +36,10 @@
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/mutation_batch_result.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/equality.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/status.h"
+#include "absl/algorithm/container.h"
 #include "absl/strings/match.h"
 
 namespace firebase {
@@ -108,12 +112,18 @@ TargetId SyncEngine::Listen(Query query) {
   HARD_ASSERT(query_views_by_query_.find(query) == query_views_by_query_.end(),
               "We already listen to query: %s", query.ToString());
 
-  TargetData target_data = local_store_->AllocateTarget(query.ToTarget());
-  TargetId target_id = target_data.target_id();
-  remote_store_->Listen(std::move(target_data));
+  TargetId target_id;
+  absl::optional<TargetId> shared_target = FindSharedTarget(query);
+  if (shared_target) {
+    target_id = *shared_target;
+  } else {
+    TargetData target_data = local_store_->AllocateTarget(query.ToTarget());
+    target_id = target_data.target_id();
+    remote_store_->Listen(std::move(target_data));
+  }
 
-  ViewSnapshot view_snapshot =
-      InitializeViewAndComputeSnapshot(query, target_id);
+  ViewSnapshot view_snapshot = InitializeViewAndComputeSnapshot(
+      query, target_id, shared_target.has_value());
   std::vector<ViewSnapshot> snapshots;
   // Not using the `std::initializer_list` constructor to avoid extra copies.
   snapshots.push_back(std::move(view_snapshot));
@@ -123,7 +133,8 @@ TargetId SyncEngine::Listen(Query query) {
 }
 
 ViewSnapshot SyncEngine::InitializeViewAndComputeSnapshot(const Query& query,
-                                                          TargetId target_id) {
+                                                          TargetId target_id,
+                                                          bool served) {
   QueryResult query_result =
       local_store_->ExecuteQuery(query, /* use_previous_results= */ true);
 
@@ -131,15 +142,22 @@ ViewSnapshot SyncEngine::InitializeViewAndComputeSnapshot(const Query& query,
   // target change to apply the sync state from those queries to the new query.
   auto current_sync_state = SyncState::None;
   absl::optional<TargetChange> synthesized_current_change;
+  DocumentKeySet remote_keys = query_result.remote_keys();
   if (queries_by_target_.find(target_id) != queries_by_target_.end()) {
     const Query& mirror_query = queries_by_target_[target_id][0];
     current_sync_state =
         query_views_by_query_[mirror_query]->view().sync_state();
     synthesized_current_change = TargetChange::CreateSynthesizedTargetChange(
         current_sync_state == SyncState::Synced);
+
+    // A query served from a shared target has no target data of its own, so
+    // it tracks the documents of the shared target.
+    if (served) {
+      remote_keys = local_store_->GetRemoteDocumentKeys(target_id);
+    }
   }
 
-  View view(query, query_result.remote_keys());
+  View view(query, std::move(remote_keys));
   ViewDocumentChanges view_doc_changes =
       view.ComputeDocumentChanges(query_result.documents());
   ViewChange view_change =
@@ -147,7 +165,7 @@ ViewSnapshot SyncEngine::InitializeViewAndComputeSnapshot(const Query& query,
   UpdateTrackedLimboDocuments(view_change.limbo_changes(), target_id);
 
   auto query_view =
-      std::make_shared<QueryView>(query, target_id, std::move(view));
+      std::make_shared<QueryView>(query, target_id, std::move(view), served);
   query_views_by_query_[query] = query_view;
 
   queries_by_target_[target_id].push_back(query);
@@ -158,6 +176,42 @@ ViewSnapshot SyncEngine::InitializeViewAndComputeSnapshot(const Query& query,
   return view_change.snapshot().value();
 }
 
+absl::optional<TargetId> SyncEngine::FindSharedTarget(
+    const Query& query) const {
+  if (!shared_targets_enabled_) {
+    return absl::nullopt;
+  }
+
+  for (const auto& entry : query_views_by_query_) {
+    const Query& candidate = entry.first;
+    // Queries for the same target already share it without being served.
+    if (candidate.ToTarget() == query.ToTarget()) {
+      return absl::nullopt;
+    }
+    if (candidate.limit_type() != LimitType::None || candidate.start_at() ||
+        candidate.end_at() || candidate.path() != query.path() ||
+        !util::Equals(candidate.collection_group(),
+                      query.collection_group()) ||
+        candidate.filters() != query.filters()) {
+      continue;
+    }
+
+    bool orders_covered = true;
+    for (const OrderBy& order_by : candidate.explicit_order_bys()) {
+      if (order_by.field().IsKeyFieldPath()) continue;
+      orders_covered = absl::c_any_of(
+          query.order_bys(), [&order_by](const OrderBy& query_order_by) {
+            return query_order_by.field() == order_by.field();
+          });
+      if (!orders_covered) break;
+    }
+    if (orders_covered) {
+      return entry.second->target_id();
+    }
+  }
+  return absl::nullopt;
+}
+
 void SyncEngine::StopListening(const Query& query) {
   AssertCallbackExists("StopListening");
 
@@ -245,7 +299,8 @@ void SyncEngine::Transaction(int max_attempts,
   // Allocate a shared_ptr so that the TransactionRunner can outlive this frame.
   auto runner = std::make_shared<TransactionRunner>(
       worker_queue, remote_store_, std::move(update_callback),
-      std::move(result_callback), max_attempts);
+      std::move(result_callback), max_attempts,
+      transaction_read_reuse_enabled_);
   runner->Run();
 }
 
@@ -280,26 +335,25 @@ void SyncEngine::ApplyRemoteEvent(const RemoteEvent& remote_event) {
     }
 
     LimboResolution& limbo_resolution = it->second;
-    // Since this is a limbo resolution lookup, it's for a single document and
-    // it could be added, modified, or removed, but not a combination.
-    auto changed_documents_count = change.added_documents().size() +
-                                   change.modified_documents().size() +
-                                   change.removed_documents().size();
-    HARD_ASSERT(
-        changed_documents_count <= 1,
-        "Limbo resolution for single document contains multiple changes.");
-
-    if (!change.added_documents().empty()) {
-      limbo_resolution.document_received = true;
-    } else if (!change.modified_documents().empty()) {
-      HARD_ASSERT(limbo_resolution.document_received,
+    // Since this is a limbo resolution lookup, each of its documents could be
+    // added, modified, or removed, but not a combination. A change without
+    // documents was probably just a CURRENT target change or similar.
+    for (const DocumentKey& key : change.added_documents()) {
+      HARD_ASSERT(limbo_resolution.keys.contains(key),
+                  "Received document %s not watched by limbo target.",
+                  key.ToString());
+      limbo_resolution.received_keys =
+          limbo_resolution.received_keys.insert(key);
+    }
+    for (const DocumentKey& key : change.modified_documents()) {
+      HARD_ASSERT(limbo_resolution.received_keys.contains(key),
                   "Received change for limbo target document without add.");
-    } else if (!change.removed_documents().empty()) {
-      HARD_ASSERT(limbo_resolution.document_received,
+    }
+    for (const DocumentKey& key : change.removed_documents()) {
+      HARD_ASSERT(limbo_resolution.received_keys.contains(key),
                   "Received remove for limbo target document without add.");
-      limbo_resolution.document_received = false;
-    } else {
-      // This was probably just a CURRENT target change or similar.
+      limbo_resolution.received_keys =
+          limbo_resolution.received_keys.erase(key);
     }
   }
 
@@ -312,10 +366,12 @@ void SyncEngine::HandleRejectedListen(TargetId target_id, Status error) {
 
   auto it = active_limbo_resolutions_by_target_.find(target_id);
   if (it != active_limbo_resolutions_by_target_.end()) {
-    DocumentKey limbo_key = it->second.key;
+    DocumentKeySet limbo_keys = ActiveLimboKeys(target_id, it->second);
     // Since this query failed, we won't want to manually unlisten to it.
     // So go ahead and remove it from bookkeeping.
-    active_limbo_targets_by_key_.erase(limbo_key);
+    for (const DocumentKey& limbo_key : limbo_keys) {
+      active_limbo_targets_by_key_.erase(limbo_key);
+    }
     active_limbo_resolutions_by_target_.erase(target_id);
     PumpEnqueuedLimboResolutions();
 
@@ -325,17 +381,20 @@ void SyncEngine::HandleRejectedListen(TargetId target_id, Status error) {
     // kind of a hack. Ideally, we would have a method in the local store to
     // purge a document. However, it would be tricky to keep all of the local
     // store's invariants with another method.
-    MutableDocument doc =
-        MutableDocument::NoDocument(limbo_key, SnapshotVersion::None());
-
+    //
     // Explicitly instantiate these to work around a bug in the default
     // constructor of the std::unordered_map that comes with GCC 4.8. Without
     // this GCC emits a spurious "chosen constructor is explicit in
     // copy-initialization" error.
-    DocumentKeySet limbo_documents{limbo_key};
+    DocumentKeySet limbo_documents = limbo_keys;
     RemoteEvent::TargetChangeMap target_changes;
     RemoteEvent::TargetSet target_mismatches;
-    DocumentUpdateMap document_updates{{limbo_key, doc}};
+    DocumentUpdateMap document_updates;
+    for (const DocumentKey& limbo_key : limbo_keys) {
+      document_updates.emplace(
+          limbo_key,
+          MutableDocument::NoDocument(limbo_key, SnapshotVersion::None()));
+    }
 
     RemoteEvent event{SnapshotVersion::None(), std::move(target_changes),
                       std::move(target_mismatches), std::move(document_updates),
@@ -407,9 +466,8 @@ void SyncEngine::HandleOnlineStateChange(model::OnlineState online_state) {
 
 DocumentKeySet SyncEngine::GetRemoteKeys(TargetId target_id) const {
   auto it = active_limbo_resolutions_by_target_.find(target_id);
-  if (it != active_limbo_resolutions_by_target_.end() &&
-      it->second.document_received) {
-    return DocumentKeySet{it->second.key};
+  if (it != active_limbo_resolutions_by_target_.end()) {
+    return it->second.received_keys;
   } else {
     DocumentKeySet keys;
     if (queries_by_target_.count(target_id) == 0) {
@@ -499,9 +557,25 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
 
     if (view_change.snapshot().has_value()) {
       new_snapshots.push_back(*view_change.snapshot());
-      LocalViewChanges doc_changes = LocalViewChanges::FromViewSnapshot(
-          *view_change.snapshot(), query_view->target_id());
-      document_changes_in_all_views.push_back(std::move(doc_changes));
+      // A served query only holds some of the documents of its target, so the
+      // query that owns the target pins the documents on its behalf.
+      if (!query_view->served()) {
+        LocalViewChanges doc_changes = LocalViewChanges::FromViewSnapshot(
+            *view_change.snapshot(), query_view->target_id());
+        document_changes_in_all_views.push_back(std::move(doc_changes));
+      }
+    }
+  }
+
+  // The next index-free run of a target skips the documents that were in
+  // limbo for any of its views, so a target only becomes limbo-free once all
+  // of its views are.
+  for (LocalViewChanges& doc_changes : document_changes_in_all_views) {
+    if (!doc_changes.is_from_cache() &&
+        !AreAllViewsSynced(doc_changes.target_id())) {
+      doc_changes = LocalViewChanges(
+          doc_changes.target_id(), /* from_cache= */ true,
+          doc_changes.added_keys(), doc_changes.removed_keys());
     }
   }
 
@@ -509,6 +583,18 @@ void SyncEngine::EmitNewSnapshotsAndNotifyLocalStore(
   local_store_->NotifyLocalViewChanges(document_changes_in_all_views);
 }
 
+bool SyncEngine::AreAllViewsSynced(TargetId target_id) const {
+  auto queries = queries_by_target_.find(target_id);
+  if (queries == queries_by_target_.end()) {
+    return true;
+  }
+  return absl::c_all_of(queries->second, [this](const Query& query) {
+    auto query_view = query_views_by_query_.find(query);
+    return query_view == query_views_by_query_.end() ||
+           query_view->second->view().sync_state() == SyncState::Synced;
+  });
+}
+
 void SyncEngine::UpdateTrackedLimboDocuments(
     const std::vector<LimboDocumentChange>& limbo_changes, TargetId target_id) {
   for (const LimboDocumentChange& limbo_change : limbo_changes) {
@@ -545,18 +631,30 @@ void SyncEngine::TrackLimboChange(const LimboDocumentChange& limbo_change) {
 }
 
 void SyncEngine::PumpEnqueuedLimboResolutions() {
+  size_t batch_size = std::max<size_t>(limbo_resolution_batch_size_, 1);
   while (!enqueued_limbo_resolutions_.empty() &&
-         active_limbo_targets_by_key_.size() <
+         active_limbo_resolutions_by_target_.size() <
              max_concurrent_limbo_resolutions_) {
-    DocumentKey key = enqueued_limbo_resolutions_.front();
-    enqueued_limbo_resolutions_.pop_front();
     TargetId limbo_target_id = target_id_generator_.NextId();
+    DocumentKeySet keys;
+    while (!enqueued_limbo_resolutions_.empty() && keys.size() < batch_size) {
+      DocumentKey key = enqueued_limbo_resolutions_.front();
+      enqueued_limbo_resolutions_.pop_front();
+      active_limbo_targets_by_key_.emplace(key, limbo_target_id);
+      keys = keys.insert(key);
+    }
+
+    // A single document is watched through its document query, as before
+    // batching; a batch through a target naming all of its documents.
+    TargetData target_data(Query(keys.min()->path()).ToTarget(),
+                           limbo_target_id, kIrrelevantSequenceNumber,
+                           QueryPurpose::LimboResolution);
+    if (keys.size() > 1) {
+      target_data = target_data.WithDocumentKeys(keys);
+    }
     active_limbo_resolutions_by_target_.emplace(limbo_target_id,
-                                                LimboResolution{key});
-    active_limbo_targets_by_key_.emplace(key, limbo_target_id);
-    remote_store_->Listen(TargetData(Query(key.path()).ToTarget(),
-                                     limbo_target_id, kIrrelevantSequenceNumber,
-                                     QueryPurpose::LimboResolution));
+                                                LimboResolution{keys});
+    remote_store_->Listen(std::move(target_data));
   }
 }
 
@@ -569,17 +667,38 @@ void SyncEngine::RemoveLimboTarget(const DocumentKey& key) {
   }
 
   TargetId limbo_target_id = it->second;
+  active_limbo_targets_by_key_.erase(it);
+
+  // A batched target keeps watching its other documents until none of them
+  // is in limbo anymore.
+  auto resolution = active_limbo_resolutions_by_target_.find(limbo_target_id);
+  if (resolution != active_limbo_resolutions_by_target_.end() &&
+      !ActiveLimboKeys(limbo_target_id, resolution->second).empty()) {
+    return;
+  }
+
   remote_store_->StopListening(limbo_target_id);
-  active_limbo_targets_by_key_.erase(key);
   active_limbo_resolutions_by_target_.erase(limbo_target_id);
   PumpEnqueuedLimboResolutions();
 }
 
+DocumentKeySet SyncEngine::ActiveLimboKeys(
+    TargetId target_id, const LimboResolution& limbo_resolution) const {
+  DocumentKeySet result;
+  for (const DocumentKey& key : limbo_resolution.keys) {
+    auto it = active_limbo_targets_by_key_.find(key);
+    if (it != active_limbo_targets_by_key_.end() && it->second == target_id) {
+      result = result.insert(key);
+    }
+  }
+  return result;
+}
+
 absl::optional<BundleLoader> SyncEngine::ReadIntoLoader(
     const bundle::BundleMetadata& metadata,
     bundle::BundleReader& reader,
     api::LoadBundleTask& result_task) {
-  BundleLoader loader(local_store_, metadata);
+  BundleLoader loader(local_store_, metadata, bundle_documents_per_chunk_);
   int64_t current_bytes_read = 0;
   // Breaks when either error happened, or when there is no more element to
   // read.
@@ -608,6 +727,11 @@ absl::optional<BundleLoader> SyncEngine::ReadIntoLoader(
       return absl::nullopt;
     }
 
+    absl::optional<DocumentMap> applied = loader.TakeAppliedChanges();
+    if (applied.has_value()) {
+      EmitNewSnapshotsAndNotifyLocalStore(applied.value(), absl::nullopt);
+    }
+
     if (maybe_progress.ValueOrDie().has_value()) {
       result_task.UpdateProgress(maybe_progress.ConsumeValueOrDie().value());
     }
@@ -153,6 +153,52 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
   void LoadBundle(std::shared_ptr<bundle::BundleReader> reader,
                   std::shared_ptr<api::LoadBundleTask> result_task);
 
+  /**
+   * Makes bundle loads write their documents to the local store in chunks of
+   * the given size while the bundle is read, raising snapshots per chunk,
+   * instead of buffering the whole bundle. Zero disables chunking.
+   */
+  void set_bundle_documents_per_chunk(size_t documents_per_chunk) {
+    bundle_documents_per_chunk_ = documents_per_chunk;
+  }
+
+  /**
+   * Lets a new query that only differs from an active query by its limit,
+   * bounds or ordering be served from that query's watch target, filtering
+   * its results locally in its View, instead of listening to a target of its
+   * own.
+   */
+  void set_shared_targets_enabled(bool enabled) {
+    shared_targets_enabled_ = enabled;
+  }
+
+  /**
+   * Makes limbo resolution watch up to the given number of documents with a
+   * single documents target, so that each of the concurrent limbo resolutions
+   * resolves a batch of documents. Zero or one resolves each document with a
+   * target of its own.
+   */
+  void set_limbo_resolution_batch_size(size_t batch_size) {
+    limbo_resolution_batch_size_ = batch_size;
+  }
+
+  /**
+   * Makes retried transactions reuse the reads of earlier attempts that didn't
+   * conflict, fetching only the contended documents again.
+   */
+  void set_transaction_read_reuse_enabled(bool enabled) {
+    transaction_read_reuse_enabled_ = enabled;
+  }
+
+  /**
+   * Returns the number of documents in limbo that are being resolved or
+   * waiting for resolution.
+   */
+  size_t GetOutstandingLimboDocumentCount() const {
+    return active_limbo_targets_by_key_.size() +
+           enqueued_limbo_resolutions_.size();
+  }
+
   // For tests only
   std::map<model::DocumentKey, model::TargetId>
   GetActiveLimboDocumentResolutions() const {
@@ -172,10 +218,14 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
    */
   class QueryView {
    public:
-    QueryView(Query query, model::TargetId target_id, View view)
+    QueryView(Query query,
+              model::TargetId target_id,
+              View view,
+              bool served = false)
         : query_(std::move(query)),
           target_id_(target_id),
-          view_(std::move(view)) {
+          view_(std::move(view)),
+          served_(served) {
     }
 
     const Query& query() const {
@@ -200,40 +250,72 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
       return view_;
     }
 
+    /**
+     * Whether the query is served from the target of a broader query, so that
+     * its results are only a subset of the documents of its target.
+     */
+    bool served() const {
+      return served_;
+    }
+
    private:
     Query query_;
     model::TargetId target_id_;
     View view_;
+    bool served_ = false;
   };
 
-  /** Tracks a limbo resolution. */
+  /** Tracks a limbo resolution, which resolves one or more documents. */
   class LimboResolution {
    public:
     LimboResolution() = default;
 
-    explicit LimboResolution(const model::DocumentKey& key) : key{key} {
+    explicit LimboResolution(model::DocumentKeySet keys)
+        : keys{std::move(keys)} {
     }
 
-    model::DocumentKey key;
+    /**
+     * The documents watched by the limbo resolution target. This does not
+     * shrink as documents leave limbo, since the target still watches them.
+     */
+    model::DocumentKeySet keys;
 
     /**
-     * Set to true once we've received a document. This is used in
-     * RemoteKeysForTarget and ultimately used by `WatchChangeAggregator` to
-     * decide whether it needs to manufacture a delete event for the target once
-     * the target is CURRENT.
+     * The documents we've received. This is used in RemoteKeysForTarget and
+     * ultimately used by `WatchChangeAggregator` to decide whether it needs to
+     * manufacture a delete event for a document once the target is CURRENT.
      */
-    bool document_received = false;
+    model::DocumentKeySet received_keys;
   };
 
   void AssertCallbackExists(absl::string_view source);
 
   ViewSnapshot InitializeViewAndComputeSnapshot(const Query& query,
-                                                model::TargetId target_id);
+                                                model::TargetId target_id,
+                                                bool served);
+
+  /** Whether all views of `target_id` are current and limbo-free. */
+  bool AreAllViewsSynced(model::TargetId target_id) const;
+
+  /**
+   * Returns the target of an active query whose results are a superset of
+   * the results of `query`, if any. Such a query has the same path and
+   * filters, no limit and no bounds, and only orders by fields `query` also
+   * orders by, since ordering by a field excludes documents without it.
+   */
+  absl::optional<model::TargetId> FindSharedTarget(const Query& query) const;
 
   void RemoveAndCleanupTarget(model::TargetId target_id, util::Status status);
 
   void RemoveLimboTarget(const model::DocumentKey& key);
 
+  /**
+   * Returns the keys of the given limbo resolution target that are still in
+   * limbo.
+   */
+  model::DocumentKeySet ActiveLimboKeys(
+      model::TargetId target_id, const LimboResolution& limbo_resolution) const;
+
   void EmitNewSnapshotsAndNotifyLocalStore(
       const model::DocumentMap& changes,
       const absl::optional<remote::RemoteEvent>& maybe_remote_event);
@@ -307,6 +389,14 @@ class SyncEngine : public remote::RemoteStoreCallback, public QueryEventSource {
 
   const size_t max_concurrent_limbo_resolutions_;
 
+  size_t bundle_documents_per_chunk_ = 0;
+
+  bool shared_targets_enabled_ = false;
+
+  size_t limbo_resolution_batch_size_ = 0;
+
+  bool transaction_read_reuse_enabled_ = false;
+
   /**
    * The keys of documents that are in limbo for which we haven't yet started a
    * limbo resolution query.
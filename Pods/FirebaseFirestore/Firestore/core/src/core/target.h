@@ -93,6 +93,10 @@ class Target {
     return limit_;
   }
 
+  bool HasLimit() const {
+    return limit_ != kNoLimit;
+  }
+
   const absl::optional<Bound>& start_at() const {
     return start_at_;
   }
@@ -101,6 +105,16 @@ class Target {
     return end_at_;
   }
 
+  /**
+   * Returns the number of segments of a perfect index for this target.
+   *
+   * Equality, inequality and order-by clauses each contribute one segment per
+   * distinct field; all ArrayContains/ArrayContainsAny filters share a single
+   * segment. Document key filters and orders are not counted since the key is
+   * always part of the index entry.
+   */
+  size_t GetSegmentCount() const;
+
   /** Returns the order of the document key component. */
   core::Direction GetKeyOrder() const {
     return order_bys_.back().direction();
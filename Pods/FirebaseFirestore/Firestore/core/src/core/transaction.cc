@@ -75,6 +75,7 @@ Status Transaction::RecordVersion(const Document& doc) {
     return Status::OK();
   } else {
     read_versions_[doc->key()] = doc_version;
+    read_documents_.emplace(doc->key(), doc);
     return Status::OK();
   }
 }
@@ -91,6 +92,22 @@ void Transaction::Lookup(const std::vector<DocumentKey>& keys,
     return;
   }
 
+  std::vector<Document> reused_documents;
+  std::vector<DocumentKey> keys_to_fetch;
+  for (const DocumentKey& key : keys) {
+    auto found = reusable_reads_.find(key);
+    if (found != reusable_reads_.end()) {
+      reused_documents.push_back(found->second);
+    } else {
+      keys_to_fetch.push_back(key);
+    }
+  }
+
+  if (keys_to_fetch.empty()) {
+    FinishLookup(std::move(reused_documents), callback);
+    return;
+  }
+
   std::shared_ptr<Datastore> datastore = datastore_.lock();
   if (!datastore) {
     callback(Status(Error::kErrorFailedPrecondition,
@@ -98,29 +115,45 @@ void Transaction::Lookup(const std::vector<DocumentKey>& keys,
     return;
   }
 
-  datastore->LookupDocuments(
-      keys,
-      [this, callback](const StatusOr<std::vector<Document>>& maybe_documents) {
-        if (!maybe_documents.ok()) {
-          callback(maybe_documents.status());
+  // Fetched documents are collected as they arrive, straight into the
+  // result, without being buffered by the datastore first.
+  auto documents = std::make_shared<std::vector<Document>>();
+  documents->reserve(keys.size());
+  datastore->StreamLookupDocuments(
+      keys_to_fetch,
+      [documents](Document&& document) {
+        documents->push_back(std::move(document));
+      },
+      [this, callback, reused_documents, documents](const Status& status) {
+        if (!status.ok()) {
+          callback(status);
           return;
         }
 
-        const auto& documents = maybe_documents.ValueOrDie();
-        for (const Document& doc : documents) {
-          Status record_error = RecordVersion(doc);
-          if (!record_error.ok()) {
-            callback(record_error);
-            return;
-          }
-        }
-
-        // TODO(varconst): see if `maybe_documents` can be moved into the
-        // callback.
-        callback(maybe_documents);
+        documents->insert(documents->end(), reused_documents.begin(),
+                          reused_documents.end());
+        // Lookup results are sorted by key.
+        std::sort(documents->begin(), documents->end(),
+                  [](const Document& lhs, const Document& rhs) {
+                    return lhs->key() < rhs->key();
+                  });
+        FinishLookup(std::move(*documents), callback);
       });
 }
 
+void Transaction::FinishLookup(std::vector<Document> documents,
+                               const LookupCallback& callback) {
+  for (const Document& doc : documents) {
+    Status record_error = RecordVersion(doc);
+    if (!record_error.ok()) {
+      callback(record_error);
+      return;
+    }
+  }
+
+  callback(std::move(documents));
+}
+
 void Transaction::WriteMutations(std::vector<Mutation>&& mutations) {
   EnsureCommitNotCalled();
   // `move` will become appropriate once `Mutation` is replaced by the C++
@@ -23,6 +23,7 @@
 #include <unordered_set>
 #include <vector>
 
+#include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/mutation.h"
 #include "Firestore/core/src/model/snapshot_version.h"
@@ -36,7 +37,6 @@ namespace firestore {
 
 namespace model {
 class Precondition;
-class Document;
 }  // namespace model
 
 namespace remote {
@@ -52,6 +52,9 @@ class Transaction {
  public:
   using LookupCallback =
       std::function<void(const util::StatusOr<std::vector<model::Document>>&)>;
+  using ReadDocuments = std::unordered_map<model::DocumentKey,
+                                           model::Document,
+                                           model::DocumentKeyHash>;
 
   Transaction() = default;
   explicit Transaction(std::shared_ptr<remote::Datastore> datastore);
@@ -63,6 +66,20 @@ class Transaction {
   void Lookup(const std::vector<model::DocumentKey>& keys,
               LookupCallback&& callback);
 
+  /**
+   * Serves lookups of the given documents from the given copies instead of
+   * fetching them again, e.g. reads of an earlier attempt of this transaction
+   * that didn't conflict. The commit still verifies their versions.
+   */
+  void ReuseReads(ReadDocuments documents) {
+    reusable_reads_ = std::move(documents);
+  }
+
+  /** Returns the documents read so far, whether fetched or reused. */
+  const ReadDocuments& read_documents() const {
+    return read_documents_;
+  }
+
   /**
    * Stores mutation for the given key and set data, to be committed when
    * `Commit` is called.
@@ -108,6 +125,13 @@ class Transaction {
    */
   util::Status RecordVersion(const model::Document& doc);
 
+  /**
+   * Records the versions of the documents a lookup returned and passes them on
+   * to its callback.
+   */
+  void FinishLookup(std::vector<model::Document> documents,
+                    const LookupCallback& callback);
+
   /** Stores mutations to be written when `Commit` is called. */
   void WriteMutations(std::vector<model::Mutation>&& mutations);
 
@@ -153,6 +177,9 @@ class Transaction {
                      model::SnapshotVersion,
                      model::DocumentKeyHash>
       read_versions_;
+
+  ReadDocuments reusable_reads_;
+  ReadDocuments read_documents_;
 };
 
 using TransactionResultCallback = util::StatusCallback;
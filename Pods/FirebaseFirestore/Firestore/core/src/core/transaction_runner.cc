@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/core/transaction_runner.h"
 
+#include <algorithm>
+#include <random>
 #include <utility>
 
 #include "Firestore/core/src/remote/exponential_backoff.h"
@@ -26,6 +28,8 @@ namespace firestore {
 namespace core {
 namespace {
 
+using model::Document;
+using model::SnapshotVersion;
 using remote::RemoteStore;
 using util::AsyncQueue;
 using util::Status;
@@ -40,19 +44,32 @@ bool IsRetryableTransactionError(const util::Status& error) {
          code == Error::kErrorFailedPrecondition ||
          !remote::Datastore::IsPermanentError(error);
 }
+
+/**
+ * The most a retry waits on top of its backoff per attempt that found a
+ * document it reads changed, and the most attempts that count.
+ */
+constexpr AsyncQueue::Milliseconds kContentionDelay{250};
+constexpr int kMaxContentionCount = 8;
+
+SnapshotVersion ReadVersion(const Document& doc) {
+  return doc->is_found_document() ? doc->version() : SnapshotVersion::None();
+}
 }  // namespace
 
 TransactionRunner::TransactionRunner(const std::shared_ptr<AsyncQueue>& queue,
                                      RemoteStore* remote_store,
                                      TransactionUpdateCallback update_callback,
                                      TransactionResultCallback result_callback,
-                                     int max_attempts)
+                                     int max_attempts,
+                                     bool reuse_reads)
     : queue_{queue},
       remote_store_{remote_store},
       update_callback_{std::move(update_callback)},
       result_callback_{std::move(result_callback)},
       backoff_{queue_, TimerId::RetryTransaction},
-      attempts_remaining_{max_attempts} {
+      attempts_remaining_{max_attempts},
+      reuse_reads_{reuse_reads} {
   HARD_ASSERT(max_attempts >= 0, "invalid max_attempts: %s", max_attempts);
 }
 
@@ -64,6 +81,10 @@ void TransactionRunner::Run() {
   backoff_.BackoffAndRun([shared_this] {
     std::shared_ptr<Transaction> transaction =
         shared_this->remote_store_->CreateTransaction();
+    shared_this->reused_reads_ = !shared_this->reusable_reads_.empty();
+    if (shared_this->reused_reads_) {
+      transaction->ReuseReads(shared_this->reusable_reads_);
+    }
     shared_this->update_callback_(
         transaction, [transaction, shared_this](const util::Status& status) {
           shared_this->queue_->Enqueue([transaction, shared_this, status] {
@@ -98,12 +119,57 @@ void TransactionRunner::HandleTransactionError(
     const std::shared_ptr<Transaction>& transaction, Status status) {
   if (attempts_remaining_ > 0 && IsRetryableTransactionError(status) &&
       !transaction->IsPermanentlyFailed()) {
+    if (reuse_reads_) {
+      PrepareRetry(*transaction);
+    }
     Run();
   } else {
     result_callback_(std::move(status));
   }
 }
 
+void TransactionRunner::PrepareRetry(const Transaction& transaction) {
+  const Transaction::ReadDocuments& reads = transaction.read_documents();
+
+  int contention = 0;
+  for (const auto& kv : reads) {
+    auto previous = previous_reads_.find(kv.first);
+    if (previous != previous_reads_.end() &&
+        ReadVersion(previous->second) != ReadVersion(kv.second)) {
+      ++contention_counts_[kv.first];
+    }
+    auto found = contention_counts_.find(kv.first);
+    if (found != contention_counts_.end()) {
+      contention = std::max(contention, found->second);
+    }
+  }
+
+  // Only reads that were fetched twice can tell whether they changed, so an
+  // attempt that failed with reused reads is followed by one that fetches
+  // everything again.
+  reusable_reads_.clear();
+  if (!reused_reads_) {
+    for (const auto& kv : reads) {
+      auto previous = previous_reads_.find(kv.first);
+      if (previous != previous_reads_.end() &&
+          contention_counts_.count(kv.first) == 0) {
+        reusable_reads_.insert(kv);
+      }
+    }
+  }
+  previous_reads_ = reads;
+
+  // Spread out the clients contending for the same documents, the more so the
+  // more often they collided.
+  if (contention > 0) {
+    std::uniform_real_distribution<double> distribution;
+    double jitter = distribution(secure_random_);
+    auto delay = kContentionDelay * std::min(contention, kMaxContentionCount);
+    backoff_.ExtendNextDelay(
+        std::chrono::duration_cast<AsyncQueue::Milliseconds>(delay * jitter));
+  }
+}
+
 }  // namespace core
 }  // namespace firestore
 }  // namespace firebase
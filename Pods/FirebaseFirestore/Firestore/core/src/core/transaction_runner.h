@@ -18,11 +18,13 @@
 #define FIRESTORE_CORE_SRC_CORE_TRANSACTION_RUNNER_H_
 
 #include <memory>
+#include <unordered_map>
 
 #include "Firestore/core/src/core/transaction.h"
 #include "Firestore/core/src/remote/exponential_backoff.h"
 #include "Firestore/core/src/remote/remote_store.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/secure_random.h"
 #include "Firestore/core/src/util/status_fwd.h"
 
 namespace firebase {
@@ -46,7 +48,8 @@ class TransactionRunner
                     remote::RemoteStore* remote_store,
                     core::TransactionUpdateCallback update_callback,
                     core::TransactionResultCallback result_callback,
-                    int max_attempts);
+                    int max_attempts,
+                    bool reuse_reads = false);
 
   /**
    * Runs the transaction and calls the result_callback_ with the result.
@@ -63,12 +66,40 @@ class TransactionRunner
   void HandleTransactionError(const std::shared_ptr<Transaction>& transaction,
                               util::Status status);
 
+  /**
+   * Compares the reads of the failed attempt with those of the attempt before
+   * it to find the documents under contention, picks the reads the next
+   * attempt can reuse and spreads out the next attempt by the contention.
+   */
+  void PrepareRetry(const Transaction& transaction);
+
   std::shared_ptr<util::AsyncQueue> queue_;
   remote::RemoteStore* remote_store_;
   core::TransactionUpdateCallback update_callback_;
   core::TransactionResultCallback result_callback_;
   remote::ExponentialBackoff backoff_;
   int attempts_remaining_;
+
+  /**
+   * Whether retries reuse the reads of earlier attempts that didn't change
+   * between attempts, fetching only the documents under contention.
+   */
+  bool reuse_reads_ = false;
+
+  /**
+   * Whether the latest attempt reused reads. Its failure may come from a
+   * reused read being stale, so the attempt after it fetches everything.
+   */
+  bool reused_reads_ = false;
+
+  Transaction::ReadDocuments previous_reads_;
+  Transaction::ReadDocuments reusable_reads_;
+
+  /** How many attempts found each document changed since the one before. */
+  std::unordered_map<model::DocumentKey, int, model::DocumentKeyHash>
+      contention_counts_;
+
+  util::SecureRandom secure_random_;
 };
 
 }  // namespace core
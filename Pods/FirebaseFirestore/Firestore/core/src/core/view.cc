@@ -17,7 +17,9 @@
 #include "Firestore/core/src/core/view.h"
 
 #include <utility>
+#include <vector>
 
+#include "Firestore/core/src/core/query_matcher.h"
 #include "Firestore/core/src/core/target.h"
 #include "Firestore/core/src/model/document_set.h"
 
@@ -26,6 +28,7 @@ namespace firestore {
 namespace core {
 
 using model::Document;
+using model::DocumentComparator;
 using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
@@ -61,27 +64,6 @@ ViewDocumentChanges::ViewDocumentChanges(model::DocumentSet new_documents,
 
 // MARK: - View
 
-namespace {
-
-int GetDocumentViewChangeTypePosition(DocumentViewChange::Type change_type) {
-  switch (change_type) {
-    case DocumentViewChange::Type::Removed:
-      return 0;
-    case DocumentViewChange::Type::Added:
-      return 1;
-    case DocumentViewChange::Type::Modified:
-      return 2;
-    case DocumentViewChange::Type::Metadata:
-      // A metadata change is converted to a modified change at the public API
-      // layer. Since we sort by document key and then change type, metadata and
-      // modified changes must be sorted equivalently.
-      return 2;
-  }
-  HARD_FAIL("Unknown DocumentViewChange::Type %s", change_type);
-}
-
-}  // namespace
-
 View::View(Query query, DocumentKeySet remote_documents)
     : query_(std::move(query)),
       document_set_(query_.Comparator()),
@@ -99,12 +81,12 @@ ViewDocumentChanges View::ComputeDocumentChanges(
   if (previous_changes) {
     change_set = previous_changes->change_set();
   }
-  DocumentSet old_document_set =
+  const DocumentSet& old_document_set =
       previous_changes ? previous_changes->document_set() : document_set_;
 
   DocumentKeySet new_mutated_keys =
       previous_changes ? previous_changes->mutated_keys() : mutated_keys_;
-  DocumentKeySet old_mutated_keys = mutated_keys_;
+  const DocumentKeySet& old_mutated_keys = mutated_keys_;
   DocumentSet new_document_set = old_document_set;
   bool needs_refill = false;
 
@@ -128,13 +110,19 @@ ViewDocumentChanges View::ComputeDocumentChanges(
     first_doc_in_limit = old_document_set.GetFirstDocument();
   }
 
+  // Compiled once per query and reused across snapshots.
+  const QueryMatcher& matcher = query_.matcher();
+  const DocumentComparator& comparator = document_set_.comparator();
   for (const auto& kv : doc_changes) {
     const DocumentKey& key = kv.first;
 
     absl::optional<Document> old_doc = old_document_set.GetDocument(key);
-    absl::optional<Document> new_doc = query_.Matches(kv.second)
-                                           ? absl::optional<Document>{kv.second}
-                                           : absl::nullopt;
+    // Documents entering the view carry their sort key, so that placing them
+    // and keeping them in order compares bytes instead of field values.
+    absl::optional<Document> new_doc =
+        matcher.Matches(kv.second)
+            ? absl::optional<Document>{comparator.WithSortKey(kv.second)}
+            : absl::nullopt;
 
     bool old_doc_had_pending_mutations =
         old_doc && old_mutated_keys.contains(key);
@@ -275,7 +263,8 @@ ViewChange View::ApplyChanges(
       });
 
   ApplyTargetChange(target_change);
-  std::vector<LimboDocumentChange> limbo_changes = UpdateLimboDocuments();
+  std::vector<LimboDocumentChange> limbo_changes =
+      UpdateLimboDocuments(changes, target_change);
   bool synced = limbo_documents_.empty() && current_;
   SyncState new_sync_state = synced ? SyncState::Synced : SyncState::Local;
   bool sync_state_changed = new_sync_state != sync_state_;
@@ -345,37 +334,71 @@ void View::ApplyTargetChange(
   if (maybe_target_change.has_value()) {
     const TargetChange& target_change = maybe_target_change.value();
 
-    for (const DocumentKey& key : target_change.added_documents()) {
-      synced_documents_ = synced_documents_.insert(key);
-    }
+    synced_documents_ =
+        synced_documents_.union_with(target_change.added_documents());
     for (const DocumentKey& key : target_change.modified_documents()) {
       HARD_ASSERT(synced_documents_.find(key) != synced_documents_.end(),
                   "Modified document %s not found in view.", key.ToString());
     }
-    for (const DocumentKey& key : target_change.removed_documents()) {
-      synced_documents_ = synced_documents_.erase(key);
-    }
+    synced_documents_ =
+        synced_documents_.difference_with(target_change.removed_documents());
 
     current_ = target_change.current();
   }
 }
 
-/** Updates limbo_documents_ and returns any changes as LimboDocumentChanges. */
-std::vector<LimboDocumentChange> View::UpdateLimboDocuments() {
+std::vector<LimboDocumentChange> View::UpdateLimboDocuments(
+    const std::vector<DocumentViewChange>& view_changes,
+    const absl::optional<TargetChange>& maybe_target_change) {
   // We can only determine limbo documents when we're in-sync with the server.
   if (!current_) {
+    limbo_documents_valid_ = false;
     return {};
   }
 
-  // TODO(klimt): Do this incrementally so that it's not quadratic when updating
-  // many documents.
+  if (limbo_documents_valid_) {
+    // Whether a document is in limbo only depends on its entry in the view and
+    // on the remote target, so only documents that changed in either can have
+    // moved in or out of limbo.
+    std::vector<DocumentKey> changed_keys;
+    changed_keys.reserve(view_changes.size());
+    for (const DocumentViewChange& change : view_changes) {
+      changed_keys.push_back(change.document()->key());
+    }
+    DocumentKeySet affected_keys =
+        DocumentKeySet::FromValues(std::move(changed_keys));
+    if (maybe_target_change) {
+      affected_keys =
+          affected_keys.union_with(maybe_target_change->added_documents())
+              .union_with(maybe_target_change->removed_documents());
+    }
+
+    // Report removals before additions, in key order, as the full diff does.
+    std::vector<LimboDocumentChange> limbo_changes;
+    for (const DocumentKey& key : affected_keys) {
+      if (limbo_documents_.contains(key) && !ShouldBeInLimbo(key)) {
+        limbo_documents_ = limbo_documents_.erase(key);
+        limbo_changes.push_back(LimboDocumentChange::Removed(key));
+      }
+    }
+    for (const DocumentKey& key : affected_keys) {
+      if (!limbo_documents_.contains(key) && ShouldBeInLimbo(key)) {
+        limbo_documents_ = limbo_documents_.insert(key);
+        limbo_changes.push_back(LimboDocumentChange::Added(key));
+      }
+    }
+    return limbo_changes;
+  }
+
+  limbo_documents_valid_ = true;
   DocumentKeySet old_limbo_documents = std::move(limbo_documents_);
-  limbo_documents_ = DocumentKeySet{};
+  std::vector<DocumentKey> limbo_keys;
   for (const Document& doc : document_set_) {
     if (ShouldBeInLimbo(doc->key())) {
-      limbo_documents_ = limbo_documents_.insert(doc->key());
+      limbo_keys.push_back(doc->key());
     }
   }
+  limbo_documents_ = DocumentKeySet::FromValues(std::move(limbo_keys));
 
   // Diff the new limbo docs with the old limbo docs.
   std::vector<LimboDocumentChange> changes;
@@ -204,7 +204,14 @@ class View {
   void ApplyTargetChange(
       const absl::optional<remote::TargetChange>& maybe_target_change);
 
-  std::vector<LimboDocumentChange> UpdateLimboDocuments();
+  /**
+   * Updates limbo_documents_ and returns any changes. Only the keys touched
+   * by `view_changes` and `maybe_target_change` are re-examined when the limbo
+   * set is already up to date; otherwise the whole view is.
+   */
+  std::vector<LimboDocumentChange> UpdateLimboDocuments(
+      const std::vector<DocumentViewChange>& view_changes,
+      const absl::optional<remote::TargetChange>& maybe_target_change);
 
   Query query_;
 
@@ -216,6 +223,13 @@ class View {
   /** Documents in the view but not in the remote target */
   model::DocumentKeySet limbo_documents_;
 
+  /**
+   * Whether limbo_documents_ reflects the current view. Limbo documents are
+   * only tracked while the view is current, so this is reset whenever an
+   * update finds the view not current.
+   */
+  bool limbo_documents_valid_ = false;
+
   /** Document Keys that have local changes. */
   model::DocumentKeySet mutated_keys_;
 
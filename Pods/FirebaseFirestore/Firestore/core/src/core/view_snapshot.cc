@@ -56,6 +56,23 @@ bool operator==(const DocumentViewChange& lhs, const DocumentViewChange& rhs) {
   return lhs.document() == rhs.document() && lhs.type() == rhs.type();
 }
 
+int GetDocumentViewChangeTypePosition(DocumentViewChange::Type change_type) {
+  switch (change_type) {
+    case DocumentViewChange::Type::Removed:
+      return 0;
+    case DocumentViewChange::Type::Added:
+      return 1;
+    case DocumentViewChange::Type::Modified:
+      return 2;
+    case DocumentViewChange::Type::Metadata:
+      // A metadata change is converted to a modified change at the public API
+      // layer. Since we sort by document key and then change type, metadata and
+      // modified changes must be sorted equivalently.
+      return 2;
+  }
+  HARD_FAIL("Unknown DocumentViewChange::Type %s", change_type);
+}
+
 // DocumentViewChangeSet
 
 void DocumentViewChangeSet::AddChange(DocumentViewChange&& change) {
@@ -66,6 +66,12 @@ class DocumentViewChange {
 
 bool operator==(const DocumentViewChange& lhs, const DocumentViewChange& rhs);
 
+/**
+ * Returns the rank of a change type in the order views report changes: all
+ * removals, then additions, then modifications.
+ */
+int GetDocumentViewChangeTypePosition(DocumentViewChange::Type change_type);
+
 /**
  * The possible states a document can be in w.r.t syncing from local storage to
  * the backend.
@@ -16,9 +16,14 @@
 
 #include "Firestore/core/src/credentials/auth_token.h"
 
+#include <cstdint>
 #include <utility>
 
 #include "Firestore/core/src/util/hard_assert.h"
+#include "absl/strings/ascii.h"
+#include "absl/strings/escaping.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/string_view.h"
 
 namespace firebase {
 namespace firestore {
@@ -36,6 +41,54 @@ const std::string& AuthToken::token() const {
   return token_;
 }
 
+absl::optional<std::chrono::system_clock::time_point>
+AuthToken::ExpirationTime() const {
+  if (!user_.is_authenticated()) {
+    return absl::nullopt;
+  }
+
+  // A JWT is `header.payload.signature`, each part encoded in unpadded
+  // web-safe base64.
+  absl::string_view token = token_;
+  size_t payload_start = token.find('.');
+  if (payload_start == absl::string_view::npos) {
+    return absl::nullopt;
+  }
+  ++payload_start;
+  size_t payload_end = token.find('.', payload_start);
+  if (payload_end == absl::string_view::npos) {
+    return absl::nullopt;
+  }
+
+  std::string payload;
+  if (!absl::WebSafeBase64Unescape(
+          token.substr(payload_start, payload_end - payload_start),
+          &payload)) {
+    return absl::nullopt;
+  }
+
+  // The payload is a flat JSON object; `exp` holds seconds since the epoch.
+  absl::string_view claims = payload;
+  size_t pos = claims.find("\"exp\"");
+  if (pos == absl::string_view::npos) {
+    return absl::nullopt;
+  }
+  pos += 5;
+  while (pos < claims.size() && (claims[pos] == ':' || claims[pos] == ' ')) {
+    ++pos;
+  }
+  size_t end = pos;
+  while (end < claims.size() && absl::ascii_isdigit(claims[end])) {
+    ++end;
+  }
+
+  int64_t seconds = 0;
+  if (!absl::SimpleAtoi(claims.substr(pos, end - pos), &seconds)) {
+    return absl::nullopt;
+  }
+  return std::chrono::system_clock::time_point{std::chrono::seconds{seconds}};
+}
+
 const AuthToken& AuthToken::Unauthenticated() {
   static const AuthToken kUnauthenticatedToken{};
   return kUnauthenticatedToken;
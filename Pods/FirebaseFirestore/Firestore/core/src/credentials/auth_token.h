@@ -17,9 +17,11 @@
 #ifndef FIRESTORE_CORE_SRC_CREDENTIALS_AUTH_TOKEN_H_
 #define FIRESTORE_CORE_SRC_CREDENTIALS_AUTH_TOKEN_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <string>
 
 #include "Firestore/core/src/credentials/user.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -55,6 +57,13 @@ class AuthToken {
     return user_;
   }
 
+  /**
+   * Returns when the token expires according to the `exp` claim of its JWT
+   * payload, or nullopt if the token is not a JWT with such a claim. The
+   * signature is not verified; the time is only used to refresh in time.
+   */
+  absl::optional<std::chrono::system_clock::time_point> ExpirationTime() const;
+
   /**
    * Returns a token for an unauthenticated user.
    *
@@ -23,13 +23,16 @@
 
 #import <Foundation/Foundation.h>
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
 #include <utility>
 
+#include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/credentials/credentials_provider.h"
 #include "Firestore/core/src/credentials/user.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 
 @class FIRApp;
 @protocol FIRAuthInterop;
@@ -50,6 +53,10 @@ namespace credentials {
  * from the thread backing our internal worker queue and the callbacks from
  * FIRAuth will be executed on an arbitrary different thread.
  *
+ * Tokens are cached until shortly before the expiry in their `exp` claim and,
+ * while the client keeps asking for them, refreshed in the background ahead
+ * of it, so that starting a stream does not wait on Firebase Auth.
+ *
  * For non-Apple desktop build, this is right now just a stub.
  */
 class FirebaseAuthCredentialsProvider
@@ -101,9 +108,33 @@ class FirebaseAuthCredentialsProvider
      */
     int token_counter = 0;
 
+    /**
+     * The last token fetched for `current_user` and when it expires. Cleared
+     * when the user changes or the token is invalidated.
+     */
+    absl::optional<AuthToken> cached_token;
+    std::chrono::system_clock::time_point cached_token_expiry;
+
+    /** When `GetToken` last asked for a token. */
+    std::chrono::system_clock::time_point last_requested;
+
+    /** Identifies the latest scheduled refresh; older ones do nothing. */
+    int refresh_generation = 0;
+
     std::mutex mutex;
   };
 
+  /**
+   * Caches the given token and schedules its background refresh. Must be
+   * called with `contents->mutex` held.
+   */
+  static void CacheToken(const std::shared_ptr<Contents>& contents,
+                         const AuthToken& token);
+
+  /** Fetches a new token into the cache if the client still uses them. */
+  static void RefreshToken(const std::shared_ptr<Contents>& contents,
+                           int refresh_generation);
+
   /**
    * Handle used to stop receiving auth changes once CredentialChangeListener is
    * removed.
@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/credentials/firebase_auth_credentials_provider_apple.h"
 
+#include <algorithm>
+
 #import "FirebaseCore/Extension/FIRAppInternal.h"
 
 #import "FirebaseAuth/Interop/FIRAuthInterop.h"
@@ -28,6 +30,23 @@
 namespace firebase {
 namespace firestore {
 namespace credentials {
+namespace {
+
+namespace chr = std::chrono;
+
+/** A cached token is fetched anew once it would expire within this time. */
+constexpr chr::minutes kTokenExpiryMargin{5};
+
+/** Cached tokens are refreshed in the background this long before expiry. */
+constexpr chr::minutes kTokenRefreshLead{10};
+
+/**
+ * Tokens are refreshed in the background only while `GetToken` was called
+ * within this time, so that an idle client does not keep fetching them.
+ */
+constexpr chr::hours kTokenRefreshIdleLimit{2};
+
+}  // namespace
 
 FirebaseAuthCredentialsProvider::FirebaseAuthCredentialsProvider(
     FIRApp* app, id<FIRAuthInterop> auth) {
@@ -59,6 +78,7 @@ FirebaseAuthCredentialsProvider::FirebaseAuthCredentialsProvider(
                     user_info[FIRAuthStateDidChangeInternalNotificationUIDKey];
                 contents->current_user = User::FromUid(user_id);
                 contents->token_counter++;
+                contents->cached_token.reset();
                 CredentialChangeListener<User> listener = change_listener_;
                 if (listener) {
                   listener(contents->current_user);
@@ -77,6 +97,22 @@ void FirebaseAuthCredentialsProvider::GetToken(
   HARD_ASSERT(auth_listener_handle_,
               "GetToken cannot be called after listener removed.");
 
+  {
+    std::unique_lock<std::mutex> lock(contents_->mutex);
+    auto now = chr::system_clock::now();
+    contents_->last_requested = now;
+    if (force_refresh_) {
+      // The backend rejected the cached token.
+      contents_->cached_token.reset();
+    } else if (contents_->cached_token &&
+               now + kTokenExpiryMargin < contents_->cached_token_expiry) {
+      AuthToken token = *contents_->cached_token;
+      lock.unlock();
+      completion(std::move(token));
+      return;
+    }
+  }
+
   // Take note of the current value of the token_counter so that this method can
   // fail if there is a token change while the request is outstanding.
   int initial_token_counter = contents_->token_counter;
@@ -95,12 +131,15 @@ void FirebaseAuthCredentialsProvider::GetToken(
           // outstanding so the response is likely for a previous user (which
           // user, we can't be sure).
           LOG_DEBUG("GetToken aborted due to token change.");
+          lock.unlock();
           return GetToken(completion);
         } else {
           if (error == nil) {
             if (token != nil) {
-              completion(
-                  AuthToken{util::MakeString(token), contents->current_user});
+              AuthToken auth_token{util::MakeString(token),
+                                   contents->current_user};
+              CacheToken(contents, auth_token);
+              completion(std::move(auth_token));
             } else {
               completion(AuthToken::Unauthenticated());
             }
@@ -127,6 +166,66 @@ void FirebaseAuthCredentialsProvider::GetToken(
   force_refresh_ = false;
 }
 
+void FirebaseAuthCredentialsProvider::CacheToken(
+    const std::shared_ptr<Contents>& contents, const AuthToken& token) {
+  absl::optional<chr::system_clock::time_point> expiry = token.ExpirationTime();
+  if (!expiry) {
+    return;
+  }
+
+  contents->cached_token = token;
+  contents->cached_token_expiry = *expiry;
+  int refresh_generation = ++contents->refresh_generation;
+
+  auto delay = chr::duration_cast<chr::nanoseconds>(
+      *expiry - kTokenRefreshLead - chr::system_clock::now());
+  std::weak_ptr<Contents> weak_contents = contents;
+  dispatch_after(
+      dispatch_time(DISPATCH_TIME_NOW, std::max<int64_t>(delay.count(), 0)),
+      dispatch_get_global_queue(QOS_CLASS_UTILITY, 0), ^{
+        std::shared_ptr<Contents> contents = weak_contents.lock();
+        if (contents) {
+          RefreshToken(contents, refresh_generation);
+        }
+      });
+}
+
+void FirebaseAuthCredentialsProvider::RefreshToken(
+    const std::shared_ptr<Contents>& contents, int refresh_generation) {
+  int token_counter = 0;
+  {
+    std::lock_guard<std::mutex> lock(contents->mutex);
+    if (refresh_generation != contents->refresh_generation ||
+        !contents->cached_token || !contents->auth ||
+        chr::system_clock::now() - contents->last_requested >
+            kTokenRefreshIdleLimit) {
+      return;
+    }
+    token_counter = contents->token_counter;
+  }
+
+  LOG_DEBUG("Refreshing the auth token ahead of its expiry");
+  std::weak_ptr<Contents> weak_contents = contents;
+  [contents->auth
+      getTokenForcingRefresh:YES
+                withCallback:^(NSString* _Nullable token,
+                               NSError* _Nullable error) {
+                  std::shared_ptr<Contents> contents = weak_contents.lock();
+                  if (!contents) {
+                    return;
+                  }
+
+                  std::lock_guard<std::mutex> lock(contents->mutex);
+                  // On failure the cached token stays in use until it is
+                  // about to expire, after which `GetToken` fetches one.
+                  if (error == nil && token != nil &&
+                      token_counter == contents->token_counter) {
+                    CacheToken(contents, AuthToken{util::MakeString(token),
+                                                   contents->current_user});
+                  }
+                }];
+}
+
 void FirebaseAuthCredentialsProvider::SetCredentialChangeListener(
     CredentialChangeListener<User> change_listener) {
   std::unique_lock<std::mutex> lock(contents_->mutex);
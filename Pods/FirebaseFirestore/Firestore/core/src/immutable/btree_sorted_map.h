@@ -0,0 +1,704 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_IMMUTABLE_BTREE_SORTED_MAP_H_
+#define FIRESTORE_CORE_SRC_IMMUTABLE_BTREE_SORTED_MAP_H_
+
+#include <algorithm>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Firestore/core/src/immutable/keys_view.h"
+#include "Firestore/core/src/immutable/sorted_container.h"
+#include "Firestore/core/src/util/comparison.h"
+#include "Firestore/core/src/util/compressed_member.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "absl/container/inlined_vector.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace immutable {
+namespace impl {
+
+/**
+ * BTreeSortedMap is a value type containing a map, stored as a persistent
+ * B-tree. It is immutable, but has methods to efficiently create new maps that
+ * are mutations of it.
+ *
+ * Each node holds up to `kMaxEntries` entries in a contiguous array, so that
+ * large maps take a heap node per few dozen entries instead of one per entry
+ * and are iterated mostly sequentially in memory. Mutations copy the nodes on
+ * the path to the changed entry and share all others with the original map.
+ */
+template <typename K, typename V, typename C = util::Comparator<K>>
+class BTreeSortedMap : public SortedMapBase, private util::CompressedMember<C> {
+  using ComparatorMember = util::CompressedMember<C>;
+
+ public:
+  /**
+   * The type of the entries stored in the map.
+   */
+  using value_type = std::pair<K, V>;
+
+  class const_iterator;
+  using const_key_iterator = util::iterator_first<const_iterator>;
+
+  /**
+   * Creates an empty BTreeSortedMap.
+   */
+  explicit BTreeSortedMap(const C& comparator = {})
+      : ComparatorMember{comparator} {
+  }
+
+  /**
+   * Creates a BTreeSortedMap from a range of pairs to insert.
+   */
+  template <typename Range>
+  static BTreeSortedMap Create(const Range& range, const C& comparator) {
+    BTreeSortedMap result{comparator};
+    for (auto&& element : range) {
+      result = result.insert(element.first, element.second);
+    }
+    return result;
+  }
+
+  /**
+   * Creates a BTreeSortedMap from entries that are sorted by key and contain no
+   * duplicate keys, moving the entries out of the range. The nodes are filled
+   * evenly at once, without any splitting.
+   */
+  template <typename Iterator>
+  static BTreeSortedMap FromSortedEntries(Iterator begin,
+                                          size_type count,
+                                          const C& comparator) {
+    if (count == 0) {
+      return BTreeSortedMap{comparator};
+    }
+
+    int height = 0;
+    while (Capacity(height) < count) {
+      ++height;
+    }
+    return BTreeSortedMap{Build(&begin, count, height), comparator};
+  }
+
+  /** Returns true if the map contains no elements. */
+  bool empty() const {
+    return root_ == nullptr;
+  }
+
+  /** Returns the number of items in this map. */
+  size_type size() const {
+    return root_ ? root_->size : 0;
+  }
+
+  const C& comparator() const {
+    return ComparatorMember::get();
+  }
+
+  /**
+   * Creates a new map identical to this one, but with a key-value pair added or
+   * updated.
+   *
+   * @param key The key to insert/update.
+   * @param value The value to associate with the key.
+   * @return A new dictionary with the added/updated value.
+   */
+  BTreeSortedMap insert(const K& key, const V& value) const {
+    if (!root_) {
+      auto leaf = std::make_shared<Node>();
+      leaf->entries.emplace_back(key, value);
+      leaf->size = 1;
+      return Wrap(std::move(leaf));
+    }
+
+    std::shared_ptr<Node> root = Insert(*root_, key, value);
+    if (root->entries.size() > kMaxEntries) {
+      // Grow the tree by a level, which keeps all leaves at the same depth.
+      auto new_root = std::make_shared<Node>();
+      new_root->children.emplace_back();
+      Split(root, new_root.get(), 0);
+      root = std::move(new_root);
+    }
+    return Wrap(std::move(root));
+  }
+
+  /**
+   * Creates a new map identical to this one, but with a key removed from it.
+   *
+   * @param key The key to remove.
+   * @return A new map without that value.
+   */
+  BTreeSortedMap erase(const K& key) const {
+    if (!root_) {
+      return *this;
+    }
+
+    std::shared_ptr<Node> root = Erase(*root_, key);
+    if (!root) {
+      return *this;
+    }
+
+    if (root->entries.empty()) {
+      // Shrink the tree by a level once its root has no entries left.
+      return root->is_leaf() ? BTreeSortedMap{comparator()}
+                             : Wrap(root->children.front());
+    }
+    return Wrap(std::move(root));
+  }
+
+  bool contains(const K& key) const {
+    const Node* node = root_.get();
+    while (node) {
+      size_type i = node->LowerBound(key, comparator());
+      if (i < node->entries.size() &&
+          util::Same(comparator().Compare(key, node->entries[i].first))) {
+        return true;
+      }
+      node = node->is_leaf() ? nullptr : node->children[i].get();
+    }
+    return false;
+  }
+
+  /**
+   * Finds a value in the map.
+   *
+   * @param key The key to look up.
+   * @return An iterator pointing to the entry containing the key, or end() if
+   *     not found.
+   */
+  const_iterator find(const K& key) const {
+    const_iterator found = lower_bound(key);
+    if (!found.is_end() &&
+        util::Same(comparator().Compare(key, found->first))) {
+      return found;
+    } else {
+      return end();
+    }
+  }
+
+  /**
+   * Finds the index of the given key in the map.
+   *
+   * @param key The key to look up.
+   * @return The index of the entry containing the key, or npos if not found.
+   */
+  size_type find_index(const K& key) const {
+    size_type pruned_entries = 0;
+    const Node* node = root_.get();
+    while (node) {
+      size_type i = node->LowerBound(key, comparator());
+      // Every entry before `i` and every subtree left of them precede the key.
+      pruned_entries += i;
+      if (!node->is_leaf()) {
+        for (size_type child = 0; child < i; ++child) {
+          pruned_entries += node->children[child]->size;
+        }
+      }
+
+      if (i < node->entries.size() &&
+          util::Same(comparator().Compare(key, node->entries[i].first))) {
+        return node->is_leaf() ? pruned_entries
+                               : pruned_entries + node->children[i]->size;
+      }
+      node = node->is_leaf() ? nullptr : node->children[i].get();
+    }
+    return npos;
+  }
+
+  /**
+   * Finds the first entry in the map containing a key greater than or equal
+   * to the given key.
+   *
+   * @param key The key to look up.
+   * @return An iterator pointing to the entry containing the key or the next
+   *     largest key. Can return end() if all keys in the map are less than the
+   *     requested key.
+   */
+  const_iterator lower_bound(const K& key) const {
+    const_iterator result;
+    const Node* node = root_.get();
+    while (node) {
+      size_type i = node->LowerBound(key, comparator());
+      result.stack_.push_back({node, i});
+      if (node->is_leaf() ||
+          (i < node->entries.size() &&
+           util::Same(comparator().Compare(key, node->entries[i].first)))) {
+        break;
+      }
+      node = node->children[i].get();
+    }
+    result.SkipFinishedNodes();
+    return result;
+  }
+
+  const_iterator min() const {
+    return begin();
+  }
+
+  const_iterator max() const {
+    const_iterator result;
+    const Node* node = root_.get();
+    while (node && !node->is_leaf()) {
+      auto last = static_cast<size_type>(node->entries.size());
+      result.stack_.push_back({node, last});
+      node = node->children[last].get();
+    }
+    if (node) {
+      auto last = static_cast<size_type>(node->entries.size() - 1);
+      result.stack_.push_back({node, last});
+    }
+    return result;
+  }
+
+  /**
+   * Returns a forward iterator pointing to the first entry in the map. If there
+   * are no entries in the map, begin() == end().
+   */
+  const_iterator begin() const {
+    const_iterator result;
+    result.PushLeftmost(root_.get());
+    return result;
+  }
+
+  /**
+   * Returns an iterator pointing past the last entry in the map.
+   */
+  const_iterator end() const {
+    return const_iterator{};
+  }
+
+  /**
+   * Returns a view of this SortedMap containing just the keys that have been
+   * inserted.
+   */
+  const util::range<const_key_iterator> keys() const {
+    return KeysView(*this);
+  }
+
+  /**
+   * Returns a view of this SortedMap containing just the keys that have been
+   * inserted that are greater than or equal to the given key.
+   */
+  const util::range<const_key_iterator> keys_from(const K& key) const {
+    return KeysViewFrom(*this, key);
+  }
+
+  /**
+   * Returns a view of this SortedMap containing just the keys that have been
+   * inserted that are greater than or equal to the given start_key and less
+   * than the given end_key.
+   */
+  const util::range<const_key_iterator> keys_in(const K& start_key,
+                                                const K& end_key) const {
+    return impl::KeysViewIn(*this, start_key, end_key, comparator());
+  }
+
+ private:
+  /**
+   * The most entries a node holds. Nodes other than the root hold at least
+   * `kMinEntries` once they have been through an erase; nodes built in bulk
+   * may hold fewer.
+   */
+  static constexpr size_type kMaxEntries = 32;
+  static constexpr size_type kMinEntries = kMaxEntries / 2;
+
+  struct Node {
+    bool is_leaf() const {
+      return children.empty();
+    }
+
+    /** Returns the index of the first entry not less than `key`. */
+    size_type LowerBound(const K& key, const C& comparator) const {
+      auto found = std::lower_bound(
+          entries.begin(), entries.end(), key,
+          [&](const value_type& entry, const K& k) {
+            return util::Ascending(comparator.Compare(entry.first, k));
+          });
+      return static_cast<size_type>(found - entries.begin());
+    }
+
+    /** Recomputes `size` from the entries and children. */
+    void Recount() {
+      size = static_cast<size_type>(entries.size());
+      for (const auto& child : children) {
+        size += child->size;
+      }
+    }
+
+    std::vector<value_type> entries;
+
+    /** Empty for leaves; otherwise one more than there are entries. */
+    std::vector<std::shared_ptr<const Node>> children;
+
+    /** The number of entries in the subtree rooted at this node. */
+    size_type size = 0;
+  };
+
+  using NodePtr = std::shared_ptr<const Node>;
+
+  BTreeSortedMap(NodePtr root, const C& comparator) noexcept
+      : ComparatorMember{comparator}, root_{std::move(root)} {
+  }
+
+  BTreeSortedMap Wrap(NodePtr root) const noexcept {
+    return BTreeSortedMap{std::move(root), comparator()};
+  }
+
+  /** The most entries a tree of the given height holds; leaves are height 0. */
+  static size_type Capacity(int height) {
+    uint64_t capacity = kMaxEntries;
+    for (int i = 0; i < height; ++i) {
+      capacity = capacity * (kMaxEntries + 1) + kMaxEntries;
+      if (capacity >= npos) {
+        return npos;
+      }
+    }
+    return static_cast<size_type>(capacity);
+  }
+
+  /**
+   * Builds a tree of the given height from the next `count` entries, spreading
+   * them evenly over as few children per node as fit.
+   */
+  template <typename Iterator>
+  static NodePtr Build(Iterator* entries, size_type count, int height) {
+    auto node = std::make_shared<Node>();
+    node->size = count;
+    if (height == 0) {
+      HARD_ASSERT(count > 0 && count <= kMaxEntries,
+                  "Leaf of %s entries during bulk build", count);
+      node->entries.reserve(count);
+      for (size_type i = 0; i < count; ++i, ++*entries) {
+        node->entries.push_back(std::move(**entries));
+      }
+      return node;
+    }
+
+    // Each child holds up to `child_capacity` entries and each but the last is
+    // followed by an entry of this node.
+    uint64_t child_capacity = Capacity(height - 1);
+    auto child_count = static_cast<size_type>(std::max<uint64_t>(
+        2, (uint64_t{count} + child_capacity + 1) / (child_capacity + 1)));
+    size_type child_entries = count - (child_count - 1);
+    node->entries.reserve(child_count - 1);
+    node->children.reserve(child_count);
+    for (size_type i = 0; i < child_count; ++i) {
+      size_type share = child_entries / child_count +
+                        (i < child_entries % child_count ? 1 : 0);
+      node->children.push_back(Build(entries, share, height - 1));
+      if (i + 1 < child_count) {
+        node->entries.push_back(std::move(**entries));
+        ++*entries;
+      }
+    }
+    return node;
+  }
+
+  /**
+   * Returns a copy of `node` with the entry added or updated. The copy may hold
+   * one entry too many, which the caller splits off.
+   */
+  std::shared_ptr<Node> Insert(const Node& node,
+                               const K& key,
+                               const V& value) const {
+    auto copy = std::make_shared<Node>(node);
+    size_type i = node.LowerBound(key, comparator());
+    if (i < node.entries.size() &&
+        util::Same(comparator().Compare(key, node.entries[i].first))) {
+      copy->entries[i] = value_type{key, value};
+      return copy;
+    }
+
+    if (node.is_leaf()) {
+      copy->entries.emplace(copy->entries.begin() + i, key, value);
+      ++copy->size;
+      return copy;
+    }
+
+    std::shared_ptr<Node> child = Insert(*node.children[i], key, value);
+    copy->size += child->size - node.children[i]->size;
+    if (child->entries.size() > kMaxEntries) {
+      Split(child, copy.get(), i);
+    } else {
+      copy->children[i] = std::move(child);
+    }
+    return copy;
+  }
+
+  /**
+   * Splits the overfull `child` in two around its middle entry, which moves up
+   * into `parent` at `index`, in place of the child.
+   */
+  static void Split(const std::shared_ptr<Node>& child,
+                    Node* parent,
+                    size_type index) {
+    size_type middle = static_cast<size_type>(child->entries.size() / 2);
+    auto right = std::make_shared<Node>();
+    right->entries.assign(std::make_move_iterator(child->entries.begin() +
+                                                  middle + 1),
+                          std::make_move_iterator(child->entries.end()));
+    if (!child->is_leaf()) {
+      right->children.assign(child->children.begin() + middle + 1,
+                             child->children.end());
+      child->children.resize(middle + 1);
+    }
+    value_type median = std::move(child->entries[middle]);
+    child->entries.resize(middle);
+    child->Recount();
+    right->Recount();
+
+    parent->entries.insert(parent->entries.begin() + index, std::move(median));
+    parent->children[index] = child;
+    parent->children.insert(parent->children.begin() + index + 1,
+                            std::move(right));
+    parent->Recount();
+  }
+
+  /**
+   * Returns a copy of `node` without the entry for `key`, or null if there is
+   * no such entry. The copy may hold too few entries, which the caller fixes.
+   */
+  std::shared_ptr<Node> Erase(const Node& node, const K& key) const {
+    size_type i = node.LowerBound(key, comparator());
+    bool found =
+        i < node.entries.size() &&
+        util::Same(comparator().Compare(key, node.entries[i].first));
+
+    if (node.is_leaf()) {
+      if (!found) {
+        return nullptr;
+      }
+      auto copy = std::make_shared<Node>(node);
+      copy->entries.erase(copy->entries.begin() + i);
+      --copy->size;
+      return copy;
+    }
+
+    std::shared_ptr<Node> child;
+    absl::optional<value_type> predecessor;
+    if (found) {
+      // Replace the entry with the greatest entry of the subtree before it.
+      child = EraseMax(*node.children[i], &predecessor);
+    } else {
+      child = Erase(*node.children[i], key);
+      if (!child) {
+        return nullptr;
+      }
+    }
+
+    auto copy = std::make_shared<Node>(node);
+    if (found) {
+      copy->entries[i] = std::move(*predecessor);
+    }
+    copy->children[i] = std::move(child);
+    --copy->size;
+    Rebalance(copy.get(), i);
+    return copy;
+  }
+
+  /** Returns a copy of `node` without its greatest entry, moved to `max`. */
+  static std::shared_ptr<Node> EraseMax(const Node& node,
+                                        absl::optional<value_type>* max) {
+    auto copy = std::make_shared<Node>(node);
+    --copy->size;
+    if (node.is_leaf()) {
+      *max = std::move(copy->entries.back());
+      copy->entries.pop_back();
+      return copy;
+    }
+
+    auto last = static_cast<size_type>(node.entries.size());
+    copy->children[last] = EraseMax(*node.children[last], max);
+    Rebalance(copy.get(), last);
+    return copy;
+  }
+
+  /**
+   * Refills the child at `index` of `parent` if it holds fewer than
+   * `kMinEntries`, by moving an entry over from a sibling that can spare one,
+   * or else by merging it with a sibling.
+   */
+  static void Rebalance(Node* parent, size_type index) {
+    if (parent->children[index]->entries.size() >= kMinEntries) {
+      return;
+    }
+
+    if (index > 0 &&
+        parent->children[index - 1]->entries.size() > kMinEntries) {
+      auto left = std::make_shared<Node>(*parent->children[index - 1]);
+      auto child = std::make_shared<Node>(*parent->children[index]);
+      child->entries.insert(child->entries.begin(),
+                            std::move(parent->entries[index - 1]));
+      parent->entries[index - 1] = std::move(left->entries.back());
+      left->entries.pop_back();
+      if (!left->is_leaf()) {
+        child->children.insert(child->children.begin(),
+                               std::move(left->children.back()));
+        left->children.pop_back();
+      }
+      left->Recount();
+      child->Recount();
+      parent->children[index - 1] = std::move(left);
+      parent->children[index] = std::move(child);
+      return;
+    }
+
+    if (index + 1 < parent->children.size() &&
+        parent->children[index + 1]->entries.size() > kMinEntries) {
+      auto child = std::make_shared<Node>(*parent->children[index]);
+      auto right = std::make_shared<Node>(*parent->children[index + 1]);
+      child->entries.push_back(std::move(parent->entries[index]));
+      parent->entries[index] = std::move(right->entries.front());
+      right->entries.erase(right->entries.begin());
+      if (!right->is_leaf()) {
+        child->children.push_back(std::move(right->children.front()));
+        right->children.erase(right->children.begin());
+      }
+      child->Recount();
+      right->Recount();
+      parent->children[index] = std::move(child);
+      parent->children[index + 1] = std::move(right);
+      return;
+    }
+
+    // Neither sibling can spare an entry, so both fit in one node together
+    // with the entry between them.
+    size_type left_index = index > 0 ? index - 1 : index;
+    auto merged = std::make_shared<Node>(*parent->children[left_index]);
+    const Node& right = *parent->children[left_index + 1];
+    merged->entries.push_back(std::move(parent->entries[left_index]));
+    merged->entries.insert(merged->entries.end(), right.entries.begin(),
+                           right.entries.end());
+    merged->children.insert(merged->children.end(), right.children.begin(),
+                            right.children.end());
+    merged->Recount();
+    parent->entries.erase(parent->entries.begin() + left_index);
+    parent->children.erase(parent->children.begin() + left_index + 1);
+    parent->children[left_index] = std::move(merged);
+  }
+
+  NodePtr root_;
+};
+
+/**
+ * A forward iterator over the entries of a BTreeSortedMap, in order.
+ *
+ * The iterator keeps the path from the root to the current entry. Like
+ * LlrbNodeIterator, it does not extend the lifetime of the tree it iterates.
+ */
+template <typename K, typename V, typename C>
+class BTreeSortedMap<K, V, C>::const_iterator {
+ public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename BTreeSortedMap::value_type;
+  using pointer = const value_type*;
+  using reference = const value_type&;
+  using difference_type = std::ptrdiff_t;
+
+  // Default constructor to conform to the requirements of ForwardIterator
+  const_iterator() = default;
+
+  bool is_end() const {
+    return stack_.empty();
+  }
+
+  pointer get() const {
+    HARD_ASSERT(!is_end(), "Can't dereference an end iterator");
+    const Frame& top = stack_.back();
+    return &top.node->entries[top.index];
+  }
+
+  reference operator*() const {
+    return *get();
+  }
+
+  pointer operator->() const {
+    return get();
+  }
+
+  const_iterator& operator++() {
+    HARD_ASSERT(!is_end(), "Can't move past the end of the map");
+    Frame& top = stack_.back();
+    ++top.index;
+    if (!top.node->is_leaf()) {
+      // The entries of the subtree after the current entry come next.
+      PushLeftmost(top.node->children[top.index].get());
+    } else {
+      SkipFinishedNodes();
+    }
+    return *this;
+  }
+
+  const_iterator operator++(int /*unused*/) {
+    const_iterator result = *this;
+    ++*this;
+    return result;
+  }
+
+  friend bool operator==(const const_iterator& a, const const_iterator& b) {
+    if (a.is_end() || b.is_end()) {
+      return a.is_end() && b.is_end();
+    }
+    const Frame& a_top = a.stack_.back();
+    const Frame& b_top = b.stack_.back();
+    return a_top.node == b_top.node && a_top.index == b_top.index;
+  }
+
+  bool operator!=(const const_iterator& b) const {
+    return !(*this == b);
+  }
+
+ private:
+  friend class BTreeSortedMap;
+
+  /**
+   * A node on the path to the current entry. For the last frame, `index` is
+   * the current entry; for the others, it is the entry that comes after the
+   * subtree being iterated.
+   */
+  struct Frame {
+    const Node* node;
+    size_type index;
+  };
+
+  void PushLeftmost(const Node* node) {
+    while (node) {
+      stack_.push_back({node, 0});
+      node = node->is_leaf() ? nullptr : node->children.front().get();
+    }
+  }
+
+  /** Pops the nodes whose entries have all been visited. */
+  void SkipFinishedNodes() {
+    while (!stack_.empty() &&
+           stack_.back().index == stack_.back().node->entries.size()) {
+      stack_.pop_back();
+    }
+  }
+
+  absl::InlinedVector<Frame, 6> stack_;
+};
+
+}  // namespace impl
+}  // namespace immutable
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_IMMUTABLE_BTREE_SORTED_MAP_H_
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_IMMUTABLE_LLRB_NODE_H_
 #define FIRESTORE_CORE_SRC_IMMUTABLE_LLRB_NODE_H_
 
+#include <algorithm>
 #include <memory>
 #include <utility>
 
@@ -101,6 +102,14 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode erase(const K& key, const Comparator& comparator) const;
 
+  /**
+   * Builds a balanced tree out of `count` entries starting at `begin`, moving
+   * the entries out of the range. The entries must be sorted by key and must
+   * not contain duplicate keys. No comparisons or rotations are performed.
+   */
+  template <typename Iterator>
+  static LlrbNode FromSortedEntries(Iterator begin, size_type count);
+
   const LlrbNode& min() const {
     const LlrbNode* node = this;
     while (!node->left().empty()) {
@@ -221,6 +230,11 @@ class LlrbNode : public SortedMapBase {
   template <typename Comparator>
   LlrbNode InnerErase(const K& key, const Comparator& comparator) const;
 
+  template <typename Iterator>
+  static LlrbNode BuildSubtree(Iterator& it,
+                               size_type count,
+                               size_type black_height);
+
   void FixUp();
   void FixRootColor();
 
@@ -459,6 +473,76 @@ void LlrbNode<K, V>::FlipColor() {
   set_right(std::move(new_right));
 }
 
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::FromSortedEntries(Iterator begin,
+                                                 size_type count) {
+  // A 2-3 tree with black height h holds between 2^h - 1 and 3^h - 1
+  // entries. Pick the smallest height that can hold all entries.
+  size_type black_height = 0;
+  size_type capacity = 0;
+  while (capacity < count) {
+    ++black_height;
+    capacity = capacity * 3 + 2;
+  }
+  return BuildSubtree(begin, count, black_height);
+}
+
+/**
+ * Builds the subtree for the next `count` entries of `it` as a 2-3 tree with
+ * the given black height. A 3-node is represented as a black node with a red
+ * left child, which keeps the tree left-leaning.
+ */
+template <typename K, typename V>
+template <typename Iterator>
+LlrbNode<K, V> LlrbNode<K, V>::BuildSubtree(Iterator& it,
+                                            size_type count,
+                                            size_type black_height) {
+  if (count == 0) {
+    return LlrbNode{};
+  }
+
+  // The bounds of the number of entries of each child.
+  size_type min_child = 0;
+  size_type max_child = 0;
+  for (size_type i = 1; i < black_height; ++i) {
+    min_child = min_child * 2 + 1;
+    max_child = max_child * 3 + 2;
+  }
+
+  if (count - 1 <= 2 * max_child) {
+    // 2-node: one entry and two children.
+    size_type left_count = std::min(max_child, count - 1 - min_child);
+    size_type right_count = count - 1 - left_count;
+
+    LlrbNode left = BuildSubtree(it, left_count, black_height - 1);
+    value_type entry = std::move(*it);
+    ++it;
+    LlrbNode right = BuildSubtree(it, right_count, black_height - 1);
+    return LlrbNode{
+        Rep{std::move(entry), Color::Black, std::move(left), std::move(right)}};
+  }
+
+  // 3-node: two entries and three children.
+  size_type children_count = count - 2;
+  size_type first_count = std::min(max_child, children_count - 2 * min_child);
+  size_type second_count =
+      std::min(max_child, children_count - first_count - min_child);
+  size_type third_count = children_count - first_count - second_count;
+
+  LlrbNode first = BuildSubtree(it, first_count, black_height - 1);
+  value_type smaller_entry = std::move(*it);
+  ++it;
+  LlrbNode second = BuildSubtree(it, second_count, black_height - 1);
+  LlrbNode red_left{Rep{std::move(smaller_entry), Color::Red, std::move(first),
+                        std::move(second)}};
+  value_type larger_entry = std::move(*it);
+  ++it;
+  LlrbNode third = BuildSubtree(it, third_count, black_height - 1);
+  return LlrbNode{Rep{std::move(larger_entry), Color::Black,
+                      std::move(red_left), std::move(third)}};
+}
+
 }  // namespace impl
 }  // namespace immutable
 }  // namespace firestore
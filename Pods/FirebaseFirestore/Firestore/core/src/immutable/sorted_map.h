@@ -18,8 +18,10 @@
 #define FIRESTORE_CORE_SRC_IMMUTABLE_SORTED_MAP_H_
 
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/immutable/array_sorted_map.h"
+#include "Firestore/core/src/immutable/btree_sorted_map.h"
 #include "Firestore/core/src/immutable/keys_view.h"
 #include "Firestore/core/src/immutable/sorted_container.h"
 #include "Firestore/core/src/immutable/sorted_map_iterator.h"
@@ -32,11 +34,35 @@ namespace firebase {
 namespace firestore {
 namespace immutable {
 
+/**
+ * Selects the left-leaning red-black tree, with a node per entry, for maps that
+ * outgrow the array representation.
+ */
+struct LlrbTree {
+  template <typename K, typename V, typename C>
+  using map_type = impl::TreeSortedMap<K, V, C>;
+};
+
+/**
+ * Selects the B-tree, with a node per few dozen entries, for maps that outgrow
+ * the array representation. It suits maps that grow large and are iterated
+ * often, at the cost of copying wider nodes on each mutation.
+ */
+struct BTree {
+  template <typename K, typename V, typename C>
+  using map_type = impl::BTreeSortedMap<K, V, C>;
+};
+
 /**
  * SortedMap is a value type containing a map. It is immutable, but
  * has methods to efficiently create new maps that are mutations of it.
+ *
+ * Small maps are stored in an array; larger ones in the tree selected by `T`.
  */
-template <typename K, typename V, typename C = util::Comparator<K>>
+template <typename K,
+          typename V,
+          typename C = util::Comparator<K>,
+          typename T = LlrbTree>
 class SortedMap : public SortedMapBase {
  public:
   using key_type = K;
@@ -44,12 +70,12 @@ class SortedMap : public SortedMapBase {
   /** The type of the entries stored in the map. */
   using value_type = std::pair<K, V>;
   using array_type = impl::ArraySortedMap<K, V, C>;
-  using tree_type = impl::TreeSortedMap<K, V, C>;
+  using tree_type = typename T::template map_type<K, V, C>;
 
   using const_iterator = impl::SortedMapIterator<
       value_type,
       typename impl::FixedArray<value_type>::const_iterator,
-      typename impl::LlrbNode<K, V>::const_iterator>;
+      typename tree_type::const_iterator>;
 
   using const_key_iterator = util::iterator_first<const_iterator>;
 
@@ -73,6 +99,25 @@ class SortedMap : public SortedMapBase {
     }
   }
 
+  /**
+   * Creates a SortedMap from entries that are sorted by key and contain no
+   * duplicate keys. This is considerably cheaper than inserting the entries
+   * one by one, since large maps are built without any rebalancing.
+   */
+  static SortedMap FromSortedEntries(std::vector<value_type>&& entries,
+                                     const C& comparator = {}) {
+    if (entries.size() <= kFixedSize) {
+      SortedMap result{comparator};
+      for (const value_type& entry : entries) {
+        result = result.insert(entry.first, entry.second);
+      }
+      return result;
+    }
+
+    return SortedMap{tree_type::FromSortedEntries(
+        entries.begin(), static_cast<size_type>(entries.size()), comparator)};
+  }
+
   SortedMap(const SortedMap& other) : tag_{other.tag_} {
     switch (tag_) {
       case Tag::Array:
@@ -101,7 +146,7 @@ class SortedMap : public SortedMapBase {
         array_.~ArraySortedMap();
         break;
       case Tag::Tree:
-        tree_.~TreeSortedMap();
+        tree_.~tree_type();
         break;
     }
   }
@@ -18,7 +18,9 @@
 #define FIRESTORE_CORE_SRC_IMMUTABLE_SORTED_SET_H_
 
 #include <algorithm>
+#include <iterator>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/immutable/sorted_container.h"
 #include "Firestore/core/src/immutable/sorted_map.h"
@@ -32,10 +34,14 @@ namespace firebase {
 namespace firestore {
 namespace immutable {
 
-template <typename K, typename C = util::Comparator<K>>
+/**
+ * SortedSet is a value type containing a set, stored as the keys of a
+ * SortedMap. `T` selects the tree of large sets, as for SortedMap.
+ */
+template <typename K, typename C = util::Comparator<K>, typename T = LlrbTree>
 class SortedSet : public SortedContainer {
  public:
-  using map_type = SortedMap<K, util::Empty, C>;
+  using map_type = SortedMap<K, util::Empty, C, T>;
 
   using size_type = typename map_type::size_type;
   using value_type = K;
@@ -74,6 +80,13 @@ class SortedSet : public SortedContainer {
     return SortedSet{map_.insert(key, {})};
   }
 
+  /**
+   * Returns a set of the values in this set, in `other`, or in both.
+   *
+   * Values of a much smaller set are inserted into the larger one, which
+   * shares most of its tree with the result. Otherwise both sets are merged
+   * in a single pass and the result is built at once.
+   */
   ABSL_MUST_USE_RESULT SortedSet union_with(const SortedSet& other) const {
     const SortedSet* result_ptr = this;
     const SortedSet* other_ptr = &other;
@@ -84,11 +97,93 @@ class SortedSet : public SortedContainer {
       other_ptr = this;
     }
 
-    auto result = *result_ptr;
-    for (const auto& k : *other_ptr) {
-      result = result.insert(k);
+    if (other_ptr->empty()) {
+      return *result_ptr;
     }
-    return result;
+
+    if (!PrefersMerge(other_ptr->size(), result_ptr->size())) {
+      auto result = *result_ptr;
+      for (const auto& k : *other_ptr) {
+        result = result.insert(k);
+      }
+      return result;
+    }
+
+    std::vector<K> values;
+    values.reserve(size() + other.size());
+    std::set_union(begin(), end(), other.begin(), other.end(),
+                   std::back_inserter(values), Less{comparator()});
+    return FromSortedValues(std::move(values), comparator());
+  }
+
+  /**
+   * Returns a set of the values in this set that are not in `other`.
+   *
+   * Removes the values of `other` one by one if it is much smaller than this
+   * set; otherwise filters this set in a single pass.
+   */
+  ABSL_MUST_USE_RESULT SortedSet difference_with(
+      const SortedSet& other) const {
+    if (empty() || other.empty()) {
+      return *this;
+    }
+
+    if (!PrefersMerge(other.size(), size())) {
+      auto result = *this;
+      for (const auto& k : other) {
+        result = result.erase(k);
+      }
+      return result;
+    }
+
+    std::vector<K> values;
+    if (PrefersMerge(size(), other.size())) {
+      values.reserve(size());
+      std::set_difference(begin(), end(), other.begin(), other.end(),
+                          std::back_inserter(values), Less{comparator()});
+    } else {
+      // This set is much smaller; look up each of its values instead.
+      for (const auto& k : *this) {
+        if (!other.contains(k)) {
+          values.push_back(k);
+        }
+      }
+    }
+    return FromSortedValues(std::move(values), comparator());
+  }
+
+  /**
+   * Returns a set of the values that are both in this set and in `other`.
+   *
+   * Looks up the values of the smaller set in the larger one if it is much
+   * smaller; otherwise merges both sets in a single pass.
+   */
+  ABSL_MUST_USE_RESULT SortedSet intersection_with(
+      const SortedSet& other) const {
+    const SortedSet* smaller = this;
+    const SortedSet* larger = &other;
+    if (smaller->size() > larger->size()) {
+      smaller = &other;
+      larger = this;
+    }
+
+    if (smaller->empty()) {
+      return SortedSet{comparator()};
+    }
+
+    std::vector<K> values;
+    if (PrefersMerge(smaller->size(), larger->size())) {
+      values.reserve(smaller->size());
+      std::set_intersection(begin(), end(), other.begin(), other.end(),
+                            std::back_inserter(values), Less{comparator()});
+    } else {
+      for (const auto& k : *smaller) {
+        if (larger->contains(k)) {
+          values.push_back(k);
+        }
+      }
+    }
+    return FromSortedValues(std::move(values), comparator());
   }
 
   ABSL_MUST_USE_RESULT SortedSet erase(const K& key) const {
@@ -141,6 +236,37 @@ class SortedSet : public SortedContainer {
     return map_.keys_in(start_key, end_key);
   }
 
+  /**
+   * Creates a SortedSet from values that are sorted and contain no
+   * duplicates, without the cost of inserting them one by one.
+   */
+  static SortedSet FromSortedValues(std::vector<K>&& values,
+                                    const C& comparator = {}) {
+    std::vector<typename map_type::value_type> entries;
+    entries.reserve(values.size());
+    for (K& value : values) {
+      entries.emplace_back(std::move(value), util::Empty{});
+    }
+    return SortedSet{map_type::FromSortedEntries(std::move(entries),
+                                                 comparator)};
+  }
+
+  /**
+   * Creates a SortedSet from values in any order, which may contain
+   * duplicates: sorts them and builds the set at once instead of inserting
+   * them one by one.
+   */
+  static SortedSet FromValues(std::vector<K>&& values,
+                              const C& comparator = {}) {
+    std::sort(values.begin(), values.end(), Less{comparator});
+    auto same = [&comparator](const K& lhs, const K& rhs) {
+      return util::Same(comparator.Compare(lhs, rhs));
+    };
+    values.erase(std::unique(values.begin(), values.end(), same),
+                 values.end());
+    return FromSortedValues(std::move(values), comparator);
+  }
+
   template <typename MapType>
   static SortedSet FromKeysOf(const MapType& map) {
     SortedSet result;
@@ -162,6 +288,30 @@ class SortedSet : public SortedContainer {
   }
 
  private:
+  /** Orders values by the set's comparator, for the standard algorithms. */
+  struct Less {
+    explicit Less(const C& comparator) : comparator{comparator} {
+    }
+
+    bool operator()(const K& lhs, const K& rhs) const {
+      return util::Ascending(comparator.Compare(lhs, rhs));
+    }
+
+    const C& comparator;
+  };
+
+  /**
+   * Returns whether combining a set with `smaller` values into one with
+   * `larger` values should walk both sets rather than update or look up the
+   * larger set once per value of the smaller one. The latter takes
+   * logarithmic time per value, but shares most of the larger set's tree.
+   */
+  static bool PrefersMerge(size_type smaller, size_type larger) {
+    return smaller > larger / kMergeRatio;
+  }
+
+  static constexpr size_type kMergeRatio = 16;
+
   map_type map_;
 };
 
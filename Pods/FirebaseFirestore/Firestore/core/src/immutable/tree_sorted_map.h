@@ -74,6 +74,18 @@ class TreeSortedMap : public SortedMapBase, private util::CompressedMember<C> {
     return TreeSortedMap{std::move(node), comparator};
   }
 
+  /**
+   * Creates a TreeSortedMap from entries that are sorted by key and contain no
+   * duplicate keys, moving the entries out of the range.
+   */
+  template <typename Iterator>
+  static TreeSortedMap FromSortedEntries(Iterator begin,
+                                         size_type count,
+                                         const C& comparator) {
+    return TreeSortedMap{node_type::FromSortedEntries(begin, count),
+                         comparator};
+  }
+
   /** Returns true if the map contains no elements. */
   bool empty() const {
     return root_.empty();
@@ -208,6 +208,66 @@ void WriteIndexValue(const google_firestore_v1_Value& value,
   encoder->WriteInfinity();
 }
 
+absl::optional<std::string> DocumentIndexValueWriter::EncodeDirectionalValues(
+    const model::FieldIndex& index) {
+  std::string result;
+  for (const model::Segment& segment : index.GetDirectionalSegments()) {
+    const absl::optional<std::string>& encoded =
+        EncodeField(segment.field_path(), segment.kind());
+    if (!encoded) {
+      return absl::nullopt;
+    }
+    // The encoders are stateless, so appending the values encoded one by one
+    // yields the same bytes as encoding them into a single buffer.
+    result += *encoded;
+  }
+  return result;
+}
+
+const std::vector<std::string>& DocumentIndexValueWriter::EncodeArrayElements(
+    const model::FieldPath& field_path) {
+  auto it = array_elements_.find(field_path);
+  if (it != array_elements_.end()) {
+    return it->second;
+  }
+
+  std::vector<std::string> elements;
+  absl::optional<google_firestore_v1_Value> field =
+      document_->field(field_path);
+  if (field &&
+      field->which_value_type == google_firestore_v1_Value_array_value_tag) {
+    IndexEncodingBuffer buffer;
+    elements.reserve(field->array_value.values_count);
+    for (pb_size_t i = 0; i < field->array_value.values_count; ++i) {
+      buffer.Reset();
+      WriteIndexValue(field->array_value.values[i],
+                      buffer.ForKind(model::Segment::kAscending));
+      elements.push_back(buffer.GetEncodedBytes());
+    }
+  }
+  return array_elements_.emplace(field_path, std::move(elements))
+      .first->second;
+}
+
+const absl::optional<std::string>& DocumentIndexValueWriter::EncodeField(
+    const model::FieldPath& field_path, model::Segment::Kind kind) {
+  auto key = std::make_pair(field_path, kind);
+  auto it = fields_.find(key);
+  if (it != fields_.end()) {
+    return it->second;
+  }
+
+  absl::optional<std::string> encoded;
+  absl::optional<google_firestore_v1_Value> field =
+      document_->field(field_path);
+  if (field) {
+    IndexEncodingBuffer buffer;
+    WriteIndexValue(*field, buffer.ForKind(kind));
+    encoded = buffer.GetEncodedBytes();
+  }
+  return fields_.emplace(std::move(key), std::move(encoded)).first->second;
+}
+
 }  // namespace index
 }  // namespace firestore
 }  // namespace firebase
@@ -17,8 +17,17 @@
 #ifndef FIRESTORE_CORE_SRC_INDEX_FIRESTORE_INDEX_VALUE_WRITER_H_
 #define FIRESTORE_CORE_SRC_INDEX_FIRESTORE_INDEX_VALUE_WRITER_H_
 
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
 #include "Firestore/core/src/index/index_byte_encoder.h"
+#include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/nanopb/nanopb_util.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -32,6 +41,46 @@ namespace index {
 void WriteIndexValue(const google_firestore_v1_Value& value,
                      DirectionalIndexByteEncoder* encoder);
 
+/**
+ * Encodes the index values of one document for all the field indexes of its
+ * collection group.
+ *
+ * Indexes of the same collection group usually share fields, so every field
+ * value is only encoded once per segment kind and the encoded bytes are
+ * reused by all the indexes that contain the field.
+ */
+class DocumentIndexValueWriter {
+ public:
+  /** `document` must outlive the writer. */
+  explicit DocumentIndexValueWriter(const model::Document& document)
+      : document_(document) {
+  }
+
+  /**
+   * Returns the encoded directional values of `index`, or `nullopt` if the
+   * document does not have all the directional fields of the index.
+   */
+  absl::optional<std::string> EncodeDirectionalValues(
+      const model::FieldIndex& index);
+
+  /**
+   * Returns the ascending encodings of the elements of the array value at
+   * `field_path`, which are empty if the field is missing or not an array.
+   */
+  const std::vector<std::string>& EncodeArrayElements(
+      const model::FieldPath& field_path);
+
+ private:
+  const absl::optional<std::string>& EncodeField(
+      const model::FieldPath& field_path, model::Segment::Kind kind);
+
+  const model::Document& document_;
+  std::map<std::pair<model::FieldPath, model::Segment::Kind>,
+           absl::optional<std::string>>
+      fields_;
+  std::map<model::FieldPath, std::vector<std::string>> array_elements_;
+};
+
 }  // namespace index
 }  // namespace firestore
 }  // namespace firebase
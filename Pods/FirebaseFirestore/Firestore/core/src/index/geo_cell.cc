@@ -0,0 +1,314 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/index/geo_cell.h"
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+#include "Firestore/core/src/util/ordered_code.h"
+
+namespace firebase {
+namespace firestore {
+namespace index {
+
+namespace {
+
+using util::OrderedCode;
+
+/** The level of the leaf cells, which quantize each coordinate to 32 bits. */
+constexpr int kMaxLevel = 32;
+
+/** The mean radius of the earth, as used by the haversine formula. */
+constexpr double kEarthRadiusMeters = 6371008.8;
+
+constexpr double kPi = 3.14159265358979323846;
+
+double ToRadians(double degrees) {
+  return degrees * kPi / 180;
+}
+
+double ToDegrees(double radians) {
+  return radians * 180 / kPi;
+}
+
+/** Maps `value` in [min, min + span] onto [0, 2^32). */
+uint32_t Quantize(double value, double min, double span) {
+  double scaled = (value - min) / span * 4294967296.0;
+  if (!(scaled > 0)) {
+    return 0;
+  }
+  if (scaled >= 4294967295.0) {
+    return UINT32_MAX;
+  }
+  return static_cast<uint32_t>(scaled);
+}
+
+uint32_t QuantizeLatitude(double latitude) {
+  return Quantize(latitude, -90, 180);
+}
+
+uint32_t QuantizeLongitude(double longitude) {
+  return Quantize(longitude, -180, 360);
+}
+
+/** Moves the bits of `value` to the even bit positions of the result. */
+uint64_t Spread(uint32_t value) {
+  uint64_t result = value;
+  result = (result | (result << 16)) & 0x0000FFFF0000FFFFULL;
+  result = (result | (result << 8)) & 0x00FF00FF00FF00FFULL;
+  result = (result | (result << 4)) & 0x0F0F0F0F0F0F0F0FULL;
+  result = (result | (result << 2)) & 0x3333333333333333ULL;
+  result = (result | (result << 1)) & 0x5555555555555555ULL;
+  return result;
+}
+
+uint64_t Interleave(uint32_t x, uint32_t y) {
+  return (Spread(x) << 1) | Spread(y);
+}
+
+/** An inclusive rectangle of quantized coordinates. */
+struct QuantizedRect {
+  uint32_t x_min;
+  uint32_t x_max;
+  uint32_t y_min;
+  uint32_t y_max;
+};
+
+/** A quadtree cell, which spans the same number of values on both axes. */
+struct Cell {
+  int level;
+  uint32_t x_min;
+  uint32_t y_min;
+
+  uint32_t span() const {
+    return static_cast<uint32_t>((uint64_t{1} << (kMaxLevel - level)) - 1);
+  }
+
+  uint32_t x_max() const {
+    return x_min + span();
+  }
+
+  uint32_t y_max() const {
+    return y_min + span();
+  }
+
+  Cell Child(int quadrant) const {
+    uint32_t half = span() / 2 + 1;
+    return Cell{level + 1, x_min + ((quadrant & 2) ? half : 0),
+                y_min + ((quadrant & 1) ? half : 0)};
+  }
+
+  GeoCellRange range() const {
+    return GeoCellRange{Interleave(x_min, y_min), Interleave(x_max(), y_max())};
+  }
+};
+
+enum class Relation { kDisjoint, kPartial, kInside };
+
+Relation Relate(const Cell& cell, const std::vector<QuantizedRect>& rects) {
+  Relation result = Relation::kDisjoint;
+  for (const QuantizedRect& rect : rects) {
+    if (cell.x_max() < rect.x_min || cell.x_min > rect.x_max ||
+        cell.y_max() < rect.y_min || cell.y_min > rect.y_max) {
+      continue;
+    }
+    if (cell.x_min >= rect.x_min && cell.x_max() <= rect.x_max &&
+        cell.y_min >= rect.y_min && cell.y_max() <= rect.y_max) {
+      return Relation::kInside;
+    }
+    result = Relation::kPartial;
+  }
+  return result;
+}
+
+}  // namespace
+
+GeoBounds GeoBounds::AroundPoint(const GeoPoint& center,
+                                 double radius_meters) {
+  double angular = std::max(radius_meters, 0.0) / kEarthRadiusMeters;
+  double latitude = ToRadians(center.latitude());
+  double min_latitude = latitude - angular;
+  double max_latitude = latitude + angular;
+
+  if (min_latitude <= -kPi / 2 || max_latitude >= kPi / 2) {
+    // The circle contains a pole, so it spans all longitudes.
+    return GeoBounds(GeoPoint(std::max(ToDegrees(min_latitude), -90.0), -180),
+                     GeoPoint(std::min(ToDegrees(max_latitude), 90.0), 180));
+  }
+
+  double delta = ToDegrees(std::asin(std::sin(angular) / std::cos(latitude)));
+  double west = center.longitude() - delta;
+  double east = center.longitude() + delta;
+  if (west < -180) west += 360;
+  if (east > 180) east -= 360;
+  return GeoBounds(GeoPoint(ToDegrees(min_latitude), west),
+                   GeoPoint(ToDegrees(max_latitude), east));
+}
+
+bool GeoBounds::Contains(const GeoPoint& point) const {
+  if (point.latitude() < south_west_.latitude() ||
+      point.latitude() > north_east_.latitude()) {
+    return false;
+  }
+  if (south_west_.longitude() <= north_east_.longitude()) {
+    return point.longitude() >= south_west_.longitude() &&
+           point.longitude() <= north_east_.longitude();
+  }
+  return point.longitude() >= south_west_.longitude() ||
+         point.longitude() <= north_east_.longitude();
+}
+
+bool GeoRegion::Contains(const GeoPoint& point) const {
+  if (!bounds_.Contains(point)) {
+    return false;
+  }
+  return !center_ || GeoDistance(*center_, point) <= radius_meters_;
+}
+
+uint64_t GeoCellId(const GeoPoint& point) {
+  return Interleave(QuantizeLongitude(point.longitude()),
+                    QuantizeLatitude(point.latitude()));
+}
+
+std::vector<GeoCellRange> CoverGeoBounds(const GeoBounds& bounds,
+                                         size_t max_ranges) {
+  uint32_t y_min = QuantizeLatitude(bounds.south_west().latitude());
+  uint32_t y_max = QuantizeLatitude(bounds.north_east().latitude());
+  uint32_t x_west = QuantizeLongitude(bounds.south_west().longitude());
+  uint32_t x_east = QuantizeLongitude(bounds.north_east().longitude());
+  if (y_min > y_max) {
+    return {};
+  }
+
+  std::vector<QuantizedRect> rects;
+  if (bounds.south_west().longitude() <= bounds.north_east().longitude()) {
+    rects.push_back({x_west, x_east, y_min, y_max});
+  } else {
+    rects.push_back({x_west, UINT32_MAX, y_min, y_max});
+    rects.push_back({0, x_east, y_min, y_max});
+  }
+
+  // Refine the covering one level at a time, for as long as splitting every
+  // partially covered cell keeps the covering within `max_ranges` cells.
+  std::vector<Cell> covering;
+  std::vector<Cell> frontier;
+  Cell root{0, 0, 0};
+  if (Relate(root, rects) == Relation::kInside) {
+    covering.push_back(root);
+  } else {
+    frontier.push_back(root);
+  }
+
+  while (!frontier.empty()) {
+    bool refine = frontier.front().level < kMaxLevel &&
+                  covering.size() + 4 * frontier.size() <= max_ranges;
+    if (!refine) {
+      covering.insert(covering.end(), frontier.begin(), frontier.end());
+      break;
+    }
+
+    std::vector<Cell> next;
+    for (const Cell& cell : frontier) {
+      for (int quadrant = 0; quadrant < 4; ++quadrant) {
+        Cell child = cell.Child(quadrant);
+        switch (Relate(child, rects)) {
+          case Relation::kDisjoint:
+            break;
+          case Relation::kPartial:
+            next.push_back(child);
+            break;
+          case Relation::kInside:
+            covering.push_back(child);
+            break;
+        }
+      }
+    }
+    frontier = std::move(next);
+  }
+
+  std::vector<GeoCellRange> ranges;
+  for (const Cell& cell : covering) {
+    ranges.push_back(cell.range());
+  }
+  std::sort(ranges.begin(), ranges.end(),
+            [](const GeoCellRange& lhs, const GeoCellRange& rhs) {
+              return lhs.min < rhs.min;
+            });
+
+  // Neighboring cells often have consecutive ids, and scan as one range.
+  std::vector<GeoCellRange> merged;
+  for (const GeoCellRange& range : ranges) {
+    if (!merged.empty() && merged.back().max + 1 == range.min) {
+      merged.back().max = range.max;
+    } else {
+      merged.push_back(range);
+    }
+  }
+  return merged;
+}
+
+double GeoDistance(const GeoPoint& a, const GeoPoint& b) {
+  double sin_latitude =
+      std::sin(ToRadians(b.latitude() - a.latitude()) / 2);
+  double sin_longitude =
+      std::sin(ToRadians(b.longitude() - a.longitude()) / 2);
+  double h = sin_latitude * sin_latitude +
+             std::cos(ToRadians(a.latitude())) *
+                 std::cos(ToRadians(b.latitude())) * sin_longitude *
+                 sin_longitude;
+  return 2 * kEarthRadiusMeters * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+absl::optional<GeoPoint> GeoPointValue(const google_firestore_v1_Value& value) {
+  if (value.which_value_type != google_firestore_v1_Value_geo_point_value_tag) {
+    return absl::nullopt;
+  }
+  return GeoPoint(value.geo_point_value.latitude,
+                  value.geo_point_value.longitude);
+}
+
+std::string EncodeGeoIndexValue(const GeoPoint& point) {
+  std::string result = EncodeGeoCellLowerBound(GeoCellId(point));
+  OrderedCode::WriteDoubleIncreasing(&result, point.latitude());
+  OrderedCode::WriteDoubleIncreasing(&result, point.longitude());
+  return result;
+}
+
+std::string EncodeGeoCellLowerBound(uint64_t cell_id) {
+  std::string result;
+  OrderedCode::WriteNumIncreasing(&result, cell_id);
+  return result;
+}
+
+absl::optional<std::pair<uint64_t, GeoPoint>> DecodeGeoIndexValue(
+    absl::string_view encoded) {
+  uint64_t cell_id;
+  double latitude;
+  double longitude;
+  if (!OrderedCode::ReadNumIncreasing(&encoded, &cell_id) ||
+      !OrderedCode::ReadDoubleIncreasing(&encoded, &latitude) ||
+      !OrderedCode::ReadDoubleIncreasing(&encoded, &longitude) ||
+      !encoded.empty()) {
+    return absl::nullopt;
+  }
+  return std::make_pair(cell_id, GeoPoint(latitude, longitude));
+}
+
+}  // namespace index
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,151 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_INDEX_GEO_CELL_H_
+#define FIRESTORE_CORE_SRC_INDEX_GEO_CELL_H_
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Firestore/Protos/nanopb/google/firestore/v1/document.nanopb.h"
+#include "Firestore/core/include/firebase/firestore/geo_point.h"
+#include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace index {
+
+/**
+ * A latitude/longitude rectangle. If the western longitude is larger than the
+ * eastern one, the rectangle crosses the antimeridian.
+ */
+class GeoBounds {
+ public:
+  GeoBounds(GeoPoint south_west, GeoPoint north_east)
+      : south_west_(south_west), north_east_(north_east) {
+  }
+
+  /**
+   * Returns the smallest rectangle that contains all points within
+   * `radius_meters` of `center`.
+   */
+  static GeoBounds AroundPoint(const GeoPoint& center, double radius_meters);
+
+  const GeoPoint& south_west() const {
+    return south_west_;
+  }
+
+  const GeoPoint& north_east() const {
+    return north_east_;
+  }
+
+  bool Contains(const GeoPoint& point) const;
+
+ private:
+  GeoPoint south_west_;
+  GeoPoint north_east_;
+};
+
+/** A box or a circle on the globe that geo index lookups are restricted to. */
+class GeoRegion {
+ public:
+  static GeoRegion Box(const GeoBounds& bounds) {
+    return GeoRegion(bounds, absl::nullopt, 0);
+  }
+
+  static GeoRegion Circle(const GeoPoint& center, double radius_meters) {
+    return GeoRegion(GeoBounds::AroundPoint(center, radius_meters), center,
+                     radius_meters);
+  }
+
+  /** The bounding box of the region, which is scanned in the geo index. */
+  const GeoBounds& bounds() const {
+    return bounds_;
+  }
+
+  bool Contains(const GeoPoint& point) const;
+
+ private:
+  GeoRegion(const GeoBounds& bounds,
+            absl::optional<GeoPoint> center,
+            double radius_meters)
+      : bounds_(bounds), center_(center), radius_meters_(radius_meters) {
+  }
+
+  GeoBounds bounds_;
+  absl::optional<GeoPoint> center_;
+  double radius_meters_;
+};
+
+/** An inclusive range of leaf cell ids. */
+struct GeoCellRange {
+  uint64_t min;
+  uint64_t max;
+};
+
+/**
+ * Returns the id of the leaf cell that contains `point`.
+ *
+ * Cells form a quadtree over the latitude/longitude plane, and ids are the
+ * interleaved bits of the quantized longitude and latitude (as in a geohash).
+ * The ids of all leaves of any cell are therefore contiguous, so a cell maps
+ * to a single range of ids.
+ */
+uint64_t GeoCellId(const GeoPoint& point);
+
+/**
+ * Returns sorted, disjoint ranges of leaf cell ids that together contain all
+ * points in `bounds`.
+ *
+ * The covering is refined for as long as it stays within `max_ranges` cells,
+ * so the ranges may also contain points just outside of `bounds`.
+ */
+std::vector<GeoCellRange> CoverGeoBounds(const GeoBounds& bounds,
+                                         size_t max_ranges);
+
+/** Returns the great-circle distance between `a` and `b` in meters. */
+double GeoDistance(const GeoPoint& a, const GeoPoint& b);
+
+/**
+ * Returns the point stored in `value`, or `nullopt` if `value` is not a
+ * geo point.
+ */
+absl::optional<GeoPoint> GeoPointValue(const google_firestore_v1_Value& value);
+
+/**
+ * Encodes `point` as the directional value of a geo index entry: the leaf
+ * cell id, which orders the entries, followed by the exact coordinates.
+ */
+std::string EncodeGeoIndexValue(const GeoPoint& point);
+
+/** Encodes the smallest directional value of the entries in `cell_id`. */
+std::string EncodeGeoCellLowerBound(uint64_t cell_id);
+
+/**
+ * Decodes a value written by `EncodeGeoIndexValue()`. Returns `nullopt` if
+ * `encoded` is not a geo index value.
+ */
+absl::optional<std::pair<uint64_t, GeoPoint>> DecodeGeoIndexValue(
+    absl::string_view encoded);
+
+}  // namespace index
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_INDEX_GEO_CELL_H_
@@ -0,0 +1,95 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/hot_document_cache.h"
+
+#include <iterator>
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using model::DocumentKey;
+using model::MutableDocument;
+
+void HotDocumentCache::set_max_bytes(size_t max_bytes) {
+  max_bytes_ = max_bytes;
+  EvictToFit(max_bytes_);
+}
+
+absl::optional<MutableDocument> HotDocumentCache::Get(const DocumentKey& key) {
+  if (!enabled()) {
+    return absl::nullopt;
+  }
+
+  auto found = index_.find(key);
+  if (found == index_.end()) {
+    ++miss_count_;
+    return absl::nullopt;
+  }
+
+  ++hit_count_;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  // Callers apply mutations to the documents they read, so hand out a copy
+  // that doesn't share the cached data.
+  return found->second->document.Clone();
+}
+
+void HotDocumentCache::Put(const MutableDocument& document, size_t byte_size) {
+  if (byte_size > max_bytes_) {
+    Invalidate(document.key());
+    return;
+  }
+
+  auto found = index_.find(document.key());
+  if (found != index_.end()) {
+    Erase(found->second);
+  }
+
+  EvictToFit(max_bytes_ - byte_size);
+  entries_.push_front(Entry{document.Clone(), byte_size});
+  index_.emplace(document.key(), entries_.begin());
+  byte_size_ += byte_size;
+}
+
+void HotDocumentCache::Invalidate(const DocumentKey& key) {
+  auto found = index_.find(key);
+  if (found != index_.end()) {
+    Erase(found->second);
+  }
+}
+
+void HotDocumentCache::Clear() {
+  entries_.clear();
+  index_.clear();
+  byte_size_ = 0;
+}
+
+void HotDocumentCache::Erase(EntryList::iterator entry) {
+  byte_size_ -= entry->byte_size;
+  index_.erase(entry->document.key());
+  entries_.erase(entry);
+}
+
+void HotDocumentCache::EvictToFit(size_t max_bytes) {
+  while (byte_size_ > max_bytes && !entries_.empty()) {
+    Erase(std::prev(entries_.end()));
+  }
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
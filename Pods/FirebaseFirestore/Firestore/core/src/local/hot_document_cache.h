@@ -0,0 +1,122 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_HOT_DOCUMENT_CACHE_H_
+#define FIRESTORE_CORE_SRC_LOCAL_HOT_DOCUMENT_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <unordered_map>
+#include <utility>
+
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * A size-bounded cache of recently read, decoded documents.
+ *
+ * Entries are evicted in least-recently-used order once the sum of their
+ * sizes exceeds the budget. The size of an entry is the size of its encoded
+ * form, which is a cheap approximation of the memory used by the decoded
+ * document. A budget of zero disables the cache.
+ *
+ * This class is not thread-safe.
+ */
+class HotDocumentCache {
+ public:
+  explicit HotDocumentCache(size_t max_bytes = 0) : max_bytes_(max_bytes) {
+  }
+
+  /** Sets the byte budget, evicting entries if the cache is now too large. */
+  void set_max_bytes(size_t max_bytes);
+
+  size_t max_bytes() const {
+    return max_bytes_;
+  }
+
+  bool enabled() const {
+    return max_bytes_ > 0;
+  }
+
+  /**
+   * Returns a copy of the cached document for `key`, or `nullopt` if it is not
+   * cached. The caller may modify the returned document.
+   */
+  absl::optional<model::MutableDocument> Get(const model::DocumentKey& key);
+
+  /**
+   * Caches a copy of `document`, whose encoded form takes `byte_size` bytes.
+   * Documents that are larger than the whole budget are not cached.
+   */
+  void Put(const model::MutableDocument& document, size_t byte_size);
+
+  /** Drops the cached entry for `key`, if any. */
+  void Invalidate(const model::DocumentKey& key);
+
+  /** Drops all entries. The hit and miss counters are kept. */
+  void Clear();
+
+  size_t hit_count() const {
+    return hit_count_;
+  }
+
+  size_t miss_count() const {
+    return miss_count_;
+  }
+
+  /** The sum of the sizes of all cached entries. */
+  size_t byte_size() const {
+    return byte_size_;
+  }
+
+  size_t size() const {
+    return index_.size();
+  }
+
+ private:
+  struct Entry {
+    model::MutableDocument document;
+    size_t byte_size;
+  };
+
+  // Most recently used entries are at the front.
+  using EntryList = std::list<Entry>;
+
+  void Erase(EntryList::iterator entry);
+  void EvictToFit(size_t max_bytes);
+
+  size_t max_bytes_ = 0;
+  size_t byte_size_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  EntryList entries_;
+  std::unordered_map<model::DocumentKey,
+                     EntryList::iterator,
+                     model::DocumentKeyHash>
+      index_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_HOT_DOCUMENT_CACHE_H_
@@ -0,0 +1,103 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/index_backfiller.h"
+
+#include <algorithm>
+#include <unordered_set>
+
+#include "Firestore/core/src/local/index_manager.h"
+#include "Firestore/core/src/local/local_documents_result.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/model/field_index.h"
+#include "Firestore/core/src/util/log.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+/** The maximum number of documents to process each time Backfill() runs. */
+const size_t kMaxDocumentsToProcess = 50;
+
+}  // namespace
+
+using model::IndexOffset;
+
+IndexBackfiller::IndexBackfiller()
+    : max_documents_to_process_(kMaxDocumentsToProcess) {
+}
+
+size_t IndexBackfiller::WriteIndexEntries(
+    IndexManager* index_manager, LocalDocumentsView* local_documents_view) {
+  std::unordered_set<std::string> processed_collection_groups;
+  size_t documents_remaining = max_documents_to_process_;
+  while (documents_remaining > 0) {
+    absl::optional<std::string> collection_group =
+        index_manager->GetNextCollectionGroupToUpdate();
+    if (!collection_group ||
+        processed_collection_groups.count(*collection_group) > 0) {
+      break;
+    }
+
+    LOG_DEBUG("Processing collection: %s", *collection_group);
+    size_t processed = WriteEntriesForCollectionGroup(
+        index_manager, local_documents_view, *collection_group,
+        documents_remaining);
+    documents_remaining -= std::min(processed, documents_remaining);
+    processed_collection_groups.insert(*collection_group);
+  }
+  return max_documents_to_process_ - documents_remaining;
+}
+
+size_t IndexBackfiller::WriteEntriesForCollectionGroup(
+    IndexManager* index_manager,
+    LocalDocumentsView* local_documents_view,
+    const std::string& collection_group,
+    size_t documents_remaining_under_cap) {
+  // Use the earliest offset of all field indexes to query the local cache.
+  IndexOffset existing_offset = index_manager->GetMinOffset(collection_group);
+  LocalDocumentsResult next_batch = local_documents_view->GetNextDocuments(
+      collection_group, existing_offset, documents_remaining_under_cap);
+  index_manager->UpdateIndexEntries(next_batch.documents());
+
+  IndexOffset new_offset = GetNewOffset(existing_offset, next_batch);
+  LOG_DEBUG("Updating offset for %s to %s", collection_group,
+            new_offset.read_time().ToString());
+  index_manager->UpdateCollectionGroup(collection_group, new_offset);
+  return next_batch.documents().size();
+}
+
+IndexOffset IndexBackfiller::GetNewOffset(
+    const IndexOffset& existing_offset,
+    const LocalDocumentsResult& lookup_result) {
+  IndexOffset max_offset = existing_offset;
+  for (const auto& entry : lookup_result.documents()) {
+    IndexOffset new_offset = IndexOffset::FromDocument(entry.second);
+    if (new_offset.CompareTo(max_offset) ==
+        util::ComparisonResult::Descending) {
+      max_offset = new_offset;
+    }
+  }
+  return IndexOffset(
+      max_offset.read_time(), max_offset.document_key(),
+      std::max(lookup_result.batch_id(), existing_offset.largest_batch_id()));
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
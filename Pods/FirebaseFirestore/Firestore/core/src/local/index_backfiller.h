@@ -0,0 +1,80 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
+
+#include <cstddef>
+#include <string>
+
+#include "Firestore/core/src/model/model_fwd.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+class IndexManager;
+class LocalDocumentsResult;
+class LocalDocumentsView;
+
+/**
+ * Implements the steps for backfilling indexes: reads documents that changed
+ * since an index was last updated and writes their index entries.
+ */
+class IndexBackfiller {
+ public:
+  IndexBackfiller();
+
+  /**
+   * Writes index entries until the cap is reached. Returns the number of
+   * documents processed.
+   *
+   * Must be called from within a persistence transaction.
+   */
+  size_t WriteIndexEntries(IndexManager* index_manager,
+                           LocalDocumentsView* local_documents_view);
+
+  size_t max_documents_to_process() const {
+    return max_documents_to_process_;
+  }
+
+  void set_max_documents_to_process(size_t max_documents_to_process) {
+    max_documents_to_process_ = max_documents_to_process;
+  }
+
+ private:
+  /**
+   * Writes entries for the provided collection group. Returns the number of
+   * documents processed.
+   */
+  size_t WriteEntriesForCollectionGroup(
+      IndexManager* index_manager,
+      LocalDocumentsView* local_documents_view,
+      const std::string& collection_group,
+      size_t documents_remaining_under_cap);
+
+  /** Returns the next offset based on the provided documents. */
+  model::IndexOffset GetNewOffset(const model::IndexOffset& existing_offset,
+                                  const LocalDocumentsResult& lookup_result);
+
+  size_t max_documents_to_process_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_H_
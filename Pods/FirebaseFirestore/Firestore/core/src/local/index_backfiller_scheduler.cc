@@ -0,0 +1,107 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/index_backfiller_scheduler.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "Firestore/core/src/local/local_store.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/log.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+namespace {
+
+/** The number of documents indexed in one transaction by default. */
+const size_t kDefaultDocumentsPerSlice = 50;
+
+/**
+ * The minimum delay between two slices. Operations queued while a slice ran
+ * go first even with a zero delay; the minimum also leaves room for
+ * operations that follow shortly after.
+ */
+const IndexBackfillerScheduler::Milliseconds kMinimumSliceDelay{10};
+
+}  // namespace
+
+constexpr size_t IndexBackfillerScheduler::DefaultDocumentsPerSecond;
+
+IndexBackfillerScheduler::IndexBackfillerScheduler(
+    std::shared_ptr<util::AsyncQueue> queue, LocalStore* local_store)
+    : queue_(std::move(queue)),
+      local_store_(NOT_NULL(local_store)),
+      documents_per_slice_(kDefaultDocumentsPerSlice) {
+}
+
+void IndexBackfillerScheduler::Start() {
+  progress_ = IndexBackfillProgress{};
+  Schedule(initial_delay_);
+}
+
+void IndexBackfillerScheduler::Stop() {
+  slice_operation_.Cancel();
+}
+
+void IndexBackfillerScheduler::set_documents_per_slice(
+    size_t documents_per_slice) {
+  HARD_ASSERT(documents_per_slice > 0,
+              "Index backfill slices must process at least one document");
+  documents_per_slice_ = documents_per_slice;
+}
+
+void IndexBackfillerScheduler::Schedule(Milliseconds delay) {
+  slice_operation_ = queue_->EnqueueAfterDelay(
+      delay, util::TimerId::IndexBackfill,
+      util::AsyncQueue::Priority::kBackground, [this] { RunSlice(); });
+}
+
+void IndexBackfillerScheduler::RunSlice() {
+  size_t processed = local_store_->Backfill(documents_per_slice_);
+
+  // A slice that could not fill its quota ran out of documents to index.
+  bool was_caught_up = progress_.caught_up;
+  progress_.documents_processed = processed;
+  progress_.total_documents_processed += processed;
+  progress_.caught_up = processed < documents_per_slice_;
+
+  if (processed > 0) {
+    LOG_DEBUG("Documents written to index: %s (%s total)", processed,
+              progress_.total_documents_processed);
+  }
+  if (progress_callback_ && (processed > 0 || !was_caught_up)) {
+    progress_callback_(progress_);
+  }
+
+  Schedule(progress_.caught_up ? idle_delay_ : DelayForBudget(processed));
+}
+
+IndexBackfillerScheduler::Milliseconds
+IndexBackfillerScheduler::DelayForBudget(size_t documents_processed) const {
+  if (documents_per_second_ == 0) {
+    return kMinimumSliceDelay;
+  }
+
+  Milliseconds budget_delay{documents_processed * 1000 /
+                            documents_per_second_};
+  return std::max(budget_delay, kMinimumSliceDelay);
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_SCHEDULER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_SCHEDULER_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <functional>
+#include <memory>
+
+#include "Firestore/core/src/util/async_queue.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+class LocalStore;
+
+/** Describes the work done by a single slice of index backfilling. */
+struct IndexBackfillProgress {
+  /** The number of documents indexed by the slice. */
+  size_t documents_processed = 0;
+
+  /** The number of documents indexed since the scheduler was started. */
+  size_t total_documents_processed = 0;
+
+  /**
+   * Whether all field indexes have caught up with the local cache. More work
+   * only becomes available once documents change or indexes are created.
+   */
+  bool caught_up = false;
+};
+
+using IndexBackfillProgressCallback =
+    std::function<void(const IndexBackfillProgress&)>;
+
+/**
+ * Runs the index backfiller on the worker queue in small time slices.
+ *
+ * Each slice indexes a bounded number of documents (in read time order, see
+ * `IndexBackfiller`) in its own transaction and then yields the queue, so
+ * that user operations queued in the meantime run before the next slice. The
+ * delay between slices is chosen so that the documents per second budget is
+ * not exceeded. Once the indexes are caught up, the scheduler falls back to
+ * checking for new work at a regular, low frequency.
+ */
+class IndexBackfillerScheduler {
+ public:
+  using Milliseconds = util::AsyncQueue::Milliseconds;
+
+  static constexpr size_t DefaultDocumentsPerSecond = 500;
+
+  /**
+   * @param queue The worker queue to run the backfill on.
+   * @param local_store The local store to backfill. Must outlive the
+   *     scheduler or `Stop()` must be called before it is destroyed.
+   */
+  IndexBackfillerScheduler(std::shared_ptr<util::AsyncQueue> queue,
+                           LocalStore* local_store);
+
+  /** Schedules the first slice after the initial delay. */
+  void Start();
+
+  /** Cancels any scheduled slice. */
+  void Stop();
+
+  /**
+   * Sets the maximum number of documents that are indexed per second of wall
+   * time. Zero disables the budget, allowing slices to run back to back.
+   */
+  void set_documents_per_second(size_t documents_per_second) {
+    documents_per_second_ = documents_per_second;
+  }
+
+  /** Sets the number of documents indexed per slice. Must be positive. */
+  void set_documents_per_slice(size_t documents_per_slice);
+
+  /**
+   * Sets a callback that is invoked on the worker queue after every slice
+   * that indexed documents or that observed the indexes catching up.
+   */
+  void set_progress_callback(IndexBackfillProgressCallback callback) {
+    progress_callback_ = std::move(callback);
+  }
+
+ private:
+  void Schedule(Milliseconds delay);
+  void RunSlice();
+
+  /** Returns the delay that keeps `documents_processed` within budget. */
+  Milliseconds DelayForBudget(size_t documents_processed) const;
+
+  std::shared_ptr<util::AsyncQueue> queue_;
+  LocalStore* local_store_ = nullptr;
+
+  size_t documents_per_second_ = DefaultDocumentsPerSecond;
+  size_t documents_per_slice_;
+  Milliseconds initial_delay_ = std::chrono::seconds(15);
+  Milliseconds idle_delay_ = std::chrono::minutes(1);
+
+  IndexBackfillProgress progress_;
+  IndexBackfillProgressCallback progress_callback_;
+  util::DelayedOperation slice_operation_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_INDEX_BACKFILLER_SCHEDULER_H_
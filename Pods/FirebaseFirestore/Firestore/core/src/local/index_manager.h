@@ -30,6 +30,10 @@ class Target;
 class SortedMap;
 }  // namespace core
 
+namespace index {
+class GeoRegion;
+}  // namespace index
+
 namespace model {
 class DocumentKey;
 class FieldIndex;
@@ -47,6 +51,24 @@ namespace local {
  */
 class IndexManager {
  public:
+  /** Represents the index state as it relates to a particular target. */
+  enum class IndexType {
+    /** Indicates that no index could be found for serving the target. */
+    NONE,
+    /**
+     * Indicates that only a "partial index" could be found for serving the
+     * target. A partial index is one which does not have a segment for every
+     * filter/orderBy in the target.
+     */
+    PARTIAL,
+    /**
+     * Indicates that a "full index" could be found for serving the target. A
+     * full index is one which has a segment for every filter/orderBy in the
+     * target.
+     */
+    FULL
+  };
+
   virtual ~IndexManager() = default;
 
   /** Initializes the IndexManager. */
@@ -101,6 +123,18 @@ class IndexManager {
   virtual absl::optional<model::FieldIndex> GetFieldIndex(
       const core::Target& target) = 0;
 
+  /**
+   * Creates a full matched field index which serves the given target.
+   *
+   * Targets that are already fully served by an existing index are left
+   * untouched. The entries for the new index are written by the index
+   * backfiller.
+   */
+  virtual void CreateTargetIndexes(const core::Target& target) = 0;
+
+  /** Returns the type of index (if any) that can be used to serve `target`. */
+  virtual IndexType GetIndexType(const core::Target& target) = 0;
+
   /**
    * Returns the documents that match the given target based on the provided
    * index, or `nullopt` if the query cannot be served from an index.
@@ -108,6 +142,36 @@ class IndexManager {
   virtual absl::optional<std::vector<model::DocumentKey>>
   GetDocumentsMatchingTarget(const core::Target& target) = 0;
 
+  /**
+   * Returns the geo index over `field_path` of the given collection group, or
+   * `nullopt` if no such index is configured.
+   */
+  virtual absl::optional<model::FieldIndex> GetGeoIndex(
+      const std::string& collection_group,
+      const model::FieldPath& field_path) = 0;
+
+  /**
+   * Returns the documents whose entries in the geo index `index` lie within
+   * `region`. The entries only reflect the documents up to the index offset
+   * of `index`.
+   */
+  virtual std::vector<model::DocumentKey> GetDocumentsInRegion(
+      const model::FieldIndex& index, const index::GeoRegion& region) = 0;
+
+  /**
+   * Returns the lowest offset at which all indexes used to serve `target` are
+   * up to date. Documents that were changed after this offset are not yet
+   * reflected in the index and need to be read from the remote document cache.
+   */
+  virtual model::IndexOffset GetMinOffset(const core::Target& target) = 0;
+
+  /**
+   * Returns the lowest offset at which all field indexes of the given
+   * collection group are up to date.
+   */
+  virtual model::IndexOffset GetMinOffset(
+      const std::string& collection_group) = 0;
+
   /**
    * Returns the next collection group to update. Returns `nullopt` if no
    * group exists.
@@ -23,6 +23,7 @@
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -36,6 +37,7 @@ namespace local {
 
 using credentials::User;
 using model::DocumentKey;
+using model::DocumentKeySet;
 using model::Mutation;
 using model::MutationByDocumentKeyMap;
 using model::Overlay;
@@ -54,28 +56,28 @@ LevelDbDocumentOverlayCache::LevelDbDocumentOverlayCache(
 
 absl::optional<Overlay> LevelDbDocumentOverlayCache::GetOverlay(
     const DocumentKey& document_key) const {
-  const std::string key_prefix =
-      LevelDbDocumentOverlayKey::KeyPrefix(user_id_, document_key);
-
   auto it = db_->current_transaction()->NewIterator();
-  it->Seek(key_prefix);
-
-  if (!it->Valid() || !absl::StartsWith(it->key(), key_prefix)) {
-    return absl::nullopt;
-  }
+  return GetOverlay(document_key, it.get());
+}
 
-  LevelDbDocumentOverlayKey key;
-  HARD_ASSERT(key.Decode(it->key()));
-  if (key.document_key() != document_key) {
-    return absl::nullopt;
+void LevelDbDocumentOverlayCache::GetOverlays(
+    OverlayByDocumentKeyMap& dest, const DocumentKeySet& keys) const {
+  // The keys are visited in order, so a single iterator only ever seeks
+  // forward through the overlay rows.
+  auto it = db_->current_transaction()->NewIterator();
+  for (const DocumentKey& key : keys) {
+    absl::optional<Overlay> overlay = GetOverlay(key, it.get());
+    if (overlay.has_value()) {
+      dest[key] = std::move(overlay).value();
+    }
   }
-
-  return ParseOverlay(key, it->value());
 }
 
 void LevelDbDocumentOverlayCache::SaveOverlays(
     int largest_batch_id, const MutationByDocumentKeyMap& overlays) {
+  auto it = db_->current_transaction()->NewIterator();
   for (const auto& overlays_entry : overlays) {
+    DeleteOverlays(overlays_entry.first, it.get());
     SaveOverlay(largest_batch_id, overlays_entry.first, overlays_entry.second);
   }
 }
@@ -88,9 +90,10 @@ void LevelDbDocumentOverlayCache::RemoveOverlaysForBatchId(int batch_id) {
 OverlayByDocumentKeyMap LevelDbDocumentOverlayCache::GetOverlays(
     const ResourcePath& collection, int since_batch_id) const {
   OverlayByDocumentKeyMap result;
+  auto it = db_->current_transaction()->NewIterator();
   ForEachKeyInCollection(
       collection, since_batch_id, [&](LevelDbDocumentOverlayKey&& key) {
-        absl::optional<Overlay> overlay = GetOverlay(key);
+        absl::optional<Overlay> overlay = GetOverlay(key, it.get());
         HARD_ASSERT(overlay.has_value());
         result[std::move(key).document_key()] = std::move(overlay).value();
       });
@@ -103,6 +106,7 @@ OverlayByDocumentKeyMap LevelDbDocumentOverlayCache::GetOverlays(
     std::size_t count) const {
   absl::optional<int> current_batch_id;
   OverlayByDocumentKeyMap result;
+  auto it = db_->current_transaction()->NewIterator();
   ForEachKeyInCollectionGroup(
       collection_group, since_batch_id,
       [&](LevelDbDocumentOverlayKey&& key) -> ForEachKeyAction {
@@ -115,7 +119,7 @@ OverlayByDocumentKeyMap LevelDbDocumentOverlayCache::GetOverlays(
           current_batch_id = key.largest_batch_id();
         }
 
-        absl::optional<Overlay> overlay = GetOverlay(key);
+        absl::optional<Overlay> overlay = GetOverlay(key, it.get());
         HARD_ASSERT(overlay.has_value());
         result[std::move(key).document_key()] = std::move(overlay).value();
         return ForEachKeyAction::kKeepGoing;
@@ -169,9 +173,6 @@ Overlay LevelDbDocumentOverlayCache::ParseOverlay(
 void LevelDbDocumentOverlayCache::SaveOverlay(int largest_batch_id,
                                               const DocumentKey& document_key,
                                               const Mutation& mutation) {
-  // Remove the existing overlay and any index entries pointing to it.
-  DeleteOverlay(document_key);
-
   const LevelDbDocumentOverlayKey key(user_id_, document_key, largest_batch_id);
 
   // Add the overlay to the database and index entries pointing to it.
@@ -187,20 +188,20 @@ void LevelDbDocumentOverlayCache::SaveOverlay(int largest_batch_id,
   }
 }
 
-void LevelDbDocumentOverlayCache::DeleteOverlay(
-    const model::DocumentKey& document_key) {
+void LevelDbDocumentOverlayCache::DeleteOverlays(
+    const model::DocumentKey& document_key, LevelDbTransaction::Iterator* it) {
   const std::string key_prefix =
       LevelDbDocumentOverlayKey::KeyPrefix(user_id_, document_key);
-  auto it = db_->current_transaction()->NewIterator();
-  it->Seek(key_prefix);
-
-  if (!it->Valid() || !absl::StartsWith(it->key(), key_prefix)) {
-    return;
-  }
 
+  // Rows for the document are ordered by batch ID. The prefix also matches
+  // documents in subcollections, which sort after them.
   LevelDbDocumentOverlayKey key;
-  HARD_ASSERT(key.Decode(it->key()));
-  if (key.document_key() == document_key) {
+  for (it->Seek(key_prefix);
+       it->Valid() && absl::StartsWith(it->key(), key_prefix); it->Next()) {
+    HARD_ASSERT(key.Decode(it->key()));
+    if (key.document_key() != document_key) {
+      break;
+    }
     DeleteOverlay(key);
   }
 }
@@ -288,8 +289,27 @@ void LevelDbDocumentOverlayCache::ForEachKeyInCollectionGroup(
 }
 
 absl::optional<Overlay> LevelDbDocumentOverlayCache::GetOverlay(
-    const LevelDbDocumentOverlayKey& key) const {
-  auto it = db_->current_transaction()->NewIterator();
+    const DocumentKey& document_key, LevelDbTransaction::Iterator* it) const {
+  const std::string key_prefix =
+      LevelDbDocumentOverlayKey::KeyPrefix(user_id_, document_key);
+
+  it->Seek(key_prefix);
+  if (!it->Valid() || !absl::StartsWith(it->key(), key_prefix)) {
+    return absl::nullopt;
+  }
+
+  LevelDbDocumentOverlayKey key;
+  HARD_ASSERT(key.Decode(it->key()));
+  if (key.document_key() != document_key) {
+    return absl::nullopt;
+  }
+
+  return ParseOverlay(key, it->value());
+}
+
+absl::optional<Overlay> LevelDbDocumentOverlayCache::GetOverlay(
+    const LevelDbDocumentOverlayKey& key,
+    LevelDbTransaction::Iterator* it) const {
   const std::string encoded_key = key.Encode();
   it->Seek(encoded_key);
   if (!it->Valid() || it->key() != encoded_key) {
@@ -22,6 +22,7 @@
 #include <string>
 
 #include "Firestore/core/src/local/document_overlay_cache.h"
+#include "Firestore/core/src/local/leveldb_transaction.h"
 #include "absl/strings/string_view.h"
 
 namespace firebase {
@@ -55,6 +56,9 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
   absl::optional<model::Overlay> GetOverlay(
       const model::DocumentKey&) const override;
 
+  void GetOverlays(model::OverlayByDocumentKeyMap& dest,
+                   const model::DocumentKeySet& keys) const override;
+
   void SaveOverlays(int largest_batch_id,
                     const model::MutationByDocumentKeyMap& overlays) override;
 
@@ -91,7 +95,12 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
                    const model::DocumentKey& document_key,
                    const model::Mutation& mutation);
 
-  void DeleteOverlay(const model::DocumentKey&);
+  /**
+   * Deletes every overlay row stored for the given document, folding any
+   * superseded rows left behind along with the current one.
+   */
+  void DeleteOverlays(const model::DocumentKey&,
+                      LevelDbTransaction::Iterator* it);
 
   void DeleteOverlay(const LevelDbDocumentOverlayKey&);
 
@@ -110,7 +119,12 @@ class LevelDbDocumentOverlayCache final : public DocumentOverlayCache {
       std::function<ForEachKeyAction(LevelDbDocumentOverlayKey&&)>) const;
 
   absl::optional<model::Overlay> GetOverlay(
-      const LevelDbDocumentOverlayKey& decoded_key) const;
+      const model::DocumentKey& document_key,
+      LevelDbTransaction::Iterator* it) const;
+
+  absl::optional<model::Overlay> GetOverlay(
+      const LevelDbDocumentOverlayKey& decoded_key,
+      LevelDbTransaction::Iterator* it) const;
 
   // The LevelDbDocumentOverlayCache instance is owned by LevelDbPersistence.
   LevelDbPersistence* db_;
@@ -19,7 +19,6 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
-#include <set>
 #include <string>
 #include <unordered_set>
 #include <utility>
@@ -27,6 +26,7 @@
 
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/index/firestore_index_value_writer.h"
+#include "Firestore/core/src/index/geo_cell.h"
 #include "Firestore/core/src/index/index_byte_encoder.h"
 #include "Firestore/core/src/index/index_entry.h"
 #include "Firestore/core/src/local/leveldb_key.h"
@@ -40,7 +40,6 @@
 #include "Firestore/core/src/model/target_index_matcher.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
-#include "Firestore/core/src/util/set_util.h"
 #include "Firestore/core/src/util/string_util.h"
 #include "Firestore/third_party/nlohmann_json/json.hpp"
 #include "absl/strings/match.h"
@@ -67,6 +66,12 @@ using nlohmann::json;
 
 namespace {
 
+/**
+ * The largest number of cell ranges a geo lookup scans. More ranges fit the
+ * region more tightly, but each one costs a seek.
+ */
+const size_t kMaxGeoCellRanges = 16;
+
 struct DbIndexState {
   int64_t seconds;
   int32_t nanos;
@@ -455,6 +460,39 @@ absl::optional<model::FieldIndex> LevelDbIndexManager::GetFieldIndex(
   return result;
 }
 
+void LevelDbIndexManager::CreateTargetIndexes(const core::Target& target) {
+  HARD_ASSERT(started_, "IndexManager not started");
+
+  for (const Target& sub_target : GetSubTargets(target)) {
+    if (GetIndexType(sub_target) == IndexType::FULL) {
+      continue;
+    }
+
+    FieldIndex field_index = TargetIndexMatcher(sub_target).BuildTargetIndex();
+    if (!field_index.segments().empty()) {
+      LOG_DEBUG("Creating index %s for target %s",
+                field_index.collection_group(), sub_target.CanonicalId());
+      AddFieldIndex(field_index);
+    }
+  }
+}
+
+IndexManager::IndexType LevelDbIndexManager::GetIndexType(
+    const core::Target& target) {
+  IndexType result = IndexType::FULL;
+  for (const Target& sub_target : GetSubTargets(target)) {
+    absl::optional<FieldIndex> index = GetFieldIndex(sub_target);
+    if (!index.has_value()) {
+      return IndexType::NONE;
+    }
+
+    if (index.value().segments().size() < sub_target.GetSegmentCount()) {
+      result = IndexType::PARTIAL;
+    }
+  }
+  return result;
+}
+
 absl::optional<std::vector<model::DocumentKey>>
 LevelDbIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
   std::unordered_map<core::Target, model::FieldIndex> indexes;
@@ -514,6 +552,54 @@ LevelDbIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
   return result;
 }
 
+absl::optional<model::FieldIndex> LevelDbIndexManager::GetGeoIndex(
+    const std::string& collection_group, const model::FieldPath& field_path) {
+  for (FieldIndex index : GetFieldIndexes(collection_group)) {
+    auto geo_segment = index.GetGeoSegment();
+    if (geo_segment.has_value() && geo_segment->field_path() == field_path) {
+      return index;
+    }
+  }
+  return absl::nullopt;
+}
+
+std::vector<model::DocumentKey> LevelDbIndexManager::GetDocumentsInRegion(
+    const model::FieldIndex& index, const index::GeoRegion& region) {
+  HARD_ASSERT(index.GetGeoSegment().has_value(),
+              "Index %s of collection group %s is not a geo index",
+              index.index_id(), index.collection_group());
+
+  // Geo entries are ordered by cell id, so each cell range of the covering is
+  // a single scan. The entries also store the exact coordinates, which drop
+  // the points in the covering that lie outside of the region itself.
+  std::vector<DocumentKey> result;
+  auto iter = db_->current_transaction()->NewIterator();
+  LevelDbIndexEntryKey entry_key;
+  for (const index::GeoCellRange& range :
+       index::CoverGeoBounds(region.bounds(), kMaxGeoCellRanges)) {
+    for (iter->Seek(LevelDbIndexEntryKey::KeyPrefix(
+             index.index_id(), uid_, "",
+             index::EncodeGeoCellLowerBound(range.min)));
+         iter->Valid(); iter->Next()) {
+      if (!entry_key.Decode(iter->key()) ||
+          entry_key.index_id() != index.index_id() ||
+          entry_key.user_id() != uid_) {
+        break;
+      }
+
+      auto value = index::DecodeGeoIndexValue(entry_key.directional_value());
+      if (!value.has_value() || value->first > range.max) {
+        break;
+      }
+      if (region.Contains(value->second)) {
+        result.push_back(DocumentKey::FromPathString(entry_key.document_key()));
+      }
+    }
+  }
+
+  return result;
+}
+
 std::vector<std::string> LevelDbIndexManager::EncodeBound(
     const FieldIndex& index,
     const Target& target,
@@ -647,6 +733,48 @@ std::vector<LevelDbIndexManager::IndexRange> LevelDbIndexManager::CreateRange(
   return ranges;
 }
 
+model::IndexOffset LevelDbIndexManager::GetMinOffset(
+    const core::Target& target) {
+  std::vector<FieldIndex> indexes;
+  for (const Target& sub_target : GetSubTargets(target)) {
+    absl::optional<FieldIndex> index = GetFieldIndex(sub_target);
+    if (index.has_value()) {
+      indexes.push_back(std::move(index).value());
+    }
+  }
+  return GetMinOffset(indexes);
+}
+
+model::IndexOffset LevelDbIndexManager::GetMinOffset(
+    const std::string& collection_group) {
+  std::vector<FieldIndex> indexes = GetFieldIndexes(collection_group);
+  if (indexes.empty()) {
+    return model::IndexOffset::None();
+  }
+  return GetMinOffset(indexes);
+}
+
+model::IndexOffset LevelDbIndexManager::GetMinOffset(
+    const std::vector<FieldIndex>& indexes) {
+  HARD_ASSERT(!indexes.empty(),
+              "Found empty index group when looking for least recent index "
+              "offset.");
+
+  auto it = indexes.begin();
+  model::IndexOffset min_offset = it->index_state().index_offset();
+  model::BatchId max_batch_id = min_offset.largest_batch_id();
+  for (++it; it != indexes.end(); ++it) {
+    const model::IndexOffset& offset = it->index_state().index_offset();
+    if (offset.CompareTo(min_offset) == util::ComparisonResult::Ascending) {
+      min_offset = offset;
+    }
+    max_batch_id = std::max(max_batch_id, offset.largest_batch_id());
+  }
+
+  return model::IndexOffset(min_offset.read_time(), min_offset.document_key(),
+                            max_batch_id);
+}
+
 absl::optional<std::string>
 LevelDbIndexManager::GetNextCollectionGroupToUpdate() {
   if (next_index_to_update_.empty()) {
@@ -679,31 +807,40 @@ void LevelDbIndexManager::UpdateIndexEntries(
     const model::DocumentMap& documents) {
   HARD_ASSERT(started_, "IndexManager not started");
 
+  std::vector<std::string> document_key_index_keys;
   for (const auto& kv : documents) {
     const auto group = kv.first.GetCollectionGroup();
     HARD_ASSERT(group.has_value(),
                 "Document key is expected to have a collection group");
-    std::vector<FieldIndex> indexes;
-    indexes = GetFieldIndexes(group.value());
+    std::vector<FieldIndex> indexes = GetFieldIndexes(group.value());
+    if (indexes.empty()) {
+      continue;
+    }
 
+    index::DocumentIndexValueWriter writer(kv.second);
     for (const auto& index : indexes) {
-      auto existing_entries = GetExistingIndexEntries(kv.first, index);
-      auto new_entries = ComputeIndexEntries(kv.second, index);
+      document_key_index_keys.clear();
+      auto existing_entries =
+          GetExistingIndexEntries(kv.first, index, &document_key_index_keys);
+      auto new_entries = ComputeIndexEntries(kv.second, index, writer);
       if (existing_entries != new_entries) {
-        UpdateEntries(kv.second, index, existing_entries, new_entries);
+        UpdateEntries(kv.second, index, existing_entries, new_entries,
+                      document_key_index_keys);
       }
     }
   }
 }
 
-std::set<IndexEntry> LevelDbIndexManager::GetExistingIndexEntries(
-    const DocumentKey& key, const FieldIndex& index) {
+std::vector<IndexEntry> LevelDbIndexManager::GetExistingIndexEntries(
+    const DocumentKey& key,
+    const FieldIndex& index,
+    std::vector<std::string>* document_key_index_keys) {
   auto document_key_index_prefix =
       LevelDbIndexEntryDocumentKeyIndexKey::KeyPrefix(
           index.index_id(), uid_, key.path().CanonicalString());
   LevelDbIndexEntryDocumentKeyIndexKey document_key_index_key;
   auto iter = db_->current_transaction()->NewIterator();
-  std::set<IndexEntry> index_entries;
+  std::vector<IndexEntry> index_entries;
   for (iter->Seek(document_key_index_prefix); iter->Valid(); iter->Next()) {
     if (!absl::StartsWith(iter->key(), document_key_index_prefix) ||
         !document_key_index_key.Decode(iter->key())) {
@@ -714,57 +851,58 @@ std::set<IndexEntry> LevelDbIndexManager::GetExistingIndexEntries(
     HARD_ASSERT(decoded,
                 "LevelDbIndexEntryKey cannot be decoded from document key "
                 "index table.");
-    index_entries.insert({entry_key.index_id(), key, entry_key.array_value(),
-                          entry_key.directional_value()});
+    index_entries.emplace_back(entry_key.index_id(), key,
+                               entry_key.array_value(),
+                               entry_key.directional_value());
+    document_key_index_keys->push_back(iter->key());
   }
 
+  std::sort(index_entries.begin(), index_entries.end());
+  index_entries.erase(std::unique(index_entries.begin(), index_entries.end()),
+                      index_entries.end());
   return index_entries;
 }
 
-std::set<IndexEntry> LevelDbIndexManager::ComputeIndexEntries(
-    const model::Document& document, const FieldIndex& index) {
-  std::set<IndexEntry> results;
+std::vector<IndexEntry> LevelDbIndexManager::ComputeIndexEntries(
+    const model::Document& document,
+    const FieldIndex& index,
+    index::DocumentIndexValueWriter& writer) {
+  std::vector<IndexEntry> results;
+
+  auto geo_segment = index.GetGeoSegment();
+  if (geo_segment.has_value()) {
+    auto value = document->field(geo_segment->field_path());
+    auto point = value.has_value() ? index::GeoPointValue(*value)
+                                   : absl::optional<GeoPoint>();
+    if (point.has_value()) {
+      results.emplace_back(index.index_id(), document->key(), "",
+                           index::EncodeGeoIndexValue(*point));
+    }
+    return results;
+  }
 
-  auto directional_value = EncodeDirectionalElements(index, document);
+  auto directional_value = writer.EncodeDirectionalValues(index);
   if (directional_value == absl::nullopt) {
     return results;
   }
 
   auto array_segment = index.GetArraySegment();
   if (array_segment.has_value()) {
-    auto field_value = document->field(array_segment->field_path());
-    if (field_value.has_value() &&
-        field_value.value().which_value_type ==
-            google_firestore_v1_Value_array_value_tag) {
-      for (pb_size_t i = 0; i < field_value.value().array_value.values_count;
-           ++i) {
-        results.insert(IndexEntry(
-            index.index_id(), document->key(),
-            EncodeSingleElement(field_value.value().array_value.values[i]),
-            directional_value.value()));
-      }
+    for (const std::string& element :
+         writer.EncodeArrayElements(array_segment->field_path())) {
+      results.emplace_back(index.index_id(), document->key(), element,
+                           directional_value.value());
     }
+    std::sort(results.begin(), results.end());
+    results.erase(std::unique(results.begin(), results.end()), results.end());
   } else {
-    results.insert(IndexEntry(index.index_id(), document->key(), "",
-                              directional_value.value()));
+    results.emplace_back(index.index_id(), document->key(), "",
+                         std::move(directional_value).value());
   }
 
   return results;
 }
 
-absl::optional<std::string> LevelDbIndexManager::EncodeDirectionalElements(
-    const FieldIndex& index, const model::Document& document) {
-  IndexEncodingBuffer index_buffer;
-  for (const auto& segment : index.GetDirectionalSegments()) {
-    auto field = document->field(segment.field_path());
-    if (!field.has_value()) {
-      return absl::nullopt;
-    }
-    index::WriteIndexValue(field.value(), index_buffer.ForKind(segment.kind()));
-  }
-  return index_buffer.GetEncodedBytes();
-}
-
 std::string LevelDbIndexManager::EncodeSingleElement(
     const _google_firestore_v1_Value& value) {
   IndexEncodingBuffer index_buffer;
@@ -776,51 +914,54 @@ std::string LevelDbIndexManager::EncodeSingleElement(
 void LevelDbIndexManager::UpdateEntries(
     const model::Document& document,
     const FieldIndex& index,
-    const std::set<IndexEntry>& existing_entries,
-    const std::set<IndexEntry>& new_entries) {
-  util::DiffSets<IndexEntry>(
-      existing_entries, new_entries, {},
-      [this, document, index](const IndexEntry& entry) {
-        this->AddIndexEntry(document, index, entry);
-      },
-      [this, document, index](const IndexEntry& entry) {
-        this->DeleteIndexEntry(document, index, entry);
-      });
-}
-
-void LevelDbIndexManager::AddIndexEntry(const model::Document& document,
-                                        const FieldIndex& index,
-                                        const IndexEntry& entry) {
+    const std::vector<IndexEntry>& existing_entries,
+    const std::vector<IndexEntry>& new_entries,
+    const std::vector<std::string>& existing_document_key_index_keys) {
+  auto* transaction = db_->current_transaction();
   std::string document_key = document->key().path().CanonicalString();
-  auto entry_key = LevelDbIndexEntryKey::Key(
-      entry.index_id(), uid_, entry.array_value(), entry.directional_value(),
-      EncodedDirectionalKey(index, document->key()), document_key);
-  db_->current_transaction()->Put(entry_key, "");
+  std::string directional_key = EncodedDirectionalKey(index, document->key());
+
+  // Both lists are sorted, so a single merge pass finds the entries that
+  // were removed and the ones that were added.
+  auto existing = existing_entries.begin();
+  auto added = new_entries.begin();
+  while (existing != existing_entries.end() || added != new_entries.end()) {
+    if (added == new_entries.end() ||
+        (existing != existing_entries.end() && *existing < *added)) {
+      transaction->Delete(
+          IndexEntryKey(*existing, directional_key, document_key));
+      ++existing;
+    } else if (existing == existing_entries.end() || *added < *existing) {
+      transaction->Put(IndexEntryKey(*added, directional_key, document_key),
+                       "");
+      ++added;
+    } else {
+      ++existing;
+      ++added;
+    }
+  }
 
-  auto document_key_index_prefix =
-      LevelDbIndexEntryDocumentKeyIndexKey::KeyPrefix(entry.index_id(), uid_,
-                                                      document_key);
-  std::unique_ptr<leveldb::Iterator> iter(
-      db_->ptr()->NewIterator(LevelDbTransaction::DefaultReadOptions()));
-  iter->Seek(util::PrefixSuccessor(document_key_index_prefix));
-  iter->Prev();
-  absl::string_view raw_key;
-  if (iter->Valid() && absl::StartsWith(local::MakeStringView(iter->key()),
-                                        document_key_index_prefix)) {
-    raw_key = local::MakeStringView(iter->key());
-  }
-
-  LevelDbIndexEntryDocumentKeyIndexKey document_key_index_key(
-      entry.index_id(), uid_, document_key, 0);
-  if (!raw_key.empty()) {
-    bool decoded = document_key_index_key.Decode(raw_key);
-    HARD_ASSERT(decoded,
-                "LevelDbIndexEntryDocumentKeyIndexKey cannot be decoded from "
-                "document key index table.");
-    document_key_index_key.IncreaseSeqNumber();
+  // The document key index rows of the document are rewritten as a whole,
+  // numbered in entry order, rather than looked up entry by entry.
+  for (const std::string& key : existing_document_key_index_keys) {
+    transaction->Delete(key);
   }
+  int64_t seq_number = 0;
+  for (const IndexEntry& entry : new_entries) {
+    LevelDbIndexEntryDocumentKeyIndexKey document_key_index_key(
+        entry.index_id(), uid_, document_key, seq_number++);
+    transaction->Put(document_key_index_key.Key(),
+                     IndexEntryKey(entry, directional_key, document_key));
+  }
+}
 
-  db_->current_transaction()->Put(document_key_index_key.Key(), entry_key);
+std::string LevelDbIndexManager::IndexEntryKey(
+    const IndexEntry& entry,
+    const std::string& directional_key,
+    const std::string& document_key) {
+  return LevelDbIndexEntryKey::Key(entry.index_id(), uid_, entry.array_value(),
+                                   entry.directional_value(), directional_key,
+                                   document_key);
 }
 
 std::string LevelDbIndexManager::EncodedDirectionalKey(
@@ -834,29 +975,6 @@ std::string LevelDbIndexManager::EncodedDirectionalKey(
   return buffer.GetEncodedBytes();
 }
 
-void LevelDbIndexManager::DeleteIndexEntry(const model::Document& document,
-                                           const FieldIndex& index,
-                                           const IndexEntry& entry) {
-  std::string document_key = document->key().path().CanonicalString();
-  auto entry_key = LevelDbIndexEntryKey::Key(
-      entry.index_id(), uid_, entry.array_value(), entry.directional_value(),
-      EncodedDirectionalKey(index, document->key()), document_key);
-  db_->current_transaction()->Delete(entry_key);
-
-  auto document_key_index_prefix =
-      LevelDbIndexEntryDocumentKeyIndexKey::KeyPrefix(entry.index_id(), uid_,
-                                                      document_key);
-  LevelDbIndexEntryDocumentKeyIndexKey document_key_index_key;
-  auto iter = db_->current_transaction()->NewIterator();
-  for (iter->Seek(document_key_index_prefix); iter->Valid(); iter->Next()) {
-    if (!absl::StartsWith(iter->key(), document_key_index_prefix) ||
-        !document_key_index_key.Decode(iter->key())) {
-      break;
-    }
-    db_->current_transaction()->Delete(iter->key());
-  }
-}
-
 // TODO(OrQuery): Implement sub targets properly.
 std::vector<Target> LevelDbIndexManager::GetSubTargets(const Target& target) {
   return {target};
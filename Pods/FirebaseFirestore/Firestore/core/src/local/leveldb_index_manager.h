@@ -18,7 +18,6 @@
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_INDEX_MANAGER_H_
 
 #include <queue>
-#include <set>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +36,7 @@ class User;
 }  // namespace credentials
 
 namespace index {
+class DocumentIndexValueWriter;
 class IndexEntry;
 }  // namespace index
 
@@ -72,9 +72,24 @@ class LevelDbIndexManager : public IndexManager {
   absl::optional<model::FieldIndex> GetFieldIndex(
       const core::Target& target) override;
 
+  void CreateTargetIndexes(const core::Target& target) override;
+
+  IndexType GetIndexType(const core::Target& target) override;
+
   absl::optional<std::vector<model::DocumentKey>> GetDocumentsMatchingTarget(
       const core::Target& target) override;
 
+  absl::optional<model::FieldIndex> GetGeoIndex(
+      const std::string& collection_group,
+      const model::FieldPath& field_path) override;
+
+  std::vector<model::DocumentKey> GetDocumentsInRegion(
+      const model::FieldIndex& index, const index::GeoRegion& region) override;
+
+  model::IndexOffset GetMinOffset(const core::Target& target) override;
+
+  model::IndexOffset GetMinOffset(const std::string& collection_group) override;
+
   absl::optional<std::string> GetNextCollectionGroupToUpdate() override;
 
   void UpdateCollectionGroup(const std::string& collection_group,
@@ -103,38 +118,42 @@ class LevelDbIndexManager : public IndexManager {
 
   void DeleteFromUpdateQueue(model::FieldIndex* index);
 
-  std::set<index::IndexEntry> GetExistingIndexEntries(
-      const model::DocumentKey& key, const model::FieldIndex& index);
+  /**
+   * Returns the index entries of the given document, sorted and without
+   * duplicates. The keys of the document key index rows that reference them
+   * are appended to `document_key_index_keys`.
+   */
+  std::vector<index::IndexEntry> GetExistingIndexEntries(
+      const model::DocumentKey& key,
+      const model::FieldIndex& index,
+      std::vector<std::string>* document_key_index_keys);
 
-  /** Creates the index entries for the given document. */
-  std::set<index::IndexEntry> ComputeIndexEntries(
-      const model::Document& document, const model::FieldIndex& index);
+  /**
+   * Creates the index entries for the given document, sorted and without
+   * duplicates. Field values are encoded through `writer`, which is shared by
+   * all the indexes of the document.
+   */
+  std::vector<index::IndexEntry> ComputeIndexEntries(
+      const model::Document& document,
+      const model::FieldIndex& index,
+      index::DocumentIndexValueWriter& writer);
 
   /**
    * Updates the index entries for the provided document by deleting entries
    * that are no longer referenced in `new_entries` and adding all newly added
-   * entries.
+   * entries. The document key index rows are rewritten to reference exactly
+   * `new_entries`.
    */
-  void UpdateEntries(const model::Document& document,
-                     const model::FieldIndex& index,
-                     const std::set<index::IndexEntry>& existing_entries,
-                     const std::set<index::IndexEntry>& new_entries);
-
-  void AddIndexEntry(const model::Document& document,
-                     const model::FieldIndex& index,
-                     const index::IndexEntry& entry);
-
-  void DeleteIndexEntry(const model::Document& document,
-                        const model::FieldIndex& index,
-                        const index::IndexEntry& entry);
+  void UpdateEntries(
+      const model::Document& document,
+      const model::FieldIndex& index,
+      const std::vector<index::IndexEntry>& existing_entries,
+      const std::vector<index::IndexEntry>& new_entries,
+      const std::vector<std::string>& existing_document_key_index_keys);
 
-  /**
-   * Returns the byte encoded form of the directional values in the field index.
-   * Returns `nullopt` if the document does not have all fields specified in the
-   * index.
-   */
-  absl::optional<std::string> EncodeDirectionalElements(
-      const model::FieldIndex& index, const model::Document& document);
+  std::string IndexEntryKey(const index::IndexEntry& entry,
+                            const std::string& directional_key,
+                            const std::string& document_key);
 
   /** Encodes a single value to the ascending index format. */
   std::string EncodeSingleElement(const _google_firestore_v1_Value& value);
@@ -148,6 +167,12 @@ class LevelDbIndexManager : public IndexManager {
 
   std::vector<core::Target> GetSubTargets(const core::Target& target);
 
+  /**
+   * Returns the offset that is shared by all `indexes`: the smallest read time
+   * and document key combined with the largest batch id.
+   */
+  model::IndexOffset GetMinOffset(const std::vector<model::FieldIndex>& indexes);
+
   /**
    * Encodes the given bounds according to the specification in `target`. For IN
    * queries, a list of possible values is returned.
@@ -20,6 +20,7 @@
 #include <vector>
 
 #include "Firestore/core/src/local/leveldb_util.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/ordered_code.h"
@@ -706,8 +707,15 @@ std::string Reader::Describe() {
 
 class Writer {
  public:
-  std::string result() const {
-    return dest_;
+  Writer() = default;
+
+  /** Creates a writer that appends to an already encoded key prefix. */
+  explicit Writer(std::string prefix) : dest_{std::move(prefix)} {
+  }
+
+  /** Moves the encoded key out of the writer, which is then left empty. */
+  std::string result() {
+    return std::move(dest_);
   }
 
   void WriteTerminator() {
@@ -1047,6 +1055,20 @@ std::string LevelDbTargetDocumentKey::Key(model::TargetId target_id,
   return writer.result();
 }
 
+std::vector<std::string> LevelDbTargetDocumentKey::Keys(
+    model::TargetId target_id, const model::DocumentKeySet& document_keys) {
+  std::string prefix = KeyPrefix(target_id);
+  std::vector<std::string> keys;
+  keys.reserve(document_keys.size());
+  for (const DocumentKey& document_key : document_keys) {
+    Writer writer{prefix};
+    writer.WriteResourcePath(document_key.path());
+    writer.WriteTerminator();
+    keys.push_back(writer.result());
+  }
+  return keys;
+}
+
 bool LevelDbTargetDocumentKey::Decode(absl::string_view key) {
   Reader reader{key};
   reader.ReadTableNameMatching(kTargetDocumentsTable);
@@ -1080,6 +1102,22 @@ std::string LevelDbDocumentTargetKey::Key(const DocumentKey& document_key,
   return writer.result();
 }
 
+std::vector<std::string> LevelDbDocumentTargetKey::Keys(
+    const model::DocumentKeySet& document_keys, model::TargetId target_id) {
+  // Only the table name is shared; the target follows the document.
+  std::string prefix = KeyPrefix();
+  std::vector<std::string> keys;
+  keys.reserve(document_keys.size());
+  for (const DocumentKey& document_key : document_keys) {
+    Writer writer{prefix};
+    writer.WriteResourcePath(document_key.path());
+    writer.WriteTargetId(target_id);
+    writer.WriteTerminator();
+    keys.push_back(writer.result());
+  }
+  return keys;
+}
+
 std::string LevelDbDocumentTargetKey::SentinelKey(
     const DocumentKey& document_key) {
   return Key(document_key, kInvalidTargetId);
@@ -1173,6 +1211,12 @@ bool LevelDbCollectionParentKey::Decode(absl::string_view key) {
   return reader.ok();
 }
 
+std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix() {
+  Writer writer;
+  writer.WriteTableName(kRemoteDocumentReadTimeTable);
+  return writer.result();
+}
+
 std::string LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
     const model::ResourcePath& collection_path,
     model::SnapshotVersion read_time) {
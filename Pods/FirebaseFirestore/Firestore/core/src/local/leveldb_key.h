@@ -19,8 +19,10 @@
 
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/model/mutation_batch.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/types.h"
@@ -441,6 +443,13 @@ class LevelDbTargetDocumentKey {
   static std::string Key(model::TargetId target_id,
                          const model::DocumentKey& document_key);
 
+  /**
+   * Creates the keys of the target-document entries for all the given
+   * documents, in order, encoding their shared prefix once.
+   */
+  static std::vector<std::string> Keys(
+      model::TargetId target_id, const model::DocumentKeySet& document_keys);
+
   /**
    * Decodes the contents of a target document key, storing the decoded values
    * in this instance.
@@ -490,6 +499,13 @@ class LevelDbDocumentTargetKey {
   static std::string Key(const model::DocumentKey& document_key,
                          model::TargetId target_id);
 
+  /**
+   * Creates the keys of the document-target entries for all the given
+   * documents, in order, encoding their shared prefix once.
+   */
+  static std::vector<std::string> Keys(
+      const model::DocumentKeySet& document_keys, model::TargetId target_id);
+
   /**
    * Creates a key that points to the sentinel row for the given document: a
    * document-target entry with a special, invalid target_id.
@@ -652,6 +668,11 @@ class LevelDbCollectionParentKey {
  */
 class LevelDbRemoteDocumentReadTimeKey {
  public:
+  /**
+   * Creates a key prefix that points just before the first key in the table.
+   */
+  static std::string KeyPrefix();
+
   /**
    * Creates a key prefix that points just before the first key for the given
    * collection_path and read_time.
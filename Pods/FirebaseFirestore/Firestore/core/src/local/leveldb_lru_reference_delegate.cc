@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/leveldb_lru_reference_delegate.h"
 
+#include <cstdint>
 #include <set>
 #include <string>
 #include <utility>
@@ -27,6 +28,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/types.h"
+#include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
@@ -34,15 +36,25 @@
 namespace firebase {
 namespace firestore {
 namespace local {
+namespace {
 
 using model::DocumentKey;
 using model::ListenSequenceNumber;
 using model::ResourcePath;
 using util::StatusOr;
 
+/**
+ * How many size checks may be answered from the running estimate before the
+ * database directory is measured again to correct for drift (compactions
+ * shrink the files, the estimate only ever grows).
+ */
+const int kSizeChecksPerMeasurement = 10;
+
+}  // namespace
+
 LevelDbLruReferenceDelegate::LevelDbLruReferenceDelegate(
     LevelDbPersistence* persistence, LruParams lru_params)
-    : db_(persistence) {
+    : db_(persistence), min_bytes_threshold_(lru_params.min_bytes_threshold) {
   gc_ = absl::make_unique<LruGarbageCollector>(this, lru_params);
 }
 
@@ -107,6 +119,16 @@ LruGarbageCollector* LevelDbLruReferenceDelegate::garbage_collector() {
 }
 
 StatusOr<int64_t> LevelDbLruReferenceDelegate::CalculateByteSize() {
+  // The estimate is good enough to tell that the cache is still under the
+  // threshold. Once it says otherwise, measure so that collection only runs
+  // when the cache really is too large.
+  absl::optional<int64_t> estimate = db_->EstimatedByteSize();
+  if (estimate && *estimate < min_bytes_threshold_ &&
+      ++size_checks_since_measurement_ < kSizeChecksPerMeasurement) {
+    return *estimate;
+  }
+
+  size_checks_since_measurement_ = 0;
   return db_->CalculateByteSize();
 }
 
@@ -129,6 +151,14 @@ void LevelDbLruReferenceDelegate::EnumerateOrphanedDocuments(
   db_->target_cache()->EnumerateOrphanedDocuments(callback);
 }
 
+void LevelDbLruReferenceDelegate::EnumerateOrphanedDocuments(
+    const OrphanedDocumentCallback& callback,
+    absl::optional<DocumentKey>* cursor,
+    size_t max_documents) {
+  db_->target_cache()->EnumerateOrphanedDocuments(callback, cursor,
+                                                  max_documents);
+}
+
 int LevelDbLruReferenceDelegate::RemoveOrphanedDocuments(
     ListenSequenceNumber upper_bound) {
   int count = 0;
@@ -137,14 +167,67 @@ int LevelDbLruReferenceDelegate::RemoveOrphanedDocuments(
         if (sequence_number <= upper_bound) {
           if (!IsPinned(key)) {
             count++;
-            db_->remote_document_cache()->Remove(key);
-            RemoveSentinel(key);
+            RemoveOrphanedDocument(key);
           }
         }
       });
+  PruneReadTimeEntries();
+  return count;
+}
+
+int LevelDbLruReferenceDelegate::RemoveOrphanedDocuments(
+    ListenSequenceNumber upper_bound,
+    absl::optional<DocumentKey>* cursor,
+    size_t max_documents) {
+  int count = 0;
+  db_->target_cache()->EnumerateOrphanedDocuments(
+      [&](const DocumentKey& key, ListenSequenceNumber sequence_number) {
+        if (sequence_number <= upper_bound) {
+          if (!IsPinned(key)) {
+            count++;
+            RemoveOrphanedDocument(key);
+          }
+        }
+      },
+      cursor, max_documents);
+
+  // Collections are pruned by `PruneRemovedDocuments` once per sweep rather
+  // than once per chunk, since consecutive chunks mostly touch the same
+  // collections.
   return count;
 }
 
+bool LevelDbLruReferenceDelegate::PruneRemovedDocuments(size_t max_entries) {
+  if (!pruning_) {
+    if (collections_to_prune_.empty()) {
+      return true;
+    }
+    auto next = collections_to_prune_.begin();
+    pruning_ = absl::make_unique<LevelDbRemoteDocumentCache::ReadTimePruning>(
+        std::move(next->second));
+    collections_to_prune_.erase(next);
+  }
+
+  db_->remote_document_cache()->PruneReadTimeEntries(pruning_.get(),
+                                                     max_entries);
+  if (!pruning_->done()) {
+    return false;
+  }
+
+  pruned_entries_ += pruning_->pruned();
+  ++pruned_collections_;
+  pruning_.reset();
+  if (!collections_to_prune_.empty()) {
+    return false;
+  }
+
+  LOG_DEBUG("Pruned %s read time entries from %s collections", pruned_entries_,
+            pruned_collections_);
+  pruned_entries_ = 0;
+  pruned_collections_ = 0;
+  return true;
+}
+
 int LevelDbLruReferenceDelegate::RemoveTargets(
     ListenSequenceNumber sequence_number, const LiveQueryMap& live_queries) {
   return static_cast<int>(
@@ -177,6 +260,22 @@ bool LevelDbLruReferenceDelegate::MutationQueuesContainKey(
   return false;
 }
 
+void LevelDbLruReferenceDelegate::RemoveOrphanedDocument(
+    const DocumentKey& key) {
+  db_->remote_document_cache()->Remove(key);
+  RemoveSentinel(key);
+
+  ResourcePath collection_path = key.path().PopLast();
+  std::string canonical_path = collection_path.CanonicalString();
+  collections_to_prune_.emplace(std::move(canonical_path),
+                                std::move(collection_path));
+}
+
+void LevelDbLruReferenceDelegate::PruneReadTimeEntries() {
+  while (!PruneRemovedDocuments(SIZE_MAX)) {
+  }
+}
+
 void LevelDbLruReferenceDelegate::RemoveSentinel(const DocumentKey& key) {
   db_->current_transaction()->Delete(
       LevelDbDocumentTargetKey::SentinelKey(key));
@@ -18,8 +18,12 @@
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_LRU_REFERENCE_DELEGATE_H_
 
 #include <memory>
+#include <string>
+#include <unordered_map>
 
+#include "Firestore/core/src/local/leveldb_remote_document_cache.h"
 #include "Firestore/core/src/local/lru_garbage_collector.h"
+#include "Firestore/core/src/model/resource_path.h"
 
 namespace firebase {
 namespace firestore {
@@ -64,8 +68,17 @@ class LevelDbLruReferenceDelegate : public LruDelegate {
       const SequenceNumberCallback& callback) override;
   void EnumerateOrphanedDocuments(
       const OrphanedDocumentCallback& callback) override;
+  void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback,
+                                  absl::optional<model::DocumentKey>* cursor,
+                                  size_t max_documents) override;
 
   int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound) override;
+  int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound,
+                              absl::optional<model::DocumentKey>* cursor,
+                              size_t max_documents) override;
+
+  /** Prunes the read time entries of the collections documents left. */
+  bool PruneRemovedDocuments(size_t max_entries) override;
   int RemoveTargets(model::ListenSequenceNumber sequence_number,
                     const LiveQueryMap& live_queries) override;
 
@@ -74,6 +87,18 @@ class LevelDbLruReferenceDelegate : public LruDelegate {
 
   bool MutationQueuesContainKey(const model::DocumentKey& key);
 
+  /**
+   * Removes an orphaned document and its sentinel, remembering its collection
+   * for `PruneReadTimeEntries`.
+   */
+  void RemoveOrphanedDocument(const model::DocumentKey& key);
+
+  /**
+   * Prunes all read time entries left behind in the collections that
+   * documents were removed from.
+   */
+  void PruneReadTimeEntries();
+
   void RemoveSentinel(const model::DocumentKey& key);
   void WriteSentinel(const model::DocumentKey& key);
 
@@ -93,6 +118,21 @@ class LevelDbLruReferenceDelegate : public LruDelegate {
   // transaction is active, resets back to kListenSequenceNumberInvalid.
   model::ListenSequenceNumber current_sequence_number_ =
       kListenSequenceNumberInvalid;
+
+  // Size checks below this threshold are answered from the persistence
+  // layer's running estimate; see `CalculateByteSize`.
+  int64_t min_bytes_threshold_ = 0;
+  int size_checks_since_measurement_ = 0;
+
+  // Collections that garbage collection removed documents from since their
+  // read time entries were last pruned, keyed by canonical path.
+  std::unordered_map<std::string, model::ResourcePath> collections_to_prune_;
+
+  // The collection being pruned by `PruneRemovedDocuments`, if any, and the
+  // totals of the pruning so far.
+  std::unique_ptr<LevelDbRemoteDocumentCache::ReadTimePruning> pruning_;
+  size_t pruned_entries_ = 0;
+  size_t pruned_collections_ = 0;
 };
 
 }  // namespace local
@@ -222,6 +222,23 @@ std::vector<MutationBatch> LevelDbMutationQueue::AllMutationBatches() {
   return result;
 }
 
+DocumentKeySet LevelDbMutationQueue::AllMutatedDocumentKeys() {
+  // The document mutation index has a row per mutated document and batch, so
+  // the keys can be read from it without parsing any batches.
+  std::string index_prefix = LevelDbDocumentMutationKey::KeyPrefix(user_id_);
+
+  auto it = db_->current_transaction()->NewIterator();
+  DocumentKeySet result;
+  LevelDbDocumentMutationKey row_key;
+  for (it->Seek(index_prefix);
+       it->Valid() && absl::StartsWith(it->key(), index_prefix); it->Next()) {
+    HARD_ASSERT(row_key.Decode(it->key()),
+                "Failed to decode document mutation key");
+    result = result.insert(row_key.document_key());
+  }
+  return result;
+}
+
 std::vector<MutationBatch>
 LevelDbMutationQueue::AllMutationBatchesAffectingDocumentKeys(
     const DocumentKeySet& document_keys) {
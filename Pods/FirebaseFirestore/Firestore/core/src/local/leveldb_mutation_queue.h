@@ -73,6 +73,8 @@ class LevelDbMutationQueue : public MutationQueue {
 
   std::vector<model::MutationBatch> AllMutationBatches() override;
 
+  model::DocumentKeySet AllMutatedDocumentKeys() override;
+
   std::vector<model::MutationBatch> AllMutationBatchesAffectingDocumentKeys(
       const model::DocumentKeySet& document_keys) override;
 
@@ -80,6 +80,24 @@ util::StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbOpener::Create(
                                     lru_params);
 }
 
+StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbOpener::OpenReadOnly() {
+  auto maybe_dir = LevelDbDataDir();
+  if (!maybe_dir.ok()) return maybe_dir.status();
+  Path db_data_dir = maybe_dir.ValueOrDie();
+
+  Status dir_status = fs_->IsDirectory(db_data_dir);
+  if (!dir_status.ok()) return dir_status;
+
+  LOG_DEBUG("Using %s for read-only LevelDB storage",
+            db_data_dir.ToUtf8String());
+
+  Serializer remote_serializer(database_info_.database_id());
+  LocalSerializer local_serializer(std::move(remote_serializer));
+
+  return LevelDbPersistence::OpenReadOnly(db_data_dir,
+                                          std::move(local_serializer));
+}
+
 StatusOr<Path> LevelDbOpener::LevelDbDataDir() {
   StatusOr<Path> maybe_dir = FirestoreAppDataDir();
   if (!maybe_dir.ok()) return maybe_dir;
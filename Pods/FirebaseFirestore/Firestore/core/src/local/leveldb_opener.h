@@ -78,6 +78,13 @@ class LevelDbOpener {
   util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       const LruParams& lru_params);
 
+  /**
+   * Opens the existing LevelDbPersistence instance for reading only; see
+   * `LevelDbPersistence::OpenReadOnly`. Unlike `Create`, this never migrates
+   * or creates any directories.
+   */
+  util::StatusOr<std::unique_ptr<LevelDbPersistence>> OpenReadOnly();
+
   /**
    * Finds a suitable directory to serve as the root of all Firestore local
    * storage for all Firestore instances.
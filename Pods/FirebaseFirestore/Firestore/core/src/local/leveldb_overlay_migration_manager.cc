@@ -25,6 +25,7 @@
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "absl/strings/match.h"
 
 namespace firebase {
@@ -67,6 +68,7 @@ void LevelDbOverlayMigrationManager::Run() {
     if (!HasPendingOverlayMigration()) {
       return;
     }
+    util::StartupSpan span(util::StartupPhase::kOverlayMigration);
 
     std::unordered_set<std::string> user_ids = GetAllUserIds(db_);
     auto* remote_document_cache = db_->remote_document_cache();
@@ -79,10 +81,8 @@ void LevelDbOverlayMigrationManager::Run() {
       auto* mutation_queue = db_->GetMutationQueue(user, index_manager);
 
       // Get all document keys that have local mutations
-      model::DocumentKeySet all_document_keys;
-      for (const auto& batch : mutation_queue->AllMutationBatches()) {
-        all_document_keys = all_document_keys.union_with(batch.keys());
-      }
+      model::DocumentKeySet all_document_keys =
+          mutation_queue->AllMutatedDocumentKeys();
 
       // Recalculate and save overlays
       auto* document_overlay_cache = db_->GetDocumentOverlayCache(user);
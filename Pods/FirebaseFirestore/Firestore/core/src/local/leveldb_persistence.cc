@@ -30,12 +30,16 @@
 #include "Firestore/core/src/local/lru_garbage_collector.h"
 #include "Firestore/core/src/local/reference_delegate.h"
 #include "Firestore/core/src/local/sizer.h"
+#include "Firestore/core/src/util/async_queue.h"
 #include "Firestore/core/src/util/filesystem.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/string_util.h"
 #include "absl/memory/memory.h"
 #include "absl/strings/match.h"
+#include "leveldb/cache.h"
+#include "leveldb/env.h"
 
 namespace firebase {
 namespace firestore {
@@ -45,12 +49,46 @@ namespace {
 using credentials::User;
 using leveldb::DB;
 using model::ListenSequenceNumber;
+using util::AsyncQueue;
 using util::Filesystem;
 using util::Path;
 using util::Status;
 using util::StatusOr;
 using util::StringFormat;
 
+/**
+ * The number of changes after which a transaction held back by group commit
+ * is written without waiting for the end of the window.
+ */
+const size_t kMaxDeferredChanges = 10000;
+
+/**
+ * The transaction `RunOnSnapshot` runs on the current thread, which stands in
+ * for the worker queue's transaction of the persistence it belongs to.
+ */
+struct SnapshotTransaction {
+  const LevelDbPersistence* persistence = nullptr;
+  LevelDbTransaction* transaction = nullptr;
+};
+
+thread_local SnapshotTransaction snapshot_transaction;
+
+/**
+ * The capacity of the block cache shared by all open databases, which
+ * matches the cache LevelDB would otherwise create for each of them.
+ */
+const size_t kSharedBlockCacheSize = 8 * 1024 * 1024;
+
+/**
+ * Returns the block cache shared by every database of the process. LevelDB
+ * namespaces cached blocks by table, so databases can share one cache, and
+ * memory no longer grows with the number of Firestore instances.
+ */
+leveldb::Cache* SharedBlockCache() {
+  static leveldb::Cache* cache = leveldb::NewLRUCache(kSharedBlockCacheSize);
+  return cache;
+}
+
 /**
  * Finds all user ids in the database based on the existence of a mutation
  * queue.
@@ -92,7 +130,10 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
   if (!created.ok()) return created.status();
 
   std::unique_ptr<DB> db = std::move(created).ValueOrDie();
-  LevelDbMigrations::RunMigrations(db.get(), version, serializer);
+  {
+    util::StartupSpan span(util::StartupPhase::kLevelDbMigrations);
+    LevelDbMigrations::RunMigrations(db.get(), version, serializer);
+  }
 
   LevelDbTransaction transaction(db.get(), "Start LevelDB");
   std::set<std::string> users = CollectUserSet(&transaction);
@@ -111,6 +152,33 @@ StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::Create(
                 lru_params);
 }
 
+StatusOr<std::unique_ptr<LevelDbPersistence>> LevelDbPersistence::OpenReadOnly(
+    util::Path dir, LocalSerializer serializer) {
+  StatusOr<std::unique_ptr<DB>> opened = OpenDb(dir, /* read_only= */ true);
+  if (!opened.ok()) return opened.status();
+
+  std::unique_ptr<DB> db = std::move(opened).ValueOrDie();
+  LevelDbMigrations::SchemaVersion version =
+      LevelDbMigrations::ReadSchemaVersion(db.get());
+  if (version < kSchemaVersion) {
+    return Status{Error::kErrorFailedPrecondition,
+                  StringFormat("LevelDB database at %s has schema version %s "
+                               "and must be migrated to %s before it can be "
+                               "opened read-only",
+                               dir.ToUtf8String(), version, kSchemaVersion)};
+  }
+
+  // Reading the user set writes nothing, so this transaction is not committed.
+  LevelDbTransaction transaction(db.get(), "Start read-only LevelDB");
+  std::set<std::string> users = CollectUserSet(&transaction);
+
+  std::unique_ptr<LevelDbPersistence> result(new LevelDbPersistence(
+      std::move(db), std::move(dir), std::move(users), std::move(serializer),
+      LruParams::Disabled()));
+  result->read_only_ = true;
+  return {std::move(result)};
+}
+
 LevelDbPersistence::LevelDbPersistence(std::unique_ptr<leveldb::DB> db,
                                        util::Path directory,
                                        std::set<std::string> users,
@@ -150,13 +218,23 @@ Status LevelDbPersistence::EnsureDirectory(const Path& dir) {
   return Status::OK();
 }
 
-StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(const Path& dir) {
+StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(const Path& dir,
+                                                         bool read_only) {
   leveldb::Options options;
-  options.create_if_missing = true;
+  options.create_if_missing = !read_only;
+  // All databases run their compactions on the background thread of the
+  // default environment and cache blocks in the same cache.
+  options.env = leveldb::Env::Default();
+  options.block_cache = SharedBlockCache();
+  // Appending to the existing log avoids writing out a new table, and the
+  // manifest update that goes with it, while opening.
+  options.reuse_logs = read_only;
 
   DB* database = nullptr;
+  util::StartupSpan recover_span(util::StartupPhase::kLevelDbRecover);
   leveldb::Status status = DB::Open(options, dir.ToUtf8String(), &database);
   if (!status.ok()) {
+    recover_span.Discard();
     return Status{Error::kErrorInternal,
                   StringFormat("Failed to open LevelDB database at %s",
                                dir.ToUtf8String())}
@@ -169,6 +247,10 @@ StatusOr<std::unique_ptr<DB>> LevelDbPersistence::OpenDb(const Path& dir) {
 // MARK: - LevelDB utilities
 
 LevelDbTransaction* LevelDbPersistence::current_transaction() {
+  if (snapshot_transaction.persistence == this) {
+    return snapshot_transaction.transaction;
+  }
+
   HARD_ASSERT(transaction_ != nullptr,
               "Attempting to access transaction before one has started");
   return transaction_.get();
@@ -217,9 +299,19 @@ StatusOr<int64_t> LevelDbPersistence::CalculateByteSize() {
     return Status::FromCause("Failed to iterate over LevelDB files",
                              iter->status());
   }
+
+  measured_byte_size_ = static_cast<int64_t>(count);
+  bytes_committed_since_measurement_ = 0;
   return static_cast<int64_t>(count);
 }
 
+absl::optional<int64_t> LevelDbPersistence::EstimatedByteSize() const {
+  if (!measured_byte_size_) {
+    return absl::nullopt;
+  }
+  return *measured_byte_size_ + bytes_committed_since_measurement_;
+}
+
 // MARK: - Persistence
 
 model::ListenSequenceNumber LevelDbPersistence::current_sequence_number()
@@ -229,6 +321,8 @@ model::ListenSequenceNumber LevelDbPersistence::current_sequence_number()
 
 void LevelDbPersistence::Shutdown() {
   HARD_ASSERT(started_, "LevelDbPersistence shutdown without start!");
+  CommitDeferredTransaction();
+  deferred_commit_.Cancel();
   started_ = false;
   db_.reset();
 }
@@ -312,14 +406,115 @@ void LevelDbPersistence::RunInternal(absl::string_view label,
   HARD_ASSERT(transaction_ == nullptr,
               "Starting a transaction while one is already in progress");
 
-  transaction_ = absl::make_unique<LevelDbTransaction>(db_.get(), label);
+  if (deferred_transaction_) {
+    transaction_ = std::move(deferred_transaction_);
+  } else {
+    transaction_ = absl::make_unique<LevelDbTransaction>(db_.get(), label);
+  }
   reference_delegate_->OnTransactionStarted(label);
 
   block();
 
   reference_delegate_->OnTransactionCommitted();
-  transaction_->Commit();
-  transaction_.reset();
+  if (read_only_) {
+    if (transaction_->changed_keys() > 0) {
+      LOG_DEBUG("Discarding %s changes of read-only transaction %s",
+                transaction_->changed_keys(), label);
+    }
+    transaction_.reset();
+    return;
+  }
+
+  if (CanDeferCommit()) {
+    deferred_transaction_ = std::move(transaction_);
+    if (!deferred_commit_) {
+      deferred_commit_ = group_commit_queue_->EnqueueAfterDelay(
+          group_commit_window_, util::TimerId::GroupCommit,
+          [this] { CommitDeferredTransaction(); });
+    }
+    return;
+  }
+
+  Commit(std::move(transaction_));
+  deferred_commit_.Cancel();
+}
+
+std::shared_ptr<const leveldb::Snapshot> LevelDbPersistence::GetSnapshot() {
+  HARD_ASSERT(transaction_ == nullptr,
+              "Taking a snapshot while a transaction is in progress");
+  CommitDeferredTransaction();
+  deferred_commit_.Cancel();
+
+  leveldb::DB* db = db_.get();
+  return std::shared_ptr<const leveldb::Snapshot>(
+      db->GetSnapshot(),
+      [db](const leveldb::Snapshot* snapshot) {
+        db->ReleaseSnapshot(snapshot);
+      });
+}
+
+void LevelDbPersistence::RunOnSnapshot(absl::string_view label,
+                                       const leveldb::Snapshot* snapshot,
+                                       const std::function<void()>& block) {
+  HARD_ASSERT(snapshot_transaction.persistence == nullptr,
+              "Starting a snapshot read while one is already in progress");
+
+  leveldb::ReadOptions read_options = LevelDbTransaction::DefaultReadOptions();
+  read_options.snapshot = NOT_NULL(snapshot);
+  LevelDbTransaction transaction(db_.get(), label, read_options);
+
+  snapshot_transaction.persistence = this;
+  snapshot_transaction.transaction = &transaction;
+  block();
+  snapshot_transaction = SnapshotTransaction{};
+
+  HARD_ASSERT(transaction.changed_keys() == 0,
+              "Snapshot read %s attempted to write", label);
+}
+
+void LevelDbPersistence::EnableGroupCommit(std::shared_ptr<AsyncQueue> queue,
+                                           std::chrono::milliseconds window) {
+  CommitDeferredTransaction();
+  deferred_commit_.Cancel();
+
+  group_commit_queue_ = std::move(queue);
+  group_commit_window_ = window;
+  deferrable_key_prefixes_ = {
+      LevelDbRemoteDocumentKey::KeyPrefix(),
+      LevelDbRemoteDocumentReadTimeKey::KeyPrefix(),
+      LevelDbCollectionParentKey::KeyPrefix(),
+      LevelDbTargetGlobalKey::Key(),
+      LevelDbTargetKey::KeyPrefix(),
+      LevelDbQueryTargetKey::KeyPrefix(),
+      LevelDbTargetDocumentKey::KeyPrefix(),
+      LevelDbDocumentTargetKey::KeyPrefix(),
+  };
+}
+
+bool LevelDbPersistence::CanDeferCommit() const {
+  if (!group_commit_queue_ || group_commit_window_.count() <= 0) {
+    return false;
+  }
+
+  // The count includes the changes of any transaction merged into this one.
+  size_t changes = transaction_->changed_keys();
+  if (changes == 0 || changes >= kMaxDeferredChanges) {
+    return false;
+  }
+  return transaction_->ChangesOnlyKeysWithPrefixes(deferrable_key_prefixes_);
+}
+
+void LevelDbPersistence::Commit(
+    std::unique_ptr<LevelDbTransaction> transaction) {
+  bytes_committed_since_measurement_ +=
+      static_cast<int64_t>(transaction->changed_bytes());
+  transaction->Commit();
+}
+
+void LevelDbPersistence::CommitDeferredTransaction() {
+  if (deferred_transaction_) {
+    Commit(std::move(deferred_transaction_));
+  }
 }
 
 leveldb::ReadOptions StandardReadOptions() {
@@ -17,10 +17,12 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_PERSISTENCE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_PERSISTENCE_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <memory>
 #include <set>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/leveldb_bundle_cache.h"
@@ -35,12 +37,18 @@
 #include "Firestore/core/src/local/leveldb_transaction.h"
 #include "Firestore/core/src/local/local_serializer.h"
 #include "Firestore/core/src/local/persistence.h"
+#include "Firestore/core/src/util/executor.h"
 #include "Firestore/core/src/util/path.h"
 #include "Firestore/core/src/util/statusor.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
 
+namespace util {
+class AsyncQueue;
+}  // namespace util
+
 namespace core {
 class DatabaseInfo;
 }  // namespace core
@@ -60,22 +68,91 @@ class LevelDbPersistence : public Persistence {
   static util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       util::Path dir, LocalSerializer serializer, const LruParams& lru_params);
 
+  /**
+   * Opens the existing database in `dir` for reading only, as a cheap way for
+   * app extensions to read a cache that the main app maintains.
+   *
+   * Nothing is created or migrated, and LevelDB is asked to reuse its log
+   * rather than compacting it into a new table on open. Opening fails if the
+   * database is missing or uses an older schema. Changes made by transactions
+   * are discarded rather than committed.
+   */
+  static util::StatusOr<std::unique_ptr<LevelDbPersistence>> OpenReadOnly(
+      util::Path dir, LocalSerializer serializer);
+
   ~LevelDbPersistence();
 
+  /** Whether this instance was opened by `OpenReadOnly`. */
+  bool read_only() const {
+    return read_only_;
+  }
+
+  /**
+   * Returns the transaction of the calling thread: the one `RunOnSnapshot` is
+   * running, if any, and otherwise the one of the worker queue.
+   */
   LevelDbTransaction* current_transaction();
 
   leveldb::DB* ptr() {
     return db_.get();
   }
 
+  LocalSerializer* serializer() {
+    return &serializer_;
+  }
+
   const std::set<std::string> users() const {
     return users_;
   }
 
   static util::Status ClearPersistence(const core::DatabaseInfo& database_info);
 
+  /**
+   * Measures the size of the database directory on disk. The result becomes
+   * the baseline of `EstimatedByteSize`.
+   */
   util::StatusOr<int64_t> CalculateByteSize();
 
+  /**
+   * Lets transactions that only change cached server state (remote documents
+   * and targets) be merged with the transactions that follow them and written
+   * as one LevelDB batch up to `window` later, scheduled on `queue`.
+   *
+   * A transaction that changes anything else, such as the mutation queue,
+   * commits at once together with everything held back before it, so local
+   * writes stay exactly as durable as before. A zero window turns group
+   * commit off.
+   */
+  void EnableGroupCommit(std::shared_ptr<util::AsyncQueue> queue,
+                         std::chrono::milliseconds window);
+
+  /**
+   * Returns a snapshot of everything committed so far, committing the
+   * transaction held back by group commit first. Must be called on the worker
+   * queue outside of a transaction, and the snapshot must be released before
+   * `Shutdown`.
+   */
+  std::shared_ptr<const leveldb::Snapshot> GetSnapshot();
+
+  /**
+   * Runs `block` with a read-only transaction over `snapshot` as the current
+   * transaction of the calling thread.
+   *
+   * Unlike `Run`, this may be called on any thread, while the worker queue
+   * runs transactions of its own. `block` may only read, and only through
+   * components that are not shared with the worker queue.
+   */
+  void RunOnSnapshot(absl::string_view label,
+                     const leveldb::Snapshot* snapshot,
+                     const std::function<void()>& block);
+
+  /**
+   * Returns the size last measured by `CalculateByteSize` plus the bytes
+   * committed since, without touching the filesystem. Returns `absl::nullopt`
+   * if the database has not been measured yet.
+   */
+  absl::optional<int64_t> EstimatedByteSize() const;
+
   // MARK: Persistence overrides
 
   model::ListenSequenceNumber current_sequence_number() const override;
@@ -114,14 +191,26 @@ class LevelDbPersistence : public Persistence {
                      LocalSerializer serializer,
                      const LruParams& lru_params);
 
+  /** Whether the current transaction may be held back for group commit. */
+  bool CanDeferCommit() const;
+
+  /** Writes the given transaction and accounts for its bytes. */
+  void Commit(std::unique_ptr<LevelDbTransaction> transaction);
+
+  /** Commits the transaction held back by group commit, if any. */
+  void CommitDeferredTransaction();
+
   /**
    * Ensures that the given directory exists.
    */
   static util::Status EnsureDirectory(const util::Path& dir);
 
-  /** Opens the database within the given directory. */
+  /**
+   * Opens the database within the given directory, creating it unless
+   * `read_only` is set.
+   */
   static util::StatusOr<std::unique_ptr<leveldb::DB>> OpenDb(
-      const util::Path& dir);
+      const util::Path& dir, bool read_only = false);
 
   static util::StatusOr<std::unique_ptr<LevelDbPersistence>> Create(
       util::Path dir,
@@ -135,6 +224,7 @@ class LevelDbPersistence : public Persistence {
   std::set<std::string> users_;
   LocalSerializer serializer_;
   bool started_ = false;
+  bool read_only_ = false;
 
   std::unique_ptr<LevelDbBundleCache> bundle_cache_;
   std::unordered_map<std::string, std::unique_ptr<LevelDbDocumentOverlayCache>>
@@ -151,6 +241,19 @@ class LevelDbPersistence : public Persistence {
   std::unique_ptr<LevelDbLruReferenceDelegate> reference_delegate_;
 
   std::unique_ptr<LevelDbTransaction> transaction_;
+
+  // Group commit: the transaction held back for merging, the prefixes of the
+  // tables it may touch and the scheduled commit of the window.
+  std::shared_ptr<util::AsyncQueue> group_commit_queue_;
+  std::chrono::milliseconds group_commit_window_{0};
+  std::vector<std::string> deferrable_key_prefixes_;
+  std::unique_ptr<LevelDbTransaction> deferred_transaction_;
+  util::DelayedOperation deferred_commit_;
+
+  // The last measured size of the database directory, and the bytes written
+  // by the transactions committed since.
+  absl::optional<int64_t> measured_byte_size_;
+  int64_t bytes_committed_since_measurement_ = 0;
 };
 
 /** Returns a standard set of read options. */
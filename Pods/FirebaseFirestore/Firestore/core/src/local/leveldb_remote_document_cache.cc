@@ -16,23 +16,34 @@
 
 #include "Firestore/core/src/local/leveldb_remote_document_cache.h"
 
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <memory>
 #include <string>
 #include <thread>  // NOLINT(build/c++11)
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "Firestore/Protos/nanopb/firestore/local/maybe_document.nanopb.h"
 #include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/index_manager.h"
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
 #include "Firestore/core/src/local/local_serializer.h"
+#include "Firestore/core/src/local/query_context.h"
+#include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/util/background_queue.h"
 #include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/status.h"
 #include "Firestore/core/src/util/string_util.h"
+#include "absl/memory/memory.h"
 #include "leveldb/db.h"
 
 namespace firebase {
@@ -42,8 +53,11 @@ namespace {
 
 using core::Query;
 using leveldb::Status;
+using model::Document;
 using model::DocumentKey;
 using model::DocumentKeySet;
+using model::DocumentMap;
+using model::IndexOffset;
 using model::MutableDocument;
 using model::MutableDocumentMap;
 using model::ResourcePath;
@@ -54,49 +68,43 @@ using util::BackgroundQueue;
 using util::Executor;
 
 /**
- * An accumulator for results produced asynchronously. This accumulates
- * values in a vector to avoid contention caused by accumulating into more
- * complex structures like immutable::SortedMap.
+ * The number of documents decoded by each background task. Small batches of
+ * documents are decoded on the calling thread.
  */
-template <typename T>
-class AsyncResults {
- public:
-  void Insert(T&& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    values_.push_back(std::move(value));
-  }
-
-  void Insert(const T& value) {
-    std::lock_guard<std::mutex> lock(mutex_);
-    values_.push_back(value);
-  }
+const size_t kDocumentsPerDecodeTask = 64;
 
-  /**
-   * Returns the accumulated result, moving it out of AsyncResults. The
-   * AsyncResults object should not be reused.
-   */
-  std::vector<T> Result() {
-    std::lock_guard<std::mutex> lock(mutex_);
-    return std::move(values_);
-  }
+/**
+ * The maximum number of bytes of encoded documents that a collection scan
+ * holds in memory while waiting for them to be decoded.
+ */
+const size_t kMaxPendingScanBytes = 8 * 1024 * 1024;
 
- private:
-  std::vector<T> values_;
-  std::mutex mutex_;
-};
+/**
+ * Returns the executor that decodes documents for the remote document caches
+ * of all Firestore instances. Each decode waits for its own tasks only, so
+ * the instances can share one pool whose size doesn't grow with their count.
+ */
+Executor* QueryExecutor() {
+  static Executor* executor = [] {
+    auto hw_concurrency = std::thread::hardware_concurrency();
+    if (hw_concurrency == 0) {
+      // If the standard library doesn't know, guess something reasonable.
+      hw_concurrency = 4;
+    }
+    // Queries block the worker queue while their documents decode here.
+    return Executor::CreateConcurrent("com.google.firebase.firestore.query",
+                                      static_cast<int>(hw_concurrency),
+                                      Executor::Priority::kUserInitiated)
+        .release();
+  }();
+  return executor;
+}
 
 }  // namespace
 
 LevelDbRemoteDocumentCache::LevelDbRemoteDocumentCache(
     LevelDbPersistence* db, LocalSerializer* serializer)
     : db_(db), serializer_(NOT_NULL(serializer)) {
-  auto hw_concurrency = std::thread::hardware_concurrency();
-  if (hw_concurrency == 0) {
-    // If the standard library doesn't know, guess something reasonable.
-    hw_concurrency = 4;
-  }
-  executor_ = Executor::CreateConcurrent("com.google.firebase.firestore.query",
-                                         static_cast<int>(hw_concurrency));
 }
 
 // Out of line because of unique_ptrs to incomplete types.
@@ -108,12 +116,13 @@ void LevelDbRemoteDocumentCache::Add(const MutableDocument& document,
   const ResourcePath& path = key.path();
 
   std::string ldb_document_key = LevelDbRemoteDocumentKey::Key(key);
-  db_->current_transaction()->Put(ldb_document_key,
-                                  serializer_->EncodeMaybeDocument(document));
+  db_->current_transaction()->Put(
+      ldb_document_key, serializer_->EncodeMaybeDocumentBytes(document));
 
   std::string ldb_read_time_key = LevelDbRemoteDocumentReadTimeKey::Key(
       path.PopLast(), read_time, path.last_segment());
   db_->current_transaction()->Put(ldb_read_time_key, "");
+  hot_documents_.Invalidate(key);
 
   NOT_NULL(index_manager_);
   index_manager_->AddToCollectionParentIndex(document.key().path().PopLast());
@@ -122,16 +131,98 @@ void LevelDbRemoteDocumentCache::Add(const MutableDocument& document,
 void LevelDbRemoteDocumentCache::Remove(const DocumentKey& key) {
   std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
   db_->current_transaction()->Delete(ldb_key);
+  hot_documents_.Invalidate(key);
+
+  // Drop the document's field index entries, so that counts served from the
+  // index don't include documents that were garbage collected.
+  NOT_NULL(index_manager_);
+  Document removed(MutableDocument::InvalidDocument(key));
+  index_manager_->UpdateIndexEntries(DocumentMap{}.insert(key, removed));
+}
+
+size_t LevelDbRemoteDocumentCache::PruneReadTimeEntries(
+    const ResourcePath& collection_path) {
+  ReadTimePruning pruning(collection_path);
+  PruneReadTimeEntries(&pruning, SIZE_MAX);
+  return pruning.pruned();
+}
+
+void LevelDbRemoteDocumentCache::PruneReadTimeEntries(ReadTimePruning* pruning,
+                                                      size_t max_entries) {
+  auto* transaction = db_->current_transaction();
+  const ResourcePath& collection_path = pruning->collection_path_;
+  size_t examined = 0;
+
+  if (!pruning->scanned_) {
+    // Entries are ordered by read time, so a later entry for a document
+    // supersedes the ones before it. Entries written since the previous step
+    // have later read times and sort after `last_key_`.
+    auto it = transaction->NewIterator();
+    if (pruning->last_key_.empty()) {
+      it->Seek(LevelDbRemoteDocumentReadTimeKey::KeyPrefix(
+          collection_path, SnapshotVersion::None()));
+    } else {
+      it->Seek(pruning->last_key_);
+      if (it->Valid() && it->key() == pruning->last_key_) {
+        it->Next();
+      }
+    }
+
+    LevelDbRemoteDocumentReadTimeKey current_key;
+    for (; examined < max_entries; it->Next(), ++examined) {
+      if (!it->Valid() || !current_key.Decode(it->key()) ||
+          current_key.collection_path() != collection_path) {
+        pruning->scanned_ = true;
+        break;
+      }
+
+      std::string& newest =
+          pruning->newest_entries_[current_key.document_id()];
+      if (!newest.empty()) {
+        transaction->Delete(newest);
+        ++pruning->pruned_;
+      }
+      newest = it->key();
+      pruning->last_key_ = newest;
+    }
+  }
+  if (!pruning->scanned_) {
+    return;
+  }
+
+  // Only the existence of each document matters, so probe with an iterator
+  // rather than reading the contents.
+  auto document_it = transaction->NewIterator();
+  auto& newest_entries = pruning->newest_entries_;
+  while (!newest_entries.empty() && examined < max_entries) {
+    auto entry = newest_entries.begin();
+    std::string ldb_key = LevelDbRemoteDocumentKey::Key(
+        DocumentKey(collection_path.Append(entry->first)));
+    document_it->Seek(ldb_key);
+    if (!document_it->Valid() || document_it->key() != ldb_key) {
+      transaction->Delete(entry->second);
+      ++pruning->pruned_;
+    }
+    newest_entries.erase(entry);
+    ++examined;
+  }
 }
 
 MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) {
+  absl::optional<MutableDocument> cached = hot_documents_.Get(key);
+  if (cached) {
+    return *std::move(cached);
+  }
+
   std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
   std::string value;
   Status status = db_->current_transaction()->Get(ldb_key, &value);
   if (status.IsNotFound()) {
     return MutableDocument::InvalidDocument(key);
   } else if (status.ok()) {
-    return DecodeMaybeDocument(value, key);
+    MutableDocument document = DecodeMaybeDocument(value, key);
+    hot_documents_.Put(document, value.size());
+    return document;
   } else {
     HARD_FAIL("Fetch document for key (%s) failed with status: %s",
               key.ToString(), status.ToString());
@@ -140,33 +231,86 @@ MutableDocument LevelDbRemoteDocumentCache::Get(const DocumentKey& key) {
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
     const DocumentKeySet& keys) {
-  BackgroundQueue tasks(executor_.get());
-  AsyncResults<std::pair<DocumentKey, MutableDocument>> results;
-
-  LevelDbRemoteDocumentKey current_key;
+  // One slot per requested key, in key order. Keys without a row are filled
+  // in right away, the others once their contents have been decoded.
+  std::vector<std::pair<DocumentKey, MutableDocument>> documents;
+  documents.reserve(keys.size());
+  std::vector<EncodedDocument> encoded;
+  encoded.reserve(keys.size());
+
+  // The keys are visited in ascending order, which is also the order of their
+  // rows. After reading a row, the iterator is advanced to the next row, which
+  // is often the next requested document. The iterator is only repositioned
+  // if that is not the case, which replaces most seeks by a single step.
   auto it = db_->current_transaction()->NewIterator();
-
+  std::string previous_ldb_key;
   for (const DocumentKey& key : keys) {
-    it->Seek(LevelDbRemoteDocumentKey::Key(key));
-    if (!it->Valid() || !current_key.Decode(it->key()) ||
-        current_key.document_key() != key) {
-      results.Insert(
-          std::make_pair(key, MutableDocument::InvalidDocument(key)));
+    absl::optional<MutableDocument> cached = hot_documents_.Get(key);
+    if (cached) {
+      // The iterator stays where it is; it still points past the last row
+      // that was read.
+      documents.emplace_back(key, *std::move(cached));
+      continue;
+    }
+
+    std::string ldb_key = LevelDbRemoteDocumentKey::Key(key);
+    bool in_order = !previous_ldb_key.empty() && previous_ldb_key < ldb_key;
+    if (!in_order || (it->Valid() && it->key() < ldb_key)) {
+      it->Seek(ldb_key);
+    }
+
+    // If the iterator points past `ldb_key` (or the end was reached), the
+    // document does not exist.
+    if (it->Valid() && it->key() == ldb_key) {
+      encoded.push_back({documents.size(), &key, it->value()});
+      documents.emplace_back(key, MutableDocument{});
+      it->Next();
     } else {
-      const std::string& contents = it->value();
-      tasks.Execute([this, &results, &key, contents] {
-        results.Insert(std::make_pair(key, DecodeMaybeDocument(contents, key)));
-      });
+      documents.emplace_back(key, MutableDocument::InvalidDocument(key));
     }
+
+    previous_ldb_key = std::move(ldb_key);
   }
 
-  tasks.AwaitAll();
+  DecodeAll(encoded, documents);
+  if (hot_documents_.enabled()) {
+    for (const EncodedDocument& entry : encoded) {
+      hot_documents_.Put(documents[entry.slot].second, entry.contents.size());
+    }
+  }
 
-  MutableDocumentMap map;
-  for (const auto& entry : results.Result()) {
-    map = map.insert(entry.first, entry.second);
+  // The slots are sorted by key, which allows the map to be built without
+  // searching for the insertion point of every entry.
+  return MutableDocumentMap::FromSortedEntries(std::move(documents));
+}
+
+void LevelDbRemoteDocumentCache::DecodeAll(
+    const std::vector<EncodedDocument>& encoded,
+    std::vector<std::pair<DocumentKey, MutableDocument>>& documents) {
+  // Decoding a document is cheap compared to the overhead of scheduling a
+  // task, so each task decodes a contiguous chunk of documents. Every task
+  // writes to distinct slots and no locking is required.
+  if (encoded.size() <= kDocumentsPerDecodeTask) {
+    for (const EncodedDocument& entry : encoded) {
+      documents[entry.slot].second =
+          DecodeMaybeDocument(entry.contents, *entry.key);
+    }
+    return;
+  }
+
+  BackgroundQueue tasks(QueryExecutor());
+  for (size_t begin = 0; begin < encoded.size();
+       begin += kDocumentsPerDecodeTask) {
+    size_t end = std::min(begin + kDocumentsPerDecodeTask, encoded.size());
+    tasks.Execute([this, &encoded, &documents, begin, end] {
+      for (size_t i = begin; i != end; ++i) {
+        const EncodedDocument& entry = encoded[i];
+        documents[entry.slot].second =
+            DecodeMaybeDocument(entry.contents, *entry.key);
+      }
+    });
   }
-  return map;
+  tasks.AwaitAll();
 }
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
@@ -186,9 +330,47 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAllExisting(
 
 MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
     const model::ResourcePath& path, const model::IndexOffset& offset) {
-  // Use the query path as a prefix for testing if a document matches the query.
-  size_t immediate_children_path_length = path.size() + 1;
+  return GetAllMatching(path, offset, DocumentFilter{}, nullptr);
+}
+
+MutableDocumentMap LevelDbRemoteDocumentCache::GetDocumentsMatchingQuery(
+    const Query& query,
+    const IndexOffset& offset,
+    const model::OverlayByDocumentKeyMap& mutated_docs,
+    QueryContext& context) {
+  // The filter runs on the decoder threads. Computing the sort order up front
+  // makes sure that its lazy initialization doesn't race.
+  (void)query.order_bys();
+
+  DocumentFilter filter = [&](const std::vector<MutableDocument>& documents) {
+    std::vector<size_t> matches = query.MatchingIndexes(documents);
+    if (mutated_docs.empty()) {
+      return matches;
+    }
+
+    // Documents with overlays are included whether or not they match, since
+    // their local version may.
+    std::vector<size_t> result;
+    result.reserve(documents.size());
+    auto next_match = matches.begin();
+    for (size_t i = 0; i < documents.size(); ++i) {
+      bool matched = next_match != matches.end() && *next_match == i;
+      if (matched) ++next_match;
+      if (matched || mutated_docs.find(documents[i].key()) !=
+                         mutated_docs.end()) {
+        result.push_back(i);
+      }
+    }
+    return result;
+  };
+  return GetAllMatching(query.path(), offset, filter, &context);
+}
 
+MutableDocumentMap LevelDbRemoteDocumentCache::GetAllMatching(
+    const ResourcePath& path,
+    const IndexOffset& offset,
+    const DocumentFilter& filter,
+    QueryContext* context) {
   if (offset.read_time() != SnapshotVersion::None()) {
     // Execute an index-free query and filter by read time. This is safe since
     // all document changes to queries that have a
@@ -220,54 +402,217 @@ MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
       }
     }
 
-    return LevelDbRemoteDocumentCache::GetAllExisting(remote_keys);
+    if (context) {
+      context->IncrementDocumentReadCount(remote_keys.size());
+    }
+
+    MutableDocumentMap documents =
+        LevelDbRemoteDocumentCache::GetAllExisting(remote_keys);
+    if (!filter) {
+      return documents;
+    }
+
+    std::vector<MutableDocument> candidates;
+    candidates.reserve(documents.size());
+    for (const auto& entry : documents) {
+      candidates.push_back(entry.second);
+    }
+
+    std::vector<std::pair<DocumentKey, MutableDocument>> matches;
+    for (size_t index : filter(candidates)) {
+      const MutableDocument& document = candidates[index];
+      matches.emplace_back(document.key(), document);
+    }
+    return MutableDocumentMap::FromSortedEntries(std::move(matches));
+  }
+
+  return ScanCollection(path, filter, context);
+}
+
+MutableDocumentMap LevelDbRemoteDocumentCache::ScanCollection(
+    const ResourcePath& path,
+    const DocumentFilter& filter,
+    QueryContext* context) {
+  // The scan runs as a pipeline: this thread iterates LevelDB and groups the
+  // encoded rows into chunks, the executor decodes and filters the chunks in
+  // parallel, and the results of all chunks are finally concatenated. Since
+  // chunks are formed in key order, the concatenation is sorted as well.
+  //
+  // To bound memory, the encoded rows of at most `kMaxPendingScanBytes` are
+  // held at a time: once this many bytes were handed to the decoders, the
+  // scan waits for them to catch up. Chunks drop their encoded rows as soon
+  // as they are decoded, so only the (filtered) results accumulate.
+  std::vector<std::unique_ptr<ScanChunk>> chunks;
+  BackgroundQueue tasks(QueryExecutor());
+  size_t pending_bytes = 0;
+  size_t documents_read = 0;
+
+  auto dispatch = [&](std::unique_ptr<ScanChunk> chunk) {
+    ScanChunk* raw_chunk = chunk.get();
+    chunks.push_back(std::move(chunk));
+    tasks.Execute(
+        [this, raw_chunk, &filter] { DecodeChunk(*raw_chunk, filter); });
+    if (pending_bytes >= kMaxPendingScanBytes) {
+      tasks.AwaitAll();
+      pending_bytes = 0;
+    }
+  };
+
+  // Documents are ordered by key, so we can use a prefix scan to narrow down
+  // the documents we need to match the query against.
+  size_t immediate_children_path_length = path.size() + 1;
+  std::string start_key = LevelDbRemoteDocumentKey::KeyPrefix(path);
+  auto it = db_->current_transaction()->NewIterator();
+  it->Seek(start_key);
+
+  auto chunk = absl::make_unique<ScanChunk>();
+  LevelDbRemoteDocumentKey current_key;
+  for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
+    // The query is actually returning any path that starts with the query
+    // path prefix which may include documents in subcollections. For example,
+    // a query on 'rooms' will return rooms/abc/messages/xyx but we shouldn't
+    // match it. Fix this by discarding rows with document keys more than one
+    // segment longer than the query path.
+    const DocumentKey& document_key = current_key.document_key();
+    if (document_key.path().size() != immediate_children_path_length) {
+      continue;
+    }
+
+    if (!path.IsPrefixOf(document_key.path())) {
+      break;
+    }
+
+    ++documents_read;
+    pending_bytes += it->value().size();
+    chunk->rows.emplace_back(document_key, it->value());
+    if (chunk->rows.size() == kDocumentsPerDecodeTask) {
+      dispatch(std::move(chunk));
+      chunk = absl::make_unique<ScanChunk>();
+    }
+  }
+
+  if (!chunk->rows.empty()) {
+    if (chunks.empty()) {
+      // Small scans are not worth the overhead of a background task.
+      DecodeChunk(*chunk, filter);
+      chunks.push_back(std::move(chunk));
+    } else {
+      dispatch(std::move(chunk));
+    }
+  }
+  tasks.AwaitAll();
+
+  if (context) {
+    context->IncrementDocumentReadCount(documents_read);
+  }
+
+  size_t result_count = 0;
+  for (const auto& decoded : chunks) {
+    result_count += decoded->results.size();
+  }
+
+  std::vector<std::pair<DocumentKey, MutableDocument>> results;
+  results.reserve(result_count);
+  for (const auto& decoded : chunks) {
+    std::move(decoded->results.begin(), decoded->results.end(),
+              std::back_inserter(results));
+  }
+  return MutableDocumentMap::FromSortedEntries(std::move(results));
+}
+
+void LevelDbRemoteDocumentCache::DecodeChunk(ScanChunk& chunk,
+                                             const DocumentFilter& filter) {
+  std::vector<MutableDocument> documents;
+  documents.reserve(chunk.rows.size());
+  for (const auto& row : chunk.rows) {
+    MutableDocument document = DecodeMaybeDocument(row.second, row.first);
+    if (document.is_found_document()) {
+      documents.push_back(std::move(document));
+    }
+  }
+
+  if (!filter) {
+    for (MutableDocument& document : documents) {
+      chunk.results.emplace_back(document.key(), std::move(document));
+    }
   } else {
-    BackgroundQueue tasks(executor_.get());
-    AsyncResults<MutableDocument> results;
+    for (size_t index : filter(documents)) {
+      chunk.results.emplace_back(documents[index].key(),
+                                 std::move(documents[index]));
+    }
+  }
+
+  // Release the encoded rows right away to bound the memory of the scan.
+  std::vector<std::pair<DocumentKey, std::string>>().swap(chunk.rows);
+}
 
-    // Documents are ordered by key, so we can use a prefix scan to narrow down
-    // the documents we need to match the query against.
-    std::string start_key = LevelDbRemoteDocumentKey::KeyPrefix(path);
+MutableDocumentMap LevelDbRemoteDocumentCache::GetAll(
+    const std::string& collection_group,
+    const IndexOffset& offset,
+    size_t limit) {
+  // Each collection of the group has its own run of read time entries, sorted
+  // by read time and document ID. We collect the first `limit` entries of each
+  // run and then keep the `limit` smallest ones overall.
+  std::vector<IndexOffset> entries;
+  LevelDbRemoteDocumentReadTimeKey current_key;
+  for (const ResourcePath& parent :
+       index_manager_->GetCollectionParents(collection_group)) {
+    ResourcePath path = parent.Append(collection_group);
     auto it = db_->current_transaction()->NewIterator();
-    it->Seek(start_key);
+    it->Seek(LevelDbRemoteDocumentReadTimeKey::KeyPrefix(path,
+                                                         offset.read_time()));
 
-    LevelDbRemoteDocumentKey current_key;
-    for (; it->Valid() && current_key.Decode(it->key()); it->Next()) {
-      // The query is actually returning any path that starts with the query
-      // path prefix which may include documents in subcollections. For example,
-      // a query on 'rooms' will return rooms/abc/messages/xyx but we shouldn't
-      // match it. Fix this by discarding rows with document keys more than one
-      // segment longer than the query path.
-      const DocumentKey& document_key = current_key.document_key();
-      if (document_key.path().size() != immediate_children_path_length) {
-        continue;
+    size_t collected = 0;
+    for (; it->Valid() && collected < limit && current_key.Decode(it->key());
+         it->Next()) {
+      if (current_key.collection_path() != path) {
+        break;
       }
 
-      if (!path.IsPrefixOf(document_key.path())) {
-        break;
+      IndexOffset entry(current_key.read_time(),
+                        DocumentKey(path.Append(current_key.document_id())),
+                        IndexOffset::InitialLargestBatchId());
+      if (entry.CompareTo(offset) != util::ComparisonResult::Descending) {
+        // The entry sorts at or before the offset.
+        continue;
       }
 
-      const std::string& contents = it->value();
-      tasks.Execute([this, &results, document_key, contents] {
-        MutableDocument document = DecodeMaybeDocument(contents, document_key);
-        if (document.is_found_document()) {
-          results.Insert(document);
-        }
-      });
+      entries.push_back(std::move(entry));
+      ++collected;
     }
+  }
 
-    tasks.AwaitAll();
+  std::sort(entries.begin(), entries.end(),
+            [](const IndexOffset& lhs, const IndexOffset& rhs) {
+              return lhs.CompareTo(rhs) == util::ComparisonResult::Ascending;
+            });
+  if (entries.size() > limit) {
+    entries.erase(entries.begin() + limit, entries.end());
+  }
 
-    MutableDocumentMap map;
-    for (const MutableDocument& doc : results.Result()) {
-      map = map.insert(doc.key(), doc);
-    }
-    return map;
+  // A document that was updated has more than one read time entry. Since the
+  // entries are sorted, the last one wins.
+  DocumentKeySet keys;
+  std::unordered_map<DocumentKey, SnapshotVersion, model::DocumentKeyHash>
+      read_times;
+  for (const IndexOffset& entry : entries) {
+    keys = keys.insert(entry.document_key());
+    read_times[entry.document_key()] = entry.read_time();
   }
+
+  MutableDocumentMap results;
+  for (const auto& kv : GetAllExisting(keys)) {
+    MutableDocument document = kv.second;
+    document.WithReadTime(read_times[kv.first]);
+    results = results.insert(kv.first, std::move(document));
+  }
+  return results;
 }
 
 MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
     absl::string_view encoded, const DocumentKey& key) {
+  util::ScopedLatency latency{metrics_,
+                              util::MetricHistogram::kDocumentDecodeMicros};
   StringReader reader{encoded};
 
   auto message = Message<firestore_client_MaybeDocument>::TryParse(&reader);
@@ -285,6 +630,10 @@ MutableDocument LevelDbRemoteDocumentCache::DecodeMaybeDocument(
   return maybe_document;
 }
 
+void LevelDbRemoteDocumentCache::SetHotDocumentCacheSize(size_t max_bytes) {
+  hot_documents_.set_max_bytes(max_bytes);
+}
+
 void LevelDbRemoteDocumentCache::SetIndexManager(IndexManager* manager) {
   index_manager_ = NOT_NULL(manager);
 }
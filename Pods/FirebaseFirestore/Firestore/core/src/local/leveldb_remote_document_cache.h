@@ -17,13 +17,21 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_REMOTE_DOCUMENT_CACHE_H_
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <thread>  // NOLINT(build/c++11)
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "Firestore/core/src/local/hot_document_cache.h"
 #include "Firestore/core/src/local/leveldb_index_manager.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/model_fwd.h"
+#include "Firestore/core/src/model/mutable_document.h"
+#include "Firestore/core/src/model/resource_path.h"
 #include "Firestore/core/src/model/types.h"
 #include "absl/strings/string_view.h"
 
@@ -31,7 +39,7 @@ namespace firebase {
 namespace firestore {
 
 namespace util {
-class Executor;
+class Metrics;
 }  // namespace util
 
 namespace local {
@@ -42,6 +50,47 @@ class LocalSerializer;
 /** Cached Remote Documents backed by leveldb. */
 class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
  public:
+  /**
+   * The progress of pruning the read time entries of one collection across
+   * several transactions.
+   */
+  class ReadTimePruning {
+   public:
+    explicit ReadTimePruning(model::ResourcePath collection_path)
+        : collection_path_(std::move(collection_path)) {
+    }
+
+    const model::ResourcePath& collection_path() const {
+      return collection_path_;
+    }
+
+    bool done() const {
+      return scanned_ && newest_entries_.empty();
+    }
+
+    /** The number of entries deleted so far. */
+    size_t pruned() const {
+      return pruned_;
+    }
+
+   private:
+    friend class LevelDbRemoteDocumentCache;
+
+    model::ResourcePath collection_path_;
+
+    /** The last entry scanned, or empty before the scan started. */
+    std::string last_key_;
+    bool scanned_ = false;
+
+    /**
+     * The newest entry seen of each document, keyed by document ID. Once the
+     * scan is done, these are checked against the documents and dropped.
+     */
+    std::unordered_map<std::string, std::string> newest_entries_;
+
+    size_t pruned_ = 0;
+  };
+
   LevelDbRemoteDocumentCache(LevelDbPersistence* db,
                              LocalSerializer* serializer);
   ~LevelDbRemoteDocumentCache();
@@ -54,10 +103,102 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
   model::MutableDocumentMap GetAll(const model::DocumentKeySet& keys) override;
   model::MutableDocumentMap GetAll(const model::ResourcePath& path,
                                    const model::IndexOffset& offset) override;
+  model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext& context) override;
+  model::MutableDocumentMap GetAll(const std::string& collection_group,
+                                   const model::IndexOffset& offset,
+                                   size_t limit) override;
 
   void SetIndexManager(IndexManager* manager) override;
 
+  /**
+   * Sets the budget of the in-memory cache of recently read, decoded
+   * documents. Zero disables the cache.
+   */
+  void SetHotDocumentCacheSize(size_t max_bytes);
+
+  /**
+   * Records the time spent decoding each document into the given metrics,
+   * which must outlive this cache. Null disables this.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+  }
+
+  /**
+   * Deletes the read time entries of the collection at `collection_path` that
+   * no longer describe a cached document: entries superseded by a later read
+   * of the same document, and entries of documents that have been removed.
+   * Returns the number of entries deleted.
+   *
+   * `Add` and `Remove` leave these entries behind because they cannot locate
+   * a document's previous entry without scanning its collection.
+   */
+  size_t PruneReadTimeEntries(const model::ResourcePath& collection_path);
+
+  /**
+   * Resumes `pruning`, examining at most `max_entries` read time entries or
+   * documents, so that large collections can be pruned in bounded steps.
+   */
+  void PruneReadTimeEntries(ReadTimePruning* pruning, size_t max_entries);
+
+  /** Exposes the hit and miss counters of the hot document cache. */
+  const HotDocumentCache& hot_document_cache() const {
+    return hot_documents_;
+  }
+
  private:
+  /**
+   * Returns the indexes of the given found documents to include in a result,
+   * in increasing order; an empty filter accepts all documents. Documents are
+   * filtered in batches so that query constraints are evaluated over many
+   * documents at a time.
+   */
+  using DocumentFilter = std::function<std::vector<size_t>(
+      const std::vector<model::MutableDocument>&)>;
+
+  /** A batch of rows of a collection scan that is decoded as one task. */
+  struct ScanChunk {
+    std::vector<std::pair<model::DocumentKey, std::string>> rows;
+    std::vector<std::pair<model::DocumentKey, model::MutableDocument>> results;
+  };
+
+  /**
+   * Returns the existing documents of the collection at `path` that changed
+   * after `offset` and satisfy `filter`.
+   */
+  model::MutableDocumentMap GetAllMatching(const model::ResourcePath& path,
+                                           const model::IndexOffset& offset,
+                                           const DocumentFilter& filter,
+                                           QueryContext* context);
+
+  /** Scans all rows of the collection at `path`, see `GetAllMatching`. */
+  model::MutableDocumentMap ScanCollection(const model::ResourcePath& path,
+                                           const DocumentFilter& filter,
+                                           QueryContext* context);
+
+  /** Decodes the rows of `chunk` into its results, applying `filter`. */
+  void DecodeChunk(ScanChunk& chunk, const DocumentFilter& filter);
+
+  /** The encoded contents of a document row, and its slot in the result. */
+  struct EncodedDocument {
+    size_t slot;
+    const model::DocumentKey* key;
+    std::string contents;
+  };
+
+  /**
+   * Decodes every entry of `encoded` into its slot of `documents`, using the
+   * executor for larger batches.
+   */
+  void DecodeAll(
+      const std::vector<EncodedDocument>& encoded,
+      std::vector<std::pair<model::DocumentKey, model::MutableDocument>>&
+          documents);
+
   /**
    * Looks up a set of entries in the cache, returning only existing entries of
    * Type::Document.
@@ -74,7 +215,12 @@ class LevelDbRemoteDocumentCache : public RemoteDocumentCache {
   // Owned by LevelDbPersistence.
   LocalSerializer* serializer_ = nullptr;
 
-  std::unique_ptr<util::Executor> executor_;
+  // Not owned; read concurrently by the decoder tasks.
+  util::Metrics* metrics_ = nullptr;
+
+  // Decoded copies of recently read documents. Only accessed from the
+  // calling thread, never from the decoder tasks.
+  HotDocumentCache hot_documents_;
 };
 
 }  // namespace local
@@ -0,0 +1,143 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/leveldb_snapshot_reader.h"
+
+#include <utility>
+
+#include "Firestore/core/src/local/leveldb_document_overlay_cache.h"
+#include "Firestore/core/src/local/leveldb_persistence.h"
+#include "Firestore/core/src/local/leveldb_remote_document_cache.h"
+#include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/util/executor.h"
+#include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/status.h"
+#include "absl/memory/memory.h"
+#include "leveldb/db.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using credentials::User;
+using util::Executor;
+using util::Status;
+
+namespace {
+
+Status TerminatedStatus() {
+  return Status(Error::kErrorFailedPrecondition,
+                "The client has already been terminated.");
+}
+
+}  // namespace
+
+LevelDbSnapshotReader::LevelDbSnapshotReader(LevelDbPersistence* persistence,
+                                             size_t max_concurrent_reads)
+    : persistence_(NOT_NULL(persistence)),
+      max_concurrent_reads_(max_concurrent_reads) {
+  HARD_ASSERT(max_concurrent_reads_ > 0,
+              "A snapshot reader needs at least one thread");
+  executor_ = Executor::CreateConcurrent(
+      "com.google.firebase.firestore.snapshot_reads",
+      static_cast<int>(max_concurrent_reads_));
+}
+
+LevelDbSnapshotReader::~LevelDbSnapshotReader() {
+  Dispose();
+}
+
+void LevelDbSnapshotReader::Schedule(const User& user, Read read) {
+  std::shared_ptr<const leveldb::Snapshot> snapshot =
+      persistence_->GetSnapshot();
+
+  {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (disposed_) {
+      lock.unlock();
+      read(TerminatedStatus());
+      return;
+    }
+
+    pending_reads_.push_back(
+        PendingRead{user, std::move(snapshot), std::move(read)});
+    if (running_readers_ >= max_concurrent_reads_) {
+      // A running reader picks the read up once it is done with its own.
+      return;
+    }
+    ++running_readers_;
+  }
+
+  executor_->Execute([this] { RunReads(); });
+}
+
+void LevelDbSnapshotReader::Dispose() {
+  std::deque<PendingRead> dropped_reads;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    disposed_ = true;
+    dropped_reads.swap(pending_reads_);
+  }
+
+  // Callers wait for the results of reads, so reads that won't run still
+  // complete.
+  for (PendingRead& pending : dropped_reads) {
+    pending.read(TerminatedStatus());
+  }
+
+  // Waits for running reads, which hold snapshots of their own.
+  executor_->Dispose();
+}
+
+void LevelDbSnapshotReader::RunReads() {
+  std::unique_ptr<LevelDbRemoteDocumentCache> cache;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!idle_caches_.empty()) {
+      cache = std::move(idle_caches_.back());
+      idle_caches_.pop_back();
+    }
+  }
+  if (!cache) {
+    cache = absl::make_unique<LevelDbRemoteDocumentCache>(
+        persistence_, persistence_->serializer());
+  }
+
+  for (;;) {
+    PendingRead pending;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (pending_reads_.empty() || disposed_) {
+        --running_readers_;
+        idle_caches_.push_back(std::move(cache));
+        return;
+      }
+      pending = std::move(pending_reads_.front());
+      pending_reads_.pop_front();
+    }
+
+    LevelDbDocumentOverlayCache overlays(pending.user, persistence_,
+                                         persistence_->serializer());
+    LocalDocumentsView documents(cache.get(), /*mutation_queue=*/nullptr,
+                                 &overlays, /*index_manager=*/nullptr);
+    persistence_->RunOnSnapshot("Snapshot read", pending.snapshot.get(),
+                                [&] { pending.read(&documents); });
+  }
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
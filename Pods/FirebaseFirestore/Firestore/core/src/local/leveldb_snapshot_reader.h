@@ -0,0 +1,113 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_LEVELDB_SNAPSHOT_READER_H_
+#define FIRESTORE_CORE_SRC_LOCAL_LEVELDB_SNAPSHOT_READER_H_
+
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>  // NOLINT(build/c++11)
+#include <vector>
+
+#include "Firestore/core/src/credentials/user.h"
+#include "Firestore/core/src/util/statusor.h"
+
+namespace leveldb {
+class Snapshot;
+}  // namespace leveldb
+
+namespace firebase {
+namespace firestore {
+
+namespace util {
+class Executor;
+}  // namespace util
+
+namespace local {
+
+class LevelDbPersistence;
+class LevelDbRemoteDocumentCache;
+class LocalDocumentsView;
+
+/**
+ * Runs reads of the local documents against LevelDB snapshots, on threads of
+ * its own, so that reads from the cache neither wait for the worker queue nor
+ * hold it up.
+ *
+ * A read sees the documents and overlays that were committed when it was
+ * scheduled. Reads use components of their own rather than the worker queue's:
+ * a remote document cache per thread, without a hot document cache, and no
+ * mutation queue or index manager. Collection group queries, which need the
+ * index manager, are therefore not supported, and queries scan their whole
+ * collection rather than using the index plans and result cache of the
+ * worker queue's `QueryEngine`.
+ */
+class LevelDbSnapshotReader {
+ public:
+  /**
+   * A read of the local documents. Reads that never run, because the reader
+   * was disposed first, get a `kErrorFailedPrecondition` status instead.
+   */
+  using Read = std::function<void(util::StatusOr<LocalDocumentsView*>)>;
+
+  LevelDbSnapshotReader(LevelDbPersistence* persistence,
+                        size_t max_concurrent_reads);
+
+  ~LevelDbSnapshotReader();
+
+  /**
+   * Schedules `read` against a snapshot of what is committed now, with the
+   * local view of the documents of `user`. Must be called on the worker queue
+   * outside of a transaction.
+   */
+  void Schedule(const credentials::User& user, Read read);
+
+  /**
+   * Fails the reads that have not started and waits for the running ones.
+   * Must be called before the persistence shuts down.
+   */
+  void Dispose();
+
+ private:
+  struct PendingRead {
+    credentials::User user;
+    std::shared_ptr<const leveldb::Snapshot> snapshot;
+    Read read;
+  };
+
+  /** Runs pending reads on the calling thread until there are none left. */
+  void RunReads();
+
+  LevelDbPersistence* persistence_ = nullptr;
+  size_t max_concurrent_reads_ = 0;
+  std::unique_ptr<util::Executor> executor_;
+
+  std::mutex mutex_;
+  std::deque<PendingRead> pending_reads_;
+  size_t running_readers_ = 0;
+  bool disposed_ = false;
+
+  /** Remote document caches not in use by a running reader. */
+  std::vector<std::unique_ptr<LevelDbRemoteDocumentCache>> idle_caches_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_LEVELDB_SNAPSHOT_READER_H_
@@ -16,9 +16,11 @@
 
 #include "Firestore/core/src/local/leveldb_target_cache.h"
 
+#include <limits>
 #include <string>
 #include <unordered_set>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/local/leveldb_persistence.h"
@@ -249,22 +251,30 @@ void LevelDbTargetCache::AddMatchingKeys(const DocumentKeySet& keys,
   // buffer (and the parser will see all default values).
   std::string empty_buffer;
 
+  LevelDbTransaction* transaction = db_->current_transaction();
+  for (std::string& key : LevelDbTargetDocumentKey::Keys(target_id, keys)) {
+    transaction->Put(std::move(key), empty_buffer);
+  }
+  for (std::string& key : LevelDbDocumentTargetKey::Keys(keys, target_id)) {
+    transaction->Put(std::move(key), empty_buffer);
+  }
   for (const DocumentKey& key : keys) {
-    db_->current_transaction()->Put(
-        LevelDbTargetDocumentKey::Key(target_id, key), empty_buffer);
-    db_->current_transaction()->Put(
-        LevelDbDocumentTargetKey::Key(key, target_id), empty_buffer);
     db_->reference_delegate()->AddReference(key);
   }
 }
 
 void LevelDbTargetCache::RemoveMatchingKeys(const DocumentKeySet& keys,
                                             TargetId target_id) {
+  LevelDbTransaction* transaction = db_->current_transaction();
+  for (const std::string& key :
+       LevelDbTargetDocumentKey::Keys(target_id, keys)) {
+    transaction->Delete(key);
+  }
+  for (const std::string& key :
+       LevelDbDocumentTargetKey::Keys(keys, target_id)) {
+    transaction->Delete(key);
+  }
   for (const DocumentKey& key : keys) {
-    db_->current_transaction()->Delete(
-        LevelDbTargetDocumentKey::Key(target_id, key));
-    db_->current_transaction()->Delete(
-        LevelDbDocumentTargetKey::Key(key, target_id));
     db_->reference_delegate()->RemoveReference(key);
   }
 }
@@ -314,7 +324,9 @@ DocumentKeySet LevelDbTargetCache::GetMatchingKeys(TargetId target_id) {
   auto index_iterator = db_->current_transaction()->NewIterator();
   index_iterator->Seek(index_prefix);
 
-  DocumentKeySet result;
+  // Rows are sorted by document key within a target, so the set can be built
+  // in one pass rather than rebalanced on every insert.
+  std::vector<DocumentKey> keys;
   LevelDbTargetDocumentKey row_key;
   for (; index_iterator->Valid(); index_iterator->Next()) {
     // TODO(gsoltis): could we use a StartsWith instead?
@@ -324,10 +336,10 @@ DocumentKeySet LevelDbTargetCache::GetMatchingKeys(TargetId target_id) {
       break;
     }
 
-    result = result.insert(row_key.document_key());
+    keys.push_back(row_key.document_key());
   }
 
-  return result;
+  return DocumentKeySet::FromSortedValues(std::move(keys));
 }
 
 bool LevelDbTargetCache::Contains(const DocumentKey& key) {
@@ -365,22 +377,52 @@ void LevelDbTargetCache::SetLastRemoteSnapshotVersion(SnapshotVersion version) {
 
 void LevelDbTargetCache::EnumerateOrphanedDocuments(
     const OrphanedDocumentCallback& callback) {
+  absl::optional<DocumentKey> cursor;
+  EnumerateOrphanedDocuments(callback, &cursor,
+                             std::numeric_limits<size_t>::max());
+}
+
+void LevelDbTargetCache::EnumerateOrphanedDocuments(
+    const OrphanedDocumentCallback& callback,
+    absl::optional<DocumentKey>* cursor,
+    size_t max_documents) {
   std::string document_target_prefix = LevelDbDocumentTargetKey::KeyPrefix();
   auto it = db_->current_transaction()->NewIterator();
-  it->Seek(document_target_prefix);
+  absl::optional<DocumentKey> start_after = std::move(*cursor);
+  cursor->reset();
+  if (start_after) {
+    it->Seek(LevelDbDocumentTargetKey::SentinelKey(*start_after));
+  } else {
+    it->Seek(document_target_prefix);
+  }
+
   ListenSequenceNumber next_to_report = 0;
   DocumentKey key_to_report;
   LevelDbDocumentTargetKey key;
+  size_t documents_examined = 0;
 
   for (; it->Valid() && absl::StartsWith(it->key(), document_target_prefix);
        it->Next()) {
     HARD_ASSERT(key.Decode(it->key()), "Failed to decode DocumentTarget key");
+    // Skip any rows left for the document the previous call stopped at.
+    if (start_after && key.document_key() == *start_after) {
+      continue;
+    }
+
     if (key.IsSentinel()) {
       // if next_to_report is non-zero, report it, this is a new key so the last
       // one must be not be a member of any targets.
       if (next_to_report != 0) {
         callback(key_to_report, next_to_report);
       }
+      // Stop at the document boundary once enough documents have been
+      // examined; the caller resumes after the last one.
+      if (documents_examined == max_documents) {
+        *cursor = std::move(key_to_report);
+        return;
+      }
+      ++documents_examined;
+
       // set next_to_report to be this sequence number. It's the next one we
       // might report, if we don't find any targets for this document.
       next_to_report =
@@ -125,6 +125,16 @@ class LevelDbTargetCache : public TargetCache {
 
   void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback);
 
+  /**
+   * Enumerates orphaned documents in key order, resuming after `*cursor` (or
+   * at the first document if `*cursor` is empty) and examining at most
+   * `max_documents` documents. On return `*cursor` holds the last document
+   * examined, or is empty once the enumeration has reached the end.
+   */
+  void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback,
+                                  absl::optional<model::DocumentKey>* cursor,
+                                  size_t max_documents);
+
  private:
   void Save(const TargetData& target_data);
   bool UpdateMetadata(const TargetData& target_data);
@@ -16,10 +16,14 @@
 
 #include "Firestore/core/src/local/leveldb_transaction.h"
 
+#include <algorithm>
+
 #include "Firestore/core/src/local/leveldb_key.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/string_util.h"
 #include "absl/memory/memory.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "leveldb/write_batch.h"
 
@@ -33,6 +37,38 @@ using leveldb::WriteOptions;
 namespace firebase {
 namespace firestore {
 namespace local {
+namespace {
+
+const std::string& KeyOf(const std::string& key) {
+  return key;
+}
+
+const std::string& KeyOf(const std::pair<const std::string, std::string>& kv) {
+  return kv.first;
+}
+
+/**
+ * Returns whether all keys of the sorted `container` start with one of the
+ * `prefixes`. Skips over each run of keys sharing a prefix with one seek.
+ */
+template <typename Container>
+bool AllKeysHavePrefixes(const Container& container,
+                         const std::vector<std::string>& prefixes) {
+  auto it = container.begin();
+  while (it != container.end()) {
+    const std::string& key = KeyOf(*it);
+    auto prefix = std::find_if(
+        prefixes.begin(), prefixes.end(),
+        [&](const std::string& p) { return absl::StartsWith(key, p); });
+    if (prefix == prefixes.end()) {
+      return false;
+    }
+    it = container.lower_bound(util::PrefixSuccessor(*prefix));
+  }
+  return true;
+}
+
+}  // namespace
 
 LevelDbTransaction::Iterator::Iterator(LevelDbTransaction* txn)
     : db_iter_(txn->db_->NewIterator(txn->read_options_)),
@@ -194,6 +230,23 @@ void LevelDbTransaction::Delete(absl::string_view key) {
   version_++;
 }
 
+size_t LevelDbTransaction::changed_bytes() const {
+  size_t bytes = 0;
+  for (const auto& deletion : deletions_) {
+    bytes += deletion.size();
+  }
+  for (const auto& entry : mutations_) {
+    bytes += entry.first.size() + entry.second.size();
+  }
+  return bytes;
+}
+
+bool LevelDbTransaction::ChangesOnlyKeysWithPrefixes(
+    const std::vector<std::string>& prefixes) const {
+  return AllKeysHavePrefixes(deletions_, prefixes) &&
+         AllKeysHavePrefixes(mutations_, prefixes);
+}
+
 void LevelDbTransaction::Commit() {
   WriteBatch batch;
   for (const auto& deletion : deletions_) {
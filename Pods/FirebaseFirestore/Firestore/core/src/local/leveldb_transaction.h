@@ -23,6 +23,7 @@
 #include <set>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
@@ -149,6 +150,19 @@ class LevelDbTransaction {
     return mutations_.size() + deletions_.size();
   }
 
+  /**
+   * Returns the number of key and value bytes the pending changes will write.
+   * Deletions count their keys, since tombstones take space until compaction.
+   */
+  size_t changed_bytes() const;
+
+  /**
+   * Returns whether every pending change is to a key that starts with one of
+   * the given prefixes.
+   */
+  bool ChangesOnlyKeysWithPrefixes(
+      const std::vector<std::string>& prefixes) const;
+
   /**
    * Remove the database entry (if any) for "key".  It is not an error if "key"
    * did not exist in the database.
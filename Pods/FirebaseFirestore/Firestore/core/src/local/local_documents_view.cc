@@ -16,6 +16,7 @@
 
 #include "Firestore/core/src/local/local_documents_view.h"
 
+#include <algorithm>
 #include <map>
 #include <memory>
 #include <string>
@@ -72,20 +73,91 @@ Document LocalDocumentsView::GetDocument(
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingQuery(
     const Query& query, const model::IndexOffset& offset) {
+  QueryContext context;
+  return GetDocumentsMatchingQuery(query, offset, context);
+}
+
+DocumentMap LocalDocumentsView::GetDocumentsMatchingQuery(
+    const Query& query,
+    const model::IndexOffset& offset,
+    QueryContext& context) {
   if (query.IsDocumentQuery()) {
-    return GetDocumentsMatchingDocumentQuery(query.path());
+    return GetDocumentsMatchingDocumentQuery(query.path(), context);
   } else if (query.IsCollectionGroupQuery()) {
-    return GetDocumentsMatchingCollectionGroupQuery(query, offset);
+    return GetDocumentsMatchingCollectionGroupQuery(query, offset, context);
   } else {
-    return GetDocumentsMatchingCollectionQuery(query, offset);
+    return GetDocumentsMatchingCollectionQuery(query, offset, context);
   }
 }
 
+LocalDocumentsResult LocalDocumentsView::GetNextDocuments(
+    const std::string& collection_group,
+    const IndexOffset& offset,
+    size_t count) {
+  MutableDocumentMap docs =
+      remote_document_cache_->GetAll(collection_group, offset, count);
+  OverlayByDocumentKeyMap overlays;
+  if (docs.size() < count) {
+    overlays = document_overlay_cache_->GetOverlays(
+        collection_group, offset.largest_batch_id(), count - docs.size());
+  }
+
+  BatchId largest_batch_id = model::kBatchIdUnknown;
+  for (const auto& entry : overlays) {
+    if (docs.find(entry.first) == docs.end()) {
+      docs = docs.insert(entry.first, GetBaseDocument(entry.first, entry.second));
+    }
+    largest_batch_id =
+        std::max(largest_batch_id, entry.second.largest_batch_id());
+  }
+
+  DocumentKeySet keys;
+  for (const auto& entry : docs) {
+    keys = keys.insert(entry.first);
+  }
+  PopulateOverlays(overlays, keys);
+
+  model::OverlayedDocumentMap views =
+      ComputeViews(docs, std::move(overlays), DocumentKeySet{});
+  DocumentMap results;
+  for (auto& entry : views) {
+    results = results.insert(entry.first, std::move(entry.second).document());
+  }
+  return LocalDocumentsResult(largest_batch_id, std::move(results));
+}
+
+DocumentMap LocalDocumentsView::GetDocumentsChangedSince(
+    const ResourcePath& collection, const IndexOffset& offset) {
+  MutableDocumentMap docs = remote_document_cache_->GetAll(collection, offset);
+  OverlayByDocumentKeyMap overlays = document_overlay_cache_->GetOverlays(
+      collection, offset.largest_batch_id());
+  for (const auto& entry : overlays) {
+    if (docs.find(entry.first) == docs.end()) {
+      docs =
+          docs.insert(entry.first, GetBaseDocument(entry.first, entry.second));
+    }
+  }
+
+  DocumentMap results;
+  for (const auto& entry : docs) {
+    MutableDocument doc = entry.second;
+    auto overlay_it = overlays.find(entry.first);
+    if (overlay_it != overlays.end()) {
+      (*overlay_it)
+          .second.mutation()
+          .ApplyToLocalView(doc, FieldMask(), Timestamp::Now());
+    }
+    results = results.insert(entry.first, std::move(doc));
+  }
+  return results;
+}
+
 DocumentMap LocalDocumentsView::GetDocumentsMatchingDocumentQuery(
-    const ResourcePath& doc_path) {
+    const ResourcePath& doc_path, QueryContext& context) {
   DocumentMap result;
   // Just do a simple document lookup.
   Document doc = GetDocument(DocumentKey{doc_path});
+  context.IncrementDocumentReadCount(1);
   if (doc->is_found_document()) {
     result = result.insert(doc->key(), doc);
   }
@@ -93,7 +165,7 @@ DocumentMap LocalDocumentsView::GetDocumentsMatchingDocumentQuery(
 }
 
 model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
-    const Query& query, const IndexOffset& offset) {
+    const Query& query, const IndexOffset& offset, QueryContext& context) {
   HARD_ASSERT(
       query.path().empty(),
       "Currently we only support collection group queries at the root.");
@@ -109,7 +181,7 @@ model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
     Query collection_query =
         query.AsCollectionQueryAtPath(parent.Append(collection_id));
     DocumentMap collection_results =
-        GetDocumentsMatchingCollectionQuery(collection_query, offset);
+        GetDocumentsMatchingCollectionQuery(collection_query, offset, context);
     for (const auto& kv : collection_results) {
       const DocumentKey& key = kv.first;
       results = results.insert(key, Document(kv.second));
@@ -119,12 +191,15 @@ model::DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionGroupQuery(
 }
 
 DocumentMap LocalDocumentsView::GetDocumentsMatchingCollectionQuery(
-    const Query& query, const IndexOffset& offset) {
-  MutableDocumentMap remote_documents =
-      remote_document_cache_->GetAll(query.path(), offset);
+    const Query& query, const IndexOffset& offset, QueryContext& context) {
   // Get locally persisted mutation batches.
   OverlayByDocumentKeyMap overlays = document_overlay_cache_->GetOverlays(
       query.path(), offset.largest_batch_id());
+  // Documents without overlays are filtered while they are read from the
+  // cache, which avoids copying documents that cannot match.
+  MutableDocumentMap remote_documents =
+      remote_document_cache_->GetDocumentsMatchingQuery(query, offset, overlays,
+                                                        context);
 
   // As documents might match the query because of their overlay we need to
   // include documents for all overlays in the initial document set.
@@ -17,13 +17,16 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_DOCUMENTS_VIEW_H_
 
+#include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "Firestore/core/src/immutable/sorted_set.h"
 #include "Firestore/core/src/local/document_overlay_cache.h"
 #include "Firestore/core/src/local/index_manager.h"
+#include "Firestore/core/src/local/local_documents_result.h"
 #include "Firestore/core/src/local/mutation_queue.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/local/remote_document_cache.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/model/model_fwd.h"
@@ -116,6 +119,39 @@ class LocalDocumentsView {
   virtual model::DocumentMap GetDocumentsMatchingQuery(
       const core::Query& query, const model::IndexOffset& offset);
 
+  /**
+   * Performs a query against the local view of all documents, recording the
+   * number of documents read from the cache in `context`.
+   */
+  model::DocumentMap GetDocumentsMatchingQuery(const core::Query& query,
+                                               const model::IndexOffset& offset,
+                                               QueryContext& context);
+
+  /**
+   * Returns the local view of the next `count` documents in the given
+   * collection group that sort after `offset`, along with the largest batch
+   * ID of the overlays that were applied to them.
+   *
+   * Documents that only exist locally (through their overlays) are included
+   * as well, which may cause the result to exceed `count`.
+   */
+  LocalDocumentsResult GetNextDocuments(const std::string& collection_group,
+                                        const model::IndexOffset& offset,
+                                        size_t count);
+
+  /**
+   * Returns the local view of every document in `collection` that was read
+   * into the cache after `offset` or that has an overlay from a batch after
+   * the offset's largest batch ID, whether it matches any query or not.
+   * Documents that don't exist are included as non-found documents.
+   */
+  model::DocumentMap GetDocumentsChangedSince(
+      const model::ResourcePath& collection, const model::IndexOffset& offset);
+
+  IndexManager* index_manager() {
+    return index_manager_;
+  }
+
  private:
   friend class CountingQueryEngine;  // For testing
 
@@ -125,14 +161,18 @@ class LocalDocumentsView {
 
   /** Performs a simple document lookup for the given path. */
   model::DocumentMap GetDocumentsMatchingDocumentQuery(
-      const model::ResourcePath& doc_path);
+      const model::ResourcePath& doc_path, QueryContext& context);
 
   model::DocumentMap GetDocumentsMatchingCollectionGroupQuery(
-      const core::Query& query, const model::IndexOffset& offset);
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext& context);
 
   /** Queries the remote documents and overlays mutations. */
   model::DocumentMap GetDocumentsMatchingCollectionQuery(
-      const core::Query& query, const model::IndexOffset& offset);
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      QueryContext& context);
 
   RemoteDocumentCache* remote_document_cache() {
     return remote_document_cache_;
@@ -146,10 +186,6 @@ class LocalDocumentsView {
     return document_overlay_cache_;
   }
 
-  IndexManager* index_manager() {
-    return index_manager_;
-  }
-
  private:
   /** Returns a base document that can be used to apply `overlay`. */
   model::MutableDocument GetBaseDocument(
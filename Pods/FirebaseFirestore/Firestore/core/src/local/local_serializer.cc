@@ -67,6 +67,7 @@ using nanopb::ByteString;
 using nanopb::CheckedSize;
 using nanopb::CopyBytesArray;
 using nanopb::MakeArray;
+using nanopb::MakeStdString;
 using nanopb::Message;
 using nanopb::Reader;
 using nanopb::ReleaseFieldOwnership;
@@ -106,6 +107,24 @@ Message<firestore_client_MaybeDocument> LocalSerializer::EncodeMaybeDocument(
   UNREACHABLE();
 }
 
+std::string LocalSerializer::EncodeMaybeDocumentBytes(
+    const MutableDocument& document) const {
+  if (!document.is_found_document()) {
+    return MakeStdString(EncodeMaybeDocument(document));
+  }
+
+  Message<firestore_client_MaybeDocument> result;
+  result->which_document_type = firestore_client_MaybeDocument_document_tag;
+  result->document = EncodeDocument(document, /*copy_values=*/false);
+  result->has_committed_mutations = document.has_committed_mutations();
+  std::string bytes = MakeStdString(result);
+
+  // The values still belong to `document`.
+  ReleaseFieldOwnership(result->document.fields,
+                        result->document.fields_count);
+  return bytes;
+}
+
 MutableDocument LocalSerializer::DecodeMaybeDocument(
     Reader* reader, firestore_client_MaybeDocument& proto) const {
   if (!reader->status().ok()) return {};
@@ -136,7 +155,7 @@ MutableDocument LocalSerializer::DecodeMaybeDocument(
 }
 
 google_firestore_v1_Document LocalSerializer::EncodeDocument(
-    const MutableDocument& doc) const {
+    const MutableDocument& doc, bool copy_values) const {
   google_firestore_v1_Document result{};
 
   result.name = rpc_serializer_.EncodeKey(doc.key());
@@ -147,8 +166,11 @@ google_firestore_v1_Document LocalSerializer::EncodeDocument(
       &result.fields, &result.fields_count,
       absl::Span<google_firestore_v1_MapValue_FieldsEntry>(
           fields_map.fields, fields_map.fields_count),
-      [](const google_firestore_v1_MapValue_FieldsEntry& map_entry) {
-        // TODO(mrschmidt): Figure out how to remove this copy
+      [copy_values](const google_firestore_v1_MapValue_FieldsEntry& map_entry) {
+        if (!copy_values) {
+          return google_firestore_v1_Document_FieldsEntry{map_entry.key,
+                                                          map_entry.value};
+        }
         return google_firestore_v1_Document_FieldsEntry{
             nanopb::CopyBytesArray(map_entry.key),
             *DeepClone(map_entry.value).release()};
@@ -483,6 +505,12 @@ std::vector<model::Segment> LocalSerializer::DecodeFieldIndexSegments(
       } else {
         kind = Segment::Kind::kDescending;
       }
+    } else if (
+        field.which_value_mode ==
+            google_firestore_admin_v1_Index_IndexField_array_config_tag &&
+        field.array_config ==
+            google_firestore_admin_v1_Index_IndexField_ArrayConfig_ARRAY_CONFIG_UNSPECIFIED) {  // NOLINT
+      kind = Segment::Kind::kGeo;
     }
 
     result.push_back({field_path.ValueOrDie(), kind});
@@ -532,6 +560,16 @@ LocalSerializer::EncodeFieldIndexSegments(
             google_firestore_admin_v1_Index_IndexField_Order_DESCENDING;
         break;
       }
+      case model::Segment::kGeo: {
+        // The index proto has no geo mode. An unspecified array config marks
+        // geo segments, which older clients read as Contains segments that no
+        // query they run can match.
+        field.which_value_mode =
+            google_firestore_admin_v1_Index_IndexField_array_config_tag;
+        field.array_config =
+            google_firestore_admin_v1_Index_IndexField_ArrayConfig_ARRAY_CONFIG_UNSPECIFIED;  // NOLINT
+        break;
+      }
       default:
         HARD_FAIL("Unrecognized enum value from segment.kind()");
     }
@@ -92,6 +92,17 @@ class LocalSerializer {
   nanopb::Message<firestore_client_MaybeDocument> EncodeMaybeDocument(
       const model::MutableDocument& maybe_doc) const;
 
+  /**
+   * Encodes a MaybeDocument model straight to the bytes of its proto for
+   * local storage.
+   *
+   * Unlike serializing the result of `EncodeMaybeDocument`, the field values
+   * are encoded in place instead of being deep-copied into the proto first,
+   * which saves an allocation per value.
+   */
+  std::string EncodeMaybeDocumentBytes(
+      const model::MutableDocument& maybe_doc) const;
+
   /**
    * @brief Decodes nanopb proto representing a MaybeDocument proto to the
    * equivalent model.
@@ -180,9 +191,13 @@ class LocalSerializer {
    * Encodes a Document for local storage. This differs from the v1 RPC
    * serializer for Documents in that it preserves the update_time, which is
    * considered an output only value by the server.
+   *
+   * Unless `copy_values` is set, the fields of the result refer to the values
+   * of `doc`, and the caller has to release their ownership before freeing
+   * the result.
    */
-  google_firestore_v1_Document EncodeDocument(
-      const model::MutableDocument& doc) const;
+  google_firestore_v1_Document EncodeDocument(const model::MutableDocument& doc,
+                                              bool copy_values = true) const;
 
   model::MutableDocument DecodeDocument(nanopb::Reader* reader,
                                         google_firestore_v1_Document& proto,
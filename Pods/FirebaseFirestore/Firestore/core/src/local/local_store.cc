@@ -22,6 +22,7 @@
 
 #include "Firestore/core/src/credentials/user.h"
 #include "Firestore/core/src/local/bundle_cache.h"
+#include "Firestore/core/src/local/index_backfiller.h"
 #include "Firestore/core/src/local/local_documents_view.h"
 #include "Firestore/core/src/local/local_view_changes.h"
 #include "Firestore/core/src/local/local_write_result.h"
@@ -39,6 +40,7 @@
 #include "Firestore/core/src/model/patch_mutation.h"
 #include "Firestore/core/src/remote/remote_event.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/to_string.h"
 
 namespace firebase {
@@ -105,7 +107,8 @@ LocalStore::LocalStore(Persistence* persistence,
       remote_document_cache_(persistence->remote_document_cache()),
       target_cache_(persistence->target_cache()),
       bundle_cache_(persistence->bundle_cache()),
-      query_engine_(query_engine) {
+      query_engine_(query_engine),
+      index_backfiller_(absl::make_unique<IndexBackfiller>()) {
   index_manager_ = persistence->GetIndexManager(initial_user);
   mutation_queue_ = persistence->GetMutationQueue(initial_user, index_manager_);
   document_overlay_cache_ = persistence->GetDocumentOverlayCache(initial_user);
@@ -124,6 +127,7 @@ LocalStore::LocalStore(Persistence* persistence,
 LocalStore::~LocalStore() = default;
 
 void LocalStore::Start() {
+  util::StartupSpan span(util::StartupPhase::kLocalStoreStart);
   StartMutationQueue();
   overlay_migration_manager_->Run();
   TargetId target_id = target_cache_->highest_target_id();
@@ -136,13 +140,14 @@ void LocalStore::StartMutationQueue() {
 }
 
 DocumentMap LocalStore::HandleUserChange(const User& user) {
-  // Swap out the mutation queue, grabbing the pending mutation batches before
-  // and after.
-  std::vector<MutationBatch> old_batches = persistence_->Run(
-      "OldBatches", [&] { return mutation_queue_->AllMutationBatches(); });
+  // Swap out the mutation queue, grabbing the keys mutated by pending batches
+  // before and after.
+  DocumentKeySet old_keys = persistence_->Run(
+      "OldBatches", [&] { return mutation_queue_->AllMutatedDocumentKeys(); });
 
   // The old one has a reference to the mutation queue, so null it out first.
   local_documents_.reset();
+  query_results_.Clear();
   index_manager_ = persistence_->GetIndexManager(user);
   mutation_queue_ = persistence_->GetMutationQueue(user, index_manager_);
   document_overlay_cache_ = persistence_->GetDocumentOverlayCache(user);
@@ -153,8 +158,7 @@ DocumentMap LocalStore::HandleUserChange(const User& user) {
   persistence_->ReleaseOtherUserSpecificComponents(user.uid());
 
   return persistence_->Run("NewBatches", [&] {
-    std::vector<MutationBatch> new_batches =
-        mutation_queue_->AllMutationBatches();
+    DocumentKeySet new_keys = mutation_queue_->AllMutatedDocumentKeys();
 
     // Recreate our LocalDocumentsView using the new MutationQueue.
     local_documents_ = absl::make_unique<LocalDocumentsView>(
@@ -162,20 +166,9 @@ DocumentMap LocalStore::HandleUserChange(const User& user) {
         index_manager_);
     query_engine_->SetLocalDocumentsView(local_documents_.get());
 
-    // Union the old/new changed keys.
-    DocumentKeySet changed_keys;
-    for (const std::vector<MutationBatch>* batches :
-         {&old_batches, &new_batches}) {
-      for (const MutationBatch& batch : *batches) {
-        for (const Mutation& mutation : batch.mutations()) {
-          changed_keys = changed_keys.insert(mutation.key());
-        }
-      }
-    }
-
     // Return the set of all (potentially) changed documents as the result of
     // the user change.
-    return local_documents_->GetDocuments(changed_keys);
+    return local_documents_->GetDocuments(old_keys.union_with(new_keys));
   });
 }
 
@@ -185,6 +178,7 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
   for (const Mutation& mutation : mutations) {
     keys = keys.insert(mutation.key());
   }
+  query_results_.InvalidateDocuments(keys);
 
   return persistence_->Run("Locally write mutations", [&] {
     // Figure out which keys do not have a remote version in the cache, this is
@@ -240,6 +234,7 @@ LocalWriteResult LocalStore::WriteLocally(std::vector<Mutation>&& mutations) {
 
 DocumentMap LocalStore::AcknowledgeBatch(
     const MutationBatchResult& batch_result) {
+  query_results_.InvalidateDocuments(batch_result.batch().keys());
   return persistence_->Run("Acknowledge batch", [&] {
     const MutationBatch& batch = batch_result.batch();
     mutation_queue_->AcknowledgeBatch(batch, batch_result.stream_token());
@@ -284,6 +279,7 @@ DocumentMap LocalStore::RejectBatch(BatchId batch_id) {
     absl::optional<MutationBatch> to_reject =
         mutation_queue_->LookupMutationBatch(batch_id);
     HARD_ASSERT(to_reject.has_value(), "Attempt to reject nonexistent batch!");
+    query_results_.InvalidateDocuments(to_reject->keys());
 
     mutation_queue_->RemoveMutationBatch(*to_reject);
     mutation_queue_->PerformConsistencyCheck();
@@ -333,6 +329,10 @@ model::DocumentMap LocalStore::ApplyRemoteEvent(
 
       TargetData old_target_data = found->second;
 
+      if (!change.added_documents().empty() ||
+          !change.removed_documents().empty()) {
+        query_results_.InvalidateTarget(old_target_data.target());
+      }
       target_cache_->RemoveMatchingKeys(change.removed_documents(), target_id);
       target_cache_->AddMatchingKeys(change.added_documents(), target_id);
 
@@ -370,6 +370,9 @@ model::DocumentMap LocalStore::ApplyRemoteEvent(
     auto result = PopulateDocumentChanges(remote_event.document_updates(),
                                           DocumentVersionMap(),
                                           remote_event.snapshot_version());
+    for (const auto& kv : remote_event.document_updates()) {
+      query_results_.InvalidateDocument(kv.first);
+    }
 
     // HACK: The only reason we allow omitting snapshot version is so we can
     // synthesize remote events when we get permission denied errors while
@@ -502,6 +505,9 @@ TargetData LocalStore::AllocateTarget(Target target) {
 }
 
 void LocalStore::ReleaseTarget(TargetId target_id) {
+  // Releasing a target can make documents of any query eligible for garbage
+  // collection.
+  query_results_.Clear();
   persistence_->Run("Release target", [&] {
     auto found = target_data_by_target_.find(target_id);
     HARD_ASSERT(found != target_data_by_target_.end(),
@@ -528,7 +534,12 @@ void LocalStore::ReleaseTarget(TargetId target_id) {
 
 QueryResult LocalStore::ExecuteQuery(const Query& query,
                                      bool use_previous_results) {
-  return persistence_->Run("ExecuteQuery", [&] {
+  absl::optional<QueryResult> cached = query_results_.Get(query);
+  if (cached) {
+    return std::move(cached).value();
+  }
+
+  QueryResult result = persistence_->Run("ExecuteQuery", [&] {
     absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
     SnapshotVersion last_limbo_free_snapshot_version;
     DocumentKeySet remote_keys;
@@ -546,6 +557,39 @@ QueryResult LocalStore::ExecuteQuery(const Query& query,
         use_previous_results ? remote_keys : DocumentKeySet{});
     return QueryResult(std::move(documents), std::move(remote_keys));
   });
+  query_results_.Put(query, result);
+  return result;
+}
+
+size_t LocalStore::CountDocuments(const Query& query) {
+  absl::optional<QueryResult> cached = query_results_.Get(query);
+  if (cached) {
+    return cached->documents().size();
+  }
+
+  return persistence_->Run("CountDocuments", [&] {
+    absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
+    SnapshotVersion last_limbo_free_snapshot_version;
+    DocumentKeySet remote_keys;
+
+    if (target_data) {
+      last_limbo_free_snapshot_version =
+          target_data->last_limbo_free_snapshot_version();
+      remote_keys = target_cache_->GetMatchingKeys(target_data->target_id());
+    }
+
+    return query_engine_->CountDocumentsMatchingQuery(
+        query, last_limbo_free_snapshot_version, remote_keys);
+  });
+}
+
+DocumentMap LocalStore::GetDocumentsInRegion(
+    const Query& query,
+    const model::FieldPath& field_path,
+    const index::GeoRegion& region) {
+  return persistence_->Run("GetDocumentsInRegion", [&] {
+    return query_engine_->GetDocumentsInRegion(query, field_path, region);
+  });
 }
 
 DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
@@ -554,12 +598,49 @@ DocumentKeySet LocalStore::GetRemoteDocumentKeys(TargetId target_id) {
   });
 }
 
+DocumentKeySet LocalStore::GetRemoteDocumentKeys(const Query& query) {
+  return persistence_->Run("RemoteDocumentKeysForQuery", [&] {
+    absl::optional<TargetData> target_data = GetTargetData(query.ToTarget());
+    if (!target_data) {
+      return DocumentKeySet{};
+    }
+    return target_cache_->GetMatchingKeys(target_data->target_id());
+  });
+}
+
 LruResults LocalStore::CollectGarbage(LruGarbageCollector* garbage_collector) {
+  query_results_.Clear();
   return persistence_->Run("Collect garbage", [&] {
     return garbage_collector->Collect(target_data_by_target_);
   });
 }
 
+LruResults LocalStore::CollectGarbageIncrementally(
+    LruGarbageCollector* garbage_collector,
+    std::chrono::milliseconds time_budget) {
+  query_results_.Clear();
+  return persistence_->Run("Collect garbage incrementally", [&] {
+    return garbage_collector->CollectIncrementally(target_data_by_target_,
+                                                   time_budget);
+  });
+}
+
+size_t LocalStore::Backfill(size_t max_documents) {
+  index_backfiller_->set_max_documents_to_process(max_documents);
+  return persistence_->Run("Backfill Indexes", [&] {
+    return index_backfiller_->WriteIndexEntries(index_manager_,
+                                                local_documents_.get());
+  });
+}
+
+void LocalStore::SetQueryResultCacheSize(size_t max_entries) {
+  query_results_.set_max_entries(max_entries);
+}
+
+void LocalStore::SetIndexAutoCreationEnabled(bool enabled) {
+  query_engine_->SetIndexAutoCreationEnabled(enabled);
+}
+
 bool LocalStore::HasNewerBundle(const bundle::BundleMetadata& metadata) {
   return persistence_->Run("Has newer bundle", [&] {
     absl::optional<bundle::BundleMetadata> cached_metadata =
@@ -576,6 +657,23 @@ void LocalStore::SaveBundle(const bundle::BundleMetadata& metadata) {
 
 DocumentMap LocalStore::ApplyBundledDocuments(
     const MutableDocumentMap& bundled_documents, const std::string& bundle_id) {
+  return ApplyBundledDocumentsInternal(bundled_documents, bundle_id,
+                                       /*replace_keys=*/true);
+}
+
+DocumentMap LocalStore::AppendBundledDocuments(
+    const MutableDocumentMap& bundled_documents, const std::string& bundle_id) {
+  return ApplyBundledDocumentsInternal(bundled_documents, bundle_id,
+                                       /*replace_keys=*/false);
+}
+
+DocumentMap LocalStore::ApplyBundledDocumentsInternal(
+    const MutableDocumentMap& bundled_documents,
+    const std::string& bundle_id,
+    bool replace_keys) {
+  for (const auto& kv : bundled_documents) {
+    query_results_.InvalidateDocument(kv.first);
+  }
   // Allocates a target to hold all document keys from the bundle, such that
   // they will not get garbage collected right away.
   TargetData umbrella_target = AllocateTarget(NewUmbrellaTarget(bundle_id));
@@ -594,7 +692,9 @@ DocumentMap LocalStore::ApplyBundledDocuments(
       versions.emplace(key, doc.version());
     }
 
-    target_cache_->RemoveMatchingKeysForTarget(umbrella_target.target_id());
+    if (replace_keys) {
+      target_cache_->RemoveMatchingKeysForTarget(umbrella_target.target_id());
+    }
     target_cache_->AddMatchingKeys(keys, umbrella_target.target_id());
 
     auto result = PopulateDocumentChanges(document_updates, versions,
@@ -613,6 +713,7 @@ void LocalStore::SaveNamedQuery(const bundle::NamedQuery& query,
   // get collected, unless users happen to unlisten the query.
   TargetData existing = AllocateTarget(query.bundled_query().target());
   int target_id = existing.target_id();
+  query_results_.InvalidateTarget(query.bundled_query().target());
 
   return persistence_->Run("Save named query", [&] {
     // Only update the matching documents if it is newer than what the SDK
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LOCAL_STORE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LOCAL_STORE_H_
 
+#include <chrono>  // NOLINT(build/c++11)
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,7 @@
 #include "Firestore/core/src/core/target_id_generator.h"
 #include "Firestore/core/src/local/document_overlay_cache.h"
 #include "Firestore/core/src/local/overlay_migration_manager.h"
+#include "Firestore/core/src/local/query_result_cache.h"
 #include "Firestore/core/src/local/reference_set.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/document.h"
@@ -45,6 +47,10 @@ namespace core {
 class Query;
 }  // namespace core
 
+namespace index {
+class GeoRegion;
+}  // namespace index
+
 namespace remote {
 class RemoteEvent;
 class TargetChange;
@@ -53,6 +59,7 @@ class TargetChange;
 namespace local {
 
 class BundleCache;
+class IndexBackfiller;
 class IndexManager;
 class LocalDocumentsView;
 class LocalViewChanges;
@@ -192,6 +199,12 @@ class LocalStore : public bundle::BundleCallback {
    */
   model::DocumentKeySet GetRemoteDocumentKeys(model::TargetId target_id);
 
+  /**
+   * Returns the keys of the documents that the backend last reported as
+   * matching the given query, or an empty set if the query has no target.
+   */
+  model::DocumentKeySet GetRemoteDocumentKeys(const core::Query& query);
+
   /**
    * Assigns a target an internal ID so that its results can be pinned so they
    * don't get GC'd. A target must be allocated in the local store before the
@@ -219,6 +232,22 @@ class LocalStore : public bundle::BundleCallback {
    */
   QueryResult ExecuteQuery(const core::Query& query, bool use_previous_results);
 
+  /**
+   * Returns the number of documents in the local store that match the
+   * specified query. Field indexes are used to avoid reading the matching
+   * documents where possible.
+   */
+  size_t CountDocuments(const core::Query& query);
+
+  /**
+   * Returns the documents in the local store that match the filters of the
+   * specified query and whose GeoPoint value at `field_path` lies within
+   * `region`. A geo index over the field is used once it has been backfilled.
+   */
+  model::DocumentMap GetDocumentsInRegion(const core::Query& query,
+                                          const model::FieldPath& field_path,
+                                          const index::GeoRegion& region);
+
   /**
    * Notify the local store of the changed views to locally pin / unpin
    * documents.
@@ -245,6 +274,38 @@ class LocalStore : public bundle::BundleCallback {
 
   LruResults CollectGarbage(LruGarbageCollector* garbage_collector);
 
+  /**
+   * Runs one time-bounded turn of an incremental garbage collection. See
+   * `LruGarbageCollector::CollectIncrementally`.
+   */
+  LruResults CollectGarbageIncrementally(
+      LruGarbageCollector* garbage_collector,
+      std::chrono::milliseconds time_budget);
+
+  /**
+   * Writes the index entries of the next batch of at most `max_documents`
+   * documents that changed since the field indexes were last updated. Returns
+   * the number of documents that were processed.
+   */
+  size_t Backfill(size_t max_documents);
+
+  /**
+   * Enables or disables the automatic creation of client-side indexes for
+   * queries that repeatedly require full collection scans.
+   */
+  void SetIndexAutoCreationEnabled(bool enabled);
+
+  /**
+   * Sets how many recent `ExecuteQuery` results are kept to serve repeated
+   * executions of the same query until a change to the cache may affect
+   * them. Zero disables caching.
+   */
+  void SetQueryResultCacheSize(size_t max_entries);
+
+  const QueryResultCache& query_result_cache() const {
+    return query_results_;
+  }
+
   /**
    * Returns whether the given bundle has already been loaded and its create
    * time is newer or equal to the currently loading bundle.
@@ -265,6 +326,10 @@ class LocalStore : public bundle::BundleCallback {
       const model::MutableDocumentMap& documents,
       const std::string& bundle_id) override;
 
+  model::DocumentMap AppendBundledDocuments(
+      const model::MutableDocumentMap& documents,
+      const std::string& bundle_id) override;
+
   /** Saves the given `NamedQuery` to local persistence. */
   void SaveNamedQuery(const bundle::NamedQuery& query,
                       const model::DocumentKeySet& keys) override;
@@ -308,6 +373,16 @@ class LocalStore : public bundle::BundleCallback {
    */
   absl::optional<TargetData> GetTargetData(const core::Target& target);
 
+  /**
+   * Applies bundled documents and pins them with the bundle's umbrella
+   * target. If `replace_keys` is true, documents pinned by an earlier load
+   * of the bundle are released first.
+   */
+  model::DocumentMap ApplyBundledDocumentsInternal(
+      const model::MutableDocumentMap& documents,
+      const std::string& bundle_id,
+      bool replace_keys);
+
   /**
    * Creates a new target using the given bundle name, which will be used to
    * hold the keys of all documents from the bundle in query-document mappings.
@@ -373,6 +448,9 @@ class LocalStore : public bundle::BundleCallback {
    */
   IndexManager* index_manager_ = nullptr;
 
+  /** Writes index entries for documents that are not yet indexed. */
+  std::unique_ptr<IndexBackfiller> index_backfiller_;
+
   /**
    * Manages overlay migration.
    */
@@ -387,6 +465,9 @@ class LocalStore : public bundle::BundleCallback {
   /** The set of document references maintained by any local views. */
   ReferenceSet local_view_references_;
 
+  /** Recent query results, dropped when their documents or targets change. */
+  QueryResultCache query_results_;
+
   /** Maps target ids to data about their queries. */
   std::unordered_map<model::TargetId, TargetData> target_data_by_target_;
 
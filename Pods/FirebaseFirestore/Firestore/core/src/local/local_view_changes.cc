@@ -16,6 +16,9 @@
 
 #include "Firestore/core/src/local/local_view_changes.h"
 
+#include <utility>
+#include <vector>
+
 #include "Firestore/core/src/core/view_snapshot.h"
 
 namespace firebase {
@@ -24,22 +27,24 @@ namespace local {
 
 using core::DocumentViewChange;
 using core::ViewSnapshot;
+using model::DocumentKey;
 using model::DocumentKeySet;
 using model::TargetId;
 
 LocalViewChanges LocalViewChanges::FromViewSnapshot(
     const core::ViewSnapshot& snapshot, model::TargetId target_id) {
-  DocumentKeySet added_keys;
-  DocumentKeySet removed_keys;
+  // The changes are in query order, so collect the keys and sort them once.
+  std::vector<DocumentKey> added_keys;
+  std::vector<DocumentKey> removed_keys;
 
   for (const DocumentViewChange& doc_change : snapshot.document_changes()) {
     switch (doc_change.type()) {
       case DocumentViewChange::Type::Added:
-        added_keys = added_keys.insert(doc_change.document()->key());
+        added_keys.push_back(doc_change.document()->key());
         break;
 
       case DocumentViewChange::Type::Removed:
-        removed_keys = removed_keys.insert(doc_change.document()->key());
+        removed_keys.push_back(doc_change.document()->key());
         break;
 
       default:
@@ -48,8 +53,10 @@ LocalViewChanges LocalViewChanges::FromViewSnapshot(
     }
   }
 
-  return LocalViewChanges(target_id, snapshot.from_cache(),
-                          std::move(added_keys), std::move(removed_keys));
+  return LocalViewChanges(
+      target_id, snapshot.from_cache(),
+      DocumentKeySet::FromValues(std::move(added_keys)),
+      DocumentKeySet::FromValues(std::move(removed_keys)));
 }
 
 }  // namespace local
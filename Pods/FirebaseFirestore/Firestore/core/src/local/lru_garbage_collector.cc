@@ -27,6 +27,7 @@
 #include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/util/log.h"
 #include "Firestore/core/src/util/statusor.h"
+#include "absl/memory/memory.h"
 
 namespace firebase {
 namespace firestore {
@@ -40,6 +41,13 @@ using model::TargetId;
 using util::StatusOr;
 
 using Millis = std::chrono::milliseconds;
+using SteadyClock = std::chrono::steady_clock;
+
+/**
+ * The number of documents, or of entries being pruned, an incremental
+ * collection examines between checks of its time budget.
+ */
+const size_t kDocumentsPerIncrementalChunk = 100;
 
 static Millis::rep MillisecondsBetween(const Timestamp& start,
                                        const Timestamp& end) {
@@ -78,6 +86,13 @@ class RollingSequenceNumberBuffer {
     return queue_.top();
   }
 
+  /** Discards the highest values until at most `count` elements remain. */
+  void Truncate(size_t count) {
+    while (queue_.size() > count) {
+      queue_.pop();
+    }
+  }
+
   size_t size() const {
     return queue_.size();
   }
@@ -91,6 +106,38 @@ class RollingSequenceNumberBuffer {
 
 const ListenSequenceNumber kListenSequenceNumberInvalid = -1;
 
+/**
+ * The progress of an incremental collection. A cycle first walks the orphaned
+ * documents to find the upper bound sequence number, then removes targets and
+ * walks the orphaned documents a second time to remove them, and finally
+ * prunes what the removals left behind.
+ */
+class LruGarbageCollector::IncrementalCollection {
+ public:
+  enum class Phase {
+    kFindingUpperBound,
+    kRemovingDocuments,
+    kPruning,
+  };
+
+  explicit IncrementalCollection(size_t max_sequence_numbers)
+      : buffer(max_sequence_numbers) {
+  }
+
+  Phase phase = Phase::kFindingUpperBound;
+
+  // The lowest sequence numbers seen so far, and how many were seen in total.
+  RollingSequenceNumberBuffer buffer;
+  size_t sequence_number_count = 0;
+
+  absl::optional<DocumentKey> cursor;
+  ListenSequenceNumber upper_bound = kListenSequenceNumberInvalid;
+
+  LruResults results{/* did_run= */ true, 0, 0, 0};
+  Timestamp start = Timestamp::Now();
+  int turns = 0;
+};
+
 LruParams LruParams::Default() {
   return LruParams{100 * 1024 * 1024, 10, 1000};
 }
@@ -110,14 +157,114 @@ LruGarbageCollector::LruGarbageCollector(LruDelegate* delegate,
     : delegate_(delegate), params_(std::move(params)) {
 }
 
+LruGarbageCollector::~LruGarbageCollector() = default;
+
 StatusOr<int64_t> LruGarbageCollector::CalculateByteSize() const {
   return delegate_->CalculateByteSize();
 }
 
 LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
+  if (!ShouldCollect()) {
+    return LruResults::DidNotRun();
+  }
+  return RunGarbageCollection(live_targets);
+}
+
+LruResults LruGarbageCollector::CollectIncrementally(
+    const LiveQueryMap& live_targets, Millis time_budget) {
+  SteadyClock::time_point deadline = SteadyClock::now() + time_budget;
+  auto out_of_time = [&] { return SteadyClock::now() >= deadline; };
+
+  if (!incremental_) {
+    if (!ShouldCollect()) {
+      return LruResults::DidNotRun();
+    }
+
+    // The percentile is capped at the configured max, so only that many of
+    // the lowest sequence numbers need to be kept track of.
+    incremental_ = absl::make_unique<IncrementalCollection>(
+        static_cast<size_t>(params_.maximum_sequence_numbers_to_collect));
+    IncrementalCollection& state = *incremental_;
+    delegate_->EnumerateTargetSequenceNumbers(
+        [&state](ListenSequenceNumber sequence_number) {
+          state.buffer.AddElement(sequence_number);
+          state.sequence_number_count++;
+        });
+  }
+
+  IncrementalCollection& state = *incremental_;
+  state.turns++;
+
+  while (state.phase == IncrementalCollection::Phase::kFindingUpperBound) {
+    delegate_->EnumerateOrphanedDocuments(
+        [&state](const DocumentKey&, ListenSequenceNumber sequence_number) {
+          state.buffer.AddElement(sequence_number);
+          state.sequence_number_count++;
+        },
+        &state.cursor, kDocumentsPerIncrementalChunk);
+
+    if (!state.cursor) {
+      int sequence_numbers = static_cast<int>(
+          (params_.percentile_to_collect / 100.0f) *
+          state.sequence_number_count);
+      if (sequence_numbers > params_.maximum_sequence_numbers_to_collect) {
+        sequence_numbers = params_.maximum_sequence_numbers_to_collect;
+      }
+      state.results.sequence_numbers_collected = sequence_numbers;
+
+      if (sequence_numbers == 0) {
+        // Nothing is old enough to collect; the cycle is complete.
+        break;
+      }
+
+      state.buffer.Truncate(static_cast<size_t>(sequence_numbers));
+      state.upper_bound = state.buffer.max_value();
+      state.results.targets_removed =
+          RemoveTargets(state.upper_bound, live_targets);
+      state.phase = IncrementalCollection::Phase::kRemovingDocuments;
+    }
+
+    if (out_of_time()) {
+      return LruResults::DidNotRun();
+    }
+  }
+
+  while (state.phase == IncrementalCollection::Phase::kRemovingDocuments) {
+    state.results.documents_removed += delegate_->RemoveOrphanedDocuments(
+        state.upper_bound, &state.cursor, kDocumentsPerIncrementalChunk);
+    if (!state.cursor) {
+      state.phase = IncrementalCollection::Phase::kPruning;
+    }
+    if (out_of_time()) {
+      return LruResults::DidNotRun();
+    }
+  }
+
+  while (state.phase == IncrementalCollection::Phase::kPruning) {
+    if (delegate_->PruneRemovedDocuments(kDocumentsPerIncrementalChunk)) {
+      break;
+    }
+    if (out_of_time()) {
+      return LruResults::DidNotRun();
+    }
+  }
+
+  LOG_DEBUG(
+      "Incremental LRU Garbage Collection: collected %s sequence numbers, "
+      "removed %s targets and %s documents in %s turns over %sms",
+      state.results.sequence_numbers_collected, state.results.targets_removed,
+      state.results.documents_removed, state.turns,
+      MillisecondsBetween(state.start, Timestamp::Now()));
+
+  LruResults results = state.results;
+  incremental_.reset();
+  return results;
+}
+
+bool LruGarbageCollector::ShouldCollect() {
   if (params_.min_bytes_threshold == Settings::CacheSizeUnlimited) {
     LOG_DEBUG("Garbage collection skipped; disabled");
-    return LruResults::DidNotRun();
+    return false;
   }
 
   StatusOr<int64_t> maybe_current_size = CalculateByteSize();
@@ -126,7 +273,7 @@ LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
         "Garbage collection skipped; failed to estimate the size of the "
         "cache: %s",
         maybe_current_size.status().ToString());
-    return LruResults::DidNotRun();
+    return false;
   }
 
   int64_t current_size = maybe_current_size.ValueOrDie();
@@ -135,11 +282,11 @@ LruResults LruGarbageCollector::Collect(const LiveQueryMap& live_targets) {
     LOG_DEBUG(
         "Garbage collection skipped; Cache size %s is lower than threshold %s",
         current_size, params_.min_bytes_threshold);
-    return LruResults::DidNotRun();
+    return false;
   }
 
   LOG_DEBUG("Running garbage collection on cache of size: %s", current_size);
-  return RunGarbageCollection(live_targets);
+  return true;
 }
 
 LruResults LruGarbageCollector::RunGarbageCollection(
@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 #define FIRESTORE_CORE_SRC_LOCAL_LRU_GARBAGE_COLLECTOR_H_
 
+#include <chrono>  // NOLINT(build/c++11)
+#include <memory>
 #include <unordered_map>
 
 #include "Firestore/core/src/local/reference_delegate.h"
@@ -24,6 +26,7 @@
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/util/status_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -90,6 +93,17 @@ class LruDelegate : public ReferenceDelegate {
   virtual void EnumerateOrphanedDocuments(
       const OrphanedDocumentCallback& callback) = 0;
 
+  /**
+   * Enumerates orphaned documents, resuming after `*cursor` (or from the start
+   * if `*cursor` is empty) and examining at most `max_documents` documents.
+   * On return `*cursor` holds the position to resume from, or is empty once
+   * the enumeration has reached the end.
+   */
+  virtual void EnumerateOrphanedDocuments(
+      const OrphanedDocumentCallback& callback,
+      absl::optional<model::DocumentKey>* cursor,
+      size_t max_documents) = 0;
+
   /**
    * Removes all unreferenced documents from the cache that have a sequence
    * number less than or equal to the given sequence number. Returns the number
@@ -98,6 +112,23 @@ class LruDelegate : public ReferenceDelegate {
   virtual int RemoveOrphanedDocuments(
       model::ListenSequenceNumber sequence_number) = 0;
 
+  /**
+   * Like `RemoveOrphanedDocuments` above, but only examines the documents the
+   * cursor-based `EnumerateOrphanedDocuments` would visit, advancing `*cursor`
+   * the same way.
+   */
+  virtual int RemoveOrphanedDocuments(
+      model::ListenSequenceNumber sequence_number,
+      absl::optional<model::DocumentKey>* cursor,
+      size_t max_documents) = 0;
+
+  /**
+   * Cleans up what the cursor-based `RemoveOrphanedDocuments` left behind,
+   * examining at most `max_entries` entries. Returns true once nothing is
+   * left to clean up.
+   */
+  virtual bool PruneRemovedDocuments(size_t max_entries) = 0;
+
   /**
    * Removes all targets that are not currently being listened to and have a
    * sequence number less than or equal to the given sequence number. Returns
@@ -116,6 +147,8 @@ class LruGarbageCollector {
  public:
   LruGarbageCollector(LruDelegate* delegate, LruParams params);
 
+  ~LruGarbageCollector();
+
   util::StatusOr<int64_t> CalculateByteSize() const;
 
   /**
@@ -147,13 +180,38 @@ class LruGarbageCollector {
 
   local::LruResults Collect(const LiveQueryMap& live_targets);
 
+  /**
+   * Performs one turn of a collection that is spread across several calls,
+   * returning once `time_budget` has been used up. The first turn of a cycle
+   * checks the cache size like `Collect`; later turns resume where the
+   * previous one stopped.
+   *
+   * Returns the results of the cycle from the turn that completes it, and
+   * `LruResults::DidNotRun()` from every other turn.
+   */
+  local::LruResults CollectIncrementally(
+      const LiveQueryMap& live_targets,
+      std::chrono::milliseconds time_budget);
+
+  /** Whether an incremental collection has started but not yet finished. */
+  bool incremental_collection_in_progress() const {
+    return incremental_ != nullptr;
+  }
+
  private:
+  class IncrementalCollection;
+
+  bool ShouldCollect();
+
   LruResults RunGarbageCollection(const LiveQueryMap& live_targets);
 
   // Delegate owns the LruGarbageCollector; this is a back pointer.
   LruDelegate* delegate_;
 
   LruParams params_ = LruParams::Default();
+
+  // State of the incremental collection in progress, if any.
+  std::unique_ptr<IncrementalCollection> incremental_;
 };
 
 }  // namespace local
@@ -95,12 +95,48 @@ absl::optional<model::FieldIndex> MemoryIndexManager::GetFieldIndex(
   return absl::nullopt;
 }
 
+void MemoryIndexManager::CreateTargetIndexes(const core::Target& target) {
+  (void)target;
+}
+
+IndexManager::IndexType MemoryIndexManager::GetIndexType(
+    const core::Target& target) {
+  (void)target;
+  return IndexType::NONE;
+}
+
 absl::optional<std::vector<model::DocumentKey>>
 MemoryIndexManager::GetDocumentsMatchingTarget(const core::Target& target) {
   (void)target;
   return {};
 }
 
+absl::optional<model::FieldIndex> MemoryIndexManager::GetGeoIndex(
+    const std::string& collection_group, const model::FieldPath& field_path) {
+  (void)collection_group;
+  (void)field_path;
+  return absl::nullopt;
+}
+
+std::vector<model::DocumentKey> MemoryIndexManager::GetDocumentsInRegion(
+    const model::FieldIndex& index, const index::GeoRegion& region) {
+  (void)index;
+  (void)region;
+  return {};
+}
+
+model::IndexOffset MemoryIndexManager::GetMinOffset(
+    const core::Target& target) {
+  (void)target;
+  return model::IndexOffset::None();
+}
+
+model::IndexOffset MemoryIndexManager::GetMinOffset(
+    const std::string& collection_group) {
+  (void)collection_group;
+  return model::IndexOffset::None();
+}
+
 absl::optional<std::string>
 MemoryIndexManager::GetNextCollectionGroupToUpdate() {
   return absl::nullopt;
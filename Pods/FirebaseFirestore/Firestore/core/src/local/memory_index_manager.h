@@ -70,9 +70,24 @@ class MemoryIndexManager : public IndexManager {
   absl::optional<model::FieldIndex> GetFieldIndex(
       const core::Target& target) override;
 
+  void CreateTargetIndexes(const core::Target& target) override;
+
+  IndexType GetIndexType(const core::Target& target) override;
+
   absl::optional<std::vector<model::DocumentKey>> GetDocumentsMatchingTarget(
       const core::Target& target) override;
 
+  absl::optional<model::FieldIndex> GetGeoIndex(
+      const std::string& collection_group,
+      const model::FieldPath& field_path) override;
+
+  std::vector<model::DocumentKey> GetDocumentsInRegion(
+      const model::FieldIndex& index, const index::GeoRegion& region) override;
+
+  model::IndexOffset GetMinOffset(const core::Target& target) override;
+
+  model::IndexOffset GetMinOffset(const std::string& collection_group) override;
+
   absl::optional<std::string> GetNextCollectionGroupToUpdate() override;
 
   void UpdateCollectionGroup(const std::string& collection_group,
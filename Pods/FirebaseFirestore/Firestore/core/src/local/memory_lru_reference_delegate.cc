@@ -104,6 +104,14 @@ void MemoryLruReferenceDelegate::EnumerateOrphanedDocuments(
   }
 }
 
+void MemoryLruReferenceDelegate::EnumerateOrphanedDocuments(
+    const OrphanedDocumentCallback& callback,
+    absl::optional<DocumentKey>* cursor,
+    size_t) {
+  EnumerateOrphanedDocuments(callback);
+  cursor->reset();
+}
+
 size_t MemoryLruReferenceDelegate::GetSequenceNumberCount() {
   size_t total_count = persistence_->target_cache()->size();
   EnumerateOrphanedDocuments(
@@ -131,6 +139,14 @@ int MemoryLruReferenceDelegate::RemoveOrphanedDocuments(
   return static_cast<int>(removed.size());
 }
 
+int MemoryLruReferenceDelegate::RemoveOrphanedDocuments(
+    model::ListenSequenceNumber upper_bound,
+    absl::optional<DocumentKey>* cursor,
+    size_t) {
+  cursor->reset();
+  return RemoveOrphanedDocuments(upper_bound);
+}
+
 void MemoryLruReferenceDelegate::AddReference(const DocumentKey& key) {
   sequence_numbers_[key] = current_sequence_number_;
 }
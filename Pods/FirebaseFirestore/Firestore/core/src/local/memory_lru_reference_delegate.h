@@ -73,7 +73,26 @@ class MemoryLruReferenceDelegate : public LruDelegate {
   void EnumerateOrphanedDocuments(
       const OrphanedDocumentCallback& callback) override;
 
+  /**
+   * Sequence numbers are kept in an unordered map here, so there is no stable
+   * position to resume from: the memory delegate always completes the
+   * enumeration in one call and leaves `*cursor` empty.
+   */
+  void EnumerateOrphanedDocuments(const OrphanedDocumentCallback& callback,
+                                  absl::optional<model::DocumentKey>* cursor,
+                                  size_t max_documents) override;
+
   int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound) override;
+
+  /** Like the cursor-based enumeration, always completes in one call. */
+  int RemoveOrphanedDocuments(model::ListenSequenceNumber upper_bound,
+                              absl::optional<model::DocumentKey>* cursor,
+                              size_t max_documents) override;
+
+  /** Removing a document leaves nothing behind in memory. */
+  bool PruneRemovedDocuments(size_t /* max_entries */) override {
+    return true;
+  }
   int RemoveTargets(model::ListenSequenceNumber sequence_number,
                     const LiveQueryMap& live_queries) override;
 
@@ -128,6 +128,14 @@ void MemoryMutationQueue::RemoveMutationBatch(const MutationBatch& batch) {
   }
 }
 
+DocumentKeySet MemoryMutationQueue::AllMutatedDocumentKeys() {
+  DocumentKeySet result;
+  for (const auto& reference : batches_by_document_key_) {
+    result = result.insert(reference.key());
+  }
+  return result;
+}
+
 std::vector<MutationBatch>
 MemoryMutationQueue::AllMutationBatchesAffectingDocumentKeys(
     const DocumentKeySet& document_keys) {
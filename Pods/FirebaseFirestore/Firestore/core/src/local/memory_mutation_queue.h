@@ -62,6 +62,8 @@ class MemoryMutationQueue : public MutationQueue {
     return queue_;
   }
 
+  model::DocumentKeySet AllMutatedDocumentKeys() override;
+
   std::vector<model::MutationBatch> AllMutationBatchesAffectingDocumentKeys(
       const model::DocumentKeySet& document_keys) override;
 
@@ -16,9 +16,14 @@
 
 #include "Firestore/core/src/local/memory_remote_document_cache.h"
 
+#include <algorithm>
+#include <string>
+#include <vector>
+
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/memory_lru_reference_delegate.h"
 #include "Firestore/core/src/local/memory_persistence.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/local/sizer.h"
 #include "Firestore/core/src/model/document.h"
 #include "Firestore/core/src/util/hard_assert.h"
@@ -76,6 +81,29 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
 
 MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
     const model::ResourcePath& path, const model::IndexOffset& offset) {
+  return GetAllMatching(
+      path, offset, [](const MutableDocument&) { return true; }, nullptr);
+}
+
+MutableDocumentMap MemoryRemoteDocumentCache::GetDocumentsMatchingQuery(
+    const core::Query& query,
+    const model::IndexOffset& offset,
+    const model::OverlayByDocumentKeyMap& mutated_docs,
+    QueryContext& context) {
+  return GetAllMatching(
+      query.path(), offset,
+      [&](const MutableDocument& document) {
+        return mutated_docs.find(document.key()) != mutated_docs.end() ||
+               query.Matches(document);
+      },
+      &context);
+}
+
+MutableDocumentMap MemoryRemoteDocumentCache::GetAllMatching(
+    const model::ResourcePath& path,
+    const model::IndexOffset& offset,
+    const std::function<bool(const MutableDocument&)>& filter,
+    QueryContext* context) {
   MutableDocumentMap results;
 
   // Documents are ordered by key, so we can use a prefix scan to narrow down
@@ -99,6 +127,13 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
       continue;
     }
 
+    if (context) {
+      context->IncrementDocumentReadCount(1);
+    }
+    if (!filter(document)) {
+      continue;
+    }
+
     // Note: We create an explicit copy to prevent modifications on the backing
     // data.
     results = results.insert(key, document.Clone());
@@ -106,6 +141,41 @@ MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
   return results;
 }
 
+MutableDocumentMap MemoryRemoteDocumentCache::GetAll(
+    const std::string& collection_group,
+    const model::IndexOffset& offset,
+    size_t limit) {
+  std::vector<const MutableDocument*> matches;
+  for (const auto& kv : docs_) {
+    const MutableDocument& document = kv.second;
+    if (kv.first.GetCollectionGroup() != collection_group) {
+      continue;
+    }
+
+    if (model::IndexOffset::FromDocument(document).CompareTo(offset) !=
+        util::ComparisonResult::Descending) {
+      // The document sorts before the offset.
+      continue;
+    }
+
+    matches.push_back(&document);
+  }
+
+  std::sort(matches.begin(), matches.end(),
+            [](const MutableDocument* lhs, const MutableDocument* rhs) {
+              return model::IndexOffset::DocumentCompare(*lhs, *rhs) ==
+                     util::ComparisonResult::Ascending;
+            });
+
+  MutableDocumentMap results;
+  for (size_t i = 0; i < matches.size() && i < limit; ++i) {
+    // Note: We create an explicit copy to prevent modifications on the backing
+    // data.
+    results = results.insert(matches[i]->key(), matches[i]->Clone());
+  }
+  return results;
+}
+
 std::vector<DocumentKey> MemoryRemoteDocumentCache::RemoveOrphanedDocuments(
     MemoryLruReferenceDelegate* reference_delegate,
     ListenSequenceNumber upper_bound) {
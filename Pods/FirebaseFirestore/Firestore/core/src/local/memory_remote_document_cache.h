@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_MEMORY_REMOTE_DOCUMENT_CACHE_H_
 
+#include <functional>
+#include <string>
 #include <utility>
 #include <vector>
 
@@ -48,6 +50,14 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
   model::MutableDocumentMap GetAll(const model::DocumentKeySet& keys) override;
   model::MutableDocumentMap GetAll(const model::ResourcePath& path,
                                    const model::IndexOffset& offset) override;
+  model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext& context) override;
+  model::MutableDocumentMap GetAll(const std::string& collection_group,
+                                   const model::IndexOffset& offset,
+                                   size_t limit) override;
   void SetIndexManager(IndexManager* manager) override;
 
   std::vector<model::DocumentKey> RemoveOrphanedDocuments(
@@ -57,6 +67,16 @@ class MemoryRemoteDocumentCache : public RemoteDocumentCache {
   int64_t CalculateByteSize(const Sizer& sizer);
 
  private:
+  /**
+   * Returns copies of the documents in the collection at `path` that sort
+   * after `offset` and satisfy `filter`.
+   */
+  model::MutableDocumentMap GetAllMatching(
+      const model::ResourcePath& path,
+      const model::IndexOffset& offset,
+      const std::function<bool(const model::MutableDocument&)>& filter,
+      QueryContext* context);
+
   /** Underlying cache of documents and their read times. */
   immutable::SortedMap<model::DocumentKey, model::MutableDocument> docs_;
 
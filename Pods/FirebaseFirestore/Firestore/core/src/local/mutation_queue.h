@@ -80,10 +80,14 @@ class MutationQueue {
   virtual void RemoveMutationBatch(const model::MutationBatch& batch) = 0;
 
   /** Gets all mutation batches in the mutation queue. */
-  // TODO(mikelehen): PERF: Current consumer only needs mutated keys; if we can
-  // provide that cheaply, we should replace this.
   virtual std::vector<model::MutationBatch> AllMutationBatches() = 0;
 
+  /**
+   * Returns the keys of all documents mutated by batches in the queue, without
+   * loading the batches themselves.
+   */
+  virtual model::DocumentKeySet AllMutatedDocumentKeys() = 0;
+
   /**
    * Finds all mutation batches that could @em possibly affect the given
    * document keys. Not all mutations in a batch will necessarily affect each
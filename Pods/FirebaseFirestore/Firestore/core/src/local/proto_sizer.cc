@@ -39,7 +39,7 @@ int64_t ProtoSizer::CalculateByteSize(const MutableDocument& maybe_doc) const {
   // calculates sizes without actually doing the encoding (to the extent
   // possible). This isn't high priority as long as `ProtoSizer` is only used in
   // tests.
-  return MakeByteString(serializer_.EncodeMaybeDocument(maybe_doc)).size();
+  return serializer_.EncodeMaybeDocumentBytes(maybe_doc).size();
 }
 
 int64_t ProtoSizer::CalculateByteSize(const model::MutationBatch& batch) const {
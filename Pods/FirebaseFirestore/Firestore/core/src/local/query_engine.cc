@@ -16,35 +16,122 @@
 
 #include "Firestore/core/src/local/query_engine.h"
 
+#include <algorithm>
+#include <limits>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/core/target.h"
+#include "Firestore/core/src/index/geo_cell.h"
+#include "Firestore/core/src/local/index_manager.h"
 #include "Firestore/core/src/local/local_documents_view.h"
+#include "Firestore/core/src/local/query_context.h"
 #include "Firestore/core/src/model/document.h"
+#include "Firestore/core/src/model/document_key.h"
 #include "Firestore/core/src/model/document_set.h"
+#include "Firestore/core/src/model/field_index.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/snapshot_version.h"
+#include "Firestore/core/src/model/target_index_matcher.h"
+#include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
 
 namespace firebase {
 namespace firestore {
 namespace local {
+namespace {
+
+/**
+ * The number of documents a full collection scan needs to read before the
+ * query is considered for index auto creation. Scanning small collections is
+ * cheaper than maintaining an index for them.
+ */
+const size_t kIndexAutoCreationMinCollectionSize = 100;
+
+/**
+ * The cost of reading a document through an index relative to reading it in
+ * a full collection scan. An index is only created if the scan read more than
+ * this many documents per matching document.
+ */
+const size_t kRelativeIndexReadCostPerDocument = 2;
+
+/**
+ * The number of expensive scans of the same query shape that are needed
+ * before an index is created, so that one-off queries don't create indexes.
+ */
+const int kIndexAutoCreationMinScanCount = 3;
+
+std::string QueryShapeKey(const model::FieldIndex& index) {
+  std::string key = index.collection_group();
+  for (const model::Segment& segment : index.segments()) {
+    key += '|';
+    key += segment.field_path().CanonicalString();
+    key += ':';
+    key += std::to_string(static_cast<int>(segment.kind()));
+  }
+  return key;
+}
+
+}  // namespace
 
 using core::LimitType;
 using core::Query;
+using core::Target;
 using model::Document;
+using model::DocumentKey;
 using model::DocumentKeySet;
 using model::DocumentMap;
 using model::DocumentSet;
+using model::IndexOffset;
 using model::MutableDocument;
 using model::SnapshotVersion;
+using util::MetricCounter;
+using util::MetricHistogram;
+using util::ScopedLatency;
+
+const char* QueryPlanName(QueryPlan plan) {
+  switch (plan) {
+    case QueryPlan::kIndexScan:
+      return "index scan";
+    case QueryPlan::kPreviousResults:
+      return "previous results";
+    case QueryPlan::kFullCollectionScan:
+      return "full collection scan";
+  }
+  UNREACHABLE();
+}
+
+void QueryEngine::SetLocalDocumentsView(LocalDocumentsView* local_documents) {
+  local_documents_view_ = local_documents;
+  index_manager_ = local_documents->index_manager();
+}
 
 DocumentMap QueryEngine::GetDocumentsMatchingQuery(
     const Query& query,
     const SnapshotVersion& last_limbo_free_snapshot_version,
     const DocumentKeySet& remote_keys) {
   HARD_ASSERT(local_documents_view_, "SetLocalDocumentsView() not called");
+  if (!metrics_) {
+    return ExecuteQuery(query, last_limbo_free_snapshot_version, remote_keys);
+  }
+
+  documents_scanned_ = 0;
+  DocumentMap results;
+  {
+    ScopedLatency latency{metrics_, MetricHistogram::kQueryExecutionMicros};
+    results =
+        ExecuteQuery(query, last_limbo_free_snapshot_version, remote_keys);
+  }
+  RecordQueryMetrics(results);
+  return results;
+}
+
+DocumentMap QueryEngine::ExecuteQuery(
+    const Query& query,
+    const SnapshotVersion& last_limbo_free_snapshot_version,
+    const DocumentKeySet& remote_keys) {
 
   // Queries that match all documents don't benefit from using key-based
   // lookups. It is more efficient to scan all documents in a collection, rather
@@ -53,19 +140,277 @@ DocumentMap QueryEngine::GetDocumentsMatchingQuery(
     return ExecuteFullCollectionScan(query);
   }
 
-  // Queries that have never seen a snapshot without limbo free documents should
-  // also be run as a full collection scan.
-  if (last_limbo_free_snapshot_version == SnapshotVersion::None()) {
-    return ExecuteFullCollectionScan(query);
+  // Queries that have never seen a snapshot without limbo free documents
+  // cannot re-use their previous results.
+  bool has_previous_results =
+      last_limbo_free_snapshot_version != SnapshotVersion::None();
+
+  // Reading index entries only touches LevelDB keys, so it is cheap to find
+  // out how many documents an index scan would read before deciding on a
+  // plan. Both the index and the previous results are then resolved through
+  // key lookups, so the plan that reads fewer documents wins.
+  absl::optional<DocumentKeySet> indexed_keys = GetKeysFromIndex(query);
+  if (indexed_keys &&
+      (!has_previous_results || indexed_keys->size() <= remote_keys.size())) {
+    absl::optional<DocumentMap> result =
+        PerformQueryUsingIndex(query, *indexed_keys);
+    if (result) {
+      last_query_plan_ = QueryPlan::kIndexScan;
+      return *std::move(result);
+    }
+  }
+
+  if (has_previous_results) {
+    absl::optional<DocumentMap> result = PerformQueryUsingRemoteKeys(
+        query, remote_keys, last_limbo_free_snapshot_version);
+    if (result) {
+      last_query_plan_ = QueryPlan::kPreviousResults;
+      return *std::move(result);
+    }
   }
 
+  return ExecuteFullCollectionScan(query);
+}
+
+size_t QueryEngine::CountDocumentsMatchingQuery(
+    const Query& query,
+    const SnapshotVersion& last_limbo_free_snapshot_version,
+    const DocumentKeySet& remote_keys) {
+  HARD_ASSERT(local_documents_view_, "SetLocalDocumentsView() not called");
+  size_t limit = query.limit_type() == LimitType::None
+                     ? std::numeric_limits<size_t>::max()
+                     : static_cast<size_t>(query.limit());
+  absl::optional<size_t> count = CountUsingIndex(query);
+  if (count) {
+    last_query_plan_ = QueryPlan::kIndexScan;
+    return std::min(*count, limit);
+  }
+
+  return GetDocumentsMatchingQuery(query, last_limbo_free_snapshot_version,
+                                   remote_keys)
+      .size();
+}
+
+DocumentMap QueryEngine::GetDocumentsInRegion(
+    const Query& query,
+    const model::FieldPath& field_path,
+    const index::GeoRegion& region) {
+  HARD_ASSERT(local_documents_view_, "SetLocalDocumentsView() not called");
+
+  auto in_region = [&](const Document& doc) {
+    if (!doc->is_found_document() || !query.Matches(doc)) {
+      return false;
+    }
+    absl::optional<google_firestore_v1_Value> value = doc->field(field_path);
+    absl::optional<GeoPoint> point =
+        value ? index::GeoPointValue(*value) : absl::nullopt;
+    return point.has_value() && region.Contains(*point);
+  };
+
+  absl::optional<model::FieldIndex> index;
+  if (index_manager_ && !query.IsDocumentQuery()) {
+    std::string collection_group = query.IsCollectionGroupQuery()
+                                       ? *query.collection_group()
+                                       : query.path().last_segment();
+    index = index_manager_->GetGeoIndex(collection_group, field_path);
+    if (!index) {
+      LOG_DEBUG("Creating geo index on %s for collection group %s",
+                field_path.CanonicalString(), collection_group);
+      index_manager_->AddFieldIndex(model::FieldIndex(
+          model::FieldIndex::UnknownId(), collection_group,
+          {model::Segment(field_path, model::Segment::kGeo)},
+          model::FieldIndex::InitialState()));
+    }
+  }
+
+  IndexOffset offset = IndexOffset::None();
+  DocumentMap results;
+  if (index && index->index_state().index_offset() != IndexOffset::None()) {
+    offset = index->index_state().index_offset();
+    DocumentKeySet indexed_keys;
+    for (const DocumentKey& key :
+         index_manager_->GetDocumentsInRegion(*index, region)) {
+      indexed_keys = indexed_keys.insert(key);
+    }
+
+    // Indexed documents are re-checked, as they may have moved since their
+    // entries were written.
+    DocumentMap indexed_documents =
+        local_documents_view_->GetDocuments(indexed_keys);
+    documents_scanned_ += indexed_documents.size();
+    for (const auto& entry : indexed_documents) {
+      if (in_region(entry.second)) {
+        results = results.insert(entry.first, entry.second);
+      }
+    }
+  }
+
+  // Documents that changed after the index offset may have no entries at all.
+  QueryContext context;
+  DocumentMap remaining =
+      local_documents_view_->GetDocumentsMatchingQuery(query, offset, context);
+  documents_scanned_ += context.document_read_count();
+  for (const auto& entry : remaining) {
+    if (in_region(entry.second)) {
+      results = results.insert(entry.first, entry.second);
+    }
+  }
+
+  LOG_DEBUG("Found %s documents in region for query %s using %s",
+            results.size(), query.ToString(),
+            offset == IndexOffset::None() ? "a scan" : "the geo index");
+  return results;
+}
+
+void QueryEngine::RecordQueryMetrics(const DocumentMap& results) const {
+  metrics_->Increment(MetricCounter::kQueriesExecuted);
+  switch (last_query_plan_) {
+    case QueryPlan::kIndexScan:
+      metrics_->Increment(MetricCounter::kQueryPlanIndexScan);
+      break;
+    case QueryPlan::kPreviousResults:
+      metrics_->Increment(MetricCounter::kQueryPlanPreviousResults);
+      break;
+    case QueryPlan::kFullCollectionScan:
+      metrics_->Increment(MetricCounter::kQueryPlanFullCollectionScan);
+      break;
+  }
+  metrics_->Increment(MetricCounter::kDocumentsScanned, documents_scanned_);
+  metrics_->Increment(MetricCounter::kDocumentsReturned, results.size());
+}
+
+absl::optional<DocumentKeySet> QueryEngine::GetKeysFromIndex(
+    const Query& query) {
+  if (!index_manager_) {
+    return absl::nullopt;
+  }
+
+  const Target& target = query.ToTarget();
+  IndexManager::IndexType index_type = index_manager_->GetIndexType(target);
+  if (index_type == IndexManager::IndexType::NONE) {
+    return absl::nullopt;
+  }
+
+  // An index that was never backfilled has no entries, and all documents
+  // would have to be read as "remaining results" anyway.
+  if (index_manager_->GetMinOffset(target) == IndexOffset::None()) {
+    return absl::nullopt;
+  }
+
+  if (query.limit_type() != LimitType::None &&
+      index_type == IndexManager::IndexType::PARTIAL) {
+    // We cannot apply a limit for targets that are served using a partial
+    // index. If a partial index will be used to serve the target, the query
+    // may return a superset of documents that match the target (e.g. if the
+    // index doesn't include all the target's filters), or may return the
+    // correct set of documents in the wrong order (e.g. if the index doesn't
+    // include a segment for one of the orderBys). Therefore, a limit should
+    // not be applied in such cases.
+    return GetKeysFromIndex(query.WithLimitToFirst(Target::kNoLimit));
+  }
+
+  absl::optional<std::vector<DocumentKey>> keys =
+      index_manager_->GetDocumentsMatchingTarget(target);
+  if (!keys) {
+    return absl::nullopt;
+  }
+
+  DocumentKeySet result;
+  for (const DocumentKey& key : *keys) {
+    result = result.insert(key);
+  }
+  return result;
+}
+
+absl::optional<size_t> QueryEngine::CountUsingIndex(const Query& query) {
+  // Collection group queries span several collections, whose changes since
+  // the index offset can't be read with a single scan.
+  if (!index_manager_ || query.IsDocumentQuery() ||
+      query.IsCollectionGroupQuery()) {
+    return absl::nullopt;
+  }
+
+  // Only a FULL index evaluates every filter of the query, so its entries
+  // can be counted without re-applying the query to the documents.
+  Query unlimited_query = query.WithLimitToFirst(Target::kNoLimit);
+  const Target& target = unlimited_query.ToTarget();
+  if (index_manager_->GetIndexType(target) != IndexManager::IndexType::FULL) {
+    return absl::nullopt;
+  }
+  absl::optional<DocumentKeySet> indexed_keys =
+      GetKeysFromIndex(unlimited_query);
+  if (!indexed_keys) {
+    return absl::nullopt;
+  }
+
+  // Documents that changed after the index was last updated may have stale
+  // entries (or none at all), so they are decided by their local view.
+  DocumentMap changed = local_documents_view_->GetDocumentsChangedSince(
+      query.path(), index_manager_->GetMinOffset(target));
+  documents_scanned_ += changed.size();
+
+  size_t count = 0;
+  for (const DocumentKey& key : *indexed_keys) {
+    if (changed.find(key) == changed.end()) {
+      ++count;
+    }
+  }
+  for (const auto& entry : changed) {
+    const Document& doc = entry.second;
+    if (doc->is_found_document() && query.Matches(doc)) {
+      ++count;
+    }
+  }
+
+  LOG_DEBUG("Counted %s documents for query %s from %s index matches",
+            count, query.ToString(), indexed_keys->size());
+  return count;
+}
+
+absl::optional<DocumentMap> QueryEngine::PerformQueryUsingIndex(
+    const Query& query, const DocumentKeySet& indexed_keys) {
+  const Target& target = query.ToTarget();
+  DocumentMap indexed_documents =
+      local_documents_view_->GetDocuments(indexed_keys);
+  documents_scanned_ += indexed_documents.size();
+  IndexOffset offset = index_manager_->GetMinOffset(target);
+
+  DocumentSet previous_results = ApplyQuery(query, indexed_documents);
+  if (query.limit_type() != LimitType::None &&
+      NeedsRefill(query.limit_type(), previous_results, indexed_keys,
+                  offset.read_time())) {
+    // A limit query whose boundaries change due to local edits can be re-run
+    // against the cache by excluding the limit. This ensures that all
+    // documents that match the query's filters are included in the result
+    // set. The SDK can then apply the limit once all local edits are
+    // incorporated.
+    Query unlimited_query = query.WithLimitToFirst(Target::kNoLimit);
+    absl::optional<DocumentKeySet> unlimited_keys =
+        GetKeysFromIndex(unlimited_query);
+    if (!unlimited_keys) {
+      return absl::nullopt;
+    }
+    return PerformQueryUsingIndex(unlimited_query, *unlimited_keys);
+  }
+
+  LOG_DEBUG("Using index to execute query %s (%s index matches)",
+            query.ToString(), indexed_keys.size());
+
+  return AppendRemainingResults(previous_results, query, offset);
+}
+
+absl::optional<DocumentMap> QueryEngine::PerformQueryUsingRemoteKeys(
+    const Query& query,
+    const DocumentKeySet& remote_keys,
+    const SnapshotVersion& last_limbo_free_snapshot_version) {
   DocumentMap documents = local_documents_view_->GetDocuments(remote_keys);
+  documents_scanned_ += documents.size();
   DocumentSet previous_results = ApplyQuery(query, documents);
 
   if (query.limit_type() != LimitType::None &&
       NeedsRefill(query.limit_type(), previous_results, remote_keys,
                   last_limbo_free_snapshot_version)) {
-    return ExecuteFullCollectionScan(query);
+    return absl::nullopt;
   }
 
   LOG_DEBUG("Re-using previous result from %s to execute query: %s",
@@ -73,18 +418,29 @@ DocumentMap QueryEngine::GetDocumentsMatchingQuery(
 
   // Retrieve all results for documents that were updated since the last
   // remote snapshot that did not contain any Limbo documents.
-  DocumentMap updated_results =
-      local_documents_view_->GetDocumentsMatchingQuery(
-          query, model::IndexOffset::Create(last_limbo_free_snapshot_version));
+  return AppendRemainingResults(
+      previous_results, query,
+      IndexOffset::Create(last_limbo_free_snapshot_version));
+}
+
+DocumentMap QueryEngine::AppendRemainingResults(
+    const DocumentSet& indexed_results,
+    const Query& query,
+    const IndexOffset& offset) {
+  // Retrieve all results for documents that were updated since the offset.
+  QueryContext context;
+  DocumentMap remaining_results =
+      local_documents_view_->GetDocumentsMatchingQuery(query, offset, context);
+  documents_scanned_ += context.document_read_count();
 
-  // We merge `previous_results` into `update_results`, since `update_results`
-  // is already a DocumentMap. If a document is contained in both lists, then
-  // its contents are the same.
-  for (const Document& result : previous_results) {
-    updated_results = updated_results.insert(result->key(), result);
+  // We merge `indexed_results` into `remaining_results`, since
+  // `remaining_results` is already a DocumentMap. If a document is contained in
+  // both lists, then its contents are the same.
+  for (const Document& result : indexed_results) {
+    remaining_results = remaining_results.insert(result->key(), result);
   }
 
-  return updated_results;
+  return remaining_results;
 }
 
 DocumentSet QueryEngine::ApplyQuery(const Query& query,
@@ -136,10 +492,50 @@ bool QueryEngine::NeedsRefill(
 }
 
 DocumentMap QueryEngine::ExecuteFullCollectionScan(const Query& query) {
+  last_query_plan_ = QueryPlan::kFullCollectionScan;
   LOG_DEBUG("Using full collection scan to execute query: %s",
             query.ToString());
-  return local_documents_view_->GetDocumentsMatchingQuery(
-      query, model::IndexOffset::None());
+  QueryContext context;
+  DocumentMap results = local_documents_view_->GetDocumentsMatchingQuery(
+      query, model::IndexOffset::None(), context);
+  documents_scanned_ += context.document_read_count();
+  if (index_auto_creation_enabled_) {
+    CreateCacheIndexes(query, context, results.size());
+  }
+  return results;
+}
+
+void QueryEngine::CreateCacheIndexes(const Query& query,
+                                     const QueryContext& context,
+                                     size_t result_size) {
+  if (!index_manager_ || query.IsDocumentQuery()) {
+    return;
+  }
+
+  size_t read_count = context.document_read_count();
+  if (read_count < kIndexAutoCreationMinCollectionSize ||
+      read_count <= kRelativeIndexReadCostPerDocument * result_size) {
+    return;
+  }
+
+  const Target& target = query.ToTarget();
+  model::FieldIndex index = model::TargetIndexMatcher(target).BuildTargetIndex();
+  if (index.segments().empty()) {
+    return;
+  }
+
+  std::string shape = QueryShapeKey(index);
+  int scan_count = ++query_shape_scan_counts_[shape];
+  if (scan_count < kIndexAutoCreationMinScanCount) {
+    return;
+  }
+
+  query_shape_scan_counts_.erase(shape);
+  LOG_DEBUG(
+      "Query %s scanned %s documents to return %s results. Creating a "
+      "client-side index.",
+      query.ToString(), read_count, result_size);
+  index_manager_->CreateTargetIndexes(target);
 }
 
 }  // namespace local
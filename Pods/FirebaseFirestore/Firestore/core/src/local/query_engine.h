@@ -17,7 +17,11 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_QUERY_ENGINE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_QUERY_ENGINE_H_
 
+#include <string>
+#include <unordered_map>
+
 #include "Firestore/core/src/model/model_fwd.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -27,15 +31,44 @@ class Query;
 enum class LimitType;
 }  // namespace core
 
+namespace index {
+class GeoRegion;
+}  // namespace index
+
+namespace util {
+class Metrics;
+}  // namespace util
+
 namespace local {
 
+class IndexManager;
 class LocalDocumentsView;
+class QueryContext;
+
+/** The strategy the QueryEngine picked to execute a query. */
+enum class QueryPlan {
+  /** The query was served from a persisted field index. */
+  kIndexScan,
+  /** The query re-used the documents that matched its previous snapshot. */
+  kPreviousResults,
+  /** The query read every document of the queried collection. */
+  kFullCollectionScan,
+};
+
+/** Returns a human-readable name of `plan`, for logging. */
+const char* QueryPlanName(QueryPlan plan);
 
 /**
- * A query engine that takes advantage of the target document mapping in the
- * TargetCache. Query execution is optimizes by only reading the documents that
- * previously matched a query plus any documents that were edited after the
- * query was last listened to.
+ * A query engine that takes advantage of the field indexes of the
+ * IndexManager and of the target document mapping in the TargetCache. Query
+ * execution is optimized by only reading the documents that match an index
+ * range or that previously matched a query, plus any documents that were
+ * edited after the index or the query was last updated.
+ *
+ * When both an index and the previous query results can serve a query, the
+ * engine picks the plan that reads fewer documents: reading index entries
+ * only touches keys, so the number of index matches is compared against the
+ * number of previously matching documents before any document is decoded.
  *
  * There are some cases where Index-Free queries are not guaranteed to
  * produce the same results as full collection scans. In these cases, the
@@ -46,6 +79,12 @@ class LocalDocumentsView;
  * - Limit queries where a document edit may cause the document to sort below
  *   another document that is in the local cache.
  * - Queries that have never been CURRENT or free of limbo documents.
+ *
+ * If index auto creation is enabled, the engine also observes the shape of
+ * queries that fall back to full collection scans. Once a shape was seen
+ * repeatedly on a large collection and most of the scanned documents did not
+ * match, a client-side index is created for it. The index is populated by the
+ * IndexBackfiller and used once it has caught up with the cache.
  */
 class QueryEngine {
  public:
@@ -57,9 +96,7 @@ class QueryEngine {
    * The caller owns the LocalDocumentView and must ensure that it outlives the
    * QueryEngine.
    */
-  virtual void SetLocalDocumentsView(LocalDocumentsView* local_documents) {
-    local_documents_view_ = local_documents;
-  }
+  virtual void SetLocalDocumentsView(LocalDocumentsView* local_documents);
 
   /** Returns all local documents matching the specified query. */
   model::DocumentMap GetDocumentsMatchingQuery(
@@ -67,7 +104,105 @@ class QueryEngine {
       const model::SnapshotVersion& last_limbo_free_snapshot_version,
       const model::DocumentKeySet& remote_keys);
 
+  /**
+   * Returns the number of local documents matching the specified query.
+   *
+   * If a fully backfilled field index serves the query, only the index
+   * entries are read, along with the documents that changed after the index
+   * was last updated. Otherwise the matching documents are read as in
+   * `GetDocumentsMatchingQuery`.
+   */
+  size_t CountDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version,
+      const model::DocumentKeySet& remote_keys);
+
+  /**
+   * Returns the local documents matching the filters of `query` whose
+   * GeoPoint value at `field_path` lies within `region`. The limit of the
+   * query is not applied.
+   *
+   * Once the geo index over the field is backfilled, only its entries within
+   * the region are read, along with the documents that changed after the
+   * index was last updated. Until then the matching documents are scanned,
+   * and the first lookup on a field creates its geo index.
+   */
+  model::DocumentMap GetDocumentsInRegion(const core::Query& query,
+                                          const model::FieldPath& field_path,
+                                          const index::GeoRegion& region);
+
+  /**
+   * Enables or disables the automatic creation of client-side indexes for
+   * query shapes that repeatedly require expensive full collection scans.
+   */
+  void SetIndexAutoCreationEnabled(bool enabled) {
+    index_auto_creation_enabled_ = enabled;
+  }
+
+  /** Returns the plan used by the last call to `GetDocumentsMatchingQuery`. */
+  QueryPlan last_query_plan() const {
+    return last_query_plan_;
+  }
+
+  /**
+   * Records the latency, plan and document counts of each query into the
+   * given metrics, which must outlive the QueryEngine. Null disables this.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+  }
+
  private:
+  model::DocumentMap ExecuteQuery(
+      const core::Query& query,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version,
+      const model::DocumentKeySet& remote_keys);
+
+  void RecordQueryMetrics(const model::DocumentMap& results) const;
+
+  /**
+   * Returns the document keys matching `query` based on the persisted field
+   * indexes, or `nullopt` if no index can serve the query or if the index has
+   * not been backfilled yet (in which case using it would still require a
+   * full collection scan).
+   */
+  absl::optional<model::DocumentKeySet> GetKeysFromIndex(
+      const core::Query& query);
+
+  /**
+   * Counts the documents matching `query`, ignoring its limit, from the keys
+   * of a FULL field index, or returns `nullopt` if no such index can serve
+   * the query. Only documents that changed after the index offset are read.
+   */
+  absl::optional<size_t> CountUsingIndex(const core::Query& query);
+
+  /**
+   * Performs an indexed query that evaluates the query based on the keys
+   * returned by `GetKeysFromIndex` and supplements the results with documents
+   * that were updated after the index was last written to. Limit queries
+   * whose boundaries changed are re-run without their limit.
+   */
+  absl::optional<model::DocumentMap> PerformQueryUsingIndex(
+      const core::Query& query, const model::DocumentKeySet& indexed_keys);
+
+  /**
+   * Performs a query based on the target's persisted query mapping. Returns
+   * `nullopt` if the mapping is not available or cannot be used.
+   */
+  absl::optional<model::DocumentMap> PerformQueryUsingRemoteKeys(
+      const core::Query& query,
+      const model::DocumentKeySet& remote_keys,
+      const model::SnapshotVersion& last_limbo_free_snapshot_version);
+
+  /**
+   * Combines the results from an indexed execution with the remaining
+   * documents that have not yet been indexed.
+   */
+  model::DocumentMap AppendRemainingResults(
+      const model::DocumentSet& indexed_results,
+      const core::Query& query,
+      const model::IndexOffset& offset);
+
   /** Applies the query filter and sorting to the provided documents. */
   model::DocumentSet ApplyQuery(const core::Query& query,
                                 const model::DocumentMap& documents) const;
@@ -92,7 +227,31 @@ class QueryEngine {
 
   model::DocumentMap ExecuteFullCollectionScan(const core::Query& query);
 
+  /**
+   * Creates a client-side index for `query` if the full collection scan
+   * recorded in `context` was expensive compared to the `result_size`
+   * matching documents, and if the query's shape was seen often enough.
+   */
+  void CreateCacheIndexes(const core::Query& query,
+                          const QueryContext& context,
+                          size_t result_size);
+
   LocalDocumentsView* local_documents_view_ = nullptr;
+  IndexManager* index_manager_ = nullptr;
+  QueryPlan last_query_plan_ = QueryPlan::kFullCollectionScan;
+
+  util::Metrics* metrics_ = nullptr;
+
+  /** The documents read by the query being executed, for metrics. */
+  size_t documents_scanned_ = 0;
+
+  bool index_auto_creation_enabled_ = false;
+
+  /**
+   * The number of expensive full collection scans observed per query shape
+   * (collection group and index segments) that did not lead to an index yet.
+   */
+  std::unordered_map<std::string, int> query_shape_scan_counts_;
 };
 
 }  // namespace local
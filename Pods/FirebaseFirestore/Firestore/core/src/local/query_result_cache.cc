@@ -0,0 +1,124 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/local/query_result_cache.h"
+
+#include <iterator>
+
+#include "Firestore/core/src/core/target.h"
+#include "Firestore/core/src/model/document_key_set.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+using core::Query;
+using core::Target;
+using model::DocumentKey;
+using model::DocumentKeySet;
+using model::ResourcePath;
+
+void QueryResultCache::set_max_entries(size_t max_entries) {
+  max_entries_ = max_entries;
+  while (entries_.size() > max_entries_) {
+    Erase(std::prev(entries_.end()));
+  }
+}
+
+absl::optional<QueryResult> QueryResultCache::Get(const Query& query) {
+  if (!enabled()) {
+    return absl::nullopt;
+  }
+
+  auto found = index_.find(query.CanonicalId());
+  if (found == index_.end()) {
+    ++miss_count_;
+    return absl::nullopt;
+  }
+
+  ++hit_count_;
+  entries_.splice(entries_.begin(), entries_, found->second);
+  return found->second->result;
+}
+
+void QueryResultCache::Put(const Query& query, const QueryResult& result) {
+  if (!enabled()) {
+    return;
+  }
+
+  std::string canonical_id = query.CanonicalId();
+  auto found = index_.find(canonical_id);
+  if (found != index_.end()) {
+    Erase(found->second);
+  }
+
+  while (entries_.size() >= max_entries_) {
+    Erase(std::prev(entries_.end()));
+  }
+  entries_.push_front(Entry{canonical_id, query, result});
+  index_.emplace(std::move(canonical_id), entries_.begin());
+}
+
+void QueryResultCache::InvalidateDocument(const DocumentKey& key) {
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    auto current = entry++;
+    if (MayContain(current->query, key)) {
+      Erase(current);
+    }
+  }
+}
+
+void QueryResultCache::InvalidateDocuments(const DocumentKeySet& keys) {
+  for (const DocumentKey& key : keys) {
+    if (entries_.empty()) return;
+    InvalidateDocument(key);
+  }
+}
+
+void QueryResultCache::InvalidateTarget(const Target& target) {
+  for (auto entry = entries_.begin(); entry != entries_.end();) {
+    auto current = entry++;
+    if (current->query.ToTarget() == target) {
+      Erase(current);
+    }
+  }
+}
+
+void QueryResultCache::Clear() {
+  entries_.clear();
+  index_.clear();
+}
+
+bool QueryResultCache::MayContain(const Query& query, const DocumentKey& key) {
+  const ResourcePath& path = query.path();
+  if (query.collection_group()) {
+    return key.HasCollectionGroup(*query.collection_group()) &&
+           path.IsPrefixOf(key.path());
+  } else if (DocumentKey::IsDocumentKey(path)) {
+    return path == key.path();
+  } else {
+    return path.IsImmediateParentOf(key.path());
+  }
+}
+
+void QueryResultCache::Erase(EntryList::iterator entry) {
+  index_.erase(entry->canonical_id);
+  entries_.erase(entry);
+}
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
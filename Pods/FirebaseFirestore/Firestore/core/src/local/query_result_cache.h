@@ -0,0 +1,118 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_LOCAL_QUERY_RESULT_CACHE_H_
+#define FIRESTORE_CORE_SRC_LOCAL_QUERY_RESULT_CACHE_H_
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <unordered_map>
+
+#include "Firestore/core/src/core/query.h"
+#include "Firestore/core/src/local/query_result.h"
+#include "Firestore/core/src/model/document_key.h"
+#include "Firestore/core/src/model/model_fwd.h"
+#include "absl/types/optional.h"
+
+namespace firebase {
+namespace firestore {
+namespace local {
+
+/**
+ * A count-bounded cache of recent `LocalStore::ExecuteQuery` results, keyed by
+ * the canonical ID of the query.
+ *
+ * The owner invalidates entries whenever the documents or target membership a
+ * result depends on may have changed. Entries are evicted in least-recently-
+ * used order. A capacity of zero disables the cache.
+ *
+ * This class is not thread-safe.
+ */
+class QueryResultCache {
+ public:
+  explicit QueryResultCache(size_t max_entries = 0)
+      : max_entries_(max_entries) {
+  }
+
+  /** Sets the capacity, evicting entries if the cache is now too large. */
+  void set_max_entries(size_t max_entries);
+
+  bool enabled() const {
+    return max_entries_ > 0;
+  }
+
+  /** Returns the cached result of `query`, or `nullopt` if there is none. */
+  absl::optional<QueryResult> Get(const core::Query& query);
+
+  /** Caches `result` as the current result of `query`. */
+  void Put(const core::Query& query, const QueryResult& result);
+
+  /**
+   * Drops the results of queries that a document with the given key could
+   * belong to, whether or not it matched their filters before.
+   */
+  void InvalidateDocument(const model::DocumentKey& key);
+
+  /** Calls `InvalidateDocument` for every key in `keys`. */
+  void InvalidateDocuments(const model::DocumentKeySet& keys);
+
+  /** Drops the results of queries served by `target`. */
+  void InvalidateTarget(const core::Target& target);
+
+  /** Drops all entries. The hit and miss counters are kept. */
+  void Clear();
+
+  size_t hit_count() const {
+    return hit_count_;
+  }
+
+  size_t miss_count() const {
+    return miss_count_;
+  }
+
+  size_t size() const {
+    return index_.size();
+  }
+
+ private:
+  struct Entry {
+    std::string canonical_id;
+    core::Query query;
+    QueryResult result;
+  };
+
+  // Most recently used entries are at the front.
+  using EntryList = std::list<Entry>;
+
+  static bool MayContain(const core::Query& query,
+                         const model::DocumentKey& key);
+
+  void Erase(EntryList::iterator entry);
+
+  size_t max_entries_ = 0;
+  size_t hit_count_ = 0;
+  size_t miss_count_ = 0;
+
+  EntryList entries_;
+  std::unordered_map<std::string, EntryList::iterator> index_;
+};
+
+}  // namespace local
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_LOCAL_QUERY_RESULT_CACHE_H_
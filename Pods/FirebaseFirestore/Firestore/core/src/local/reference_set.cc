@@ -28,15 +28,20 @@ using model::DocumentKey;
 using model::DocumentKeySet;
 
 void ReferenceSet::AddReference(const DocumentKey& key, int id) {
-  DocumentKeyReference reference{key, id};
-  by_key_ = by_key_.insert(reference);
-  by_id_ = by_id_.insert(reference);
+  by_key_ = by_key_.insert(DocumentKeyReference{key, id});
+  DocumentKeySet& keys = by_id_[id];
+  keys = keys.insert(key);
 }
 
 void ReferenceSet::AddReferences(const DocumentKeySet& keys, int id) {
+  if (keys.empty()) {
+    return;
+  }
   for (const DocumentKey& key : keys) {
-    AddReference(key, id);
+    by_key_ = by_key_.insert(DocumentKeyReference{key, id});
   }
+  DocumentKeySet& id_keys = by_id_[id];
+  id_keys = id_keys.union_with(keys);
 }
 
 void ReferenceSet::RemoveReference(const DocumentKey& key, int id) {
@@ -46,45 +51,54 @@ void ReferenceSet::RemoveReference(const DocumentKey& key, int id) {
 void ReferenceSet::RemoveReferences(
     const firebase::firestore::model::DocumentKeySet& keys, int id) {
   for (const DocumentKey& key : keys) {
-    RemoveReference(key, id);
+    by_key_ = by_key_.erase(DocumentKeyReference{key, id});
+  }
+
+  auto found = by_id_.find(id);
+  if (found == by_id_.end()) {
+    return;
+  }
+  found->second = found->second.difference_with(keys);
+  if (found->second.empty()) {
+    by_id_.erase(found);
   }
 }
 
 DocumentKeySet ReferenceSet::RemoveReferences(int id) {
-  DocumentKeyReference start{DocumentKey::Empty(), id};
-  DocumentKeyReference end{DocumentKey::Empty(), id + 1};
-
-  DocumentKeySet removed{};
+  auto found = by_id_.find(id);
+  if (found == by_id_.end()) {
+    return DocumentKeySet{};
+  }
 
-  auto initial = by_id_;
-  for (const auto& reference : initial.values_in(start, end)) {
-    RemoveReference(reference);
-    removed = removed.insert(reference.key());
+  DocumentKeySet removed = std::move(found->second);
+  by_id_.erase(found);
+  for (const DocumentKey& key : removed) {
+    by_key_ = by_key_.erase(DocumentKeyReference{key, id});
   }
   return removed;
 }
 
 void ReferenceSet::RemoveAllReferences() {
-  auto initial = by_key_;
-  for (const DocumentKeyReference& reference : initial) {
-    RemoveReference(reference);
-  }
+  by_key_ = decltype(by_key_){};
+  by_id_.clear();
 }
 
 void ReferenceSet::RemoveReference(const DocumentKeyReference& reference) {
   by_key_ = by_key_.erase(reference);
-  by_id_ = by_id_.erase(reference);
-}
-
-DocumentKeySet ReferenceSet::ReferencedKeys(int id) {
-  DocumentKeyReference start{DocumentKey::Empty(), id};
-  DocumentKeyReference end{DocumentKey::Empty(), id + 1};
 
-  DocumentKeySet keys;
-  for (const auto& reference : by_id_.values_in(start, end)) {
-    keys = keys.insert(reference.key());
+  auto found = by_id_.find(reference.ref_id());
+  if (found == by_id_.end()) {
+    return;
   }
-  return keys;
+  found->second = found->second.erase(reference.key());
+  if (found->second.empty()) {
+    by_id_.erase(found);
+  }
+}
+
+DocumentKeySet ReferenceSet::ReferencedKeys(int id) const {
+  auto found = by_id_.find(id);
+  return found != by_id_.end() ? found->second : DocumentKeySet{};
 }
 
 bool ReferenceSet::ContainsKey(const DocumentKey& key) {
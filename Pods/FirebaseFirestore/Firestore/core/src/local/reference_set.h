@@ -17,8 +17,11 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_REFERENCE_SET_H_
 #define FIRESTORE_CORE_SRC_LOCAL_REFERENCE_SET_H_
 
+#include <unordered_map>
+
 #include "Firestore/core/src/immutable/sorted_set.h"
 #include "Firestore/core/src/local/document_key_reference.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -36,9 +39,9 @@ namespace local {
  * there's no references in that set (this can be efficiently checked thanks to
  * sorting by key).
  *
- * ReferenceSet also keeps a secondary set that contains references sorted by
- * Id. This one is used to efficiently implement removal of all references by
- * some TargetId.
+ * ReferenceSet also keeps the referenced keys of each Id in a DocumentKeySet.
+ * This one is used to efficiently implement removal of all references by some
+ * TargetId, and lets ReferencedKeys share the set instead of building a copy.
  */
 class ReferenceSet {
  public:
@@ -72,7 +75,7 @@ class ReferenceSet {
 
   /** Returns all of the document keys that have had references added for the
    * given ID. */
-  model::DocumentKeySet ReferencedKeys(int id);
+  model::DocumentKeySet ReferencedKeys(int id) const;
 
   /**
    * Checks to see if there are any references to a document with the given key.
@@ -84,7 +87,7 @@ class ReferenceSet {
 
   immutable::SortedSet<DocumentKeyReference, DocumentKeyReference::ByKey>
       by_key_;
-  immutable::SortedSet<DocumentKeyReference, DocumentKeyReference::ById> by_id_;
+  std::unordered_map<int, model::DocumentKeySet> by_id_;
 };
 
 }  // namespace local
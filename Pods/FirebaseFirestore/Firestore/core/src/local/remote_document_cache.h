@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 #define FIRESTORE_CORE_SRC_LOCAL_REMOTE_DOCUMENT_CACHE_H_
 
+#include <string>
+
 #include "Firestore/core/src/model/model_fwd.h"
 
 namespace firebase {
@@ -29,6 +31,7 @@ class Query;
 namespace local {
 
 class IndexManager;
+class QueryContext;
 
 /**
  * Represents cached documents received from the remote backend.
@@ -92,6 +95,43 @@ class RemoteDocumentCache {
   virtual model::MutableDocumentMap GetAll(
       const model::ResourcePath& path, const model::IndexOffset& offset) = 0;
 
+  /**
+   * Executes a collection query against the cached Document entries, only
+   * returning the documents that match `query`.
+   *
+   * Documents that have an entry in `mutated_docs` are returned whether they
+   * match or not, since their local mutations may change the outcome.
+   *
+   * @param query The collection query to match documents against.
+   * @param offset The read time and document key to start scanning at
+   * (exclusive).
+   * @param mutated_docs The overlays of the documents in the collection.
+   * @param context Records the number of documents that were read.
+   * @return The set of matching documents.
+   */
+  virtual model::MutableDocumentMap GetDocumentsMatchingQuery(
+      const core::Query& query,
+      const model::IndexOffset& offset,
+      const model::OverlayByDocumentKeyMap& mutated_docs,
+      QueryContext& context) = 0;
+
+  /**
+   * Looks up the next `limit` documents for a collection group based on the
+   * provided offset. The ordering is based on the document's read time and
+   * key.
+   *
+   * The returned documents carry the read time at which they were added to
+   * the cache, so that callers can compute the offset to continue from.
+   *
+   * @param collection_group The collection group to scan.
+   * @param offset The offset to start the scan at (exclusive).
+   * @param limit The maximum number of results to return.
+   * @return A newly created map with the next set of documents.
+   */
+  virtual model::MutableDocumentMap GetAll(const std::string& collection_group,
+                                           const model::IndexOffset& offset,
+                                           size_t limit) = 0;
+
   /**
    * Sets the index manager used by remote document cache.
    *
@@ -93,23 +93,38 @@ TargetData TargetData::Invalid() {
 
 TargetData TargetData::WithSequenceNumber(
     ListenSequenceNumber sequence_number) const {
-  return TargetData(target_, target_id_, sequence_number, purpose_,
-                    snapshot_version_, last_limbo_free_snapshot_version_,
-                    resume_token_);
+  TargetData result = *this;
+  result.sequence_number_ = sequence_number;
+  return result;
 }
 
 TargetData TargetData::WithResumeToken(ByteString resume_token,
                                        SnapshotVersion snapshot_version) const {
-  return TargetData(target_, target_id_, sequence_number_, purpose_,
-                    std::move(snapshot_version),
-                    last_limbo_free_snapshot_version_, std::move(resume_token));
+  TargetData result = *this;
+  result.resume_token_ = std::move(resume_token);
+  result.snapshot_version_ = std::move(snapshot_version);
+  return result;
 }
 
 TargetData TargetData::WithLastLimboFreeSnapshotVersion(
     SnapshotVersion last_limbo_free_snapshot_version) const {
-  return TargetData(target_, target_id_, sequence_number_, purpose_,
-                    snapshot_version_,
-                    std::move(last_limbo_free_snapshot_version), resume_token_);
+  TargetData result = *this;
+  result.last_limbo_free_snapshot_version_ =
+      std::move(last_limbo_free_snapshot_version);
+  return result;
+}
+
+TargetData TargetData::WithDocumentKeys(
+    model::DocumentKeySet document_keys) const {
+  TargetData result = *this;
+  result.document_keys_ = std::move(document_keys);
+  return result;
+}
+
+TargetData TargetData::WithExpectedCount(int32_t expected_count) const {
+  TargetData result = *this;
+  result.expected_count_ = expected_count;
+  return result;
 }
 
 bool operator==(const TargetData& lhs, const TargetData& rhs) {
@@ -117,7 +132,9 @@ bool operator==(const TargetData& lhs, const TargetData& rhs) {
          lhs.sequence_number() == rhs.sequence_number() &&
          lhs.purpose() == rhs.purpose() &&
          lhs.snapshot_version() == rhs.snapshot_version() &&
-         lhs.resume_token() == rhs.resume_token();
+         lhs.resume_token() == rhs.resume_token() &&
+         lhs.document_keys() == rhs.document_keys() &&
+         lhs.expected_count() == rhs.expected_count();
 }
 
 size_t TargetData::Hash() const {
@@ -17,15 +17,18 @@
 #ifndef FIRESTORE_CORE_SRC_LOCAL_TARGET_DATA_H_
 #define FIRESTORE_CORE_SRC_LOCAL_TARGET_DATA_H_
 
+#include <cstdint>
 #include <iosfwd>
 #include <memory>
 #include <string>
 #include <vector>
 
 #include "Firestore/core/src/core/target.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/snapshot_version.h"
 #include "Firestore/core/src/model/types.h"
 #include "Firestore/core/src/nanopb/byte_string.h"
+#include "absl/types/optional.h"
 
 namespace firebase {
 namespace firestore {
@@ -160,6 +163,33 @@ class TargetData {
   TargetData WithLastLimboFreeSnapshotVersion(
       model::SnapshotVersion last_limbo_free_snapshot_version) const;
 
+  /**
+   * Returns a new instance of TargetData that watches the given documents
+   * instead of the results of `target()`. Such targets are only used to
+   * resolve several documents in limbo at once, and are never persisted.
+   */
+  TargetData WithDocumentKeys(model::DocumentKeySet document_keys) const;
+
+  /**
+   * The documents this target watches if it was created with
+   * `WithDocumentKeys`; empty if it watches the results of `target()`.
+   */
+  const model::DocumentKeySet& document_keys() const {
+    return document_keys_;
+  }
+
+  /**
+   * Returns a new instance of TargetData that tells the backend how many
+   * documents the client has for it, so that an existence filter mismatch
+   * on resumption comes with a bloom filter. Never persisted.
+   */
+  TargetData WithExpectedCount(int32_t expected_count) const;
+
+  /** The number of documents the client has for this target, if known. */
+  const absl::optional<int32_t>& expected_count() const {
+    return expected_count_;
+  }
+
   friend bool operator==(const TargetData& lhs, const TargetData& rhs);
 
   size_t Hash() const;
@@ -176,6 +206,8 @@ class TargetData {
   model::SnapshotVersion snapshot_version_;
   model::SnapshotVersion last_limbo_free_snapshot_version_;
   nanopb::ByteString resume_token_;
+  model::DocumentKeySet document_keys_;
+  absl::optional<int32_t> expected_count_;
 };
 
 inline bool operator!=(const TargetData& lhs, const TargetData& rhs) {
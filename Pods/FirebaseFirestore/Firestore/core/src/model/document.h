@@ -18,6 +18,7 @@
 #define FIRESTORE_CORE_SRC_MODEL_DOCUMENT_H_
 
 #include <iosfwd>
+#include <memory>
 #include <string>
 #include <utility>
 
@@ -27,6 +28,19 @@ namespace firebase {
 namespace firestore {
 namespace model {
 
+/**
+ * The precomputed position of a document in one ordering of documents.
+ *
+ * Comparing the `bytes` of two keys of the same `ordering` agrees with
+ * comparing the documents themselves whenever the bytes differ; equal bytes
+ * have to be settled by comparing the documents.
+ */
+struct DocumentSortKey {
+  /** Identifies the ordering and keeps it alive, so it is never reused. */
+  std::shared_ptr<const void> ordering;
+  std::string bytes;
+};
+
 /** Represents an immutable document in Firestore. */
 class Document {
  public:
@@ -56,8 +70,21 @@ class Document {
     return document_.read_time();
   }
 
+  /**
+   * The sort key attached by `DocumentComparator::WithSortKey`, or null. It is
+   * not part of the document's value and is ignored by equality.
+   */
+  const std::shared_ptr<const DocumentSortKey>& sort_key() const {
+    return sort_key_;
+  }
+
+  void set_sort_key(std::shared_ptr<const DocumentSortKey> sort_key) {
+    sort_key_ = std::move(sort_key);
+  }
+
  private:
   MutableDocument document_;
+  std::shared_ptr<const DocumentSortKey> sort_key_;
 };
 
 inline bool operator==(const Document& lhs, const Document& rhs) {
@@ -25,7 +25,8 @@ namespace firestore {
 namespace model {
 
 /** Convenience type for a set of keys, since they are so common. */
-using DocumentKeySet = immutable::SortedSet<DocumentKey>;
+using DocumentKeySet = immutable::
+    SortedSet<DocumentKey, util::Comparator<DocumentKey>, immutable::BTree>;
 
 }  // namespace model
 }  // namespace firestore
@@ -42,6 +42,13 @@ DocumentComparator DocumentComparator::ByKey() {
   });
 }
 
+Document DocumentComparator::WithSortKey(Document document) const {
+  if (sort_key_function_) {
+    document.set_sort_key(sort_key_function_(document));
+  }
+  return document;
+}
+
 DocumentSet::DocumentSet(DocumentComparator&& comparator)
     : index_{}, sorted_set_{std::move(comparator)} {
 }
@@ -110,8 +117,10 @@ DocumentSet DocumentSet::erase(const DocumentKey& key) const {
     return *this;
   }
 
+  // The index does not keep sort keys; encoding this one document is cheaper
+  // than comparing its fields on the way down the sorted set.
   DocumentMap index = index_.erase(key);
-  SetType set = sorted_set_.erase(*doc);
+  SetType set = sorted_set_.erase(comparator().WithSortKey(*doc));
   return {std::move(index), std::move(set)};
 }
 
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_MODEL_DOCUMENT_SET_H_
 #define FIRESTORE_CORE_SRC_MODEL_DOCUMENT_SET_H_
 
+#include <functional>
 #include <iosfwd>
 #include <memory>
 #include <string>
@@ -37,12 +38,37 @@ class DocumentComparator : public util::FunctionComparator<Document> {
  public:
   using FunctionComparator<Document>::FunctionComparator;
 
+  using SortKeyFunction =
+      std::function<std::shared_ptr<const DocumentSortKey>(const Document&)>;
+
+  /**
+   * Creates a comparator that also computes sort keys for the documents it
+   * orders. The comparison function should compare documents by their sort
+   * keys when both have one; see `WithSortKey`.
+   */
+  DocumentComparator(ComparisonFunction&& function,
+                     SortKeyFunction&& sort_key_function)
+      : FunctionComparator<Document>(std::move(function)),
+        sort_key_function_(std::move(sort_key_function)) {
+  }
+
   static DocumentComparator ByKey();
 
+  /**
+   * Returns the given document with its sort key for this comparator attached,
+   * so that comparing it against other such documents does not have to look up
+   * and compare their fields again. The document is returned as is if this
+   * comparator has no sort keys or could not encode the document's values.
+   */
+  Document WithSortKey(Document document) const;
+
   // TODO(wilhuff): Remove this using statement
   // This exists to put these two overloads on equal footing. Once the overload
   // below is gone, this using statement can be removed as well.
   using FunctionComparator<Document>::Compare;
+
+ private:
+  SortKeyFunction sort_key_function_;
 };
 
 /**
@@ -57,7 +83,8 @@ class DocumentSet : public immutable::SortedContainer {
    * The type of the main collection of documents in an DocumentSet.
    * @see sorted_set_.
    */
-  using SetType = immutable::SortedSet<Document, DocumentComparator>;
+  using SetType =
+      immutable::SortedSet<Document, DocumentComparator, immutable::BTree>;
 
   // STL container types
   using value_type = Document;
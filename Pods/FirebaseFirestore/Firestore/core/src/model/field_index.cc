@@ -80,7 +80,8 @@ util::ComparisonResult IndexOffset::DocumentCompare(const Document& lhs,
 std::vector<Segment> FieldIndex::GetDirectionalSegments() const {
   std::vector<Segment> filtered_segments;
   for (const auto& segment : segments_) {
-    if (segment.kind() != Segment::kContains) {
+    if (segment.kind() == Segment::kAscending ||
+        segment.kind() == Segment::kDescending) {
       filtered_segments.push_back(segment);
     }
   }
@@ -127,6 +128,13 @@ absl::optional<Segment> FieldIndex::GetArraySegment() const {
   return absl::nullopt;
 }
 
+absl::optional<Segment> FieldIndex::GetGeoSegment() const {
+  if (segments_.size() == 1 && segments_.front().kind() == Segment::kGeo) {
+    return segments_.front();
+  }
+  return absl::nullopt;
+}
+
 }  // namespace model
 }  // namespace firestore
 }  // namespace firebase
@@ -48,6 +48,12 @@ class Segment : public util::Comparable<Segment> {
     kDescending,
     /** Contains index. Can be used for Contains and ArrayContainsAny */
     kContains,
+    /**
+     * Geo index over GeoPoint values. Can only be used for lookups of the
+     * points within a box or circle, and must be the only segment of its
+     * index.
+     */
+    kGeo,
   };
 
   Segment(FieldPath field_path, Kind kind)
@@ -196,7 +202,8 @@ class IndexState {
  * Every index is associated with a collection. The definition contains a list
  * of fields and their index kind (which can be `Segment::Kind::kAscending`,
  * `Segment::Kind::kDescending` or `Segment::Kind::kContains` for
- * ArrayContains/ArrayContainsAny queries.
+ * ArrayContains/ArrayContainsAny queries), or a single `Segment::Kind::kGeo`
+ * segment for geo lookups.
  *
  * Unlike the backend, the SDK does not differentiate between collection or
  * collection group-scoped indices. Every index can be used for both single
@@ -265,6 +272,9 @@ class FieldIndex {
   /** Returns the ArrayContains/ArrayContainsAny segment for this index. */
   absl::optional<Segment> GetArraySegment() const;
 
+  /** Returns the geo segment for this index, if this is a geo index. */
+  absl::optional<Segment> GetGeoSegment() const;
+
  private:
   int32_t index_id_ = UnknownId();
   std::string collection_group_;
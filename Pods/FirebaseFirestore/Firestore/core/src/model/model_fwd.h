@@ -41,10 +41,13 @@ struct Comparator;
 
 namespace immutable {
 
-template <typename K, typename V, typename C>
+struct BTree;
+struct LlrbTree;
+
+template <typename K, typename V, typename C, typename T>
 class SortedMap;
 
-template <typename K, typename C>
+template <typename K, typename C, typename T>
 class SortedSet;
 
 }  // namespace immutable
@@ -92,14 +95,20 @@ using BatchId = int32_t;
 using ListenSequenceNumber = int64_t;
 using TargetId = int32_t;
 
-using DocumentKeySet =
-    immutable::SortedSet<DocumentKey, util::Comparator<DocumentKey>>;
+// Key sets and document maps commonly grow to thousands of entries and are
+// iterated in full, so they are stored in B-trees once they outgrow an array.
+using DocumentKeySet = immutable::
+    SortedSet<DocumentKey, util::Comparator<DocumentKey>, immutable::BTree>;
 
-using MutableDocumentMap = immutable::
-    SortedMap<DocumentKey, MutableDocument, util::Comparator<DocumentKey>>;
+using MutableDocumentMap = immutable::SortedMap<DocumentKey,
+                                                MutableDocument,
+                                                util::Comparator<DocumentKey>,
+                                                immutable::LlrbTree>;
 
-using DocumentMap =
-    immutable::SortedMap<DocumentKey, Document, util::Comparator<DocumentKey>>;
+using DocumentMap = immutable::SortedMap<DocumentKey,
+                                         Document,
+                                         util::Comparator<DocumentKey>,
+                                         immutable::BTree>;
 
 using DocumentVersionMap =
     std::unordered_map<DocumentKey, SnapshotVersion, DocumentKeyHash>;
@@ -66,16 +66,18 @@ google_firestore_v1_MapValue_FieldsEntry* FindEntry(
   }
   const google_firestore_v1_MapValue& map_value = value.map_value;
 
-  // MapValues in iOS are always stored in sorted order.
-  auto found = std::equal_range(map_value.fields,
-                                map_value.fields + map_value.fields_count,
-                                segment, MapEntryKeyCompare());
-
-  if (found.first == found.second) {
+  // MapValues in iOS are always stored in sorted order, and keys are unique,
+  // so a single binary search finds the entry.
+  google_firestore_v1_MapValue_FieldsEntry* end =
+      map_value.fields + map_value.fields_count;
+  auto found = std::lower_bound(map_value.fields, end, segment,
+                                MapEntryKeyCompare());
+
+  if (found == end || MakeStringView(found->key) != segment) {
     return nullptr;
   }
 
-  return found.first;
+  return found;
 }
 
 size_t CalculateSizeOfUnion(
@@ -259,14 +261,15 @@ absl::optional<google_firestore_v1_Value> ObjectValue::Get(
     return *value_;
   }
 
-  google_firestore_v1_Value nested_value = *value_;
+  // Walk the tree without copying the values on the way.
+  const google_firestore_v1_Value* nested_value = value_.get();
   for (const std::string& segment : path) {
     google_firestore_v1_MapValue_FieldsEntry* entry =
-        FindEntry(nested_value, segment);
+        FindEntry(*nested_value, segment);
     if (!entry) return absl::nullopt;
-    nested_value = entry->value;
+    nested_value = &entry->value;
   }
-  return nested_value;
+  return *nested_value;
 }
 
 google_firestore_v1_Value ObjectValue::Get() const {
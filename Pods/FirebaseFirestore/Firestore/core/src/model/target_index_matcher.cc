@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/model/target_index_matcher.h"
 
+#include <set>
+
 #include "Firestore/core/src/util/hard_assert.h"
 
 namespace firebase {
@@ -51,6 +53,11 @@ bool TargetIndexMatcher::ServedByIndex(const model::FieldIndex& index) {
   HARD_ASSERT(index.collection_group() == collection_id_,
               "Collection IDs do not match");
 
+  // Geo indexes only serve geo lookups, never the filters of a target.
+  if (index.GetGeoSegment().has_value()) {
+    return false;
+  }
+
   // If there is an array element, find a matching filter.
   const auto& array_segment = index.GetArraySegment();
   if (array_segment.has_value() &&
@@ -110,6 +117,48 @@ bool TargetIndexMatcher::ServedByIndex(const model::FieldIndex& index) {
   return true;
 }
 
+FieldIndex TargetIndexMatcher::BuildTargetIndex() const {
+  // We want to make sure only one segment is created for each field. For
+  // example, in case of `a == 3 && a > 10`, "a" should only be used once.
+  std::set<FieldPath> unique_fields;
+  std::vector<Segment> segments;
+
+  for (const FieldFilter& filter : equality_filters_) {
+    if (filter.field().IsKeyFieldPath()) {
+      continue;
+    }
+
+    bool is_array_op = filter.op() == FieldFilter::Operator::ArrayContains ||
+                       filter.op() == FieldFilter::Operator::ArrayContainsAny;
+    if (is_array_op) {
+      segments.emplace_back(filter.field(), Segment::kContains);
+    } else if (unique_fields.insert(filter.field()).second) {
+      segments.emplace_back(filter.field(), Segment::kAscending);
+    }
+  }
+
+  // We do not need to check `inequality_filter_` explicitly: the target's
+  // first OrderBy clause is always on the inequality field, so the loop below
+  // adds the required segment.
+  for (const OrderBy& order_by : order_bys_) {
+    // The document key is always part of the index entry, so an OrderBy on the
+    // key does not need its own segment.
+    if (order_by.field().IsKeyFieldPath()) {
+      continue;
+    }
+
+    if (unique_fields.insert(order_by.field()).second) {
+      segments.emplace_back(order_by.field(),
+                            order_by.direction() == core::Direction::Ascending
+                                ? Segment::kAscending
+                                : Segment::kDescending);
+    }
+  }
+
+  return FieldIndex(FieldIndex::UnknownId(), collection_id_,
+                    std::move(segments), FieldIndex::InitialState());
+}
+
 bool TargetIndexMatcher::HasMatchingEqualityFilter(const Segment& segment) {
   for (const auto& filter : equality_filters_) {
     if (MatchesFilter(filter, segment)) {
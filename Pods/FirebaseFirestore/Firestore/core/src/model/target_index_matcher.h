@@ -77,6 +77,18 @@ class TargetIndexMatcher {
    */
   bool ServedByIndex(const model::FieldIndex& index);
 
+  /**
+   * Returns a full index that can be used to serve the TargetIndexMatcher's
+   * target.
+   *
+   * The index contains an ascending segment for each equality filter, a
+   * `kContains` segment for an ArrayContains/ArrayContainsAny filter and a
+   * directional segment for each OrderBy clause (which includes the field of
+   * the inequality filter, if any). The returned index has an unknown ID and
+   * its initial state.
+   */
+  model::FieldIndex BuildTargetIndex() const;
+
  private:
   bool HasMatchingEqualityFilter(const model::Segment& segment);
 
@@ -28,6 +28,7 @@
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/util/read_context.h"
 #include "Firestore/core/src/util/status.h"
+#include "absl/strings/cord.h"
 #include "absl/strings/string_view.h"
 
 namespace firebase {
@@ -142,6 +143,40 @@ class StringReader : public Reader {
   pb_istream_t stream_{};
 };
 
+/**
+ * A `Reader` that reads from the chunks of an `absl::Cord`.
+ *
+ * The chunks are read in place rather than flattened into one contiguous
+ * block, so a payload assembled from several buffers (e.g. the slices of a
+ * `grpc::ByteBuffer`, see `remote::MakeCord()`) is copied only once, straight
+ * into the decoded proto.
+ */
+class CordReader : public Reader {
+ public:
+  /**
+   * Creates an input stream that reads from the given `cord`. Copying a cord
+   * only shares its chunks, and the copy keeps them alive for the lifetime of
+   * this `CordReader`.
+   */
+  explicit CordReader(absl::Cord cord);
+
+  // The stream refers to this reader.
+  CordReader(const CordReader&) = delete;
+  CordReader& operator=(const CordReader&) = delete;
+
+  void Read(const pb_field_t fields[], void* dest_struct) override;
+
+ private:
+  /** The callback of a stream that spans several chunks. */
+  static bool ReadFromChunks(pb_istream_t* stream,
+                             pb_byte_t* buf,
+                             size_t count);
+
+  absl::Cord cord_;
+  absl::Cord::CharIterator position_;
+  pb_istream_t stream_{};
+};
+
 }  // namespace nanopb
 }  // namespace firestore
 }  // namespace firebase
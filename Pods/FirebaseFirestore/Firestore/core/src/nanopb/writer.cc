@@ -29,6 +29,10 @@ namespace {
 
 constexpr size_t kMinBufferSize = 4;
 
+// Number of submessage sizes that Write can cache without allocating. Each
+// field of a map value takes two: the map entry and its value.
+constexpr size_t kInlineSizeCacheEntries = 64;
+
 bool AppendToBytesArray(pb_ostream_t* stream,
                         const pb_byte_t* buf,
                         size_t count) {
@@ -40,7 +44,27 @@ bool AppendToBytesArray(pb_ostream_t* stream,
 }  // namespace
 
 void Writer::Write(const pb_field_t fields[], const void* src_struct) {
-  if (!pb_encode(&stream_, fields, src_struct)) {
+  // Size every submessage once up front and write with those sizes. Plain
+  // pb_encode sizes each submessage right before writing it, so deeply nested
+  // values would be sized again at every level of nesting.
+  size_t inline_sizes[kInlineSizeCacheEntries];
+  std::vector<size_t> sizes;
+  pb_size_cache_t cache{inline_sizes, kInlineSizeCacheEntries, 0, 0};
+
+  size_t size = 0;
+  bool sized = pb_get_encoded_size_cached(&size, fields, src_struct, &cache);
+  if (sized && cache.count > cache.capacity) {
+    sizes.resize(cache.count);
+    cache.sizes = sizes.data();
+    cache.capacity = sizes.size();
+    sized = pb_get_encoded_size_cached(&size, fields, src_struct, &cache);
+  }
+
+  // If sizing failed, let pb_encode fail again to report why.
+  bool encoded = sized
+                     ? pb_encode_cached(&stream_, fields, src_struct, &cache)
+                     : pb_encode(&stream_, fields, src_struct);
+  if (!encoded) {
     HARD_FAIL(PB_GET_ERROR(&stream_));
   }
 }
@@ -0,0 +1,105 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/remote/bloom_filter.h"
+
+#include <array>
+#include <utility>
+
+#include "Firestore/core/src/util/md5.h"
+#include "Firestore/core/src/util/status.h"
+#include "Firestore/core/src/util/string_format.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+namespace {
+
+using nanopb::ByteString;
+using util::Status;
+using util::StatusOr;
+using util::StringFormat;
+
+uint64_t ReadLittleEndian(const uint8_t* bytes) {
+  uint64_t result = 0;
+  for (int i = 7; i >= 0; --i) {
+    result = (result << 8) | bytes[i];
+  }
+  return result;
+}
+
+}  // namespace
+
+BloomFilter::BloomFilter(ByteString bitmap,
+                         int32_t padding,
+                         int32_t hash_count)
+    : bitmap_{std::move(bitmap)},
+      bit_count_{static_cast<int32_t>(bitmap_.size() * 8) - padding},
+      hash_count_{hash_count} {
+}
+
+StatusOr<BloomFilter> BloomFilter::Create(ByteString bitmap,
+                                          int32_t padding,
+                                          int32_t hash_count) {
+  if (padding < 0 || padding >= 8) {
+    return Status(Error::kErrorInvalidArgument,
+                  StringFormat("Invalid padding: %s", padding));
+  }
+  if (hash_count < 0) {
+    return Status(Error::kErrorInvalidArgument,
+                  StringFormat("Invalid hash count: %s", hash_count));
+  }
+  if (bitmap.empty() && padding != 0) {
+    return Status(Error::kErrorInvalidArgument,
+                  StringFormat("Expected padding of 0 when bitmap length is "
+                               "0, but got %s",
+                               padding));
+  }
+  if (!bitmap.empty() && hash_count == 0) {
+    return Status(Error::kErrorInvalidArgument,
+                  "Expected a positive hash count for a non-empty bitmap");
+  }
+  return BloomFilter(std::move(bitmap), padding, hash_count);
+}
+
+bool BloomFilter::MightContain(absl::string_view value) const {
+  if (bit_count_ == 0) {
+    return false;
+  }
+
+  std::array<uint8_t, 16> digest = util::CalculateMd5Digest(value);
+  uint64_t h1 = ReadLittleEndian(digest.data());
+  uint64_t h2 = ReadLittleEndian(digest.data() + 8);
+
+  // The index arithmetic wraps around modulo 2^64, as on the backend.
+  auto bit_count = static_cast<uint64_t>(bit_count_);
+  for (int32_t i = 0; i < hash_count_; ++i) {
+    uint64_t index = (h1 + static_cast<uint64_t>(i) * h2) % bit_count;
+    if (!IsBitSet(index)) {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool BloomFilter::IsBitSet(uint64_t index) const {
+  uint8_t byte = bitmap_.data()[index / 8];
+  return (byte >> (index % 8)) & 1;
+}
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
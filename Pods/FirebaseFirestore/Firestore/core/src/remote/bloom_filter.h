@@ -0,0 +1,75 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
+#define FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
+
+#include <cstdint>
+
+#include "Firestore/core/src/nanopb/byte_string.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/string_view.h"
+
+namespace firebase {
+namespace firestore {
+namespace remote {
+
+/**
+ * A bloom filter sent by the backend as part of an existence filter, over the
+ * full resource names of the documents that still match a target.
+ *
+ * Each value is hashed with MD5; the two little-endian 64-bit halves of the
+ * digest, `h1` and `h2`, yield the bit indexes `(h1 + i * h2) % bit_count` for
+ * `i` in `[0, hash_count)`. Bits are numbered from the least significant bit
+ * of the first byte of the bitmap.
+ */
+class BloomFilter {
+ public:
+  /**
+   * Returns a bloom filter of the given parameters, or an error if they are
+   * inconsistent: the padding must be in `[0, 7]` and zero for an empty
+   * bitmap, and a non-empty bitmap needs a positive hash count.
+   */
+  static util::StatusOr<BloomFilter> Create(nanopb::ByteString bitmap,
+                                            int32_t padding,
+                                            int32_t hash_count);
+
+  /**
+   * Returns whether the given value may have been added to the filter. False
+   * positives are possible, false negatives are not: a value for which this
+   * returns false was certainly not added. An empty filter contains nothing.
+   */
+  bool MightContain(absl::string_view value) const;
+
+  int32_t bit_count() const {
+    return bit_count_;
+  }
+
+ private:
+  BloomFilter(nanopb::ByteString bitmap, int32_t padding, int32_t hash_count);
+
+  bool IsBitSet(uint64_t index) const;
+
+  nanopb::ByteString bitmap_;
+  int32_t bit_count_ = 0;
+  int32_t hash_count_ = 0;
+};
+
+}  // namespace remote
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_REMOTE_BLOOM_FILTER_H_
@@ -52,6 +52,7 @@ namespace {
 using core::DatabaseInfo;
 using credentials::AuthCredentialsProvider;
 using credentials::AuthToken;
+using model::Document;
 using model::DocumentKey;
 using model::Mutation;
 using util::AsyncQueue;
@@ -64,7 +65,9 @@ const auto kRpcNameCommit = "/google.firestore.v1.Firestore/Commit";
 const auto kRpcNameLookup = "/google.firestore.v1.Firestore/BatchGetDocuments";
 
 std::unique_ptr<Executor> CreateExecutor() {
-  return Executor::CreateSerial("com.google.firebase.firestore.rpc");
+  // Responses to the RPCs are what snapshots wait on.
+  return Executor::CreateSerial("com.google.firebase.firestore.rpc",
+                                Executor::Priority::kUserInitiated);
 }
 
 std::string MakeString(grpc::string_ref grpc_str) {
@@ -114,6 +117,16 @@ void Datastore::Start() {
   rpc_executor_->Execute([this] { PollGrpcQueue(); });
 }
 
+void Datastore::Prewarm() {
+  LOG_DEBUG("Prewarming the connection and credentials");
+  grpc_connection_.Prewarm();
+
+  // The providers cache the tokens, so the first stream gets them without
+  // another round trip.
+  auth_credentials_->GetToken([](const StatusOr<AuthToken>&) {});
+  app_check_credentials_->GetToken([](const StatusOr<std::string>&) {});
+}
+
 void Datastore::Shutdown() {
   is_shut_down_ = true;
 
@@ -205,24 +218,47 @@ void Datastore::CommitMutationsWithCredentials(
 
 void Datastore::LookupDocuments(const std::vector<DocumentKey>& keys,
                                 LookupCallback&& user_callback) {
+  // Results are sorted by key.
+  auto results = std::make_shared<DatastoreSerializer::LookupResults>();
+  StreamLookupDocuments(
+      keys,
+      [results](Document&& document) {
+        DocumentKey key = document->key();
+        (*results)[std::move(key)] = std::move(document);
+      },
+      [results, user_callback](const Status& status) {
+        if (!status.ok()) {
+          user_callback(status);
+          return;
+        }
+        user_callback(DatastoreSerializer::ToDocuments(std::move(*results)));
+      });
+}
+
+void Datastore::StreamLookupDocuments(const std::vector<DocumentKey>& keys,
+                                      DocumentCallback&& document_callback,
+                                      CommitCallback&& completion_callback) {
   ResumeRpcWithCredentials(
       // TODO(c++14): move into lambda.
-      [this, keys, user_callback](const StatusOr<AuthToken>& auth_token,
-                                  const std::string& app_check_token) mutable {
+      [this, keys, document_callback, completion_callback](
+          const StatusOr<AuthToken>& auth_token,
+          const std::string& app_check_token) mutable {
         if (!auth_token.ok()) {
-          user_callback(auth_token.status());
+          completion_callback(auth_token.status());
           return;
         }
-        LookupDocumentsWithCredentials(auth_token.ValueOrDie(), app_check_token,
-                                       keys, std::move(user_callback));
+        StreamLookupDocumentsWithCredentials(
+            auth_token.ValueOrDie(), app_check_token, keys,
+            std::move(document_callback), std::move(completion_callback));
       });
 }
 
-void Datastore::LookupDocumentsWithCredentials(
+void Datastore::StreamLookupDocumentsWithCredentials(
     const credentials::AuthToken& auth_token,
     const std::string& app_check_token,
     const std::vector<DocumentKey>& keys,
-    LookupCallback&& user_callback) {
+    DocumentCallback&& document_callback,
+    CommitCallback&& completion_callback) {
   grpc::ByteBuffer message =
       MakeByteBuffer(datastore_serializer_.EncodeLookupRequest(keys));
 
@@ -232,17 +268,33 @@ void Datastore::LookupDocumentsWithCredentials(
   GrpcStreamingReader* call = call_owning.get();
   active_calls_.push_back(std::move(call_owning));
 
+  // Each response is decoded and handed on as it arrives, rather than once
+  // all of them have been buffered.
+  auto decode_status = std::make_shared<Status>();
+  auto response_callback = [this, document_callback,
+                            decode_status](const grpc::ByteBuffer& response) {
+    if (!decode_status->ok()) {
+      return;
+    }
+    StatusOr<Document> document =
+        datastore_serializer_.DecodeLookupResponse(response);
+    if (!document.ok()) {
+      *decode_status = document.status();
+      return;
+    }
+    document_callback(std::move(document).ValueOrDie());
+  };
+
   // TODO(c++14): lambda captures using move.
-  auto responses_callback =
-      [this, user_callback](const std::vector<grpc::ByteBuffer>& result) {
-        user_callback(datastore_serializer_.MergeLookupResponses(result));
-      };
-
-  auto close_callback = [this, user_callback, call](const util::Status& status,
-                                                    bool callback_fired) {
-    // Trigger user_callback with an error status
+  auto on_completion = [completion_callback, decode_status] {
+    completion_callback(*decode_status);
+  };
+
+  auto close_callback = [this, completion_callback, call](
+                            const util::Status& status, bool callback_fired) {
+    // Trigger completion_callback with an error status
     if (!callback_fired) {
-      user_callback(status);
+      completion_callback(status);
     }
     if (!status.ok()) {
       LogGrpcCallFinished("BatchGetDocuments", call, status);
@@ -251,7 +303,7 @@ void Datastore::LookupDocumentsWithCredentials(
     RemoveGrpcCall(call);
   };
 
-  call->Start(keys.size(), responses_callback, close_callback);
+  call->Start(keys.size(), response_callback, on_completion, close_callback);
 }
 
 void Datastore::ResumeRpcWithCredentials(const OnCredentials& on_credentials) {
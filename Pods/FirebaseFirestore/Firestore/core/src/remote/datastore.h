@@ -71,6 +71,7 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   using LookupCallback =
       std::function<void(const util::StatusOr<std::vector<model::Document>>&)>;
   using CommitCallback = std::function<void(const util::Status&)>;
+  using DocumentCallback = std::function<void(model::Document&&)>;
 
   Datastore(
       const core::DatabaseInfo& database_info,
@@ -83,6 +84,10 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
 
   virtual ~Datastore() = default;
 
+  const model::DatabaseId& database_id() const {
+    return datastore_serializer_.serializer().database_id();
+  }
+
   /** Starts polling the gRPC completion queue. */
   void Start();
   /** Cancels any pending gRPC calls and drains the gRPC completion queue. */
@@ -101,11 +106,48 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
   virtual std::shared_ptr<WriteStream> CreateWriteStream(
       WriteStreamCallback* callback);
 
+  /**
+   * Spreads calls over the given number of gRPC channels, keeping the watch
+   * and write streams apart from other calls. Call before creating any
+   * streams or calls.
+   */
+  void SetChannelCount(size_t channel_count) {
+    grpc_connection_.set_channel_count(channel_count);
+  }
+
+  /** Records the concurrency of gRPC channels into the given metrics. */
+  void SetMetrics(util::Metrics* metrics) {
+    grpc_connection_.set_metrics(metrics);
+  }
+
+  /**
+   * Starts connecting to the backend and fetching the credentials ahead of
+   * the first stream, without waiting for either.
+   */
+  void Prewarm();
+
+  /** Returns the load counters of each gRPC channel. */
+  std::vector<GrpcChannelStats> GetChannelStats() const {
+    return grpc_connection_.GetChannelStats();
+  }
+
   void CommitMutations(const std::vector<model::Mutation>& mutations,
                        CommitCallback&& callback);
   void LookupDocuments(const std::vector<model::DocumentKey>& keys,
                        LookupCallback&& user_callback);
 
+  /**
+   * Looks up the given documents without collecting them: `document_callback`
+   * is invoked with each document as soon as its response has been decoded,
+   * in the order the backend sends them, and `completion_callback` once the
+   * lookup has finished. If the lookup fails, the documents received so far
+   * must be discarded; `completion_callback` is then invoked with the error
+   * and `document_callback` is not invoked anymore.
+   */
+  void StreamLookupDocuments(const std::vector<model::DocumentKey>& keys,
+                             DocumentCallback&& document_callback,
+                             CommitCallback&& completion_callback);
+
   /** Returns true if the given error is a gRPC ABORTED error. */
   static bool IsAbortedError(const util::Status& error);
 
@@ -172,11 +214,12 @@ class Datastore : public std::enable_shared_from_this<Datastore> {
       const std::vector<model::Mutation>& mutations,
       CommitCallback&& callback);
 
-  void LookupDocumentsWithCredentials(
+  void StreamLookupDocumentsWithCredentials(
       const credentials::AuthToken& auth_token,
       const std::string& app_check_token,
       const std::vector<model::DocumentKey>& keys,
-      LookupCallback&& user_callback);
+      DocumentCallback&& document_callback,
+      CommitCallback&& completion_callback);
 
   using OnCredentials = std::function<void(
       const util::StatusOr<credentials::AuthToken>&, const std::string&)>;
@@ -17,26 +17,63 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_EXISTENCE_FILTER_H_
 #define FIRESTORE_CORE_SRC_REMOTE_EXISTENCE_FILTER_H_
 
+#include <cstdint>
+#include <utility>
+
+#include "Firestore/core/src/nanopb/byte_string.h"
+#include "absl/types/optional.h"
+
 namespace firebase {
 namespace firestore {
 namespace remote {
 
+/**
+ * The parameters of a `BloomFilter` as sent by the backend, which are only
+ * validated once the filter is needed.
+ */
+struct BloomFilterParameters {
+  nanopb::ByteString bitmap;
+  int32_t padding = 0;
+  int32_t hash_count = 0;
+};
+
+inline bool operator==(const BloomFilterParameters& lhs,
+                       const BloomFilterParameters& rhs) {
+  return lhs.bitmap == rhs.bitmap && lhs.padding == rhs.padding &&
+         lhs.hash_count == rhs.hash_count;
+}
+
 class ExistenceFilter {
  public:
   ExistenceFilter() = default;
   explicit ExistenceFilter(int count) : count_{count} {
   }
+  ExistenceFilter(int count,
+                  absl::optional<BloomFilterParameters> unchanged_names)
+      : count_{count}, unchanged_names_{std::move(unchanged_names)} {
+  }
 
   int count() const {
     return count_;
   }
 
+  /**
+   * A bloom filter over the names of the documents that match the target, if
+   * the backend sent one. It tells which of the cached documents are gone
+   * when `count` does not match the cache.
+   */
+  const absl::optional<BloomFilterParameters>& unchanged_names() const {
+    return unchanged_names_;
+  }
+
  private:
   int count_ = 0;
+  absl::optional<BloomFilterParameters> unchanged_names_;
 };
 
 inline bool operator==(const ExistenceFilter& lhs, const ExistenceFilter& rhs) {
-  return lhs.count() == rhs.count();
+  return lhs.count() == rhs.count() &&
+         lhs.unchanged_names() == rhs.unchanged_names();
 }
 
 }  // namespace remote
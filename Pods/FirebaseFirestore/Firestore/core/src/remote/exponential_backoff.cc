@@ -23,6 +23,7 @@
 
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
 
 namespace firebase {
 namespace firestore {
@@ -45,6 +46,15 @@ constexpr double kDefaultBackoffFactor = 1.5;
 /** Maximum backoff time in milliseconds. */
 constexpr Milliseconds kDefaultBackoffMaxDelay = Milliseconds(60 * 1000);
 
+/**
+ * The scale of adaptive delays after a network change. Retries come sooner
+ * but still back off, in case the new network is unusable too.
+ */
+constexpr double kNetworkChangeDelayScale = 0.25;
+
+/** The largest scale of adaptive delays under repeated overload. */
+constexpr double kMaxOverloadDelayScale = 4;
+
 }  // namespace
 
 ExponentialBackoff::ExponentialBackoff(const std::shared_ptr<AsyncQueue>& queue,
@@ -77,12 +87,31 @@ ExponentialBackoff::ExponentialBackoff(const std::shared_ptr<AsyncQueue>& queue,
                          kDefaultBackoffMaxDelay) {
 }
 
+void ExponentialBackoff::HandleNetworkChange() {
+  Reset();
+  if (adaptive_) {
+    delay_scale_ = kNetworkChangeDelayScale;
+  }
+}
+
+void ExponentialBackoff::HandleOverload() {
+  ResetToMax();
+  if (adaptive_) {
+    delay_scale_ = std::min(std::max(delay_scale_, 1.0) * 2,
+                            kMaxOverloadDelayScale);
+  }
+}
+
 void ExponentialBackoff::BackoffAndRun(AsyncQueue::Operation&& operation) {
   Cancel();
 
   // First schedule the block using the current base (which may be 0 and should
   // be honored as such).
-  Milliseconds desired_delay_with_jitter = current_base_ + GetDelayWithJitter();
+  Milliseconds desired_delay_with_jitter =
+      chr::duration_cast<Milliseconds>(
+          (current_base_ + GetDelayWithJitter()) * delay_scale_) +
+      extra_delay_;
+  extra_delay_ = Milliseconds{0};
 
   Milliseconds delay_so_far = chr::duration_cast<Milliseconds>(
       chr::steady_clock::now() - last_attempt_time_);
@@ -99,6 +128,10 @@ void ExponentialBackoff::BackoffAndRun(AsyncQueue::Operation&& operation) {
         "last attempt: %s ms ago)",
         remaining_delay.count(), current_base_.count(),
         desired_delay_with_jitter.count(), delay_so_far.count());
+    if (metrics_) {
+      metrics_->Record(util::MetricHistogram::kStreamBackoffMillis,
+                       static_cast<uint64_t>(remaining_delay.count()));
+    }
   }
 
   delayed_operation_ =
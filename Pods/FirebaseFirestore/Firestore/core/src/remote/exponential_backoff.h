@@ -25,6 +25,11 @@
 
 namespace firebase {
 namespace firestore {
+
+namespace util {
+class Metrics;
+}  // namespace util
+
 namespace remote {
 
 /**
@@ -38,6 +43,11 @@ namespace remote {
  * added to the base delay. This prevents clients from accidentally
  * synchronizing their delays causing spikes of load to the backend.
  *
+ * When adaptive, the delays are also scaled by feedback on the connection:
+ * they shrink after the network changed, since the failure most likely came
+ * from the old network, grow beyond `max_delay` while the backend reports
+ * that it is overloaded, and return to normal once a connection is healthy.
+ *
  */
 class ExponentialBackoff {
  public:
@@ -86,6 +96,47 @@ class ExponentialBackoff {
     current_base_ = max_delay_;
   }
 
+  /**
+   * Adds the given delay to the very next `BackoffAndRun`, on top of the
+   * backoff delay and its jitter.
+   */
+  void ExtendNextDelay(util::AsyncQueue::Milliseconds delay) {
+    extra_delay_ = delay;
+  }
+
+  /** Enables the scaling of delays by `Handle*` feedback. */
+  void set_adaptive(bool adaptive) {
+    adaptive_ = adaptive;
+    if (!adaptive) {
+      delay_scale_ = 1;
+    }
+  }
+
+  /**
+   * Records the delay of every backoff into the given metrics, which must
+   * outlive this object. Null disables recording.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+  }
+
+  /**
+   * Notes that the device switched networks: restarts the backoff curve and,
+   * when adaptive, shortens its delays until a connection is healthy.
+   */
+  void HandleNetworkChange();
+
+  /**
+   * Notes that the backend is overloaded (RESOURCE_EXHAUSTED): uses the
+   * maximum delay and, when adaptive, stretches it further on each repeat.
+   */
+  void HandleOverload();
+
+  /** Notes that a connection has been healthy, undoing any scaling. */
+  void HandleHealthyConnection() {
+    delay_scale_ = 1;
+  }
+
   /**
    * Waits for `current_base` seconds (which may be zero), increases the delay
    * and runs the specified operation. If there was a pending operation waiting
@@ -110,10 +161,15 @@ class ExponentialBackoff {
 
   const double backoff_factor_;
   Milliseconds current_base_{0};
+  Milliseconds extra_delay_{0};
   const Milliseconds initial_delay_;
   const Milliseconds max_delay_;
   util::SecureRandom secure_random_;
   std::chrono::steady_clock::time_point last_attempt_time_;
+
+  bool adaptive_ = false;
+  double delay_scale_ = 1;
+  util::Metrics* metrics_ = nullptr;
 };
 
 }  // namespace remote
@@ -32,6 +32,7 @@
 #include "Firestore/core/src/util/filesystem.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
 #include "Firestore/core/src/util/warnings.h"
@@ -241,9 +242,23 @@ GrpcConnection::GrpcConnection(
       grpc_queue_{NOT_NULL(grpc_queue)},
       connectivity_monitor_{NOT_NULL(connectivity_monitor)},
       firebase_metadata_provider_{NOT_NULL(firebase_metadata_provider)} {
+  channels_.resize(1);
   RegisterConnectivityMonitor();
 }
 
+void GrpcConnection::set_channel_count(size_t channel_count) {
+  HARD_ASSERT(active_calls_.empty(),
+              "Channel count must be set before creating any calls");
+  channels_.clear();
+  channels_.resize(std::max<size_t>(channel_count, 1));
+}
+
+void GrpcConnection::Prewarm() {
+  Channel& channel = channels_[0];
+  EnsureActiveStub(channel);
+  channel.grpc_channel->GetState(/*try_to_connect=*/true);
+}
+
 void GrpcConnection::Shutdown() {
   // Fast finish any pending calls. This will not trigger the observers.
   // Calls may unregister themselves on finish, so make a protective copy.
@@ -285,15 +300,59 @@ std::unique_ptr<grpc::ClientContext> GrpcConnection::CreateContext(
   return context;
 }
 
-void GrpcConnection::EnsureActiveStub() {
+size_t GrpcConnection::SelectChannel(CallType type) {
+  size_t index = 0;
+  if (type == CallType::kRequest && channels_.size() > 1) {
+    index = 1;
+    for (size_t i = 2; i < channels_.size(); ++i) {
+      if (channels_[i].stats.active_calls <
+          channels_[index].stats.active_calls) {
+        index = i;
+      }
+    }
+  }
+
+  EnsureActiveStub(channels_[index]);
+  return index;
+}
+
+void GrpcConnection::EnsureActiveStub(Channel& channel) {
   // TODO(varconst): find out in which cases a gRPC channel might shut down.
   // This might be overkill.
-  if (!grpc_channel_ || grpc_channel_->GetState(/*try_to_connect=*/false) ==
-                            GRPC_CHANNEL_SHUTDOWN) {
+  if (!channel.grpc_channel ||
+      channel.grpc_channel->GetState(/*try_to_connect=*/false) ==
+          GRPC_CHANNEL_SHUTDOWN) {
     LOG_DEBUG("Creating Firestore stub.");
-    grpc_channel_ = CreateChannel();
-    grpc_stub_ = absl::make_unique<grpc::GenericStub>(grpc_channel_);
+    channel.grpc_channel = CreateChannel();
+    channel.grpc_stub =
+        absl::make_unique<grpc::GenericStub>(channel.grpc_channel);
+  }
+}
+
+void GrpcConnection::TrackCall(GrpcCall* call, size_t channel_index) {
+  call_channels_[call] = channel_index;
+
+  GrpcChannelStats& stats = channels_[channel_index].stats;
+  ++stats.active_calls;
+  ++stats.total_calls;
+  if (stats.active_calls > stats.peak_active_calls) {
+    stats.peak_active_calls = stats.active_calls;
+    LOG_DEBUG("gRPC channel %s reached %s concurrent calls", channel_index,
+              stats.active_calls);
+  }
+  if (metrics_) {
+    metrics_->Record(util::MetricHistogram::kGrpcConcurrentCalls,
+                     stats.active_calls);
+  }
+}
+
+std::vector<GrpcChannelStats> GrpcConnection::GetChannelStats() const {
+  std::vector<GrpcChannelStats> result;
+  result.reserve(channels_.size());
+  for (const Channel& channel : channels_) {
+    result.push_back(channel.stats);
   }
+  return result;
 }
 
 std::shared_ptr<grpc::Channel> GrpcConnection::CreateChannel() const {
@@ -304,6 +363,11 @@ std::shared_ptr<grpc::Channel> GrpcConnection::CreateChannel() const {
   // the OS will usually notify gRPC when a connection dies. But not always.
   // This acts as a failsafe.)
   args.SetInt(GRPC_ARG_KEEPALIVE_TIME_MS, 30 * 1000);
+  if (channels_.size() > 1) {
+    // Channels with identical arguments otherwise share their connection,
+    // which would defeat the purpose of the pool.
+    args.SetInt(GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL, 1);
+  }
 
   const HostConfig* host_config = Config().find(host);
   if (!host_config) {
@@ -337,13 +401,15 @@ std::unique_ptr<GrpcStream> GrpcConnection::CreateStream(
     const AuthToken& auth_token,
     const std::string& app_check_token,
     GrpcStreamObserver* observer) {
-  EnsureActiveStub();
+  size_t index = SelectChannel(CallType::kStream);
 
   auto context = CreateContext(auth_token, app_check_token);
-  auto call =
-      grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
-  return absl::make_unique<GrpcStream>(std::move(context), std::move(call),
-                                       worker_queue_, this, observer);
+  auto call = channels_[index].grpc_stub->PrepareCall(
+      context.get(), MakeString(rpc_name), grpc_queue_);
+  auto stream = absl::make_unique<GrpcStream>(
+      std::move(context), std::move(call), worker_queue_, this, observer);
+  TrackCall(stream.get(), index);
+  return stream;
 }
 
 std::unique_ptr<GrpcUnaryCall> GrpcConnection::CreateUnaryCall(
@@ -351,13 +417,15 @@ std::unique_ptr<GrpcUnaryCall> GrpcConnection::CreateUnaryCall(
     const AuthToken& auth_token,
     const std::string& app_check_token,
     const grpc::ByteBuffer& message) {
-  EnsureActiveStub();
+  size_t index = SelectChannel(CallType::kRequest);
 
   auto context = CreateContext(auth_token, app_check_token);
-  auto call = grpc_stub_->PrepareUnaryCall(context.get(), MakeString(rpc_name),
-                                           message, grpc_queue_);
-  return absl::make_unique<GrpcUnaryCall>(std::move(context), std::move(call),
-                                          worker_queue_, this, message);
+  auto call = channels_[index].grpc_stub->PrepareUnaryCall(
+      context.get(), MakeString(rpc_name), message, grpc_queue_);
+  auto unary_call = absl::make_unique<GrpcUnaryCall>(
+      std::move(context), std::move(call), worker_queue_, this, message);
+  TrackCall(unary_call.get(), index);
+  return unary_call;
 }
 
 std::unique_ptr<GrpcStreamingReader> GrpcConnection::CreateStreamingReader(
@@ -365,13 +433,15 @@ std::unique_ptr<GrpcStreamingReader> GrpcConnection::CreateStreamingReader(
     const AuthToken& auth_token,
     const std::string& app_check_token,
     const grpc::ByteBuffer& message) {
-  EnsureActiveStub();
+  size_t index = SelectChannel(CallType::kRequest);
 
   auto context = CreateContext(auth_token, app_check_token);
-  auto call =
-      grpc_stub_->PrepareCall(context.get(), MakeString(rpc_name), grpc_queue_);
-  return absl::make_unique<GrpcStreamingReader>(
+  auto call = channels_[index].grpc_stub->PrepareCall(
+      context.get(), MakeString(rpc_name), grpc_queue_);
+  auto reader = absl::make_unique<GrpcStreamingReader>(
       std::move(context), std::move(call), worker_queue_, this, message);
+  TrackCall(reader.get(), index);
+  return reader;
 }
 
 void GrpcConnection::RegisterConnectivityMonitor() {
@@ -388,7 +458,9 @@ void GrpcConnection::RegisterConnectivityMonitor() {
         // connection before eventually failing. Note that gRPC Objective-C
         // client does the same thing:
         // https://github.com/grpc/grpc/blob/fe11db09575f2dfbe1f88cd44bd417acc168e354/src/objective-c/GRPCClient/private/GRPCHost.m#L309-L314
-        grpc_channel_.reset();
+        for (Channel& channel : channels_) {
+          channel.grpc_channel.reset();
+        }
       });
 }
 
@@ -400,6 +472,12 @@ void GrpcConnection::Unregister(GrpcCall* call) {
   auto found = std::find(active_calls_.begin(), active_calls_.end(), call);
   HARD_ASSERT(found != active_calls_.end(), "Missing a gRPC call");
   active_calls_.erase(found);
+
+  auto channel = call_channels_.find(call);
+  if (channel != call_channels_.end()) {
+    --channels_[channel->second].stats.active_calls;
+    call_channels_.erase(channel);
+  }
 }
 
 void GrpcConnection::SetClientLanguage(std::string language_token) {
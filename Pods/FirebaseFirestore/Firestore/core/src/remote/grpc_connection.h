@@ -43,17 +43,41 @@ SUPPRESS_END()
 
 namespace firebase {
 namespace firestore {
+
+namespace util {
+class Metrics;
+}  // namespace util
+
 namespace remote {
 
 class FirebaseMetadataProvider;
 
+/** Load counters of one gRPC channel of a `GrpcConnection`. */
+struct GrpcChannelStats {
+  /** The calls in progress, each of which is an HTTP/2 stream. */
+  size_t active_calls = 0;
+
+  /** The most calls that were ever in progress at once. */
+  size_t peak_active_calls = 0;
+
+  /** The calls started on the channel since it was created. */
+  size_t total_calls = 0;
+};
+
 // PORTING NOTE: this class has limited resemblance to `GrpcConnection` in Web
 // client. However, unlike Web client, it's not meant to hide different
 // implementations of a `Connection` under a single interface.
 
 /**
- * Creates and owns gRPC objects (channel and stub) necessary to produce a
+ * Creates and owns gRPC objects (channels and stubs) necessary to produce a
  * `GrpcStream`.
+ *
+ * By default all calls share a single channel. With a larger channel count,
+ * the long-lived watch and write streams keep the first channel to
+ * themselves, and unary calls and streaming reads go to the least loaded of
+ * the other channels. Each channel has a connection of its own, so that a
+ * large response to a read does not hold up the latency-sensitive streams
+ * behind HTTP/2 flow control.
  */
 class GrpcConnection {
  public:
@@ -92,6 +116,31 @@ class GrpcConnection {
   void Register(GrpcCall* call);
   void Unregister(GrpcCall* call);
 
+  /**
+   * Sets how many channels calls are spread over. Zero and one use a single
+   * channel for all calls. Call before creating any streams or calls.
+   */
+  void set_channel_count(size_t channel_count);
+
+  /**
+   * Records the number of calls in progress on the chosen channel each time a
+   * call starts into the given metrics, which must outlive the connection.
+   * Null disables this.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+  }
+
+  /**
+   * Starts connecting the channel of the streams in the background: gRPC
+   * resolves the host and performs the TCP and TLS handshakes on its own
+   * threads, so that the first stream does not wait for them.
+   */
+  void Prewarm();
+
+  /** Returns the load counters of each channel, in channel order. */
+  std::vector<GrpcChannelStats> GetChannelStats() const;
+
   static void SetClientLanguage(std::string language_token);
 
   /**
@@ -112,8 +161,30 @@ class GrpcConnection {
   std::unique_ptr<grpc::ClientContext> CreateContext(
       const credentials::AuthToken& auth_token,
       const std::string& app_check_token) const;
+  enum class CallType {
+    /** The watch and write streams, which are long-lived. */
+    kStream,
+    /** Unary calls and streaming reads, which complete on their own. */
+    kRequest,
+  };
+
+  struct Channel {
+    std::shared_ptr<grpc::Channel> grpc_channel;
+    std::unique_ptr<grpc::GenericStub> grpc_stub;
+    GrpcChannelStats stats;
+  };
+
   std::shared_ptr<grpc::Channel> CreateChannel() const;
-  void EnsureActiveStub();
+
+  /**
+   * Picks the channel for a new call of the given type, making sure it has an
+   * active stub, and returns its index.
+   */
+  size_t SelectChannel(CallType type);
+  void EnsureActiveStub(Channel& channel);
+
+  /** Accounts `call` to the channel at `channel_index` until it finishes. */
+  void TrackCall(GrpcCall* call, size_t channel_index);
 
   void RegisterConnectivityMonitor();
 
@@ -121,11 +192,13 @@ class GrpcConnection {
   std::shared_ptr<util::AsyncQueue> worker_queue_;
   grpc::CompletionQueue* grpc_queue_ = nullptr;
 
-  std::shared_ptr<grpc::Channel> grpc_channel_;
-  std::unique_ptr<grpc::GenericStub> grpc_stub_;
+  std::vector<Channel> channels_;
 
   ConnectivityMonitor* connectivity_monitor_ = nullptr;
   std::vector<GrpcCall*> active_calls_;
+  std::unordered_map<GrpcCall*, size_t> call_channels_;
+
+  util::Metrics* metrics_ = nullptr;
 
   FirebaseMetadataProvider* firebase_metadata_provider_ = nullptr;
 };
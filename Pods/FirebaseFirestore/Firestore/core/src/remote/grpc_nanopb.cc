@@ -16,6 +16,8 @@
 
 #include "Firestore/core/src/remote/grpc_nanopb.h"
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 
 #include "Firestore/core/include/firebase/firestore/firestore_errors.h"
@@ -28,13 +30,23 @@ namespace firebase {
 namespace firestore {
 namespace remote {
 
-using nanopb::ByteString;
-using nanopb::ByteStringWriter;
 using util::Status;
+using util::StatusOr;
+
+namespace {
+
+// Chunks no larger than this are copied into a slice of their own rather than
+// shared, as sharing one costs an allocation.
+constexpr size_t kMaxBytesToCopy = 511;
+
+void DeleteCord(void* cord) {
+  delete static_cast<absl::Cord*>(cord);
+}
+
+}  // namespace
 
 ByteBufferReader::ByteBufferReader(const grpc::ByteBuffer& buffer) {
-  std::vector<grpc::Slice> slices;
-  grpc::Status status = buffer.Dump(&slices);
+  grpc::Status status = buffer.Dump(&slices_);
   // Conversion may fail if compression is used and gRPC tries to decompress an
   // ill-formed buffer.
   if (!status.ok()) {
@@ -45,14 +57,44 @@ ByteBufferReader::ByteBufferReader(const grpc::ByteBuffer& buffer) {
     return;
   }
 
-  ByteStringWriter writer;
-  writer.Reserve(buffer.Length());
-  for (const auto& slice : slices) {
-    writer.Append(slice.begin(), slice.size());
+  if (slices_.size() == 1) {
+    stream_ = pb_istream_from_buffer(slices_[0].begin(), slices_[0].size());
+    return;
+  }
+
+  // Sizes are taken from the slices, which are decompressed if need be.
+  stream_.callback = ReadFromSlices;
+  stream_.state = this;
+  for (const grpc::Slice& slice : slices_) {
+    stream_.bytes_left += slice.size();
   }
+}
 
-  bytes_ = writer.Release();
-  stream_ = pb_istream_from_buffer(bytes_.data(), bytes_.size());
+bool ByteBufferReader::ReadFromSlices(pb_istream_t* stream,
+                                      pb_byte_t* buf,
+                                      size_t count) {
+  auto reader = static_cast<ByteBufferReader*>(stream->state);
+  while (count > 0) {
+    if (reader->slice_index_ == reader->slices_.size()) {
+      return false;
+    }
+
+    const grpc::Slice& slice = reader->slices_[reader->slice_index_];
+    size_t available = slice.size() - reader->slice_offset_;
+    size_t n = std::min(count, available);
+    if (buf != nullptr) {
+      std::memcpy(buf, slice.begin() + reader->slice_offset_, n);
+      buf += n;
+    }
+
+    count -= n;
+    reader->slice_offset_ += n;
+    if (reader->slice_offset_ == slice.size()) {
+      ++reader->slice_index_;
+      reader->slice_offset_ = 0;
+    }
+  }
+  return true;
 }
 
 void ByteBufferReader::Read(const pb_field_t* fields, void* dest_struct) {
@@ -63,6 +105,50 @@ void ByteBufferReader::Read(const pb_field_t* fields, void* dest_struct) {
   }
 }
 
+StatusOr<absl::Cord> MakeCord(const grpc::ByteBuffer& buffer) {
+  std::vector<grpc::Slice> slices;
+  grpc::Status status = buffer.Dump(&slices);
+  if (!status.ok()) {
+    Status error{Error::kErrorInternal,
+                 "Trying to convert an invalid grpc::ByteBuffer"};
+    error.CausedBy(ConvertStatus(status));
+    return error;
+  }
+
+  absl::Cord result;
+  for (grpc::Slice& slice : slices) {
+    absl::string_view data{reinterpret_cast<const char*>(slice.begin()),
+                           slice.size()};
+    if (data.size() <= kMaxBytesToCopy) {
+      result.Append(data);
+      continue;
+    }
+
+    // The releaser owns a reference to the slice, which keeps `data` alive.
+    result.Append(absl::MakeCordFromExternal(
+        data, [slice = std::move(slice)](absl::string_view) {}));
+  }
+  return result;
+}
+
+grpc::ByteBuffer MakeByteBuffer(const absl::Cord& cord) {
+  std::vector<grpc::Slice> slices;
+  size_t offset = 0;
+  for (absl::string_view chunk : cord.Chunks()) {
+    if (chunk.size() <= kMaxBytesToCopy) {
+      slices.emplace_back(chunk.data(), chunk.size());
+    } else {
+      // A single-chunk subcord shares the chunk, and flattening it is free.
+      auto piece = new absl::Cord(cord.Subcord(offset, chunk.size()));
+      absl::string_view data = piece->Flatten();
+      slices.emplace_back(const_cast<char*>(data.data()), data.size(),
+                          DeleteCord, piece);
+    }
+    offset += chunk.size();
+  }
+  return grpc::ByteBuffer{slices.data(), slices.size()};
+}
+
 namespace {
 
 bool AppendToGrpcBuffer(pb_ostream_t* stream,
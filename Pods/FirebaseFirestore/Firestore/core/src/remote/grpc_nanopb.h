@@ -20,12 +20,15 @@
 #include <pb.h>
 #include <pb_decode.h>
 
+#include <cstddef>
 #include <vector>
 
 #include "Firestore/core/src/nanopb/byte_string.h"
 #include "Firestore/core/src/nanopb/message.h"
 #include "Firestore/core/src/nanopb/reader.h"
 #include "Firestore/core/src/nanopb/writer.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "absl/strings/cord.h"
 #include "grpcpp/support/byte_buffer.h"
 
 namespace firebase {
@@ -36,16 +39,29 @@ namespace remote {
 class ByteBufferReader : public nanopb::Reader {
  public:
   /**
-   * Copies the given `buffer` and associates the resulting stream with this
-   * `ByteBufferReader`.
+   * Associates the slices of the given `buffer` with this `ByteBufferReader`.
+   *
+   * The slices are shared with `buffer` rather than copied into one
+   * contiguous block, so each string and bytes field is copied only once,
+   * straight from the slices into the decoded proto.
    */
-  // TODO(varconst): avoid copying the buffer.
   explicit ByteBufferReader(const grpc::ByteBuffer& buffer);
 
+  // The stream refers to this reader.
+  ByteBufferReader(const ByteBufferReader&) = delete;
+  ByteBufferReader& operator=(const ByteBufferReader&) = delete;
+
   void Read(const pb_field_t* fields, void* dest_struct) override;
 
  private:
-  nanopb::ByteString bytes_;
+  /** The callback of a stream that spans several slices. */
+  static bool ReadFromSlices(pb_istream_t* stream,
+                             pb_byte_t* buf,
+                             size_t count);
+
+  std::vector<grpc::Slice> slices_;
+  size_t slice_index_ = 0;
+  size_t slice_offset_ = 0;
   pb_istream_t stream_{};
 };
 
@@ -72,6 +88,21 @@ grpc::ByteBuffer MakeByteBuffer(const nanopb::Message<T>& message) {
   return writer.Release();
 }
 
+/**
+ * Wraps the slices of the given `buffer` into an `absl::Cord` without copying
+ * them: each chunk of the cord holds a reference to the slice it views.
+ *
+ * Fails if the slices can't be obtained, e.g. if `buffer` is compressed and
+ * ill-formed.
+ */
+util::StatusOr<absl::Cord> MakeCord(const grpc::ByteBuffer& buffer);
+
+/**
+ * Wraps the chunks of the given `cord` into a `grpc::ByteBuffer`. Large chunks
+ * are shared rather than copied: each slice holds a reference to the cord.
+ */
+grpc::ByteBuffer MakeByteBuffer(const absl::Cord& cord);
+
 }  // namespace remote
 }  // namespace firestore
 }  // namespace firebase
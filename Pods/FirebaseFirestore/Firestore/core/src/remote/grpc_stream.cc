@@ -139,6 +139,25 @@ void GrpcStream::Write(grpc::ByteBuffer&& message) {
   MaybeWrite(buffered_writer_.EnqueueWrite(std::move(message)));
 }
 
+void GrpcStream::Write(grpc::ByteBuffer&& message,
+                       const grpc::WriteOptions& options) {
+  MaybeWrite(buffered_writer_.EnqueueWrite(std::move(message), options));
+}
+
+void GrpcStream::WriteBatch(std::vector<grpc::ByteBuffer>&& messages,
+                            size_t compression_threshold) {
+  for (size_t i = 0; i < messages.size(); ++i) {
+    grpc::WriteOptions options;
+    if (i + 1 < messages.size()) {
+      options.set_buffer_hint();
+    }
+    if (messages[i].Length() < compression_threshold) {
+      options.set_no_compression();
+    }
+    MaybeWrite(buffered_writer_.EnqueueWrite(std::move(messages[i]), options));
+  }
+}
+
 void GrpcStream::WriteLast(grpc::ByteBuffer&& message) {
   grpc::WriteOptions options;
   options.set_last_message();
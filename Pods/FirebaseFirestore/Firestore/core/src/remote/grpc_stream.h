@@ -133,6 +133,16 @@ class GrpcStream : public GrpcCall {
 
   // Can only be called once the stream has opened.
   void Write(grpc::ByteBuffer&& message);
+  void Write(grpc::ByteBuffer&& message, const grpc::WriteOptions& options);
+
+  /**
+   * Writes the given messages in order, hinting gRPC to buffer all but the
+   * last one so that they can be coalesced into as few network writes as
+   * possible. Messages smaller than `compression_threshold` bytes are sent
+   * uncompressed. Can only be called once the stream has opened.
+   */
+  void WriteBatch(std::vector<grpc::ByteBuffer>&& messages,
+                  size_t compression_threshold = 0);
 
   /**
    * Writes the given message and indicates to the server that no more write
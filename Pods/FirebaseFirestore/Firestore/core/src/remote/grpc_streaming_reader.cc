@@ -48,8 +48,22 @@ GrpcStreamingReader::GrpcStreamingReader(
 void GrpcStreamingReader::Start(size_t expected_response_count,
                                 ResponsesCallback&& responses_callback,
                                 CloseCallback&& close_callback) {
-  expected_response_count_ = expected_response_count;
   responses_callback_ = std::move(responses_callback);
+  Start(
+      expected_response_count,
+      [this](const grpc::ByteBuffer& message) {
+        responses_.push_back(message);
+      },
+      [this] { responses_callback_(responses_); }, std::move(close_callback));
+}
+
+void GrpcStreamingReader::Start(size_t expected_response_count,
+                                ResponseCallback&& response_callback,
+                                CompletionCallback&& completion_callback,
+                                CloseCallback&& close_callback) {
+  expected_response_count_ = expected_response_count;
+  response_callback_ = std::move(response_callback);
+  completion_callback_ = std::move(completion_callback);
   close_callback_ = std::move(close_callback);
   stream_->Start();
 }
@@ -69,12 +83,12 @@ void GrpcStreamingReader::OnStreamStart() {
 }
 
 void GrpcStreamingReader::OnStreamRead(const grpc::ByteBuffer& message) {
-  // Accumulate responses, responses_callback_ will be fired if
-  // GrpcStreamingReader has received all the responses.
-  responses_.push_back(message);
-  if (responses_.size() == expected_response_count_) {
+  // completion_callback_ will be fired once GrpcStreamingReader has received
+  // all the responses.
+  response_callback_(message);
+  if (++received_response_count_ == expected_response_count_) {
     callback_fired_ = true;
-    responses_callback_(responses_);
+    completion_callback_();
   }
 }
 
@@ -84,7 +98,7 @@ void GrpcStreamingReader::OnStreamFinish(const util::Status& status) {
   // but we still need to return an empty vector of documents.
   if (status.ok() && !callback_fired_) {
     callback_fired_ = true;
-    responses_callback_(responses_);
+    completion_callback_();
   }
 
   // Invoking the callback ends this reader's lifetime.
@@ -42,12 +42,15 @@ class GrpcConnection;
 
 /**
  * Sends a single request to the server, reads one or more streaming server
- * responses, and invokes the given callback with the accumulated responses.
+ * responses, and invokes the given callback with the accumulated responses or
+ * with each response as it arrives.
  */
 class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
  public:
   using ResponsesT = grpc::ByteBuffer;
-  using ResponsesCallback = std::function<void(const std::vector<ResponsesT>)>;
+  using ResponsesCallback = std::function<void(const std::vector<ResponsesT>&)>;
+  using ResponseCallback = std::function<void(const ResponsesT&)>;
+  using CompletionCallback = std::function<void()>;
   using CloseCallback = std::function<void(const util::Status&, bool)>;
 
   GrpcStreamingReader(
@@ -66,6 +69,18 @@ class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
              ResponsesCallback&& responses_callback,
              CloseCallback&& close_callback);
 
+  /**
+   * Starts the call without accumulating the responses: `response_callback`
+   * is invoked with each response as it arrives, so that the caller can
+   * decode it and let go of its buffer, and `completion_callback` once all
+   * expected responses have arrived. If the call fails, `close_callback` is
+   * invoked with a non-ok status.
+   */
+  void Start(size_t expected_response_count,
+             ResponseCallback&& response_callback,
+             CompletionCallback&& completion_callback,
+             CloseCallback&& close_callback);
+
   /**
    * If the call is in progress, attempts to cancel the call; otherwise, it's
    * a no-op. Cancellation is done on best-effort basis; however:
@@ -104,9 +119,14 @@ class GrpcStreamingReader : public GrpcCall, public GrpcStreamObserver {
   grpc::ByteBuffer request_;
 
   size_t expected_response_count_;
+  size_t received_response_count_ = 0;
   bool callback_fired_ = false;
-  ResponsesCallback responses_callback_;
+  ResponseCallback response_callback_;
+  CompletionCallback completion_callback_;
   CloseCallback close_callback_;
+
+  // Only used by the accumulating `Start`.
+  ResponsesCallback responses_callback_;
   std::vector<ResponsesT> responses_;
 };
 
@@ -80,6 +80,10 @@ class OnlineStateTracker {
    */
   void UpdateState(model::OnlineState new_state);
 
+  model::OnlineState state() const {
+    return state_;
+  }
+
  private:
   void SetAndBroadcast(model::OnlineState new_state);
   void LogClientOfflineWarningIfNecessary(const std::string& reason);
@@ -17,8 +17,14 @@
 #include "Firestore/core/src/remote/remote_event.h"
 
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/local/target_data.h"
+#include "Firestore/core/src/model/database_id.h"
+#include "Firestore/core/src/remote/bloom_filter.h"
+#include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/statusor.h"
+#include "Firestore/core/src/util/string_format.h"
 
 namespace firebase {
 namespace firestore {
@@ -34,6 +40,8 @@ using model::MutableDocument;
 using model::SnapshotVersion;
 using model::TargetId;
 using nanopb::ByteString;
+using util::StatusOr;
+using util::StringFormat;
 
 // TargetChange
 
@@ -55,9 +63,10 @@ void TargetState::UpdateResumeToken(ByteString resume_token) {
 }
 
 TargetChange TargetState::ToTargetChange() const {
-  DocumentKeySet added_documents;
-  DocumentKeySet modified_documents;
-  DocumentKeySet removed_documents;
+  // The changes are unordered, so collect the keys and sort them once.
+  std::vector<DocumentKey> added_documents;
+  std::vector<DocumentKey> modified_documents;
+  std::vector<DocumentKey> removed_documents;
 
   for (const auto& entry : document_changes_) {
     const DocumentKey& document_key = entry.first;
@@ -65,22 +74,24 @@ TargetChange TargetState::ToTargetChange() const {
 
     switch (change_type) {
       case DocumentViewChange::Type::Added:
-        added_documents = added_documents.insert(document_key);
+        added_documents.push_back(document_key);
         break;
       case DocumentViewChange::Type::Modified:
-        modified_documents = modified_documents.insert(document_key);
+        modified_documents.push_back(document_key);
         break;
       case DocumentViewChange::Type::Removed:
-        removed_documents = removed_documents.insert(document_key);
+        removed_documents.push_back(document_key);
         break;
       default:
         HARD_FAIL("Encountered invalid change type: %s", change_type);
     }
   }
 
-  return TargetChange{resume_token(), current(), std::move(added_documents),
-                      std::move(modified_documents),
-                      std::move(removed_documents)};
+  return TargetChange{
+      resume_token(), current(),
+      DocumentKeySet::FromValues(std::move(added_documents)),
+      DocumentKeySet::FromValues(std::move(modified_documents)),
+      DocumentKeySet::FromValues(std::move(removed_documents))};
 }
 
 void TargetState::ClearPendingChanges() {
@@ -215,7 +226,15 @@ void WatchChangeAggregator::HandleExistenceFilter(
   absl::optional<TargetData> target_data = TargetDataForActiveTarget(target_id);
   if (target_data) {
     const Target& target = target_data->target();
-    if (target.IsDocumentQuery()) {
+    if (!target_data->document_keys().empty() && expected_count == 0) {
+      // None of the watched documents exist.
+      for (const DocumentKey& key : target_data->document_keys()) {
+        RemoveDocumentFromTarget(
+            target_id, key,
+            MutableDocument::NoDocument(key, SnapshotVersion::None()));
+      }
+    } else if (target_data->document_keys().empty() &&
+               target.IsDocumentQuery()) {
       if (expected_count == 0) {
         // The existence filter told us the document does not exist. We deduce
         // that this document does not exist and apply a deleted document to our
@@ -234,9 +253,11 @@ void WatchChangeAggregator::HandleExistenceFilter(
       }
     } else {
       int current_size = GetCurrentDocumentCountForTarget(target_id);
-      if (current_size != expected_count) {
-        // Existence filter mismatch: We reset the mapping and raise a new
-        // snapshot with `isFromCache:true`.
+      if (current_size != expected_count &&
+          !ApplyBloomFilter(target_id, existence_filter.filter())) {
+        // Existence filter mismatch that the bloom filter, if any, could not
+        // explain: We reset the mapping and raise a new snapshot with
+        // `isFromCache:true`.
         ResetTarget(target_id);
         pending_target_resets_.insert(target_id);
       }
@@ -255,19 +276,26 @@ RemoteEvent WatchChangeAggregator::CreateRemoteEvent(
     absl::optional<TargetData> target_data =
         TargetDataForActiveTarget(target_id);
     if (target_data) {
-      if (target_state.current() && target_data->target().IsDocumentQuery()) {
+      if (target_state.current() &&
+          (!target_data->document_keys().empty() ||
+           target_data->target().IsDocumentQuery())) {
         // Document queries for document that don't exist can produce an empty
         // result set. To update our local cache, we synthesize a document
         // delete if we have not previously received the document. This resolves
         // the limbo state of the document, removing it from
         // SyncEngine::limbo_document_refs_.
-        DocumentKey key{target_data->target().path()};
-        if (pending_document_updates_.find(key) ==
-                pending_document_updates_.end() &&
-            !TargetContainsDocument(target_id, key)) {
-          RemoveDocumentFromTarget(
-              target_id, key,
-              MutableDocument::NoDocument(key, snapshot_version));
+        DocumentKeySet keys = target_data->document_keys();
+        if (keys.empty()) {
+          keys = keys.insert(DocumentKey{target_data->target().path()});
+        }
+        for (const DocumentKey& key : keys) {
+          if (pending_document_updates_.find(key) ==
+                  pending_document_updates_.end() &&
+              !TargetContainsDocument(target_id, key)) {
+            RemoveDocumentFromTarget(
+                target_id, key,
+                MutableDocument::NoDocument(key, snapshot_version));
+          }
         }
       }
 
@@ -278,7 +306,7 @@ RemoteEvent WatchChangeAggregator::CreateRemoteEvent(
     }
   }
 
-  DocumentKeySet resolved_limbo_documents;
+  std::vector<DocumentKey> resolved_limbo_documents;
 
   // We extract the set of limbo-only document updates as the GC logic
   // special-cases documents that do not appear in the target cache.
@@ -298,14 +326,15 @@ RemoteEvent WatchChangeAggregator::CreateRemoteEvent(
     }
 
     if (is_only_limbo_target) {
-      resolved_limbo_documents = resolved_limbo_documents.insert(entry.first);
+      resolved_limbo_documents.push_back(entry.first);
     }
   }
 
   RemoteEvent remote_event{snapshot_version, std::move(target_changes),
                            std::move(pending_target_resets_),
                            std::move(pending_document_updates_),
-                           std::move(resolved_limbo_documents)};
+                           DocumentKeySet::FromValues(
+                               std::move(resolved_limbo_documents))};
 
   // Re-initialize the current state to ensure that we do not modify the
   // generated `RemoteEvent`.
@@ -412,6 +441,47 @@ void WatchChangeAggregator::ResetTarget(TargetId target_id) {
   }
 }
 
+bool WatchChangeAggregator::ApplyBloomFilter(
+    TargetId target_id, const ExistenceFilter& existence_filter) {
+  const absl::optional<BloomFilterParameters>& parameters =
+      existence_filter.unchanged_names();
+  if (!parameters) {
+    return false;
+  }
+
+  StatusOr<BloomFilter> maybe_bloom_filter = BloomFilter::Create(
+      parameters->bitmap, parameters->padding, parameters->hash_count);
+  if (!maybe_bloom_filter.ok()) {
+    LOG_WARN("Applying bloom filter failed: %s",
+             maybe_bloom_filter.status().error_message());
+    return false;
+  }
+
+  const BloomFilter& bloom_filter = maybe_bloom_filter.ValueOrDie();
+  if (bloom_filter.bit_count() == 0) {
+    return false;
+  }
+
+  // The filter contains the documents that still match the target, so those
+  // it does not contain were deleted or no longer match. It may contain some
+  // that are gone as well, in which case the counts still differ.
+  const model::DatabaseId& database_id =
+      target_metadata_provider_->GetDatabaseId();
+  DocumentKeySet existing_keys =
+      target_metadata_provider_->GetRemoteKeysForTarget(target_id);
+  for (const DocumentKey& key : existing_keys) {
+    std::string document_path = StringFormat(
+        "projects/%s/databases/%s/documents/%s", database_id.project_id(),
+        database_id.database_id(), key.path().CanonicalString());
+    if (!bloom_filter.MightContain(document_path)) {
+      RemoveDocumentFromTarget(target_id, key, absl::nullopt);
+    }
+  }
+
+  return GetCurrentDocumentCountForTarget(target_id) ==
+         existence_filter.count();
+}
+
 bool WatchChangeAggregator::TargetContainsDocument(TargetId target_id,
                                                    const DocumentKey& key) {
   const DocumentKeySet& existing_keys =
@@ -62,6 +62,9 @@ class TargetMetadataProvider {
    */
   virtual absl::optional<local::TargetData> GetTargetDataForTarget(
       model::TargetId target_id) const = 0;
+
+  /** Returns the database the targets belong to. */
+  virtual const model::DatabaseId& GetDatabaseId() const = 0;
 };
 
 /**
@@ -374,6 +377,15 @@ class WatchChangeAggregator {
    */
   int GetCurrentDocumentCountForTarget(model::TargetId target_id);
 
+  /**
+   * Removes the documents that are not in the bloom filter of a mismatched
+   * existence filter from the target, and returns whether the target then has
+   * the expected number of documents. Returns false if the existence filter
+   * has no usable bloom filter.
+   */
+  bool ApplyBloomFilter(model::TargetId target_id,
+                        const ExistenceFilter& existence_filter);
+
   // PORTING NOTE: this method exists only for consistency with other platforms;
   // in C++, it's pretty much unnecessary.
   TargetState& EnsureTargetState(model::TargetId target_id);
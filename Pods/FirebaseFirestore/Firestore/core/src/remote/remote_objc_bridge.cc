@@ -52,6 +52,7 @@ using nanopb::Message;
 using nanopb::Reader;
 using remote::ByteBufferReader;
 using remote::Serializer;
+using util::Status;
 using util::StatusOr;
 
 // WatchStreamSerializer
@@ -238,30 +239,52 @@ StatusOr<std::vector<model::Document>>
 DatastoreSerializer::MergeLookupResponses(
     const std::vector<grpc::ByteBuffer>& responses) const {
   // Sort by key.
-  std::map<DocumentKey, Document> results;
+  LookupResults results;
 
   for (const auto& response : responses) {
-    ByteBufferReader reader{response};
-    auto message =
-        Message<google_firestore_v1_BatchGetDocumentsResponse>::TryParse(
-            &reader);
-
-    Document doc = serializer_.DecodeMaybeDocument(reader.context(), *message);
-    if (!reader.ok()) {
-      return reader.status();
+    Status status = MergeLookupResponse(response, &results);
+    if (!status.ok()) {
+      return status;
     }
+  }
+
+  StatusOr<std::vector<Document>> result{ToDocuments(std::move(results))};
+  return result;
+}
+
+Status DatastoreSerializer::MergeLookupResponse(
+    const grpc::ByteBuffer& response, LookupResults* results) const {
+  StatusOr<Document> doc = DecodeLookupResponse(response);
+  if (!doc.ok()) {
+    return doc.status();
+  }
 
-    results[doc->key()] = std::move(doc);
+  Document& decoded = doc.ValueOrDie();
+  (*results)[decoded->key()] = std::move(decoded);
+  return Status::OK();
+}
+
+StatusOr<Document> DatastoreSerializer::DecodeLookupResponse(
+    const grpc::ByteBuffer& response) const {
+  ByteBufferReader reader{response};
+  auto message =
+      Message<google_firestore_v1_BatchGetDocumentsResponse>::TryParse(&reader);
+
+  Document doc = serializer_.DecodeMaybeDocument(reader.context(), *message);
+  if (!reader.ok()) {
+    return reader.status();
   }
+  return doc;
+}
 
+std::vector<Document> DatastoreSerializer::ToDocuments(
+    LookupResults&& results) {
   std::vector<Document> docs;
   docs.reserve(results.size());
-  for (const auto& kv : results) {
-    docs.push_back(kv.second);
+  for (auto& kv : results) {
+    docs.push_back(std::move(kv.second));
   }
-
-  StatusOr<std::vector<Document>> result{std::move(docs)};
-  return result;
+  return docs;
 }
 
 }  // namespace remote
@@ -17,6 +17,7 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_OBJC_BRIDGE_H_
 
+#include <map>
 #include <memory>
 #include <string>
 #include <utility>
@@ -126,6 +127,8 @@ class DatastoreSerializer {
   nanopb::Message<google_firestore_v1_BatchGetDocumentsRequest>
   EncodeLookupRequest(const std::vector<model::DocumentKey>& keys) const;
 
+  using LookupResults = std::map<model::DocumentKey, model::Document>;
+
   /**
    * Merges results of the streaming read together. The array is sorted by the
    * document key.
@@ -133,6 +136,20 @@ class DatastoreSerializer {
   util::StatusOr<std::vector<model::Document>> MergeLookupResponses(
       const std::vector<grpc::ByteBuffer>& responses) const;
 
+  /**
+   * Decodes a single response of the streaming read into `results`, so that
+   * responses can be decoded as they arrive.
+   */
+  util::Status MergeLookupResponse(const grpc::ByteBuffer& response,
+                                   LookupResults* results) const;
+
+  /** Decodes the document of a single response of the streaming read. */
+  util::StatusOr<model::Document> DecodeLookupResponse(
+      const grpc::ByteBuffer& response) const;
+
+  /** Returns the documents of `results`, sorted by the document key. */
+  static std::vector<model::Document> ToDocuments(LookupResults&& results);
+
   const Serializer& serializer() const {
     return serializer_;
   }
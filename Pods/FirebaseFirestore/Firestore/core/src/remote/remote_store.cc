@@ -16,8 +16,10 @@
 
 #include "Firestore/core/src/remote/remote_store.h"
 
+#include <iterator>
 #include <string>
 #include <utility>
+#include <vector>
 
 #include "Firestore/core/src/core/transaction.h"
 #include "Firestore/core/src/local/local_store.h"
@@ -28,6 +30,7 @@
 #include "Firestore/core/src/util/error_apple.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/to_string.h"
 #include "absl/memory/memory.h"
 
@@ -42,6 +45,7 @@ using local::TargetData;
 using model::BatchId;
 using model::DocumentKeySet;
 using model::kBatchIdUnknown;
+using model::Mutation;
 using model::MutationBatch;
 using model::MutationBatchResult;
 using model::MutationResult;
@@ -56,7 +60,16 @@ using util::Status;
  * The maximum number of pending writes to allow.
  * TODO(b/35853402): Negotiate this value with the backend.
  */
-constexpr int kMaxPendingWrites = 10;
+constexpr size_t kMaxPendingWrites = 10;
+
+/** The maximum number of writes the backend accepts in one request. */
+constexpr size_t kMaxWritesPerRequest = 500;
+
+/**
+ * How long after a connectivity change a failing watch stream is assumed to
+ * have lost the connection that the change dropped.
+ */
+constexpr std::chrono::seconds kConnectivityChangeWindow{10};
 
 RemoteStore::RemoteStore(
     LocalStore* local_store,
@@ -67,7 +80,8 @@ RemoteStore::RemoteStore(
     : local_store_{local_store},
       datastore_{std::move(datastore)},
       online_state_tracker_{worker_queue, std::move(online_state_handler)},
-      connectivity_monitor_{NOT_NULL(connectivity_monitor)} {
+      connectivity_monitor_{NOT_NULL(connectivity_monitor)},
+      max_pending_writes_{kMaxPendingWrites} {
   datastore_->Start();
 
   // Create streams (but note they're not started yet)
@@ -90,6 +104,11 @@ void RemoteStore::Start() {
           return;
         }
 
+        last_connectivity_change_ = std::chrono::steady_clock::now();
+        backoff_skip_available_ = true;
+        watch_stream_->HandleNetworkChange();
+        write_stream_->HandleNetworkChange();
+
         if (CanUseNetwork()) {
           LOG_DEBUG("RemoteStore %s restarting streams as connectivity changed",
                     this);
@@ -133,6 +152,8 @@ void RemoteStore::DisableNetworkInternal() {
               write_pipeline_.size());
     write_pipeline_.clear();
   }
+  sent_batch_count_ = 0;
+  write_request_batch_counts_.clear();
 
   CleanUpWatchStreamState();
 }
@@ -193,7 +214,18 @@ void RemoteStore::SendWatchRequest(const TargetData& target_data) {
   // We need to increment the expected number of pending responses we're due
   // from watch so we wait for the ack to process any messages from this target.
   watch_change_aggregator_->RecordPendingTargetRequest(target_data.target_id());
-  watch_stream_->WatchQuery(target_data);
+  watch_stream_->WatchQuery(PrepareWatchRequest(target_data));
+}
+
+TargetData RemoteStore::PrepareWatchRequest(
+    const TargetData& target_data) const {
+  if (target_data.resume_token().empty()) {
+    return target_data;
+  }
+
+  size_t expected_count =
+      GetRemoteKeysForTarget(target_data.target_id()).size();
+  return target_data.WithExpectedCount(static_cast<int32_t>(expected_count));
 }
 
 void RemoteStore::SendUnwatchRequest(TargetId target_id) {
@@ -222,11 +254,41 @@ void RemoteStore::CleanUpWatchStreamState() {
   watch_change_aggregator_.reset();
 }
 
+bool RemoteStore::IsTransientConnectivityError(const Status& status) {
+  if (!fast_reconnect_enabled_ || !backoff_skip_available_ ||
+      status.code() != Error::kErrorUnavailable) {
+    return false;
+  }
+
+  // Only skip the backoff once per change, so that a network that is still
+  // unusable does not turn into a tight reconnect loop.
+  backoff_skip_available_ = false;
+  return std::chrono::steady_clock::now() - last_connectivity_change_ <
+         kConnectivityChangeWindow;
+}
+
 void RemoteStore::OnWatchStreamOpen() {
   // Restore any existing watches.
+  if (!fast_reconnect_enabled_) {
+    for (const auto& kv : listen_targets_) {
+      SendWatchRequest(kv.second);
+    }
+    return;
+  }
+
+  std::vector<TargetData> requests;
+  requests.reserve(listen_targets_.size());
   for (const auto& kv : listen_targets_) {
-    SendWatchRequest(kv.second);
+    watch_change_aggregator_->RecordPendingTargetRequest(kv.first);
+    requests.push_back(PrepareWatchRequest(kv.second));
   }
+
+  std::vector<const TargetData*> targets;
+  targets.reserve(requests.size());
+  for (const TargetData& request : requests) {
+    targets.push_back(&request);
+  }
+  watch_stream_->WatchQueries(targets);
 }
 
 void RemoteStore::OnWatchStreamClose(const Status& status) {
@@ -243,6 +305,11 @@ void RemoteStore::OnWatchStreamClose(const Status& status) {
   if (ShouldStartWatchStream()) {
     online_state_tracker_.HandleWatchStreamFailure(status);
 
+    if (IsTransientConnectivityError(status)) {
+      LOG_DEBUG("RemoteStore %s reconnecting watch stream without backoff",
+                this);
+      watch_stream_->InhibitBackoff();
+    }
     StartWatchStream();
   } else {
     // We don't need to restart the watch stream because there are no active
@@ -255,6 +322,9 @@ void RemoteStore::OnWatchStreamClose(const Status& status) {
 void RemoteStore::OnWatchStreamChange(const WatchChange& change,
                                       const SnapshotVersion& snapshot_version) {
   // Mark the connection as Online because we got a message from the server.
+  if (online_state_tracker_.state() != OnlineState::Online) {
+    watch_stream_->HandleHealthyConnection();
+  }
   online_state_tracker_.UpdateState(OnlineState::Online);
 
   if (change.type() == WatchChange::Type::TargetChange) {
@@ -330,7 +400,8 @@ void RemoteStore::RaiseWatchSnapshot(const SnapshotVersion& snapshot_version) {
     // state.
     target_data =
         TargetData(target_data.target(), target_id,
-                   target_data.sequence_number(), target_data.purpose());
+                   target_data.sequence_number(), target_data.purpose())
+            .WithDocumentKeys(target_data.document_keys());
     listen_targets_[target_id] = target_data;
 
     // Cause a hard reset by unwatching and rewatching immediately, but
@@ -341,9 +412,11 @@ void RemoteStore::RaiseWatchSnapshot(const SnapshotVersion& snapshot_version) {
     // mismatch, but don't actually retain that in listen_targets_. This ensures
     // that we flag the first re-listen this way without impacting future
     // listens of this target (that might happen e.g. on reconnect).
-    TargetData request_target_data(target_data.target(), target_id,
-                                   target_data.sequence_number(),
-                                   QueryPurpose::ExistenceFilterMismatch);
+    TargetData request_target_data =
+        TargetData(target_data.target(), target_id,
+                   target_data.sequence_number(),
+                   QueryPurpose::ExistenceFilterMismatch)
+            .WithDocumentKeys(target_data.document_keys());
     SendWatchRequest(request_target_data);
   }
 
@@ -384,13 +457,17 @@ void RemoteStore::FillWritePipeline() {
     last_batch_id_retrieved = batch->batch_id();
   }
 
+  if (write_stream_->IsOpen() && write_stream_->handshake_complete()) {
+    SendPendingWrites();
+  }
+
   if (ShouldStartWriteStream()) {
     StartWriteStream();
   }
 }
 
 bool RemoteStore::CanAddToWritePipeline() const {
-  return CanUseNetwork() && write_pipeline_.size() < kMaxPendingWrites;
+  return CanUseNetwork() && write_pipeline_.size() < max_pending_writes_;
 }
 
 void RemoteStore::AddToWritePipeline(const MutationBatch& batch) {
@@ -398,9 +475,59 @@ void RemoteStore::AddToWritePipeline(const MutationBatch& batch) {
               "AddToWritePipeline called when pipeline is full");
 
   write_pipeline_.push_back(batch);
+  if (metrics_) {
+    metrics_->Record(util::MetricHistogram::kWritePipelineDepth,
+                     write_pipeline_.size());
+  }
+}
 
-  if (write_stream_->IsOpen() && write_stream_->handshake_complete()) {
-    write_stream_->WriteMutations(batch.mutations());
+void RemoteStore::set_metrics(util::Metrics* metrics) {
+  metrics_ = metrics;
+  watch_stream_->set_metrics(metrics);
+  watch_stream_->set_backoff_metrics(metrics);
+  write_stream_->set_backoff_metrics(metrics);
+}
+
+void RemoteStore::set_adaptive_backoff_enabled(bool enabled) {
+  watch_stream_->set_adaptive_backoff_enabled(enabled);
+  write_stream_->set_adaptive_backoff_enabled(enabled);
+}
+
+void RemoteStore::set_max_pending_writes(size_t max_pending_writes) {
+  max_pending_writes_ =
+      max_pending_writes > 0 ? max_pending_writes : kMaxPendingWrites;
+}
+
+void RemoteStore::SendPendingWrites() {
+  while (sent_batch_count_ < write_pipeline_.size()) {
+    const MutationBatch& first = write_pipeline_[sent_batch_count_];
+    std::vector<Mutation> mutations = first.mutations();
+    size_t batch_count = 1;
+
+    if (max_write_request_bytes_ > 0 &&
+        first.batch_id() > unpacked_until_batch_id_) {
+      size_t request_bytes = write_stream_->EncodedMutationsSize(mutations);
+      while (sent_batch_count_ + batch_count < write_pipeline_.size()) {
+        const MutationBatch& next =
+            write_pipeline_[sent_batch_count_ + batch_count];
+        if (mutations.size() + next.mutations().size() > kMaxWritesPerRequest) {
+          break;
+        }
+        size_t next_bytes =
+            write_stream_->EncodedMutationsSize(next.mutations());
+        if (request_bytes + next_bytes > max_write_request_bytes_) {
+          break;
+        }
+        mutations.insert(mutations.end(), next.mutations().begin(),
+                         next.mutations().end());
+        request_bytes += next_bytes;
+        ++batch_count;
+      }
+    }
+
+    write_stream_->WriteMutations(mutations);
+    write_request_batch_counts_.push_back(batch_count);
+    sent_batch_count_ += batch_count;
   }
 }
 
@@ -424,25 +551,55 @@ void RemoteStore::OnWriteStreamHandshakeComplete() {
   local_store_->SetLastStreamToken(write_stream_->last_stream_token());
 
   // Send the write pipeline now that the stream is established.
-  for (const MutationBatch& write : write_pipeline_) {
-    write_stream_->WriteMutations(write.mutations());
-  }
+  sent_batch_count_ = 0;
+  write_request_batch_counts_.clear();
+  SendPendingWrites();
 }
 
 void RemoteStore::OnWriteStreamMutationResult(
     SnapshotVersion commit_version,
     std::vector<MutationResult> mutation_results) {
   // This is a response to a write containing mutations and should be correlated
-  // to the first write in our write pipeline.
+  // to the first writes in our write pipeline, one or more depending on how
+  // many batches the request carried.
   HARD_ASSERT(!write_pipeline_.empty(), "Got result for empty write pipeline");
-
-  MutationBatch batch = write_pipeline_.front();
-  write_pipeline_.erase(write_pipeline_.begin());
-
-  MutationBatchResult batch_result(std::move(batch), commit_version,
-                                   std::move(mutation_results),
-                                   write_stream_->last_stream_token());
-  sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+  HARD_ASSERT(!write_request_batch_counts_.empty(),
+              "Got result for a write that was not sent");
+
+  size_t batch_count = write_request_batch_counts_.front();
+  write_request_batch_counts_.pop_front();
+  sent_batch_count_ -= batch_count;
+
+  std::vector<MutationBatch> batches(write_pipeline_.begin(),
+                                     write_pipeline_.begin() + batch_count);
+  write_pipeline_.erase(write_pipeline_.begin(),
+                        write_pipeline_.begin() + batch_count);
+
+  if (batch_count == 1) {
+    MutationBatchResult batch_result(std::move(batches.front()),
+                                     commit_version,
+                                     std::move(mutation_results),
+                                     write_stream_->last_stream_token());
+    sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+  } else {
+    // Hand each batch the results of its own mutations.
+    auto next_result = mutation_results.begin();
+    for (MutationBatch& batch : batches) {
+      size_t mutation_count = batch.mutations().size();
+      HARD_ASSERT(static_cast<size_t>(mutation_results.end() - next_result) >=
+                      mutation_count,
+                  "Write response has fewer results than packed mutations");
+      std::vector<MutationResult> batch_results(
+          std::make_move_iterator(next_result),
+          std::make_move_iterator(next_result + mutation_count));
+      next_result += mutation_count;
+
+      MutationBatchResult batch_result(std::move(batch), commit_version,
+                                       std::move(batch_results),
+                                       write_stream_->last_stream_token());
+      sync_engine_->HandleSuccessfulWrite(std::move(batch_result));
+    }
+  }
 
   // It's possible that with the completion of this mutation another slot has
   // freed up.
@@ -510,6 +667,18 @@ void RemoteStore::HandleWriteError(const Status& status) {
     return;
   }
 
+  // A rejected request that packed several batches doesn't tell which batch
+  // was the problem. Resend them one per request so that the rejection of a
+  // single batch does.
+  size_t batch_count = write_request_batch_counts_.empty()
+                           ? 1
+                           : write_request_batch_counts_.front();
+  if (batch_count > 1) {
+    unpacked_until_batch_id_ = write_pipeline_[batch_count - 1].batch_id();
+    write_stream_->InhibitBackoff();
+    return;
+  }
+
   // If this was a permanent error, the request itself was the problem so it's
   // not going to succeed if we resend it.
   MutationBatch batch = write_pipeline_.front();
@@ -536,10 +705,19 @@ std::shared_ptr<Transaction> RemoteStore::CreateTransaction() {
   return std::make_shared<Transaction>(datastore_);
 }
 
+void RemoteStore::CommitMutations(const std::vector<Mutation>& mutations,
+                                  Datastore::CommitCallback&& callback) {
+  datastore_->CommitMutations(mutations, std::move(callback));
+}
+
 DocumentKeySet RemoteStore::GetRemoteKeysForTarget(TargetId target_id) const {
   return sync_engine_->GetRemoteKeys(target_id);
 }
 
+const model::DatabaseId& RemoteStore::GetDatabaseId() const {
+  return datastore_->database_id();
+}
+
 absl::optional<TargetData> RemoteStore::GetTargetDataForTarget(
     TargetId target_id) const {
   auto found = listen_targets_.find(target_id);
@@ -17,6 +17,8 @@
 #ifndef FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 #define FIRESTORE_CORE_SRC_REMOTE_REMOTE_STORE_H_
 
+#include <chrono>  // NOLINT(build/c++11)
+#include <deque>
 #include <memory>
 #include <unordered_map>
 #include <vector>
@@ -179,20 +181,75 @@ class RemoteStore : public TargetMetadataProvider,
   void FillWritePipeline();
 
   /**
-   * Queues additional writes to be sent to the write stream, sending them
-   * immediately if the write stream is established.
+   * Queues additional writes to be sent to the write stream once it is
+   * established.
    */
   void AddToWritePipeline(const model::MutationBatch& batch);
 
+  /**
+   * Sets how many mutation batches may be in flight on the write stream. Zero
+   * restores the default.
+   */
+  void set_max_pending_writes(size_t max_pending_writes);
+
+  /**
+   * Records the write pipeline depth and the bytes received on the watch
+   * stream into the given metrics, which must outlive the RemoteStore. Null
+   * disables this.
+   */
+  void set_metrics(util::Metrics* metrics);
+
+  /**
+   * Enables the fast reconnect of the watch stream: once it opens, the listen
+   * requests of all active targets are encoded and sent in one go, and the
+   * first transient failure after the device's connectivity changed is
+   * retried without backoff.
+   */
+  void set_fast_reconnect_enabled(bool enabled) {
+    fast_reconnect_enabled_ = enabled;
+  }
+
+  /**
+   * Lets the backoff of both streams adapt to the connection: reconnects
+   * come sooner after the device's connectivity changed and later while the
+   * backend reports that it is overloaded.
+   */
+  void set_adaptive_backoff_enabled(bool enabled);
+
+  /**
+   * Lets consecutive mutation batches share one write request of up to the
+   * given size in bytes. Batches are still acknowledged one by one. Zero sends
+   * each batch in its own request.
+   */
+  void set_max_write_request_bytes(size_t max_write_request_bytes) {
+    max_write_request_bytes_ = max_write_request_bytes;
+  }
+
+  /**
+   * Compresses write requests of at least the given size in bytes with gzip.
+   * Zero, the default, leaves them uncompressed.
+   */
+  void set_write_compression_threshold(size_t write_compression_threshold) {
+    write_stream_->set_compression_threshold(write_compression_threshold);
+  }
+
   /** Returns a new transaction backed by this remote store. */
   // TODO(c++14): return a plain value when it becomes possible to move
   // `Transaction` into lambdas.
   std::shared_ptr<core::Transaction> CreateTransaction();
 
+  /**
+   * Commits the given mutations straight to the backend, bypassing the write
+   * pipeline and the mutation queue.
+   */
+  void CommitMutations(const std::vector<model::Mutation>& mutations,
+                       Datastore::CommitCallback&& callback);
+
   model::DocumentKeySet GetRemoteKeysForTarget(
       model::TargetId target_id) const override;
   absl::optional<local::TargetData> GetTargetDataForTarget(
       model::TargetId target_id) const override;
+  const model::DatabaseId& GetDatabaseId() const override;
 
   void OnWatchStreamOpen() override;
   void OnWatchStreamChange(
@@ -212,6 +269,13 @@ class RemoteStore : public TargetMetadataProvider,
   void DisableNetworkInternal();
 
   void SendWatchRequest(const local::TargetData& target_data);
+
+  /**
+   * Adds the number of documents the client has for a resumed target, which
+   * lets the backend reply to a mismatch with a bloom filter.
+   */
+  local::TargetData PrepareWatchRequest(
+      const local::TargetData& target_data) const;
   void SendUnwatchRequest(model::TargetId target_id);
 
   /**
@@ -240,6 +304,13 @@ class RemoteStore : public TargetMetadataProvider,
   void HandleHandshakeError(const util::Status& status);
   void HandleWriteError(const util::Status& status);
 
+  /**
+   * Sends the batches of the write pipeline that have not been sent on the
+   * current write stream, packing consecutive batches into one request when
+   * enabled.
+   */
+  void SendPendingWrites();
+
   void StartWatchStream();
 
   /**
@@ -250,6 +321,13 @@ class RemoteStore : public TargetMetadataProvider,
 
   void CleanUpWatchStreamState();
 
+  /**
+   * Whether an error that closed the watch stream is most likely due to the
+   * connection that was dropped when the device's connectivity changed
+   * shortly before, in which case reconnecting should not wait.
+   */
+  bool IsTransientConnectivityError(const util::Status& status);
+
   RemoteStoreCallback* sync_engine_ = nullptr;
 
   /**
@@ -282,6 +360,15 @@ class RemoteStore : public TargetMetadataProvider,
    */
   bool is_network_enabled_ = false;
 
+  bool fast_reconnect_enabled_ = false;
+
+  /**
+   * When the connectivity monitor last reported a usable network, and whether
+   * the watch stream may still skip its backoff once because of it.
+   */
+  std::chrono::steady_clock::time_point last_connectivity_change_;
+  bool backoff_skip_available_ = false;
+
   std::shared_ptr<WatchStream> watch_stream_;
   std::shared_ptr<WriteStream> write_stream_;
   std::unique_ptr<WatchChangeAggregator> watch_change_aggregator_;
@@ -304,6 +391,26 @@ class RemoteStore : public TargetMetadataProvider,
    * the `write_pipeline_` as we receive responses.
    */
   std::vector<model::MutationBatch> write_pipeline_;
+
+  size_t max_pending_writes_;
+  size_t max_write_request_bytes_ = 0;
+
+  util::Metrics* metrics_ = nullptr;
+
+  /**
+   * How many batches from the front of `write_pipeline_` were sent on the
+   * current write stream, and how many of them each unacknowledged request
+   * carried.
+   */
+  size_t sent_batch_count_ = 0;
+  std::deque<size_t> write_request_batch_counts_;
+
+  /**
+   * Batches up to this one are sent in requests of their own, because a
+   * request packing them was rejected and only a request carrying a single
+   * batch tells which batch to reject.
+   */
+  model::BatchId unpacked_until_batch_id_ = model::kBatchIdUnknown;
 };
 
 }  // namespace remote
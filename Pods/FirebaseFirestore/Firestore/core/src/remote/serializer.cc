@@ -36,6 +36,7 @@
 #include "Firestore/core/src/core/query.h"
 #include "Firestore/core/src/local/target_data.h"
 #include "Firestore/core/src/model/delete_mutation.h"
+#include "Firestore/core/src/model/document_key_set.h"
 #include "Firestore/core/src/model/field_path.h"
 #include "Firestore/core/src/model/mutable_document.h"
 #include "Firestore/core/src/model/patch_mutation.h"
@@ -54,6 +55,8 @@
 #include "Firestore/core/src/util/statusor.h"
 #include "Firestore/core/src/util/string_format.h"
 #include "absl/algorithm/container.h"
+#include "absl/strings/match.h"
+#include "absl/strings/str_cat.h"
 #include "absl/types/span.h"
 
 namespace firebase {
@@ -77,6 +80,7 @@ using model::DatabaseId;
 using model::DeepClone;
 using model::DeleteMutation;
 using model::DocumentKey;
+using model::DocumentKeySet;
 using model::EncodeServerTimestamp;
 using model::FieldMask;
 using model::FieldPath;
@@ -175,7 +179,10 @@ FieldPath InvalidFieldPath() {
 }  // namespace
 
 Serializer::Serializer(DatabaseId database_id)
-    : database_id_(std::move(database_id)) {
+    : database_id_(std::move(database_id)),
+      document_name_prefix_(
+          absl::StrCat(DatabaseName(database_id_).CanonicalString(),
+                       "/documents/")) {
 }
 
 pb_bytes_array_t* Serializer::EncodeDatabaseName() const {
@@ -210,8 +217,19 @@ void Serializer::ValidateDocumentKeyPath(
 
 DocumentKey Serializer::DecodeKey(ReadContext* context,
                                   const pb_bytes_array_t* name) const {
-  ResourcePath resource_name =
-      DecodeResourceName(context, MakeStringView(name));
+  absl::string_view encoded = MakeStringView(name);
+  if (absl::StartsWith(encoded, document_name_prefix_)) {
+    // Skip building and dropping the segments of the database name, which are
+    // the same for every document.
+    ResourcePath local_path = ResourcePath::FromStringView(
+        encoded.substr(document_name_prefix_.size()));
+    if (DocumentKey::IsDocumentKey(local_path)) {
+      return DocumentKey{std::move(local_path)};
+    }
+  }
+
+  // The slow path reports the errors.
+  ResourcePath resource_name = DecodeResourceName(context, encoded);
   ValidateDocumentKeyPath(context, resource_name);
 
   return DecodeKey(context, resource_name);
@@ -623,7 +641,11 @@ google_firestore_v1_Target Serializer::EncodeTarget(
   google_firestore_v1_Target result{};
   const Target& target = target_data.target();
 
-  if (target.IsDocumentQuery()) {
+  if (!target_data.document_keys().empty()) {
+    result.which_target_type = google_firestore_v1_Target_documents_tag;
+    result.target_type.documents =
+        EncodeDocumentsTarget(target_data.document_keys());
+  } else if (target.IsDocumentQuery()) {
     result.which_target_type = google_firestore_v1_Target_documents_tag;
     result.target_type.documents = EncodeDocumentsTarget(target);
   } else {
@@ -636,6 +658,13 @@ google_firestore_v1_Target Serializer::EncodeTarget(
     result.which_resume_type = google_firestore_v1_Target_resume_token_tag;
     result.resume_type.resume_token =
         nanopb::CopyBytesArray(target_data.resume_token().get());
+
+    // The count lets the backend reply to a resumed target with a bloom filter
+    // of its documents once they differ from what the client has.
+    if (target_data.expected_count()) {
+      result.has_expected_count = true;
+      result.expected_count.value = *target_data.expected_count();
+    }
   }
 
   return result;
@@ -652,6 +681,20 @@ google_firestore_v1_Target_DocumentsTarget Serializer::EncodeDocumentsTarget(
   return result;
 }
 
+google_firestore_v1_Target_DocumentsTarget Serializer::EncodeDocumentsTarget(
+    const DocumentKeySet& keys) const {
+  google_firestore_v1_Target_DocumentsTarget result{};
+
+  result.documents_count = CheckedSize(keys.size());
+  result.documents = MakeArray<pb_bytes_array_t*>(result.documents_count);
+  pb_size_t i = 0;
+  for (const DocumentKey& key : keys) {
+    result.documents[i++] = EncodeQueryPath(key.path());
+  }
+
+  return result;
+}
+
 Target Serializer::DecodeDocumentsTarget(
     ReadContext* context,
     const google_firestore_v1_Target_DocumentsTarget& proto) const {
@@ -663,7 +706,7 @@ Target Serializer::DecodeDocumentsTarget(
   }
 
   ResourcePath path =
-      DecodeQueryPath(context, DecodeString(proto.documents[0]));
+      DecodeQueryPath(context, MakeStringView(proto.documents[0]));
   return Query(std::move(path)).ToTarget();
 }
 
@@ -734,7 +777,7 @@ Target Serializer::DecodeStructuredQuery(
     ReadContext* context,
     pb_bytes_array_t* parent,
     google_firestore_v1_StructuredQuery& query) const {
-  ResourcePath path = DecodeQueryPath(context, DecodeString(parent));
+  ResourcePath path = DecodeQueryPath(context, MakeStringView(parent));
 
   CollectionGroupId collection_group;
   size_t from_count = query.from_count;
@@ -1393,7 +1436,16 @@ std::unique_ptr<WatchChange> Serializer::DecodeDocumentRemove(
 
 std::unique_ptr<WatchChange> Serializer::DecodeExistenceFilterWatchChange(
     ReadContext*, const google_firestore_v1_ExistenceFilter& filter) const {
-  ExistenceFilter existence_filter{filter.count};
+  absl::optional<BloomFilterParameters> unchanged_names;
+  if (filter.has_unchanged_names) {
+    const google_firestore_v1_BloomFilter& bloom_filter =
+        filter.unchanged_names;
+    unchanged_names = BloomFilterParameters{
+        ByteString{bloom_filter.bits.bitmap}, bloom_filter.bits.padding,
+        bloom_filter.hash_count};
+  }
+
+  ExistenceFilter existence_filter{filter.count, std::move(unchanged_names)};
   return absl::make_unique<ExistenceFilterWatchChange>(existence_filter,
                                                        filter.target_id);
 }
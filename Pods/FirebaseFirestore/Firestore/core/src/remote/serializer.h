@@ -183,6 +183,8 @@ class Serializer {
       const local::TargetData& target_data) const;
   google_firestore_v1_Target_DocumentsTarget EncodeDocumentsTarget(
       const core::Target& target) const;
+  google_firestore_v1_Target_DocumentsTarget EncodeDocumentsTarget(
+      const model::DocumentKeySet& keys) const;
   core::Target DecodeDocumentsTarget(
       util::ReadContext* context,
       const google_firestore_v1_Target_DocumentsTarget& proto) const;
@@ -326,6 +328,11 @@ class Serializer {
       const google_firestore_v1_ExistenceFilter& filter) const;
 
   model::DatabaseId database_id_;
+
+  // The names of the documents of `database_id_` start with this prefix, so
+  // decoding their keys only has to split the rest.
+  std::string document_name_prefix_;
+
   // TODO(varconst): Android caches the result of calling `EncodeDatabaseName`
   // as well, consider implementing that.
 };
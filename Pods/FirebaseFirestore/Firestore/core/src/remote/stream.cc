@@ -25,6 +25,7 @@
 #include "Firestore/core/src/util/error_apple.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/string_format.h"
 
 namespace firebase {
@@ -104,6 +105,7 @@ void Stream::Start() {
 
   HARD_ASSERT(state_ == State::Initial, "Already started");
   state_ = State::Starting;
+  open_span_.emplace(util::StartupPhase::kStreamOpen);
 
   RequestCredentials();
 }
@@ -178,6 +180,10 @@ void Stream::ResumeStartWithCredentials(const StatusOr<AuthToken>& auth_token,
 
   grpc_stream_ = CreateGrpcStream(grpc_connection_, auth_token.ValueOrDie(),
                                   app_check_token);
+  if (compression_threshold_ > 0) {
+    // Only announces the algorithm; `MakeWriteOptions` exempts small messages.
+    grpc_stream_->context()->set_compression_algorithm(GRPC_COMPRESS_GZIP);
+  }
   grpc_stream_->Start();
 }
 
@@ -185,6 +191,7 @@ void Stream::OnStreamStart() {
   EnsureOnQueue();
 
   state_ = State::Open;
+  open_span_.reset();
   NotifyStreamOpen();
 
   health_check_ = worker_queue_->EnqueueAfterDelay(
@@ -192,6 +199,7 @@ void Stream::OnStreamStart() {
         {
           if (IsOpen()) {
             state_ = State::Healthy;
+            backoff_.HandleHealthyConnection();
           }
         }
       });
@@ -324,6 +332,11 @@ void Stream::Close(const Status& status) {
   }
   // Step 6 (both): destroy the underlying stream.
   grpc_stream_.reset();
+  if (open_span_) {
+    // Streams that never opened don't count as connected.
+    open_span_->Discard();
+    open_span_.reset();
+  }
 
   // Step 7 (both): update the state machine and notify the listener.
   // State must be updated before calling the delegate.
@@ -336,7 +349,7 @@ void Stream::HandleErrorStatus(const Status& status) {
     LOG_DEBUG(
         "%s Using maximum backoff delay to prevent overloading the backend.",
         GetDebugDescription());
-    backoff_.ResetToMax();
+    backoff_.HandleOverload();
   } else if (status.code() == Error::kErrorUnauthenticated &&
              state_ != State::Healthy) {
     // "unauthenticated" error means the token was rejected. This should rarely
@@ -375,7 +388,26 @@ void Stream::Write(grpc::ByteBuffer&& message) {
   HARD_ASSERT(IsOpen(), "Cannot write when the stream is not open.");
 
   CancelIdleCheck();
-  grpc_stream_->Write(std::move(message));
+  grpc::WriteOptions options = MakeWriteOptions(message);
+  grpc_stream_->Write(std::move(message), options);
+}
+
+grpc::WriteOptions Stream::MakeWriteOptions(
+    const grpc::ByteBuffer& message) const {
+  grpc::WriteOptions options;
+  if (message.Length() < compression_threshold_) {
+    options.set_no_compression();
+  }
+  return options;
+}
+
+void Stream::WriteBatch(std::vector<grpc::ByteBuffer>&& messages) {
+  EnsureOnQueue();
+
+  HARD_ASSERT(IsOpen(), "Cannot write when the stream is not open.");
+
+  CancelIdleCheck();
+  grpc_stream_->WriteBatch(std::move(messages), compression_threshold_);
 }
 
 std::string Stream::GetDebugDescription() const {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/credentials/auth_token.h"
 #include "Firestore/core/src/credentials/credentials_fwd.h"
@@ -29,8 +30,10 @@
 #include "Firestore/core/src/remote/grpc_stream.h"
 #include "Firestore/core/src/remote/remote_objc_bridge.h"
 #include "Firestore/core/src/util/async_queue.h"
+#include "Firestore/core/src/util/startup_trace.h"
 #include "Firestore/core/src/util/status_fwd.h"
 #include "absl/strings/string_view.h"
+#include "absl/types/optional.h"
 #include "grpcpp/support/byte_buffer.h"
 
 namespace firebase {
@@ -179,6 +182,45 @@ class Stream : public GrpcStreamObserver,
    */
   void InhibitBackoff();
 
+  /**
+   * Lets the backoff between reconnects adapt to network changes, overload
+   * and healthy connections, see `ExponentialBackoff::set_adaptive`.
+   */
+  void set_adaptive_backoff_enabled(bool enabled) {
+    backoff_.set_adaptive(enabled);
+  }
+
+  /** Records the backoff delays into the given metrics; may be null. */
+  void set_backoff_metrics(util::Metrics* metrics) {
+    backoff_.set_metrics(metrics);
+  }
+
+  /**
+   * Notes that the device switched networks, so that the next reconnect does
+   * not wait out the backoff accumulated on the previous network.
+   */
+  void HandleNetworkChange() {
+    backoff_.HandleNetworkChange();
+  }
+
+  /**
+   * Notes that the connection to the backend works, which ends any adaptive
+   * scaling of the backoff.
+   */
+  void HandleHealthyConnection() {
+    backoff_.HandleHealthyConnection();
+  }
+
+  /**
+   * Compresses outgoing messages of at least the given size in bytes with
+   * gzip; smaller messages, for which compression gains little, are sent as
+   * they are. Zero disables compression. Takes effect the next time the
+   * stream starts.
+   */
+  void set_compression_threshold(size_t compression_threshold) {
+    compression_threshold_ = compression_threshold;
+  }
+
   /**
    * Marks this stream as idle. If no further actions are performed on the
    * stream for one minute, the stream will automatically close itself and
@@ -207,6 +249,7 @@ class Stream : public GrpcStreamObserver,
   // `Stream` expects all its methods to be called on the worker queue.
   void EnsureOnQueue() const;
   void Write(grpc::ByteBuffer&& message);
+  void WriteBatch(std::vector<grpc::ByteBuffer>&& messages);
   std::string GetDebugDescription() const;
 
   ExponentialBackoff backoff_;
@@ -241,9 +284,15 @@ class Stream : public GrpcStreamObserver,
       const std::string& app_check_token);
   void BackoffAndTryRestarting();
 
+  /** The write options of `message`, which decide on its compression. */
+  grpc::WriteOptions MakeWriteOptions(const grpc::ByteBuffer& message) const;
+
   State state_ = State::Initial;
+  size_t compression_threshold_ = 0;
 
   std::unique_ptr<GrpcStream> grpc_stream_;
+  // Traces the start of the stream until it opens, for startup tracing.
+  absl::optional<util::StartupSpan> open_span_;
 
   std::shared_ptr<credentials::AppCheckCredentialsProvider>
       app_check_credentials_provider_;
@@ -24,6 +24,7 @@
 #include "Firestore/core/src/remote/grpc_nanopb.h"
 #include "Firestore/core/src/util/hard_assert.h"
 #include "Firestore/core/src/util/log.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/status.h"
 
 namespace firebase {
@@ -67,6 +68,19 @@ void WatchStream::WatchQuery(const TargetData& query) {
   Write(MakeByteBuffer(request));
 }
 
+void WatchStream::WatchQueries(const std::vector<const TargetData*>& queries) {
+  EnsureOnQueue();
+
+  std::vector<grpc::ByteBuffer> messages;
+  messages.reserve(queries.size());
+  for (const TargetData* query : queries) {
+    auto request = watch_serializer_.EncodeWatchRequest(*query);
+    LOG_DEBUG("%s watch: %s", GetDebugDescription(), request.ToString());
+    messages.push_back(MakeByteBuffer(request));
+  }
+  WriteBatch(std::move(messages));
+}
+
 void WatchStream::UnwatchTargetId(TargetId target_id) {
   EnsureOnQueue();
 
@@ -93,6 +107,11 @@ void WatchStream::NotifyStreamOpen() {
 }
 
 Status WatchStream::NotifyStreamResponse(const grpc::ByteBuffer& message) {
+  if (metrics_) {
+    metrics_->Increment(util::MetricCounter::kWatchBytesReceived,
+                        message.Length());
+  }
+
   ByteBufferReader reader{message};
   auto response = watch_serializer_.ParseResponse(&reader);
   if (!reader.ok()) {
@@ -19,6 +19,7 @@
 
 #include <memory>
 #include <string>
+#include <vector>
 
 #include "Firestore/core/src/model/model_fwd.h"
 #include "Firestore/core/src/remote/grpc_connection.h"
@@ -37,6 +38,10 @@ namespace local {
 class TargetData;
 }  // namespace local
 
+namespace util {
+class Metrics;
+}  // namespace util
+
 namespace remote {
 
 class Serializer;
@@ -108,6 +113,23 @@ class WatchStream : public Stream {
   virtual /*virtual for tests only*/ void UnwatchTargetId(
       model::TargetId target_id);
 
+  /**
+   * Registers interest in the results of all the given queries, including
+   * their resume tokens. All requests are encoded before the first one is
+   * written, and they are handed to gRPC together so that they leave in as
+   * few network writes as possible.
+   */
+  virtual /*virtual for tests only*/ void WatchQueries(
+      const std::vector<const local::TargetData*>& queries);
+
+  /**
+   * Counts the bytes of received messages into the given metrics, which must
+   * outlive the stream. Null disables this.
+   */
+  void set_metrics(util::Metrics* metrics) {
+    metrics_ = metrics;
+  }
+
  private:
   std::unique_ptr<GrpcStream> CreateGrpcStream(
       GrpcConnection* grpc_connection,
@@ -125,6 +147,7 @@ class WatchStream : public Stream {
 
   WatchStreamSerializer watch_serializer_;
   WatchStreamCallback* callback_;
+  util::Metrics* metrics_ = nullptr;
 };
 
 }  // namespace remote
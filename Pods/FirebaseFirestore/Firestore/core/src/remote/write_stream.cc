@@ -94,6 +94,15 @@ void WriteStream::WriteMutations(const std::vector<Mutation>& mutations) {
   Write(MakeByteBuffer(request));
 }
 
+size_t WriteStream::EncodedMutationsSize(
+    const std::vector<Mutation>& mutations) const {
+  auto request = write_serializer_.EncodeWriteMutationsRequest(
+      mutations, last_stream_token());
+  size_t size = 0;
+  pb_get_encoded_size(&size, request.fields(), request.get());
+  return size;
+}
+
 std::unique_ptr<GrpcStream> WriteStream::CreateGrpcStream(
     GrpcConnection* grpc_connection,
     const AuthToken& auth_token,
@@ -129,6 +129,13 @@ class WriteStream : public Stream {
   /** Sends a group of mutations to the Firestore backend to apply. */
   virtual void WriteMutations(const std::vector<model::Mutation>& mutations);
 
+  /**
+   * Returns the size in bytes of the request `WriteMutations` would send for
+   * the given mutations.
+   */
+  size_t EncodedMutationsSize(
+      const std::vector<model::Mutation>& mutations) const;
+
  protected:
   // For tests only
   void SetHandshakeComplete(bool value = true) {
@@ -16,16 +16,16 @@
 
 #include "Firestore/core/include/firebase/firestore/timestamp.h"
 
+#include <cmath>
 #include <ostream>
 
-#if defined(__APPLE__)
-#import <CoreFoundation/CoreFoundation.h>
-#elif defined(_STLPORT_VERSION)
+#if defined(_STLPORT_VERSION)
 #include <ctime>
 #endif
 
 #include "Firestore/core/src/util/hard_assert.h"
 #include "absl/strings/str_cat.h"
+#include "absl/time/clock.h"
 
 namespace firebase {
 namespace {
@@ -67,9 +67,10 @@ Timestamp::Timestamp(int64_t seconds, int32_t nanoseconds)
 Timestamp Timestamp::Now() {
 #if defined(__APPLE__)
   // Originally, FIRTimestamp used NSDate to get current time. This method
-  // preserves the lower accuracy of that method.
-  CFAbsoluteTime now =
-      CFAbsoluteTimeGetCurrent() + kCFAbsoluteTimeIntervalSince1970;
+  // preserves the lower accuracy of that method. absl::Now() extrapolates
+  // from a calibrated mach_continuous_time() and only reads the system clock
+  // every so often, where CFAbsoluteTimeGetCurrent() read it on every call.
+  double now = absl::ToDoubleSeconds(absl::Now() - absl::UnixEpoch());
   double seconds_double;
   double fraction = modf(now, &seconds_double);
   auto seconds = static_cast<int64_t>(seconds_double);
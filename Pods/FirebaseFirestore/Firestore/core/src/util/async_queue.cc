@@ -19,6 +19,7 @@
 #include <utility>
 
 #include "Firestore/core/src/util/hard_assert.h"
+#include "Firestore/core/src/util/metrics.h"
 #include "Firestore/core/src/util/task.h"
 #include "absl/algorithm/container.h"
 #include "absl/memory/memory.h"
@@ -26,6 +27,21 @@
 namespace firebase {
 namespace firestore {
 namespace util {
+namespace {
+
+/**
+ * How many operations of higher priorities may run ahead of the oldest
+ * operation of each priority before it runs regardless.
+ */
+constexpr std::array<int, 3> kMaxLaneSkips = {{0, 4, 16}};
+
+size_t LaneIndex(AsyncQueue::Priority priority) {
+  return static_cast<size_t>(priority);
+}
+
+}  // namespace
+
+constexpr size_t AsyncQueue::kPriorityCount;
 
 std::shared_ptr<AsyncQueue> AsyncQueue::Create(
     std::unique_ptr<Executor> executor) {
@@ -57,6 +73,13 @@ void AsyncQueue::Dispose() {
   }
 
   executor_->Dispose();
+
+  // The tasks that would have run the remaining operations were discarded.
+  std::array<std::deque<Operation>, kPriorityCount> discarded;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    discarded.swap(lanes_);
+  }
 }
 
 void AsyncQueue::VerifyIsCurrentExecutor() const {
@@ -91,15 +114,19 @@ void AsyncQueue::ExecuteBlocking(const Operation& operation) {
 }
 
 bool AsyncQueue::Enqueue(const Operation& operation) {
+  return Enqueue(Priority::kNormal, operation);
+}
+
+bool AsyncQueue::Enqueue(Priority priority, const Operation& operation) {
   VerifySequentialOrder();
-  return EnqueueRelaxed(operation);
+  return EnqueueRelaxed(priority, operation);
 }
 
 bool AsyncQueue::EnqueueEvenWhileRestricted(const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ == Mode::kDisposed) return false;
 
-  executor_->Execute(Wrap(operation));
+  EnqueueLocked(operation, Priority::kNormal);
   return true;
 }
 
@@ -109,16 +136,86 @@ bool AsyncQueue::is_running() const {
 }
 
 bool AsyncQueue::EnqueueRelaxed(const Operation& operation) {
+  return EnqueueRelaxed(Priority::kNormal, operation);
+}
+
+bool AsyncQueue::EnqueueRelaxed(Priority priority, const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   if (mode_ != Mode::kRunning) return false;
 
-  executor_->Execute(Wrap(operation));
+  EnqueueLocked(operation, priority);
+  return true;
+}
+
+void AsyncQueue::EnqueueLocked(const Operation& operation, Priority priority) {
+  if (metrics_) {
+    std::shared_ptr<Metrics> metrics = metrics_;
+    Metrics::Clock::time_point enqueued = Metrics::Clock::now();
+    lanes_[LaneIndex(priority)].push_back([metrics, enqueued, operation] {
+      metrics->RecordSince(MetricHistogram::kAsyncQueueWaitMicros, enqueued);
+      operation();
+    });
+  } else {
+    lanes_[LaneIndex(priority)].push_back(operation);
+  }
+  executor_->Execute([this] { RunNextOperation(); });
+}
+
+void AsyncQueue::RunNextOperation() {
+  Operation operation;
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!PopNextOperation(&operation)) return;
+  }
+
+  ExecuteBlocking(operation);
+}
+
+bool AsyncQueue::PopNextOperation(Operation* operation) {
+  if (mode_ != Mode::kRunning) {
+    lanes_[LaneIndex(Priority::kBackground)].clear();
+  }
+
+  // Pick the highest priority lane, unless a lower one has waited too long.
+  size_t next = kPriorityCount;
+  for (size_t i = kPriorityCount; i-- > 0;) {
+    if (!lanes_[i].empty() && lane_skips_[i] >= kMaxLaneSkips[i]) {
+      next = i;
+      break;
+    }
+  }
+  for (size_t i = 0; i < kPriorityCount && next == kPriorityCount; ++i) {
+    if (!lanes_[i].empty()) {
+      next = i;
+    }
+  }
+  if (next == kPriorityCount) {
+    return false;
+  }
+
+  for (size_t i = 0; i < kPriorityCount; ++i) {
+    if (i == next || lanes_[i].empty()) {
+      lane_skips_[i] = 0;
+    } else {
+      ++lane_skips_[i];
+    }
+  }
+
+  *operation = std::move(lanes_[next].front());
+  lanes_[next].pop_front();
   return true;
 }
 
 DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
                                                const TimerId timer_id,
                                                const Operation& operation) {
+  return EnqueueAfterDelay(delay, timer_id, Priority::kNormal, operation);
+}
+
+DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
+                                               const TimerId timer_id,
+                                               Priority priority,
+                                               const Operation& operation) {
   std::lock_guard<std::mutex> lock(mutex_);
   VerifyIsCurrentExecutor();
 
@@ -132,7 +229,21 @@ DelayedOperation AsyncQueue::EnqueueAfterDelay(Milliseconds delay,
   }
 
   auto tag = static_cast<Executor::Tag>(timer_id);
-  return executor_->Schedule(delay, tag, Wrap(operation));
+  if (priority == Priority::kNormal) {
+    return executor_->Schedule(delay, tag, Wrap(operation));
+  }
+
+  return executor_->Schedule(delay, tag, [this, operation, priority] {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (mode_ != Mode::kRunning) return;
+
+    EnqueueLocked(operation, priority);
+  });
+}
+
+void AsyncQueue::SetMetrics(std::shared_ptr<Metrics> metrics) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  metrics_ = std::move(metrics);
 }
 
 AsyncQueue::Operation AsyncQueue::Wrap(const Operation& operation) {
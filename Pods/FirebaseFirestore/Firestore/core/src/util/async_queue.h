@@ -17,8 +17,10 @@
 #ifndef FIRESTORE_CORE_SRC_UTIL_ASYNC_QUEUE_H_
 #define FIRESTORE_CORE_SRC_UTIL_ASYNC_QUEUE_H_
 
+#include <array>
 #include <atomic>
 #include <chrono>  // NOLINT(build/c++11)
+#include <deque>
 #include <functional>
 #include <memory>
 #include <mutex>  // NOLINT(build/c++11)
@@ -30,6 +32,8 @@ namespace firebase {
 namespace firestore {
 namespace util {
 
+class Metrics;
+
 /**
  * Well-known "timer" ids used when scheduling delayed operations on the
  * AsyncQueue. These ids can then be used from tests to check for the
@@ -68,13 +72,43 @@ enum class TimerId {
    * A timer used to retry transactions. Since there can be multiple concurrent
    * transactions, multiple of these may be in the queue at a given time.
    */
-  RetryTransaction
+  RetryTransaction,
+
+  /**
+   * A timer used to periodically attempt index backfilling.
+   */
+  IndexBackfill,
+
+  /**
+   * A timer used to commit the LevelDB transactions held back by group
+   * commit once the commit window closes.
+   */
+  GroupCommit,
+
+  /**
+   * A timer used by `QueryListener` to raise the snapshot it coalesced from
+   * intermediate snapshots once its minimum snapshot interval has passed.
+   */
+  ListenerSnapshotCoalescing,
+
+  /**
+   * Timers used by `BulkWriter` to retry writes after a retryable error and to
+   * send further writes once its rate limit admits them.
+   */
+  RetryBulkWrite,
+  BulkWriterThrottle
 };
 
 // A serial queue that executes given operations asynchronously, one at a time.
 // Operations may be scheduled to be executed as soon as possible or in the
 // future. Operations scheduled for the same time are FIFO-ordered.
 //
+// Operations enqueued for immediate execution are also ordered by priority:
+// the next operation to run is the oldest one of the highest priority, except
+// that an operation passed over too many times in favor of higher priority
+// operations runs next, so that no priority starves. Operations of the same
+// priority stay FIFO-ordered.
+//
 // `AsyncQueue` wraps a platform-specific executor, adding checks that enforce
 // sequential ordering of operations: an enqueued operation, while being run,
 // normally cannot enqueue other operations for immediate execution (but see
@@ -112,6 +146,21 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
     kDisposed,
   };
 
+  enum class Priority {
+    /** Operations a user is waiting on, such as reads from the cache. */
+    kInteractive,
+
+    /** The default priority. */
+    kNormal,
+
+    /**
+     * Maintenance work such as garbage collection or index backfilling, which
+     * should be split into short steps. Background operations that have not
+     * started running are discarded once the queue leaves `Mode::kRunning`.
+     */
+    kBackground,
+  };
+
   static std::shared_ptr<AsyncQueue> Create(std::unique_ptr<Executor> executor);
 
   ~AsyncQueue();
@@ -149,6 +198,9 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   //     restricted mode or been disposed.
   bool Enqueue(const Operation& operation);
 
+  // Like `Enqueue`, but with the given priority instead of `kNormal`.
+  bool Enqueue(Priority priority, const Operation& operation);
+
   // Like `Enqueue`, but it will proceed scheduling the requested operation
   // regardless of whether the queue is in restricted mode or not.
   //
@@ -159,6 +211,7 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
 
   // Like `Enqueue`, but without applying any prerequisite checks.
   bool EnqueueRelaxed(const Operation& operation);
+  bool EnqueueRelaxed(Priority priority, const Operation& operation);
 
   // Returns true if the queue is still in the main kRunning mode (i.e. not
   // restricted or disposed).
@@ -174,11 +227,19 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   // assertion failure. In tests, these tags also allow to check for presence of
   // certain operations and to run certain operations in advance.
   //
+  // Once the delay has passed, an operation of a priority other than
+  // `Priority::kNormal` is put on the queue with that priority rather than run
+  // right away; it can no longer be canceled from then on.
+  //
   // Precondition: `EnqueueAfterDelay` is being invoked asynchronously on the
   // queue.
   DelayedOperation EnqueueAfterDelay(Milliseconds delay,
                                      TimerId timer_id,
                                      const Operation& operation);
+  DelayedOperation EnqueueAfterDelay(Milliseconds delay,
+                                     TimerId timer_id,
+                                     Priority priority,
+                                     const Operation& operation);
 
   // Direct execution
 
@@ -219,6 +280,11 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   // queue.
   void RunScheduledOperationsUntil(TimerId last_timer_id);
 
+  // Records how long each enqueued operation waits before it runs into
+  // `metrics`. Null disables this. Operations scheduled after a delay are not
+  // measured, since their wait is intended.
+  void SetMetrics(std::shared_ptr<Metrics> metrics);
+
   // For tests: Skip all subsequent delays for a specific TimerId.
   // NOTE: This does not work with TimerId::All.
   void SkipDelaysForTimerId(TimerId timer_id);
@@ -228,6 +294,18 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
 
   Operation Wrap(const Operation& operation);
 
+  // Puts `operation` in the lane of the given priority and schedules a task on
+  // the executor that runs the next operation. Must be called with `mutex_`
+  // held.
+  void EnqueueLocked(const Operation& operation, Priority priority);
+
+  // Runs the operation that is next by priority, if any.
+  void RunNextOperation();
+
+  // Takes the operation that is next by priority out of its lane. Returns
+  // false if there is none. Must be called with `mutex_` held.
+  bool PopNextOperation(Operation* operation);
+
   // Asserts that the current invocation happens asynchronously on the queue.
   void VerifyIsCurrentExecutor() const;
   void VerifySequentialOrder() const;
@@ -239,6 +317,14 @@ class AsyncQueue : public std::enable_shared_from_this<AsyncQueue> {
   Mode mode_ = Mode::kRunning;
 
   std::vector<TimerId> timer_ids_to_skip_;
+  std::shared_ptr<Metrics> metrics_;
+
+  static constexpr size_t kPriorityCount = 3;
+
+  // The operations waiting to run, one FIFO lane per priority, and how many
+  // operations have run ahead of each lane's oldest operation.
+  std::array<std::deque<Operation>, kPriorityCount> lanes_;
+  std::array<int, kPriorityCount> lane_skips_{};
 };
 
 }  // namespace util
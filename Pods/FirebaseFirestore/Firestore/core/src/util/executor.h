@@ -56,19 +56,33 @@ class Executor {
   using Clock = std::chrono::steady_clock;
   using TimePoint = std::chrono::time_point<Clock, Milliseconds>;
 
+  // How urgent the operations of an executor are. Platforms that support it
+  // use the priority to order threads and to choose between performance and
+  // efficiency cores; elsewhere it is ignored.
+  enum class Priority {
+    // Work the user is waiting on, such as raising snapshots.
+    kUserInitiated,
+    kDefault,
+    // Long-running work whose progress the user does not watch.
+    kUtility,
+    // Maintenance the user is not aware of.
+    kBackground,
+  };
+
   // Creates a new serial Executor of the platform-appropriate type, and gives
-  // it the given label, if the implementation supports it.
+  // it the given label and priority, if the implementation supports them.
   //
   // Note that this method has multiple definitions, depending on the platform.
-  static std::unique_ptr<Executor> CreateSerial(const char* label);
+  static std::unique_ptr<Executor> CreateSerial(
+      const char* label, Priority priority = Priority::kDefault);
 
   // Creates a new concurrent Executor of the platform-appropriate type, with
-  // at least the given number of threads, and gives it the given label, if the
-  // implementation supports it.
+  // at least the given number of threads, and gives it the given label and
+  // priority, if the implementation supports them.
   //
   // Note that this method has multiple definitions, depending on the platform.
-  static std::unique_ptr<Executor> CreateConcurrent(const char* label,
-                                                    int threads);
+  static std::unique_ptr<Executor> CreateConcurrent(
+      const char* label, int threads, Priority priority = Priority::kDefault);
 
   virtual ~Executor() = default;
 
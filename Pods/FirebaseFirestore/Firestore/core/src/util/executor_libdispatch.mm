@@ -48,6 +48,20 @@ absl::string_view GetCurrentQueueLabel() {
       dispatch_queue_get_label(DISPATCH_CURRENT_QUEUE_LABEL));
 }
 
+dispatch_qos_class_t ToQosClass(Executor::Priority priority) {
+  switch (priority) {
+    case Executor::Priority::kUserInitiated:
+      return QOS_CLASS_USER_INITIATED;
+    case Executor::Priority::kDefault:
+      return QOS_CLASS_DEFAULT;
+    case Executor::Priority::kUtility:
+      return QOS_CLASS_UTILITY;
+    case Executor::Priority::kBackground:
+      return QOS_CLASS_BACKGROUND;
+  }
+  UNREACHABLE();
+}
+
 }  // namespace
 
 // MARK: - ExecutorLibdispatch
@@ -358,19 +372,24 @@ ExecutorLibdispatch::Id ExecutorLibdispatch::NextIdLocked() {
 
 // MARK: - Executor
 
-std::unique_ptr<Executor> Executor::CreateSerial(const char* label) {
-  dispatch_queue_t queue = dispatch_queue_create(label, DISPATCH_QUEUE_SERIAL);
+std::unique_ptr<Executor> Executor::CreateSerial(const char* label,
+                                                 Priority priority) {
+  dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+      DISPATCH_QUEUE_SERIAL, ToQosClass(priority), 0);
+  dispatch_queue_t queue = dispatch_queue_create(label, attr);
   return absl::make_unique<ExecutorLibdispatch>(queue);
 }
 
 std::unique_ptr<Executor> Executor::CreateConcurrent(const char* label,
-                                                     int threads) {
+                                                     int threads,
+                                                     Priority priority) {
   HARD_ASSERT(threads > 1);
 
   // Concurrent queues auto-create enough threads to avoid deadlock so there's
   // no need to honor the threads argument.
-  dispatch_queue_t queue =
-      dispatch_queue_create(label, DISPATCH_QUEUE_CONCURRENT);
+  dispatch_queue_attr_t attr = dispatch_queue_attr_make_with_qos_class(
+      DISPATCH_QUEUE_CONCURRENT, ToQosClass(priority), 0);
+  dispatch_queue_t queue = dispatch_queue_create(label, attr);
   return absl::make_unique<ExecutorLibdispatch>(queue);
 }
 
@@ -244,11 +244,13 @@ Task* ExecutorStd::PopFromSchedule() {
 // definition in executor_libdispatch.mm.
 #if !HAVE_LIBDISPATCH
 
-std::unique_ptr<Executor> Executor::CreateSerial(const char*) {
+std::unique_ptr<Executor> Executor::CreateSerial(const char*, Priority) {
   return absl::make_unique<ExecutorStd>(/*threads=*/1);
 }
 
-std::unique_ptr<Executor> Executor::CreateConcurrent(const char*, int threads) {
+std::unique_ptr<Executor> Executor::CreateConcurrent(const char*,
+                                                     int threads,
+                                                     Priority) {
   return absl::make_unique<ExecutorStd>(threads);
 }
 
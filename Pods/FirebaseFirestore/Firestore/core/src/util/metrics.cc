@@ -0,0 +1,336 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/metrics.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "Firestore/core/src/util/hard_assert.h"
+#include "absl/container/internal/hashtablez_sampler.h"
+#include "absl/strings/internal/cordz_functions.h"
+#include "absl/strings/internal/cordz_info.h"
+#include "absl/numeric/bits.h"
+#include "absl/strings/str_cat.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+namespace chr = std::chrono;
+
+constexpr std::memory_order kRelaxed = std::memory_order_relaxed;
+
+size_t BucketIndex(uint64_t value) {
+  return static_cast<size_t>(absl::bit_width(value));
+}
+
+/** The largest value that falls into the bucket at `index`. */
+uint64_t BucketUpperBound(size_t index) {
+  if (index == 0) {
+    return 0;
+  }
+  if (index >= 64) {
+    return UINT64_MAX;
+  }
+  return (uint64_t{1} << index) - 1;
+}
+
+template <typename Frame>
+std::vector<uintptr_t> StackAddresses(const Frame& frames) {
+  std::vector<uintptr_t> result;
+  for (void* frame : frames) {
+    result.push_back(reinterpret_cast<uintptr_t>(frame));
+  }
+  return result;
+}
+
+void AppendStackJson(std::string* out, const std::vector<uintptr_t>& stack) {
+  absl::StrAppend(out, "\"stack\":[");
+  for (size_t i = 0; i < stack.size(); ++i) {
+    absl::StrAppend(out, i == 0 ? "" : ",", "\"0x", absl::Hex(stack[i]), "\"");
+  }
+  absl::StrAppend(out, "]");
+}
+
+}  // namespace
+
+constexpr size_t HistogramSnapshot::kBucketCount;
+constexpr size_t HashTableSample::kProbeLengthBucketCount;
+
+static_assert(HashTableSample::kProbeLengthBucketCount ==
+                  absl::container_internal::HashtablezInfo::kProbeLengthBuckets,
+              "Probe length histograms must match");
+
+const char* MetricName(MetricCounter counter) {
+  switch (counter) {
+    case MetricCounter::kQueriesExecuted:
+      return "queries_executed";
+    case MetricCounter::kQueryPlanIndexScan:
+      return "query_plan_index_scan";
+    case MetricCounter::kQueryPlanPreviousResults:
+      return "query_plan_previous_results";
+    case MetricCounter::kQueryPlanFullCollectionScan:
+      return "query_plan_full_collection_scan";
+    case MetricCounter::kDocumentsScanned:
+      return "documents_scanned";
+    case MetricCounter::kDocumentsReturned:
+      return "documents_returned";
+    case MetricCounter::kWatchBytesReceived:
+      return "watch_bytes_received";
+    case MetricCounter::kGarbageCollections:
+      return "garbage_collections";
+  }
+  UNREACHABLE();
+}
+
+const char* MetricName(MetricHistogram histogram) {
+  switch (histogram) {
+    case MetricHistogram::kQueryExecutionMicros:
+      return "query_execution_micros";
+    case MetricHistogram::kDocumentDecodeMicros:
+      return "document_decode_micros";
+    case MetricHistogram::kAsyncQueueWaitMicros:
+      return "async_queue_wait_micros";
+    case MetricHistogram::kWritePipelineDepth:
+      return "write_pipeline_depth";
+    case MetricHistogram::kGarbageCollectionMicros:
+      return "garbage_collection_micros";
+    case MetricHistogram::kGrpcConcurrentCalls:
+      return "grpc_concurrent_calls";
+    case MetricHistogram::kStreamBackoffMillis:
+      return "stream_backoff_millis";
+    case MetricHistogram::kTimeToFirstSnapshotMicros:
+      return "time_to_first_snapshot_micros";
+  }
+  UNREACHABLE();
+}
+
+double HistogramSnapshot::Mean() const {
+  return count == 0 ? 0
+                    : static_cast<double>(sum) / static_cast<double>(count);
+}
+
+uint64_t HistogramSnapshot::Percentile(double fraction) const {
+  if (count == 0) {
+    return 0;
+  }
+
+  auto rank = static_cast<uint64_t>(
+      std::ceil(std::min(std::max(fraction, 0.0), 1.0) *
+                static_cast<double>(count)));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < kBucketCount; ++i) {
+    seen += buckets[i];
+    if (seen >= rank) {
+      return std::min(BucketUpperBound(i), max);
+    }
+  }
+  return max;
+}
+
+std::string MetricsSnapshot::ToJson() const {
+  // Metric names are plain identifiers, so nothing needs escaping.
+  std::string result = "{\"counters\":{";
+  for (size_t i = 0; i < kMetricCounterCount; ++i) {
+    absl::StrAppend(&result, i == 0 ? "" : ",", "\"",
+                    MetricName(static_cast<MetricCounter>(i)),
+                    "\":", counters[i]);
+  }
+
+  absl::StrAppend(&result, "},\"histograms\":{");
+  for (size_t i = 0; i < kMetricHistogramCount; ++i) {
+    const HistogramSnapshot& value = histograms[i];
+    absl::StrAppend(&result, i == 0 ? "" : ",", "\"",
+                    MetricName(static_cast<MetricHistogram>(i)), "\":{");
+    absl::StrAppend(&result, "\"count\":", value.count,
+                    ",\"sum\":", value.sum, ",\"max\":", value.max,
+                    ",\"mean\":", value.Mean());
+    absl::StrAppend(&result, ",\"p50\":", value.Percentile(0.5),
+                    ",\"p90\":", value.Percentile(0.9),
+                    ",\"p99\":", value.Percentile(0.99), "}");
+  }
+  absl::StrAppend(&result, "},\"hash_tables\":[");
+  for (size_t i = 0; i < hash_tables.size(); ++i) {
+    const HashTableSample& table = hash_tables[i];
+    absl::StrAppend(&result, i == 0 ? "" : ",",
+                    "{\"capacity\":", table.capacity, ",\"size\":", table.size,
+                    ",\"element_size\":", table.element_size,
+                    ",\"rehashes\":", table.rehashes,
+                    ",\"max_probe_length\":", table.max_probe_length,
+                    ",\"tombstone_ratio\":", table.tombstone_ratio);
+    absl::StrAppend(&result, ",\"probe_lengths\":[");
+    for (size_t b = 0; b < table.probe_lengths.size(); ++b) {
+      absl::StrAppend(&result, b == 0 ? "" : ",", table.probe_lengths[b]);
+    }
+    absl::StrAppend(&result, "],");
+    AppendStackJson(&result, table.stack);
+    absl::StrAppend(&result, "}");
+  }
+
+  absl::StrAppend(&result, "],\"cord_call_sites\":[");
+  for (size_t i = 0; i < cord_call_sites.size(); ++i) {
+    const CordCallSiteSample& site = cord_call_sites[i];
+    absl::StrAppend(&result, i == 0 ? "" : ",", "{\"cords\":", site.cords,
+                    ",\"size\":", site.size, ",\"memory\":", site.memory,
+                    ",\"fair_share_memory\":", site.fair_share_memory);
+    absl::StrAppend(&result, ",\"nodes\":", site.nodes,
+                    ",\"flats\":", site.flats,
+                    ",\"small_flats\":", site.small_flats,
+                    ",\"externals\":", site.externals, ",");
+    AppendStackJson(&result, site.stack);
+    absl::StrAppend(&result, "}");
+  }
+
+  absl::StrAppend(&result, "],\"startup\":{");
+  for (size_t i = 0; i < startup_phases.size(); ++i) {
+    const StartupPhaseSummary& phase = startup_phases[i];
+    absl::StrAppend(&result, i == 0 ? "" : ",", "\"",
+                    StartupPhaseName(phase.phase),
+                    "\":{\"count\":", phase.count,
+                    ",\"first_start_micros\":", phase.first_start_micros,
+                    ",\"first_duration_micros\":", phase.first_duration_micros,
+                    ",\"total_micros\":", phase.total_micros, "}");
+  }
+  absl::StrAppend(&result, "}}");
+  return result;
+}
+
+bool SetHashTableSampling(bool enabled, int32_t rate) {
+  namespace hz = absl::container_internal;
+  if (!hz::HashtablezSamplerBuilt()) {
+    return false;
+  }
+  if (enabled) {
+    hz::SetHashtablezSampleParameter(rate);
+  }
+  hz::SetHashtablezEnabled(enabled);
+  return true;
+}
+
+std::vector<HashTableSample> SampleHashTables() {
+  std::vector<HashTableSample> result;
+  absl::container_internal::ExportHashtablezSamples(
+      [&result](const absl::container_internal::HashtablezSnapshot& info) {
+        HashTableSample sample;
+        sample.capacity = info.capacity;
+        sample.size = info.size;
+        sample.element_size = info.inline_element_size;
+        sample.rehashes = info.num_rehashes;
+        sample.max_probe_length = info.max_probe_length;
+        std::copy(std::begin(info.probe_length_histogram),
+                  std::end(info.probe_length_histogram),
+                  sample.probe_lengths.begin());
+        sample.tombstone_ratio = info.TombstoneRatio();
+        sample.stack = StackAddresses(info.stack);
+        result.push_back(std::move(sample));
+      });
+  return result;
+}
+
+bool SetCordSampling(int32_t mean_interval) {
+#ifdef ABSL_INTERNAL_CORDZ_ENABLED
+  absl::cord_internal::set_cordz_mean_interval(std::max(mean_interval, 0));
+  return true;
+#else
+  (void)mean_interval;
+  return false;
+#endif
+}
+
+std::vector<CordCallSiteSample> SampleCordCallSites() {
+  std::vector<CordCallSiteSample> result;
+  for (const absl::cord_internal::CordzCallSiteStatistics& stats :
+       absl::cord_internal::AggregateCordzStatisticsByCallSite()) {
+    CordCallSiteSample site;
+    site.cords = stats.cords;
+    site.size = static_cast<uint64_t>(stats.size);
+    site.memory = static_cast<uint64_t>(stats.estimated_memory_usage);
+    site.fair_share_memory =
+        static_cast<uint64_t>(stats.estimated_fair_share_memory_usage);
+    site.nodes = static_cast<uint64_t>(stats.node_count);
+    site.flats = stats.node_counts.flat;
+    site.small_flats = stats.node_counts.flat_64 + stats.node_counts.flat_128;
+    site.externals = stats.node_counts.external;
+    site.stack = StackAddresses(stats.stack);
+    result.push_back(std::move(site));
+  }
+  return result;
+}
+
+void Metrics::Increment(MetricCounter counter, uint64_t amount) {
+  counters_[static_cast<size_t>(counter)].fetch_add(amount, kRelaxed);
+}
+
+void Metrics::Record(MetricHistogram histogram, uint64_t value) {
+  Histogram& target = histograms_[static_cast<size_t>(histogram)];
+  target.count.fetch_add(1, kRelaxed);
+  target.sum.fetch_add(value, kRelaxed);
+  target.buckets[BucketIndex(value)].fetch_add(1, kRelaxed);
+
+  uint64_t max = target.max.load(kRelaxed);
+  while (value > max &&
+         !target.max.compare_exchange_weak(max, value, kRelaxed)) {
+  }
+}
+
+void Metrics::RecordSince(MetricHistogram histogram,
+                          Clock::time_point start) {
+  auto elapsed =
+      chr::duration_cast<chr::microseconds>(Clock::now() - start).count();
+  Record(histogram, static_cast<uint64_t>(std::max<int64_t>(elapsed, 0)));
+}
+
+MetricsSnapshot Metrics::Snapshot() const {
+  MetricsSnapshot result;
+  for (size_t i = 0; i < kMetricCounterCount; ++i) {
+    result.counters[i] = counters_[i].load(kRelaxed);
+  }
+
+  for (size_t i = 0; i < kMetricHistogramCount; ++i) {
+    const Histogram& source = histograms_[i];
+    HistogramSnapshot& target = result.histograms[i];
+    target.count = source.count.load(kRelaxed);
+    target.sum = source.sum.load(kRelaxed);
+    target.max = source.max.load(kRelaxed);
+    for (size_t b = 0; b < HistogramSnapshot::kBucketCount; ++b) {
+      target.buckets[b] = source.buckets[b].load(kRelaxed);
+    }
+  }
+  return result;
+}
+
+void Metrics::Reset() {
+  for (std::atomic<uint64_t>& counter : counters_) {
+    counter.store(0, kRelaxed);
+  }
+
+  for (Histogram& histogram : histograms_) {
+    histogram.count.store(0, kRelaxed);
+    histogram.sum.store(0, kRelaxed);
+    histogram.max.store(0, kRelaxed);
+    for (std::atomic<uint64_t>& bucket : histogram.buckets) {
+      bucket.store(0, kRelaxed);
+    }
+  }
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
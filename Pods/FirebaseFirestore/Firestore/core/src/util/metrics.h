@@ -0,0 +1,285 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_METRICS_H_
+#define FIRESTORE_CORE_SRC_UTIL_METRICS_H_
+
+#include <array>
+#include <atomic>
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "Firestore/core/src/util/startup_trace.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/** The counters recorded by `Metrics`. */
+enum class MetricCounter {
+  /** Queries executed against the local cache. */
+  kQueriesExecuted,
+  /** Queries served from a persisted field index. */
+  kQueryPlanIndexScan,
+  /** Queries served from the documents that matched their last snapshot. */
+  kQueryPlanPreviousResults,
+  /** Queries served by reading every document of their collection. */
+  kQueryPlanFullCollectionScan,
+  /** Documents read from the cache while executing queries. */
+  kDocumentsScanned,
+  /** Documents that matched the queries they were read for. */
+  kDocumentsReturned,
+  /** Serialized bytes of all messages received on the watch stream. */
+  kWatchBytesReceived,
+  /** Garbage collection passes over the local cache. */
+  kGarbageCollections,
+};
+
+/** The histograms recorded by `Metrics`. */
+enum class MetricHistogram {
+  /** Time spent executing a query against the local cache, in microseconds. */
+  kQueryExecutionMicros,
+  /** Time spent decoding a document read from the cache, in microseconds. */
+  kDocumentDecodeMicros,
+  /**
+   * Time an operation waited on the worker queue before it started running,
+   * in microseconds.
+   */
+  kAsyncQueueWaitMicros,
+  /** The number of mutation batches in the write pipeline, per added batch. */
+  kWritePipelineDepth,
+  /** Time spent in a garbage collection pass, in microseconds. */
+  kGarbageCollectionMicros,
+  /**
+   * The number of calls in progress on a gRPC channel, that is its concurrent
+   * HTTP/2 streams, per started call.
+   */
+  kGrpcConcurrentCalls,
+  /** The delay before a stream reconnects after an error, in milliseconds. */
+  kStreamBackoffMillis,
+  /**
+   * Time from adding a snapshot listener until its first snapshot was raised,
+   * in microseconds.
+   */
+  kTimeToFirstSnapshotMicros,
+};
+
+constexpr size_t kMetricCounterCount = 8;
+constexpr size_t kMetricHistogramCount = 8;
+
+/** Returns a stable name of `counter`, for exporting to dashboards. */
+const char* MetricName(MetricCounter counter);
+
+/** Returns a stable name of `histogram`, for exporting to dashboards. */
+const char* MetricName(MetricHistogram histogram);
+
+/**
+ * The distribution of the values recorded in a histogram. Values are bucketed
+ * by powers of two: bucket zero counts zeros and bucket `i` counts the values
+ * in `[2^(i-1), 2^i)`.
+ */
+struct HistogramSnapshot {
+  static constexpr size_t kBucketCount = 65;
+
+  uint64_t count = 0;
+  uint64_t sum = 0;
+  uint64_t max = 0;
+  std::array<uint64_t, kBucketCount> buckets{};
+
+  /** The average of the recorded values, or zero if there are none. */
+  double Mean() const;
+
+  /**
+   * Returns an upper bound of the smallest value that is at least as large as
+   * the given fraction of the recorded values, e.g. 0.99 for the 99th
+   * percentile. The bound is at most twice the actual value.
+   */
+  uint64_t Percentile(double fraction) const;
+};
+
+/**
+ * A hash table of the process sampled by Abseil's hashtablez sampler, to find
+ * oversized or badly hashed maps; see `SetHashTableSampling()`.
+ */
+struct HashTableSample {
+  static constexpr size_t kProbeLengthBucketCount = 8;
+
+  uint64_t capacity = 0;
+  uint64_t size = 0;
+  /** The size of a slot, i.e. of an element stored inline, in bytes. */
+  uint64_t element_size = 0;
+  uint64_t rehashes = 0;
+  /** The longest probe of an insert, in groups of slots past the first. */
+  uint64_t max_probe_length = 0;
+  /**
+   * The number of inserts by probe length: bucket `i` counts the inserts that
+   * probed `i` groups past the first, the last bucket all the longer ones.
+   */
+  std::array<uint64_t, kProbeLengthBucketCount> probe_lengths{};
+  /** An upper bound of the fraction of slots holding tombstones. */
+  double tombstone_ratio = 0;
+  /** The addresses of the allocating stack, innermost frame first. */
+  std::vector<uintptr_t> stack;
+};
+
+/**
+ * Starts or stops sampling about one in `rate` of the hash tables the process
+ * allocates. Returns false, and has no effect, unless Abseil was built with
+ * `ABSL_HASHTABLEZ_BUILD_SAMPLER`.
+ */
+bool SetHashTableSampling(bool enabled, int32_t rate = 1024);
+
+/** Returns the live sampled hash tables of the process. */
+std::vector<HashTableSample> SampleHashTables();
+
+/**
+ * The memory of the live sampled `absl::Cord`s of the process created at one
+ * call site, to attribute large cord trees and fragmentation; see
+ * `SetCordSampling()`.
+ */
+struct CordCallSiteSample {
+  uint64_t cords = 0;
+  /** The sum of the cords' sizes, in bytes. */
+  uint64_t size = 0;
+  /** The memory the cords reference, in bytes. */
+  uint64_t memory = 0;
+  /** The share of that memory not shared with other cords, in bytes. */
+  uint64_t fair_share_memory = 0;
+  uint64_t nodes = 0;
+  uint64_t flats = 0;
+  /** Flats of up to 128 bytes, a sign of fragmentation. */
+  uint64_t small_flats = 0;
+  uint64_t externals = 0;
+  /** The addresses of the sampling stack, innermost frame first. */
+  std::vector<uintptr_t> stack;
+};
+
+/**
+ * Samples about one in `mean_interval` of the cords the process creates, or
+ * none if zero. Returns false, and has no effect, on platforms where Abseil
+ * was built without cord sampling (by default, Apple and Android; see
+ * `ABSL_CORDZ_BUILD_SAMPLER`).
+ */
+bool SetCordSampling(int32_t mean_interval);
+
+/** Returns the live sampled cords by call site, largest fair share first. */
+std::vector<CordCallSiteSample> SampleCordCallSites();
+
+/** The values of all counters and histograms at a point in time. */
+struct MetricsSnapshot {
+  std::array<uint64_t, kMetricCounterCount> counters{};
+  std::array<HistogramSnapshot, kMetricHistogramCount> histograms{};
+  /** Sampled process-wide, so the same for every client. */
+  std::vector<HashTableSample> hash_tables;
+  /** Sampled process-wide, so the same for every client. */
+  std::vector<CordCallSiteSample> cord_call_sites;
+  /** Traced process-wide, so the same for every client. */
+  std::vector<StartupPhaseSummary> startup_phases;
+
+  uint64_t counter(MetricCounter counter) const {
+    return counters[static_cast<size_t>(counter)];
+  }
+
+  const HistogramSnapshot& histogram(MetricHistogram histogram) const {
+    return histograms[static_cast<size_t>(histogram)];
+  }
+
+  /**
+   * Returns the values as a JSON object keyed by metric name, for benchmark
+   * harnesses and dashboards. Histograms are summarized by their count, sum,
+   * max, mean and 50th, 90th and 99th percentiles; hash table and cord stacks
+   * are hex addresses, to be symbolized offline. Startup phases are keyed by
+   * their `StartupPhaseName()`.
+   */
+  std::string ToJson() const;
+};
+
+/**
+ * Counters and latency histograms of the hot paths of a client, read by apps
+ * to diagnose slow screens.
+ *
+ * Recording is lock-free and may happen on any thread; components hold a
+ * nullable pointer to the client's `Metrics` and skip both the recording and
+ * the clock reads it needs when metrics are disabled.
+ */
+class Metrics {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  void Increment(MetricCounter counter, uint64_t amount = 1);
+
+  void Record(MetricHistogram histogram, uint64_t value);
+
+  /** Records the time elapsed since `start` in microseconds. */
+  void RecordSince(MetricHistogram histogram, Clock::time_point start);
+
+  /**
+   * Returns the current values. Values recorded concurrently may or may not
+   * be included, so the counts of a histogram can be briefly inconsistent.
+   */
+  MetricsSnapshot Snapshot() const;
+
+  void Reset();
+
+ private:
+  struct Histogram {
+    std::atomic<uint64_t> count{0};
+    std::atomic<uint64_t> sum{0};
+    std::atomic<uint64_t> max{0};
+    std::array<std::atomic<uint64_t>, HistogramSnapshot::kBucketCount>
+        buckets{};
+  };
+
+  std::array<std::atomic<uint64_t>, kMetricCounterCount> counters_{};
+  std::array<Histogram, kMetricHistogramCount> histograms_;
+};
+
+/**
+ * Records the time between its construction and destruction into a histogram
+ * of the given metrics. Does nothing if `metrics` is null.
+ */
+class ScopedLatency {
+ public:
+  ScopedLatency(Metrics* metrics, MetricHistogram histogram)
+      : metrics_{metrics}, histogram_{histogram} {
+    if (metrics_) {
+      start_ = Metrics::Clock::now();
+    }
+  }
+
+  ~ScopedLatency() {
+    if (metrics_) {
+      metrics_->RecordSince(histogram_, start_);
+    }
+  }
+
+  ScopedLatency(const ScopedLatency&) = delete;
+  ScopedLatency& operator=(const ScopedLatency&) = delete;
+
+ private:
+  Metrics* metrics_ = nullptr;
+  MetricHistogram histogram_;
+  Metrics::Clock::time_point start_;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_METRICS_H_
@@ -158,6 +158,15 @@ class RandomAccessQueue {
     return queue_.empty();
   }
 
+  /**
+   * Returns the number of elements in this queue.
+   *
+   * This method has constant-time complexity.
+   */
+  size_t size() const {
+    return queue_entries_by_element_.size();
+  }
+
   /**
    * Returns whether or not this queue contains the given element.
    *
@@ -0,0 +1,211 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "Firestore/core/src/util/startup_trace.h"
+
+#include <array>
+#include <atomic>
+#include <cstring>
+#include <mutex>  // NOLINT(build/c++11)
+
+#if defined(__APPLE__)
+#include <crt_externs.h>
+#include <os/log.h>
+#include <os/signpost.h>
+#endif  // defined(__APPLE__)
+
+#include "Firestore/core/src/util/hard_assert.h"
+
+namespace firebase {
+namespace firestore {
+namespace util {
+namespace {
+
+namespace chr = std::chrono;
+
+/** The launch argument that enables tracing before the app's code runs. */
+const char* const kLaunchArgument = "-FIRStartupTracingEnabled";
+
+bool EnabledByLaunchArgument() {
+#if defined(__APPLE__)
+  int argc = *_NSGetArgc();
+  char** argv = *_NSGetArgv();
+  for (int i = 1; i < argc; ++i) {
+    if (std::strcmp(argv[i], kLaunchArgument) == 0) {
+      return true;
+    }
+  }
+#endif  // defined(__APPLE__)
+  return false;
+}
+
+struct TraceState {
+  std::mutex mutex;
+  StartupSpan::Clock::time_point origin = StartupSpan::Clock::now();
+  std::array<StartupPhaseSummary, kStartupPhaseCount> phases{};
+};
+
+TraceState& GetTraceState() {
+  static auto* state = new TraceState();
+  return *state;
+}
+
+bool InitiallyEnabled() {
+  // Creates the state first, so that its origin precedes all spans.
+  GetTraceState();
+  return EnabledByLaunchArgument();
+}
+
+std::atomic<bool>& EnabledFlag() {
+  static std::atomic<bool> enabled{InitiallyEnabled()};
+  return enabled;
+}
+
+#if defined(__APPLE__)
+
+os_log_t SignpostLog() {
+  static os_log_t log = os_log_create("com.google.firebase.firestore",
+                                      "Startup");
+  return log;
+}
+
+uint64_t BeginSignpost(const char* name) {
+  if (__builtin_available(iOS 12.0, macOS 10.14, tvOS 12.0, watchOS 5.0, *)) {
+    os_signpost_id_t id = os_signpost_id_generate(SignpostLog());
+    os_signpost_interval_begin(SignpostLog(), id, "Firestore startup",
+                               "%{public}s", name);
+    return id;
+  }
+  return 0;
+}
+
+void EndSignpost(uint64_t id, const char* name, bool recorded) {
+  if (__builtin_available(iOS 12.0, macOS 10.14, tvOS 12.0, watchOS 5.0, *)) {
+    os_signpost_interval_end(SignpostLog(), id, "Firestore startup",
+                             "%{public}s%{public}s", name,
+                             recorded ? "" : " (discarded)");
+  }
+}
+
+#else  // !defined(__APPLE__)
+
+uint64_t BeginSignpost(const char*) {
+  return 0;
+}
+
+void EndSignpost(uint64_t, const char*, bool) {
+}
+
+#endif  // defined(__APPLE__)
+
+uint64_t ToMicros(StartupSpan::Clock::duration duration) {
+  return static_cast<uint64_t>(
+      chr::duration_cast<chr::microseconds>(duration).count());
+}
+
+}  // namespace
+
+const char* StartupPhaseName(StartupPhase phase) {
+  switch (phase) {
+    case StartupPhase::kClientInitialize:
+      return "client_initialize";
+    case StartupPhase::kGrpcInit:
+      return "grpc_init";
+    case StartupPhase::kLevelDbOpen:
+      return "leveldb_open";
+    case StartupPhase::kLevelDbRecover:
+      return "leveldb_recover";
+    case StartupPhase::kLevelDbMigrations:
+      return "leveldb_migrations";
+    case StartupPhase::kOverlayMigration:
+      return "overlay_migration";
+    case StartupPhase::kLocalStoreStart:
+      return "local_store_start";
+    case StartupPhase::kStreamOpen:
+      return "stream_open";
+  }
+  UNREACHABLE();
+}
+
+void SetStartupTracingEnabled(bool enabled) {
+  TraceState& state = GetTraceState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  if (enabled && !EnabledFlag().load()) {
+    state.origin = StartupSpan::Clock::now();
+    state.phases = {};
+  }
+  EnabledFlag().store(enabled);
+}
+
+bool IsStartupTracingEnabled() {
+  return EnabledFlag().load(std::memory_order_relaxed);
+}
+
+std::vector<StartupPhaseSummary> GetStartupTraceSummary() {
+  TraceState& state = GetTraceState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  std::vector<StartupPhaseSummary> result;
+  for (const StartupPhaseSummary& phase : state.phases) {
+    if (phase.count > 0) {
+      result.push_back(phase);
+    }
+  }
+  return result;
+}
+
+StartupSpan::StartupSpan(StartupPhase phase) : phase_(phase) {
+  if (IsStartupTracingEnabled()) {
+    active_ = true;
+    start_ = Clock::now();
+    signpost_id_ = BeginSignpost(StartupPhaseName(phase_));
+  }
+}
+
+void StartupSpan::End() {
+  if (!active_) {
+    return;
+  }
+  active_ = false;
+  Clock::time_point end = Clock::now();
+  EndSignpost(signpost_id_, StartupPhaseName(phase_), /*recorded=*/true);
+
+  TraceState& state = GetTraceState();
+  std::lock_guard<std::mutex> lock(state.mutex);
+  // Spans that began before tracing was (re-)enabled are not counted.
+  if (start_ < state.origin) {
+    return;
+  }
+  StartupPhaseSummary& summary = state.phases[static_cast<size_t>(phase_)];
+  uint64_t duration = ToMicros(end - start_);
+  if (summary.count == 0) {
+    summary.phase = phase_;
+    summary.first_start_micros = ToMicros(start_ - state.origin);
+    summary.first_duration_micros = duration;
+  }
+  ++summary.count;
+  summary.total_micros += duration;
+}
+
+void StartupSpan::Discard() {
+  if (active_) {
+    active_ = false;
+    EndSignpost(signpost_id_, StartupPhaseName(phase_), /*recorded=*/false);
+  }
+}
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
@@ -0,0 +1,116 @@
+/*
+ * Copyright 2022 Google LLC
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *      http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef FIRESTORE_CORE_SRC_UTIL_STARTUP_TRACE_H_
+#define FIRESTORE_CORE_SRC_UTIL_STARTUP_TRACE_H_
+
+#include <chrono>  // NOLINT(build/c++11)
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace firebase {
+namespace firestore {
+namespace util {
+
+/** The phases of a cold start traced by `StartupSpan`. */
+enum class StartupPhase {
+  /** `FirestoreClient::Initialize`, which contains most of the phases. */
+  kClientInitialize,
+  /**
+   * Creating the datastore, whose completion queue runs `grpc_init` for the
+   * first client of the process.
+   */
+  kGrpcInit,
+  /** `LevelDbOpener::Create`, from locating the directory to the LRU setup. */
+  kLevelDbOpen,
+  /** `leveldb::DB::Open`, which replays the log of the last session. */
+  kLevelDbRecover,
+  /** Running the schema migrations of `LevelDbMigrations`. */
+  kLevelDbMigrations,
+  /** Building the document overlays of pending writes for the user. */
+  kOverlayMigration,
+  /** `LocalStore::Start`, which reads the mutation queue and target cache. */
+  kLocalStoreStart,
+  /** From starting a stream until its channel connected and it opened. */
+  kStreamOpen,
+};
+
+constexpr size_t kStartupPhaseCount = 8;
+
+/** Returns a stable name of `phase`, for exporting to dashboards. */
+const char* StartupPhaseName(StartupPhase phase);
+
+/** The traced runs of one startup phase in this process. */
+struct StartupPhaseSummary {
+  StartupPhase phase = StartupPhase::kClientInitialize;
+  uint64_t count = 0;
+  /** When the first run began, counted from when tracing was enabled. */
+  uint64_t first_start_micros = 0;
+  uint64_t first_duration_micros = 0;
+  uint64_t total_micros = 0;
+};
+
+/**
+ * Enables or disables startup tracing for the process. Tracing is off unless
+ * enabled here or, on Apple platforms, by launching the app with the
+ * `-FIRStartupTracingEnabled` argument, which also reaches the phases that
+ * run before the app can call this.
+ */
+void SetStartupTracingEnabled(bool enabled);
+
+bool IsStartupTracingEnabled();
+
+/** Returns the phases that ran at least once since tracing was enabled. */
+std::vector<StartupPhaseSummary> GetStartupTraceSummary();
+
+/**
+ * Traces one run of a startup phase, from its construction until `End()` or
+ * its destruction. On Apple platforms each run is also an `os_signpost`
+ * interval, shown by Instruments next to the other Firebase signposts. Does
+ * nothing unless startup tracing is enabled.
+ */
+class StartupSpan {
+ public:
+  using Clock = std::chrono::steady_clock;
+
+  explicit StartupSpan(StartupPhase phase);
+
+  ~StartupSpan() {
+    End();
+  }
+
+  StartupSpan(const StartupSpan&) = delete;
+  StartupSpan& operator=(const StartupSpan&) = delete;
+
+  /** Records the run. Later calls do nothing. */
+  void End();
+
+  /** Drops the run without recording it, e.g. if the phase failed. */
+  void Discard();
+
+ private:
+  StartupPhase phase_;
+  bool active_ = false;
+  uint64_t signpost_id_ = 0;
+  Clock::time_point start_;
+};
+
+}  // namespace util
+}  // namespace firestore
+}  // namespace firebase
+
+#endif  // FIRESTORE_CORE_SRC_UTIL_STARTUP_TRACE_H_
@@ -20,6 +20,7 @@
 #import "filter_policy.h"
 #import "iterator.h"
 #import "options.h"
+#import "rate_limiter.h"
 #import "slice.h"
 #import "status.h"
 #import "table.h"
@@ -20,6 +20,10 @@
 #include <intrin.h>
 #endif
 
+#if defined(TARGET_OS_IPHONE) && TARGET_OS_IPHONE
+#include <mach/mach_time.h>
+#endif
+
 #if defined(__powerpc__) || defined(__ppc__)
 #ifdef __GLIBC__
 #include <sys/platform/ppc.h>
@@ -35,7 +39,27 @@ namespace absl {
 ABSL_NAMESPACE_BEGIN
 namespace base_internal {
 
-#if defined(__i386__)
+#if defined(TARGET_OS_IPHONE) && TARGET_OS_IPHONE
+
+// Apps cannot read the hardware counter directly on iOS, but the kernel
+// publishes the timebase to user space and mach_continuous_time() reads it
+// without a system call. Unlike mach_absolute_time() it keeps counting while
+// the device sleeps, which GetCurrentTimeNanos() relies on to notice that
+// its calibration has gone stale. Releases without it only have the latter.
+int64_t UnscaledCycleClock::Now() {
+  if (__builtin_available(iOS 10.0, tvOS 10.0, watchOS 3.0, *)) {
+    return static_cast<int64_t>(mach_continuous_time());
+  }
+  return static_cast<int64_t>(mach_absolute_time());
+}
+
+double UnscaledCycleClock::Frequency() {
+  mach_timebase_info_data_t timebase = {0, 1};
+  mach_timebase_info(&timebase);
+  return 1e9 * timebase.denom / timebase.numer;
+}
+
+#elif defined(__i386__)
 
 int64_t UnscaledCycleClock::Now() {
   int64_t ret;
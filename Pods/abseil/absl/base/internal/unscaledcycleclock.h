@@ -58,9 +58,9 @@
 // usable counter. The CycleTimer interface also requires a *scaled*
 // CycleClock that runs at atleast 1 MHz. We've found some Android
 // ARM64 devices where this is not the case, so we disable it by
-// default on Android ARM64.
-#if defined(__native_client__) ||                      \
-    (defined(TARGET_OS_IPHONE) && TARGET_OS_IPHONE) || \
+// default on Android ARM64. iOS sandboxes the hardware counter too, but there
+// the counter is read through mach_continuous_time() instead.
+#if defined(__native_client__) || \
     (defined(__ANDROID__) && defined(__aarch64__))
 #define ABSL_USE_UNSCALED_CYCLECLOCK_DEFAULT 0
 #else
@@ -81,7 +81,8 @@
 // This macro can be used to test if UnscaledCycleClock::Frequency()
 // is NominalCPUFrequency() on a particular platform.
 #if (defined(__i386__) || defined(__x86_64__) || defined(__riscv) || \
-     defined(_M_IX86) || defined(_M_X64))
+     defined(_M_IX86) || defined(_M_X64)) &&                         \
+    !(defined(TARGET_OS_IPHONE) && TARGET_OS_IPHONE)
 #define ABSL_INTERNAL_UNSCALED_CYCLECLOCK_FREQUENCY_IS_CPU_FREQUENCY
 #endif
 
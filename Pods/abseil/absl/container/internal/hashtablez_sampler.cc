@@ -14,6 +14,7 @@
 
 #include "absl/container/internal/hashtablez_sampler.h"
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cmath>
@@ -32,6 +33,7 @@ namespace absl {
 ABSL_NAMESPACE_BEGIN
 namespace container_internal {
 constexpr int HashtablezInfo::kMaxStackDepth;
+constexpr size_t HashtablezInfo::kProbeLengthBuckets;
 
 namespace {
 ABSL_CONST_INIT std::atomic<bool> g_hashtablez_enabled{
@@ -72,6 +74,9 @@ void HashtablezInfo::PrepareForSampling() {
   hashes_bitwise_and.store(~size_t{}, std::memory_order_relaxed);
   hashes_bitwise_xor.store(0, std::memory_order_relaxed);
   max_reserve.store(0, std::memory_order_relaxed);
+  for (auto& bucket : probe_length_histogram) {
+    bucket.store(0, std::memory_order_relaxed);
+  }
 
   create_time = absl::Now();
   // The inliner makes hardcoded skip_count difficult (especially when combined
@@ -160,6 +165,9 @@ void RecordInsertSlow(HashtablezInfo* info, size_t hash,
                probe_length),
       std::memory_order_relaxed);
   info->total_probe_length.fetch_add(probe_length, std::memory_order_relaxed);
+  info->probe_length_histogram[std::min(
+      probe_length, HashtablezInfo::kProbeLengthBuckets - 1)]
+      .fetch_add(1, std::memory_order_relaxed);
   info->size.fetch_add(1, std::memory_order_relaxed);
 }
 
@@ -185,6 +193,37 @@ void SetHashtablezMaxSamples(int32_t max) {
   }
 }
 
+bool HashtablezSamplerBuilt() {
+#if defined(ABSL_INTERNAL_HASHTABLEZ_SAMPLE)
+  return true;
+#else
+  return false;
+#endif
+}
+
+int64_t ExportHashtablezSamples(
+    const std::function<void(const HashtablezSnapshot&)>& f) {
+  return GlobalHashtablezSampler().Iterate([&f](const HashtablezInfo& info) {
+    constexpr auto kRelaxed = std::memory_order_relaxed;
+    HashtablezSnapshot snapshot;
+    snapshot.capacity = info.capacity.load(kRelaxed);
+    snapshot.size = info.size.load(kRelaxed);
+    snapshot.num_erases = info.num_erases.load(kRelaxed);
+    snapshot.num_rehashes = info.num_rehashes.load(kRelaxed);
+    snapshot.max_probe_length = info.max_probe_length.load(kRelaxed);
+    snapshot.total_probe_length = info.total_probe_length.load(kRelaxed);
+    for (size_t i = 0; i < HashtablezInfo::kProbeLengthBuckets; ++i) {
+      snapshot.probe_length_histogram[i] =
+          info.probe_length_histogram[i].load(kRelaxed);
+    }
+    snapshot.max_reserve = info.max_reserve.load(kRelaxed);
+    snapshot.inline_element_size = info.inline_element_size;
+    snapshot.create_time = info.create_time;
+    snapshot.stack.assign(info.stack, info.stack + info.depth);
+    f(snapshot);
+  });
+}
+
 }  // namespace container_internal
 ABSL_NAMESPACE_END
 }  // namespace absl
@@ -26,6 +26,11 @@
 // `Sample()` and `Unsample()` make use of a single global sampler with
 // properties controlled by the flags hashtablez_enabled,
 // hashtablez_sample_rate, and hashtablez_max_samples.
+// `ExportHashtablezSamples()` reports the live samples to profilers.
+//
+// Sampling is compiled in only if ABSL_HASHTABLEZ_BUILD_SAMPLER is defined for
+// every translation unit, as it costs a thread-local decrement per table
+// allocation even while disabled at runtime.
 //
 // WARNING
 //
@@ -40,6 +45,7 @@
 #define ABSL_CONTAINER_INTERNAL_HASHTABLEZ_SAMPLER_H_
 
 #include <atomic>
+#include <cstddef>
 #include <functional>
 #include <memory>
 #include <vector>
@@ -82,6 +88,12 @@ struct HashtablezInfo : public profiling_internal::Sample<HashtablezInfo> {
   std::atomic<size_t> hashes_bitwise_xor;
   std::atomic<size_t> max_reserve;
 
+  // The number of inserts by probe length, in groups: bucket `i` counts the
+  // inserts that probed `i` groups past the first, and the last bucket counts
+  // all the longer ones.
+  static constexpr size_t kProbeLengthBuckets = 8;
+  std::atomic<size_t> probe_length_histogram[kProbeLengthBuckets];
+
   // All of the fields below are set by `PrepareForSampling`, they must not be
   // mutated in `Record*` functions.  They are logically `const` in that sense.
   // These are guarded by init_mu, but that is not externalized to clients, who
@@ -129,6 +141,9 @@ inline void RecordStorageChangedSlow(HashtablezInfo* info, size_t size,
     // This is a clear, reset the total/num_erases too.
     info->total_probe_length.store(0, std::memory_order_relaxed);
     info->num_erases.store(0, std::memory_order_relaxed);
+    for (auto& bucket : info->probe_length_histogram) {
+      bucket.store(0, std::memory_order_relaxed);
+    }
   }
 }
 
@@ -151,6 +166,11 @@ void UnsampleSlow(HashtablezInfo* info);
 #error ABSL_INTERNAL_HASHTABLEZ_SAMPLE cannot be directly set
 #endif  // defined(ABSL_INTERNAL_HASHTABLEZ_SAMPLE)
 
+#if defined(ABSL_HASHTABLEZ_BUILD_SAMPLER) && ABSL_PER_THREAD_TLS && \
+    !defined(ABSL_BUILD_DLL) && !defined(ABSL_CONSUME_DLL)
+#define ABSL_INTERNAL_HASHTABLEZ_SAMPLE
+#endif
+
 #if defined(ABSL_INTERNAL_HASHTABLEZ_SAMPLE)
 class HashtablezInfoHandle {
  public:
@@ -267,6 +287,37 @@ void SetHashtablezSampleParameter(int32_t rate);
 // Sets a soft max for the number of samples that will be kept.
 void SetHashtablezMaxSamples(int32_t max);
 
+// Returns whether sampling is compiled in, so that enabling it has an effect.
+bool HashtablezSamplerBuilt();
+
+// A copy of a sampled table's statistics, suitable for exporting.
+struct HashtablezSnapshot {
+  size_t capacity = 0;
+  size_t size = 0;
+  // Erases since the last rehash or clear, which leave tombstones unless their
+  // group was never full: their ratio to the capacity bounds that of deleted
+  // slots.
+  size_t num_erases = 0;
+  size_t num_rehashes = 0;
+  size_t max_probe_length = 0;
+  size_t total_probe_length = 0;
+  size_t probe_length_histogram[HashtablezInfo::kProbeLengthBuckets] = {};
+  size_t max_reserve = 0;
+  size_t inline_element_size = 0;
+  absl::Time create_time;
+  // The stack the table was allocated from, innermost frame first.
+  std::vector<void*> stack;
+
+  double TombstoneRatio() const {
+    return capacity == 0 ? 0 : static_cast<double>(num_erases) / capacity;
+  }
+};
+
+// Calls `f` with a snapshot of each live sample of the global sampler, and
+// returns the number of samples dropped because of the max samples.
+int64_t ExportHashtablezSamples(
+    const std::function<void(const HashtablezSnapshot&)>& f);
+
 // Configuration override.
 // This allows process-wide sampling without depending on order of
 // initialization of static storage duration objects.
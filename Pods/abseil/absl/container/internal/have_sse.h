@@ -39,6 +39,18 @@
 #error "Bad configuration!"
 #endif
 
+// NEON group probing is used on little-endian AArch64, which includes every
+// Apple ARM64 target.
+#ifndef ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON
+#if defined(__aarch64__) && defined(__ARM_NEON) && \
+    defined(__ORDER_LITTLE_ENDIAN__) &&             \
+    __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+#define ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON 1
+#else
+#define ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON 0
+#endif
+#endif
+
 #if ABSL_INTERNAL_RAW_HASH_SET_HAVE_SSE2
 #include <emmintrin.h>
 #endif
@@ -47,4 +59,8 @@
 #include <tmmintrin.h>
 #endif
 
+#if ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON
+#include <arm_neon.h>
+#endif
+
 #endif  // ABSL_CONTAINER_INTERNAL_HAVE_SSE_H_
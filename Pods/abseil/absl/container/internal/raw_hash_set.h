@@ -457,8 +457,68 @@ struct GroupPortableImpl {
   uint64_t ctrl;
 };
 
+#if ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON
+// Same layout and bitmasks as GroupPortableImpl, but the byte comparisons are
+// done with 8-lane NEON compares, which also makes Match() exact: portable
+// Match() can report false positives next to a real match.
+struct GroupAArch64Impl {
+  static constexpr size_t kWidth = 8;
+
+  explicit GroupAArch64Impl(const ctrl_t* pos)
+      : ctrl(vld1_u8(reinterpret_cast<const uint8_t*>(pos))) {}
+
+  BitMask<uint64_t, kWidth, 3> Match(h2_t hash) const {
+    constexpr uint64_t msbs = 0x8080808080808080ULL;
+    uint8x8_t match = vceq_u8(ctrl, vdup_n_u8(hash));
+    return BitMask<uint64_t, kWidth, 3>(
+        vget_lane_u64(vreinterpret_u64_u8(match), 0) & msbs);
+  }
+
+  BitMask<uint64_t, kWidth, 3> MatchEmpty() const {
+    constexpr uint64_t msbs = 0x8080808080808080ULL;
+    uint8x8_t empty =
+        vceq_s8(vreinterpret_s8_u8(ctrl),
+                vdup_n_s8(static_cast<int8_t>(ctrl_t::kEmpty)));
+    return BitMask<uint64_t, kWidth, 3>(
+        vget_lane_u64(vreinterpret_u64_u8(empty), 0) & msbs);
+  }
+
+  BitMask<uint64_t, kWidth, 3> MatchEmptyOrDeleted() const {
+    constexpr uint64_t msbs = 0x8080808080808080ULL;
+    uint8x8_t special =
+        vcgt_s8(vdup_n_s8(static_cast<int8_t>(ctrl_t::kSentinel)),
+                vreinterpret_s8_u8(ctrl));
+    return BitMask<uint64_t, kWidth, 3>(
+        vget_lane_u64(vreinterpret_u64_u8(special), 0) & msbs);
+  }
+
+  uint32_t CountLeadingEmptyOrDeleted() const {
+    // The lowest bit of each byte of (mask | ~(mask >> 7)) is clear exactly
+    // for kEmpty and kDeleted. countr_zero(0) is 64, for a group that is all
+    // empty or deleted.
+    constexpr uint64_t lsbs = 0x0101010101010101ULL;
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(ctrl), 0);
+    return static_cast<uint32_t>(countr_zero((mask | ~(mask >> 7)) & lsbs) >>
+                                 3);
+  }
+
+  void ConvertSpecialToEmptyAndFullToDeleted(ctrl_t* dst) const {
+    constexpr uint64_t msbs = 0x8080808080808080ULL;
+    constexpr uint64_t lsbs = 0x0101010101010101ULL;
+    uint64_t mask = vget_lane_u64(vreinterpret_u64_u8(ctrl), 0);
+    auto x = mask & msbs;
+    auto res = (~x + (x >> 7)) & ~lsbs;
+    little_endian::Store64(dst, res);
+  }
+
+  uint8x8_t ctrl;
+};
+#endif  // ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON
+
 #if ABSL_INTERNAL_RAW_HASH_SET_HAVE_SSE2
 using Group = GroupSse2Impl;
+#elif ABSL_INTERNAL_RAW_HASH_SET_HAVE_NEON
+using Group = GroupAArch64Impl;
 #else
 using Group = GroupPortableImpl;
 #endif
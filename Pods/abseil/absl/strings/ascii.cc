@@ -14,6 +14,15 @@
 
 #include "absl/strings/ascii.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ABSL_INTERNAL_ASCII_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ABSL_INTERNAL_ASCII_NEON 1
+#endif
+
 namespace absl {
 ABSL_NAMESPACE_BEGIN
 namespace ascii_internal {
@@ -155,18 +164,49 @@ ABSL_DLL const char kToUpper[256] = {
 
 }  // namespace ascii_internal
 
-void AsciiStrToLower(std::string* s) {
-  for (auto& ch : *s) {
-    ch = absl::ascii_tolower(ch);
+namespace {
+
+// Flips the case of the letters from `first` to `last` in s, 16 bytes at a
+// time where vectors are available; case only differs in bit 0x20.
+template <char first, char last>
+void AsciiStrFlipCase(std::string* s) {
+  char* p = &(*s)[0];
+  char* const end = p + s->size();
+#if defined(ABSL_INTERNAL_ASCII_SSE2)
+  // Bytes of 0x80 and above compare as negative, so they aren't letters.
+  const __m128i below = _mm_set1_epi8(first - 1);
+  const __m128i above = _mm_set1_epi8(last + 1);
+  const __m128i bit = _mm_set1_epi8(0x20);
+  for (; end - p >= 16; p += 16) {
+    __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i letter = _mm_and_si128(_mm_cmpgt_epi8(chunk, below),
+                                         _mm_cmplt_epi8(chunk, above));
+    chunk = _mm_xor_si128(chunk, _mm_and_si128(letter, bit));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(p), chunk);
   }
-}
-
-void AsciiStrToUpper(std::string* s) {
-  for (auto& ch : *s) {
-    ch = absl::ascii_toupper(ch);
+#elif defined(ABSL_INTERNAL_ASCII_NEON)
+  const uint8x16_t lo = vdupq_n_u8(static_cast<uint8_t>(first));
+  const uint8x16_t hi = vdupq_n_u8(static_cast<uint8_t>(last));
+  const uint8x16_t bit = vdupq_n_u8(0x20);
+  for (; end - p >= 16; p += 16) {
+    uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t letter =
+        vandq_u8(vcgeq_u8(chunk, lo), vcleq_u8(chunk, hi));
+    chunk = veorq_u8(chunk, vandq_u8(letter, bit));
+    vst1q_u8(reinterpret_cast<uint8_t*>(p), chunk);
+  }
+#endif
+  for (; p != end; ++p) {
+    if (*p >= first && *p <= last) *p ^= 0x20;
   }
 }
 
+}  // namespace
+
+void AsciiStrToLower(std::string* s) { AsciiStrFlipCase<'A', 'Z'>(s); }
+
+void AsciiStrToUpper(std::string* s) { AsciiStrFlipCase<'a', 'z'>(s); }
+
 void RemoveExtraAsciiWhitespace(std::string* str) {
   auto stripped = StripAsciiWhitespace(*str);
 
@@ -35,15 +35,18 @@ void set_cordz_mean_interval(int32_t mean_interval);
 // Enable cordz unless any of the following applies:
 // - no thread local support
 // - MSVC build
-// - Android build
-// - Apple build
+// - Android build, unless ABSL_CORDZ_BUILD_SAMPLER is defined
+// - Apple build, unless ABSL_CORDZ_BUILD_SAMPLER is defined
 // - DLL build
 // Hashtablez is turned off completely in opensource builds.
 // MSVC's static atomics are dynamically initialized in debug mode, which breaks
 // sampling.
+// ABSL_CORDZ_BUILD_SAMPLER must be defined for every translation unit, e.g. by
+// mobile builds used for production memory profiling.
 #if defined(ABSL_HAVE_THREAD_LOCAL) && !defined(_MSC_VER)  && \
     !defined(ABSL_BUILD_DLL) && !defined(ABSL_CONSUME_DLL) && \
-    !defined(__ANDROID__) && !defined(__APPLE__)
+    ((!defined(__ANDROID__) && !defined(__APPLE__)) ||    \
+     defined(ABSL_CORDZ_BUILD_SAMPLER))
 #define ABSL_INTERNAL_CORDZ_ENABLED 1
 #endif
 
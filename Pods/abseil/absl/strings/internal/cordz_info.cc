@@ -14,6 +14,10 @@
 
 #include "absl/strings/internal/cordz_info.h"
 
+#include <algorithm>
+#include <map>
+#include <vector>
+
 #include "absl/base/config.h"
 #include "absl/base/internal/spinlock.h"
 #include "absl/container/inlined_vector.h"
@@ -440,6 +444,52 @@ CordzStatistics CordzInfo::GetCordzStatistics() const {
   return stats;
 }
 
+std::vector<CordzCallSiteStatistics> AggregateCordzStatisticsByCallSite() {
+  std::vector<CordzCallSiteStatistics> result;
+  std::map<std::vector<void*>, size_t> index_by_stack;
+  CordzSnapshot snapshot;
+  for (const CordzInfo* info = CordzInfo::Head(snapshot); info != nullptr;
+       info = info->Next(snapshot)) {
+    absl::Span<void* const> stack = info->GetStack();
+    std::vector<void*> key(stack.begin(), stack.end());
+    auto inserted = index_by_stack.emplace(std::move(key), result.size());
+    if (inserted.second) {
+      result.emplace_back();
+      result.back().stack = inserted.first->first;
+    }
+    CordzCallSiteStatistics& site = result[inserted.first->second];
+
+    const CordzStatistics stats = info->GetCordzStatistics();
+    site.method = stats.method;
+    ++site.cords;
+    site.size += stats.size;
+    site.estimated_memory_usage += stats.estimated_memory_usage;
+    site.estimated_fair_share_memory_usage +=
+        stats.estimated_fair_share_memory_usage;
+    site.node_count += stats.node_count;
+    CordzStatistics::NodeCounts& counts = site.node_counts;
+    counts.flat += stats.node_counts.flat;
+    counts.flat_64 += stats.node_counts.flat_64;
+    counts.flat_128 += stats.node_counts.flat_128;
+    counts.flat_256 += stats.node_counts.flat_256;
+    counts.flat_512 += stats.node_counts.flat_512;
+    counts.flat_1k += stats.node_counts.flat_1k;
+    counts.external += stats.node_counts.external;
+    counts.substring += stats.node_counts.substring;
+    counts.concat += stats.node_counts.concat;
+    counts.ring += stats.node_counts.ring;
+    counts.btree += stats.node_counts.btree;
+  }
+
+  std::sort(result.begin(), result.end(),
+            [](const CordzCallSiteStatistics& a,
+               const CordzCallSiteStatistics& b) {
+              return a.estimated_fair_share_memory_usage >
+                     b.estimated_fair_share_memory_usage;
+            });
+  return result;
+}
+
 }  // namespace cord_internal
 ABSL_NAMESPACE_END
 }  // namespace absl
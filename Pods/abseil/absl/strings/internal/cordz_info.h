@@ -18,6 +18,7 @@
 #include <atomic>
 #include <cstdint>
 #include <functional>
+#include <vector>
 
 #include "absl/base/config.h"
 #include "absl/base/internal/raw_logging.h"
@@ -291,6 +292,26 @@ inline CordRep* CordzInfo::RefCordRep() const ABSL_LOCKS_EXCLUDED(mutex_) {
   return rep_ ? CordRep::Ref(rep_) : nullptr;
 }
 
+// The statistics of the live sampled cords that were sampled at one stack,
+// summed, for attributing cord memory and fragmentation to call sites.
+struct CordzCallSiteStatistics {
+  // The stack the cords were sampled at, innermost frame first.
+  std::vector<void*> stack;
+  // The cord method that sampled them.
+  CordzUpdateTracker::MethodIdentifier method =
+      CordzUpdateTracker::MethodIdentifier::kUnknown;
+  size_t cords = 0;
+  int64_t size = 0;
+  int64_t estimated_memory_usage = 0;
+  int64_t estimated_fair_share_memory_usage = 0;
+  int64_t node_count = 0;
+  CordzStatistics::NodeCounts node_counts;
+};
+
+// Returns the statistics of all live sampled cords aggregated by the stack they
+// were sampled at, the largest fair share of memory first.
+std::vector<CordzCallSiteStatistics> AggregateCordzStatisticsByCallSite();
+
 }  // namespace cord_internal
 ABSL_NAMESPACE_END
 }  // namespace absl
@@ -15,10 +15,13 @@
 #include "absl/strings/internal/str_format/bind.h"
 
 #include <cerrno>
+#include <cstring>
 #include <limits>
 #include <sstream>
 #include <string>
 
+#include "absl/strings/numbers.h"
+
 namespace absl {
 ABSL_NAMESPACE_BEGIN
 namespace str_format_internal {
@@ -214,6 +217,109 @@ std::string& AppendPack(std::string* out, const UntypedFormatSpecImpl format,
   return *out;
 }
 
+bool FastFormatArg::Supports(char conv) const {
+  switch (kind_) {
+    case kSigned:
+    case kUnsigned:
+      return conv == 'd' || conv == 'i' || conv == 'u' || conv == 'x' ||
+             conv == 'X';
+    case kString:
+      return conv == 's';
+    case kNone:
+      break;
+  }
+  return false;
+}
+
+void FastFormatArg::AppendTo(char conv, std::string* out) const {
+  if (kind_ == kString) {
+    out->append(str_.data(), str_.size());
+    return;
+  }
+
+  char buf[numbers_internal::kFastToBufferSize];
+  char* end;
+  if (conv == 'x' || conv == 'X') {
+    const char* digits =
+        conv == 'x' ? "0123456789abcdef" : "0123456789ABCDEF";
+    end = buf + sizeof(buf);
+    char* p = end;
+    uint64_t v = bits_;
+    do {
+      *--p = digits[v & 0xf];
+      v >>= 4;
+    } while (v != 0);
+    out->append(p, end - p);
+    return;
+  }
+  if (kind_ == kSigned && conv != 'u') {
+    end = numbers_internal::FastIntToBuffer(value_, buf);
+  } else {
+    end = numbers_internal::FastIntToBuffer(bits_, buf);
+  }
+  out->append(buf, end - buf);
+}
+
+namespace {
+
+// Skips the length modifiers, which the conversions ignore, of the conversion
+// starting at str[i], and returns the index of its conversion character.
+size_t SkipLengthModifiers(string_view str, size_t i) {
+  while (i < str.size() && str[i] != '\0' &&
+         std::strchr("hljztLq", str[i]) != nullptr) {
+    ++i;
+  }
+  return i;
+}
+
+}  // namespace
+
+bool FastFormatPack(std::string* out, const UntypedFormatSpecImpl format,
+                    absl::Span<const FastFormatArg> args) {
+  if (format.has_parsed_conversion()) return false;
+  const string_view str = format.str();
+
+  // Check that every conversion takes the fast path, and bound the size.
+  size_t size = 0;
+  size_t next_arg = 0;
+  for (size_t i = 0; i < str.size(); ++i) {
+    if (str[i] != '%') {
+      ++size;
+      continue;
+    }
+    i = SkipLengthModifiers(str, i + 1);
+    if (i == str.size()) return false;
+    if (str[i] == '%') {
+      ++size;
+      continue;
+    }
+    if (next_arg == args.size() || !args[next_arg].Supports(str[i])) {
+      return false;
+    }
+    size += args[next_arg++].MaxSize();
+  }
+  if (next_arg != args.size()) return false;
+
+  out->reserve(out->size() + size);
+  next_arg = 0;
+  size_t start = 0;
+  while (true) {
+    size_t percent = str.find('%', start);
+    if (percent == string_view::npos) {
+      out->append(str.data() + start, str.size() - start);
+      return true;
+    }
+    out->append(str.data() + start, percent - start);
+    size_t i = SkipLengthModifiers(str, percent + 1);
+    if (str[i] == '%') {
+      out->push_back('%');
+    } else {
+      args[next_arg++].AppendTo(str[i], out);
+    }
+    start = i + 1;
+  }
+}
+
 std::string FormatPack(const UntypedFormatSpecImpl format,
                        absl::Span<const FormatArgImpl> args) {
   std::string out;
@@ -16,9 +16,11 @@
 #define ABSL_STRINGS_INTERNAL_STR_FORMAT_BIND_H_
 
 #include <array>
+#include <cstdint>
 #include <cstdio>
 #include <sstream>
 #include <string>
+#include <type_traits>
 
 #include "absl/base/port.h"
 #include "absl/strings/internal/str_format/arg.h"
@@ -187,6 +189,73 @@ bool FormatUntyped(FormatRawSinkImpl raw_sink,
 std::string& AppendPack(std::string* out, UntypedFormatSpecImpl format,
                         absl::Span<const FormatArgImpl> args);
 
+// The fast path of StrFormat() and StrAppendFormat(), for the commonest
+// formats: those whose conversions are all plain %d, %i, %u, %x, %X or %s (no
+// flags, width, precision or positional argument) of integers and strings.
+// Their arguments are captured as FastFormatArg instead of FormatArgImpl, and
+// converted directly rather than through the type-erased dispatcher.
+template <typename T>
+struct IsFastFormatInt
+    : std::integral_constant<
+          bool, std::is_integral<T>::value && !std::is_same<T, bool>::value &&
+                    !std::is_same<T, char>::value &&
+                    !std::is_same<T, signed char>::value &&
+                    !std::is_same<T, unsigned char>::value &&
+                    !std::is_same<T, wchar_t>::value &&
+                    !std::is_same<T, char16_t>::value &&
+                    !std::is_same<T, char32_t>::value> {};
+
+template <typename T>
+struct IsFastFormatArg
+    : std::integral_constant<
+          bool, IsFastFormatInt<T>::value ||
+                    std::is_same<T, std::string>::value ||
+                    std::is_same<T, string_view>::value ||
+                    std::is_same<typename std::decay<T>::type, char*>::value ||
+                    std::is_same<typename std::decay<T>::type,
+                                 const char*>::value> {};
+
+template <typename... Args>
+struct AllFastFormatArgs : absl::conjunction<IsFastFormatArg<Args>...> {};
+
+class FastFormatArg {
+ public:
+  template <typename T, typename std::enable_if<IsFastFormatInt<T>::value,
+                                                int>::type = 0>
+  explicit FastFormatArg(T v)
+      : kind_(std::is_signed<T>::value ? kSigned : kUnsigned),
+        value_(static_cast<int64_t>(v)),
+        bits_(static_cast<typename std::make_unsigned<T>::type>(v)) {}
+  explicit FastFormatArg(string_view s) : kind_(kString), str_(s) {}
+  explicit FastFormatArg(const std::string& s) : kind_(kString), str_(s) {}
+  // A null pointer is left to the general path.
+  explicit FastFormatArg(const char* s)
+      : kind_(s == nullptr ? kNone : kString), str_(s == nullptr ? "" : s) {}
+  // Only constructed when AllFastFormatArgs doesn't hold, and then not used.
+  template <typename T,
+            typename std::enable_if<!IsFastFormatArg<T>::value, int>::type = 0>
+  explicit FastFormatArg(const T&) : kind_(kNone) {}
+
+  // Whether conv converts this argument, and an upper bound on the size.
+  bool Supports(char conv) const;
+  size_t MaxSize() const { return kind_ == kString ? str_.size() : 20; }
+
+  void AppendTo(char conv, std::string* out) const;
+
+ private:
+  enum Kind : uint8_t { kNone, kSigned, kUnsigned, kString };
+
+  Kind kind_;
+  int64_t value_ = 0;
+  uint64_t bits_ = 0;
+  string_view str_;
+};
+
+// Appends the result of the fast path to out, and returns true, if format and
+// args are eligible; otherwise leaves out untouched and returns false.
+bool FastFormatPack(std::string* out, UntypedFormatSpecImpl format,
+                    absl::Span<const FastFormatArg> args);
+
 std::string FormatPack(const UntypedFormatSpecImpl format,
                        absl::Span<const FormatArgImpl> args);
 
@@ -31,6 +31,7 @@
 #include <utility>
 
 #include "absl/base/attributes.h"
+#include "absl/base/internal/endian.h"
 #include "absl/base/internal/raw_logging.h"
 #include "absl/numeric/bits.h"
 #include "absl/strings/ascii.h"
@@ -913,6 +914,31 @@ const IntType LookupTables<IntType>::kVminOverBase[] =
 
 #undef X_OVER_BASE_INITIALIZER
 
+// Decimal digits are parsed 8 at a time where possible, as a SWAR word.
+constexpr int kSwarDigits = 8;
+constexpr uint32_t kSwarScale = 100000000;  // 10^kSwarDigits
+
+// Returns whether the 8 bytes at p are all decimal digits, and if so stores
+// their value in *value.
+inline bool ParseEightDigits(const char* p, uint32_t* value) {
+  uint64_t chunk = absl::little_endian::Load64(p);
+  // A byte is a digit iff its high nibble is 3, and stays 3 when adding 6.
+  if ((((chunk & 0xF0F0F0F0F0F0F0F0) |
+        (((chunk + 0x0606060606060606) & 0xF0F0F0F0F0F0F0F0) >> 4)) !=
+       0x3333333333333333)) {
+    return false;
+  }
+  chunk -= 0x3030303030303030;
+  // Combine adjacent digits into 2-digit, then 4-digit, then 8-digit values.
+  chunk = (chunk * 10) + (chunk >> 8);
+  chunk = (((chunk & 0x000000FF000000FF) * (100 + (uint64_t{1000000} << 32))) +
+           (((chunk >> 16) & 0x000000FF000000FF) *
+            (1 + (uint64_t{10000} << 32)))) >>
+          32;
+  *value = static_cast<uint32_t>(chunk);
+  return true;
+}
+
 template <typename IntType>
 inline bool safe_parse_positive_int(absl::string_view text, int base,
                                     IntType* value_p) {
@@ -926,6 +952,17 @@ inline bool safe_parse_positive_int(absl::string_view text, int base,
          std::numeric_limits<IntType>::max() / base == vmax_over_base);
   const char* start = text.data();
   const char* end = start + text.size();
+  if (base == 10) {
+    // Chunks that would overflow are left to the loop below, which saturates.
+    uint32_t chunk;
+    while (end - start >= kSwarDigits && ParseEightDigits(start, &chunk) &&
+           value <= (vmax - static_cast<IntType>(chunk)) /
+                        static_cast<IntType>(kSwarScale)) {
+      value = value * static_cast<IntType>(kSwarScale) +
+              static_cast<IntType>(chunk);
+      start += kSwarDigits;
+    }
+  }
   // loop over digits
   for (; start < end; ++start) {
     unsigned char c = static_cast<unsigned char>(start[0]);
@@ -969,6 +1006,17 @@ inline bool safe_parse_negative_int(absl::string_view text, int base,
   }
   const char* start = text.data();
   const char* end = start + text.size();
+  if (base == 10) {
+    // Division truncates towards zero, so this bound is rounded up as needed.
+    uint32_t chunk;
+    while (end - start >= kSwarDigits && ParseEightDigits(start, &chunk) &&
+           value >= (vmin + static_cast<IntType>(chunk)) /
+                        static_cast<IntType>(kSwarScale)) {
+      value = value * static_cast<IntType>(kSwarScale) -
+              static_cast<IntType>(chunk);
+      start += kSwarDigits;
+    }
+  }
   // loop over digits
   for (; start < end; ++start) {
     unsigned char c = static_cast<unsigned char>(start[0]);
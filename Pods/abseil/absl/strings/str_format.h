@@ -337,6 +337,13 @@ using ParsedFormat = str_format_internal::ExtendedParsedFormat<
 template <typename... Args>
 ABSL_MUST_USE_RESULT std::string StrFormat(const FormatSpec<Args...>& format,
                                            const Args&... args) {
+  std::string out;
+  if (str_format_internal::AllFastFormatArgs<Args...>::value &&
+      str_format_internal::FastFormatPack(
+          &out, str_format_internal::UntypedFormatSpecImpl::Extract(format),
+          {str_format_internal::FastFormatArg(args)...})) {
+    return out;
+  }
   return str_format_internal::FormatPack(
       str_format_internal::UntypedFormatSpecImpl::Extract(format),
       {str_format_internal::FormatArgImpl(args)...});
@@ -356,6 +363,12 @@ template <typename... Args>
 std::string& StrAppendFormat(std::string* dst,
                              const FormatSpec<Args...>& format,
                              const Args&... args) {
+  if (str_format_internal::AllFastFormatArgs<Args...>::value &&
+      str_format_internal::FastFormatPack(
+          dst, str_format_internal::UntypedFormatSpecImpl::Extract(format),
+          {str_format_internal::FastFormatArg(args)...})) {
+    return *dst;
+  }
   return str_format_internal::AppendPack(
       dst, str_format_internal::UntypedFormatSpecImpl::Extract(format),
       {str_format_internal::FormatArgImpl(args)...});
@@ -24,13 +24,85 @@
 #include <memory>
 
 #include "absl/base/internal/raw_logging.h"
+#include "absl/numeric/bits.h"
 #include "absl/strings/ascii.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define ABSL_INTERNAL_STR_SPLIT_SSE2 1
+#elif defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define ABSL_INTERNAL_STR_SPLIT_NEON 1
+#endif
+
 namespace absl {
 ABSL_NAMESPACE_BEGIN
 
 namespace {
 
+// The most delimiters that FindFirstOfFew() compares 16 bytes of text against
+// at once.
+constexpr size_t kMaxFewDelimiters = 4;
+
+// Returns the position of the first character of text at or after pos that is
+// one of delimiters, or npos. There must be between 1 and kMaxFewDelimiters
+// delimiters.
+size_t FindFirstOfFew(absl::string_view text, absl::string_view delimiters,
+                      size_t pos) {
+  assert(!delimiters.empty() && delimiters.size() <= kMaxFewDelimiters);
+  if (delimiters.size() == 1) return text.find(delimiters[0], pos);
+  if (pos >= text.size()) return absl::string_view::npos;
+  const char* p = text.data() + pos;
+  const char* const end = text.data() + text.size();
+  // Missing delimiters repeat the last one, which doesn't change the matches.
+  auto delimiter = [&delimiters](size_t i) {
+    return delimiters[std::min(i, delimiters.size() - 1)];
+  };
+#if defined(ABSL_INTERNAL_STR_SPLIT_SSE2)
+  const __m128i d0 = _mm_set1_epi8(delimiter(0));
+  const __m128i d1 = _mm_set1_epi8(delimiter(1));
+  const __m128i d2 = _mm_set1_epi8(delimiter(2));
+  const __m128i d3 = _mm_set1_epi8(delimiter(3));
+  for (; end - p >= 16; p += 16) {
+    const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    const __m128i match =
+        _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, d0),
+                                  _mm_cmpeq_epi8(chunk, d1)),
+                     _mm_or_si128(_mm_cmpeq_epi8(chunk, d2),
+                                  _mm_cmpeq_epi8(chunk, d3)));
+    const uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(match));
+    if (mask != 0) {
+      return static_cast<size_t>(p - text.data()) + absl::countr_zero(mask);
+    }
+  }
+#elif defined(ABSL_INTERNAL_STR_SPLIT_NEON)
+  const uint8x16_t d0 = vdupq_n_u8(static_cast<uint8_t>(delimiter(0)));
+  const uint8x16_t d1 = vdupq_n_u8(static_cast<uint8_t>(delimiter(1)));
+  const uint8x16_t d2 = vdupq_n_u8(static_cast<uint8_t>(delimiter(2)));
+  const uint8x16_t d3 = vdupq_n_u8(static_cast<uint8_t>(delimiter(3)));
+  for (; end - p >= 16; p += 16) {
+    const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(p));
+    const uint8x16_t match =
+        vorrq_u8(vorrq_u8(vceqq_u8(chunk, d0), vceqq_u8(chunk, d1)),
+                 vorrq_u8(vceqq_u8(chunk, d2), vceqq_u8(chunk, d3)));
+    // Narrow each byte of the match to a nibble, giving a 64-bit mask.
+    const uint64_t mask = vget_lane_u64(
+        vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+    if (mask != 0) {
+      return static_cast<size_t>(p - text.data()) +
+             absl::countr_zero(mask) / 4;
+    }
+  }
+#endif
+  for (; p != end; ++p) {
+    for (char c : delimiters) {
+      if (*p == c) return static_cast<size_t>(p - text.data());
+    }
+  }
+  return absl::string_view::npos;
+}
+
 // This GenericFind() template function encapsulates the finding algorithm
 // shared between the ByString and ByAnyChar delimiters. The FindPolicy
 // template parameter allows each delimiter to customize the actual find
@@ -113,6 +185,12 @@ absl::string_view ByChar::Find(absl::string_view text, size_t pos) const {
 ByAnyChar::ByAnyChar(absl::string_view sp) : delimiters_(sp) {}
 
 absl::string_view ByAnyChar::Find(absl::string_view text, size_t pos) const {
+  if (!delimiters_.empty() && delimiters_.size() <= kMaxFewDelimiters) {
+    size_t found_pos = FindFirstOfFew(text, delimiters_, pos);
+    if (found_pos == absl::string_view::npos)
+      return absl::string_view(text.data() + text.size(), 0);
+    return text.substr(found_pos, 1);
+  }
   return GenericFind(text, delimiters_, pos, AnyOfPolicy());
 }
 
@@ -33,13 +33,24 @@
 #include <semaphore.h>
 #endif
 
+#if ABSL_WAITER_MODE == ABSL_WAITER_MODE_ULOCK
+// These aren't declared by the SDK headers; see <sys/ulock.h> in xnu.
+extern "C" {
+int __ulock_wait(uint32_t operation, void *addr, uint64_t value,
+                 uint32_t timeout_us);
+int __ulock_wake(uint32_t operation, void *addr, uint64_t wake_value);
+}
+#endif
+
 #include <errno.h>
 #include <stdio.h>
 #include <time.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cassert>
 #include <cstdint>
+#include <limits>
 #include <new>
 #include <type_traits>
 
@@ -121,6 +132,85 @@ void Waiter::Poke() {
   }
 }
 
+#elif ABSL_WAITER_MODE == ABSL_WAITER_MODE_ULOCK
+
+namespace {
+constexpr uint32_t kUlCompareAndWait = 1;
+constexpr uint32_t kUlfNoErrno = 0x01000000;
+
+// Microseconds from now until abs_timeout, rounded up so that a wait doesn't
+// time out early; zero if abs_timeout has passed.
+int64_t MicrosUntil(const struct timespec &abs_timeout) {
+  struct timeval now;
+  gettimeofday(&now, nullptr);
+  int64_t ns = (abs_timeout.tv_sec - now.tv_sec) * int64_t{1000000000} +
+               abs_timeout.tv_nsec - now.tv_usec * int64_t{1000};
+  return ns > 0 ? (ns + 999) / 1000 : 0;
+}
+}  // namespace
+
+Waiter::Waiter() {
+  ulock_.store(0, std::memory_order_relaxed);
+}
+
+Waiter::~Waiter() = default;
+
+bool Waiter::Wait(KernelTimeout t) {
+  // Same protocol as the futex waiter: consume a wakeup if there is one,
+  // otherwise sleep while the count is still zero.
+  bool first_pass = true;
+  struct timespec abs_timeout;
+  if (t.has_timeout()) abs_timeout = t.MakeAbsTimespec();
+
+  while (true) {
+    uint32_t x = ulock_.load(std::memory_order_relaxed);
+    while (x != 0) {
+      if (!ulock_.compare_exchange_weak(x, x - 1,
+                                        std::memory_order_acquire,
+                                        std::memory_order_relaxed)) {
+        continue;  // Raced with someone, retry.
+      }
+      return true;  // Consumed a wakeup, we are done.
+    }
+
+    if (!first_pass) MaybeBecomeIdle();
+    // A timeout of zero waits forever, so longer timeouts than fit are cut
+    // short, and the loop goes back to sleep for the rest.
+    uint32_t timeout_us = 0;
+    if (t.has_timeout()) {
+      int64_t us = MicrosUntil(abs_timeout);
+      if (us == 0) return false;
+      timeout_us = static_cast<uint32_t>(
+          std::min<int64_t>(us, std::numeric_limits<uint32_t>::max()));
+    }
+    const int err = __ulock_wait(kUlCompareAndWait | kUlfNoErrno, &ulock_, 0,
+                                 timeout_us);
+    if (err < 0) {
+      if (err == -EINTR || err == -EFAULT || err == -ETIMEDOUT) {
+        // Do nothing, the loop will retry or find the deadline passed.
+      } else {
+        ABSL_RAW_LOG(FATAL, "__ulock_wait failed with error %d\n", err);
+      }
+    }
+    first_pass = false;
+  }
+}
+
+void Waiter::Post() {
+  if (ulock_.fetch_add(1, std::memory_order_release) == 0) {
+    // We incremented from 0, need to wake a potential waiter.
+    Poke();
+  }
+}
+
+void Waiter::Poke() {
+  // Wake one thread waiting on the ulock; -ENOENT means there was none.
+  const int err = __ulock_wake(kUlCompareAndWait | kUlfNoErrno, &ulock_, 0);
+  if (ABSL_PREDICT_FALSE(err < 0 && err != -ENOENT && err != -EINTR)) {
+    ABSL_RAW_LOG(FATAL, "__ulock_wake failed with error %d\n", err);
+  }
+}
+
 #elif ABSL_WAITER_MODE == ABSL_WAITER_MODE_CONDVAR
 
 class PthreadMutexHolder {
@@ -44,6 +44,7 @@
 #define ABSL_WAITER_MODE_SEM 1
 #define ABSL_WAITER_MODE_CONDVAR 2
 #define ABSL_WAITER_MODE_WIN32 3
+#define ABSL_WAITER_MODE_ULOCK 4
 
 #if defined(ABSL_FORCE_WAITER_MODE)
 #define ABSL_WAITER_MODE ABSL_FORCE_WAITER_MODE
@@ -51,6 +52,10 @@
 #define ABSL_WAITER_MODE ABSL_WAITER_MODE_WIN32
 #elif defined(ABSL_INTERNAL_HAVE_FUTEX)
 #define ABSL_WAITER_MODE ABSL_WAITER_MODE_FUTEX
+#elif defined(__APPLE__)
+// Darwin's futex equivalent, __ulock_wait() and __ulock_wake(), which libc++
+// and the Swift runtime also build on.
+#define ABSL_WAITER_MODE ABSL_WAITER_MODE_ULOCK
 #elif defined(ABSL_HAVE_SEMAPHORE_H)
 #define ABSL_WAITER_MODE ABSL_WAITER_MODE_SEM
 #else
@@ -112,6 +117,11 @@ class Waiter {
   std::atomic<int32_t> futex_;
   static_assert(sizeof(int32_t) == sizeof(futex_), "Wrong size for futex");
 
+#elif ABSL_WAITER_MODE == ABSL_WAITER_MODE_ULOCK
+  // As for the futex, but __ulock_wait() compares 32 bits too.
+  std::atomic<uint32_t> ulock_;
+  static_assert(sizeof(uint32_t) == sizeof(ulock_), "Wrong size for ulock");
+
 #elif ABSL_WAITER_MODE == ABSL_WAITER_MODE_CONDVAR
   // REQUIRES: mu_ must be held.
   void InternalCondVarPoke();
@@ -26,6 +26,10 @@
 #include <sys/time.h>
 #endif
 
+#ifdef __APPLE__
+#include <pthread/qos.h>
+#endif
+
 #include <assert.h>
 #include <errno.h>
 #include <stdio.h>
@@ -1449,10 +1453,50 @@ void Mutex::AssertNotHeld() const {
   }
 }
 
+namespace {
+// Spinning pays off only if the holder releases the lock before the spin
+// budget runs out, so each mutex's budget tracks how many iterations it took
+// to acquire it recently: twice that, plus a few, bounded by the global limit.
+// Mutex has no room for the estimate, so estimates live in a small table
+// indexed by the mutex's address; mutexes that share a slot share one.
+constexpr int kMinSpinIterations = 16;
+constexpr int kSpinEstimates = 64;
+
+struct ABSL_CACHELINE_ALIGNED SpinEstimate {
+  std::atomic<int> iterations;
+};
+
+ABSL_CONST_INIT SpinEstimate spin_estimates[kSpinEstimates] = {};
+
+std::atomic<int> &GetSpinEstimate(const std::atomic<intptr_t> *mu) {
+  uintptr_t p = reinterpret_cast<uintptr_t>(mu);
+  return spin_estimates[((p >> 3) ^ (p >> 9)) % kSpinEstimates].iterations;
+}
+
+// The most iterations the calling thread may spin for.
+int SpinLimit() {
+  int limit = GetMutexGlobals().spinloop_iterations;
+#ifdef __APPLE__
+  // Threads of low QoS run on the efficiency cores, where each iteration takes
+  // longer and burns power the holder's core could have used.
+  qos_class_t qos = qos_class_self();
+  if (qos == QOS_CLASS_UTILITY || qos == QOS_CLASS_BACKGROUND) {
+    limit /= 4;
+  }
+#endif
+  return limit;
+}
+}  // namespace
+
 // Attempt to acquire *mu, and return whether successful.  The implementation
 // may spin for a short while if the lock cannot be acquired immediately.
 static bool TryAcquireWithSpinning(std::atomic<intptr_t>* mu) {
-  int c = GetMutexGlobals().spinloop_iterations;
+  std::atomic<int> &estimate = GetSpinEstimate(mu);
+  const int estimated = estimate.load(std::memory_order_relaxed);
+  const int limit =
+      std::min(SpinLimit(), 2 * estimated + kMinSpinIterations);
+  int c = 0;
+  bool acquired = false;
   do {  // do/while somewhat faster on AMD
     intptr_t v = mu->load(std::memory_order_relaxed);
     if ((v & (kMuReader|kMuEvent)) != 0) {
@@ -1461,10 +1505,16 @@ static bool TryAcquireWithSpinning(std::atomic<intptr_t>* mu) {
                mu->compare_exchange_strong(v, kMuWriter | v,
                                            std::memory_order_acquire,
                                            std::memory_order_relaxed)) {
-      return true;
+      acquired = true;
+      break;
     }
-  } while (--c > 0);
-  return false;
+  } while (++c < limit);
+  // A failed spin counts as the whole budget, so the estimate can grow back
+  // once the mutex is held for longer.
+  if (limit > 0) {
+    estimate.store(estimated + (c - estimated) / 8, std::memory_order_relaxed);
+  }
+  return acquired;
 }
 
 ABSL_XRAY_LOG_ARGS(1) void Mutex::Lock() {
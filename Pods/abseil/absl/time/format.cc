@@ -69,6 +69,83 @@ absl::Time Join(const cctz_parts& parts) {
   return time_internal::FromUnixDuration(d);
 }
 
+// Parses n digits at *p, advancing it, or returns -1 if they aren't digits.
+int ParseFixedDigits(const char** p, const char* end, int n) {
+  if (end - *p < n) return -1;
+  int value = 0;
+  for (int i = 0; i < n; ++i) {
+    const unsigned digit = static_cast<unsigned>((*p)[i] - '0');
+    if (digit > 9) return -1;
+    value = value * 10 + static_cast<int>(digit);
+  }
+  *p += n;
+  return value;
+}
+
+bool Expect(const char** p, const char* end, char c) {
+  if (*p == end || **p != c) return false;
+  ++*p;
+  return true;
+}
+
+// The fast path of ParseTime(RFC3339_full, ...), for the fixed-width form of
+// RFC 3339 that machines write: "YYYY-MM-DDTHH:MM:SS[.fraction](Z|+hh:mm)".
+// Returns false for anything else, including invalid fields and leap
+// seconds, which the general parser then accepts or reports.
+bool ParseRFC3339Fixed(absl::string_view input, cctz_parts* parts) {
+  const char* p = input.data();
+  const char* const end = p + input.size();
+  const int year = ParseFixedDigits(&p, end, 4);
+  if (year < 0 || !Expect(&p, end, '-')) return false;
+  const int month = ParseFixedDigits(&p, end, 2);
+  if (month < 0 || !Expect(&p, end, '-')) return false;
+  const int day = ParseFixedDigits(&p, end, 2);
+  if (day < 0 || !(Expect(&p, end, 'T') || Expect(&p, end, 't'))) {
+    return false;
+  }
+  const int hour = ParseFixedDigits(&p, end, 2);
+  if (hour < 0 || !Expect(&p, end, ':')) return false;
+  const int minute = ParseFixedDigits(&p, end, 2);
+  if (minute < 0 || !Expect(&p, end, ':')) return false;
+  const int second = ParseFixedDigits(&p, end, 2);
+  if (second < 0 || second > 59) return false;
+
+  // Femtoseconds keep the first 15 digits of the fraction.
+  int64_t fem = 0;
+  if (Expect(&p, end, '.')) {
+    int digits = 0;
+    for (; p != end && static_cast<unsigned>(*p - '0') <= 9; ++p, ++digits) {
+      if (digits < 15) fem = fem * 10 + (*p - '0');
+    }
+    if (digits == 0) return false;
+    for (; digits < 15; ++digits) fem *= 10;
+  }
+
+  int offset = 0;
+  if (!(Expect(&p, end, 'Z') || Expect(&p, end, 'z'))) {
+    if (p == end || (*p != '+' && *p != '-')) return false;
+    const int sign = *p++ == '-' ? -1 : 1;
+    const int offset_hours = ParseFixedDigits(&p, end, 2);
+    if (offset_hours < 0 || offset_hours > 23 || !Expect(&p, end, ':')) {
+      return false;
+    }
+    const int offset_minutes = ParseFixedDigits(&p, end, 2);
+    if (offset_minutes < 0 || offset_minutes > 59) return false;
+    offset = sign * (offset_hours * 60 + offset_minutes) * 60;
+  }
+  if (p != end) return false;
+
+  // Out-of-range fields would be normalized away, so the parse is invalid.
+  const cctz::civil_second cs(year, month, day, hour, minute, second);
+  if (cs.month() != month || cs.day() != day || cs.hour() != hour ||
+      cs.minute() != minute) {
+    return false;
+  }
+  parts->sec = cctz::convert(cs, cctz::utc_time_zone()) - cctz::seconds(offset);
+  parts->fem = cctz::detail::femtoseconds(fem);
+  return true;
+}
+
 }  // namespace
 
 std::string FormatTime(absl::string_view format, absl::Time t,
@@ -127,8 +204,13 @@ bool ParseTime(absl::string_view format, absl::string_view input,
     }
   }
 
-  std::string error;
   cctz_parts parts;
+  if (format == RFC3339_full && ParseRFC3339Fixed(input, &parts)) {
+    *time = Join(parts);
+    return true;
+  }
+
+  std::string error;
   const bool b =
       cctz::detail::parse(std::string(format), std::string(input),
                           cctz::time_zone(tz), &parts.sec, &parts.fem, &error);
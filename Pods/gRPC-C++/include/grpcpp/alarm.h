@@ -21,7 +21,9 @@
 #ifndef GRPCPP_ALARM_H
 #define GRPCPP_ALARM_H
 
+#include <chrono>
 #include <functional>
+#include <vector>
 
 #include <grpc/grpc.h>
 #include <grpcpp/impl/codegen/completion_queue.h>
@@ -32,6 +34,10 @@
 
 namespace grpc {
 
+namespace experimental {
+class AlarmBatch;
+}
+
 class Alarm : private ::grpc::GrpcLibraryCodegen {
  public:
   /// Create an unset completion queue alarm
@@ -89,14 +95,79 @@ class Alarm : private ::grpc::GrpcLibraryCodegen {
     SetInternal(::grpc::TimePoint<T>(deadline).raw_time(), std::move(f));
   }
 
+  /// Trigger an alarm instance on completion queue \a cq every \a period,
+  /// starting one period from now. Each expiry adds an event with tag \a tag
+  /// and success bit true to \a cq; the alarm is armed for the next period
+  /// once that event has been returned by the completion queue, so at most
+  /// one event is outstanding. Periods are counted from the previous
+  /// deadline, not from the delivery of the event. After \a Cancel, one
+  /// last event with success bit false is added. Rearming does not allocate.
+  void SetRecurring(::grpc::CompletionQueue* cq,
+                    std::chrono::milliseconds period, void* tag) {
+    SetRecurringInternal(cq, period.count(), tag);
+  }
+
+  /// Set an alarm to invoke callback \a f with true every \a period, starting
+  /// one period from now, and once with false after it is cancelled. The
+  /// next period is armed after \a f returns.
+  void SetRecurring(std::chrono::milliseconds period,
+                    std::function<void(bool)> f) {
+    SetRecurringInternal(period.count(), std::move(f));
+  }
+
  private:
+  friend class ::grpc::experimental::AlarmBatch;
+
   void SetInternal(::grpc::CompletionQueue* cq, gpr_timespec deadline,
                    void* tag);
   void SetInternal(gpr_timespec deadline, std::function<void(bool)> f);
+  void SetRecurringInternal(::grpc::CompletionQueue* cq, int64_t period_ms,
+                            void* tag);
+  void SetRecurringInternal(int64_t period_ms, std::function<void(bool)> f);
 
   ::grpc::internal::CompletionQueueTag* alarm_;
 };
 
+namespace experimental {
+
+/// Sets many completion queue alarms at once. Alarms added with \a Add are
+/// armed together by \a Commit, which enters the core once for the whole
+/// batch instead of once per alarm. Each alarm then behaves as if
+/// Alarm::Set had been called on it. A batch can be reused after \a Commit
+/// and keeps its capacity, so a steady stream of batches does not allocate.
+class AlarmBatch {
+ public:
+  explicit AlarmBatch(::grpc::CompletionQueue* cq) : cq_(cq) {}
+
+  AlarmBatch(const AlarmBatch&) = delete;
+  AlarmBatch& operator=(const AlarmBatch&) = delete;
+
+  /// Reserve room for \a n alarms.
+  void Reserve(size_t n) { entries_.reserve(n); }
+
+  /// Add \a alarm to the batch, to expire at \a deadline with tag \a tag.
+  /// \a alarm must stay alive until the batch is committed.
+  template <typename T>
+  void Add(Alarm* alarm, const T& deadline, void* tag) {
+    entries_.push_back({alarm, ::grpc::TimePoint<T>(deadline).raw_time(), tag});
+  }
+
+  /// Arm every alarm added since the last commit.
+  void Commit();
+
+ private:
+  struct Entry {
+    Alarm* alarm;
+    gpr_timespec deadline;
+    void* tag;
+  };
+
+  ::grpc::CompletionQueue* cq_;
+  std::vector<Entry> entries_;
+};
+
+}  // namespace experimental
+
 }  // namespace grpc
 
 #endif  // GRPCPP_ALARM_H
@@ -184,6 +184,7 @@ class ByteBuffer final {
   template <class R>
   friend class internal::DeserializeFuncType;
   friend class ProtoBufferReader;
+  friend class ByteBufferSliceReader;
   friend class ProtoBufferWriter;
   friend class internal::GrpcByteBufferPeer;
   friend class internal::ExternalConnectionAcceptorImpl;
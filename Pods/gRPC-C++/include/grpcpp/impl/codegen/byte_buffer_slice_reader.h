@@ -0,0 +1,149 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_IMPL_CODEGEN_BYTE_BUFFER_SLICE_READER_H
+#define GRPCPP_IMPL_CODEGEN_BYTE_BUFFER_SLICE_READER_H
+
+// IWYU pragma: private, include <grpcpp/support/byte_buffer_slice_reader.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <grpc/impl/codegen/byte_buffer_reader.h>
+#include <grpc/impl/codegen/slice.h>
+#include <grpcpp/impl/codegen/byte_buffer.h>
+#include <grpcpp/impl/codegen/config.h>
+#include <grpcpp/impl/codegen/core_codegen_interface.h>
+#include <grpcpp/impl/codegen/slice.h>
+#include <grpcpp/impl/codegen/status.h>
+
+namespace grpc {
+
+/// Reads a \a ByteBuffer one slice at a time without copying it, through
+/// the same Next()/BackUp()/Skip()/ByteCount() contract as protobuf's
+/// ZeroCopyInputStream, so that a parser (protobuf or otherwise) can be
+/// driven directly from the received slices. Unlike ProtoBufferReader, it
+/// also lets the parser keep parts of the payload without copying them:
+/// \a Alias returns a \a Slice that shares the memory of the chunk last
+/// returned by Next() and stays valid after the buffer and this reader are
+/// gone. Large bytes/string fields can thus be kept as slices while
+/// parsing.
+///
+/// Compressed buffers are decompressed by the reader, chunk by chunk.
+class ByteBufferSliceReader final {
+ public:
+  /// Constructs a reader over \a buffer, which must outlive it. If the
+  /// buffer cannot be read, status() is not OK and Next() returns false.
+  explicit ByteBufferSliceReader(ByteBuffer* buffer) {
+    if (!buffer->Valid() ||
+        !g_core_codegen_interface->grpc_byte_buffer_reader_init(
+            &reader_, buffer->c_buffer())) {
+      status_ = Status(StatusCode::INTERNAL,
+                       "Couldn't initialize byte buffer reader");
+    }
+  }
+
+  ~ByteBufferSliceReader() {
+    if (status_.ok()) {
+      g_core_codegen_interface->grpc_byte_buffer_reader_destroy(&reader_);
+    }
+  }
+
+  ByteBufferSliceReader(const ByteBufferSliceReader&) = delete;
+  ByteBufferSliceReader& operator=(const ByteBufferSliceReader&) = delete;
+
+  /// Points \a data and \a size at the next chunk. Returns false at the end
+  /// of the buffer or if it could not be read.
+  bool Next(const void** data, int* size) {
+    if (!status_.ok()) return false;
+    if (backup_count_ > 0) {
+      // Return the tail of the current chunk that was backed up over.
+      *data = GRPC_SLICE_START_PTR(*slice_) + GRPC_SLICE_LENGTH(*slice_) -
+              backup_count_;
+      *size = static_cast<int>(backup_count_);
+      backup_count_ = 0;
+      return true;
+    }
+    if (!g_core_codegen_interface->grpc_byte_buffer_reader_peek(&reader_,
+                                                                &slice_)) {
+      return false;
+    }
+    *data = GRPC_SLICE_START_PTR(*slice_);
+    *size = static_cast<int>(GRPC_SLICE_LENGTH(*slice_));
+    byte_count_ += *size;
+    return true;
+  }
+
+  /// Returns the last \a count bytes of the chunk last returned by Next()
+  /// to the stream; the next Next() returns them again.
+  void BackUp(int count) {
+    GPR_CODEGEN_ASSERT(slice_ != nullptr);
+    GPR_CODEGEN_ASSERT(count >= 0);
+    GPR_CODEGEN_ASSERT(static_cast<size_t>(count) <=
+                       GRPC_SLICE_LENGTH(*slice_));
+    backup_count_ = count;
+  }
+
+  /// Skips \a count bytes. Returns false if the buffer ends first.
+  bool Skip(int count) {
+    const void* data;
+    int size;
+    while (Next(&data, &size)) {
+      if (size >= count) {
+        BackUp(size - count);
+        return true;
+      }
+      count -= size;
+    }
+    return false;
+  }
+
+  /// The number of bytes read so far, not counting ones backed up over.
+  int64_t ByteCount() const { return byte_count_ - backup_count_; }
+
+  /// Returns a slice referencing \a length bytes at \a data, which must lie
+  /// within the chunk last returned by Next(). Takes a reference on the
+  /// underlying memory rather than copying it (except for small inlined
+  /// slices, which are copied).
+  Slice Alias(const void* data, size_t length) const {
+    GPR_CODEGEN_ASSERT(slice_ != nullptr);
+    const uint8_t* begin = GRPC_SLICE_START_PTR(*slice_);
+    const uint8_t* start = static_cast<const uint8_t*>(data);
+    GPR_CODEGEN_ASSERT(start >= begin);
+    const size_t offset = static_cast<size_t>(start - begin);
+    GPR_CODEGEN_ASSERT(offset + length <= GRPC_SLICE_LENGTH(*slice_));
+    return Slice(g_core_codegen_interface->grpc_slice_sub(*slice_, offset,
+                                                          offset + length),
+                 Slice::STEAL_REF);
+  }
+
+  /// Whether the buffer could be read.
+  Status status() const { return status_; }
+
+ private:
+  int64_t byte_count_ = 0;
+  int64_t backup_count_ = 0;
+  grpc_byte_buffer_reader reader_;
+  // The chunk last returned by Next(), owned by the buffer or reader_.
+  grpc_slice* slice_ = nullptr;
+  Status status_;
+};
+
+}  // namespace grpc
+
+#endif  // GRPCPP_IMPL_CODEGEN_BYTE_BUFFER_SLICE_READER_H
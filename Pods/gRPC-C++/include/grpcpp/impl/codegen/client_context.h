@@ -41,6 +41,7 @@
 #include <string>
 
 #include <grpc/impl/codegen/compression_types.h>
+#include <grpc/impl/codegen/grpc_types.h>
 #include <grpc/impl/codegen/propagation_bits.h>
 #include <grpcpp/impl/codegen/client_interceptor.h>
 #include <grpcpp/impl/codegen/config.h>
@@ -380,6 +381,14 @@ class ClientContext {
   /// \return The call's peer URI.
   std::string peer() const;
 
+  /// If the call was sampled for latency instrumentation (see
+  /// grpc_rpc_timeline_set_sampling_period()), fill \a timeline with the time
+  /// from the call's start to each event it has reached so far.
+  /// It is only valid to call this during the lifetime of the client call.
+  ///
+  /// \return Whether the call was sampled.
+  bool GetRpcTimeline(grpc_rpc_timeline* timeline) const;
+
   /// Sets the census context.
   /// It is only valid to call this before the client call is created. A common
   /// place of setting census context is from within the DefaultConstructor
@@ -204,6 +204,30 @@ class CompletionQueue : private ::grpc::GrpcLibraryCodegen {
     return AsyncNextInternal(tag, ok, deadline_tp.raw_time());
   }
 
+  /// EXPERIMENTAL
+  /// An event read by NextBatch: the \a tag and \a ok that Next would have
+  /// returned for it.
+  struct Event {
+    void* tag;
+    bool ok;
+  };
+
+  /// EXPERIMENTAL
+  /// Read up to \a max_events events from the queue. This blocks as Next does
+  /// until the first is available, and then takes any others already queued,
+  /// saving a trip through the queue (and its polling) for each of them.
+  ///
+  /// \param[out] events Upon success, filled with the events read.
+  /// \param[in] max_events The size of \a events; must be at least 1.
+  ///
+  /// \return The number of events read, or 0 if the queue is fully drained
+  ///         and shut down.
+  size_t NextBatch(Event* events, size_t max_events) {
+    return AsyncNextBatchInternal(
+        events, max_events,
+        ::grpc::g_core_codegen_interface->gpr_inf_future(GPR_CLOCK_REALTIME));
+  }
+
   /// EXPERIMENTAL
   /// First executes \a F, then reads from the queue, blocking up to
   /// \a deadline (or the queue's shutdown).
@@ -318,6 +342,8 @@ class CompletionQueue : private ::grpc::GrpcLibraryCodegen {
   };
 
   NextStatus AsyncNextInternal(void** tag, bool* ok, gpr_timespec deadline);
+  size_t AsyncNextBatchInternal(Event* events, size_t max_events,
+                                gpr_timespec deadline);
 
   /// Wraps \a grpc_completion_queue_pluck.
   /// \warning Must not be mixed with calls to \a Next.
@@ -21,6 +21,12 @@
 
 // IWYU pragma: private, include <grpcpp/support/message_allocator.h>
 
+#include <stddef.h>
+
+#include <vector>
+
+#include <grpcpp/impl/codegen/sync.h>
+
 namespace grpc {
 
 // NOTE: This is an API for advanced users who need custom allocators.
@@ -68,6 +74,73 @@ class MessageAllocator {
   virtual MessageHolder<RequestT, ResponseT>* AllocateMessages() = 0;
 };
 
+// EXPERIMENTAL API. A MessageAllocator that reuses request/response pairs
+// across calls instead of constructing new ones. Released messages are
+// Clear()ed and kept for the next call, and Clear() on protobuf messages
+// keeps the memory of their fields, so once the pool has warmed up a unary
+// method whose messages keep a similar shape allocates none for them.
+// RequestT and ResponseT must have a Clear() method, as protobuf messages
+// do. At most max_pooled pairs are kept; beyond that they are deleted.
+// Like any MessageAllocator, it must outlive the server.
+template <typename RequestT, typename ResponseT>
+class PooledMessageAllocator : public MessageAllocator<RequestT, ResponseT> {
+ public:
+  explicit PooledMessageAllocator(size_t max_pooled = 1024)
+      : max_pooled_(max_pooled) {}
+
+  ~PooledMessageAllocator() override {
+    for (PooledHolder* holder : free_) delete holder;
+  }
+
+  MessageHolder<RequestT, ResponseT>* AllocateMessages() override {
+    {
+      internal::MutexLock lock(&mu_);
+      if (!free_.empty()) {
+        PooledHolder* holder = free_.back();
+        free_.pop_back();
+        return holder;
+      }
+    }
+    return new PooledHolder(this);
+  }
+
+ private:
+  class PooledHolder : public MessageHolder<RequestT, ResponseT> {
+   public:
+    explicit PooledHolder(PooledMessageAllocator* allocator)
+        : allocator_(allocator) {
+      this->set_request(&request_);
+      this->set_response(&response_);
+    }
+
+    void Release() override {
+      request_.Clear();
+      response_.Clear();
+      allocator_->Return(this);
+    }
+
+   private:
+    PooledMessageAllocator* const allocator_;
+    RequestT request_;
+    ResponseT response_;
+  };
+
+  void Return(PooledHolder* holder) {
+    {
+      internal::MutexLock lock(&mu_);
+      if (free_.size() < max_pooled_) {
+        free_.push_back(holder);
+        return;
+      }
+    }
+    delete holder;
+  }
+
+  const size_t max_pooled_;
+  internal::Mutex mu_;
+  std::vector<PooledHolder*> free_;
+};
+
 }  // namespace grpc
 
 #endif  // GRPCPP_IMPL_CODEGEN_MESSAGE_ALLOCATOR_H
@@ -129,6 +129,12 @@ class ServerCallbackCall {
  private:
   virtual ServerReactor* reactor() = 0;
 
+  // The core call whose arena holds the closures that ScheduleOnDone and
+  // CallOnCancel hand to an executor. Implementations that are not backed
+  // by a core call (mocks) return nullptr and the closures are
+  // heap-allocated.
+  virtual grpc_call* core_call() { return nullptr; }
+
   // CallOnDone performs the work required at completion of the RPC: invoking
   // the OnDone function and doing all necessary cleanup. This function is only
   // ever invoked on a fully-Unref'fed ServerCallbackCall.
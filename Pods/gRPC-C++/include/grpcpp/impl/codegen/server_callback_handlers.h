@@ -218,6 +218,8 @@ class CallbackUnaryHandler : public ::grpc::internal::MethodHandler {
       return reactor_.load(std::memory_order_relaxed);
     }
 
+    grpc_call* core_call() override { return call_.call(); }
+
     ::grpc::internal::CallOpSet<::grpc::internal::CallOpSendInitialMetadata>
         meta_ops_;
     ::grpc::internal::CallbackWithSuccessTag meta_tag_;
@@ -415,6 +417,8 @@ class CallbackClientStreamingHandler : public ::grpc::internal::MethodHandler {
       return reactor_.load(std::memory_order_relaxed);
     }
 
+    grpc_call* core_call() override { return call_.call(); }
+
     ::grpc::internal::CallOpSet<::grpc::internal::CallOpSendInitialMetadata>
         meta_ops_;
     ::grpc::internal::CallbackWithSuccessTag meta_tag_;
@@ -644,6 +648,8 @@ class CallbackServerStreamingHandler : public ::grpc::internal::MethodHandler {
       return reactor_.load(std::memory_order_relaxed);
     }
 
+    grpc_call* core_call() override { return call_.call(); }
+
     ::grpc::internal::CallOpSet<::grpc::internal::CallOpSendInitialMetadata>
         meta_ops_;
     ::grpc::internal::CallbackWithSuccessTag meta_tag_;
@@ -861,6 +867,8 @@ class CallbackBidiHandler : public ::grpc::internal::MethodHandler {
       return reactor_.load(std::memory_order_relaxed);
     }
 
+    grpc_call* core_call() override { return call_.call(); }
+
     ::grpc::internal::CallOpSet<::grpc::internal::CallOpSendInitialMetadata>
         meta_ops_;
     ::grpc::internal::CallbackWithSuccessTag meta_tag_;
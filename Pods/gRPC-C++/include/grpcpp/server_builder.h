@@ -225,10 +225,28 @@ class ServerBuilder {
 
   /// Options for synchronous servers.
   enum SyncServerOption {
-    NUM_CQS,         ///< Number of completion queues.
-    MIN_POLLERS,     ///< Minimum number of polling threads.
-    MAX_POLLERS,     ///< Maximum number of polling threads.
-    CQ_TIMEOUT_MSEC  ///< Completion queue timeout in milliseconds.
+    NUM_CQS,          ///< Number of completion queues.
+    MIN_POLLERS,      ///< Minimum number of polling threads.
+    MAX_POLLERS,      ///< Maximum number of polling threads.
+    CQ_TIMEOUT_MSEC,  ///< Completion queue timeout in milliseconds.
+    /// Average time in milliseconds an incoming RPC may wait for a polling
+    /// thread before more are added, up to MAX_POLLERS. They are removed,
+    /// down to MIN_POLLERS, once the wait has stayed below half of this for
+    /// a second. 0 (the default) disables autoscaling.
+    AUTOSCALE_TARGET_LATENCY_MSEC,
+    /// Maximum number of threads started per second by autoscaling.
+    AUTOSCALE_MAX_THREAD_CREATIONS_PER_SEC,
+    /// CPU utilization of the process, in percent of all cores, above which
+    /// autoscaling adds no polling threads.
+    AUTOSCALE_MAX_CPU_PERCENT,
+    /// Requests that arrived more than this many milliseconds before a
+    /// thread picks them up are failed with RESOURCE_EXHAUSTED instead of
+    /// being handled. 0 (the default) disables this check.
+    SHED_QUEUE_TIME_MSEC,
+    /// Requests picked up while the process uses more than this percentage
+    /// of all cores are failed with RESOURCE_EXHAUSTED. 0 (the default)
+    /// disables this check.
+    SHED_CPU_PERCENT
   };
 
   /// Only useful if this is a Synchronous server.
@@ -355,7 +373,15 @@ class ServerBuilder {
 
   struct SyncServerSettings {
     SyncServerSettings()
-        : num_cqs(1), min_pollers(1), max_pollers(2), cq_timeout_msec(10000) {}
+        : num_cqs(1),
+          min_pollers(1),
+          max_pollers(2),
+          cq_timeout_msec(10000),
+          autoscale_target_latency_msec(0),
+          autoscale_max_thread_creations_per_sec(10),
+          autoscale_max_cpu_percent(90),
+          shed_queue_time_msec(0),
+          shed_cpu_percent(0) {}
 
     /// Number of server completion queues to create to listen to incoming RPCs.
     int num_cqs;
@@ -370,6 +396,15 @@ class ServerBuilder {
 
     /// The timeout for server completion queue's AsyncNext call.
     int cq_timeout_msec;
+
+    /// See AUTOSCALE_TARGET_LATENCY_MSEC and the options after it.
+    int autoscale_target_latency_msec;
+    int autoscale_max_thread_creations_per_sec;
+    int autoscale_max_cpu_percent;
+
+    /// See SHED_QUEUE_TIME_MSEC and SHED_CPU_PERCENT.
+    int shed_queue_time_msec;
+    int shed_cpu_percent;
   };
 
   int max_receive_message_size_;
@@ -0,0 +1,90 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPCPP_SUPPORT_RPC_TRACE_H
+#define GRPCPP_SUPPORT_RPC_TRACE_H
+
+#include <stdint.h>
+
+#include <chrono>
+#include <memory>
+#include <vector>
+
+#include <grpcpp/support/config.h>
+
+namespace grpc {
+
+namespace experimental {
+
+/// A span of a client call sampled for its timeline (see
+/// grpc_rpc_timeline_set_sampling_period()), laid out like an OpenTelemetry
+/// span so that an exporter can copy it field by field.
+///
+/// Each sampled call has a root span named "grpc.call" lasting from its
+/// creation to its last recorded event, and one child span for each phase
+/// it went through, in order:
+///   "grpc.resolve"          waiting for a resolver result
+///   "grpc.pick"             the LB pick, including any connection attempt
+///   "grpc.send_headers"     sending the initial metadata
+///   "grpc.wait_response"    until the response's initial metadata arrived
+///   "grpc.receive_message"  until the first response message was complete
+///   "grpc.receive_trailers" until the trailing metadata arrived
+///   "grpc.dispatch"         handing the status to the application
+/// The spans of one call share a trace id, and its children have the root's
+/// span id as their parent span id.
+struct RpcTraceSpan {
+  /// Static string: one of the names above.
+  const char* name;
+  uint8_t trace_id[16];
+  uint8_t span_id[8];
+  /// All zero for the root span.
+  uint8_t parent_span_id[8];
+  int64_t start_time_unix_nano;
+  int64_t end_time_unix_nano;
+};
+
+/// Receives the spans of sampled calls; see StartRpcTraceExport().
+class RpcTraceExporter {
+ public:
+  virtual ~RpcTraceExporter() {}
+  /// Called from a dedicated thread with the spans of the calls that finished
+  /// since the previous export. Never called with no spans.
+  virtual void Export(const std::vector<RpcTraceSpan>& spans) = 0;
+};
+
+/// Append the spans of the sampled calls that finished since the last
+/// collection to \a spans. This drains the same buffer as
+/// grpc_rpc_timeline_collect(), so it shouldn't be used together with it or
+/// with StartRpcTraceExport().
+void CollectRpcTraceSpans(std::vector<RpcTraceSpan>* spans);
+
+/// Start a thread that collects spans every \a interval and passes them to
+/// \a exporter, replacing any exporter started before. Sampled calls are only
+/// kept in a bounded buffer, so \a interval should be short enough that it
+/// does not overflow at the sampled call rate.
+void StartRpcTraceExport(std::shared_ptr<RpcTraceExporter> exporter,
+                         std::chrono::milliseconds interval);
+
+/// Stop the export thread, once it has exported the spans still buffered.
+void StopRpcTraceExport();
+
+}  // namespace experimental
+
+}  // namespace grpc
+
+#endif  // GRPCPP_SUPPORT_RPC_TRACE_H
@@ -28,9 +28,10 @@ namespace grpc_core {
 extern const char* kRequestRingHashAttribute;
 
 // Helper Parsing method to parse ring hash policy configs; for example, ring
-// hash size validity.
+// hash size validity.  maglev_table_size is 0 unless the config asks for a
+// Maglev lookup table instead of a ring.
 void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
-                           size_t* max_ring_size,
+                           size_t* max_ring_size, size_t* maglev_table_size,
                            std::vector<grpc_error_handle>* error_list);
 }  // namespace grpc_core
 
@@ -42,6 +42,10 @@ class ServerRetryThrottleData : public RefCounted<ServerRetryThrottleData> {
   /// Records a success.
   void RecordSuccess();
 
+  /// Returns true if retries are currently throttled, without recording
+  /// anything.  Used to decide whether to send hedged attempts.
+  bool IsThrottled();
+
   intptr_t max_milli_tokens() const { return max_milli_tokens_; }
   intptr_t milli_token_ratio() const { return milli_token_ratio_; }
 
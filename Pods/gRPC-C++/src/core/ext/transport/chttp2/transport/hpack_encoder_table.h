@@ -17,9 +17,8 @@
 
 #include <grpc/support/port_platform.h>
 
-#include "absl/container/inlined_vector.h"
-
 #include "src/core/ext/transport/chttp2/transport/hpack_constants.h"
+#include "src/core/ext/transport/chttp2/transport/hpack_table_ring.h"
 
 namespace grpc_core {
 
@@ -27,7 +26,7 @@ namespace grpc_core {
 // sizes.
 class HPackEncoderTable {
  public:
-  HPackEncoderTable() : elem_size_(hpack_constants::kInitialTableEntries) {}
+  HPackEncoderTable() = default;
 
   static constexpr size_t MaxEntrySize() { return 65535; }
 
@@ -44,26 +43,24 @@ class HPackEncoderTable {
 
   // Convert an element index into a dynamic index
   uint32_t DynamicIndex(uint32_t index) const {
-    return 1 + hpack_constants::kLastStaticEntry + tail_remote_index_ +
-           table_elems_ - index;
+    return hpack_constants::kLastStaticEntry + elem_size_.end_index() - index;
   }
   // Check if an element index is convertable to a dynamic index
   bool ConvertableToDynamicIndex(uint32_t index) const {
-    return index > tail_remote_index_;
+    return index >= elem_size_.first_index();
   }
+  // The number of elements ever added: dynamic indices only change with it
+  uint32_t insertion_count() const { return elem_size_.end_index() - 1; }
 
  private:
   void EvictOne();
-  void Rebuild(uint32_t capacity);
 
-  // one before the lowest usable table index
-  uint32_t tail_remote_index_ = 0;
   uint32_t max_table_size_ = hpack_constants::kInitialTableSize;
-  uint32_t table_elems_ = 0;
   uint32_t table_size_ = 0;
-  // The size of each element in the HPACK table.
-  absl::InlinedVector<uint16_t, hpack_constants::kInitialTableEntries>
-      elem_size_;
+  // The size of each element in the HPACK table, by element index. Index 0
+  // means "not in the table", so they start at 1.
+  HPackTableRing<uint16_t, hpack_constants::kInitialTableEntries> elem_size_{
+      1};
 };
 
 }  // namespace grpc_core
@@ -24,6 +24,7 @@
 #include <grpc/slice.h>
 
 #include "src/core/ext/transport/chttp2/transport/hpack_constants.h"
+#include "src/core/ext/transport/chttp2/transport/hpack_table_ring.h"
 #include "src/core/lib/gprpp/memory.h"
 #include "src/core/lib/iomgr/error.h"
 #include "src/core/lib/transport/metadata_batch.h"
@@ -63,7 +64,7 @@ class HPackTable {
   grpc_error_handle Add(Memento md) GRPC_MUST_USE_RESULT;
 
   // Current entry count in the table.
-  uint32_t num_entries() const { return num_entries_; }
+  uint32_t num_entries() const { return entries_.size(); }
 
  private:
   struct StaticMementos {
@@ -73,27 +74,19 @@ class HPackTable {
   static const StaticMementos& GetStaticMementos() GPR_ATTRIBUTE_NOINLINE;
 
   enum { kInlineEntries = hpack_constants::kInitialTableEntries };
-  using EntriesVec = absl::InlinedVector<Memento, kInlineEntries>;
 
   const Memento* LookupDynamic(uint32_t index) const {
-    // Not static - find the value in the list of valid entries
+    // Not static - find the value in the list of valid entries, newest first
     const uint32_t tbl_index = index - (hpack_constants::kLastStaticEntry + 1);
-    if (tbl_index < num_entries_) {
-      uint32_t offset =
-          (num_entries_ - 1u - tbl_index + first_entry_) % entries_.size();
-      return &entries_[offset];
+    if (tbl_index < entries_.size()) {
+      return &entries_[entries_.end_index() - 1u - tbl_index];
     }
     // Invalid entry: return error
     return nullptr;
   }
 
   void EvictOne();
-  void Rebuild(uint32_t new_cap);
 
-  // The first used entry in ents.
-  uint32_t first_entry_ = 0;
-  // How many entries are in the table.
-  uint32_t num_entries_ = 0;
   // The amount of memory used by the table, according to the hpack algorithm
   uint32_t mem_used_ = 0;
   // The max memory allowed to be used by the table, according to the hpack
@@ -101,11 +94,8 @@ class HPackTable {
   uint32_t max_bytes_ = hpack_constants::kInitialTableSize;
   // The currently agreed size of the table, according to the hpack algorithm.
   uint32_t current_table_bytes_ = hpack_constants::kInitialTableSize;
-  // Maximum number of entries we could possibly fit in the table, given defined
-  // overheads.
-  uint32_t max_entries_ = hpack_constants::kInitialTableEntries;
   // HPack table entries
-  EntriesVec entries_{hpack_constants::kInitialTableEntries};
+  HPackTableRing<Memento, kInlineEntries> entries_;
   // Mementos for static data
   const StaticMementos& static_metadata_;
 };
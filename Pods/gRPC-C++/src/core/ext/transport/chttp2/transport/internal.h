@@ -66,6 +66,12 @@ typedef enum {
   STREAM_LIST_COUNT /* must be last */
 } grpc_chttp2_stream_list_id;
 
+/* Weights given to streams in the writable list's fair queue; the range and
+   default match HTTP/2 stream weights */
+#define GRPC_CHTTP2_MIN_STREAM_WEIGHT 1
+#define GRPC_CHTTP2_MAX_STREAM_WEIGHT 256
+#define GRPC_CHTTP2_DEFAULT_STREAM_WEIGHT 16
+
 typedef enum {
   GRPC_CHTTP2_WRITE_STATE_IDLE,
   GRPC_CHTTP2_WRITE_STATE_WRITING,
@@ -318,6 +324,9 @@ struct grpc_chttp2_transport {
 
   /** maps stream id to grpc_chttp2_stream objects */
   grpc_chttp2_stream_map stream_map;
+  /** virtual time of the writable list: the start tag of the stream popped
+      from it last */
+  uint64_t writable_vtime = 0;
 
   grpc_closure write_action_begin_locked;
   grpc_closure write_action;
@@ -354,6 +363,8 @@ struct grpc_chttp2_transport {
   /** how much data are we willing to buffer when the WRITE_BUFFER_HINT is set?
    */
   uint32_t write_buffer_size = grpc_core::chttp2::kDefaultWindow;
+  /** how long to hold writes on an idle transport for, so they coalesce */
+  grpc_millis write_coalescing_window = 0;
 
   /** Set to a grpc_error object if a goaway frame is received. By default, set
    * to GRPC_ERROR_NONE */
@@ -463,6 +474,11 @@ struct grpc_chttp2_transport {
   bool bdp_ping_started = false;
   grpc_timer next_bdp_ping_timer;
 
+  /* write coalescing timer: set while a write is held to gather more frames */
+  bool have_write_coalescing_timer = false;
+  grpc_timer write_coalescing_timer;
+  grpc_closure write_coalescing_timer_expired_locked;
+
   /* keep-alive ping support */
   /** Closure to initialize a keepalive ping */
   grpc_closure init_keepalive_ping_locked;
@@ -480,6 +496,9 @@ struct grpc_chttp2_transport {
   grpc_millis keepalive_time;
   /** grace period for a ping to complete before watchdog kicks in */
   grpc_millis keepalive_timeout;
+  /** last time the peer was seen to be alive (data read, or a BDP ping sent);
+      the keepalive timer is pushed back lazily, when it fires */
+  grpc_millis keepalive_last_activity = 0;
   /** if keepalive pings are allowed when there's no outstanding streams */
   bool keepalive_permit_without_calls = false;
   /** If start_keepalive_ping_locked has been called */
@@ -525,6 +544,11 @@ struct grpc_chttp2_stream {
 
   grpc_chttp2_stream_link links[STREAM_LIST_COUNT];
   uint8_t included[STREAM_LIST_COUNT] = {};
+  /** share of the transport's writes this stream gets while writable */
+  uint32_t write_weight = GRPC_CHTTP2_DEFAULT_STREAM_WEIGHT;
+  /** virtual time this stream is next due to write at: the writable list is
+      kept ordered by it, and writing advances it by bytes over weight */
+  uint64_t write_vtime = 0;
 
   /** HTTP2 stream id for this stream, or zero if one has not been assigned */
   uint32_t id = 0;
@@ -683,6 +707,9 @@ bool grpc_chttp2_list_add_writable_stream(grpc_chttp2_transport* t,
     returns non-zero if there was a stream available */
 bool grpc_chttp2_list_pop_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream** s);
+/** Charge s for bytes written on its behalf, pushing back its next turn in
+    the writable list in inverse proportion to its weight */
+void grpc_chttp2_charge_writable_stream(grpc_chttp2_stream* s, size_t bytes);
 bool grpc_chttp2_list_remove_writable_stream(grpc_chttp2_transport* t,
                                              grpc_chttp2_stream* s);
 
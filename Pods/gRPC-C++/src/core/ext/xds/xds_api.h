@@ -22,9 +22,11 @@
 #include <stdint.h>
 
 #include <set>
+#include <vector>
 
 #include "envoy/admin/v3/config_dump.upb.h"
 #include "upb/def.hpp"
+#include "upb/upb.hpp"
 
 #include <grpc/slice.h>
 
@@ -68,6 +70,17 @@ class XdsApi {
     virtual void ParseResource(const XdsEncodingContext& context, size_t idx,
                                absl::string_view type_url,
                                absl::string_view serialized_resource) = 0;
+
+    // Called instead of ParseResource() for each resource in a delta
+    // (incremental) ADS response, with the version the server gave it.
+    virtual void ParseDeltaResource(const XdsEncodingContext& context,
+                                    size_t idx, absl::string_view version,
+                                    absl::string_view type_url,
+                                    absl::string_view serialized_resource) = 0;
+
+    // Called for each name in the removed_resources field of a delta ADS
+    // response.
+    virtual void RemoveResource(absl::string_view resource_name) = 0;
   };
 
   struct ClusterLoadReport {
@@ -156,6 +169,22 @@ class XdsApi {
                                 const grpc_slice& encoded_response,
                                 AdsResponseParserInterface* parser);
 
+  // Creates a DeltaDiscoveryRequest for the incremental variant of ADS.
+  // Only the changes to the subscription are sent; initial_versions is
+  // sent on the first request for a type on a new stream, so that the
+  // server can skip the resources the client already has.
+  grpc_slice CreateDeltaAdsRequest(
+      const XdsBootstrap::XdsServer& server, absl::string_view type_url,
+      absl::string_view nonce, const std::vector<std::string>& subscribe,
+      const std::vector<std::string>& unsubscribe,
+      const std::map<std::string, std::string>& initial_versions,
+      grpc_error_handle error, bool populate_node);
+
+  // Like ParseAdsResponse(), for a DeltaDiscoveryResponse.
+  absl::Status ParseDeltaAdsResponse(const XdsBootstrap::XdsServer& server,
+                                     const grpc_slice& encoded_response,
+                                     AdsResponseParserInterface* parser);
+
   // Creates an initial LRS request.
   grpc_slice CreateLrsInitialRequest(const XdsBootstrap::XdsServer& server);
 
@@ -184,6 +213,12 @@ class XdsApi {
   const std::string build_version_;
   const std::string user_agent_name_;
   const std::string user_agent_version_;
+  // Memory for the first block of the arena that ADS responses are decoded
+  // into, kept from one response to the next so that typical responses are
+  // decoded without allocating. Used with the XdsClient's mutex held.
+  std::vector<char> ads_arena_block_;
+
+  upb::Arena MakeAdsResponseArena(size_t response_size);
 };
 
 }  // namespace grpc_core
@@ -41,6 +41,9 @@ typedef enum {
   /// Holds a pointer to ServiceConfigCallData associated with this call.
   GRPC_CONTEXT_SERVICE_CONFIG_CALL_DATA,
 
+  /// Value is a grpc_core::RpcTimeline, if the call is being sampled.
+  GRPC_CONTEXT_RPC_TIMELINE,
+
   GRPC_CONTEXT_COUNT
 } grpc_context_index;
 
@@ -44,12 +44,17 @@ extern grpc_stats_data* grpc_stats_per_cpu_storage;
 #define GRPC_STATS_INC_COUNTER(ctr) \
   (gpr_atm_no_barrier_fetch_add(&GRPC_THREAD_STATS_DATA()->counters[(ctr)], 1))
 
+#define GRPC_STATS_ADD_TO_COUNTER(ctr, value)                               \
+  (gpr_atm_no_barrier_fetch_add(&GRPC_THREAD_STATS_DATA()->counters[(ctr)], \
+                                static_cast<gpr_atm>(value)))
+
 #define GRPC_STATS_INC_HISTOGRAM(histogram, index)                             \
   (gpr_atm_no_barrier_fetch_add(                                               \
       &GRPC_THREAD_STATS_DATA()->histograms[histogram##_FIRST_SLOT + (index)], \
       1))
 #else /* defined(GRPC_COLLECT_STATS) || !defined(NDEBUG) */
 #define GRPC_STATS_INC_COUNTER(ctr)
+#define GRPC_STATS_ADD_TO_COUNTER(ctr, value)
 #define GRPC_STATS_INC_HISTOGRAM(histogram, index)
 #endif /* defined(GRPC_COLLECT_STATS) || !defined(NDEBUG) */
 
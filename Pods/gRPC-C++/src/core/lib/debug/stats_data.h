@@ -33,6 +33,9 @@ typedef enum {
   GRPC_STATS_COUNTER_CQS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_CHANNELS_CREATED,
   GRPC_STATS_COUNTER_CLIENT_SUBCHANNELS_CREATED,
+  GRPC_STATS_COUNTER_CLIENT_CONCURRENCY_LIMIT,
+  GRPC_STATS_COUNTER_CLIENT_CALLS_CONCURRENCY_QUEUED,
+  GRPC_STATS_COUNTER_CLIENT_CALLS_CONCURRENCY_REJECTED,
   GRPC_STATS_COUNTER_SERVER_CHANNELS_CREATED,
   GRPC_STATS_COUNTER_SYSCALL_POLL,
   GRPC_STATS_COUNTER_SYSCALL_WAIT,
@@ -49,6 +52,8 @@ typedef enum {
   GRPC_STATS_COUNTER_SYSCALL_READ,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED,
   GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS,
+  GRPC_STATS_COUNTER_TCP_ZEROCOPY_COPY_BYTES_AVOIDED,
+  GRPC_STATS_COUNTER_TCP_ZEROCOPY_WRITES_COPIED,
   GRPC_STATS_COUNTER_HTTP2_OP_BATCHES,
   GRPC_STATS_COUNTER_HTTP2_OP_CANCEL,
   GRPC_STATS_COUNTER_HTTP2_OP_SEND_INITIAL_METADATA,
@@ -121,6 +126,7 @@ typedef enum {
   GRPC_STATS_COUNTER_EXECUTOR_WAKEUP_INITIATED,
   GRPC_STATS_COUNTER_EXECUTOR_QUEUE_DRAINED,
   GRPC_STATS_COUNTER_EXECUTOR_PUSH_RETRIES,
+  GRPC_STATS_COUNTER_EXECUTOR_CLOSURES_STOLEN,
   GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS,
   GRPC_STATS_COUNTER_SERVER_SLOWPATH_REQUESTS_QUEUED,
   GRPC_STATS_COUNTER_CQ_EV_QUEUE_TRYLOCK_FAILURES,
@@ -144,6 +150,7 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_TRAILING_METADATA_PER_WRITE,
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
+  GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH,
   GRPC_STATS_HISTOGRAM_COUNT
 } grpc_stats_histograms;
 extern const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT];
@@ -175,7 +182,9 @@ typedef enum {
   GRPC_STATS_HISTOGRAM_HTTP2_SEND_FLOWCTL_PER_WRITE_BUCKETS = 64,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_FIRST_SLOT = 832,
   GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED_BUCKETS = 8,
-  GRPC_STATS_HISTOGRAM_BUCKETS = 840
+  GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH_FIRST_SLOT = 840,
+  GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH_BUCKETS = 8,
+  GRPC_STATS_HISTOGRAM_BUCKETS = 848
 } grpc_stats_histogram_constants;
 #if defined(GRPC_COLLECT_STATS) || !defined(NDEBUG)
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED() \
@@ -188,6 +197,13 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_CHANNELS_CREATED)
 #define GRPC_STATS_INC_CLIENT_SUBCHANNELS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_SUBCHANNELS_CREATED)
+#define GRPC_STATS_INC_CLIENT_CONCURRENCY_LIMIT(value)                    \
+  GRPC_STATS_ADD_TO_COUNTER(GRPC_STATS_COUNTER_CLIENT_CONCURRENCY_LIMIT, \
+                            (value))
+#define GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_QUEUED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_CALLS_CONCURRENCY_QUEUED)
+#define GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_REJECTED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_CLIENT_CALLS_CONCURRENCY_REJECTED)
 #define GRPC_STATS_INC_SERVER_CHANNELS_CREATED() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_CHANNELS_CREATED)
 #define GRPC_STATS_INC_SYSCALL_POLL() \
@@ -220,6 +236,11 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLERS_CREATED)
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_BACKUP_POLLER_POLLS)
+#define GRPC_STATS_INC_TCP_ZEROCOPY_COPY_BYTES_AVOIDED(value) \
+  GRPC_STATS_ADD_TO_COUNTER(                                  \
+      GRPC_STATS_COUNTER_TCP_ZEROCOPY_COPY_BYTES_AVOIDED, (value))
+#define GRPC_STATS_INC_TCP_ZEROCOPY_WRITES_COPIED() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_TCP_ZEROCOPY_WRITES_COPIED)
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_HTTP2_OP_BATCHES)
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL() \
@@ -386,6 +407,8 @@ typedef enum {
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_QUEUE_DRAINED)
 #define GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_PUSH_RETRIES)
+#define GRPC_STATS_INC_EXECUTOR_CLOSURES_STOLEN() \
+  GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_EXECUTOR_CLOSURES_STOLEN)
 #define GRPC_STATS_INC_SERVER_REQUESTED_CALLS() \
   GRPC_STATS_INC_COUNTER(GRPC_STATS_COUNTER_SERVER_REQUESTED_CALLS)
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED() \
@@ -435,12 +458,18 @@ void grpc_stats_inc_http2_send_flowctl_per_write(int value);
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value) \
   grpc_stats_inc_server_cqs_checked((int)(value))
 void grpc_stats_inc_server_cqs_checked(int value);
+#define GRPC_STATS_INC_EXECUTOR_QUEUE_DEPTH(value) \
+  grpc_stats_inc_executor_queue_depth((int)(value))
+void grpc_stats_inc_executor_queue_depth(int value);
 #else
 #define GRPC_STATS_INC_CLIENT_CALLS_CREATED()
 #define GRPC_STATS_INC_SERVER_CALLS_CREATED()
 #define GRPC_STATS_INC_CQS_CREATED()
 #define GRPC_STATS_INC_CLIENT_CHANNELS_CREATED()
 #define GRPC_STATS_INC_CLIENT_SUBCHANNELS_CREATED()
+#define GRPC_STATS_INC_CLIENT_CONCURRENCY_LIMIT(value)
+#define GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_QUEUED()
+#define GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_REJECTED()
 #define GRPC_STATS_INC_SERVER_CHANNELS_CREATED()
 #define GRPC_STATS_INC_SYSCALL_POLL()
 #define GRPC_STATS_INC_SYSCALL_WAIT()
@@ -457,6 +486,8 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_SYSCALL_READ()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLERS_CREATED()
 #define GRPC_STATS_INC_TCP_BACKUP_POLLER_POLLS()
+#define GRPC_STATS_INC_TCP_ZEROCOPY_COPY_BYTES_AVOIDED(value)
+#define GRPC_STATS_INC_TCP_ZEROCOPY_WRITES_COPIED()
 #define GRPC_STATS_INC_HTTP2_OP_BATCHES()
 #define GRPC_STATS_INC_HTTP2_OP_CANCEL()
 #define GRPC_STATS_INC_HTTP2_OP_SEND_INITIAL_METADATA()
@@ -529,6 +560,7 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED()
 #define GRPC_STATS_INC_EXECUTOR_QUEUE_DRAINED()
 #define GRPC_STATS_INC_EXECUTOR_PUSH_RETRIES()
+#define GRPC_STATS_INC_EXECUTOR_CLOSURES_STOLEN()
 #define GRPC_STATS_INC_SERVER_REQUESTED_CALLS()
 #define GRPC_STATS_INC_SERVER_SLOWPATH_REQUESTS_QUEUED()
 #define GRPC_STATS_INC_CQ_EV_QUEUE_TRYLOCK_FAILURES()
@@ -547,10 +579,11 @@ void grpc_stats_inc_server_cqs_checked(int value);
 #define GRPC_STATS_INC_HTTP2_SEND_TRAILING_METADATA_PER_WRITE(value)
 #define GRPC_STATS_INC_HTTP2_SEND_FLOWCTL_PER_WRITE(value)
 #define GRPC_STATS_INC_SERVER_CQS_CHECKED(value)
+#define GRPC_STATS_INC_EXECUTOR_QUEUE_DEPTH(value)
 #endif /* defined(GRPC_COLLECT_STATS) || !defined(NDEBUG) */
-extern const int grpc_stats_histo_buckets[13];
-extern const int grpc_stats_histo_start[13];
-extern const int* const grpc_stats_histo_bucket_boundaries[13];
-extern void (*const grpc_stats_inc_histogram[13])(int x);
+extern const int grpc_stats_histo_buckets[14];
+extern const int grpc_stats_histo_start[14];
+extern const int* const grpc_stats_histo_bucket_boundaries[14];
+extern void (*const grpc_stats_inc_histogram[14])(int x);
 
 #endif /* GRPC_CORE_LIB_DEBUG_STATS_DATA_H */
@@ -0,0 +1,133 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_GPRPP_MPMCQ_H
+#define GRPC_CORE_LIB_GPRPP_MPMCQ_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <utility>
+
+namespace grpc_core {
+
+// Bounded multiple-producer multiple-consumer lock free queue, based upon the
+// implementation from Dmitry Vyukov here:
+// http://www.1024cores.net/home/lock-free-algorithms/queues/bounded-mpmc-queue
+// Each cell carries a sequence number saying whether it is ready to be pushed
+// to or popped from for the current lap around the ring, so a push or pop is
+// one compare-and-swap on the shared position in the uncontended case.
+template <typename T, size_t kCapacity>
+class BoundedMultiProducerMultiConsumerQueue {
+  static_assert(kCapacity >= 2 && (kCapacity & (kCapacity - 1)) == 0,
+                "capacity must be a power of two");
+
+ public:
+  BoundedMultiProducerMultiConsumerQueue() {
+    for (size_t i = 0; i < kCapacity; i++) {
+      cells_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+  }
+
+  BoundedMultiProducerMultiConsumerQueue(
+      const BoundedMultiProducerMultiConsumerQueue&) = delete;
+  BoundedMultiProducerMultiConsumerQueue& operator=(
+      const BoundedMultiProducerMultiConsumerQueue&) = delete;
+
+  // Push a value; returns false if the queue is full.
+  // Thread safe - can be called from multiple threads concurrently
+  bool TryPush(T value) {
+    size_t pos = enqueue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & (kCapacity - 1)];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos);
+      if (diff == 0) {
+        if (enqueue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        // The cell still holds the value pushed a lap ago.
+        return false;
+      } else {
+        pos = enqueue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    cell->value = std::move(value);
+    cell->sequence.store(pos + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Pop a value; returns false if the queue is empty (or the oldest push has
+  // not finished yet).
+  // Thread safe - can be called from multiple threads concurrently
+  bool TryPop(T* value) {
+    size_t pos = dequeue_pos_.load(std::memory_order_relaxed);
+    Cell* cell;
+    for (;;) {
+      cell = &cells_[pos & (kCapacity - 1)];
+      const size_t sequence = cell->sequence.load(std::memory_order_acquire);
+      const intptr_t diff =
+          static_cast<intptr_t>(sequence) - static_cast<intptr_t>(pos + 1);
+      if (diff == 0) {
+        if (dequeue_pos_.compare_exchange_weak(pos, pos + 1,
+                                               std::memory_order_relaxed)) {
+          break;
+        }
+      } else if (diff < 0) {
+        return false;
+      } else {
+        pos = dequeue_pos_.load(std::memory_order_relaxed);
+      }
+    }
+    *value = std::move(cell->value);
+    cell->sequence.store(pos + kCapacity, std::memory_order_release);
+    return true;
+  }
+
+  // Number of values pushed (or being pushed) and not yet popped. Only
+  // approximate while other threads push and pop.
+  size_t SizeApprox() const {
+    const size_t enqueued = enqueue_pos_.load(std::memory_order_acquire);
+    const size_t dequeued = dequeue_pos_.load(std::memory_order_acquire);
+    return enqueued > dequeued ? enqueued - dequeued : 0;
+  }
+
+ private:
+  struct Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  Cell cells_[kCapacity];
+  // make sure the producers' and consumers' positions don't share a cacheline
+  union {
+    char enqueue_padding_[GPR_CACHELINE_SIZE];
+    std::atomic<size_t> enqueue_pos_{0};
+  };
+  union {
+    char dequeue_padding_[GPR_CACHELINE_SIZE];
+    std::atomic<size_t> dequeue_pos_{0};
+  };
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_GPRPP_MPMCQ_H
@@ -23,9 +23,12 @@
 
 #include <stddef.h>
 
+#include <string>
+
 #include <grpc/support/atm.h>
 
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/time_precise.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 
 namespace grpc_core {
@@ -51,6 +54,18 @@ class Combiner {
   grpc_closure_list final_list;
   grpc_closure offload;
   gpr_refcount refs;
+  // If true, the combiner never offloads its work to the executor: it keeps
+  // running on the thread that holds it, typically a poller thread
+  bool affinity = false;
+  // Contention profile. The counters are updated without barriers, so they
+  // are only approximate while the combiner is in use.
+  gpr_atm scheduled_items = 0;
+  gpr_atm offloads = 0;
+  gpr_atm max_queue_depth = 0;
+  gpr_atm held_nanos = 0;  // Total time spent with closures queued
+  gpr_cycle_counter locked_at = 0;  // Only accessed while locked
+  // Returns a summary of the contention profile, for logging
+  std::string StatsString();
 };
 }  // namespace grpc_core
 
@@ -85,5 +100,7 @@ void grpc_combiner_unref(grpc_core::Combiner* lock GRPC_COMBINER_DEBUG_ARGS);
 bool grpc_combiner_continue_exec_ctx();
 
 extern grpc_core::DebugOnlyTraceFlag grpc_combiner_trace;
+// Logs the contention profile of the transport combiners when they go away
+extern grpc_core::TraceFlag grpc_combiner_stats_trace;
 
 #endif /* GRPC_CORE_LIB_IOMGR_COMBINER_H */
@@ -93,6 +93,11 @@
 #ifndef GRPC_LINUX_SOCKETUTILS
 #define GRPC_POSIX_SOCKETUTILS
 #endif
+#ifdef __has_include
+#if __has_include(<linux/io_uring.h>)
+#define GRPC_LINUX_IO_URING 1
+#endif
+#endif
 #elif defined(GPR_APPLE)
 #define GRPC_HAVE_ARPA_NAMESER 1
 #define GRPC_HAVE_IFADDRS 1
@@ -106,10 +111,16 @@
 #define GRPC_CFSTREAM_CLIENT 1
 #define GRPC_CFSTREAM_ENDPOINT 1
 #define GRPC_APPLE_EV 1
+#ifdef __has_include
+#if __has_include(<Network/Network.h>)
+#define GRPC_APPLE_NETWORK_ENDPOINT 1
+#endif
+#endif
 #define GRPC_POSIX_SOCKET_ARES_EV_DRIVER 1
 #define GRPC_POSIX_SOCKET_EV 1
 #define GRPC_POSIX_SOCKET_EV_EPOLL1 1
 #define GRPC_POSIX_SOCKET_EV_EPOLLEX 1
+#define GRPC_POSIX_SOCKET_EV_IO_URING 1
 #define GRPC_POSIX_SOCKET_EV_POLL 1
 #define GRPC_POSIX_SOCKET_IF_NAMETOINDEX 1
 #define GRPC_POSIX_SOCKET_RESOLVE_ADDRESS 1
@@ -198,6 +209,7 @@
 #define GRPC_POSIX_SOCKET_EV_EPOLLEX 1
 #define GRPC_POSIX_SOCKET_EV_POLL 1
 #define GRPC_POSIX_SOCKET_EV_EPOLL1 1
+#define GRPC_POSIX_SOCKET_EV_IO_URING 1
 #define GRPC_POSIX_SOCKET_IF_NAMETOINDEX 1
 #define GRPC_POSIX_SOCKET_IOMGR 1
 #define GRPC_POSIX_SOCKET_RESOLVE_ADDRESS 1
@@ -0,0 +1,95 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_LIB_IOMGR_RESOLVE_ADDRESS_CACHE_H
+#define GRPC_CORE_LIB_IOMGR_RESOLVE_ADDRESS_CACHE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "absl/base/thread_annotations.h"
+
+#include <grpc/support/time.h>
+
+#include "src/core/lib/gprpp/global_config.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/resolve_address.h"
+
+GPR_GLOBAL_CONFIG_DECLARE_INT32(grpc_dns_cache_ttl_ms);
+GPR_GLOBAL_CONFIG_DECLARE_INT32(grpc_dns_negative_cache_ttl_ms);
+
+namespace grpc_core {
+
+// A DNS resolver which caches the results of another one, so that all the
+// channels share them. Addresses are kept for GRPC_DNS_CACHE_TTL_MS and
+// failures for GRPC_DNS_NEGATIVE_CACHE_TTL_MS: getaddrinfo() does not report
+// record TTLs, so these bound how stale a result may get. Concurrent
+// resolutions of the same name share a single lookup.
+class CachingDNSResolver : public DNSResolver {
+ public:
+  // Returns a resolver caching the results of resolver, or resolver itself if
+  // both TTLs are 0. The cache is created once, around the first resolver.
+  static DNSResolver* MaybeWrap(DNSResolver* resolver);
+
+  OrphanablePtr<DNSResolver::Request> ResolveName(
+      absl::string_view name, absl::string_view default_port,
+      grpc_pollset_set* interested_parties,
+      std::function<void(absl::StatusOr<std::vector<grpc_resolved_address>>)>
+          on_done) override;
+
+  absl::StatusOr<std::vector<grpc_resolved_address>> ResolveNameBlocking(
+      absl::string_view name, absl::string_view default_port) override;
+
+ private:
+  class CachedRequest;
+  using Key = std::pair<std::string, std::string>;  // name, default port
+  using Result = absl::StatusOr<std::vector<grpc_resolved_address>>;
+
+  struct Entry {
+    Result result;
+    gpr_timespec expires;
+    // While a lookup is in flight, the requests waiting for it
+    bool in_flight = false;
+    std::vector<RefCountedPtr<CachedRequest>> waiters;
+    OrphanablePtr<DNSResolver::Request> lookup;
+  };
+
+  CachingDNSResolver(DNSResolver* resolver, int ttl_ms, int negative_ttl_ms);
+
+  void StartRequest(RefCountedPtr<CachedRequest> request);
+  void OnLookupDone(const Key& key, Result result);
+  // Returns the cached result for key, if still fresh
+  bool Lookup(const Key& key, Result* result)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void Store(const Key& key, const Result& result)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  gpr_timespec ExpiryFor(const Result& result) const;
+
+  DNSResolver* const resolver_;
+  const int ttl_ms_;
+  const int negative_ttl_ms_;
+  Mutex mu_;
+  std::map<Key, Entry> cache_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_IOMGR_RESOLVE_ADDRESS_CACHE_H
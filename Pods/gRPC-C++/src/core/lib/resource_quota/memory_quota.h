@@ -73,6 +73,35 @@ enum class ReclamationPass {
 };
 static constexpr size_t kNumReclamationPasses = 4;
 
+// Memory pressure levels.
+// Rather than waiting for a quota to be overcommitted before doing anything, we
+// respond in stages as it fills up: each level allows one more reclamation
+// pass to run, and tells the rest of the stack to cut back a little further.
+enum class MemoryPressureLevel {
+  // Reclamation only runs if the quota is overcommitted.
+  kNone = 0,
+  // Allocators give back the memory they have cached and benign reclamation
+  // runs; transports stop growing flow control windows, and begin to shrink
+  // them.
+  kModerate = 1,
+  // Idle reclamation runs as well; servers stop accepting new connections.
+  kHigh = 2,
+  // Destructive reclamation runs as well; servers refuse new streams. An
+  // overcommitted quota is always at this level.
+  kCritical = 3,
+};
+static constexpr size_t kNumMemoryPressureLevels = 4;
+
+// The fraction of a quota in use at which each level above kNone begins.
+struct MemoryPressureThresholds {
+  double moderate = 0.8;
+  double high = 0.9;
+  double critical = 0.95;
+};
+
+// Called each time a quota's memory pressure level changes.
+using MemoryPressureCallback = std::function<void(MemoryPressureLevel)>;
+
 // For each reclamation function run we construct a ReclamationSweep.
 // When this object is finally destroyed (it may be moved several times first),
 // then that reclamation is complete and we may continue the reclamation loop.
@@ -179,7 +208,7 @@ class ReclaimerQueue {
 class BasicMemoryQuota final
     : public std::enable_shared_from_this<BasicMemoryQuota> {
  public:
-  explicit BasicMemoryQuota(std::string name) : name_(std::move(name)) {}
+  explicit BasicMemoryQuota(std::string name);
 
   // Start the reclamation activity.
   void Start();
@@ -201,6 +230,24 @@ class BasicMemoryQuota final
   // Instantaneous memory pressure approximation.
   std::pair<double, size_t>
   InstantaneousPressureAndMaxRecommendedAllocationSize() const;
+  // Current memory pressure level.
+  MemoryPressureLevel PressureLevel() const {
+    return pressure_level_.load(std::memory_order_relaxed);
+  }
+  // Set the thresholds at which each memory pressure level begins.
+  void SetPressureThresholds(MemoryPressureThresholds thresholds)
+      ABSL_LOCKS_EXCLUDED(pressure_mu_);
+  MemoryPressureThresholds PressureThresholds() const
+      ABSL_LOCKS_EXCLUDED(pressure_mu_);
+  // Add a callback to be run (from the reclamation activity) whenever the
+  // pressure level changes, for as long as the quota lives.
+  void AddPressureWatcher(MemoryPressureCallback callback)
+      ABSL_LOCKS_EXCLUDED(pressure_mu_);
+  // Number of times the quota has entered a level, for metrics.
+  uint64_t PressureLevelEntries(MemoryPressureLevel level) const {
+    return pressure_level_entries_[static_cast<size_t>(level)].load(
+        std::memory_order_relaxed);
+  }
   // Cancel a reclaimer
   ReclamationFunction CancelReclaimer(
       size_t reclaimer, typename ReclaimerQueue::Index index,
@@ -224,6 +271,18 @@ class BasicMemoryQuota final
 
   static constexpr intptr_t kInitialSize = std::numeric_limits<intptr_t>::max();
 
+  // Recompute level_free_bytes_ after a change to the quota size or to the
+  // thresholds.
+  void UpdateLevelFreeBytes() ABSL_LOCKS_EXCLUDED(pressure_mu_);
+  // Move to the pressure level for free bytes, waking the reclaimer activity
+  // if it changed.
+  void UpdatePressureLevel(intptr_t free_bytes);
+  // Run the pressure watchers if the level changed since they last ran.
+  // Only called from the reclaimer activity.
+  void NotifyPressureWatchers() ABSL_LOCKS_EXCLUDED(pressure_mu_);
+  // Poll reclaimer queue pass if the current pressure allows it to run.
+  Poll<ReclamationFunction> PollReclaimer(size_t pass);
+
   // The amount of memory that's free in this quota.
   // We use intptr_t as a reasonable proxy for ssize_t that's portable.
   // We allow arbitrary overcommit and so this must allow negative values.
@@ -233,6 +292,20 @@ class BasicMemoryQuota final
 
   // Reclaimer queues.
   ReclaimerQueue reclaimers_[kNumReclamationPasses];
+  // Current memory pressure level.
+  std::atomic<MemoryPressureLevel> pressure_level_{MemoryPressureLevel::kNone};
+  // For each level above kNone, the free bytes at or below which it begins.
+  std::atomic<intptr_t> level_free_bytes_[kNumMemoryPressureLevels - 1] = {
+      {0}, {0}, {0}};
+  std::atomic<uint64_t> pressure_level_entries_[kNumMemoryPressureLevels] = {
+      {0}, {0}, {0}, {0}};
+  mutable Mutex pressure_mu_;
+  MemoryPressureThresholds pressure_thresholds_ ABSL_GUARDED_BY(pressure_mu_);
+  std::vector<MemoryPressureCallback> pressure_watchers_
+      ABSL_GUARDED_BY(pressure_mu_);
+  // The level the watchers were last told about; only touched by the
+  // reclaimer activity.
+  MemoryPressureLevel notified_pressure_level_ = MemoryPressureLevel::kNone;
   // The reclaimer activity consumes reclaimers whenever we are in overcommit to
   // try and get back under memory limits.
   ActivityPtr reclaimer_activity_;
@@ -287,6 +360,16 @@ class GrpcMemoryAllocatorImpl final : public EventEngineMemoryAllocatorImpl {
         .first;
   }
 
+  // Read the memory pressure level, and the thresholds between levels
+  MemoryPressureLevel PressureLevel() const {
+    MutexLock lock(&memory_quota_mu_);
+    return memory_quota_->PressureLevel();
+  }
+  MemoryPressureThresholds PressureThresholds() const {
+    MutexLock lock(&memory_quota_mu_);
+    return memory_quota_->PressureThresholds();
+  }
+
   // Name of this allocator
   absl::string_view name() const { return name_; }
 
@@ -355,6 +438,12 @@ class MemoryOwner final : public MemoryAllocator {
     return impl()->InstantaneousPressure();
   }
 
+  // Memory pressure level in the underlying quota, and its thresholds.
+  MemoryPressureLevel PressureLevel() const { return impl()->PressureLevel(); }
+  MemoryPressureThresholds PressureThresholds() const {
+    return impl()->PressureThresholds();
+  }
+
   template <typename T, typename... Args>
   OrphanablePtr<T> MakeOrphanable(Args&&... args) {
     return OrphanablePtr<T>(New<T>(std::forward<Args>(args)...));
@@ -401,9 +490,21 @@ class MemoryQuota final
 
   // Return true if the instantaneous memory pressure is high.
   bool IsMemoryPressureHigh() const {
-    static constexpr double kMemoryPressureHighThreshold = 0.9;
-    return memory_quota_->InstantaneousPressureAndMaxRecommendedAllocationSize()
-               .first > kMemoryPressureHighThreshold;
+    return PressureLevel() >= MemoryPressureLevel::kHigh;
+  }
+
+  // Memory pressure levels: see MemoryPressureLevel.
+  MemoryPressureLevel PressureLevel() const {
+    return memory_quota_->PressureLevel();
+  }
+  void SetPressureThresholds(MemoryPressureThresholds thresholds) {
+    memory_quota_->SetPressureThresholds(thresholds);
+  }
+  void AddPressureWatcher(MemoryPressureCallback callback) {
+    memory_quota_->AddPressureWatcher(std::move(callback));
+  }
+  uint64_t PressureLevelEntries(MemoryPressureLevel level) const {
+    return memory_quota_->PressureLevelEntries(level);
   }
 
  private:
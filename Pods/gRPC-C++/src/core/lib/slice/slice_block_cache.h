@@ -0,0 +1,49 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_SLICE_SLICE_BLOCK_CACHE_H
+#define GRPC_CORE_LIB_SLICE_SLICE_BLOCK_CACHE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+namespace grpc_core {
+
+// Per-thread caches of the heap blocks that back slices (refcount and bytes).
+//
+// Blocks of up to kMaxCachedBlockSize bytes are rounded up to a power of two
+// size class. A freed block goes on a short free list for its class on the
+// freeing thread, where the next allocation of that class on the thread picks
+// it up without going to malloc. Each thread caches at most
+// kMaxCachedBytesPerClass bytes per class, and its cache is freed when the
+// thread exits. Where there's no way to hear about thread exit (non-POSIX
+// platforms), blocks always go straight back to the heap.
+//
+// This only caches memory: slices allocated through a MemoryAllocator are
+// accounted against their quota exactly as before.
+class SliceBlockCache {
+ public:
+  static constexpr size_t kMaxCachedBlockSize = 16 * 1024;
+  static constexpr size_t kMaxCachedBytesPerClass = 32 * 1024;
+
+  // Returns a block of at least size bytes.
+  static void* Alloc(size_t size);
+  // Frees a block returned by Alloc(); size must be the size it was asked for.
+  static void Free(void* block, size_t size);
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_SLICE_SLICE_BLOCK_CACHE_H
@@ -0,0 +1,80 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_SLICE_SLICE_CORD_H
+#define GRPC_CORE_LIB_SLICE_SLICE_CORD_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+
+#include <utility>
+
+#include "absl/strings/cord.h"
+
+#include <grpc/byte_buffer.h>
+#include <grpc/slice_buffer.h>
+
+#include "src/core/lib/slice/slice.h"
+
+namespace grpc_core {
+
+// A sequence of bytes backed by an absl::Cord, for assembling large messages.
+// Unlike grpc_slice_buffer, which keeps its slices in one array, appending,
+// prepending and splitting off a prefix don't move the other pieces: they take
+// constant time, or logarithmic in the number of pieces.
+// Slices move in and out without copying their bytes: the cord holds a ref to
+// each (large enough) slice given to it, and slices taken out hold a ref to
+// the cord.
+class SliceCord {
+ public:
+  SliceCord() = default;
+  explicit SliceCord(absl::Cord cord) : cord_(std::move(cord)) {}
+  // Take all the slices from slice_buffer, leaving it empty.
+  explicit SliceCord(grpc_slice_buffer* slice_buffer);
+
+  SliceCord(const SliceCord&) = default;
+  SliceCord& operator=(const SliceCord&) = default;
+  SliceCord(SliceCord&&) = default;
+  SliceCord& operator=(SliceCord&&) = default;
+
+  size_t Length() const { return cord_.size(); }
+  bool empty() const { return cord_.empty(); }
+
+  void Append(Slice slice);
+  void Append(SliceCord other) { cord_.Append(std::move(other.cord_)); }
+  void Prepend(Slice slice);
+  void Prepend(SliceCord other) { cord_.Prepend(std::move(other.cord_)); }
+
+  // Remove the first n bytes, and return them. n must be at most Length().
+  SliceCord TakeFirst(size_t n);
+
+  // Append the contents to slice_buffer, leaving this empty.
+  void MoveTo(grpc_slice_buffer* slice_buffer);
+
+  // Interop with grpc_byte_buffer, and so with the C++ ByteBuffer, which wraps
+  // one: the slices of a (possibly compressed) byte buffer's payload, and a raw
+  // byte buffer of this one's contents, leaving this empty.
+  static SliceCord FromByteBuffer(grpc_byte_buffer* byte_buffer);
+  grpc_byte_buffer* MoveToByteBuffer();
+
+  const absl::Cord& cord() const { return cord_; }
+
+ private:
+  absl::Cord cord_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_SLICE_SLICE_CORD_H
@@ -50,6 +50,10 @@ typedef struct grpc_call_create_args {
   absl::optional<grpc_core::Slice> authority;
 
   grpc_millis send_deadline;
+
+  /* if not NULL, learns the arena size for calls like this one, in lieu of the
+     channel's estimate */
+  grpc_core::ArenaSizeEstimator* arena_size_estimator;
 } grpc_call_create_args;
 
 /* Create a new call based on \a args.
@@ -110,6 +114,11 @@ void* grpc_call_context_get(grpc_call* call, grpc_context_index elem);
 
 uint8_t grpc_call_is_client(grpc_call* call);
 
+/* How long ago the call was created. On the server, calls are created when
+ * their stream arrives, so this includes the time spent waiting to be
+ * matched and dispatched. */
+gpr_timespec grpc_call_get_age(grpc_call* call);
+
 /* Get the estimated memory size for a call BESIDES the call stack. Combined
  * with the size of the call stack, it helps estimate the arena size for the
  * initial call. */
@@ -27,6 +27,7 @@
 #include "src/core/lib/channel/channel_stack_builder.h"
 #include "src/core/lib/channel/channelz.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/surface/channel_stack_type.h"
 
@@ -75,6 +76,9 @@ namespace grpc_core {
 struct RegisteredCall {
   Slice path;
   absl::optional<Slice> authority;
+  // Calls on a registered method tend to need the same arena size, so each
+  // method learns its own rather than sharing the channel's estimate
+  ArenaSizeEstimator arena_size_estimator;
 
   explicit RegisteredCall(const char* method_arg, const char* host_arg);
   RegisteredCall(const RegisteredCall& other);
@@ -110,6 +114,7 @@ struct grpc_channel {
       registration_table;
   grpc_core::RefCountedPtr<grpc_core::channelz::ChannelNode> channelz_node;
   grpc_core::ManualConstructor<grpc_core::MemoryAllocator> allocator;
+  grpc_core::ManualConstructor<grpc_core::ArenaPool> arena_pool;
 
   grpc_core::ManualConstructor<std::string> target;
 };
@@ -21,6 +21,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <map>
 
 #if COCOAPODS==1
@@ -71,6 +72,11 @@ class SslSessionLRUCache : public grpc_core::RefCounted<SslSessionLRUCache> {
   /// Returns the session from the cache associated with \a key or null if not
   /// found.
   SslSessionPtr Get(const char* key);
+  /// Returns how many calls to Get() found a session, and how many didn't.
+  void GetStats(uint64_t* hits, uint64_t* misses) const {
+    *hits = hits_.load(std::memory_order_relaxed);
+    *misses = misses_.load(std::memory_order_relaxed);
+  }
 
  private:
   class Node;
@@ -87,6 +93,9 @@ class SslSessionLRUCache : public grpc_core::RefCounted<SslSessionLRUCache> {
   Node* use_order_list_tail_ = nullptr;
   size_t use_order_list_size_ = 0;
   std::map<std::string, Node*> entry_by_key_;
+
+  std::atomic<uint64_t> hits_{0};
+  std::atomic<uint64_t> misses_{0};
 };
 
 }  // namespace tsi
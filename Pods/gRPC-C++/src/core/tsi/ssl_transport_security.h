@@ -79,6 +79,30 @@ void tsi_ssl_session_cache_ref(tsi_ssl_session_cache* cache);
 /* Decrement reference counter of \a cache.  */
 void tsi_ssl_session_cache_unref(tsi_ssl_session_cache* cache);
 
+/* Get how many session lookups in \a cache found a session (\a hits) and
+   how many didn't (\a misses).  */
+void tsi_ssl_session_cache_get_stats(tsi_ssl_session_cache* cache,
+                                     uint64_t* hits, uint64_t* misses);
+
+/* --- tsi_ssl_protection_stats object ---
+
+   Totals over all SSL frame protectors of the process. Each connection adds
+   its counters in batches of records and when it is destroyed, so the totals
+   lag the live connections by up to a batch each.  */
+typedef struct {
+  uint64_t connections;
+  uint64_t records_protected;
+  uint64_t records_unprotected;
+  uint64_t bytes_protected;
+  uint64_t bytes_unprotected;
+  uint64_t protect_ns;
+  uint64_t unprotect_ns;
+  uint64_t key_updates;
+} tsi_ssl_protection_stats;
+
+/* Get the process-wide protection totals.  */
+void tsi_ssl_get_protection_stats(tsi_ssl_protection_stats* stats);
+
 /* --- tsi_ssl_client_handshaker_factory object ---
 
    This object creates a client tsi_handshaker objects implemented in terms of
@@ -167,6 +191,13 @@ struct tsi_ssl_client_handshaker_options {
      > 1.1 is supported for CRL checking*/
   const char* crl_directory;
 
+  /* Send data in the first flight of TLS 1.3 resumptions (0-RTT), with
+     BoringSSL. Such early data can be replayed by the network, so this must
+     only be set when everything sent before the handshake completes is safe
+     to process more than once. If the server rejects it, the connection fails
+     and the session is kept in session_cache without its 0-RTT ability. */
+  bool enable_early_data;
+
   tsi_ssl_client_handshaker_options()
       : pem_key_cert_pair(nullptr),
         pem_root_certs(nullptr),
@@ -178,7 +209,8 @@ struct tsi_ssl_client_handshaker_options {
         skip_server_certificate_verification(false),
         min_tls_version(tsi_tls_version::TSI_TLS1_2),
         max_tls_version(tsi_tls_version::TSI_TLS1_3),
-        crl_directory(nullptr) {}
+        crl_directory(nullptr),
+        enable_early_data(false) {}
 };
 
 /* Creates a client handshaker factory.
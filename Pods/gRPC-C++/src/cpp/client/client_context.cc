@@ -169,6 +169,10 @@ std::string ClientContext::peer() const {
   return peer;
 }
 
+bool ClientContext::GetRpcTimeline(grpc_rpc_timeline* timeline) const {
+  return call_ != nullptr && grpc_call_get_rpc_timeline(call_, timeline) != 0;
+}
+
 void ClientContext::SetGlobalCallbacks(GlobalCallbacks* client_callbacks) {
   GPR_ASSERT(g_client_callbacks == g_default_client_callbacks);
   GPR_ASSERT(client_callbacks != nullptr);
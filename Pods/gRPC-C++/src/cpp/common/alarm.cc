@@ -17,6 +17,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <algorithm>
 #include <memory>
 
 #include <grpc/support/log.h>
@@ -26,6 +27,7 @@
 #include <grpcpp/support/time.h>
 
 #include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/timer.h"
@@ -41,14 +43,65 @@ class AlarmImpl : public ::grpc::internal::CompletionQueueTag {
     grpc_timer_init_unset(&timer_);
   }
   ~AlarmImpl() override {}
-  bool FinalizeResult(void** tag, bool* /*status*/) override {
+  bool FinalizeResult(void** tag, bool* status) override {
     *tag = tag_;
+    if (period_ > 0) {
+      // A recurring alarm is armed again only once its tag is delivered, so
+      // that completion_ is never queued twice.
+      if (*status) {
+        grpc_core::ExecCtx exec_ctx;
+        Rearm();
+      } else {
+        cq_ = nullptr;
+      }
+    }
     Unref();
     return true;
   }
   void Set(::grpc::CompletionQueue* cq, gpr_timespec deadline, void* tag) {
     grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
     grpc_core::ExecCtx exec_ctx;
+    Arm(cq, deadline, tag);
+  }
+  // Like Set() but expects the caller to provide the ExecCtx, so that a batch
+  // of alarms shares one.
+  void Arm(::grpc::CompletionQueue* cq, gpr_timespec deadline, void* tag) {
+    period_ = 0;
+    StartCq(cq, grpc_timespec_to_millis_round_up(deadline), tag);
+  }
+  void SetRecurring(::grpc::CompletionQueue* cq, int64_t period_ms,
+                    void* tag) {
+    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+    grpc_core::ExecCtx exec_ctx;
+    period_ = std::max<grpc_millis>(period_ms, 1);
+    StartCq(cq, grpc_core::ExecCtx::Get()->Now() + period_, tag);
+  }
+  void Set(gpr_timespec deadline, std::function<void(bool)> f) {
+    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+    grpc_core::ExecCtx exec_ctx;
+    period_ = 0;
+    StartCallback(grpc_timespec_to_millis_round_up(deadline), std::move(f));
+  }
+  void SetRecurring(int64_t period_ms, std::function<void(bool)> f) {
+    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+    grpc_core::ExecCtx exec_ctx;
+    period_ = std::max<grpc_millis>(period_ms, 1);
+    StartCallback(grpc_core::ExecCtx::Get()->Now() + period_, std::move(f));
+  }
+  void Cancel() {
+    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+    grpc_core::ExecCtx exec_ctx;
+    grpc_core::MutexLock lock(&mu_);
+    cancelled_ = true;
+    grpc_timer_cancel(&timer_);
+  }
+  void Destroy() {
+    Cancel();
+    Unref();
+  }
+
+ private:
+  void StartCq(::grpc::CompletionQueue* cq, grpc_millis deadline, void* tag) {
     GRPC_CQ_INTERNAL_REF(cq->cq(), "alarm");
     cq_ = cq->cq();
     tag_ = tag;
@@ -60,9 +113,10 @@ class AlarmImpl : public ::grpc::internal::CompletionQueueTag {
           AlarmImpl* alarm = static_cast<AlarmImpl*>(arg);
           alarm->Ref();
           // Preserve the cq and reset the cq_ so that the alarm
-          // can be reset when the alarm tag is delivered.
+          // can be reset when the alarm tag is delivered. A recurring
+          // alarm keeps it to arm itself again from FinalizeResult.
           grpc_completion_queue* cq = alarm->cq_;
-          alarm->cq_ = nullptr;
+          if (alarm->period_ == 0) alarm->cq_ = nullptr;
           grpc_cq_end_op(
               cq, alarm, error,
               [](void* /*arg*/, grpc_cq_completion* /*completion*/) {}, arg,
@@ -70,43 +124,68 @@ class AlarmImpl : public ::grpc::internal::CompletionQueueTag {
           GRPC_CQ_INTERNAL_UNREF(cq, "alarm");
         },
         this, grpc_schedule_on_exec_ctx);
-    grpc_timer_init(&timer_, grpc_timespec_to_millis_round_up(deadline),
-                    &on_alarm_);
+    StartTimer(deadline);
   }
-  void Set(gpr_timespec deadline, std::function<void(bool)> f) {
-    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
-    grpc_core::ExecCtx exec_ctx;
+
+  void StartCallback(grpc_millis deadline, std::function<void(bool)> f) {
     // Don't use any CQ at all. Instead just use the timer to fire the function
     callback_ = std::move(f);
     Ref();
     GRPC_CLOSURE_INIT(
         &on_alarm_,
         [](void* arg, grpc_error_handle error) {
-          grpc_core::Executor::Run(
-              GRPC_CLOSURE_CREATE(
-                  [](void* arg, grpc_error_handle error) {
-                    AlarmImpl* alarm = static_cast<AlarmImpl*>(arg);
-                    alarm->callback_(error == GRPC_ERROR_NONE);
-                    alarm->Unref();
-                  },
-                  arg, nullptr),
-              error);
+          AlarmImpl* alarm = static_cast<AlarmImpl*>(arg);
+          grpc_core::Executor::Run(&alarm->on_callback_, error);
         },
         this, grpc_schedule_on_exec_ctx);
-    grpc_timer_init(&timer_, grpc_timespec_to_millis_round_up(deadline),
-                    &on_alarm_);
+    GRPC_CLOSURE_INIT(
+        &on_callback_,
+        [](void* arg, grpc_error_handle error) {
+          AlarmImpl* alarm = static_cast<AlarmImpl*>(arg);
+          bool ok = error == GRPC_ERROR_NONE;
+          alarm->callback_(ok);
+          if (ok && alarm->period_ > 0) {
+            // Keep the ref taken in StartCallback for the next firing.
+            alarm->Rearm();
+            return;
+          }
+          alarm->Unref();
+        },
+        this, nullptr);
+    StartTimer(deadline);
   }
-  void Cancel() {
-    grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
-    grpc_core::ExecCtx exec_ctx;
-    grpc_timer_cancel(&timer_);
+
+  void StartTimer(grpc_millis deadline) {
+    grpc_core::MutexLock lock(&mu_);
+    cancelled_ = false;
+    deadline_ = deadline;
+    grpc_timer_init(&timer_, deadline_, &on_alarm_);
   }
-  void Destroy() {
-    Cancel();
-    Unref();
+
+  // Arms a recurring alarm for its next period. The next deadline follows
+  // from the previous one, not from now, so that firings do not drift. If
+  // the alarm was cancelled while no timer was pending, it completes with
+  // ok=false right away, as it would have from grpc_timer_cancel().
+  void Rearm() {
+    if (cq_ != nullptr) {
+      GRPC_CQ_INTERNAL_REF(cq_, "alarm");
+      if (!grpc_cq_begin_op(cq_, this)) {
+        // The completion queue is shutting down.
+        GRPC_CQ_INTERNAL_UNREF(cq_, "alarm");
+        cq_ = nullptr;
+        return;
+      }
+    }
+    grpc_core::MutexLock lock(&mu_);
+    if (cancelled_) {
+      grpc_core::ExecCtx::Run(DEBUG_LOCATION, &on_alarm_,
+                              GRPC_ERROR_CANCELLED);
+      return;
+    }
+    deadline_ += period_;
+    grpc_timer_init(&timer_, deadline_, &on_alarm_);
   }
 
- private:
   void Ref() { gpr_ref(&refs_); }
   void Unref() {
     if (gpr_unref(&refs_)) {
@@ -117,11 +196,18 @@ class AlarmImpl : public ::grpc::internal::CompletionQueueTag {
   grpc_timer timer_;
   gpr_refcount refs_;
   grpc_closure on_alarm_;
+  grpc_closure on_callback_;
   grpc_cq_completion completion_;
   // completion queue where events about this alarm will be posted
   grpc_completion_queue* cq_;
   void* tag_;
   std::function<void(bool)> callback_;
+  // Non-zero for a recurring alarm.
+  grpc_millis period_ = 0;
+  // Guards arming the timer against Cancel().
+  grpc_core::Mutex mu_;
+  bool cancelled_ ABSL_GUARDED_BY(mu_) = false;
+  grpc_millis deadline_ ABSL_GUARDED_BY(mu_) = 0;
 };
 }  // namespace internal
 
@@ -156,5 +242,30 @@ Alarm::~Alarm() {
   }
 }
 
+void Alarm::SetRecurringInternal(::grpc::CompletionQueue* cq,
+                                 int64_t period_ms, void* tag) {
+  static_cast<internal::AlarmImpl*>(alarm_)->SetRecurring(cq, period_ms, tag);
+}
+
+void Alarm::SetRecurringInternal(int64_t period_ms,
+                                 std::function<void(bool)> f) {
+  static_cast<internal::AlarmImpl*>(alarm_)->SetRecurring(period_ms,
+                                                          std::move(f));
+}
+
 void Alarm::Cancel() { static_cast<internal::AlarmImpl*>(alarm_)->Cancel(); }
+
+namespace experimental {
+
+void AlarmBatch::Commit() {
+  grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+  grpc_core::ExecCtx exec_ctx;
+  for (const Entry& entry : entries_) {
+    static_cast<internal::AlarmImpl*>(entry.alarm->alarm_)
+        ->Arm(cq_, entry.deadline, entry.tag);
+  }
+  entries_.clear();
+}
+
+}  // namespace experimental
 }  // namespace grpc
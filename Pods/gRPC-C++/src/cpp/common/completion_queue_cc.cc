@@ -15,6 +15,7 @@
  *
  */
 
+#include <algorithm>
 #include <memory>
 
 #include <grpc/grpc.h>
@@ -162,6 +163,35 @@ CompletionQueue::NextStatus CompletionQueue::AsyncNextInternal(
   }
 }
 
+size_t CompletionQueue::AsyncNextBatchInternal(Event* events,
+                                               size_t max_events,
+                                               gpr_timespec deadline) {
+  // Events are read from the core queue through a buffer of this many
+  static constexpr size_t kMaxCoreBatch = 64;
+  grpc_event core_events[kMaxCoreBatch];
+  GPR_ASSERT(max_events > 0);
+  for (;;) {
+    size_t num_core_events = grpc_completion_queue_next_batch(
+        cq_, core_events, std::min(max_events, kMaxCoreBatch), deadline,
+        nullptr);
+    size_t num_events = 0;
+    for (size_t i = 0; i < num_core_events; i++) {
+      // Timeouts and shutdowns only ever come alone
+      if (core_events[i].type != GRPC_OP_COMPLETE) return 0;
+      auto core_cq_tag =
+          static_cast<::grpc::internal::CompletionQueueTag*>(
+              core_events[i].tag);
+      void* tag = core_cq_tag;
+      bool ok = core_events[i].success != 0;
+      if (core_cq_tag->FinalizeResult(&tag, &ok)) {
+        events[num_events++] = Event{tag, ok};
+      }
+    }
+    // Every event may have been internal to the library: then keep going
+    if (num_events > 0) return num_events;
+  }
+}
+
 CompletionQueue::CompletionQueueTLSCache::CompletionQueueTLSCache(
     CompletionQueue* cq)
     : cq_(cq), flushed_(false) {
@@ -0,0 +1,163 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include <string.h>
+
+#include <algorithm>
+#include <random>
+
+#include <grpc/grpc.h>
+#include <grpcpp/support/rpc_trace.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+
+namespace grpc {
+namespace experimental {
+
+namespace {
+
+// Timelines taken from the core per grpc_rpc_timeline_collect() call
+constexpr size_t kTimelinesPerCollect = 64;
+
+// The child span that ends with each grpc_rpc_timeline_event
+const char* const kPhaseNames[GRPC_RPC_TIMELINE_EVENT_COUNT] = {
+    "grpc.resolve",          "grpc.pick",
+    "grpc.send_headers",     "grpc.wait_response",
+    "grpc.receive_message",  "grpc.receive_trailers",
+    "grpc.dispatch",
+};
+
+void FillId(std::mt19937_64* rng, uint8_t* id, size_t size) {
+  for (size_t i = 0; i < size; i += sizeof(uint64_t)) {
+    uint64_t bits = (*rng)();
+    memcpy(id + i, &bits, std::min(sizeof(bits), size - i));
+  }
+}
+
+void AppendSpans(const grpc_rpc_timeline& timeline, std::mt19937_64* rng,
+                 std::vector<RpcTraceSpan>* spans) {
+  RpcTraceSpan root;
+  root.name = "grpc.call";
+  FillId(rng, root.trace_id, sizeof(root.trace_id));
+  FillId(rng, root.span_id, sizeof(root.span_id));
+  memset(root.parent_span_id, 0, sizeof(root.parent_span_id));
+  root.start_time_unix_nano = timeline.start_unix_ns;
+  const size_t root_index = spans->size();
+  spans->push_back(root);
+  // Events of a retried call may not be in order: a phase that ended before
+  // the previous one is given no length rather than a negative one.
+  int64_t phase_start_ns = 0;
+  for (int i = 0; i < GRPC_RPC_TIMELINE_EVENT_COUNT; ++i) {
+    if (timeline.elapsed_ns[i] < 0) continue;
+    const int64_t phase_end_ns =
+        std::max(phase_start_ns, timeline.elapsed_ns[i]);
+    RpcTraceSpan child;
+    child.name = kPhaseNames[i];
+    memcpy(child.trace_id, root.trace_id, sizeof(child.trace_id));
+    FillId(rng, child.span_id, sizeof(child.span_id));
+    memcpy(child.parent_span_id, root.span_id, sizeof(child.parent_span_id));
+    child.start_time_unix_nano = timeline.start_unix_ns + phase_start_ns;
+    child.end_time_unix_nano = timeline.start_unix_ns + phase_end_ns;
+    spans->push_back(child);
+    phase_start_ns = phase_end_ns;
+  }
+  (*spans)[root_index].end_time_unix_nano =
+      timeline.start_unix_ns + phase_start_ns;
+}
+
+class ExportThread {
+ public:
+  ExportThread(std::shared_ptr<RpcTraceExporter> exporter,
+               std::chrono::milliseconds interval)
+      : exporter_(std::move(exporter)),
+        interval_(absl::Milliseconds(interval.count())),
+        thd_("grpcpp_rpc_trace_export", Run, this) {
+    thd_.Start();
+  }
+
+  ~ExportThread() {
+    {
+      grpc_core::MutexLock lock(&mu_);
+      shutdown_ = true;
+      cv_.Signal();
+    }
+    thd_.Join();
+  }
+
+ private:
+  static void Run(void* arg) {
+    ExportThread* self = static_cast<ExportThread*>(arg);
+    std::vector<RpcTraceSpan> spans;
+    bool shutdown = false;
+    while (!shutdown) {
+      {
+        grpc_core::MutexLock lock(&self->mu_);
+        if (!self->shutdown_) {
+          self->cv_.WaitWithTimeout(&self->mu_, self->interval_);
+        }
+        shutdown = self->shutdown_;
+      }
+      spans.clear();
+      CollectRpcTraceSpans(&spans);
+      if (!spans.empty()) self->exporter_->Export(spans);
+    }
+  }
+
+  const std::shared_ptr<RpcTraceExporter> exporter_;
+  const absl::Duration interval_;
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar cv_;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  grpc_core::Thread thd_;
+};
+
+grpc_core::Mutex* g_export_mu = new grpc_core::Mutex();
+ExportThread* g_export_thread ABSL_GUARDED_BY(g_export_mu) = nullptr;
+
+}  // namespace
+
+void CollectRpcTraceSpans(std::vector<RpcTraceSpan>* spans) {
+  std::mt19937_64 rng{std::random_device()()};
+  grpc_rpc_timeline timelines[kTimelinesPerCollect];
+  size_t count;
+  do {
+    count = grpc_rpc_timeline_collect(timelines, kTimelinesPerCollect);
+    for (size_t i = 0; i < count; ++i) {
+      AppendSpans(timelines[i], &rng, spans);
+    }
+  } while (count == kTimelinesPerCollect);
+}
+
+void StartRpcTraceExport(std::shared_ptr<RpcTraceExporter> exporter,
+                         std::chrono::milliseconds interval) {
+  grpc_core::MutexLock lock(g_export_mu);
+  delete g_export_thread;
+  g_export_thread = new ExportThread(std::move(exporter), interval);
+}
+
+void StopRpcTraceExport() {
+  grpc_core::MutexLock lock(g_export_mu);
+  delete g_export_thread;
+  g_export_thread = nullptr;
+}
+
+}  // namespace experimental
+}  // namespace grpc
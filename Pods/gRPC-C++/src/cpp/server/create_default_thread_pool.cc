@@ -16,18 +16,32 @@
  *
  */
 
+#include <string.h>
+
 #include <grpc/support/cpu.h>
 
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/cpp/server/dynamic_thread_pool.h"
+#include "src/cpp/server/work_stealing_thread_pool.h"
 
 #ifndef GRPC_CUSTOM_DEFAULT_THREAD_POOL
 
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_cpp_thread_pool, "dynamic",
+    "The default thread pool of the C++ library: \"dynamic\", which adds "
+    "threads when all are busy, or \"work_stealing\", which keeps one queue "
+    "per thread and suits callbacks that do not block.")
+
 namespace grpc {
 namespace {
 
 ThreadPoolInterface* CreateDefaultThreadPoolImpl() {
   int cores = gpr_cpu_num_cores();
   if (!cores) cores = 4;
+  grpc_core::UniquePtr<char> pool = GPR_GLOBAL_CONFIG_GET(grpc_cpp_thread_pool);
+  if (strcmp(pool.get(), "work_stealing") == 0) {
+    return new WorkStealingThreadPool(cores);
+  }
   return new DynamicThreadPool(cores);
 }
 
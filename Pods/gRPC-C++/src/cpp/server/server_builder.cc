@@ -30,6 +30,7 @@
 #include "src/core/lib/gpr/useful.h"
 #include "src/cpp/server/external_connection_acceptor_impl.h"
 #include "src/cpp/server/thread_pool_interface.h"
+#include "src/cpp/thread_manager/thread_manager.h"
 
 namespace grpc {
 
@@ -160,6 +161,21 @@ ServerBuilder& ServerBuilder::SetSyncServerOption(
     case CQ_TIMEOUT_MSEC:
       sync_server_settings_.cq_timeout_msec = val;
       break;
+    case AUTOSCALE_TARGET_LATENCY_MSEC:
+      sync_server_settings_.autoscale_target_latency_msec = val;
+      break;
+    case AUTOSCALE_MAX_THREAD_CREATIONS_PER_SEC:
+      sync_server_settings_.autoscale_max_thread_creations_per_sec = val;
+      break;
+    case AUTOSCALE_MAX_CPU_PERCENT:
+      sync_server_settings_.autoscale_max_cpu_percent = val;
+      break;
+    case SHED_QUEUE_TIME_MSEC:
+      sync_server_settings_.shed_queue_time_msec = val;
+      break;
+    case SHED_CPU_PERCENT:
+      sync_server_settings_.shed_cpu_percent = val;
+      break;
   }
   return *this;
 }
@@ -330,6 +346,33 @@ std::unique_ptr<grpc::Server> ServerBuilder::BuildAndStart() {
             sync_server_settings_.num_cqs, sync_server_settings_.min_pollers,
             sync_server_settings_.max_pollers,
             sync_server_settings_.cq_timeout_msec);
+    if (sync_server_settings_.autoscale_target_latency_msec > 0) {
+      gpr_log(GPR_INFO,
+              "Sync server autoscaling. Target latency (msec): %d, Max thread "
+              "creations/sec: %d, Max CPU: %d%%",
+              sync_server_settings_.autoscale_target_latency_msec,
+              sync_server_settings_.autoscale_max_thread_creations_per_sec,
+              sync_server_settings_.autoscale_max_cpu_percent);
+      args.SetInt(GRPC_ARG_SYNC_SERVER_AUTOSCALE_TARGET_LATENCY_MS,
+                  sync_server_settings_.autoscale_target_latency_msec);
+      args.SetInt(
+          GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CREATION_RATE,
+          sync_server_settings_.autoscale_max_thread_creations_per_sec);
+      args.SetInt(GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CPU_PERCENT,
+                  sync_server_settings_.autoscale_max_cpu_percent);
+    }
+    if (sync_server_settings_.shed_queue_time_msec > 0 ||
+        sync_server_settings_.shed_cpu_percent > 0) {
+      gpr_log(GPR_INFO,
+              "Sync server load shedding. Max queue time (msec): %d, Max "
+              "CPU: %d%%",
+              sync_server_settings_.shed_queue_time_msec,
+              sync_server_settings_.shed_cpu_percent);
+      args.SetInt(GRPC_ARG_SYNC_SERVER_SHED_QUEUE_TIME_MS,
+                  sync_server_settings_.shed_queue_time_msec);
+      args.SetInt(GRPC_ARG_SYNC_SERVER_SHED_CPU_PERCENT,
+                  sync_server_settings_.shed_cpu_percent);
+    }
   }
 
   if (has_callback_methods) {
@@ -20,10 +20,27 @@
 #include "src/core/lib/iomgr/closure.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/executor.h"
+#include "src/core/lib/surface/call.h"
 
 namespace grpc {
 namespace internal {
 
+namespace {
+
+// Allocates a closure for an executor hop on the call's arena, so that
+// dispatching OnDone or OnCancel does not allocate per call. The closure
+// is freed with the call, so its callback must be done with it before it
+// can release the call.
+template <typename Closure, typename... Args>
+Closure* NewClosure(grpc_call* call, ServerCallbackCall* callback_call,
+                    Args... args) {
+  if (call == nullptr) return new Closure(callback_call, false, args...);
+  return new (grpc_call_arena_alloc(call, sizeof(Closure)))
+      Closure(callback_call, true, args...);
+}
+
+}  // namespace
+
 void ServerCallbackCall::ScheduleOnDone(bool inline_ondone) {
   if (inline_ondone) {
     CallOnDone();
@@ -34,18 +51,24 @@ void ServerCallbackCall::ScheduleOnDone(bool inline_ondone) {
     struct ClosureWithArg {
       grpc_closure closure;
       ServerCallbackCall* call;
-      explicit ClosureWithArg(ServerCallbackCall* call_arg) : call(call_arg) {
+      bool on_arena;
+      ClosureWithArg(ServerCallbackCall* call_arg, bool on_arena_arg)
+          : call(call_arg), on_arena(on_arena_arg) {
         GRPC_CLOSURE_INIT(
             &closure,
             [](void* void_arg, grpc_error_handle) {
               ClosureWithArg* arg = static_cast<ClosureWithArg*>(void_arg);
-              arg->call->CallOnDone();
-              delete arg;
+              // CallOnDone releases the call and with it the arena, so
+              // nothing in arg may be used after it.
+              const bool on_arena = arg->on_arena;
+              ServerCallbackCall* call = arg->call;
+              if (!on_arena) delete arg;
+              call->CallOnDone();
             },
             this, grpc_schedule_on_exec_ctx);
       }
     };
-    ClosureWithArg* arg = new ClosureWithArg(this);
+    ClosureWithArg* arg = NewClosure<ClosureWithArg>(core_call(), this);
     grpc_core::Executor::Run(&arg->closure, GRPC_ERROR_NONE);
   }
 }
@@ -61,21 +84,26 @@ void ServerCallbackCall::CallOnCancel(ServerReactor* reactor) {
     struct ClosureWithArg {
       grpc_closure closure;
       ServerCallbackCall* call;
+      bool on_arena;
       ServerReactor* reactor;
-      ClosureWithArg(ServerCallbackCall* call_arg, ServerReactor* reactor_arg)
-          : call(call_arg), reactor(reactor_arg) {
+      ClosureWithArg(ServerCallbackCall* call_arg, bool on_arena_arg,
+                     ServerReactor* reactor_arg)
+          : call(call_arg), on_arena(on_arena_arg), reactor(reactor_arg) {
         GRPC_CLOSURE_INIT(
             &closure,
             [](void* void_arg, grpc_error_handle) {
               ClosureWithArg* arg = static_cast<ClosureWithArg*>(void_arg);
+              ServerCallbackCall* call = arg->call;
               arg->reactor->OnCancel();
-              arg->call->MaybeDone();
-              delete arg;
+              // MaybeDone may release the call and with it the arena.
+              if (!arg->on_arena) delete arg;
+              call->MaybeDone();
             },
             this, grpc_schedule_on_exec_ctx);
       }
     };
-    ClosureWithArg* arg = new ClosureWithArg(this, reactor);
+    ClosureWithArg* arg =
+        NewClosure<ClosureWithArg>(core_call(), this, reactor);
     grpc_core::Executor::Run(&arg->closure, GRPC_ERROR_NONE);
   }
 }
@@ -15,6 +15,7 @@
  *
  */
 
+#include <climits>
 #include <cstdlib>
 #include <sstream>
 #include <type_traits>
@@ -44,6 +45,7 @@
 #include <grpcpp/support/time.h>
 
 #include "src/core/ext/transport/inproc/inproc_transport.h"
+#include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/iomgr.h"
@@ -70,6 +72,9 @@ namespace {
 // because the server threadpool is full.
 const char* kServerThreadpoolExhausted = "Server Threadpool Exhausted";
 
+// The status message of sync requests shed because the server is overloaded.
+const char* kServerOverloaded = "Server Overloaded";
+
 // Although we might like to give a useful status error message on unimplemented
 // RPCs, it's not always possible since that also would need to be added across
 // languages and isn't actually required by the spec.
@@ -380,8 +385,9 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
     return true;
   }
 
+  // Runs the method's handler, or error_handler instead if it is not null.
   void Run(const std::shared_ptr<GlobalCallbacks>& global_callbacks,
-           bool resources) {
+           grpc::internal::MethodHandler* error_handler) {
     ctx_.Init(deadline_, &request_metadata_);
     wrapped_call_.Init(
         call_, server_, &cq_, server_->max_receive_message_size(),
@@ -392,7 +398,7 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
     request_metadata_.count = 0;
 
     global_callbacks_ = global_callbacks;
-    resources_ = resources;
+    error_handler_ = error_handler;
 
     interceptor_methods_.SetCall(&*wrapped_call_);
     interceptor_methods_.SetReverse();
@@ -403,8 +409,8 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
 
     if (has_request_payload_) {
       // Set interception point for RECV MESSAGE
-      auto* handler = resources_ ? method_->handler()
-                                 : server_->resource_exhausted_handler_.get();
+      auto* handler =
+          error_handler_ != nullptr ? error_handler_ : method_->handler();
       deserialized_request_ = handler->Deserialize(call_, request_payload_,
                                                    &request_status_, nullptr);
       if (!request_status_.ok()) {
@@ -428,8 +434,8 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
   void ContinueRunAfterInterception() {
     ctx_->ctx.BeginCompletionOp(&*wrapped_call_, nullptr, nullptr);
     global_callbacks_->PreSynchronousRequest(&ctx_->ctx);
-    auto* handler = resources_ ? method_->handler()
-                               : server_->resource_exhausted_handler_.get();
+    auto* handler =
+        error_handler_ != nullptr ? error_handler_ : method_->handler();
     handler->RunHandler(grpc::internal::MethodHandler::HandlerParameter(
         &*wrapped_call_, &ctx_->ctx, deserialized_request_, request_status_,
         nullptr, nullptr));
@@ -451,6 +457,9 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
     delete this;
   }
 
+  // How long ago the call arrived.
+  gpr_timespec age() const { return grpc_call_get_age(call_); }
+
   // For requests that must be only cleaned up but not actually Run
   void Cleanup() {
     cq_.Shutdown();
@@ -489,7 +498,7 @@ class Server::SyncRequest final : public grpc::internal::CompletionQueueTag {
   grpc::CompletionQueue cq_;
   grpc::Status request_status_;
   std::shared_ptr<GlobalCallbacks> global_callbacks_;
-  bool resources_;
+  grpc::internal::MethodHandler* error_handler_ = nullptr;
   void* deserialized_request_ = nullptr;
   grpc::internal::InterceptorBatchMethodsImpl interceptor_methods_;
 
@@ -748,15 +757,42 @@ const char* Server::CallbackRequest<
 // appropriate RPC handlers
 class Server::SyncRequestThreadManager : public grpc::ThreadManager {
  public:
+  // Requests are failed with RESOURCE_EXHAUSTED instead of being handled
+  // once they have waited longer than max_queue_time_msec since they
+  // arrived, or while the process uses more than max_cpu_percent of the
+  // machine's CPUs. 0 disables either check.
+  struct LoadSheddingOptions {
+    int max_queue_time_msec = 0;
+    int max_cpu_percent = 0;
+
+    static LoadSheddingOptions FromChannelArgs(const grpc_channel_args* args) {
+      LoadSheddingOptions options;
+      options.max_queue_time_msec = grpc_channel_args_find_integer(
+          args, GRPC_ARG_SYNC_SERVER_SHED_QUEUE_TIME_MS, {0, 0, INT_MAX});
+      options.max_cpu_percent = grpc_channel_args_find_integer(
+          args, GRPC_ARG_SYNC_SERVER_SHED_CPU_PERCENT, {0, 0, INT_MAX});
+      return options;
+    }
+  };
+
   SyncRequestThreadManager(Server* server, grpc::CompletionQueue* server_cq,
                            std::shared_ptr<GlobalCallbacks> global_callbacks,
                            grpc_resource_quota* rq, int min_pollers,
-                           int max_pollers, int cq_timeout_msec)
-      : ThreadManager("SyncServer", rq, min_pollers, max_pollers),
+                           int max_pollers, int cq_timeout_msec,
+                           const AutoscaleOptions& autoscale,
+                           const LoadSheddingOptions& shedding)
+      : ThreadManager("SyncServer", rq, min_pollers, max_pollers, autoscale),
         server_(server),
         server_cq_(server_cq),
         cq_timeout_msec_(cq_timeout_msec),
-        global_callbacks_(std::move(global_callbacks)) {}
+        shedding_(shedding),
+        global_callbacks_(std::move(global_callbacks)) {
+    if (shedding_.max_queue_time_msec > 0 || shedding_.max_cpu_percent > 0) {
+      overloaded_handler_ =
+          absl::make_unique<grpc::internal::ResourceExhaustedHandler>(
+              kServerOverloaded);
+    }
+  }
 
   WorkStatus PollForWork(void** tag, bool* ok) override {
     *tag = nullptr;
@@ -788,7 +824,13 @@ class Server::SyncRequestThreadManager : public grpc::ThreadManager {
     GPR_DEBUG_ASSERT(ok);
 
     GPR_TIMER_SCOPE("sync_req->Run()", 0);
-    sync_req->Run(global_callbacks_, resources);
+    grpc::internal::MethodHandler* error_handler = nullptr;
+    if (!resources) {
+      error_handler = server_->resource_exhausted_handler_.get();
+    } else if (ShouldShed(sync_req)) {
+      error_handler = overloaded_handler_.get();
+    }
+    sync_req->Run(global_callbacks_, error_handler);
   }
 
   void AddSyncMethod(grpc::internal::RpcServiceMethod* method, void* tag) {
@@ -839,9 +881,24 @@ class Server::SyncRequestThreadManager : public grpc::ThreadManager {
   }
 
  private:
+  // Checked before dispatching, so that an overloaded server fails requests
+  // right away rather than handling ones whose clients are about to give up
+  // on them.
+  bool ShouldShed(SyncRequest* sync_req) {
+    if (overloaded_handler_ == nullptr) return false;
+    if (shedding_.max_queue_time_msec > 0 &&
+        gpr_time_to_millis(sync_req->age()) > shedding_.max_queue_time_msec) {
+      return true;
+    }
+    return shedding_.max_cpu_percent > 0 &&
+           GetCpuPercent() > shedding_.max_cpu_percent;
+  }
+
   Server* server_;
   grpc::CompletionQueue* server_cq_;
   int cq_timeout_msec_;
+  const LoadSheddingOptions shedding_;
+  std::unique_ptr<grpc::internal::MethodHandler> overloaded_handler_;
   bool has_sync_method_ = false;
   std::unique_ptr<grpc::internal::RpcServiceMethod> unknown_method_;
   std::shared_ptr<Server::GlobalCallbacks> global_callbacks_;
@@ -884,10 +941,17 @@ Server::Server(
       default_rq_created = true;
     }
 
+    grpc_channel_args sync_args;
+    args->SetChannelArgs(&sync_args);
+    const auto autoscale =
+        grpc::ThreadManager::AutoscaleOptions::FromChannelArgs(&sync_args);
+    const auto shedding =
+        SyncRequestThreadManager::LoadSheddingOptions::FromChannelArgs(
+            &sync_args);
     for (const auto& it : *sync_server_cqs_) {
       sync_req_mgrs_.emplace_back(new SyncRequestThreadManager(
           this, it.get(), global_callbacks_, server_rq, min_pollers,
-          max_pollers, sync_cq_timeout_msec));
+          max_pollers, sync_cq_timeout_msec, autoscale, shedding));
     }
 
     if (default_rq_created) {
@@ -0,0 +1,148 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include "src/cpp/server/work_stealing_thread_pool.h"
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/tls.h"
+
+namespace grpc {
+
+namespace {
+// The worker running on this thread, if it is a pool thread.
+GPR_THREAD_LOCAL(void*) g_current_worker;
+}  // namespace
+
+constexpr size_t WorkStealingThreadPool::WorkQueue::kCapacity;
+
+bool WorkStealingThreadPool::WorkQueue::Push(
+    const std::function<void()>& callback) {
+  grpc_core::MutexLock lock(&mu_);
+  if (size_ == kCapacity) return false;
+  slots_[(head_ + size_) % kCapacity] = callback;
+  ++size_;
+  return true;
+}
+
+bool WorkStealingThreadPool::WorkQueue::Take(std::function<void()>* callback) {
+  grpc_core::MutexLock lock(&mu_);
+  if (size_ == 0) return false;
+  // Swap rather than move so the slot keeps no reference to the callback's
+  // captures and later reuse does not have to free them under the lock.
+  callback->swap(slots_[head_]);
+  head_ = (head_ + 1) % kCapacity;
+  --size_;
+  return true;
+}
+
+WorkStealingThreadPool::WorkStealingThreadPool(int num_threads) {
+  GPR_ASSERT(num_threads > 0);
+  workers_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    workers_.emplace_back(new Worker);
+    workers_.back()->pool = this;
+    workers_.back()->index = i;
+  }
+  // Start the threads only once every queue exists, since any of them may
+  // be stolen from.
+  for (auto& worker : workers_) {
+    worker->thread =
+        grpc_core::Thread("grpcpp_work_stealing_pool", ThreadFunc, worker.get());
+    worker->thread.Start();
+  }
+}
+
+WorkStealingThreadPool::~WorkStealingThreadPool() {
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+    cv_.SignalAll();
+  }
+  // The threads run whatever is still queued before they exit.
+  for (auto& worker : workers_) {
+    worker->thread.Join();
+  }
+}
+
+void WorkStealingThreadPool::Add(const std::function<void()>& callback) {
+  Worker* current = static_cast<Worker*>(g_current_worker);
+  Worker* target;
+  if (current != nullptr && current->pool == this) {
+    target = current;
+  } else {
+    target = workers_[next_queue_.fetch_add(1, std::memory_order_relaxed) %
+                      workers_.size()]
+                 .get();
+  }
+  if (!target->queue.Push(callback)) {
+    grpc_core::MutexLock lock(&mu_);
+    overflow_.push_back(callback);
+  }
+  // Count the callback before looking for idle threads: a thread going idle
+  // counts itself before looking at pending_, so one of the two sees the
+  // other.
+  pending_.fetch_add(1);
+  if (idle_threads_.load() > 0) {
+    grpc_core::MutexLock lock(&mu_);
+    cv_.Signal();
+  }
+}
+
+bool WorkStealingThreadPool::TakeWork(Worker* worker,
+                                      std::function<void()>* callback) {
+  if (worker->queue.Take(callback)) return true;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (!overflow_.empty()) {
+      *callback = std::move(overflow_.front());
+      overflow_.pop_front();
+      return true;
+    }
+  }
+  for (size_t i = 1; i < workers_.size(); ++i) {
+    Worker* victim = workers_[(worker->index + i) % workers_.size()].get();
+    if (victim->queue.Take(callback)) return true;
+  }
+  return false;
+}
+
+void WorkStealingThreadPool::ThreadFunc(void* arg) {
+  Worker* worker = static_cast<Worker*>(arg);
+  WorkStealingThreadPool* pool = worker->pool;
+  g_current_worker = worker;
+  std::function<void()> callback;
+  for (;;) {
+    if (pool->TakeWork(worker, &callback)) {
+      pool->pending_.fetch_sub(1);
+      callback();
+      callback = nullptr;
+      continue;
+    }
+    grpc_core::MutexLock lock(&pool->mu_);
+    pool->idle_threads_.fetch_add(1);
+    while (!pool->shutdown_ && pool->pending_.load() <= 0) {
+      pool->cv_.Wait(&pool->mu_);
+    }
+    pool->idle_threads_.fetch_sub(1);
+    if (pool->shutdown_ && pool->pending_.load() <= 0) break;
+  }
+  g_current_worker = nullptr;
+}
+
+}  // namespace grpc
@@ -0,0 +1,98 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_INTERNAL_CPP_WORK_STEALING_THREAD_POOL_H
+#define GRPC_INTERNAL_CPP_WORK_STEALING_THREAD_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+#include <deque>
+#include <memory>
+#include <vector>
+
+#include <grpcpp/support/config.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/cpp/server/thread_pool_interface.h"
+
+namespace grpc {
+
+// A thread pool with a fixed number of threads, each with its own queue of
+// callbacks.  Add() spreads callbacks over the queues (a callback added from
+// one of the pool's threads goes to that thread's queue), and a thread whose
+// queue is empty takes work from the others, so callers contend on one
+// queue's lock at a time rather than on a single pool-wide one.
+//
+// Unlike DynamicThreadPool, no threads are added when all of them are busy,
+// so callbacks that block for long hold back the ones queued behind them.
+class WorkStealingThreadPool final : public ThreadPoolInterface {
+ public:
+  explicit WorkStealingThreadPool(int num_threads);
+  ~WorkStealingThreadPool() override;
+
+  void Add(const std::function<void()>& callback) override;
+
+ private:
+  // A bounded FIFO of callbacks.  The slots are allocated up front and
+  // reused, so queuing a callback only copies it into a slot.
+  class WorkQueue {
+   public:
+    // Returns false if the queue is full.
+    bool Push(const std::function<void()>& callback);
+    // Returns false if the queue is empty.
+    bool Take(std::function<void()>* callback);
+
+   private:
+    static constexpr size_t kCapacity = 256;
+
+    grpc_core::Mutex mu_;
+    std::function<void()> slots_[kCapacity] ABSL_GUARDED_BY(mu_);
+    size_t head_ ABSL_GUARDED_BY(mu_) = 0;
+    size_t size_ ABSL_GUARDED_BY(mu_) = 0;
+  };
+
+  struct Worker {
+    WorkStealingThreadPool* pool;
+    size_t index;
+    WorkQueue queue;
+    grpc_core::Thread thread;
+  };
+
+  static void ThreadFunc(void* arg);
+  bool TakeWork(Worker* worker, std::function<void()>* callback);
+
+  std::vector<std::unique_ptr<Worker>> workers_;
+  std::atomic<size_t> next_queue_{0};
+  // Callbacks queued and not yet taken.  Briefly negative when a callback
+  // is taken before Add() counts it.
+  std::atomic<intptr_t> pending_{0};
+  std::atomic<intptr_t> idle_threads_{0};
+
+  grpc_core::Mutex mu_;
+  grpc_core::CondVar cv_;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  // Callbacks that did not fit in the queue they were assigned to.
+  std::deque<std::function<void()>> overflow_ ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace grpc
+
+#endif  // GRPC_INTERNAL_CPP_WORK_STEALING_THREAD_POOL_H
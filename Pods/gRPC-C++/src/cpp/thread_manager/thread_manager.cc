@@ -18,15 +18,70 @@
 
 #include "src/cpp/thread_manager/thread_manager.h"
 
+#include <inttypes.h>
+#include <string.h>
+
+#include <algorithm>
 #include <climits>
+#include <ctime>
 
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
+#include <grpc/support/time.h>
 
 #include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 
 namespace grpc {
 
+namespace {
+
+// How often desired_pollers_ and the CPU utilization are re-evaluated.
+constexpr int64_t kAutoscaleIntervalUsec = 100 * 1000;
+// How long the queue latency must stay below half the target before a
+// poller is removed.
+constexpr int64_t kScaleDownDelayUsec = 1000 * 1000;
+// Weight of a new sample in the queue latency average.
+constexpr double kLatencyAlpha = 0.2;
+
+int64_t NowUsec() {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  return static_cast<int64_t>(now.tv_sec) * GPR_US_PER_SEC +
+         now.tv_nsec / GPR_NS_PER_US;
+}
+
+// CPU time used by the process. Where clock() measures wall time instead
+// (Windows), the utilization computed from it stays at 100% / cores and the
+// CPU cap has no effect.
+int64_t ProcessCpuTimeUsec() {
+  return static_cast<int64_t>(static_cast<double>(std::clock()) /
+                              CLOCKS_PER_SEC * GPR_US_PER_SEC);
+}
+
+}  // namespace
+
+ThreadManager::AutoscaleOptions
+ThreadManager::AutoscaleOptions::FromChannelArgs(
+    const grpc_channel_args* args) {
+  AutoscaleOptions options;
+  if (args == nullptr) return options;
+  for (size_t i = 0; i < args->num_args; i++) {
+    const grpc_arg& arg = args->args[i];
+    if (arg.type != GRPC_ARG_INTEGER) continue;
+    const char* key = arg.key;
+    if (0 == strcmp(key, GRPC_ARG_SYNC_SERVER_AUTOSCALE_TARGET_LATENCY_MS)) {
+      options.target_latency_msec = std::max(0, arg.value.integer);
+    } else if (0 == strcmp(key,
+                           GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CREATION_RATE)) {
+      options.max_thread_creations_per_sec = std::max(1, arg.value.integer);
+    } else if (0 ==
+               strcmp(key, GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CPU_PERCENT)) {
+      options.max_cpu_percent = std::max(1, arg.value.integer);
+    }
+  }
+  return options;
+}
+
 ThreadManager::WorkerThread::WorkerThread(ThreadManager* thd_mgr)
     : thd_mgr_(thd_mgr) {
   // Make thread creation exclusive with respect to its join happening in
@@ -50,8 +105,15 @@ ThreadManager::WorkerThread::~WorkerThread() {
   thd_.Join();
 }
 
-ThreadManager::ThreadManager(const char*, grpc_resource_quota* resource_quota,
+ThreadManager::ThreadManager(const char* name,
+                             grpc_resource_quota* resource_quota,
                              int min_pollers, int max_pollers)
+    : ThreadManager(name, resource_quota, min_pollers, max_pollers,
+                    AutoscaleOptions()) {}
+
+ThreadManager::ThreadManager(const char*, grpc_resource_quota* resource_quota,
+                             int min_pollers, int max_pollers,
+                             const AutoscaleOptions& autoscale)
     : shutdown_(false),
       thread_quota_(
           grpc_core::ResourceQuota::FromC(resource_quota)->thread_quota()),
@@ -59,7 +121,17 @@ ThreadManager::ThreadManager(const char*, grpc_resource_quota* resource_quota,
       min_pollers_(min_pollers),
       max_pollers_(max_pollers == -1 ? INT_MAX : max_pollers),
       num_threads_(0),
-      max_active_threads_sofar_(0) {}
+      max_active_threads_sofar_(0),
+      autoscale_(autoscale),
+      desired_pollers_(min_pollers) {
+  // Without an upper bound, autoscaling would only be bounded by the
+  // thread quota.
+  if (autoscaling() && max_pollers == -1) {
+    gpr_log(GPR_INFO,
+            "Sync server autoscaling without MAX_POLLERS: pollers are bounded "
+            "only by the thread quota");
+  }
+}
 
 ThreadManager::~ThreadManager() {
   {
@@ -92,6 +164,133 @@ int ThreadManager::GetMaxActiveThreadsSoFar() {
   return max_active_threads_sofar_;
 }
 
+ThreadManager::AutoscaleStats ThreadManager::GetAutoscaleStats() {
+  grpc_core::MutexLock lock(&mu_);
+  AutoscaleStats stats;
+  stats.num_threads = num_threads_;
+  stats.num_pollers = num_pollers_;
+  stats.desired_pollers = pollers_to_keep();
+  stats.queue_latency_usec = queue_latency_usec_;
+  stats.cpu_percent = cpu_percent_;
+  stats.threads_created = threads_created_;
+  stats.thread_creations_throttled = thread_creations_throttled_;
+  return stats;
+}
+
+void ThreadManager::OnPollerBusyLocked(int64_t now_usec) {
+  if (num_pollers_ > 0) {
+    // Work arriving now is still picked up right away.
+    queue_latency_usec_ = static_cast<int64_t>(
+        (1 - kLatencyAlpha) * static_cast<double>(queue_latency_usec_));
+  } else if (no_pollers_since_usec_ == 0) {
+    no_pollers_since_usec_ = now_usec;
+  }
+  MaybeRescaleLocked(now_usec);
+}
+
+void ThreadManager::OnPollerResumedLocked(int64_t now_usec) {
+  if (num_pollers_ == 1 && no_pollers_since_usec_ != 0) {
+    // Work that arrived while no thread was polling waited up to this long.
+    const int64_t waited = now_usec - no_pollers_since_usec_;
+    queue_latency_usec_ = static_cast<int64_t>(
+        kLatencyAlpha * static_cast<double>(waited) +
+        (1 - kLatencyAlpha) * static_cast<double>(queue_latency_usec_));
+    no_pollers_since_usec_ = 0;
+  }
+  MaybeRescaleLocked(now_usec);
+}
+
+void ThreadManager::MaybeRescaleLocked(int64_t now_usec) {
+  if (!autoscaling()) return;
+  if (now_usec - last_rescale_usec_ < kAutoscaleIntervalUsec) return;
+  SampleCpuLocked(now_usec);
+  last_rescale_usec_ = now_usec;
+  // Work that has been waiting since the last poller went busy counts even
+  // though no poller has come back to measure it yet.
+  int64_t latency_usec = queue_latency_usec_;
+  if (no_pollers_since_usec_ != 0) {
+    latency_usec = std::max(latency_usec, now_usec - no_pollers_since_usec_);
+  }
+  const int64_t target_usec =
+      static_cast<int64_t>(autoscale_.target_latency_msec) * GPR_US_PER_MS;
+  if (latency_usec > target_usec) {
+    below_target_since_usec_ = 0;
+    if (desired_pollers_ < max_pollers_ &&
+        cpu_percent_ < autoscale_.max_cpu_percent) {
+      desired_pollers_++;
+      gpr_log(GPR_DEBUG,
+              "Sync server queue latency %" PRId64
+              "us: raising pollers to %d (cpu %d%%)",
+              latency_usec, desired_pollers_, cpu_percent_);
+    }
+  } else if (latency_usec < target_usec / 2) {
+    // Between half the target and the target nothing changes, so that the
+    // pool does not oscillate around the target.
+    if (below_target_since_usec_ == 0) {
+      below_target_since_usec_ = now_usec;
+    } else if (now_usec - below_target_since_usec_ >= kScaleDownDelayUsec &&
+               desired_pollers_ > min_pollers_) {
+      desired_pollers_--;
+      below_target_since_usec_ = now_usec;
+      gpr_log(GPR_DEBUG,
+              "Sync server queue latency %" PRId64
+              "us: lowering pollers to %d",
+              latency_usec, desired_pollers_);
+    }
+  } else {
+    below_target_since_usec_ = 0;
+  }
+}
+
+void ThreadManager::SampleCpuLocked(int64_t now_usec) {
+  const int64_t elapsed_usec = now_usec - last_cpu_sample_usec_;
+  if (last_cpu_sample_usec_ != 0 && elapsed_usec < kAutoscaleIntervalUsec) {
+    return;
+  }
+  const int64_t cpu_time_usec = ProcessCpuTimeUsec();
+  if (last_cpu_sample_usec_ != 0) {
+    int cores = gpr_cpu_num_cores();
+    if (cores == 0) cores = 1;
+    cpu_percent_ =
+        static_cast<int>(100 * (cpu_time_usec - last_cpu_time_usec_) /
+                         (elapsed_usec * cores));
+  }
+  last_cpu_sample_usec_ = now_usec;
+  last_cpu_time_usec_ = cpu_time_usec;
+}
+
+int ThreadManager::GetCpuPercent() {
+  grpc_core::MutexLock lock(&mu_);
+  SampleCpuLocked(NowUsec());
+  return cpu_percent_;
+}
+
+bool ThreadManager::TakeCreationTokenLocked(int64_t now_usec) {
+  // Pollers below min_pollers are always replaced, and so is the last one,
+  // since new work would otherwise fail for lack of a thread.
+  if (!autoscaling() || num_pollers_ < min_pollers_ || num_pollers_ == 0) {
+    return true;
+  }
+  const double rate = autoscale_.max_thread_creations_per_sec;
+  if (last_token_refill_usec_ == 0) {
+    creation_tokens_ = 1;
+  } else {
+    creation_tokens_ = std::min(
+        std::max(rate, 1.0),
+        creation_tokens_ + rate *
+                               static_cast<double>(now_usec -
+                                                   last_token_refill_usec_) /
+                               GPR_US_PER_SEC);
+  }
+  last_token_refill_usec_ = now_usec;
+  if (creation_tokens_ < 1) {
+    thread_creations_throttled_++;
+    return false;
+  }
+  creation_tokens_ -= 1;
+  return true;
+}
+
 void ThreadManager::MarkAsCompleted(WorkerThread* thd) {
   {
     grpc_core::MutexLock list_lock(&list_mu_);
@@ -157,8 +356,13 @@ void ThreadManager::MainWorkLoop() {
     switch (work_status) {
       case TIMEOUT:
         // If we timed out and we have more pollers than we need (or we are
-        // shutdown), finish this thread
+        // shutdown), finish this thread. When autoscaling, pollers beyond
+        // the desired count that time out are not needed either.
         if (shutdown_ || num_pollers_ > max_pollers_) done = true;
+        if (autoscaling()) {
+          MaybeRescaleLocked(NowUsec());
+          if (num_pollers_ >= desired_pollers_) done = true;
+        }
         break;
       case SHUTDOWN:
         // If the thread manager is shutdown, finish this thread
@@ -168,11 +372,14 @@ void ThreadManager::MainWorkLoop() {
         // If we got work and there are now insufficient pollers and there is
         // quota available to create a new thread, start a new poller thread
         bool resource_exhausted = false;
-        if (!shutdown_ && num_pollers_ < min_pollers_) {
-          if (thread_quota_->Reserve(1)) {
+        const int64_t now_usec = autoscaling() ? NowUsec() : 0;
+        if (autoscaling()) OnPollerBusyLocked(now_usec);
+        if (!shutdown_ && num_pollers_ < pollers_to_keep()) {
+          if (TakeCreationTokenLocked(now_usec) && thread_quota_->Reserve(1)) {
             // We can allocate a new poller thread
             num_pollers_++;
             num_threads_++;
+            threads_created_++;
             if (num_threads_ > max_active_threads_sofar_) {
               max_active_threads_sofar_ = num_threads_;
             }
@@ -186,6 +393,7 @@ void ThreadManager::MainWorkLoop() {
               grpc_core::MutexLock failure_lock(&mu_);
               num_pollers_--;
               num_threads_--;
+              threads_created_--;
               resource_exhausted = true;
               delete worker;
             }
@@ -247,6 +455,7 @@ void ThreadManager::MainWorkLoop() {
     // avalanche.
     if (num_pollers_ < max_pollers_) {
       num_pollers_++;
+      if (autoscaling()) OnPollerResumedLocked(NowUsec());
     } else {
       break;
     }
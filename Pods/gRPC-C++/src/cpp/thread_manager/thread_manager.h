@@ -19,6 +19,8 @@
 #ifndef GRPC_INTERNAL_CPP_THREAD_MANAGER_H
 #define GRPC_INTERNAL_CPP_THREAD_MANAGER_H
 
+#include <stdint.h>
+
 #include <list>
 #include <memory>
 
@@ -29,12 +31,63 @@
 #include "src/core/lib/gprpp/thd.h"
 #include "src/core/lib/resource_quota/api.h"
 
+// Channel args through which ServerBuilder passes the autoscaling options
+// of sync servers to Server. See ThreadManager::AutoscaleOptions.
+#define GRPC_ARG_SYNC_SERVER_AUTOSCALE_TARGET_LATENCY_MS \
+  "grpc.cpp.sync_server_autoscale_target_latency_ms"
+#define GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CREATION_RATE \
+  "grpc.cpp.sync_server_autoscale_max_creations_per_sec"
+#define GRPC_ARG_SYNC_SERVER_AUTOSCALE_MAX_CPU_PERCENT \
+  "grpc.cpp.sync_server_autoscale_max_cpu_percent"
+// Likewise for load shedding, which Server applies before dispatching a sync
+// request to its handler.
+#define GRPC_ARG_SYNC_SERVER_SHED_QUEUE_TIME_MS \
+  "grpc.cpp.sync_server_shed_queue_time_ms"
+#define GRPC_ARG_SYNC_SERVER_SHED_CPU_PERCENT \
+  "grpc.cpp.sync_server_shed_cpu_percent"
+
 namespace grpc {
 
 class ThreadManager {
  public:
+  // Without autoscaling, a thread that finds work starts a new poller only
+  // when fewer than min_pollers are left polling. With autoscaling, the
+  // number of pollers kept, desired_pollers, moves between min_pollers and
+  // max_pollers with the time work waits for a poller: while all threads
+  // are busy, new work waits in the completion queue until one of them
+  // goes back to polling.
+  struct AutoscaleOptions {
+    // Pollers are added while the average wait is above this, and removed
+    // once it has stayed below half of it for a second. 0 disables
+    // autoscaling.
+    int target_latency_msec = 0;
+    // Threads started to add pollers are limited to this rate.
+    int max_thread_creations_per_sec = 10;
+    // No pollers are added while the process uses more than this share of
+    // the machine's CPUs, since more threads would not run any sooner.
+    int max_cpu_percent = 90;
+
+    static AutoscaleOptions FromChannelArgs(const grpc_channel_args* args);
+  };
+
+  struct AutoscaleStats {
+    int num_threads;
+    int num_pollers;
+    int desired_pollers;
+    // Moving average of the time work waited for a poller.
+    int64_t queue_latency_usec;
+    int cpu_percent;
+    // Threads started to add pollers, and the ones not started because of
+    // max_thread_creations_per_sec.
+    uint64_t threads_created;
+    uint64_t thread_creations_throttled;
+  };
+
   explicit ThreadManager(const char* name, grpc_resource_quota* resource_quota,
                          int min_pollers, int max_pollers);
+  ThreadManager(const char* name, grpc_resource_quota* resource_quota,
+                int min_pollers, int max_pollers,
+                const AutoscaleOptions& autoscale);
   virtual ~ThreadManager();
 
   // Initializes and Starts the Rpc Manager threads
@@ -93,6 +146,13 @@ class ThreadManager {
   // to check if resource_quota is properly being enforced.
   int GetMaxActiveThreadsSoFar();
 
+  // A snapshot of the autoscaling state, for debugging and metrics.
+  AutoscaleStats GetAutoscaleStats();
+
+  // The share of the machine's CPUs the process used over the last
+  // sampling interval (100ms), in percent.
+  int GetCpuPercent();
+
  private:
   // Helper wrapper class around grpc_core::Thread. Takes a ThreadManager object
   // and starts a new grpc_core::Thread to calls the Run() function.
@@ -142,8 +202,26 @@ class ThreadManager {
   void MarkAsCompleted(WorkerThread* thd);
   void CleanupCompletedThreads();
 
-  // Protects shutdown_, num_pollers_, num_threads_ and
-  // max_active_threads_sofar_
+  bool autoscaling() const { return autoscale_.target_latency_msec > 0; }
+  // Records that a thread stopped polling (because it found work) or went
+  // back to polling, updating the queue latency average. Called with mu_
+  // held, after num_pollers_ is updated.
+  void OnPollerBusyLocked(int64_t now_usec);
+  void OnPollerResumedLocked(int64_t now_usec);
+  // Re-evaluates desired_pollers_ at most every kAutoscaleIntervalUsec.
+  void MaybeRescaleLocked(int64_t now_usec);
+  // Updates cpu_percent_ at most every kAutoscaleIntervalUsec.
+  void SampleCpuLocked(int64_t now_usec);
+  // Whether a thread may be started now to add a poller, taking a token
+  // from the creation rate limit if so.
+  bool TakeCreationTokenLocked(int64_t now_usec);
+  // The number of pollers a thread that found work tops up to.
+  int pollers_to_keep() const {
+    return autoscaling() ? desired_pollers_ : min_pollers_;
+  }
+
+  // Protects shutdown_, num_pollers_, num_threads_,
+  // max_active_threads_sofar_ and the autoscaling state
   grpc_core::Mutex mu_;
 
   bool shutdown_;
@@ -173,6 +251,23 @@ class ThreadManager {
   // ever set so far
   int max_active_threads_sofar_;
 
+  const AutoscaleOptions autoscale_;
+  int desired_pollers_;
+  int64_t queue_latency_usec_ = 0;
+  // When the last poller found work and none were left polling, or 0.
+  int64_t no_pollers_since_usec_ = 0;
+  // Since when queue_latency_usec_ has stayed below the lower threshold,
+  // or 0.
+  int64_t below_target_since_usec_ = 0;
+  int64_t last_rescale_usec_ = 0;
+  int64_t last_cpu_sample_usec_ = 0;
+  int64_t last_cpu_time_usec_ = 0;
+  int cpu_percent_ = 0;
+  double creation_tokens_ = 0;
+  int64_t last_token_refill_usec_ = 0;
+  uint64_t threads_created_ = 0;
+  uint64_t thread_creations_throttled_ = 0;
+
   grpc_core::Mutex list_mu_;
   std::list<WorkerThread*> completed_threads_;
 };
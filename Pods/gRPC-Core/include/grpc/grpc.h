@@ -134,6 +134,20 @@ GRPCAPI grpc_event grpc_completion_queue_next(grpc_completion_queue* cq,
                                               gpr_timespec deadline,
                                               void* reserved);
 
+/** EXPERIMENTAL. As grpc_completion_queue_next, but returns up to max_events
+    (which must be at least 1) events in events[] in one call: it blocks as
+    grpc_completion_queue_next does for the first, and then adds any others
+    already queued. Returns the number of events written, which is always at
+    least 1: all are of type GRPC_OP_COMPLETE, or there is one of type
+    GRPC_QUEUE_TIMEOUT or GRPC_QUEUE_SHUTDOWN.
+
+    Only completion queues of type GRPC_CQ_NEXT support this. */
+GRPCAPI size_t grpc_completion_queue_next_batch(grpc_completion_queue* cq,
+                                                grpc_event* events,
+                                                size_t max_events,
+                                                gpr_timespec deadline,
+                                                void* reserved);
+
 /** Blocks until an event with tag 'tag' is available, the completion queue is
     being shutdown or deadline is reached.
 
@@ -269,6 +283,25 @@ GRPCAPI grpc_call_error grpc_call_start_batch(grpc_call* call,
     functionality. Instead, use grpc_auth_context. */
 GRPCAPI char* grpc_call_get_peer(grpc_call* call);
 
+/** Sample one in every \a period client calls (on each thread) for latency
+    instrumentation: the times at which a sampled call reaches each
+    grpc_rpc_timeline_event are recorded, at a cost of a few clock reads. 0
+    disables sampling. Defaults to the GRPC_RPC_TIMELINE_SAMPLING_PERIOD
+    environment variable, or 1000. */
+GRPCAPI void grpc_rpc_timeline_set_sampling_period(uint32_t period);
+
+/** If \a call was sampled, fills \a timeline with its events so far and
+    returns 1; otherwise returns 0. */
+GRPCAPI int grpc_call_get_rpc_timeline(grpc_call* call,
+                                       grpc_rpc_timeline* timeline);
+
+/** Moves the timelines of up to \a max_timelines sampled calls that have
+    finished (since the previous collection) to \a timelines, and returns how
+    many were moved. A bounded number of recent timelines are kept: older ones
+    are dropped if they're not collected in time. */
+GRPCAPI size_t grpc_rpc_timeline_collect(grpc_rpc_timeline* timelines,
+                                         size_t max_timelines);
+
 struct census_context;
 
 /** Set census context for a call; Must be called before first call to
@@ -396,6 +429,28 @@ GRPCAPI grpc_call_error grpc_server_request_registered_call(
     grpc_completion_queue* cq_bound_to_call,
     grpc_completion_queue* cq_for_notification, void* tag_new);
 
+/** One request for grpc_server_request_registered_calls. The fields have the
+    meaning of the grpc_server_request_registered_call arguments of the same
+    names. */
+typedef struct grpc_server_registered_call_request {
+  grpc_call** call;
+  gpr_timespec* deadline;
+  grpc_metadata_array* request_metadata;
+  grpc_byte_buffer** optional_payload;
+  void* tag;
+} grpc_server_registered_call_request;
+
+/** Requests notification of up to 'count' new pre-registered calls at once,
+    as if grpc_server_request_registered_call were called with each of
+    'requests' in turn, but matching them against incoming calls in one pass.
+    Stops at the first request that fails; the ones before it are queued, and
+    the error is returned. */
+GRPCAPI grpc_call_error grpc_server_request_registered_calls(
+    grpc_server* server, void* registered_method,
+    const grpc_server_registered_call_request* requests, size_t count,
+    grpc_completion_queue* cq_bound_to_call,
+    grpc_completion_queue* cq_for_notification);
+
 /** Create a server. Additional configuration for each incoming channel can
     be specified with args. If no additional configuration is needed, args can
     be NULL. The user data in 'args' need only live through the invocation of
@@ -514,6 +569,29 @@ GRPCAPI void grpc_resource_quota_resize(grpc_resource_quota* resource_quota,
 GRPCAPI void grpc_resource_quota_set_max_threads(
     grpc_resource_quota* resource_quota, int new_max_threads);
 
+/** EXPERIMENTAL. Set the fractions of a buffer pool in use at which each memory
+    pressure level begins (by default 0.8, 0.9 and 0.95). */
+GRPCAPI void grpc_resource_quota_set_memory_pressure_thresholds(
+    grpc_resource_quota* resource_quota, double moderate, double high,
+    double critical);
+
+/** EXPERIMENTAL. Return the memory pressure level of a buffer pool */
+GRPCAPI grpc_memory_pressure_level
+grpc_resource_quota_memory_pressure_level(grpc_resource_quota* resource_quota);
+
+/** EXPERIMENTAL. Return the number of times a buffer pool has entered a memory
+    pressure level */
+GRPCAPI uint64_t grpc_resource_quota_memory_pressure_level_entries(
+    grpc_resource_quota* resource_quota, grpc_memory_pressure_level level);
+
+/** EXPERIMENTAL. Call \a callback, with \a user_data, each time the memory
+    pressure level of a buffer pool changes, for as long as the pool exists.
+    Callbacks run on gRPC threads, and must not block. */
+GRPCAPI void grpc_resource_quota_add_memory_pressure_watcher(
+    grpc_resource_quota* resource_quota,
+    void (*callback)(void* user_data, grpc_memory_pressure_level level),
+    void* user_data);
+
 /** EXPERIMENTAL.  Dumps xDS configs as a serialized ClientConfig proto.
     The full name of the proto is envoy.service.status.v3.ClientConfig. */
 GRPCAPI grpc_slice grpc_dump_xds_configs();
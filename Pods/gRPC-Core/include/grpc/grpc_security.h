@@ -119,6 +119,60 @@ GRPCAPI void grpc_ssl_session_cache_destroy(grpc_ssl_session_cache* cache);
 GRPCAPI grpc_arg
 grpc_ssl_session_cache_create_channel_arg(grpc_ssl_session_cache* cache);
 
+/** Get how many session lookups in \a cache found a session to resume
+    (\a hits) and how many didn't (\a misses). */
+GRPCAPI void grpc_ssl_session_cache_get_stats(grpc_ssl_session_cache* cache,
+                                              uint64_t* hits,
+                                              uint64_t* misses);
+
+/** Channels created with SSL credentials and no GRPC_SSL_SESSION_CACHE_ARG
+    share a process-wide session cache, one for each distinct set of root
+    certificates, key/cert pair and verification options, so that new
+    channels to a target can resume sessions of earlier ones. Its capacity is
+    set by the GRPC_SSL_DEFAULT_SESSION_CACHE_SIZE environment variable (256
+    sessions by default, 0 to disable it).
+    Get the lookup statistics of all of these caches together. */
+GRPCAPI void grpc_ssl_default_session_cache_get_stats(uint64_t* hits,
+                                                      uint64_t* misses);
+
+/** Totals over all SSL/TLS connections of the process since it started:
+    records and plaintext bytes protected and unprotected, time spent doing
+    so, and TLS 1.3 key updates the connections initiated. TLS 1.3
+    connections update their keys every 2^23 records in either direction. */
+typedef struct {
+  uint64_t connections;
+  uint64_t records_protected;
+  uint64_t records_unprotected;
+  uint64_t bytes_protected;
+  uint64_t bytes_unprotected;
+  uint64_t protect_ns;
+  uint64_t unprotect_ns;
+  uint64_t key_updates;
+} grpc_ssl_protection_stats;
+
+/** Get the current SSL/TLS protection totals. Each connection contributes
+    its counters every few dozen records and when it closes. */
+GRPCAPI void grpc_ssl_get_protection_stats(grpc_ssl_protection_stats* stats);
+
+/** When the GRPC_HANDSHAKE_THREADS environment variable is set to a positive
+    number, the cryptographic steps of security handshakes run on a pool of
+    that many dedicated threads instead of on the polling threads. */
+typedef struct {
+  /** Threads in the pool; 0 if handshakes run inline. */
+  size_t num_threads;
+  /** Handshake steps currently waiting for a free thread. */
+  size_t queue_depth;
+  /** The largest queue_depth seen so far. */
+  size_t max_queue_depth;
+  /** Handshake steps taken off the queue so far. */
+  uint64_t steps_run;
+  /** Total time those steps spent waiting in the queue, in nanoseconds. */
+  uint64_t total_queue_wait_ns;
+} grpc_handshake_pool_stats;
+
+/** Get the current statistics of the handshake thread pool. */
+GRPCAPI void grpc_handshake_pool_get_stats(grpc_handshake_pool_stats* stats);
+
 /** --- grpc_call_credentials object.
 
    A call credentials object represents a way to authenticate on a particular
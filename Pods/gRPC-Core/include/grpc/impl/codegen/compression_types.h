@@ -52,6 +52,11 @@ extern "C" {
  * be ignored). */
 #define GRPC_COMPRESSION_CHANNEL_ENABLED_ALGORITHMS_BITSET \
   "grpc.compression_enabled_algorithms_bitset"
+/** Messages smaller than this many bytes are sent uncompressed, whatever the
+ * call's compression algorithm: compressing them costs more than it saves.
+ * Its value is a non-negative int. Defaults to 0 (compress all messages). */
+#define GRPC_COMPRESSION_CHANNEL_MIN_MESSAGE_SIZE \
+  "grpc.compression_min_message_size"
 /** \} */
 
 /** The various compression algorithms supported by gRPC (not sorted by
@@ -170,6 +170,16 @@ typedef struct {
  * channel goes back into IDLE state. Int valued, milliseconds. INT_MAX means
  * unlimited. The default value is 30 minutes and the min value is 1 second. */
 #define GRPC_ARG_CLIENT_IDLE_TIMEOUT_MS "grpc.client_idle_timeout_ms"
+/** If set to non-zero, a channel entering IDLE only drops its LB policy and
+ * with it the connections, and keeps its resolver and the last resolver
+ * result, so that the first RPC after idle does not wait on re-resolution.
+ * Defaults to 0. */
+#define GRPC_ARG_CLIENT_IDLE_WARM "grpc.client_idle_warm"
+/** If set to non-zero, the client idle filter learns how long the channel
+ * usually stays idle and starts reconnecting shortly before the next RPC is
+ * expected. Defaults to 0. */
+#define GRPC_ARG_CLIENT_IDLE_PREDICTIVE_RECONNECT \
+  "grpc.client_idle_predictive_reconnect"
 /** Enable/disable support for per-message compression. Defaults to 1, unless
     GRPC_ARG_MINIMAL_STACK is enabled, in which case it defaults to 0. */
 #define GRPC_ARG_ENABLE_PER_MESSAGE_COMPRESSION "grpc.per_message_compression"
@@ -201,6 +211,11 @@ typedef struct {
 #define GRPC_ARG_HTTP2_MAX_FRAME_SIZE "grpc.http2.max_frame_size"
 /** Should BDP probing be performed? */
 #define GRPC_ARG_HTTP2_BDP_PROBE "grpc.http2.bdp_probe"
+/** If non-zero, the transport's combiner never offloads its work to the
+    executor: the work keeps running on the thread that holds the combiner,
+    typically a poller thread. This avoids cross-thread handoffs, at the cost
+    of fairness between the transports that share a poller. Defaults to 0. */
+#define GRPC_ARG_HTTP2_COMBINER_AFFINITY "grpc.http2.combiner_affinity"
 /** (DEPRECATED) Does not have any effect.
     Earlier, this arg configured the minimum time between successive ping frames
     without receiving any data/header frame, Int valued, milliseconds. This put
@@ -231,6 +246,12 @@ typedef struct {
 /** How much data are we willing to queue up per stream if
     GRPC_WRITE_BUFFER_HINT is set? This is an upper bound */
 #define GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE "grpc.http2.write_buffer_size"
+/** How long, in microseconds, an idle http2 transport holds a write for so
+    that frames from other streams (and PING/SETTINGS acks) queued meanwhile go
+    out in the same endpoint write. Rounded up to the timer's millisecond
+    granularity. Defaults to 0 (write immediately) */
+#define GRPC_ARG_HTTP2_WRITE_COALESCING_WINDOW_US \
+  "grpc.http2.write_coalescing_window_us"
 /** Should we allow receipt of true-binary data on http2 connections?
     Defaults to on (1) */
 #define GRPC_ARG_HTTP2_ENABLE_TRUE_BINARY "grpc.http2.true_binary"
@@ -279,6 +300,16 @@ typedef struct {
     grpc_ssl_session_cache*). (use grpc_ssl_session_cache_arg_vtable() to fetch
     an appropriate pointer arg vtable) */
 #define GRPC_SSL_SESSION_CACHE_ARG "grpc.ssl_session_cache"
+/** If non-zero, connections of SSL channels that resume a TLS 1.3 session
+    send their first bytes, including the requests of the first RPCs, as 0-RTT
+    early data, saving a round trip after a reconnect. Early data can be
+    replayed by the network, so set this only on channels whose RPCs are all
+    idempotent or otherwise safe to process twice. If the server rejects the
+    early data, the connection fails (its RPCs fail with UNAVAILABLE, as with
+    any dropped connection) and later ones resume without 0-RTT. Needs a
+    session cache (see GRPC_SSL_SESSION_CACHE_ARG) and BoringSSL. Defaults to
+    0. */
+#define GRPC_ARG_TLS_EARLY_DATA "grpc.tls_early_data"
 /** If non-zero, it will determine the maximum frame size used by TSI's frame
  *  protector.
  *
@@ -349,6 +380,12 @@ typedef struct {
    issued by the tcp_write(). By default, this is set to 4. */
 #define GRPC_ARG_TCP_TX_ZEROCOPY_MAX_SIMULT_SENDS \
   "grpc.experimental.tcp_tx_zerocopy_max_simultaneous_sends"
+/* TCP write batching enable state: zero is disabled, non-zero is enabled. By
+   default, it is disabled. When enabled, writes of a few slices wait for the
+   end of the current exec_ctx and go out together with the other endpoints'
+   in one io_uring_enter() call, where io_uring is available. */
+#define GRPC_ARG_TCP_WRITE_BATCHING_ENABLED \
+  "grpc.experimental.tcp_write_batching_enabled"
 /* Timeout in milliseconds to use for calls to the grpclb load balancer.
    If 0 or unset, the balancer calls will have no deadline. */
 #define GRPC_ARG_GRPCLB_CALL_TIMEOUT_MS "grpc.grpclb_call_timeout_ms"
@@ -389,17 +426,15 @@ typedef struct {
       https://github.com/grpc/proposal/blob/master/A6-client-retries.md
     NOTE: Transparent retries are not yet implemented.  When they are
           implemented, they will also be enabled by this arg.
-    NOTE: Hedging functionality is not yet implemented, so those
-          fields in the service config will currently be ignored.  See
-          also the GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING arg below.
+    NOTE: The hedging fields in the service config are ignored unless
+          the GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING arg below is also set.
  */
 #define GRPC_ARG_ENABLE_RETRIES "grpc.enable_retries"
 /** Enables hedging functionality, as described in:
       https://github.com/grpc/proposal/blob/master/A6-client-retries.md
-    Default is currently false, since this functionality is not yet
-    fully implemented.
+    Default is currently false, since this functionality is new.
     NOTE: This channel arg is experimental and will eventually be removed.
-          Once hedging functionality has been implemented and proves stable,
+          Once hedging functionality proves stable,
           this arg will be removed, and the hedging functionality will
           be enabled via the GRPC_ARG_ENABLE_RETRIES arg above. */
 #define GRPC_ARG_EXPERIMENTAL_ENABLE_HEDGING "grpc.experimental.enable_hedging"
@@ -437,6 +472,19 @@ typedef struct {
 /** If set, uses a local subchannel pool within the channel. Otherwise, uses the
  * global subchannel pool. */
 #define GRPC_ARG_USE_LOCAL_SUBCHANNEL_POOL "grpc.use_local_subchannel_pool"
+/** If set, channels with the same value of this string arg share their
+ * connections to each address in the global subchannel pool, even if the rest
+ * of their channel args differ. The connection is made with the args of the
+ * first channel to create it, so the caller must only use the same key for
+ * channels whose credentials and transport settings are interchangeable. */
+#define GRPC_ARG_SUBCHANNEL_SHARING_KEY "grpc.subchannel_sharing_key"
+/** An int arg used with GRPC_ARG_SUBCHANNEL_SHARING_KEY. When a shared
+ * connection already carries this many calls, a channel creating a
+ * subchannel to the same address gets a new connection instead of that one.
+ * 0 (the default) means no limit, so each address gets a single connection.
+ */
+#define GRPC_ARG_SUBCHANNEL_SHARING_MAX_STREAMS \
+  "grpc.subchannel_sharing_max_streams_per_connection"
 /** gRPC Objective-C channel pooling domain string. */
 #define GRPC_ARG_CHANNEL_POOL_DOMAIN "grpc.channel_pooling_domain"
 /** gRPC Objective-C channel pooling id. */
@@ -499,6 +547,13 @@ typedef enum grpc_call_error {
 #define GRPC_DEFAULT_MAX_SEND_MESSAGE_LENGTH (-1)
 #define GRPC_DEFAULT_MAX_RECV_MESSAGE_LENGTH (4 * 1024 * 1024)
 
+/** Initial metadata key giving a call's weight, an integer from 1 to 256, in
+    sharing write bandwidth with the other calls on its http2 connection.
+    Calls default to 16; a call weighted 64 gets four times the share of one at
+    the default when both have data ready. The transport consumes this key and
+    does not send it to the peer. */
+#define GRPC_STREAM_WEIGHT_METADATA_KEY "grpc-stream-weight"
+
 /** Write Flags: */
 /** Hint that the write may be buffered and need not go out on the wire
     immediately. GRPC is free to buffer the message until the next non-buffered
@@ -730,6 +785,51 @@ typedef struct {
 
 typedef struct grpc_resource_quota grpc_resource_quota;
 
+/** How close a resource quota is to running out of memory. At each level gRPC
+    does more to free memory: */
+typedef enum {
+  /** Nothing: there's memory to spare */
+  GRPC_MEMORY_PRESSURE_NONE = 0,
+  /** Cached memory is released and flow control windows shrink */
+  GRPC_MEMORY_PRESSURE_MODERATE = 1,
+  /** Idle connections are closed and servers accept no new connections */
+  GRPC_MEMORY_PRESSURE_HIGH = 2,
+  /** Servers refuse new streams, and in flight work may be cancelled */
+  GRPC_MEMORY_PRESSURE_CRITICAL = 3
+} grpc_memory_pressure_level;
+
+/** Points in the life of a client call recorded by its timeline, in the order
+    they usually happen. */
+typedef enum {
+  /** The channel had a resolver result (and so a service config) for it */
+  GRPC_RPC_TIMELINE_NAME_RESOLVED = 0,
+  /** The LB policy picked a connected subchannel for it: this includes any
+      wait for a connection to be established */
+  GRPC_RPC_TIMELINE_LB_PICK_COMPLETE,
+  /** The batch sending its initial metadata completed */
+  GRPC_RPC_TIMELINE_HEADERS_SENT,
+  /** The response's initial metadata was received */
+  GRPC_RPC_TIMELINE_FIRST_BYTE_RECEIVED,
+  /** The first response message was received in full */
+  GRPC_RPC_TIMELINE_FIRST_MESSAGE_RECEIVED,
+  /** The response's trailing metadata was received */
+  GRPC_RPC_TIMELINE_LAST_BYTE_RECEIVED,
+  /** The completion of the batch receiving its status was handed to the
+      application (queued on the completion queue, or its callback run) */
+  GRPC_RPC_TIMELINE_COMPLETION_DISPATCHED,
+  GRPC_RPC_TIMELINE_EVENT_COUNT
+} grpc_rpc_timeline_event;
+
+/** The timeline of a sampled client call: see
+    grpc_rpc_timeline_set_sampling_period(). */
+typedef struct grpc_rpc_timeline {
+  /** When the call was created, in nanoseconds since the Unix epoch */
+  int64_t start_unix_ns;
+  /** Nanoseconds from the call's creation to each event, or -1 for the events
+      the call didn't reach. */
+  int64_t elapsed_ns[GRPC_RPC_TIMELINE_EVENT_COUNT];
+} grpc_rpc_timeline;
+
 /** Completion queues internally MAY maintain a set of file descriptors in a
     structure called 'pollset'. This enum specifies if a completion queue has an
     associated pollset and any restrictions on the type of file descriptors that
@@ -25,6 +25,7 @@
 #include <string.h>
 
 #include <set>
+#include <thread>
 
 #include "absl/container/inlined_vector.h"
 #include "absl/strings/numbers.h"
@@ -51,11 +52,13 @@
 #include "src/core/ext/filters/client_channel/resolver_result_parsing.h"
 #include "src/core/ext/filters/client_channel/retry_filter.h"
 #include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/ext/filters/concurrency_limit/concurrency_limit_filter.h"
 #include "src/core/ext/filters/deadline/deadline_filter.h"
 #include "src/core/lib/backoff/backoff.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/connected_channel.h"
 #include "src/core/lib/channel/status_util.h"
+#include "src/core/lib/debug/rpc_timeline.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/iomgr.h"
@@ -668,6 +671,70 @@ class ClientChannel::SubchannelWrapper : public SubchannelInterface {
       ABSL_GUARDED_BY(&ClientChannel::work_serializer_);
 };
 
+//
+// ClientChannel::PickerWrapper
+//
+
+// A picker shared by the picks in progress on it.  Picks may hold the last
+// ref, but pickers hold SubchannelWrappers, which are destroyed in the
+// WorkSerializer, so the picker is always destroyed there.
+class ClientChannel::PickerWrapper : public RefCounted<PickerWrapper> {
+ public:
+  PickerWrapper(std::shared_ptr<WorkSerializer> work_serializer,
+                std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker)
+      : work_serializer_(std::move(work_serializer)),
+        picker_(std::move(picker)) {}
+
+  ~PickerWrapper() override {
+    auto* picker = picker_.release();  // owned by lambda
+    work_serializer_->Run([picker]() { delete picker; }, DEBUG_LOCATION);
+  }
+
+  LoadBalancingPolicy::SubchannelPicker* picker() const {
+    return picker_.get();
+  }
+
+ private:
+  std::shared_ptr<WorkSerializer> work_serializer_;
+  std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker_;
+};
+
+RefCountedPtr<ClientChannel::PickerWrapper> ClientChannel::GetPicker() {
+  for (;;) {
+    const uint32_t epoch = picker_epoch_.load(std::memory_order_seq_cst);
+    std::atomic<uint32_t>& readers = picker_readers_[epoch % 2];
+    readers.fetch_add(1, std::memory_order_seq_cst);
+    // If SwapPickerLocked() moved on to the other epoch in the meantime, it
+    // may not have seen us: start again.
+    if (GPR_LIKELY(picker_epoch_.load(std::memory_order_seq_cst) == epoch)) {
+      PickerWrapper* picker = picker_.load(std::memory_order_seq_cst);
+      RefCountedPtr<PickerWrapper> ref =
+          picker != nullptr ? picker->Ref() : nullptr;
+      readers.fetch_sub(1, std::memory_order_release);
+      return ref;
+    }
+    readers.fetch_sub(1, std::memory_order_release);
+  }
+}
+
+RefCountedPtr<ClientChannel::PickerWrapper> ClientChannel::SwapPickerLocked(
+    std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker) {
+  PickerWrapper* new_picker =
+      picker != nullptr ? new PickerWrapper(work_serializer_, std::move(picker))
+                        : nullptr;
+  RefCountedPtr<PickerWrapper> old_picker(
+      picker_.exchange(new_picker, std::memory_order_seq_cst));
+  // Picks that load picker_ from here on see the new picker.  Wait for those
+  // registered in the current epoch, which may have loaded the old one, to
+  // have taken their refs: that's only a few instructions each.
+  const uint32_t epoch =
+      picker_epoch_.fetch_add(1, std::memory_order_seq_cst);
+  while (picker_readers_[epoch % 2].load(std::memory_order_acquire) != 0) {
+    std::this_thread::yield();
+  }
+  return old_picker;
+}
+
 //
 // ClientChannel::ExternalConnectivityWatcher
 //
@@ -986,8 +1053,12 @@ class ClientChannel::ClientChannelControlHelper
 //
 
 ClientChannel* ClientChannel::GetFromChannel(grpc_channel* channel) {
-  grpc_channel_element* elem =
-      grpc_channel_stack_last_element(grpc_channel_get_channel_stack(channel));
+  return GetFromChannelStack(grpc_channel_get_channel_stack(channel));
+}
+
+ClientChannel* ClientChannel::GetFromChannelStack(
+    grpc_channel_stack* channel_stack) {
+  grpc_channel_element* elem = grpc_channel_stack_last_element(channel_stack);
   if (elem->filter != &kFilterVtable) return nullptr;
   return static_cast<ClientChannel*>(elem->channel_data);
 }
@@ -1029,6 +1100,8 @@ ClientChannel::ClientChannel(grpc_channel_element_args* args,
                              grpc_error_handle* error)
     : deadline_checking_enabled_(
           grpc_deadline_checking_enabled(args->channel_args)),
+      warm_idle_(grpc_channel_args_find_bool(args->channel_args,
+                                             GRPC_ARG_CLIENT_IDLE_WARM, false)),
       owning_stack_(args->channel_stack),
       client_channel_factory_(
           ClientChannelFactory::GetFromChannelArgs(args->channel_args)),
@@ -1113,6 +1186,8 @@ ClientChannel::~ClientChannel() {
     gpr_log(GPR_INFO, "chand=%p: destroying channel", this);
   }
   DestroyResolverAndLbPolicyLocked();
+  PickerWrapper* picker = picker_.exchange(nullptr);
+  if (picker != nullptr) picker->Unref();
   grpc_channel_args_destroy(channel_args_);
   // Stop backup polling.
   grpc_client_channel_stop_backup_polling(interested_parties_);
@@ -1184,6 +1259,12 @@ void ClientChannel::OnResolverResultChangedLocked(Resolver::Result result) {
   if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
     gpr_log(GPR_INFO, "chand=%p: got resolver result", this);
   }
+  // In warm idle, keep the result for when the channel is used again.
+  if (warm_idle_active_) {
+    last_resolver_result_ = std::move(result);
+    return;
+  }
+  if (warm_idle_) last_resolver_result_ = result;
   // We only want to trace the address resolution in the follow cases:
   // (a) Address resolution resulted in service config change.
   // (b) Address resolution that causes number of backends to go from
@@ -1305,7 +1386,7 @@ void ClientChannel::OnResolverResultChangedLocked(Resolver::Result result) {
 }
 
 void ClientChannel::OnResolverErrorLocked(absl::Status status) {
-  if (resolver_ == nullptr) return;
+  if (resolver_ == nullptr || warm_idle_active_) return;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
     gpr_log(GPR_INFO, "chand=%p: resolver transient failure: %s", this,
             status.ToString().c_str());
@@ -1472,6 +1553,13 @@ void ClientChannel::UpdateServiceConfigInDataPlaneLocked() {
   // Construct dynamic filter stack.
   std::vector<const grpc_channel_filter*> filters =
       config_selector->GetFilters();
+  // The concurrency limit goes above the retry filter, so that it counts
+  // calls rather than attempts.
+  if (service_config != nullptr &&
+      service_config->GetGlobalParsedConfig(
+          ConcurrencyLimitServiceConfigParser::ParserIndex()) != nullptr) {
+    filters.push_back(&kConcurrencyLimitFilterVtable);
+  }
   if (enable_retries) {
     filters.push_back(&kRetryFilterVtable);
   } else {
@@ -1538,21 +1626,27 @@ void ClientChannel::CreateResolverLocked() {
 }
 
 void ClientChannel::DestroyResolverAndLbPolicyLocked() {
+  warm_idle_active_ = false;
+  last_resolver_result_.reset();
   if (resolver_ != nullptr) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
       gpr_log(GPR_INFO, "chand=%p: shutting down resolver=%p", this,
               resolver_.get());
     }
     resolver_.reset();
-    if (lb_policy_ != nullptr) {
-      if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
-        gpr_log(GPR_INFO, "chand=%p: shutting down lb_policy=%p", this,
-                lb_policy_.get());
-      }
-      grpc_pollset_set_del_pollset_set(lb_policy_->interested_parties(),
-                                       interested_parties_);
-      lb_policy_.reset();
+    DestroyLbPolicyLocked();
+  }
+}
+
+void ClientChannel::DestroyLbPolicyLocked() {
+  if (lb_policy_ != nullptr) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+      gpr_log(GPR_INFO, "chand=%p: shutting down lb_policy=%p", this,
+              lb_policy_.get());
     }
+    grpc_pollset_set_del_pollset_set(lb_policy_->interested_parties(),
+                                     interested_parties_);
+    lb_policy_.reset();
   }
 }
 
@@ -1588,12 +1682,15 @@ void ClientChannel::UpdateStateAndPickerLocked(
             channelz::ChannelNode::GetChannelConnectivityStateChangeString(
                 state)));
   }
-  // Grab data plane lock to update the picker.
+  // Grab data plane lock to update the picker.  New picks don't need the
+  // lock, so they go straight to the new picker while we re-process the queued
+  // ones here, all in one pass under the lock.
+  RefCountedPtr<PickerWrapper> old_picker;
   {
     MutexLock lock(&data_plane_mu_);
     // Swap out the picker.
     // Note: Original value will be destroyed after the lock is released.
-    picker_.swap(picker);
+    old_picker = SwapPickerLocked(std::move(picker));
     // Re-process queued picks.
     for (LbQueuedCall* call = lb_queued_calls_; call != nullptr;
          call = call->next) {
@@ -1652,11 +1749,9 @@ grpc_error_handle ClientChannel::DoPingLocked(grpc_transport_op* op) {
   if (state_tracker_.state() != GRPC_CHANNEL_READY) {
     return GRPC_ERROR_CREATE_FROM_STATIC_STRING("channel not connected");
   }
-  LoadBalancingPolicy::PickResult result;
-  {
-    MutexLock lock(&data_plane_mu_);
-    result = picker_->Pick(LoadBalancingPolicy::PickArgs());
-  }
+  RefCountedPtr<PickerWrapper> picker = GetPicker();
+  LoadBalancingPolicy::PickResult result =
+      picker->picker()->Pick(LoadBalancingPolicy::PickArgs());
   return HandlePickResult<grpc_error_handle>(
       &result,
       // Complete pick.
@@ -1717,11 +1812,20 @@ void ClientChannel::StartTransportOpLocked(grpc_transport_op* op) {
       gpr_log(GPR_INFO, "chand=%p: disconnect_with_error: %s", this,
               grpc_error_std_string(op->disconnect_with_error).c_str());
     }
-    DestroyResolverAndLbPolicyLocked();
     intptr_t value;
     if (grpc_error_get_int(op->disconnect_with_error,
                            GRPC_ERROR_INT_CHANNEL_CONNECTIVITY_STATE, &value) &&
         static_cast<grpc_connectivity_state>(value) == GRPC_CHANNEL_IDLE) {
+      // In warm idle only the LB policy goes, taking the connections with
+      // it; the resolver keeps running and its results are held until the
+      // channel is used again.
+      if (warm_idle_ && resolver_ != nullptr &&
+          disconnect_error_ == GRPC_ERROR_NONE) {
+        DestroyLbPolicyLocked();
+        warm_idle_active_ = true;
+      } else {
+        DestroyResolverAndLbPolicyLocked();
+      }
       if (disconnect_error_ == GRPC_ERROR_NONE) {
         // Enter IDLE state.
         UpdateStateAndPickerLocked(GRPC_CHANNEL_IDLE, absl::Status(),
@@ -1730,6 +1834,7 @@ void ClientChannel::StartTransportOpLocked(grpc_transport_op* op) {
       GRPC_ERROR_UNREF(op->disconnect_with_error);
     } else {
       // Disconnect.
+      DestroyResolverAndLbPolicyLocked();
       GPR_ASSERT(disconnect_error_ == GRPC_ERROR_NONE);
       disconnect_error_ = op->disconnect_with_error;
       UpdateStateAndPickerLocked(
@@ -1801,6 +1906,21 @@ void ClientChannel::TryToConnectLocked() {
     lb_policy_->ExitIdleLocked();
   } else if (resolver_ == nullptr) {
     CreateResolverLocked();
+  } else if (warm_idle_active_) {
+    // Leaving warm idle: apply the last resolver result right away rather
+    // than waiting for the resolver.
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
+      gpr_log(GPR_INFO, "chand=%p: leaving warm idle", this);
+    }
+    warm_idle_active_ = false;
+    UpdateStateAndPickerLocked(
+        GRPC_CHANNEL_CONNECTING, absl::Status(), "leaving warm idle",
+        absl::make_unique<LoadBalancingPolicy::QueuePicker>(nullptr));
+    if (last_resolver_result_.has_value()) {
+      Resolver::Result result = std::move(*last_resolver_result_);
+      last_resolver_result_.reset();
+      OnResolverResultChangedLocked(std::move(result));
+    }
   }
   GRPC_CHANNEL_STACK_UNREF(owning_stack_, "TryToConnect");
 }
@@ -2359,6 +2479,7 @@ bool ClientChannel::CallData::CheckResolutionLocked(grpc_call_element* elem,
   // Apply service config to call if not yet applied.
   if (GPR_LIKELY(!service_config_applied_)) {
     service_config_applied_ = true;
+    RpcTimeline::Record(call_context_, GRPC_RPC_TIMELINE_NAME_RESOLVED);
     *error = ApplyServiceConfigToCallLocked(elem, initial_metadata_batch);
   }
   MaybeRemoveCallFromResolverQueuedCallsLocked(elem);
@@ -2802,13 +2923,11 @@ void ClientChannel::LoadBalancedCall::StartTransportStreamOpBatch(
   }
   // Add the batch to the pending list.
   PendingBatchesAdd(batch);
-  // For batches containing a send_initial_metadata op, acquire the
-  // channel's data plane mutex to pick a subchannel.
+  // For batches containing a send_initial_metadata op, pick a subchannel.
   if (GPR_LIKELY(batch->send_initial_metadata)) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_call_trace)) {
-      gpr_log(GPR_INFO,
-              "chand=%p lb_call=%p: grabbing data plane mutex to perform pick",
-              chand_, this);
+      gpr_log(GPR_INFO, "chand=%p lb_call=%p: performing pick", chand_,
+              this);
     }
     PickSubchannel(this, GRPC_ERROR_NONE);
   } else {
@@ -2912,6 +3031,7 @@ void ClientChannel::LoadBalancedCall::RecvTrailingMetadataReady(
 }
 
 void ClientChannel::LoadBalancedCall::CreateSubchannelCall() {
+  RpcTimeline::Record(call_context_, GRPC_RPC_TIMELINE_LB_PICK_COMPLETE);
   SubchannelCall::Args call_args = {
       std::move(connected_subchannel_), pollent_, path_.Ref(), /*start_time=*/0,
       deadline_, arena_,
@@ -3033,10 +3153,23 @@ void ClientChannel::LoadBalancedCall::PickDone(void* arg,
 void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
                                                      grpc_error_handle error) {
   auto* self = static_cast<LoadBalancedCall*>(arg);
-  bool pick_complete;
-  {
+  // Pick with the current picker without taking the data plane mutex.  Only
+  // a call that has to wait for another picker needs the mutex, to queue it.
+  RefCountedPtr<PickerWrapper> picker = self->chand_->GetPicker();
+  bool pick_complete =
+      picker != nullptr && self->PickSubchannelImpl(picker->picker(), &error);
+  if (!pick_complete) {
     MutexLock lock(&self->chand_->data_plane_mu_);
-    pick_complete = self->PickSubchannelLocked(&error);
+    if (picker != nullptr &&
+        self->chand_->picker_.load(std::memory_order_relaxed) ==
+            picker.get()) {
+      // The picker is still current, so the next picker will re-process the
+      // call.
+      self->MaybeAddCallToLbQueuedCallsLocked();
+    } else {
+      // There's a new picker already: try it.
+      pick_complete = self->PickSubchannelLocked(&error);
+    }
   }
   if (pick_complete) {
     PickDone(self, error);
@@ -3046,6 +3179,17 @@ void ClientChannel::LoadBalancedCall::PickSubchannel(void* arg,
 
 bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
     grpc_error_handle* error) {
+  if (PickSubchannelImpl(
+          chand_->picker_.load(std::memory_order_relaxed)->picker(), error)) {
+    MaybeRemoveCallFromLbQueuedCallsLocked();
+    return true;
+  }
+  MaybeAddCallToLbQueuedCallsLocked();
+  return false;
+}
+
+bool ClientChannel::LoadBalancedCall::PickSubchannelImpl(
+    LoadBalancingPolicy::SubchannelPicker* picker, grpc_error_handle* error) {
   GPR_ASSERT(connected_subchannel_ == nullptr);
   GPR_ASSERT(subchannel_call_ == nullptr);
   // Grab initial metadata.
@@ -3062,20 +3206,18 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
   pick_args.call_state = &lb_call_state;
   Metadata initial_metadata(initial_metadata_batch);
   pick_args.initial_metadata = &initial_metadata;
-  auto result = chand_->picker_->Pick(pick_args);
+  auto result = picker->Pick(pick_args);
   return HandlePickResult<bool>(
       &result,
       // CompletePick
-      [this](LoadBalancingPolicy::PickResult::Complete* complete_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
+      [this](LoadBalancingPolicy::PickResult::Complete* complete_pick) {
             if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
               gpr_log(GPR_INFO,
                       "chand=%p lb_call=%p: LB pick succeeded: subchannel=%p",
                       chand_, this, complete_pick->subchannel.get());
             }
             GPR_ASSERT(complete_pick->subchannel != nullptr);
-            // Grab a ref to the connected subchannel while we're still
-            // holding the data plane mutex.
+            // Grab a ref to the connected subchannel.
             SubchannelWrapper* subchannel = static_cast<SubchannelWrapper*>(
                 complete_pick->subchannel.get());
             connected_subchannel_ = subchannel->connected_subchannel();
@@ -3090,7 +3232,6 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
                         "has no connected subchannel; queueing pick",
                         chand_, this);
               }
-              MaybeAddCallToLbQueuedCallsLocked();
               return false;
             }
             lb_subchannel_call_tracker_ =
@@ -3098,23 +3239,19 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
             if (lb_subchannel_call_tracker_ != nullptr) {
               lb_subchannel_call_tracker_->Start();
             }
-            MaybeRemoveCallFromLbQueuedCallsLocked();
             return true;
           },
       // QueuePick
-      [this](LoadBalancingPolicy::PickResult::Queue* /*queue_pick*/)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
+      [this](LoadBalancingPolicy::PickResult::Queue* /*queue_pick*/) {
             if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
               gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick queued", chand_,
                       this);
             }
-            MaybeAddCallToLbQueuedCallsLocked();
             return false;
           },
       // FailPick
       [this, send_initial_metadata_flags,
-       &error](LoadBalancingPolicy::PickResult::Fail* fail_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
+       &error](LoadBalancingPolicy::PickResult::Fail* fail_pick) {
             if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
               gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick failed: %s",
                       chand_, this, fail_pick->status.ToString().c_str());
@@ -3128,17 +3265,14 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
               *error = GRPC_ERROR_CREATE_REFERENCING_FROM_STATIC_STRING(
                   "Failed to pick subchannel", &lb_error, 1);
               GRPC_ERROR_UNREF(lb_error);
-              MaybeRemoveCallFromLbQueuedCallsLocked();
               return true;
             }
             // If wait_for_ready is true, then queue to retry when we get a new
             // picker.
-            MaybeAddCallToLbQueuedCallsLocked();
             return false;
           },
       // DropPick
-      [this, &error](LoadBalancingPolicy::PickResult::Drop* drop_pick)
-          ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_) {
+      [this, &error](LoadBalancingPolicy::PickResult::Drop* drop_pick) {
             if (GRPC_TRACE_FLAG_ENABLED(grpc_client_channel_routing_trace)) {
               gpr_log(GPR_INFO, "chand=%p lb_call=%p: LB pick dropped: %s",
                       chand_, this, drop_pick->status.ToString().c_str());
@@ -3146,7 +3280,6 @@ bool ClientChannel::LoadBalancedCall::PickSubchannelLocked(
             *error =
                 grpc_error_set_int(absl_status_to_grpc_error(drop_pick->status),
                                    GRPC_ERROR_INT_LB_POLICY_DROP, 1);
-            MaybeRemoveCallFromLbQueuedCallsLocked();
             return true;
           });
 }
@@ -19,6 +19,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <map>
 #include <memory>
 #include <set>
@@ -92,6 +93,8 @@ class ClientChannel {
   // Returns the ClientChannel object from channel, or null if channel
   // is not a client channel.
   static ClientChannel* GetFromChannel(grpc_channel* channel);
+  // Same as above, from the channel stack.
+  static ClientChannel* GetFromChannelStack(grpc_channel_stack* channel_stack);
 
   grpc_connectivity_state CheckConnectivityState(bool try_to_connect);
 
@@ -150,6 +153,7 @@ class ClientChannel {
   class ClientChannelControlHelper;
   class ConnectivityWatcherAdder;
   class ConnectivityWatcherRemover;
+  class PickerWrapper;
 
   // Represents a pending connectivity callback from an external caller
   // via grpc_client_channel_watch_connectivity_state().
@@ -244,6 +248,7 @@ class ClientChannel {
   void CreateResolverLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
   void DestroyResolverAndLbPolicyLocked()
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
+  void DestroyLbPolicyLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
 
   grpc_error_handle DoPingLocked(grpc_transport_op* op)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(work_serializer_);
@@ -261,6 +266,15 @@ class ClientChannel {
                                 grpc_polling_entity* pollent)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(resolution_mu_);
 
+  // Returns a ref to the current picker (null if there is none), without
+  // taking data_plane_mu_.
+  RefCountedPtr<PickerWrapper> GetPicker();
+  // Installs a new picker and returns the previous one.  Once this returns,
+  // no pick can be about to take a ref to the previous picker.
+  RefCountedPtr<PickerWrapper> SwapPickerLocked(
+      std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
+
   // These methods all require holding data_plane_mu_.
   void AddLbQueuedCall(LbQueuedCall* call, grpc_polling_entity* pollent)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(data_plane_mu_);
@@ -271,6 +285,8 @@ class ClientChannel {
   // Fields set at construction and never modified.
   //
   const bool deadline_checking_enabled_;
+  // Whether entering IDLE keeps the resolver (GRPC_ARG_CLIENT_IDLE_WARM).
+  const bool warm_idle_;
   grpc_channel_stack* owning_stack_;
   ClientChannelFactory* client_channel_factory_;
   const grpc_channel_args* channel_args_;
@@ -301,8 +317,14 @@ class ClientChannel {
   // Fields used in the data plane.  Guarded by data_plane_mu_.
   //
   mutable Mutex data_plane_mu_;
-  std::unique_ptr<LoadBalancingPolicy::SubchannelPicker> picker_
-      ABSL_GUARDED_BY(data_plane_mu_);
+  // The current picker, which holds a ref.  Replaced only while holding
+  // data_plane_mu_, but read by picks without it: see GetPicker().
+  std::atomic<PickerWrapper*> picker_{nullptr};
+  // Picks register in picker_readers_[picker_epoch_ % 2] while they take a
+  // ref to picker_, so that SwapPickerLocked() can tell when the picks that
+  // may have seen the previous picker are done with the pointer.
+  std::atomic<uint32_t> picker_epoch_{0};
+  std::atomic<uint32_t> picker_readers_[2] = {{0}, {0}};
   // Linked list of calls queued waiting for LB pick.
   LbQueuedCall* lb_queued_calls_ ABSL_GUARDED_BY(data_plane_mu_) = nullptr;
 
@@ -320,6 +342,11 @@ class ClientChannel {
       ABSL_GUARDED_BY(work_serializer_);
   OrphanablePtr<LoadBalancingPolicy> lb_policy_
       ABSL_GUARDED_BY(work_serializer_);
+  // With warm_idle_, the last resolver result, replayed when the channel
+  // leaves IDLE, and whether the channel is in IDLE with its resolver up.
+  absl::optional<Resolver::Result> last_resolver_result_
+      ABSL_GUARDED_BY(work_serializer_);
+  bool warm_idle_active_ ABSL_GUARDED_BY(work_serializer_) = false;
   RefCountedPtr<SubchannelPoolInterface> subchannel_pool_
       ABSL_GUARDED_BY(work_serializer_);
   // The number of SubchannelWrapper instances referencing a given Subchannel.
@@ -382,6 +409,7 @@ class ClientChannel::LoadBalancedCall
   // Helper function for performing an LB pick while holding the data plane
   // mutex.  Returns true if the pick is complete, in which case the caller
   // must invoke PickDone() or AsyncPickDone() with the returned error.
+  // Otherwise queues the call until the next picker.
   bool PickSubchannelLocked(grpc_error_handle* error)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&ClientChannel::data_plane_mu_);
   // Schedules a callback to process the completed pick.  The callback
@@ -433,6 +461,11 @@ class ClientChannel::LoadBalancedCall
   static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
 
   void CreateSubchannelCall();
+  // Performs an LB pick with picker.  Returns true if the pick is complete,
+  // as for PickSubchannelLocked(), or false if the call needs to wait for
+  // another picker.  Does not touch the queue of LB picks.
+  bool PickSubchannelImpl(LoadBalancingPolicy::SubchannelPicker* picker,
+                          grpc_error_handle* error);
   // Invoked when a pick is completed, on both success or failure.
   static void PickDone(void* arg, grpc_error_handle error);
   // Removes the call from the channel's list of queued picks if present.
@@ -0,0 +1,723 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// The least_request and peak_ewma LB policies.
+//
+// Both pick among the READY subchannels with the "power of d choices": sample
+// choiceCount of them (2 by default) at random, and send the call to the one
+// with the lowest cost.
+// - least_request: the cost is the number of calls in flight on the
+//   subchannel.
+// - peak_ewma: the cost is the subchannel's latency (an exponentially
+//   weighted moving average, which jumps straight up to any slower sample so
+//   that a backend that slows down is avoided at once), times one more than
+//   the number of calls in flight on it.
+// When backends report their CPU utilization (via ORCA load reports in the
+// trailing metadata), the cost is also scaled by 1 / (1 - utilization): as in
+// an M/M/1 queue, latency grows that way as a backend approaches saturation.
+
+#include <grpc/support/port_platform.h>
+
+#include <math.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/json/json_util.h"
+#include "src/core/lib/transport/connectivity_state.h"
+#include "src/core/lib/transport/error_utils.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_lb_least_request_trace(false, "least_request");
+TraceFlag grpc_lb_peak_ewma_trace(false, "peak_ewma");
+
+namespace {
+
+constexpr char kLeastRequest[] = "least_request";
+constexpr char kPeakEwma[] = "peak_ewma";
+
+constexpr uint32_t kDefaultChoiceCount = 2;
+constexpr uint32_t kMaxChoiceCount = 10;
+constexpr grpc_millis kDefaultDecayTime = 10 * GPR_MS_PER_SEC;
+// Utilization reports above this are capped, so that the cost stays finite
+constexpr double kMaxUtilization = 0.99;
+
+// Random numbers for picks, which are made concurrently on data plane threads:
+// xorshift64* on a per-thread state.
+GPR_THREAD_LOCAL(uint64_t) g_pick_random_state;
+
+uint32_t PickRandom(uint32_t n) {
+  uint64_t x = g_pick_random_state;
+  if (GPR_UNLIKELY(x == 0)) {
+    x = static_cast<uint64_t>(gpr_get_cycle_counter()) ^
+        reinterpret_cast<uintptr_t>(&x) ^ 0x9e3779b97f4a7c15ull;
+    if (x == 0) x = 1;
+  }
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  g_pick_random_state = x;
+  return static_cast<uint32_t>(((x * 0x2545f4914f6cdd1dull) >> 32) % n);
+}
+
+double SecondsSince(gpr_cycle_counter start) {
+  gpr_timespec elapsed = gpr_cycle_counter_sub(gpr_get_cycle_counter(), start);
+  return static_cast<double>(elapsed.tv_sec) +
+         static_cast<double>(elapsed.tv_nsec) / GPR_NS_PER_SEC;
+}
+
+//
+// config
+//
+
+class LoadAwareLbConfig : public LoadBalancingPolicy::Config {
+ public:
+  LoadAwareLbConfig(const char* name, uint32_t choice_count,
+                    grpc_millis decay_time)
+      : name_(name), choice_count_(choice_count), decay_time_(decay_time) {}
+
+  const char* name() const override { return name_; }
+
+  uint32_t choice_count() const { return choice_count_; }
+  grpc_millis decay_time() const { return decay_time_; }
+
+ private:
+  const char* name_;
+  uint32_t choice_count_;
+  grpc_millis decay_time_;
+};
+
+//
+// load of one subchannel, shared with pickers and call trackers
+//
+
+class SubchannelLoad : public RefCounted<SubchannelLoad> {
+ public:
+  explicit SubchannelLoad(double decay_time_seconds)
+      : decay_time_seconds_(decay_time_seconds) {}
+
+  void CallStarted() {
+    calls_in_flight_.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  void CallFinished(const absl::Status& status, double latency_seconds,
+                    const LoadBalancingPolicy::BackendMetricAccessor::
+                        BackendMetricData* backend_metric_data) {
+    calls_in_flight_.fetch_sub(1, std::memory_order_relaxed);
+    if (backend_metric_data != nullptr) {
+      utilization_.store(std::min(std::max(backend_metric_data->cpu_utilization,
+                                           0.0),
+                                  kMaxUtilization),
+                         std::memory_order_relaxed);
+    }
+    // A failure that's quicker than the average says nothing good about the
+    // backend: don't let it pull the average down.
+    MutexLock lock(&mu_);
+    const double ewma = latency_ewma_.load(std::memory_order_relaxed);
+    if (last_sample_time_ == 0 || latency_seconds > ewma) {
+      latency_ewma_.store(latency_seconds, std::memory_order_relaxed);
+    } else if (status.ok()) {
+      const double weight =
+          exp(-SecondsSince(last_sample_time_) / decay_time_seconds_);
+      latency_ewma_.store(ewma * weight + latency_seconds * (1 - weight),
+                          std::memory_order_relaxed);
+    }
+    last_sample_time_ = gpr_get_cycle_counter();
+    has_latency_.store(true, std::memory_order_release);
+  }
+
+  double LeastRequestCost() const {
+    return (calls_in_flight_.load(std::memory_order_relaxed) + 1) *
+           UtilizationFactor();
+  }
+
+  double PeakEwmaCost() const {
+    const uint32_t calls_in_flight =
+        calls_in_flight_.load(std::memory_order_relaxed);
+    if (!has_latency_.load(std::memory_order_acquire)) {
+      // Nothing known yet: try a backend that hasn't been tried, but don't
+      // send it everything before the first response.
+      return calls_in_flight == 0 ? 0
+                                  : std::numeric_limits<double>::infinity();
+    }
+    return latency_ewma_.load(std::memory_order_relaxed) *
+           (calls_in_flight + 1) * UtilizationFactor();
+  }
+
+ private:
+  double UtilizationFactor() const {
+    return 1 / (1 - utilization_.load(std::memory_order_relaxed));
+  }
+
+  const double decay_time_seconds_;
+  std::atomic<uint32_t> calls_in_flight_{0};
+  std::atomic<double> utilization_{0};
+  std::atomic<bool> has_latency_{false};
+  std::atomic<double> latency_ewma_{0};
+  Mutex mu_;
+  gpr_cycle_counter last_sample_time_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+class CallTracker : public LoadBalancingPolicy::SubchannelCallTrackerInterface {
+ public:
+  explicit CallTracker(RefCountedPtr<SubchannelLoad> load)
+      : load_(std::move(load)) {}
+
+  void Start() override {
+    start_time_ = gpr_get_cycle_counter();
+    load_->CallStarted();
+  }
+
+  void Finish(FinishArgs args) override {
+    load_->CallFinished(args.status, SecondsSince(start_time_),
+                        args.backend_metric_accessor->GetBackendMetricData());
+  }
+
+ private:
+  RefCountedPtr<SubchannelLoad> load_;
+  gpr_cycle_counter start_time_ = 0;
+};
+
+//
+// least_request and peak_ewma LB policies
+//
+
+class LoadAwarePolicy : public LoadBalancingPolicy {
+ public:
+  enum class Cost { kCallsInFlight, kPeakEwma };
+
+  LoadAwarePolicy(Args args, Cost cost);
+
+  const char* name() const override {
+    return cost_ == Cost::kCallsInFlight ? kLeastRequest : kPeakEwma;
+  }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ResetBackoffLocked() override;
+
+ private:
+  ~LoadAwarePolicy() override;
+
+  TraceFlag& tracer() const {
+    return cost_ == Cost::kCallsInFlight ? grpc_lb_least_request_trace
+                                         : grpc_lb_peak_ewma_trace;
+  }
+
+  // Forward declaration.
+  class LoadAwareSubchannelList;
+
+  // Data for a particular subchannel in a subchannel list.
+  // This subclass adds the following functionality:
+  // - Tracks the previous connectivity state of the subchannel, so that
+  //   we know how many subchannels are in each state.
+  // - Holds the subchannel's load.
+  class LoadAwareSubchannelData
+      : public SubchannelData<LoadAwareSubchannelList,
+                              LoadAwareSubchannelData> {
+   public:
+    LoadAwareSubchannelData(
+        SubchannelList<LoadAwareSubchannelList, LoadAwareSubchannelData>*
+            subchannel_list,
+        const ServerAddress& address,
+        RefCountedPtr<SubchannelInterface> subchannel);
+
+    grpc_connectivity_state connectivity_state() const {
+      return last_connectivity_state_;
+    }
+
+    const RefCountedPtr<SubchannelLoad>& load() const { return load_; }
+
+    // Performs connectivity state updates that need to be done both when we
+    // first start watching and when a watcher notification is received.
+    void UpdateConnectivityStateLocked(
+        grpc_connectivity_state connectivity_state);
+
+   private:
+    // Performs connectivity state updates that need to be done only
+    // after we have started watching.
+    void ProcessConnectivityChangeLocked(
+        grpc_connectivity_state connectivity_state) override;
+
+    grpc_connectivity_state last_connectivity_state_ = GRPC_CHANNEL_IDLE;
+    bool seen_failure_since_ready_ = false;
+    RefCountedPtr<SubchannelLoad> load_;
+  };
+
+  // A list of subchannels.
+  class LoadAwareSubchannelList
+      : public SubchannelList<LoadAwareSubchannelList,
+                              LoadAwareSubchannelData> {
+   public:
+    LoadAwareSubchannelList(LoadAwarePolicy* policy,
+                            ServerAddressList addresses,
+                            const grpc_channel_args& args)
+        : SubchannelList(policy, &policy->tracer(), std::move(addresses),
+                         policy->channel_control_helper(), args) {
+      // Need to maintain a ref to the LB policy as long as we maintain
+      // any references to subchannels, since the subchannels'
+      // pollset_sets will include the LB policy's pollset_set.
+      policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+    }
+
+    ~LoadAwareSubchannelList() override {
+      LoadAwarePolicy* p = static_cast<LoadAwarePolicy*>(policy());
+      p->Unref(DEBUG_LOCATION, "subchannel_list");
+    }
+
+    // Starts watching the subchannels in this list.
+    void StartWatchingLocked();
+
+    // Updates the counters of subchannels in each state when a
+    // subchannel transitions from old_state to new_state.
+    void UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                                   grpc_connectivity_state new_state);
+
+    // Promotes this list to be the policy's current list if it's ready to
+    // be, then updates the policy's connectivity state from the counters of
+    // subchannels in each state.
+    void UpdateStateFromSubchannelStateCountsLocked();
+
+   private:
+    // If this subchannel list is the policy's current subchannel list,
+    // updates the policy's connectivity state.
+    void MaybeUpdateConnectivityStateLocked();
+
+    size_t num_ready_ = 0;
+    size_t num_connecting_ = 0;
+    size_t num_transient_failure_ = 0;
+  };
+
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(LoadAwarePolicy* parent, LoadAwareSubchannelList* subchannel_list);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    struct Entry {
+      RefCountedPtr<SubchannelInterface> subchannel;
+      RefCountedPtr<SubchannelLoad> load;
+    };
+
+    double CostOf(const Entry& entry) const {
+      return cost_ == Cost::kCallsInFlight ? entry.load->LeastRequestCost()
+                                           : entry.load->PeakEwmaCost();
+    }
+
+    // Using pointer value only, no ref held -- do not dereference!
+    LoadAwarePolicy* parent_;
+    const Cost cost_;
+    const uint32_t choice_count_;
+    absl::InlinedVector<Entry, 10> subchannels_;
+  };
+
+  void ShutdownLocked() override;
+
+  const Cost cost_;
+  RefCountedPtr<LoadAwareLbConfig> config_;
+
+  // List of subchannels.
+  OrphanablePtr<LoadAwareSubchannelList> subchannel_list_;
+  // Latest pending subchannel list.
+  // When we get an updated address list, we create a new subchannel list
+  // for it here, and we wait to swap it into subchannel_list_ until the new
+  // list becomes READY.
+  OrphanablePtr<LoadAwareSubchannelList> latest_pending_subchannel_list_;
+
+  bool shutdown_ = false;
+};
+
+//
+// LoadAwarePolicy::Picker
+//
+
+LoadAwarePolicy::Picker::Picker(LoadAwarePolicy* parent,
+                                LoadAwareSubchannelList* subchannel_list)
+    : parent_(parent),
+      cost_(parent->cost_),
+      choice_count_(parent->config_->choice_count()) {
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    LoadAwareSubchannelData* sd = subchannel_list->subchannel(i);
+    if (sd->connectivity_state() == GRPC_CHANNEL_READY) {
+      subchannels_.push_back({sd->subchannel()->Ref(), sd->load()});
+    }
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(parent->tracer())) {
+    gpr_log(GPR_INFO,
+            "[%s %p picker %p] created picker from subchannel_list=%p "
+            "with %" PRIuPTR " READY subchannels",
+            parent_->name(), parent_, this, subchannel_list,
+            subchannels_.size());
+  }
+}
+
+LoadAwarePolicy::PickResult LoadAwarePolicy::Picker::Pick(
+    PickArgs /*args*/) {
+  const uint32_t num_subchannels = static_cast<uint32_t>(subchannels_.size());
+  // Sample choice_count_ subchannels (with replacement, which keeps picks
+  // cheap and barely matters) and keep the cheapest.
+  const Entry* best = &subchannels_[PickRandom(num_subchannels)];
+  double best_cost = CostOf(*best);
+  for (uint32_t i = 1; i < choice_count_ && num_subchannels > 1; ++i) {
+    const Entry* candidate = &subchannels_[PickRandom(num_subchannels)];
+    const double cost = CostOf(*candidate);
+    if (cost < best_cost) {
+      best = candidate;
+      best_cost = cost;
+    }
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(parent_->tracer())) {
+    gpr_log(GPR_INFO, "[%s %p picker %p] returning subchannel=%p (cost %f)",
+            parent_->name(), parent_, this, best->subchannel.get(), best_cost);
+  }
+  return PickResult::Complete(best->subchannel,
+                              absl::make_unique<CallTracker>(best->load));
+}
+
+//
+// LoadAwarePolicy
+//
+
+LoadAwarePolicy::LoadAwarePolicy(Args args, Cost cost)
+    : LoadBalancingPolicy(std::move(args)), cost_(cost) {
+  if (GRPC_TRACE_FLAG_ENABLED(tracer())) {
+    gpr_log(GPR_INFO, "[%s %p] Created", name(), this);
+  }
+}
+
+LoadAwarePolicy::~LoadAwarePolicy() {
+  if (GRPC_TRACE_FLAG_ENABLED(tracer())) {
+    gpr_log(GPR_INFO, "[%s %p] Destroying", name(), this);
+  }
+  GPR_ASSERT(subchannel_list_ == nullptr);
+  GPR_ASSERT(latest_pending_subchannel_list_ == nullptr);
+}
+
+void LoadAwarePolicy::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(tracer())) {
+    gpr_log(GPR_INFO, "[%s %p] Shutting down", name(), this);
+  }
+  shutdown_ = true;
+  subchannel_list_.reset();
+  latest_pending_subchannel_list_.reset();
+}
+
+void LoadAwarePolicy::ResetBackoffLocked() {
+  subchannel_list_->ResetBackoffLocked();
+  if (latest_pending_subchannel_list_ != nullptr) {
+    latest_pending_subchannel_list_->ResetBackoffLocked();
+  }
+}
+
+void LoadAwarePolicy::LoadAwareSubchannelList::StartWatchingLocked() {
+  if (num_subchannels() == 0) return;
+  // Check current state of each subchannel synchronously, since any
+  // subchannel already used by some other channel may have a non-IDLE
+  // state.
+  for (size_t i = 0; i < num_subchannels(); ++i) {
+    grpc_connectivity_state state =
+        subchannel(i)->CheckConnectivityStateLocked();
+    if (state != GRPC_CHANNEL_IDLE) {
+      subchannel(i)->UpdateConnectivityStateLocked(state);
+    }
+  }
+  // Start connectivity watch for each subchannel.
+  for (size_t i = 0; i < num_subchannels(); i++) {
+    if (subchannel(i)->subchannel() != nullptr) {
+      subchannel(i)->StartConnectivityWatchLocked();
+      subchannel(i)->subchannel()->AttemptToConnect();
+    }
+  }
+  // Now set the LB policy's state based on the subchannels' states.
+  UpdateStateFromSubchannelStateCountsLocked();
+}
+
+void LoadAwarePolicy::LoadAwareSubchannelList::UpdateStateCountersLocked(
+    grpc_connectivity_state old_state, grpc_connectivity_state new_state) {
+  GPR_ASSERT(old_state != GRPC_CHANNEL_SHUTDOWN);
+  GPR_ASSERT(new_state != GRPC_CHANNEL_SHUTDOWN);
+  if (old_state == GRPC_CHANNEL_READY) {
+    GPR_ASSERT(num_ready_ > 0);
+    --num_ready_;
+  } else if (old_state == GRPC_CHANNEL_CONNECTING) {
+    GPR_ASSERT(num_connecting_ > 0);
+    --num_connecting_;
+  } else if (old_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    GPR_ASSERT(num_transient_failure_ > 0);
+    --num_transient_failure_;
+  }
+  if (new_state == GRPC_CHANNEL_READY) {
+    ++num_ready_;
+  } else if (new_state == GRPC_CHANNEL_CONNECTING) {
+    ++num_connecting_;
+  } else if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    ++num_transient_failure_;
+  }
+}
+
+// Sets the policy's connectivity state and generates a new picker based
+// on the current subchannel list, with the same rules as round_robin.
+void LoadAwarePolicy::LoadAwareSubchannelList::
+    MaybeUpdateConnectivityStateLocked() {
+  LoadAwarePolicy* p = static_cast<LoadAwarePolicy*>(policy());
+  // Only set connectivity state if this is the current subchannel list.
+  if (p->subchannel_list_.get() != this) return;
+  if (num_ready_ > 0) {
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_READY, absl::Status(), absl::make_unique<Picker>(p, this));
+  } else if (num_connecting_ > 0) {
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_CONNECTING, absl::Status(),
+        absl::make_unique<QueuePicker>(p->Ref(DEBUG_LOCATION, "QueuePicker")));
+  } else if (num_transient_failure_ == num_subchannels()) {
+    absl::Status status =
+        absl::UnavailableError("connections to all backends failing");
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, status,
+        absl::make_unique<TransientFailurePicker>(status));
+  }
+}
+
+void LoadAwarePolicy::LoadAwareSubchannelList::
+    UpdateStateFromSubchannelStateCountsLocked() {
+  LoadAwarePolicy* p = static_cast<LoadAwarePolicy*>(policy());
+  // If we have at least one READY subchannel, or all of them are in
+  // TRANSIENT_FAILURE, swap to the new list.
+  if (num_ready_ > 0 || num_transient_failure_ == num_subchannels()) {
+    if (p->subchannel_list_.get() != this) {
+      GPR_ASSERT(p->latest_pending_subchannel_list_.get() == this);
+      GPR_ASSERT(!shutting_down());
+      if (GRPC_TRACE_FLAG_ENABLED(p->tracer())) {
+        const size_t old_num_subchannels =
+            p->subchannel_list_ != nullptr
+                ? p->subchannel_list_->num_subchannels()
+                : 0;
+        gpr_log(GPR_INFO,
+                "[%s %p] phasing out subchannel list %p (size %" PRIuPTR
+                ") in favor of %p (size %" PRIuPTR ")",
+                p->name(), p, p->subchannel_list_.get(), old_num_subchannels,
+                this, num_subchannels());
+      }
+      p->subchannel_list_ = std::move(p->latest_pending_subchannel_list_);
+    }
+  }
+  MaybeUpdateConnectivityStateLocked();
+}
+
+LoadAwarePolicy::LoadAwareSubchannelData::LoadAwareSubchannelData(
+    SubchannelList<LoadAwareSubchannelList, LoadAwareSubchannelData>*
+        subchannel_list,
+    const ServerAddress& address, RefCountedPtr<SubchannelInterface> subchannel)
+    : SubchannelData(subchannel_list, address, std::move(subchannel)) {
+  LoadAwarePolicy* p = static_cast<LoadAwarePolicy*>(subchannel_list->policy());
+  load_ = MakeRefCounted<SubchannelLoad>(
+      static_cast<double>(p->config_->decay_time()) / GPR_MS_PER_SEC);
+}
+
+void LoadAwarePolicy::LoadAwareSubchannelData::UpdateConnectivityStateLocked(
+    grpc_connectivity_state connectivity_state) {
+  LoadAwarePolicy* p =
+      static_cast<LoadAwarePolicy*>(subchannel_list()->policy());
+  if (GRPC_TRACE_FLAG_ENABLED(p->tracer())) {
+    gpr_log(
+        GPR_INFO,
+        "[%s %p] connectivity changed for subchannel %p, subchannel_list %p "
+        "(index %" PRIuPTR " of %" PRIuPTR "): prev_state=%s new_state=%s",
+        p->name(), p, subchannel(), subchannel_list(), Index(),
+        subchannel_list()->num_subchannels(),
+        ConnectivityStateName(last_connectivity_state_),
+        ConnectivityStateName(connectivity_state));
+  }
+  // As in round_robin: once we see a failure, report TRANSIENT_FAILURE until
+  // the subchannel is READY again.
+  if (!seen_failure_since_ready_) {
+    if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      seen_failure_since_ready_ = true;
+    }
+    subchannel_list()->UpdateStateCountersLocked(last_connectivity_state_,
+                                                 connectivity_state);
+  } else {
+    if (connectivity_state == GRPC_CHANNEL_READY) {
+      seen_failure_since_ready_ = false;
+      subchannel_list()->UpdateStateCountersLocked(
+          GRPC_CHANNEL_TRANSIENT_FAILURE, connectivity_state);
+    }
+  }
+  last_connectivity_state_ = connectivity_state;
+}
+
+void LoadAwarePolicy::LoadAwareSubchannelData::ProcessConnectivityChangeLocked(
+    grpc_connectivity_state connectivity_state) {
+  LoadAwarePolicy* p =
+      static_cast<LoadAwarePolicy*>(subchannel_list()->policy());
+  GPR_ASSERT(subchannel() != nullptr);
+  // If the new state is TRANSIENT_FAILURE, re-resolve and attempt to
+  // reconnect.
+  if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    if (GRPC_TRACE_FLAG_ENABLED(p->tracer())) {
+      gpr_log(GPR_INFO,
+              "[%s %p] Subchannel %p has gone into TRANSIENT_FAILURE. "
+              "Requesting re-resolution",
+              p->name(), p, subchannel());
+    }
+    p->channel_control_helper()->RequestReresolution();
+    subchannel()->AttemptToConnect();
+  }
+  UpdateConnectivityStateLocked(connectivity_state);
+  subchannel_list()->UpdateStateFromSubchannelStateCountsLocked();
+}
+
+void LoadAwarePolicy::UpdateLocked(UpdateArgs args) {
+  config_ = std::move(args.config);
+  ServerAddressList addresses;
+  if (args.addresses.ok()) {
+    if (GRPC_TRACE_FLAG_ENABLED(tracer())) {
+      gpr_log(GPR_INFO, "[%s %p] received update with %" PRIuPTR " addresses",
+              name(), this, args.addresses->size());
+    }
+    addresses = std::move(*args.addresses);
+  } else {
+    if (GRPC_TRACE_FLAG_ENABLED(tracer())) {
+      gpr_log(GPR_INFO, "[%s %p] received update with address error: %s",
+              name(), this, args.addresses.status().ToString().c_str());
+    }
+    // If we already have a subchannel list, then ignore the resolver
+    // failure and keep using the existing list.
+    if (subchannel_list_ != nullptr) return;
+  }
+  // Replace latest_pending_subchannel_list_.
+  if (GRPC_TRACE_FLAG_ENABLED(tracer()) &&
+      latest_pending_subchannel_list_ != nullptr) {
+    gpr_log(GPR_INFO,
+            "[%s %p] Shutting down previous pending subchannel list %p",
+            name(), this, latest_pending_subchannel_list_.get());
+  }
+  latest_pending_subchannel_list_ = MakeOrphanable<LoadAwareSubchannelList>(
+      this, std::move(addresses), *args.args);
+  if (latest_pending_subchannel_list_->num_subchannels() == 0) {
+    // If the new list is empty, immediately promote the new list to the
+    // current list and transition to TRANSIENT_FAILURE.
+    absl::Status status =
+        args.addresses.ok() ? absl::UnavailableError(absl::StrCat(
+                                  "empty address list: ", args.resolution_note))
+                            : args.addresses.status();
+    channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, status,
+        absl::make_unique<TransientFailurePicker>(status));
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+  } else if (subchannel_list_ == nullptr) {
+    // If there is no current list, immediately promote the new list to
+    // the current list and start watching it.
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+    subchannel_list_->StartWatchingLocked();
+  } else {
+    // Start watching the pending list.  It will get swapped into the
+    // current list when it reports READY.
+    latest_pending_subchannel_list_->StartWatchingLocked();
+  }
+}
+
+//
+// factories
+//
+
+class LoadAwareFactory : public LoadBalancingPolicyFactory {
+ public:
+  LoadAwareFactory(const char* name, LoadAwarePolicy::Cost cost)
+      : name_(name), cost_(cost) {}
+
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<LoadAwarePolicy>(std::move(args), cost_);
+  }
+
+  const char* name() const override { return name_; }
+
+  // Both take {"choiceCount": 2}; peak_ewma also takes {"decayTime": "10s"},
+  // how long it takes for a latency sample's weight in the average to fall to
+  // 1/e.
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    std::vector<grpc_error_handle> error_list;
+    uint32_t choice_count = kDefaultChoiceCount;
+    grpc_millis decay_time = kDefaultDecayTime;
+    if (json.type() == Json::Type::OBJECT) {
+      const Json::Object& object = json.object_value();
+      if (ParseJsonObjectField(object, "choiceCount", &choice_count,
+                               &error_list, /*required=*/false)) {
+        if (choice_count < 2) {
+          error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+              "field:choiceCount error:must be at least 2"));
+        }
+        // Like Envoy, quietly cap the choice count.
+        choice_count = std::min(choice_count, kMaxChoiceCount);
+      }
+      if (cost_ == LoadAwarePolicy::Cost::kPeakEwma &&
+          ParseJsonObjectFieldAsDuration(object, "decayTime", &decay_time,
+                                         &error_list, /*required=*/false) &&
+          decay_time <= 0) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:decayTime error:must be greater than 0"));
+      }
+    } else if (json.type() != Json::Type::JSON_NULL) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "error:type should be OBJECT"));
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+          absl::StrCat(name_, " LB policy config").c_str(), &error_list);
+      return nullptr;
+    }
+    return MakeRefCounted<LoadAwareLbConfig>(name_, choice_count, decay_time);
+  }
+
+ private:
+  const char* name_;
+  LoadAwarePolicy::Cost cost_;
+};
+
+}  // namespace
+
+void GrpcLbPolicyLeastRequestInit() {
+  LoadBalancingPolicyRegistry::Builder::RegisterLoadBalancingPolicyFactory(
+      absl::make_unique<LoadAwareFactory>(
+          kLeastRequest, LoadAwarePolicy::Cost::kCallsInFlight));
+  LoadBalancingPolicyRegistry::Builder::RegisterLoadBalancingPolicyFactory(
+      absl::make_unique<LoadAwareFactory>(kPeakEwma,
+                                          LoadAwarePolicy::Cost::kPeakEwma));
+}
+
+void GrpcLbPolicyLeastRequestShutdown() {}
+
+}  // namespace grpc_core
@@ -18,6 +18,9 @@
 
 #include <string.h>
 
+#include <algorithm>
+#include <atomic>
+
 #include <grpc/support/alloc.h>
 
 #include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
@@ -26,6 +29,9 @@
 #include "src/core/lib/address_utils/sockaddr_utils.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/json/json_util.h"
 #include "src/core/lib/resolver/server_address.h"
 #include "src/core/lib/transport/connectivity_state.h"
 #include "src/core/lib/transport/error_utils.h"
@@ -42,6 +48,32 @@ namespace {
 
 constexpr char kPickFirst[] = "pick_first";
 
+// How often the pick rate is sampled to size the set of warm standbys.
+constexpr grpc_millis kPickRateWindow = GPR_MS_PER_SEC;
+
+class PickFirstConfig : public LoadBalancingPolicy::Config {
+ public:
+  PickFirstConfig(uint32_t warmup_percent, uint32_t rpcs_per_second_per_standby)
+      : warmup_percent_(warmup_percent),
+        rpcs_per_second_per_standby_(rpcs_per_second_per_standby) {}
+
+  const char* name() const override { return kPickFirst; }
+
+  // Percentage of the addresses to keep connected, including the selected
+  // one.  The others are warm standbys, ready to take over if the selected
+  // subchannel fails.
+  uint32_t warmup_percent() const { return warmup_percent_; }
+  // Adds a warm standby for each this many RPCs per second picked.  0
+  // disables rate-based standbys.
+  uint32_t rpcs_per_second_per_standby() const {
+    return rpcs_per_second_per_standby_;
+  }
+
+ private:
+  uint32_t warmup_percent_;
+  uint32_t rpcs_per_second_per_standby_;
+};
+
 class PickFirst : public LoadBalancingPolicy {
  public:
   explicit PickFirst(Args args);
@@ -75,6 +107,19 @@ class PickFirst : public LoadBalancingPolicy {
     void ProcessUnselectedReadyLocked();
 
     void CheckConnectivityStateAndStartWatchingLocked();
+
+    bool standby() const { return standby_; }
+    grpc_connectivity_state standby_state() const { return standby_state_; }
+
+    // Starts watching the subchannel and keeping it connected, so that it
+    // can be selected without waiting for a connection and handshake.
+    // Must not be called while there is a connectivity watch pending.
+    void StartStandbyLocked();
+    void StopStandbyLocked();
+
+   private:
+    bool standby_ = false;
+    grpc_connectivity_state standby_state_ = GRPC_CHANNEL_IDLE;
   };
 
   class PickFirstSubchannelList
@@ -106,23 +151,93 @@ class PickFirst : public LoadBalancingPolicy {
     bool in_transient_failure_ = false;
   };
 
+  // Counts picks to estimate the RPC rate.  Shared between the policy and
+  // its pickers.
+  class PickRateTracker : public RefCounted<PickRateTracker> {
+   public:
+    explicit PickRateTracker(uint32_t rpcs_per_second_per_standby)
+        : rpcs_per_second_per_standby_(rpcs_per_second_per_standby),
+          window_start_(ExecCtx::Get()->Now()) {}
+
+    uint32_t rpcs_per_second_per_standby() const {
+      return rpcs_per_second_per_standby_;
+    }
+
+    // Number of warm standbys called for by the last sampled pick rate.
+    size_t num_standbys() const {
+      return num_standbys_.load(std::memory_order_relaxed);
+    }
+
+    // Records a pick.  Returns true if it ended a sampling window and the
+    // number of standbys called for has changed.
+    bool RecordPick(grpc_millis now);
+
+   private:
+    const uint32_t rpcs_per_second_per_standby_;
+    std::atomic<uint64_t> picks_{0};
+    std::atomic<grpc_millis> window_start_;
+    std::atomic<size_t> num_standbys_{0};
+  };
+
   class Picker : public SubchannelPicker {
    public:
-    explicit Picker(RefCountedPtr<SubchannelInterface> subchannel)
-        : subchannel_(std::move(subchannel)) {}
+    Picker(RefCountedPtr<SubchannelInterface> subchannel, PickFirst* policy);
 
-    PickResult Pick(PickArgs /*args*/) override {
-      return PickResult::Complete(subchannel_);
+    ~Picker() override {
+      if (policy_ != nullptr) policy_.reset(DEBUG_LOCATION, "Picker");
     }
 
+    PickResult Pick(PickArgs args) override;
+
    private:
+    // Resizes the set of warm standbys from within the work serializer.
+    class StandbyUpdater {
+     public:
+      explicit StandbyUpdater(RefCountedPtr<PickFirst> policy)
+          : policy_(std::move(policy)) {
+        GRPC_CLOSURE_INIT(&closure_, RunInExecCtx, this, nullptr);
+      }
+
+      void Start() {
+        // Hop into ExecCtx, so that we're not holding the data plane mutex
+        // while we run control-plane code.
+        ExecCtx::Run(DEBUG_LOCATION, &closure_, GRPC_ERROR_NONE);
+      }
+
+     private:
+      static void RunInExecCtx(void* arg, grpc_error_handle /*error*/);
+
+      RefCountedPtr<PickFirst> policy_;
+      grpc_closure closure_;
+    };
+
     RefCountedPtr<SubchannelInterface> subchannel_;
+    // Set only when rate-based standbys are enabled.
+    RefCountedPtr<PickFirst> policy_;
+    RefCountedPtr<PickRateTracker> rate_tracker_;
   };
 
   void ShutdownLocked() override;
 
   void AttemptToConnectUsingLatestUpdateArgsLocked();
 
+  // Returns the number of warm standbys to keep for a subchannel list of
+  // the given size.
+  size_t NumStandbysLocked(size_t num_subchannels) const;
+  // Starts connecting to the subchannels that will be standbys once one in
+  // \a subchannel_list is selected.
+  void PreconnectLocked(PickFirstSubchannelList* subchannel_list);
+  // Brings the set of warm standbys for selected_ to the configured size,
+  // and shuts down the subchannels not needed.
+  void UpdateStandbysLocked();
+  // Returns a READY warm standby, or null if there is none.
+  PickFirstSubchannelData* ReadyStandbyLocked() const;
+
+  // Latest config.  May be null.
+  RefCountedPtr<PickFirstConfig> config_;
+  // Set when rate-based standbys are enabled.
+  RefCountedPtr<PickRateTracker> rate_tracker_;
+
   // Lateset update args.
   UpdateArgs latest_update_args_;
   // All our subchannels.
@@ -178,6 +293,114 @@ void PickFirst::ResetBackoffLocked() {
   }
 }
 
+bool PickFirst::PickRateTracker::RecordPick(grpc_millis now) {
+  picks_.fetch_add(1, std::memory_order_relaxed);
+  grpc_millis window_start = window_start_.load(std::memory_order_relaxed);
+  if (now - window_start < kPickRateWindow) return false;
+  // Only one pick gets to close the window.
+  if (!window_start_.compare_exchange_strong(window_start, now,
+                                             std::memory_order_relaxed)) {
+    return false;
+  }
+  const uint64_t picks = picks_.exchange(0, std::memory_order_relaxed);
+  const uint64_t rpcs_per_second =
+      picks * GPR_MS_PER_SEC / static_cast<uint64_t>(now - window_start);
+  const size_t num_standbys = static_cast<size_t>(
+      (rpcs_per_second + rpcs_per_second_per_standby_ - 1) /
+      rpcs_per_second_per_standby_);
+  return num_standbys_.exchange(num_standbys, std::memory_order_relaxed) !=
+         num_standbys;
+}
+
+PickFirst::Picker::Picker(RefCountedPtr<SubchannelInterface> subchannel,
+                          PickFirst* policy)
+    : subchannel_(std::move(subchannel)),
+      rate_tracker_(policy->rate_tracker_) {
+  if (rate_tracker_ != nullptr) policy_ = policy->Ref(DEBUG_LOCATION, "Picker");
+}
+
+LoadBalancingPolicy::PickResult PickFirst::Picker::Pick(PickArgs /*args*/) {
+  if (rate_tracker_ != nullptr &&
+      rate_tracker_->RecordPick(ExecCtx::Get()->Now())) {
+    (new StandbyUpdater(policy_))->Start();
+  }
+  return PickResult::Complete(subchannel_);
+}
+
+void PickFirst::Picker::StandbyUpdater::RunInExecCtx(
+    void* arg, grpc_error_handle /*error*/) {
+  auto* self = static_cast<StandbyUpdater*>(arg);
+  self->policy_->work_serializer()->Run(
+      [self]() {
+        if (!self->policy_->shutdown_) self->policy_->UpdateStandbysLocked();
+        delete self;
+      },
+      DEBUG_LOCATION);
+}
+
+size_t PickFirst::NumStandbysLocked(size_t num_subchannels) const {
+  if (num_subchannels == 0) return 0;
+  size_t num_standbys = 0;
+  if (config_ != nullptr) {
+    // Round up, and don't count the selected subchannel.
+    const size_t num_warm =
+        (num_subchannels * config_->warmup_percent() + 99) / 100;
+    if (num_warm > 0) num_standbys = num_warm - 1;
+  }
+  if (rate_tracker_ != nullptr) num_standbys += rate_tracker_->num_standbys();
+  return std::min(num_standbys, num_subchannels - 1);
+}
+
+void PickFirst::PreconnectLocked(PickFirstSubchannelList* subchannel_list) {
+  // The first subchannel is connected to as usual.  The ones after it are
+  // connected to without watching them: if the first one fails, the next
+  // one is likely to be READY by the time it's checked.
+  const size_t num_standbys =
+      NumStandbysLocked(subchannel_list->num_subchannels());
+  for (size_t i = 1; i <= num_standbys; ++i) {
+    subchannel_list->subchannel(i)->subchannel()->AttemptToConnect();
+  }
+}
+
+void PickFirst::UpdateStandbysLocked() {
+  if (selected_ == nullptr) return;
+  PickFirstSubchannelList* subchannel_list = selected_->subchannel_list();
+  size_t num_standbys = NumStandbysLocked(subchannel_list->num_subchannels());
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_pick_first_trace) && num_standbys > 0) {
+    gpr_log(GPR_INFO, "Pick First %p keeping %" PRIuPTR " warm standbys", this,
+            num_standbys);
+  }
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    PickFirstSubchannelData* sd = subchannel_list->subchannel(i);
+    if (sd == selected_ || sd->subchannel() == nullptr) continue;
+    if (num_standbys > 0) {
+      --num_standbys;
+      sd->StartStandbyLocked();
+      continue;
+    }
+    sd->StopStandbyLocked();
+    // With rate-based standbys, hold on to the subchannels without a
+    // connection, so that they can be warmed up again if the rate grows.
+    if (rate_tracker_ != nullptr) {
+      grpc_connectivity_state state = sd->CheckConnectivityStateLocked();
+      if (state == GRPC_CHANNEL_IDLE ||
+          state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+        continue;
+      }
+    }
+    sd->ShutdownLocked();
+  }
+}
+
+PickFirst::PickFirstSubchannelData* PickFirst::ReadyStandbyLocked() const {
+  if (subchannel_list_ == nullptr) return nullptr;
+  for (size_t i = 0; i < subchannel_list_->num_subchannels(); ++i) {
+    PickFirstSubchannelData* sd = subchannel_list_->subchannel(i);
+    if (sd->standby() && sd->standby_state() == GRPC_CHANNEL_READY) return sd;
+  }
+  return nullptr;
+}
+
 void PickFirst::AttemptToConnectUsingLatestUpdateArgsLocked() {
   // Create a subchannel list from latest_update_args_.
   ServerAddressList addresses;
@@ -233,6 +456,7 @@ void PickFirst::AttemptToConnectUsingLatestUpdateArgsLocked() {
     // state of all subchannels above.
     subchannel_list_->subchannel(0)->StartConnectivityWatchLocked();
     subchannel_list_->subchannel(0)->subchannel()->AttemptToConnect();
+    PreconnectLocked(subchannel_list_.get());
   } else {
     // We do have a selected subchannel (which means it's READY), so keep
     // using it until one of the subchannels in the new list reports READY.
@@ -256,6 +480,7 @@ void PickFirst::AttemptToConnectUsingLatestUpdateArgsLocked() {
     latest_pending_subchannel_list_->subchannel(0)
         ->subchannel()
         ->AttemptToConnect();
+    PreconnectLocked(latest_pending_subchannel_list_.get());
   }
 }
 
@@ -284,6 +509,19 @@ void PickFirst::UpdateLocked(UpdateArgs args) {
   }
   // Update latest_update_args_.
   latest_update_args_ = std::move(args);
+  // Update config.  Keep the pick rate seen so far if the rate-based
+  // standbys didn't change.
+  config_ = latest_update_args_.config;
+  const uint32_t rpcs_per_second_per_standby =
+      config_ == nullptr ? 0 : config_->rpcs_per_second_per_standby();
+  if (rpcs_per_second_per_standby == 0) {
+    rate_tracker_.reset();
+  } else if (rate_tracker_ == nullptr ||
+             rate_tracker_->rpcs_per_second_per_standby() !=
+                 rpcs_per_second_per_standby) {
+    rate_tracker_ =
+        MakeRefCounted<PickRateTracker>(rpcs_per_second_per_standby);
+  }
   // If we are not in idle, start connection attempt immediately.
   // Otherwise, we defer the attempt into ExitIdleLocked().
   if (!idle_) {
@@ -299,6 +537,15 @@ void PickFirst::PickFirstSubchannelData::ProcessConnectivityChangeLocked(
   GPR_ASSERT(subchannel_list() == p->subchannel_list_.get() ||
              subchannel_list() == p->latest_pending_subchannel_list_.get());
   GPR_ASSERT(connectivity_state != GRPC_CHANNEL_SHUTDOWN);
+  // Keep warm standbys connected.
+  if (standby_) {
+    standby_state_ = connectivity_state;
+    if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE ||
+        connectivity_state == GRPC_CHANNEL_IDLE) {
+      subchannel()->AttemptToConnect();
+    }
+    return;
+  }
   // Handle updates for the currently selected subchannel.
   if (p->selected_ == this) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_pick_first_trace)) {
@@ -335,7 +582,26 @@ void PickFirst::PickFirstSubchannelData::ProcessConnectivityChangeLocked(
                 p->Ref(DEBUG_LOCATION, "QueuePicker")));
       }
     } else {
-      if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      PickFirstSubchannelData* standby =
+          connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE
+              ? p->ReadyStandbyLocked()
+              : nullptr;
+      if (standby != nullptr) {
+        // If the selected subchannel goes bad and a warm standby is READY,
+        // fail over to it right away, rather than making the next RPC wait
+        // for a new connection.  This subchannel becomes a candidate
+        // standby itself.
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_pick_first_trace)) {
+          gpr_log(GPR_INFO,
+                  "Pick First %p selected subchannel failed; failing over to "
+                  "standby %p",
+                  p, standby->subchannel());
+        }
+        p->channel_control_helper()->RequestReresolution();
+        CancelConnectivityWatchLocked(
+            "selected subchannel failed; failing over to standby");
+        standby->ProcessUnselectedReadyLocked();
+      } else if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
         // If the selected subchannel goes bad, request a re-resolution. We
         // also set the channel state to IDLE. The reason is that if the new
         // state is TRANSIENT_FAILURE due to a GOAWAY reception we don't want
@@ -357,7 +623,7 @@ void PickFirst::PickFirstSubchannelData::ProcessConnectivityChangeLocked(
         if (connectivity_state == GRPC_CHANNEL_READY) {
           p->channel_control_helper()->UpdateState(
               GRPC_CHANNEL_READY, absl::Status(),
-              absl::make_unique<Picker>(subchannel()->Ref()));
+              absl::make_unique<Picker>(subchannel()->Ref(), p));
         } else {  // CONNECTING
           p->channel_control_helper()->UpdateState(
               connectivity_state, absl::Status(),
@@ -471,14 +737,12 @@ void PickFirst::PickFirstSubchannelData::ProcessUnselectedReadyLocked() {
     gpr_log(GPR_INFO, "Pick First %p selected subchannel %p", p, subchannel());
   }
   p->selected_ = this;
+  // A standby being selected keeps its connectivity watch.
+  standby_ = false;
   p->channel_control_helper()->UpdateState(
       GRPC_CHANNEL_READY, absl::Status(),
-      absl::make_unique<Picker>(subchannel()->Ref()));
-  for (size_t i = 0; i < subchannel_list()->num_subchannels(); ++i) {
-    if (i != Index()) {
-      subchannel_list()->subchannel(i)->ShutdownLocked();
-    }
-  }
+      absl::make_unique<Picker>(subchannel()->Ref(), p));
+  p->UpdateStandbysLocked();
 }
 
 void PickFirst::PickFirstSubchannelData::
@@ -499,10 +763,19 @@ void PickFirst::PickFirstSubchannelData::
   }
 }
 
-class PickFirstConfig : public LoadBalancingPolicy::Config {
- public:
-  const char* name() const override { return kPickFirst; }
-};
+void PickFirst::PickFirstSubchannelData::StartStandbyLocked() {
+  if (standby_) return;
+  standby_ = true;
+  standby_state_ = CheckConnectivityStateLocked();
+  StartConnectivityWatchLocked();
+  if (standby_state_ != GRPC_CHANNEL_READY) subchannel()->AttemptToConnect();
+}
+
+void PickFirst::PickFirstSubchannelData::StopStandbyLocked() {
+  if (!standby_) return;
+  standby_ = false;
+  CancelConnectivityWatchLocked("no longer a standby");
+}
 
 //
 // factory
@@ -518,8 +791,32 @@ class PickFirstFactory : public LoadBalancingPolicyFactory {
   const char* name() const override { return kPickFirst; }
 
   RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
-      const Json& /*json*/, grpc_error_handle* /*error*/) const override {
-    return MakeRefCounted<PickFirstConfig>();
+      const Json& json, grpc_error_handle* error) const override {
+    std::vector<grpc_error_handle> error_list;
+    uint32_t warmup_percent = 0;
+    uint32_t rpcs_per_second_per_standby = 0;
+    if (json.type() == Json::Type::OBJECT) {
+      const Json::Object& object = json.object_value();
+      if (ParseJsonObjectField(object, "warmupPercent", &warmup_percent,
+                               &error_list, /*required=*/false) &&
+          warmup_percent > 100) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:warmupPercent error:must be at most 100"));
+      }
+      ParseJsonObjectField(object, "rpcsPerSecondPerStandby",
+                           &rpcs_per_second_per_standby, &error_list,
+                           /*required=*/false);
+    } else if (json.type() != Json::Type::JSON_NULL) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "error:type should be OBJECT"));
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR("pick_first LB policy config",
+                                             &error_list);
+      return nullptr;
+    }
+    return MakeRefCounted<PickFirstConfig>(warmup_percent,
+                                           rpcs_per_second_per_standby);
   }
 };
 
@@ -58,6 +58,8 @@ class PriorityLbConfig : public LoadBalancingPolicy::Config {
  public:
   struct PriorityLbChild {
     RefCountedPtr<LoadBalancingPolicy::Config> config;
+    // The JSON form of config, used to tell whether it changed.
+    Json config_json;
     bool ignore_reresolution_requests = false;
   };
 
@@ -95,13 +97,13 @@ class PriorityLb : public LoadBalancingPolicy {
     ChildPriority(RefCountedPtr<PriorityLb> priority_policy, std::string name);
 
     ~ChildPriority() override {
+      grpc_channel_args_destroy(last_args_);
       priority_policy_.reset(DEBUG_LOCATION, "ChildPriority");
     }
 
     const std::string& name() const { return name_; }
 
-    void UpdateLocked(RefCountedPtr<LoadBalancingPolicy::Config> config,
-                      bool ignore_reresolution_requests);
+    void UpdateLocked(const PriorityLbConfig::PriorityLbChild& config);
     void ExitIdleLocked();
     void ResetBackoffLocked();
     void DeactivateLocked();
@@ -191,6 +193,13 @@ class PriorityLb : public LoadBalancingPolicy {
 
     OrphanablePtr<LoadBalancingPolicy> child_policy_;
 
+    // What the child policy was last updated with, so that an update
+    // which changes nothing for this child is not passed down to it.
+    bool last_update_valid_ = false;
+    Json last_config_json_;
+    ServerAddressList last_addresses_;
+    grpc_channel_args* last_args_ = nullptr;
+
     grpc_connectivity_state connectivity_state_ = GRPC_CHANNEL_CONNECTING;
     absl::Status connectivity_status_;
     RefCountedPtr<RefCountedPicker> picker_wrapper_;
@@ -315,8 +324,7 @@ void PriorityLb::UpdateLocked(UpdateArgs args) {
       child->DeactivateLocked();
     } else {
       // Existing child found in new config.  Update it.
-      child->UpdateLocked(config_it->second.config,
-                          config_it->second.ignore_reresolution_requests);
+      child->UpdateLocked(config_it->second);
     }
   }
   // Try to get connected.
@@ -435,8 +443,7 @@ void PriorityLb::TryNextPriorityLocked(bool report_connecting) {
           Ref(DEBUG_LOCATION, "ChildPriority"), child_name);
       auto child_config = config_->children().find(child_name);
       GPR_DEBUG_ASSERT(child_config != config_->children().end());
-      child->UpdateLocked(child_config->second.config,
-                          child_config->second.ignore_reresolution_requests);
+      child->UpdateLocked(child_config->second);
       return;
     }
     // The child already exists.
@@ -542,27 +549,48 @@ void PriorityLb::ChildPriority::Orphan() {
 }
 
 void PriorityLb::ChildPriority::UpdateLocked(
-    RefCountedPtr<LoadBalancingPolicy::Config> config,
-    bool ignore_reresolution_requests) {
+    const PriorityLbConfig::PriorityLbChild& config) {
   if (priority_policy_->shutting_down_) return;
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_priority_trace)) {
     gpr_log(GPR_INFO, "[priority_lb %p] child %s (%p): start update",
             priority_policy_.get(), name_.c_str(), this);
   }
-  ignore_reresolution_requests_ = ignore_reresolution_requests;
+  ignore_reresolution_requests_ = config.ignore_reresolution_requests;
   // Create policy if needed.
   if (child_policy_ == nullptr) {
     child_policy_ = CreateChildPolicyLocked(priority_policy_->args_);
   }
   // Construct update args.
   UpdateArgs update_args;
-  update_args.config = std::move(config);
+  update_args.config = config.config;
   if (priority_policy_->addresses_.ok()) {
     update_args.addresses = (*priority_policy_->addresses_)[name_];
   } else {
     update_args.addresses = priority_policy_->addresses_.status();
   }
   update_args.args = grpc_channel_args_copy(priority_policy_->args_);
+  // If neither the config, the addresses nor the args of this child have
+  // changed, skip the update, so that an endpoint change in one priority
+  // does not rebuild the subchannel lists of all the others.
+  if (last_update_valid_ && update_args.addresses.ok() &&
+      config.config_json == last_config_json_ &&
+      *update_args.addresses == last_addresses_ &&
+      grpc_channel_args_compare(update_args.args, last_args_) == 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_priority_trace)) {
+      gpr_log(GPR_INFO,
+              "[priority_lb %p] child %s (%p): unchanged, skipping update",
+              priority_policy_.get(), name_.c_str(), this);
+    }
+    grpc_channel_args_destroy(update_args.args);
+    return;
+  }
+  last_update_valid_ = update_args.addresses.ok();
+  if (last_update_valid_) {
+    last_config_json_ = config.config_json;
+    last_addresses_ = *update_args.addresses;
+    grpc_channel_args_destroy(last_args_);
+    last_args_ = grpc_channel_args_copy(update_args.args);
+  }
   // Update the policy.
   if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_priority_trace)) {
     gpr_log(GPR_INFO,
@@ -858,6 +886,7 @@ class PriorityLbFactory : public LoadBalancingPolicyFactory {
               GRPC_ERROR_UNREF(parse_error);
             }
             children[child_name].config = std::move(config);
+            children[child_name].config_json = it2->second;
             children[child_name].ignore_reresolution_requests =
                 ignore_resolution_requests;
           }
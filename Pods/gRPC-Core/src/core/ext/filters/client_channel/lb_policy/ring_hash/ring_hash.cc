@@ -19,6 +19,9 @@
 #include <stdlib.h>
 #include <string.h>
 
+#include <limits>
+#include <memory>
+
 #include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
 #define XXH_INLINE_ALL
@@ -43,12 +46,25 @@ namespace grpc_core {
 const char* kRequestRingHashAttribute = "request_ring_hash";
 TraceFlag grpc_lb_ring_hash_trace(false, "ring_hash_lb");
 
+namespace {
+
+bool IsPrime(size_t n) {
+  if (n < 2) return false;
+  for (size_t d = 2; d * d <= n; ++d) {
+    if (n % d == 0) return false;
+  }
+  return true;
+}
+
+}  // namespace
+
 // Helper Parser method
 void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
-                           size_t* max_ring_size,
+                           size_t* max_ring_size, size_t* maglev_table_size,
                            std::vector<grpc_error_handle>* error_list) {
   *min_ring_size = 1024;
   *max_ring_size = 8388608;
+  *maglev_table_size = 0;
   if (json.type() != Json::Type::OBJECT) {
     error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
         "ring_hash_experimental should be of type object"));
@@ -83,6 +99,21 @@ void ParseRingHashLbConfig(const Json& json, size_t* min_ring_size,
         "and max_ring_size cannot be smaller than "
         "min_ring_size"));
   }
+  ring_hash_it = ring_hash.find("maglev_table_size");
+  if (ring_hash_it != ring_hash.end()) {
+    if (ring_hash_it->second.type() != Json::Type::NUMBER) {
+      error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:maglev_table_size error: should be of type number"));
+    } else {
+      *maglev_table_size = gpr_parse_nonnegative_int(
+          ring_hash_it->second.string_value().c_str());
+      if (*maglev_table_size > 8388608 || !IsPrime(*maglev_table_size)) {
+        error_list->push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:maglev_table_size error: should be a prime no larger "
+            "than 8388608"));
+      }
+    }
+  }
 }
 
 namespace {
@@ -91,15 +122,22 @@ constexpr char kRingHash[] = "ring_hash_experimental";
 
 class RingHashLbConfig : public LoadBalancingPolicy::Config {
  public:
-  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size)
-      : min_ring_size_(min_ring_size), max_ring_size_(max_ring_size) {}
+  RingHashLbConfig(size_t min_ring_size, size_t max_ring_size,
+                   size_t maglev_table_size)
+      : min_ring_size_(min_ring_size),
+        max_ring_size_(max_ring_size),
+        maglev_table_size_(maglev_table_size) {}
   const char* name() const override { return kRingHash; }
   size_t min_ring_size() const { return min_ring_size_; }
   size_t max_ring_size() const { return max_ring_size_; }
+  // If non-zero, requests are mapped by a Maglev table of this size instead
+  // of a ring.
+  size_t maglev_table_size() const { return maglev_table_size_; }
 
  private:
   size_t min_ring_size_;
   size_t max_ring_size_;
+  size_t maglev_table_size_;
 };
 
 //
@@ -207,21 +245,52 @@ class RingHash : public LoadBalancingPolicy {
     size_t num_transient_failure_ = 0;
   };
 
+  // Maps request hashes to subchannels: a ring searched by hash or, when the
+  // config sets maglev_table_size, a Maglev lookup table indexed by hash.
   class Ring : public RefCounted<Ring> {
    public:
-    struct Entry {
-      uint64_t hash;
-      RingHashSubchannelData* subchannel;
-    };
-
     Ring(RingHash* parent,
          RefCountedPtr<RingHashSubchannelList> subchannel_list);
 
-    const std::vector<Entry>& ring() const { return ring_; }
+    // Returns the number of positions on the ring (or in the table).
+    size_t size() const { return table_->indexes.size(); }
+
+    // Returns the position that a request hash maps to.
+    size_t FindPosition(uint64_t hash) const;
+
+    RingHashSubchannelData* subchannel(size_t position) const {
+      return subchannel_list_->subchannel(table_->indexes[position]);
+    }
 
    private:
+    // Positions refer to subchannels by index into the subchannel list, so
+    // that a table can be reused for a new subchannel list with the same
+    // addresses and weights.
+    struct Table {
+      // What the table is built from.
+      std::vector<std::pair<std::string, uint32_t>> address_weights;
+      size_t min_ring_size;
+      size_t max_ring_size;
+      size_t maglev_table_size;
+      // For a ring, the hash of each position, in order.  Empty for a Maglev
+      // table.
+      std::vector<uint64_t> hashes;
+      // The index of the subchannel at each position.
+      std::vector<uint32_t> indexes;
+
+      bool SameInputs(const Table& other) const {
+        return address_weights == other.address_weights &&
+               min_ring_size == other.min_ring_size &&
+               max_ring_size == other.max_ring_size &&
+               maglev_table_size == other.maglev_table_size;
+      }
+    };
+
+    static void BuildRing(Table* table);
+    static void BuildMaglevTable(Table* table);
+
     RefCountedPtr<RingHashSubchannelList> subchannel_list_;
-    std::vector<Entry> ring_;
+    std::shared_ptr<const Table> table_;
   };
 
   class Picker : public SubchannelPicker {
@@ -298,41 +367,66 @@ RingHash::Ring::Ring(RingHash* parent,
                      RefCountedPtr<RingHashSubchannelList> subchannel_list)
     : subchannel_list_(std::move(subchannel_list)) {
   size_t num_subchannels = subchannel_list_->num_subchannels();
-  // Store the weights while finding the sum.
-  struct AddressWeight {
-    std::string address;
-    // Default weight is 1 for the cases where a weight is not provided,
-    // each occurrence of the address will be counted a weight value of 1.
-    uint32_t weight = 1;
-    double normalized_weight;
-  };
-  std::vector<AddressWeight> address_weights;
-  size_t sum = 0;
-  address_weights.reserve(num_subchannels);
+  auto table = std::make_shared<Table>();
+  table->min_ring_size = parent->config_->min_ring_size();
+  table->max_ring_size = parent->config_->max_ring_size();
+  table->maglev_table_size = parent->config_->maglev_table_size();
+  table->address_weights.reserve(num_subchannels);
   for (size_t i = 0; i < num_subchannels; ++i) {
     RingHashSubchannelData* sd = subchannel_list_->subchannel(i);
     const ServerAddressWeightAttribute* weight_attribute = static_cast<
         const ServerAddressWeightAttribute*>(sd->address().GetAttribute(
         ServerAddressWeightAttribute::kServerAddressWeightAttributeKey));
-    AddressWeight address_weight;
-    address_weight.address =
-        grpc_sockaddr_to_string(&sd->address().address(), false);
+    // Default weight is 1 for the cases where a weight is not provided,
+    // each occurrence of the address will be counted a weight value of 1.
+    uint32_t weight = 1;
     if (weight_attribute != nullptr) {
       GPR_ASSERT(weight_attribute->weight() != 0);
-      address_weight.weight = weight_attribute->weight();
+      weight = weight_attribute->weight();
     }
-    sum += address_weight.weight;
-    address_weights.push_back(std::move(address_weight));
+    table->address_weights.emplace_back(
+        grpc_sockaddr_to_string(&sd->address().address(), false), weight);
   }
+  // Updates often leave the addresses as they were (e.g., when only the
+  // endpoints' health changes): keep the table then, rather than rebuilding.
+  if (parent->ring_ != nullptr && parent->ring_->table_->SameInputs(*table)) {
+    table_ = parent->ring_->table_;
+  } else if (table->maglev_table_size != 0) {
+    BuildMaglevTable(table.get());
+    table_ = std::move(table);
+  } else {
+    BuildRing(table.get());
+    table_ = std::move(table);
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_ring_hash_trace)) {
+    gpr_log(GPR_INFO,
+            "[RH %p picker %p] created %s from subchannel_list=%p "
+            "with %" PRIuPTR " entries%s",
+            parent, this, table_->hashes.empty() ? "Maglev table" : "ring",
+            subchannel_list_.get(), table_->indexes.size(),
+            parent->ring_ != nullptr && parent->ring_->table_ == table_
+                ? " (unchanged)"
+                : "");
+  }
+}
+
+void RingHash::Ring::BuildRing(Table* table) {
+  const size_t num_subchannels = table->address_weights.size();
   // Calculating normalized weights and find min and max.
+  size_t sum = 0;
+  for (const auto& address_weight : table->address_weights) {
+    sum += address_weight.second;
+  }
+  std::vector<double> normalized_weights;
+  normalized_weights.reserve(num_subchannels);
   double min_normalized_weight = 1.0;
   double max_normalized_weight = 0.0;
-  for (auto& address : address_weights) {
-    address.normalized_weight = static_cast<double>(address.weight) / sum;
-    min_normalized_weight =
-        std::min(address.normalized_weight, min_normalized_weight);
-    max_normalized_weight =
-        std::max(address.normalized_weight, max_normalized_weight);
+  for (const auto& address_weight : table->address_weights) {
+    const double normalized_weight =
+        static_cast<double>(address_weight.second) / sum;
+    normalized_weights.push_back(normalized_weight);
+    min_normalized_weight = std::min(normalized_weight, min_normalized_weight);
+    max_normalized_weight = std::max(normalized_weight, max_normalized_weight);
   }
   // Scale up the number of hashes per host such that the least-weighted host
   // gets a whole number of hashes on the ring. Other hosts might not end up
@@ -341,14 +435,19 @@ RingHash::Ring::Ring(RingHash* parent,
   // weights aren't provided, all hosts should get an equal number of hashes. In
   // the case where this number exceeds the max_ring_size, it's scaled back down
   // to fit.
-  const size_t min_ring_size = parent->config_->min_ring_size();
-  const size_t max_ring_size = parent->config_->max_ring_size();
+  const size_t min_ring_size = table->min_ring_size;
+  const size_t max_ring_size = table->max_ring_size;
   const double scale = std::min(
       std::ceil(min_normalized_weight * min_ring_size) / min_normalized_weight,
       static_cast<double>(max_ring_size));
   // Reserve memory for the entire ring up front.
   const uint64_t ring_size = std::ceil(scale);
-  ring_.reserve(ring_size);
+  struct Entry {
+    uint64_t hash;
+    uint32_t index;
+  };
+  std::vector<Entry> ring;
+  ring.reserve(ring_size);
   // Populate the hash ring by walking through the (host, weight) pairs in
   // normalized_host_weights, and generating (scale * weight) hashes for each
   // host. Since these aren't necessarily whole numbers, we maintain running
@@ -357,14 +456,12 @@ RingHash::Ring::Ring(RingHash* parent,
   absl::InlinedVector<char, 196> hash_key_buffer;
   double current_hashes = 0.0;
   double target_hashes = 0.0;
-  uint64_t min_hashes_per_host = ring_size;
-  uint64_t max_hashes_per_host = 0;
   for (size_t i = 0; i < num_subchannels; ++i) {
-    const std::string& address_string = address_weights[i].address;
+    const std::string& address_string = table->address_weights[i].first;
     hash_key_buffer.assign(address_string.begin(), address_string.end());
     hash_key_buffer.emplace_back('_');
     auto offset_start = hash_key_buffer.end();
-    target_hashes += scale * address_weights[i].normalized_weight;
+    target_hashes += scale * normalized_weights[i];
     size_t count = 0;
     while (current_hashes < target_hashes) {
       const std::string count_str = absl::StrCat(count);
@@ -372,41 +469,78 @@ RingHash::Ring::Ring(RingHash* parent,
       absl::string_view hash_key(hash_key_buffer.data(),
                                  hash_key_buffer.size());
       const uint64_t hash = XXH64(hash_key.data(), hash_key.size(), 0);
-      ring_.push_back({hash, subchannel_list_->subchannel(i)});
+      ring.push_back({hash, static_cast<uint32_t>(i)});
       ++count;
       ++current_hashes;
       hash_key_buffer.erase(offset_start, hash_key_buffer.end());
     }
-    min_hashes_per_host =
-        std::min(static_cast<uint64_t>(i), min_hashes_per_host);
-    max_hashes_per_host =
-        std::max(static_cast<uint64_t>(i), max_hashes_per_host);
   }
-  std::sort(ring_.begin(), ring_.end(),
+  std::sort(ring.begin(), ring.end(),
             [](const Entry& lhs, const Entry& rhs) -> bool {
               return lhs.hash < rhs.hash;
             });
-  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_ring_hash_trace)) {
-    gpr_log(GPR_INFO,
-            "[RH %p picker %p] created ring from subchannel_list=%p "
-            "with %" PRIuPTR " ring entries",
-            parent, this, subchannel_list_.get(), ring_.size());
+  table->hashes.reserve(ring.size());
+  table->indexes.reserve(ring.size());
+  for (const Entry& entry : ring) {
+    table->hashes.push_back(entry.hash);
+    table->indexes.push_back(entry.index);
   }
 }
 
-//
-// RingHash::Picker
-//
-
-RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
-  auto hash =
-      args.call_state->ExperimentalGetCallAttribute(kRequestRingHashAttribute);
-  uint64_t h;
-  if (!absl::SimpleAtoi(hash, &h)) {
-    return PickResult::Fail(
-        absl::InternalError("xds ring hash value is not a number"));
+// Builds the lookup table of Maglev (Eisenbud et al., NSDI 2016).  Each
+// address has its own permutation of the table's positions, derived from two
+// hashes of the address, and the addresses take turns claiming their next
+// preferred position that's still free, the turns going in proportion to
+// their weights.  A table size that's a prime much larger than the number of
+// addresses spreads the requests evenly, and a change of addresses moves
+// few of the positions of the others.
+void RingHash::Ring::BuildMaglevTable(Table* table) {
+  constexpr uint32_t kFree = std::numeric_limits<uint32_t>::max();
+  const uint64_t table_size = table->maglev_table_size;
+  const size_t num_subchannels = table->address_weights.size();
+  struct Permutation {
+    uint64_t offset;
+    uint64_t skip;
+    uint64_t next;
+    uint64_t credit;
+  };
+  std::vector<Permutation> permutations;
+  permutations.reserve(num_subchannels);
+  uint64_t max_weight = 0;
+  for (const auto& address_weight : table->address_weights) {
+    const std::string& address = address_weight.first;
+    permutations.push_back(
+        {XXH64(address.data(), address.size(), 0) % table_size,
+         XXH64(address.data(), address.size(), 1) % (table_size - 1) + 1, 0,
+         0});
+    max_weight = std::max<uint64_t>(max_weight, address_weight.second);
+  }
+  table->indexes.assign(table_size, kFree);
+  for (uint64_t filled = 0, i = 0; filled < table_size;
+       i = (i + 1) % num_subchannels) {
+    Permutation& permutation = permutations[i];
+    // The heaviest addresses take a position every time round, the others
+    // when they have built up enough credit.
+    permutation.credit += table->address_weights[i].second;
+    if (permutation.credit < max_weight) continue;
+    permutation.credit -= max_weight;
+    // The table size being prime, each permutation covers every position, so
+    // this finds a free one.
+    uint64_t position;
+    do {
+      position = (permutation.offset +
+                  permutation.skip * permutation.next++) %
+                 table_size;
+    } while (table->indexes[position] != kFree);
+    table->indexes[position] = static_cast<uint32_t>(i);
+    ++filled;
   }
-  const std::vector<Ring::Entry>& ring = ring_->ring();
+}
+
+size_t RingHash::Ring::FindPosition(uint64_t hash) const {
+  const std::vector<uint64_t>& ring = table_->hashes;
+  if (ring.empty()) return hash % table_->indexes.size();
+  const uint64_t h = hash;
   // Ported from https://github.com/RJ/ketama/blob/master/libketama/ketama.c
   // (ketama_get_server) NOTE: The algorithm depends on using signed integers
   // for lowp, highp, and first_index. Do not change them!
@@ -419,8 +553,8 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
       first_index = 0;
       break;
     }
-    uint64_t midval = ring[first_index].hash;
-    uint64_t midval1 = first_index == 0 ? 0 : ring[first_index - 1].hash;
+    uint64_t midval = ring[first_index];
+    uint64_t midval1 = first_index == 0 ? 0 : ring[first_index - 1];
     if (h <= midval && h > midval1) {
       break;
     }
@@ -434,6 +568,23 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
       break;
     }
   }
+  return first_index;
+}
+
+//
+// RingHash::Picker
+//
+
+RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
+  auto hash =
+      args.call_state->ExperimentalGetCallAttribute(kRequestRingHashAttribute);
+  uint64_t h;
+  if (!absl::SimpleAtoi(hash, &h)) {
+    return PickResult::Fail(
+        absl::InternalError("xds ring hash value is not a number"));
+  }
+  const size_t first_index = ring_->FindPosition(h);
+  RingHashSubchannelData* first_subchannel = ring_->subchannel(first_index);
   OrphanablePtr<SubchannelConnectionAttempter> subchannel_connection_attempter;
   auto ScheduleSubchannelConnectionAttempt =
       [&](RefCountedPtr<SubchannelInterface> subchannel) {
@@ -443,13 +594,13 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
         }
         subchannel_connection_attempter->AddSubchannel(std::move(subchannel));
       };
-  switch (ring[first_index].subchannel->GetConnectivityState()) {
+  switch (first_subchannel->GetConnectivityState()) {
     case GRPC_CHANNEL_READY:
       return PickResult::Complete(
-          ring[first_index].subchannel->subchannel()->Ref());
+          first_subchannel->subchannel()->Ref());
     case GRPC_CHANNEL_IDLE:
       ScheduleSubchannelConnectionAttempt(
-          ring[first_index].subchannel->subchannel()->Ref());
+          first_subchannel->subchannel()->Ref());
       ABSL_FALLTHROUGH_INTENDED;
     case GRPC_CHANNEL_CONNECTING:
       return PickResult::Queue();
@@ -457,27 +608,28 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
       break;
   }
   ScheduleSubchannelConnectionAttempt(
-      ring[first_index].subchannel->subchannel()->Ref());
+      first_subchannel->subchannel()->Ref());
   // Loop through remaining subchannels to find one in READY.
   // On the way, we make sure the right set of connection attempts
   // will happen.
   bool found_second_subchannel = false;
   bool found_first_non_failed = false;
-  for (size_t i = 1; i < ring.size(); ++i) {
-    const Ring::Entry& entry = ring[(first_index + i) % ring.size()];
-    if (entry.subchannel == ring[first_index].subchannel) {
+  for (size_t i = 1; i < ring_->size(); ++i) {
+    RingHashSubchannelData* sd =
+        ring_->subchannel((first_index + i) % ring_->size());
+    if (sd == first_subchannel) {
       continue;
     }
     grpc_connectivity_state connectivity_state =
-        entry.subchannel->GetConnectivityState();
+        sd->GetConnectivityState();
     if (connectivity_state == GRPC_CHANNEL_READY) {
-      return PickResult::Complete(entry.subchannel->subchannel()->Ref());
+      return PickResult::Complete(sd->subchannel()->Ref());
     }
     if (!found_second_subchannel) {
       switch (connectivity_state) {
         case GRPC_CHANNEL_IDLE:
           ScheduleSubchannelConnectionAttempt(
-              entry.subchannel->subchannel()->Ref());
+              sd->subchannel()->Ref());
           ABSL_FALLTHROUGH_INTENDED;
         case GRPC_CHANNEL_CONNECTING:
           return PickResult::Queue();
@@ -489,11 +641,11 @@ RingHash::PickResult RingHash::Picker::Pick(PickArgs args) {
     if (!found_first_non_failed) {
       if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
         ScheduleSubchannelConnectionAttempt(
-            entry.subchannel->subchannel()->Ref());
+            sd->subchannel()->Ref());
       } else {
         if (connectivity_state == GRPC_CHANNEL_IDLE) {
           ScheduleSubchannelConnectionAttempt(
-              entry.subchannel->subchannel()->Ref());
+              sd->subchannel()->Ref());
         }
         found_first_non_failed = true;
       }
@@ -784,10 +936,13 @@ class RingHashFactory : public LoadBalancingPolicyFactory {
       const Json& json, grpc_error_handle* error) const override {
     size_t min_ring_size;
     size_t max_ring_size;
+    size_t maglev_table_size;
     std::vector<grpc_error_handle> error_list;
-    ParseRingHashLbConfig(json, &min_ring_size, &max_ring_size, &error_list);
+    ParseRingHashLbConfig(json, &min_ring_size, &max_ring_size,
+                          &maglev_table_size, &error_list);
     if (error_list.empty()) {
-      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size);
+      return MakeRefCounted<RingHashLbConfig>(min_ring_size, max_ring_size,
+                                              maglev_table_size);
     } else {
       *error = GRPC_ERROR_CREATE_FROM_VECTOR(
           "ring_hash_experimental LB policy config", &error_list);
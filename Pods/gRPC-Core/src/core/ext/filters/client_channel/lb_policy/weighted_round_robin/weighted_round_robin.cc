@@ -0,0 +1,780 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+// The weighted_round_robin LB policy.
+//
+// Like round_robin, but each READY subchannel gets a share of the calls in
+// proportion to its weight: the queries per second it serves divided by its
+// CPU utilization, both as reported by the backend in ORCA load reports in
+// call trailing metadata. A backend twice the size of another should run at
+// the same utilization with twice the QPS, and so get twice the calls.
+// - A subchannel's weight is only used once it has been reporting for
+//   blackoutPeriod, so that a backend that just (re)started isn't sent a
+//   flood of calls on the strength of its first, idle, reports.
+// - A weight expires when no report has been seen for weightExpirationPeriod.
+// - Subchannels with no usable weight get the mean of the others' weights;
+//   if fewer than two subchannels have a weight, calls are spread evenly.
+// The pickers recompute the schedule from the weights every
+// weightUpdatePeriod.
+
+#include <grpc/support/port_platform.h>
+
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "absl/strings/str_cat.h"
+
+#include <grpc/support/alloc.h>
+
+#include "src/core/ext/filters/client_channel/lb_policy/subchannel_list.h"
+#include "src/core/ext/filters/client_channel/lb_policy_registry.h"
+#include "src/core/ext/filters/client_channel/subchannel.h"
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/json/json_util.h"
+#include "src/core/lib/transport/connectivity_state.h"
+#include "src/core/lib/transport/error_utils.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_lb_wrr_trace(false, "weighted_round_robin_lb");
+
+namespace {
+
+constexpr char kWeightedRoundRobin[] = "weighted_round_robin";
+
+constexpr grpc_millis kDefaultBlackoutPeriod = 10 * GPR_MS_PER_SEC;
+constexpr grpc_millis kDefaultWeightExpirationPeriod = 3 * 60 * GPR_MS_PER_SEC;
+constexpr grpc_millis kDefaultWeightUpdatePeriod = GPR_MS_PER_SEC;
+constexpr grpc_millis kMinWeightUpdatePeriod = 100;
+
+//
+// config
+//
+
+class WeightedRoundRobinConfig : public LoadBalancingPolicy::Config {
+ public:
+  WeightedRoundRobinConfig(grpc_millis blackout_period,
+                           grpc_millis weight_expiration_period,
+                           grpc_millis weight_update_period)
+      : blackout_period_(blackout_period),
+        weight_expiration_period_(weight_expiration_period),
+        weight_update_period_(weight_update_period) {}
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  grpc_millis blackout_period() const { return blackout_period_; }
+  grpc_millis weight_expiration_period() const {
+    return weight_expiration_period_;
+  }
+  grpc_millis weight_update_period() const { return weight_update_period_; }
+
+ private:
+  grpc_millis blackout_period_;
+  grpc_millis weight_expiration_period_;
+  grpc_millis weight_update_period_;
+};
+
+//
+// weight of one endpoint, shared with pickers and call trackers
+//
+
+class EndpointWeight : public RefCounted<EndpointWeight> {
+ public:
+  // Called when a call finishes with a load report.
+  void MaybeUpdate(double qps, double cpu_utilization, grpc_millis now) {
+    // A backend that doesn't report both can't be weighed.
+    if (qps <= 0 || cpu_utilization <= 0) return;
+    MutexLock lock(&mu_);
+    if (non_empty_since_ == GRPC_MILLIS_INF_FUTURE) non_empty_since_ = now;
+    last_update_time_ = now;
+    weight_ = qps / cpu_utilization;
+  }
+
+  // Returns the weight to schedule with, or 0 if there is none.
+  double GetWeight(grpc_millis now, grpc_millis weight_expiration_period,
+                   grpc_millis blackout_period) {
+    MutexLock lock(&mu_);
+    if (non_empty_since_ == GRPC_MILLIS_INF_FUTURE) return 0;
+    if (now - last_update_time_ >= weight_expiration_period) {
+      // Start a new blackout period when reports resume.
+      non_empty_since_ = GRPC_MILLIS_INF_FUTURE;
+      return 0;
+    }
+    if (now - non_empty_since_ < blackout_period) return 0;
+    return weight_;
+  }
+
+ private:
+  Mutex mu_;
+  double weight_ ABSL_GUARDED_BY(mu_) = 0;
+  grpc_millis non_empty_since_ ABSL_GUARDED_BY(mu_) = GRPC_MILLIS_INF_FUTURE;
+  grpc_millis last_update_time_ ABSL_GUARDED_BY(mu_) = GRPC_MILLIS_INF_PAST;
+};
+
+class CallTracker : public LoadBalancingPolicy::SubchannelCallTrackerInterface {
+ public:
+  explicit CallTracker(RefCountedPtr<EndpointWeight> weight)
+      : weight_(std::move(weight)) {}
+
+  void Start() override {}
+
+  void Finish(FinishArgs args) override {
+    const LoadBalancingPolicy::BackendMetricAccessor::BackendMetricData*
+        backend_metric_data =
+            args.backend_metric_accessor->GetBackendMetricData();
+    if (backend_metric_data == nullptr) return;
+    weight_->MaybeUpdate(
+        static_cast<double>(backend_metric_data->requests_per_second),
+        backend_metric_data->cpu_utilization, ExecCtx::Get()->Now());
+  }
+
+ private:
+  RefCountedPtr<EndpointWeight> weight_;
+};
+
+//
+// scheduler
+//
+
+// Picks subchannels in proportion to fixed weights in O(1), without locks.
+//
+// This is a static form of earliest-deadline-first scheduling: instead of
+// keeping each subchannel's next deadline in a priority queue, which would
+// need a lock around every pick, it goes round the subchannels in order and
+// lets each one take a turn with a probability given by its weight, decided
+// deterministically from how many times round the list it has been. Weights
+// are scaled so that the largest is kMaxWeight (which always takes its turn),
+// and none below kMinRatio of that, so a pick tries 1 / kMinRatio subchannels
+// at worst and, with the weights of a typical fleet, not many more than one.
+class StaticStrideScheduler {
+ public:
+  // Returns null if fewer than two weights are non-zero, when there is
+  // nothing to weigh.
+  static std::unique_ptr<StaticStrideScheduler> Make(
+      const std::vector<double>& weights) {
+    size_t num_non_zero = 0;
+    double sum = 0;
+    double max = 0;
+    for (double weight : weights) {
+      if (weight > 0) {
+        ++num_non_zero;
+        sum += weight;
+        max = std::max(max, weight);
+      }
+    }
+    if (num_non_zero < 2) return nullptr;
+    const double mean = sum / num_non_zero;
+    const double scale = kMaxWeight / max;
+    std::vector<uint16_t> scaled_weights;
+    scaled_weights.reserve(weights.size());
+    for (double weight : weights) {
+      if (weight <= 0) weight = mean;
+      scaled_weights.push_back(static_cast<uint16_t>(
+          std::max(weight * scale, kMinRatio * kMaxWeight) + 0.5));
+    }
+    return std::unique_ptr<StaticStrideScheduler>(
+        new StaticStrideScheduler(std::move(scaled_weights)));
+  }
+
+  // Returns the index of the subchannel to use. sequence is a counter shared
+  // by concurrent picks.
+  size_t Pick(std::atomic<uint64_t>* sequence) const {
+    const uint64_t num_weights = weights_.size();
+    for (;;) {
+      const uint64_t position =
+          sequence->fetch_add(1, std::memory_order_relaxed);
+      const uint64_t index = position % num_weights;
+      const uint64_t generation = position / num_weights;
+      const uint64_t weight = weights_[index];
+      // The offset staggers the subchannels' turns within a generation.
+      const uint64_t phase =
+          (weight * generation + index * (kMaxWeight / 2)) % kMaxWeight;
+      if (phase >= kMaxWeight - weight) return index;
+    }
+  }
+
+ private:
+  static constexpr uint16_t kMaxWeight = 0xffff;
+  static constexpr double kMinRatio = 0.1;
+
+  explicit StaticStrideScheduler(std::vector<uint16_t> weights)
+      : weights_(std::move(weights)) {}
+
+  const std::vector<uint16_t> weights_;
+};
+
+constexpr uint16_t StaticStrideScheduler::kMaxWeight;
+constexpr double StaticStrideScheduler::kMinRatio;
+
+//
+// weighted_round_robin LB policy
+//
+
+class WeightedRoundRobin : public LoadBalancingPolicy {
+ public:
+  explicit WeightedRoundRobin(Args args);
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  void UpdateLocked(UpdateArgs args) override;
+  void ResetBackoffLocked() override;
+
+ private:
+  ~WeightedRoundRobin() override;
+
+  // Forward declaration.
+  class WrrSubchannelList;
+
+  // Data for a particular subchannel in a subchannel list.
+  // This subclass adds the following functionality:
+  // - Tracks the previous connectivity state of the subchannel, so that
+  //   we know how many subchannels are in each state.
+  // - Holds the weight of the subchannel's address.
+  class WrrSubchannelData
+      : public SubchannelData<WrrSubchannelList, WrrSubchannelData> {
+   public:
+    WrrSubchannelData(
+        SubchannelList<WrrSubchannelList, WrrSubchannelData>* subchannel_list,
+        const ServerAddress& address,
+        RefCountedPtr<SubchannelInterface> subchannel);
+
+    grpc_connectivity_state connectivity_state() const {
+      return last_connectivity_state_;
+    }
+
+    const RefCountedPtr<EndpointWeight>& weight() const { return weight_; }
+
+    // Performs connectivity state updates that need to be done both when we
+    // first start watching and when a watcher notification is received.
+    void UpdateConnectivityStateLocked(
+        grpc_connectivity_state connectivity_state);
+
+   private:
+    // Performs connectivity state updates that need to be done only
+    // after we have started watching.
+    void ProcessConnectivityChangeLocked(
+        grpc_connectivity_state connectivity_state) override;
+
+    grpc_connectivity_state last_connectivity_state_ = GRPC_CHANNEL_IDLE;
+    bool seen_failure_since_ready_ = false;
+    RefCountedPtr<EndpointWeight> weight_;
+  };
+
+  // A list of subchannels.
+  class WrrSubchannelList
+      : public SubchannelList<WrrSubchannelList, WrrSubchannelData> {
+   public:
+    WrrSubchannelList(WeightedRoundRobin* policy, ServerAddressList addresses,
+                      const grpc_channel_args& args)
+        : SubchannelList(policy, &grpc_lb_wrr_trace, std::move(addresses),
+                         policy->channel_control_helper(), args) {
+      // Need to maintain a ref to the LB policy as long as we maintain
+      // any references to subchannels, since the subchannels'
+      // pollset_sets will include the LB policy's pollset_set.
+      policy->Ref(DEBUG_LOCATION, "subchannel_list").release();
+    }
+
+    ~WrrSubchannelList() override {
+      WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+      p->Unref(DEBUG_LOCATION, "subchannel_list");
+    }
+
+    // Starts watching the subchannels in this list.
+    void StartWatchingLocked();
+
+    // Updates the counters of subchannels in each state when a
+    // subchannel transitions from old_state to new_state.
+    void UpdateStateCountersLocked(grpc_connectivity_state old_state,
+                                   grpc_connectivity_state new_state);
+
+    // Promotes this list to be the policy's current list if it's ready to
+    // be, then updates the policy's connectivity state from the counters of
+    // subchannels in each state.
+    void UpdateStateFromSubchannelStateCountsLocked();
+
+   private:
+    // If this subchannel list is the policy's current subchannel list,
+    // updates the policy's connectivity state.
+    void MaybeUpdateConnectivityStateLocked();
+
+    size_t num_ready_ = 0;
+    size_t num_connecting_ = 0;
+    size_t num_transient_failure_ = 0;
+  };
+
+  class Picker : public SubchannelPicker {
+   public:
+    Picker(WeightedRoundRobin* parent, WrrSubchannelList* subchannel_list);
+
+    PickResult Pick(PickArgs args) override;
+
+   private:
+    struct Entry {
+      RefCountedPtr<SubchannelInterface> subchannel;
+      RefCountedPtr<EndpointWeight> weight;
+    };
+
+    // Rebuilds the scheduler from the current weights if it is due.
+    void MaybeUpdateScheduler(grpc_millis now);
+    void BuildScheduler(grpc_millis now);
+
+    // Using pointer value only, no ref held -- do not dereference!
+    WeightedRoundRobin* parent_;
+    const RefCountedPtr<WeightedRoundRobinConfig> config_;
+    std::vector<Entry> subchannels_;
+    std::atomic<uint64_t> sequence_;
+    std::atomic<grpc_millis> next_update_time_;
+    Mutex scheduler_mu_;
+    // Null when calls are to be spread evenly.
+    std::shared_ptr<const StaticStrideScheduler> scheduler_
+        ABSL_GUARDED_BY(scheduler_mu_);
+  };
+
+  void ShutdownLocked() override;
+
+  RefCountedPtr<WeightedRoundRobinConfig> config_;
+
+  // Weights by address, for the addresses in the latest update. Weights are
+  // kept across updates for the addresses that remain, so that changes to
+  // the address list don't reset every backend's weight.
+  std::map<std::string, RefCountedPtr<EndpointWeight>> endpoint_weights_;
+
+  // List of subchannels.
+  OrphanablePtr<WrrSubchannelList> subchannel_list_;
+  // Latest pending subchannel list.
+  // When we get an updated address list, we create a new subchannel list
+  // for it here, and we wait to swap it into subchannel_list_ until the new
+  // list becomes READY.
+  OrphanablePtr<WrrSubchannelList> latest_pending_subchannel_list_;
+
+  bool shutdown_ = false;
+};
+
+//
+// WeightedRoundRobin::Picker
+//
+
+WeightedRoundRobin::Picker::Picker(WeightedRoundRobin* parent,
+                                   WrrSubchannelList* subchannel_list)
+    : parent_(parent),
+      config_(parent->config_),
+      // Start at a random index, as round_robin does, so that clients created
+      // at the same time don't all send their first calls to one backend.
+      sequence_(static_cast<uint64_t>(rand())),
+      next_update_time_(GRPC_MILLIS_INF_FUTURE) {
+  for (size_t i = 0; i < subchannel_list->num_subchannels(); ++i) {
+    WrrSubchannelData* sd = subchannel_list->subchannel(i);
+    if (sd->connectivity_state() == GRPC_CHANNEL_READY) {
+      subchannels_.push_back({sd->subchannel()->Ref(), sd->weight()});
+    }
+  }
+  BuildScheduler(ExecCtx::Get()->Now());
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO,
+            "[WRR %p picker %p] created picker from subchannel_list=%p "
+            "with %" PRIuPTR " READY subchannels",
+            parent_, this, subchannel_list, subchannels_.size());
+  }
+}
+
+void WeightedRoundRobin::Picker::BuildScheduler(grpc_millis now) {
+  std::vector<double> weights;
+  weights.reserve(subchannels_.size());
+  for (const Entry& entry : subchannels_) {
+    weights.push_back(
+        entry.weight->GetWeight(now, config_->weight_expiration_period(),
+                                config_->blackout_period()));
+  }
+  std::shared_ptr<const StaticStrideScheduler> scheduler =
+      StaticStrideScheduler::Make(weights);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p picker %p] %s", parent_, this,
+            scheduler != nullptr ? "scheduling by weight"
+                                 : "no weights: scheduling evenly");
+  }
+  {
+    MutexLock lock(&scheduler_mu_);
+    scheduler_ = std::move(scheduler);
+  }
+  next_update_time_.store(now + config_->weight_update_period(),
+                          std::memory_order_relaxed);
+}
+
+void WeightedRoundRobin::Picker::MaybeUpdateScheduler(grpc_millis now) {
+  grpc_millis next_update_time =
+      next_update_time_.load(std::memory_order_relaxed);
+  if (GPR_LIKELY(now < next_update_time)) return;
+  // Only one pick does the update; the others keep the current schedule.
+  if (!next_update_time_.compare_exchange_strong(next_update_time,
+                                                 GRPC_MILLIS_INF_FUTURE,
+                                                 std::memory_order_relaxed)) {
+    return;
+  }
+  BuildScheduler(now);
+}
+
+WeightedRoundRobin::PickResult WeightedRoundRobin::Picker::Pick(
+    PickArgs /*args*/) {
+  MaybeUpdateScheduler(ExecCtx::Get()->Now());
+  std::shared_ptr<const StaticStrideScheduler> scheduler;
+  {
+    MutexLock lock(&scheduler_mu_);
+    scheduler = scheduler_;
+  }
+  const size_t index =
+      scheduler != nullptr
+          ? scheduler->Pick(&sequence_)
+          : sequence_.fetch_add(1, std::memory_order_relaxed) %
+                subchannels_.size();
+  const Entry& entry = subchannels_[index];
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO,
+            "[WRR %p picker %p] returning index %" PRIuPTR ", subchannel=%p",
+            parent_, this, index, entry.subchannel.get());
+  }
+  return PickResult::Complete(entry.subchannel,
+                              absl::make_unique<CallTracker>(entry.weight));
+}
+
+//
+// WeightedRoundRobin
+//
+
+WeightedRoundRobin::WeightedRoundRobin(Args args)
+    : LoadBalancingPolicy(std::move(args)) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Created", this);
+  }
+}
+
+WeightedRoundRobin::~WeightedRoundRobin() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Destroying", this);
+  }
+  GPR_ASSERT(subchannel_list_ == nullptr);
+  GPR_ASSERT(latest_pending_subchannel_list_ == nullptr);
+}
+
+void WeightedRoundRobin::ShutdownLocked() {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(GPR_INFO, "[WRR %p] Shutting down", this);
+  }
+  shutdown_ = true;
+  subchannel_list_.reset();
+  latest_pending_subchannel_list_.reset();
+}
+
+void WeightedRoundRobin::ResetBackoffLocked() {
+  subchannel_list_->ResetBackoffLocked();
+  if (latest_pending_subchannel_list_ != nullptr) {
+    latest_pending_subchannel_list_->ResetBackoffLocked();
+  }
+}
+
+void WeightedRoundRobin::WrrSubchannelList::StartWatchingLocked() {
+  if (num_subchannels() == 0) return;
+  // Check current state of each subchannel synchronously, since any
+  // subchannel already used by some other channel may have a non-IDLE
+  // state.
+  for (size_t i = 0; i < num_subchannels(); ++i) {
+    grpc_connectivity_state state =
+        subchannel(i)->CheckConnectivityStateLocked();
+    if (state != GRPC_CHANNEL_IDLE) {
+      subchannel(i)->UpdateConnectivityStateLocked(state);
+    }
+  }
+  // Start connectivity watch for each subchannel.
+  for (size_t i = 0; i < num_subchannels(); i++) {
+    if (subchannel(i)->subchannel() != nullptr) {
+      subchannel(i)->StartConnectivityWatchLocked();
+      subchannel(i)->subchannel()->AttemptToConnect();
+    }
+  }
+  // Now set the LB policy's state based on the subchannels' states.
+  UpdateStateFromSubchannelStateCountsLocked();
+}
+
+void WeightedRoundRobin::WrrSubchannelList::UpdateStateCountersLocked(
+    grpc_connectivity_state old_state, grpc_connectivity_state new_state) {
+  GPR_ASSERT(old_state != GRPC_CHANNEL_SHUTDOWN);
+  GPR_ASSERT(new_state != GRPC_CHANNEL_SHUTDOWN);
+  if (old_state == GRPC_CHANNEL_READY) {
+    GPR_ASSERT(num_ready_ > 0);
+    --num_ready_;
+  } else if (old_state == GRPC_CHANNEL_CONNECTING) {
+    GPR_ASSERT(num_connecting_ > 0);
+    --num_connecting_;
+  } else if (old_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    GPR_ASSERT(num_transient_failure_ > 0);
+    --num_transient_failure_;
+  }
+  if (new_state == GRPC_CHANNEL_READY) {
+    ++num_ready_;
+  } else if (new_state == GRPC_CHANNEL_CONNECTING) {
+    ++num_connecting_;
+  } else if (new_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    ++num_transient_failure_;
+  }
+}
+
+// Sets the policy's connectivity state and generates a new picker based
+// on the current subchannel list, with the same rules as round_robin.
+void WeightedRoundRobin::WrrSubchannelList::
+    MaybeUpdateConnectivityStateLocked() {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  // Only set connectivity state if this is the current subchannel list.
+  if (p->subchannel_list_.get() != this) return;
+  if (num_ready_ > 0) {
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_READY, absl::Status(), absl::make_unique<Picker>(p, this));
+  } else if (num_connecting_ > 0) {
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_CONNECTING, absl::Status(),
+        absl::make_unique<QueuePicker>(p->Ref(DEBUG_LOCATION, "QueuePicker")));
+  } else if (num_transient_failure_ == num_subchannels()) {
+    absl::Status status =
+        absl::UnavailableError("connections to all backends failing");
+    p->channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, status,
+        absl::make_unique<TransientFailurePicker>(status));
+  }
+}
+
+void WeightedRoundRobin::WrrSubchannelList::
+    UpdateStateFromSubchannelStateCountsLocked() {
+  WeightedRoundRobin* p = static_cast<WeightedRoundRobin*>(policy());
+  // If we have at least one READY subchannel, or all of them are in
+  // TRANSIENT_FAILURE, swap to the new list.
+  if (num_ready_ > 0 || num_transient_failure_ == num_subchannels()) {
+    if (p->subchannel_list_.get() != this) {
+      GPR_ASSERT(p->latest_pending_subchannel_list_.get() == this);
+      GPR_ASSERT(!shutting_down());
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+        const size_t old_num_subchannels =
+            p->subchannel_list_ != nullptr
+                ? p->subchannel_list_->num_subchannels()
+                : 0;
+        gpr_log(GPR_INFO,
+                "[WRR %p] phasing out subchannel list %p (size %" PRIuPTR
+                ") in favor of %p (size %" PRIuPTR ")",
+                p, p->subchannel_list_.get(), old_num_subchannels, this,
+                num_subchannels());
+      }
+      p->subchannel_list_ = std::move(p->latest_pending_subchannel_list_);
+    }
+  }
+  MaybeUpdateConnectivityStateLocked();
+}
+
+WeightedRoundRobin::WrrSubchannelData::WrrSubchannelData(
+    SubchannelList<WrrSubchannelList, WrrSubchannelData>* subchannel_list,
+    const ServerAddress& address, RefCountedPtr<SubchannelInterface> subchannel)
+    : SubchannelData(subchannel_list, address, std::move(subchannel)) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list->policy());
+  auto it = p->endpoint_weights_.find(
+      grpc_sockaddr_to_string(&address.address(), /*normalize=*/false));
+  weight_ = it != p->endpoint_weights_.end() ? it->second
+                                             : MakeRefCounted<EndpointWeight>();
+}
+
+void WeightedRoundRobin::WrrSubchannelData::UpdateConnectivityStateLocked(
+    grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+    gpr_log(
+        GPR_INFO,
+        "[WRR %p] connectivity changed for subchannel %p, subchannel_list %p "
+        "(index %" PRIuPTR " of %" PRIuPTR "): prev_state=%s new_state=%s",
+        p, subchannel(), subchannel_list(), Index(),
+        subchannel_list()->num_subchannels(),
+        ConnectivityStateName(last_connectivity_state_),
+        ConnectivityStateName(connectivity_state));
+  }
+  // As in round_robin: once we see a failure, report TRANSIENT_FAILURE until
+  // the subchannel is READY again.
+  if (!seen_failure_since_ready_) {
+    if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+      seen_failure_since_ready_ = true;
+    }
+    subchannel_list()->UpdateStateCountersLocked(last_connectivity_state_,
+                                                 connectivity_state);
+  } else {
+    if (connectivity_state == GRPC_CHANNEL_READY) {
+      seen_failure_since_ready_ = false;
+      subchannel_list()->UpdateStateCountersLocked(
+          GRPC_CHANNEL_TRANSIENT_FAILURE, connectivity_state);
+    }
+  }
+  last_connectivity_state_ = connectivity_state;
+}
+
+void WeightedRoundRobin::WrrSubchannelData::ProcessConnectivityChangeLocked(
+    grpc_connectivity_state connectivity_state) {
+  WeightedRoundRobin* p =
+      static_cast<WeightedRoundRobin*>(subchannel_list()->policy());
+  GPR_ASSERT(subchannel() != nullptr);
+  // If the new state is TRANSIENT_FAILURE, re-resolve and attempt to
+  // reconnect.
+  if (connectivity_state == GRPC_CHANNEL_TRANSIENT_FAILURE) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO,
+              "[WRR %p] Subchannel %p has gone into TRANSIENT_FAILURE. "
+              "Requesting re-resolution",
+              p, subchannel());
+    }
+    p->channel_control_helper()->RequestReresolution();
+    subchannel()->AttemptToConnect();
+  }
+  UpdateConnectivityStateLocked(connectivity_state);
+  subchannel_list()->UpdateStateFromSubchannelStateCountsLocked();
+}
+
+void WeightedRoundRobin::UpdateLocked(UpdateArgs args) {
+  config_ = std::move(args.config);
+  ServerAddressList addresses;
+  if (args.addresses.ok()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] received update with %" PRIuPTR " addresses",
+              this, args.addresses->size());
+    }
+    addresses = std::move(*args.addresses);
+  } else {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace)) {
+      gpr_log(GPR_INFO, "[WRR %p] received update with address error: %s",
+              this, args.addresses.status().ToString().c_str());
+    }
+    // If we already have a subchannel list, then ignore the resolver
+    // failure and keep using the existing list.
+    if (subchannel_list_ != nullptr) return;
+  }
+  // Keep the weights of the addresses still in the list.
+  std::map<std::string, RefCountedPtr<EndpointWeight>> endpoint_weights;
+  for (const ServerAddress& address : addresses) {
+    std::string key =
+        grpc_sockaddr_to_string(&address.address(), /*normalize=*/false);
+    auto it = endpoint_weights_.find(key);
+    endpoint_weights.emplace(std::move(key),
+                             it != endpoint_weights_.end()
+                                 ? it->second
+                                 : MakeRefCounted<EndpointWeight>());
+  }
+  endpoint_weights_ = std::move(endpoint_weights);
+  // Replace latest_pending_subchannel_list_.
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_wrr_trace) &&
+      latest_pending_subchannel_list_ != nullptr) {
+    gpr_log(GPR_INFO,
+            "[WRR %p] Shutting down previous pending subchannel list %p", this,
+            latest_pending_subchannel_list_.get());
+  }
+  latest_pending_subchannel_list_ = MakeOrphanable<WrrSubchannelList>(
+      this, std::move(addresses), *args.args);
+  if (latest_pending_subchannel_list_->num_subchannels() == 0) {
+    // If the new list is empty, immediately promote the new list to the
+    // current list and transition to TRANSIENT_FAILURE.
+    absl::Status status =
+        args.addresses.ok() ? absl::UnavailableError(absl::StrCat(
+                                  "empty address list: ", args.resolution_note))
+                            : args.addresses.status();
+    channel_control_helper()->UpdateState(
+        GRPC_CHANNEL_TRANSIENT_FAILURE, status,
+        absl::make_unique<TransientFailurePicker>(status));
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+  } else if (subchannel_list_ == nullptr) {
+    // If there is no current list, immediately promote the new list to
+    // the current list and start watching it.
+    subchannel_list_ = std::move(latest_pending_subchannel_list_);
+    subchannel_list_->StartWatchingLocked();
+  } else {
+    // Start watching the pending list.  It will get swapped into the
+    // current list when it reports READY.
+    latest_pending_subchannel_list_->StartWatchingLocked();
+  }
+}
+
+//
+// factory
+//
+
+class WeightedRoundRobinFactory : public LoadBalancingPolicyFactory {
+ public:
+  OrphanablePtr<LoadBalancingPolicy> CreateLoadBalancingPolicy(
+      LoadBalancingPolicy::Args args) const override {
+    return MakeOrphanable<WeightedRoundRobin>(std::move(args));
+  }
+
+  const char* name() const override { return kWeightedRoundRobin; }
+
+  RefCountedPtr<LoadBalancingPolicy::Config> ParseLoadBalancingConfig(
+      const Json& json, grpc_error_handle* error) const override {
+    std::vector<grpc_error_handle> error_list;
+    grpc_millis blackout_period = kDefaultBlackoutPeriod;
+    grpc_millis weight_expiration_period = kDefaultWeightExpirationPeriod;
+    grpc_millis weight_update_period = kDefaultWeightUpdatePeriod;
+    if (json.type() == Json::Type::OBJECT) {
+      const Json::Object& object = json.object_value();
+      ParseJsonObjectFieldAsDuration(object, "blackoutPeriod", &blackout_period,
+                                     &error_list, /*required=*/false);
+      if (ParseJsonObjectFieldAsDuration(object, "weightExpirationPeriod",
+                                         &weight_expiration_period,
+                                         &error_list, /*required=*/false) &&
+          weight_expiration_period <= 0) {
+        error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "field:weightExpirationPeriod error:must be greater than 0"));
+      }
+      if (ParseJsonObjectFieldAsDuration(object, "weightUpdatePeriod",
+                                         &weight_update_period, &error_list,
+                                         /*required=*/false)) {
+        weight_update_period =
+            std::max(weight_update_period, kMinWeightUpdatePeriod);
+      }
+    } else if (json.type() != Json::Type::JSON_NULL) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "error:type should be OBJECT"));
+    }
+    if (!error_list.empty()) {
+      *error = GRPC_ERROR_CREATE_FROM_VECTOR(
+          "weighted_round_robin LB policy config", &error_list);
+      return nullptr;
+    }
+    return MakeRefCounted<WeightedRoundRobinConfig>(
+        blackout_period, weight_expiration_period, weight_update_period);
+  }
+};
+
+}  // namespace
+
+void GrpcLbPolicyWeightedRoundRobinInit() {
+  LoadBalancingPolicyRegistry::Builder::RegisterLoadBalancingPolicyFactory(
+      absl::make_unique<WeightedRoundRobinFactory>());
+}
+
+void GrpcLbPolicyWeightedRoundRobinShutdown() {}
+
+}  // namespace grpc_core
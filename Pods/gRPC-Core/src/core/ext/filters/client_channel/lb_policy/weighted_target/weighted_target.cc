@@ -56,6 +56,8 @@ class WeightedTargetLbConfig : public LoadBalancingPolicy::Config {
   struct ChildConfig {
     uint32_t weight;
     RefCountedPtr<LoadBalancingPolicy::Config> config;
+    // The JSON form of config, used to tell whether it changed.
+    Json config_json;
   };
 
   using TargetMap = std::map<std::string, ChildConfig>;
@@ -178,6 +180,13 @@ class WeightedTargetLb : public LoadBalancingPolicy {
 
     OrphanablePtr<LoadBalancingPolicy> child_policy_;
 
+    // What the child policy was last updated with, so that an update
+    // which changes nothing for this child is not passed down to it.
+    bool last_update_valid_ = false;
+    Json last_config_json_;
+    ServerAddressList last_addresses_;
+    grpc_channel_args* last_args_ = nullptr;
+
     RefCountedPtr<ChildPickerWrapper> picker_wrapper_;
     grpc_connectivity_state connectivity_state_ = GRPC_CHANNEL_CONNECTING;
     bool seen_failure_since_ready_ = false;
@@ -423,6 +432,7 @@ WeightedTargetLb::WeightedChild::~WeightedChild() {
             "[weighted_target_lb %p] WeightedChild %p %s: destroying child",
             weighted_target_policy_.get(), this, name_.c_str());
   }
+  grpc_channel_args_destroy(last_args_);
   weighted_target_policy_.reset(DEBUG_LOCATION, "WeightedChild");
 }
 
@@ -497,6 +507,28 @@ void WeightedTargetLb::WeightedChild::UpdateLocked(
   if (child_policy_ == nullptr) {
     child_policy_ = CreateChildPolicyLocked(args);
   }
+  // If neither the config, the addresses nor the args of this child have
+  // changed, skip the update, so that an endpoint change in one locality
+  // does not rebuild the subchannel lists of all the others.
+  if (last_update_valid_ && addresses.ok() &&
+      config.config_json == last_config_json_ &&
+      *addresses == last_addresses_ &&
+      grpc_channel_args_compare(args, last_args_) == 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_lb_weighted_target_trace)) {
+      gpr_log(GPR_INFO,
+              "[weighted_target_lb %p] WeightedChild %p %s: unchanged, "
+              "skipping update",
+              weighted_target_policy_.get(), this, name_.c_str());
+    }
+    return;
+  }
+  last_update_valid_ = addresses.ok();
+  if (last_update_valid_) {
+    last_config_json_ = config.config_json;
+    last_addresses_ = *addresses;
+    grpc_channel_args_destroy(last_args_);
+    last_args_ = grpc_channel_args_copy(args);
+  }
   // Construct update args.
   UpdateArgs update_args;
   update_args.config = config.config;
@@ -718,6 +750,7 @@ class WeightedTargetLbFactory : public LoadBalancingPolicyFactory {
       child_config->config =
           LoadBalancingPolicyRegistry::ParseLoadBalancingConfig(it->second,
                                                                 &parse_error);
+      child_config->config_json = it->second;
       if (child_config->config == nullptr) {
         GPR_DEBUG_ASSERT(parse_error != GRPC_ERROR_NONE);
         std::vector<grpc_error_handle> child_errors;
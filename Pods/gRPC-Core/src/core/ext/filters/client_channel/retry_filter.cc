@@ -84,9 +84,16 @@
 // CallAttempt object against the state in the CallData object to see
 // which batches need to be sent on the LB call for a given attempt.
 
+// With a hedging policy, instead of waiting for an attempt to fail, we
+// start a new attempt every hedgingDelay while the call is not yet
+// committed.  All attempts in flight get the same send ops; whichever one
+// first returns a result that commits the call wins, and the others are
+// cancelled.  Hedged attempts read the same cached send_message data
+// concurrently, so that data is read in full when it's cached and only
+// freed when the call is destroyed.
+
 // TODO(roth): In subsequent PRs:
 // - add support for transparent retries (including initial metadata)
-// - implement hedging
 
 // By default, we buffer 256 KiB per RPC for retries.
 // TODO(roth): Do we have any data to suggest a better value?
@@ -225,6 +232,13 @@ class RetryFilter::CallData {
     // Cancels the call attempt.
     void CancelFromSurface(grpc_transport_stream_op_batch* cancel_batch);
 
+    // Adds whatever batches are needed on this attempt to closures.
+    void AddRetriableBatches(CallCombinerClosureList* closures);
+
+    // Abandons a hedged attempt after the call was committed to another
+    // one, adding a batch to closures to cancel it.
+    void CancelLosingAttempt(CallCombinerClosureList* closures);
+
    private:
     // State used for starting a retryable batch on the call attempt's LB call.
     // This provides its own grpc_transport_stream_op_batch and other data
@@ -332,7 +346,7 @@ class RetryFilter::CallData {
       void Commit() override {
         call_attempt_->lb_call_committed_ = true;
         auto* calld = call_attempt_->calld_;
-        if (calld->retry_committed_) {
+        if (calld->retry_committed_ && !call_attempt_->abandoned_) {
           auto* service_config_call_data =
               static_cast<ClientChannelServiceConfigCallData*>(
                   calld->call_context_[GRPC_CONTEXT_SERVICE_CONFIG_CALL_DATA]
@@ -378,9 +392,6 @@ class RetryFilter::CallData {
     // Adds batches for pending batches to closures.
     void AddBatchesForPendingBatches(CallCombinerClosureList* closures);
 
-    // Adds whatever batches are needed on this attempt to closures.
-    void AddRetriableBatches(CallCombinerClosureList* closures);
-
     // Returns true if any send op in the batch was not yet started on this
     // attempt.
     bool PendingBatchContainsUnstartedSendOps(PendingBatch* pending);
@@ -397,6 +408,13 @@ class RetryFilter::CallData {
     bool ShouldRetry(absl::optional<grpc_status_code> status, bool is_lb_drop,
                      absl::optional<grpc_millis> server_pushback_ms);
 
+    // With a hedging policy, returns true if the result of this attempt
+    // should be discarded, because it has a non-fatal status and another
+    // attempt is in flight or can still be started.
+    bool ShouldDiscardForHedging(
+        grpc_status_code status, bool is_lb_drop,
+        absl::optional<grpc_millis> server_pushback_ms);
+
     // Abandons the call attempt.  Unrefs any deferred batches.
     void Abandon();
 
@@ -503,6 +521,30 @@ class RetryFilter::CallData {
   // Commits the call so that no further retry attempts will be performed.
   void RetryCommit(CallAttempt* call_attempt);
 
+  bool hedging() const {
+    return retry_policy_ != nullptr &&
+           retry_policy_->hedging_delay().has_value();
+  }
+  // Returns true if another hedged attempt may be started.
+  bool CanStartHedgedAttempt();
+  // Returns true if an attempt other than call_attempt is in flight.
+  bool HaveOtherAttemptsInFlight(CallAttempt* call_attempt) const {
+    return !hedged_attempts_.empty() ||
+           (call_attempt_ != nullptr && call_attempt_.get() != call_attempt);
+  }
+  // Stops tracking a hedged attempt whose result was discarded.  If no
+  // attempt is left in flight, starts the next one without waiting for
+  // the hedging delay.
+  void DiscardHedgedAttempt(CallAttempt* call_attempt,
+                            absl::optional<grpc_millis> server_pushback_ms);
+  // Makes winner the current attempt and cancels all the others.
+  void CancelLosingHedgedAttempts(CallAttempt* winner);
+
+  void MaybeStartHedgingTimer();
+  void MaybeCancelHedgingTimer();
+  static void OnHedgingTimer(void* arg, grpc_error_handle error);
+  static void OnHedgingTimerLocked(void* arg, grpc_error_handle error);
+
   // Starts a timer to retry after appropriate back-off.
   // If server_pushback_ms is nullopt, retry_backoff_ is used.
   void StartRetryTimer(absl::optional<grpc_millis> server_pushback_ms);
@@ -532,10 +574,11 @@ class RetryFilter::CallData {
 
   RefCountedPtr<CallStackDestructionBarrier> call_stack_destruction_barrier_;
 
-  // TODO(roth): As part of implementing hedging, we will need to maintain a
-  // list of all pending attempts, so that we can cancel them all if the call
-  // gets cancelled.
+  // The most recently started call attempt, or the one committed to.
   RefCountedPtr<CallAttempt> call_attempt_;
+  // With hedging, the other attempts still in flight.  If call_attempt_
+  // is null, this is empty.
+  absl::InlinedVector<RefCountedPtr<CallAttempt>, 4> hedged_attempts_;
 
   // LB call used when we've committed to a call attempt and the retry
   // state for that attempt is no longer needed.  This provides a fast
@@ -560,6 +603,14 @@ class RetryFilter::CallData {
   grpc_timer retry_timer_;
   grpc_closure retry_closure_;
 
+  // Hedging state.
+  bool hedging_timer_pending_ : 1;
+  // Set when throttling or server push-back stops new hedged attempts.
+  bool hedging_throttled_ : 1;
+  int num_attempts_started_ = 0;
+  grpc_timer hedging_timer_;
+  grpc_closure hedging_closure_;
+
   // Cached data for retrying send ops.
   // send_initial_metadata
   bool seen_send_initial_metadata_ = false;
@@ -581,10 +632,9 @@ class RetryFilter::CallData {
   // Note: We inline the cache for the first 3 send_message ops and use
   // dynamic allocation after that.  This number was essentially picked
   // at random; it could be changed in the future to tune performance.
-  // TODO(roth): As part of implementing hedging, we may need some
-  // synchronization here, since ByteStreamCache does not provide any
-  // synchronization, so it's not safe to have multiple
-  // CachingByteStreams read from the same ByteStreamCache concurrently.
+  // ByteStreamCache does not provide any synchronization, so with hedging,
+  // each message is read in full when it's cached, and then the
+  // CachingByteStreams of concurrent attempts only read the cache.
   absl::InlinedVector<ByteStreamCache*, 3> send_messages_;
   // send_trailing_metadata
   bool seen_send_trailing_metadata_ = false;
@@ -701,10 +751,9 @@ RetryFilter::CallData::CallAttempt::~CallAttempt() {
 }
 
 void RetryFilter::CallData::CallAttempt::FreeCachedSendOpDataAfterCommit() {
-  // TODO(roth): When we implement hedging, this logic will need to get
-  // a bit more complex, because there may be other (now abandoned) call
-  // attempts still using this data.  We may need to do some sort of
-  // ref-counting instead.
+  // With hedging, abandoned attempts may still be using this data, so it
+  // is freed when the call is destroyed instead.
+  if (calld_->hedging()) return;
   if (completed_send_initial_metadata_) {
     calld_->FreeCachedSendInitialMetadata();
   }
@@ -744,12 +793,11 @@ bool RetryFilter::CallData::CallAttempt::HaveSendOpsToReplay() {
 }
 
 void RetryFilter::CallData::CallAttempt::MaybeSwitchToFastPath() {
-  // If we're not yet committed, we can't switch yet.
-  // TODO(roth): As part of implementing hedging, this logic needs to
-  // check that *this* call attempt is the one that we've committed to.
-  // Might need to replace abandoned_ with an enum indicating whether we're
-  // in flight, abandoned, or the winning call attempt.
-  if (!calld_->retry_committed_) return;
+  // If we're not yet committed, or committed to another attempt, we can't
+  // switch yet.
+  if (!calld_->retry_committed_ || calld_->call_attempt_.get() != this) {
+    return;
+  }
   // If we've already switched to fast path, there's nothing to do here.
   if (calld_->committed_call_ != nullptr) return;
   // If the perAttemptRecvTimeout timer is pending, we can't switch yet.
@@ -1058,6 +1106,22 @@ void RetryFilter::CallData::CallAttempt::CancelFromSurface(
   lb_call_->StartTransportStreamOpBatch(cancel_batch);
 }
 
+void RetryFilter::CallData::CallAttempt::CancelLosingAttempt(
+    CallCombinerClosureList* closures) {
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p attempt=%p: cancelling losing hedged attempt",
+            calld_->chand_, calld_, this);
+  }
+  MaybeCancelPerAttemptRecvTimer();
+  AddBatchForCancelOp(
+      grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                             "call committed to another hedged attempt"),
+                         GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_CANCELLED),
+      closures);
+  Abandon();
+}
+
 bool RetryFilter::CallData::CallAttempt::ShouldRetry(
     absl::optional<grpc_status_code> status, bool is_lb_drop,
     absl::optional<grpc_millis> server_pushback_ms) {
@@ -1162,6 +1226,64 @@ bool RetryFilter::CallData::CallAttempt::ShouldRetry(
   return true;
 }
 
+bool RetryFilter::CallData::CallAttempt::ShouldDiscardForHedging(
+    grpc_status_code status, bool is_lb_drop,
+    absl::optional<grpc_millis> server_pushback_ms) {
+  // LB drops always fail the call.
+  if (is_lb_drop) return false;
+  if (GPR_LIKELY(status == GRPC_STATUS_OK)) {
+    if (calld_->retry_throttle_data_ != nullptr) {
+      calld_->retry_throttle_data_->RecordSuccess();
+    }
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p attempt=%p: call succeeded",
+              calld_->chand_, calld_, this);
+    }
+    return false;
+  }
+  // A fatal status fails the call right away.
+  if (!calld_->retry_policy_->retryable_status_codes().Contains(status)) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO,
+              "chand=%p calld=%p attempt=%p: status %s not configured as "
+              "non-fatal",
+              calld_->chand_, calld_, this, grpc_status_code_to_string(status));
+    }
+    return false;
+  }
+  // A non-fatal failure counts against the throttle like a retry does.
+  // Throttling or negative server push-back stops new hedged attempts,
+  // but the ones in flight may still succeed.
+  if (calld_->retry_throttle_data_ != nullptr &&
+      !calld_->retry_throttle_data_->RecordFailure()) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p attempt=%p: hedging throttled",
+              calld_->chand_, calld_, this);
+    }
+    calld_->hedging_throttled_ = true;
+  }
+  if (server_pushback_ms.has_value() && *server_pushback_ms < 0) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO,
+              "chand=%p calld=%p attempt=%p: no more hedging due to server "
+              "push-back",
+              calld_->chand_, calld_, this);
+    }
+    calld_->hedging_throttled_ = true;
+  }
+  if (calld_->retry_committed_) return false;
+  if (calld_->HaveOtherAttemptsInFlight(this) ||
+      calld_->CanStartHedgedAttempt()) {
+    return true;
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p attempt=%p: no hedged attempts left in flight",
+            calld_->chand_, calld_, this);
+  }
+  return false;
+}
+
 void RetryFilter::CallData::CallAttempt::Abandon() {
   abandoned_ = true;
   // Unref batches for deferred completion callbacks that will now never
@@ -1218,9 +1340,8 @@ void RetryFilter::CallData::CallAttempt::OnPerAttemptRecvTimerLocked(
   if (error == GRPC_ERROR_NONE &&
       call_attempt->per_attempt_recv_timer_pending_) {
     call_attempt->per_attempt_recv_timer_pending_ = false;
-    // Cancel this attempt.
-    // TODO(roth): When implementing hedging, we should not cancel the
-    // current attempt.
+    // Cancel this attempt.  (Hedging policies have no per-attempt recv
+    // timeout, so this is never a hedged attempt.)
     call_attempt->AddBatchForCancelOp(
         grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
                                "retry perAttemptRecvTimeout exceeded"),
@@ -1303,10 +1424,9 @@ RetryFilter::CallData::CallAttempt::BatchData::~BatchData() {
 void RetryFilter::CallData::CallAttempt::BatchData::
     FreeCachedSendOpDataForCompletedBatch() {
   auto* calld = call_attempt_->calld_;
-  // TODO(roth): When we implement hedging, this logic will need to get
-  // a bit more complex, because there may be other (now abandoned) call
-  // attempts still using this data.  We may need to do some sort of
-  // ref-counting instead.
+  // With hedging, abandoned attempts may still be using this data, so it
+  // is freed when the call is destroyed instead.
+  if (calld->hedging()) return;
   if (batch_.send_initial_metadata) {
     calld->FreeCachedSendInitialMetadata();
   }
@@ -1687,8 +1807,28 @@ void RetryFilter::CallData::CallAttempt::BatchData::RecvTrailingMetadataReady(
         calld->chand_, calld, call_attempt, grpc_status_code_to_string(status),
         is_lb_drop);
   }
-  // Check if we should retry.
-  if (call_attempt->ShouldRetry(status, is_lb_drop, server_pushback_ms)) {
+  // With hedging, drop a non-fatal result as long as there is another
+  // attempt to wait for.
+  if (calld->hedging()) {
+    if (call_attempt->ShouldDiscardForHedging(status, is_lb_drop,
+                                              server_pushback_ms)) {
+      CallCombinerClosureList closures;
+      call_attempt->AddBatchForCancelOp(
+          error == GRPC_ERROR_NONE
+              ? grpc_error_set_int(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                                       "hedged attempt failed"),
+                                   GRPC_ERROR_INT_GRPC_STATUS,
+                                   GRPC_STATUS_CANCELLED)
+              : GRPC_ERROR_REF(error),
+          &closures);
+      call_attempt->Abandon();
+      calld->DiscardHedgedAttempt(call_attempt, server_pushback_ms);
+      // Yields call combiner.
+      closures.RunClosures(calld->call_combiner_);
+      return;
+    }
+  } else if (call_attempt->ShouldRetry(status, is_lb_drop,
+                                       server_pushback_ms)) {
     // Start retry timer.
     calld->StartRetryTimer(server_pushback_ms);
     // Cancel call attempt.
@@ -1884,12 +2024,15 @@ void RetryFilter::CallData::CallAttempt::BatchData::
   // the filters in the subchannel stack may modify this batch, and we don't
   // want those modifications to be passed forward to subsequent attempts.
   //
-  // If we've already completed one or more attempts, add the
-  // grpc-retry-attempts header.
+  // If we've already completed one or more attempts (or, with hedging,
+  // started them), add the grpc-retry-attempts header.
   call_attempt_->send_initial_metadata_ = calld->send_initial_metadata_.Copy();
-  if (GPR_UNLIKELY(calld->num_attempts_completed_ > 0)) {
+  const int previous_attempts = calld->hedging()
+                                    ? calld->num_attempts_started_ - 1
+                                    : calld->num_attempts_completed_;
+  if (GPR_UNLIKELY(previous_attempts > 0)) {
     call_attempt_->send_initial_metadata_.Set(GrpcPreviousRpcAttemptsMetadata(),
-                                              calld->num_attempts_completed_);
+                                              previous_attempts);
   } else {
     call_attempt_->send_initial_metadata_.Remove(
         GrpcPreviousRpcAttemptsMetadata());
@@ -2074,9 +2217,14 @@ RetryFilter::CallData::CallData(RetryFilter* chand,
       pending_send_message_(false),
       pending_send_trailing_metadata_(false),
       retry_committed_(false),
-      retry_timer_pending_(false) {}
+      retry_timer_pending_(false),
+      hedging_timer_pending_(false),
+      hedging_throttled_(false) {}
 
 RetryFilter::CallData::~CallData() {
+  // With hedging, cached send ops are kept until all attempts are done with
+  // them.  Every batch holds a ref to the call stack, so they are by now.
+  if (hedging()) FreeAllCachedSendOpData();
   grpc_slice_unref_internal(path_);
   // Make sure there are no remaining pending batches.
   for (size_t i = 0; i < GPR_ARRAY_SIZE(pending_batches_); ++i) {
@@ -2102,15 +2250,11 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
     }
     // If we have a current call attempt, commit the call, then send
     // the cancellation down to that attempt.  When the call fails, it
-    // will not be retried, because we have committed it here.
+    // will not be retried, because we have committed it here.  With
+    // hedging, committing cancels the other attempts; we don't wait for
+    // those cancellations before completing this batch.
     if (call_attempt_ != nullptr) {
       RetryCommit(call_attempt_.get());
-      // TODO(roth): When implementing hedging, this will get more
-      // complex, because instead of just passing the batch down to a
-      // single call attempt, we'll need to cancel multiple call
-      // attempts and wait for the cancellation on_complete from each call
-      // attempt before we propagate the on_complete from this batch
-      // back to the surface.
       // Note: This will release the call combiner.
       call_attempt_->CancelFromSurface(batch);
       return;
@@ -2128,6 +2272,7 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
       grpc_timer_cancel(&retry_timer_);
       FreeAllCachedSendOpData();
     }
+    MaybeCancelHedgingTimer();
     // Fail pending batches.
     PendingBatchesFail(GRPC_ERROR_REF(cancel_error));
     // Note: This will release the call combiner.
@@ -2205,10 +2350,22 @@ void RetryFilter::CallData::StartTransportStreamOpBatch(
   }
   // Send batches to call attempt.
   if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
-    gpr_log(GPR_INFO, "chand=%p calld=%p: starting batch on attempt=%p", chand_,
-            this, call_attempt_.get());
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p: starting batch on attempt=%p and %" PRIuPTR
+            " other hedged attempts",
+            chand_, this, call_attempt_.get(), hedged_attempts_.size());
   }
-  call_attempt_->StartRetriableBatches();
+  if (GPR_LIKELY(hedged_attempts_.empty())) {
+    call_attempt_->StartRetriableBatches();
+    return;
+  }
+  CallCombinerClosureList closures;
+  for (auto& call_attempt : hedged_attempts_) {
+    call_attempt->AddRetriableBatches(&closures);
+  }
+  call_attempt_->AddRetriableBatches(&closures);
+  // Note: This will yield the call combiner.
+  closures.RunClosures(call_combiner_);
 }
 
 OrphanablePtr<ClientChannel::LoadBalancedCall>
@@ -2228,7 +2385,9 @@ RetryFilter::CallData::CreateLoadBalancedCall(
 }
 
 void RetryFilter::CallData::CreateCallAttempt() {
+  ++num_attempts_started_;
   call_attempt_ = MakeRefCounted<CallAttempt>(this);
+  MaybeStartHedgingTimer();
   call_attempt_->StartRetriableBatches();
 }
 
@@ -2255,6 +2414,24 @@ void RetryFilter::CallData::MaybeCacheSendOpsForBatch(PendingBatch* pending) {
     ByteStreamCache* cache = arena_->New<ByteStreamCache>(
         std::move(batch->payload->send_message.send_message));
     send_messages_.push_back(cache);
+    // With hedging, read the whole message into the cache now, so that
+    // concurrent attempts never read the underlying stream.  Messages from
+    // the surface are always available synchronously.
+    if (hedging()) {
+      ByteStreamCache::CachingByteStream reader(cache);
+      size_t remaining = reader.length();
+      while (remaining > 0 && reader.Next(remaining, nullptr)) {
+        grpc_slice slice;
+        grpc_error_handle error = reader.Pull(&slice);
+        if (error != GRPC_ERROR_NONE) {
+          GRPC_ERROR_UNREF(error);
+          break;
+        }
+        remaining -= GRPC_SLICE_LENGTH(slice);
+        grpc_slice_unref_internal(slice);
+      }
+      reader.Orphan();
+    }
   }
   // Save metadata batch for send_trailing_metadata ops.
   if (batch->send_trailing_metadata) {
@@ -2347,9 +2524,9 @@ RetryFilter::CallData::PendingBatch* RetryFilter::CallData::PendingBatchesAdd(
   if (batch->send_trailing_metadata) {
     pending_send_trailing_metadata_ = true;
   }
-  // TODO(roth): When we implement hedging, if there are currently attempts
-  // in flight, we will need to pick the one on which the max number of send
-  // ops have already been sent, and we commit to that attempt.
+  // TODO(roth): With hedging, this commits to the most recently started
+  // attempt.  Ideally, we would pick the one on which the max number of
+  // send ops have already been sent.
   if (GPR_UNLIKELY(bytes_buffered_for_retry_ >
                    chand_->per_rpc_retry_buffer_size_)) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
@@ -2481,6 +2658,115 @@ void RetryFilter::CallData::RetryCommit(CallAttempt* call_attempt) {
     // Free cached send ops.
     call_attempt->FreeCachedSendOpDataAfterCommit();
   }
+  if (hedging()) {
+    MaybeCancelHedgingTimer();
+    if (call_attempt != nullptr) CancelLosingHedgedAttempts(call_attempt);
+  }
+}
+
+bool RetryFilter::CallData::CanStartHedgedAttempt() {
+  return !retry_committed_ && cancelled_from_surface_ == GRPC_ERROR_NONE &&
+         !hedging_throttled_ &&
+         num_attempts_started_ < retry_policy_->max_attempts() &&
+         (retry_throttle_data_ == nullptr ||
+          !retry_throttle_data_->IsThrottled());
+}
+
+void RetryFilter::CallData::DiscardHedgedAttempt(
+    CallAttempt* call_attempt, absl::optional<grpc_millis> server_pushback_ms) {
+  if (call_attempt_.get() == call_attempt) {
+    call_attempt_.reset(DEBUG_LOCATION, "DiscardHedgedAttempt");
+    if (!hedged_attempts_.empty()) {
+      call_attempt_ = std::move(hedged_attempts_.back());
+      hedged_attempts_.pop_back();
+    }
+  } else {
+    for (auto it = hedged_attempts_.begin(); it != hedged_attempts_.end();
+         ++it) {
+      if (it->get() == call_attempt) {
+        hedged_attempts_.erase(it);
+        break;
+      }
+    }
+  }
+  // If nothing is left in flight, start the next attempt right away, or
+  // after the server push-back.
+  if (call_attempt_ == nullptr) {
+    MaybeCancelHedgingTimer();
+    StartRetryTimer(server_pushback_ms.value_or(0));
+  }
+}
+
+void RetryFilter::CallData::CancelLosingHedgedAttempts(CallAttempt* winner) {
+  for (auto& call_attempt : hedged_attempts_) {
+    if (call_attempt.get() == winner) {
+      std::swap(call_attempt, call_attempt_);
+      break;
+    }
+  }
+  CallCombinerClosureList closures;
+  for (auto& call_attempt : hedged_attempts_) {
+    call_attempt->CancelLosingAttempt(&closures);
+  }
+  hedged_attempts_.clear();
+  closures.RunClosuresWithoutYielding(call_combiner_);
+}
+
+void RetryFilter::CallData::MaybeStartHedgingTimer() {
+  if (!hedging() || hedging_timer_pending_ || !CanStartHedgedAttempt()) {
+    return;
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+    gpr_log(GPR_INFO,
+            "chand=%p calld=%p: starting hedged attempt in %" PRId64 " ms",
+            chand_, this, *retry_policy_->hedging_delay());
+  }
+  GRPC_CLOSURE_INIT(&hedging_closure_, OnHedgingTimer, this, nullptr);
+  GRPC_CALL_STACK_REF(owning_call_, "OnHedgingTimer");
+  hedging_timer_pending_ = true;
+  grpc_timer_init(&hedging_timer_,
+                  ExecCtx::Get()->Now() + *retry_policy_->hedging_delay(),
+                  &hedging_closure_);
+}
+
+void RetryFilter::CallData::MaybeCancelHedgingTimer() {
+  if (hedging_timer_pending_) {
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: cancelling hedging timer", chand_,
+              this);
+    }
+    hedging_timer_pending_ = false;  // Lame timer callback.
+    grpc_timer_cancel(&hedging_timer_);
+  }
+}
+
+void RetryFilter::CallData::OnHedgingTimer(void* arg, grpc_error_handle error) {
+  auto* calld = static_cast<CallData*>(arg);
+  GRPC_CLOSURE_INIT(&calld->hedging_closure_, OnHedgingTimerLocked, calld,
+                    nullptr);
+  GRPC_CALL_COMBINER_START(calld->call_combiner_, &calld->hedging_closure_,
+                           GRPC_ERROR_REF(error), "hedging timer fired");
+}
+
+void RetryFilter::CallData::OnHedgingTimerLocked(void* arg,
+                                                 grpc_error_handle error) {
+  auto* calld = static_cast<CallData*>(arg);
+  if (error == GRPC_ERROR_NONE && calld->hedging_timer_pending_) {
+    calld->hedging_timer_pending_ = false;
+    if (calld->call_attempt_ != nullptr && calld->CanStartHedgedAttempt()) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_retry_trace)) {
+        gpr_log(GPR_INFO, "chand=%p calld=%p: starting hedged attempt",
+                calld->chand_, calld);
+      }
+      calld->hedged_attempts_.push_back(std::move(calld->call_attempt_));
+      // Note: This will yield the call combiner.
+      calld->CreateCallAttempt();
+      GRPC_CALL_STACK_UNREF(calld->owning_call_, "OnHedgingTimer");
+      return;
+    }
+  }
+  GRPC_CALL_COMBINER_STOP(calld->call_combiner_, "hedging timer cancelled");
+  GRPC_CALL_STACK_UNREF(calld->owning_call_, "OnHedgingTimer");
 }
 
 void RetryFilter::CallData::StartRetryTimer(
@@ -48,13 +48,15 @@ class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
   RetryMethodConfig(int max_attempts, grpc_millis initial_backoff,
                     grpc_millis max_backoff, float backoff_multiplier,
                     StatusCodeSet retryable_status_codes,
-                    absl::optional<grpc_millis> per_attempt_recv_timeout)
+                    absl::optional<grpc_millis> per_attempt_recv_timeout,
+                    absl::optional<grpc_millis> hedging_delay = absl::nullopt)
       : max_attempts_(max_attempts),
         initial_backoff_(initial_backoff),
         max_backoff_(max_backoff),
         backoff_multiplier_(backoff_multiplier),
         retryable_status_codes_(retryable_status_codes),
-        per_attempt_recv_timeout_(per_attempt_recv_timeout) {}
+        per_attempt_recv_timeout_(per_attempt_recv_timeout),
+        hedging_delay_(hedging_delay) {}
 
   int max_attempts() const { return max_attempts_; }
   grpc_millis initial_backoff() const { return initial_backoff_; }
@@ -66,6 +68,10 @@ class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
   absl::optional<grpc_millis> per_attempt_recv_timeout() const {
     return per_attempt_recv_timeout_;
   }
+  // Set if this is a hedging policy rather than a retry policy.  In that
+  // case, retryable_status_codes() holds the non-fatal status codes, and
+  // the backoff parameters are unused.
+  absl::optional<grpc_millis> hedging_delay() const { return hedging_delay_; }
 
  private:
   int max_attempts_ = 0;
@@ -74,6 +80,7 @@ class RetryMethodConfig : public ServiceConfigParser::ParsedConfig {
   float backoff_multiplier_ = 0;
   StatusCodeSet retryable_status_codes_;
   absl::optional<grpc_millis> per_attempt_recv_timeout_;
+  absl::optional<grpc_millis> hedging_delay_;
 };
 
 class RetryServiceConfigParser : public ServiceConfigParser::Parser {
@@ -115,6 +115,15 @@ void ServerRetryThrottleData::RecordSuccess() {
       static_cast<gpr_atm>(throttle_data->max_milli_tokens_));
 }
 
+bool ServerRetryThrottleData::IsThrottled() {
+  // First, check if we are stale and need to be replaced.
+  ServerRetryThrottleData* throttle_data = this;
+  GetReplacementThrottleDataIfNeeded(&throttle_data);
+  return static_cast<intptr_t>(
+             gpr_atm_no_barrier_load(&throttle_data->milli_tokens_)) <=
+         throttle_data->max_milli_tokens_ / 2;
+}
+
 //
 // ServerRetryThrottleMap
 //
@@ -139,6 +139,7 @@ RefCountedPtr<SubchannelCall> SubchannelCall::Create(Args args,
 SubchannelCall::SubchannelCall(Args args, grpc_error_handle* error)
     : connected_subchannel_(std::move(args.connected_subchannel)),
       deadline_(args.deadline) {
+  connected_subchannel_->active_calls_.fetch_add(1, std::memory_order_relaxed);
   grpc_call_stack* callstk = SUBCHANNEL_CALL_TO_CALL_STACK(this);
   const grpc_call_element_args call_args = {
       callstk,             /* call_stack */
@@ -210,6 +211,7 @@ void SubchannelCall::Destroy(void* arg, grpc_error_handle /*error*/) {
   grpc_closure* after_call_stack_destroy = self->after_call_stack_destroy_;
   RefCountedPtr<ConnectedSubchannel> connected_subchannel =
       std::move(self->connected_subchannel_);
+  connected_subchannel->active_calls_.fetch_sub(1, std::memory_order_relaxed);
   // Destroy the subchannel call.
   self->~SubchannelCall();
   // Destroy the call stack. This should be after destroying the subchannel
@@ -694,15 +696,54 @@ Subchannel::~Subchannel() {
 RefCountedPtr<Subchannel> Subchannel::Create(
     OrphanablePtr<SubchannelConnector> connector,
     const grpc_resolved_address& address, const grpc_channel_args* args) {
-  SubchannelKey key(address, args);
   SubchannelPoolInterface* subchannel_pool =
       SubchannelPoolInterface::GetSubchannelPoolFromChannelArgs(args);
   GPR_ASSERT(subchannel_pool != nullptr);
+  // Channels sharing connections may cap the calls on each one, in which
+  // case we use the first connection to the address that has room, or
+  // else make another one.  Connections still being established count as
+  // having room.
+  const int max_streams = grpc_channel_args_find_integer(
+      args, GRPC_ARG_SUBCHANNEL_SHARING_MAX_STREAMS, {0, 0, INT_MAX});
+  const bool sharing = grpc_channel_args_find_string(
+                           args, GRPC_ARG_SUBCHANNEL_SHARING_KEY) != nullptr;
+  if (sharing && max_streams > 0) {
+    for (int shard = 0;; ++shard) {
+      grpc_arg arg = grpc_channel_arg_integer_create(
+          const_cast<char*>(GRPC_ARG_SUBCHANNEL_SHARING_SHARD), shard);
+      grpc_channel_args* shard_args =
+          grpc_channel_args_copy_and_add(args, &arg, 1);
+      SubchannelKey key(address, shard_args);
+      grpc_channel_args_destroy(shard_args);
+      RefCountedPtr<Subchannel> c = subchannel_pool->FindSubchannel(key);
+      if (c == nullptr) {
+        return CreateAndRegister(subchannel_pool, std::move(key),
+                                 std::move(connector), args);
+      }
+      RefCountedPtr<ConnectedSubchannel> connected_subchannel =
+          c->connected_subchannel();
+      if (connected_subchannel == nullptr ||
+          connected_subchannel->active_calls() <
+              static_cast<size_t>(max_streams)) {
+        return c;
+      }
+    }
+  }
+  SubchannelKey key(address, args);
   RefCountedPtr<Subchannel> c = subchannel_pool->FindSubchannel(key);
   if (c != nullptr) {
     return c;
   }
-  c = MakeRefCounted<Subchannel>(std::move(key), std::move(connector), args);
+  return CreateAndRegister(subchannel_pool, std::move(key),
+                           std::move(connector), args);
+}
+
+RefCountedPtr<Subchannel> Subchannel::CreateAndRegister(
+    SubchannelPoolInterface* subchannel_pool, SubchannelKey key,
+    OrphanablePtr<SubchannelConnector> connector,
+    const grpc_channel_args* args) {
+  RefCountedPtr<Subchannel> c =
+      MakeRefCounted<Subchannel>(std::move(key), std::move(connector), args);
   // Try to register the subchannel before setting the subchannel pool.
   // Otherwise, in case of a registration race, unreffing c in
   // RegisterSubchannel() will cause c to be tried to be unregistered, while
@@ -19,6 +19,7 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <atomic>
 #include <deque>
 
 #include "src/core/ext/filters/client_channel/client_channel_channelz.h"
@@ -60,9 +61,17 @@ class ConnectedSubchannel : public RefCounted<ConnectedSubchannel> {
 
   size_t GetInitialCallSizeEstimate() const;
 
+  // The number of SubchannelCalls currently on this connection.
+  size_t active_calls() const {
+    return active_calls_.load(std::memory_order_relaxed);
+  }
+
  private:
+  friend class SubchannelCall;
+
   grpc_channel_stack* channel_stack_;
   grpc_channel_args* args_;
+  std::atomic<size_t> active_calls_{0};
   // ref counted pointer to the channelz node in this connected subchannel's
   // owning subchannel.
   RefCountedPtr<channelz::SubchannelNode> channelz_subchannel_;
@@ -311,6 +320,14 @@ class Subchannel : public DualRefCounted<Subchannel> {
 
   class AsyncWatcherNotifierLocked;
 
+  // Creates a subchannel for \a key and registers it in the pool.  If
+  // another thread registered one for the same key first, returns that one
+  // instead.
+  static RefCountedPtr<Subchannel> CreateAndRegister(
+      SubchannelPoolInterface* subchannel_pool, SubchannelKey key,
+      OrphanablePtr<SubchannelConnector> connector,
+      const grpc_channel_args* args);
+
   // Sets the subchannel's connectivity state to \a state.
   void SetConnectivityStateLocked(grpc_connectivity_state state,
                                   const absl::Status& status)
@@ -20,6 +20,10 @@
 
 #include "src/core/ext/filters/client_channel/subchannel_pool_interface.h"
 
+#include <string.h>
+
+#include "absl/container/inlined_vector.h"
+
 #include "src/core/lib/address_utils/sockaddr_utils.h"
 #include "src/core/lib/gpr/useful.h"
 
@@ -34,6 +38,21 @@ TraceFlag grpc_subchannel_pool_trace(false, "subchannel_pool");
 
 SubchannelKey::SubchannelKey(const grpc_resolved_address& address,
                              const grpc_channel_args* args) {
+  if (grpc_channel_args_find_string(args, GRPC_ARG_SUBCHANNEL_SHARING_KEY) !=
+      nullptr) {
+    // Channels that set a sharing key reuse each other's subchannels
+    // however the rest of their args differ, so drop everything else.
+    absl::InlinedVector<grpc_arg, 2> key_args;
+    for (size_t i = 0; i < args->num_args; ++i) {
+      if (strcmp(args->args[i].key, GRPC_ARG_SUBCHANNEL_SHARING_KEY) == 0 ||
+          strcmp(args->args[i].key, GRPC_ARG_SUBCHANNEL_SHARING_SHARD) == 0) {
+        key_args.push_back(args->args[i]);
+      }
+    }
+    grpc_channel_args sharing_args = {key_args.size(), key_args.data()};
+    Init(address, &sharing_args, grpc_channel_args_normalize);
+    return;
+  }
   Init(address, args, grpc_channel_args_normalize);
 }
 
@@ -27,13 +27,20 @@
 #include "src/core/lib/gprpp/ref_counted.h"
 #include "src/core/lib/iomgr/resolve_address.h"
 
+// Tells apart the connections made to one address for channels sharing
+// connections under GRPC_ARG_SUBCHANNEL_SHARING_KEY.
+#define GRPC_ARG_SUBCHANNEL_SHARING_SHARD \
+  "grpc.internal.subchannel_sharing_shard"
+
 namespace grpc_core {
 
 class Subchannel;
 
 extern TraceFlag grpc_subchannel_pool_trace;
 
-// A key that can uniquely identify a subchannel.
+// A key that can uniquely identify a subchannel.  If the args have
+// GRPC_ARG_SUBCHANNEL_SHARING_KEY, only it and the sharing shard are part
+// of the key.
 class SubchannelKey {
  public:
   SubchannelKey(const grpc_resolved_address& address,
@@ -19,13 +19,16 @@
 #include <grpc/support/port_platform.h>
 
 #include <limits.h>
+#include <math.h>
 
 #include <atomic>
 
+#include "src/core/ext/filters/client_channel/client_channel.h"
 #include "src/core/ext/filters/client_idle/idle_filter_state.h"
 #include "src/core/lib/channel/channel_args.h"
 #include "src/core/lib/channel/channel_stack_builder.h"
 #include "src/core/lib/config/core_configuration.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/timer.h"
 #include "src/core/lib/transport/http2_errors.h"
 
@@ -34,6 +37,10 @@
 #define DEFAULT_IDLE_TIMEOUT_MS INT_MAX
 // The user input idle timeout smaller than this would be capped to it.
 #define MIN_IDLE_TIMEOUT_MS (1 /*second*/ * 1000)
+// Predictive reconnect needs this many idle periods of similar length, and
+// starts reconnecting this long before the next call is expected.
+#define PREDICTIVE_RECONNECT_MIN_IDLE_PERIODS 3
+#define PREDICTIVE_RECONNECT_LEAD_MS (2 /*seconds*/ * 1000)
 
 namespace grpc_core {
 
@@ -77,11 +84,20 @@ class ChannelData {
   static void IdleTimerCallback(void* arg, grpc_error_handle error);
   static void IdleTransportOpCompleteCallback(void* arg,
                                               grpc_error_handle error);
+  static void ReconnectTimerCallback(void* arg, grpc_error_handle error);
 
   void StartIdleTimer();
 
   void EnterIdle();
 
+  // Records how long the channel was idle, when the first call after idle
+  // starts.
+  void RecordIdlePeriodEnd();
+  // Starts the reconnect timer if past idle periods predict when the next
+  // call will come.
+  void MaybeStartReconnectTimerLocked() ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void OnReconnectTimer();
+
   grpc_channel_element* elem_;
   // The channel stack to which we take refs for pending callbacks.
   grpc_channel_stack* channel_stack_;
@@ -99,6 +115,22 @@ class ChannelData {
   // The transport op telling the client channel to enter IDLE.
   grpc_transport_op idle_transport_op_;
   grpc_closure idle_transport_op_complete_callback_;
+
+  // State for predictive reconnect
+  // (GRPC_ARG_CLIENT_IDLE_PREDICTIVE_RECONNECT).
+  const bool predictive_reconnect_;
+  // Whether the channel was sent into IDLE and no call has started since.
+  std::atomic<bool> idle_{false};
+  Mutex mu_;
+  grpc_millis idle_since_ ABSL_GUARDED_BY(mu_) = 0;
+  // Smoothed length of the recent idle periods, and of how far they were
+  // from it.
+  double idle_period_ms_ ABSL_GUARDED_BY(mu_) = 0;
+  double idle_period_deviation_ms_ ABSL_GUARDED_BY(mu_) = 0;
+  int idle_periods_seen_ ABSL_GUARDED_BY(mu_) = 0;
+  bool reconnect_timer_pending_ ABSL_GUARDED_BY(mu_) = false;
+  grpc_timer reconnect_timer_;
+  grpc_closure reconnect_timer_callback_;
 };
 
 grpc_error_handle ChannelData::Init(grpc_channel_element* elem,
@@ -125,6 +157,7 @@ void ChannelData::StartTransportOp(grpc_channel_element* elem,
     // No synchronization issues here. grpc_timer_cancel() is valid as long as
     // the timer has been init()ed before.
     grpc_timer_cancel(&chand->idle_timer_);
+    grpc_timer_cancel(&chand->reconnect_timer_);
   }
   // Pass the op to the next filter.
   grpc_channel_next_op(elem, op);
@@ -132,6 +165,10 @@ void ChannelData::StartTransportOp(grpc_channel_element* elem,
 
 void ChannelData::IncreaseCallCount() {
   idle_filter_state_.IncreaseCallCount();
+  if (predictive_reconnect_ &&
+      idle_.exchange(false, std::memory_order_relaxed)) {
+    RecordIdlePeriodEnd();
+  }
 }
 
 void ChannelData::DecreaseCallCount() {
@@ -146,7 +183,10 @@ ChannelData::ChannelData(grpc_channel_element* elem,
                          grpc_error_handle* /*error*/)
     : elem_(elem),
       channel_stack_(args->channel_stack),
-      client_idle_timeout_(GetClientIdleTimeout(args->channel_args)) {
+      client_idle_timeout_(GetClientIdleTimeout(args->channel_args)),
+      predictive_reconnect_(grpc_channel_args_find_bool(
+          args->channel_args, GRPC_ARG_CLIENT_IDLE_PREDICTIVE_RECONNECT,
+          false)) {
   // If the idle filter is explicitly disabled in channel args, this ctor should
   // not get called.
   GPR_ASSERT(client_idle_timeout_ != GRPC_MILLIS_INF_FUTURE);
@@ -161,6 +201,9 @@ ChannelData::ChannelData(grpc_channel_element* elem,
   GRPC_CLOSURE_INIT(&idle_transport_op_complete_callback_,
                     IdleTransportOpCompleteCallback, this,
                     grpc_schedule_on_exec_ctx);
+  grpc_timer_init_unset(&reconnect_timer_);
+  GRPC_CLOSURE_INIT(&reconnect_timer_callback_, ReconnectTimerCallback, this,
+                    grpc_schedule_on_exec_ctx);
 }
 
 void ChannelData::IdleTimerCallback(void* arg, grpc_error_handle error) {
@@ -206,6 +249,74 @@ void ChannelData::EnterIdle() {
   idle_transport_op_.on_consumed = &idle_transport_op_complete_callback_;
   // Pass the transport op down to the channel stack.
   grpc_channel_next_op(elem_, &idle_transport_op_);
+  if (predictive_reconnect_) {
+    MutexLock lock(&mu_);
+    idle_since_ = ExecCtx::Get()->Now();
+    idle_.store(true, std::memory_order_relaxed);
+    MaybeStartReconnectTimerLocked();
+  }
+}
+
+void ChannelData::RecordIdlePeriodEnd() {
+  MutexLock lock(&mu_);
+  if (reconnect_timer_pending_) grpc_timer_cancel(&reconnect_timer_);
+  const double period = ExecCtx::Get()->Now() - idle_since_;
+  if (idle_periods_seen_ == 0) {
+    idle_period_ms_ = period;
+  } else {
+    idle_period_deviation_ms_ = 0.75 * idle_period_deviation_ms_ +
+                                0.25 * fabs(period - idle_period_ms_);
+    idle_period_ms_ = 0.75 * idle_period_ms_ + 0.25 * period;
+  }
+  ++idle_periods_seen_;
+  GRPC_IDLE_FILTER_LOG("idle for %.0f ms, %.0f ms on average (+/- %.0f ms)",
+                       period, idle_period_ms_, idle_period_deviation_ms_);
+}
+
+void ChannelData::MaybeStartReconnectTimerLocked() {
+  // Only trust a pattern of idle periods of about the same length.
+  if (reconnect_timer_pending_ ||
+      idle_periods_seen_ < PREDICTIVE_RECONNECT_MIN_IDLE_PERIODS ||
+      idle_period_deviation_ms_ > idle_period_ms_ / 4) {
+    return;
+  }
+  const grpc_millis deadline =
+      idle_since_ +
+      static_cast<grpc_millis>(idle_period_ms_ - idle_period_deviation_ms_) -
+      PREDICTIVE_RECONNECT_LEAD_MS;
+  // Idle periods this short are not worth dropping the connections for.
+  if (deadline <= idle_since_) return;
+  GRPC_IDLE_FILTER_LOG("reconnect timer set for %" PRId64 " ms",
+                       deadline - idle_since_);
+  reconnect_timer_pending_ = true;
+  // Hold a ref to the channel stack for the timer callback.
+  GRPC_CHANNEL_STACK_REF(channel_stack_, "reconnect timer callback");
+  grpc_timer_init(&reconnect_timer_, deadline, &reconnect_timer_callback_);
+}
+
+void ChannelData::ReconnectTimerCallback(void* arg, grpc_error_handle error) {
+  ChannelData* chand = static_cast<ChannelData*>(arg);
+  {
+    MutexLock lock(&chand->mu_);
+    chand->reconnect_timer_pending_ = false;
+  }
+  if (error == GRPC_ERROR_NONE) chand->OnReconnectTimer();
+  GRPC_CHANNEL_STACK_UNREF(chand->channel_stack_, "reconnect timer callback");
+}
+
+void ChannelData::OnReconnectTimer() {
+  // Nothing to do if a call already woke the channel up.
+  if (!idle_.exchange(false, std::memory_order_relaxed)) return;
+  GRPC_IDLE_FILTER_LOG("reconnecting ahead of the expected next call");
+  ClientChannel* client_channel =
+      ClientChannel::GetFromChannelStack(channel_stack_);
+  if (client_channel != nullptr) {
+    client_channel->CheckConnectivityState(/*try_to_connect=*/true);
+  }
+  // A phony call starts the idle timer, so that the channel goes back to
+  // IDLE if the call does not come after all.
+  IncreaseCallCount();
+  DecreaseCallCount();
 }
 
 class CallData {
@@ -0,0 +1,581 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/ext/filters/concurrency_limit/concurrency_limit_filter.h"
+
+#include <math.h>
+
+#include <algorithm>
+#include <list>
+
+#include "absl/container/inlined_vector.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+
+#include <grpc/status.h>
+#include <grpc/support/log.h>
+
+#include "src/core/ext/filters/client_channel/client_channel.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/debug/stats.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/json/json_util.h"
+#include "src/core/lib/service_config/service_config.h"
+#include "src/core/lib/transport/error_utils.h"
+#include "src/core/lib/transport/metadata_batch.h"
+
+namespace grpc_core {
+
+TraceFlag grpc_concurrency_limit_trace(false, "concurrency_limit");
+
+namespace {
+
+size_t g_concurrency_limit_parser_index;
+
+// Statuses that say the backend is overloaded (or too slow to answer before
+// the deadline), rather than that the call itself failed.
+bool IsOverloadStatus(grpc_status_code status) {
+  return status == GRPC_STATUS_RESOURCE_EXHAUSTED ||
+         status == GRPC_STATUS_UNAVAILABLE ||
+         status == GRPC_STATUS_DEADLINE_EXCEEDED;
+}
+
+// Like ParseJsonObjectField(), for the fractional fields that it does not
+// handle.
+bool ParseJsonObjectFieldAsDouble(const Json::Object& object,
+                                  absl::string_view field_name, double* output,
+                                  std::vector<grpc_error_handle>* error_list) {
+  auto it = object.find(std::string(field_name));
+  if (it == object.end()) return false;
+  if (it->second.type() != Json::Type::NUMBER ||
+      !absl::SimpleAtod(it->second.string_value(), output)) {
+    error_list->push_back(GRPC_ERROR_CREATE_FROM_CPP_STRING(
+        absl::StrCat("field:", field_name, " error:type should be NUMBER")));
+    return false;
+  }
+  return true;
+}
+
+class CallData;
+
+class ChannelData {
+ public:
+  enum class Admission { kAdmitted, kQueued, kRejected };
+
+  static grpc_error_handle Init(grpc_channel_element* elem,
+                                grpc_channel_element_args* args);
+  static void Destroy(grpc_channel_element* elem);
+
+  // False if there was no config when the channel stack was built, in which
+  // case calls are passed through.
+  bool enabled() const { return enabled_; }
+
+  // Takes a slot for the call, or else queues it until one frees up.
+  Admission Admit(CallData* calld);
+  // Takes a queued call off the queue.  Returns false if it already left.
+  bool Dequeue(CallData* calld);
+  // Gives back a call's slot.  rtt_ns is set if the call finished in a way
+  // that tells something about the backend's latency.
+  void Release(absl::optional<double> rtt_ns, bool overloaded);
+
+ private:
+  ChannelData(grpc_channel_element* elem, grpc_channel_element_args* args);
+  ~ChannelData();
+
+  void UpdateLimitLocked(double rtt_ns, bool overloaded)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  void SetLimitLocked(double limit) ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  bool enabled_ = false;
+  ConcurrencyLimitGlobalConfig::Config config_;
+
+  Mutex mu_;
+  double limit_ ABSL_GUARDED_BY(mu_) = 0;
+  // The integer limit last added to the client_concurrency_limit counter.
+  int reported_limit_ ABSL_GUARDED_BY(mu_) = 0;
+  uint32_t in_flight_ ABSL_GUARDED_BY(mu_) = 0;
+  std::list<CallData*> queue_ ABSL_GUARDED_BY(mu_);
+  // kGradient: average RTT over roughly the last long_window calls.
+  double long_rtt_ns_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
+class CallData {
+ public:
+  static grpc_error_handle Init(grpc_call_element* elem,
+                                const grpc_call_element_args* args);
+  static void Destroy(grpc_call_element* elem,
+                      const grpc_call_final_info* /*final_info*/,
+                      grpc_closure* /*then_schedule_closure*/);
+
+  static void StartTransportStreamOpBatch(
+      grpc_call_element* elem, grpc_transport_stream_op_batch* batch);
+
+ private:
+  friend class ChannelData;
+  class QueuedCallCanceller;
+
+  CallData(grpc_call_element* elem, const grpc_call_element_args* args);
+  ~CallData();
+
+  // Records that the call now holds a slot.
+  void TakeSlot() {
+    holds_slot_ = true;
+    start_time_ = gpr_get_cycle_counter();
+  }
+
+  // Passes the queued batch down once the call got a slot.
+  void Resume();
+  static void ResumeBatch(void* arg, grpc_error_handle error);
+
+  static void RecvTrailingMetadataReady(void* arg, grpc_error_handle error);
+
+  grpc_call_element* elem_;
+  grpc_call_stack* owning_call_;
+  CallCombiner* call_combiner_;
+  grpc_millis deadline_;
+
+  bool holds_slot_ = false;
+  gpr_cycle_counter start_time_;
+  // Set if the call was rejected; later batches fail with it.
+  grpc_error_handle rejected_error_ = GRPC_ERROR_NONE;
+
+  // The send_initial_metadata batch, which is held (along with the call
+  // combiner) while the call is queued.  queued_ and queue_position_ are
+  // guarded by the ChannelData's mu_.
+  grpc_transport_stream_op_batch* queued_batch_ = nullptr;
+  bool queued_ = false;
+  std::list<CallData*>::iterator queue_position_;
+  grpc_closure resume_closure_;
+
+  grpc_metadata_batch* recv_trailing_metadata_ = nullptr;
+  grpc_closure recv_trailing_metadata_ready_;
+  grpc_closure* original_recv_trailing_metadata_ready_ = nullptr;
+};
+
+// CallData::QueuedCallCanceller
+
+class CallData::QueuedCallCanceller {
+ public:
+  explicit QueuedCallCanceller(CallData* calld) : calld_(calld) {
+    GRPC_CALL_STACK_REF(calld->owning_call_, "QueuedCallCanceller");
+    GRPC_CLOSURE_INIT(&closure_, &Cancel, this, grpc_schedule_on_exec_ctx);
+    calld->call_combiner_->SetNotifyOnCancel(&closure_);
+  }
+
+ private:
+  static void Cancel(void* arg, grpc_error_handle error) {
+    auto* self = static_cast<QueuedCallCanceller*>(arg);
+    CallData* calld = self->calld_;
+    auto* chand = static_cast<ChannelData*>(calld->elem_->channel_data);
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_concurrency_limit_trace)) {
+      gpr_log(GPR_INFO, "chand=%p calld=%p: cancelling queued call: error=%s",
+              chand, calld, grpc_error_std_string(error).c_str());
+    }
+    if (error != GRPC_ERROR_NONE && chand->Dequeue(calld)) {
+      // Note: This will release the call combiner.
+      grpc_transport_stream_op_batch_finish_with_failure(
+          calld->queued_batch_, GRPC_ERROR_REF(error), calld->call_combiner_);
+    }
+    GRPC_CALL_STACK_UNREF(calld->owning_call_, "QueuedCallCanceller");
+    delete self;
+  }
+
+  CallData* calld_;
+  grpc_closure closure_;
+};
+
+// ChannelData
+
+grpc_error_handle ChannelData::Init(grpc_channel_element* elem,
+                                    grpc_channel_element_args* args) {
+  GPR_ASSERT(elem->filter == &kConcurrencyLimitFilterVtable);
+  new (elem->channel_data) ChannelData(elem, args);
+  return GRPC_ERROR_NONE;
+}
+
+void ChannelData::Destroy(grpc_channel_element* elem) {
+  auto* chand = static_cast<ChannelData*>(elem->channel_data);
+  chand->~ChannelData();
+}
+
+ChannelData::ChannelData(grpc_channel_element* /*elem*/,
+                         grpc_channel_element_args* args) {
+  auto* service_config = grpc_channel_args_find_pointer<ServiceConfig>(
+      args->channel_args, GRPC_ARG_SERVICE_CONFIG_OBJ);
+  if (service_config == nullptr) return;
+  const auto* config = static_cast<const ConcurrencyLimitGlobalConfig*>(
+      service_config->GetGlobalParsedConfig(
+          ConcurrencyLimitServiceConfigParser::ParserIndex()));
+  if (config == nullptr) return;
+  enabled_ = true;
+  config_ = config->config();
+  MutexLock lock(&mu_);
+  SetLimitLocked(config_.initial_limit);
+}
+
+ChannelData::~ChannelData() {
+  MutexLock lock(&mu_);
+  GPR_ASSERT(queue_.empty());
+  GRPC_STATS_INC_CLIENT_CONCURRENCY_LIMIT(-reported_limit_);
+}
+
+ChannelData::Admission ChannelData::Admit(CallData* calld) {
+  MutexLock lock(&mu_);
+  if (in_flight_ < static_cast<uint32_t>(limit_)) {
+    ++in_flight_;
+    return Admission::kAdmitted;
+  }
+  if (queue_.size() >= config_.max_queue_size) return Admission::kRejected;
+  calld->queued_ = true;
+  calld->queue_position_ = queue_.insert(queue_.end(), calld);
+  // Watch for cancellation before the call can be resumed by another one.
+  new CallData::QueuedCallCanceller(calld);
+  return Admission::kQueued;
+}
+
+bool ChannelData::Dequeue(CallData* calld) {
+  MutexLock lock(&mu_);
+  if (!calld->queued_) return false;
+  calld->queued_ = false;
+  queue_.erase(calld->queue_position_);
+  return true;
+}
+
+void ChannelData::Release(absl::optional<double> rtt_ns, bool overloaded) {
+  absl::InlinedVector<CallData*, 1> resumed;
+  {
+    MutexLock lock(&mu_);
+    if (rtt_ns.has_value()) UpdateLimitLocked(*rtt_ns, overloaded);
+    --in_flight_;
+    while (!queue_.empty() && in_flight_ < static_cast<uint32_t>(limit_)) {
+      CallData* calld = queue_.front();
+      queue_.pop_front();
+      calld->queued_ = false;
+      ++in_flight_;
+      resumed.push_back(calld);
+    }
+  }
+  for (CallData* calld : resumed) calld->Resume();
+}
+
+void ChannelData::UpdateLimitLocked(double rtt_ns, bool overloaded) {
+  double limit = limit_;
+  switch (config_.algorithm) {
+    case ConcurrencyLimitGlobalConfig::Algorithm::kGradient: {
+      if (long_rtt_ns_ == 0) {
+        long_rtt_ns_ = rtt_ns;
+      } else {
+        long_rtt_ns_ += (rtt_ns - long_rtt_ns_) / config_.long_window;
+      }
+      // After a latency spike, let the long-term RTT come down faster, so
+      // that the limit can recover.
+      if (long_rtt_ns_ > 2 * rtt_ns) long_rtt_ns_ *= 0.95;
+      // With little load in flight, latency says nothing about the limit.
+      if (!overloaded && in_flight_ * 2 < limit) return;
+      // An overloaded status counts as the steepest gradient.
+      const double gradient =
+          overloaded ? 0.5
+                     : std::max(0.5, std::min(1.0, config_.rtt_tolerance *
+                                                       long_rtt_ns_ /
+                                                       std::max(rtt_ns, 1.0)));
+      const double new_limit = limit * gradient + sqrt(limit);
+      limit = limit * (1 - config_.smoothing) + new_limit * config_.smoothing;
+      break;
+    }
+    case ConcurrencyLimitGlobalConfig::Algorithm::kAimd:
+      if (overloaded ||
+          (config_.latency_threshold > 0 &&
+           rtt_ns > static_cast<double>(config_.latency_threshold) *
+                        GPR_NS_PER_MS)) {
+        limit *= config_.backoff_ratio;
+      } else if (in_flight_ * 2 >= limit) {
+        limit += 1;
+      } else {
+        return;
+      }
+      break;
+  }
+  SetLimitLocked(limit);
+}
+
+void ChannelData::SetLimitLocked(double limit) {
+  limit_ = std::max<double>(config_.min_limit,
+                            std::min<double>(config_.max_limit, limit));
+  const int reported_limit = static_cast<int>(limit_);
+  if (reported_limit == reported_limit_) return;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_concurrency_limit_trace)) {
+    gpr_log(GPR_INFO, "chand=%p: concurrency limit %d -> %d (in flight %u)",
+            this, reported_limit_, reported_limit, in_flight_);
+  }
+  GRPC_STATS_INC_CLIENT_CONCURRENCY_LIMIT(reported_limit - reported_limit_);
+  reported_limit_ = reported_limit;
+}
+
+// CallData
+
+grpc_error_handle CallData::Init(grpc_call_element* elem,
+                                 const grpc_call_element_args* args) {
+  new (elem->call_data) CallData(elem, args);
+  return GRPC_ERROR_NONE;
+}
+
+void CallData::Destroy(grpc_call_element* elem,
+                       const grpc_call_final_info* /*final_info*/,
+                       grpc_closure* /*then_schedule_closure*/) {
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  calld->~CallData();
+}
+
+void CallData::StartTransportStreamOpBatch(
+    grpc_call_element* elem, grpc_transport_stream_op_batch* batch) {
+  auto* chand = static_cast<ChannelData*>(elem->channel_data);
+  auto* calld = static_cast<CallData*>(elem->call_data);
+  if (!chand->enabled()) {
+    grpc_call_next_op(elem, batch);
+    return;
+  }
+  // If the call was rejected, fail everything that follows.
+  if (calld->rejected_error_ != GRPC_ERROR_NONE) {
+    grpc_transport_stream_op_batch_finish_with_failure(
+        batch, GRPC_ERROR_REF(calld->rejected_error_), calld->call_combiner_);
+    return;
+  }
+  // Intercept recv_trailing_metadata to give back the slot and take a
+  // latency sample.
+  if (batch->recv_trailing_metadata) {
+    calld->recv_trailing_metadata_ =
+        batch->payload->recv_trailing_metadata.recv_trailing_metadata;
+    calld->original_recv_trailing_metadata_ready_ =
+        batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready;
+    batch->payload->recv_trailing_metadata.recv_trailing_metadata_ready =
+        &calld->recv_trailing_metadata_ready_;
+  }
+  if (batch->send_initial_metadata) {
+    calld->queued_batch_ = batch;
+    switch (chand->Admit(calld)) {
+      case ChannelData::Admission::kAdmitted:
+        calld->TakeSlot();
+        break;
+      case ChannelData::Admission::kQueued:
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_concurrency_limit_trace)) {
+          gpr_log(GPR_INFO, "chand=%p calld=%p: queueing call", chand, calld);
+        }
+        GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_QUEUED();
+        // The batch is passed down when another call gives back its slot.
+        return;
+      case ChannelData::Admission::kRejected:
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_concurrency_limit_trace)) {
+          gpr_log(GPR_INFO, "chand=%p calld=%p: rejecting call", chand,
+                  calld);
+        }
+        GRPC_STATS_INC_CLIENT_CALLS_CONCURRENCY_REJECTED();
+        calld->rejected_error_ = grpc_error_set_int(
+            GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+                "adaptive concurrency limit reached"),
+            GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_RESOURCE_EXHAUSTED);
+        grpc_transport_stream_op_batch_finish_with_failure(
+            batch, GRPC_ERROR_REF(calld->rejected_error_),
+            calld->call_combiner_);
+        return;
+    }
+  }
+  // Chain to the next filter.
+  grpc_call_next_op(elem, batch);
+}
+
+CallData::CallData(grpc_call_element* elem, const grpc_call_element_args* args)
+    : elem_(elem),
+      owning_call_(args->call_stack),
+      call_combiner_(args->call_combiner),
+      deadline_(args->deadline) {
+  GRPC_CLOSURE_INIT(&recv_trailing_metadata_ready_, RecvTrailingMetadataReady,
+                    this, grpc_schedule_on_exec_ctx);
+}
+
+CallData::~CallData() {
+  // The call ended without recv_trailing_metadata.
+  if (holds_slot_) {
+    static_cast<ChannelData*>(elem_->channel_data)
+        ->Release(absl::nullopt, false);
+  }
+  GRPC_ERROR_UNREF(rejected_error_);
+}
+
+void CallData::Resume() {
+  GRPC_CLOSURE_INIT(&resume_closure_, ResumeBatch, this, nullptr);
+  ExecCtx::Run(DEBUG_LOCATION, &resume_closure_, GRPC_ERROR_NONE);
+}
+
+void CallData::ResumeBatch(void* arg, grpc_error_handle /*error*/) {
+  auto* calld = static_cast<CallData*>(arg);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_concurrency_limit_trace)) {
+    gpr_log(GPR_INFO, "chand=%p calld=%p: resuming queued call",
+            calld->elem_->channel_data, calld);
+  }
+  calld->TakeSlot();
+  // Chain to the next filter.
+  grpc_call_next_op(calld->elem_, calld->queued_batch_);
+}
+
+void CallData::RecvTrailingMetadataReady(void* arg, grpc_error_handle error) {
+  auto* calld = static_cast<CallData*>(arg);
+  if (calld->holds_slot_) {
+    calld->holds_slot_ = false;
+    grpc_status_code status;
+    if (error != GRPC_ERROR_NONE) {
+      grpc_error_get_status(error, calld->deadline_, &status, nullptr, nullptr,
+                            nullptr);
+    } else {
+      status = calld->recv_trailing_metadata_->get(GrpcStatusMetadata())
+                   .value_or(GRPC_STATUS_UNKNOWN);
+    }
+    // A cancelled call says nothing about the backend.
+    absl::optional<double> rtt_ns;
+    if (status != GRPC_STATUS_CANCELLED) {
+      gpr_timespec elapsed =
+          gpr_cycle_counter_sub(gpr_get_cycle_counter(), calld->start_time_);
+      rtt_ns = static_cast<double>(elapsed.tv_sec) * GPR_NS_PER_SEC +
+               elapsed.tv_nsec;
+    }
+    static_cast<ChannelData*>(calld->elem_->channel_data)
+        ->Release(rtt_ns, IsOverloadStatus(status));
+  }
+  Closure::Run(DEBUG_LOCATION, calld->original_recv_trailing_metadata_ready_,
+               GRPC_ERROR_REF(error));
+}
+
+}  // namespace
+
+//
+// ConcurrencyLimitServiceConfigParser
+//
+
+std::unique_ptr<ServiceConfigParser::ParsedConfig>
+ConcurrencyLimitServiceConfigParser::ParseGlobalParams(
+    const grpc_channel_args* /*args*/, const Json& json,
+    grpc_error_handle* error) {
+  GPR_DEBUG_ASSERT(error != nullptr && *error == GRPC_ERROR_NONE);
+  auto it = json.object_value().find("adaptiveConcurrency");
+  if (it == json.object_value().end()) return nullptr;
+  if (it->second.type() != Json::Type::OBJECT) {
+    *error = GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:adaptiveConcurrency error:type should be OBJECT");
+    return nullptr;
+  }
+  const Json::Object& object = it->second.object_value();
+  std::vector<grpc_error_handle> error_list;
+  ConcurrencyLimitGlobalConfig::Config config;
+  ParseJsonObjectField(object, "initialLimit", &config.initial_limit,
+                       &error_list, /*required=*/false);
+  ParseJsonObjectField(object, "minLimit", &config.min_limit, &error_list,
+                       /*required=*/false);
+  ParseJsonObjectField(object, "maxLimit", &config.max_limit, &error_list,
+                       /*required=*/false);
+  ParseJsonObjectField(object, "maxQueueSize", &config.max_queue_size,
+                       &error_list, /*required=*/false);
+  if (config.min_limit == 0) {
+    error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:minLimit error:must be greater than 0"));
+  } else if (config.max_limit < config.min_limit) {
+    error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:maxLimit error:must not be less than minLimit"));
+  } else if (config.initial_limit < config.min_limit ||
+             config.initial_limit > config.max_limit) {
+    error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:initialLimit error:must be between minLimit and maxLimit"));
+  }
+  const Json::Object* gradient = nullptr;
+  const Json::Object* aimd = nullptr;
+  ParseJsonObjectField(object, "gradient", &gradient, &error_list,
+                       /*required=*/false);
+  ParseJsonObjectField(object, "aimd", &aimd, &error_list,
+                       /*required=*/false);
+  if (gradient != nullptr && aimd != nullptr) {
+    error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+        "field:aimd error:cannot be combined with gradient"));
+  } else if (aimd != nullptr) {
+    config.algorithm = ConcurrencyLimitGlobalConfig::Algorithm::kAimd;
+    if (ParseJsonObjectFieldAsDouble(*aimd, "backoffRatio",
+                                     &config.backoff_ratio, &error_list) &&
+        (config.backoff_ratio <= 0 || config.backoff_ratio >= 1)) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:backoffRatio error:must be between 0 and 1"));
+    }
+    ParseJsonObjectFieldAsDuration(*aimd, "latencyThreshold",
+                                   &config.latency_threshold, &error_list,
+                                   /*required=*/false);
+  } else if (gradient != nullptr) {
+    if (ParseJsonObjectFieldAsDouble(*gradient, "smoothing", &config.smoothing,
+                                     &error_list) &&
+        (config.smoothing <= 0 || config.smoothing > 1)) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:smoothing error:must be greater than 0 and at most 1"));
+    }
+    if (ParseJsonObjectFieldAsDouble(*gradient, "rttTolerance",
+                                     &config.rtt_tolerance, &error_list) &&
+        config.rtt_tolerance < 1) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:rttTolerance error:must be at least 1"));
+    }
+    if (ParseJsonObjectField(*gradient, "longWindow", &config.long_window,
+                             &error_list, /*required=*/false) &&
+        config.long_window == 0) {
+      error_list.push_back(GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+          "field:longWindow error:must be greater than 0"));
+    }
+  }
+  if (!error_list.empty()) {
+    *error = GRPC_ERROR_CREATE_FROM_VECTOR("field:adaptiveConcurrency",
+                                           &error_list);
+    return nullptr;
+  }
+  return absl::make_unique<ConcurrencyLimitGlobalConfig>(config);
+}
+
+size_t ConcurrencyLimitServiceConfigParser::ParserIndex() {
+  return g_concurrency_limit_parser_index;
+}
+
+void ConcurrencyLimitServiceConfigParser::Register() {
+  g_concurrency_limit_parser_index = ServiceConfigParser::RegisterParser(
+      absl::make_unique<ConcurrencyLimitServiceConfigParser>());
+}
+
+extern const grpc_channel_filter kConcurrencyLimitFilterVtable = {
+    CallData::StartTransportStreamOpBatch,
+    grpc_channel_next_op,
+    sizeof(CallData),
+    CallData::Init,
+    grpc_call_stack_ignore_set_pollset_or_pollset_set,
+    CallData::Destroy,
+    sizeof(ChannelData),
+    ChannelData::Init,
+    ChannelData::Destroy,
+    grpc_channel_next_get_info,
+    "concurrency_limit_filter",
+};
+
+void ConcurrencyLimitFilterInit(void) {
+  ConcurrencyLimitServiceConfigParser::Register();
+}
+
+void ConcurrencyLimitFilterShutdown(void) {}
+
+}  // namespace grpc_core
@@ -0,0 +1,97 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_EXT_FILTERS_CONCURRENCY_LIMIT_CONCURRENCY_LIMIT_FILTER_H
+#define GRPC_CORE_EXT_FILTERS_CONCURRENCY_LIMIT_CONCURRENCY_LIMIT_FILTER_H
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/channel/channel_stack.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/service_config/service_config_parser.h"
+
+namespace grpc_core {
+
+// Parsed form of the "adaptiveConcurrency" field of the service config:
+//
+//   "adaptiveConcurrency": {
+//     "initialLimit": 20, "minLimit": 1, "maxLimit": 1000,
+//     "maxQueueSize": 0,
+//     // At most one of:
+//     "gradient": {"smoothing": 0.2, "rttTolerance": 1.5, "longWindow": 600},
+//     "aimd": {"backoffRatio": 0.9, "latencyThreshold": "1s"}
+//   }
+class ConcurrencyLimitGlobalConfig : public ServiceConfigParser::ParsedConfig {
+ public:
+  enum class Algorithm {
+    // Scales the limit by how far the latency of recent calls is above
+    // the long-term latency, as in Netflix's Gradient2 limit.
+    kGradient,
+    // Grows the limit by one per successful call and shrinks it by
+    // backoff_ratio on each overloaded or slow call.
+    kAimd,
+  };
+
+  struct Config {
+    Algorithm algorithm = Algorithm::kGradient;
+    uint32_t initial_limit = 20;
+    uint32_t min_limit = 1;
+    uint32_t max_limit = 1000;
+    // Calls beyond the limit wait for a slot, up to this many. 0 fails them
+    // right away with RESOURCE_EXHAUSTED.
+    uint32_t max_queue_size = 0;
+    // kGradient
+    double smoothing = 0.2;
+    double rtt_tolerance = 1.5;
+    uint32_t long_window = 600;
+    // kAimd
+    double backoff_ratio = 0.9;
+    // Calls slower than this count as overloaded. 0 means only the status
+    // is looked at.
+    grpc_millis latency_threshold = 0;
+  };
+
+  explicit ConcurrencyLimitGlobalConfig(const Config& config)
+      : config_(config) {}
+
+  const Config& config() const { return config_; }
+
+ private:
+  Config config_;
+};
+
+class ConcurrencyLimitServiceConfigParser
+    : public ServiceConfigParser::Parser {
+ public:
+  std::unique_ptr<ServiceConfigParser::ParsedConfig> ParseGlobalParams(
+      const grpc_channel_args* /*args*/, const Json& json,
+      grpc_error_handle* error) override;
+  // Returns the parser index for ConcurrencyLimitServiceConfigParser.
+  static size_t ParserIndex();
+  // Registers ConcurrencyLimitServiceConfigParser to ServiceConfigParser.
+  static void Register();
+};
+
+// Dynamic filter that limits the calls in flight on a channel to a limit
+// adapted from their latency and status.  The client channel adds it above
+// the retry filter when the service config has an "adaptiveConcurrency"
+// field, so a call holds one slot for all of its attempts.  The limit
+// starts over from initialLimit when the service config changes.
+extern const grpc_channel_filter kConcurrencyLimitFilterVtable;
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_FILTERS_CONCURRENCY_LIMIT_CONCURRENCY_LIMIT_FILTER_H
@@ -21,6 +21,7 @@
 #include "src/core/ext/filters/http/message_compress/message_compress_filter.h"
 
 #include <assert.h>
+#include <limits.h>
 #include <string.h>
 
 #include "absl/types/optional.h"
@@ -65,6 +66,9 @@ class ChannelData {
               name);
       default_compression_algorithm_ = GRPC_COMPRESS_NONE;
     }
+    min_message_size_to_compress_ = grpc_channel_args_find_integer(
+        args->channel_args, GRPC_COMPRESSION_CHANNEL_MIN_MESSAGE_SIZE,
+        {0, 0, INT_MAX});
     GPR_ASSERT(!args->is_last);
   }
 
@@ -76,11 +80,17 @@ class ChannelData {
     return enabled_compression_algorithms_;
   }
 
+  uint32_t min_message_size_to_compress() const {
+    return min_message_size_to_compress_;
+  }
+
  private:
   /** The default, channel-level, compression algorithm */
   grpc_compression_algorithm default_compression_algorithm_;
   /** Enabled compression algorithms */
   grpc_core::CompressionAlgorithmSet enabled_compression_algorithms_;
+  /** Messages smaller than this are not compressed */
+  uint32_t min_message_size_to_compress_;
 };
 
 class CallData {
@@ -88,6 +98,7 @@ class CallData {
   CallData(grpc_call_element* elem, const grpc_call_element_args& args)
       : call_combiner_(args.call_combiner) {
     ChannelData* channeld = static_cast<ChannelData*>(elem->channel_data);
+    min_message_size_to_compress_ = channeld->min_message_size_to_compress();
     // The call's message compression algorithm is set to channel's default
     // setting. It can be overridden later by initial metadata.
     if (GPR_LIKELY(channeld->enabled_compression_algorithms().IsSet(
@@ -129,6 +140,7 @@ class CallData {
 
   grpc_core::CallCombiner* call_combiner_;
   grpc_compression_algorithm compression_algorithm_ = GRPC_COMPRESS_NONE;
+  uint32_t min_message_size_to_compress_;
   grpc_error_handle cancel_error_ = GRPC_ERROR_NONE;
   grpc_transport_stream_op_batch* send_message_batch_ = nullptr;
   bool seen_initial_metadata_ = false;
@@ -139,6 +151,8 @@ class CallData {
    * Keep them at the bottom of the struct, so they don't pollute the
    * cache-lines. */
   grpc_slice_buffer slices_; /**< Buffers up input slices to be compressed */
+  /** Reused by all the messages of the call */
+  grpc_core::MessageCompressionContext compression_context_;
   // Allocate space for the replacement stream
   std::aligned_storage<sizeof(grpc_core::SliceBufferByteStream),
                        alignof(grpc_core::SliceBufferByteStream)>::type
@@ -157,6 +171,11 @@ bool CallData::SkipMessageCompression() {
   if (flags & (GRPC_WRITE_NO_COMPRESS | GRPC_WRITE_INTERNAL_COMPRESS)) {
     return true;
   }
+  // Small messages aren't worth compressing.
+  if (send_message_batch_->payload->send_message.send_message->length() <
+      min_message_size_to_compress_) {
+    return true;
+  }
   // If this call doesn't have any message compression algorithm set, skip
   // message compression.
   return compression_algorithm_ == GRPC_COMPRESS_NONE;
@@ -219,7 +238,8 @@ void CallData::FinishSendMessage(grpc_call_element* elem) {
   grpc_slice_buffer_init(&tmp);
   uint32_t send_flags =
       send_message_batch_->payload->send_message.send_message->flags();
-  bool did_compress = grpc_msg_compress(compression_algorithm_, &slices_, &tmp);
+  bool did_compress =
+      compression_context_.Compress(compression_algorithm_, &slices_, &tmp);
   if (did_compress) {
     if (GRPC_TRACE_FLAG_ENABLED(grpc_compression_trace)) {
       const char* algo_name;
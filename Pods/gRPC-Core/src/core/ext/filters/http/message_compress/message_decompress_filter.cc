@@ -121,6 +121,8 @@ class CallData {
   // It is initialized during construction and reset when a new stream is
   // created using it.
   grpc_slice_buffer recv_slices_;
+  // Reused by all the messages of the call
+  MessageCompressionContext decompression_context_;
   std::aligned_storage<sizeof(SliceBufferByteStream),
                        alignof(SliceBufferByteStream)>::type
       recv_replacement_stream_;
@@ -237,8 +239,8 @@ void CallData::OnRecvMessageNextDone(void* arg, grpc_error_handle error) {
 void CallData::FinishRecvMessage() {
   grpc_slice_buffer decompressed_slices;
   grpc_slice_buffer_init(&decompressed_slices);
-  if (grpc_msg_decompress(algorithm_, &recv_slices_, &decompressed_slices) ==
-      0) {
+  if (decompression_context_.Decompress(algorithm_, &recv_slices_,
+                                       &decompressed_slices) == 0) {
     GPR_DEBUG_ASSERT(error_ == GRPC_ERROR_NONE);
     error_ = GRPC_ERROR_CREATE_FROM_CPP_STRING(
         absl::StrCat("Unexpected error decompressing data for algorithm with "
@@ -24,6 +24,7 @@
 #include <stdio.h>
 #include <string.h>
 
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_format.h"
 
 #include <grpc/slice_buffer.h>
@@ -105,6 +106,9 @@ static void write_action_begin_locked(void* t, grpc_error_handle error);
 static void write_action(void* t, grpc_error_handle error);
 static void write_action_end(void* t, grpc_error_handle error);
 static void write_action_end_locked(void* t, grpc_error_handle error);
+static void write_coalescing_timer_expired(void* t, grpc_error_handle error);
+static void write_coalescing_timer_expired_locked(void* t,
+                                                  grpc_error_handle error);
 
 static void read_action(void* t, grpc_error_handle error);
 static void read_action_locked(void* t, grpc_error_handle error);
@@ -226,6 +230,10 @@ grpc_chttp2_transport::~grpc_chttp2_transport() {
 
   grpc_chttp2_stream_map_destroy(&stream_map);
 
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_combiner_stats_trace)) {
+    gpr_log(GPR_INFO, "%s:%p combiner: %s", is_client ? "CLIENT" : "SERVER",
+            this, combiner->StatsString().c_str());
+  }
   GRPC_COMBINER_UNREF(combiner, "chttp2_transport");
 
   cancel_pings(this,
@@ -302,6 +310,11 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                            GRPC_ARG_HTTP2_WRITE_BUFFER_SIZE)) {
       t->write_buffer_size = static_cast<uint32_t>(grpc_channel_arg_get_integer(
           &channel_args->args[i], {0, 0, MAX_WRITE_BUFFER_SIZE}));
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_WRITE_COALESCING_WINDOW_US)) {
+      const int value = grpc_channel_arg_get_integer(
+          &channel_args->args[i], {0, 0, GPR_US_PER_SEC});
+      t->write_coalescing_window = (value + GPR_US_PER_MS - 1) / GPR_US_PER_MS;
     } else if (0 ==
                strcmp(channel_args->args[i].key, GRPC_ARG_HTTP2_BDP_PROBE)) {
       enable_bdp = grpc_channel_arg_get_bool(&channel_args->args[i], true);
@@ -334,6 +347,10 @@ static bool read_channel_args(grpc_chttp2_transport* t,
                strcmp(channel_args->args[i].key, GRPC_ARG_ENABLE_CHANNELZ)) {
       channelz_enabled = grpc_channel_arg_get_bool(
           &channel_args->args[i], GRPC_ENABLE_CHANNELZ_DEFAULT);
+    } else if (0 == strcmp(channel_args->args[i].key,
+                           GRPC_ARG_HTTP2_COMBINER_AFFINITY)) {
+      t->combiner->affinity =
+          grpc_channel_arg_get_bool(&channel_args->args[i], false);
     } else {
       static const struct {
         const char* channel_arg_name;
@@ -424,6 +441,21 @@ static void configure_transport_ping_policy(grpc_chttp2_transport* t) {
       g_default_min_recv_ping_interval_without_data_ms;
 }
 
+// Keepalive deadlines are rounded up to a process-wide grid, so that the
+// timers of transports sharing a keepalive time expire together in one timer
+// wakeup instead of spreading across the period. This delays a ping by at most
+// an eighth of the keepalive time, and never more than
+// kMaxKeepaliveAlignmentMs.
+static grpc_millis keepalive_deadline(grpc_chttp2_transport* t,
+                                      grpc_millis from) {
+  constexpr grpc_millis kMaxKeepaliveAlignmentMs = 10 * GPR_MS_PER_SEC;
+  const grpc_millis deadline = from + t->keepalive_time;
+  const grpc_millis grid =
+      std::min(t->keepalive_time / 8, kMaxKeepaliveAlignmentMs);
+  if (grid <= 1) return deadline;
+  return (deadline + grid - 1) / grid * grid;
+}
+
 static void init_keepalive_pings_if_enabled(grpc_chttp2_transport* t) {
   if (t->keepalive_time != GRPC_MILLIS_INF_FUTURE) {
     t->keepalive_state = GRPC_CHTTP2_KEEPALIVE_STATE_WAITING;
@@ -431,7 +463,7 @@ static void init_keepalive_pings_if_enabled(grpc_chttp2_transport* t) {
     GRPC_CLOSURE_INIT(&t->init_keepalive_ping_locked, init_keepalive_ping, t,
                       grpc_schedule_on_exec_ctx);
     grpc_timer_init(&t->keepalive_ping_timer,
-                    grpc_core::ExecCtx::Get()->Now() + t->keepalive_time,
+                    keepalive_deadline(t, grpc_core::ExecCtx::Get()->Now()),
                     &t->init_keepalive_ping_locked);
   } else {
     // Use GRPC_CHTTP2_KEEPALIVE_STATE_DISABLED to indicate there are no
@@ -582,6 +614,9 @@ static void close_transport_locked(grpc_chttp2_transport* t,
     if (t->have_next_bdp_ping_timer) {
       grpc_timer_cancel(&t->next_bdp_ping_timer);
     }
+    if (t->have_write_coalescing_timer) {
+      grpc_timer_cancel(&t->write_coalescing_timer);
+    }
     switch (t->keepalive_state) {
       case GRPC_CHTTP2_KEEPALIVE_STATE_WAITING:
         grpc_timer_cancel(&t->keepalive_ping_timer);
@@ -860,6 +895,29 @@ static void inc_initiate_write_reason(
   }
 }
 
+// Writes that may be held for the coalescing window. Keepalive and application
+// pings are waited on by timers started when they're requested, and closing or
+// resetting a transport shouldn't be delayed, so those go out immediately.
+static bool write_can_be_coalesced(grpc_chttp2_initiate_write_reason reason) {
+  switch (reason) {
+    case GRPC_CHTTP2_INITIATE_WRITE_START_NEW_STREAM:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_MESSAGE:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_INITIAL_METADATA:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_TRAILING_METADATA:
+    case GRPC_CHTTP2_INITIATE_WRITE_RST_STREAM:
+    case GRPC_CHTTP2_INITIATE_WRITE_STREAM_FLOW_CONTROL:
+    case GRPC_CHTTP2_INITIATE_WRITE_TRANSPORT_FLOW_CONTROL:
+    case GRPC_CHTTP2_INITIATE_WRITE_SEND_SETTINGS:
+    case GRPC_CHTTP2_INITIATE_WRITE_PING_RESPONSE:
+    // BDP pings are timed from when they're written, so they can wait to ride
+    // along with other frames
+    case GRPC_CHTTP2_INITIATE_WRITE_BDP_PING:
+      return true;
+    default:
+      return false;
+  }
+}
+
 void grpc_chttp2_initiate_write(grpc_chttp2_transport* t,
                                 grpc_chttp2_initiate_write_reason reason) {
   GPR_TIMER_SCOPE("grpc_chttp2_initiate_write", 0);
@@ -870,6 +928,20 @@ void grpc_chttp2_initiate_write(grpc_chttp2_transport* t,
       set_write_state(t, GRPC_CHTTP2_WRITE_STATE_WRITING,
                       grpc_chttp2_initiate_write_reason_string(reason));
       GRPC_CHTTP2_REF_TRANSPORT(t, "writing");
+      // With a coalescing window, hold the write so that frames queued by
+      // other streams in the meantime join it. begin_write still bounds each
+      // endpoint write by the target write size.
+      if (t->write_coalescing_window > 0 && write_can_be_coalesced(reason)) {
+        t->have_write_coalescing_timer = true;
+        GRPC_CLOSURE_INIT(&t->write_coalescing_timer_expired_locked,
+                          write_coalescing_timer_expired, t,
+                          grpc_schedule_on_exec_ctx);
+        grpc_timer_init(
+            &t->write_coalescing_timer,
+            grpc_core::ExecCtx::Get()->Now() + t->write_coalescing_window,
+            &t->write_coalescing_timer_expired_locked);
+        break;
+      }
       // Note that the 'write_action_begin_locked' closure is being scheduled
       // on the 'finally_scheduler' of t->combiner. This means that
       // 'write_action_begin_locked' is called only *after* all the other
@@ -894,12 +966,37 @@ void grpc_chttp2_initiate_write(grpc_chttp2_transport* t,
     case GRPC_CHTTP2_WRITE_STATE_WRITING:
       set_write_state(t, GRPC_CHTTP2_WRITE_STATE_WRITING_WITH_MORE,
                       grpc_chttp2_initiate_write_reason_string(reason));
-      break;
+      ABSL_FALLTHROUGH_INTENDED;
     case GRPC_CHTTP2_WRITE_STATE_WRITING_WITH_MORE:
+      // Anything that can't wait flushes a held write early
+      if (t->have_write_coalescing_timer && !write_can_be_coalesced(reason)) {
+        grpc_timer_cancel(&t->write_coalescing_timer);
+      }
       break;
   }
 }
 
+static void write_coalescing_timer_expired(void* gt, grpc_error_handle error) {
+  grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(gt);
+  t->combiner->Run(
+      GRPC_CLOSURE_INIT(&t->write_coalescing_timer_expired_locked,
+                        write_coalescing_timer_expired_locked, t, nullptr),
+      GRPC_ERROR_REF(error));
+}
+
+static void write_coalescing_timer_expired_locked(
+    void* gt, grpc_error_handle /*error*/) {
+  grpc_chttp2_transport* t = static_cast<grpc_chttp2_transport*>(gt);
+  GPR_ASSERT(t->have_write_coalescing_timer);
+  t->have_write_coalescing_timer = false;
+  // Cancelled or not, the held write goes out now; if the transport closed,
+  // write_action_begin_locked writes nothing and drops the "writing" ref.
+  t->combiner->FinallyRun(
+      GRPC_CLOSURE_INIT(&t->write_action_begin_locked,
+                        write_action_begin_locked, t, nullptr),
+      GRPC_ERROR_NONE);
+}
+
 void grpc_chttp2_mark_stream_writable(grpc_chttp2_transport* t,
                                       grpc_chttp2_stream* s) {
   if (t->closed_with_error == GRPC_ERROR_NONE &&
@@ -1390,6 +1487,19 @@ static void perform_stream_op_locked(void* stream_op,
     s->send_initial_metadata_finished = add_closure_barrier(on_complete);
     s->send_initial_metadata =
         op_payload->send_initial_metadata.send_initial_metadata;
+    std::string weight_buffer;
+    absl::optional<absl::string_view> weight =
+        s->send_initial_metadata->GetStringValue(
+            GRPC_STREAM_WEIGHT_METADATA_KEY, &weight_buffer);
+    if (weight.has_value()) {
+      uint32_t value;
+      if (absl::SimpleAtoi(*weight, &value)) {
+        s->write_weight = grpc_core::Clamp<uint32_t>(
+            value, GRPC_CHTTP2_MIN_STREAM_WEIGHT,
+            GRPC_CHTTP2_MAX_STREAM_WEIGHT);
+      }
+      s->send_initial_metadata->Remove(GRPC_STREAM_WEIGHT_METADATA_KEY);
+    }
     if (t->is_client) {
       s->deadline = std::min(
           s->deadline,
@@ -2455,10 +2565,9 @@ static void read_action_locked(void* tp, grpc_error_handle error) {
     t->endpoint_reading = 0;
   } else if (t->closed_with_error == GRPC_ERROR_NONE) {
     keep_reading = true;
-    // Since we have read a byte, reset the keepalive timer
-    if (t->keepalive_state == GRPC_CHTTP2_KEEPALIVE_STATE_WAITING) {
-      grpc_timer_cancel(&t->keepalive_ping_timer);
-    }
+    // Since we have read a byte, push back the keepalive ping. Rather than
+    // re-arming the timer on every read, the timer checks this when it fires.
+    t->keepalive_last_activity = grpc_core::ExecCtx::Get()->Now();
   }
   grpc_slice_buffer_reset_and_unref_internal(&t->read_buffer);
 
@@ -2517,10 +2626,8 @@ static void start_bdp_ping_locked(void* tp, grpc_error_handle error) {
   if (error != GRPC_ERROR_NONE || t->closed_with_error != GRPC_ERROR_NONE) {
     return;
   }
-  // Reset the keepalive ping timer
-  if (t->keepalive_state == GRPC_CHTTP2_KEEPALIVE_STATE_WAITING) {
-    grpc_timer_cancel(&t->keepalive_ping_timer);
-  }
+  // The BDP ping does for a keepalive ping, so push back the next one
+  t->keepalive_last_activity = grpc_core::ExecCtx::Get()->Now();
   t->flow_control->bdp_estimator()->StartPing();
   t->bdp_ping_started = true;
 }
@@ -2659,6 +2766,17 @@ static void init_keepalive_ping_locked(void* arg, grpc_error_handle error) {
   GPR_ASSERT(t->keepalive_state == GRPC_CHTTP2_KEEPALIVE_STATE_WAITING);
   if (t->destroying || t->closed_with_error != GRPC_ERROR_NONE) {
     t->keepalive_state = GRPC_CHTTP2_KEEPALIVE_STATE_DYING;
+  } else if (error == GRPC_ERROR_NONE &&
+             t->keepalive_last_activity + t->keepalive_time >
+                 grpc_core::ExecCtx::Get()->Now()) {
+    // There's been activity since the timer was set: wait out the rest of
+    // the keepalive time from then
+    GRPC_CHTTP2_REF_TRANSPORT(t, "init keepalive ping");
+    GRPC_CLOSURE_INIT(&t->init_keepalive_ping_locked, init_keepalive_ping, t,
+                      grpc_schedule_on_exec_ctx);
+    grpc_timer_init(&t->keepalive_ping_timer,
+                    keepalive_deadline(t, t->keepalive_last_activity),
+                    &t->init_keepalive_ping_locked);
   } else if (error == GRPC_ERROR_NONE) {
     if (t->keepalive_permit_without_calls ||
         grpc_chttp2_stream_map_size(&t->stream_map) > 0) {
@@ -2672,7 +2790,7 @@ static void init_keepalive_ping_locked(void* arg, grpc_error_handle error) {
       GRPC_CLOSURE_INIT(&t->init_keepalive_ping_locked, init_keepalive_ping, t,
                         grpc_schedule_on_exec_ctx);
       grpc_timer_init(&t->keepalive_ping_timer,
-                      grpc_core::ExecCtx::Get()->Now() + t->keepalive_time,
+                      keepalive_deadline(t, grpc_core::ExecCtx::Get()->Now()),
                       &t->init_keepalive_ping_locked);
     }
   } else if (error == GRPC_ERROR_CANCELLED) {
@@ -2681,7 +2799,7 @@ static void init_keepalive_ping_locked(void* arg, grpc_error_handle error) {
     GRPC_CLOSURE_INIT(&t->init_keepalive_ping_locked, init_keepalive_ping, t,
                       grpc_schedule_on_exec_ctx);
     grpc_timer_init(&t->keepalive_ping_timer,
-                    grpc_core::ExecCtx::Get()->Now() + t->keepalive_time,
+                    keepalive_deadline(t, grpc_core::ExecCtx::Get()->Now()),
                     &t->init_keepalive_ping_locked);
   }
   GRPC_CHTTP2_UNREF_TRANSPORT(t, "init keepalive ping");
@@ -2746,7 +2864,7 @@ static void finish_keepalive_ping_locked(void* arg, grpc_error_handle error) {
       GRPC_CLOSURE_INIT(&t->init_keepalive_ping_locked, init_keepalive_ping, t,
                         grpc_schedule_on_exec_ctx);
       grpc_timer_init(&t->keepalive_ping_timer,
-                      grpc_core::ExecCtx::Get()->Now() + t->keepalive_time,
+                      keepalive_deadline(t, grpc_core::ExecCtx::Get()->Now()),
                       &t->init_keepalive_ping_locked);
     }
   }
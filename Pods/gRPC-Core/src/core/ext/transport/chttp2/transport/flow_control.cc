@@ -218,7 +218,7 @@ grpc_error_handle TransportFlowControl::ValidateRecvData(
 
 StreamFlowControl::StreamFlowControl(TransportFlowControl* tfc,
                                      const grpc_chttp2_stream* s)
-    : tfc_(tfc), s_(s) {}
+    : tfc_(tfc), s_(s), autotune_epoch_start_(ExecCtx::Get()->Now()) {}
 
 grpc_error_handle StreamFlowControl::RecvData(int64_t incoming_frame_size) {
   FlowControlTrace trace("  data recv", tfc_, this);
@@ -257,6 +257,7 @@ grpc_error_handle StreamFlowControl::RecvData(int64_t incoming_frame_size) {
 
   UpdateAnnouncedWindowDelta(tfc_, -incoming_frame_size);
   local_window_delta_ -= incoming_frame_size;
+  autotune_bytes_ += incoming_frame_size;
   tfc_->CommitRecvData(incoming_frame_size);
   return GRPC_ERROR_NONE;
 }
@@ -309,6 +310,14 @@ void StreamFlowControl::IncomingByteStreamUpdate(size_t max_size_hint,
     max_recv_bytes = 0;
   }
 
+  /* let a stream that keeps consuming data run ahead of the application */
+  Autotune();
+  if (autotuned_window_ > have_already) {
+    max_recv_bytes = std::max(
+        max_recv_bytes,
+        autotuned_window_ - static_cast<uint32_t>(have_already));
+  }
+
   /* add some small lookahead to keep pipelines flowing */
   GPR_DEBUG_ASSERT(
       max_recv_bytes <=
@@ -323,28 +332,80 @@ void StreamFlowControl::IncomingByteStreamUpdate(size_t max_size_hint,
   }
 }
 
-// Take in a target and modifies it based on the memory pressure of the system
-static double AdjustForMemoryPressure(double memory_pressure, double target) {
+void StreamFlowControl::Autotune() {
+  // Measure over a few round trips at least, to smooth out bursts
+  static const grpc_millis kMinEpoch = 100;
+  static const double kEpochRtts = 4;
+  // Window to give per round trip's worth of consumption
+  static const double kWindowRtts = 2;
+  const grpc_millis now = ExecCtx::Get()->Now();
+  const double rtt = tfc_->bdp_estimator()->EstimateRtt();
+  const grpc_millis elapsed = now - autotune_epoch_start_;
+  if (elapsed < std::max(kMinEpoch,
+                         static_cast<grpc_millis>(kEpochRtts * rtt * 1e3))) {
+    return;
+  }
+  // Idle streams, and any stream before the first ping measures the round
+  // trip, go back to just the window the application asks for.
+  // Nor do we grow windows under memory pressure.
+  if (autotune_bytes_ == 0 || rtt == 0 ||
+      tfc_->PressureLevel() >= MemoryPressureLevel::kModerate) {
+    autotuned_window_ = 0;
+  } else {
+    const double rate = static_cast<double>(autotune_bytes_) * 1e3 /
+                        static_cast<double>(elapsed);
+    autotuned_window_ = static_cast<uint32_t>(
+        Clamp(kWindowRtts * rate * rtt, 0.0, double(kMaxWindowDelta)));
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_flowctl_trace)) {
+    gpr_log(GPR_INFO,
+            "%p[%u] autotune: %" PRId64 " bytes in %" PRId64
+            "ms, rtt=%lfs window=%u",
+            tfc_->transport(), s_->id, autotune_bytes_, elapsed, rtt,
+            autotuned_window_);
+  }
+  autotune_bytes_ = 0;
+  autotune_epoch_start_ = now;
+}
+
+// Take in a target and modifies it based on the memory pressure of the system:
+// windows shrink from the quota's moderate pressure threshold, to nothing at
+// its high one.
+static double AdjustForMemoryPressure(
+    double memory_pressure, const MemoryPressureThresholds& thresholds,
+    double target) {
   // do not increase window under heavy memory pressure.
   static const double kLowMemPressure = 0.1;
   static const double kZeroTarget = 22;
-  static const double kHighMemPressure = 0.8;
-  static const double kMaxMemPressure = 0.9;
   if (memory_pressure < kLowMemPressure && target < kZeroTarget) {
     target = (target - kZeroTarget) * memory_pressure / kLowMemPressure +
              kZeroTarget;
-  } else if (memory_pressure > kHighMemPressure) {
-    target *= 1 - std::min(1.0, (memory_pressure - kHighMemPressure) /
-                                    (kMaxMemPressure - kHighMemPressure));
+  } else if (memory_pressure > thresholds.moderate) {
+    const double range = thresholds.high - thresholds.moderate;
+    target *= range <= 0 ? 0
+                         : 1 - std::min(1.0, (memory_pressure -
+                                              thresholds.moderate) /
+                                                 range);
   }
   return target;
 }
 
+double TransportFlowControl::MemoryPressure() const {
+  return t_->memory_owner.is_valid() ? t_->memory_owner.InstantaneousPressure()
+                                     : 0.0;
+}
+
+MemoryPressureLevel TransportFlowControl::PressureLevel() const {
+  return t_->memory_owner.is_valid() ? t_->memory_owner.PressureLevel()
+                                     : MemoryPressureLevel::kNone;
+}
+
 double TransportFlowControl::TargetLogBdp() {
-  return AdjustForMemoryPressure(t_->memory_owner.is_valid()
-                                     ? t_->memory_owner.InstantaneousPressure()
-                                     : 0.0,
-                                 1 + log2(bdp_estimator_.EstimateBdp()));
+  return AdjustForMemoryPressure(
+      MemoryPressure(),
+      t_->memory_owner.is_valid() ? t_->memory_owner.PressureThresholds()
+                                  : MemoryPressureThresholds(),
+      1 + log2(bdp_estimator_.EstimateBdp()));
 }
 
 double TransportFlowControl::SmoothLogBdp(double value) {
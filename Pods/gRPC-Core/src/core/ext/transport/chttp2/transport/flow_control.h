@@ -26,6 +26,7 @@
 #include "src/core/ext/transport/chttp2/transport/http2_settings.h"
 #include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
+#include "src/core/lib/resource_quota/memory_quota.h"
 #include "src/core/lib/transport/bdp_estimator.h"
 #include "src/core/lib/transport/pid_controller.h"
 
@@ -296,6 +297,11 @@ class TransportFlowControl final : public TransportFlowControlBase {
 
   BdpEstimator* bdp_estimator() override { return &bdp_estimator_; }
 
+  // Memory pressure of the transport's memory owner, from 0 to 1
+  double MemoryPressure() const;
+  // ... and its memory pressure level
+  MemoryPressureLevel PressureLevel() const;
+
   void TestOnlyForceHugeWindow() override {
     announced_window_ = 1024 * 1024 * 1024;
     remote_window_ = 1024 * 1024 * 1024;
@@ -470,6 +476,19 @@ class StreamFlowControl final : public StreamFlowControlBase {
     announced_window_delta_ += change;
     tfc->PostUpdateAnnouncedWindowOverIncomingWindow(announced_window_delta_);
   }
+
+  // Window autotuning: on top of what the application asks for, a stream is
+  // given enough window to cover its own consumption rate over a couple of
+  // round trips. A busy stream then isn't held back by a window sized for a
+  // single message, while an idle one stops being extended.
+  void Autotune();
+
+  // Start of the current autotuning measurement, and the bytes received
+  // since
+  grpc_millis autotune_epoch_start_;
+  int64_t autotune_bytes_ = 0;
+  // Window the stream is kept ahead of the application by
+  uint32_t autotuned_window_ = 0;
 };
 
 class TestOnlyTransportTargetWindowEstimatesMocker {
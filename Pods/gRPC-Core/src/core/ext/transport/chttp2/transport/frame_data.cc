@@ -90,6 +90,21 @@ void grpc_chttp2_encode_data(uint32_t id, grpc_slice_buffer* inbuf,
   stats->data_bytes += write_bytes;
 }
 
+// Remove the first slice from slices, returning its bytes from offset on.
+// Payload is never copied on the way to the byte stream: a slice that's handed
+// on whole (the usual case for all but the one holding a frame header) keeps
+// the ref it already has rather than taking a new one and dropping the old.
+static grpc_slice take_rest_of_first(grpc_slice_buffer* slices,
+                                     size_t offset) {
+  if (offset == 0) {
+    return grpc_slice_buffer_take_first(slices);
+  }
+  grpc_slice* slice = grpc_slice_buffer_peek_first(slices);
+  grpc_slice out = grpc_slice_sub(*slice, offset, GRPC_SLICE_LENGTH(*slice));
+  grpc_slice_buffer_remove_first(slices);
+  return out;
+}
+
 grpc_error_handle grpc_deframe_unprocessed_incoming_frames(
     grpc_chttp2_data_parser* p, grpc_chttp2_stream* s,
     grpc_slice_buffer* slices, grpc_slice* slice_out,
@@ -218,42 +233,36 @@ grpc_error_handle grpc_deframe_unprocessed_incoming_frames(
           s->stats.incoming.data_bytes += remaining;
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Push(
-                   grpc_slice_sub(*slice, static_cast<size_t>(cur - beg),
-                                  static_cast<size_t>(end - beg)),
+                   take_rest_of_first(slices, static_cast<size_t>(cur - beg)),
                    slice_out))) {
-            grpc_slice_buffer_remove_first(slices);
             return error;
           }
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Finished(GRPC_ERROR_NONE, true))) {
-            grpc_slice_buffer_remove_first(slices);
             return error;
           }
           p->parsing_frame = nullptr;
           p->state = GRPC_CHTTP2_DATA_FH_0;
-          grpc_slice_buffer_remove_first(slices);
           return GRPC_ERROR_NONE;
         } else if (remaining < p->frame_size) {
           s->stats.incoming.data_bytes += remaining;
           if (GRPC_ERROR_NONE !=
               (error = p->parsing_frame->Push(
-                   grpc_slice_sub(*slice, static_cast<size_t>(cur - beg),
-                                  static_cast<size_t>(end - beg)),
+                   take_rest_of_first(slices, static_cast<size_t>(cur - beg)),
                    slice_out))) {
             return error;
           }
           p->frame_size -= remaining;
-          grpc_slice_buffer_remove_first(slices);
           return GRPC_ERROR_NONE;
         } else {
           GPR_ASSERT(remaining > p->frame_size);
           s->stats.incoming.data_bytes += p->frame_size;
           if (GRPC_ERROR_NONE !=
-              p->parsing_frame->Push(
-                  grpc_slice_sub(
-                      *slice, static_cast<size_t>(cur - beg),
-                      static_cast<size_t>(cur + p->frame_size - beg)),
-                  slice_out)) {
+              (error = p->parsing_frame->Push(
+                   grpc_slice_sub(
+                       *slice, static_cast<size_t>(cur - beg),
+                       static_cast<size_t>(cur + p->frame_size - beg)),
+                   slice_out))) {
             grpc_slice_buffer_remove_first(slices);
             return error;
           }
@@ -336,50 +336,51 @@ void HPackCompressor::Framer::AdvertiseTableSizeChange() {
   w.Write(0x20, AddTiny(w.length()));
 }
 
-void HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
-                                         const Slice& value, Framer* framer) {
+uint32_t HPackCompressor::SliceIndex::EmitTo(absl::string_view key,
+                                             const Slice& value,
+                                             Framer* framer) {
   auto& table = framer->compressor_->table_;
-  using It = std::vector<ValueIndex>::iterator;
-  It prev = values_.end();
   uint32_t transport_length =
       key.length() + value.length() + hpack_constants::kEntryOverhead;
   if (transport_length > HPackEncoderTable::MaxEntrySize()) {
     framer->EmitLitHdrWithNonBinaryStringKeyNotIdx(Slice::FromStaticString(key),
                                                    value.Ref());
-    return;
-  }
-  // Linear scan through previous values to see if we find the value.
-  for (It it = values_.begin(); it != values_.end(); ++it) {
-    if (value == it->value) {
-      // Got a hit... is it still in the decode table?
-      if (table.ConvertableToDynamicIndex(it->index)) {
-        // Yes, emit the index and proceed to cleanup.
-        framer->EmitIndexed(table.DynamicIndex(it->index));
-      } else {
-        // Not current, emit a new literal and update the index.
-        it->index = table.AllocateIndex(transport_length);
-        framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(
-            Slice::FromStaticString(key), value.Ref());
-      }
-      // Bubble this entry up if we can - ensures that the most used values end
-      // up towards the start of the array.
-      if (prev != values_.end()) std::swap(*prev, *it);
-      // If there are entries at the end of the array, and those entries are no
-      // longer in the table, remove them.
-      while (!values_.empty() &&
-             !table.ConvertableToDynamicIndex(values_.back().index)) {
-        values_.pop_back();
-      }
-      // All done, early out.
-      return;
+    return 0;
+  }
+  auto it = values_.find(value.c_slice());
+  if (it != values_.end()) {
+    // Got a hit... is it still in the decode table?
+    if (table.ConvertableToDynamicIndex(it->second.index)) {
+      // Yes, emit the index.
+      framer->EmitIndexed(table.DynamicIndex(it->second.index));
+    } else {
+      // Not current, emit a new literal and update the index.
+      it->second.index = table.AllocateIndex(transport_length);
+      framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(
+          Slice::FromStaticString(key), value.Ref());
     }
-    prev = it;
+    return it->second.index;
   }
   // No hit, emit a new literal and add it to the index.
   uint32_t index = table.AllocateIndex(transport_length);
   framer->EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice::FromStaticString(key),
                                                  value.Ref());
-  values_.emplace_back(value.Ref(), index);
+  Slice owned = value.Ref();
+  const grpc_slice owned_key = owned.c_slice();
+  values_.emplace(owned_key, ValueIndex(std::move(owned), index));
+  // Drop the values that have left the table, at a rate that keeps this
+  // O(1) amortized.
+  if (values_.size() >= sweep_at_) {
+    for (auto value_it = values_.begin(); value_it != values_.end();) {
+      if (table.ConvertableToDynamicIndex(value_it->second.index)) {
+        ++value_it;
+      } else {
+        value_it = values_.erase(value_it);
+      }
+    }
+    sweep_at_ = std::max(kMinSweepSize, 2 * values_.size());
+  }
+  return index;
 }
 
 void HPackCompressor::Framer::Encode(const Slice& key, const Slice& value) {
@@ -391,13 +392,14 @@ void HPackCompressor::Framer::Encode(const Slice& key, const Slice& value) {
 }
 
 void HPackCompressor::Framer::Encode(HttpPathMetadata, const Slice& value) {
-  compressor_->path_index_.EmitTo(HttpPathMetadata::key(), value, this);
+  path_index_ =
+      compressor_->path_index_.EmitTo(HttpPathMetadata::key(), value, this);
 }
 
 void HPackCompressor::Framer::Encode(HttpAuthorityMetadata,
                                      const Slice& value) {
-  compressor_->authority_index_.EmitTo(HttpAuthorityMetadata::key(), value,
-                                       this);
+  authority_index_ = compressor_->authority_index_.EmitTo(
+      HttpAuthorityMetadata::key(), value, this);
 }
 
 void HPackCompressor::Framer::Encode(TeMetadata, TeMetadata::ValueType value) {
@@ -638,6 +640,149 @@ void HPackCompressor::Framer::Encode(GrpcAcceptEncodingMetadata,
                                          std::move(encoded_value));
 }
 
+bool HPackCompressor::Framer::EmitRequestTemplate(
+    RequestTemplate* request_template) {
+  auto& table = compressor_->table_;
+  const uint32_t dynamic_indices[] = {
+      request_template->path_index, request_template->authority_index,
+      compressor_->content_type_index_, compressor_->te_index_};
+  for (uint32_t index : dynamic_indices) {
+    if (!table.ConvertableToDynamicIndex(index)) return false;
+  }
+  // Elements added since it was encoded have shifted the dynamic indices
+  if (request_template->encoded_length == 0 ||
+      request_template->encoded_at != table.insertion_count()) {
+    uint8_t* p = request_template->encoded;
+    auto emit_indexed = [&p](uint32_t index) {
+      VarintWriter<1> w(index);
+      w.Write(0x80, p);
+      p += w.length();
+    };
+    emit_indexed(table.DynamicIndex(request_template->path_index));
+    emit_indexed(table.DynamicIndex(request_template->authority_index));
+    emit_indexed(request_template->method ==
+                         HttpMethodMetadata::ValueType::kGet
+                     ? 2   // :method: GET
+                     : 3);  // :method: POST
+    emit_indexed(request_template->scheme ==
+                         HttpSchemeMetadata::ValueType::kHttp
+                     ? 6   // :scheme: http
+                     : 7);  // :scheme: https
+    emit_indexed(table.DynamicIndex(compressor_->content_type_index_));
+    emit_indexed(table.DynamicIndex(compressor_->te_index_));
+    request_template->encoded_at = table.insertion_count();
+    request_template->encoded_length =
+        static_cast<uint8_t>(p - request_template->encoded);
+  }
+  memcpy(AddTiny(request_template->encoded_length), request_template->encoded,
+         request_template->encoded_length);
+  for (size_t i = 0; i < 6; i++) {
+    GRPC_STATS_INC_HPACK_SEND_INDEXED();
+  }
+  return true;
+}
+
+namespace {
+// Forwards the headers of a request to a framer, less those covered by the
+// request template it has already emitted.
+class SkipRequestTemplateHeaders {
+ public:
+  explicit SkipRequestTemplateHeaders(HPackCompressor::Framer* framer)
+      : framer_(framer) {}
+
+  void Encode(HttpPathMetadata, const Slice&) {}
+  void Encode(HttpAuthorityMetadata, const Slice&) {}
+  void Encode(HttpMethodMetadata, HttpMethodMetadata::ValueType) {}
+  void Encode(HttpSchemeMetadata, HttpSchemeMetadata::ValueType) {}
+  void Encode(ContentTypeMetadata, ContentTypeMetadata::ValueType) {}
+  void Encode(TeMetadata, TeMetadata::ValueType) {}
+  template <typename Which, typename Value>
+  void Encode(Which which, const Value& value) {
+    framer_->Encode(which, value);
+  }
+  void Encode(const Slice& key, const Slice& value) {
+    framer_->Encode(key, value);
+  }
+
+ private:
+  HPackCompressor::Framer* const framer_;
+};
+}  // namespace
+
+void HPackCompressor::EncodeHeaders(const EncodeHeaderOptions& options,
+                                    const grpc_metadata_batch& headers,
+                                    grpc_slice_buffer* output) {
+  Framer framer(options, this, output);
+  // Only requests lead with exactly the headers a template covers, in the
+  // order they'd be encoded in anyway.
+  const Slice* path = headers.get_pointer(HttpPathMetadata());
+  const Slice* authority = headers.get_pointer(HttpAuthorityMetadata());
+  auto method = headers.get(HttpMethodMetadata());
+  auto scheme = headers.get(HttpSchemeMetadata());
+  if (path == nullptr || authority == nullptr ||
+      (method != HttpMethodMetadata::ValueType::kPost &&
+       method != HttpMethodMetadata::ValueType::kGet) ||
+      (scheme != HttpSchemeMetadata::ValueType::kHttp &&
+       scheme != HttpSchemeMetadata::ValueType::kHttps) ||
+      headers.get(ContentTypeMetadata()) !=
+          ContentTypeMetadata::ValueType::kApplicationGrpc ||
+      headers.get(TeMetadata()) != TeMetadata::ValueType::kTrailers ||
+      headers.get_pointer(HttpStatusMetadata()) != nullptr) {
+    headers.Encode(&framer);
+    return;
+  }
+  RequestTemplate* request_template =
+      FindRequestTemplate(*path, *authority, *method, *scheme);
+  if (request_template != nullptr &&
+      framer.EmitRequestTemplate(request_template)) {
+    SkipRequestTemplateHeaders sink(&framer);
+    headers.Encode(&sink);
+    return;
+  }
+  headers.Encode(&framer);
+  SaveRequestTemplate(request_template, *path, *authority, *method, *scheme,
+                      framer.path_index_, framer.authority_index_);
+}
+
+HPackCompressor::RequestTemplate* HPackCompressor::FindRequestTemplate(
+    const Slice& path, const Slice& authority,
+    HttpMethodMetadata::ValueType method,
+    HttpSchemeMetadata::ValueType scheme) {
+  for (auto it = request_templates_.begin(); it != request_templates_.end();
+       ++it) {
+    if (it->method == method && it->scheme == scheme && it->path == path &&
+        it->authority == authority) {
+      // Bubble this entry up, like SliceIndex does
+      if (it != request_templates_.begin()) {
+        std::swap(*it, *(it - 1));
+        --it;
+      }
+      return &*it;
+    }
+  }
+  return nullptr;
+}
+
+void HPackCompressor::SaveRequestTemplate(
+    RequestTemplate* request_template, const Slice& path,
+    const Slice& authority, HttpMethodMetadata::ValueType method,
+    HttpSchemeMetadata::ValueType scheme, uint32_t path_index,
+    uint32_t authority_index) {
+  // Too large to be indexed: there's nothing to precompile.
+  if (path_index == 0 || authority_index == 0) return;
+  if (request_template == nullptr) {
+    if (request_templates_.size() == kMaxRequestTemplates) {
+      request_templates_.pop_back();
+    }
+    request_templates_.push_back(
+        RequestTemplate{path.Ref(), authority.Ref(), method, scheme});
+    request_template = &request_templates_.back();
+  }
+  request_template->path_index = path_index;
+  request_template->authority_index = authority_index;
+  request_template->encoded_length = 0;
+}
+
 void HPackCompressor::SetMaxUsableSize(uint32_t max_table_size) {
   max_usable_size_ = max_table_size;
   SetMaxTableSize(std::min(table_.max_size(), max_table_size));
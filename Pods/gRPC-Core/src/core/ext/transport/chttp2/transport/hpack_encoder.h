@@ -22,12 +22,14 @@
 #include <grpc/support/port_platform.h>
 
 #include <cstdint>
+#include <unordered_map>
 
 #include <grpc/slice.h>
 #include <grpc/slice_buffer.h>
 
 #include "src/core/ext/transport/chttp2/transport/frame.h"
 #include "src/core/ext/transport/chttp2/transport/hpack_encoder_table.h"
+#include "src/core/lib/slice/slice_internal.h"
 #include "src/core/lib/transport/metadata_batch.h"
 #include "src/core/lib/transport/transport.h"
 
@@ -37,6 +39,7 @@ namespace grpc_core {
 
 class HPackCompressor {
   class SliceIndex;
+  struct RequestTemplate;
 
  public:
   HPackCompressor() = default;
@@ -66,6 +69,11 @@ class HPackCompressor {
     Framer framer(options, this, output);
     headers.Encode(&framer);
   }
+  // As above, but emits the leading headers of requests from a
+  // RequestTemplate where it can.
+  void EncodeHeaders(const EncodeHeaderOptions& options,
+                     const grpc_metadata_batch& headers,
+                     grpc_slice_buffer* output);
 
   class Framer {
    public:
@@ -109,6 +117,7 @@ class HPackCompressor {
     }
 
    private:
+    friend class HPackCompressor;
     friend class SliceIndex;
 
     struct FramePrefix {
@@ -125,6 +134,7 @@ class HPackCompressor {
 
     void AdvertiseTableSizeChange();
     void EmitIndexed(uint32_t index);
+    bool EmitRequestTemplate(RequestTemplate* request_template);
     void EmitLitHdrWithNonBinaryStringKeyIncIdx(Slice key_slice,
                                                 Slice value_slice);
     void EmitLitHdrWithBinaryStringKeyIncIdx(Slice key_slice,
@@ -156,11 +166,18 @@ class HPackCompressor {
     grpc_transport_one_way_stats* const stats_;
     HPackCompressor* const compressor_;
     FramePrefix prefix_;
+    // Table indices of the :path and :authority values sent, if they were
+    // indexed
+    uint32_t path_index_ = 0;
+    uint32_t authority_index_ = 0;
   };
 
  private:
   static constexpr size_t kNumFilterValues = 64;
   static constexpr uint32_t kNumCachedGrpcStatusValues = 16;
+  static constexpr size_t kMaxRequestTemplates = 8;
+  // Four dynamic indices and two static ones
+  static constexpr size_t kMaxRequestTemplateLength = 4 * 5 + 2;
 
   // maximum number of bytes we'll use for the decode table (to guard against
   // peers ooming us by setting decode table size high)
@@ -172,16 +189,23 @@ class HPackCompressor {
 
   class SliceIndex {
    public:
-    void EmitTo(absl::string_view key, const Slice& value, Framer* framer);
+    // Returns the table index of the value, or 0 if it wasn't indexed
+    uint32_t EmitTo(absl::string_view key, const Slice& value, Framer* framer);
 
    private:
+    // Entries no longer in the table are dropped once this many more values
+    // have been added since the last sweep
+    static constexpr size_t kMinSweepSize = 16;
+
     struct ValueIndex {
       ValueIndex(Slice value, uint32_t index)
           : value(std::move(value)), index(index) {}
       Slice value;
       uint32_t index;
     };
-    std::vector<ValueIndex> values_;
+    // Keyed by the value's c_slice(), whose bytes the entry's value owns
+    std::unordered_map<grpc_slice, ValueIndex, SliceHash> values_;
+    size_t sweep_at_ = kMinSweepSize;
   };
 
   struct PreviousTimeout {
@@ -189,6 +213,36 @@ class HPackCompressor {
     uint32_t index;
   };
 
+  // A precompiled header block fragment for the headers that lead every
+  // request to a method: :path, :authority, :method, :scheme, content-type
+  // and te. Once a connection has sent them they stay in the table for as
+  // long as it keeps calling the same methods, so the fragment is all
+  // indexed fields and is emitted with a single copy.
+  struct RequestTemplate {
+    Slice path;
+    Slice authority;
+    HttpMethodMetadata::ValueType method;
+    HttpSchemeMetadata::ValueType scheme;
+    // Table indices of path and authority
+    uint32_t path_index;
+    uint32_t authority_index;
+    // table_.insertion_count() when encoded, which its dynamic indices are
+    // relative to; encoded_length is zero until it has been encoded
+    uint32_t encoded_at;
+    uint8_t encoded_length;
+    uint8_t encoded[kMaxRequestTemplateLength];
+  };
+
+  RequestTemplate* FindRequestTemplate(const Slice& path,
+                                       const Slice& authority,
+                                       HttpMethodMetadata::ValueType method,
+                                       HttpSchemeMetadata::ValueType scheme);
+  void SaveRequestTemplate(RequestTemplate* request_template,
+                           const Slice& path, const Slice& authority,
+                           HttpMethodMetadata::ValueType method,
+                           HttpSchemeMetadata::ValueType scheme,
+                           uint32_t path_index, uint32_t authority_index);
+
   // Index into table_ for the te:trailers metadata element
   uint32_t te_index_ = 0;
   // Index into table_ for the content-type metadata element
@@ -212,6 +266,8 @@ class HPackCompressor {
   SliceIndex path_index_;
   SliceIndex authority_index_;
   std::vector<PreviousTimeout> previous_timeouts_;
+  // Most recently used first
+  std::vector<RequestTemplate> request_templates_;
 };
 
 }  // namespace grpc_core
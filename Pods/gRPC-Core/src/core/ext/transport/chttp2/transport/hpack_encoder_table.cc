@@ -21,7 +21,6 @@
 namespace grpc_core {
 
 uint32_t HPackEncoderTable::AllocateIndex(size_t element_size) {
-  uint32_t new_index = tail_remote_index_ + table_elems_ + 1;
   GPR_DEBUG_ASSERT(element_size <= MaxEntrySize());
 
   if (element_size > max_table_size_) {
@@ -37,13 +36,8 @@ uint32_t HPackEncoderTable::AllocateIndex(size_t element_size) {
   while (table_size_ + element_size > max_table_size_) {
     EvictOne();
   }
-  GPR_ASSERT(table_elems_ < elem_size_.size());
-  elem_size_[new_index % elem_size_.size()] =
-      static_cast<uint16_t>(element_size);
   table_size_ += element_size;
-  table_elems_++;
-
-  return new_index;
+  return elem_size_.PushBack(static_cast<uint16_t>(element_size));
 }
 
 bool HPackEncoderTable::SetMaxSize(uint32_t max_table_size) {
@@ -54,33 +48,16 @@ bool HPackEncoderTable::SetMaxSize(uint32_t max_table_size) {
     EvictOne();
   }
   max_table_size_ = max_table_size;
-  const size_t max_table_elems =
-      hpack_constants::EntriesForBytes(max_table_size);
-  // TODO(ctiller): integrate with ResourceQuota to rebuild smaller when we can.
-  if (max_table_elems > elem_size_.size()) {
-    Rebuild(std::max(max_table_elems, 2 * elem_size_.size()));
-  }
+  // The ring grows as elements are added, so there's nothing to reserve here.
+  // TODO(ctiller): integrate with ResourceQuota to shrink when we can.
   return true;
 }
 
 void HPackEncoderTable::EvictOne() {
-  tail_remote_index_++;
-  GPR_ASSERT(tail_remote_index_ > 0);
-  GPR_ASSERT(table_elems_ > 0);
-  auto removing_size = elem_size_[tail_remote_index_ % elem_size_.size()];
+  GPR_ASSERT(!elem_size_.empty());
+  auto removing_size = elem_size_.PopFront();
   GPR_ASSERT(table_size_ >= removing_size);
   table_size_ -= removing_size;
-  table_elems_--;
-}
-
-void HPackEncoderTable::Rebuild(uint32_t capacity) {
-  decltype(elem_size_) new_elem_size(capacity);
-  GPR_ASSERT(table_elems_ <= capacity);
-  for (uint32_t i = 0; i < table_elems_; i++) {
-    uint32_t ofs = tail_remote_index_ + i + 1;
-    new_elem_size[ofs % capacity] = elem_size_[ofs % elem_size_.size()];
-  }
-  elem_size_.swap(new_elem_size);
 }
 
 }  // namespace grpc_core
@@ -44,21 +44,9 @@ HPackTable::~HPackTable() = default;
 
 /* Evict one element from the table */
 void HPackTable::EvictOne() {
-  auto first_entry = std::move(entries_[first_entry_]);
+  auto first_entry = entries_.PopFront();
   GPR_ASSERT(first_entry.transport_size() <= mem_used_);
   mem_used_ -= first_entry.transport_size();
-  first_entry_ = ((first_entry_ + 1) % entries_.size());
-  num_entries_--;
-}
-
-void HPackTable::Rebuild(uint32_t new_cap) {
-  EntriesVec entries;
-  entries.resize(new_cap);
-  for (size_t i = 0; i < num_entries_; i++) {
-    entries[i] = std::move(entries_[(first_entry_ + i) % entries_.size()]);
-  }
-  first_entry_ = 0;
-  entries_.swap(entries);
 }
 
 void HPackTable::SetMaxBytes(uint32_t max_bytes) {
@@ -90,17 +78,12 @@ grpc_error_handle HPackTable::SetCurrentTableSize(uint32_t bytes) {
     EvictOne();
   }
   current_table_bytes_ = bytes;
-  max_entries_ = hpack_constants::EntriesForBytes(bytes);
-  if (max_entries_ > entries_.size()) {
-    Rebuild(max_entries_);
-  } else if (max_entries_ < entries_.size() / 3) {
+  // entries_ grows as entries are added, so only shrinking is done here.
+  const uint32_t max_entries = hpack_constants::EntriesForBytes(bytes);
+  if (max_entries < entries_.capacity() / 3) {
     // TODO(ctiller): move to resource quota system, only shrink under memory
     // pressure
-    uint32_t new_cap =
-        std::max(max_entries_, static_cast<uint32_t>(kInlineEntries));
-    if (new_cap != entries_.size()) {
-      Rebuild(new_cap);
-    }
+    entries_.ShrinkTo(max_entries);
   }
   return GRPC_ERROR_NONE;
 }
@@ -122,7 +105,7 @@ grpc_error_handle HPackTable::Add(Memento md) {
     // attempt to add an entry larger than the entire table causes
     // the table to be emptied of all existing entries, and results in an
     // empty table.
-    while (num_entries_) {
+    while (!entries_.empty()) {
       EvictOne();
     }
     return GRPC_ERROR_NONE;
@@ -136,10 +119,7 @@ grpc_error_handle HPackTable::Add(Memento md) {
 
   // copy the finalized entry in
   mem_used_ += md.transport_size();
-  entries_[(first_entry_ + num_entries_) % entries_.size()] = std::move(md);
-
-  // update accounting values
-  num_entries_++;
+  entries_.PushBack(std::move(md));
   return GRPC_ERROR_NONE;
 }
 
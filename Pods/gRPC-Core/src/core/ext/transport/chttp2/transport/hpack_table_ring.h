@@ -0,0 +1,105 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HPACK_TABLE_RING_H
+#define GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HPACK_TABLE_RING_H
+
+#include <grpc/support/port_platform.h>
+
+#include <cstdint>
+#include <utility>
+
+#include "absl/container/inlined_vector.h"
+
+#include <grpc/support/log.h>
+
+namespace grpc_core {
+
+// The entries of an HPACK dynamic table, oldest first, stored flat in a ring.
+// Entries are addressed by the index they were added at, which keeps counting
+// up as entries are evicted. The capacity is always a power of two, so
+// addressing is a mask, and it doubles when full, so following the table's
+// size costs O(1) amortized per entry instead of a rebuild per resize.
+template <typename T, uint32_t kInlineEntries>
+class HPackTableRing {
+  static_assert((kInlineEntries & (kInlineEntries - 1)) == 0,
+                "capacity must be a power of two");
+
+ public:
+  explicit HPackTableRing(uint32_t first_index = 0)
+      : first_(first_index), entries_(kInlineEntries) {}
+
+  // Index of the oldest entry
+  uint32_t first_index() const { return first_; }
+  // Index the next entry will be added at
+  uint32_t end_index() const { return first_ + size_; }
+  uint32_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+  uint32_t capacity() const { return static_cast<uint32_t>(entries_.size()); }
+
+  // index must be in [first_index(), end_index())
+  T& operator[](uint32_t index) {
+    GPR_DEBUG_ASSERT(index - first_ < size_);
+    return entries_[index & mask()];
+  }
+  const T& operator[](uint32_t index) const {
+    GPR_DEBUG_ASSERT(index - first_ < size_);
+    return entries_[index & mask()];
+  }
+
+  // Add an entry as the newest, and return its index
+  uint32_t PushBack(T value) {
+    if (size_ == capacity()) Resize(2 * capacity());
+    entries_[end_index() & mask()] = std::move(value);
+    return first_ + size_++;
+  }
+
+  // Remove the oldest entry, and return it
+  T PopFront() {
+    GPR_DEBUG_ASSERT(size_ > 0);
+    T value = std::move(entries_[first_ & mask()]);
+    first_++;
+    size_--;
+    return value;
+  }
+
+  // Release capacity beyond what's needed for max_entries (and the entries
+  // currently held)
+  void ShrinkTo(uint32_t max_entries) {
+    uint32_t new_capacity = kInlineEntries;
+    while (new_capacity < max_entries || new_capacity < size_) {
+      new_capacity *= 2;
+    }
+    if (new_capacity < capacity()) Resize(new_capacity);
+  }
+
+ private:
+  uint32_t mask() const { return capacity() - 1; }
+
+  void Resize(uint32_t new_capacity) {
+    absl::InlinedVector<T, kInlineEntries> entries(new_capacity);
+    for (uint32_t i = first_; i != end_index(); i++) {
+      entries[i & (new_capacity - 1)] = std::move(entries_[i & mask()]);
+    }
+    entries_.swap(entries);
+  }
+
+  uint32_t first_;
+  uint32_t size_ = 0;
+  absl::InlinedVector<T, kInlineEntries> entries_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_EXT_TRANSPORT_CHTTP2_TRANSPORT_HPACK_TABLE_RING_H
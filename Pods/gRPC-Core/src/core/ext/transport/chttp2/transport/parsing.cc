@@ -479,6 +479,20 @@ static grpc_error_handle init_header_frame_parser(grpc_chttp2_transport* t,
                    t->settings[GRPC_ACKED_SETTINGS]
                               [GRPC_CHTTP2_SETTINGS_MAX_CONCURRENT_STREAMS])) {
       return GRPC_ERROR_CREATE_FROM_STATIC_STRING("Max stream count exceeded");
+    } else if (GPR_UNLIKELY(t->memory_owner.is_valid() &&
+                            t->memory_owner.PressureLevel() >=
+                                grpc_core::MemoryPressureLevel::kCritical)) {
+      // Refuse the stream rather than take on more work: the client knows it
+      // was never processed, and can retry it elsewhere.
+      GRPC_CHTTP2_IF_TRACING(gpr_log(
+          GPR_INFO, "refusing grpc_chttp2_stream %d: memory pressure critical",
+          t->incoming_stream_id));
+      t->last_new_stream_id = t->incoming_stream_id;
+      grpc_chttp2_add_rst_stream_to_next_write(t, t->incoming_stream_id,
+                                               GRPC_HTTP2_REFUSED_STREAM,
+                                               nullptr);
+      grpc_chttp2_initiate_write(t, GRPC_CHTTP2_INITIATE_WRITE_RST_STREAM);
+      return init_header_skip_frame_parser(t, priority_type);
     }
     t->last_new_stream_id = t->incoming_stream_id;
     s = t->incoming_stream =
@@ -18,6 +18,10 @@
 
 #include <grpc/support/port_platform.h>
 
+#include <inttypes.h>
+
+#include <algorithm>
+
 #include <grpc/support/log.h>
 
 #include "src/core/ext/transport/chttp2/transport/chttp2_transport.h"
@@ -136,17 +140,68 @@ static bool stream_list_add(grpc_chttp2_transport* t, grpc_chttp2_stream* s,
   return true;
 }
 
+/* The writable list is a start-time fair queue: streams are kept in order of
+   their virtual start times, and writing advances a stream's virtual time by
+   the bytes written over its weight. A stream that becomes writable starts no
+   earlier than the list's current virtual time, so a new small call is served
+   ahead of busy streams that have already used up their share. */
+static bool stream_list_add_writable(grpc_chttp2_transport* t,
+                                     grpc_chttp2_stream* s) {
+  const grpc_chttp2_stream_list_id id = GRPC_CHTTP2_LIST_WRITABLE;
+  if (s->included[id]) {
+    return false;
+  }
+  s->write_vtime = std::max(s->write_vtime, t->writable_vtime);
+  grpc_chttp2_stream* prev = t->lists[id].tail;
+  // Equal start times keep their arrival order, which is round-robin among
+  // streams of the same weight
+  while (prev != nullptr && prev->write_vtime > s->write_vtime) {
+    prev = prev->links[id].prev;
+  }
+  if (prev == t->lists[id].tail) {
+    stream_list_add_tail(t, s, id);
+    return true;
+  }
+  grpc_chttp2_stream* next =
+      prev == nullptr ? t->lists[id].head : prev->links[id].next;
+  s->links[id].prev = prev;
+  s->links[id].next = next;
+  next->links[id].prev = s;
+  if (prev != nullptr) {
+    prev->links[id].next = s;
+  } else {
+    t->lists[id].head = s;
+  }
+  s->included[id] = 1;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_trace_http2_stream_state)) {
+    gpr_log(GPR_INFO, "%p[%d][%s]: add to %s at vtime %" PRIu64, t, s->id,
+            t->is_client ? "cli" : "svr", stream_list_id_string(id),
+            s->write_vtime);
+  }
+  return true;
+}
+
 /* wrappers for specializations */
 
 bool grpc_chttp2_list_add_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream* s) {
   GPR_ASSERT(s->id != 0);
-  return stream_list_add(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  return stream_list_add_writable(t, s);
 }
 
 bool grpc_chttp2_list_pop_writable_stream(grpc_chttp2_transport* t,
                                           grpc_chttp2_stream** s) {
-  return stream_list_pop(t, s, GRPC_CHTTP2_LIST_WRITABLE);
+  if (!stream_list_pop(t, s, GRPC_CHTTP2_LIST_WRITABLE)) {
+    return false;
+  }
+  t->writable_vtime = std::max(t->writable_vtime, (*s)->write_vtime);
+  return true;
+}
+
+void grpc_chttp2_charge_writable_stream(grpc_chttp2_stream* s, size_t bytes) {
+  s->write_vtime +=
+      static_cast<uint64_t>(bytes) * GRPC_CHTTP2_MAX_STREAM_WEIGHT /
+      s->write_weight;
 }
 
 bool grpc_chttp2_list_remove_writable_stream(grpc_chttp2_transport* t,
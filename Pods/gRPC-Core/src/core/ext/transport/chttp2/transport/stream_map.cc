@@ -22,19 +22,33 @@
 
 #include <string.h>
 
+#include <vector>
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+/* The table is grown before it gets more than half full */
+static size_t slot_for(const grpc_chttp2_stream_map* map, uint32_t key) {
+  /* Fibonacci hashing: stream ids go up in steps of two, which this spreads
+     evenly whatever the capacity */
+  return static_cast<size_t>(static_cast<uint32_t>(key * 2654435769u)) &
+         (map->capacity - 1);
+}
+
+static void alloc_slots(grpc_chttp2_stream_map* map, size_t capacity) {
+  map->keys = static_cast<uint32_t*>(gpr_zalloc(sizeof(uint32_t) * capacity));
+  map->values = static_cast<void**>(gpr_malloc(sizeof(void*) * capacity));
+  map->capacity = capacity;
+}
+
 void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
                                  size_t initial_capacity) {
   GPR_DEBUG_ASSERT(initial_capacity > 1);
-  map->keys =
-      static_cast<uint32_t*>(gpr_malloc(sizeof(uint32_t) * initial_capacity));
-  map->values =
-      static_cast<void**>(gpr_malloc(sizeof(void*) * initial_capacity));
+  size_t capacity = 2;
+  while (capacity < initial_capacity) capacity *= 2;
+  alloc_slots(map, capacity);
   map->count = 0;
-  map->free = 0;
-  map->capacity = initial_capacity;
+  map->last_key = 0;
 }
 
 void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map* map) {
@@ -42,136 +56,108 @@ void grpc_chttp2_stream_map_destroy(grpc_chttp2_stream_map* map) {
   gpr_free(map->values);
 }
 
-static size_t compact(uint32_t* keys, void** values, size_t count) {
-  size_t i, out;
-
-  for (i = 0, out = 0; i < count; i++) {
-    if (values[i]) {
-      keys[out] = keys[i];
-      values[out] = values[i];
-      out++;
-    }
-  }
-
-  return out;
+static void insert(grpc_chttp2_stream_map* map, uint32_t key, void* value) {
+  size_t mask = map->capacity - 1;
+  size_t slot = slot_for(map, key);
+  while (map->keys[slot] != 0) slot = (slot + 1) & mask;
+  map->keys[slot] = key;
+  map->values[slot] = value;
 }
 
 void grpc_chttp2_stream_map_add(grpc_chttp2_stream_map* map, uint32_t key,
                                 void* value) {
-  size_t count = map->count;
-  size_t capacity = map->capacity;
-  uint32_t* keys = map->keys;
-  void** values = map->values;
-
-  // The first assertion ensures that the table is monotonically increasing.
-  GPR_ASSERT(count == 0 || keys[count - 1] < key);
+  // The first assertion ensures that keys are monotonically increasing (for as
+  // long as the map isn't empty), which also means the key can't already be
+  // in the map.
+  GPR_ASSERT(map->count == 0 || key > map->last_key);
   GPR_DEBUG_ASSERT(value);
-  // Asserting that the key is not already in the map can be a debug assertion.
-  // Why: we're already checking that the map elements are monotonically
-  // increasing. If we re-add a key, i.e. if the key is already present, then
-  // either it is the most recently added key in the map (in which case the
-  // first assertion fails due to key == last_key) or there is a more recently
-  // added (larger) key at the end of the map: in which case the first assertion
-  // still fails due to key < last_key.
-  GPR_DEBUG_ASSERT(grpc_chttp2_stream_map_find(map, key) == nullptr);
-
-  if (count == capacity) {
-    if (map->free > capacity / 4) {
-      count = compact(keys, values, count);
-      map->free = 0;
-    } else {
-      /* resize when less than 25% of the table is free, because compaction
-         won't help much */
-      map->capacity = capacity = 2 * capacity;
-      map->keys = keys = static_cast<uint32_t*>(
-          gpr_realloc(keys, capacity * sizeof(uint32_t)));
-      map->values = values =
-          static_cast<void**>(gpr_realloc(values, capacity * sizeof(void*)));
+  map->last_key = key;
+
+  if (2 * (map->count + 1) > map->capacity) {
+    uint32_t* keys = map->keys;
+    void** values = map->values;
+    size_t capacity = map->capacity;
+    alloc_slots(map, 2 * capacity);
+    for (size_t i = 0; i < capacity; i++) {
+      if (keys[i] != 0) insert(map, keys[i], values[i]);
     }
+    gpr_free(keys);
+    gpr_free(values);
   }
 
-  keys[count] = key;
-  values[count] = value;
-  map->count = count + 1;
+  insert(map, key, value);
+  map->count++;
 }
 
-template <bool strict_find>
-static void** find(grpc_chttp2_stream_map* map, uint32_t key) {
-  size_t min_idx = 0;
-  size_t max_idx = map->count;
-  size_t mid_idx;
-  uint32_t* keys = map->keys;
-  void** values = map->values;
-  uint32_t mid_key;
-
-  GPR_DEBUG_ASSERT(!strict_find || max_idx > 0);
-  if (!strict_find && max_idx == 0) return nullptr;
-
-  while (min_idx < max_idx) {
-    /* find the midpoint, avoiding overflow */
-    mid_idx = min_idx + ((max_idx - min_idx) / 2);
-    mid_key = keys[mid_idx];
-
-    if (mid_key < key) {
-      min_idx = mid_idx + 1;
-    } else if (mid_key > key) {
-      max_idx = mid_idx;
-    } else /* mid_key == key */
-    {
-      return &values[mid_idx];
-    }
+static size_t find(const grpc_chttp2_stream_map* map, uint32_t key) {
+  size_t mask = map->capacity - 1;
+  for (size_t slot = slot_for(map, key);; slot = (slot + 1) & mask) {
+    if (map->keys[slot] == key) return slot;
+    if (map->keys[slot] == 0) return map->capacity;
   }
-
-  GPR_DEBUG_ASSERT(!strict_find);
-  return nullptr;
 }
 
 void* grpc_chttp2_stream_map_delete(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find<true>(map, key);
-  GPR_DEBUG_ASSERT(pvalue != nullptr);
-  void* out = *pvalue;
-  GPR_DEBUG_ASSERT(out != nullptr);
-  *pvalue = nullptr;
-  map->free++;
-  /* recognize complete emptyness and ensure we can skip
-     defragmentation later */
-  if (map->free == map->count) {
-    map->free = map->count = 0;
+  size_t slot = find(map, key);
+  GPR_DEBUG_ASSERT(slot != map->capacity);
+  if (slot == map->capacity) return nullptr;
+  void* out = map->values[slot];
+  map->count--;
+  /* backward shift deletion: move later entries of the probe run into the
+     hole, as long as that doesn't put them ahead of their home slot */
+  size_t mask = map->capacity - 1;
+  size_t hole = slot;
+  for (size_t next = (hole + 1) & mask; map->keys[next] != 0;
+       next = (next + 1) & mask) {
+    size_t home = slot_for(map, map->keys[next]);
+    if (((next - home) & mask) >= ((next - hole) & mask)) {
+      map->keys[hole] = map->keys[next];
+      map->values[hole] = map->values[next];
+      hole = next;
+    }
   }
+  map->keys[hole] = 0;
   GPR_DEBUG_ASSERT(grpc_chttp2_stream_map_find(map, key) == nullptr);
   return out;
 }
 
 void* grpc_chttp2_stream_map_find(grpc_chttp2_stream_map* map, uint32_t key) {
-  void** pvalue = find<false>(map, key);
-  return pvalue != nullptr ? *pvalue : nullptr;
+  if (key == 0) return nullptr;
+  size_t slot = find(map, key);
+  return slot != map->capacity ? map->values[slot] : nullptr;
 }
 
 size_t grpc_chttp2_stream_map_size(grpc_chttp2_stream_map* map) {
-  return map->count - map->free;
+  return map->count;
 }
 
 void* grpc_chttp2_stream_map_rand(grpc_chttp2_stream_map* map) {
-  if (map->count == map->free) {
+  if (map->count == 0) {
     return nullptr;
   }
-  if (map->free != 0) {
-    map->count = compact(map->keys, map->values, map->count);
-    map->free = 0;
-    GPR_ASSERT(map->count > 0);
-  }
-  return map->values[(static_cast<size_t>(rand())) % map->count];
+  /* not quite uniform: entries after longer runs of empty slots are favoured,
+     which is fine for picking a stream to reclaim */
+  size_t mask = map->capacity - 1;
+  size_t slot = static_cast<size_t>(rand()) & mask;
+  while (map->keys[slot] == 0) slot = (slot + 1) & mask;
+  return map->values[slot];
 }
 
 void grpc_chttp2_stream_map_for_each(grpc_chttp2_stream_map* map,
                                      void (*f)(void* user_data, uint32_t key,
                                                void* value),
                                      void* user_data) {
-  size_t i;
-
-  for (i = 0; i < map->count; i++) {
-    if (map->values[i]) {
-      f(user_data, map->keys[i], map->values[i]);
+  /* f may delete streams, which moves other entries around, so walk a snapshot
+     of the keys and look each one up again */
+  std::vector<uint32_t> keys;
+  keys.reserve(map->count);
+  for (size_t i = 0; i < map->capacity; i++) {
+    if (map->keys[i] != 0) keys.push_back(map->keys[i]);
+  }
+  for (uint32_t key : keys) {
+    void* value = grpc_chttp2_stream_map_find(map, key);
+    if (value != nullptr) {
+      f(user_data, key, value);
     }
   }
 }
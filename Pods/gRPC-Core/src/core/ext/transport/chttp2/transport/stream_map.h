@@ -25,16 +25,20 @@
 
 /* Data structure to map a uint32_t to a data object (represented by a void*)
 
-   Represented as a sorted array of keys, and a corresponding array of values.
-   Lookups are performed with binary search.
+   Represented as an open addressing hash table with linear probing: an array
+   of keys, and a corresponding array of values. Key 0 marks an empty slot,
+   which is safe since http2 never uses stream id 0. Deletes shift the rest of
+   the probe run back rather than leaving tombstones, so lookups stay short on
+   connections that cycle through many streams.
    Adds are restricted to strictly higher keys than previously seen (this is
    guaranteed by http2). */
 struct grpc_chttp2_stream_map {
   uint32_t* keys;
   void** values;
   size_t count;
-  size_t free;
+  /* always a power of two */
   size_t capacity;
+  uint32_t last_key;
 };
 void grpc_chttp2_stream_map_init(grpc_chttp2_stream_map* map,
                                  size_t initial_capacity);
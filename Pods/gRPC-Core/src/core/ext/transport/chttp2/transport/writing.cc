@@ -393,7 +393,10 @@ class DataSendContext {
 class StreamWriteContext {
  public:
   StreamWriteContext(WriteContext* write_context, grpc_chttp2_stream* s)
-      : write_context_(write_context), t_(write_context->transport()), s_(s) {
+      : write_context_(write_context),
+        t_(write_context->transport()),
+        s_(s),
+        outbuf_length_before_(t_->outbuf.length) {
     GRPC_CHTTP2_IF_TRACING(
         gpr_log(GPR_INFO, "W:%p %s[%d] im-(sent,send)=(%d,%d) announce=%d", t_,
                 t_->is_client ? "CLIENT" : "SERVER", s->id,
@@ -487,6 +490,8 @@ class StreamWriteContext {
     data_send_context.CallCallbacks();
     stream_became_writable_ = true;
     if (s_->flow_controlled_buffer.length > 0) {
+      grpc_chttp2_charge_writable_stream(
+          s_, t_->outbuf.length - outbuf_length_before_);
       GRPC_CHTTP2_STREAM_REF(s_, "chttp2_writing:fork");
       grpc_chttp2_list_add_writable_stream(t_, s_);
     }
@@ -570,6 +575,7 @@ class StreamWriteContext {
   WriteContext* const write_context_;
   grpc_chttp2_transport* const t_;
   grpc_chttp2_stream* const s_;
+  const size_t outbuf_length_before_;
   bool stream_became_writable_ = false;
   absl::optional<uint32_t> send_status_;
   absl::optional<grpc_core::ContentTypeMetadata::ValueType> send_content_type_ =
@@ -18,6 +18,7 @@
 
 #include "src/core/ext/xds/xds_api.h"
 
+#include <algorithm>
 #include <set>
 #include <string>
 #include <vector>
@@ -351,10 +352,21 @@ void MaybeLogDiscoveryResponse(
 
 }  // namespace
 
+upb::Arena XdsApi::MakeAdsResponseArena(size_t response_size) {
+  // Decoded messages plus the strings copied out of the response typically
+  // take about twice the response size.
+  constexpr size_t kMinBlockSize = 16 * 1024;
+  constexpr size_t kMaxBlockSize = 1024 * 1024;
+  size_t wanted =
+      std::min(std::max(2 * response_size, kMinBlockSize), kMaxBlockSize);
+  if (ads_arena_block_.size() < wanted) ads_arena_block_.resize(wanted);
+  return upb::Arena(ads_arena_block_.data(), ads_arena_block_.size());
+}
+
 absl::Status XdsApi::ParseAdsResponse(const XdsBootstrap::XdsServer& server,
                                       const grpc_slice& encoded_response,
                                       AdsResponseParserInterface* parser) {
-  upb::Arena arena;
+  upb::Arena arena = MakeAdsResponseArena(GRPC_SLICE_LENGTH(encoded_response));
   const XdsEncodingContext context = {client_,
                                       tracer_,
                                       symtab_->ptr(),
@@ -402,6 +414,177 @@ absl::Status XdsApi::ParseAdsResponse(const XdsBootstrap::XdsServer& server,
 
 namespace {
 
+void MaybeLogDeltaDiscoveryRequest(
+    const XdsEncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryRequest* request) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(request, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] constructed delta ADS request: %s",
+            context.client, buf);
+  }
+}
+
+void MaybeLogDeltaDiscoveryResponse(
+    const XdsEncodingContext& context,
+    const envoy_service_discovery_v3_DeltaDiscoveryResponse* response) {
+  if (GRPC_TRACE_FLAG_ENABLED(*context.tracer) &&
+      gpr_should_log(GPR_LOG_SEVERITY_DEBUG)) {
+    const upb_msgdef* msg_type =
+        envoy_service_discovery_v3_DeltaDiscoveryResponse_getmsgdef(
+            context.symtab);
+    char buf[10240];
+    upb_text_encode(response, msg_type, nullptr, 0, buf, sizeof(buf));
+    gpr_log(GPR_DEBUG, "[xds_client %p] received delta response: %s",
+            context.client, buf);
+  }
+}
+
+}  // namespace
+
+grpc_slice XdsApi::CreateDeltaAdsRequest(
+    const XdsBootstrap::XdsServer& server, absl::string_view type_url,
+    absl::string_view nonce, const std::vector<std::string>& subscribe,
+    const std::vector<std::string>& unsubscribe,
+    const std::map<std::string, std::string>& initial_versions,
+    grpc_error_handle error, bool populate_node) {
+  upb::Arena arena;
+  const XdsEncodingContext context = {client_,
+                                      tracer_,
+                                      symtab_->ptr(),
+                                      arena.ptr(),
+                                      server.ShouldUseV3(),
+                                      certificate_provider_definition_map_};
+  // Create a request.
+  envoy_service_discovery_v3_DeltaDiscoveryRequest* request =
+      envoy_service_discovery_v3_DeltaDiscoveryRequest_new(arena.ptr());
+  // Set type_url.
+  std::string type_url_str = absl::StrCat("type.googleapis.com/", type_url);
+  envoy_service_discovery_v3_DeltaDiscoveryRequest_set_type_url(
+      request, StdStringToUpbString(type_url_str));
+  // Set nonce.
+  if (!nonce.empty()) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_set_response_nonce(
+        request, StdStringToUpbString(nonce));
+  }
+  // Set error_detail if it's a NACK.
+  std::string error_string_storage;
+  if (error != GRPC_ERROR_NONE) {
+    google_rpc_Status* error_detail =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_error_detail(
+            request, arena.ptr());
+    // Hard-code INVALID_ARGUMENT as the status code, as for
+    // CreateAdsRequest().
+    google_rpc_Status_set_code(error_detail, GRPC_STATUS_INVALID_ARGUMENT);
+    error_string_storage = grpc_error_std_string(error);
+    upb_strview error_description = StdStringToUpbString(error_string_storage);
+    google_rpc_Status_set_message(error_detail, error_description);
+    GRPC_ERROR_UNREF(error);
+  }
+  // Populate node.
+  if (populate_node) {
+    envoy_config_core_v3_Node* node_msg =
+        envoy_service_discovery_v3_DeltaDiscoveryRequest_mutable_node(
+            request, arena.ptr());
+    PopulateNode(context, node_, build_version_, user_agent_name_,
+                 user_agent_version_, node_msg);
+  }
+  // Add the subscription changes.
+  for (const std::string& resource_name : subscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_subscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  for (const std::string& resource_name : unsubscribe) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_add_resource_names_unsubscribe(
+        request, StdStringToUpbString(resource_name), arena.ptr());
+  }
+  for (const auto& p : initial_versions) {
+    envoy_service_discovery_v3_DeltaDiscoveryRequest_initial_resource_versions_set(
+        request, StdStringToUpbString(p.first),
+        StdStringToUpbString(p.second), arena.ptr());
+  }
+  MaybeLogDeltaDiscoveryRequest(context, request);
+  size_t output_length;
+  char* output = envoy_service_discovery_v3_DeltaDiscoveryRequest_serialize(
+      request, arena.ptr(), &output_length);
+  return grpc_slice_from_copied_buffer(output, output_length);
+}
+
+absl::Status XdsApi::ParseDeltaAdsResponse(
+    const XdsBootstrap::XdsServer& server, const grpc_slice& encoded_response,
+    AdsResponseParserInterface* parser) {
+  upb::Arena arena = MakeAdsResponseArena(GRPC_SLICE_LENGTH(encoded_response));
+  const XdsEncodingContext context = {client_,
+                                      tracer_,
+                                      symtab_->ptr(),
+                                      arena.ptr(),
+                                      server.ShouldUseV3(),
+                                      certificate_provider_definition_map_};
+  // Decode the response.
+  const envoy_service_discovery_v3_DeltaDiscoveryResponse* response =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_parse(
+          reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(encoded_response)),
+          GRPC_SLICE_LENGTH(encoded_response), arena.ptr());
+  // If decoding fails, report a fatal error and return.
+  if (response == nullptr) {
+    return absl::InvalidArgumentError("Can't decode DeltaDiscoveryResponse.");
+  }
+  MaybeLogDeltaDiscoveryResponse(context, response);
+  // Report the type_url, version, nonce, and number of resources to the parser.
+  AdsResponseParserInterface::AdsResponseFields fields;
+  fields.type_url = std::string(absl::StripPrefix(
+      UpbStringToAbsl(
+          envoy_service_discovery_v3_DeltaDiscoveryResponse_type_url(response)),
+      "type.googleapis.com/"));
+  fields.version = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_system_version_info(
+          response));
+  fields.nonce = UpbStringToStdString(
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_nonce(response));
+  size_t num_resources;
+  const envoy_service_discovery_v3_Resource* const* resources =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_resources(
+          response, &num_resources);
+  fields.num_resources = num_resources;
+  absl::Status status = parser->ProcessAdsResponseFields(std::move(fields));
+  if (!status.ok()) return status;
+  // Process each resource.
+  for (size_t i = 0; i < num_resources; ++i) {
+    const google_protobuf_Any* any =
+        envoy_service_discovery_v3_Resource_resource(resources[i]);
+    // A resource without a body is of no use to us; let the parser report
+    // it as undecodable.
+    absl::string_view type_url;
+    absl::string_view serialized_resource;
+    if (any != nullptr) {
+      type_url =
+          absl::StripPrefix(UpbStringToAbsl(google_protobuf_Any_type_url(any)),
+                            "type.googleapis.com/");
+      serialized_resource = UpbStringToAbsl(google_protobuf_Any_value(any));
+    }
+    parser->ParseDeltaResource(
+        context, i,
+        UpbStringToAbsl(
+            envoy_service_discovery_v3_Resource_version(resources[i])),
+        type_url, serialized_resource);
+  }
+  // Process the removed resources.
+  size_t num_removed;
+  const upb_strview* removed =
+      envoy_service_discovery_v3_DeltaDiscoveryResponse_removed_resources(
+          response, &num_removed);
+  for (size_t i = 0; i < num_removed; ++i) {
+    parser->RemoveResource(UpbStringToAbsl(removed[i]));
+  }
+  return absl::OkStatus();
+}
+
+namespace {
+
 void MaybeLogLrsRequest(
     const XdsEncodingContext& context,
     const envoy_service_load_stats_v3_LoadStatsRequest* request) {
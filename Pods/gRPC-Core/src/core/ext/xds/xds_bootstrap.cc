@@ -141,6 +141,10 @@ bool XdsBootstrap::XdsServer::ShouldUseV3() const {
   return server_features.find("xds_v3") != server_features.end();
 }
 
+bool XdsBootstrap::XdsServer::ShouldUseDelta() const {
+  return server_features.find("xds_delta") != server_features.end();
+}
+
 //
 // XdsBootstrap
 //
@@ -69,6 +69,9 @@ class XdsBootstrap {
     }
 
     bool ShouldUseV3() const;
+    // Whether to use the incremental (delta) variant of ADS, enabled by
+    // the "xds_delta" server feature.
+    bool ShouldUseDelta() const;
   };
 
   struct Authority {
@@ -22,7 +22,11 @@
 #include <limits.h>
 #include <string.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include "absl/container/inlined_vector.h"
+#include "absl/hash/hash.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
 #include "absl/strings/string_view.h"
@@ -184,6 +188,11 @@ class XdsClient::ChannelState::AdsCallState
   bool HasSubscribedResources() const;
 
  private:
+  // Whether this call uses the incremental (delta) variant of ADS, where
+  // requests carry only the changes to the subscription and responses
+  // carry only the changed and removed resources.
+  bool delta() const { return chand()->server_.ShouldUseDelta(); }
+
   class AdsResponseParser : public XdsApi::AdsResponseParserInterface {
    public:
     struct Result {
@@ -208,11 +217,41 @@ class XdsClient::ChannelState::AdsCallState
                        absl::string_view serialized_resource) override
         ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
+    void ParseDeltaResource(const XdsEncodingContext& context, size_t idx,
+                            absl::string_view version,
+                            absl::string_view type_url,
+                            absl::string_view serialized_resource) override
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+    void RemoveResource(absl::string_view resource_name) override
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     Result TakeResult() { return std::move(result_); }
 
    private:
     XdsClient* xds_client() const { return ads_call_state_->xds_client(); }
 
+    void ParseResourceWithVersion(const XdsEncodingContext& context,
+                                  size_t idx, absl::string_view type_url,
+                                  absl::string_view serialized_resource,
+                                  const std::string& version)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+    // Cancels the does-not-exist timer of the resource, if any.
+    void MaybeCancelTimer(const XdsResourceName& resource_name);
+
+    // If serialized_resource is exactly the resource we last accepted,
+    // handles it as an unchanged resource and returns true, without decoding
+    // or validating it again.
+    bool MaybeSkipUnchangedResource(absl::string_view serialized_resource,
+                                    bool is_v2)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
+    // Returns the cached state of the resource, or null if we are not
+    // subscribed to it.
+    ResourceState* FindResourceState(const XdsResourceName& resource_name)
+        ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+
     AdsCallState* ads_call_state_;
     const grpc_millis update_time_ = ExecCtx::Get()->Now();
     Result result_;
@@ -312,10 +351,21 @@ class XdsClient::ChannelState::AdsCallState
     std::map<std::string /*authority*/,
              std::map<XdsResourceKey, OrphanablePtr<ResourceTimer>>>
         subscribed_resources;
+
+    // For delta ADS: the full names of the resources the server has been
+    // told about on this call, and whether a request has been sent yet.
+    std::set<std::string> delta_resource_names;
+    bool sent_delta_request = false;
   };
 
   void SendMessageLocked(const XdsResourceType* type)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  void SendDeltaMessageLocked(const XdsResourceType* type,
+                              ResourceTypeState* state)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
+  // Sends the serialized request, taking ownership of it.
+  void StartSendMessageLocked(grpc_slice request_payload_slice)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_);
 
   static void OnRequestSent(void* arg, grpc_error_handle error);
   void OnRequestSentLocked(grpc_error_handle error)
@@ -789,9 +839,115 @@ void UpdateResourceMetadataNacked(const std::string& version,
 
 }  // namespace
 
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    MaybeCancelTimer(const XdsResourceName& resource_name) {
+  auto timer_it = ads_call_state_->state_map_.find(result_.type);
+  if (timer_it != ads_call_state_->state_map_.end()) {
+    auto it =
+        timer_it->second.subscribed_resources.find(resource_name.authority);
+    if (it != timer_it->second.subscribed_resources.end()) {
+      auto res_it = it->second.find(resource_name.key);
+      if (res_it != it->second.end()) {
+        res_it->second->MaybeCancelTimer();
+      }
+    }
+  }
+}
+
+XdsClient::ResourceState*
+XdsClient::ChannelState::AdsCallState::AdsResponseParser::FindResourceState(
+    const XdsResourceName& resource_name) {
+  // Lookup the authority in the cache.
+  auto authority_it =
+      xds_client()->authority_state_map_.find(resource_name.authority);
+  if (authority_it == xds_client()->authority_state_map_.end()) {
+    return nullptr;
+  }
+  // Found authority, so look up type.
+  AuthorityState& authority_state = authority_it->second;
+  auto type_it = authority_state.resource_map.find(result_.type);
+  if (type_it == authority_state.resource_map.end()) return nullptr;
+  auto& type_map = type_it->second;
+  // Found type, so look up resource key.
+  auto it = type_map.find(resource_name.key);
+  if (it == type_map.end()) return nullptr;
+  return &it->second;
+}
+
+bool XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    MaybeSkipUnchangedResource(absl::string_view serialized_resource,
+                               bool is_v2) {
+  auto& accepted_resources = xds_client()->accepted_resources_;
+  auto it = accepted_resources.find(
+      {result_.type, absl::Hash<absl::string_view>()(serialized_resource)});
+  if (it == accepted_resources.end() || it->second.is_v2 != is_v2) {
+    return false;
+  }
+  const XdsResourceName& resource_name = it->second.name;
+  ResourceState* resource_state = FindResourceState(resource_name);
+  if (resource_state == nullptr || resource_state->resource == nullptr ||
+      resource_state->meta.serialized_proto != serialized_resource) {
+    return false;
+  }
+  // Same as a resource that decodes to the one we have.
+  MaybeCancelTimer(resource_name);
+  if (result_.type->AllResourcesRequiredInSotW()) {
+    result_.resources_seen[resource_name.authority].insert(resource_name.key);
+  }
+  result_.have_valid_resources = true;
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+    gpr_log(GPR_INFO,
+            "[xds_client %p] %s resource %s unchanged since last accepted, "
+            "ignoring.",
+            xds_client(), result_.type_url.c_str(),
+            resource_name.key.id.c_str());
+  }
+  return true;
+}
+
 void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     const XdsEncodingContext& context, size_t idx, absl::string_view type_url,
     absl::string_view serialized_resource) {
+  ParseResourceWithVersion(context, idx, type_url, serialized_resource,
+                           result_.version);
+}
+
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    ParseDeltaResource(const XdsEncodingContext& context, size_t idx,
+                       absl::string_view version, absl::string_view type_url,
+                       absl::string_view serialized_resource) {
+  ParseResourceWithVersion(context, idx, type_url, serialized_resource,
+                           std::string(version));
+}
+
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::RemoveResource(
+    absl::string_view resource_name) {
+  auto name = XdsClient::ParseXdsResourceName(resource_name, result_.type);
+  if (!name.ok()) {
+    result_.errors.emplace_back(
+        absl::StrCat("removed resource: Cannot parse xDS resource name \"",
+                     resource_name, "\""));
+    return;
+  }
+  MaybeCancelTimer(*name);
+  ResourceState* resource_state = FindResourceState(*name);
+  if (resource_state == nullptr) return;
+  // Unlike a state-of-the-world response, a delta response names the
+  // removed resources explicitly, so this tells us that the resource does
+  // not exist even if we have not received it yet.
+  result_.have_valid_resources = true;
+  resource_state->resource.reset();
+  resource_state->meta.client_status =
+      XdsApi::ResourceMetadata::DOES_NOT_EXIST;
+  Notifier::ScheduleNotifyWatchersOnResourceDoesNotExistInWorkSerializer(
+      xds_client(), resource_state->watchers, DEBUG_LOCATION);
+}
+
+void XdsClient::ChannelState::AdsCallState::AdsResponseParser::
+    ParseResourceWithVersion(const XdsEncodingContext& context, size_t idx,
+                             absl::string_view type_url,
+                             absl::string_view serialized_resource,
+                             const std::string& version) {
   // Check the type_url of the resource.
   bool is_v2 = false;
   if (!result_.type->IsType(type_url, &is_v2)) {
@@ -800,6 +956,7 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
                      type_url, " (should be ", result_.type_url, ")"));
     return;
   }
+  if (MaybeSkipUnchangedResource(serialized_resource, is_v2)) return;
   // Parse the resource.
   absl::StatusOr<XdsResourceType::DecodeResult> result =
       result_.type->Decode(context, serialized_resource, is_v2);
@@ -818,36 +975,12 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     return;
   }
   // Cancel resource-does-not-exist timer, if needed.
-  auto timer_it = ads_call_state_->state_map_.find(result_.type);
-  if (timer_it != ads_call_state_->state_map_.end()) {
-    auto it =
-        timer_it->second.subscribed_resources.find(resource_name->authority);
-    if (it != timer_it->second.subscribed_resources.end()) {
-      auto res_it = it->second.find(resource_name->key);
-      if (res_it != it->second.end()) {
-        res_it->second->MaybeCancelTimer();
-      }
-    }
-  }
-  // Lookup the authority in the cache.
-  auto authority_it =
-      xds_client()->authority_state_map_.find(resource_name->authority);
-  if (authority_it == xds_client()->authority_state_map_.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  // Found authority, so look up type.
-  AuthorityState& authority_state = authority_it->second;
-  auto type_it = authority_state.resource_map.find(result_.type);
-  if (type_it == authority_state.resource_map.end()) {
-    return;  // Skip resource -- we don't have a subscription for it.
-  }
-  auto& type_map = type_it->second;
-  // Found type, so look up resource key.
-  auto it = type_map.find(resource_name->key);
-  if (it == type_map.end()) {
+  MaybeCancelTimer(*resource_name);
+  ResourceState* resource_state_ptr = FindResourceState(*resource_name);
+  if (resource_state_ptr == nullptr) {
     return;  // Skip resource -- we don't have a subscription for it.
   }
-  ResourceState& resource_state = it->second;
+  ResourceState& resource_state = *resource_state_ptr;
   // If needed, record that we've seen this resource.
   if (result_.type->AllResourcesRequiredInSotW()) {
     result_.resources_seen[resource_name->authority].insert(resource_name->key);
@@ -864,7 +997,7 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
                 "invalid resource: ", result->resource.status().ToString())),
             GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE),
         DEBUG_LOCATION);
-    UpdateResourceMetadataNacked(result_.version,
+    UpdateResourceMetadataNacked(version,
                                  result->resource.status().ToString(),
                                  update_time_, &resource_state.meta);
     return;
@@ -883,9 +1016,14 @@ void XdsClient::ChannelState::AdsCallState::AdsResponseParser::ParseResource(
     return;
   }
   // Update the resource state.
+  xds_client()->ForgetAcceptedResourceLocked(
+      result_.type, resource_state.meta.serialized_proto);
+  xds_client()->accepted_resources_[{
+      result_.type, absl::Hash<absl::string_view>()(serialized_resource)}] = {
+      *resource_name, is_v2};
   resource_state.resource = std::move(*result->resource);
   resource_state.meta = CreateResourceMetadataAcked(
-      std::string(serialized_resource), result_.version, update_time_);
+      std::string(serialized_resource), version, update_time_);
   // Notify watchers.
   auto& watchers_list = resource_state.watchers;
   auto* value =
@@ -917,12 +1055,20 @@ XdsClient::ChannelState::AdsCallState::AdsCallState(
   // the polling entities from client_channel.
   GPR_ASSERT(xds_client() != nullptr);
   // Create a call with the specified method name.
-  const char* method =
-      chand()->server_.ShouldUseV3()
-          ? "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
-            "StreamAggregatedResources"
-          : "/envoy.service.discovery.v2.AggregatedDiscoveryService/"
-            "StreamAggregatedResources";
+  const char* method;
+  if (delta()) {
+    method = chand()->server_.ShouldUseV3()
+                 ? "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+                   "DeltaAggregatedResources"
+                 : "/envoy.service.discovery.v2.AggregatedDiscoveryService/"
+                   "DeltaAggregatedResources";
+  } else {
+    method = chand()->server_.ShouldUseV3()
+                 ? "/envoy.service.discovery.v3.AggregatedDiscoveryService/"
+                   "StreamAggregatedResources"
+                 : "/envoy.service.discovery.v2.AggregatedDiscoveryService/"
+                   "StreamAggregatedResources";
+  }
   call_ = grpc_channel_create_pollset_set_call(
       chand()->channel_, nullptr, GRPC_PROPAGATE_DEFAULTS,
       xds_client()->interested_parties_,
@@ -1039,6 +1185,10 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
     return;
   }
   auto& state = state_map_[type];
+  if (delta()) {
+    SendDeltaMessageLocked(type, &state);
+    return;
+  }
   grpc_slice request_payload_slice;
   request_payload_slice = xds_client()->api_.CreateAdsRequest(
       chand()->server_,
@@ -1058,6 +1208,74 @@ void XdsClient::ChannelState::AdsCallState::SendMessageLocked(
   }
   GRPC_ERROR_UNREF(state.error);
   state.error = GRPC_ERROR_NONE;
+  StartSendMessageLocked(request_payload_slice);
+}
+
+void XdsClient::ChannelState::AdsCallState::SendDeltaMessageLocked(
+    const XdsResourceType* type, ResourceTypeState* state)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_) {
+  // Tell the server only how the subscription changed since the last
+  // request on this call.
+  std::vector<std::string> names = ResourceNamesForRequest(type);
+  std::set<std::string> resource_names(names.begin(), names.end());
+  std::vector<std::string> subscribe;
+  std::set_difference(resource_names.begin(), resource_names.end(),
+                      state->delta_resource_names.begin(),
+                      state->delta_resource_names.end(),
+                      std::back_inserter(subscribe));
+  std::vector<std::string> unsubscribe;
+  std::set_difference(state->delta_resource_names.begin(),
+                      state->delta_resource_names.end(),
+                      resource_names.begin(), resource_names.end(),
+                      std::back_inserter(unsubscribe));
+  // On the first request for this type, report the versions we already
+  // have cached from an earlier call, so that the server need not resend
+  // the resources that did not change.
+  std::map<std::string, std::string> initial_versions;
+  if (!state->sent_delta_request) {
+    for (const auto& a : state->subscribed_resources) {
+      const std::string& authority = a.first;
+      auto authority_it = xds_client()->authority_state_map_.find(authority);
+      if (authority_it == xds_client()->authority_state_map_.end()) continue;
+      auto type_it = authority_it->second.resource_map.find(type);
+      if (type_it == authority_it->second.resource_map.end()) continue;
+      for (const auto& r : a.second) {
+        auto it = type_it->second.find(r.first);
+        if (it == type_it->second.end() || it->second.resource == nullptr ||
+            it->second.meta.version.empty()) {
+          continue;
+        }
+        initial_versions[XdsClient::ConstructFullXdsResourceName(
+            authority, type->type_url(), r.first)] = it->second.meta.version;
+      }
+    }
+  }
+  grpc_slice request_payload_slice = xds_client()->api_.CreateDeltaAdsRequest(
+      chand()->server_,
+      chand()->server_.ShouldUseV3() ? type->type_url() : type->v2_type_url(),
+      state->nonce, subscribe, unsubscribe, initial_versions,
+      GRPC_ERROR_REF(state->error), !sent_initial_message_);
+  sent_initial_message_ = true;
+  state->sent_delta_request = true;
+  state->delta_resource_names = std::move(resource_names);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_xds_client_trace)) {
+    gpr_log(GPR_INFO,
+            "[xds_client %p] xds server %s: sending delta ADS request: "
+            "type=%s subscribe=%" PRIuPTR " unsubscribe=%" PRIuPTR
+            " nonce=%s error=%s",
+            xds_client(), chand()->server_.server_uri.c_str(),
+            std::string(type->type_url()).c_str(), subscribe.size(),
+            unsubscribe.size(), state->nonce.c_str(),
+            grpc_error_std_string(state->error).c_str());
+  }
+  GRPC_ERROR_UNREF(state->error);
+  state->error = GRPC_ERROR_NONE;
+  StartSendMessageLocked(request_payload_slice);
+}
+
+void XdsClient::ChannelState::AdsCallState::StartSendMessageLocked(
+    grpc_slice request_payload_slice)
+    ABSL_EXCLUSIVE_LOCKS_REQUIRED(&XdsClient::mu_) {
   // Create message payload.
   send_message_payload_ =
       grpc_raw_byte_buffer_create(&request_payload_slice, 1);
@@ -1170,8 +1388,11 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
   recv_message_payload_ = nullptr;
   // Parse and validate the response.
   AdsResponseParser parser(this);
-  absl::Status status = xds_client()->api_.ParseAdsResponse(
-      chand()->server_, response_slice, &parser);
+  absl::Status status =
+      delta() ? xds_client()->api_.ParseDeltaAdsResponse(
+                    chand()->server_, response_slice, &parser)
+              : xds_client()->api_.ParseAdsResponse(chand()->server_,
+                                                    response_slice, &parser);
   grpc_slice_unref_internal(response_slice);
   if (!status.ok()) {
     // Ignore unparsable response.
@@ -1200,8 +1421,9 @@ bool XdsClient::ChannelState::AdsCallState::OnResponseReceivedLocked() {
           GRPC_ERROR_CREATE_FROM_CPP_STRING(std::move(error)),
           GRPC_ERROR_INT_GRPC_STATUS, GRPC_STATUS_UNAVAILABLE);
     }
-    // Delete resources not seen in update if needed.
-    if (result.type->AllResourcesRequiredInSotW()) {
+    // Delete resources not seen in update if needed.  Delta responses
+    // carry only the changed resources and name the removed ones.
+    if (!delta() && result.type->AllResourcesRequiredInSotW()) {
       for (auto& a : xds_client()->authority_state_map_) {
         const std::string& authority = a.first;
         AuthorityState& authority_state = a.second;
@@ -1962,6 +2184,7 @@ void XdsClient::CancelResourceWatch(const XdsResourceType* type,
   if (resource_state.watchers.empty()) {
     authority_state.channel_state->UnsubscribeLocked(type, *resource_name,
                                                      delay_unsubscription);
+    ForgetAcceptedResourceLocked(type, resource_state.meta.serialized_proto);
     type_map.erase(resource_it);
     if (type_map.empty()) {
       authority_state.resource_map.erase(type_it);
@@ -1993,6 +2216,13 @@ const XdsResourceType* XdsClient::GetResourceTypeLocked(
   return nullptr;
 }
 
+void XdsClient::ForgetAcceptedResourceLocked(
+    const XdsResourceType* type, absl::string_view serialized_resource) {
+  if (serialized_resource.empty()) return;
+  accepted_resources_.erase(
+      {type, absl::Hash<absl::string_view>()(serialized_resource)});
+}
+
 absl::StatusOr<XdsClient::XdsResourceName> XdsClient::ParseXdsResourceName(
     absl::string_view name, const XdsResourceType* type) {
   // Old-style names use the empty string for authority.
@@ -274,6 +274,10 @@ class XdsClient : public DualRefCounted<XdsClient> {
       absl::string_view authority, absl::string_view resource_type,
       const XdsResourceKey& key);
 
+  void ForgetAcceptedResourceLocked(const XdsResourceType* type,
+                                    absl::string_view serialized_resource)
+      ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   XdsApi::ClusterLoadReportMap BuildLoadReportSnapshotLocked(
       bool send_all_clusters, const std::set<std::string>& clusters)
       ABSL_EXCLUSIVE_LOCKS_REQUIRED(mu_);
@@ -305,6 +309,16 @@ class XdsClient : public DualRefCounted<XdsClient> {
   std::map<std::string /*authority*/, AuthorityState> authority_state_map_
       ABSL_GUARDED_BY(mu_);
 
+  // Names of accepted resources by a hash of their serialized form, so that a
+  // resource resent unchanged can be recognized without decoding it.
+  struct AcceptedResource {
+    XdsResourceName name;
+    bool is_v2;
+  };
+  std::map<std::pair<const XdsResourceType*, size_t /*hash*/>,
+           AcceptedResource>
+      accepted_resources_ ABSL_GUARDED_BY(mu_);
+
   // Load report data.
   std::map<
       std::pair<std::string /*cluster_name*/, std::string /*eds_service_name*/>,
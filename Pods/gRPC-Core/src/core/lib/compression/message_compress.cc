@@ -91,20 +91,37 @@ static void* zalloc_gpr(void* /*opaque*/, unsigned int items,
 
 static void zfree_gpr(void* /*opaque*/, void* address) { gpr_free(address); }
 
-static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
-                         int gzip) {
-  z_stream zs;
+static void zlib_deflate_init(z_stream* zs, int gzip) {
+  int r;
+  memset(zs, 0, sizeof(*zs));
+  zs->zalloc = zalloc_gpr;
+  zs->zfree = zfree_gpr;
+  r = deflateInit2(zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
+                   8, Z_DEFAULT_STRATEGY);
+  GPR_ASSERT(r == Z_OK);
+}
+
+static void zlib_inflate_init(z_stream* zs, int gzip) {
+  int r;
+  memset(zs, 0, sizeof(*zs));
+  zs->zalloc = zalloc_gpr;
+  zs->zfree = zfree_gpr;
+  r = inflateInit2(zs, 15 | (gzip ? 16 : 0));
+  GPR_ASSERT(r == Z_OK);
+}
+
+/* run the initialized (or just reset) stream 'zs' over 'input'.
+   On failure, output is unchanged. */
+static int zlib_run(z_stream* zs, grpc_slice_buffer* input,
+                    grpc_slice_buffer* output,
+                    int (*flate)(z_stream* zs, int flush)) {
   int r;
   size_t i;
   size_t count_before = output->count;
   size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = deflateInit2(&zs, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 15 | (gzip ? 16 : 0),
-                   8, Z_DEFAULT_STRATEGY);
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, deflate) && output->length < input->length;
+  r = zlib_body(zs, input, output, flate);
+  /* compressing only succeeds if it saves some bytes */
+  if (r && flate == deflate) r = output->length < input->length;
   if (!r) {
     for (i = count_before; i < output->count; i++) {
       grpc_slice_unref_internal(output->slices[i]);
@@ -112,6 +129,15 @@ static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
     output->count = count_before;
     output->length = length_before;
   }
+  return r;
+}
+
+static int zlib_compress(grpc_slice_buffer* input, grpc_slice_buffer* output,
+                         int gzip) {
+  z_stream zs;
+  int r;
+  zlib_deflate_init(&zs, gzip);
+  r = zlib_run(&zs, input, output, deflate);
   deflateEnd(&zs);
   return r;
 }
@@ -120,22 +146,8 @@ static int zlib_decompress(grpc_slice_buffer* input, grpc_slice_buffer* output,
                            int gzip) {
   z_stream zs;
   int r;
-  size_t i;
-  size_t count_before = output->count;
-  size_t length_before = output->length;
-  memset(&zs, 0, sizeof(zs));
-  zs.zalloc = zalloc_gpr;
-  zs.zfree = zfree_gpr;
-  r = inflateInit2(&zs, 15 | (gzip ? 16 : 0));
-  GPR_ASSERT(r == Z_OK);
-  r = zlib_body(&zs, input, output, inflate);
-  if (!r) {
-    for (i = count_before; i < output->count; i++) {
-      grpc_slice_unref_internal(output->slices[i]);
-    }
-    output->count = count_before;
-    output->length = length_before;
-  }
+  zlib_inflate_init(&zs, gzip);
+  r = zlib_run(&zs, input, output, inflate);
   inflateEnd(&zs);
   return r;
 }
@@ -190,3 +202,92 @@ int grpc_msg_decompress(grpc_compression_algorithm algorithm,
   gpr_log(GPR_ERROR, "invalid compression algorithm %d", algorithm);
   return 0;
 }
+
+namespace grpc_core {
+
+struct MessageCompressionContext::ZlibStream {
+  z_stream zs;
+  bool gzip;
+};
+
+MessageCompressionContext::~MessageCompressionContext() {
+  if (deflate_ != nullptr) {
+    deflateEnd(&deflate_->zs);
+    delete deflate_;
+  }
+  if (inflate_ != nullptr) {
+    inflateEnd(&inflate_->zs);
+    delete inflate_;
+  }
+}
+
+MessageCompressionContext::ZlibStream*
+MessageCompressionContext::DeflateStream(bool gzip) {
+  if (deflate_ != nullptr && deflate_->gzip != gzip) {
+    deflateEnd(&deflate_->zs);
+    delete deflate_;
+    deflate_ = nullptr;
+  }
+  if (deflate_ == nullptr) {
+    deflate_ = new ZlibStream;
+    deflate_->gzip = gzip;
+    zlib_deflate_init(&deflate_->zs, gzip);
+  } else {
+    // Also clears any error left over from the previous message.
+    deflateReset(&deflate_->zs);
+  }
+  return deflate_;
+}
+
+MessageCompressionContext::ZlibStream*
+MessageCompressionContext::InflateStream(bool gzip) {
+  if (inflate_ != nullptr && inflate_->gzip != gzip) {
+    inflateEnd(&inflate_->zs);
+    delete inflate_;
+    inflate_ = nullptr;
+  }
+  if (inflate_ == nullptr) {
+    inflate_ = new ZlibStream;
+    inflate_->gzip = gzip;
+    zlib_inflate_init(&inflate_->zs, gzip);
+  } else {
+    inflateReset(&inflate_->zs);
+  }
+  return inflate_;
+}
+
+int MessageCompressionContext::Compress(grpc_compression_algorithm algorithm,
+                                        grpc_slice_buffer* input,
+                                        grpc_slice_buffer* output) {
+  bool gzip;
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+      gzip = false;
+      break;
+    case GRPC_COMPRESS_GZIP:
+      gzip = true;
+      break;
+    default:
+      return grpc_msg_compress(algorithm, input, output);
+  }
+  if (!zlib_run(&DeflateStream(gzip)->zs, input, output, deflate)) {
+    copy(input, output);
+    return 0;
+  }
+  return 1;
+}
+
+int MessageCompressionContext::Decompress(grpc_compression_algorithm algorithm,
+                                          grpc_slice_buffer* input,
+                                          grpc_slice_buffer* output) {
+  switch (algorithm) {
+    case GRPC_COMPRESS_DEFLATE:
+      return zlib_run(&InflateStream(false)->zs, input, output, inflate);
+    case GRPC_COMPRESS_GZIP:
+      return zlib_run(&InflateStream(true)->zs, input, output, inflate);
+    default:
+      return grpc_msg_decompress(algorithm, input, output);
+  }
+}
+
+}  // namespace grpc_core
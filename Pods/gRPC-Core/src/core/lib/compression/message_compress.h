@@ -37,4 +37,39 @@ int grpc_msg_compress(grpc_compression_algorithm algorithm,
 int grpc_msg_decompress(grpc_compression_algorithm algorithm,
                         grpc_slice_buffer* input, grpc_slice_buffer* output);
 
+namespace grpc_core {
+
+// Compression state kept across the messages of one stream. Setting up a zlib
+// stream allocates and initializes its window and tables (over 256KB for
+// deflate), which dominates the cost of compressing a small message: this
+// sets the streams up on first use, and only resets them for later messages.
+// Results are the same as grpc_msg_compress() and grpc_msg_decompress()'s.
+class MessageCompressionContext {
+ public:
+  MessageCompressionContext() = default;
+  ~MessageCompressionContext();
+
+  MessageCompressionContext(const MessageCompressionContext&) = delete;
+  MessageCompressionContext& operator=(const MessageCompressionContext&) =
+      delete;
+
+  // As grpc_msg_compress().
+  int Compress(grpc_compression_algorithm algorithm, grpc_slice_buffer* input,
+               grpc_slice_buffer* output);
+  // As grpc_msg_decompress().
+  int Decompress(grpc_compression_algorithm algorithm,
+                 grpc_slice_buffer* input, grpc_slice_buffer* output);
+
+ private:
+  struct ZlibStream;
+
+  ZlibStream* DeflateStream(bool gzip);
+  ZlibStream* InflateStream(bool gzip);
+
+  ZlibStream* deflate_ = nullptr;
+  ZlibStream* inflate_ = nullptr;
+};
+
+}  // namespace grpc_core
+
 #endif /* GRPC_CORE_LIB_COMPRESSION_MESSAGE_COMPRESS_H */
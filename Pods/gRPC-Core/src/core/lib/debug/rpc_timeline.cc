@@ -0,0 +1,136 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/debug/rpc_timeline.h"
+
+#include <algorithm>
+
+#include <grpc/grpc.h>
+#include <grpc/support/cpu.h>
+
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_rpc_timeline_sampling_period, 1000,
+    "Record the timeline of one in this many client calls (on each thread). 0 "
+    "disables sampling.");
+
+namespace grpc_core {
+
+namespace {
+
+// Timelines kept per CPU until they're collected
+constexpr size_t kRingSize = 64;
+
+struct Ring {
+  Mutex mu;
+  grpc_rpc_timeline timelines[kRingSize] ABSL_GUARDED_BY(mu);
+  // Where the next timeline is written
+  size_t next ABSL_GUARDED_BY(mu) = 0;
+  // How many timelines (up to next) are not yet collected
+  size_t count ABSL_GUARDED_BY(mu) = 0;
+};
+
+size_t NumRings() {
+  static const size_t num_rings = std::max(1u, gpr_cpu_num_cores());
+  return num_rings;
+}
+
+Ring* Rings() {
+  static Ring* rings = new Ring[NumRings()];
+  return rings;
+}
+
+std::atomic<uint32_t>& SamplingPeriod() {
+  static std::atomic<uint32_t> period(static_cast<uint32_t>(
+      std::max(0, GPR_GLOBAL_CONFIG_GET(grpc_rpc_timeline_sampling_period))));
+  return period;
+}
+
+// Counts down the calls created on this thread until the next one sampled.
+GPR_THREAD_LOCAL(uint32_t) g_calls_until_sample;
+
+}  // namespace
+
+bool RpcTimeline::ShouldSample() {
+  const uint32_t period = SamplingPeriod().load(std::memory_order_relaxed);
+  if (period == 0) return false;
+  uint32_t calls_until_sample = g_calls_until_sample;
+  if (calls_until_sample == 0 || calls_until_sample > period) {
+    calls_until_sample = period;
+  }
+  g_calls_until_sample = --calls_until_sample;
+  return calls_until_sample == 0;
+}
+
+void RpcTimeline::SetSamplingPeriod(uint32_t period) {
+  SamplingPeriod().store(period, std::memory_order_relaxed);
+}
+
+void RpcTimeline::Record(grpc_rpc_timeline_event event) {
+  gpr_timespec elapsed =
+      gpr_cycle_counter_sub(gpr_get_cycle_counter(), start_time_);
+  int64_t expected = -1;
+  elapsed_ns_[event].compare_exchange_strong(expected, ToNanos(elapsed),
+                                             std::memory_order_relaxed);
+}
+
+void RpcTimeline::Get(grpc_rpc_timeline* timeline) const {
+  timeline->start_unix_ns = start_unix_ns_;
+  for (int i = 0; i < GRPC_RPC_TIMELINE_EVENT_COUNT; ++i) {
+    timeline->elapsed_ns[i] = elapsed_ns_[i].load(std::memory_order_relaxed);
+  }
+}
+
+void RpcTimeline::Publish() const {
+  const unsigned cpu = ExecCtx::Get() != nullptr
+                           ? ExecCtx::Get()->starting_cpu()
+                           : gpr_cpu_current_cpu();
+  Ring& ring = Rings()[cpu % NumRings()];
+  MutexLock lock(&ring.mu);
+  Get(&ring.timelines[ring.next]);
+  ring.next = (ring.next + 1) % kRingSize;
+  ring.count = std::min(ring.count + 1, kRingSize);
+}
+
+size_t RpcTimeline::Collect(grpc_rpc_timeline* timelines,
+                            size_t max_timelines) {
+  size_t collected = 0;
+  for (size_t i = 0; i < NumRings() && collected < max_timelines; ++i) {
+    Ring& ring = Rings()[i];
+    MutexLock lock(&ring.mu);
+    // Oldest first
+    size_t index = (ring.next + kRingSize - ring.count) % kRingSize;
+    for (; ring.count > 0 && collected < max_timelines; --ring.count) {
+      timelines[collected++] = ring.timelines[index];
+      index = (index + 1) % kRingSize;
+    }
+  }
+  return collected;
+}
+
+}  // namespace grpc_core
+
+void grpc_rpc_timeline_set_sampling_period(uint32_t period) {
+  grpc_core::RpcTimeline::SetSamplingPeriod(period);
+}
+
+size_t grpc_rpc_timeline_collect(grpc_rpc_timeline* timelines,
+                                 size_t max_timelines) {
+  return grpc_core::RpcTimeline::Collect(timelines, max_timelines);
+}
@@ -0,0 +1,85 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_DEBUG_RPC_TIMELINE_H
+#define GRPC_CORE_LIB_DEBUG_RPC_TIMELINE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include <atomic>
+
+#include <grpc/impl/codegen/grpc_types.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/channel/context.h"
+#include "src/core/lib/gpr/time_precise.h"
+#include "src/core/lib/gprpp/global_config.h"
+
+GPR_GLOBAL_CONFIG_DECLARE_INT32(grpc_rpc_timeline_sampling_period);
+
+namespace grpc_core {
+
+// The times at which a sampled client call reached each
+// grpc_rpc_timeline_event. It lives in the call's arena, and is found by the
+// layers that record events through the call context
+// (GRPC_CONTEXT_RPC_TIMELINE); once the call is destroyed it is published to a
+// per-CPU ring buffer, from which grpc_rpc_timeline_collect() takes it.
+class RpcTimeline {
+ public:
+  explicit RpcTimeline(gpr_cycle_counter start_time)
+      : start_time_(start_time),
+        start_unix_ns_(ToNanos(gpr_now(GPR_CLOCK_REALTIME))) {
+    for (auto& elapsed_ns : elapsed_ns_) {
+      elapsed_ns.store(-1, std::memory_order_relaxed);
+    }
+  }
+
+  // Whether the call being created on this thread should be sampled.
+  static bool ShouldSample();
+  static void SetSamplingPeriod(uint32_t period);
+
+  // Record the current time for event, if it's the first time it's reached
+  // (later attempts of a retried call don't overwrite the first's).
+  void Record(grpc_rpc_timeline_event event);
+  // Record event for the call of context, if it's being sampled.
+  static void Record(const grpc_call_context_element* context,
+                     grpc_rpc_timeline_event event) {
+    auto* timeline =
+        static_cast<RpcTimeline*>(context[GRPC_CONTEXT_RPC_TIMELINE].value);
+    if (GPR_UNLIKELY(timeline != nullptr)) timeline->Record(event);
+  }
+
+  void Get(grpc_rpc_timeline* timeline) const;
+
+  // Copy the timeline to the ring buffer of the current CPU.
+  void Publish() const;
+  // Move up to max_timelines published timelines to timelines.
+  static size_t Collect(grpc_rpc_timeline* timelines, size_t max_timelines);
+
+ private:
+  static int64_t ToNanos(gpr_timespec ts) {
+    return ts.tv_sec * GPR_NS_PER_SEC + ts.tv_nsec;
+  }
+
+  const gpr_cycle_counter start_time_;
+  const int64_t start_unix_ns_;
+  std::atomic<int64_t> elapsed_ns_[GRPC_RPC_TIMELINE_EVENT_COUNT];
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_DEBUG_RPC_TIMELINE_H
@@ -32,6 +32,9 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "cqs_created",
     "client_channels_created",
     "client_subchannels_created",
+    "client_concurrency_limit",
+    "client_calls_concurrency_queued",
+    "client_calls_concurrency_rejected",
     "server_channels_created",
     "syscall_poll",
     "syscall_wait",
@@ -48,6 +51,8 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "syscall_read",
     "tcp_backup_pollers_created",
     "tcp_backup_poller_polls",
+    "tcp_zerocopy_copy_bytes_avoided",
+    "tcp_zerocopy_writes_copied",
     "http2_op_batches",
     "http2_op_cancel",
     "http2_op_send_initial_metadata",
@@ -120,6 +125,7 @@ const char* grpc_stats_counter_name[GRPC_STATS_COUNTER_COUNT] = {
     "executor_wakeup_initiated",
     "executor_queue_drained",
     "executor_push_retries",
+    "executor_closures_stolen",
     "server_requested_calls",
     "server_slowpath_requests_queued",
     "cq_ev_queue_trylock_failures",
@@ -132,6 +138,9 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of completion queues created",
     "Number of client channels created",
     "Number of client subchannels created",
+    "Sum of the current adaptive concurrency limits of all client channels",
+    "Number of client calls queued by an adaptive concurrency limit",
+    "Number of client calls failed by an adaptive concurrency limit",
     "Number of server channels created",
     "Number of polling syscalls (epoll_wait, poll, etc) made by this process",
     "Number of sleeping syscalls made by this process",
@@ -157,6 +166,9 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of read syscalls (or equivalent - eg recvmsg) made by this process",
     "Number of times a backup poller has been created (this can be expensive)",
     "Number of polls performed on the backup poller",
+    "Number of bytes that TCP zerocopy writes sent without the kernel copying "
+    "them",
+    "Number of TCP zerocopy writes whose data the kernel copied anyway",
     "Number of batches received by HTTP2 transport",
     "Number of cancelations received by HTTP2 transport",
     "Number of batches containing send initial metadata",
@@ -243,6 +255,8 @@ const char* grpc_stats_counter_doc[GRPC_STATS_COUNTER_COUNT] = {
     "Number of times an executor queue was drained",
     "Number of times we raced and were forced to retry pushing a closure to "
     "the executor",
+    "Number of closures that an idle executor thread stole from the queue of "
+    "another thread",
     "How many calls were requested (not necessarily received) by the server",
     "How many times was the server slow path taken (indicates too few "
     "outstanding requests)",
@@ -267,6 +281,7 @@ const char* grpc_stats_histogram_name[GRPC_STATS_HISTOGRAM_COUNT] = {
     "http2_send_trailing_metadata_per_write",
     "http2_send_flowctl_per_write",
     "server_cqs_checked",
+    "executor_queue_depth",
 };
 const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     "Initial size of the grpc_call arena created at call start",
@@ -284,6 +299,7 @@ const char* grpc_stats_histogram_doc[GRPC_STATS_HISTOGRAM_COUNT] = {
     // NOLINTNEXTLINE(bugprone-suspicious-missing-comma)
     "How many completion queues were checked looking for a CQ that had "
     "requested the incoming call",
+    "Number of closures waiting in an executor when another one is queued",
 };
 const int grpc_stats_table_0[65] = {
     0,      1,      2,      3,      4,     5,     7,     9,     11,    14,
@@ -663,17 +679,40 @@ void grpc_stats_inc_server_cqs_checked(int value) {
       GRPC_STATS_HISTOGRAM_SERVER_CQS_CHECKED,
       grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_8, 8));
 }
-const int grpc_stats_histo_buckets[13] = {64, 128, 64, 64, 64, 64, 64,
-                                          64, 64,  64, 64, 64, 8};
-const int grpc_stats_histo_start[13] = {0,   64,  192, 256, 320, 384, 448,
-                                        512, 576, 640, 704, 768, 832};
-const int* const grpc_stats_histo_bucket_boundaries[13] = {
+void grpc_stats_inc_executor_queue_depth(int value) {
+  value = grpc_core::Clamp(value, 0, 64);
+  if (value < 3) {
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH, value);
+    return;
+  }
+  union {
+    double dbl;
+    uint64_t uint;
+  } _val, _bkt;
+  _val.dbl = value;
+  if (_val.uint < 4625196817309499392ull) {
+    int bucket =
+        grpc_stats_table_9[((_val.uint - 4613937818241073152ull) >> 51)] + 3;
+    _bkt.dbl = grpc_stats_table_8[bucket];
+    bucket -= (_val.uint < _bkt.uint);
+    GRPC_STATS_INC_HISTOGRAM(GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH, bucket);
+    return;
+  }
+  GRPC_STATS_INC_HISTOGRAM(
+      GRPC_STATS_HISTOGRAM_EXECUTOR_QUEUE_DEPTH,
+      grpc_stats_histo_find_bucket_slow(value, grpc_stats_table_8, 8));
+}
+const int grpc_stats_histo_buckets[14] = {64, 128, 64, 64, 64, 64, 64,
+                                          64, 64,  64, 64, 64, 8,  8};
+const int grpc_stats_histo_start[14] = {0,   64,  192, 256, 320, 384, 448,
+                                        512, 576, 640, 704, 768, 832, 840};
+const int* const grpc_stats_histo_bucket_boundaries[14] = {
     grpc_stats_table_0, grpc_stats_table_2, grpc_stats_table_4,
     grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_4,
     grpc_stats_table_6, grpc_stats_table_4, grpc_stats_table_6,
     grpc_stats_table_6, grpc_stats_table_6, grpc_stats_table_6,
-    grpc_stats_table_8};
-void (*const grpc_stats_inc_histogram[13])(int x) = {
+    grpc_stats_table_8, grpc_stats_table_8};
+void (*const grpc_stats_inc_histogram[14])(int x) = {
     grpc_stats_inc_call_initial_size,
     grpc_stats_inc_poll_events_returned,
     grpc_stats_inc_tcp_write_size,
@@ -686,4 +725,5 @@ void (*const grpc_stats_inc_histogram[13])(int x) = {
     grpc_stats_inc_http2_send_message_per_write,
     grpc_stats_inc_http2_send_trailing_metadata_per_write,
     grpc_stats_inc_http2_send_flowctl_per_write,
-    grpc_stats_inc_server_cqs_checked};
+    grpc_stats_inc_server_cqs_checked,
+    grpc_stats_inc_executor_queue_depth};
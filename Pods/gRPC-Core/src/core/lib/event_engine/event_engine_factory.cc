@@ -13,15 +13,19 @@
 // limitations under the License.
 #include <grpc/support/port_platform.h>
 
+#include "absl/memory/memory.h"
+
 #include <grpc/event_engine/event_engine.h>
 
+#include "src/core/lib/event_engine/libuv_event_engine.h"
 #include "src/core/lib/gprpp/sync.h"
 
 namespace grpc_event_engine {
 namespace experimental {
 
 namespace {
-std::function<std::unique_ptr<EventEngine>()>* g_event_engine_factory = nullptr;
+const std::function<std::unique_ptr<EventEngine>()>* g_event_engine_factory =
+    nullptr;
 grpc_core::Mutex* g_mu = new grpc_core::Mutex();
 }  // namespace
 
@@ -31,7 +35,7 @@ EventEngine* GetDefaultEventEngine() {
 }
 
 void SetDefaultEventEngineFactory(
-    std::function<std::unique_ptr<EventEngine>()>* factory) {
+    const std::function<std::unique_ptr<EventEngine>()>* factory) {
   grpc_core::MutexLock lock(g_mu);
   g_event_engine_factory = factory;
 }
@@ -39,8 +43,7 @@ void SetDefaultEventEngineFactory(
 std::unique_ptr<EventEngine> CreateEventEngine() {
   grpc_core::MutexLock lock(g_mu);
   if (g_event_engine_factory == nullptr) {
-    // TODO(hork): call LibuvEventEngineFactory
-    abort();
+    return absl::make_unique<LibuvEventEngine>();
   }
   return (*g_event_engine_factory)();
 }
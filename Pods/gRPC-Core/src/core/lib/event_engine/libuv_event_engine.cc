@@ -0,0 +1,849 @@
+// Copyright 2021 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/event_engine/libuv_event_engine.h"
+
+#include <string.h>
+
+#include <algorithm>
+#include <string>
+
+#include "absl/memory/memory.h"
+#include "absl/status/status.h"
+#include "absl/status/statusor.h"
+#include "absl/strings/str_cat.h"
+#include "absl/synchronization/notification.h"
+
+#include <grpc/slice.h>
+#include <grpc/slice_buffer.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gprpp/host_port.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+
+namespace {
+
+// The engine whose loop callback is running on this thread, if any.
+GPR_THREAD_LOCAL(LibuvEventEngine*) g_current_engine;
+
+class CurrentEngineScope {
+ public:
+  explicit CurrentEngineScope(LibuvEventEngine* engine)
+      : previous_(g_current_engine) {
+    g_current_engine = engine;
+  }
+  ~CurrentEngineScope() { g_current_engine = previous_; }
+
+ private:
+  LibuvEventEngine* const previous_;
+};
+
+absl::Status UvError(const char* what, int err) {
+  return absl::UnavailableError(absl::StrCat(what, ": ", uv_strerror(err)));
+}
+
+uint64_t MillisUntil(absl::Time when) {
+  absl::Duration delay = when - absl::Now();
+  if (delay <= absl::ZeroDuration()) return 0;
+  return static_cast<uint64_t>(
+      absl::ToInt64Milliseconds(absl::Ceil(delay, absl::Milliseconds(1))));
+}
+
+EventEngine::ResolvedAddress GetAddress(
+    int (*getname)(const uv_tcp_t*, sockaddr*, int*), const uv_tcp_t* tcp) {
+  sockaddr_storage storage;
+  int len = sizeof(storage);
+  if (getname(tcp, reinterpret_cast<sockaddr*>(&storage), &len) != 0) {
+    return EventEngine::ResolvedAddress();
+  }
+  return EventEngine::ResolvedAddress(reinterpret_cast<sockaddr*>(&storage),
+                                      static_cast<socklen_t>(len));
+}
+
+// Loop-thread state of one TCP connection. Freed by the close callback of
+// its handle, so that libuv never sees a dangling handle.
+struct TcpConnection {
+  TcpConnection(LibuvEventEngine* engine, MemoryAllocator allocator)
+      : engine(engine), allocator(std::move(allocator)) {
+    tcp.data = this;
+  }
+
+  uv_tcp_t tcp;
+  LibuvEventEngine* const engine;
+  MemoryAllocator allocator;
+  // Pending Read, if any.
+  std::function<void(absl::Status)> on_read;
+  grpc_slice_buffer* read_buffer = nullptr;
+  grpc_slice read_slice = grpc_empty_slice();
+  bool closed = false;
+};
+
+void CloseConnection(TcpConnection* conn) {
+  if (conn->closed) return;
+  conn->closed = true;
+  if (conn->on_read != nullptr) {
+    auto on_read = std::move(conn->on_read);
+    conn->on_read = nullptr;
+    on_read(absl::CancelledError("endpoint shutdown"));
+  }
+  uv_close(reinterpret_cast<uv_handle_t*>(&conn->tcp), [](uv_handle_t* h) {
+    auto* conn = static_cast<TcpConnection*>(h->data);
+    grpc_slice_unref(conn->read_slice);
+    delete conn;
+  });
+}
+
+// A single uv_write covering every slice of the buffer handed to
+// Endpoint::Write, so a write costs one request no matter how many slices it
+// spans.
+struct WriteRequest {
+  uv_write_t req;
+  LibuvEventEngine* engine;
+  std::function<void(absl::Status)> on_writable;
+  std::vector<uv_buf_t> bufs;
+};
+
+class LibuvEndpoint final : public EventEngine::Endpoint {
+ public:
+  // Must be created on the loop thread.
+  explicit LibuvEndpoint(TcpConnection* conn)
+      : conn_(conn),
+        peer_address_(GetAddress(uv_tcp_getpeername, &conn->tcp)),
+        local_address_(GetAddress(uv_tcp_getsockname, &conn->tcp)) {}
+
+  ~LibuvEndpoint() override {
+    TcpConnection* conn = conn_;
+    conn->engine->RunInLoop([conn] { CloseConnection(conn); });
+  }
+
+  void Read(std::function<void(absl::Status)> on_read,
+            SliceBuffer* buffer) override {
+    TcpConnection* conn = conn_;
+    grpc_slice_buffer* dst = buffer->RawSliceBuffer();
+    conn->engine->RunInLoop([conn, dst, on_read]() mutable {
+      if (conn->closed) {
+        on_read(absl::CancelledError("endpoint shutdown"));
+        return;
+      }
+      GPR_ASSERT(conn->on_read == nullptr);
+      conn->on_read = std::move(on_read);
+      conn->read_buffer = dst;
+      int r = uv_read_start(reinterpret_cast<uv_stream_t*>(&conn->tcp),
+                            OnAlloc, OnRead);
+      if (r != 0) FinishRead(conn, UvError("uv_read_start", r));
+    });
+  }
+
+  void Write(std::function<void(absl::Status)> on_writable,
+             SliceBuffer* data) override {
+    TcpConnection* conn = conn_;
+    grpc_slice_buffer* src = data->RawSliceBuffer();
+    conn->engine->RunInLoop([conn, src, on_writable]() mutable {
+      if (conn->closed) {
+        on_writable(absl::CancelledError("endpoint shutdown"));
+        return;
+      }
+      StartWrite(conn, src, std::move(on_writable));
+    });
+  }
+
+  const EventEngine::ResolvedAddress& GetPeerAddress() const override {
+    return peer_address_;
+  }
+  const EventEngine::ResolvedAddress& GetLocalAddress() const override {
+    return local_address_;
+  }
+
+ private:
+  static void OnAlloc(uv_handle_t* handle, size_t suggested_size,
+                      uv_buf_t* buf) {
+    auto* conn = static_cast<TcpConnection*>(handle->data);
+    if (GRPC_SLICE_LENGTH(conn->read_slice) == 0) {
+      conn->read_slice = conn->allocator.MakeSlice(
+          MemoryRequest(std::min<size_t>(suggested_size, 8192),
+                        std::max<size_t>(suggested_size, 8192)));
+    }
+    *buf = uv_buf_init(
+        reinterpret_cast<char*>(GRPC_SLICE_START_PTR(conn->read_slice)),
+        static_cast<unsigned int>(GRPC_SLICE_LENGTH(conn->read_slice)));
+  }
+
+  static void OnRead(uv_stream_t* stream, ssize_t nread,
+                     const uv_buf_t* /*buf*/) {
+    auto* conn = static_cast<TcpConnection*>(stream->data);
+    CurrentEngineScope scope(conn->engine);
+    if (nread == 0) return;  // EAGAIN; the slice is kept for the next read
+    if (nread < 0) {
+      FinishRead(conn, UvError("read", static_cast<int>(nread)));
+      return;
+    }
+    grpc_slice slice = conn->read_slice;
+    conn->read_slice = grpc_empty_slice();
+    size_t unused = GRPC_SLICE_LENGTH(slice) - static_cast<size_t>(nread);
+    grpc_slice_buffer_add(conn->read_buffer, slice);
+    grpc_slice_buffer_trim_end(conn->read_buffer, unused, nullptr);
+    FinishRead(conn, absl::OkStatus());
+  }
+
+  static void FinishRead(TcpConnection* conn, absl::Status status) {
+    uv_read_stop(reinterpret_cast<uv_stream_t*>(&conn->tcp));
+    auto on_read = std::move(conn->on_read);
+    conn->on_read = nullptr;
+    conn->read_buffer = nullptr;
+    on_read(std::move(status));
+  }
+
+  static void StartWrite(TcpConnection* conn, grpc_slice_buffer* src,
+                         std::function<void(absl::Status)> on_writable) {
+    auto* stream = reinterpret_cast<uv_stream_t*>(&conn->tcp);
+    std::vector<uv_buf_t> bufs;
+    bufs.reserve(src->count);
+    for (size_t i = 0; i < src->count; ++i) {
+      bufs.push_back(uv_buf_init(
+          reinterpret_cast<char*>(GRPC_SLICE_START_PTR(src->slices[i])),
+          static_cast<unsigned int>(GRPC_SLICE_LENGTH(src->slices[i]))));
+    }
+    // Try to write the whole batch synchronously first; only what the socket
+    // would not take goes through a write request.
+    int written = uv_try_write(stream, bufs.data(),
+                               static_cast<unsigned int>(bufs.size()));
+    if (written < 0 && written != UV_EAGAIN && written != UV_ENOSYS) {
+      on_writable(UvError("write", written));
+      return;
+    }
+    size_t skip = written > 0 ? static_cast<size_t>(written) : 0;
+    auto first = bufs.begin();
+    while (first != bufs.end() && skip >= first->len) {
+      skip -= first->len;
+      ++first;
+    }
+    if (first == bufs.end()) {
+      on_writable(absl::OkStatus());
+      return;
+    }
+    first->base += skip;
+    first->len -= skip;
+    auto* req = new WriteRequest;
+    req->engine = conn->engine;
+    req->on_writable = std::move(on_writable);
+    req->bufs.assign(first, bufs.end());
+    req->req.data = req;
+    int r = uv_write(&req->req, stream, req->bufs.data(),
+                     static_cast<unsigned int>(req->bufs.size()), OnWrite);
+    if (r != 0) {
+      std::unique_ptr<WriteRequest> owned(req);
+      owned->on_writable(UvError("uv_write", r));
+    }
+  }
+
+  static void OnWrite(uv_write_t* write_req, int status) {
+    std::unique_ptr<WriteRequest> req(
+        static_cast<WriteRequest*>(write_req->data));
+    CurrentEngineScope scope(req->engine);
+    req->on_writable(status == 0 ? absl::OkStatus()
+                                 : UvError("write", status));
+  }
+
+  TcpConnection* const conn_;
+  const EventEngine::ResolvedAddress peer_address_;
+  const EventEngine::ResolvedAddress local_address_;
+};
+
+class LibuvListener final : public EventEngine::Listener {
+ public:
+  LibuvListener(LibuvEventEngine* engine, AcceptCallback on_accept,
+                std::function<void(absl::Status)> on_shutdown,
+                std::unique_ptr<MemoryAllocatorFactory> allocator_factory)
+      : state_(new State{engine, std::move(on_accept), std::move(on_shutdown),
+                         std::move(allocator_factory), {}, 0}) {}
+
+  ~LibuvListener() override {
+    State* state = state_;
+    state->engine->RunInLoop([state] {
+      state->open = state->servers.size();
+      if (state->open == 0) {
+        FinishShutdown(state);
+        return;
+      }
+      for (Server* server : state->servers) {
+        uv_close(reinterpret_cast<uv_handle_t*>(&server->tcp),
+                 [](uv_handle_t* h) {
+                   auto* server = static_cast<Server*>(h->data);
+                   State* state = server->state;
+                   delete server;
+                   if (--state->open == 0) FinishShutdown(state);
+                 });
+      }
+    });
+  }
+
+  absl::StatusOr<int> Bind(
+      const EventEngine::ResolvedAddress& addr) override {
+    absl::StatusOr<int> result;
+    State* state = state_;
+    state->engine->RunInLoopSync([state, &addr, &result] {
+      auto* server = new Server;
+      server->state = state;
+      server->tcp.data = server;
+      int r = uv_tcp_init(state->engine->loop(), &server->tcp);
+      if (r != 0) {
+        delete server;
+        result = UvError("uv_tcp_init", r);
+        return;
+      }
+      state->servers.push_back(server);
+      r = uv_tcp_bind(&server->tcp, addr.address(), 0);
+      if (r != 0) {
+        result = UvError("uv_tcp_bind", r);
+        return;
+      }
+      EventEngine::ResolvedAddress bound =
+          GetAddress(uv_tcp_getsockname, &server->tcp);
+      switch (bound.address()->sa_family) {
+        case AF_INET:
+          result = ntohs(
+              reinterpret_cast<const sockaddr_in*>(bound.address())->sin_port);
+          break;
+        case AF_INET6:
+          result = ntohs(reinterpret_cast<const sockaddr_in6*>(bound.address())
+                             ->sin6_port);
+          break;
+        default:
+          result = absl::InvalidArgumentError("unsupported address family");
+      }
+    });
+    return result;
+  }
+
+  absl::Status Start() override {
+    absl::Status status;
+    State* state = state_;
+    state->engine->RunInLoopSync([state, &status] {
+      for (Server* server : state->servers) {
+        int r = uv_listen(reinterpret_cast<uv_stream_t*>(&server->tcp),
+                          SOMAXCONN, OnConnection);
+        if (r != 0) {
+          status = UvError("uv_listen", r);
+          return;
+        }
+      }
+    });
+    return status;
+  }
+
+ private:
+  struct Server;
+  // Outlives the listener until every server handle has been closed.
+  struct State {
+    LibuvEventEngine* const engine;
+    AcceptCallback on_accept;
+    std::function<void(absl::Status)> on_shutdown;
+    std::unique_ptr<MemoryAllocatorFactory> allocator_factory;
+    std::vector<Server*> servers;
+    size_t open = 0;
+  };
+  struct Server {
+    uv_tcp_t tcp;
+    State* state;
+  };
+
+  static void FinishShutdown(State* state) {
+    std::unique_ptr<State> owned(state);
+    owned->on_shutdown(absl::OkStatus());
+  }
+
+  static void OnConnection(uv_stream_t* stream, int status) {
+    State* state = static_cast<Server*>(stream->data)->state;
+    CurrentEngineScope scope(state->engine);
+    if (status != 0) {
+      gpr_log(GPR_ERROR, "libuv accept failed: %s", uv_strerror(status));
+      return;
+    }
+    auto* conn = new TcpConnection(
+        state->engine,
+        state->allocator_factory->CreateMemoryAllocator("libuv_endpoint"));
+    uv_tcp_init(state->engine->loop(), &conn->tcp);
+    int r = uv_accept(stream, reinterpret_cast<uv_stream_t*>(&conn->tcp));
+    if (r != 0) {
+      gpr_log(GPR_ERROR, "libuv accept failed: %s", uv_strerror(r));
+      CloseConnection(conn);
+      return;
+    }
+    uv_tcp_nodelay(&conn->tcp, 1);
+    state->on_accept(
+        absl::make_unique<LibuvEndpoint>(conn),
+        state->allocator_factory->CreateMemoryAllocator("libuv_listener"));
+  }
+
+  State* const state_;
+};
+
+// Hostname lookups go through uv_getaddrinfo on libuv's thread pool. SRV and
+// TXT lookups need a DNS client, which libuv does not provide.
+class LibuvDNSResolver final : public EventEngine::DNSResolver {
+ public:
+  explicit LibuvDNSResolver(LibuvEventEngine* engine)
+      : engine_(engine), registry_(std::make_shared<Registry>()) {}
+
+  LookupTaskHandle LookupHostname(LookupHostnameCallback on_resolve,
+                                  absl::string_view address,
+                                  absl::string_view default_port,
+                                  absl::Time deadline) override {
+    std::string host;
+    std::string port;
+    if (!grpc_core::SplitHostPort(address, &host, &port) || host.empty()) {
+      Fail(std::move(on_resolve), absl::InvalidArgumentError(absl::StrCat(
+                                      "unparseable host:port: ", address)));
+      return {{0, 0}};
+    }
+    if (port.empty()) {
+      if (default_port.empty()) {
+        Fail(std::move(on_resolve), absl::InvalidArgumentError(absl::StrCat(
+                                        "no port in name: ", address)));
+        return {{0, 0}};
+      }
+      port = std::string(default_port);
+    }
+    auto lookup = std::make_shared<Lookup>();
+    lookup->engine = engine_;
+    lookup->registry = registry_;
+    lookup->on_resolve = std::move(on_resolve);
+    lookup->host = std::move(host);
+    lookup->port = std::move(port);
+    {
+      grpc_core::MutexLock lock(&registry_->mu);
+      lookup->id = registry_->next_id++;
+      registry_->lookups[lookup->id] = lookup;
+    }
+    std::shared_ptr<Registry> registry = registry_;
+    intptr_t id = lookup->id;
+    lookup->deadline_timer = engine_->RunAt(deadline, [registry, id] {
+      std::shared_ptr<Lookup> lookup = registry->Take(id);
+      if (lookup == nullptr) return;
+      lookup->on_resolve(absl::DeadlineExceededError("DNS lookup timed out"));
+    });
+    engine_->RunInLoop([lookup] {
+      if (!lookup->registry->Contains(lookup->id)) return;
+      addrinfo hints;
+      memset(&hints, 0, sizeof(hints));
+      hints.ai_family = AF_UNSPEC;
+      hints.ai_socktype = SOCK_STREAM;
+      lookup->req.data = new std::shared_ptr<Lookup>(lookup);
+      int r = uv_getaddrinfo(lookup->engine->loop(), &lookup->req, OnResolved,
+                             lookup->host.c_str(), lookup->port.c_str(),
+                             &hints);
+      if (r != 0) {
+        delete static_cast<std::shared_ptr<Lookup>*>(lookup->req.data);
+        if (lookup->registry->Take(lookup->id) == nullptr) return;
+        lookup->engine->Cancel(lookup->deadline_timer);
+        lookup->on_resolve(UvError("uv_getaddrinfo", r));
+      }
+    });
+    return {{id, reinterpret_cast<intptr_t>(registry_.get())}};
+  }
+
+  LookupTaskHandle LookupSRV(LookupSRVCallback on_resolve,
+                             absl::string_view /*name*/,
+                             absl::Time /*deadline*/) override {
+    Fail(std::move(on_resolve),
+         absl::UnimplementedError("SRV lookups are not supported by libuv"));
+    return {{0, 0}};
+  }
+
+  LookupTaskHandle LookupTXT(LookupTXTCallback on_resolve,
+                             absl::string_view /*name*/,
+                             absl::Time /*deadline*/) override {
+    Fail(std::move(on_resolve),
+         absl::UnimplementedError("TXT lookups are not supported by libuv"));
+    return {{0, 0}};
+  }
+
+  bool CancelLookup(LookupTaskHandle handle) override {
+    std::shared_ptr<Lookup> lookup = registry_->Take(handle.key[0]);
+    if (lookup == nullptr) return false;
+    engine_->Cancel(lookup->deadline_timer);
+    // Best effort: a request that already reached the thread pool runs to
+    // completion, and its result is then dropped.
+    engine_->RunInLoop(
+        [lookup] { uv_cancel(reinterpret_cast<uv_req_t*>(&lookup->req)); });
+    return true;
+  }
+
+ private:
+  struct Registry;
+  struct Lookup {
+    uv_getaddrinfo_t req;
+    LibuvEventEngine* engine;
+    std::shared_ptr<Registry> registry;
+    intptr_t id;
+    LookupHostnameCallback on_resolve;
+    std::string host;
+    std::string port;
+    EventEngine::TaskHandle deadline_timer;
+  };
+  // Shared with in-flight lookups, which may finish after the resolver is
+  // destroyed.
+  struct Registry {
+    std::shared_ptr<Lookup> Take(intptr_t id) {
+      grpc_core::MutexLock lock(&mu);
+      auto it = lookups.find(id);
+      if (it == lookups.end()) return nullptr;
+      std::shared_ptr<Lookup> lookup = std::move(it->second);
+      lookups.erase(it);
+      return lookup;
+    }
+    bool Contains(intptr_t id) {
+      grpc_core::MutexLock lock(&mu);
+      return lookups.count(id) != 0;
+    }
+
+    grpc_core::Mutex mu;
+    intptr_t next_id ABSL_GUARDED_BY(mu) = 1;
+    std::map<intptr_t, std::shared_ptr<Lookup>> lookups ABSL_GUARDED_BY(mu);
+  };
+
+  template <typename Callback>
+  void Fail(Callback on_resolve, absl::Status status) {
+    engine_->Run([on_resolve, status] { on_resolve(status); });
+  }
+
+  static void OnResolved(uv_getaddrinfo_t* req, int status, addrinfo* res) {
+    std::unique_ptr<std::shared_ptr<Lookup>> holder(
+        static_cast<std::shared_ptr<Lookup>*>(req->data));
+    std::shared_ptr<Lookup> lookup = *holder;
+    CurrentEngineScope scope(lookup->engine);
+    if (lookup->registry->Take(lookup->id) == nullptr) {
+      uv_freeaddrinfo(res);
+      return;
+    }
+    lookup->engine->Cancel(lookup->deadline_timer);
+    if (status != 0) {
+      lookup->on_resolve(absl::NotFoundError(absl::StrCat(
+          "DNS lookup for ", lookup->host, " failed: ", uv_strerror(status))));
+      return;
+    }
+    std::vector<EventEngine::ResolvedAddress> addresses;
+    for (addrinfo* ai = res; ai != nullptr; ai = ai->ai_next) {
+      addresses.emplace_back(ai->ai_addr,
+                             static_cast<socklen_t>(ai->ai_addrlen));
+    }
+    uv_freeaddrinfo(res);
+    lookup->on_resolve(std::move(addresses));
+  }
+
+  LibuvEventEngine* const engine_;
+  const std::shared_ptr<Registry> registry_;
+};
+
+}  // namespace
+
+struct LibuvEventEngine::LoopHandles {
+  uv_async_t wakeup;
+  uv_timer_t timer;
+  int open = 2;
+};
+
+struct LibuvEventEngine::ConnectState {
+  LibuvEventEngine* engine;
+  intptr_t id;
+  OnConnectCallback on_connect;
+  MemoryAllocator allocator;
+  TaskHandle deadline_timer;
+  // Loop thread only.
+  TcpConnection* conn = nullptr;
+  uv_connect_t req;
+};
+
+LibuvEventEngine::LibuvEventEngine() : owned_loop_(new uv_loop_t) {
+  loop_ = owned_loop_.get();
+  GPR_ASSERT(uv_loop_init(loop_) == 0);
+  Init();
+  thread_ = grpc_core::Thread("libuv_event_engine", ThreadBody, this);
+  thread_.Start();
+}
+
+LibuvEventEngine::LibuvEventEngine(uv_loop_t* loop) : loop_(loop) { Init(); }
+
+LibuvEventEngine::~LibuvEventEngine() {
+  if (owned_loop_ == nullptr) {
+    Shutdown();
+    return;
+  }
+  // Closing the engine's handles leaves the loop without active handles,
+  // which makes uv_run return on the loop thread.
+  GPR_ASSERT(!IsWorkerThread());
+  RunInLoop([this] { Shutdown(); });
+  thread_.Join();
+  if (uv_loop_close(loop_) != 0) {
+    gpr_log(GPR_ERROR, "libuv loop closed with active handles");
+  }
+}
+
+void LibuvEventEngine::Init() {
+  handles_ = new LoopHandles;
+  GPR_ASSERT(uv_async_init(loop_, &handles_->wakeup, OnWakeup) == 0);
+  handles_->wakeup.data = this;
+  GPR_ASSERT(uv_timer_init(loop_, &handles_->timer) == 0);
+  handles_->timer.data = this;
+}
+
+void LibuvEventEngine::Shutdown() {
+  std::vector<std::function<void()>> queue;
+  std::map<std::pair<absl::Time, intptr_t>, std::function<void()>> timers;
+  std::map<intptr_t, std::shared_ptr<ConnectState>> connects;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    shutdown_ = true;
+    queue.swap(queue_);
+    timers.swap(timers_);
+    timer_deadlines_.clear();
+    connects.swap(connects_);
+  }
+  uv_timer_stop(&handles_->timer);
+  auto on_close = [](uv_handle_t* h) {
+    auto* handles = static_cast<LoopHandles*>(h->data);
+    if (--handles->open == 0) delete handles;
+  };
+  handles_->wakeup.data = handles_;
+  handles_->timer.data = handles_;
+  uv_close(reinterpret_cast<uv_handle_t*>(&handles_->wakeup), on_close);
+  uv_close(reinterpret_cast<uv_handle_t*>(&handles_->timer), on_close);
+  handles_ = nullptr;
+}
+
+void LibuvEventEngine::ThreadBody(void* arg) {
+  auto* engine = static_cast<LibuvEventEngine*>(arg);
+  uv_run(engine->loop_, UV_RUN_DEFAULT);
+}
+
+void LibuvEventEngine::RunInLoop(std::function<void()> fn) {
+  grpc_core::MutexLock lock(&mu_);
+  if (shutdown_) return;
+  queue_.push_back(std::move(fn));
+  // A non-empty queue already has a wakeup pending. The send stays under the
+  // lock so that it cannot race with Shutdown closing the handle.
+  if (queue_.size() == 1) uv_async_send(&handles_->wakeup);
+}
+
+void LibuvEventEngine::RunInLoopSync(std::function<void()> fn) {
+  if (IsWorkerThread()) {
+    fn();
+    return;
+  }
+  absl::Notification done;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (shutdown_) return;
+  }
+  RunInLoop([&fn, &done] {
+    fn();
+    done.Notify();
+  });
+  done.WaitForNotification();
+}
+
+void LibuvEventEngine::OnWakeup(uv_async_t* handle) {
+  auto* engine = static_cast<LibuvEventEngine*>(handle->data);
+  CurrentEngineScope scope(engine);
+  std::vector<std::function<void()>> queue;
+  {
+    grpc_core::MutexLock lock(&engine->mu_);
+    queue.swap(engine->queue_);
+  }
+  for (auto& fn : queue) fn();
+}
+
+void LibuvEventEngine::ArmTimer() {
+  uint64_t delay;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    if (shutdown_) return;
+    if (timers_.empty()) {
+      uv_timer_stop(&handles_->timer);
+      return;
+    }
+    delay = MillisUntil(timers_.begin()->first.first);
+  }
+  uv_timer_start(&handles_->timer, OnTimer, delay, 0);
+}
+
+void LibuvEventEngine::OnTimer(uv_timer_t* handle) {
+  auto* engine = static_cast<LibuvEventEngine*>(handle->data);
+  CurrentEngineScope scope(engine);
+  std::vector<std::function<void()>> due;
+  absl::Time now = absl::Now();
+  {
+    grpc_core::MutexLock lock(&engine->mu_);
+    while (!engine->timers_.empty() &&
+           engine->timers_.begin()->first.first <= now) {
+      auto it = engine->timers_.begin();
+      due.push_back(std::move(it->second));
+      engine->timer_deadlines_.erase(it->first.second);
+      engine->timers_.erase(it);
+    }
+  }
+  for (auto& fn : due) fn();
+  engine->ArmTimer();
+}
+
+bool LibuvEventEngine::IsWorkerThread() { return g_current_engine == this; }
+
+void LibuvEventEngine::Run(Closure* closure) {
+  RunInLoop([closure] { closure->Run(); });
+}
+
+void LibuvEventEngine::Run(std::function<void()> closure) {
+  RunInLoop(std::move(closure));
+}
+
+EventEngine::TaskHandle LibuvEventEngine::RunAt(absl::Time when,
+                                                Closure* closure) {
+  return RunAt(when, [closure] { closure->Run(); });
+}
+
+EventEngine::TaskHandle LibuvEventEngine::RunAt(
+    absl::Time when, std::function<void()> closure) {
+  intptr_t id = next_id_.fetch_add(1, std::memory_order_relaxed);
+  grpc_core::MutexLock lock(&mu_);
+  if (shutdown_) return {{0, 0}};
+  timers_.emplace(std::make_pair(when, id), std::move(closure));
+  timer_deadlines_.emplace(id, when);
+  // Only a new earliest deadline needs the loop to re-arm the shared timer.
+  if (timers_.begin()->first.second == id) {
+    queue_.push_back([this] { ArmTimer(); });
+    if (queue_.size() == 1) uv_async_send(&handles_->wakeup);
+  }
+  return {{id, reinterpret_cast<intptr_t>(this)}};
+}
+
+bool LibuvEventEngine::Cancel(TaskHandle handle) {
+  grpc_core::MutexLock lock(&mu_);
+  auto it = timer_deadlines_.find(handle.keys[0]);
+  if (it == timer_deadlines_.end()) return false;
+  // The shared timer is left armed; it finds nothing due and re-arms.
+  timers_.erase(std::make_pair(it->second, it->first));
+  timer_deadlines_.erase(it);
+  return true;
+}
+
+EventEngine::ConnectionHandle LibuvEventEngine::Connect(
+    OnConnectCallback on_connect, const ResolvedAddress& addr,
+    const EndpointConfig& /*args*/, MemoryAllocator memory_allocator,
+    absl::Time deadline) {
+  auto state = std::make_shared<ConnectState>();
+  state->engine = this;
+  state->id = next_id_.fetch_add(1, std::memory_order_relaxed);
+  state->on_connect = std::move(on_connect);
+  state->allocator = std::move(memory_allocator);
+  intptr_t id = state->id;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    connects_.emplace(id, state);
+  }
+  state->deadline_timer = RunAt(deadline, [this, id] {
+    std::shared_ptr<ConnectState> state;
+    {
+      grpc_core::MutexLock lock(&mu_);
+      auto it = connects_.find(id);
+      if (it == connects_.end()) return;
+      state = std::move(it->second);
+      connects_.erase(it);
+    }
+    if (state->conn != nullptr) CloseConnection(state->conn);
+    state->on_connect(absl::DeadlineExceededError("connect timed out"));
+  });
+  RunInLoop([this, state, addr] {
+    {
+      grpc_core::MutexLock lock(&mu_);
+      if (connects_.count(state->id) == 0) return;
+    }
+    state->conn = new TcpConnection(this, MemoryAllocator());
+    uv_tcp_init(loop_, &state->conn->tcp);
+    uv_tcp_nodelay(&state->conn->tcp, 1);
+    state->req.data = new std::shared_ptr<ConnectState>(state);
+    int r = uv_tcp_connect(
+        &state->req, &state->conn->tcp, addr.address(),
+        [](uv_connect_t* req, int status) {
+          std::unique_ptr<std::shared_ptr<ConnectState>> holder(
+              static_cast<std::shared_ptr<ConnectState>*>(req->data));
+          std::shared_ptr<ConnectState> state = *holder;
+          LibuvEventEngine* engine = state->engine;
+          CurrentEngineScope scope(engine);
+          {
+            grpc_core::MutexLock lock(&engine->mu_);
+            // Cancelled or timed out; whoever removed the entry closed the
+            // connection.
+            if (engine->connects_.erase(state->id) == 0) return;
+          }
+          engine->Cancel(state->deadline_timer);
+          if (status != 0) {
+            CloseConnection(state->conn);
+            state->on_connect(UvError("connect", status));
+            return;
+          }
+          state->conn->allocator = std::move(state->allocator);
+          state->on_connect(absl::make_unique<LibuvEndpoint>(state->conn));
+        });
+    if (r != 0) {
+      delete static_cast<std::shared_ptr<ConnectState>*>(state->req.data);
+      {
+        grpc_core::MutexLock lock(&mu_);
+        if (connects_.erase(state->id) == 0) return;
+      }
+      Cancel(state->deadline_timer);
+      CloseConnection(state->conn);
+      state->on_connect(UvError("uv_tcp_connect", r));
+    }
+  });
+  return {{id, reinterpret_cast<intptr_t>(this)}};
+}
+
+bool LibuvEventEngine::CancelConnect(ConnectionHandle handle) {
+  std::shared_ptr<ConnectState> state;
+  {
+    grpc_core::MutexLock lock(&mu_);
+    auto it = connects_.find(handle.keys[0]);
+    if (it == connects_.end()) return false;
+    state = std::move(it->second);
+    connects_.erase(it);
+  }
+  Cancel(state->deadline_timer);
+  // Closing the handle makes libuv complete the connect with UV_ECANCELED.
+  RunInLoop([state] {
+    if (state->conn != nullptr) CloseConnection(state->conn);
+  });
+  return true;
+}
+
+absl::StatusOr<std::unique_ptr<EventEngine::Listener>>
+LibuvEventEngine::CreateListener(
+    Listener::AcceptCallback on_accept,
+    std::function<void(absl::Status)> on_shutdown,
+    const EndpointConfig& /*config*/,
+    std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory) {
+  return absl::make_unique<LibuvListener>(this, std::move(on_accept),
+                                          std::move(on_shutdown),
+                                          std::move(memory_allocator_factory));
+}
+
+std::unique_ptr<EventEngine::DNSResolver> LibuvEventEngine::GetDNSResolver() {
+  return absl::make_unique<LibuvDNSResolver>(this);
+}
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
@@ -0,0 +1,127 @@
+// Copyright 2021 The gRPC Authors
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+#ifndef GRPC_CORE_LIB_EVENT_ENGINE_LIBUV_EVENT_ENGINE_H
+#define GRPC_CORE_LIB_EVENT_ENGINE_LIBUV_EVENT_ENGINE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdint.h>
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <uv.h>
+
+#include "absl/time/time.h"
+
+#include <grpc/event_engine/event_engine.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+
+namespace grpc_event_engine {
+namespace experimental {
+
+/// An EventEngine that runs all I/O, timers and callbacks on a single libuv
+/// loop.
+///
+/// The engine either owns its loop and drives it from a dedicated thread, or
+/// attaches to a loop supplied by the embedder, which keeps running that loop
+/// itself. In both cases every callback handed to the engine runs on the loop
+/// thread, and all libuv handles are only touched from that thread: other
+/// threads hand work over through a single uv_async_t.
+class LibuvEventEngine final : public EventEngine {
+ public:
+  /// Creates an engine with a private loop and a thread running it.
+  LibuvEventEngine();
+  /// Attaches to \a loop, which must outlive the engine. The embedder keeps
+  /// calling uv_run on it, and must destroy the engine either on the loop
+  /// thread or after the loop has stopped running.
+  explicit LibuvEventEngine(uv_loop_t* loop);
+  ~LibuvEventEngine() override;
+
+  LibuvEventEngine(const LibuvEventEngine&) = delete;
+  LibuvEventEngine& operator=(const LibuvEventEngine&) = delete;
+
+  absl::StatusOr<std::unique_ptr<Listener>> CreateListener(
+      Listener::AcceptCallback on_accept,
+      std::function<void(absl::Status)> on_shutdown,
+      const EndpointConfig& config,
+      std::unique_ptr<MemoryAllocatorFactory> memory_allocator_factory)
+      override;
+  ConnectionHandle Connect(OnConnectCallback on_connect,
+                           const ResolvedAddress& addr,
+                           const EndpointConfig& args,
+                           MemoryAllocator memory_allocator,
+                           absl::Time deadline) override;
+  bool CancelConnect(ConnectionHandle handle) override;
+  bool IsWorkerThread() override;
+  std::unique_ptr<DNSResolver> GetDNSResolver() override;
+  void Run(Closure* closure) override;
+  void Run(std::function<void()> closure) override;
+  TaskHandle RunAt(absl::Time when, Closure* closure) override;
+  TaskHandle RunAt(absl::Time when, std::function<void()> closure) override;
+  bool Cancel(TaskHandle handle) override;
+
+  /// Queues \a fn to run on the loop thread. Functions run in the order they
+  /// were queued, and are dropped if the engine shuts down first.
+  void RunInLoop(std::function<void()> fn);
+  /// Runs \a fn on the loop thread and waits for it to finish. Runs inline
+  /// when called from the loop thread.
+  void RunInLoopSync(std::function<void()> fn);
+
+  uv_loop_t* loop() const { return loop_; }
+
+ private:
+  struct LoopHandles;
+  struct ConnectState;
+
+  void Init();
+  void Shutdown();
+  // Re-arms the shared uv timer for the earliest pending deadline, or stops
+  // it when nothing is pending. Loop thread only.
+  void ArmTimer();
+  static void OnWakeup(uv_async_t* handle);
+  static void OnTimer(uv_timer_t* handle);
+  static void ThreadBody(void* arg);
+
+  uv_loop_t* loop_;
+  // Set when the engine owns loop_ and drives it from thread_.
+  std::unique_ptr<uv_loop_t> owned_loop_;
+  grpc_core::Thread thread_;
+  // Heap-allocated so that the close callbacks can run after the engine is
+  // gone.
+  LoopHandles* handles_;
+  std::atomic<intptr_t> next_id_{1};
+
+  grpc_core::Mutex mu_;
+  bool shutdown_ ABSL_GUARDED_BY(mu_) = false;
+  std::vector<std::function<void()>> queue_ ABSL_GUARDED_BY(mu_);
+  // All pending RunAt tasks share one uv timer: tasks are ordered by
+  // deadline, and the timer only ever waits for the first of them.
+  std::map<std::pair<absl::Time, intptr_t>, std::function<void()>> timers_
+      ABSL_GUARDED_BY(mu_);
+  std::map<intptr_t, absl::Time> timer_deadlines_ ABSL_GUARDED_BY(mu_);
+  std::map<intptr_t, std::shared_ptr<ConnectState>> connects_
+      ABSL_GUARDED_BY(mu_);
+};
+
+}  // namespace experimental
+}  // namespace grpc_event_engine
+
+#endif  // GRPC_CORE_LIB_EVENT_ENGINE_LIBUV_EVENT_ENGINE_H
@@ -17,6 +17,7 @@
 #include <grpc/event_engine/memory_allocator.h>
 
 #include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/slice/slice_block_cache.h"
 #include "src/core/lib/slice/slice_refcount.h"
 
 namespace grpc_event_engine {
@@ -30,8 +31,9 @@ class SliceRefCount {
  public:
   static void Destroy(void* p) {
     auto* rc = static_cast<SliceRefCount*>(p);
+    const size_t size = rc->size_;
     rc->~SliceRefCount();
-    gpr_free(rc);
+    grpc_core::SliceBlockCache::Free(rc, size);
   }
   SliceRefCount(std::shared_ptr<internal::MemoryAllocatorImpl> allocator,
                 size_t size)
@@ -56,7 +58,7 @@ class SliceRefCount {
 
 grpc_slice MemoryAllocator::MakeSlice(MemoryRequest request) {
   auto size = Reserve(request.Increase(sizeof(SliceRefCount)));
-  void* p = gpr_malloc(size);
+  void* p = grpc_core::SliceBlockCache::Alloc(size);
   new (p) SliceRefCount(allocator_, size);
   grpc_slice slice;
   slice.refcount = static_cast<SliceRefCount*>(p)->base_refcount();
@@ -24,14 +24,18 @@
 #include <inttypes.h>
 #include <string.h>
 
+#include "absl/strings/str_format.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gprpp/mpscq.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 
 grpc_core::DebugOnlyTraceFlag grpc_combiner_trace(false, "combiner");
+grpc_core::TraceFlag grpc_combiner_stats_trace(false, "combiner_stats");
 
 #define GRPC_COMBINER_TRACE(fn)          \
   do {                                   \
@@ -130,7 +134,17 @@ static void combiner_exec(grpc_core::Combiner* lock, grpc_closure* cl,
   GRPC_COMBINER_TRACE(gpr_log(GPR_INFO,
                               "C:%p grpc_combiner_execute c=%p last=%" PRIdPTR,
                               lock, cl, last));
+  GRPC_STATS_INC_COMBINER_LOCKS_SCHEDULED_ITEMS();
+  gpr_atm_no_barrier_fetch_add(&lock->scheduled_items, 1);
+  // there may be a race with another thread raising the maximum too: that
+  // only loses some precision
+  gpr_atm depth = (last >> 1) + 1;
+  if (depth > gpr_atm_no_barrier_load(&lock->max_queue_depth)) {
+    gpr_atm_no_barrier_store(&lock->max_queue_depth, depth);
+  }
   if (last == 1) {
+    GRPC_STATS_INC_COMBINER_LOCKS_INITIATED();
+    lock->locked_at = gpr_get_cycle_counter();
     gpr_atm_no_barrier_store(
         &lock->initiating_exec_ctx_or_null,
         reinterpret_cast<gpr_atm>(grpc_core::ExecCtx::Get()));
@@ -157,6 +171,12 @@ static void combiner_exec(grpc_core::Combiner* lock, grpc_closure* cl,
   lock->queue.Push(cl->next_data.mpscq_node.get());
 }
 
+static void note_unlocked(grpc_core::Combiner* lock, gpr_timespec held) {
+  gpr_atm_no_barrier_fetch_add(
+      &lock->held_nanos,
+      static_cast<gpr_atm>(held.tv_sec) * GPR_NS_PER_SEC + held.tv_nsec);
+}
+
 static void move_next() {
   grpc_core::ExecCtx::Get()->combiner_data()->active_combiner =
       grpc_core::ExecCtx::Get()
@@ -175,6 +195,8 @@ static void offload(void* arg, grpc_error_handle /*error*/) {
 static void queue_offload(grpc_core::Combiner* lock) {
   move_next();
   GRPC_COMBINER_TRACE(gpr_log(GPR_INFO, "C:%p queue_offload", lock));
+  GRPC_STATS_INC_COMBINER_LOCKS_OFFLOADED();
+  gpr_atm_no_barrier_fetch_add(&lock->offloads, 1);
   grpc_core::Executor::Run(&lock->offload, GRPC_ERROR_NONE);
 }
 
@@ -202,7 +224,9 @@ bool grpc_combiner_continue_exec_ctx() {
   // 2. the current execution context needs to finish as soon as possible
   // 3. the current thread is not a worker for any background poller
   // 4. the DEFAULT executor is threaded
-  if (contended && grpc_core::ExecCtx::Get()->IsReadyToFinish() &&
+  // 5. the combiner is not pinned to the thread that holds it
+  if (contended && !lock->affinity &&
+      grpc_core::ExecCtx::Get()->IsReadyToFinish() &&
       !grpc_iomgr_platform_is_any_background_poller_thread() &&
       grpc_core::Executor::IsThreadedDefault()) {
     // this execution context wants to move on: schedule remaining work to be
@@ -270,6 +294,9 @@ bool grpc_combiner_continue_exec_ctx() {
 
   move_next();
   lock->time_to_execute_final_list = false;
+  // read before releasing: once released, another thread may lock it again
+  gpr_timespec held =
+      gpr_cycle_counter_sub(gpr_get_cycle_counter(), lock->locked_at);
   gpr_atm old_state =
       gpr_atm_full_fetch_add(&lock->state, -STATE_ELEM_COUNT_LOW_BIT);
   GRPC_COMBINER_TRACE(
@@ -293,9 +320,11 @@ bool grpc_combiner_continue_exec_ctx() {
       break;
     case OLD_STATE_WAS(false, 1):
       // had one count, one unorphaned --> unlocked unorphaned
+      note_unlocked(lock, held);
       return true;
     case OLD_STATE_WAS(true, 1):
       // and one count, one orphaned --> unlocked and orphaned
+      note_unlocked(lock, held);
       really_destroy(lock);
       return true;
     case OLD_STATE_WAS(false, 0):
@@ -328,6 +357,7 @@ static void combiner_finally_exec(grpc_core::Combiner* lock,
   if (grpc_closure_list_empty(lock->final_list)) {
     gpr_atm_full_fetch_add(&lock->state, STATE_ELEM_COUNT_LOW_BIT);
   }
+  GRPC_STATS_INC_COMBINER_LOCKS_SCHEDULED_FINAL_ITEMS();
   grpc_closure_list_append(&lock->final_list, closure, error);
 }
 
@@ -347,4 +377,14 @@ void Combiner::Run(grpc_closure* closure, grpc_error_handle error) {
 void Combiner::FinallyRun(grpc_closure* closure, grpc_error_handle error) {
   combiner_finally_exec(this, closure, error);
 }
+
+std::string Combiner::StatsString() {
+  return absl::StrFormat(
+      "scheduled_items=%d offloads=%d max_queue_depth=%d held_us=%d%s",
+      gpr_atm_no_barrier_load(&scheduled_items),
+      gpr_atm_no_barrier_load(&offloads),
+      gpr_atm_no_barrier_load(&max_queue_depth),
+      gpr_atm_no_barrier_load(&held_nanos) / GPR_NS_PER_US,
+      affinity ? " affinity" : "");
+}
 }  // namespace grpc_core
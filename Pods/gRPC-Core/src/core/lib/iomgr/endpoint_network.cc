@@ -0,0 +1,380 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_APPLE_NETWORK_ENDPOINT
+
+#include <CoreFoundation/CoreFoundation.h>
+#include <Network/Network.h>
+#include <string.h>
+
+#include <grpc/slice_buffer.h>
+#include <grpc/support/alloc.h>
+#include <grpc/support/string_util.h>
+
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/endpoint_network.h"
+#include "src/core/lib/iomgr/error_cfstream.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/slice/slice_internal.h"
+#include "src/core/lib/slice/slice_string_helpers.h"
+
+extern grpc_core::TraceFlag grpc_tcp_trace;
+
+/* The most a single read returns. Unlike CFStreamRead(), which copies at most
+   one 8 KB slice per read, a read hands over everything the connection has
+   buffered, up to this length. */
+#define MAX_READ_LENGTH (64 * 1024)
+
+struct NetworkEndpoint {
+  grpc_endpoint base;
+  gpr_refcount refcount;
+
+  nw_connection_t connection;
+  dispatch_queue_t queue;
+
+  grpc_closure* read_cb;
+  grpc_closure* write_cb;
+  grpc_slice_buffer* read_slices;
+  grpc_slice_buffer* write_slices;
+
+  std::string peer_string;
+  std::string local_address;
+};
+
+static void NetworkFree(NetworkEndpoint* ep) {
+  nw_connection_cancel(ep->connection);
+  nw_release(ep->connection);
+  dispatch_release(ep->queue);
+  delete ep;
+}
+
+#ifndef NDEBUG
+#define EP_REF(ep, reason) NetworkRef((ep), (reason), __FILE__, __LINE__)
+#define EP_UNREF(ep, reason) NetworkUnref((ep), (reason), __FILE__, __LINE__)
+static void NetworkUnref(NetworkEndpoint* ep, const char* reason,
+                         const char* file, int line) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_atm val = gpr_atm_no_barrier_load(&ep->refcount.count);
+    gpr_log(file, line, GPR_LOG_SEVERITY_DEBUG,
+            "Network endpoint unref %p : %s %" PRIdPTR " -> %" PRIdPTR, ep,
+            reason, val, val - 1);
+  }
+  if (gpr_unref(&ep->refcount)) {
+    NetworkFree(ep);
+  }
+}
+static void NetworkRef(NetworkEndpoint* ep, const char* reason,
+                       const char* file, int line) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_atm val = gpr_atm_no_barrier_load(&ep->refcount.count);
+    gpr_log(file, line, GPR_LOG_SEVERITY_DEBUG,
+            "Network endpoint ref %p : %s %" PRIdPTR " -> %" PRIdPTR, ep,
+            reason, val, val + 1);
+  }
+  gpr_ref(&ep->refcount);
+}
+#else
+#define EP_REF(ep, reason) NetworkRef((ep))
+#define EP_UNREF(ep, reason) NetworkUnref((ep))
+static void NetworkUnref(NetworkEndpoint* ep) {
+  if (gpr_unref(&ep->refcount)) {
+    NetworkFree(ep);
+  }
+}
+static void NetworkRef(NetworkEndpoint* ep) { gpr_ref(&ep->refcount); }
+#endif
+
+grpc_error_handle grpc_error_create_from_nw_error(nw_error_t error,
+                                                  const char* desc) {
+  if (error == nullptr) {
+    return GRPC_ERROR_CREATE_FROM_COPIED_STRING(desc);
+  }
+  CFErrorRef cf_error = nw_error_copy_cf_error(error);
+  grpc_error_handle grpc_error = GRPC_ERROR_CREATE_FROM_CFERROR(cf_error, desc);
+  CFRelease(cf_error);
+  return grpc_error;
+}
+
+static grpc_error_handle NetworkAnnotateError(grpc_error_handle src_error,
+                                              NetworkEndpoint* ep) {
+  return grpc_error_set_str(
+      grpc_error_set_int(src_error, GRPC_ERROR_INT_GRPC_STATUS,
+                         GRPC_STATUS_UNAVAILABLE),
+      GRPC_ERROR_STR_TARGET_ADDRESS, ep->peer_string);
+}
+
+static void CallReadCb(NetworkEndpoint* ep, grpc_error_handle error) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p call_read_cb %p %p:%p", ep,
+            ep->read_cb, ep->read_cb->cb, ep->read_cb->cb_arg);
+    size_t i;
+    gpr_log(GPR_DEBUG, "read: error=%s", grpc_error_std_string(error).c_str());
+
+    for (i = 0; i < ep->read_slices->count; i++) {
+      char* dump = grpc_dump_slice(ep->read_slices->slices[i],
+                                   GPR_DUMP_HEX | GPR_DUMP_ASCII);
+      gpr_log(GPR_DEBUG, "READ %p (peer=%s): %s", ep, ep->peer_string.c_str(),
+              dump);
+      gpr_free(dump);
+    }
+  }
+  grpc_closure* cb = ep->read_cb;
+  ep->read_cb = nullptr;
+  ep->read_slices = nullptr;
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, cb, error);
+}
+
+static void CallWriteCb(NetworkEndpoint* ep, grpc_error_handle error) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p call_write_cb %p %p:%p", ep,
+            ep->write_cb, ep->write_cb->cb, ep->write_cb->cb_arg);
+    gpr_log(GPR_DEBUG, "write: error=%s", grpc_error_std_string(error).c_str());
+  }
+  grpc_closure* cb = ep->write_cb;
+  ep->write_cb = nullptr;
+  ep->write_slices = nullptr;
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, cb, error);
+}
+
+static void ReleaseDispatchData(void* region) {
+  dispatch_release(static_cast<dispatch_data_t>(region));
+}
+
+/* Appends the regions of content to slices, each slice keeping its region
+   alive instead of copying it */
+static void AppendDispatchData(dispatch_data_t content,
+                               grpc_slice_buffer* slices) {
+  dispatch_data_apply(content, ^bool(dispatch_data_t region, size_t /*offset*/,
+                                     const void* buffer, size_t size) {
+    dispatch_retain(region);
+    grpc_slice_buffer_add(
+        slices, grpc_slice_new_with_user_data(const_cast<void*>(buffer), size,
+                                              ReleaseDispatchData, region));
+    return true;
+  });
+}
+
+static void NetworkRead(grpc_endpoint* ep, grpc_slice_buffer* slices,
+                        grpc_closure* cb, bool urgent) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p read (%p, %p) length:%zu", ep_impl,
+            slices, cb, slices->length);
+  }
+  GPR_ASSERT(ep_impl->read_cb == nullptr);
+  ep_impl->read_cb = cb;
+  ep_impl->read_slices = slices;
+  grpc_slice_buffer_reset_and_unref_internal(slices);
+  EP_REF(ep_impl, "read");
+  nw_connection_receive(
+      ep_impl->connection, 1, MAX_READ_LENGTH,
+      ^(dispatch_data_t content, nw_content_context_t /*context*/,
+        bool is_complete, nw_error_t receive_error) {
+        grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+        grpc_core::ExecCtx exec_ctx;
+        grpc_error_handle error = GRPC_ERROR_NONE;
+        if (content != nullptr) {
+          AppendDispatchData(content, ep_impl->read_slices);
+        }
+        /* Data received along with an error or the end of the stream is
+           delivered first; the next read reports the error. */
+        if (ep_impl->read_slices->length == 0) {
+          if (receive_error != nullptr) {
+            error = NetworkAnnotateError(
+                grpc_error_create_from_nw_error(receive_error, "Read error"),
+                ep_impl);
+          } else {
+            GPR_ASSERT(is_complete);
+            error = NetworkAnnotateError(
+                GRPC_ERROR_CREATE_FROM_STATIC_STRING("Socket closed"), ep_impl);
+          }
+        }
+        CallReadCb(ep_impl, error);
+        EP_UNREF(ep_impl, "read");
+      });
+}
+
+static void NetworkWrite(grpc_endpoint* ep, grpc_slice_buffer* slices,
+                         grpc_closure* cb, void* arg) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p write (%p, %p) length:%zu",
+            ep_impl, slices, cb, slices->length);
+    for (size_t i = 0; i < slices->count; i++) {
+      char* dump =
+          grpc_dump_slice(slices->slices[i], GPR_DUMP_HEX | GPR_DUMP_ASCII);
+      gpr_log(GPR_DEBUG, "WRITE %p (peer=%s): %s", ep_impl,
+              ep_impl->peer_string.c_str(), dump);
+      gpr_free(dump);
+    }
+  }
+  GPR_ASSERT(ep_impl->write_cb == nullptr);
+  ep_impl->write_cb = cb;
+  ep_impl->write_slices = slices;
+  if (slices->length == 0) {
+    CallWriteCb(ep_impl, GRPC_ERROR_NONE);
+    return;
+  }
+  /* The whole buffer goes out in a single send, the slices being referenced
+     rather than copied. Inlined slices live in the slice buffer itself, which
+     may be reused once the write is done, so dispatch copies those. */
+  dispatch_data_t data = nullptr;
+  for (size_t i = 0; i < slices->count; i++) {
+    grpc_slice slice = slices->slices[i];
+    dispatch_data_t part;
+    if (slice.refcount == nullptr) {
+      part = dispatch_data_create(GRPC_SLICE_START_PTR(slice),
+                                  GRPC_SLICE_LENGTH(slice), ep_impl->queue,
+                                  DISPATCH_DATA_DESTRUCTOR_DEFAULT);
+    } else {
+      grpc_slice_ref_internal(slice);
+      part = dispatch_data_create(GRPC_SLICE_START_PTR(slice),
+                                  GRPC_SLICE_LENGTH(slice), ep_impl->queue,
+                                  ^{
+                                    grpc_slice_unref(slice);
+                                  });
+    }
+    if (data == nullptr) {
+      data = part;
+    } else {
+      dispatch_data_t concat = dispatch_data_create_concat(data, part);
+      dispatch_release(data);
+      dispatch_release(part);
+      data = concat;
+    }
+  }
+  EP_REF(ep_impl, "write");
+  nw_connection_send(ep_impl->connection, data,
+                     NW_CONNECTION_DEFAULT_MESSAGE_CONTEXT, false,
+                     ^(nw_error_t send_error) {
+                       grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+                       grpc_core::ExecCtx exec_ctx;
+                       grpc_error_handle error = GRPC_ERROR_NONE;
+                       if (send_error != nullptr) {
+                         error = NetworkAnnotateError(
+                             grpc_error_create_from_nw_error(send_error,
+                                                             "write failed."),
+                             ep_impl);
+                       }
+                       CallWriteCb(ep_impl, error);
+                       EP_UNREF(ep_impl, "write");
+                     });
+  dispatch_release(data);
+}
+
+void NetworkShutdown(grpc_endpoint* ep, grpc_error_handle why) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p shutdown (%s)", ep_impl,
+            grpc_error_std_string(why).c_str());
+  }
+  /* Fails the pending read and write, on the connection's queue */
+  nw_connection_cancel(ep_impl->connection);
+  GRPC_ERROR_UNREF(why);
+}
+
+void NetworkDestroy(grpc_endpoint* ep) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p destroy", ep_impl);
+  }
+  EP_UNREF(ep_impl, "destroy");
+}
+
+absl::string_view NetworkGetPeer(grpc_endpoint* ep) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  return ep_impl->peer_string;
+}
+
+absl::string_view NetworkGetLocalAddress(grpc_endpoint* ep) {
+  NetworkEndpoint* ep_impl = reinterpret_cast<NetworkEndpoint*>(ep);
+  return ep_impl->local_address;
+}
+
+int NetworkGetFD(grpc_endpoint* ep) { return 0; }
+
+bool NetworkCanTrackErr(grpc_endpoint* ep) { return false; }
+
+void NetworkAddToPollset(grpc_endpoint* ep, grpc_pollset* pollset) {}
+void NetworkAddToPollsetSet(grpc_endpoint* ep, grpc_pollset_set* pollset) {}
+void NetworkDeleteFromPollsetSet(grpc_endpoint* ep,
+                                 grpc_pollset_set* pollset) {}
+
+static const grpc_endpoint_vtable vtable = {NetworkRead,
+                                            NetworkWrite,
+                                            NetworkAddToPollset,
+                                            NetworkAddToPollsetSet,
+                                            NetworkDeleteFromPollsetSet,
+                                            NetworkShutdown,
+                                            NetworkDestroy,
+                                            NetworkGetPeer,
+                                            NetworkGetLocalAddress,
+                                            NetworkGetFD,
+                                            NetworkCanTrackErr};
+
+static std::string NetworkLocalAddress(nw_connection_t connection) {
+  std::string local_address;
+  nw_path_t path = nw_connection_copy_current_path(connection);
+  if (path == nullptr) return local_address;
+  nw_endpoint_t local = nw_path_copy_effective_local_endpoint(path);
+  if (local != nullptr) {
+    if (nw_endpoint_get_type(local) == nw_endpoint_type_address) {
+      const sockaddr* addr = nw_endpoint_get_address(local);
+      grpc_resolved_address resolved_local_addr;
+      if (addr->sa_len <= sizeof(resolved_local_addr.addr)) {
+        memcpy(resolved_local_addr.addr, addr, addr->sa_len);
+        resolved_local_addr.len = addr->sa_len;
+        local_address = grpc_sockaddr_to_uri(&resolved_local_addr);
+      }
+    }
+    nw_release(local);
+  }
+  nw_release(path);
+  return local_address;
+}
+
+grpc_endpoint* grpc_network_endpoint_create(nw_connection_t connection,
+                                            dispatch_queue_t queue,
+                                            const char* peer_string) {
+  NetworkEndpoint* ep_impl = new NetworkEndpoint;
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "Network endpoint:%p create connection:%p", ep_impl,
+            connection);
+  }
+  ep_impl->base.vtable = &vtable;
+  gpr_ref_init(&ep_impl->refcount, 1);
+  ep_impl->connection = connection;
+  nw_retain(connection);
+  ep_impl->queue = queue;
+  dispatch_retain(queue);
+  ep_impl->peer_string = peer_string;
+  ep_impl->local_address = NetworkLocalAddress(connection);
+  ep_impl->read_cb = nullptr;
+  ep_impl->write_cb = nullptr;
+  ep_impl->read_slices = nullptr;
+  ep_impl->write_slices = nullptr;
+  return &ep_impl->base;
+}
+
+#endif /* GRPC_APPLE_NETWORK_ENDPOINT */
@@ -0,0 +1,50 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_ENDPOINT_NETWORK_H
+#define GRPC_CORE_LIB_IOMGR_ENDPOINT_NETWORK_H
+/*
+   TCP endpoint on top of an Apple Network.framework connection. Reads and
+   writes are issued on the connection's dispatch queue, and the received
+   dispatch_data regions are handed to the transport without being copied.
+*/
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_APPLE_NETWORK_ENDPOINT
+
+#include <Network/Network.h>
+
+#include "src/core/lib/iomgr/endpoint.h"
+#include "src/core/lib/iomgr/error.h"
+
+/* Takes a ref to connection, which must be in the ready state, and cancels it
+   when the endpoint is destroyed. */
+grpc_endpoint* grpc_network_endpoint_create(nw_connection_t connection,
+                                            dispatch_queue_t queue,
+                                            const char* peer_string);
+
+/* Create an error from a Network.framework error, which may be null */
+grpc_error_handle grpc_error_create_from_nw_error(nw_error_t error,
+                                                  const char* desc);
+
+#endif /* GRPC_APPLE_NETWORK_ENDPOINT */
+
+#endif /* GRPC_CORE_LIB_IOMGR_ENDPOINT_NETWORK_H */
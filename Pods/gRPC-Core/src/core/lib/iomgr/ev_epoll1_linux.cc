@@ -16,6 +16,10 @@
  *
  */
 
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif /* _GNU_SOURCE */
+
 #include <grpc/support/port_platform.h>
 
 #include <grpc/support/log.h>
@@ -31,6 +35,9 @@
 #include <limits.h>
 #include <poll.h>
 #include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <sys/epoll.h>
 #include <sys/socket.h>
@@ -50,6 +57,7 @@
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/core/lib/gprpp/manual_constructor.h"
 #include "src/core/lib/iomgr/block_annotate.h"
 #include "src/core/lib/iomgr/ev_epoll1_linux.h"
@@ -59,6 +67,14 @@
 #include "src/core/lib/iomgr/wakeup_fd_posix.h"
 #include "src/core/lib/profiling/timers.h"
 
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_poller_affinity, "none",
+    "How the epoll1 engine places pollers on the cpus: 'none'; 'cpu', where "
+    "each cpu is a neighborhood; or 'numa', where each NUMA node is one. With "
+    "'cpu' or 'numa', pollsets are spread over the neighborhoods in turn "
+    "rather than following the threads that poll them, and the threads that "
+    "work on a pollset are bound to the cpus of its neighborhood.");
+
 static grpc_wakeup_fd global_wakeup_fd;
 
 /*******************************************************************************
@@ -472,6 +488,16 @@ static gpr_atm g_active_poller;
 static pollset_neighborhood* g_neighborhoods;
 static size_t g_num_neighborhoods;
 
+typedef enum { AFFINITY_NONE, AFFINITY_CPU, AFFINITY_NUMA } poller_affinity;
+
+static poller_affinity g_affinity = AFFINITY_NONE;
+/* With an affinity, the cpus of each neighborhood */
+static cpu_set_t* g_neighborhood_cpus;
+/* With an affinity, the neighborhood of the next pollset */
+static gpr_atm g_next_neighborhood;
+/* The neighborhood whose cpus the current thread is bound to */
+static GPR_THREAD_LOCAL(pollset_neighborhood*) g_current_thread_binding;
+
 /* Return true if first in list */
 static bool worker_insert(grpc_pollset* pollset, grpc_pollset_worker* worker) {
   if (pollset->root_worker == nullptr) {
@@ -513,6 +539,122 @@ static size_t choose_neighborhood(void) {
   return static_cast<size_t>(gpr_cpu_current_cpu()) % g_num_neighborhoods;
 }
 
+#define MAX_NUMA_NODES 64
+
+static poller_affinity parse_poller_affinity(void) {
+  grpc_core::UniquePtr<char> value =
+      GPR_GLOBAL_CONFIG_GET(grpc_poller_affinity);
+  if (strcmp(value.get(), "cpu") == 0) return AFFINITY_CPU;
+  if (strcmp(value.get(), "numa") == 0) return AFFINITY_NUMA;
+  if (strcmp(value.get(), "none") != 0 && value.get()[0] != '\0') {
+    gpr_log(GPR_ERROR, "Unknown poller affinity '%s', using none",
+            value.get());
+  }
+  return AFFINITY_NONE;
+}
+
+/* Reads the cpus of a NUMA node, listed like "0-3,8-11" */
+static bool read_numa_node_cpus(int node, cpu_set_t* cpus) {
+  char path[64];
+  snprintf(path, sizeof(path), "/sys/devices/system/node/node%d/cpulist",
+           node);
+  FILE* file = fopen(path, "r");
+  if (file == nullptr) return false;
+  char list[4096];
+  bool read = fgets(list, sizeof(list), file) != nullptr;
+  fclose(file);
+  if (!read) return false;
+  CPU_ZERO(cpus);
+  char* p = list;
+  while (*p >= '0' && *p <= '9') {
+    long first = strtol(p, &p, 10);
+    long last = first;
+    if (*p == '-') last = strtol(p + 1, &p, 10);
+    for (long cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, cpus);
+    }
+    if (*p == ',') p++;
+  }
+  return true;
+}
+
+/* Sets up one neighborhood per cpu or per NUMA node the process may run on,
+   in g_neighborhood_cpus, and returns how many there are. Returns 0 if the
+   topology is unknown. */
+static size_t poller_affinity_init(void) {
+  cpu_set_t allowed;
+  if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) {
+    gpr_log(GPR_ERROR, "sched_getaffinity failed: %s", strerror(errno));
+    return 0;
+  }
+  std::vector<cpu_set_t> neighborhoods;
+  if (g_affinity == AFFINITY_NUMA) {
+    for (int node = 0; node < MAX_NUMA_NODES; node++) {
+      cpu_set_t cpus;
+      if (!read_numa_node_cpus(node, &cpus)) continue;
+      CPU_AND(&cpus, &cpus, &allowed);
+      if (CPU_COUNT(&cpus) > 0) neighborhoods.push_back(cpus);
+    }
+    if (neighborhoods.empty()) {
+      gpr_log(GPR_ERROR, "No NUMA topology, using the cpu poller affinity");
+      g_affinity = AFFINITY_CPU;
+    }
+  }
+  if (g_affinity == AFFINITY_CPU) {
+    /* Past MAX_NEIGHBORHOODS cpus, neighborhoods take several */
+    size_t n = 0;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (!CPU_ISSET(cpu, &allowed)) continue;
+      if (n < MAX_NEIGHBORHOODS) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        neighborhoods.push_back(cpus);
+      }
+      CPU_SET(cpu, &neighborhoods[n % MAX_NEIGHBORHOODS]);
+      n++;
+    }
+  }
+  if (neighborhoods.empty()) return 0;
+  g_neighborhood_cpus = static_cast<cpu_set_t*>(
+      gpr_malloc(sizeof(*g_neighborhood_cpus) * neighborhoods.size()));
+  for (size_t i = 0; i < neighborhoods.size(); i++) {
+    g_neighborhood_cpus[i] = neighborhoods[i];
+    std::vector<int> cpus;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &neighborhoods[i])) cpus.push_back(cpu);
+    }
+    gpr_log(GPR_INFO, "epoll1 poller neighborhood %" PRIuPTR ": cpus %s", i,
+            absl::StrJoin(cpus, ",").c_str());
+  }
+  return neighborhoods.size();
+}
+
+/* Binds the current thread to the cpus of the neighborhood, with an affinity.
+   Called with the pollset of the neighborhood locked. */
+static void bind_current_thread(pollset_neighborhood* neighborhood) {
+  if (g_affinity == AFFINITY_NONE || g_current_thread_binding == neighborhood) {
+    return;
+  }
+  g_current_thread_binding = neighborhood;
+  size_t i = static_cast<size_t>(neighborhood - g_neighborhoods);
+  int err = pthread_setaffinity_np(pthread_self(), sizeof(cpu_set_t),
+                                   &g_neighborhood_cpus[i]);
+  if (err != 0) {
+    gpr_log(GPR_ERROR, "pthread_setaffinity_np failed: %s", strerror(err));
+  } else if (GRPC_TRACE_FLAG_ENABLED(grpc_polling_trace)) {
+    gpr_log(GPR_INFO, "bound thread to poller neighborhood %" PRIuPTR, i);
+  }
+}
+
+int grpc_epoll1_pollset_affinity(grpc_pollset* pollset, cpu_set_t* cpus) {
+  if (g_affinity == AFFINITY_NONE) return -1;
+  gpr_mu_lock(&pollset->mu);
+  size_t i = static_cast<size_t>(pollset->neighborhood - g_neighborhoods);
+  gpr_mu_unlock(&pollset->mu);
+  if (cpus != nullptr) *cpus = g_neighborhood_cpus[i];
+  return static_cast<int>(i);
+}
+
 static grpc_error_handle pollset_global_init(void) {
   gpr_atm_no_barrier_store(&g_active_poller, 0);
   global_wakeup_fd.read_fd = -1;
@@ -525,8 +667,15 @@ static grpc_error_handle pollset_global_init(void) {
                 &ev) != 0) {
     return GRPC_OS_ERROR(errno, "epoll_ctl");
   }
+  g_affinity = parse_poller_affinity();
   g_num_neighborhoods =
-      grpc_core::Clamp(gpr_cpu_num_cores(), 1u, MAX_NEIGHBORHOODS);
+      g_affinity == AFFINITY_NONE ? 0 : poller_affinity_init();
+  gpr_atm_no_barrier_store(&g_next_neighborhood, 0);
+  if (g_num_neighborhoods == 0) {
+    g_affinity = AFFINITY_NONE;
+    g_num_neighborhoods =
+        grpc_core::Clamp(gpr_cpu_num_cores(), 1u, MAX_NEIGHBORHOODS);
+  }
   g_neighborhoods = static_cast<pollset_neighborhood*>(
       gpr_zalloc(sizeof(*g_neighborhoods) * g_num_neighborhoods));
   for (size_t i = 0; i < g_num_neighborhoods; i++) {
@@ -541,12 +690,22 @@ static void pollset_global_shutdown(void) {
     gpr_mu_destroy(&g_neighborhoods[i].mu);
   }
   gpr_free(g_neighborhoods);
+  gpr_free(g_neighborhood_cpus);
+  g_neighborhood_cpus = nullptr;
+  g_affinity = AFFINITY_NONE;
 }
 
 static void pollset_init(grpc_pollset* pollset, gpr_mu** mu) {
   gpr_mu_init(&pollset->mu);
   *mu = &pollset->mu;
-  pollset->neighborhood = &g_neighborhoods[choose_neighborhood()];
+  if (g_affinity == AFFINITY_NONE) {
+    pollset->neighborhood = &g_neighborhoods[choose_neighborhood()];
+  } else {
+    pollset->neighborhood =
+        &g_neighborhoods[static_cast<size_t>(gpr_atm_no_barrier_fetch_add(
+                             &g_next_neighborhood, 1)) %
+                         g_num_neighborhoods];
+  }
   pollset->reassigning_neighborhood = false;
   pollset->root_worker = nullptr;
   pollset->kicked_without_poller = false;
@@ -760,7 +919,8 @@ static bool begin_worker(grpc_pollset* pollset, grpc_pollset_worker* worker,
     // pollset has been observed to be inactive, we need to move back to the
     // active list
     bool is_reassigning = false;
-    if (!pollset->reassigning_neighborhood) {
+    /* With an affinity, pollsets stay in their neighborhood */
+    if (!pollset->reassigning_neighborhood && g_affinity == AFFINITY_NONE) {
       is_reassigning = true;
       pollset->reassigning_neighborhood = true;
       pollset->neighborhood = &g_neighborhoods[choose_neighborhood()];
@@ -1022,6 +1182,7 @@ static grpc_error_handle pollset_work(grpc_pollset* ps,
     return GRPC_ERROR_NONE;
   }
 
+  bind_current_thread(ps->neighborhood);
   if (begin_worker(ps, &worker, worker_hdl, deadline)) {
     g_current_thread_pollset = ps;
     g_current_thread_worker = &worker;
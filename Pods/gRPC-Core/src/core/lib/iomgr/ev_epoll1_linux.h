@@ -28,4 +28,14 @@
 
 const grpc_event_engine_vtable* grpc_init_epoll1_linux(bool explicit_request);
 
+#ifdef GRPC_LINUX_EPOLL
+#include <sched.h>
+
+/* With GRPC_POLLER_AFFINITY set to cpu or numa, returns the index of the
+   neighborhood of an epoll1 pollset, such as a completion queue's, and sets
+   cpus, if not null, to the cpus its workers are bound to. Returns -1
+   otherwise. */
+int grpc_epoll1_pollset_affinity(grpc_pollset* pollset, cpu_set_t* cpus);
+#endif /* GRPC_LINUX_EPOLL */
+
 #endif /* GRPC_CORE_LIB_IOMGR_EV_EPOLL1_LINUX_H */
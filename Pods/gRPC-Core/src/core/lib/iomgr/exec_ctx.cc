@@ -77,6 +77,16 @@ static grpc_millis timespec_to_millis_round_down(gpr_timespec ts) {
   return timespan_to_millis_round_down(gpr_time_sub(ts, g_start_time));
 }
 
+// Converts ts to the clock that grpc_millis count on, through the current
+// ExecCtx's stored clock readings if there is one.
+static gpr_timespec convert_to_start_clock(gpr_timespec ts) {
+  grpc_core::ExecCtx* exec_ctx = grpc_core::ExecCtx::Get();
+  if (exec_ctx == nullptr) {
+    return gpr_convert_clock_type(ts, g_start_time.clock_type);
+  }
+  return exec_ctx->ConvertClockType(ts, g_start_time.clock_type);
+}
+
 static grpc_millis timespan_to_millis_round_up(gpr_timespec ts) {
   double x = GPR_MS_PER_SEC * static_cast<double>(ts.tv_sec) +
              static_cast<double>(ts.tv_nsec) / GPR_NS_PER_MS +
@@ -107,18 +117,20 @@ gpr_timespec grpc_millis_to_timespec(grpc_millis millis,
   if (clock_type == GPR_TIMESPAN) {
     return gpr_time_from_millis(millis, GPR_TIMESPAN);
   }
-  return gpr_time_add(gpr_convert_clock_type(g_start_time, clock_type),
-                      gpr_time_from_millis(millis, GPR_TIMESPAN));
+  grpc_core::ExecCtx* exec_ctx = grpc_core::ExecCtx::Get();
+  gpr_timespec start_time =
+      exec_ctx == nullptr
+          ? gpr_convert_clock_type(g_start_time, clock_type)
+          : exec_ctx->ConvertClockType(g_start_time, clock_type);
+  return gpr_time_add(start_time, gpr_time_from_millis(millis, GPR_TIMESPAN));
 }
 
 grpc_millis grpc_timespec_to_millis_round_down(gpr_timespec ts) {
-  return timespec_to_millis_round_down(
-      gpr_convert_clock_type(ts, g_start_time.clock_type));
+  return timespec_to_millis_round_down(convert_to_start_clock(ts));
 }
 
 grpc_millis grpc_timespec_to_millis_round_up(gpr_timespec ts) {
-  return timespec_to_millis_round_up(
-      gpr_convert_clock_type(ts, g_start_time.clock_type));
+  return timespec_to_millis_round_up(convert_to_start_clock(ts));
 }
 
 grpc_millis grpc_cycle_counter_to_millis_round_down(gpr_cycle_counter cycles) {
@@ -174,12 +186,36 @@ bool ExecCtx::Flush() {
 
 grpc_millis ExecCtx::Now() {
   if (!now_is_valid_) {
-    now_ = timespec_to_millis_round_down(gpr_now(GPR_CLOCK_MONOTONIC));
+    now_ = timespec_to_millis_round_down(
+        clocks_are_valid_ ? monotonic_clock_ : gpr_now(GPR_CLOCK_MONOTONIC));
     now_is_valid_ = true;
   }
   return now_;
 }
 
+gpr_timespec ExecCtx::ConvertClockType(gpr_timespec ts,
+                                      gpr_clock_type clock_type) {
+  auto is_clock = [](gpr_clock_type type) {
+    return type == GPR_CLOCK_MONOTONIC || type == GPR_CLOCK_REALTIME;
+  };
+  if (ts.clock_type == clock_type || !is_clock(ts.clock_type) ||
+      !is_clock(clock_type) || ts.tv_sec == INT64_MAX ||
+      ts.tv_sec == INT64_MIN) {
+    return gpr_convert_clock_type(ts, clock_type);
+  }
+  if (!clocks_are_valid_) {
+    monotonic_clock_ = gpr_now(GPR_CLOCK_MONOTONIC);
+    realtime_clock_ = gpr_now(GPR_CLOCK_REALTIME);
+    clocks_are_valid_ = true;
+  }
+  const gpr_timespec& from = ts.clock_type == GPR_CLOCK_MONOTONIC
+                                 ? monotonic_clock_
+                                 : realtime_clock_;
+  const gpr_timespec& to =
+      clock_type == GPR_CLOCK_MONOTONIC ? monotonic_clock_ : realtime_clock_;
+  return gpr_time_add(to, gpr_time_sub(ts, from));
+}
+
 void ExecCtx::Run(const DebugLocation& location, grpc_closure* closure,
                   grpc_error_handle error) {
   (void)location;
@@ -191,10 +191,21 @@ class ExecCtx {
    */
   grpc_millis Now();
 
+  /** Converts \a ts between GPR_CLOCK_MONOTONIC and GPR_CLOCK_REALTIME like
+   *  gpr_convert_clock_type, but with clock readings that are stored and
+   *  reused the way Now() is, so that converting several deadlines in one
+   *  ExecCtx reads the clocks once. Other conversions are passed through to
+   *  gpr_convert_clock_type.
+   */
+  gpr_timespec ConvertClockType(gpr_timespec ts, gpr_clock_type clock_type);
+
   /** Invalidates the stored time value. A new time value will be set on calling
    *  Now().
    */
-  void InvalidateNow() { now_is_valid_ = false; }
+  void InvalidateNow() {
+    now_is_valid_ = false;
+    clocks_are_valid_ = false;
+  }
 
   /** To be used only by shutdown code in iomgr */
   void SetNowIomgrShutdown() {
@@ -247,6 +258,10 @@ class ExecCtx {
   bool now_is_valid_ = false;
   grpc_millis now_ = 0;
 
+  bool clocks_are_valid_ = false;
+  gpr_timespec monotonic_clock_;
+  gpr_timespec realtime_clock_;
+
   static GPR_THREAD_LOCAL(ExecCtx*) exec_ctx_;
   ExecCtx* last_exec_ctx_ = Get();
 };
@@ -22,19 +22,31 @@
 
 #include <string.h>
 
+#include <atomic>
+
+#include "absl/strings/str_split.h"
+#include "absl/strings/string_view.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/sync.h>
 
+#include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/core/lib/gprpp/memory.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 
 #define MAX_DEPTH 2
 
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_work_stealing_executors, "",
+    "A comma-separated list of the executors whose threads steal work from "
+    "each other: \"default\", \"resolver\", or \"all\".")
+
 #define EXECUTOR_TRACE(format, ...)                       \
   do {                                                    \
     if (GRPC_TRACE_FLAG_ENABLED(executor_trace)) {        \
@@ -84,13 +96,63 @@ const EnqueueFunc
                              {{default_enqueue_short, default_enqueue_long},
                               {resolver_enqueue_short, resolver_enqueue_long}};
 
+bool UseWorkStealing(absl::string_view executor) {
+  UniquePtr<char> value = GPR_GLOBAL_CONFIG_GET(grpc_work_stealing_executors);
+  for (absl::string_view name : absl::StrSplit(value.get(), ',')) {
+    if (name == "all" || name == executor) return true;
+  }
+  return false;
+}
+
 }  // namespace
 
 TraceFlag executor_trace(false, "executor");
 
-Executor::Executor(const char* name) : name_(name) {
+// A bounded work-stealing deque of closures, after Chase and Lev. Only the
+// owner thread pushes, at the bottom. Every thread, the owner included, takes
+// from the top, so the closures of one thread start in the order they were
+// scheduled.
+class WorkStealingDeque {
+ public:
+  // Returns false if the deque is full. Only called by the owner thread.
+  bool Push(grpc_closure* closure) {
+    int64_t b = bottom_.load(std::memory_order_relaxed);
+    int64_t t = top_.load(std::memory_order_acquire);
+    if (b - t >= kCapacity) return false;
+    buffer_[b & (kCapacity - 1)].store(closure, std::memory_order_relaxed);
+    bottom_.store(b + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Returns nullptr if the deque is empty, or if another thread took the top
+  // closure first.
+  grpc_closure* Steal() {
+    int64_t t = top_.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t b = bottom_.load(std::memory_order_acquire);
+    if (t >= b) return nullptr;
+    grpc_closure* closure =
+        buffer_[t & (kCapacity - 1)].load(std::memory_order_relaxed);
+    if (!top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst,
+                                      std::memory_order_relaxed)) {
+      return nullptr;
+    }
+    return closure;
+  }
+
+ private:
+  static constexpr int64_t kCapacity = 1024;
+
+  std::atomic<int64_t> top_{0};
+  std::atomic<int64_t> bottom_{0};
+  std::atomic<grpc_closure*> buffer_[kCapacity] = {};
+};
+
+Executor::Executor(const char* name, bool work_stealing)
+    : name_(name), work_stealing_(work_stealing) {
   adding_thread_lock_ = GPR_SPINLOCK_STATIC_INITIALIZER;
   gpr_atm_rel_store(&num_threads_, 0);
+  gpr_atm_rel_store(&queue_depth_, 0);
   max_threads_ = std::max(1u, 2 * gpr_cpu_num_cores());
 }
 
@@ -167,9 +229,25 @@ void Executor::SetThreading(bool threading) {
       thd_state_[i].name = name_;
       thd_state_[i].thd = Thread();
       thd_state_[i].elems = GRPC_CLOSURE_LIST_INIT;
+      thd_state_[i].executor = this;
+      if (work_stealing_) {
+        thd_state_[i].deque = new WorkStealingDeque();
+      }
+    }
+
+    if (work_stealing_) {
+      gpr_mu_init(&mu_);
+      gpr_cv_init(&cv_);
+      injected_ = GRPC_CLOSURE_LIST_INIT;
+      gpr_atm_rel_store(&shutdown_, 0);
+      gpr_atm_rel_store(&idle_threads_, 0);
     }
 
-    thd_state_[0].thd = Thread(name_, &Executor::ThreadMain, &thd_state_[0]);
+    thd_state_[0].thd =
+        Thread(name_,
+               work_stealing_ ? &Executor::WorkStealingThreadMain
+                              : &Executor::ThreadMain,
+               &thd_state_[0]);
     thd_state_[0].thd.Start();
   } else {  // !threading
     if (curr_num_threads == 0) {
@@ -177,6 +255,13 @@ void Executor::SetThreading(bool threading) {
       return;
     }
 
+    if (work_stealing_) {
+      gpr_mu_lock(&mu_);
+      gpr_atm_rel_store(&shutdown_, 1);
+      gpr_cv_broadcast(&cv_);
+      gpr_mu_unlock(&mu_);
+    }
+
     for (size_t i = 0; i < max_threads_; i++) {
       gpr_mu_lock(&thd_state_[i].mu);
       thd_state_[i].shutdown = true;
@@ -203,7 +288,17 @@ void Executor::SetThreading(bool threading) {
       RunClosures(thd_state_[i].name, thd_state_[i].elems);
     }
 
+    if (work_stealing_) {
+      DrainWorkStealing();
+      for (size_t i = 0; i < max_threads_; i++) {
+        delete thd_state_[i].deque;
+      }
+      gpr_mu_destroy(&mu_);
+      gpr_cv_destroy(&cv_);
+    }
+
     gpr_free(thd_state_);
+    gpr_atm_rel_store(&queue_depth_, 0);
 
     // grpc_iomgr_shutdown_background_closure() will close all the registered
     // fds in the background poller, and wait for all pending closures to
@@ -246,6 +341,9 @@ void Executor::ThreadMain(void* arg) {
 
     grpc_closure_list closures = ts->elems;
     ts->elems = GRPC_CLOSURE_LIST_INIT;
+    // All the closures queued since the last batch
+    gpr_atm_no_barrier_fetch_add(&ts->executor->queue_depth_,
+                                 -static_cast<gpr_atm>(ts->depth));
     gpr_mu_unlock(&ts->mu);
 
     EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: execute", ts->name, ts->id);
@@ -257,6 +355,168 @@ void Executor::ThreadMain(void* arg) {
   g_this_thread_state = nullptr;
 }
 
+void Executor::WorkStealingThreadMain(void* arg) {
+  ThreadState* ts = static_cast<ThreadState*>(arg);
+  g_this_thread_state = ts;
+
+  ExecCtx exec_ctx(GRPC_EXEC_CTX_FLAG_IS_INTERNAL_THREAD);
+
+  for (;;) {
+    grpc_closure* closure = ts->executor->TakeWork(ts);
+    if (closure == nullptr) {
+      EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: shutdown", ts->name, ts->id);
+      break;
+    }
+
+    EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: execute", ts->name, ts->id);
+
+    ExecCtx::Get()->InvalidateNow();
+    grpc_closure_list closures;
+    closures.head = closures.tail = closure;
+    RunClosures(ts->name, closures);
+  }
+
+  g_this_thread_state = nullptr;
+}
+
+grpc_closure* Executor::TakeWork(ThreadState* ts) {
+  for (;;) {
+    if (gpr_atm_acq_load(&shutdown_)) {
+      return nullptr;
+    }
+
+    grpc_closure* closure = ts->deque->Steal();
+    if (closure == nullptr) {
+      gpr_mu_lock(&mu_);
+      closure = injected_.head;
+      if (closure != nullptr) {
+        injected_.head = closure->next_data.next;
+        if (injected_.head == nullptr) injected_.tail = nullptr;
+        closure->next_data.next = nullptr;
+      }
+      gpr_mu_unlock(&mu_);
+    }
+    if (closure == nullptr) {
+      closure = StealWork(ts);
+    }
+    if (closure != nullptr) {
+      gpr_atm_full_fetch_add(&queue_depth_, -1);
+      return closure;
+    }
+
+    // Enqueue() adds to queue_depth_ before it checks idle_threads_, and this
+    // thread adds to idle_threads_ before it checks queue_depth_, so either
+    // this thread sees the new closure or Enqueue() wakes it up. The depth may
+    // be briefly negative, when a closure is taken before it is counted.
+    gpr_mu_lock(&mu_);
+    gpr_atm_full_fetch_add(&idle_threads_, 1);
+    while (gpr_atm_acq_load(&queue_depth_) <= 0 &&
+           !gpr_atm_acq_load(&shutdown_)) {
+      gpr_cv_wait(&cv_, &mu_, gpr_inf_future(GPR_CLOCK_MONOTONIC));
+    }
+    gpr_atm_full_fetch_add(&idle_threads_, -1);
+    gpr_mu_unlock(&mu_);
+  }
+}
+
+grpc_closure* Executor::StealWork(ThreadState* ts) {
+  size_t cur_thread_count =
+      static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+  for (size_t i = 1; i < cur_thread_count; i++) {
+    ThreadState* victim = &thd_state_[(ts->id + i) % cur_thread_count];
+    grpc_closure* closure = victim->deque->Steal();
+    if (closure != nullptr) {
+      GRPC_STATS_INC_EXECUTOR_CLOSURES_STOLEN();
+      EXECUTOR_TRACE("(%s) [%" PRIdPTR "]: stole %p from [%" PRIdPTR "]",
+                     name_, ts->id, closure, victim->id);
+      return closure;
+    }
+  }
+  return nullptr;
+}
+
+void Executor::DrainWorkStealing() {
+  // The threads are joined, so nothing else touches the deques
+  for (size_t i = 0; i < max_threads_; i++) {
+    grpc_closure_list closures = GRPC_CLOSURE_LIST_INIT;
+    while (grpc_closure* closure = thd_state_[i].deque->Steal()) {
+      grpc_closure_list_append(&closures, closure);
+    }
+    RunClosures(name_, closures);
+  }
+  RunClosures(name_, injected_);
+  injected_ = GRPC_CLOSURE_LIST_INIT;
+}
+
+void Executor::EnqueueWorkStealing(grpc_closure* closure,
+                                   grpc_error_handle error, bool is_short) {
+  // Stores the error in the closure, like the closure lists do
+  grpc_closure_list closures = GRPC_CLOSURE_LIST_INIT;
+  grpc_closure_list_append(&closures, closure, error);
+
+  if (is_short) {
+    GRPC_STATS_INC_EXECUTOR_SCHEDULED_SHORT_ITEMS();
+  } else {
+    GRPC_STATS_INC_EXECUTOR_SCHEDULED_LONG_ITEMS();
+  }
+
+  // Long closures go to the shared list, so that they don't hold back the
+  // short ones that this thread queues after them.
+  ThreadState* ts = g_this_thread_state;
+  if (ts != nullptr && ts->executor == this && is_short &&
+      ts->deque->Push(closure)) {
+    GRPC_STATS_INC_EXECUTOR_SCHEDULED_TO_SELF();
+#ifndef NDEBUG
+    EXECUTOR_TRACE("(%s) schedule %p (created %s:%d) to own thread %" PRIdPTR,
+                   name_, closure, closure->file_created, closure->line_created,
+                   ts->id);
+#else
+    EXECUTOR_TRACE("(%s) schedule %p to own thread %" PRIdPTR, name_, closure,
+                   ts->id);
+#endif
+  } else {
+    gpr_mu_lock(&mu_);
+    grpc_closure_list_append(&injected_, closure);
+    gpr_mu_unlock(&mu_);
+#ifndef NDEBUG
+    EXECUTOR_TRACE("(%s) schedule %p (%s) (created %s:%d) to shared list",
+                   name_, closure, is_short ? "short" : "long",
+                   closure->file_created, closure->line_created);
+#else
+    EXECUTOR_TRACE("(%s) schedule %p (%s) to shared list", name_, closure,
+                   is_short ? "short" : "long");
+#endif
+  }
+
+  gpr_atm depth = gpr_atm_full_fetch_add(&queue_depth_, 1);
+  GRPC_STATS_INC_EXECUTOR_QUEUE_DEPTH(depth);
+
+  if (gpr_atm_acq_load(&idle_threads_) > 0) {
+    GRPC_STATS_INC_EXECUTOR_WAKEUP_INITIATED();
+    gpr_mu_lock(&mu_);
+    gpr_cv_signal(&cv_);
+    gpr_mu_unlock(&mu_);
+    return;
+  }
+
+  // Every thread is busy. A long closure may keep its thread busy for good, so
+  // it always asks for a new thread. Short ones only do once they pile up.
+  if ((!is_short || depth >= MAX_DEPTH) &&
+      gpr_spinlock_trylock(&adding_thread_lock_)) {
+    size_t cur_thread_count =
+        static_cast<size_t>(gpr_atm_acq_load(&num_threads_));
+    if (cur_thread_count < max_threads_ && !gpr_atm_acq_load(&shutdown_)) {
+      gpr_atm_rel_store(&num_threads_, cur_thread_count + 1);
+
+      thd_state_[cur_thread_count].thd =
+          Thread(name_, &Executor::WorkStealingThreadMain,
+                 &thd_state_[cur_thread_count]);
+      thd_state_[cur_thread_count].thd.Start();
+    }
+    gpr_spinlock_unlock(&adding_thread_lock_);
+  }
+}
+
 void Executor::Enqueue(grpc_closure* closure, grpc_error_handle error,
                        bool is_short) {
   bool retry_push;
@@ -283,6 +543,11 @@ void Executor::Enqueue(grpc_closure* closure, grpc_error_handle error,
       return;
     }
 
+    if (work_stealing_) {
+      EnqueueWorkStealing(closure, error, is_short);
+      return;
+    }
+
     ThreadState* ts = g_this_thread_state;
     if (ts == nullptr) {
       ts = &thd_state_[HashPointer(ExecCtx::Get(), cur_thread_count)];
@@ -342,6 +607,8 @@ void Executor::Enqueue(grpc_closure* closure, grpc_error_handle error,
       }
 
       grpc_closure_list_append(&ts->elems, closure, error);
+      GRPC_STATS_INC_EXECUTOR_QUEUE_DEPTH(
+          gpr_atm_no_barrier_fetch_add(&queue_depth_, 1));
 
       // If we already queued more than MAX_DEPTH number of closures on this
       // thread, use this as a hint to create more threads
@@ -385,9 +652,9 @@ void Executor::InitAll() {
   }
 
   executors[static_cast<size_t>(ExecutorType::DEFAULT)] =
-      new Executor("default-executor");
+      new Executor("default-executor", UseWorkStealing("default"));
   executors[static_cast<size_t>(ExecutorType::RESOLVER)] =
-      new Executor("resolver-executor");
+      new Executor("resolver-executor", UseWorkStealing("resolver"));
 
   executors[static_cast<size_t>(ExecutorType::DEFAULT)]->Init();
   executors[static_cast<size_t>(ExecutorType::RESOLVER)]->Init();
@@ -443,6 +710,16 @@ bool Executor::IsThreadedDefault() {
   return Executor::IsThreaded(ExecutorType::DEFAULT);
 }
 
+size_t Executor::QueueDepth() const {
+  gpr_atm depth = gpr_atm_acq_load(&queue_depth_);
+  return depth > 0 ? static_cast<size_t>(depth) : 0;
+}
+
+size_t Executor::QueueDepth(ExecutorType executor_type) {
+  GPR_ASSERT(executor_type < ExecutorType::NUM_EXECUTORS);
+  return executors[static_cast<size_t>(executor_type)]->QueueDepth();
+}
+
 void Executor::SetThreadingAll(bool enable) {
   EXECUTOR_TRACE("Executor::SetThreadingAll(%d) called", enable);
   for (size_t i = 0; i < static_cast<size_t>(ExecutorType::NUM_EXECUTORS);
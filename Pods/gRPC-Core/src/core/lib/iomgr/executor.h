@@ -27,6 +27,9 @@
 
 namespace grpc_core {
 
+class Executor;
+class WorkStealingDeque;
+
 struct ThreadState {
   gpr_mu mu;
   size_t id;         // For debugging purposes
@@ -37,6 +40,8 @@ struct ThreadState {
   bool shutdown;
   bool queued_long_job;
   Thread thd;
+  Executor* executor;        // The executor that owns this thread state
+  WorkStealingDeque* deque;  // Only used by work-stealing executors
 };
 
 enum class ExecutorType {
@@ -52,9 +57,15 @@ enum class ExecutorJobType {
   NUM_JOB_TYPES  // Add new values above this
 };
 
+// By default, an executor hashes closures onto the closure lists of its
+// threads. A work-stealing executor instead queues the closures that its own
+// threads schedule on per-thread lock-free deques, and the closures scheduled
+// from other threads on a shared list. Idle threads steal from the deques of
+// busy ones, so short closures don't wait behind long ones. The
+// GRPC_WORK_STEALING_EXECUTORS config selects which executors steal work.
 class Executor {
  public:
-  explicit Executor(const char* executor_name);
+  explicit Executor(const char* executor_name, bool work_stealing = false);
 
   void Init();
 
@@ -72,6 +83,9 @@ class Executor {
    * a short job (i.e expected to not block and complete quickly) */
   void Enqueue(grpc_closure* closure, grpc_error_handle error, bool is_short);
 
+  /** Number of closures enqueued that have not started running yet */
+  size_t QueueDepth() const;
+
   // TODO(sreek): Currently we have two executors (available globally): The
   // default executor and the resolver executor.
   //
@@ -103,15 +117,36 @@ class Executor {
   // Return if the DEFAULT executor is threaded
   static bool IsThreadedDefault();
 
+  // Return the number of closures waiting in a given executor
+  static size_t QueueDepth(ExecutorType executor_type);
+
  private:
   static size_t RunClosures(const char* executor_name, grpc_closure_list list);
   static void ThreadMain(void* arg);
+  static void WorkStealingThreadMain(void* arg);
+
+  void EnqueueWorkStealing(grpc_closure* closure, grpc_error_handle error,
+                           bool is_short);
+  // Returns the next closure for ts to run, or nullptr once shutdown
+  grpc_closure* TakeWork(ThreadState* ts);
+  grpc_closure* StealWork(ThreadState* ts);
+  // Runs the closures left in the deques and the shared list
+  void DrainWorkStealing();
 
   const char* name_;
   ThreadState* thd_state_;
   size_t max_threads_;
   gpr_atm num_threads_;
   gpr_spinlock adding_thread_lock_;
+  gpr_atm queue_depth_;
+
+  const bool work_stealing_;
+  // The fields below are only used by work-stealing executors
+  gpr_mu mu_;
+  gpr_cv cv_;
+  grpc_closure_list injected_;  // Closures scheduled from other threads
+  gpr_atm shutdown_;
+  gpr_atm idle_threads_;
 };
 
 // Global initializer for executor
@@ -28,7 +28,10 @@
 /// "ev_apple" by setting environment variable "GRPC_CFSTREAM_RUN_LOOP=1". This
 /// pollset resolves a bug from Apple when CFStream streams dispatch events to
 /// dispatch queues. The caveat of this pollset is that users may not be able to
-/// run a gRPC server in the same process.
+/// run a gRPC server in the same process. Finally, with the dispatch queue
+/// pollset, setting environment variable "GRPC_APPLE_NETWORK_FRAMEWORK=1" makes
+/// client connections use Network.framework instead of CFStream, where the OS
+/// supports it.
 
 #include <grpc/support/port_platform.h>
 
@@ -41,6 +44,7 @@
 #include "src/core/lib/iomgr/ev_posix.h"
 #include "src/core/lib/iomgr/iomgr_internal.h"
 #include "src/core/lib/iomgr/resolve_address.h"
+#include "src/core/lib/iomgr/resolve_address_cache.h"
 #include "src/core/lib/iomgr/resolve_address_posix.h"
 #include "src/core/lib/iomgr/tcp_client.h"
 #include "src/core/lib/iomgr/tcp_posix.h"
@@ -49,11 +53,15 @@
 
 static const char* grpc_cfstream_env_var = "grpc_cfstream";
 static const char* grpc_cfstream_run_loop_env_var = "GRPC_CFSTREAM_RUN_LOOP";
+static const char* grpc_apple_network_framework_env_var =
+    "GRPC_APPLE_NETWORK_FRAMEWORK";
 
 extern grpc_tcp_server_vtable grpc_posix_tcp_server_vtable;
 extern grpc_tcp_client_vtable grpc_posix_tcp_client_vtable;
 extern grpc_tcp_client_vtable grpc_cfstream_client_vtable;
-extern grpc_timer_vtable grpc_generic_timer_vtable;
+#ifdef GRPC_APPLE_NETWORK_ENDPOINT
+extern grpc_tcp_client_vtable grpc_network_client_vtable;
+#endif
 extern grpc_pollset_vtable grpc_posix_pollset_vtable;
 extern grpc_pollset_set_vtable grpc_posix_pollset_set_vtable;
 
@@ -88,6 +96,7 @@ namespace {
 struct CFStreamEnv {
   bool enable_cfstream;
   bool enable_cfstream_run_loop;
+  bool enable_network_framework;
 };
 
 // Parses environment variables for CFStream specific settings
@@ -101,6 +110,10 @@ CFStreamEnv ParseEnvForCFStream() {
   // explicitly with environment variable.
   env.enable_cfstream_run_loop = enable_cfstream_run_loop_str != nullptr &&
                                  enable_cfstream_run_loop_str[0] == '1';
+  char* enable_network_framework_str =
+      getenv(grpc_apple_network_framework_env_var);
+  env.enable_network_framework = enable_network_framework_str != nullptr &&
+                                 enable_network_framework_str[0] == '1';
   return env;
 }
 
@@ -117,6 +130,20 @@ void MaybeShutdownTcpPosix(void) {
     grpc_tcp_posix_shutdown();
   }
 }
+
+// Network.framework connections run on their own dispatch queues, so they
+// don't mix with the CFRunLoop pollset
+grpc_tcp_client_vtable* DispatchQueueClientVtable(const CFStreamEnv& env) {
+#ifdef GRPC_APPLE_NETWORK_ENDPOINT
+  if (env.enable_network_framework) {
+    if (__builtin_available(iOS 12.0, macOS 10.14, tvOS 12.0, watchOS 5.0,
+                            *)) {
+      return &grpc_network_client_vtable;
+    }
+  }
+#endif
+  return &grpc_cfstream_client_vtable;
+}
 }  // namespace
 
 static void iomgr_platform_init(void) {
@@ -164,8 +191,9 @@ void grpc_set_default_iomgr_platform() {
     grpc_set_pollset_set_vtable(&grpc_posix_pollset_set_vtable);
     grpc_set_iomgr_platform_vtable(&vtable);
   } else if (env.enable_cfstream && !env.enable_cfstream_run_loop) {
-    // Use CFStream with dispatch queue for client; use POSIX sockets for server
-    grpc_set_tcp_client_impl(&grpc_cfstream_client_vtable);
+    // Use CFStream (or Network.framework) with dispatch queue for client; use
+    // POSIX sockets for server
+    grpc_set_tcp_client_impl(DispatchQueueClientVtable(env));
     grpc_set_tcp_server_impl(&grpc_posix_tcp_server_vtable);
     grpc_set_pollset_vtable(&grpc_posix_pollset_vtable);
     grpc_set_pollset_set_vtable(&grpc_posix_pollset_set_vtable);
@@ -177,8 +205,9 @@ void grpc_set_default_iomgr_platform() {
     grpc_set_pollset_set_vtable(&grpc_apple_pollset_set_vtable);
     grpc_set_iomgr_platform_vtable(&apple_vtable);
   }
-  grpc_set_timer_impl(&grpc_generic_timer_vtable);
-  grpc_core::SetDNSResolver(grpc_core::NativeDNSResolver::GetOrCreate());
+  grpc_set_timer_impl(grpc_configured_timer_impl());
+  grpc_core::SetDNSResolver(grpc_core::CachingDNSResolver::MaybeWrap(
+      grpc_core::NativeDNSResolver::GetOrCreate()));
 }
 
 bool grpc_iomgr_run_in_background() {
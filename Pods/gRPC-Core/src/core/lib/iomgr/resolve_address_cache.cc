@@ -0,0 +1,199 @@
+//
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/resolve_address_cache.h"
+
+#include <algorithm>
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/iomgr/resolve_address_impl.h"
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_dns_cache_ttl_ms, 30000,
+    "How long, in milliseconds, resolved addresses are cached for. 0 disables "
+    "the caching of successful resolutions.");
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_dns_negative_cache_ttl_ms, 5000,
+    "How long, in milliseconds, failed resolutions are cached for. 0 disables "
+    "the caching of failures.");
+
+namespace grpc_core {
+
+namespace {
+
+// Bounds the memory held by the cache; expired entries are evicted first
+constexpr size_t kMaxCacheEntries = 1024;
+
+}  // namespace
+
+class CachingDNSResolver::CachedRequest : public DNSResolver::Request {
+ public:
+  CachedRequest(
+      CachingDNSResolver* resolver, absl::string_view name,
+      absl::string_view default_port, grpc_pollset_set* interested_parties,
+      std::function<void(absl::StatusOr<std::vector<grpc_resolved_address>>)>
+          on_done)
+      : resolver_(resolver),
+        key_(std::string(name), std::string(default_port)),
+        interested_parties_(interested_parties),
+        on_done_(std::move(on_done)) {}
+
+  void Start() override { resolver_->StartRequest(Ref()); }
+
+  // Like the native resolver, the resolution can't be cancelled: the request
+  // stays alive, through the ref held by the cache, until on_done runs.
+  void Orphan() override { Unref(); }
+
+ private:
+  friend class CachingDNSResolver;
+
+  CachingDNSResolver* const resolver_;
+  const Key key_;
+  grpc_pollset_set* const interested_parties_;
+  std::function<void(absl::StatusOr<std::vector<grpc_resolved_address>>)>
+      on_done_;
+};
+
+CachingDNSResolver::CachingDNSResolver(DNSResolver* resolver, int ttl_ms,
+                                       int negative_ttl_ms)
+    : resolver_(resolver), ttl_ms_(ttl_ms), negative_ttl_ms_(negative_ttl_ms) {}
+
+DNSResolver* CachingDNSResolver::MaybeWrap(DNSResolver* resolver) {
+  static CachingDNSResolver* cache = [resolver]() -> CachingDNSResolver* {
+    int ttl_ms = GPR_GLOBAL_CONFIG_GET(grpc_dns_cache_ttl_ms);
+    int negative_ttl_ms = GPR_GLOBAL_CONFIG_GET(grpc_dns_negative_cache_ttl_ms);
+    if (ttl_ms <= 0 && negative_ttl_ms <= 0) return nullptr;
+    return new CachingDNSResolver(resolver, std::max(ttl_ms, 0),
+                                  std::max(negative_ttl_ms, 0));
+  }();
+  if (cache == nullptr) return resolver;
+  GPR_ASSERT(cache->resolver_ == resolver);
+  return cache;
+}
+
+OrphanablePtr<DNSResolver::Request> CachingDNSResolver::ResolveName(
+    absl::string_view name, absl::string_view default_port,
+    grpc_pollset_set* interested_parties,
+    std::function<void(absl::StatusOr<std::vector<grpc_resolved_address>>)>
+        on_done) {
+  return MakeOrphanable<CachedRequest>(this, name, default_port,
+                                       interested_parties, std::move(on_done));
+}
+
+absl::StatusOr<std::vector<grpc_resolved_address>>
+CachingDNSResolver::ResolveNameBlocking(absl::string_view name,
+                                        absl::string_view default_port) {
+  Key key{std::string(name), std::string(default_port)};
+  Result result;
+  {
+    MutexLock lock(&mu_);
+    if (Lookup(key, &result)) return result;
+  }
+  result = resolver_->ResolveNameBlocking(name, default_port);
+  MutexLock lock(&mu_);
+  Store(key, result);
+  return result;
+}
+
+void CachingDNSResolver::StartRequest(RefCountedPtr<CachedRequest> request) {
+  DNSResolver::Request* lookup = nullptr;
+  {
+    MutexLock lock(&mu_);
+    Result result;
+    if (Lookup(request->key_, &result)) {
+      new DNSCallbackExecCtxScheduler(std::move(request->on_done_),
+                                      std::move(result));
+      return;
+    }
+    Entry& entry = cache_[request->key_];
+    entry.waiters.push_back(request);
+    if (entry.in_flight) return;
+    // The first request for the name starts the lookup the others share
+    entry.in_flight = true;
+    Key key = request->key_;
+    entry.lookup = resolver_->ResolveName(
+        key.first, key.second, request->interested_parties_,
+        [this, key](Result result) { OnLookupDone(key, std::move(result)); });
+    lookup = entry.lookup.get();
+  }
+  // The entry can't be evicted while in flight, so lookup stays valid
+  lookup->Start();
+}
+
+void CachingDNSResolver::OnLookupDone(const Key& key, Result result) {
+  std::vector<RefCountedPtr<CachedRequest>> waiters;
+  OrphanablePtr<DNSResolver::Request> lookup;
+  {
+    MutexLock lock(&mu_);
+    Entry& entry = cache_[key];
+    entry.in_flight = false;
+    waiters.swap(entry.waiters);
+    lookup = std::move(entry.lookup);
+    Store(key, result);
+  }
+  // Like the lookup's own callback, these don't need to bounce through the
+  // ExecCtx: the lookup already runs them asynchronously.
+  for (auto& waiter : waiters) {
+    waiter->on_done_(result);
+  }
+}
+
+bool CachingDNSResolver::Lookup(const Key& key, Result* result) {
+  auto it = cache_.find(key);
+  if (it == cache_.end() || it->second.in_flight) return false;
+  if (gpr_time_cmp(it->second.expires, gpr_now(GPR_CLOCK_MONOTONIC)) <= 0) {
+    return false;
+  }
+  *result = it->second.result;
+  return true;
+}
+
+void CachingDNSResolver::Store(const Key& key, const Result& result) {
+  Entry& entry = cache_[key];
+  entry.result = result;
+  entry.expires = ExpiryFor(result);
+  if (cache_.size() <= kMaxCacheEntries) return;
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  for (auto it = cache_.begin(); it != cache_.end();) {
+    if (!it->second.in_flight && gpr_time_cmp(it->second.expires, now) <= 0) {
+      it = cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+  // Still full of fresh entries: drop some, other than the one just stored
+  for (auto it = cache_.begin();
+       it != cache_.end() && cache_.size() > kMaxCacheEntries;) {
+    if (!it->second.in_flight && it->first != key) {
+      it = cache_.erase(it);
+    } else {
+      ++it;
+    }
+  }
+}
+
+gpr_timespec CachingDNSResolver::ExpiryFor(const Result& result) const {
+  return gpr_time_add(
+      gpr_now(GPR_CLOCK_MONOTONIC),
+      gpr_time_from_millis(result.ok() ? ttl_ms_ : negative_ttl_ms_,
+                           GPR_TIMESPAN));
+}
+
+}  // namespace grpc_core
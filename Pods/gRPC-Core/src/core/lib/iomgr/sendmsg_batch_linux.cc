@@ -0,0 +1,236 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/sendmsg_batch_linux.h"
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_LINUX_IO_URING
+#include <linux/io_uring.h>
+#include <sys/syscall.h>
+#endif
+
+/* Sending through io_uring needs IORING_OP_SENDMSG, from linux 5.3. The ring
+   is only set up on first use, so older kernels merely fail that once. */
+#if defined(GRPC_LINUX_IO_URING) && defined(__NR_io_uring_setup) && \
+    defined(IORING_FEAT_SINGLE_MMAP)
+#include <errno.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include <algorithm>
+
+#include <grpc/support/sync.h>
+
+/* A ring used by a single submitter at a time: all the requests of a batch go
+   in and all their completions come out before the next batch */
+typedef struct sendmsg_ring {
+  int ring_fd;
+  /* The process that set the ring up. A forked child shares the ring with its
+     parent, so it must not use it. */
+  pid_t pid;
+
+  void* sq_ring;
+  size_t sq_ring_size;
+  void* cq_ring;
+  size_t cq_ring_size;
+  struct io_uring_sqe* sqes;
+  size_t sqes_size;
+
+  unsigned* sq_head;
+  unsigned* sq_tail;
+  unsigned* sq_mask;
+  unsigned* cq_head;
+  unsigned* cq_tail;
+  unsigned* cq_mask;
+  struct io_uring_cqe* cqes;
+} sendmsg_ring;
+
+static sendmsg_ring g_ring = {-1};
+static gpr_once g_once = GPR_ONCE_INIT;
+static gpr_mu g_mu;
+static bool g_init_attempted = false;
+
+static void init_mu() { gpr_mu_init(&g_mu); }
+
+static void* ring_mmap(size_t size, off_t offset) {
+  void* ptr = mmap(nullptr, size, PROT_READ | PROT_WRITE,
+                   MAP_SHARED | MAP_POPULATE, g_ring.ring_fd, offset);
+  return ptr == MAP_FAILED ? nullptr : ptr;
+}
+
+/* Called with g_mu held */
+static void ring_shutdown() {
+  if (g_ring.sqes != nullptr) munmap(g_ring.sqes, g_ring.sqes_size);
+  if (g_ring.cq_ring != nullptr && g_ring.cq_ring != g_ring.sq_ring) {
+    munmap(g_ring.cq_ring, g_ring.cq_ring_size);
+  }
+  if (g_ring.sq_ring != nullptr) munmap(g_ring.sq_ring, g_ring.sq_ring_size);
+  g_ring.sqes = nullptr;
+  g_ring.cq_ring = g_ring.sq_ring = nullptr;
+  if (g_ring.ring_fd >= 0) {
+    close(g_ring.ring_fd);
+    g_ring.ring_fd = -1;
+  }
+}
+
+/* Called with g_mu held */
+static bool ring_init() {
+  struct io_uring_params params;
+  memset(&params, 0, sizeof(params));
+  g_ring.ring_fd = static_cast<int>(
+      syscall(__NR_io_uring_setup, GRPC_SENDMSG_BATCH_MAX, &params));
+  if (g_ring.ring_fd < 0) {
+    gpr_log(GPR_INFO, "io_uring unavailable for batched sends: %s",
+            strerror(errno));
+    return false;
+  }
+  g_ring.pid = getpid();
+  g_ring.sq_ring_size =
+      params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  g_ring.cq_ring_size =
+      params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+  bool single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP) != 0;
+  if (single_mmap) {
+    g_ring.sq_ring_size = g_ring.cq_ring_size =
+        std::max(g_ring.sq_ring_size, g_ring.cq_ring_size);
+  }
+  g_ring.sq_ring = ring_mmap(g_ring.sq_ring_size, IORING_OFF_SQ_RING);
+  g_ring.cq_ring = single_mmap
+                       ? g_ring.sq_ring
+                       : ring_mmap(g_ring.cq_ring_size, IORING_OFF_CQ_RING);
+  g_ring.sqes_size = params.sq_entries * sizeof(struct io_uring_sqe);
+  g_ring.sqes = static_cast<struct io_uring_sqe*>(
+      ring_mmap(g_ring.sqes_size, IORING_OFF_SQES));
+  if (g_ring.sq_ring == nullptr || g_ring.cq_ring == nullptr ||
+      g_ring.sqes == nullptr) {
+    gpr_log(GPR_ERROR, "mapping the io_uring failed: %s", strerror(errno));
+    ring_shutdown();
+    return false;
+  }
+
+  char* sq = static_cast<char*>(g_ring.sq_ring);
+  g_ring.sq_head = reinterpret_cast<unsigned*>(sq + params.sq_off.head);
+  g_ring.sq_tail = reinterpret_cast<unsigned*>(sq + params.sq_off.tail);
+  g_ring.sq_mask = reinterpret_cast<unsigned*>(sq + params.sq_off.ring_mask);
+  /* Submission entry i always goes into slot i of the ring */
+  unsigned* sq_array = reinterpret_cast<unsigned*>(sq + params.sq_off.array);
+  for (unsigned i = 0; i < params.sq_entries; i++) {
+    sq_array[i] = i;
+  }
+  char* cq = static_cast<char*>(g_ring.cq_ring);
+  g_ring.cq_head = reinterpret_cast<unsigned*>(cq + params.cq_off.head);
+  g_ring.cq_tail = reinterpret_cast<unsigned*>(cq + params.cq_off.tail);
+  g_ring.cq_mask = reinterpret_cast<unsigned*>(cq + params.cq_off.ring_mask);
+  g_ring.cqes =
+      reinterpret_cast<struct io_uring_cqe*>(cq + params.cq_off.cqes);
+  return true;
+}
+
+/* Copies the available completions into results and returns how many there
+   were */
+static size_t ring_reap_completions(ssize_t* results) {
+  unsigned head = *g_ring.cq_head;
+  unsigned tail = __atomic_load_n(g_ring.cq_tail, __ATOMIC_ACQUIRE);
+  size_t n = 0;
+  for (; head != tail; head++, n++) {
+    const struct io_uring_cqe* cqe = &g_ring.cqes[head & *g_ring.cq_mask];
+    results[cqe->user_data] = cqe->res;
+  }
+  __atomic_store_n(g_ring.cq_head, head, __ATOMIC_RELEASE);
+  return n;
+}
+
+bool grpc_sendmsg_batch(const int* fds, struct msghdr* const* msgs,
+                        size_t count, int flags, ssize_t* results) {
+  GPR_ASSERT(count <= GRPC_SENDMSG_BATCH_MAX);
+  if (count == 0) return true;
+  gpr_once_init(&g_once, init_mu);
+  gpr_mu_lock(&g_mu);
+  if (!g_init_attempted) {
+    g_init_attempted = true;
+    ring_init();
+  }
+  if (g_ring.ring_fd < 0 || g_ring.pid != getpid()) {
+    gpr_mu_unlock(&g_mu);
+    return false;
+  }
+  /* The previous batch left the submission queue empty */
+  unsigned tail = *g_ring.sq_tail;
+  for (size_t i = 0; i < count; i++) {
+    struct io_uring_sqe* sqe = &g_ring.sqes[(tail + i) & *g_ring.sq_mask];
+    memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = IORING_OP_SENDMSG;
+    sqe->fd = fds[i];
+    sqe->addr = reinterpret_cast<uint64_t>(msgs[i]);
+    sqe->len = 1;
+    /* A send that can't go out right away fails with EAGAIN, as on a non
+       blocking socket, instead of waiting in the kernel */
+    sqe->msg_flags = static_cast<uint32_t>(flags | MSG_DONTWAIT);
+    sqe->user_data = i;
+  }
+  __atomic_store_n(g_ring.sq_tail, tail + static_cast<unsigned>(count),
+                   __ATOMIC_RELEASE);
+  /* The sends don't block, so waiting for all of them is short */
+  size_t submitted = 0;
+  size_t reaped = 0;
+  while (reaped < count) {
+    int r = static_cast<int>(
+        syscall(__NR_io_uring_enter, g_ring.ring_fd, count - submitted,
+                count - reaped, IORING_ENTER_GETEVENTS, nullptr, 0));
+    if (r >= 0) {
+      submitted += static_cast<size_t>(r);
+    } else if (errno != EINTR && errno != EAGAIN && errno != EBUSY) {
+      /* The kernel may still be reading the messages of a submitted request,
+         so those can't be given back */
+      GPR_ASSERT(submitted == 0);
+      gpr_log(GPR_ERROR, "io_uring_enter failed: %s", strerror(errno));
+      __atomic_store_n(g_ring.sq_tail, tail, __ATOMIC_RELEASE);
+      ring_shutdown();
+      gpr_mu_unlock(&g_mu);
+      return false;
+    }
+    reaped += ring_reap_completions(results);
+  }
+  gpr_mu_unlock(&g_mu);
+  return true;
+}
+
+void grpc_sendmsg_batch_shutdown() {
+  gpr_once_init(&g_once, init_mu);
+  gpr_mu_lock(&g_mu);
+  if (g_ring.pid == getpid()) ring_shutdown();
+  g_init_attempted = false;
+  gpr_mu_unlock(&g_mu);
+}
+
+#else /* defined(GRPC_LINUX_IO_URING) && ... */
+
+bool grpc_sendmsg_batch(const int* /*fds*/, struct msghdr* const* /*msgs*/,
+                        size_t /*count*/, int /*flags*/, ssize_t* /*results*/) {
+  return false;
+}
+
+void grpc_sendmsg_batch_shutdown() {}
+
+#endif /* !(defined(GRPC_LINUX_IO_URING) && ...) */
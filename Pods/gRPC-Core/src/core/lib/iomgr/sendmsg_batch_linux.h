@@ -0,0 +1,44 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#ifndef GRPC_CORE_LIB_IOMGR_SENDMSG_BATCH_LINUX_H
+#define GRPC_CORE_LIB_IOMGR_SENDMSG_BATCH_LINUX_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stddef.h>
+#include <sys/socket.h>
+#include <sys/types.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+/* The most messages grpc_sendmsg_batch() takes at once */
+#define GRPC_SENDMSG_BATCH_MAX 64
+
+/* Sends msgs[i] on fds[i], for count messages on as many sockets, through a
+   single io_uring_enter() call. Each send behaves as a non blocking
+   sendmsg(fds[i], msgs[i], flags) would, and results[i] is set to the number
+   of bytes it sent or to -errno. Returns false, having sent nothing, if
+   io_uring is unavailable. Thread safe. */
+bool grpc_sendmsg_batch(const int* fds, struct msghdr* const* msgs,
+                        size_t count, int flags, ssize_t* results);
+
+/* Releases the io_uring instance, if any */
+void grpc_sendmsg_batch_shutdown();
+
+#endif /* GRPC_CORE_LIB_IOMGR_SENDMSG_BATCH_LINUX_H */
@@ -0,0 +1,203 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/iomgr/port.h"
+
+#ifdef GRPC_APPLE_NETWORK_ENDPOINT
+
+#include <Network/Network.h>
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/address_utils/sockaddr_utils.h"
+#include "src/core/lib/channel/channel_args.h"
+#include "src/core/lib/iomgr/closure.h"
+#include "src/core/lib/iomgr/endpoint_network.h"
+#include "src/core/lib/iomgr/error.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/tcp_client.h"
+#include "src/core/lib/iomgr/timer.h"
+
+extern grpc_core::TraceFlag grpc_tcp_trace;
+
+struct NetworkConnect {
+  gpr_mu mu;
+
+  nw_connection_t connection;
+  dispatch_queue_t queue;
+
+  grpc_timer alarm;
+  grpc_closure on_alarm;
+
+  grpc_closure* closure;
+  grpc_endpoint** endpoint;
+  // One for the timer, one for the state handler, which runs until the
+  // connection is cancelled, by this or by the endpoint.
+  int refs;
+  std::string addr_name;
+};
+
+static void NetworkConnectUnref(NetworkConnect* connect) {
+  gpr_mu_lock(&connect->mu);
+  const bool done = (--connect->refs == 0);
+  gpr_mu_unlock(&connect->mu);
+  if (done) {
+    nw_release(connect->connection);
+    dispatch_release(connect->queue);
+    gpr_mu_destroy(&connect->mu);
+    delete connect;
+  }
+}
+
+static void OnAlarm(void* arg, grpc_error_handle error) {
+  NetworkConnect* connect = static_cast<NetworkConnect*>(arg);
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "CLIENT_CONNECT :%p OnAlarm, error:%s", connect,
+            grpc_error_std_string(error).c_str());
+  }
+  gpr_mu_lock(&connect->mu);
+  grpc_closure* closure = connect->closure;
+  connect->closure = nullptr;
+  gpr_mu_unlock(&connect->mu);
+  // Only schedule a callback once, by either OnAlarm or OnConnected
+  if (closure != nullptr) {
+    nw_connection_cancel(connect->connection);
+    grpc_core::ExecCtx::Run(
+        DEBUG_LOCATION, closure,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING("connect() timed out"));
+  }
+  NetworkConnectUnref(connect);
+}
+
+static void OnConnected(NetworkConnect* connect, grpc_error_handle error) {
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "CLIENT_CONNECT :%p OnConnected, error:%s", connect,
+            grpc_error_std_string(error).c_str());
+  }
+  gpr_mu_lock(&connect->mu);
+  grpc_closure* closure = connect->closure;
+  connect->closure = nullptr;
+  if (closure == nullptr) {
+    gpr_mu_unlock(&connect->mu);
+    GRPC_ERROR_UNREF(error);
+    return;
+  }
+  grpc_timer_cancel(&connect->alarm);
+  if (error == GRPC_ERROR_NONE) {
+    *connect->endpoint = grpc_network_endpoint_create(
+        connect->connection, connect->queue, connect->addr_name.c_str());
+  } else {
+    nw_connection_cancel(connect->connection);
+  }
+  gpr_mu_unlock(&connect->mu);
+  grpc_core::ExecCtx::Run(DEBUG_LOCATION, closure, error);
+}
+
+static void OnStateChanged(NetworkConnect* connect, nw_connection_state_t state,
+                           nw_error_t error) {
+  grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+  grpc_core::ExecCtx exec_ctx;
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "CLIENT_CONNECT :%p state %d", connect, state);
+  }
+  switch (state) {
+    case nw_connection_state_ready:
+      OnConnected(connect, GRPC_ERROR_NONE);
+      break;
+    // Waiting means there is no usable path yet. Fail the attempt rather than
+    // have it sit until the deadline, and let the channel back off.
+    case nw_connection_state_waiting:
+    case nw_connection_state_failed:
+      OnConnected(connect, grpc_error_set_int(grpc_error_create_from_nw_error(
+                                                  error, "connect() error"),
+                                              GRPC_ERROR_INT_GRPC_STATUS,
+                                              GRPC_STATUS_UNAVAILABLE));
+      break;
+    case nw_connection_state_cancelled:
+      NetworkConnectUnref(connect);
+      break;
+    default:
+      break;
+  }
+}
+
+static void NetworkClientConnect(grpc_closure* closure, grpc_endpoint** ep,
+                                 grpc_pollset_set* interested_parties,
+                                 const grpc_channel_args* channel_args,
+                                 const grpc_resolved_address* resolved_addr,
+                                 grpc_millis deadline) {
+  NetworkConnect* connect = new NetworkConnect();
+  connect->closure = closure;
+  connect->endpoint = ep;
+  connect->addr_name = grpc_sockaddr_to_uri(resolved_addr);
+  connect->refs = 2;
+  gpr_mu_init(&connect->mu);
+
+  if (grpc_tcp_trace.enabled()) {
+    gpr_log(GPR_DEBUG, "CLIENT_CONNECT: %p, %s: asynchronously connecting",
+            connect, connect->addr_name.c_str());
+  }
+
+  nw_endpoint_t endpoint = nw_endpoint_create_address(
+      reinterpret_cast<const sockaddr*>(resolved_addr->addr));
+  // TLS stays disabled: the channel's security connector runs its own
+  // handshake over the endpoint.
+  nw_parameters_t parameters = nw_parameters_create_secure_tcp(
+      NW_PARAMETERS_DISABLE_PROTOCOL, ^(nw_protocol_options_t tcp_options) {
+        nw_tcp_options_set_no_delay(tcp_options, true);
+      });
+  connect->connection = nw_connection_create(endpoint, parameters);
+  nw_release(endpoint);
+  nw_release(parameters);
+  connect->queue =
+      dispatch_queue_create("grpc.network.connection", DISPATCH_QUEUE_SERIAL);
+  nw_connection_set_queue(connect->connection, connect->queue);
+  nw_connection_set_state_changed_handler(
+      connect->connection, ^(nw_connection_state_t state, nw_error_t error) {
+        OnStateChanged(connect, state, error);
+      });
+  // Network.framework keeps a connection up across path changes where it
+  // can; these only report them.
+  nw_connection_set_viability_changed_handler(
+      connect->connection, ^(bool viable) {
+        if (grpc_tcp_trace.enabled()) {
+          gpr_log(GPR_DEBUG, "CLIENT_CONNECT: %p viable:%d", connect, viable);
+        }
+      });
+  nw_connection_set_better_path_available_handler(
+      connect->connection, ^(bool available) {
+        if (grpc_tcp_trace.enabled()) {
+          gpr_log(GPR_DEBUG, "CLIENT_CONNECT: %p better path available:%d",
+                  connect, available);
+        }
+      });
+  GRPC_CLOSURE_INIT(&connect->on_alarm, OnAlarm, connect,
+                    grpc_schedule_on_exec_ctx);
+  gpr_mu_lock(&connect->mu);
+  grpc_timer_init(&connect->alarm, deadline, &connect->on_alarm);
+  nw_connection_start(connect->connection);
+  gpr_mu_unlock(&connect->mu);
+}
+
+grpc_tcp_client_vtable grpc_network_client_vtable = {NetworkClientConnect};
+
+#endif /* GRPC_APPLE_NETWORK_ENDPOINT */
@@ -38,6 +38,7 @@
 
 #include <algorithm>
 #include <unordered_map>
+#include <vector>
 
 #include <grpc/slice.h>
 #include <grpc/support/alloc.h>
@@ -51,11 +52,15 @@
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/debug/trace.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/tls.h"
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/buffer_list.h"
 #include "src/core/lib/iomgr/ev_posix.h"
 #include "src/core/lib/iomgr/executor.h"
+#include "src/core/lib/iomgr/sendmsg_batch_linux.h"
 #include "src/core/lib/iomgr/socket_utils_posix.h"
 #include "src/core/lib/iomgr/tcp_posix.h"
 #include "src/core/lib/profiling/timers.h"
@@ -87,6 +92,12 @@
 #ifndef MSG_ZEROCOPY
 #define MSG_ZEROCOPY 0x4000000
 #endif
+// Set in the ee_code of a zerocopy notification when the kernel copied the
+// data after all, for instance because the route is loopback or the device
+// cannot scatter-gather.
+#ifndef SO_EE_CODE_ZEROCOPY_COPIED
+#define SO_EE_CODE_ZEROCOPY_COPIED 1
+#endif
 
 #ifdef GRPC_MSG_IOVLEN_TYPE
 typedef GRPC_MSG_IOVLEN_TYPE msg_iovlen_type;
@@ -136,9 +147,29 @@ class TcpZerocopySendRecord {
     out_offset_.slice_idx = 0;
     out_offset_.byte_idx = 0;
     grpc_slice_buffer_swap(slices_to_send, &buf_);
+    bytes_sent_ = 0;
+    copied_.store(false, std::memory_order_relaxed);
+    start_time_ = gpr_now(GPR_CLOCK_MONOTONIC);
     Ref();
   }
 
+  // Account for the bytes that a zerocopy sendmsg() took.
+  void NoteBytesSent(size_t bytes) { bytes_sent_ += bytes; }
+
+  // Called when an error queue notification says that the kernel copied the
+  // data of one of our sendmsg() calls instead of sending it in place.
+  void NoteCopied() { copied_.store(true, std::memory_order_relaxed); }
+
+  // The following are only meaningful once all the sends completed, ie. once
+  // Unref() returned true.
+  size_t bytes_sent() const { return bytes_sent_; }
+  bool copied() const { return copied_.load(std::memory_order_relaxed); }
+  // How long the buffers of this tcp_write() were pinned, in microseconds.
+  int64_t completion_latency_us() const {
+    return gpr_timespec_to_micros(
+        gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), start_time_));
+  }
+
   // References: 1 reference per sendmsg(), and 1 for the tcp_write().
   void Ref() { ref_.fetch_add(1, std::memory_order_relaxed); }
 
@@ -178,19 +209,31 @@ class TcpZerocopySendRecord {
   grpc_slice_buffer buf_;
   std::atomic<intptr_t> ref_{0};
   OutgoingOffset out_offset_;
+  size_t bytes_sent_ = 0;
+  std::atomic<bool> copied_{false};
+  gpr_timespec start_time_;
 };
 
 class TcpZerocopySendCtx {
  public:
   static constexpr int kDefaultMaxSends = 4;
   static constexpr size_t kDefaultSendBytesThreshold = 16 * 1024;  // 16KB
+  // The threshold adapts between the configured one and this many bytes.
+  static constexpr size_t kMaxSendBytesThreshold = 1024 * 1024;  // 1MB
+  // Completions slower than this pin the buffers of a tcp_write() for long
+  // enough that smaller writes are better off copying, which leaves the
+  // limited send records to the largest writes.
+  static constexpr int64_t kSlowCompletionMicros = 50 * 1000;  // 50ms
 
   explicit TcpZerocopySendCtx(
       int max_sends = kDefaultMaxSends,
       size_t send_bytes_threshold = kDefaultSendBytesThreshold)
       : max_sends_(max_sends),
         free_send_records_size_(max_sends),
-        threshold_bytes_(send_bytes_threshold) {
+        threshold_bytes_(send_bytes_threshold),
+        min_threshold_bytes_(send_bytes_threshold),
+        max_threshold_bytes_(
+            std::max(send_bytes_threshold, kMaxSendBytesThreshold)) {
     send_records_ = static_cast<TcpZerocopySendRecord*>(
         gpr_malloc(max_sends * sizeof(*send_records_)));
     free_send_records_ = static_cast<TcpZerocopySendRecord**>(
@@ -308,8 +351,33 @@ class TcpZerocopySendCtx {
 
   // Only use zerocopy if we are sending at least this many bytes. The
   // additional overhead of reading the error queue for notifications means that
-  // zerocopy is not useful for small transfers.
-  size_t threshold_bytes() const { return threshold_bytes_; }
+  // zerocopy is not useful for small transfers. The threshold starts at the
+  // configured one and adapts to how the previous zerocopy writes fared; see
+  // NoteSendsComplete().
+  size_t threshold_bytes() const {
+    return threshold_bytes_.load(std::memory_order_relaxed);
+  }
+
+  // Called once all the sends of a tcp_write() with zerocopy completed, before
+  // the record is put back. Doubles the threshold if the kernel copied the
+  // data anyway or if the buffers stayed pinned for long, and halves it back
+  // towards the configured threshold otherwise. Returns the number of bytes
+  // that the kernel sent without copying them.
+  size_t NoteSendsComplete(const TcpZerocopySendRecord* record) {
+    if (record->bytes_sent() == 0) {
+      // Every sendmsg() failed, which says nothing about zerocopy.
+      return 0;
+    }
+    const bool copied = record->copied();
+    size_t threshold = threshold_bytes_.load(std::memory_order_relaxed);
+    if (copied || record->completion_latency_us() > kSlowCompletionMicros) {
+      threshold = std::min(threshold * 2, max_threshold_bytes_);
+    } else {
+      threshold = std::max(threshold / 2, min_threshold_bytes_);
+    }
+    threshold_bytes_.store(threshold, std::memory_order_relaxed);
+    return copied ? 0 : record->bytes_sent();
+  }
 
  private:
   TcpZerocopySendRecord* ReleaseSendRecordLocked(uint32_t seq) {
@@ -345,13 +413,126 @@ class TcpZerocopySendCtx {
   uint32_t last_send_ = 0;
   std::atomic<bool> shutdown_{false};
   bool enabled_ = false;
-  size_t threshold_bytes_ = kDefaultSendBytesThreshold;
+  std::atomic<size_t> threshold_bytes_{kDefaultSendBytesThreshold};
+  const size_t min_threshold_bytes_;
+  const size_t max_threshold_bytes_;
   std::unordered_map<uint32_t, TcpZerocopySendRecord*> ctx_lookup_;
   bool memory_limited_ = false;
 };
 
+// A pool of read buffers, reused once all the slices that the endpoint handed
+// out for them are released, so that steady state reads don't allocate. The
+// buffers come from the endpoint's memory allocator and stay charged to it
+// while they wait in the pool. The pool outlives the endpoint for as long as
+// slices of its buffers are alive.
+class TcpReadSlabPool : public RefCounted<TcpReadSlabPool> {
+ public:
+  // Bounds on the buffers waiting for reuse; the others are freed when their
+  // slices are released. Large reads amortize their allocation anyway.
+  static constexpr size_t kMaxFreeSlabs = 4;
+  static constexpr size_t kMaxFreeBytes = 256 * 1024;  // 256KB
+
+  ~TcpReadSlabPool() override { Shutdown(); }
+
+  // Returns a slice of request.max() bytes, or fewer but at least
+  // request.min() under memory pressure, reusing a pooled buffer of that size
+  // if there is one. A change of size drops the pooled buffers, so callers
+  // should round sizes to keep hitting the pool.
+  grpc_slice MakeSlice(MemoryOwner* memory_owner, MemoryRequest request) {
+    Slab* slab = nullptr;
+    std::vector<Slab*> stale;
+    {
+      MutexLock lock(&mu_);
+      if (slab_size_ != request.max()) {
+        slab_size_ = request.max();
+        stale.swap(free_slabs_);
+      } else if (!free_slabs_.empty()) {
+        slab = free_slabs_.back();
+        free_slabs_.pop_back();
+      }
+    }
+    for (Slab* s : stale) {
+      FreeSlab(s);
+    }
+    if (slab == nullptr) {
+      slab = new Slab(this, memory_owner->MakeSlice(request));
+    } else {
+      slab->refs.store(1, std::memory_order_relaxed);
+    }
+    // Released by ReleaseSlab()
+    Ref().release();
+    grpc_slice slice;
+    slice.refcount = &slab->base;
+    slice.data.refcounted.bytes = GRPC_SLICE_START_PTR(slab->backing);
+    slice.data.refcounted.length = GRPC_SLICE_LENGTH(slab->backing);
+    return slice;
+  }
+
+  // Frees the pooled buffers. Buffers released afterwards are freed as well.
+  void Shutdown() {
+    std::vector<Slab*> stale;
+    {
+      MutexLock lock(&mu_);
+      shutdown_ = true;
+      stale.swap(free_slabs_);
+    }
+    for (Slab* s : stale) {
+      FreeSlab(s);
+    }
+  }
+
+ private:
+  struct Slab {
+    Slab(TcpReadSlabPool* pool, grpc_slice backing)
+        : base(grpc_slice_refcount::Type::REGULAR, &refs, ReleaseSlab, this,
+               &base),
+          pool(pool),
+          backing(backing) {}
+
+    grpc_slice_refcount base;
+    std::atomic<size_t> refs{1};
+    TcpReadSlabPool* pool;
+    // The buffer, allocated with MemoryAllocator::MakeSlice()
+    grpc_slice backing;
+  };
+
+  // Called when the last slice of a buffer is released.
+  static void ReleaseSlab(void* arg) {
+    Slab* slab = static_cast<Slab*>(arg);
+    TcpReadSlabPool* pool = slab->pool;
+    bool keep;
+    {
+      MutexLock lock(&pool->mu_);
+      keep = !pool->shutdown_ &&
+             GRPC_SLICE_LENGTH(slab->backing) == pool->slab_size_ &&
+             pool->free_slabs_.size() < kMaxFreeSlabs &&
+             (pool->free_slabs_.size() + 1) * pool->slab_size_ <=
+                 kMaxFreeBytes;
+      if (keep) {
+        pool->free_slabs_.push_back(slab);
+      }
+    }
+    if (!keep) {
+      FreeSlab(slab);
+    }
+    pool->Unref();
+  }
+
+  static void FreeSlab(Slab* slab) {
+    grpc_slice_unref_internal(slab->backing);
+    delete slab;
+  }
+
+  Mutex mu_;
+  bool shutdown_ = false;
+  // The size of the buffers that are pooled
+  size_t slab_size_ = 0;
+  std::vector<Slab*> free_slabs_;
+};
+
 }  // namespace grpc_core
 
+using grpc_core::TcpReadSlabPool;
 using grpc_core::TcpZerocopySendCtx;
 using grpc_core::TcpZerocopySendRecord;
 
@@ -398,6 +579,7 @@ struct grpc_tcp {
 
   grpc_core::MemoryOwner memory_owner;
   grpc_core::MemoryAllocator::Reservation self_reservation;
+  grpc_core::RefCountedPtr<TcpReadSlabPool> read_slab_pool;
 
   grpc_core::TracedBuffer* tb_head; /* List of traced buffers */
   gpr_mu tb_mu; /* Lock for access to list of traced buffers */
@@ -423,6 +605,9 @@ struct grpc_tcp {
                                       on errors anymore */
   TcpZerocopySendCtx tcp_zerocopy_send_ctx;
   TcpZerocopySendRecord* current_zerocopy_send = nullptr;
+  /* Whether small writes wait for the end of the exec_ctx to go out along with
+     the other endpoints' */
+  bool write_batching;
 };
 
 struct backup_poller {
@@ -620,6 +805,7 @@ static void tcp_free(grpc_tcp* tcp) {
   gpr_mu_unlock(&tcp->tb_mu);
   tcp->outgoing_buffer_arg = nullptr;
   gpr_mu_destroy(&tcp->tb_mu);
+  tcp->read_slab_pool->Shutdown();
   delete tcp;
 }
 
@@ -844,12 +1030,25 @@ static void tcp_continue_read(grpc_tcp* tcp) {
     int target_length = static_cast<int>(tcp->target_length);
     int extra_wanted =
         target_length - static_cast<int>(tcp->incoming_buffer->length);
+    /* If the last read left bytes on the socket, TCP_INQ told us how many:
+       make room for all of them */
+    if (tcp->inq_capable) {
+      extra_wanted = std::max(extra_wanted, tcp->inq);
+    }
+    extra_wanted = grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
+                                    tcp->max_read_chunk_size);
+    /* Round up to a power of two so that reads of similar sizes reuse the
+       pooled buffers */
+    int slab_size = 1;
+    while (slab_size < extra_wanted) {
+      slab_size <<= 1;
+    }
+    slab_size = std::min(slab_size, tcp->max_read_chunk_size);
     grpc_slice_buffer_add_indexed(
         tcp->incoming_buffer,
-        tcp->memory_owner.MakeSlice(grpc_core::MemoryRequest(
-            tcp->min_read_chunk_size,
-            grpc_core::Clamp(extra_wanted, tcp->min_read_chunk_size,
-                             tcp->max_read_chunk_size))));
+        tcp->read_slab_pool->MakeSlice(
+            &tcp->memory_owner,
+            grpc_core::MemoryRequest(tcp->min_read_chunk_size, slab_size)));
   }
   if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
     gpr_log(GPR_INFO, "TCP:%p do_read", tcp);
@@ -1023,6 +1222,7 @@ static void process_zerocopy(grpc_tcp* tcp, struct cmsghdr* cmsg) {
   GPR_DEBUG_ASSERT(serr->ee_origin == SO_EE_ORIGIN_ZEROCOPY);
   const uint32_t lo = serr->ee_info;
   const uint32_t hi = serr->ee_data;
+  const bool copied = (serr->ee_code & SO_EE_CODE_ZEROCOPY_COPIED) != 0;
   for (uint32_t seq = lo; seq <= hi; ++seq) {
     // TODO(arjunroy): It's likely that lo and hi refer to zerocopy sequence
     // numbers that are generated by a single call to grpc_endpoint_write; ie.
@@ -1031,6 +1231,9 @@ static void process_zerocopy(grpc_tcp* tcp, struct cmsghdr* cmsg) {
     TcpZerocopySendRecord* record =
         tcp->tcp_zerocopy_send_ctx.ReleaseSendRecord(seq);
     GPR_DEBUG_ASSERT(record);
+    if (copied) {
+      record->NoteCopied();
+    }
     UnrefMaybePutZerocopySendRecord(tcp, record, seq, "CALLBACK RCVD");
   }
 }
@@ -1357,6 +1560,7 @@ static bool do_tcp_flush_zerocopy(grpc_tcp* tcp, TcpZerocopySendRecord* record,
       }
     }
     tcp->bytes_counter += sent_length;
+    record->NoteBytesSent(static_cast<size_t>(sent_length));
     record->UpdateOffsetForBytesSent(sending_length,
                                      static_cast<size_t>(sent_length));
     if (record->AllSlicesSent()) {
@@ -1371,6 +1575,11 @@ static void UnrefMaybePutZerocopySendRecord(grpc_tcp* tcp,
                                             uint32_t /*seq*/,
                                             const char* /*tag*/) {
   if (record->Unref()) {
+    if (record->copied()) {
+      GRPC_STATS_INC_TCP_ZEROCOPY_WRITES_COPIED();
+    }
+    GRPC_STATS_INC_TCP_ZEROCOPY_COPY_BYTES_AVOIDED(
+        tcp->tcp_zerocopy_send_ctx.NoteSendsComplete(record));
     tcp->tcp_zerocopy_send_ctx.PutSendRecord(record);
   }
 }
@@ -1535,6 +1744,129 @@ static void tcp_handle_write(void* arg /* grpc_tcp */,
   }
 }
 
+/* Writes of at most this many slices can be batched */
+#define MAX_BATCHED_WRITE_IOVEC 16
+
+namespace {
+/* The writes queued on one thread during an exec_ctx, sent together once the
+   closures scheduled before the first of them have run */
+struct tcp_write_batch {
+  grpc_closure flush_closure;
+  size_t count;
+  grpc_tcp* tcps[GRPC_SENDMSG_BATCH_MAX];
+  struct msghdr msgs[GRPC_SENDMSG_BATCH_MAX];
+  struct iovec iovs[GRPC_SENDMSG_BATCH_MAX][MAX_BATCHED_WRITE_IOVEC];
+};
+}  // namespace
+
+static GPR_THREAD_LOCAL(tcp_write_batch*) g_write_batch;
+
+/* Drops the first sent bytes of the outgoing buffer */
+static void tcp_consume_sent(grpc_tcp* tcp, size_t sent) {
+  while (sent > 0) {
+    size_t slice_length = GRPC_SLICE_LENGTH(tcp->outgoing_buffer->slices[0]);
+    if (slice_length > sent) {
+      tcp->outgoing_byte_idx = sent;
+      return;
+    }
+    sent -= slice_length;
+    grpc_slice_buffer_remove_first(tcp->outgoing_buffer);
+  }
+}
+
+static void tcp_flush_write_batch(void* arg, grpc_error_handle /*error*/) {
+  tcp_write_batch* batch = static_cast<tcp_write_batch*>(arg);
+  if (g_write_batch == batch) {
+    g_write_batch = nullptr;
+  }
+  int fds[GRPC_SENDMSG_BATCH_MAX];
+  struct msghdr* msgs[GRPC_SENDMSG_BATCH_MAX];
+  size_t sending_lengths[GRPC_SENDMSG_BATCH_MAX];
+  ssize_t results[GRPC_SENDMSG_BATCH_MAX];
+  for (size_t i = 0; i < batch->count; i++) {
+    grpc_tcp* tcp = batch->tcps[i];
+    struct msghdr* msg = &batch->msgs[i];
+    memset(msg, 0, sizeof(*msg));
+    msg->msg_iov = batch->iovs[i];
+    msg->msg_iovlen = static_cast<msg_iovlen_type>(tcp->outgoing_buffer->count);
+    sending_lengths[i] = 0;
+    for (size_t j = 0; j < tcp->outgoing_buffer->count; j++) {
+      grpc_slice slice = tcp->outgoing_buffer->slices[j];
+      batch->iovs[i][j].iov_base = GRPC_SLICE_START_PTR(slice);
+      batch->iovs[i][j].iov_len = GRPC_SLICE_LENGTH(slice);
+      sending_lengths[i] += GRPC_SLICE_LENGTH(slice);
+    }
+    fds[i] = tcp->fd;
+    msgs[i] = msg;
+  }
+  /* A lone write gains nothing from io_uring */
+  bool sent = false;
+  if (batch->count > 1) {
+    GPR_TIMER_SCOPE("sendmsg_batch", 1);
+    GRPC_STATS_INC_SYSCALL_WRITE();
+    sent = grpc_sendmsg_batch(fds, msgs, batch->count, SENDMSG_FLAGS, results);
+  }
+  for (size_t i = 0; i < batch->count; i++) {
+    grpc_tcp* tcp = batch->tcps[i];
+    grpc_error_handle error = GRPC_ERROR_NONE;
+    bool flush_result;
+    if (sent && results[i] > 0) {
+      GRPC_STATS_INC_TCP_WRITE_SIZE(sending_lengths[i]);
+      GRPC_STATS_INC_TCP_WRITE_IOV_SIZE(tcp->outgoing_buffer->count);
+      tcp->bytes_counter += results[i];
+    }
+    if (sent && results[i] == static_cast<ssize_t>(sending_lengths[i])) {
+      grpc_slice_buffer_reset_and_unref_internal(tcp->outgoing_buffer);
+      flush_result = true;
+    } else {
+      /* The rest of the write, or its error, goes through the usual path */
+      if (sent && results[i] > 0) {
+        tcp_consume_sent(tcp, static_cast<size_t>(results[i]));
+      }
+      flush_result = tcp_flush(tcp, &error);
+    }
+    if (!flush_result) {
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
+        gpr_log(GPR_INFO, "write: delayed");
+      }
+      notify_on_write(tcp);
+    } else {
+      grpc_closure* cb = tcp->write_cb;
+      tcp->write_cb = nullptr;
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
+        gpr_log(GPR_INFO, "write: %s", grpc_error_std_string(error).c_str());
+      }
+      grpc_core::Closure::Run(DEBUG_LOCATION, cb, error);
+      TCP_UNREF(tcp, "write");
+    }
+  }
+  delete batch;
+}
+
+/* Queues the write of the outgoing buffer in the current thread's batch */
+static void tcp_queue_batched_write(grpc_tcp* tcp, grpc_closure* cb) {
+  TCP_REF(tcp, "write");
+  tcp->write_cb = cb;
+  tcp_write_batch* batch = g_write_batch;
+  if (batch == nullptr) {
+    batch = new tcp_write_batch;
+    batch->count = 0;
+    GRPC_CLOSURE_INIT(&batch->flush_closure, tcp_flush_write_batch, batch,
+                      grpc_schedule_on_exec_ctx);
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, &batch->flush_closure,
+                            GRPC_ERROR_NONE);
+    g_write_batch = batch;
+  }
+  batch->tcps[batch->count++] = tcp;
+  if (batch->count == GRPC_SENDMSG_BATCH_MAX) {
+    /* Full: it still goes out as scheduled, and the next write starts over */
+    g_write_batch = nullptr;
+  }
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_tcp_trace)) {
+    gpr_log(GPR_INFO, "write: batched");
+  }
+}
+
 static void tcp_write(grpc_endpoint* ep, grpc_slice_buffer* buf,
                       grpc_closure* cb, void* arg) {
   GPR_TIMER_SCOPE("tcp_write", 0);
@@ -1581,6 +1913,12 @@ static void tcp_write(grpc_endpoint* ep, grpc_slice_buffer* buf,
     GPR_ASSERT(grpc_event_engine_can_track_errors());
   }
 
+  if (tcp->write_batching && zerocopy_send_record == nullptr &&
+      arg == nullptr && buf->count <= MAX_BATCHED_WRITE_IOVEC) {
+    tcp_queue_batched_write(tcp, cb);
+    return;
+  }
+
   bool flush_result =
       zerocopy_send_record != nullptr
           ? tcp_flush_zerocopy(tcp, zerocopy_send_record, &error)
@@ -1672,6 +2010,7 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
       grpc_core::TcpZerocopySendCtx::kDefaultSendBytesThreshold;
   int tcp_tx_zerocopy_max_simult_sends =
       grpc_core::TcpZerocopySendCtx::kDefaultMaxSends;
+  bool tcp_write_batching = false;
   if (channel_args != nullptr) {
     for (size_t i = 0; i < channel_args->num_args; i++) {
       if (0 ==
@@ -1706,6 +2045,10 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
             grpc_core::TcpZerocopySendCtx::kDefaultMaxSends, 0, INT_MAX};
         tcp_tx_zerocopy_max_simult_sends =
             grpc_channel_arg_get_integer(&channel_args->args[i], options);
+      } else if (0 == strcmp(channel_args->args[i].key,
+                             GRPC_ARG_TCP_WRITE_BATCHING_ENABLED)) {
+        tcp_write_batching =
+            grpc_channel_arg_get_bool(&channel_args->args[i], false);
       }
     }
   }
@@ -1725,6 +2068,7 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
                           ->memory_quota()
                           ->CreateMemoryOwner(peer_string);
   tcp->self_reservation = tcp->memory_owner.MakeReservation(sizeof(grpc_tcp));
+  tcp->read_slab_pool = grpc_core::MakeRefCounted<TcpReadSlabPool>();
   grpc_resolved_address resolved_local_addr;
   memset(&resolved_local_addr, 0, sizeof(resolved_local_addr));
   resolved_local_addr.len = sizeof(resolved_local_addr.addr);
@@ -1751,6 +2095,7 @@ grpc_endpoint* grpc_tcp_create(grpc_fd* em_fd,
   tcp->socket_ts_enabled = false;
   tcp->ts_capable = true;
   tcp->outgoing_buffer_arg = nullptr;
+  tcp->write_batching = tcp_write_batching;
   if (tcp_tx_zerocopy_enabled && !tcp->tcp_zerocopy_send_ctx.memory_limited()) {
 #ifdef GRPC_LINUX_ERRQUEUE
     const int enable = 1;
@@ -1836,6 +2181,7 @@ void grpc_tcp_destroy_and_release_fd(grpc_endpoint* ep, int* fd,
 void grpc_tcp_posix_init() { g_backup_poller_mu = new grpc_core::Mutex; }
 
 void grpc_tcp_posix_shutdown() {
+  grpc_sendmsg_batch_shutdown();
   delete g_backup_poller_mu;
   g_backup_poller_mu = nullptr;
 }
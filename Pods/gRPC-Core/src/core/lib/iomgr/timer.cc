@@ -20,10 +20,35 @@
 
 #include "src/core/lib/iomgr/timer.h"
 
+#include <string.h>
+
+#include <grpc/support/log.h>
+
+#include "src/core/lib/gprpp/global_config.h"
 #include "src/core/lib/iomgr/timer_manager.h"
 
+GPR_GLOBAL_CONFIG_DEFINE_STRING(
+    grpc_timer_strategy, "generic",
+    "Declares which timer implementation to use: \"generic\" for the sharded "
+    "heaps, or \"wheel\" for the hierarchical timing wheels.")
+
+extern grpc_timer_vtable grpc_generic_timer_vtable;
+extern grpc_timer_vtable grpc_wheel_timer_vtable;
+
 grpc_timer_vtable* grpc_timer_impl;
 
+grpc_timer_vtable* grpc_configured_timer_impl() {
+  grpc_core::UniquePtr<char> value = GPR_GLOBAL_CONFIG_GET(grpc_timer_strategy);
+  if (0 == strcmp(value.get(), "wheel")) {
+    return &grpc_wheel_timer_vtable;
+  }
+  if (0 != strcmp(value.get(), "generic")) {
+    gpr_log(GPR_ERROR, "Unknown timer strategy '%s', using generic",
+            value.get());
+  }
+  return &grpc_generic_timer_vtable;
+}
+
 void grpc_set_timer_impl(grpc_timer_vtable* vtable) {
   grpc_timer_impl = vtable;
 }
@@ -128,4 +128,8 @@ void grpc_kick_poller(void);
 /* Sets the timer implementation */
 void grpc_set_timer_impl(grpc_timer_vtable* vtable);
 
+/* Returns the timer implementation that GRPC_TIMER_STRATEGY names: "generic"
+   (the default) for timer_generic.cc, or "wheel" for timer_wheel.cc */
+grpc_timer_vtable* grpc_configured_timer_impl(void);
+
 #endif /* GRPC_CORE_LIB_IOMGR_TIMER_H */
@@ -0,0 +1,521 @@
+/*
+ *
+ * Copyright 2022 gRPC authors.
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ *
+ */
+
+#include <grpc/support/port_platform.h>
+
+#include <inttypes.h>
+
+#include <algorithm>
+
+#include "absl/numeric/bits.h"
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/cpu.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/debug/trace.h"
+#include "src/core/lib/gpr/spinlock.h"
+#include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/iomgr/port.h"
+#include "src/core/lib/iomgr/timer.h"
+
+/* A hierarchical timing wheel, which adds and cancels timers in constant time
+ * (the timer heaps of timer_generic.cc take logarithmic time). Most timers are
+ * deadlines that get cancelled before they fire, so most timers never move
+ * from the slot they were added to.
+ *
+ * Each shard has a wheel of WHEEL_LEVELS levels. Level 0 has one slot per
+ * millisecond of the next WHEEL_L0_SLOTS milliseconds. Each slot of level l > 0
+ * spans WHEEL_LN_SLOTS times as many milliseconds as a slot of level l - 1,
+ * and the whole level spans a slot of level l + 1. Every time the level 0
+ * cursor wraps around, the next slot of level 1 cascades: its timers move
+ * down to level 0. Every time the level 1 cursor wraps around, the next slot
+ * of level 2 cascades, and so on. So a timer fires at the exact millisecond of
+ * its deadline, after moving down at most once per level.
+ *
+ * Deadlines beyond the span of the wheel (2^32 ms, about 49 days) wait in the
+ * last slot of the wheel, and are placed again every time it cascades.
+ */
+
+#define WHEEL_LEVELS 5
+#define WHEEL_L0_BITS 8
+#define WHEEL_LN_BITS 6
+#define WHEEL_L0_SLOTS (1u << WHEEL_L0_BITS)
+#define WHEEL_LN_SLOTS (1u << WHEEL_LN_BITS)
+#define WHEEL_NUM_SLOTS \
+  (WHEEL_L0_SLOTS + (WHEEL_LEVELS - 1) * WHEEL_LN_SLOTS)
+#define WHEEL_MAX_DELTA 0xffffffffu
+
+extern grpc_core::TraceFlag grpc_timer_trace;
+extern grpc_core::TraceFlag grpc_timer_check_trace;
+
+/* A "wheel shard". Timers are hashed to a shard by their address. */
+struct wheel_shard {
+  gpr_mu mu;
+  /* The next millisecond to process: the timers due before it have fired */
+  grpc_millis now;
+  /* A lower bound on the deadlines of the timers in this shard */
+  grpc_millis min_deadline;
+  size_t num_timers;
+  /* One bit per slot, set if the slot holds any timer. Level 0 takes the first
+     WHEEL_L0_SLOTS / 64 words, and every other level one word. */
+  uint64_t occupied[WHEEL_NUM_SLOTS / 64];
+  /* Doubly-linked lists of timers, through grpc_timer::next and prev. The
+     slot of a timer is stored in its heap_index. */
+  grpc_timer* slots[WHEEL_NUM_SLOTS];
+};
+static size_t g_num_shards;
+static wheel_shard* g_shards;
+
+/* Thread local variable that stores the deadline of the next timer the thread
+ * has last-seen, as in timer_generic.cc */
+static GPR_THREAD_LOCAL(grpc_millis) g_last_seen_min_timer;
+
+struct shared_mutables {
+  /* A lower bound on the deadline of the next timer due across all shards */
+  grpc_millis min_timer;
+  /* Allow only one run_some_expired_timers at once */
+  gpr_spinlock checker_mu;
+  bool initialized;
+  /* Protects min_timer updates */
+  gpr_mu mu;
+} GPR_ALIGN_STRUCT(GPR_CACHELINE_SIZE);
+
+static struct shared_mutables g_shared_mutables;
+
+static grpc_millis load_min_timer() {
+#if GPR_ARCH_64
+  // See timer_generic.cc for the c-style cast.
+  return static_cast<grpc_millis>(
+      gpr_atm_no_barrier_load((gpr_atm*)(&g_shared_mutables.min_timer)));
+#else
+  // On 32-bit systems, gpr_atm_no_barrier_load does not work on 64-bit types
+  // (like grpc_millis). So all reads and writes to g_shared_mutables.min_timer
+  // are done under g_shared_mutables.mu
+  gpr_mu_lock(&g_shared_mutables.mu);
+  grpc_millis min_timer = g_shared_mutables.min_timer;
+  gpr_mu_unlock(&g_shared_mutables.mu);
+  return min_timer;
+#endif
+}
+
+/* REQUIRES: g_shared_mutables.mu locked */
+static void store_min_timer(grpc_millis min_timer) {
+#if GPR_ARCH_64
+  gpr_atm_no_barrier_store((gpr_atm*)(&g_shared_mutables.min_timer),
+                           min_timer);
+#else
+  g_shared_mutables.min_timer = min_timer;
+#endif
+}
+
+static uint32_t level_shift(int level) {
+  return WHEEL_L0_BITS + (level - 1) * WHEEL_LN_BITS;
+}
+
+static uint32_t level_first_slot(int level) {
+  return WHEEL_L0_SLOTS + (level - 1) * WHEEL_LN_SLOTS;
+}
+
+/* Returns the slot of a timer due at deadline */
+static uint32_t slot_for(wheel_shard* shard, grpc_millis deadline) {
+  if (deadline < shard->now) {
+    /* Missed: fire it with the next millisecond */
+    return static_cast<uint64_t>(shard->now) & (WHEEL_L0_SLOTS - 1);
+  }
+  uint64_t delta = static_cast<uint64_t>(deadline - shard->now);
+  uint64_t expires = static_cast<uint64_t>(deadline);
+  if (delta < WHEEL_L0_SLOTS) {
+    return expires & (WHEEL_L0_SLOTS - 1);
+  }
+  if (delta > WHEEL_MAX_DELTA) {
+    expires = static_cast<uint64_t>(shard->now) + WHEEL_MAX_DELTA;
+  }
+  int level = 1;
+  while (level < WHEEL_LEVELS - 1 &&
+         delta >= (uint64_t{1} << level_shift(level + 1))) {
+    level++;
+  }
+  return level_first_slot(level) +
+         ((expires >> level_shift(level)) & (WHEEL_LN_SLOTS - 1));
+}
+
+static void slot_add(wheel_shard* shard, uint32_t slot, grpc_timer* timer) {
+  timer->heap_index = slot;
+  timer->prev = nullptr;
+  timer->next = shard->slots[slot];
+  if (timer->next != nullptr) timer->next->prev = timer;
+  shard->slots[slot] = timer;
+  shard->occupied[slot / 64] |= uint64_t{1} << (slot % 64);
+}
+
+static void slot_remove(wheel_shard* shard, grpc_timer* timer) {
+  uint32_t slot = timer->heap_index;
+  if (timer->prev != nullptr) {
+    timer->prev->next = timer->next;
+  } else {
+    shard->slots[slot] = timer->next;
+  }
+  if (timer->next != nullptr) timer->next->prev = timer->prev;
+  if (shard->slots[slot] == nullptr) {
+    shard->occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+  }
+}
+
+/* Empties a slot and returns its timers */
+static grpc_timer* slot_take(wheel_shard* shard, uint32_t slot) {
+  grpc_timer* timers = shard->slots[slot];
+  shard->slots[slot] = nullptr;
+  shard->occupied[slot / 64] &= ~(uint64_t{1} << (slot % 64));
+  return timers;
+}
+
+/* Returns the first occupied level 0 slot at or after from, or WHEEL_L0_SLOTS
+   if there is none */
+static uint32_t next_level0_slot(wheel_shard* shard, uint32_t from) {
+  for (uint32_t word = from / 64; word < WHEEL_L0_SLOTS / 64; word++) {
+    uint64_t bits = shard->occupied[word];
+    if (word == from / 64) bits &= ~uint64_t{0} << (from % 64);
+    if (bits != 0) return word * 64 + absl::countr_zero(bits);
+  }
+  return WHEEL_L0_SLOTS;
+}
+
+/* Moves the timers of the current slot of level down to the lower levels, and
+   returns the index of that slot */
+static uint32_t cascade(wheel_shard* shard, int level) {
+  uint32_t index = (static_cast<uint64_t>(shard->now) >> level_shift(level)) &
+                   (WHEEL_LN_SLOTS - 1);
+  grpc_timer* timer = slot_take(shard, level_first_slot(level) + index);
+  while (timer != nullptr) {
+    grpc_timer* next = timer->next;
+    slot_add(shard, slot_for(shard, timer->deadline), timer);
+    timer = next;
+  }
+  return index;
+}
+
+/* Returns a lower bound on the deadlines of the timers in the shard: the exact
+   deadline of the next timer if it is in level 0, or else the time of the next
+   cascade that brings timers down. */
+static grpc_millis compute_min_deadline(wheel_shard* shard) {
+  if (shard->num_timers == 0) return GRPC_MILLIS_INF_FUTURE;
+  uint64_t now = static_cast<uint64_t>(shard->now);
+  uint64_t window = now & ~uint64_t{WHEEL_L0_SLOTS - 1};
+  uint32_t cursor = now & (WHEEL_L0_SLOTS - 1);
+  uint32_t slot = next_level0_slot(shard, cursor);
+  if (slot < WHEEL_L0_SLOTS) {
+    /* Nothing in the other levels is due before the end of the window */
+    return static_cast<grpc_millis>(window + slot);
+  }
+  uint64_t min_deadline = UINT64_MAX;
+  slot = next_level0_slot(shard, 0);
+  if (slot < WHEEL_L0_SLOTS) {
+    /* Due in the next window */
+    min_deadline = window + WHEEL_L0_SLOTS + slot;
+  }
+  for (int level = 1; level < WHEEL_LEVELS; level++) {
+    uint64_t bits = shard->occupied[WHEEL_L0_SLOTS / 64 + level - 1];
+    if (bits == 0) continue;
+    uint64_t granularity = uint64_t{1} << level_shift(level);
+    /* The first cascade of this level at or after now, and its slot */
+    uint64_t first = (now + granularity - 1) & ~(granularity - 1);
+    uint32_t index = (first >> level_shift(level)) & (WHEEL_LN_SLOTS - 1);
+    uint64_t rotated = absl::rotr(bits, static_cast<int>(index));
+    min_deadline = std::min(min_deadline,
+                            first + absl::countr_zero(rotated) * granularity);
+  }
+  return static_cast<grpc_millis>(
+      std::min(min_deadline, static_cast<uint64_t>(GRPC_MILLIS_INF_FUTURE)));
+}
+
+static void timer_list_init() {
+  g_num_shards = grpc_core::Clamp(2 * gpr_cpu_num_cores(), 1u, 32u);
+  g_shards =
+      static_cast<wheel_shard*>(gpr_zalloc(g_num_shards * sizeof(*g_shards)));
+
+  g_shared_mutables.initialized = true;
+  g_shared_mutables.checker_mu = GPR_SPINLOCK_INITIALIZER;
+  gpr_mu_init(&g_shared_mutables.mu);
+  g_shared_mutables.min_timer = GRPC_MILLIS_INF_FUTURE;
+
+  g_last_seen_min_timer = 0;
+
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+  for (size_t i = 0; i < g_num_shards; i++) {
+    wheel_shard* shard = &g_shards[i];
+    gpr_mu_init(&shard->mu);
+    shard->now = now;
+    shard->min_deadline = GRPC_MILLIS_INF_FUTURE;
+  }
+}
+
+/* Fires every timer of shard with error.
+   REQUIRES: shard->mu locked */
+static void fire_all(wheel_shard* shard, grpc_error_handle error) {
+  for (uint32_t slot = 0; slot < WHEEL_NUM_SLOTS; slot++) {
+    grpc_timer* timer = slot_take(shard, slot);
+    while (timer != nullptr) {
+      grpc_timer* next = timer->next;
+      timer->pending = false;
+      grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                              GRPC_ERROR_REF(error));
+      timer = next;
+    }
+  }
+  shard->num_timers = 0;
+}
+
+static void timer_list_shutdown() {
+  grpc_error_handle error =
+      GRPC_ERROR_CREATE_FROM_STATIC_STRING("Timer list shutdown");
+  for (size_t i = 0; i < g_num_shards; i++) {
+    wheel_shard* shard = &g_shards[i];
+    gpr_mu_lock(&shard->mu);
+    fire_all(shard, error);
+    gpr_mu_unlock(&shard->mu);
+    gpr_mu_destroy(&shard->mu);
+  }
+  GRPC_ERROR_UNREF(error);
+  gpr_mu_destroy(&g_shared_mutables.mu);
+  gpr_free(g_shards);
+  g_shared_mutables.initialized = false;
+}
+
+static void timer_init(grpc_timer* timer, grpc_millis deadline,
+                       grpc_closure* closure) {
+  wheel_shard* shard = &g_shards[grpc_core::HashPointer(timer, g_num_shards)];
+  timer->closure = closure;
+  timer->deadline = deadline;
+
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+    gpr_log(GPR_INFO, "TIMER %p: SET %" PRId64 " now %" PRId64 " call %p[%p]",
+            timer, deadline, grpc_core::ExecCtx::Get()->Now(), closure,
+            closure->cb);
+  }
+
+  if (!g_shared_mutables.initialized) {
+    timer->pending = false;
+    grpc_core::ExecCtx::Run(
+        DEBUG_LOCATION, timer->closure,
+        GRPC_ERROR_CREATE_FROM_STATIC_STRING(
+            "Attempt to create timer before initialization"));
+    return;
+  }
+
+  if (deadline <= grpc_core::ExecCtx::Get()->Now()) {
+    timer->pending = false;
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure, GRPC_ERROR_NONE);
+    /* early out */
+    return;
+  }
+
+  gpr_mu_lock(&shard->mu);
+  if (shard->num_timers == 0) {
+    /* Checks don't advance empty shards: catch up before placing the timer */
+    shard->now = std::max(shard->now, grpc_core::ExecCtx::Get()->Now());
+  }
+  timer->pending = true;
+  slot_add(shard, slot_for(shard, deadline), timer);
+  shard->num_timers++;
+  bool is_first_timer = deadline < shard->min_deadline;
+  if (is_first_timer) {
+    shard->min_deadline = deadline;
+  }
+  gpr_mu_unlock(&shard->mu);
+
+  /* As in timer_generic.cc, a grpc_timer_check() may run between the unlock
+     above and the lock below. It either sees the lowered min_deadline of the
+     shard, or the lock below lowers min_timer after it. */
+  if (is_first_timer) {
+    gpr_mu_lock(&g_shared_mutables.mu);
+    if (deadline < g_shared_mutables.min_timer) {
+      store_min_timer(deadline);
+      grpc_kick_poller();
+    }
+    gpr_mu_unlock(&g_shared_mutables.mu);
+  }
+}
+
+static void timer_consume_kick(void) {
+  /* Force re-evaluation of last seen min */
+  g_last_seen_min_timer = 0;
+}
+
+static void timer_cancel(grpc_timer* timer) {
+  if (!g_shared_mutables.initialized) {
+    /* must have already been cancelled, also the shard mutex is invalid */
+    return;
+  }
+
+  wheel_shard* shard = &g_shards[grpc_core::HashPointer(timer, g_num_shards)];
+  gpr_mu_lock(&shard->mu);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+    gpr_log(GPR_INFO, "TIMER %p: CANCEL pending=%s", timer,
+            timer->pending ? "true" : "false");
+  }
+
+  /* The min_deadline of the shard stays a lower bound */
+  if (timer->pending) {
+    grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                            GRPC_ERROR_CANCELLED);
+    timer->pending = false;
+    slot_remove(shard, timer);
+    shard->num_timers--;
+  }
+  gpr_mu_unlock(&shard->mu);
+}
+
+/* Advances the wheel of shard to now, firing the timers due by then, and
+   returns how many fired. Jumps over the empty slots and the cascades of empty
+   slots instead of stepping through them.
+   REQUIRES: shard->mu locked */
+static size_t advance_shard(wheel_shard* shard, grpc_millis now,
+                            grpc_error_handle error) {
+  size_t n = 0;
+  while (shard->now <= now) {
+    uint64_t tick = static_cast<uint64_t>(shard->now);
+    if ((tick & (WHEEL_L0_SLOTS - 1)) == 0) {
+      for (int level = 1; level < WHEEL_LEVELS; level++) {
+        if (cascade(shard, level) != 0) break;
+      }
+    }
+    if (shard->num_timers == 0) {
+      shard->now = now + 1;
+      break;
+    }
+    uint64_t window = tick & ~uint64_t{WHEEL_L0_SLOTS - 1};
+    uint32_t slot = next_level0_slot(shard, tick & (WHEEL_L0_SLOTS - 1));
+    if (slot == WHEEL_L0_SLOTS ||
+        static_cast<grpc_millis>(window + slot) > now) {
+      /* Nothing is due in level 0 before now: jump to the next timer or the
+         next cascade that brings timers down */
+      shard->now = grpc_core::Clamp(compute_min_deadline(shard),
+                                    shard->now + 1, now + 1);
+      continue;
+    }
+    shard->now = static_cast<grpc_millis>(window + slot + 1);
+    grpc_timer* timer = slot_take(shard, slot);
+    while (timer != nullptr) {
+      grpc_timer* next = timer->next;
+      if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_trace)) {
+        gpr_log(GPR_INFO, "TIMER %p: FIRE %" PRId64 "ms late", timer,
+                now - timer->deadline);
+      }
+      timer->pending = false;
+      grpc_core::ExecCtx::Run(DEBUG_LOCATION, timer->closure,
+                              GRPC_ERROR_REF(error));
+      shard->num_timers--;
+      n++;
+      timer = next;
+    }
+  }
+  return n;
+}
+
+static grpc_timer_check_result run_some_expired_timers(
+    grpc_millis now, grpc_millis* next, grpc_error_handle error) {
+  grpc_timer_check_result result = GRPC_TIMERS_NOT_CHECKED;
+
+  grpc_millis min_timer = load_min_timer();
+  g_last_seen_min_timer = min_timer;
+
+  if (now < min_timer) {
+    if (next != nullptr) *next = std::min(*next, min_timer);
+    GRPC_ERROR_UNREF(error);
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  if (gpr_spinlock_trylock(&g_shared_mutables.checker_mu)) {
+    gpr_mu_lock(&g_shared_mutables.mu);
+    result = GRPC_TIMERS_CHECKED_AND_EMPTY;
+    grpc_millis new_min_timer = GRPC_MILLIS_INF_FUTURE;
+    for (size_t i = 0; i < g_num_shards; i++) {
+      wheel_shard* shard = &g_shards[i];
+      gpr_mu_lock(&shard->mu);
+      if (shard->min_deadline <= now) {
+        size_t n = now == GRPC_MILLIS_INF_FUTURE
+                       ? shard->num_timers
+                       : advance_shard(shard, now, error);
+        if (now == GRPC_MILLIS_INF_FUTURE) {
+          fire_all(shard, error);
+        }
+        if (n > 0) result = GRPC_TIMERS_FIRED;
+        shard->min_deadline = compute_min_deadline(shard);
+        if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+          gpr_log(GPR_INFO,
+                  "  .. shard[%d] popped %" PRIdPTR
+                  ", min_deadline --> %" PRId64,
+                  static_cast<int>(i), n, shard->min_deadline);
+        }
+      }
+      new_min_timer = std::min(new_min_timer, shard->min_deadline);
+      gpr_mu_unlock(&shard->mu);
+    }
+
+    if (next) {
+      *next = std::min(*next, new_min_timer);
+    }
+    store_min_timer(new_min_timer);
+    gpr_mu_unlock(&g_shared_mutables.mu);
+    gpr_spinlock_unlock(&g_shared_mutables.checker_mu);
+  }
+
+  GRPC_ERROR_UNREF(error);
+
+  return result;
+}
+
+static grpc_timer_check_result timer_check(grpc_millis* next) {
+  grpc_millis now = grpc_core::ExecCtx::Get()->Now();
+
+  /* fetch from a thread-local first: this avoids contention on a globally
+     mutable cacheline in the common case */
+  grpc_millis min_timer = g_last_seen_min_timer;
+
+  if (now < min_timer) {
+    if (next != nullptr) {
+      *next = std::min(*next, min_timer);
+    }
+    if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+      gpr_log(GPR_INFO, "TIMER CHECK SKIP: now=%" PRId64 " min_timer=%" PRId64,
+              now, min_timer);
+    }
+    return GRPC_TIMERS_CHECKED_AND_EMPTY;
+  }
+
+  grpc_error_handle shutdown_error =
+      now != GRPC_MILLIS_INF_FUTURE
+          ? GRPC_ERROR_NONE
+          : GRPC_ERROR_CREATE_FROM_STATIC_STRING("Shutting down timer system");
+
+  grpc_timer_check_result r =
+      run_some_expired_timers(now, next, shutdown_error);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_timer_check_trace)) {
+    gpr_log(GPR_INFO, "TIMER CHECK END: r=%d; next=%" PRId64, r,
+            next == nullptr ? -1 : *next);
+  }
+  return r;
+}
+
+grpc_timer_vtable grpc_wheel_timer_vtable = {
+    timer_init,      timer_cancel,        timer_check,
+    timer_list_init, timer_list_shutdown, timer_consume_kick};
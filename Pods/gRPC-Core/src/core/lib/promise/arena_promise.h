@@ -0,0 +1,173 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef GRPC_CORE_LIB_PROMISE_ARENA_PROMISE_H
+#define GRPC_CORE_LIB_PROMISE_ARENA_PROMISE_H
+
+#include <grpc/support/port_platform.h>
+
+#include <stdlib.h>
+
+#include <type_traits>
+#include <utility>
+
+#include "absl/meta/type_traits.h"
+
+#include "src/core/lib/promise/context.h"
+#include "src/core/lib/promise/poll.h"
+#include "src/core/lib/resource_quota/arena.h"
+
+namespace grpc_core {
+
+namespace arena_promise_detail {
+
+template <typename T>
+class ImplInterface {
+ public:
+  // Poll the underlying callable
+  virtual Poll<T> PollOnce() = 0;
+  // Destroy the underlying callable. The memory belongs to the arena and is
+  // released with it.
+  virtual void Destroy() = 0;
+
+ protected:
+  ~ImplInterface() = default;
+};
+
+// The implementation of an empty ArenaPromise: it must never be polled.
+template <typename T>
+class NullImpl final : public ImplInterface<T> {
+ public:
+  Poll<T> PollOnce() override { abort(); }
+  void Destroy() override {}
+
+  static ImplInterface<T>* Get() {
+    static NullImpl<T> instance;
+    return &instance;
+  }
+
+ private:
+  ~NullImpl() = default;
+};
+
+// A callable with state, placed in the arena.
+template <typename T, typename Callable>
+class CallableImpl final : public ImplInterface<T> {
+ public:
+  explicit CallableImpl(Callable&& callable) : callable_(std::move(callable)) {}
+  Poll<T> PollOnce() override { return callable_(); }
+  void Destroy() override { this->~CallableImpl(); }
+
+ private:
+  ~CallableImpl() = default;
+
+  Callable callable_;
+};
+
+// A callable without state (e.g., a captureless lambda): every promise of this
+// type can share one instance, so nothing needs to be allocated.
+template <typename T, typename Callable>
+class SharedImpl final : public ImplInterface<T> {
+ public:
+  Poll<T> PollOnce() override { return Callable()(); }
+  void Destroy() override {}
+
+  static ImplInterface<T>* Get() {
+    static SharedImpl<T, Callable> instance;
+    return &instance;
+  }
+
+ private:
+  ~SharedImpl() = default;
+};
+
+template <typename Callable>
+using IsStateless =
+    std::integral_constant<bool, std::is_empty<Callable>::value &&
+                                     std::is_default_constructible<
+                                         Callable>::value>;
+
+template <typename T, typename Callable>
+ImplInterface<T>* MakeImpl(Arena*, Callable&&, std::true_type /*stateless*/) {
+  return SharedImpl<T, Callable>::Get();
+}
+
+template <typename T, typename Callable>
+ImplInterface<T>* MakeImpl(Arena* arena, Callable&& callable,
+                           std::false_type /*stateless*/) {
+  return arena->New<CallableImpl<T, Callable>>(std::move(callable));
+}
+
+}  // namespace arena_promise_detail
+
+// A promise of a T, of any type, that lives in an arena.
+// Promise combinators (Seq, Race, ...) produce a distinct type for every
+// composition, which compile into one fused state machine but can't be named
+// across a call path built at runtime. ArenaPromise erases the type in one
+// virtual call per poll, placing the state in the (call's) arena rather than
+// on the heap: so a call's steps can be composed with no allocation beyond
+// the arena, and no closure scheduling between them.
+template <typename T>
+class ArenaPromise {
+ public:
+  // An empty promise, which must be assigned to before being polled.
+  ArenaPromise() = default;
+
+  // Make an ArenaPromise from a callable, in the given arena.
+  template <typename Callable,
+            typename = absl::enable_if_t<!std::is_same<
+                absl::decay_t<Callable>, ArenaPromise>::value>>
+  ArenaPromise(Arena* arena, Callable&& callable)
+      : impl_(arena_promise_detail::MakeImpl<T, absl::decay_t<Callable>>(
+            arena, absl::decay_t<Callable>(std::forward<Callable>(callable)),
+            arena_promise_detail::IsStateless<absl::decay_t<Callable>>())) {}
+
+  // Make an ArenaPromise from a callable, in the current arena context.
+  template <typename Callable,
+            typename = absl::enable_if_t<!std::is_same<
+                absl::decay_t<Callable>, ArenaPromise>::value>>
+  // NOLINTNEXTLINE(google-explicit-constructor)
+  ArenaPromise(Callable&& callable)
+      : ArenaPromise(GetContext<Arena>(), std::forward<Callable>(callable)) {}
+
+  ArenaPromise(const ArenaPromise&) = delete;
+  ArenaPromise& operator=(const ArenaPromise&) = delete;
+  ArenaPromise(ArenaPromise&& other) noexcept : impl_(other.impl_) {
+    other.impl_ = arena_promise_detail::NullImpl<T>::Get();
+  }
+  ArenaPromise& operator=(ArenaPromise&& other) noexcept {
+    impl_->Destroy();
+    impl_ = absl::exchange(other.impl_,
+                           arena_promise_detail::NullImpl<T>::Get());
+    return *this;
+  }
+
+  ~ArenaPromise() { impl_->Destroy(); }
+
+  // Poll the promise once.
+  Poll<T> operator()() { return impl_->PollOnce(); }
+
+  // Has this promise been given a callable?
+  bool has_value() const {
+    return impl_ != arena_promise_detail::NullImpl<T>::Get();
+  }
+
+ private:
+  arena_promise_detail::ImplInterface<T>* impl_ =
+      arena_promise_detail::NullImpl<T>::Get();
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_PROMISE_ARENA_PROMISE_H
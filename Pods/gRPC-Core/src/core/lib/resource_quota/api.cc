@@ -106,3 +106,48 @@ extern "C" void grpc_resource_quota_set_max_threads(
       ->thread_quota()
       ->SetMax(new_max_threads);
 }
+
+extern "C" void grpc_resource_quota_set_memory_pressure_thresholds(
+    grpc_resource_quota* resource_quota, double moderate, double high,
+    double critical) {
+  grpc_core::ExecCtx exec_ctx;
+  grpc_core::MemoryPressureThresholds thresholds;
+  thresholds.moderate = moderate;
+  thresholds.high = high;
+  thresholds.critical = critical;
+  grpc_core::ResourceQuota::FromC(resource_quota)
+      ->memory_quota()
+      ->SetPressureThresholds(thresholds);
+}
+
+extern "C" grpc_memory_pressure_level grpc_resource_quota_memory_pressure_level(
+    grpc_resource_quota* resource_quota) {
+  return static_cast<grpc_memory_pressure_level>(
+      grpc_core::ResourceQuota::FromC(resource_quota)
+          ->memory_quota()
+          ->PressureLevel());
+}
+
+extern "C" uint64_t grpc_resource_quota_memory_pressure_level_entries(
+    grpc_resource_quota* resource_quota, grpc_memory_pressure_level level) {
+  if (level < GRPC_MEMORY_PRESSURE_NONE ||
+      level > GRPC_MEMORY_PRESSURE_CRITICAL) {
+    return 0;
+  }
+  return grpc_core::ResourceQuota::FromC(resource_quota)
+      ->memory_quota()
+      ->PressureLevelEntries(
+          static_cast<grpc_core::MemoryPressureLevel>(level));
+}
+
+extern "C" void grpc_resource_quota_add_memory_pressure_watcher(
+    grpc_resource_quota* resource_quota,
+    void (*callback)(void* user_data, grpc_memory_pressure_level level),
+    void* user_data) {
+  grpc_core::ResourceQuota::FromC(resource_quota)
+      ->memory_quota()
+      ->AddPressureWatcher(
+          [callback, user_data](grpc_core::MemoryPressureLevel level) {
+            callback(user_data, static_cast<grpc_memory_pressure_level>(level));
+          });
+}
@@ -77,10 +77,15 @@ std::pair<Arena*, void*> Arena::CreateWithAlloc(
 }
 
 size_t Arena::Destroy() {
+  size_t size = DestroyKeepingStorage();
+  gpr_free_aligned(this);
+  return size;
+}
+
+size_t Arena::DestroyKeepingStorage() {
   size_t size = total_used_.load(std::memory_order_relaxed);
   memory_allocator_->Release(total_allocated_.load(std::memory_order_relaxed));
   this->~Arena();
-  gpr_free_aligned(this);
   return size;
 }
 
@@ -104,4 +109,111 @@ void* Arena::AllocZone(size_t size) {
   return reinterpret_cast<char*>(z) + zone_base_size;
 }
 
+void ArenaSizeEstimator::Update(size_t size) {
+  const size_t bucket = std::min(size / kBucketSize, kNumBuckets - 1);
+  buckets_[bucket].fetch_add(1, std::memory_order_relaxed);
+  if (bucket == kNumBuckets - 1) {
+    size_t max_large = max_large_.load(std::memory_order_relaxed);
+    while (max_large < size && !max_large_.compare_exchange_weak(
+                                   max_large, size, std::memory_order_relaxed,
+                                   std::memory_order_relaxed)) {
+    }
+  }
+  const uint32_t samples =
+      samples_.fetch_add(1, std::memory_order_relaxed) + 1;
+  if (samples < kSamplesPerUpdate) {
+    // Until there are enough sizes for a percentile, cover the largest one
+    size_t estimate = estimate_.load(std::memory_order_relaxed);
+    while (estimate < size && !estimate_.compare_exchange_weak(
+                                  estimate, size, std::memory_order_relaxed,
+                                  std::memory_order_relaxed)) {
+    }
+  } else if (samples % kSamplesPerUpdate == 0) {
+    Recompute();
+  }
+}
+
+void ArenaSizeEstimator::Recompute() {
+  uint32_t counts[kNumBuckets];
+  uint64_t total = 0;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    counts[i] = buckets_[i].load(std::memory_order_relaxed);
+    total += counts[i];
+  }
+  uint64_t seen = 0;
+  size_t estimate = kNumBuckets * kBucketSize;
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    seen += counts[i];
+    if (seen * 100 >= total * kPercentile) {
+      // The top of the bucket covers every size counted in it
+      estimate = i == kNumBuckets - 1
+                     ? std::max(estimate,
+                                max_large_.load(std::memory_order_relaxed))
+                     : (i + 1) * kBucketSize;
+      break;
+    }
+  }
+  estimate_.store(estimate, std::memory_order_relaxed);
+  // Halve the counts, so the estimate follows the recent sizes
+  for (size_t i = 0; i < kNumBuckets; i++) {
+    buckets_[i].fetch_sub(counts[i] / 2, std::memory_order_relaxed);
+  }
+  max_large_.store(0, std::memory_order_relaxed);
+}
+
+ArenaPool::~ArenaPool() {
+  for (size_t i = 0; i < num_pooled_; i++) {
+    gpr_free_aligned(pooled_[i].storage);
+  }
+}
+
+std::pair<Arena*, void*> ArenaPool::CreateWithAlloc(
+    size_t initial_size, size_t alloc_size, MemoryAllocator* memory_allocator) {
+  static constexpr size_t base_size =
+      GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(Arena));
+  initial_size = GPR_ROUND_UP_TO_ALIGNMENT_SIZE(initial_size);
+  void* storage = nullptr;
+  size_t initial_zone_size = 0;
+  void* stale[kMaxPooledArenas];
+  size_t num_stale = 0;
+  {
+    MutexLock lock(&mu_);
+    while (num_pooled_ > 0) {
+      const PooledArena& pooled = pooled_[--num_pooled_];
+      if (pooled.initial_zone_size >= initial_size) {
+        storage = pooled.storage;
+        initial_zone_size = pooled.initial_zone_size;
+        break;
+      }
+      // Too small for what calls need now; it would only ever be passed over
+      stale[num_stale++] = pooled.storage;
+    }
+  }
+  for (size_t i = 0; i < num_stale; i++) {
+    gpr_free_aligned(stale[i]);
+  }
+  if (storage == nullptr) {
+    return Arena::CreateWithAlloc(initial_size, alloc_size, memory_allocator);
+  }
+  auto* new_arena = new (storage)
+      Arena(initial_zone_size, alloc_size, memory_allocator);
+  void* first_alloc = reinterpret_cast<char*>(new_arena) + base_size;
+  return std::make_pair(new_arena, first_alloc);
+}
+
+size_t ArenaPool::Destroy(Arena* arena) {
+  const size_t initial_zone_size = arena->initial_zone_size_;
+  if (initial_zone_size > kMaxPooledArenaSize) return arena->Destroy();
+  size_t size = arena->DestroyKeepingStorage();
+  {
+    MutexLock lock(&mu_);
+    if (num_pooled_ < kMaxPooledArenas) {
+      pooled_[num_pooled_++] = PooledArena{arena, initial_zone_size};
+      return size;
+    }
+  }
+  gpr_free_aligned(arena);
+  return size;
+}
+
 }  // namespace grpc_core
@@ -33,11 +33,15 @@
 #include <memory>
 #include <new>
 #include <utility>
+#include <vector>
+
+#include "absl/container/inlined_vector.h"
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/sync.h>
 
 #include "src/core/lib/gpr/alloc.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/promise/context.h"
 #include "src/core/lib/resource_quota/memory_quota.h"
 
@@ -106,6 +110,11 @@ class Arena {
 
   ~Arena();
 
+  friend class ArenaPool;
+  // Destroy the arena as Destroy() does, but keep its storage so that an
+  // ArenaPool can build another arena in it.
+  size_t DestroyKeepingStorage();
+
   void* AllocZone(size_t size);
 
   // Keep track of the total used size. We use this in our call sizing
@@ -124,6 +133,68 @@ class Arena {
 };
 
 // Smart pointer for arenas when the final size is not required.
+// Learns the arena size that calls of one kind need: a high percentile of the
+// sizes seen recently, so that nearly all calls fit in their initial zone
+// without sizing every call for the largest one seen.
+class ArenaSizeEstimator {
+ public:
+  // Size to give the initial zone of the next arena
+  size_t Estimate() const { return estimate_.load(std::memory_order_relaxed); }
+  // Record the size an arena ended up using, as returned by Arena::Destroy()
+  void Update(size_t size);
+
+ private:
+  // Sizes are counted in buckets of kBucketSize bytes; the last bucket takes
+  // everything bigger
+  static constexpr size_t kBucketSize = 256;
+  static constexpr size_t kNumBuckets = 64;
+  // The estimate is recomputed, and the counts halved so that old sizes fade
+  // out, every kSamplesPerUpdate sizes
+  static constexpr uint32_t kSamplesPerUpdate = 128;
+  static constexpr uint32_t kPercentile = 95;
+
+  void Recompute();
+
+  std::atomic<uint32_t> buckets_[kNumBuckets]{};
+  std::atomic<uint32_t> samples_{0};
+  // Largest size seen in the last bucket since the last recompute
+  std::atomic<size_t> max_large_{0};
+  std::atomic<size_t> estimate_{0};
+};
+
+// Keeps arenas freed by calls on a channel, to build later calls' arenas in
+// their storage instead of going back to the heap for it.
+class ArenaPool {
+ public:
+  ArenaPool() = default;
+  ~ArenaPool();
+  ArenaPool(const ArenaPool&) = delete;
+  ArenaPool& operator=(const ArenaPool&) = delete;
+
+  // As Arena::CreateWithAlloc(), reusing a pooled arena whose initial zone has
+  // at least initial_size bytes if there is one.
+  std::pair<Arena*, void*> CreateWithAlloc(size_t initial_size,
+                                           size_t alloc_size,
+                                           MemoryAllocator* memory_allocator);
+  // As Arena::Destroy(), keeping the arena's storage for reuse if there's room
+  // in the pool.
+  size_t Destroy(Arena* arena);
+
+ private:
+  static constexpr size_t kMaxPooledArenas = 8;
+  // Arenas with bigger initial zones than this are always freed
+  static constexpr size_t kMaxPooledArenaSize = 64 * 1024;
+
+  struct PooledArena {
+    void* storage;
+    size_t initial_zone_size;
+  };
+
+  Mutex mu_;
+  PooledArena pooled_[kMaxPooledArenas] ABSL_GUARDED_BY(mu_);
+  size_t num_pooled_ ABSL_GUARDED_BY(mu_) = 0;
+};
+
 struct ScopedArenaDeleter {
   void operator()(Arena* arena) { arena->Destroy(); }
 };
@@ -133,6 +204,55 @@ inline ScopedArenaPtr MakeScopedArena(size_t initial_size,
   return ScopedArenaPtr(Arena::Create(initial_size, memory_allocator));
 }
 
+// Standard allocator drawing from an arena, so that containers living as long
+// as a call can grow without going to the heap. Deallocation is a no-op: the
+// memory is returned when the arena is destroyed. A default constructed
+// allocator has no arena and falls back to gpr_malloc/gpr_free, so containers
+// that are sometimes built outside a call stay usable.
+template <typename T>
+class ArenaAllocator {
+ public:
+  using value_type = T;
+  using propagate_on_container_copy_assignment = std::true_type;
+  using propagate_on_container_move_assignment = std::true_type;
+  using propagate_on_container_swap = std::true_type;
+
+  ArenaAllocator() = default;
+  explicit ArenaAllocator(Arena* arena) : arena_(arena) {}
+  template <typename U>
+  ArenaAllocator(const ArenaAllocator<U>& other)  // NOLINT
+      : arena_(other.arena()) {}
+
+  T* allocate(size_t n) {
+    if (arena_ == nullptr) return static_cast<T*>(gpr_malloc(n * sizeof(T)));
+    return static_cast<T*>(arena_->Alloc(n * sizeof(T)));
+  }
+  void deallocate(T* p, size_t) {
+    if (arena_ == nullptr) gpr_free(p);
+  }
+
+  Arena* arena() const { return arena_; }
+
+  template <typename U>
+  bool operator==(const ArenaAllocator<U>& other) const {
+    return arena_ == other.arena();
+  }
+  template <typename U>
+  bool operator!=(const ArenaAllocator<U>& other) const {
+    return arena_ != other.arena();
+  }
+
+ private:
+  Arena* arena_ = nullptr;
+};
+
+// Containers whose heap storage comes from an arena.
+// Elements must not outlive the arena that the container was built with.
+template <typename T, size_t N>
+using ArenaInlinedVector = absl::InlinedVector<T, N, ArenaAllocator<T>>;
+template <typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
 // Arenas form a context for activities
 template <>
 struct ContextType<Arena> {};
@@ -321,17 +321,24 @@ class BasicMemoryQuota::WaitForSweepPromise {
   uint64_t token_;
 };
 
+BasicMemoryQuota::BasicMemoryQuota(std::string name) : name_(std::move(name)) {
+  UpdateLevelFreeBytes();
+}
+
 void BasicMemoryQuota::Start() {
   auto self = shared_from_this();
 
   // Reclamation loop:
-  // basically, wait until we are in overcommit (free_bytes_ < 0), and then:
-  // while (free_bytes_ < 0) reclaim_memory()
+  // basically, wait until we are under memory pressure, and then:
+  // while (under memory pressure) reclaim_memory()
   // ... and repeat
+  // The pressure level limits which passes reclaim_memory() may choose from.
   auto reclamation_loop = Loop(Seq(
       [self]() -> Poll<int> {
-        // If there's free memory we no longer need to reclaim memory!
-        if (self->free_bytes_.load(std::memory_order_acquire) > 0) {
+        self->NotifyPressureWatchers();
+        // If there's memory to spare we no longer need to reclaim memory!
+        if (self->free_bytes_.load(std::memory_order_acquire) > 0 &&
+            self->PressureLevel() == MemoryPressureLevel::kNone) {
           return Pending{};
         }
         return 0;
@@ -345,10 +352,13 @@ void BasicMemoryQuota::Start() {
             return std::make_tuple(name, std::move(f));
           };
         };
-        return Race(Map(self->reclaimers_[0].Next(), annotate("compact")),
-                    Map(self->reclaimers_[1].Next(), annotate("benign")),
-                    Map(self->reclaimers_[2].Next(), annotate("idle")),
-                    Map(self->reclaimers_[3].Next(), annotate("destructive")));
+        auto next = [self](size_t pass) {
+          return [self, pass]() { return self->PollReclaimer(pass); };
+        };
+        return Race(Map(next(0), annotate("compact")),
+                    Map(next(1), annotate("benign")),
+                    Map(next(2), annotate("idle")),
+                    Map(next(3), annotate("destructive")));
       },
       [self](std::tuple<const char*, ReclamationFunction> arg) {
         auto reclaimer = std::move(std::get<1>(arg));
@@ -382,8 +392,22 @@ void BasicMemoryQuota::Start() {
 
 void BasicMemoryQuota::Stop() { reclaimer_activity_.reset(); }
 
+Poll<ReclamationFunction> BasicMemoryQuota::PollReclaimer(size_t pass) {
+  // Keep the watchers current while we wait for a reclaimer.
+  NotifyPressureWatchers();
+  // Compaction runs alongside benign reclamation, each later pass from its
+  // own level on.
+  GPR_DEBUG_ASSERT(pass < kNumReclamationPasses);
+  if (free_bytes_.load(std::memory_order_acquire) > 0 &&
+      static_cast<size_t>(PressureLevel()) < std::max<size_t>(pass, 1)) {
+    return Pending{};
+  }
+  return reclaimers_[pass].PollNext();
+}
+
 void BasicMemoryQuota::SetSize(size_t new_size) {
   size_t old_size = quota_size_.exchange(new_size, std::memory_order_relaxed);
+  UpdateLevelFreeBytes();
   if (old_size < new_size) {
     // We're growing the quota.
     Return(new_size - old_size);
@@ -403,6 +427,7 @@ void BasicMemoryQuota::Take(size_t amount) {
   if (prior >= 0 && prior < static_cast<intptr_t>(amount)) {
     if (reclaimer_activity_ != nullptr) reclaimer_activity_->ForceWakeup();
   }
+  UpdatePressureLevel(prior - static_cast<intptr_t>(amount));
 }
 
 void BasicMemoryQuota::FinishReclamation(uint64_t token) {
@@ -419,7 +444,89 @@ void BasicMemoryQuota::FinishReclamation(uint64_t token) {
 }
 
 void BasicMemoryQuota::Return(size_t amount) {
-  free_bytes_.fetch_add(amount, std::memory_order_relaxed);
+  auto prior = free_bytes_.fetch_add(amount, std::memory_order_relaxed);
+  UpdatePressureLevel(prior + static_cast<intptr_t>(amount));
+}
+
+void BasicMemoryQuota::SetPressureThresholds(
+    MemoryPressureThresholds thresholds) {
+  {
+    MutexLock lock(&pressure_mu_);
+    // Keep each threshold within [0, 1] and no lower than the one before it.
+    pressure_thresholds_.moderate = Clamp(thresholds.moderate, 0.0, 1.0);
+    pressure_thresholds_.high =
+        Clamp(thresholds.high, pressure_thresholds_.moderate, 1.0);
+    pressure_thresholds_.critical =
+        Clamp(thresholds.critical, pressure_thresholds_.high, 1.0);
+  }
+  UpdateLevelFreeBytes();
+}
+
+MemoryPressureThresholds BasicMemoryQuota::PressureThresholds() const {
+  MutexLock lock(&pressure_mu_);
+  return pressure_thresholds_;
+}
+
+void BasicMemoryQuota::AddPressureWatcher(MemoryPressureCallback callback) {
+  MutexLock lock(&pressure_mu_);
+  pressure_watchers_.push_back(std::move(callback));
+}
+
+void BasicMemoryQuota::UpdateLevelFreeBytes() {
+  MemoryPressureThresholds thresholds = PressureThresholds();
+  const double size = quota_size_.load(std::memory_order_relaxed);
+  const double fractions[] = {thresholds.moderate, thresholds.high,
+                              thresholds.critical};
+  for (size_t i = 0; i < GPR_ARRAY_SIZE(fractions); i++) {
+    // Stay well inside intptr_t, which a double can't represent exactly.
+    static const double kMaxFreeBytes =
+        static_cast<double>(std::numeric_limits<intptr_t>::max() / 2);
+    level_free_bytes_[i].store(static_cast<intptr_t>(std::min(
+                                   size * (1.0 - fractions[i]), kMaxFreeBytes)),
+                               std::memory_order_relaxed);
+  }
+  UpdatePressureLevel(free_bytes_.load(std::memory_order_relaxed));
+}
+
+void BasicMemoryQuota::UpdatePressureLevel(intptr_t free_bytes) {
+  size_t level = 0;
+  if (free_bytes <= 0) {
+    level = kNumMemoryPressureLevels - 1;
+  } else {
+    while (level < kNumMemoryPressureLevels - 1 &&
+           free_bytes <=
+               level_free_bytes_[level].load(std::memory_order_relaxed)) {
+      level++;
+    }
+  }
+  const auto new_level = static_cast<MemoryPressureLevel>(level);
+  if (pressure_level_.load(std::memory_order_relaxed) == new_level) return;
+  // Memory can be returned from outside of an ExecCtx (e.g. as an allocator
+  // is destroyed): then the reclaimer activity picks up the level when it
+  // next runs.
+  if (pressure_level_.exchange(new_level, std::memory_order_relaxed) !=
+          new_level &&
+      reclaimer_activity_ != nullptr && ExecCtx::Get() != nullptr) {
+    reclaimer_activity_->ForceWakeup();
+  }
+}
+
+void BasicMemoryQuota::NotifyPressureWatchers() {
+  const MemoryPressureLevel level = PressureLevel();
+  if (level == notified_pressure_level_) return;
+  notified_pressure_level_ = level;
+  pressure_level_entries_[static_cast<size_t>(level)].fetch_add(
+      1, std::memory_order_relaxed);
+  if (GRPC_TRACE_FLAG_ENABLED(grpc_resource_quota_trace)) {
+    gpr_log(GPR_INFO, "RQ: %s memory pressure level now %d", name_.c_str(),
+            static_cast<int>(level));
+  }
+  std::vector<MemoryPressureCallback> watchers;
+  {
+    MutexLock lock(&pressure_mu_);
+    watchers = pressure_watchers_;
+  }
+  for (const auto& watcher : watchers) watcher(level);
 }
 
 std::pair<double, size_t>
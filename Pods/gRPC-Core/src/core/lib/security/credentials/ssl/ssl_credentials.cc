@@ -22,6 +22,8 @@
 
 #include <string.h>
 
+#include "absl/strings/str_cat.h"
+
 #include <grpc/support/alloc.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
@@ -58,6 +60,8 @@ grpc_ssl_credentials::create_security_connector(
     grpc_channel_args** new_args) {
   const char* overridden_target_name = nullptr;
   tsi_ssl_session_cache* ssl_session_cache = nullptr;
+  const bool enable_early_data =
+      grpc_channel_args_find_bool(args, GRPC_ARG_TLS_EARLY_DATA, false);
   for (size_t i = 0; args && i < args->num_args; i++) {
     grpc_arg* arg = &args->args[i];
     if (strcmp(arg->key, GRPC_SSL_TARGET_NAME_OVERRIDE_ARG) == 0 &&
@@ -70,10 +74,13 @@ grpc_ssl_credentials::create_security_connector(
           static_cast<tsi_ssl_session_cache*>(arg->value.pointer.p);
     }
   }
+  if (ssl_session_cache == nullptr) {
+    ssl_session_cache = grpc_core::DefaultSslSessionCache(session_cache_key());
+  }
   grpc_core::RefCountedPtr<grpc_channel_security_connector> sc =
       grpc_ssl_channel_security_connector_create(
           this->Ref(), std::move(call_creds), &config_, target,
-          overridden_target_name, ssl_session_cache);
+          overridden_target_name, ssl_session_cache, enable_early_data);
   if (sc == nullptr) {
     return sc;
   }
@@ -83,6 +90,25 @@ grpc_ssl_credentials::create_security_connector(
   return sc;
 }
 
+std::string grpc_ssl_credentials::session_cache_key() const {
+  // A peer verified by a callback could be accepted by one callback and
+  // rejected by another, so the callback is part of the key as well.
+  const absl::string_view separator("\0", 1);
+  return absl::StrCat(
+      config_.pem_root_certs == nullptr ? "" : config_.pem_root_certs,
+      separator,
+      config_.pem_key_cert_pair == nullptr
+          ? ""
+          : config_.pem_key_cert_pair->cert_chain,
+      separator,
+      reinterpret_cast<uintptr_t>(config_.verify_options.verify_peer_callback),
+      ",",
+      reinterpret_cast<uintptr_t>(
+          config_.verify_options.verify_peer_callback_userdata),
+      ",", static_cast<int>(config_.min_tls_version), ",",
+      static_cast<int>(config_.max_tls_version));
+}
+
 void grpc_ssl_credentials::build_config(
     const char* pem_root_certs, grpc_ssl_pem_key_cert_pair* pem_key_cert_pair,
     const grpc_ssl_verify_peer_options* verify_options) {
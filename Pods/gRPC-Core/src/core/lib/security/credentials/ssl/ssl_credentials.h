@@ -46,6 +46,8 @@ class grpc_ssl_credentials : public grpc_channel_credentials {
   void build_config(const char* pem_root_certs,
                     grpc_ssl_pem_key_cert_pair* pem_key_cert_pair,
                     const grpc_ssl_verify_peer_options* verify_options);
+  // Identifies config_ in DefaultSslSessionCache().
+  std::string session_cache_key() const;
 
   grpc_ssl_config config_;
 };
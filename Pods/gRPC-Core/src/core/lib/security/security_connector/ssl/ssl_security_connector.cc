@@ -32,6 +32,7 @@
 #include "src/core/ext/transport/chttp2/alpn/alpn.h"
 #include "src/core/lib/channel/handshaker.h"
 #include "src/core/lib/gpr/string.h"
+#include "src/core/lib/gpr/useful.h"
 #include "src/core/lib/gprpp/host_port.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/gprpp/sync.h"
@@ -69,13 +70,14 @@ class grpc_ssl_channel_security_connector final
       grpc_core::RefCountedPtr<grpc_channel_credentials> channel_creds,
       grpc_core::RefCountedPtr<grpc_call_credentials> request_metadata_creds,
       const grpc_ssl_config* config, const char* target_name,
-      const char* overridden_target_name)
+      const char* overridden_target_name, bool enable_early_data)
       : grpc_channel_security_connector(GRPC_SSL_URL_SCHEME,
                                         std::move(channel_creds),
                                         std::move(request_metadata_creds)),
         overridden_target_name_(
             overridden_target_name == nullptr ? "" : overridden_target_name),
-        verify_options_(&config->verify_options) {
+        verify_options_(&config->verify_options),
+        enable_early_data_(enable_early_data) {
     absl::string_view host;
     absl::string_view port;
     grpc_core::SplitHostPort(target_name, &host, &port);
@@ -107,6 +109,7 @@ class grpc_ssl_channel_security_connector final
     options.session_cache = ssl_session_cache;
     options.min_tls_version = grpc_get_tsi_tls_version(config->min_tls_version);
     options.max_tls_version = grpc_get_tsi_tls_version(config->max_tls_version);
+    options.enable_early_data = enable_early_data_;
     const tsi_result result =
         tsi_create_ssl_client_handshaker_factory_with_options(
             &options, &client_handshaker_factory_);
@@ -182,7 +185,10 @@ class grpc_ssl_channel_security_connector final
     if (c != 0) return c;
     c = target_name_.compare(other->target_name_);
     if (c != 0) return c;
-    return overridden_target_name_.compare(other->overridden_target_name_);
+    c = overridden_target_name_.compare(other->overridden_target_name_);
+    if (c != 0) return c;
+    return grpc_core::QsortCompare(enable_early_data_,
+                                   other->enable_early_data_);
   }
 
   bool check_call_host(absl::string_view host, grpc_auth_context* auth_context,
@@ -203,6 +209,7 @@ class grpc_ssl_channel_security_connector final
   std::string target_name_;
   std::string overridden_target_name_;
   const verify_peer_options* verify_options_;
+  const bool enable_early_data_;
 };
 
 class grpc_ssl_server_security_connector
@@ -405,7 +412,7 @@ grpc_ssl_channel_security_connector_create(
     grpc_core::RefCountedPtr<grpc_call_credentials> request_metadata_creds,
     const grpc_ssl_config* config, const char* target_name,
     const char* overridden_target_name,
-    tsi_ssl_session_cache* ssl_session_cache) {
+    tsi_ssl_session_cache* ssl_session_cache, bool enable_early_data) {
   if (config == nullptr || target_name == nullptr) {
     gpr_log(GPR_ERROR, "An ssl channel needs a config and a target name.");
     return nullptr;
@@ -429,7 +436,7 @@ grpc_ssl_channel_security_connector_create(
   grpc_core::RefCountedPtr<grpc_ssl_channel_security_connector> c =
       grpc_core::MakeRefCounted<grpc_ssl_channel_security_connector>(
           std::move(channel_creds), std::move(request_metadata_creds), config,
-          target_name, overridden_target_name);
+          target_name, overridden_target_name, enable_early_data);
   const grpc_security_status result = c->InitializeHandshakerFactory(
       config, pem_root_certs, root_store, ssl_session_cache);
   if (result != GRPC_SECURITY_OK) {
@@ -55,7 +55,7 @@ grpc_ssl_channel_security_connector_create(
     grpc_core::RefCountedPtr<grpc_call_credentials> request_metadata_creds,
     const grpc_ssl_config* config, const char* target_name,
     const char* overridden_target_name,
-    tsi_ssl_session_cache* ssl_session_cache);
+    tsi_ssl_session_cache* ssl_session_cache, bool enable_early_data);
 
 /* Config for ssl servers. */
 struct grpc_ssl_server_config {
@@ -20,6 +20,7 @@
 
 #include "src/core/lib/security/security_connector/ssl_utils.h"
 
+#include <map>
 #include <vector>
 
 #include "absl/strings/str_cat.h"
@@ -33,6 +34,7 @@
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gprpp/host_port.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
+#include "src/core/lib/gprpp/sync.h"
 #include "src/core/lib/iomgr/load_file.h"
 #include "src/core/lib/security/context/security_context.h"
 #include "src/core/lib/security/security_connector/load_system_roots.h"
@@ -62,6 +64,11 @@ void grpc_set_ssl_roots_override_callback(grpc_ssl_roots_override_callback cb) {
   ssl_roots_override_cb = cb;
 }
 
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_ssl_default_session_cache_size, 256,
+    "Capacity in sessions of the default SSL session cache of each distinct "
+    "SSL credentials config. 0 disables the default caches.");
+
 /* -- Cipher suites. -- */
 
 static gpr_once cipher_suites_once = GPR_ONCE_INIT;
@@ -535,6 +542,81 @@ grpc_arg grpc_ssl_session_cache_create_channel_arg(
       const_cast<char*>(GRPC_SSL_SESSION_CACHE_ARG), cache, &vtable);
 }
 
+void grpc_ssl_session_cache_get_stats(grpc_ssl_session_cache* cache,
+                                      uint64_t* hits, uint64_t* misses) {
+  tsi_ssl_session_cache_get_stats(
+      reinterpret_cast<tsi_ssl_session_cache*>(cache), hits, misses);
+}
+
+void grpc_ssl_get_protection_stats(grpc_ssl_protection_stats* stats) {
+  tsi_ssl_protection_stats tsi_stats;
+  tsi_ssl_get_protection_stats(&tsi_stats);
+  stats->connections = tsi_stats.connections;
+  stats->records_protected = tsi_stats.records_protected;
+  stats->records_unprotected = tsi_stats.records_unprotected;
+  stats->bytes_protected = tsi_stats.bytes_protected;
+  stats->bytes_unprotected = tsi_stats.bytes_unprotected;
+  stats->protect_ns = tsi_stats.protect_ns;
+  stats->unprotect_ns = tsi_stats.unprotect_ns;
+  stats->key_updates = tsi_stats.key_updates;
+}
+
+/* --- Default SSL session caches. --- */
+
+namespace {
+
+// Bounds the memory held by the default caches when an application creates
+// credentials with many different configs.
+constexpr size_t kMaxDefaultSessionCaches = 16;
+
+struct DefaultSessionCaches {
+  grpc_core::Mutex mu;
+  // Caches are kept until shutdown: each only holds a bounded number of
+  // sessions.
+  std::map<std::string, tsi_ssl_session_cache*> caches ABSL_GUARDED_BY(mu);
+};
+
+DefaultSessionCaches* GetDefaultSessionCaches() {
+  static DefaultSessionCaches* caches = new DefaultSessionCaches();
+  return caches;
+}
+
+}  // namespace
+
+void grpc_ssl_default_session_cache_get_stats(uint64_t* hits,
+                                              uint64_t* misses) {
+  *hits = 0;
+  *misses = 0;
+  DefaultSessionCaches* caches = GetDefaultSessionCaches();
+  grpc_core::MutexLock lock(&caches->mu);
+  for (const auto& p : caches->caches) {
+    uint64_t cache_hits;
+    uint64_t cache_misses;
+    tsi_ssl_session_cache_get_stats(p.second, &cache_hits, &cache_misses);
+    *hits += cache_hits;
+    *misses += cache_misses;
+  }
+}
+
+namespace grpc_core {
+
+tsi_ssl_session_cache* DefaultSslSessionCache(const std::string& config_key) {
+  static const int32_t capacity =
+      GPR_GLOBAL_CONFIG_GET(grpc_ssl_default_session_cache_size);
+  if (capacity <= 0) return nullptr;
+  DefaultSessionCaches* caches = GetDefaultSessionCaches();
+  MutexLock lock(&caches->mu);
+  auto it = caches->caches.find(config_key);
+  if (it != caches->caches.end()) return it->second;
+  if (caches->caches.size() >= kMaxDefaultSessionCaches) return nullptr;
+  tsi_ssl_session_cache* cache =
+      tsi_ssl_session_cache_create_lru(static_cast<size_t>(capacity));
+  caches->caches.emplace(config_key, cache);
+  return cache;
+}
+
+}  // namespace grpc_core
+
 /* --- Default SSL root store implementation. --- */
 
 namespace grpc_core {
@@ -134,6 +134,14 @@ class DefaultSslRootStore {
   static grpc_slice default_pem_root_certs_;
 };
 
+// The process-wide session cache used by SSL credentials that aren't given
+// one through GRPC_SSL_SESSION_CACHE_ARG. Sessions are only shared between
+// credentials with the same config_key, which must identify everything that
+// verifying the peer depends on, so that a session is never resumed by a
+// channel that would not have accepted its server. Returns nullptr if the
+// default caches are disabled or too many distinct keys are in use.
+tsi_ssl_session_cache* DefaultSslSessionCache(const std::string& config_key);
+
 class PemKeyCertPair {
  public:
   PemKeyCertPair(absl::string_view private_key, absl::string_view cert_chain)
@@ -0,0 +1,117 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/security/transport/handshake_worker_pool.h"
+
+#include <string.h>
+
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gprpp/global_config.h"
+#include "src/core/lib/iomgr/exec_ctx.h"
+
+GPR_GLOBAL_CONFIG_DEFINE_INT32(
+    grpc_handshake_threads, 0,
+    "Number of threads that run security handshake steps off the polling "
+    "threads. 0 runs them inline.");
+
+namespace grpc_core {
+
+namespace {
+
+// Upper bound on GRPC_HANDSHAKE_THREADS, so that a typo cannot spawn
+// thousands of threads.
+constexpr int kMaxHandshakeThreads = 64;
+
+gpr_once g_pool_once = GPR_ONCE_INIT;
+HandshakeWorkerPool* g_pool = nullptr;
+
+uint64_t TimespecToNanos(gpr_timespec ts) {
+  return static_cast<uint64_t>(ts.tv_sec) * GPR_NS_PER_SEC +
+         static_cast<uint64_t>(ts.tv_nsec);
+}
+
+}  // namespace
+
+HandshakeWorkerPool* HandshakeWorkerPool::Get() {
+  gpr_once_init(&g_pool_once, []() {
+    int num_threads = GPR_GLOBAL_CONFIG_GET(grpc_handshake_threads);
+    if (num_threads <= 0) return;
+    if (num_threads > kMaxHandshakeThreads) {
+      gpr_log(GPR_INFO, "Capping GRPC_HANDSHAKE_THREADS %d to %d", num_threads,
+              kMaxHandshakeThreads);
+      num_threads = kMaxHandshakeThreads;
+    }
+    g_pool = new HandshakeWorkerPool(num_threads);
+  });
+  return g_pool;
+}
+
+HandshakeWorkerPool::HandshakeWorkerPool(int num_threads) {
+  threads_.reserve(num_threads);
+  for (int i = 0; i < num_threads; ++i) {
+    threads_.emplace_back("grpc_handshake", &ThreadMain, this, nullptr,
+                          Thread::Options().set_joinable(false));
+    threads_.back().Start();
+  }
+}
+
+void HandshakeWorkerPool::Run(grpc_closure* closure) {
+  MutexLock lock(&mu_);
+  queue_.push_back({closure, gpr_now(GPR_CLOCK_MONOTONIC)});
+  if (queue_.size() > max_queue_depth_) max_queue_depth_ = queue_.size();
+  cv_.Signal();
+}
+
+void HandshakeWorkerPool::GetStats(grpc_handshake_pool_stats* stats) {
+  MutexLock lock(&mu_);
+  stats->num_threads = threads_.size();
+  stats->queue_depth = queue_.size();
+  stats->max_queue_depth = max_queue_depth_;
+  stats->steps_run = steps_run_;
+  stats->total_queue_wait_ns = total_queue_wait_ns_;
+}
+
+void HandshakeWorkerPool::ThreadMain(void* arg) {
+  HandshakeWorkerPool* pool = static_cast<HandshakeWorkerPool*>(arg);
+  while (true) {
+    grpc_closure* closure;
+    {
+      MutexLock lock(&pool->mu_);
+      while (pool->queue_.empty()) pool->cv_.Wait(&pool->mu_);
+      QueuedClosure next = pool->queue_.front();
+      pool->queue_.pop_front();
+      gpr_timespec wait =
+          gpr_time_sub(gpr_now(GPR_CLOCK_MONOTONIC), next.enqueue_time);
+      ++pool->steps_run_;
+      pool->total_queue_wait_ns_ += TimespecToNanos(wait);
+      closure = next.closure;
+    }
+    ExecCtx exec_ctx;
+    closure->cb(closure->cb_arg, GRPC_ERROR_NONE);
+  }
+}
+
+}  // namespace grpc_core
+
+void grpc_handshake_pool_get_stats(grpc_handshake_pool_stats* stats) {
+  memset(stats, 0, sizeof(*stats));
+  grpc_core::HandshakeWorkerPool* pool = grpc_core::HandshakeWorkerPool::Get();
+  if (pool != nullptr) pool->GetStats(stats);
+}
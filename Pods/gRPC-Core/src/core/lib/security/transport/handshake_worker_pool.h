@@ -0,0 +1,73 @@
+//
+// Copyright 2021 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+
+#ifndef GRPC_CORE_LIB_SECURITY_TRANSPORT_HANDSHAKE_WORKER_POOL_H
+#define GRPC_CORE_LIB_SECURITY_TRANSPORT_HANDSHAKE_WORKER_POOL_H
+
+#include <grpc/support/port_platform.h>
+
+#include <deque>
+#include <vector>
+
+#include <grpc/grpc_security.h>
+#include <grpc/support/time.h>
+
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/gprpp/thd.h"
+#include "src/core/lib/iomgr/closure.h"
+
+namespace grpc_core {
+
+// A fixed set of threads that run the CPU-heavy steps of security handshakes
+// (tsi_handshaker_next() and the peer check that follows it), so that a burst
+// of new connections does not stall the pollers serving established ones.
+// At most one step per thread runs at a time; the rest wait in a FIFO queue.
+// The pool size comes from the GRPC_HANDSHAKE_THREADS environment variable;
+// the default of 0 keeps handshakes inline on the polling thread.
+class HandshakeWorkerPool {
+ public:
+  // Returns the process-wide pool, starting its threads on first use, or
+  // nullptr if handshakes are not offloaded.
+  static HandshakeWorkerPool* Get();
+
+  // Runs \a closure with GRPC_ERROR_NONE on one of the pool threads, under an
+  // ExecCtx of that thread.
+  void Run(grpc_closure* closure);
+
+  void GetStats(grpc_handshake_pool_stats* stats);
+
+ private:
+  struct QueuedClosure {
+    grpc_closure* closure;
+    gpr_timespec enqueue_time;
+  };
+
+  explicit HandshakeWorkerPool(int num_threads);
+
+  static void ThreadMain(void* arg);
+
+  Mutex mu_;
+  CondVar cv_;
+  std::deque<QueuedClosure> queue_ ABSL_GUARDED_BY(mu_);
+  size_t max_queue_depth_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t steps_run_ ABSL_GUARDED_BY(mu_) = 0;
+  uint64_t total_queue_wait_ns_ ABSL_GUARDED_BY(mu_) = 0;
+  std::vector<Thread> threads_;
+};
+
+}  // namespace grpc_core
+
+#endif  // GRPC_CORE_LIB_SECURITY_TRANSPORT_HANDSHAKE_WORKER_POOL_H
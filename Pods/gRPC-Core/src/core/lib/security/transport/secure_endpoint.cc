@@ -39,6 +39,10 @@
 #include "src/core/tsi/transport_security_grpc.h"
 
 #define STAGING_BUFFER_SIZE 8192
+/* Large enough for a whole TLS record of the largest frame size, so that the
+   common case of one record per staging buffer doesn't split its bytes over
+   two output slices. */
+#define WRITE_STAGING_BUFFER_SIZE 16384
 
 static void on_read(void* user_data, grpc_error_handle error);
 
@@ -92,7 +96,8 @@ struct secure_endpoint {
   grpc_slice_buffer leftover_bytes;
   /* buffers for read and write */
   grpc_slice read_staging_buffer = GRPC_SLICE_MALLOC(STAGING_BUFFER_SIZE);
-  grpc_slice write_staging_buffer = GRPC_SLICE_MALLOC(STAGING_BUFFER_SIZE);
+  grpc_slice write_staging_buffer =
+      GRPC_SLICE_MALLOC(WRITE_STAGING_BUFFER_SIZE);
   grpc_slice_buffer output_buffer;
 
   gpr_refcount ref;
@@ -272,7 +277,7 @@ static void endpoint_read(grpc_endpoint* secure_ep, grpc_slice_buffer* slices,
 static void flush_write_staging_buffer(secure_endpoint* ep, uint8_t** cur,
                                        uint8_t** end) {
   grpc_slice_buffer_add(&ep->output_buffer, ep->write_staging_buffer);
-  ep->write_staging_buffer = GRPC_SLICE_MALLOC(STAGING_BUFFER_SIZE);
+  ep->write_staging_buffer = GRPC_SLICE_MALLOC(WRITE_STAGING_BUFFER_SIZE);
   *cur = GRPC_SLICE_START_PTR(ep->write_staging_buffer);
   *end = GRPC_SLICE_END_PTR(ep->write_staging_buffer);
 }
@@ -35,6 +35,7 @@
 #include "src/core/lib/config/core_configuration.h"
 #include "src/core/lib/gprpp/ref_counted_ptr.h"
 #include "src/core/lib/security/context/security_context.h"
+#include "src/core/lib/security/transport/handshake_worker_pool.h"
 #include "src/core/lib/security/transport/secure_endpoint.h"
 #include "src/core/lib/security/transport/tsi_error.h"
 #include "src/core/lib/slice/slice_internal.h"
@@ -61,6 +62,7 @@ class SecurityHandshaker : public Handshaker {
  private:
   grpc_error_handle DoHandshakerNextLocked(const unsigned char* bytes_received,
                                            size_t bytes_received_size);
+  grpc_error_handle StartHandshakerNextLocked(size_t bytes_received_size);
 
   grpc_error_handle OnHandshakeNextDoneLocked(
       tsi_result result, const unsigned char* bytes_to_send,
@@ -75,6 +77,7 @@ class SecurityHandshaker : public Handshaker {
       void* arg, grpc_error_handle error);
   static void OnHandshakeDataSentToPeerFnScheduler(void* arg,
                                                    grpc_error_handle error);
+  static void OnHandshakerNextOffloadedFn(void* arg, grpc_error_handle error);
   static void OnHandshakeNextDoneGrpcWrapper(
       tsi_result result, void* user_data, const unsigned char* bytes_to_send,
       size_t bytes_to_send_size, tsi_handshaker_result* handshaker_result);
@@ -104,6 +107,9 @@ class SecurityHandshaker : public Handshaker {
   grpc_closure on_handshake_data_sent_to_peer_;
   grpc_closure on_handshake_data_received_from_peer_;
   grpc_closure on_peer_checked_;
+  grpc_closure on_handshaker_next_offloaded_;
+  // Bytes in handshake_buffer_ for the offloaded tsi_handshaker_next() call.
+  size_t offloaded_bytes_received_size_ = 0;
   RefCountedPtr<grpc_auth_context> auth_context_;
   tsi_handshaker_result* handshaker_result_ = nullptr;
   size_t max_frame_size_ = 0;
@@ -435,6 +441,40 @@ grpc_error_handle SecurityHandshaker::DoHandshakerNextLocked(
                                    hs_result);
 }
 
+// Feeds the bytes_received_size bytes of handshake_buffer_ to the TSI
+// handshaker, inline or on the handshake worker pool if there is one.
+// handshake_buffer_ is not touched again until the next read completes, which
+// cannot happen before the offloaded step has run.
+grpc_error_handle SecurityHandshaker::StartHandshakerNextLocked(
+    size_t bytes_received_size) {
+  HandshakeWorkerPool* pool = HandshakeWorkerPool::Get();
+  if (pool == nullptr) {
+    return DoHandshakerNextLocked(handshake_buffer_, bytes_received_size);
+  }
+  offloaded_bytes_received_size_ = bytes_received_size;
+  pool->Run(GRPC_CLOSURE_INIT(&on_handshaker_next_offloaded_,
+                              &SecurityHandshaker::OnHandshakerNextOffloadedFn,
+                              this, nullptr));
+  return GRPC_ERROR_NONE;
+}
+
+void SecurityHandshaker::OnHandshakerNextOffloadedFn(
+    void* arg, grpc_error_handle /*error*/) {
+  RefCountedPtr<SecurityHandshaker> h(static_cast<SecurityHandshaker*>(arg));
+  MutexLock lock(&h->mu_);
+  if (h->is_shutdown_) {
+    h->HandshakeFailedLocked(GRPC_ERROR_NONE);
+    return;
+  }
+  grpc_error_handle error = h->DoHandshakerNextLocked(
+      h->handshake_buffer_, h->offloaded_bytes_received_size_);
+  if (error != GRPC_ERROR_NONE) {
+    h->HandshakeFailedLocked(error);
+  } else {
+    h.release();  // Avoid unref
+  }
+}
+
 // This callback might be run inline while we are still holding on to the mutex,
 // so schedule OnHandshakeDataReceivedFromPeerFn on ExecCtx to avoid a deadlock.
 void SecurityHandshaker::OnHandshakeDataReceivedFromPeerFnScheduler(
@@ -460,7 +500,7 @@ void SecurityHandshaker::OnHandshakeDataReceivedFromPeerFn(
   // Copy all slices received.
   size_t bytes_received_size = h->MoveReadBufferIntoHandshakeBuffer();
   // Call TSI handshaker.
-  error = h->DoHandshakerNextLocked(h->handshake_buffer_, bytes_received_size);
+  error = h->StartHandshakerNextLocked(bytes_received_size);
   if (error != GRPC_ERROR_NONE) {
     h->HandshakeFailedLocked(error);
   } else {
@@ -533,8 +573,7 @@ void SecurityHandshaker::DoHandshake(grpc_tcp_server_acceptor* /*acceptor*/,
   args_ = args;
   on_handshake_done_ = on_handshake_done;
   size_t bytes_received_size = MoveReadBufferIntoHandshakeBuffer();
-  grpc_error_handle error =
-      DoHandshakerNextLocked(handshake_buffer_, bytes_received_size);
+  grpc_error_handle error = StartHandshakerNextLocked(bytes_received_size);
   if (error != GRPC_ERROR_NONE) {
     HandshakeFailedLocked(error);
   } else {
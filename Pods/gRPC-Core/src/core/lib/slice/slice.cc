@@ -26,6 +26,7 @@
 
 #include "src/core/lib/gprpp/memory.h"
 #include "src/core/lib/gprpp/ref_counted.h"
+#include "src/core/lib/slice/slice_block_cache.h"
 #include "src/core/lib/slice/slice_internal.h"
 
 char* grpc_slice_to_c_string(grpc_slice slice) {
@@ -270,13 +271,15 @@ class MallocRefCount {
  public:
   static void Destroy(void* arg) {
     MallocRefCount* r = static_cast<MallocRefCount*>(arg);
+    const size_t block_size = r->block_size_;
     r->~MallocRefCount();
-    gpr_free(r);
+    grpc_core::SliceBlockCache::Free(r, block_size);
   }
 
-  MallocRefCount()
+  explicit MallocRefCount(size_t block_size)
       : base_(grpc_slice_refcount::Type::REGULAR, &refs_, Destroy, this,
-              &base_) {}
+              &base_),
+        block_size_(block_size) {}
   ~MallocRefCount() = default;
 
   grpc_slice_refcount* base_refcount() { return &base_; }
@@ -284,6 +287,7 @@ class MallocRefCount {
  private:
   grpc_slice_refcount base_;
   std::atomic<size_t> refs_{1};
+  const size_t block_size_;
 };
 
 }  // namespace
@@ -302,13 +306,15 @@ void grpc_core::UnmanagedMemorySlice::HeapInit(size_t length) {
 
      refcount is a malloc_refcount
      bytes is an array of bytes of the requested length
-     Both parts are placed in the same allocation returned from gpr_malloc */
-  auto* rc =
-      static_cast<MallocRefCount*>(gpr_malloc(sizeof(MallocRefCount) + length));
+     Both parts are placed in the same allocation, taken from the thread's
+     SliceBlockCache */
+  const size_t block_size = sizeof(MallocRefCount) + length;
+  auto* rc = static_cast<MallocRefCount*>(
+      grpc_core::SliceBlockCache::Alloc(block_size));
 
   /* Initial refcount on rc is 1 - and it's up to the caller to release
      this reference. */
-  new (rc) MallocRefCount();
+  new (rc) MallocRefCount(block_size);
 
   /* Build up the slice to be returned. */
   /* The slices refcount points back to the allocated block. */
@@ -0,0 +1,135 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/slice/slice_block_cache.h"
+
+#ifdef GPR_POSIX_SYNC
+#include <pthread.h>
+#endif
+
+#include <grpc/support/alloc.h>
+#include <grpc/support/log.h>
+#include <grpc/support/sync.h>
+
+#include "src/core/lib/gpr/tls.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Size classes: 128 byte blocks up to kMaxCachedBlockSize
+constexpr size_t kMinClassShift = 7;
+constexpr size_t kNumClasses = 8;
+static_assert(size_t{1} << (kMinClassShift + kNumClasses - 1) ==
+                  SliceBlockCache::kMaxCachedBlockSize,
+              "size classes must end at kMaxCachedBlockSize");
+
+size_t SizeClass(size_t size) {
+  size_t size_class = 0;
+  while ((size_t{1} << (size_class + kMinClassShift)) < size) size_class++;
+  return size_class;
+}
+
+size_t ClassBlockSize(size_t size_class) {
+  return size_t{1} << (size_class + kMinClassShift);
+}
+
+// Free blocks are linked through their first bytes
+struct FreeBlock {
+  FreeBlock* next;
+};
+
+struct Cache {
+  FreeBlock* free_blocks[kNumClasses];
+  size_t free_count[kNumClasses];
+};
+
+GPR_THREAD_LOCAL(Cache*) g_cache;
+
+#ifdef GPR_POSIX_SYNC
+// Only used to free a thread's cache when it exits: g_cache is what's read on
+// the allocation path.
+pthread_key_t g_cache_key;
+gpr_once g_cache_key_once = GPR_ONCE_INIT;
+
+void DestroyCache(void* arg) {
+  Cache* cache = static_cast<Cache*>(arg);
+  g_cache = nullptr;
+  for (size_t i = 0; i < kNumClasses; i++) {
+    for (FreeBlock* block = cache->free_blocks[i]; block != nullptr;) {
+      FreeBlock* next = block->next;
+      gpr_free(block);
+      block = next;
+    }
+  }
+  gpr_free(cache);
+}
+
+void InitCacheKey() {
+  GPR_ASSERT(pthread_key_create(&g_cache_key, DestroyCache) == 0);
+}
+
+Cache* GetOrCreateCache() {
+  Cache* cache = g_cache;
+  if (cache != nullptr) return cache;
+  gpr_once_init(&g_cache_key_once, InitCacheKey);
+  cache = static_cast<Cache*>(gpr_zalloc(sizeof(Cache)));
+  if (pthread_setspecific(g_cache_key, cache) != 0) {
+    gpr_free(cache);
+    return nullptr;
+  }
+  g_cache = cache;
+  return cache;
+}
+#else
+Cache* GetOrCreateCache() { return nullptr; }
+#endif
+
+}  // namespace
+
+void* SliceBlockCache::Alloc(size_t size) {
+  if (size > kMaxCachedBlockSize) return gpr_malloc(size);
+  const size_t size_class = SizeClass(size);
+  Cache* cache = g_cache;
+  if (cache != nullptr && cache->free_blocks[size_class] != nullptr) {
+    FreeBlock* block = cache->free_blocks[size_class];
+    cache->free_blocks[size_class] = block->next;
+    cache->free_count[size_class]--;
+    return block;
+  }
+  return gpr_malloc(ClassBlockSize(size_class));
+}
+
+void SliceBlockCache::Free(void* block, size_t size) {
+  if (size > kMaxCachedBlockSize) {
+    gpr_free(block);
+    return;
+  }
+  const size_t size_class = SizeClass(size);
+  Cache* cache = GetOrCreateCache();
+  if (cache == nullptr || (cache->free_count[size_class] + 1) *
+                                  ClassBlockSize(size_class) >
+                              kMaxCachedBytesPerClass) {
+    gpr_free(block);
+    return;
+  }
+  FreeBlock* free_block = static_cast<FreeBlock*>(block);
+  free_block->next = cache->free_blocks[size_class];
+  cache->free_blocks[size_class] = free_block;
+  cache->free_count[size_class]++;
+}
+
+}  // namespace grpc_core
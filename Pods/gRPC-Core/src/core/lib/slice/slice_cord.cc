@@ -0,0 +1,134 @@
+// Copyright 2022 gRPC authors.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <grpc/support/port_platform.h>
+
+#include "src/core/lib/slice/slice_cord.h"
+
+#include <string.h>
+
+#include <atomic>
+
+#include <grpc/byte_buffer_reader.h>
+#include <grpc/support/log.h>
+
+#include "src/core/lib/slice/slice_internal.h"
+
+namespace grpc_core {
+
+namespace {
+
+// Slices up to this size are copied into the cord rather than referenced:
+// the cord would copy them into one of its own nodes on append anyway.
+constexpr size_t kMaxBytesToCopy = 511;
+
+// Takes ownership of slice.
+absl::Cord CordFromSlice(grpc_slice slice) {
+  absl::string_view bytes(
+      reinterpret_cast<const char*>(GRPC_SLICE_START_PTR(slice)),
+      GRPC_SLICE_LENGTH(slice));
+  if (slice.refcount == nullptr || bytes.size() <= kMaxBytesToCopy) {
+    absl::Cord cord(bytes);
+    grpc_slice_unref_internal(slice);
+    return cord;
+  }
+  return absl::MakeCordFromExternal(
+      bytes, [slice](absl::string_view) { grpc_slice_unref_internal(slice); });
+}
+
+// Keeps a cord alive for as long as there are slices of its chunks.
+class CordSliceRefcount {
+ public:
+  explicit CordSliceRefcount(absl::Cord cord)
+      : base_(grpc_slice_refcount::Type::REGULAR, &refs_, Destroy, this,
+              &base_),
+        cord_(std::move(cord)) {}
+
+  grpc_slice_refcount* base_refcount() { return &base_; }
+  const absl::Cord& cord() const { return cord_; }
+
+ private:
+  static void Destroy(void* arg) {
+    delete static_cast<CordSliceRefcount*>(arg);
+  }
+
+  grpc_slice_refcount base_;
+  std::atomic<size_t> refs_{1};
+  absl::Cord cord_;
+};
+
+}  // namespace
+
+SliceCord::SliceCord(grpc_slice_buffer* slice_buffer) {
+  while (slice_buffer->count > 0) {
+    cord_.Append(CordFromSlice(grpc_slice_buffer_take_first(slice_buffer)));
+  }
+}
+
+void SliceCord::Append(Slice slice) {
+  cord_.Append(CordFromSlice(slice.TakeCSlice()));
+}
+
+void SliceCord::Prepend(Slice slice) {
+  cord_.Prepend(CordFromSlice(slice.TakeCSlice()));
+}
+
+SliceCord SliceCord::TakeFirst(size_t n) {
+  GPR_ASSERT(n <= cord_.size());
+  SliceCord prefix(cord_.Subcord(0, n));
+  cord_.RemovePrefix(n);
+  return prefix;
+}
+
+void SliceCord::MoveTo(grpc_slice_buffer* slice_buffer) {
+  if (cord_.empty()) return;
+  auto* refcount = new CordSliceRefcount(std::move(cord_));
+  cord_.Clear();
+  for (absl::string_view chunk : refcount->cord().Chunks()) {
+    grpc_slice slice;
+    if (chunk.size() <= GRPC_SLICE_INLINED_SIZE) {
+      slice.refcount = nullptr;
+      slice.data.inlined.length = static_cast<uint8_t>(chunk.size());
+      memcpy(slice.data.inlined.bytes, chunk.data(), chunk.size());
+    } else {
+      refcount->base_refcount()->Ref();
+      slice.refcount = refcount->base_refcount();
+      slice.data.refcounted.bytes =
+          reinterpret_cast<uint8_t*>(const_cast<char*>(chunk.data()));
+      slice.data.refcounted.length = chunk.size();
+    }
+    grpc_slice_buffer_add(slice_buffer, slice);
+  }
+  refcount->base_refcount()->Unref();
+}
+
+SliceCord SliceCord::FromByteBuffer(grpc_byte_buffer* byte_buffer) {
+  SliceCord result;
+  grpc_byte_buffer_reader reader;
+  if (!grpc_byte_buffer_reader_init(&reader, byte_buffer)) return result;
+  grpc_slice slice;
+  while (grpc_byte_buffer_reader_next(&reader, &slice) != 0) {
+    result.cord_.Append(CordFromSlice(slice));
+  }
+  grpc_byte_buffer_reader_destroy(&reader);
+  return result;
+}
+
+grpc_byte_buffer* SliceCord::MoveToByteBuffer() {
+  grpc_byte_buffer* byte_buffer = grpc_raw_byte_buffer_create(nullptr, 0);
+  MoveTo(&byte_buffer->data.raw.slice_buffer);
+  return byte_buffer;
+}
+
+}  // namespace grpc_core
@@ -40,6 +40,7 @@
 
 #include "src/core/lib/channel/channel_stack.h"
 #include "src/core/lib/compression/compression_internal.h"
+#include "src/core/lib/debug/rpc_timeline.h"
 #include "src/core/lib/debug/stats.h"
 #include "src/core/lib/gpr/alloc.h"
 #include "src/core/lib/gpr/string.h"
@@ -136,6 +137,7 @@ struct grpc_call {
         cq(args.cq),
         channel(args.channel),
         is_client(args.server_transport_data == nullptr),
+        arena_size_estimator(args.arena_size_estimator),
         stream_op_payload(context) {}
 
   ~grpc_call() {
@@ -159,6 +161,7 @@ struct grpc_call {
 
   /* client or server call */
   bool is_client;
+  grpc_core::ArenaSizeEstimator* arena_size_estimator;
   /** has grpc_call_unref been called */
   bool destroy_called = false;
   /** flag indicating that cancellation is inherited */
@@ -337,7 +340,13 @@ grpc_error_handle grpc_call_create(grpc_call_create_args* args,
   grpc_error_handle error = GRPC_ERROR_NONE;
   grpc_channel_stack* channel_stack =
       grpc_channel_get_channel_stack(args->channel);
-  size_t initial_size = grpc_channel_get_call_size_estimate(args->channel);
+  size_t initial_size = 0;
+  if (args->arena_size_estimator != nullptr) {
+    initial_size = args->arena_size_estimator->Estimate();
+  }
+  if (initial_size == 0) {
+    initial_size = grpc_channel_get_call_size_estimate(args->channel);
+  }
   GRPC_STATS_INC_CALL_INITIAL_SIZE(initial_size);
   size_t call_and_stack_size =
       GPR_ROUND_UP_TO_ALIGNMENT_SIZE(sizeof(grpc_call)) +
@@ -346,8 +355,8 @@ grpc_error_handle grpc_call_create(grpc_call_create_args* args,
       call_and_stack_size + (args->parent ? sizeof(child_call) : 0);
 
   std::pair<grpc_core::Arena*, void*> arena_with_call =
-      grpc_core::Arena::CreateWithAlloc(initial_size, call_alloc_size,
-                                        &*args->channel->allocator);
+      args->channel->arena_pool->CreateWithAlloc(initial_size, call_alloc_size,
+                                                 &*args->channel->allocator);
   arena = arena_with_call.first;
   call = new (arena_with_call.second) grpc_call(arena, *args);
   *out_call = call;
@@ -357,6 +366,11 @@ grpc_error_handle grpc_call_create(grpc_call_create_args* args,
     call->final_op.client.status = nullptr;
     call->final_op.client.error_string = nullptr;
     GRPC_STATS_INC_CLIENT_CALLS_CREATED();
+    if (GPR_UNLIKELY(grpc_core::RpcTimeline::ShouldSample())) {
+      grpc_call_context_set(
+          call, GRPC_CONTEXT_RPC_TIMELINE,
+          arena->New<grpc_core::RpcTimeline>(call->start_time), nullptr);
+    }
     path = grpc_slice_ref_internal(args->path->c_slice());
     call->send_initial_metadata.Set(grpc_core::HttpPathMetadata(),
                                     std::move(*args->path));
@@ -513,14 +527,23 @@ static void release_call(void* call, grpc_error_handle /*error*/) {
   grpc_call* c = static_cast<grpc_call*>(call);
   grpc_channel* channel = c->channel;
   grpc_core::Arena* arena = c->arena;
+  grpc_core::ArenaSizeEstimator* arena_size_estimator = c->arena_size_estimator;
   c->~grpc_call();
-  grpc_channel_update_call_size_estimate(channel, arena->Destroy());
+  size_t arena_size = channel->arena_pool->Destroy(arena);
+  if (arena_size_estimator != nullptr) {
+    arena_size_estimator->Update(arena_size);
+  } else {
+    grpc_channel_update_call_size_estimate(channel, arena_size);
+  }
   GRPC_CHANNEL_INTERNAL_UNREF(channel, "call");
 }
 
 static void destroy_call(void* call, grpc_error_handle /*error*/) {
   GPR_TIMER_SCOPE("destroy_call", 0);
   grpc_call* c = static_cast<grpc_call*>(call);
+  auto* timeline = static_cast<grpc_core::RpcTimeline*>(
+      c->context[GRPC_CONTEXT_RPC_TIMELINE].value);
+  if (GPR_UNLIKELY(timeline != nullptr)) timeline->Publish();
   c->recv_initial_metadata.Clear();
   c->recv_trailing_metadata.Clear();
   c->receiving_stream.reset();
@@ -631,6 +654,14 @@ char* grpc_call_get_peer(grpc_call* call) {
   return gpr_strdup("unknown");
 }
 
+int grpc_call_get_rpc_timeline(grpc_call* call, grpc_rpc_timeline* timeline) {
+  auto* rpc_timeline = static_cast<grpc_core::RpcTimeline*>(
+      call->context[GRPC_CONTEXT_RPC_TIMELINE].value);
+  if (rpc_timeline == nullptr) return 0;
+  rpc_timeline->Get(timeline);
+  return 1;
+}
+
 grpc_call* grpc_call_from_top_element(grpc_call_element* surface_element) {
   return CALL_FROM_TOP_ELEM(surface_element);
 }
@@ -1030,6 +1061,8 @@ static void post_batch_completion(batch_control* bctl) {
     call->send_trailing_metadata.Clear();
   }
   if (bctl->op.recv_trailing_metadata) {
+    grpc_core::RpcTimeline::Record(call->context,
+                                   GRPC_RPC_TIMELINE_COMPLETION_DISPATCHED);
     /* propagate cancellation to any interested children */
     gpr_atm_rel_store(&call->received_final_op_atm, 1);
     parent_call* pc = get_parent_call(call);
@@ -1089,6 +1122,8 @@ static void continue_receiving_slices(batch_control* bctl) {
     size_t remaining = call->receiving_stream->length() -
                        (*call->receiving_buffer)->data.raw.slice_buffer.length;
     if (remaining == 0) {
+      grpc_core::RpcTimeline::Record(call->context,
+                                     GRPC_RPC_TIMELINE_FIRST_MESSAGE_RECEIVED);
       call->receiving_message = false;
       call->receiving_stream.reset();
       finish_batch_step(bctl);
@@ -1250,6 +1285,8 @@ static void receiving_initial_metadata_ready(void* bctlp,
   GRPC_CALL_COMBINER_STOP(&call->call_combiner, "recv_initial_metadata_ready");
 
   if (error == GRPC_ERROR_NONE) {
+    grpc_core::RpcTimeline::Record(call->context,
+                                   GRPC_RPC_TIMELINE_FIRST_BYTE_RECEIVED);
     grpc_metadata_batch* md = &call->recv_initial_metadata;
     recv_initial_filter(call, md);
 
@@ -1306,6 +1343,8 @@ static void receiving_trailing_metadata_ready(void* bctlp,
   batch_control* bctl = static_cast<batch_control*>(bctlp);
   grpc_call* call = bctl->call;
   GRPC_CALL_COMBINER_STOP(&call->call_combiner, "recv_trailing_metadata_ready");
+  grpc_core::RpcTimeline::Record(call->context,
+                                 GRPC_RPC_TIMELINE_LAST_BYTE_RECEIVED);
   grpc_metadata_batch* md = &call->recv_trailing_metadata;
   recv_trailing_filter(call, md, GRPC_ERROR_REF(error));
   finish_batch_step(bctl);
@@ -1315,6 +1354,10 @@ static void finish_batch(void* bctlp, grpc_error_handle error) {
   batch_control* bctl = static_cast<batch_control*>(bctlp);
   grpc_call* call = bctl->call;
   GRPC_CALL_COMBINER_STOP(&call->call_combiner, "on_complete");
+  if (bctl->op.send_initial_metadata) {
+    grpc_core::RpcTimeline::Record(call->context,
+                                   GRPC_RPC_TIMELINE_HEADERS_SENT);
+  }
   if (bctl->batch_error.ok()) {
     bctl->batch_error.set(error);
   }
@@ -1786,6 +1829,10 @@ void* grpc_call_context_get(grpc_call* call, grpc_context_index elem) {
 
 uint8_t grpc_call_is_client(grpc_call* call) { return call->is_client; }
 
+gpr_timespec grpc_call_get_age(grpc_call* call) {
+  return gpr_cycle_counter_sub(gpr_get_cycle_counter(), call->start_time);
+}
+
 grpc_compression_algorithm grpc_call_compression_for_level(
     grpc_call* call, grpc_compression_level level) {
   return call->encodings_accepted_by_peer.CompressionAlgorithmForLevel(level);
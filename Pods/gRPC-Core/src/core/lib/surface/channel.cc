@@ -91,6 +91,7 @@ grpc_channel* grpc_channel_create_with_builder(
   channel->allocator.Init(grpc_core::ResourceQuotaFromChannelArgs(args)
                               ->memory_quota()
                               ->CreateMemoryOwner(name));
+  channel->arena_pool.Init();
 
   gpr_atm_no_barrier_store(
       &channel->call_size_estimate,
@@ -345,7 +346,8 @@ static grpc_call* grpc_channel_create_call_internal(
     grpc_channel* channel, grpc_call* parent_call, uint32_t propagation_mask,
     grpc_completion_queue* cq, grpc_pollset_set* pollset_set_alternative,
     grpc_core::Slice path, absl::optional<grpc_core::Slice> authority,
-    grpc_millis deadline) {
+    grpc_millis deadline,
+    grpc_core::ArenaSizeEstimator* arena_size_estimator = nullptr) {
   GPR_ASSERT(channel->is_client);
   GPR_ASSERT(!(cq != nullptr && pollset_set_alternative != nullptr));
 
@@ -360,6 +362,7 @@ static grpc_call* grpc_channel_create_call_internal(
   args.path = std::move(path);
   args.authority = std::move(authority);
   args.send_deadline = deadline;
+  args.arena_size_estimator = arena_size_estimator;
 
   grpc_call* call;
   GRPC_LOG_IF_ERROR("call_create", grpc_call_create(&args, &call));
@@ -468,7 +471,7 @@ grpc_call* grpc_channel_create_registered_call(
       rc->authority.has_value()
           ? absl::optional<grpc_core::Slice>(rc->authority->Ref())
           : absl::nullopt,
-      grpc_timespec_to_millis_round_up(deadline));
+      grpc_timespec_to_millis_round_up(deadline), &rc->arena_size_estimator);
 
   return call;
 }
@@ -483,6 +486,7 @@ static void destroy_channel(void* arg, grpc_error_handle /*error*/) {
   }
   grpc_channel_stack_destroy(CHANNEL_STACK_FROM_CHANNEL(channel));
   channel->registration_table.Destroy();
+  channel->arena_pool.Destroy();
   channel->allocator.Destroy();
   channel->target.Destroy();
   gpr_free(channel);
@@ -31,6 +31,7 @@
 
 #include <grpc/support/alloc.h>
 #include <grpc/support/atm.h>
+#include <grpc/support/cpu.h>
 #include <grpc/support/log.h>
 #include <grpc/support/string_util.h>
 #include <grpc/support/time.h>
@@ -39,6 +40,7 @@
 #include "src/core/lib/gpr/spinlock.h"
 #include "src/core/lib/gpr/string.h"
 #include "src/core/lib/gpr/tls.h"
+#include "src/core/lib/gprpp/mpmcq.h"
 #include "src/core/lib/iomgr/executor.h"
 #include "src/core/lib/iomgr/pollset.h"
 #include "src/core/lib/iomgr/timer.h"
@@ -320,7 +322,19 @@ struct cq_callback_data {
 #endif
   }
 
-  /** No actual completed events queue, unlike other types */
+  /** No actual completed events queue, unlike other types: only callbacks
+      waiting for an executor thread. Rather than each taking its own trip
+      through the executor, they queue here for drainers that run them in
+      batches, so producers don't contend on the executor's locks. */
+  struct QueuedCallback {
+    grpc_completion_queue_functor* functor = nullptr;
+    bool ok = false;
+  };
+  grpc_core::BoundedMultiProducerMultiConsumerQueue<QueuedCallback, 256>
+      queued_callbacks;
+
+  /** Number of drainers of queued_callbacks scheduled on the executor */
+  std::atomic<size_t> num_callback_drainers{0};
 
   /** Number of pending events (+1 if we're not shutdown).
       Initial count is dropped by grpc_completion_queue_shutdown. */
@@ -827,6 +841,54 @@ static void functor_callback(void* arg, grpc_error_handle error) {
   functor->functor_run(functor, error == GRPC_ERROR_NONE);
 }
 
+static void drain_queued_callbacks(void* arg, grpc_error_handle /*error*/) {
+  grpc_completion_queue* cq = static_cast<grpc_completion_queue*>(arg);
+  cq_callback_data* cqd = static_cast<cq_callback_data*> DATA_FROM_CQ(cq);
+  cq_callback_data::QueuedCallback callback;
+  for (;;) {
+    while (cqd->queued_callbacks.TryPop(&callback)) {
+      callback.functor->functor_run(callback.functor, callback.ok);
+    }
+    cqd->num_callback_drainers.fetch_sub(1, std::memory_order_seq_cst);
+    /* A callback queued since our last pop may have seen us still running and
+       so not scheduled a drainer: if so, carry on (unless another drainer has
+       started since) */
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (cqd->queued_callbacks.SizeApprox() == 0) break;
+    size_t num_drainers = 0;
+    if (!cqd->num_callback_drainers.compare_exchange_strong(
+            num_drainers, 1, std::memory_order_seq_cst)) {
+      break;
+    }
+  }
+  GRPC_CQ_INTERNAL_UNREF(cq, "callback_drainer");
+}
+
+/* Make sure a drainer will run the callback just queued: start one if none
+   are running, or another (up to one per core) if callbacks are backing up */
+static void maybe_start_callback_drainer(grpc_completion_queue* cq,
+                                         cq_callback_data* cqd) {
+  static constexpr size_t kQueuedCallbacksPerDrainer = 16;
+  static const size_t max_drainers =
+      static_cast<size_t>(std::max(1u, gpr_cpu_num_cores()));
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  size_t num_drainers =
+      cqd->num_callback_drainers.load(std::memory_order_seq_cst);
+  while (num_drainers == 0 ||
+         (num_drainers < max_drainers &&
+          cqd->queued_callbacks.SizeApprox() >
+              num_drainers * kQueuedCallbacksPerDrainer)) {
+    if (cqd->num_callback_drainers.compare_exchange_weak(
+            num_drainers, num_drainers + 1, std::memory_order_seq_cst)) {
+      GRPC_CQ_INTERNAL_REF(cq, "callback_drainer");
+      grpc_core::Executor::Run(
+          GRPC_CLOSURE_CREATE(drain_queued_callbacks, cq, nullptr),
+          GRPC_ERROR_NONE);
+      return;
+    }
+  }
+}
+
 /* Complete an event on a completion queue of type GRPC_CQ_CALLBACK */
 static void cq_end_op_for_callback(
     grpc_completion_queue* cq, void* tag, grpc_error_handle error,
@@ -857,28 +919,41 @@ static void cq_end_op_for_callback(
 
   cq_check_tag(cq, tag, true); /* Used in debug builds only */
 
-  if (cqd->pending_events.fetch_sub(1, std::memory_order_acq_rel) == 1) {
-    cq_finish_shutdown_callback(cq);
-  }
-
   // If possible, schedule the callback onto an existing thread-local
   // ApplicationCallbackExecCtx, which is a work queue. This is possible for:
   // 1. The callback is internally-generated and there is an ACEC available
   // 2. The callback is marked inlineable and there is an ACEC available
   // 3. We are already running in a background poller thread (which always has
   //    an ACEC available at the base of the stack).
+  // Otherwise the callback goes to the executor: queued for a drainer if
+  // there's room, which must happen before the pending event is finished,
+  // since that may let the cq be destroyed.
   auto* functor = static_cast<grpc_completion_queue_functor*>(tag);
-  if (((internal || functor->inlineable) &&
+  const bool run_inline =
+      ((internal || functor->inlineable) &&
        grpc_core::ApplicationCallbackExecCtx::Available()) ||
-      grpc_iomgr_is_any_background_poller_thread()) {
+      grpc_iomgr_is_any_background_poller_thread();
+  const bool queued =
+      !run_inline && cqd->queued_callbacks.TryPush(
+                         {functor, error == GRPC_ERROR_NONE});
+  if (queued) maybe_start_callback_drainer(cq, cqd);
+
+  if (cqd->pending_events.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    cq_finish_shutdown_callback(cq);
+  }
+
+  if (run_inline) {
     grpc_core::ApplicationCallbackExecCtx::Enqueue(functor,
                                                    (error == GRPC_ERROR_NONE));
     GRPC_ERROR_UNREF(error);
     return;
   }
+  if (queued) {
+    GRPC_ERROR_UNREF(error);
+    return;
+  }
 
-  // Schedule the callback on a closure if not internal or triggered
-  // from a background poller thread.
+  // Schedule the callback on a closure of its own if the queue is full.
   grpc_core::Executor::Run(
       GRPC_CLOSURE_CREATE(functor_callback, functor, nullptr), error);
 }
@@ -952,24 +1027,22 @@ static void dump_pending_tags(grpc_completion_queue* cq) {
 static void dump_pending_tags(grpc_completion_queue* /*cq*/) {}
 #endif
 
-static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
-                          void* reserved) {
-  GPR_TIMER_SCOPE("grpc_completion_queue_next", 0);
+static void cq_completion_to_event(grpc_cq_completion* c, grpc_event* ev) {
+  ev->type = GRPC_OP_COMPLETE;
+  ev->success = c->next & 1u;
+  ev->tag = c->tag;
+  c->done(c->done_arg, c);
+}
 
-  grpc_event ret;
+/* Body of grpc_completion_queue_next(_batch): waits for the first event as
+   grpc_completion_queue_next does, then takes up to max_events - 1 more that
+   are already queued. Returns the number of events written to events. */
+static size_t cq_next_events(grpc_completion_queue* cq, gpr_timespec deadline,
+                             grpc_event* events, size_t max_events) {
+  grpc_event& ret = events[0];
+  size_t num_events = 1;
   cq_next_data* cqd = static_cast<cq_next_data*> DATA_FROM_CQ(cq);
 
-  GRPC_API_TRACE(
-      "grpc_completion_queue_next("
-      "cq=%p, "
-      "deadline=gpr_timespec { tv_sec: %" PRId64
-      ", tv_nsec: %d, clock_type: %d }, "
-      "reserved=%p)",
-      5,
-      (cq, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
-       reserved));
-  GPR_ASSERT(!reserved);
-
   dump_pending_tags(cq);
 
   GRPC_CQ_INTERNAL_REF(cq, "next");
@@ -986,23 +1059,18 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
   for (;;) {
     grpc_millis iteration_deadline = deadline_millis;
 
-    if (is_finished_arg.stolen_completion != nullptr) {
-      grpc_cq_completion* c = is_finished_arg.stolen_completion;
-      is_finished_arg.stolen_completion = nullptr;
-      ret.type = GRPC_OP_COMPLETE;
-      ret.success = c->next & 1u;
-      ret.tag = c->tag;
-      c->done(c->done_arg, c);
-      break;
-    }
-
-    grpc_cq_completion* c = cqd->queue.Pop();
+    grpc_cq_completion* c = is_finished_arg.stolen_completion;
+    is_finished_arg.stolen_completion = nullptr;
+    if (c == nullptr) c = cqd->queue.Pop();
 
     if (c != nullptr) {
-      ret.type = GRPC_OP_COMPLETE;
-      ret.success = c->next & 1u;
-      ret.tag = c->tag;
-      c->done(c->done_arg, c);
+      cq_completion_to_event(c, &ret);
+      /* Whatever else is already queued comes for free: no more polling, and
+         no more trips through this function */
+      while (num_events < max_events &&
+             (c = cqd->queue.Pop()) != nullptr) {
+        cq_completion_to_event(c, &events[num_events++]);
+      }
       break;
     } else {
       /* If c == NULL it means either the queue is empty OR in an transient
@@ -1071,11 +1139,33 @@ static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
     gpr_mu_unlock(cq->mu);
   }
 
-  GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, &ret);
+  for (size_t i = 0; i < num_events; i++) {
+    GRPC_SURFACE_TRACE_RETURNED_EVENT(cq, &events[i]);
+  }
   GRPC_CQ_INTERNAL_UNREF(cq, "next");
 
   GPR_ASSERT(is_finished_arg.stolen_completion == nullptr);
 
+  return num_events;
+}
+
+static grpc_event cq_next(grpc_completion_queue* cq, gpr_timespec deadline,
+                          void* reserved) {
+  GPR_TIMER_SCOPE("grpc_completion_queue_next", 0);
+
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next("
+      "cq=%p, "
+      "deadline=gpr_timespec { tv_sec: %" PRId64
+      ", tv_nsec: %d, clock_type: %d }, "
+      "reserved=%p)",
+      5,
+      (cq, deadline.tv_sec, deadline.tv_nsec, (int)deadline.clock_type,
+       reserved));
+  GPR_ASSERT(!reserved);
+
+  grpc_event ret;
+  cq_next_events(cq, deadline, &ret, 1);
   return ret;
 }
 
@@ -1126,6 +1216,28 @@ grpc_event grpc_completion_queue_next(grpc_completion_queue* cq,
   return cq->vtable->next(cq, deadline, reserved);
 }
 
+size_t grpc_completion_queue_next_batch(grpc_completion_queue* cq,
+                                        grpc_event* events, size_t max_events,
+                                        gpr_timespec deadline,
+                                        void* reserved) {
+  GPR_TIMER_SCOPE("grpc_completion_queue_next_batch", 0);
+
+  GRPC_API_TRACE(
+      "grpc_completion_queue_next_batch("
+      "cq=%p, events=%p, max_events=%" PRIuPTR ", "
+      "deadline=gpr_timespec { tv_sec: %" PRId64
+      ", tv_nsec: %d, clock_type: %d }, "
+      "reserved=%p)",
+      7,
+      (cq, events, max_events, deadline.tv_sec, deadline.tv_nsec,
+       (int)deadline.clock_type, reserved));
+  GPR_ASSERT(!reserved);
+  GPR_ASSERT(max_events > 0);
+  GPR_ASSERT(cq->vtable->cq_completion_type == GRPC_CQ_NEXT);
+
+  return cq_next_events(cq, deadline, events, max_events);
+}
+
 static int add_plucker(grpc_completion_queue* cq, void* tag,
                        grpc_pollset_worker** worker) {
   cq_pluck_data* cqd = static_cast<cq_pluck_data*> DATA_FROM_CQ(cq);
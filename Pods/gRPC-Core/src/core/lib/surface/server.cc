@@ -172,6 +172,16 @@ class Server::RequestMatcherInterface {
   virtual void RequestCallWithPossiblePublish(size_t request_queue_index,
                                               RequestedCall* call) = 0;
 
+  // Like RequestCallWithPossiblePublish, for several RPCs placed on the same
+  // queue at once.
+  virtual void RequestCallsWithPossiblePublish(size_t request_queue_index,
+                                               RequestedCall** calls,
+                                               size_t count) {
+    for (size_t i = 0; i < count; i++) {
+      RequestCallWithPossiblePublish(request_queue_index, calls[i]);
+    }
+  }
+
   // This function is invoked on an incoming RPC, represented by the calld
   // object. The RequestMatcher will try to match it against an
   // application-requested RPC if possible or will place it in the pending queue
@@ -207,6 +217,7 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
       calld->SetState(CallData::CallState::ZOMBIED);
       calld->KillZombie();
       pending_.pop();
+      pending_calls_.fetch_sub(1, std::memory_order_relaxed);
     }
   }
 
@@ -228,38 +239,22 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
   void RequestCallWithPossiblePublish(size_t request_queue_index,
                                       RequestedCall* call) override {
     if (requests_per_cq_[request_queue_index].Push(&call->mpscq_node)) {
-      /* this was the first queued request: we need to lock and start
-         matching calls */
-      struct PendingCall {
-        RequestedCall* rc = nullptr;
-        CallData* calld;
-      };
-      auto pop_next_pending = [this, request_queue_index] {
-        PendingCall pending_call;
-        {
-          MutexLock lock(&server_->mu_call_);
-          if (!pending_.empty()) {
-            pending_call.rc = reinterpret_cast<RequestedCall*>(
-                requests_per_cq_[request_queue_index].Pop());
-            if (pending_call.rc != nullptr) {
-              pending_call.calld = pending_.front();
-              pending_.pop();
-            }
-          }
-        }
-        return pending_call;
-      };
-      while (true) {
-        PendingCall next_pending = pop_next_pending();
-        if (next_pending.rc == nullptr) break;
-        if (!next_pending.calld->MaybeActivate()) {
-          // Zombied Call
-          next_pending.calld->KillZombie();
-        } else {
-          next_pending.calld->Publish(request_queue_index, next_pending.rc);
-        }
+      /* this was the first queued request: we need to start matching calls */
+      PublishPending(request_queue_index);
+    }
+  }
+
+  void RequestCallsWithPossiblePublish(size_t request_queue_index,
+                                       RequestedCall** calls,
+                                       size_t count) override {
+    bool first = false;
+    for (size_t i = 0; i < count; i++) {
+      if (requests_per_cq_[request_queue_index].Push(&calls[i]->mpscq_node)) {
+        first = true;
       }
     }
+    // One matching pass for the whole batch.
+    if (first) PublishPending(request_queue_index);
   }
 
   void MatchOrQueue(size_t start_request_queue_index,
@@ -286,6 +281,9 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
     size_t loop_count;
     {
       MutexLock lock(&server_->mu_call_);
+      // Count this call before looking at the queues; see PublishPending.
+      pending_calls_.fetch_add(1, std::memory_order_relaxed);
+      std::atomic_thread_fence(std::memory_order_seq_cst);
       for (loop_count = 0; loop_count < requests_per_cq_.size(); loop_count++) {
         cq_idx =
             (start_request_queue_index + loop_count) % requests_per_cq_.size();
@@ -299,6 +297,7 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
         pending_.push(calld);
         return;
       }
+      pending_calls_.fetch_sub(1, std::memory_order_relaxed);
     }
     GRPC_STATS_INC_SERVER_CQS_CHECKED(loop_count + requests_per_cq_.size());
     calld->SetState(CallData::CallState::ACTIVATED);
@@ -308,8 +307,52 @@ class Server::RealRequestMatcher : public RequestMatcherInterface {
   Server* server() const override { return server_; }
 
  private:
+  // Matches requests newly queued on request_queue_index against pending
+  // calls. Pushing a request and checking pending_calls_ on one side, and
+  // counting a call in pending_calls_ and popping the request queues on the
+  // other, are each separated by a full fence, so either MatchOrQueue finds
+  // the request or this sees the call. The common case of no pending calls
+  // therefore does not take mu_call_.
+  void PublishPending(size_t request_queue_index) {
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (pending_calls_.load(std::memory_order_relaxed) == 0) return;
+    struct PendingCall {
+      RequestedCall* rc = nullptr;
+      CallData* calld;
+    };
+    auto pop_next_pending = [this, request_queue_index] {
+      PendingCall pending_call;
+      {
+        MutexLock lock(&server_->mu_call_);
+        if (!pending_.empty()) {
+          pending_call.rc = reinterpret_cast<RequestedCall*>(
+              requests_per_cq_[request_queue_index].Pop());
+          if (pending_call.rc != nullptr) {
+            pending_call.calld = pending_.front();
+            pending_.pop();
+            pending_calls_.fetch_sub(1, std::memory_order_relaxed);
+          }
+        }
+      }
+      return pending_call;
+    };
+    while (true) {
+      PendingCall next_pending = pop_next_pending();
+      if (next_pending.rc == nullptr) break;
+      if (!next_pending.calld->MaybeActivate()) {
+        // Zombied Call
+        next_pending.calld->KillZombie();
+      } else {
+        next_pending.calld->Publish(request_queue_index, next_pending.rc);
+      }
+    }
+  }
+
   Server* const server_;
   std::queue<CallData*> pending_;
+  // The calls on pending_ plus the MatchOrQueue calls about to look at the
+  // request queues under mu_call_.
+  std::atomic<size_t> pending_calls_{0};
   std::vector<LockedMultiProducerSingleConsumerQueue> requests_per_cq_;
 };
 
@@ -949,6 +992,41 @@ grpc_call_error Server::RequestRegisteredCall(
   return QueueRequestedCall(cq_idx, rc);
 }
 
+grpc_call_error Server::RequestRegisteredCalls(
+    RegisteredMethod* rm, const grpc_server_registered_call_request* requests,
+    size_t count, grpc_completion_queue* cq_bound_to_call,
+    grpc_completion_queue* cq_for_notification) {
+  if (count == 0) return GRPC_CALL_OK;
+  size_t cq_idx;
+  grpc_call_error error =
+      ValidateServerRequestAndCq(&cq_idx, cq_for_notification, requests[0].tag,
+                                 requests[0].optional_payload, rm);
+  if (error != GRPC_CALL_OK) return error;
+  std::vector<RequestedCall*> rcs;
+  rcs.reserve(count);
+  for (size_t i = 0; i < count; i++) {
+    const grpc_server_registered_call_request& request = requests[i];
+    if (i > 0) {
+      error = ValidateServerRequest(cq_for_notification, request.tag,
+                                    request.optional_payload, rm);
+      if (error != GRPC_CALL_OK) break;
+    }
+    rcs.push_back(new RequestedCall(
+        request.tag, cq_bound_to_call, request.call, request.request_metadata,
+        rm, request.deadline, request.optional_payload));
+  }
+  if (ShutdownCalled()) {
+    for (RequestedCall* rc : rcs) {
+      FailCall(cq_idx, rc,
+               GRPC_ERROR_CREATE_FROM_STATIC_STRING("Server Shutdown"));
+    }
+  } else {
+    rm->matcher->RequestCallsWithPossiblePublish(cq_idx, rcs.data(),
+                                                 rcs.size());
+  }
+  return error;
+}
+
 //
 // Server::ChannelData::ConnectivityWatcher
 //
@@ -1122,6 +1200,7 @@ void Server::ChannelData::AcceptStream(void* arg, grpc_transport* /*transport*/,
   args.pollset_set_alternative = nullptr;
   args.server_transport_data = transport_server_data;
   args.send_deadline = GRPC_MILLIS_INF_FUTURE;
+  args.arena_size_estimator = nullptr;
   grpc_call* call;
   grpc_error_handle error = grpc_call_create(&args, &call);
   grpc_call_element* elem =
@@ -1571,6 +1650,29 @@ grpc_call_error grpc_server_request_registered_call(
       cq_for_notification, tag_new);
 }
 
+grpc_call_error grpc_server_request_registered_calls(
+    grpc_server* server, void* registered_method,
+    const grpc_server_registered_call_request* requests, size_t count,
+    grpc_completion_queue* cq_bound_to_call,
+    grpc_completion_queue* cq_for_notification) {
+  grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
+  grpc_core::ExecCtx exec_ctx;
+  for (size_t i = 0; i < count; i++) {
+    GRPC_STATS_INC_SERVER_REQUESTED_CALLS();
+  }
+  auto* rm =
+      static_cast<grpc_core::Server::RegisteredMethod*>(registered_method);
+  GRPC_API_TRACE(
+      "grpc_server_request_registered_calls("
+      "server=%p, registered_method=%p, requests=%p, count=%" PRIuPTR
+      ", cq_bound_to_call=%p, cq_for_notification=%p)",
+      6,
+      (server, registered_method, requests, count, cq_bound_to_call,
+       cq_for_notification));
+  return grpc_core::Server::FromC(server)->RequestRegisteredCalls(
+      rm, requests, count, cq_bound_to_call, cq_for_notification);
+}
+
 void grpc_server_set_config_fetcher(
     grpc_server* server, grpc_server_config_fetcher* server_config_fetcher) {
   grpc_core::ApplicationCallbackExecCtx callback_exec_ctx;
@@ -164,6 +164,11 @@ class Server : public InternallyRefCounted<Server>,
       grpc_completion_queue* cq_bound_to_call,
       grpc_completion_queue* cq_for_notification, void* tag_new);
 
+  grpc_call_error RequestRegisteredCalls(
+      RegisteredMethod* rm, const grpc_server_registered_call_request* requests,
+      size_t count, grpc_completion_queue* cq_bound_to_call,
+      grpc_completion_queue* cq_for_notification);
+
   void ShutdownAndNotify(grpc_completion_queue* cq, void* tag)
       ABSL_LOCKS_EXCLUDED(mu_global_, mu_call_);
 
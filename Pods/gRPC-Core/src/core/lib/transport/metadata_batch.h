@@ -38,6 +38,7 @@
 #include "src/core/lib/gprpp/chunked_vector.h"
 #include "src/core/lib/gprpp/table.h"
 #include "src/core/lib/iomgr/exec_ctx.h"
+#include "src/core/lib/resource_quota/arena.h"
 #include "src/core/lib/slice/slice.h"
 #include "src/core/lib/surface/validate_metadata.h"
 #include "src/core/lib/transport/parsed_metadata.h"
@@ -716,6 +717,8 @@ struct Value<Which, absl::enable_if_t<Which::kRepeatable == false, void>> {
 template <typename Which>
 struct Value<Which, absl::enable_if_t<Which::kRepeatable == true, void>> {
   Value() = default;
+  explicit Value(Arena* arena)
+      : value(ArenaAllocator<typename Which::ValueType>(arena)) {}
   explicit Value(const typename Which::ValueType& value) {
     this->value.push_back(value);
   }
@@ -735,7 +738,7 @@ struct Value<Which, absl::enable_if_t<Which::kRepeatable == true, void>> {
       encoder->Encode(Which(), v);
     }
   }
-  using StorageType = absl::InlinedVector<typename Which::ValueType, 1>;
+  using StorageType = ArenaInlinedVector<typename Which::ValueType, 1>;
   StorageType value;
 };
 
@@ -936,7 +939,12 @@ class MetadataMap {
   template <typename Which, typename... Args>
   absl::enable_if_t<Which::kRepeatable == true, void> Set(Which,
                                                           Args&&... args) {
-    GetOrCreatePointer(Which())->emplace_back(std::forward<Args>(args)...);
+    // Repeated values grow in the call's arena rather than on the heap.
+    auto* p = get_pointer(Which());
+    if (p == nullptr) {
+      p = &table_.template set<Value<Which>>(unknown_.arena())->value;
+    }
+    p->emplace_back(std::forward<Args>(args)...);
   }
 
   // Remove a specific piece of known metadata.
@@ -50,8 +50,14 @@ void grpc_message_size_filter_shutdown(void);
 namespace grpc_core {
 void FaultInjectionFilterInit(void);
 void FaultInjectionFilterShutdown(void);
+void ConcurrencyLimitFilterInit(void);
+void ConcurrencyLimitFilterShutdown(void);
 void GrpcLbPolicyRingHashInit(void);
 void GrpcLbPolicyRingHashShutdown(void);
+void GrpcLbPolicyLeastRequestInit(void);
+void GrpcLbPolicyLeastRequestShutdown(void);
+void GrpcLbPolicyWeightedRoundRobinInit(void);
+void GrpcLbPolicyWeightedRoundRobinShutdown(void);
 #ifndef GRPC_NO_RLS
 void RlsLbPluginInit();
 void RlsLbPluginShutdown();
@@ -116,6 +122,10 @@ void grpc_register_built_in_plugins(void) {
                        grpc_lb_policy_round_robin_shutdown);
   grpc_register_plugin(grpc_core::GrpcLbPolicyRingHashInit,
                        grpc_core::GrpcLbPolicyRingHashShutdown);
+  grpc_register_plugin(grpc_core::GrpcLbPolicyLeastRequestInit,
+                       grpc_core::GrpcLbPolicyLeastRequestShutdown);
+  grpc_register_plugin(grpc_core::GrpcLbPolicyWeightedRoundRobinInit,
+                       grpc_core::GrpcLbPolicyWeightedRoundRobinShutdown);
   grpc_register_plugin(grpc_resolver_dns_ares_init,
                        grpc_resolver_dns_ares_shutdown);
   grpc_register_plugin(grpc_resolver_dns_native_init,
@@ -126,6 +136,8 @@ void grpc_register_built_in_plugins(void) {
                        grpc_message_size_filter_shutdown);
   grpc_register_plugin(grpc_core::FaultInjectionFilterInit,
                        grpc_core::FaultInjectionFilterShutdown);
+  grpc_register_plugin(grpc_core::ConcurrencyLimitFilterInit,
+                       grpc_core::ConcurrencyLimitFilterShutdown);
 #ifndef GRPC_NO_XDS
   // rbac_filter is being guarded with GRPC_NO_XDS to avoid a dependency on the re2 library by default
   grpc_register_plugin(grpc_core::RbacFilterInit, grpc_core::RbacFilterShutdown);
@@ -119,8 +119,10 @@ SslSessionPtr SslSessionLRUCache::Get(const char* key) {
   // Key is only used for lookups.
   Node* node = FindLocked(key);
   if (node == nullptr) {
+    misses_.fetch_add(1, std::memory_order_relaxed);
     return nullptr;
   }
+  hits_.fetch_add(1, std::memory_order_relaxed);
   return node->CopySession();
 }
 
@@ -33,6 +33,8 @@
 #include <sys/socket.h>
 #endif
 
+#include <atomic>
+#include <map>
 #include <string>
 
 #if COCOAPODS==1
@@ -55,6 +57,11 @@
 #else
   #include <openssl/err.h>
 #endif
+#if COCOAPODS==1
+  #include <openssl_grpc/sha.h>
+#else
+  #include <openssl/sha.h>
+#endif
 #if COCOAPODS==1
   #include <openssl_grpc/ssl.h>
 #else
@@ -87,9 +94,12 @@
 #include <grpc/support/thd_id.h>
 
 #include "src/core/lib/gpr/useful.h"
+#include "src/core/lib/gprpp/sync.h"
+#include "src/core/lib/slice/slice_internal.h"
 #include "src/core/tsi/ssl/session_cache/ssl_session_cache.h"
 #include "src/core/tsi/ssl_types.h"
 #include "src/core/tsi/transport_security.h"
+#include "src/core/tsi/transport_security_grpc.h"
 
 /* --- Constants. ---*/
 
@@ -97,6 +107,24 @@
 #define TSI_SSL_MAX_PROTECTED_FRAME_SIZE_LOWER_BOUND 1024
 #define TSI_SSL_HANDSHAKER_OUTGOING_BUFFER_INITIAL_SIZE 1024
 
+/* At most this many verified server certificate chains are remembered. A
+   chain is verified again after TSI_SSL_VERIFIED_CHAIN_TTL_SECONDS, or after
+   TSI_SSL_VERIFIED_CHAIN_CRL_TTL_SECONDS when CRLs are checked so that newly
+   revoked certificates are noticed soon, and never trusted past the expiry of
+   any of its certificates. */
+#define TSI_SSL_VERIFIED_CHAIN_CACHE_SIZE 1024
+#define TSI_SSL_VERIFIED_CHAIN_TTL_SECONDS 3600
+#define TSI_SSL_VERIFIED_CHAIN_CRL_TTL_SECONDS 300
+
+/* Records carry at most this many bytes until TSI_SSL_SLOW_START_BYTES have
+   been sent since the connection was created or last went idle, so that each
+   of them fits in one TCP segment while the congestion window is small and
+   the peer can decrypt it as soon as it arrives. Records then grow to the
+   full frame size, which costs fewer AEAD calls and headers per byte. */
+#define TSI_SSL_SLOW_START_RECORD_SIZE 1300
+#define TSI_SSL_SLOW_START_BYTES (64 * 1024)
+#define TSI_SSL_RECORD_SIZE_IDLE_RESET_MS 1000
+
 /* Putting a macro like this and littering the source file with #if is really
    bad practice.
    TODO(jboeuf): refactor all the #if / #endif in a separate module. */
@@ -107,6 +135,16 @@
 /* TODO(jboeuf): I have not found a way to get this number dynamically from the
    SSL structure. This is what we would ultimately want though... */
 #define TSI_SSL_MAX_PROTECTION_OVERHEAD 100
+/* TLS 1.3 connections update their keys after this many records in either
+   direction, well within the AES-GCM limit of RFC 8446, section 5.5. */
+#define TSI_SSL_KEY_UPDATE_RECORDS (1 << 23)
+/* Protectors add their counters to the process-wide stats every this many
+   records. */
+#define TSI_SSL_STATS_FLUSH_RECORDS 64
+/* Unprotect of the zero-copy protector decrypts into slices of this size. */
+#define TSI_SSL_ZERO_COPY_READ_SLICE_SIZE 16384
+/* Leftovers of a read slice smaller than this are not reused. */
+#define TSI_SSL_ZERO_COPY_MIN_READ_SIZE 1024
 
 /* --- Structure definitions. ---*/
 
@@ -125,6 +163,10 @@ struct tsi_ssl_client_handshaker_factory {
   unsigned char* alpn_protocol_list;
   size_t alpn_protocol_list_length;
   grpc_core::RefCountedPtr<tsi::SslSessionLRUCache> session_cache;
+  /* Digest of the roots and CRL settings that server chains are verified
+     against, and how long a verified chain may be reused. */
+  unsigned char verified_chain_config_digest[SHA256_DIGEST_LENGTH];
+  int64_t verified_chain_ttl_seconds;
 };
 
 struct tsi_ssl_server_handshaker_factory {
@@ -155,18 +197,54 @@ struct tsi_ssl_handshaker_result {
   unsigned char* unused_bytes;
   size_t unused_bytes_size;
 };
+/* State of the BIO that the SSL object of a frame protector reads ciphertext
+   from and writes ciphertext to, in place of the BIO pair of the handshake.
+   SSL_read takes ciphertext straight from the caller's bytes in unprotect and
+   SSL_write puts it straight into the caller's output in protect, instead of
+   both going through the buffer of the pair. Ciphertext that does not fit in
+   the output, or that SSL writes outside of protect (alerts, key updates),
+   waits in |pending|. */
+struct tsi_ssl_window {
+  const unsigned char* in = nullptr;
+  size_t in_size = 0;
+  size_t in_offset = 0;
+  unsigned char* out = nullptr;
+  size_t out_size = 0;
+  size_t out_offset = 0;
+  std::string pending;
+  size_t pending_offset = 0;
+};
+
 struct tsi_ssl_frame_protector {
   tsi_frame_protector base;
   SSL* ssl;
+  /* Exactly one of these carries the ciphertext of ssl. */
   BIO* network_io;
+  tsi_ssl_window* window;
   unsigned char* buffer;
   size_t buffer_size;
   size_t buffer_offset;
+  /* Size of the record being filled, up to buffer_size. */
+  size_t record_size;
+  /* Bytes sent in records since the last idle period. */
+  size_t bytes_since_idle;
+  gpr_timespec last_record_time;
+  /* Whether a KeyUpdate asking the peer to update its keys as well was sent
+     after the peer's records reached TSI_SSL_KEY_UPDATE_RECORDS. */
+  bool peer_key_update_requested;
+  /* Counters of this connection, and the part of them already added to the
+     process-wide stats. */
+  tsi_ssl_protection_stats stats;
+  tsi_ssl_protection_stats flushed_stats;
 };
 /* --- Library Initialization. ---*/
 
 static gpr_once g_init_openssl_once = GPR_ONCE_INIT;
 static int g_ssl_ctx_ex_factory_index = -1;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+static BIO_METHOD* g_window_bio_method = nullptr;
+static void init_window_bio_method(void);
+#endif
 static const unsigned char kSslSessionIdContext[] = {'g', 'r', 'p', 'c'};
 #if !defined(OPENSSL_IS_BORINGSSL) && !defined(OPENSSL_NO_ENGINE)
 static const char kSslEnginePrefix[] = "engine:";
@@ -217,6 +295,9 @@ static void init_openssl(void) {
   g_ssl_ctx_ex_factory_index =
       SSL_CTX_get_ex_new_index(0, nullptr, nullptr, nullptr, nullptr);
   GPR_ASSERT(g_ssl_ctx_ex_factory_index != -1);
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+  init_window_bio_method();
+#endif
 }
 
 /* --- Ssl utils. ---*/
@@ -560,6 +641,25 @@ static void log_ssl_error_stack(void) {
 }
 
 /* Performs an SSL_read and handle errors. */
+static int server_handshaker_factory_new_session_callback(
+    SSL* ssl, SSL_SESSION* session);
+
+#if defined(OPENSSL_IS_BORINGSSL)
+/* Replaces the session that ssl offered with early data, which the server
+   rejected, by a copy that won't offer it again, so that the next connection
+   resumes it with a regular 1-RTT handshake instead of failing the same way. */
+static void tsi_ssl_forget_early_data(SSL* ssl) {
+  SSL_SESSION* session = SSL_get_session(ssl);
+  if (session == nullptr) return;
+  gpr_log(GPR_INFO,
+          "Server rejected TLS early data; resuming without it from now on.");
+  SSL_SESSION* copy = SSL_SESSION_copy_without_early_data(session);
+  if (!server_handshaker_factory_new_session_callback(ssl, copy)) {
+    SSL_SESSION_free(copy);
+  }
+}
+#endif
+
 static tsi_result do_ssl_read(SSL* ssl, unsigned char* unprotected_bytes,
                               size_t* unprotected_bytes_size) {
   GPR_ASSERT(*unprotected_bytes_size <= INT_MAX);
@@ -582,6 +682,13 @@ static tsi_result do_ssl_read(SSL* ssl, unsigned char* unprotected_bytes,
         gpr_log(GPR_ERROR, "Corruption detected.");
         log_ssl_error_stack();
         return TSI_DATA_CORRUPTED;
+#if defined(OPENSSL_IS_BORINGSSL)
+      case SSL_ERROR_EARLY_DATA_REJECTED:
+        /* The early data can't be sent again on this connection: the
+           application will see it fail and retry on a new one. */
+        tsi_ssl_forget_early_data(ssl);
+        return TSI_PROTOCOL_FAILURE;
+#endif
       default:
         gpr_log(GPR_ERROR, "SSL_read failed with error %s.",
                 ssl_error_string(read_from_ssl));
@@ -593,7 +700,8 @@ static tsi_result do_ssl_read(SSL* ssl, unsigned char* unprotected_bytes,
 }
 
 /* Performs an SSL_write and handle errors. */
-static tsi_result do_ssl_write(SSL* ssl, unsigned char* unprotected_bytes,
+static tsi_result do_ssl_write(SSL* ssl,
+                               const unsigned char* unprotected_bytes,
                                size_t unprotected_bytes_size) {
   GPR_ASSERT(unprotected_bytes_size <= INT_MAX);
   ERR_clear_error();
@@ -605,6 +713,11 @@ static tsi_result do_ssl_write(SSL* ssl, unsigned char* unprotected_bytes,
       gpr_log(GPR_ERROR,
               "Peer tried to renegotiate SSL connection. This is unsupported.");
       return TSI_UNIMPLEMENTED;
+#if defined(OPENSSL_IS_BORINGSSL)
+    } else if (ssl_write_result == SSL_ERROR_EARLY_DATA_REJECTED) {
+      tsi_ssl_forget_early_data(ssl);
+      return TSI_PROTOCOL_FAILURE;
+#endif
     } else {
       gpr_log(GPR_ERROR, "SSL_write failed with error %s.",
               ssl_error_string(ssl_write_result));
@@ -967,6 +1080,128 @@ static int NullVerifyCallback(int /*preverify_ok*/, X509_STORE_CTX* /*ctx*/) {
   return 1;
 }
 
+/* --- Verified certificate chain cache. --- */
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+
+namespace {
+
+// Process-wide set of server certificate chains that recently passed
+// X509_verify_cert(), so that handshakes with the same fleet of servers skip
+// chain building and signature checks. Entries are keyed by a digest of the
+// presented chain and of the verification config of the client factory, and
+// hold the time (in seconds since the epoch) until which they can be trusted.
+class VerifiedChainCache {
+ public:
+  static VerifiedChainCache* Get() {
+    static VerifiedChainCache* cache = new VerifiedChainCache();
+    return cache;
+  }
+
+  bool Contains(const std::string& key, int64_t now) {
+    grpc_core::MutexLock lock(&mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    if (it->second <= now) {
+      entries_.erase(it);
+      return false;
+    }
+    return true;
+  }
+
+  void Add(std::string key, int64_t expiry) {
+    grpc_core::MutexLock lock(&mu_);
+    if (entries_.size() >= TSI_SSL_VERIFIED_CHAIN_CACHE_SIZE &&
+        entries_.find(key) == entries_.end()) {
+      // Make room by dropping the entry that expires first.
+      auto first_to_expire = entries_.begin();
+      for (auto it = entries_.begin(); it != entries_.end(); ++it) {
+        if (it->second < first_to_expire->second) first_to_expire = it;
+      }
+      entries_.erase(first_to_expire);
+    }
+    entries_[std::move(key)] = expiry;
+  }
+
+ private:
+  grpc_core::Mutex mu_;
+  std::map<std::string, int64_t> entries_ ABSL_GUARDED_BY(mu_);
+};
+
+bool AddCertDigest(SHA256_CTX* sha, X509* cert) {
+  unsigned char md[EVP_MAX_MD_SIZE];
+  unsigned int md_len = 0;
+  if (!X509_digest(cert, EVP_sha256(), md, &md_len)) return false;
+  SHA256_Update(sha, md, md_len);
+  return true;
+}
+
+// Computes the cache key of the chain presented in |ctx|.
+bool VerifiedChainCacheKey(const tsi_ssl_client_handshaker_factory* factory,
+                           X509_STORE_CTX* ctx, std::string* key) {
+  SHA256_CTX sha;
+  SHA256_Init(&sha);
+  SHA256_Update(&sha, factory->verified_chain_config_digest,
+                SHA256_DIGEST_LENGTH);
+  X509* leaf = X509_STORE_CTX_get0_cert(ctx);
+  if (leaf == nullptr || !AddCertDigest(&sha, leaf)) return false;
+  STACK_OF(X509)* untrusted = X509_STORE_CTX_get0_untrusted(ctx);
+  if (untrusted != nullptr) {
+    for (size_t i = 0; i < sk_X509_num(untrusted); ++i) {
+      if (!AddCertDigest(&sha, sk_X509_value(untrusted, i))) return false;
+    }
+  }
+  unsigned char digest[SHA256_DIGEST_LENGTH];
+  SHA256_Final(digest, &sha);
+  key->assign(reinterpret_cast<const char*>(digest), sizeof(digest));
+  return true;
+}
+
+// Returns the earliest expiry of the certificates in the verified chain of
+// |ctx|, in seconds since the epoch, or |limit| if that comes first.
+int64_t VerifiedChainExpiry(X509_STORE_CTX* ctx, int64_t now, int64_t limit) {
+  STACK_OF(X509)* chain = X509_STORE_CTX_get0_chain(ctx);
+  if (chain == nullptr) return now;
+  int64_t expiry = limit;
+  for (size_t i = 0; i < sk_X509_num(chain); ++i) {
+    int days = 0;
+    int seconds = 0;
+    if (!ASN1_TIME_diff(&days, &seconds, nullptr,
+                        X509_get0_notAfter(sk_X509_value(chain, i)))) {
+      return now;
+    }
+    int64_t not_after = now + static_cast<int64_t>(days) * 86400 + seconds;
+    if (not_after < expiry) expiry = not_after;
+  }
+  return expiry;
+}
+
+}  // namespace
+
+// Verifies the server chain with X509_verify_cert(), unless the same chain was
+// verified against the same config recently.
+static int verified_chain_cache_verify_callback(X509_STORE_CTX* ctx,
+                                                void* arg) {
+  const tsi_ssl_client_handshaker_factory* factory =
+      static_cast<const tsi_ssl_client_handshaker_factory*>(arg);
+  int64_t now = gpr_now(GPR_CLOCK_REALTIME).tv_sec;
+  std::string key;
+  bool cacheable = VerifiedChainCacheKey(factory, ctx, &key);
+  if (cacheable && VerifiedChainCache::Get()->Contains(key, now)) {
+    X509_STORE_CTX_set_error(ctx, X509_V_OK);
+    return 1;
+  }
+  int result = X509_verify_cert(ctx);
+  if (result > 0 && cacheable) {
+    int64_t expiry = VerifiedChainExpiry(
+        ctx, now, now + factory->verified_chain_ttl_seconds);
+    if (expiry > now) VerifiedChainCache::Get()->Add(std::move(key), expiry);
+  }
+  return result;
+}
+
+#endif /* OPENSSL_VERSION_NUMBER >= 0x10100000 */
+
 // Sets the min and max TLS version of |ssl_context| to |min_tls_version| and
 // |max_tls_version|, respectively. Calling this method is a no-op when using
 // OpenSSL versions < 1.1.
@@ -1076,8 +1311,295 @@ void tsi_ssl_session_cache_unref(tsi_ssl_session_cache* cache) {
   reinterpret_cast<tsi::SslSessionLRUCache*>(cache)->Unref();
 }
 
+void tsi_ssl_session_cache_get_stats(tsi_ssl_session_cache* cache,
+                                     uint64_t* hits, uint64_t* misses) {
+  reinterpret_cast<tsi::SslSessionLRUCache*>(cache)->GetStats(hits, misses);
+}
+
+/* --- Window BIO implementation. ---*/
+
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+
+static int window_bio_write(BIO* bio, const char* data, int len) {
+  tsi_ssl_window* window = static_cast<tsi_ssl_window*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  if (len <= 0) return 0;
+  size_t size = static_cast<size_t>(len);
+  size_t direct = 0;
+  /* Only write to the output while nothing is pending, to keep the order. */
+  if (window->out != nullptr &&
+      window->pending_offset == window->pending.size()) {
+    direct = window->out_size - window->out_offset;
+    if (direct > size) direct = size;
+    memcpy(window->out + window->out_offset, data, direct);
+    window->out_offset += direct;
+  }
+  window->pending.append(data + direct, size - direct);
+  return len;
+}
+
+static int window_bio_read(BIO* bio, char* data, int len) {
+  tsi_ssl_window* window = static_cast<tsi_ssl_window*>(BIO_get_data(bio));
+  BIO_clear_retry_flags(bio);
+  size_t available = window->in_size - window->in_offset;
+  if (available == 0) {
+    BIO_set_retry_read(bio);
+    return -1;
+  }
+  if (len <= 0) return 0;
+  size_t size = static_cast<size_t>(len);
+  if (size > available) size = available;
+  memcpy(data, window->in + window->in_offset, size);
+  window->in_offset += size;
+  return static_cast<int>(size);
+}
+
+static long window_bio_ctrl(BIO* bio, int cmd, long /*larg*/, void* /*parg*/) {
+  tsi_ssl_window* window = static_cast<tsi_ssl_window*>(BIO_get_data(bio));
+  switch (cmd) {
+    case BIO_CTRL_PENDING:
+      return static_cast<long>(window->in_size - window->in_offset);
+    case BIO_CTRL_WPENDING:
+      return static_cast<long>(window->pending.size() -
+                               window->pending_offset);
+    case BIO_CTRL_FLUSH:
+      return 1;
+    default:
+      return 0;
+  }
+}
+
+static void init_window_bio_method(void) {
+  g_window_bio_method =
+      BIO_meth_new(BIO_get_new_index() | BIO_TYPE_SOURCE_SINK, "grpc window");
+  GPR_ASSERT(g_window_bio_method != nullptr);
+  BIO_meth_set_write(g_window_bio_method, window_bio_write);
+  BIO_meth_set_read(g_window_bio_method, window_bio_read);
+  BIO_meth_set_ctrl(g_window_bio_method, window_bio_ctrl);
+}
+
+/* Moves the ciphertext of ssl from the handshake's BIO pair to a window BIO,
+   unless the pair still holds ciphertext, in which case it stays in use. On
+   success, takes ownership of network_io. */
+static tsi_ssl_window* ssl_set_window_bio(SSL* ssl, BIO* network_io) {
+  if (BIO_pending(network_io) != 0 || BIO_pending(SSL_get_rbio(ssl)) != 0) {
+    return nullptr;
+  }
+  BIO* bio = BIO_new(g_window_bio_method);
+  if (bio == nullptr) return nullptr;
+  tsi_ssl_window* window = new tsi_ssl_window();
+  BIO_set_data(bio, window);
+  BIO_set_init(bio, 1);
+  SSL_set_bio(ssl, bio, bio);
+  BIO_free(network_io);
+  return window;
+}
+
+#endif /* OPENSSL_VERSION_NUMBER >= 0x10100000 */
+
+/* --- tsi_frame_protector methods implementation. ---*/
+
+/* Returns how much ciphertext is waiting to be output. */
+static size_t ssl_protector_pending(tsi_ssl_frame_protector* impl) {
+  if (impl->window != nullptr) {
+    return impl->window->pending.size() - impl->window->pending_offset;
+  }
+  int pending = static_cast<int>(BIO_pending(impl->network_io));
+  GPR_ASSERT(pending >= 0);
+  return static_cast<size_t>(pending);
+}
+
+/* Moves up to size bytes of waiting ciphertext to out. Returns how many, or a
+   negative value on error. */
+static int ssl_protector_read_pending(tsi_ssl_frame_protector* impl,
+                                      unsigned char* out, size_t size) {
+  GPR_ASSERT(size <= INT_MAX);
+  if (impl->window == nullptr) {
+    return BIO_read(impl->network_io, out, static_cast<int>(size));
+  }
+  tsi_ssl_window* window = impl->window;
+  size_t available = window->pending.size() - window->pending_offset;
+  if (size > available) size = available;
+  memcpy(out, window->pending.data() + window->pending_offset, size);
+  window->pending_offset += size;
+  if (window->pending_offset == window->pending.size()) {
+    window->pending.clear();
+    window->pending_offset = 0;
+  }
+  return static_cast<int>(size);
+}
+
+/* --- tsi_ssl_protection_stats methods implementation. ---*/
+
+namespace {
+
+struct ProtectionStats {
+  std::atomic<uint64_t> connections{0};
+  std::atomic<uint64_t> records_protected{0};
+  std::atomic<uint64_t> records_unprotected{0};
+  std::atomic<uint64_t> bytes_protected{0};
+  std::atomic<uint64_t> bytes_unprotected{0};
+  std::atomic<uint64_t> protect_ns{0};
+  std::atomic<uint64_t> unprotect_ns{0};
+  std::atomic<uint64_t> key_updates{0};
+};
+
+ProtectionStats* GetProtectionStats() {
+  static ProtectionStats* stats = new ProtectionStats();
+  return stats;
+}
+
+uint64_t NanosBetween(gpr_timespec start, gpr_timespec end) {
+  gpr_timespec elapsed = gpr_time_sub(end, start);
+  return static_cast<uint64_t>(elapsed.tv_sec) * GPR_NS_PER_SEC +
+         static_cast<uint64_t>(elapsed.tv_nsec);
+}
+
+}  // namespace
+
+void tsi_ssl_get_protection_stats(tsi_ssl_protection_stats* stats) {
+  ProtectionStats* totals = GetProtectionStats();
+  stats->connections = totals->connections.load(std::memory_order_relaxed);
+  stats->records_protected =
+      totals->records_protected.load(std::memory_order_relaxed);
+  stats->records_unprotected =
+      totals->records_unprotected.load(std::memory_order_relaxed);
+  stats->bytes_protected =
+      totals->bytes_protected.load(std::memory_order_relaxed);
+  stats->bytes_unprotected =
+      totals->bytes_unprotected.load(std::memory_order_relaxed);
+  stats->protect_ns = totals->protect_ns.load(std::memory_order_relaxed);
+  stats->unprotect_ns = totals->unprotect_ns.load(std::memory_order_relaxed);
+  stats->key_updates = totals->key_updates.load(std::memory_order_relaxed);
+}
+
+/* Adds the counters of impl that are not in the process-wide stats yet. With
+   force unset, only does so once enough records have accumulated. */
+static void ssl_protector_flush_stats(tsi_ssl_frame_protector* impl,
+                                      bool force) {
+  tsi_ssl_protection_stats* stats = &impl->stats;
+  tsi_ssl_protection_stats* flushed = &impl->flushed_stats;
+  if (!force &&
+      stats->records_protected + stats->records_unprotected <
+          flushed->records_protected + flushed->records_unprotected +
+              TSI_SSL_STATS_FLUSH_RECORDS) {
+    return;
+  }
+  ProtectionStats* totals = GetProtectionStats();
+  totals->records_protected.fetch_add(
+      stats->records_protected - flushed->records_protected,
+      std::memory_order_relaxed);
+  totals->records_unprotected.fetch_add(
+      stats->records_unprotected - flushed->records_unprotected,
+      std::memory_order_relaxed);
+  totals->bytes_protected.fetch_add(
+      stats->bytes_protected - flushed->bytes_protected,
+      std::memory_order_relaxed);
+  totals->bytes_unprotected.fetch_add(
+      stats->bytes_unprotected - flushed->bytes_unprotected,
+      std::memory_order_relaxed);
+  totals->protect_ns.fetch_add(stats->protect_ns - flushed->protect_ns,
+                               std::memory_order_relaxed);
+  totals->unprotect_ns.fetch_add(stats->unprotect_ns - flushed->unprotect_ns,
+                                 std::memory_order_relaxed);
+  totals->key_updates.fetch_add(stats->key_updates - flushed->key_updates,
+                                std::memory_order_relaxed);
+  *flushed = *stats;
+}
+
 /* --- tsi_frame_protector methods implementation. ---*/
 
+/* Schedules a TLS 1.3 KeyUpdate, sent with the next record, once either
+   direction of the connection has used its keys for
+   TSI_SSL_KEY_UPDATE_RECORDS records. Sending one resets our write sequence
+   right away; the read sequence resets when the peer answers our request. */
+static void ssl_protector_maybe_update_keys(tsi_ssl_frame_protector* impl) {
+#if defined(OPENSSL_IS_BORINGSSL)
+  if (SSL_version(impl->ssl) != TLS1_3_VERSION) return;
+  bool read_limit =
+      SSL_get_read_sequence(impl->ssl) >= TSI_SSL_KEY_UPDATE_RECORDS;
+  if (!read_limit) impl->peer_key_update_requested = false;
+  bool request_peer = read_limit && !impl->peer_key_update_requested;
+  if (!request_peer &&
+      SSL_get_write_sequence(impl->ssl) < TSI_SSL_KEY_UPDATE_RECORDS) {
+    return;
+  }
+  if (!SSL_key_update(impl->ssl, request_peer ? SSL_KEY_UPDATE_REQUESTED
+                                              : SSL_KEY_UPDATE_NOT_REQUESTED)) {
+    ERR_clear_error();
+    return;
+  }
+  if (request_peer) impl->peer_key_update_requested = true;
+  impl->stats.key_updates++;
+  if (GRPC_TRACE_FLAG_ENABLED(tsi_tracing_enabled)) {
+    gpr_log(GPR_INFO,
+            "SSL protector %p updating its keys after %" PRIu64
+            " records protected and %" PRIu64 " unprotected",
+            impl, impl->stats.records_protected,
+            impl->stats.records_unprotected);
+  }
+#else
+  (void)impl;
+#endif
+}
+
+/* Picks the size of the next record, when none is being filled. */
+static void ssl_protector_start_record(tsi_ssl_frame_protector* impl) {
+  gpr_timespec now = gpr_now(GPR_CLOCK_MONOTONIC);
+  if (gpr_time_cmp(gpr_time_sub(now, impl->last_record_time),
+                   gpr_time_from_millis(TSI_SSL_RECORD_SIZE_IDLE_RESET_MS,
+                                        GPR_TIMESPAN)) > 0) {
+    impl->bytes_since_idle = 0;
+  }
+  impl->record_size = impl->buffer_size;
+  if (impl->bytes_since_idle < TSI_SSL_SLOW_START_BYTES &&
+      impl->record_size > TSI_SSL_SLOW_START_RECORD_SIZE) {
+    impl->record_size = TSI_SSL_SLOW_START_RECORD_SIZE;
+  }
+}
+
+/* Encrypts a record of size bytes. Its ciphertext goes to out, up to
+   *out_size bytes, and the rest waits to be output. *out_size is set to the
+   bytes written to out. */
+static tsi_result ssl_protector_write_record(tsi_ssl_frame_protector* impl,
+                                             const unsigned char* bytes,
+                                             size_t size, unsigned char* out,
+                                             size_t* out_size) {
+  tsi_result result;
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+  ssl_protector_maybe_update_keys(impl);
+  if (impl->window != nullptr) {
+    tsi_ssl_window* window = impl->window;
+    window->out = out;
+    window->out_size = *out_size;
+    window->out_offset = 0;
+    result = do_ssl_write(impl->ssl, bytes, size);
+    *out_size = window->out_offset;
+    window->out = nullptr;
+    window->out_size = 0;
+    window->out_offset = 0;
+  } else {
+    result = do_ssl_write(impl->ssl, bytes, size);
+    if (result == TSI_OK) {
+      int read_from_ssl = ssl_protector_read_pending(impl, out, *out_size);
+      if (read_from_ssl < 0) {
+        gpr_log(GPR_ERROR, "Could not read from BIO after SSL_write.");
+        return TSI_INTERNAL_ERROR;
+      }
+      *out_size = static_cast<size_t>(read_from_ssl);
+    }
+  }
+  if (result != TSI_OK) return result;
+  impl->buffer_offset = 0;
+  impl->bytes_since_idle += size;
+  impl->last_record_time = gpr_now(GPR_CLOCK_MONOTONIC);
+  impl->stats.records_protected++;
+  impl->stats.bytes_protected += size;
+  impl->stats.protect_ns += NanosBetween(start, impl->last_record_time);
+  ssl_protector_flush_stats(impl, /*force=*/false);
+  return TSI_OK;
+}
+
 static tsi_result ssl_protector_protect(tsi_frame_protector* self,
                                         const unsigned char* unprotected_bytes,
                                         size_t* unprotected_bytes_size,
@@ -1090,12 +1612,10 @@ static tsi_result ssl_protector_protect(tsi_frame_protector* self,
   tsi_result result = TSI_OK;
 
   /* First see if we have some pending data in the SSL BIO. */
-  int pending_in_ssl = static_cast<int>(BIO_pending(impl->network_io));
-  if (pending_in_ssl > 0) {
+  if (ssl_protector_pending(impl) > 0) {
     *unprotected_bytes_size = 0;
-    GPR_ASSERT(*protected_output_frames_size <= INT_MAX);
-    read_from_ssl = BIO_read(impl->network_io, protected_output_frames,
-                             static_cast<int>(*protected_output_frames_size));
+    read_from_ssl = ssl_protector_read_pending(
+        impl, protected_output_frames, *protected_output_frames_size);
     if (read_from_ssl < 0) {
       gpr_log(GPR_ERROR,
               "Could not read from BIO even though some data is pending");
@@ -1106,7 +1626,8 @@ static tsi_result ssl_protector_protect(tsi_frame_protector* self,
   }
 
   /* Now see if we can send a complete frame. */
-  available = impl->buffer_size - impl->buffer_offset;
+  if (impl->buffer_offset == 0) ssl_protector_start_record(impl);
+  available = impl->record_size - impl->buffer_offset;
   if (available > *unprotected_bytes_size) {
     /* If we cannot, just copy the data in our internal buffer. */
     memcpy(impl->buffer + impl->buffer_offset, unprotected_bytes,
@@ -1116,21 +1637,21 @@ static tsi_result ssl_protector_protect(tsi_frame_protector* self,
     return TSI_OK;
   }
 
-  /* If we can, prepare the buffer, send it to SSL_write and read. */
-  memcpy(impl->buffer + impl->buffer_offset, unprotected_bytes, available);
-  result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_size);
-  if (result != TSI_OK) return result;
-
-  GPR_ASSERT(*protected_output_frames_size <= INT_MAX);
-  read_from_ssl = BIO_read(impl->network_io, protected_output_frames,
-                           static_cast<int>(*protected_output_frames_size));
-  if (read_from_ssl < 0) {
-    gpr_log(GPR_ERROR, "Could not read from BIO after SSL_write.");
-    return TSI_INTERNAL_ERROR;
+  /* If we can, prepare the buffer, send it to SSL_write and read. A record
+     that lies entirely in the caller's bytes is encrypted from there, without
+     copying it to our buffer first. */
+  if (impl->buffer_offset == 0) {
+    result = ssl_protector_write_record(impl, unprotected_bytes, available,
+                                        protected_output_frames,
+                                        protected_output_frames_size);
+  } else {
+    memcpy(impl->buffer + impl->buffer_offset, unprotected_bytes, available);
+    result = ssl_protector_write_record(impl, impl->buffer, impl->record_size,
+                                        protected_output_frames,
+                                        protected_output_frames_size);
   }
-  *protected_output_frames_size = static_cast<size_t>(read_from_ssl);
+  if (result != TSI_OK) return result;
   *unprotected_bytes_size = available;
-  impl->buffer_offset = 0;
   return TSI_OK;
 }
 
@@ -1140,44 +1661,44 @@ static tsi_result ssl_protector_protect_flush(
   tsi_result result = TSI_OK;
   tsi_ssl_frame_protector* impl =
       reinterpret_cast<tsi_ssl_frame_protector*>(self);
-  int read_from_ssl = 0;
-  int pending;
+  size_t written = 0;
 
   if (impl->buffer_offset != 0) {
-    result = do_ssl_write(impl->ssl, impl->buffer, impl->buffer_offset);
+    written = *protected_output_frames_size;
+    result = ssl_protector_write_record(impl, impl->buffer, impl->buffer_offset,
+                                        protected_output_frames, &written);
     if (result != TSI_OK) return result;
-    impl->buffer_offset = 0;
   }
 
-  pending = static_cast<int>(BIO_pending(impl->network_io));
-  GPR_ASSERT(pending >= 0);
-  *still_pending_size = static_cast<size_t>(pending);
-  if (*still_pending_size == 0) return TSI_OK;
+  *still_pending_size = ssl_protector_pending(impl);
+  if (*still_pending_size == 0) {
+    *protected_output_frames_size = written;
+    return TSI_OK;
+  }
 
-  GPR_ASSERT(*protected_output_frames_size <= INT_MAX);
-  read_from_ssl = BIO_read(impl->network_io, protected_output_frames,
-                           static_cast<int>(*protected_output_frames_size));
-  if (read_from_ssl <= 0) {
-    gpr_log(GPR_ERROR, "Could not read from BIO after SSL_write.");
-    return TSI_INTERNAL_ERROR;
+  if (written < *protected_output_frames_size) {
+    int read_from_ssl = ssl_protector_read_pending(
+        impl, protected_output_frames + written,
+        *protected_output_frames_size - written);
+    if (read_from_ssl <= 0) {
+      gpr_log(GPR_ERROR, "Could not read from BIO after SSL_write.");
+      return TSI_INTERNAL_ERROR;
+    }
+    written += static_cast<size_t>(read_from_ssl);
   }
-  *protected_output_frames_size = static_cast<size_t>(read_from_ssl);
-  pending = static_cast<int>(BIO_pending(impl->network_io));
-  GPR_ASSERT(pending >= 0);
-  *still_pending_size = static_cast<size_t>(pending);
+  *protected_output_frames_size = written;
+  *still_pending_size = ssl_protector_pending(impl);
   return TSI_OK;
 }
 
-static tsi_result ssl_protector_unprotect(
-    tsi_frame_protector* self, const unsigned char* protected_frames_bytes,
+static tsi_result ssl_protector_unprotect_records(
+    tsi_ssl_frame_protector* impl, const unsigned char* protected_frames_bytes,
     size_t* protected_frames_bytes_size, unsigned char* unprotected_bytes,
     size_t* unprotected_bytes_size) {
   tsi_result result = TSI_OK;
   int written_into_ssl = 0;
   size_t output_bytes_size = *unprotected_bytes_size;
   size_t output_bytes_offset = 0;
-  tsi_ssl_frame_protector* impl =
-      reinterpret_cast<tsi_ssl_frame_protector*>(self);
 
   /* First, try to read remaining data from ssl. */
   result = do_ssl_read(impl->ssl, unprotected_bytes, unprotected_bytes_size);
@@ -1191,19 +1712,37 @@ static tsi_result ssl_protector_unprotect(
   unprotected_bytes += output_bytes_offset;
   *unprotected_bytes_size = output_bytes_size - output_bytes_offset;
 
-  /* Then, try to write some data to ssl. */
-  GPR_ASSERT(*protected_frames_bytes_size <= INT_MAX);
-  written_into_ssl = BIO_write(impl->network_io, protected_frames_bytes,
-                               static_cast<int>(*protected_frames_bytes_size));
-  if (written_into_ssl < 0) {
-    gpr_log(GPR_ERROR, "Sending protected frame to ssl failed with %d",
-            written_into_ssl);
-    return TSI_INTERNAL_ERROR;
-  }
-  *protected_frames_bytes_size = static_cast<size_t>(written_into_ssl);
+  if (impl->window != nullptr) {
+    /* Let ssl read straight from the caller's bytes. Once it produces no
+       more plaintext, it has either buffered all of them waiting for the rest
+       of a record or been closed by the peer, so they all count as used. */
+    tsi_ssl_window* window = impl->window;
+    window->in = protected_frames_bytes;
+    window->in_size = *protected_frames_bytes_size;
+    window->in_offset = 0;
+    result = do_ssl_read(impl->ssl, unprotected_bytes, unprotected_bytes_size);
+    if (*unprotected_bytes_size > 0) {
+      *protected_frames_bytes_size = window->in_offset;
+    }
+    window->in = nullptr;
+    window->in_size = 0;
+    window->in_offset = 0;
+  } else {
+    /* Then, try to write some data to ssl. */
+    GPR_ASSERT(*protected_frames_bytes_size <= INT_MAX);
+    written_into_ssl =
+        BIO_write(impl->network_io, protected_frames_bytes,
+                  static_cast<int>(*protected_frames_bytes_size));
+    if (written_into_ssl < 0) {
+      gpr_log(GPR_ERROR, "Sending protected frame to ssl failed with %d",
+              written_into_ssl);
+      return TSI_INTERNAL_ERROR;
+    }
+    *protected_frames_bytes_size = static_cast<size_t>(written_into_ssl);
 
-  /* Now try to read some data again. */
-  result = do_ssl_read(impl->ssl, unprotected_bytes, unprotected_bytes_size);
+    /* Now try to read some data again. */
+    result = do_ssl_read(impl->ssl, unprotected_bytes, unprotected_bytes_size);
+  }
   if (result == TSI_OK) {
     /* Don't forget to output the total number of bytes read. */
     *unprotected_bytes_size += output_bytes_offset;
@@ -1211,12 +1750,54 @@ static tsi_result ssl_protector_unprotect(
   return result;
 }
 
+static tsi_result ssl_protector_unprotect(
+    tsi_frame_protector* self, const unsigned char* protected_frames_bytes,
+    size_t* protected_frames_bytes_size, unsigned char* unprotected_bytes,
+    size_t* unprotected_bytes_size) {
+  tsi_ssl_frame_protector* impl =
+      reinterpret_cast<tsi_ssl_frame_protector*>(self);
+  gpr_timespec start = gpr_now(GPR_CLOCK_MONOTONIC);
+#if defined(OPENSSL_IS_BORINGSSL)
+  uint64_t read_sequence = SSL_get_read_sequence(impl->ssl);
+#endif
+  tsi_result result = ssl_protector_unprotect_records(
+      impl, protected_frames_bytes, protected_frames_bytes_size,
+      unprotected_bytes, unprotected_bytes_size);
+  if (result != TSI_OK) return result;
+#if defined(OPENSSL_IS_BORINGSSL)
+  /* The read sequence restarts from 0 when the peer updates its keys. */
+  uint64_t new_read_sequence = SSL_get_read_sequence(impl->ssl);
+  impl->stats.records_unprotected += new_read_sequence >= read_sequence
+                                         ? new_read_sequence - read_sequence
+                                         : new_read_sequence;
+#else
+  if (*unprotected_bytes_size > 0) impl->stats.records_unprotected++;
+#endif
+  impl->stats.bytes_unprotected += *unprotected_bytes_size;
+  impl->stats.unprotect_ns +=
+      NanosBetween(start, gpr_now(GPR_CLOCK_MONOTONIC));
+  ssl_protector_flush_stats(impl, /*force=*/false);
+  return TSI_OK;
+}
+
 static void ssl_protector_destroy(tsi_frame_protector* self) {
   tsi_ssl_frame_protector* impl =
       reinterpret_cast<tsi_ssl_frame_protector*>(self);
+  ssl_protector_flush_stats(impl, /*force=*/true);
+  if (GRPC_TRACE_FLAG_ENABLED(tsi_tracing_enabled)) {
+    gpr_log(GPR_INFO,
+            "SSL protector %p done: %" PRIu64 " records (%" PRIu64
+            " bytes) protected in %" PRIu64 " ns, %" PRIu64 " records (%" PRIu64
+            " bytes) unprotected in %" PRIu64 " ns, %" PRIu64 " key updates",
+            impl, impl->stats.records_protected, impl->stats.bytes_protected,
+            impl->stats.protect_ns, impl->stats.records_unprotected,
+            impl->stats.bytes_unprotected, impl->stats.unprotect_ns,
+            impl->stats.key_updates);
+  }
   if (impl->buffer != nullptr) gpr_free(impl->buffer);
   if (impl->ssl != nullptr) SSL_free(impl->ssl);
   if (impl->network_io != nullptr) BIO_free(impl->network_io);
+  delete impl->window;
   gpr_free(self);
 }
 
@@ -1227,6 +1808,156 @@ static const tsi_frame_protector_vtable frame_protector_vtable = {
     ssl_protector_destroy,
 };
 
+/* --- tsi_zero_copy_grpc_protector methods implementation. ---*/
+
+/* Zero-copy protector on top of a frame protector whose SSL object uses a
+   window BIO. Records are encrypted straight from the unprotected slices and
+   decrypted straight from the protected ones, instead of going through the
+   staging buffers of the secure endpoint. */
+struct tsi_ssl_zero_copy_grpc_protector {
+  tsi_zero_copy_grpc_protector base;
+  tsi_ssl_frame_protector* protector;
+};
+
+/* Adds the first length bytes of slice to sb and unrefs the rest. */
+static void ssl_add_slice_head(grpc_slice_buffer* sb, grpc_slice slice,
+                               size_t length) {
+  if (length > 0) {
+    grpc_slice_buffer_add(sb, grpc_slice_split_head(&slice, length));
+  }
+  grpc_slice_unref_internal(slice);
+}
+
+/* Moves the ciphertext that SSL wrote outside of a protect call, or that did
+   not fit in its output, to protected_slices. */
+static tsi_result ssl_zero_copy_move_pending(
+    tsi_ssl_frame_protector* impl, grpc_slice_buffer* protected_slices) {
+  size_t pending = ssl_protector_pending(impl);
+  if (pending == 0) return TSI_OK;
+  grpc_slice slice = GRPC_SLICE_MALLOC(pending);
+  int read = ssl_protector_read_pending(impl, GRPC_SLICE_START_PTR(slice),
+                                        pending);
+  if (read < 0) {
+    grpc_slice_unref_internal(slice);
+    return TSI_INTERNAL_ERROR;
+  }
+  ssl_add_slice_head(protected_slices, slice, static_cast<size_t>(read));
+  return TSI_OK;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_protect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* unprotected_slices,
+    grpc_slice_buffer* protected_slices) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_frame_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self)->protector;
+  tsi_result result = ssl_zero_copy_move_pending(impl, protected_slices);
+  while (result == TSI_OK && unprotected_slices->length > 0) {
+    ssl_protector_start_record(impl);
+    size_t size = impl->record_size;
+    if (size > unprotected_slices->length) size = unprotected_slices->length;
+    /* A record that lies in one slice is encrypted from there; one that
+       spans slices is gathered in our buffer first. */
+    grpc_slice first = grpc_empty_slice();
+    const unsigned char* bytes = impl->buffer;
+    if (GRPC_SLICE_LENGTH(unprotected_slices->slices[0]) >= size) {
+      first = grpc_slice_buffer_take_first(unprotected_slices);
+      if (GRPC_SLICE_LENGTH(first) > size) {
+        grpc_slice_buffer_undo_take_first(unprotected_slices,
+                                          grpc_slice_split_tail(&first, size));
+      }
+      bytes = GRPC_SLICE_START_PTR(first);
+    } else {
+      grpc_slice_buffer_move_first_into_buffer(unprotected_slices, size,
+                                               impl->buffer);
+    }
+    grpc_slice out = GRPC_SLICE_MALLOC(size + TSI_SSL_MAX_PROTECTION_OVERHEAD);
+    size_t out_size = GRPC_SLICE_LENGTH(out);
+    result = ssl_protector_write_record(impl, bytes, size,
+                                        GRPC_SLICE_START_PTR(out), &out_size);
+    grpc_slice_unref_internal(first);
+    if (result != TSI_OK) {
+      grpc_slice_unref_internal(out);
+      break;
+    }
+    ssl_add_slice_head(protected_slices, out, out_size);
+    result = ssl_zero_copy_move_pending(impl, protected_slices);
+  }
+  return result;
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_unprotect(
+    tsi_zero_copy_grpc_protector* self, grpc_slice_buffer* protected_slices,
+    grpc_slice_buffer* unprotected_slices) {
+  if (self == nullptr || unprotected_slices == nullptr ||
+      protected_slices == nullptr) {
+    return TSI_INVALID_ARGUMENT;
+  }
+  tsi_ssl_frame_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self)->protector;
+  tsi_result result = TSI_OK;
+  grpc_slice out = grpc_empty_slice();
+  for (size_t i = 0; result == TSI_OK && i < protected_slices->count; i++) {
+    const unsigned char* bytes =
+        GRPC_SLICE_START_PTR(protected_slices->slices[i]);
+    size_t size = GRPC_SLICE_LENGTH(protected_slices->slices[i]);
+    /* Keep going while there is ciphertext left or SSL may still hold
+       plaintext that did not fit in the last slice. */
+    bool keep_looping = true;
+    while (size > 0 || keep_looping) {
+      if (GRPC_SLICE_LENGTH(out) < TSI_SSL_ZERO_COPY_MIN_READ_SIZE) {
+        grpc_slice_unref_internal(out);
+        out = GRPC_SLICE_MALLOC(TSI_SSL_ZERO_COPY_READ_SLICE_SIZE);
+      }
+      size_t consumed = size;
+      size_t produced = GRPC_SLICE_LENGTH(out);
+      result = ssl_protector_unprotect(&impl->base, bytes, &consumed,
+                                       GRPC_SLICE_START_PTR(out), &produced);
+      if (result != TSI_OK) break;
+      if (produced > 0) {
+        grpc_slice_buffer_add(unprotected_slices,
+                              grpc_slice_split_head(&out, produced));
+      }
+      bytes += consumed;
+      size -= consumed;
+      keep_looping = produced > 0;
+    }
+  }
+  grpc_slice_unref_internal(out);
+  grpc_slice_buffer_reset_and_unref_internal(protected_slices);
+  return result;
+}
+
+static void ssl_zero_copy_grpc_protector_destroy(
+    tsi_zero_copy_grpc_protector* self) {
+  if (self == nullptr) return;
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  ssl_protector_destroy(&impl->protector->base);
+  gpr_free(impl);
+}
+
+static tsi_result ssl_zero_copy_grpc_protector_max_frame_size(
+    tsi_zero_copy_grpc_protector* self, size_t* max_frame_size) {
+  if (self == nullptr || max_frame_size == nullptr) return TSI_INVALID_ARGUMENT;
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      reinterpret_cast<tsi_ssl_zero_copy_grpc_protector*>(self);
+  *max_frame_size =
+      impl->protector->buffer_size + TSI_SSL_MAX_PROTECTION_OVERHEAD;
+  return TSI_OK;
+}
+
+static const tsi_zero_copy_grpc_protector_vtable
+    zero_copy_grpc_protector_vtable = {
+        ssl_zero_copy_grpc_protector_protect,
+        ssl_zero_copy_grpc_protector_unprotect,
+        ssl_zero_copy_grpc_protector_destroy,
+        ssl_zero_copy_grpc_protector_max_frame_size,
+};
+
 /* --- tsi_server_handshaker_factory methods implementation. --- */
 
 static void tsi_ssl_handshaker_factory_destroy(
@@ -1362,9 +2093,21 @@ static tsi_result ssl_handshaker_result_extract_peer(
 }
 
 static tsi_result ssl_handshaker_result_get_frame_protector_type(
-    const tsi_handshaker_result* /*self*/,
+    const tsi_handshaker_result* self,
     tsi_frame_protector_type* frame_protector_type) {
   *frame_protector_type = TSI_FRAME_PROTECTOR_NORMAL;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+  /* The zero-copy protector needs the window BIO, which replaces the BIO pair
+     only if the pair is empty. */
+  const tsi_ssl_handshaker_result* impl =
+      reinterpret_cast<const tsi_ssl_handshaker_result*>(self);
+  if (BIO_pending(impl->network_io) == 0 &&
+      BIO_pending(SSL_get_rbio(impl->ssl)) == 0) {
+    *frame_protector_type = TSI_FRAME_PROTECTOR_NORMAL_OR_ZERO_COPY;
+  }
+#else
+  (void)self;
+#endif
   return TSI_OK;
 }
 
@@ -1408,11 +2151,40 @@ static tsi_result ssl_handshaker_result_create_frame_protector(
   impl->ssl = nullptr;
   protector_impl->network_io = impl->network_io;
   impl->network_io = nullptr;
+#if OPENSSL_VERSION_NUMBER >= 0x10100000
+  protector_impl->window =
+      ssl_set_window_bio(protector_impl->ssl, protector_impl->network_io);
+  if (protector_impl->window != nullptr) protector_impl->network_io = nullptr;
+#endif
   protector_impl->base.vtable = &frame_protector_vtable;
+  GetProtectionStats()->connections.fetch_add(1, std::memory_order_relaxed);
   *protector = &protector_impl->base;
   return TSI_OK;
 }
 
+static tsi_result ssl_handshaker_result_create_zero_copy_grpc_protector(
+    const tsi_handshaker_result* self, size_t* max_output_protected_frame_size,
+    tsi_zero_copy_grpc_protector** protector) {
+  tsi_frame_protector* frame_protector = nullptr;
+  tsi_result result = ssl_handshaker_result_create_frame_protector(
+      self, max_output_protected_frame_size, &frame_protector);
+  if (result != TSI_OK) return result;
+  tsi_ssl_frame_protector* frame_protector_impl =
+      reinterpret_cast<tsi_ssl_frame_protector*>(frame_protector);
+  if (frame_protector_impl->window == nullptr) {
+    gpr_log(GPR_ERROR, "Zero-copy protection needs an empty BIO pair.");
+    ssl_protector_destroy(frame_protector);
+    return TSI_FAILED_PRECONDITION;
+  }
+  tsi_ssl_zero_copy_grpc_protector* impl =
+      static_cast<tsi_ssl_zero_copy_grpc_protector*>(
+          gpr_zalloc(sizeof(*impl)));
+  impl->base.vtable = &zero_copy_grpc_protector_vtable;
+  impl->protector = frame_protector_impl;
+  *protector = &impl->base;
+  return TSI_OK;
+}
+
 static tsi_result ssl_handshaker_result_get_unused_bytes(
     const tsi_handshaker_result* self, const unsigned char** bytes,
     size_t* bytes_size) {
@@ -1435,7 +2207,7 @@ static void ssl_handshaker_result_destroy(tsi_handshaker_result* self) {
 static const tsi_handshaker_result_vtable handshaker_result_vtable = {
     ssl_handshaker_result_extract_peer,
     ssl_handshaker_result_get_frame_protector_type,
-    nullptr, /* create_zero_copy_grpc_protector */
+    ssl_handshaker_result_create_zero_copy_grpc_protector,
     ssl_handshaker_result_create_frame_protector,
     ssl_handshaker_result_get_unused_bytes,
     ssl_handshaker_result_destroy,
@@ -1488,9 +2260,20 @@ static tsi_result ssl_handshaker_get_bytes_to_send_to_peer(
   return BIO_pending(impl->network_io) == 0 ? TSI_OK : TSI_INCOMPLETE_DATA;
 }
 
+static bool ssl_handshaker_can_send_data(SSL* ssl) {
+#if defined(OPENSSL_IS_BORINGSSL)
+  /* A client resuming a 0-RTT capable session can send (early) data as soon
+     as its ClientHello is out: the frame protector's first SSL_read completes
+     the handshake. The peer's certificates and ALPN protocol are already
+     known from the session. */
+  if (SSL_in_early_data(ssl)) return true;
+#endif
+  return SSL_is_init_finished(ssl);
+}
+
 static tsi_result ssl_handshaker_get_result(tsi_ssl_handshaker* impl) {
   if ((impl->result == TSI_HANDSHAKE_IN_PROGRESS) &&
-      SSL_is_init_finished(impl->ssl)) {
+      ssl_handshaker_can_send_data(impl->ssl)) {
     impl->result = TSI_OK;
   }
   return impl->result;
@@ -1716,7 +2499,8 @@ static tsi_result create_tsi_ssl_handshaker(SSL_CTX* ctx, int is_client,
     ERR_clear_error();
     ssl_result = SSL_do_handshake(ssl);
     ssl_result = SSL_get_error(ssl, ssl_result);
-    if (ssl_result != SSL_ERROR_WANT_READ) {
+    if (ssl_result != SSL_ERROR_WANT_READ &&
+        !(ssl_result == SSL_ERROR_NONE && ssl_handshaker_can_send_data(ssl))) {
       gpr_log(GPR_ERROR,
               "Unexpected error received from first SSL_do_handshake call: %s",
               ssl_error_string(ssl_result));
@@ -2025,6 +2809,11 @@ tsi_result tsi_create_ssl_client_handshaker_factory_with_options(
     SSL_CTX_sess_set_new_cb(ssl_context,
                             server_handshaker_factory_new_session_callback);
     SSL_CTX_set_session_cache_mode(ssl_context, SSL_SESS_CACHE_CLIENT);
+#if defined(OPENSSL_IS_BORINGSSL)
+    if (options->enable_early_data) {
+      SSL_CTX_set_early_data_enabled(ssl_context, 1);
+    }
+#endif
   }
 
   do {
@@ -2098,6 +2887,31 @@ tsi_result tsi_create_ssl_client_handshaker_factory_with_options(
       gpr_log(GPR_INFO, "enabled client side CRL checking.");
     }
   }
+
+  if (!options->skip_server_certificate_verification) {
+    SHA256_CTX sha;
+    SHA256_Init(&sha);
+    if (options->pem_root_certs != nullptr) {
+      SHA256_Update(&sha, options->pem_root_certs,
+                    strlen(options->pem_root_certs) + 1);
+    }
+    if (options->root_store != nullptr) {
+      const X509_STORE* store = options->root_store->store;
+      SHA256_Update(&sha, &store, sizeof(store));
+    }
+    if (options->crl_directory != nullptr) {
+      SHA256_Update(&sha, options->crl_directory,
+                    strlen(options->crl_directory) + 1);
+    }
+    SHA256_Final(impl->verified_chain_config_digest, &sha);
+    impl->verified_chain_ttl_seconds =
+        options->crl_directory != nullptr &&
+                strcmp(options->crl_directory, "") != 0
+            ? TSI_SSL_VERIFIED_CHAIN_CRL_TTL_SECONDS
+            : TSI_SSL_VERIFIED_CHAIN_TTL_SECONDS;
+    SSL_CTX_set_cert_verify_callback(
+        ssl_context, verified_chain_cache_verify_callback, impl);
+  }
 #endif
 
   *factory = impl;
@@ -11,6 +11,7 @@
 #include "leveldb/db.h"
 #include "leveldb/env.h"
 #include "leveldb/iterator.h"
+#include "util/rate_limited_file.h"
 
 namespace leveldb {
 
@@ -27,6 +28,9 @@ Status BuildTable(const std::string& dbname, Env* env, const Options& options,
     if (!s.ok()) {
       return s;
     }
+    // Writers may be stalled on this table, so it goes ahead of compactions.
+    file = NewRateLimitedFile(file, options.rate_limiter,
+                              RateLimiter::Priority::kHigh);
 
     TableBuilder* builder = new TableBuilder(options, file);
     meta->smallest.DecodeFrom(iter->key());
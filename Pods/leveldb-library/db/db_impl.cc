@@ -9,6 +9,8 @@
 
 #include <algorithm>
 #include <atomic>
+#include <deque>
+#include <numeric>
 #include <set>
 #include <string>
 #include <vector>
@@ -35,6 +37,7 @@
 #include "util/coding.h"
 #include "util/logging.h"
 #include "util/mutexlock.h"
+#include "util/rate_limited_file.h"
 
 namespace leveldb {
 
@@ -43,15 +46,32 @@ const int kNumNonTableCacheFiles = 10;
 // Information kept for every waiting writer
 struct DBImpl::Writer {
   explicit Writer(port::Mutex* mu)
-      : batch(nullptr), sync(false), done(false), cv(mu) {}
+      : batch(nullptr),
+        sync(false),
+        done(false),
+        insert_pending(false),
+        cv(mu) {}
 
   Status status;
   WriteBatch* batch;
   bool sync;
   bool done;
+  bool insert_pending;  // Logged by the leader, still to be added to mem_
   port::CondVar cv;
 };
 
+// A part of a compaction that runs on a thread of its own: the input with
+// user keys in [begin, *end), or from begin on if end is null.
+struct DBImpl::Subcompaction {
+  DBImpl* db;
+  CompactionState* state;
+  std::string begin;
+  const std::string* end;
+  Status status GUARDED_BY(db->mutex_);
+  bool done GUARDED_BY(db->mutex_);
+  port::CondVar* done_cv;
+};
+
 struct DBImpl::CompactionState {
   // Files produced by compaction
   struct Output {
@@ -77,6 +97,9 @@ struct DBImpl::CompactionState {
   // we can drop all entries for the same key with sequence numbers < S.
   SequenceNumber smallest_snapshot;
 
+  // Position of the pass over the compaction input that fills outputs
+  Compaction::Progress progress;
+
   std::vector<Output> outputs;
 
   // State kept for output being generated
@@ -101,8 +124,13 @@ Options SanitizeOptions(const std::string& dbname,
   result.filter_policy = (src.filter_policy != nullptr) ? ipolicy : nullptr;
   ClipToRange(&result.max_open_files, 64 + kNumNonTableCacheFiles, 50000);
   ClipToRange(&result.write_buffer_size, 64 << 10, 1 << 30);
+  if (result.arena_block_size == 0) {
+    result.arena_block_size = result.write_buffer_size / 64;
+  }
+  ClipToRange(&result.arena_block_size, 4 << 10, 16 << 20);
   ClipToRange(&result.max_file_size, 1 << 20, 1 << 30);
   ClipToRange(&result.block_size, 1 << 10, 4 << 20);
+  ClipToRange(&result.max_subcompactions, 1, 64);
   if (result.info_log == nullptr) {
     // Open a log file in the same directory as the db
     src.env->CreateDir(dbname);  // In case it does not exist
@@ -145,18 +173,55 @@ DBImpl::DBImpl(const Options& raw_options, const std::string& dbname)
       log_(nullptr),
       seed_(0),
       tmp_batch_(new WriteBatch),
+      last_allocated_sequence_(0),
+      memtable_turn_(&mutex_),
+      pending_memtable_inserts_(0),
+      memtable_inserts_done_(&mutex_),
+      background_log_sync_(false),
+      log_sync_thread_running_(false),
+      log_sync_in_progress_(false),
+      logged_sequence_(0),
+      sync_requested_sequence_(0),
+      durable_sequence_(0),
+      log_sync_requested_(&mutex_),
+      log_synced_(&mutex_),
       background_compaction_scheduled_(false),
       manual_compaction_(nullptr),
       versions_(new VersionSet(dbname_, &options_, table_cache_,
                                &internal_comparator_)) {}
 
 DBImpl::~DBImpl() {
+  if (options_.flush_memtable_on_close) {
+    // Leave no log records for the next open to replay.  mem_ is null if
+    // the open failed.
+    mutex_.Lock();
+    bool flush = false;
+    if (mem_ != nullptr && bg_error_.ok()) {
+      Iterator* iter = mem_->NewIterator();
+      iter->SeekToFirst();
+      flush = iter->Valid();
+      delete iter;
+    }
+    mutex_.Unlock();
+    if (flush) {
+      Status s = FlushMemTable();
+      if (!s.ok()) {
+        Log(options_.info_log, "Flush on close failed: %s",
+            s.ToString().c_str());
+      }
+    }
+  }
+
   // Wait for background work to finish.
   mutex_.Lock();
   shutting_down_.store(true, std::memory_order_release);
   while (background_compaction_scheduled_) {
     background_work_finished_signal_.Wait();
   }
+  log_sync_requested_.Signal();
+  while (log_sync_thread_running_) {
+    log_synced_.Wait();
+  }
   mutex_.Unlock();
 
   if (db_lock_ != nullptr) {
@@ -179,6 +244,17 @@ DBImpl::~DBImpl() {
   }
 }
 
+// Returns the options to build the table files of the given level with.
+static Options TableOptionsForLevel(const Options& options, int level) {
+  Options result = options;
+  if (!options.compression_per_level.empty()) {
+    const size_t last = options.compression_per_level.size() - 1;
+    result.compression =
+        options.compression_per_level[std::min<size_t>(level, last)];
+  }
+  return result;
+}
+
 Status DBImpl::NewDB() {
   VersionEdit new_db;
   new_db.SetComparatorName(user_comparator()->Name());
@@ -368,6 +444,130 @@ Status DBImpl::Recover(VersionEdit* edit, bool* save_manifest) {
   return Status::OK();
 }
 
+namespace {
+
+// Reads the records of a log on a background thread, so that reading them
+// and verifying their checksums overlaps with their insertion into the
+// memtable during recovery.
+class LogRecordReader {
+ public:
+  // The records too small to hold a write batch are reported to
+  // *reporter and skipped.  Reading stops once *read_status, if non-null,
+  // records an error.
+  LogRecordReader(log::Reader* reader, log::Reader::Reporter* reporter,
+                  const Status* read_status)
+      : reader_(reader),
+        reporter_(reporter),
+        read_status_(read_status),
+        next_record_(0),
+        cv_(&mu_),
+        done_(false),
+        cancelled_(false) {}
+
+  LogRecordReader(const LogRecordReader&) = delete;
+  LogRecordReader& operator=(const LogRecordReader&) = delete;
+
+  // Stops reading; *read_status is stable once this returns.
+  ~LogRecordReader() {
+    MutexLock l(&mu_);
+    cancelled_ = true;
+    cv_.SignalAll();
+    while (!done_) {
+      cv_.Wait();
+    }
+  }
+
+  void Start(Env* env) { env->StartThread(&LogRecordReader::ReadWork, this); }
+
+  // Stores the next record in *record.  Returns false at the end of the
+  // log or once reading has stopped.
+  bool Next(std::string* record) {
+    if (next_record_ == records_.size()) {
+      // Records are handed over in chunks to keep the two threads from
+      // contending for mu_ on every record.
+      records_.clear();
+      next_record_ = 0;
+      MutexLock l(&mu_);
+      while (chunks_.empty() && !done_) {
+        cv_.Wait();
+      }
+      if (chunks_.empty()) {
+        return false;
+      }
+      records_.swap(chunks_.front());
+      chunks_.pop_front();
+      cv_.SignalAll();
+    }
+    record->swap(records_[next_record_++]);
+    return true;
+  }
+
+ private:
+  // The records read ahead of the memtable inserts are bounded to
+  // kMaxChunks chunks of about kChunkBytes each.
+  static const size_t kChunkBytes = 256 << 10;
+  static const size_t kMaxChunks = 16;
+
+  static void ReadWork(void* arg) {
+    reinterpret_cast<LogRecordReader*>(arg)->Read();
+  }
+
+  void Read() {
+    std::string scratch;
+    Slice record;
+    std::vector<std::string> chunk;
+    size_t chunk_bytes = 0;
+    while (true) {
+      bool more = reader_->ReadRecord(&record, &scratch) &&
+                  (read_status_ == nullptr || read_status_->ok());
+      if (more && record.size() < 12) {
+        reporter_->Corruption(record.size(),
+                              Status::Corruption("log record too small"));
+        continue;
+      }
+      if (more) {
+        chunk.emplace_back(record.data(), record.size());
+        chunk_bytes += record.size();
+        if (chunk_bytes < kChunkBytes) {
+          continue;
+        }
+      }
+
+      MutexLock l(&mu_);
+      while (!cancelled_ && chunks_.size() >= kMaxChunks) {
+        cv_.Wait();
+      }
+      if (!chunk.empty() && !cancelled_) {
+        chunks_.emplace_back();
+        chunks_.back().swap(chunk);
+        chunk_bytes = 0;
+        cv_.SignalAll();
+      }
+      if (!more || cancelled_) {
+        done_ = true;
+        cv_.SignalAll();
+        return;
+      }
+    }
+  }
+
+  log::Reader* const reader_;
+  log::Reader::Reporter* const reporter_;
+  const Status* const read_status_;
+
+  // The chunk the caller of Next() is consuming.
+  std::vector<std::string> records_;
+  size_t next_record_;
+
+  port::Mutex mu_;
+  port::CondVar cv_ GUARDED_BY(mu_);
+  std::deque<std::vector<std::string>> chunks_ GUARDED_BY(mu_);
+  bool done_ GUARDED_BY(mu_);
+  bool cancelled_ GUARDED_BY(mu_);
+};
+
+}  // namespace
+
 Status DBImpl::RecoverLogFile(uint64_t log_number, bool last_log,
                               bool* save_manifest, VersionEdit* edit,
                               SequenceNumber* max_sequence) {
@@ -395,12 +595,14 @@ Status DBImpl::RecoverLogFile(uint64_t log_number, bool last_log,
     return status;
   }
 
-  // Create the log reader.
+  // Create the log reader.  Errors of the reader are only touched by the
+  // thread of LogRecordReader until it is destroyed.
+  Status read_status;
   LogReporter reporter;
   reporter.env = env_;
   reporter.info_log = options_.info_log;
   reporter.fname = fname.c_str();
-  reporter.status = (options_.paranoid_checks ? &status : nullptr);
+  reporter.status = (options_.paranoid_checks ? &read_status : nullptr);
   // We intentionally make log::Reader do checksumming even if
   // paranoid_checks==false so that corruptions cause entire commits
   // to be skipped instead of propagating bad information (like overly
@@ -410,21 +612,18 @@ Status DBImpl::RecoverLogFile(uint64_t log_number, bool last_log,
       (unsigned long long)log_number);
 
   // Read all the records and add to a memtable
-  std::string scratch;
-  Slice record;
+  std::string record;
   WriteBatch batch;
   int compactions = 0;
   MemTable* mem = nullptr;
-  while (reader.ReadRecord(&record, &scratch) && status.ok()) {
-    if (record.size() < 12) {
-      reporter.Corruption(record.size(),
-                          Status::Corruption("log record too small"));
-      continue;
-    }
+  LogRecordReader* records =
+      new LogRecordReader(&reader, &reporter, reporter.status);
+  records->Start(env_);
+  while (status.ok() && records->Next(&record)) {
     WriteBatchInternal::SetContents(&batch, record);
 
     if (mem == nullptr) {
-      mem = new MemTable(internal_comparator_);
+      mem = NewMemTable();
       mem->Ref();
     }
     status = WriteBatchInternal::InsertInto(&batch, mem);
@@ -452,6 +651,10 @@ Status DBImpl::RecoverLogFile(uint64_t log_number, bool last_log,
     }
   }
 
+  delete records;
+  if (status.ok()) {
+    status = read_status;
+  }
   delete file;
 
   // See if we should keep reusing the last log file.
@@ -470,7 +673,7 @@ Status DBImpl::RecoverLogFile(uint64_t log_number, bool last_log,
         mem = nullptr;
       } else {
         // mem can be nullptr if lognum exists but was empty.
-        mem_ = new MemTable(internal_comparator_);
+        mem_ = NewMemTable();
         mem_->Ref();
       }
     }
@@ -502,7 +705,8 @@ Status DBImpl::WriteLevel0Table(MemTable* mem, VersionEdit* edit,
   Status s;
   {
     mutex_.Unlock();
-    s = BuildTable(dbname_, env_, options_, table_cache_, iter, &meta);
+    s = BuildTable(dbname_, env_, TableOptionsForLevel(options_, 0),
+                   table_cache_, iter, &meta);
     mutex_.Lock();
   }
 
@@ -621,7 +825,14 @@ void DBImpl::TEST_CompactRange(int level, const Slice* begin,
   }
 }
 
-Status DBImpl::TEST_CompactMemTable() {
+Status DBImpl::TEST_CompactMemTable() { return FlushMemTable(); }
+
+MemTable* DBImpl::NewMemTable() const {
+  return new MemTable(internal_comparator_, options_.arena_block_size,
+                      options_.memtable_huge_page_size);
+}
+
+Status DBImpl::FlushMemTable() {
   // nullptr batch means just wait for earlier writes to be done
   Status s = Write(WriteOptions(), nullptr);
   if (s.ok()) {
@@ -803,7 +1014,11 @@ Status DBImpl::OpenCompactionOutputFile(CompactionState* compact) {
   std::string fname = TableFileName(dbname_, file_number);
   Status s = env_->NewWritableFile(fname, &compact->outfile);
   if (s.ok()) {
-    compact->builder = new TableBuilder(options_, compact->outfile);
+    compact->outfile = NewRateLimitedFile(
+        compact->outfile, options_.rate_limiter, RateLimiter::Priority::kLow);
+    compact->builder = new TableBuilder(
+        TableOptionsForLevel(options_, compact->compaction->level() + 1),
+        compact->outfile);
   }
   return s;
 }
@@ -875,29 +1090,30 @@ Status DBImpl::InstallCompactionResults(CompactionState* compact) {
   return versions_->LogAndApply(compact->compaction->edit(), &mutex_);
 }
 
-Status DBImpl::DoCompactionWork(CompactionState* compact) {
-  const uint64_t start_micros = env_->NowMicros();
-  int64_t imm_micros = 0;  // Micros spent doing imm_ compactions
-
-  Log(options_.info_log, "Compacting %d@%d + %d@%d files",
-      compact->compaction->num_input_files(0), compact->compaction->level(),
-      compact->compaction->num_input_files(1),
-      compact->compaction->level() + 1);
+void DBImpl::SubcompactionWork(void* arg) {
+  Subcompaction* sub = reinterpret_cast<Subcompaction*>(arg);
+  const Slice begin(sub->begin);
+  const Slice end = sub->end != nullptr ? Slice(*sub->end) : Slice();
+  Status status = sub->db->DoSubcompactionWork(
+      sub->state, &begin, sub->end != nullptr ? &end : nullptr, false,
+      nullptr);
+  MutexLock l(&sub->db->mutex_);
+  sub->status = status;
+  sub->done = true;
+  sub->done_cv->SignalAll();
+}
 
-  assert(versions_->NumLevelFiles(compact->compaction->level()) > 0);
-  assert(compact->builder == nullptr);
-  assert(compact->outfile == nullptr);
-  if (snapshots_.empty()) {
-    compact->smallest_snapshot = versions_->LastSequence();
+Status DBImpl::DoSubcompactionWork(CompactionState* compact,
+                                   const Slice* begin, const Slice* end,
+                                   bool compact_memtable,
+                                   int64_t* imm_micros) {
+  Iterator* input = versions_->MakeInputIterator(compact->compaction);
+  if (begin != nullptr) {
+    InternalKey start(*begin, kMaxSequenceNumber, kValueTypeForSeek);
+    input->Seek(start.Encode());
   } else {
-    compact->smallest_snapshot = snapshots_.oldest()->sequence_number();
+    input->SeekToFirst();
   }
-
-  // Release mutex while we're actually doing the compaction work
-  mutex_.Unlock();
-
-  Iterator* input = versions_->MakeInputIterator(compact->compaction);
-  input->SeekToFirst();
   Status status;
   ParsedInternalKey ikey;
   std::string current_user_key;
@@ -905,7 +1121,7 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
   SequenceNumber last_sequence_for_key = kMaxSequenceNumber;
   for (; input->Valid() && !shutting_down_.load(std::memory_order_acquire);) {
     // Prioritize immutable compaction work
-    if (has_imm_.load(std::memory_order_relaxed)) {
+    if (compact_memtable && has_imm_.load(std::memory_order_relaxed)) {
       const uint64_t imm_start = env_->NowMicros();
       mutex_.Lock();
       if (imm_ != nullptr) {
@@ -914,11 +1130,16 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         background_work_finished_signal_.SignalAll();
       }
       mutex_.Unlock();
-      imm_micros += (env_->NowMicros() - imm_start);
+      *imm_micros += (env_->NowMicros() - imm_start);
     }
 
     Slice key = input->key();
-    if (compact->compaction->ShouldStopBefore(key) &&
+    if (end != nullptr && ParseInternalKey(key, &ikey) &&
+        user_comparator()->Compare(ikey.user_key, *end) >= 0) {
+      // The rest belongs to the next subcompaction
+      break;
+    }
+    if (compact->compaction->ShouldStopBefore(key, &compact->progress) &&
         compact->builder != nullptr) {
       status = FinishCompactionOutputFile(compact, input);
       if (!status.ok()) {
@@ -948,7 +1169,8 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         drop = true;  // (A)
       } else if (ikey.type == kTypeDeletion &&
                  ikey.sequence <= compact->smallest_snapshot &&
-                 compact->compaction->IsBaseLevelForKey(ikey.user_key)) {
+                 compact->compaction->IsBaseLevelForKey(ikey.user_key,
+                                                        &compact->progress)) {
         // For this user key:
         // (1) there is no data in higher levels
         // (2) data in lower levels will have larger sequence numbers
@@ -967,7 +1189,8 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
         "%d smallest_snapshot: %d",
         ikey.user_key.ToString().c_str(),
         (int)ikey.sequence, ikey.type, kTypeValue, drop,
-        compact->compaction->IsBaseLevelForKey(ikey.user_key),
+        compact->compaction->IsBaseLevelForKey(ikey.user_key,
+                                               &compact->progress),
         (int)last_sequence_for_key, (int)compact->smallest_snapshot);
 #endif
 
@@ -1008,7 +1231,79 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
     status = input->status();
   }
   delete input;
-  input = nullptr;
+  return status;
+}
+
+Status DBImpl::DoCompactionWork(CompactionState* compact) {
+  const uint64_t start_micros = env_->NowMicros();
+  int64_t imm_micros = 0;  // Micros spent doing imm_ compactions
+
+  Log(options_.info_log, "Compacting %d@%d + %d@%d files",
+      compact->compaction->num_input_files(0), compact->compaction->level(),
+      compact->compaction->num_input_files(1),
+      compact->compaction->level() + 1);
+
+  assert(versions_->NumLevelFiles(compact->compaction->level()) > 0);
+  assert(compact->builder == nullptr);
+  assert(compact->outfile == nullptr);
+  if (snapshots_.empty()) {
+    compact->smallest_snapshot = versions_->LastSequence();
+  } else {
+    compact->smallest_snapshot = snapshots_.oldest()->sequence_number();
+  }
+
+  // Split large compactions into subcompactions over disjoint key ranges,
+  // which run on threads of their own next to this one.
+  std::vector<std::string> boundaries;
+  compact->compaction->GetSubcompactionBoundaries(options_.max_subcompactions,
+                                                  &boundaries);
+  std::vector<Subcompaction*> subcompactions;
+  port::CondVar subcompactions_done(&mutex_);
+  for (size_t i = 0; i < boundaries.size(); i++) {
+    Subcompaction* sub = new Subcompaction;
+    sub->db = this;
+    sub->state = new CompactionState(compact->compaction);
+    sub->state->smallest_snapshot = compact->smallest_snapshot;
+    sub->begin = boundaries[i];
+    sub->end = i + 1 < boundaries.size() ? &boundaries[i + 1] : nullptr;
+    sub->done = false;
+    sub->done_cv = &subcompactions_done;
+    subcompactions.push_back(sub);
+  }
+  if (!subcompactions.empty()) {
+    Log(options_.info_log, "Compacting in %d subcompactions",
+        static_cast<int>(subcompactions.size() + 1));
+  }
+
+  // Release mutex while we're actually doing the compaction work
+  mutex_.Unlock();
+
+  for (Subcompaction* sub : subcompactions) {
+    env_->StartThread(&DBImpl::SubcompactionWork, sub);
+  }
+  const Slice first_end =
+      boundaries.empty() ? Slice() : Slice(boundaries.front());
+  Status status = DoSubcompactionWork(
+      compact, nullptr, boundaries.empty() ? nullptr : &first_end, true,
+      &imm_micros);
+
+  mutex_.Lock();
+  for (Subcompaction* sub : subcompactions) {
+    while (!sub->done) {
+      subcompactions_done.Wait();
+    }
+    if (status.ok()) {
+      status = sub->status;
+    }
+    // Outputs are in key order across subcompactions as well.
+    compact->outputs.insert(compact->outputs.end(),
+                            sub->state->outputs.begin(),
+                            sub->state->outputs.end());
+    compact->total_bytes += sub->state->total_bytes;
+    sub->state->outputs.clear();
+    CleanupCompaction(sub->state);
+    delete sub;
+  }
 
   CompactionStats stats;
   stats.micros = env_->NowMicros() - start_micros - imm_micros;
@@ -1021,7 +1316,6 @@ Status DBImpl::DoCompactionWork(CompactionState* compact) {
     stats.bytes_written += compact->outputs[i].file_size;
   }
 
-  mutex_.Lock();
   stats_[compact->compaction->level() + 1].Add(stats);
 
   if (status.ok()) {
@@ -1043,6 +1337,11 @@ struct IterState {
   MemTable* const mem GUARDED_BY(mu);
   MemTable* const imm GUARDED_BY(mu);
 
+  // ReadOptions::iterate_upper_bound as an internal key, which the internal
+  // iterators are bounded by.
+  std::string upper_bound;
+  Slice upper_bound_slice;
+
   IterState(port::Mutex* mutex, MemTable* mem, MemTable* imm, Version* version)
       : mu(mutex), version(version), mem(mem), imm(imm) {}
 };
@@ -1064,6 +1363,17 @@ Iterator* DBImpl::NewInternalIterator(const ReadOptions& options,
                                       uint32_t* seed) {
   mutex_.Lock();
   *latest_snapshot = versions_->LastSequence();
+  IterState* cleanup = new IterState(&mutex_, mem_, imm_, versions_->current());
+
+  ReadOptions internal_options = options;
+  if (options.iterate_upper_bound != nullptr) {
+    // The first internal key of the bound's user key.
+    AppendInternalKey(&cleanup->upper_bound,
+                      ParsedInternalKey(*options.iterate_upper_bound,
+                                        kMaxSequenceNumber, kValueTypeForSeek));
+    cleanup->upper_bound_slice = cleanup->upper_bound;
+    internal_options.iterate_upper_bound = &cleanup->upper_bound_slice;
+  }
 
   // Collect together all needed child iterators
   std::vector<Iterator*> list;
@@ -1073,12 +1383,12 @@ Iterator* DBImpl::NewInternalIterator(const ReadOptions& options,
     list.push_back(imm_->NewIterator());
     imm_->Ref();
   }
-  versions_->current()->AddIterators(options, &list);
+  versions_->current()->AddIterators(internal_options, &list);
   Iterator* internal_iter =
-      NewMergingIterator(&internal_comparator_, &list[0], list.size());
+      NewMergingIterator(&internal_comparator_, &list[0], list.size(),
+                         internal_options.iterate_upper_bound);
   versions_->current()->Ref();
 
-  IterState* cleanup = new IterState(&mutex_, mem_, imm_, versions_->current());
   internal_iter->RegisterCleanup(CleanupIteratorState, cleanup, nullptr);
 
   *seed = ++seed_;
@@ -1144,6 +1454,83 @@ Status DBImpl::Get(const ReadOptions& options, const Slice& key,
   return s;
 }
 
+std::vector<Status> DBImpl::MultiGet(const ReadOptions& options,
+                                     const std::vector<Slice>& keys,
+                                     std::vector<std::string>* values) {
+  const size_t n = keys.size();
+  std::vector<Status> statuses(n);
+  values->clear();
+  values->resize(n);
+
+  MutexLock l(&mutex_);
+  SequenceNumber snapshot;
+  if (options.snapshot != nullptr) {
+    snapshot =
+        static_cast<const SnapshotImpl*>(options.snapshot)->sequence_number();
+  } else {
+    snapshot = versions_->LastSequence();
+  }
+
+  MemTable* mem = mem_;
+  MemTable* imm = imm_;
+  Version* current = versions_->current();
+  mem->Ref();
+  if (imm != nullptr) imm->Ref();
+  current->Ref();
+
+  // Unlock while reading from files and memtables
+  std::vector<Version::MultiGetRequest> requests(n);
+  {
+    mutex_.Unlock();
+    // Version::MultiGet() wants the keys in order, and the memtables are
+    // searched in the same order to stay close to the previous key.
+    const Comparator* ucmp = user_comparator();
+    std::vector<size_t> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+      return ucmp->Compare(keys[a], keys[b]) < 0;
+    });
+
+    std::deque<LookupKey> lkeys;
+    std::vector<Version::MultiGetRequest*> pending;
+    for (size_t i : order) {
+      lkeys.emplace_back(keys[i], snapshot);
+      const LookupKey& lkey = lkeys.back();
+      std::string* value = &(*values)[i];
+      if (mem->Get(lkey, value, &statuses[i])) {
+        // Done
+      } else if (imm != nullptr && imm->Get(lkey, value, &statuses[i])) {
+        // Done
+      } else {
+        requests[i].key = &lkey;
+        requests[i].value = value;
+        pending.push_back(&requests[i]);
+      }
+    }
+    if (!pending.empty()) {
+      current->MultiGet(options, pending);
+    }
+    mutex_.Lock();
+  }
+
+  bool need_compaction = false;
+  for (size_t i = 0; i < n; i++) {
+    if (requests[i].key != nullptr) {
+      statuses[i] = requests[i].status;
+      if (current->UpdateStats(requests[i].stats)) {
+        need_compaction = true;
+      }
+    }
+  }
+  if (need_compaction) {
+    MaybeScheduleCompaction();
+  }
+  mem->Unref();
+  if (imm != nullptr) imm->Unref();
+  current->Unref();
+  return statuses;
+}
+
 Iterator* DBImpl::NewIterator(const ReadOptions& options) {
   SequenceNumber latest_snapshot;
   uint32_t seed;
@@ -1153,7 +1540,7 @@ Iterator* DBImpl::NewIterator(const ReadOptions& options) {
                             ? static_cast<const SnapshotImpl*>(options.snapshot)
                                   ->sequence_number()
                             : latest_snapshot),
-                       seed);
+                       seed, options.iterate_upper_bound);
 }
 
 void DBImpl::RecordReadSample(Slice key) {
@@ -1190,37 +1577,67 @@ Status DBImpl::Write(const WriteOptions& options, WriteBatch* updates) {
 
   MutexLock l(&mutex_);
   writers_.push_back(&w);
-  while (!w.done && &w != writers_.front()) {
+  // With pipelined writes, the members of a logged group have left writers_
+  // before they are done.
+  while (!w.done && !w.insert_pending &&
+         (writers_.empty() || &w != writers_.front())) {
     w.cv.Wait();
   }
+  if (w.insert_pending) {
+    InsertBatchForGroup(&w);
+    while (!w.done) {
+      w.cv.Wait();
+    }
+  }
   if (w.done) {
     return w.status;
   }
 
   // May temporarily unlock and wait.
   Status status = MakeRoomForWrite(updates == nullptr);
-  uint64_t last_sequence = versions_->LastSequence();
+  uint64_t last_sequence = last_allocated_sequence_;
   Writer* last_writer = &w;
+  std::vector<Writer*> group;
+  bool sync_deferred = false;
   if (status.ok() && updates != nullptr) {  // nullptr batch is for compactions
     WriteBatch* updates = BuildBatchGroup(&last_writer);
     WriteBatchInternal::SetSequence(updates, last_sequence + 1);
+    const bool pipelined = options_.enable_pipelined_write;
+    const bool concurrent_insert =
+        options_.allow_concurrent_memtable_write && updates == tmp_batch_;
+    if (pipelined || concurrent_insert) {
+      // Give each batch of the group the sequence numbers it occupies in
+      // the combined log record, so that it can be inserted on its own.
+      SequenceNumber next_sequence = last_sequence + 1;
+      for (Writer* member : writers_) {
+        if (member->batch != nullptr) {
+          WriteBatchInternal::SetSequence(member->batch, next_sequence);
+          next_sequence += WriteBatchInternal::Count(member->batch);
+        }
+        group.push_back(member);
+        if (member == last_writer) break;
+      }
+    }
+    const SequenceNumber first_sequence = last_sequence + 1;
     last_sequence += WriteBatchInternal::Count(updates);
+    last_allocated_sequence_ = last_sequence;
 
     // Add to log and apply to memtable.  We can release the lock
     // during this phase since &w is currently responsible for logging
     // and protects against concurrent loggers and concurrent writes
     // into mem_.
+    sync_deferred = options.sync && background_log_sync_;
     {
       mutex_.Unlock();
       status = log_->AddRecord(WriteBatchInternal::Contents(updates));
       bool sync_error = false;
-      if (status.ok() && options.sync) {
+      if (status.ok() && options.sync && !sync_deferred) {
         status = logfile_->Sync();
         if (!status.ok()) {
           sync_error = true;
         }
       }
-      if (status.ok()) {
+      if (status.ok() && group.empty()) {
         status = WriteBatchInternal::InsertInto(updates, mem_);
       }
       mutex_.Lock();
@@ -1232,8 +1649,71 @@ Status DBImpl::Write(const WriteOptions& options, WriteBatch* updates) {
       }
     }
     if (updates == tmp_batch_) tmp_batch_->Clear();
+    if (status.ok()) {
+      logged_sequence_ = last_sequence;
+      if (sync_deferred) {
+        sync_requested_sequence_ = last_sequence;
+        log_sync_requested_.Signal();
+      }
+    }
+
+    if (pipelined) {
+      // Hand the log to the next group, then wait for the groups logged
+      // before this one to reach the memtable first.  Groups are applied
+      // and published in the order of their sequence numbers.
+      writers_.erase(writers_.begin(), writers_.begin() + group.size());
+      if (!writers_.empty()) {
+        writers_.front()->cv.Signal();
+      }
+      while (versions_->LastSequence() + 1 != first_sequence) {
+        memtable_turn_.Wait();
+      }
+    }
+    if (status.ok() && !group.empty()) {
+      status = InsertBatchGroup(group, concurrent_insert);
+    }
 
     versions_->SetLastSequence(last_sequence);
+    if (pipelined) {
+      memtable_turn_.SignalAll();
+      if (status.ok() && sync_deferred) {
+        status = AwaitLogSync(last_sequence);
+      }
+      for (Writer* member : group) {
+        if (member != &w) {
+          member->status = status;
+          member->done = true;
+          member->cv.Signal();
+        }
+      }
+      return status;
+    }
+  }
+
+  if (sync_deferred) {
+    // Let the next group log its records while the log sync thread syncs
+    // the log for this one.
+    group.clear();
+    while (true) {
+      Writer* member = writers_.front();
+      writers_.pop_front();
+      group.push_back(member);
+      if (member == last_writer) break;
+    }
+    if (!writers_.empty()) {
+      writers_.front()->cv.Signal();
+    }
+    if (status.ok()) {
+      status = AwaitLogSync(last_sequence);
+    }
+    for (Writer* member : group) {
+      if (member != &w) {
+        member->status = status;
+        member->done = true;
+        member->cv.Signal();
+      }
+    }
+    return status;
   }
 
   while (true) {
@@ -1255,6 +1735,108 @@ Status DBImpl::Write(const WriteOptions& options, WriteBatch* updates) {
   return status;
 }
 
+Status DBImpl::AwaitLogSync(SequenceNumber sequence) {
+  mutex_.AssertHeld();
+  while (durable_sequence_ < sequence && log_sync_status_.ok()) {
+    log_synced_.Wait();
+  }
+  return durable_sequence_ >= sequence ? Status::OK() : log_sync_status_;
+}
+
+void DBImpl::LogSyncWork(void* db) {
+  reinterpret_cast<DBImpl*>(db)->LogSyncCall();
+}
+
+void DBImpl::LogSyncCall() {
+  MutexLock l(&mutex_);
+  while (true) {
+    const bool pending =
+        durable_sequence_ < sync_requested_sequence_ && log_sync_status_.ok();
+    if (!pending) {
+      // Pending syncs are finished before shutting down.
+      if (shutting_down_.load(std::memory_order_acquire)) break;
+      log_sync_requested_.Wait();
+      continue;
+    }
+
+    // Every record up to logged_sequence_ has been flushed to logfile_, so
+    // a single sync covers the writers that have asked for one meanwhile.
+    const SequenceNumber target = logged_sequence_;
+    WritableFile* const logfile = logfile_;
+    log_sync_in_progress_ = true;
+    mutex_.Unlock();
+    Status s = logfile->SyncFlushed();
+    mutex_.Lock();
+    log_sync_in_progress_ = false;
+    if (s.ok()) {
+      durable_sequence_ = std::max(durable_sequence_, target);
+    } else {
+      // As with a failed inline sync, the log is now indeterminate.
+      log_sync_status_ = s;
+      RecordBackgroundError(s);
+    }
+    log_synced_.SignalAll();
+  }
+  log_sync_thread_running_ = false;
+  log_synced_.SignalAll();
+}
+
+// REQUIRES: Each batch of the group has been logged and carries its own
+// sequence number, and the group has the memtable to itself
+Status DBImpl::InsertBatchGroup(const std::vector<Writer*>& group,
+                                bool concurrently) {
+  mutex_.AssertHeld();
+  Writer* leader = group.front();
+  if (!concurrently) {
+    // mem_ cannot change before the group is published.
+    MemTable* mem = mem_;
+    mutex_.Unlock();
+    Status s;
+    for (Writer* member : group) {
+      if (member->batch != nullptr) {
+        s = WriteBatchInternal::InsertInto(member->batch, mem);
+        if (!s.ok()) break;
+      }
+    }
+    mutex_.Lock();
+    return s;
+  }
+
+  pending_memtable_inserts_ = 0;
+  memtable_insert_status_ = Status::OK();
+  for (Writer* member : group) {
+    if (member->batch != nullptr) {
+      pending_memtable_inserts_++;
+      if (member != leader) {
+        member->insert_pending = true;
+        member->cv.Signal();
+      }
+    }
+  }
+
+  InsertBatchForGroup(leader);
+  while (pending_memtable_inserts_ > 0) {
+    memtable_inserts_done_.Wait();
+  }
+  return memtable_insert_status_;
+}
+
+void DBImpl::InsertBatchForGroup(Writer* w) {
+  mutex_.AssertHeld();
+  // mem_ cannot change before the leader has seen every insert finish.
+  MemTable* mem = mem_;
+  mutex_.Unlock();
+  Status s = WriteBatchInternal::InsertIntoConcurrently(w->batch, mem);
+  mutex_.Lock();
+  w->insert_pending = false;
+  if (!s.ok() && memtable_insert_status_.ok()) {
+    memtable_insert_status_ = s;
+  }
+  if (--pending_memtable_inserts_ == 0) {
+    memtable_inserts_done_.Signal();
+  }
+}
+
 // REQUIRES: Writer list must be non-empty
 // REQUIRES: First writer must have a non-null batch
 WriteBatch* DBImpl::BuildBatchGroup(Writer** last_writer) {
@@ -1342,6 +1924,14 @@ Status DBImpl::MakeRoomForWrite(bool force) {
       // There are too many level-0 files.
       Log(options_.info_log, "Too many L0 files; waiting...\n");
       background_work_finished_signal_.Wait();
+    } else if (versions_->LastSequence() != last_allocated_sequence_) {
+      // Groups that are already logged still have to reach mem_.
+      memtable_turn_.Wait();
+    } else if (log_sync_in_progress_ ||
+               (durable_sequence_ < sync_requested_sequence_ &&
+                log_sync_status_.ok())) {
+      // The log sync thread still needs the current log.
+      log_synced_.Wait();
     } else {
       // Attempt to switch to a new memtable and trigger compaction of old
       assert(versions_->PrevLogNumber() == 0);
@@ -1360,7 +1950,7 @@ Status DBImpl::MakeRoomForWrite(bool force) {
       log_ = new log::Writer(lfile);
       imm_ = mem_;
       has_imm_.store(true, std::memory_order_release);
-      mem_ = new MemTable(internal_comparator_);
+      mem_ = NewMemTable();
       mem_->Ref();
       force = false;  // Do not force another compaction if have room
       MaybeScheduleCompaction();
@@ -1413,6 +2003,50 @@ bool DBImpl::GetProperty(const Slice& property, std::string* value) {
   } else if (in == "sstables") {
     *value = versions_->current()->DebugString();
     return true;
+  } else if (in.starts_with("table-properties")) {
+    in.remove_prefix(strlen("table-properties"));
+    int first_level = 0;
+    int last_level = config::kNumLevels - 1;
+    if (!in.empty()) {
+      uint64_t level;
+      if (!in.starts_with("-at-level")) return false;
+      in.remove_prefix(strlen("-at-level"));
+      bool ok = ConsumeDecimalNumber(&in, &level) && in.empty();
+      if (!ok || level >= config::kNumLevels) return false;
+      first_level = last_level = static_cast<int>(level);
+    }
+
+    // Reading the properties may open table files.
+    Version* v = versions_->current();
+    v->Ref();
+    mutex_.Unlock();
+    TableProperties total;
+    int missing = 0;
+    for (int level = first_level; level <= last_level; level++) {
+      missing += v->SumTableProperties(level, &total);
+    }
+    mutex_.Lock();
+    v->Unref();
+
+    const std::pair<const char*, uint64_t> rows[] = {
+        {"entries", total.num_entries},
+        {"data blocks", total.num_data_blocks},
+        {"restarts", total.num_restarts},
+        {"raw key bytes", total.raw_key_size},
+        {"prefix-compressed key bytes", total.prefix_compressed_key_size},
+        {"raw value bytes", total.raw_value_size},
+        {"data bytes", total.data_size},
+        {"index bytes", total.index_size},
+        {"filter bytes", total.filter_size},
+        {"files without properties", static_cast<uint64_t>(missing)},
+    };
+    char buf[100];
+    for (const auto& row : rows) {
+      snprintf(buf, sizeof(buf), "%s: %llu\n", row.first,
+               static_cast<unsigned long long>(row.second));
+      value->append(buf);
+    }
+    return true;
   } else if (in == "approximate-memory-usage") {
     size_t total_usage = options_.block_cache->TotalCharge();
     if (mem_) {
@@ -1469,6 +2103,19 @@ Status DB::Delete(const WriteOptions& opt, const Slice& key) {
   return Write(opt, &batch);
 }
 
+std::vector<Status> DB::MultiGet(const ReadOptions& options,
+                                 const std::vector<Slice>& keys,
+                                 std::vector<std::string>* values) {
+  values->clear();
+  values->resize(keys.size());
+  std::vector<Status> statuses;
+  statuses.reserve(keys.size());
+  for (size_t i = 0; i < keys.size(); i++) {
+    statuses.push_back(Get(options, keys[i], &(*values)[i]));
+  }
+  return statuses;
+}
+
 DB::~DB() {}
 
 Status DB::Open(const Options& options, const std::string& dbname, DB** dbptr) {
@@ -1491,7 +2138,7 @@ Status DB::Open(const Options& options, const std::string& dbname, DB** dbptr) {
       impl->logfile_ = lfile;
       impl->logfile_number_ = new_log_number;
       impl->log_ = new log::Writer(lfile);
-      impl->mem_ = new MemTable(impl->internal_comparator_);
+      impl->mem_ = impl->NewMemTable();
       impl->mem_->Ref();
     }
   }
@@ -1501,6 +2148,18 @@ Status DB::Open(const Options& options, const std::string& dbname, DB** dbptr) {
     s = impl->versions_->LogAndApply(&edit, &impl->mutex_);
   }
   if (s.ok()) {
+    impl->last_allocated_sequence_ = impl->versions_->LastSequence();
+    impl->logged_sequence_ = impl->last_allocated_sequence_;
+    impl->sync_requested_sequence_ = impl->last_allocated_sequence_;
+    impl->durable_sequence_ = impl->last_allocated_sequence_;
+    // The Env creates every log file alike, so probing the first one tells
+    // whether the later ones support SyncFlushed() too.
+    impl->background_log_sync_ =
+        options.background_log_sync && impl->logfile_->SyncFlushed().ok();
+    if (impl->background_log_sync_) {
+      impl->log_sync_thread_running_ = true;
+      options.env->StartThread(&DBImpl::LogSyncWork, impl);
+    }
     impl->DeleteObsoleteFiles();
     impl->MaybeScheduleCompaction();
   }
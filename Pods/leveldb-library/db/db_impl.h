@@ -9,6 +9,7 @@
 #include <deque>
 #include <set>
 #include <string>
+#include <vector>
 
 #include "db/dbformat.h"
 #include "db/log_writer.h"
@@ -41,6 +42,9 @@ class DBImpl : public DB {
   virtual Status Write(const WriteOptions& options, WriteBatch* updates);
   virtual Status Get(const ReadOptions& options, const Slice& key,
                      std::string* value);
+  virtual std::vector<Status> MultiGet(const ReadOptions& options,
+                                       const std::vector<Slice>& keys,
+                                       std::vector<std::string>* values);
   virtual Iterator* NewIterator(const ReadOptions&);
   virtual const Snapshot* GetSnapshot();
   virtual void ReleaseSnapshot(const Snapshot* snapshot);
@@ -73,6 +77,7 @@ class DBImpl : public DB {
  private:
   friend class DB;
   struct CompactionState;
+  struct Subcompaction;
   struct Writer;
 
   // Information for a manual compaction
@@ -122,6 +127,13 @@ class DBImpl : public DB {
   // Errors are recorded in bg_error_.
   void CompactMemTable() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Returns a new memtable with the arena settings of options_.
+  MemTable* NewMemTable() const;
+
+  // Writes the contents of mem_ to a level-0 table and waits until the
+  // table is installed.
+  Status FlushMemTable() LOCKS_EXCLUDED(mutex_);
+
   Status RecoverLogFile(uint64_t log_number, bool last_log, bool* save_manifest,
                         VersionEdit* edit, SequenceNumber* max_sequence)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -134,6 +146,23 @@ class DBImpl : public DB {
   WriteBatch* BuildBatchGroup(Writer** last_writer)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Inserts the batches of a logged group, whose leader is its first
+  // member, into mem_.  If concurrently is set, each writer of the group
+  // inserts its own batch and the leader waits until all of them are done.
+  Status InsertBatchGroup(const std::vector<Writer*>& group, bool concurrently)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Inserts the batch of a writer on behalf of its group's leader.
+  void InsertBatchForGroup(Writer* w) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Hands the sync of the log records up to sequence to the log sync
+  // thread and waits until they are durable.
+  Status AwaitLogSync(SequenceNumber sequence)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  static void LogSyncWork(void* db);
+  void LogSyncCall();
+
   void RecordBackgroundError(const Status& s);
 
   void MaybeScheduleCompaction() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
@@ -145,6 +174,15 @@ class DBImpl : public DB {
   Status DoCompactionWork(CompactionState* compact)
       EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Compacts the input of compact with user keys in [*begin, *end) into its
+  // outputs, where a null bound is open.  If compact_memtable is set, also
+  // compacts imm_ whenever it fills up, adding the time spent to
+  // *imm_micros.
+  Status DoSubcompactionWork(CompactionState* compact, const Slice* begin,
+                             const Slice* end, bool compact_memtable,
+                             int64_t* imm_micros) LOCKS_EXCLUDED(mutex_);
+  static void SubcompactionWork(void* arg);
+
   Status OpenCompactionOutputFile(CompactionState* compact);
   Status FinishCompactionOutputFile(CompactionState* compact, Iterator* input);
   Status InstallCompactionResults(CompactionState* compact)
@@ -185,6 +223,33 @@ class DBImpl : public DB {
   std::deque<Writer*> writers_ GUARDED_BY(mutex_);
   WriteBatch* tmp_batch_ GUARDED_BY(mutex_);
 
+  // The sequence number of the last write that has been logged.  It runs
+  // ahead of versions_->LastSequence() while pipelined writes still have to
+  // reach the memtable.
+  SequenceNumber last_allocated_sequence_ GUARDED_BY(mutex_);
+
+  // Signalled when a pipelined group has been applied to the memtable.
+  port::CondVar memtable_turn_ GUARDED_BY(mutex_);
+
+  // Progress of the memtable inserts of the current write group when
+  // options_.allow_concurrent_memtable_write is set.
+  int pending_memtable_inserts_ GUARDED_BY(mutex_);
+  Status memtable_insert_status_ GUARDED_BY(mutex_);
+  port::CondVar memtable_inserts_done_ GUARDED_BY(mutex_);
+
+  // State of the log sync thread when options_.background_log_sync is set.
+  // Sync writes raise sync_requested_sequence_ and wait for
+  // durable_sequence_ to reach it.
+  bool background_log_sync_ GUARDED_BY(mutex_);
+  bool log_sync_thread_running_ GUARDED_BY(mutex_);
+  bool log_sync_in_progress_ GUARDED_BY(mutex_);
+  SequenceNumber logged_sequence_ GUARDED_BY(mutex_);
+  SequenceNumber sync_requested_sequence_ GUARDED_BY(mutex_);
+  SequenceNumber durable_sequence_ GUARDED_BY(mutex_);
+  Status log_sync_status_ GUARDED_BY(mutex_);
+  port::CondVar log_sync_requested_ GUARDED_BY(mutex_);
+  port::CondVar log_synced_ GUARDED_BY(mutex_);
+
   SnapshotList snapshots_ GUARDED_BY(mutex_);
 
   // Set of table files to protect from deletion because they are
@@ -46,11 +46,12 @@ class DBIter : public Iterator {
   enum Direction { kForward, kReverse };
 
   DBIter(DBImpl* db, const Comparator* cmp, Iterator* iter, SequenceNumber s,
-         uint32_t seed)
+         uint32_t seed, const Slice* upper_bound)
       : db_(db),
         user_comparator_(cmp),
         iter_(iter),
         sequence_(s),
+        upper_bound_(upper_bound),
         direction_(kForward),
         valid_(false),
         rnd_(seed),
@@ -110,6 +111,7 @@ class DBIter : public Iterator {
   const Comparator* const user_comparator_;
   Iterator* const iter_;
   SequenceNumber const sequence_;
+  const Slice* const upper_bound_;
   Status status_;
   std::string saved_key_;    // == current key when direction_==kReverse
   std::string saved_value_;  // == current raw value when direction_==kReverse
@@ -171,7 +173,12 @@ void DBIter::FindNextUserEntry(bool skipping, std::string* skip) {
   assert(direction_ == kForward);
   do {
     ParsedInternalKey ikey;
-    if (ParseKey(&ikey) && ikey.sequence <= sequence_) {
+    if (!ParseKey(&ikey)) {
+      // Skip corrupted entries
+    } else if (upper_bound_ != nullptr &&
+               user_comparator_->Compare(ikey.user_key, *upper_bound_) >= 0) {
+      break;
+    } else if (ikey.sequence <= sequence_) {
       switch (ikey.type) {
         case kTypeDeletion:
           // Arrange to skip all upcoming entries for this key since
@@ -294,7 +301,21 @@ void DBIter::SeekToFirst() {
 void DBIter::SeekToLast() {
   direction_ = kReverse;
   ClearSavedValue();
-  iter_->SeekToLast();
+  if (upper_bound_ == nullptr) {
+    iter_->SeekToLast();
+  } else {
+    // Position iter_ at the last entry before the bound's user key.
+    saved_key_.clear();
+    AppendInternalKey(&saved_key_, ParsedInternalKey(*upper_bound_,
+                                                     kMaxSequenceNumber,
+                                                     kValueTypeForSeek));
+    iter_->Seek(saved_key_);
+    if (iter_->Valid()) {
+      iter_->Prev();
+    } else {
+      iter_->SeekToLast();
+    }
+  }
   FindPrevUserEntry();
 }
 
@@ -302,8 +323,9 @@ void DBIter::SeekToLast() {
 
 Iterator* NewDBIterator(DBImpl* db, const Comparator* user_key_comparator,
                         Iterator* internal_iter, SequenceNumber sequence,
-                        uint32_t seed) {
-  return new DBIter(db, user_key_comparator, internal_iter, sequence, seed);
+                        uint32_t seed, const Slice* upper_bound) {
+  return new DBIter(db, user_key_comparator, internal_iter, sequence, seed,
+                    upper_bound);
 }
 
 }  // namespace leveldb
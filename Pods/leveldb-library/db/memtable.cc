@@ -21,6 +21,13 @@ static Slice GetLengthPrefixedSlice(const char* data) {
 MemTable::MemTable(const InternalKeyComparator& comparator)
     : comparator_(comparator), refs_(0), table_(comparator_, &arena_) {}
 
+MemTable::MemTable(const InternalKeyComparator& comparator,
+                   size_t arena_block_size, size_t huge_page_size)
+    : comparator_(comparator),
+      refs_(0),
+      arena_(arena_block_size, huge_page_size),
+      table_(comparator_, &arena_) {}
+
 MemTable::~MemTable() { assert(refs_ == 0); }
 
 size_t MemTable::ApproximateMemoryUsage() { return arena_.MemoryUsage(); }
@@ -72,31 +79,45 @@ class MemTableIterator : public Iterator {
 
 Iterator* MemTable::NewIterator() { return new MemTableIterator(&table_); }
 
-void MemTable::Add(SequenceNumber s, ValueType type, const Slice& key,
-                   const Slice& value) {
-  // Format of an entry is concatenation of:
-  //  key_size     : varint32 of internal_key.size()
-  //  key bytes    : char[internal_key.size()]
-  //  value_size   : varint32 of value.size()
-  //  value bytes  : char[value.size()]
+// Format of an entry is concatenation of:
+//  key_size     : varint32 of internal_key.size()
+//  key bytes    : char[internal_key.size()]
+//  value_size   : varint32 of value.size()
+//  value bytes  : char[value.size()]
+static size_t EntryLength(const Slice& key, const Slice& value) {
+  size_t internal_key_size = key.size() + 8;
+  return VarintLength(internal_key_size) + internal_key_size +
+         VarintLength(value.size()) + value.size();
+}
+
+static void EncodeEntry(char* buf, SequenceNumber s, ValueType type,
+                        const Slice& key, const Slice& value) {
   size_t key_size = key.size();
   size_t val_size = value.size();
-  size_t internal_key_size = key_size + 8;
-  const size_t encoded_len = VarintLength(internal_key_size) +
-                             internal_key_size + VarintLength(val_size) +
-                             val_size;
-  char* buf = arena_.Allocate(encoded_len);
-  char* p = EncodeVarint32(buf, internal_key_size);
+  char* p = EncodeVarint32(buf, key_size + 8);
   memcpy(p, key.data(), key_size);
   p += key_size;
   EncodeFixed64(p, (s << 8) | type);
   p += 8;
   p = EncodeVarint32(p, val_size);
   memcpy(p, value.data(), val_size);
-  assert(p + val_size == buf + encoded_len);
+  assert(p + val_size == buf + EntryLength(key, value));
+}
+
+void MemTable::Add(SequenceNumber s, ValueType type, const Slice& key,
+                   const Slice& value) {
+  char* buf = arena_.Allocate(EntryLength(key, value));
+  EncodeEntry(buf, s, type, key, value);
   table_.Insert(buf);
 }
 
+void MemTable::AddConcurrently(SequenceNumber s, ValueType type,
+                               const Slice& key, const Slice& value) {
+  char* buf = arena_.AllocateConcurrently(EntryLength(key, value));
+  EncodeEntry(buf, s, type, key, value);
+  table_.InsertConcurrently(buf);
+}
+
 bool MemTable::Get(const LookupKey& key, std::string* value, Status* s) {
   Slice memkey = key.memtable_key();
   Table::Iterator iter(&table_);
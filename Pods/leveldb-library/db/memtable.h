@@ -23,6 +23,11 @@ class MemTable {
   // is zero and the caller must call Ref() at least once.
   explicit MemTable(const InternalKeyComparator& comparator);
 
+  // Allocates the entries from blocks of arena_block_size bytes, backed by
+  // huge pages of huge_page_size if that is non-zero.  See Arena.
+  MemTable(const InternalKeyComparator& comparator, size_t arena_block_size,
+           size_t huge_page_size);
+
   MemTable(const MemTable&) = delete;
   MemTable& operator=(const MemTable&) = delete;
 
@@ -56,6 +61,11 @@ class MemTable {
   void Add(SequenceNumber seq, ValueType type, const Slice& key,
            const Slice& value);
 
+  // Like Add(), but may be called from several threads at once, as long as
+  // no thread calls Add() at the same time.
+  void AddConcurrently(SequenceNumber seq, ValueType type, const Slice& key,
+                       const Slice& value);
+
   // If memtable contains a value for key, store it in *value and return true.
   // If memtable contains a deletion for key, store a NotFound() error
   // in *status and return true.
@@ -8,7 +8,8 @@
 // Thread safety
 // -------------
 //
-// Writes require external synchronization, most likely a mutex.
+// Writes require external synchronization, most likely a mutex, except
+// that InsertConcurrently() may be called from several threads at once.
 // Reads require a guarantee that the SkipList will not be destroyed
 // while the read is in progress.  Apart from that, reads progress
 // without any internal locking or synchronization.
@@ -56,6 +57,14 @@ class SkipList {
   // REQUIRES: nothing that compares equal to key is currently in the list.
   void Insert(const Key& key);
 
+  // Like Insert(), but may run concurrently with other calls to
+  // InsertConcurrently() on different keys.  Nodes are linked into each
+  // level with a compare-and-swap, bottom level first, retrying the level
+  // when another insert got there first.
+  // REQUIRES: nothing that compares equal to key is in the list, and no
+  // concurrent call to Insert().
+  void InsertConcurrently(const Key& key);
+
   // Returns true iff an entry that compares equal to key is in the list.
   bool Contains(const Key& key) const;
 
@@ -106,7 +115,9 @@ class SkipList {
   }
 
   Node* NewNode(const Key& key, int height);
+  Node* NewNodeConcurrently(const Key& key, int height);
   int RandomHeight();
+  int RandomHeightConcurrently();
   bool Equal(const Key& a, const Key& b) const { return (compare_(a, b) == 0); }
 
   // Return true if key is greater than the data stored in "n"
@@ -119,6 +130,11 @@ class SkipList {
   // node at "level" for every level in [0..max_height_-1].
   Node* FindGreaterOrEqual(const Key& key, Node** prev) const;
 
+  // Starting at "before", which must precede key, find the nodes at "level"
+  // between which key belongs.
+  void FindSpliceForLevel(const Key& key, Node* before, int level,
+                          Node** out_prev, Node** out_next) const;
+
   // Return the latest node with a key < key.
   // Return head_ if there is no such node.
   Node* FindLessThan(const Key& key) const;
@@ -139,6 +155,9 @@ class SkipList {
 
   // Read/written only by Insert().
   Random rnd_;
+
+  // Source of the heights picked by InsertConcurrently().
+  std::atomic<uint32_t> concurrent_seed_;
 };
 
 // Implementation details follow
@@ -173,6 +192,14 @@ struct SkipList<Key, Comparator>::Node {
     next_[n].store(x, std::memory_order_relaxed);
   }
 
+  // Link x in place of "expected", failing if the link has changed since.
+  bool CASNext(int n, Node* expected, Node* x) {
+    assert(n >= 0);
+    return next_[n].compare_exchange_strong(expected, x,
+                                            std::memory_order_release,
+                                            std::memory_order_relaxed);
+  }
+
  private:
   // Array of length equal to the node height.  next_[0] is lowest level link.
   std::atomic<Node*> next_[1];
@@ -186,6 +213,14 @@ typename SkipList<Key, Comparator>::Node* SkipList<Key, Comparator>::NewNode(
   return new (node_memory) Node(key);
 }
 
+template <typename Key, class Comparator>
+typename SkipList<Key, Comparator>::Node*
+SkipList<Key, Comparator>::NewNodeConcurrently(const Key& key, int height) {
+  char* const node_memory = arena_->AllocateAlignedConcurrently(
+      sizeof(Node) + sizeof(std::atomic<Node*>) * (height - 1));
+  return new (node_memory) Node(key);
+}
+
 template <typename Key, class Comparator>
 inline SkipList<Key, Comparator>::Iterator::Iterator(const SkipList* list) {
   list_ = list;
@@ -251,6 +286,25 @@ int SkipList<Key, Comparator>::RandomHeight() {
   return height;
 }
 
+template <typename Key, class Comparator>
+int SkipList<Key, Comparator>::RandomHeightConcurrently() {
+  // Same distribution as RandomHeight(), drawn from a finalized Weyl
+  // sequence so that concurrent inserts do not share generator state.
+  uint32_t r =
+      concurrent_seed_.fetch_add(0x9e3779b9, std::memory_order_relaxed);
+  r ^= r >> 16;
+  r *= 0x85ebca6b;
+  r ^= r >> 13;
+  r *= 0xc2b2ae35;
+  r ^= r >> 16;
+  int height = 1;
+  while (height < kMaxHeight && (r & 3) == 0) {
+    height++;
+    r >>= 2;
+  }
+  return height;
+}
+
 template <typename Key, class Comparator>
 bool SkipList<Key, Comparator>::KeyIsAfterNode(const Key& key, Node* n) const {
   // null n is considered infinite
@@ -327,7 +381,8 @@ SkipList<Key, Comparator>::SkipList(Comparator cmp, Arena* arena)
       arena_(arena),
       head_(NewNode(0 /* any key will do */, kMaxHeight)),
       max_height_(1),
-      rnd_(0xdeadbeef) {
+      rnd_(0xdeadbeef),
+      concurrent_seed_(0xdeadbeef) {
   for (int i = 0; i < kMaxHeight; i++) {
     head_->SetNext(i, nullptr);
   }
@@ -367,6 +422,69 @@ void SkipList<Key, Comparator>::Insert(const Key& key) {
   }
 }
 
+template <typename Key, class Comparator>
+void SkipList<Key, Comparator>::FindSpliceForLevel(const Key& key,
+                                                   Node* before, int level,
+                                                   Node** out_prev,
+                                                   Node** out_next) const {
+  Node* x = before;
+  while (true) {
+    Node* next = x->Next(level);
+    if (KeyIsAfterNode(key, next)) {
+      x = next;
+    } else {
+      *out_prev = x;
+      *out_next = next;
+      return;
+    }
+  }
+}
+
+template <typename Key, class Comparator>
+void SkipList<Key, Comparator>::InsertConcurrently(const Key& key) {
+  const int height = RandomHeightConcurrently();
+  int max_height = GetMaxHeight();
+  while (height > max_height &&
+         !max_height_.compare_exchange_weak(max_height, height,
+                                            std::memory_order_relaxed)) {
+  }
+  // Readers that see the raised height before the new levels are linked
+  // drop from head_ straight to a lower level, as in Insert().
+  if (height > max_height) {
+    max_height = height;
+  }
+
+  Node* prev[kMaxHeight];
+  Node* next[kMaxHeight];
+  Node* x = head_;
+  for (int level = max_height - 1; level >= 0; level--) {
+    Node* level_prev;
+    Node* level_next;
+    FindSpliceForLevel(key, x, level, &level_prev, &level_next);
+    if (level < height) {
+      prev[level] = level_prev;
+      next[level] = level_next;
+    }
+    x = level_prev;
+  }
+
+  // Our data structure does not allow duplicate insertion
+  assert(next[0] == nullptr || !Equal(key, next[0]->key));
+
+  Node* node = NewNodeConcurrently(key, height);
+  for (int i = 0; i < height; i++) {
+    while (true) {
+      node->NoBarrier_SetNext(i, next[i]);
+      if (prev[i]->CASNext(i, next[i], node)) {
+        break;
+      }
+      // Another insert linked a node after prev[i].  prev[i] still sorts
+      // before key, so resume the search at this level from there.
+      FindSpliceForLevel(key, prev[i], i, &prev[i], &next[i]);
+    }
+  }
+}
+
 template <typename Key, class Comparator>
 bool SkipList<Key, Comparator>::Contains(const Key& key) const {
   Node* x = FindGreaterOrEqual(key, nullptr);
@@ -111,6 +111,38 @@ Status TableCache::Get(const ReadOptions& options, uint64_t file_number,
   return s;
 }
 
+Status TableCache::MultiGet(const ReadOptions& options, uint64_t file_number,
+                            uint64_t file_size, const Slice* keys, size_t n,
+                            void* const* args,
+                            void (*handle_result)(void*, const Slice&,
+                                                  const Slice&)) {
+  Cache::Handle* handle = nullptr;
+  Status s = FindTable(file_number, file_size, &handle);
+  if (s.ok()) {
+    Table* t = reinterpret_cast<TableAndFile*>(cache_->Value(handle))->table;
+    s = t->InternalMultiGet(options, keys, n, args, handle_result);
+    cache_->Release(handle);
+  }
+  return s;
+}
+
+Status TableCache::GetProperties(uint64_t file_number, uint64_t file_size,
+                                 TableProperties* properties) {
+  Cache::Handle* handle = nullptr;
+  Status s = FindTable(file_number, file_size, &handle);
+  if (s.ok()) {
+    Table* t = reinterpret_cast<TableAndFile*>(cache_->Value(handle))->table;
+    const TableProperties* table_properties = t->GetProperties();
+    if (table_properties != nullptr) {
+      *properties = *table_properties;
+    } else {
+      s = Status::NotFound("table has no properties");
+    }
+    cache_->Release(handle);
+  }
+  return s;
+}
+
 void TableCache::Evict(uint64_t file_number) {
   char buf[sizeof(file_number)];
   EncodeFixed64(buf, file_number);
@@ -41,6 +41,19 @@ class TableCache {
              uint64_t file_size, const Slice& k, void* arg,
              void (*handle_result)(void*, const Slice&, const Slice&));
 
+  // Like Get() for each of keys[0,n-1], which must be sorted, calling
+  // (*handle_result)(args[i], ...) for keys[i].  The table is looked up once
+  // for all of them.
+  Status MultiGet(const ReadOptions& options, uint64_t file_number,
+                  uint64_t file_size, const Slice* keys, size_t n,
+                  void* const* args,
+                  void (*handle_result)(void*, const Slice&, const Slice&));
+
+  // Stores the properties of the specified file in *properties.  Returns
+  // NotFound if the file was built without them.
+  Status GetProperties(uint64_t file_number, uint64_t file_size,
+                       TableProperties* properties);
+
   // Evict any entry for the specified file number
   void Evict(uint64_t file_number);
 
@@ -165,16 +165,23 @@ class Version::LevelFileNumIterator : public Iterator {
  public:
   LevelFileNumIterator(const InternalKeyComparator& icmp,
                        const std::vector<FileMetaData*>* flist)
-      : icmp_(icmp), flist_(flist), index_(flist->size()) {  // Marks as invalid
-  }
-  virtual bool Valid() const { return index_ < flist_->size(); }
+      : LevelFileNumIterator(icmp, flist, flist->size()) {}
+  // Iterates over the first "num_files" files of "*flist" only.
+  LevelFileNumIterator(const InternalKeyComparator& icmp,
+                       const std::vector<FileMetaData*>* flist,
+                       size_t num_files)
+      : icmp_(icmp),
+        flist_(flist),
+        num_files_(num_files),
+        index_(num_files) {  // Marks as invalid
+    assert(num_files <= flist->size());
+  }
+  virtual bool Valid() const { return index_ < num_files_; }
   virtual void Seek(const Slice& target) {
-    index_ = FindFile(icmp_, *flist_, target);
+    index_ = std::min<size_t>(FindFile(icmp_, *flist_, target), num_files_);
   }
   virtual void SeekToFirst() { index_ = 0; }
-  virtual void SeekToLast() {
-    index_ = flist_->empty() ? 0 : flist_->size() - 1;
-  }
+  virtual void SeekToLast() { index_ = num_files_ == 0 ? 0 : num_files_ - 1; }
   virtual void Next() {
     assert(Valid());
     index_++;
@@ -182,7 +189,7 @@ class Version::LevelFileNumIterator : public Iterator {
   virtual void Prev() {
     assert(Valid());
     if (index_ == 0) {
-      index_ = flist_->size();  // Marks as invalid
+      index_ = num_files_;  // Marks as invalid
     } else {
       index_--;
     }
@@ -202,6 +209,7 @@ class Version::LevelFileNumIterator : public Iterator {
  private:
   const InternalKeyComparator icmp_;
   const std::vector<FileMetaData*>* const flist_;
+  const size_t num_files_;
   uint32_t index_;
 
   // Backing store for value().  Holds the file number and size.
@@ -221,30 +229,72 @@ static Iterator* GetFileIterator(void* arg, const ReadOptions& options,
 }
 
 Iterator* Version::NewConcatenatingIterator(const ReadOptions& options,
-                                            int level) const {
+                                            int level,
+                                            size_t num_files) const {
   return NewTwoLevelIterator(
-      new LevelFileNumIterator(vset_->icmp_, &files_[level]), &GetFileIterator,
-      vset_->table_cache_, options);
+      new LevelFileNumIterator(vset_->icmp_, &files_[level], num_files),
+      &GetFileIterator, vset_->table_cache_, options, &vset_->icmp_);
 }
 
 void Version::AddIterators(const ReadOptions& options,
                            std::vector<Iterator*>* iters) {
+  const InternalKeyComparator& icmp = vset_->icmp_;
+  const Slice* upper_bound = options.iterate_upper_bound;
+
   // Merge all level zero files together since they may overlap
   for (size_t i = 0; i < files_[0].size(); i++) {
-    iters->push_back(vset_->table_cache_->NewIterator(
-        options, files_[0][i]->number, files_[0][i]->file_size));
+    FileMetaData* f = files_[0][i];
+    if (upper_bound != nullptr &&
+        icmp.Compare(f->smallest.Encode(), *upper_bound) >= 0) {
+      continue;
+    }
+    iters->push_back(
+        vset_->table_cache_->NewIterator(options, f->number, f->file_size));
   }
 
   // For levels > 0, we can use a concatenating iterator that sequentially
   // walks through the non-overlapping files in the level, opening them
   // lazily.
   for (int level = 1; level < config::kNumLevels; level++) {
-    if (!files_[level].empty()) {
-      iters->push_back(NewConcatenatingIterator(options, level));
+    const std::vector<FileMetaData*>& files = files_[level];
+    size_t num_files = files.size();
+    if (upper_bound != nullptr) {
+      // The files of the level are sorted by their smallest keys as well.
+      num_files = std::lower_bound(files.begin(), files.end(), *upper_bound,
+                                   [&icmp](FileMetaData* f, const Slice& k) {
+                                     return icmp.Compare(f->smallest.Encode(),
+                                                         k) < 0;
+                                   }) -
+                  files.begin();
+    }
+    if (num_files > 0) {
+      iters->push_back(NewConcatenatingIterator(options, level, num_files));
     }
   }
 }
 
+int Version::SumTableProperties(int level, TableProperties* total) {
+  int missing = 0;
+  for (FileMetaData* f : files_[level]) {
+    TableProperties p;
+    if (!vset_->table_cache_->GetProperties(f->number, f->file_size, &p)
+             .ok()) {
+      missing++;
+      continue;
+    }
+    total->num_entries += p.num_entries;
+    total->num_data_blocks += p.num_data_blocks;
+    total->num_restarts += p.num_restarts;
+    total->raw_key_size += p.raw_key_size;
+    total->raw_value_size += p.raw_value_size;
+    total->prefix_compressed_key_size += p.prefix_compressed_key_size;
+    total->data_size += p.data_size;
+    total->index_size += p.index_size;
+    total->filter_size += p.filter_size;
+  }
+  return missing;
+}
+
 // Callback from TableCache::Get()
 namespace {
 enum SaverState {
@@ -420,6 +470,143 @@ Status Version::Get(const ReadOptions& options, const LookupKey& k,
   return Status::NotFound(Slice());  // Use an empty error message for speed
 }
 
+void Version::MultiGet(const ReadOptions& options,
+                       const std::vector<MultiGetRequest*>& requests) {
+  const Comparator* ucmp = vset_->icmp_.user_comparator();
+  std::vector<MultiGetRequest*> pending;  // Sorted by user key
+  pending.reserve(requests.size());
+  for (MultiGetRequest* r : requests) {
+    r->stats.seek_file = nullptr;
+    r->stats.seek_file_level = -1;
+    r->done = false;
+    r->last_file_read = nullptr;
+    r->last_file_read_level = -1;
+    pending.push_back(r);
+  }
+
+  // As in Get(), a key found in a level is not looked up in later levels.
+  std::vector<MultiGetRequest*> batch;
+  for (int level = 0; level < config::kNumLevels && !pending.empty();
+       level++) {
+    const std::vector<FileMetaData*>& files = files_[level];
+    if (files.empty()) continue;
+
+    if (level == 0) {
+      // Level-0 files may overlap each other.  Search them from newest to
+      // oldest, each for the keys that it may hold and were not found in
+      // a newer file.
+      std::vector<FileMetaData*> tmp(files);
+      std::sort(tmp.begin(), tmp.end(), NewestFirst);
+      for (FileMetaData* f : tmp) {
+        batch.clear();
+        for (MultiGetRequest* r : pending) {
+          Slice user_key = r->key->user_key();
+          if (!r->done &&
+              ucmp->Compare(user_key, f->smallest.user_key()) >= 0 &&
+              ucmp->Compare(user_key, f->largest.user_key()) <= 0) {
+            batch.push_back(r);
+          }
+        }
+        MultiGetFromFile(options, level, f, batch);
+      }
+    } else {
+      // The files of the level are sorted and disjoint, and so the keys
+      // that fall into a file are adjacent in "pending".
+      size_t i = 0;
+      while (i < pending.size()) {
+        uint32_t index =
+            FindFile(vset_->icmp_, files, pending[i]->key->internal_key());
+        if (index >= files.size()) {
+          break;  // All of the remaining keys are past the last file
+        }
+        FileMetaData* f = files[index];
+        batch.clear();
+        for (; i < pending.size() &&
+               vset_->icmp_.Compare(pending[i]->key->internal_key(),
+                                    f->largest.Encode()) <= 0;
+             i++) {
+          // Keys before the start of "f" fall into the gap ahead of it.
+          if (ucmp->Compare(pending[i]->key->user_key(),
+                            f->smallest.user_key()) >= 0) {
+            batch.push_back(pending[i]);
+          }
+        }
+        MultiGetFromFile(options, level, f, batch);
+      }
+    }
+
+    pending.erase(std::remove_if(pending.begin(), pending.end(),
+                                 [](MultiGetRequest* r) { return r->done; }),
+                  pending.end());
+  }
+
+  for (MultiGetRequest* r : pending) {
+    r->status = Status::NotFound(Slice());  // Use an empty error message
+  }
+}
+
+void Version::MultiGetFromFile(const ReadOptions& options, int level,
+                               FileMetaData* f,
+                               const std::vector<MultiGetRequest*>& batch) {
+  if (batch.empty()) {
+    return;
+  }
+
+  const Comparator* ucmp = vset_->icmp_.user_comparator();
+  std::vector<Saver> savers(batch.size());
+  std::vector<Slice> keys;
+  std::vector<void*> args;
+  keys.reserve(batch.size());
+  args.reserve(batch.size());
+  for (size_t i = 0; i < batch.size(); i++) {
+    MultiGetRequest* r = batch[i];
+    if (r->last_file_read != nullptr && r->stats.seek_file == nullptr) {
+      // We have had more than one seek for this read.  Charge the 1st file.
+      r->stats.seek_file = r->last_file_read;
+      r->stats.seek_file_level = r->last_file_read_level;
+    }
+    r->last_file_read = f;
+    r->last_file_read_level = level;
+
+    Saver& saver = savers[i];
+    saver.state = kNotFound;
+    saver.ucmp = ucmp;
+    saver.user_key = r->key->user_key();
+    saver.value = r->value;
+    keys.push_back(r->key->internal_key());
+    args.push_back(&saver);
+  }
+
+  Status s = vset_->table_cache_->MultiGet(options, f->number, f->file_size,
+                                           keys.data(), keys.size(),
+                                           args.data(), SaveValue);
+  for (size_t i = 0; i < batch.size(); i++) {
+    MultiGetRequest* r = batch[i];
+    if (!s.ok()) {
+      r->status = s;
+      r->done = true;
+      continue;
+    }
+    switch (savers[i].state) {
+      case kNotFound:
+        break;  // Keep searching in other files
+      case kFound:
+        r->status = Status::OK();
+        r->done = true;
+        break;
+      case kDeleted:
+        r->status = Status::NotFound(Slice());
+        r->done = true;
+        break;
+      case kCorrupt:
+        r->status =
+            Status::Corruption("corrupted key for ", r->key->user_key());
+        r->done = true;
+        break;
+    }
+  }
+}
+
 bool Version::UpdateStats(const GetStats& stats) {
   FileMetaData* f = stats.seek_file;
   if (f != nullptr) {
@@ -1497,12 +1684,12 @@ Compaction* VersionSet::CompactRange(int level, const InternalKey* begin,
 Compaction::Compaction(const Options* options, int level)
     : level_(level),
       max_output_file_size_(MaxFileSizeForLevel(options, level)),
-      input_version_(nullptr),
-      grandparent_index_(0),
-      seen_key_(false),
-      overlapped_bytes_(0) {
+      input_version_(nullptr) {}
+
+Compaction::Progress::Progress()
+    : grandparent_index(0), seen_key(false), overlapped_bytes(0) {
   for (int i = 0; i < config::kNumLevels; i++) {
-    level_ptrs_[i] = 0;
+    level_ptrs[i] = 0;
   }
 }
 
@@ -1530,13 +1717,15 @@ void Compaction::AddInputDeletions(VersionEdit* edit) {
   }
 }
 
-bool Compaction::IsBaseLevelForKey(const Slice& user_key) {
+bool Compaction::IsBaseLevelForKey(const Slice& user_key,
+                                   Progress* progress) const {
   // Maybe use binary search to find right entry instead of linear search?
   const Comparator* user_cmp = input_version_->vset_->icmp_.user_comparator();
+  size_t* level_ptrs = progress->level_ptrs;
   for (int lvl = level_ + 2; lvl < config::kNumLevels; lvl++) {
     const std::vector<FileMetaData*>& files = input_version_->files_[lvl];
-    for (; level_ptrs_[lvl] < files.size();) {
-      FileMetaData* f = files[level_ptrs_[lvl]];
+    for (; level_ptrs[lvl] < files.size();) {
+      FileMetaData* f = files[level_ptrs[lvl]];
       if (user_cmp->Compare(user_key, f->largest.user_key()) <= 0) {
         // We've advanced far enough
         if (user_cmp->Compare(user_key, f->smallest.user_key()) >= 0) {
@@ -1545,36 +1734,81 @@ bool Compaction::IsBaseLevelForKey(const Slice& user_key) {
         }
         break;
       }
-      level_ptrs_[lvl]++;
+      level_ptrs[lvl]++;
     }
   }
   return true;
 }
 
-bool Compaction::ShouldStopBefore(const Slice& internal_key) {
+bool Compaction::ShouldStopBefore(const Slice& internal_key,
+                                  Progress* progress) const {
   const VersionSet* vset = input_version_->vset_;
   // Scan to find earliest grandparent file that contains key.
   const InternalKeyComparator* icmp = &vset->icmp_;
-  while (grandparent_index_ < grandparents_.size() &&
-         icmp->Compare(internal_key,
-                       grandparents_[grandparent_index_]->largest.Encode()) >
+  while (progress->grandparent_index < grandparents_.size() &&
+         icmp->Compare(
+             internal_key,
+             grandparents_[progress->grandparent_index]->largest.Encode()) >
              0) {
-    if (seen_key_) {
-      overlapped_bytes_ += grandparents_[grandparent_index_]->file_size;
+    if (progress->seen_key) {
+      progress->overlapped_bytes +=
+          grandparents_[progress->grandparent_index]->file_size;
     }
-    grandparent_index_++;
+    progress->grandparent_index++;
   }
-  seen_key_ = true;
+  progress->seen_key = true;
 
-  if (overlapped_bytes_ > MaxGrandParentOverlapBytes(vset->options_)) {
+  if (progress->overlapped_bytes >
+      MaxGrandParentOverlapBytes(vset->options_)) {
     // Too much overlap for current output; start new output
-    overlapped_bytes_ = 0;
+    progress->overlapped_bytes = 0;
     return true;
   } else {
     return false;
   }
 }
 
+void Compaction::GetSubcompactionBoundaries(
+    int max_parts, std::vector<std::string>* boundaries) const {
+  boundaries->clear();
+  if (max_parts <= 1) {
+    return;
+  }
+
+  // Cut the key space at the largest keys of the input files, once the
+  // files before a cut hold the next share of the input bytes.
+  const Comparator* user_cmp = input_version_->vset_->icmp_.user_comparator();
+  std::vector<FileMetaData*> files(inputs_[0]);
+  files.insert(files.end(), inputs_[1].begin(), inputs_[1].end());
+  std::sort(files.begin(), files.end(),
+            [user_cmp](FileMetaData* a, FileMetaData* b) {
+              return user_cmp->Compare(a->largest.user_key(),
+                                       b->largest.user_key()) < 0;
+            });
+  uint64_t total_bytes = 0;
+  for (FileMetaData* f : files) {
+    total_bytes += f->file_size;
+  }
+
+  uint64_t bytes = 0;
+  for (size_t i = 0; i + 1 < files.size(); i++) {
+    bytes += files[i]->file_size;
+    const uint64_t next_share =
+        total_bytes * (boundaries->size() + 1) / max_parts;
+    if (bytes < next_share) {
+      continue;
+    }
+    Slice key = files[i]->largest.user_key();
+    if (boundaries->empty() ||
+        user_cmp->Compare(key, Slice(boundaries->back())) > 0) {
+      boundaries->push_back(key.ToString());
+      if (boundaries->size() + 1 == static_cast<size_t>(max_parts)) {
+        break;
+      }
+    }
+  }
+}
+
 void Compaction::ReleaseInputs() {
   if (input_version_ != nullptr) {
     input_version_->Unref();
@@ -35,6 +35,7 @@ class Iterator;
 class MemTable;
 class TableBuilder;
 class TableCache;
+struct TableProperties;
 class Version;
 class VersionSet;
 class WritableFile;
@@ -68,13 +69,39 @@ class Version {
   };
 
   // Append to *iters a sequence of iterators that will
-  // yield the contents of this Version when merged together.
+  // yield the contents of this Version when merged together.  If
+  // options.iterate_upper_bound is set, it is an internal key, and the
+  // files that start at or past it are left out.
   // REQUIRES: This version has been saved (see VersionSet::SaveTo)
   void AddIterators(const ReadOptions&, std::vector<Iterator*>* iters);
 
   Status Get(const ReadOptions&, const LookupKey& key, std::string* val,
              GetStats* stats);
 
+  // One of the keys looked up by MultiGet().  "key" and "value" are set by
+  // the caller; MultiGet() fills in "status", "stats" and, if the key was
+  // found, *value.
+  struct MultiGetRequest {
+    const LookupKey* key = nullptr;
+    std::string* value = nullptr;
+    Status status;
+    GetStats stats;
+
+   private:
+    friend class Version;
+
+    bool done;
+    FileMetaData* last_file_read;
+    int last_file_read_level;
+  };
+
+  // Does what Get() does for each of "requests", but looks up each table
+  // file only once for all the keys that may be in it.
+  // REQUIRES: "requests" are sorted by user key
+  // REQUIRES: lock is not held
+  void MultiGet(const ReadOptions&,
+                const std::vector<MultiGetRequest*>& requests);
+
   // Adds "stats" into the current state.  Returns true if a new
   // compaction may need to be triggered, false otherwise.
   // REQUIRES: lock is held
@@ -111,6 +138,11 @@ class Version {
 
   int NumFiles(int level) const { return files_[level].size(); }
 
+  // Adds the properties of the table files of "level" to *total.  Returns
+  // the number of files whose properties could not be read.
+  // REQUIRES: lock is not held
+  int SumTableProperties(int level, TableProperties* total);
+
   // Return a human readable string that describes this version's contents.
   std::string DebugString() const;
 
@@ -135,7 +167,15 @@ class Version {
 
   ~Version();
 
-  Iterator* NewConcatenatingIterator(const ReadOptions&, int level) const;
+  // Returns an iterator over the first "num_files" files of "level".
+  Iterator* NewConcatenatingIterator(const ReadOptions&, int level,
+                                     size_t num_files) const;
+
+  // Looks up the keys of "batch", which are sorted and not done yet, in
+  // file "f" of "level" for MultiGet().
+  void MultiGetFromFile(const ReadOptions& options, int level,
+                        FileMetaData* f,
+                        const std::vector<MultiGetRequest*>& batch);
 
   // Call func(arg, level, f) for every file that overlaps user_key in
   // order from newest to oldest.  If an invocation of func returns
@@ -318,6 +358,28 @@ class VersionSet {
 // A Compaction encapsulates information about a compaction.
 class Compaction {
  public:
+  // The position of one pass over the input of a compaction, as tracked by
+  // IsBaseLevelForKey() and ShouldStopBefore().  Subcompactions each make a
+  // pass over their own part of the key space.
+  struct Progress {
+    Progress();
+
+    // State used to check for number of overlapping grandparent files
+    // (parent == level_ + 1, grandparent == level_ + 2)
+    size_t grandparent_index;  // Index in grandparent_starts_
+    bool seen_key;             // Some output key has been seen
+    int64_t overlapped_bytes;  // Bytes of overlap between current output
+                               // and grandparent files
+
+    // State for implementing IsBaseLevelForKey
+
+    // level_ptrs holds indices into input_version_->levels_: our state
+    // is that we are positioned at one of the file ranges for each
+    // higher level than the ones involved in this compaction (i.e. for
+    // all L >= level_ + 2).
+    size_t level_ptrs[config::kNumLevels];
+  };
+
   ~Compaction();
 
   // Return the level that is being compacted.  Inputs from "level"
@@ -347,11 +409,19 @@ class Compaction {
   // Returns true if the information we have available guarantees that
   // the compaction is producing data in "level+1" for which no data exists
   // in levels greater than "level+1".
-  bool IsBaseLevelForKey(const Slice& user_key);
+  // REQUIRES: the keys passed with the same progress are increasing.
+  bool IsBaseLevelForKey(const Slice& user_key, Progress* progress) const;
 
   // Returns true iff we should stop building the current output
   // before processing "internal_key".
-  bool ShouldStopBefore(const Slice& internal_key);
+  bool ShouldStopBefore(const Slice& internal_key, Progress* progress) const;
+
+  // Splits the key space of the compaction into at most "max_parts" ranges
+  // of about the same amount of input, for subcompactions.  Stores the user
+  // keys where the second and later ranges start in *boundaries; each range
+  // ends before the start of the next one.
+  void GetSubcompactionBoundaries(int max_parts,
+                                  std::vector<std::string>* boundaries) const;
 
   // Release the input version for the compaction, once the compaction
   // is successful.
@@ -371,21 +441,9 @@ class Compaction {
   // Each compaction reads inputs from "level_" and "level_+1"
   std::vector<FileMetaData*> inputs_[2];  // The two sets of inputs
 
-  // State used to check for number of overlapping grandparent files
-  // (parent == level_ + 1, grandparent == level_ + 2)
+  // The grandparent files overlapping the compaction, used to check for
+  // number of overlapping grandparent files
   std::vector<FileMetaData*> grandparents_;
-  size_t grandparent_index_;  // Index in grandparent_starts_
-  bool seen_key_;             // Some output key has been seen
-  int64_t overlapped_bytes_;  // Bytes of overlap between current output
-                              // and grandparent files
-
-  // State for implementing IsBaseLevelForKey
-
-  // level_ptrs_ holds indices into input_version_->levels_: our state
-  // is that we are positioned at one of the file ranges for each
-  // higher level than the ones involved in this compaction (i.e. for
-  // all L >= level_ + 2).
-  size_t level_ptrs_[config::kNumLevels];
 };
 
 }  // namespace leveldb
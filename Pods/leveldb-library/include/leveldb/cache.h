@@ -31,6 +31,26 @@ class LEVELDB_EXPORT Cache;
 // of Cache uses a least-recently-used eviction policy.
 LEVELDB_EXPORT Cache* NewLRUCache(size_t capacity);
 
+// Like NewLRUCache(capacity), with 2^num_shard_bits shards of their own lock
+// and LRU order, 16 by default.  If "scan_resistant" is true, entries start
+// in a probationary segment that is evicted first and move to the protected
+// segment, which holds up to 80% of the capacity, once they are looked up.
+// A large scan then evicts its own entries instead of the working set.
+LEVELDB_EXPORT Cache* NewLRUCache(size_t capacity, int num_shard_bits,
+                                  bool scan_resistant);
+
+// Create a new cache with a fixed size capacity.  This implementation
+// of Cache uses CLOCK (second-chance) eviction and looks up and releases
+// entries without taking a lock, which suits many concurrent readers.
+// Inserts and erases lock one of 2^num_shard_bits shards.
+//
+// Each shard has a fixed number of slots, sized for entries charged
+// estimated_entry_charge on average (by default the default block size);
+// a shard evicts entries once its slots fill up even if it has capacity
+// left.
+LEVELDB_EXPORT Cache* NewClockCache(size_t capacity, int num_shard_bits = 4,
+                                    size_t estimated_entry_charge = 4096);
+
 class LEVELDB_EXPORT Cache {
  public:
   Cache() = default;
@@ -45,6 +65,16 @@ class LEVELDB_EXPORT Cache {
   // Opaque handle to an entry stored in the cache.
   struct Handle {};
 
+  // A hint to the eviction policy about how likely an entry is to be used
+  // again.
+  enum class Priority {
+    kHigh,
+    // Entries filled by scans.  The builtin caches evict them before other
+    // entries unless they are looked up again; the CLOCK cache does not admit
+    // them at all if that would evict an entry that was used recently.
+    kLow,
+  };
+
   // Insert a mapping from key->value into the cache and assign it
   // the specified charge against the total cache capacity.
   //
@@ -57,6 +87,14 @@ class LEVELDB_EXPORT Cache {
   virtual Handle* Insert(const Slice& key, void* value, size_t charge,
                          void (*deleter)(const Slice& key, void* value)) = 0;
 
+  // Like Insert() above, with a hint of the entry's priority.  The default
+  // implementation ignores the hint.
+  virtual Handle* Insert(const Slice& key, void* value, size_t charge,
+                         void (*deleter)(const Slice& key, void* value),
+                         Priority priority) {
+    return Insert(key, value, charge, deleter);
+  }
+
   // If the cache has no mapping for "key", returns nullptr.
   //
   // Else return a handle that corresponds to the mapping.  The caller
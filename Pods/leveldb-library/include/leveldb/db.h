@@ -8,6 +8,9 @@
 #include <stdint.h>
 #include <stdio.h>
 
+#include <string>
+#include <vector>
+
 #include "leveldb/export.h"
 #include "leveldb/iterator.h"
 #include "leveldb/options.h"
@@ -87,6 +90,17 @@ class LEVELDB_EXPORT DB {
   virtual Status Get(const ReadOptions& options, const Slice& key,
                      std::string* value) = 0;
 
+  // Looks up all of "keys" as if by Get(), from the same state of the
+  // database.  Returns the status of each lookup and resizes *values to
+  // hold the value of each key, in the order of "keys".  Values of keys
+  // whose status is not OK are empty.
+  //
+  // Faster than calling Get() for each key: the keys are sorted and each
+  // table file is searched once for all the keys that may be in it.
+  virtual std::vector<Status> MultiGet(const ReadOptions& options,
+                                       const std::vector<Slice>& keys,
+                                       std::vector<std::string>* values);
+
   // Return a heap-allocated iterator over the contents of the database.
   // The result of NewIterator() is initially invalid (caller must
   // call one of the Seek methods on the iterator before using it).
@@ -121,6 +135,11 @@ class LEVELDB_EXPORT DB {
   //     of the sstables that make up the db contents.
   //  "leveldb.approximate-memory-usage" - returns the approximate number of
   //     bytes of memory in use by the DB.
+  //  "leveldb.table-properties" - returns a multi-line string with the sums
+  //     of the table properties (see TableProperties) of all table files,
+  //     e.g. how well their keys compress.
+  //  "leveldb.table-properties-at-level<N>" - the same for the table files
+  //     at level <N>.
   virtual bool GetProperty(const Slice& property, std::string* value) = 0;
 
   // For each i in [0,n-1], store in "sizes[i]", the approximate
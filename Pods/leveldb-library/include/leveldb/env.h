@@ -52,6 +52,33 @@ class SequentialFile;
 class Slice;
 class WritableFile;
 
+// Hints about how a file will be read, which the default Env passes on to
+// the operating system.
+enum class FileAccessHint { kNormal, kRandom, kSequential };
+
+// How the default Env reads files.  See ConfigureDefaultEnv().
+struct LEVELDB_EXPORT DefaultEnvOptions {
+  // The maximum number of files opened for random access, that is table
+  // files, that are mapped into memory at a time.  The others are read
+  // with pread().  If negative, the platform default is used: 1000 for
+  // 64-bit binaries and none for 32-bit ones.
+  int mmap_limit = -1;
+
+  // The hint for files opened for random access.  kRandom suits databases
+  // that are mostly read by point lookups, as it stops the OS from reading
+  // ahead of each of them; scans can still ask for readahead through
+  // ReadOptions::readahead_size.
+  FileAccessHint random_access_file_hint = FileAccessHint::kNormal;
+
+  // The hint for files opened for sequential reads, that is the log and
+  // manifest files read on recovery.
+  FileAccessHint sequential_file_hint = FileAccessHint::kNormal;
+};
+
+// Configures the Env returned by Env::Default().
+// REQUIRES: Env::Default() has not been called yet.
+LEVELDB_EXPORT void ConfigureDefaultEnv(const DefaultEnvOptions& options);
+
 class LEVELDB_EXPORT Env {
  public:
   Env() = default;
@@ -240,6 +267,13 @@ class LEVELDB_EXPORT RandomAccessFile {
   // Safe for concurrent use by multiple threads.
   virtual Status Read(uint64_t offset, size_t n, Slice* result,
                       char* scratch) const = 0;
+
+  // Hint that "n" bytes starting at "offset" will be read soon, so that
+  // they can be read ahead asynchronously.  The default implementation
+  // does nothing.
+  //
+  // Safe for concurrent use by multiple threads.
+  virtual void Readahead(uint64_t offset, size_t n) const;
 };
 
 // A file abstraction for sequential writing.  The implementation
@@ -258,6 +292,13 @@ class LEVELDB_EXPORT WritableFile {
   virtual Status Close() = 0;
   virtual Status Flush() = 0;
   virtual Status Sync() = 0;
+
+  // Makes the data passed to the file before its last Flush() durable.
+  // Unlike the other methods, may be called concurrently with Append() and
+  // Flush() from another thread.
+  //
+  // The default implementation returns NotSupported.
+  virtual Status SyncFlushed();
 };
 
 // An interface for writing log messages.
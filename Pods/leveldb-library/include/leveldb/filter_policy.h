@@ -49,6 +49,35 @@ class LEVELDB_EXPORT FilterPolicy {
   // This method may return true or false if the key was not on the
   // list, but it should aim to return false with a high probability.
   virtual bool KeyMayMatch(const Slice& key, const Slice& filter) const = 0;
+
+  // "filter" contains the data appended by a preceding call to
+  // CreateFilter() on this class.  This method must return true if one of
+  // the keys passed to CreateFilter() shares the prefix of "key", for
+  // policies that filter on prefixes (see NewPrefixBloomFilterPolicy()).
+  // The default implementation always returns true.
+  virtual bool PrefixMayMatch(const Slice& key, const Slice& filter) const {
+    return true;
+  }
+};
+
+// Extracts the prefixes of keys that prefix filters summarize.
+//
+// Keys that share a prefix must be adjacent in the order of the comparator,
+// as they are for a bytewise comparator and a prefix made of leading bytes.
+class LEVELDB_EXPORT PrefixExtractor {
+ public:
+  virtual ~PrefixExtractor();
+
+  // Return the name of this extractor.  Filters built with a different
+  // extractor are not consulted.
+  virtual const char* Name() const = 0;
+
+  // Return whether "key" has a prefix.
+  virtual bool InDomain(const Slice& key) const = 0;
+
+  // Return the prefix of "key".
+  // REQUIRES: InDomain(key)
+  virtual Slice Transform(const Slice& key) const = 0;
 };
 
 // Return a new filter policy that uses a bloom filter with approximately
@@ -67,6 +96,35 @@ class LEVELDB_EXPORT FilterPolicy {
 // trailing spaces in keys.
 LEVELDB_EXPORT const FilterPolicy* NewBloomFilterPolicy(int bits_per_key);
 
+// Return a new filter policy that uses a bloom filter split into blocks of
+// one cache line, with approximately the specified number of bits per key.
+// All the probes of a key fall into one block, so that a lookup costs a
+// single cache miss, at a false positive rate close to that of
+// NewBloomFilterPolicy() with the same bits_per_key.
+//
+// The filters have a format of their own, versioned in the name of the
+// policy, so switching a database to this policy ignores the existing
+// filters until compactions rewrite them.  The caveats of
+// NewBloomFilterPolicy() apply.
+LEVELDB_EXPORT const FilterPolicy* NewBlockedBloomFilterPolicy(
+    int bits_per_key);
+
+// Return a new filter policy that uses a bloom filter with approximately
+// the specified number of bits per entry, whose entries are the prefixes
+// that "extractor" finds in the keys and, if "whole_key_filtering" is true,
+// the keys themselves.
+//
+// Iterators that read with ReadOptions::prefix_seek skip the tables whose
+// filters rule out the prefix of a Seek() target.  DB::Get() checks the
+// whole key, or its prefix if "whole_key_filtering" is false.
+//
+// Callers must delete the result, and keep "extractor" alive, until after
+// any database that is using the result has been closed.  The same caveat
+// about comparators as for NewBloomFilterPolicy() applies.
+LEVELDB_EXPORT const FilterPolicy* NewPrefixBloomFilterPolicy(
+    int bits_per_key, const PrefixExtractor* extractor,
+    bool whole_key_filtering);
+
 }  // namespace leveldb
 
 #endif  // STORAGE_LEVELDB_INCLUDE_FILTER_POLICY_H_
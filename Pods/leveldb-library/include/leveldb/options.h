@@ -7,6 +7,9 @@
 
 #include <stddef.h>
 
+#include <string>
+#include <vector>
+
 #include "leveldb/export.h"
 
 namespace leveldb {
@@ -16,6 +19,8 @@ class Comparator;
 class Env;
 class FilterPolicy;
 class Logger;
+class RateLimiter;
+class Slice;
 class Snapshot;
 
 // DB contents are stored in a set of blocks, each of which holds a
@@ -26,7 +31,8 @@ enum CompressionType {
   // NOTE: do not change the values of existing entries, as these are
   // part of the persistent format on disk.
   kNoCompression = 0x0,
-  kSnappyCompression = 0x1
+  kSnappyCompression = 0x1,
+  kZstdCompression = 0x2,
 };
 
 // Options to control the behavior of a database (passed to DB::Open)
@@ -81,6 +87,22 @@ struct LEVELDB_EXPORT Options {
   // the next time the database is opened.
   size_t write_buffer_size = 4 * 1024 * 1024;
 
+  // Size of the blocks that the memtable allocates its entries from.
+  // Larger blocks mean fewer allocations, while smaller ones waste less
+  // memory at the end of each block.  Zero picks 1/64 of
+  // write_buffer_size.
+  //
+  // Default: 0
+  size_t arena_block_size = 0;
+
+  // If non-zero, the memtable blocks are rounded up to a multiple of this
+  // size and backed by huge pages of it, on platforms that support them and
+  // have huge pages reserved, e.g. 2MB on Linux; other platforms use
+  // regular memory.  This saves TLB misses with large write buffers.
+  //
+  // Default: 0
+  size_t memtable_huge_page_size = 0;
+
   // Number of open files that can be used by the DB.  You may need to
   // increase this if your database has a large working set (budget
   // one open file per 2MB of working set).
@@ -104,6 +126,50 @@ struct LEVELDB_EXPORT Options {
   // leave this parameter alone.
   int block_restart_interval = 16;
 
+  // If true, data blocks place their restart points by how much each key
+  // shares with the key before it, instead of every block_restart_interval
+  // keys: a restart comes early before a key that shares little, and comes
+  // up to twice as late while keys share most of their bytes.  This suits
+  // long keys with long common prefixes.
+  //
+  // Default: false
+  bool adaptive_block_restarts = false;
+
+  // If true, each data block gets a hash index from the user keys in it to
+  // their restart points, so that point lookups go straight to the restart
+  // point of their key instead of binary searching the restart array.  The
+  // index costs about two bytes per distinct key.  Blocks with more than 254
+  // restart points are written without it.  Only meaningful for tables
+  // written by a DB, whose keys are internal keys.
+  //
+  // Tables written with the index can not be read by versions of leveldb
+  // that predate it; tables written without it read as before.  This
+  // parameter can be changed dynamically.
+  //
+  // Default: false
+  bool data_block_hash_index = false;
+
+  // If true, the index of each table is split into partitions of about
+  // "block_size" bytes, and so are its filters, under a small top-level
+  // index.  Only the top level is kept in memory for each open table; the
+  // partitions are read on demand through "block_cache", where they take
+  // the place of data blocks once they are not used.  This bounds the
+  // memory of large databases to the size of the cache, at the price of an
+  // extra cache lookup per read.
+  //
+  // Tables written with this option can not be read by versions of leveldb
+  // that predate it; tables written without it read as before.
+  //
+  // Default: false
+  bool partition_index_and_filters = false;
+
+  // If false, the top-level index and filter index of tables with
+  // partitioned index and filters are read through "block_cache" as well,
+  // instead of being held for as long as the table is open.
+  //
+  // Default: true
+  bool pin_top_level_index_and_filter = true;
+
   // Leveldb will write up to this amount of bytes to a file before
   // switching to a new one.
   // Most clients should leave this parameter alone.  However if your
@@ -130,16 +196,87 @@ struct LEVELDB_EXPORT Options {
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = kSnappyCompression;
 
+  // If non-empty, the compression of the table files compacted into level
+  // i, overriding "compression": entry i, or the last entry for levels past
+  // the end.  Memtable flushes use entry 0, and files moved to another
+  // level unchanged keep their compression.  Cheap compression for the
+  // small, often rewritten upper levels and strong compression for the
+  // large lower levels usually gives the best size for the CPU spent.
+  std::vector<CompressionType> compression_per_level;
+
+  // Compression level for kZstdCompression, from 1 (fastest) to 22.
+  //
+  // Default: 1
+  int zstd_compression_level = 1;
+
+  // If non-null, kZstdCompression primes the compression of each data
+  // block with this dictionary, for example one trained with
+  // "zstd --train" on samples of the values the database stores.  Small
+  // blocks of similar values then compress far better.  The dictionary is
+  // stored in each table file that used it, so tables stay readable after
+  // it changes.  It must remain live while the database is open.
+  const std::string* compression_dictionary = nullptr;
+
   // EXPERIMENTAL: If true, append to existing MANIFEST and log files
   // when a database is opened.  This can significantly speed up open.
   //
   // Default: currently false, but may become true later.
   bool reuse_logs = false;
 
+  // If true, closing the database writes the memtable to a table file, so
+  // that the next open has no log records to replay and opens faster.
+  // Closing takes longer instead.
+  //
+  // Default: false
+  bool flush_memtable_on_close = false;
+
   // If non-null, use the specified filter policy to reduce disk reads.
   // Many applications will benefit from passing the result of
   // NewBloomFilterPolicy() here.
   const FilterPolicy* filter_policy = nullptr;
+
+  // If true, the writers whose batches are logged together as a group each
+  // insert their own batch into the memtable, in parallel, instead of the
+  // first writer of the group inserting all of them.  This shortens the time
+  // a group holds up the writers queued behind it when several threads write
+  // at once.
+  //
+  // Default: false
+  bool allow_concurrent_memtable_write = false;
+
+  // If true, a write group hands the log over to the next group as soon as
+  // its record is appended, and is applied to the memtable while the next
+  // group is being logged.  Groups still become visible to reads in the
+  // order of their sequence numbers.  This lowers write latency under
+  // sustained load.
+  //
+  // Default: false
+  bool enable_pipelined_write = false;
+
+  // If true, the log file is synced by a background thread instead of by
+  // the writer of each sync write.  Sync writes that arrive while a sync is
+  // in progress are made durable together by the next one, so that many
+  // concurrent sync writers share each fsync and the log stays available to
+  // the writers behind them.  A sync write still returns only once it is
+  // durable, but may become visible to reads shortly before that.
+  //
+  // Has no effect if the Env's log files do not support SyncFlushed().
+  //
+  // Default: false
+  bool background_log_sync = false;
+
+  // The number of threads a compaction may use.  Compactions of more input
+  // files are split into up to this many ranges of the key space, which are
+  // compacted in parallel into separate output files.  Raising this speeds
+  // up large level-0 compactions, and so shortens write stalls on bulk loads.
+  //
+  // Default: 1
+  int max_subcompactions = 1;
+
+  // If non-null, the writes of the table files built by memtable flushes
+  // and compactions go through this rate limiter, flushes first.  This keeps
+  // background work from starving foreground reads on slow storage.
+  RateLimiter* rate_limiter = nullptr;
 };
 
 // Options that control read operations
@@ -154,6 +291,35 @@ struct LEVELDB_EXPORT ReadOptions {
   // Callers may wish to set this field to false for bulk scans.
   bool fill_cache = true;
 
+  // Should the blocks this read adds to the cache be evicted before other
+  // blocks unless they are read again?  Callers may wish to set this field
+  // to true for scans that should not flush the blocks of point lookups
+  // from the cache.  Has no effect unless fill_cache is true.
+  bool fill_cache_low_priority = false;
+
+  // If true, the caller only cares about the keys that share the prefix of
+  // the target of each Seek(), as defined by the PrefixExtractor of the
+  // filter policy, and stops iterating once it sees another prefix.  Tables
+  // whose filters rule out that prefix are then skipped without reading
+  // their data blocks, so keys of later prefixes may be missing.  Has no
+  // effect unless the filter policy filters on prefixes.
+  bool prefix_seek = false;
+
+  // If non-zero, iterators read table files ahead of their position in
+  // windows of this many bytes, so that long sequential scans read from
+  // storage in large asynchronous reads rather than one block at a time.
+  // Point lookups should leave this at zero.
+  size_t readahead_size = 0;
+
+  // If non-null, iterators stop before the first key that is at or past
+  // "*iterate_upper_bound", and neither yield nor read the keys from there
+  // on: Next() leaves them invalid and SeekToLast() positions them at the
+  // last key before the bound.  Scans over a range should set this to the
+  // end of the range so that they do not read the blocks and tables that
+  // follow it.  For a DB the bound is a user key; for a Table it is ordered
+  // by the comparator of the table.  The slice must outlive the iterators.
+  const Slice* iterate_upper_bound = nullptr;
+
   // If "snapshot" is non-null, read as of the supplied snapshot
   // (which must belong to the DB that is being read and which must
   // not have been released).  If "snapshot" is null, use an implicit
@@ -0,0 +1,53 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+//
+// A database can be configured with a RateLimiter that paces the writes of
+// the table files built by memtable flushes and compactions, so that
+// background work does not saturate slow storage and hold up foreground
+// reads.
+//
+// Most people will want to use the builtin token bucket (see
+// NewRateLimiter() below).
+
+#ifndef STORAGE_LEVELDB_INCLUDE_RATE_LIMITER_H_
+#define STORAGE_LEVELDB_INCLUDE_RATE_LIMITER_H_
+
+#include <cstddef>
+#include <cstdint>
+
+#include "leveldb/export.h"
+
+namespace leveldb {
+
+class Env;
+
+class LEVELDB_EXPORT RateLimiter {
+ public:
+  // Writes of high priority are admitted before any waiting writes of low
+  // priority.  Memtable flushes are of high priority, since writers stall
+  // on them, and compactions are of low priority.
+  enum class Priority { kHigh, kLow };
+
+  virtual ~RateLimiter();
+
+  // Blocks until "bytes" bytes may be written.  May be called from several
+  // threads at once.
+  virtual void Request(size_t bytes, Priority priority) = 0;
+};
+
+// Return a new rate limiter that admits "bytes_per_second" bytes per second
+// on average.  The allowance is refilled every "refill_period_micros"
+// microseconds, and unused allowance does not carry over to later periods.
+// The limiter reads the time from and sleeps through "env", or
+// Env::Default() if it is null.
+//
+// Callers must delete the result after any database that is using the
+// result has been closed.
+LEVELDB_EXPORT RateLimiter* NewRateLimiter(
+    int64_t bytes_per_second, int64_t refill_period_micros = 100000,
+    Env* env = nullptr);
+
+}  // namespace leveldb
+
+#endif  // STORAGE_LEVELDB_INCLUDE_RATE_LIMITER_H_
@@ -20,6 +20,29 @@ class RandomAccessFile;
 struct ReadOptions;
 class TableCache;
 
+// Statistics of a table, which the table stores when it is built.
+struct LEVELDB_EXPORT TableProperties {
+  uint64_t num_entries = 0;
+  uint64_t num_data_blocks = 0;
+
+  // Number of restart points of the data blocks.
+  uint64_t num_restarts = 0;
+
+  // Sizes of the keys and values as they were added.
+  uint64_t raw_key_size = 0;
+  uint64_t raw_value_size = 0;
+
+  // Size of the keys in the data blocks after prefix compression, that is
+  // of the parts that each key does not share with the key before it.
+  uint64_t prefix_compressed_key_size = 0;
+
+  // Sizes of the data blocks, the index and the filters in the file, after
+  // compression and including block trailers.
+  uint64_t data_size = 0;
+  uint64_t index_size = 0;
+  uint64_t filter_size = 0;
+};
+
 // A Table is a sorted map from strings to strings.  Tables are
 // immutable and persistent.  A Table may be safely accessed from
 // multiple threads without external synchronization.
@@ -58,11 +81,44 @@ class LEVELDB_EXPORT Table {
   // be close to the file length.
   uint64_t ApproximateOffsetOf(const Slice& key) const;
 
+  // Returns the properties the table was built with, or nullptr if it was
+  // built without them or they could not be read.
+  const TableProperties* GetProperties() const;
+
  private:
   friend class TableCache;
   struct Rep;
+  class PrefixSeekIterator;
 
   static Iterator* BlockReader(void*, const ReadOptions&, const Slice&);
+  // Like the above, with an iterator for point lookups if "point_lookup"
+  // (see Block::NewIterator()).
+  static Iterator* BlockReader(void*, const ReadOptions&, const Slice&,
+                               bool point_lookup);
+  // Like BlockReader() for the index partitions of a partitioned index.
+  static Iterator* IndexPartitionReader(void*, const ReadOptions&,
+                                        const Slice&);
+
+  // Returns an iterator over the block at "handle", which is read through
+  // the block cache.  Data blocks are decompressed with the compression
+  // dictionary of the table; other blocks, that is index blocks, are always
+  // cached, with high priority.
+  Iterator* BlockIterator(const ReadOptions&, const BlockHandle& handle,
+                          bool data_block, bool point_lookup) const;
+
+  // Returns an iterator over the index, whose values are the handles of the
+  // data blocks, whether the index is partitioned or not.
+  Iterator* NewIndexIterator(const ReadOptions&) const;
+
+  bool HasFilter() const;
+
+  // Returns false if the filter of the data block at "block_offset" rules
+  // out "key", or if "prefix", any key that shares the prefix of "key".
+  bool FilterMayMatch(const ReadOptions&, uint64_t block_offset,
+                      const Slice& key, bool prefix) const;
+  bool FilterPartitionMayMatch(const ReadOptions&, const BlockHandle& handle,
+                               uint64_t block_offset, const Slice& key,
+                               bool prefix) const;
 
   explicit Table(Rep* rep) : rep_(rep) {}
 
@@ -73,8 +129,19 @@ class LEVELDB_EXPORT Table {
                      void (*handle_result)(void* arg, const Slice& k,
                                            const Slice& v));
 
+  // Like InternalGet() for each of keys[0,n-1], calling handle_result with
+  // args[i] for keys[i].  The keys must be sorted; each index entry and
+  // data block they fall into is then read only once.
+  Status InternalMultiGet(const ReadOptions&, const Slice* keys, size_t n,
+                          void* const* args,
+                          void (*handle_result)(void* arg, const Slice& k,
+                                                const Slice& v));
+
   void ReadMeta(const Footer& footer);
   void ReadFilter(const Slice& filter_handle_value);
+  void ReadFilterIndex(const Slice& filter_index_handle_value);
+  void ReadProperties(const Slice& properties_handle_value);
+  void ReadCompressionDictionary(const Slice& dictionary_handle_value);
 
   Rep* const rep_;
 };
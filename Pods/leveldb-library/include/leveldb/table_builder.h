@@ -83,6 +83,8 @@ class LEVELDB_EXPORT TableBuilder {
   bool ok() const { return status().ok(); }
   void WriteBlock(BlockBuilder* block, BlockHandle* handle);
   void WriteRawBlock(const Slice& data, CompressionType, BlockHandle* handle);
+  // Writes the current index partition and the filters of its data blocks.
+  void WritePartition();
 
   struct Rep;
   Rep* rep_;
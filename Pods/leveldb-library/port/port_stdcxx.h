@@ -28,6 +28,9 @@
 #if HAVE_SNAPPY
 #include <snappy.h>
 #endif  // HAVE_SNAPPY
+#if HAVE_ZSTD
+#include <zstd.h>
+#endif  // HAVE_ZSTD
 
 #include <cassert>
 #include <condition_variable>  // NOLINT
@@ -128,6 +131,89 @@ inline bool Snappy_Uncompress(const char* input, size_t length, char* output) {
 #endif  // HAVE_SNAPPY
 }
 
+// Compresses input at the given zstd level, with the raw content dictionary
+// dictionary[0, dictionary_length) unless dictionary_length is zero.
+inline bool Zstd_Compress(int level, const char* dictionary,
+                          size_t dictionary_length, const char* input,
+                          size_t length, std::string* output) {
+#if HAVE_ZSTD
+  size_t outlen = ZSTD_compressBound(length);
+  if (ZSTD_isError(outlen)) {
+    return false;
+  }
+  output->resize(outlen);
+  ZSTD_CCtx* ctx = ZSTD_createCCtx();
+  if (ctx == nullptr) {
+    return false;
+  }
+  outlen = ZSTD_compress_usingDict(ctx, &(*output)[0], output->size(), input,
+                                   length, dictionary, dictionary_length,
+                                   level);
+  ZSTD_freeCCtx(ctx);
+  if (ZSTD_isError(outlen)) {
+    return false;
+  }
+  output->resize(outlen);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)level;
+  (void)dictionary;
+  (void)dictionary_length;
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+inline bool Zstd_GetUncompressedLength(const char* input, size_t length,
+                                       size_t* result) {
+#if HAVE_ZSTD
+  unsigned long long size = ZSTD_getFrameContentSize(input, length);
+  if (size == ZSTD_CONTENTSIZE_UNKNOWN || size == ZSTD_CONTENTSIZE_ERROR) {
+    return false;
+  }
+  *result = static_cast<size_t>(size);
+  return true;
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)input;
+  (void)length;
+  (void)result;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
+// Decompresses input into output, which must have room for the length
+// reported by Zstd_GetUncompressedLength(), with the dictionary that
+// compressed it.
+inline bool Zstd_Uncompress(const char* dictionary, size_t dictionary_length,
+                            const char* input, size_t length, char* output) {
+#if HAVE_ZSTD
+  size_t outlen;
+  if (!Zstd_GetUncompressedLength(input, length, &outlen)) {
+    return false;
+  }
+  ZSTD_DCtx* ctx = ZSTD_createDCtx();
+  if (ctx == nullptr) {
+    return false;
+  }
+  outlen = ZSTD_decompress_usingDict(ctx, output, outlen, input, length,
+                                     dictionary, dictionary_length);
+  ZSTD_freeDCtx(ctx);
+  return !ZSTD_isError(outlen);
+#else
+  // Silence compiler warnings about unused arguments.
+  (void)dictionary;
+  (void)dictionary_length;
+  (void)input;
+  (void)length;
+  (void)output;
+  return false;
+#endif  // HAVE_ZSTD
+}
+
 inline bool GetHeapProfile(void (*func)(void*, const char*, int), void* arg) {
   // Silence compiler warnings about unused arguments.
   (void)func;
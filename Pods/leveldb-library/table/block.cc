@@ -12,29 +12,53 @@
 #include "leveldb/comparator.h"
 #include "table/format.h"
 #include "util/coding.h"
+#include "util/hash.h"
 #include "util/logging.h"
 
 namespace leveldb {
 
 inline uint32_t Block::NumRestarts() const {
   assert(size_ >= sizeof(uint32_t));
-  return DecodeFixed32(data_ + size_ - sizeof(uint32_t));
+  return DecodeFixed32(data_ + size_ - sizeof(uint32_t)) &
+         ~kBlockHashIndexFlag;
 }
 
 Block::Block(const BlockContents& contents)
     : data_(contents.data.data()),
       size_(contents.data.size()),
+      num_restarts_(0),
+      hash_buckets_(nullptr),
+      num_hash_buckets_(0),
       owned_(contents.heap_allocated) {
   if (size_ < sizeof(uint32_t)) {
     size_ = 0;  // Error marker
-  } else {
-    size_t max_restarts_allowed = (size_ - sizeof(uint32_t)) / sizeof(uint32_t);
-    if (NumRestarts() > max_restarts_allowed) {
-      // The size is too small for NumRestarts()
+    return;
+  }
+
+  size_t trailer_end = size_ - sizeof(uint32_t);
+  if (DecodeFixed32(data_ + trailer_end) & kBlockHashIndexFlag) {
+    // The restart array is followed by the hash index.
+    if (trailer_end < sizeof(uint32_t)) {
       size_ = 0;
-    } else {
-      restart_offset_ = size_ - (1 + NumRestarts()) * sizeof(uint32_t);
+      return;
+    }
+    trailer_end -= sizeof(uint32_t);
+    num_hash_buckets_ = DecodeFixed32(data_ + trailer_end);
+    if (num_hash_buckets_ == 0 || num_hash_buckets_ > trailer_end) {
+      size_ = 0;
+      return;
     }
+    trailer_end -= num_hash_buckets_;
+    hash_buckets_ = reinterpret_cast<const uint8_t*>(data_ + trailer_end);
+  }
+
+  num_restarts_ = NumRestarts();
+  size_t max_restarts_allowed = trailer_end / sizeof(uint32_t);
+  if (num_restarts_ > max_restarts_allowed) {
+    // The size is too small for NumRestarts()
+    size_ = 0;
+  } else {
+    restart_offset_ = trailer_end - num_restarts_ * sizeof(uint32_t);
   }
 }
 
@@ -79,6 +103,8 @@ class Block::Iter : public Iterator {
   const char* const data_;       // underlying block contents
   uint32_t const restarts_;      // Offset of restart array (list of fixed32)
   uint32_t const num_restarts_;  // Number of uint32_t entries in restart array
+  const uint8_t* const hash_buckets_;  // Hash index used by Seek(), if any
+  uint32_t const num_hash_buckets_;
 
   // current_ is offset in data_ of current entry.  >= restarts_ if !Valid
   uint32_t current_;
@@ -113,11 +139,14 @@ class Block::Iter : public Iterator {
 
  public:
   Iter(const Comparator* comparator, const char* data, uint32_t restarts,
-       uint32_t num_restarts)
+       uint32_t num_restarts, const uint8_t* hash_buckets,
+       uint32_t num_hash_buckets)
       : comparator_(comparator),
         data_(data),
         restarts_(restarts),
         num_restarts_(num_restarts),
+        hash_buckets_(hash_buckets),
+        num_hash_buckets_(num_hash_buckets),
         current_(restarts_),
         restart_index_(num_restarts_) {
     assert(num_restarts_ > 0);
@@ -161,6 +190,10 @@ class Block::Iter : public Iterator {
   }
 
   virtual void Seek(const Slice& target) {
+    if (hash_buckets_ != nullptr && HashSeek(target)) {
+      return;
+    }
+
     // Binary search in restart array to find the last restart point
     // with a key < target
     uint32_t left = 0;
@@ -190,14 +223,7 @@ class Block::Iter : public Iterator {
 
     // Linear search (within restart block) for first key >= target
     SeekToRestartPoint(left);
-    while (true) {
-      if (!ParseNextKey()) {
-        return;
-      }
-      if (Compare(key_, target) >= 0) {
-        return;
-      }
-    }
+    SeekForwardTo(target);
   }
 
   virtual void SeekToFirst() {
@@ -221,6 +247,44 @@ class Block::Iter : public Iterator {
     value_.clear();
   }
 
+  // Skips to the first entry >= target, from the current position.
+  void SeekForwardTo(const Slice& target) {
+    while (true) {
+      if (!ParseNextKey()) {
+        return;
+      }
+      if (Compare(key_, target) >= 0) {
+        return;
+      }
+    }
+  }
+
+  // Seeks to the entries of the user key of "target" with the hash index.
+  // Returns false if the index can not tell where they are.
+  bool HashSeek(const Slice& target) {
+    if (target.size() < kBlockHashKeySuffix) {
+      return false;
+    }
+    const uint32_t hash = Hash(target.data(),
+                               target.size() - kBlockHashKeySuffix,
+                               kBlockHashSeed);
+    const uint8_t entry = hash_buckets_[hash % num_hash_buckets_];
+    if (entry == kBlockHashNoEntry) {
+      // The user key is not in the block.
+      current_ = restarts_;
+      restart_index_ = num_restarts_;
+      return true;
+    }
+    if (entry == kBlockHashCollision || entry >= num_restarts_) {
+      return false;
+    }
+
+    // All the entries of the user key follow restart point "entry".
+    SeekToRestartPoint(entry);
+    SeekForwardTo(target);
+    return true;
+  }
+
   bool ParseNextKey() {
     current_ = NextEntryOffset();
     const char* p = data_ + current_;
@@ -251,15 +315,16 @@ class Block::Iter : public Iterator {
   }
 };
 
-Iterator* Block::NewIterator(const Comparator* comparator) {
+Iterator* Block::NewIterator(const Comparator* comparator,
+                             bool point_lookup) {
   if (size_ < sizeof(uint32_t)) {
     return NewErrorIterator(Status::Corruption("bad block contents"));
   }
-  const uint32_t num_restarts = NumRestarts();
-  if (num_restarts == 0) {
+  if (num_restarts_ == 0) {
     return NewEmptyIterator();
   } else {
-    return new Iter(comparator, data_, restart_offset_, num_restarts);
+    return new Iter(comparator, data_, restart_offset_, num_restarts_,
+                    point_lookup ? hash_buckets_ : nullptr, num_hash_buckets_);
   }
 }
 
@@ -26,7 +26,13 @@ class Block {
   ~Block();
 
   size_t size() const { return size_; }
-  Iterator* NewIterator(const Comparator* comparator);
+
+  // If "point_lookup" is true, the iterator is only used to find the entries
+  // of the user key of each Seek() target, which lets it use the hash index
+  // of the block if it has one.  Seeking to a user key that is not in the
+  // block may then leave the iterator at any entry, or invalid.
+  Iterator* NewIterator(const Comparator* comparator,
+                        bool point_lookup = false);
 
  private:
   class Iter;
@@ -36,7 +42,10 @@ class Block {
   const char* data_;
   size_t size_;
   uint32_t restart_offset_;  // Offset in data_ of restart array
-  bool owned_;               // Block owns data_[]
+  uint32_t num_restarts_;
+  const uint8_t* hash_buckets_;  // Hash index, or nullptr if there is none
+  uint32_t num_hash_buckets_;
+  bool owned_;  // Block owns data_[]
 };
 
 }  // namespace leveldb
@@ -25,6 +25,17 @@
 //     restarts: uint32[num_restarts]
 //     num_restarts: uint32
 // restarts[i] contains the offset within the block of the ith restart point.
+//
+// With Options::data_block_hash_index, data blocks instead end in:
+//     restarts: uint32[num_restarts]
+//     buckets: uint8[num_buckets]
+//     num_buckets: uint32
+//     num_restarts | kBlockHashIndexFlag: uint32
+// buckets[Hash(user_key) % num_buckets] holds the index of the restart point
+// whose entries hold user_key, or kBlockHashNoEntry if no key of the block
+// hashes to the bucket, or kBlockHashCollision if keys of several restart
+// points do.  Blocks never have 2^31 restart points, so older blocks do not
+// have the flag set.
 
 #include "table/block_builder.h"
 
@@ -34,12 +45,19 @@
 
 #include "leveldb/comparator.h"
 #include "leveldb/table_builder.h"
+#include "table/format.h"
 #include "util/coding.h"
+#include "util/hash.h"
 
 namespace leveldb {
 
 BlockBuilder::BlockBuilder(const Options* options)
-    : options_(options), restarts_(), counter_(0), finished_(false) {
+    : options_(options),
+      restarts_(),
+      counter_(0),
+      non_shared_key_bytes_(0),
+      finished_(false),
+      hash_index_(false) {
   assert(options->block_restart_interval >= 1);
   restarts_.push_back(0);  // First restart point is at offset 0
 }
@@ -49,14 +67,29 @@ void BlockBuilder::Reset() {
   restarts_.clear();
   restarts_.push_back(0);  // First restart point is at offset 0
   counter_ = 0;
+  non_shared_key_bytes_ = 0;
   finished_ = false;
   last_key_.clear();
+  hash_index_ = false;
+  key_hashes_.clear();
+}
+
+// Number of buckets per distinct user key in the hash index.
+static const double kHashBucketsPerKey = 2.0;
+
+static uint32_t HashIndexBuckets(size_t num_keys) {
+  const double buckets = num_keys * kHashBucketsPerKey;
+  return std::max<uint32_t>(1, static_cast<uint32_t>(buckets));
 }
 
 size_t BlockBuilder::CurrentSizeEstimate() const {
-  return (buffer_.size() +                       // Raw data buffer
-          restarts_.size() * sizeof(uint32_t) +  // Restart array
-          sizeof(uint32_t));                     // Restart array length
+  size_t estimate = buffer_.size() +                       // Raw data buffer
+                    restarts_.size() * sizeof(uint32_t) +  // Restart array
+                    sizeof(uint32_t);  // Restart array length
+  if (hash_index_) {
+    estimate += HashIndexBuckets(key_hashes_.size()) + sizeof(uint32_t);
+  }
+  return estimate;
 }
 
 Slice BlockBuilder::Finish() {
@@ -64,30 +97,69 @@ Slice BlockBuilder::Finish() {
   for (size_t i = 0; i < restarts_.size(); i++) {
     PutFixed32(&buffer_, restarts_[i]);
   }
-  PutFixed32(&buffer_, restarts_.size());
+  if (hash_index_) {
+    const uint32_t num_buckets = HashIndexBuckets(key_hashes_.size());
+    std::string buckets(num_buckets, static_cast<char>(kBlockHashNoEntry));
+    for (const std::pair<uint32_t, uint8_t>& key : key_hashes_) {
+      char& bucket = buckets[key.first % num_buckets];
+      if (bucket == static_cast<char>(kBlockHashNoEntry)) {
+        bucket = static_cast<char>(key.second);
+      } else if (bucket != static_cast<char>(key.second)) {
+        bucket = static_cast<char>(kBlockHashCollision);
+      }
+    }
+    buffer_.append(buckets);
+    PutFixed32(&buffer_, num_buckets);
+    PutFixed32(&buffer_, restarts_.size() | kBlockHashIndexFlag);
+  } else {
+    PutFixed32(&buffer_, restarts_.size());
+  }
   finished_ = true;
   return Slice(buffer_);
 }
 
+bool BlockBuilder::RestartBefore(const Slice& key, size_t shared) const {
+  const int interval = options_->block_restart_interval;
+  if (!options_->adaptive_block_restarts || interval == 1) {
+    return counter_ >= interval;
+  }
+  // A restart stores the shared prefix again, so put restarts where keys
+  // share little with the key before them: restart early before a key that
+  // shares less than a quarter of itself, and hold off while keys share
+  // more than half of themselves.
+  if (counter_ >= 2 * interval) {
+    return true;
+  } else if (counter_ >= interval) {
+    return shared * 2 <= key.size();
+  } else if (counter_ >= interval / 2) {
+    return shared * 4 < key.size();
+  }
+  return false;
+}
+
 void BlockBuilder::Add(const Slice& key, const Slice& value) {
   Slice last_key_piece(last_key_);
   assert(!finished_);
-  assert(counter_ <= options_->block_restart_interval);
+  assert(counter_ <= 2 * options_->block_restart_interval);
   assert(buffer_.empty()  // No values yet?
          || options_->comparator->Compare(key, last_key_piece) > 0);
+  if (buffer_.empty()) {
+    hash_index_ = options_->data_block_hash_index;
+  }
+  // See how much sharing to do with previous string
   size_t shared = 0;
-  if (counter_ < options_->block_restart_interval) {
-    // See how much sharing to do with previous string
-    const size_t min_length = std::min(last_key_piece.size(), key.size());
-    while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
-      shared++;
-    }
-  } else {
+  const size_t min_length = std::min(last_key_piece.size(), key.size());
+  while ((shared < min_length) && (last_key_piece[shared] == key[shared])) {
+    shared++;
+  }
+  if (RestartBefore(key, shared)) {
     // Restart compression
     restarts_.push_back(buffer_.size());
     counter_ = 0;
+    shared = 0;
   }
   const size_t non_shared = key.size() - shared;
+  non_shared_key_bytes_ += non_shared;
 
   // Add "<shared><non_shared><value_size>" to buffer_
   PutVarint32(&buffer_, shared);
@@ -98,6 +170,25 @@ void BlockBuilder::Add(const Slice& key, const Slice& value) {
   buffer_.append(key.data() + shared, non_shared);
   buffer_.append(value.data(), value.size());
 
+  if (hash_index_) {
+    if (key.size() < kBlockHashKeySuffix) {
+      hash_index_ = false;  // Not an internal key
+    } else if (restarts_.size() > kBlockHashMaxRestarts) {
+      hash_index_ = false;  // Restart point indexes do not fit in a bucket
+    } else {
+      // Entries of the same user key are adjacent; index each one once.
+      Slice user_key(key.data(), key.size() - kBlockHashKeySuffix);
+      if (last_key_piece.size() < kBlockHashKeySuffix ||
+          Slice(last_key_piece.data(),
+                last_key_piece.size() - kBlockHashKeySuffix) != user_key ||
+          restarts_.size() - 1 != key_hashes_.back().second) {
+        key_hashes_.emplace_back(
+            Hash(user_key.data(), user_key.size(), kBlockHashSeed),
+            static_cast<uint8_t>(restarts_.size() - 1));
+      }
+    }
+  }
+
   // Update state
   last_key_.resize(shared);
   last_key_.append(key.data() + shared, non_shared);
@@ -7,6 +7,7 @@
 
 #include <stdint.h>
 
+#include <utility>
 #include <vector>
 
 #include "leveldb/slice.h"
@@ -41,13 +42,26 @@ class BlockBuilder {
   // Return true iff no entries have been added since the last Reset()
   bool empty() const { return buffer_.empty(); }
 
+  // Number of restart points and bytes of the keys not shared with the key
+  // before them since the last Reset().
+  size_t num_restarts() const { return restarts_.size(); }
+  size_t non_shared_key_bytes() const { return non_shared_key_bytes_; }
+
  private:
+  // Returns whether "key", which shares "shared" bytes with the key before
+  // it, starts a new restart point.
+  bool RestartBefore(const Slice& key, size_t shared) const;
+
   const Options* options_;
   std::string buffer_;              // Destination buffer
   std::vector<uint32_t> restarts_;  // Restart points
   int counter_;                     // Number of entries emitted since restart
+  size_t non_shared_key_bytes_;
   bool finished_;                   // Has Finish() been called?
   std::string last_key_;
+  bool hash_index_;  // Is a hash index being built for this block?
+  // Hash of each distinct user key and the index of its restart point
+  std::vector<std::pair<uint32_t, uint8_t>> key_hashes_;
 };
 
 }  // namespace leveldb
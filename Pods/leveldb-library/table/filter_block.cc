@@ -88,13 +88,23 @@ FilterBlockReader::FilterBlockReader(const FilterPolicy* policy,
 }
 
 bool FilterBlockReader::KeyMayMatch(uint64_t block_offset, const Slice& key) {
+  return MayMatch(block_offset, key, &FilterPolicy::KeyMayMatch);
+}
+
+bool FilterBlockReader::PrefixMayMatch(uint64_t block_offset,
+                                       const Slice& key) {
+  return MayMatch(block_offset, key, &FilterPolicy::PrefixMayMatch);
+}
+
+bool FilterBlockReader::MayMatch(uint64_t block_offset, const Slice& key,
+                                 MatchFunction match) {
   uint64_t index = block_offset >> base_lg_;
   if (index < num_) {
     uint32_t start = DecodeFixed32(offset_ + index * 4);
     uint32_t limit = DecodeFixed32(offset_ + index * 4 + 4);
     if (start <= limit && limit <= static_cast<size_t>(offset_ - data_)) {
       Slice filter = Slice(data_ + start, limit - start);
-      return policy_->KeyMayMatch(key, filter);
+      return (policy_->*match)(key, filter);
     } else if (start == limit) {
       // Empty filters do not match any keys
       return false;
@@ -56,7 +56,16 @@ class FilterBlockReader {
   FilterBlockReader(const FilterPolicy* policy, const Slice& contents);
   bool KeyMayMatch(uint64_t block_offset, const Slice& key);
 
+  // Returns false if the filter rules out keys that share the prefix of
+  // "key" in the block at "block_offset".
+  bool PrefixMayMatch(uint64_t block_offset, const Slice& key);
+
  private:
+  using MatchFunction = bool (FilterPolicy::*)(const Slice& key,
+                                               const Slice& filter) const;
+
+  bool MayMatch(uint64_t block_offset, const Slice& key, MatchFunction match);
+
   const FilterPolicy* policy_;
   const char* data_;    // Pointer to filter data (at block-start)
   const char* offset_;  // Pointer to beginning of offset array (at block-end)
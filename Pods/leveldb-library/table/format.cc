@@ -4,7 +4,10 @@
 
 #include "table/format.h"
 
+#include <utility>
+
 #include "leveldb/env.h"
+#include "leveldb/table.h"
 #include "port/port.h"
 #include "table/block.h"
 #include "util/coding.h"
@@ -33,8 +36,10 @@ void Footer::EncodeTo(std::string* dst) const {
   metaindex_handle_.EncodeTo(dst);
   index_handle_.EncodeTo(dst);
   dst->resize(2 * BlockHandle::kMaxEncodedLength);  // Padding
-  PutFixed32(dst, static_cast<uint32_t>(kTableMagicNumber & 0xffffffffu));
-  PutFixed32(dst, static_cast<uint32_t>(kTableMagicNumber >> 32));
+  const uint64_t magic =
+      partitioned_index_ ? kPartitionedTableMagicNumber : kTableMagicNumber;
+  PutFixed32(dst, static_cast<uint32_t>(magic & 0xffffffffu));
+  PutFixed32(dst, static_cast<uint32_t>(magic >> 32));
   assert(dst->size() == original_size + kEncodedLength);
   (void)original_size;  // Disable unused variable warning.
 }
@@ -45,9 +50,10 @@ Status Footer::DecodeFrom(Slice* input) {
   const uint32_t magic_hi = DecodeFixed32(magic_ptr + 4);
   const uint64_t magic = ((static_cast<uint64_t>(magic_hi) << 32) |
                           (static_cast<uint64_t>(magic_lo)));
-  if (magic != kTableMagicNumber) {
+  if (magic != kTableMagicNumber && magic != kPartitionedTableMagicNumber) {
     return Status::Corruption("not an sstable (bad magic number)");
   }
+  partitioned_index_ = (magic == kPartitionedTableMagicNumber);
 
   Status result = metaindex_handle_.DecodeFrom(input);
   if (result.ok()) {
@@ -61,8 +67,93 @@ Status Footer::DecodeFrom(Slice* input) {
   return result;
 }
 
+const char kCompressionDictionaryKey[] = "compression.dictionary";
+const char kPartitionedFilterPrefix[] = "partitionedfilter.";
+const char kPropertiesBlockKey[] = "leveldb.properties";
+
+namespace {
+
+// Tags of the properties in their encoding.  Never reuse a tag.
+enum PropertyTag : uint32_t {
+  kNumEntriesTag = 1,
+  kNumDataBlocksTag = 2,
+  kNumRestartsTag = 3,
+  kRawKeySizeTag = 4,
+  kRawValueSizeTag = 5,
+  kPrefixCompressedKeySizeTag = 6,
+  kDataSizeTag = 7,
+  kIndexSizeTag = 8,
+  kFilterSizeTag = 9,
+};
+
+}  // namespace
+
+void EncodeTableProperties(const TableProperties& properties,
+                           std::string* dst) {
+  const std::pair<PropertyTag, uint64_t> values[] = {
+      {kNumEntriesTag, properties.num_entries},
+      {kNumDataBlocksTag, properties.num_data_blocks},
+      {kNumRestartsTag, properties.num_restarts},
+      {kRawKeySizeTag, properties.raw_key_size},
+      {kRawValueSizeTag, properties.raw_value_size},
+      {kPrefixCompressedKeySizeTag, properties.prefix_compressed_key_size},
+      {kDataSizeTag, properties.data_size},
+      {kIndexSizeTag, properties.index_size},
+      {kFilterSizeTag, properties.filter_size},
+  };
+  for (const auto& value : values) {
+    PutVarint32(dst, value.first);
+    PutVarint64(dst, value.second);
+  }
+}
+
+bool DecodeTableProperties(Slice input, TableProperties* properties) {
+  *properties = TableProperties();
+  uint32_t tag;
+  uint64_t value;
+  while (!input.empty()) {
+    if (!GetVarint32(&input, &tag) || !GetVarint64(&input, &value)) {
+      return false;
+    }
+    switch (tag) {
+      case kNumEntriesTag:
+        properties->num_entries = value;
+        break;
+      case kNumDataBlocksTag:
+        properties->num_data_blocks = value;
+        break;
+      case kNumRestartsTag:
+        properties->num_restarts = value;
+        break;
+      case kRawKeySizeTag:
+        properties->raw_key_size = value;
+        break;
+      case kRawValueSizeTag:
+        properties->raw_value_size = value;
+        break;
+      case kPrefixCompressedKeySizeTag:
+        properties->prefix_compressed_key_size = value;
+        break;
+      case kDataSizeTag:
+        properties->data_size = value;
+        break;
+      case kIndexSizeTag:
+        properties->index_size = value;
+        break;
+      case kFilterSizeTag:
+        properties->filter_size = value;
+        break;
+      default:
+        // Written by a newer version.
+        break;
+    }
+  }
+  return true;
+}
+
 Status ReadBlock(RandomAccessFile* file, const ReadOptions& options,
-                 const BlockHandle& handle, BlockContents* result) {
+                 const BlockHandle& handle, BlockContents* result,
+                 const Slice& dictionary) {
   result->data = Slice();
   result->cachable = false;
   result->heap_allocated = false;
@@ -130,6 +221,25 @@ Status ReadBlock(RandomAccessFile* file, const ReadOptions& options,
       result->cachable = true;
       break;
     }
+    case kZstdCompression: {
+      size_t ulength = 0;
+      if (!port::Zstd_GetUncompressedLength(data, n, &ulength)) {
+        delete[] buf;
+        return Status::Corruption("corrupted zstd compressed block contents");
+      }
+      char* ubuf = new char[ulength];
+      if (!port::Zstd_Uncompress(dictionary.data(), dictionary.size(), data, n,
+                                 ubuf)) {
+        delete[] buf;
+        delete[] ubuf;
+        return Status::Corruption("corrupted zstd compressed block contents");
+      }
+      delete[] buf;
+      result->data = Slice(ubuf, ulength);
+      result->heap_allocated = true;
+      result->cachable = true;
+      break;
+    }
     default:
       delete[] buf;
       return Status::Corruption("bad block type");
@@ -18,6 +18,7 @@ namespace leveldb {
 class Block;
 class RandomAccessFile;
 struct ReadOptions;
+struct TableProperties;
 
 // BlockHandle is a pointer to the extent of a file that stores a data
 // block or a meta block.
@@ -63,12 +64,19 @@ class Footer {
   const BlockHandle& index_handle() const { return index_handle_; }
   void set_index_handle(const BlockHandle& h) { index_handle_ = h; }
 
+  // Whether the index block is the top level of a partitioned index, whose
+  // entries point to index partitions instead of data blocks.  Stored as a
+  // different magic number, which older readers reject.
+  bool partitioned_index() const { return partitioned_index_; }
+  void set_partitioned_index(bool p) { partitioned_index_ = p; }
+
   void EncodeTo(std::string* dst) const;
   Status DecodeFrom(Slice* input);
 
  private:
   BlockHandle metaindex_handle_;
   BlockHandle index_handle_;
+  bool partitioned_index_ = false;
 };
 
 // kTableMagicNumber was picked by running
@@ -76,19 +84,59 @@ class Footer {
 // and taking the leading 64 bits.
 static const uint64_t kTableMagicNumber = 0xdb4775248b80fb57ull;
 
+// The magic number of tables with a partitioned index.
+static const uint64_t kPartitionedTableMagicNumber = 0x88e241b785f4cff7ull;
+
 // 1-byte type + 32-bit crc
 static const size_t kBlockTrailerSize = 5;
 
+// The hash index of data blocks; see block_builder.cc for its layout.
+// Set in the restart count of blocks that end in a hash index.
+static const uint32_t kBlockHashIndexFlag = 1u << 31;
+// Bucket values that are not restart point indexes.
+static const uint8_t kBlockHashNoEntry = 255;
+static const uint8_t kBlockHashCollision = 254;
+// Blocks with more restart points have no hash index.
+static const size_t kBlockHashMaxRestarts = 254;
+// The size of the sequence number and type at the end of internal keys,
+// which the hash leaves out so that it only covers the user key.
+static const size_t kBlockHashKeySuffix = 8;
+static const uint32_t kBlockHashSeed = 0x3b5a1c9d;
+
 struct BlockContents {
   Slice data;           // Actual contents of data
   bool cachable;        // True iff data can be cached
   bool heap_allocated;  // True iff caller should delete[] data.data()
 };
 
+// The key in the metaindex block of the dictionary that primed the zstd
+// compression of the data blocks of a table.
+extern const char kCompressionDictionaryKey[];
+
+// The prefix, followed by the name of the filter policy, of the key in the
+// metaindex block of the top-level filter index of a table with partitioned
+// filters.  Each of its entries points to a filter partition and is keyed
+// like the index partition whose data blocks the partition covers.
+extern const char kPartitionedFilterPrefix[];
+
+// The key in the metaindex block of the properties of a table.
+extern const char kPropertiesBlockKey[];
+
+// Appends an encoding of "properties" to *dst, in which each property is
+// tagged so that unknown ones can be skipped.
+void EncodeTableProperties(const TableProperties& properties,
+                           std::string* dst);
+
+// Decodes properties written by EncodeTableProperties().  Returns false if
+// "input" is malformed.
+bool DecodeTableProperties(Slice input, TableProperties* properties);
+
 // Read the block identified by "handle" from "file".  On failure
-// return non-OK.  On success fill *result and return OK.
+// return non-OK.  On success fill *result and return OK.  Blocks
+// compressed with a dictionary are decompressed with "dictionary".
 Status ReadBlock(RandomAccessFile* file, const ReadOptions& options,
-                 const BlockHandle& handle, BlockContents* result);
+                 const BlockHandle& handle, BlockContents* result,
+                 const Slice& dictionary = Slice());
 
 // Implementation details follow.  Clients should ignore,
 
@@ -13,8 +13,10 @@ namespace leveldb {
 namespace {
 class MergingIterator : public Iterator {
  public:
-  MergingIterator(const Comparator* comparator, Iterator** children, int n)
+  MergingIterator(const Comparator* comparator, Iterator** children, int n,
+                  const Slice* upper_bound)
       : comparator_(comparator),
+        upper_bound_(upper_bound),
         children_(new IteratorWrapper[n]),
         n_(n),
         current_(nullptr),
@@ -38,7 +40,18 @@ class MergingIterator : public Iterator {
 
   virtual void SeekToLast() {
     for (int i = 0; i < n_; i++) {
-      children_[i].SeekToLast();
+      IteratorWrapper* child = &children_[i];
+      if (upper_bound_ == nullptr) {
+        child->SeekToLast();
+      } else {
+        // Position the child at its last entry before the bound.
+        child->Seek(*upper_bound_);
+        if (child->Valid()) {
+          child->Prev();
+        } else {
+          child->SeekToLast();
+        }
+      }
     }
     FindLargest();
     direction_ = kReverse;
@@ -135,10 +148,18 @@ class MergingIterator : public Iterator {
   void FindSmallest();
   void FindLargest();
 
+  // Returns true if "child" is positioned at an entry before the bound.
+  bool BeforeUpperBound(const IteratorWrapper* child) const {
+    return child->Valid() &&
+           (upper_bound_ == nullptr ||
+            comparator_->Compare(child->key(), *upper_bound_) < 0);
+  }
+
   // We might want to use a heap in case there are lots of children.
   // For now we use a simple array since we expect a very small number
   // of children in leveldb.
   const Comparator* comparator_;
+  const Slice* const upper_bound_;
   IteratorWrapper* children_;
   int n_;
   IteratorWrapper* current_;
@@ -149,7 +170,7 @@ void MergingIterator::FindSmallest() {
   IteratorWrapper* smallest = nullptr;
   for (int i = 0; i < n_; i++) {
     IteratorWrapper* child = &children_[i];
-    if (child->Valid()) {
+    if (BeforeUpperBound(child)) {
       if (smallest == nullptr) {
         smallest = child;
       } else if (comparator_->Compare(child->key(), smallest->key()) < 0) {
@@ -177,14 +198,14 @@ void MergingIterator::FindLargest() {
 }  // namespace
 
 Iterator* NewMergingIterator(const Comparator* comparator, Iterator** children,
-                             int n) {
+                             int n, const Slice* upper_bound) {
   assert(n >= 0);
   if (n == 0) {
     return NewEmptyIterator();
-  } else if (n == 1) {
+  } else if (n == 1 && upper_bound == nullptr) {
     return children[0];
   } else {
-    return new MergingIterator(comparator, children, n);
+    return new MergingIterator(comparator, children, n, upper_bound);
   }
 }
 
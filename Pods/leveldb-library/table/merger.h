@@ -9,6 +9,7 @@ namespace leveldb {
 
 class Comparator;
 class Iterator;
+class Slice;
 
 // Return an iterator that provided the union of the data in
 // children[0,n-1].  Takes ownership of the child iterators and
@@ -17,9 +18,14 @@ class Iterator;
 // The result does no duplicate suppression.  I.e., if a particular
 // key is present in K child iterators, it will be yielded K times.
 //
+// If "upper_bound" is non-null, the result only yields the keys before
+// "*upper_bound": children that have moved forward to the bound are no
+// longer consulted, and SeekToLast() positions the children before it.
+// "*upper_bound" must outlive the result.
+//
 // REQUIRES: n >= 0
 Iterator* NewMergingIterator(const Comparator* comparator, Iterator** children,
-                             int n);
+                             int n, const Slice* upper_bound = nullptr);
 
 }  // namespace leveldb
 
@@ -21,6 +21,7 @@ struct Table::Rep {
   ~Rep() {
     delete filter;
     delete[] filter_data;
+    delete filter_index;
     delete index_block;
   }
 
@@ -33,6 +34,22 @@ struct Table::Rep {
 
   BlockHandle metaindex_handle;  // Handle to metaindex_block: saved from footer
   Block* index_block;
+
+  // Set for tables with a partitioned index and filters.  index_block and
+  // filter_index are then their top levels, or nullptr if those are not
+  // pinned and are read through the block cache from index_handle and
+  // filter_index_handle.
+  bool partitioned;
+  BlockHandle index_handle;
+  Block* filter_index;
+  bool has_filter_index;
+  BlockHandle filter_index_handle;
+
+  // Decompresses the data blocks that were compressed with a dictionary
+  std::string compression_dictionary;
+
+  bool has_properties = false;
+  TableProperties properties;
 };
 
 Status Table::Open(const Options& options, RandomAccessFile* file,
@@ -52,9 +69,14 @@ Status Table::Open(const Options& options, RandomAccessFile* file,
   s = footer.DecodeFrom(&footer_input);
   if (!s.ok()) return s;
 
-  // Read the index block
+  // Read the index block, unless it is the top level of a partitioned index
+  // that is read through the block cache instead.
+  const bool partitioned = footer.partitioned_index();
+  const bool read_index =
+      !partitioned || options.pin_top_level_index_and_filter ||
+      options.block_cache == nullptr;
   BlockContents index_block_contents;
-  if (s.ok()) {
+  if (s.ok() && read_index) {
     ReadOptions opt;
     if (options.paranoid_checks) {
       opt.verify_checksums = true;
@@ -65,7 +87,8 @@ Status Table::Open(const Options& options, RandomAccessFile* file,
   if (s.ok()) {
     // We've successfully read the footer and the index block: we're
     // ready to serve requests.
-    Block* index_block = new Block(index_block_contents);
+    Block* index_block =
+        read_index ? new Block(index_block_contents) : nullptr;
     Rep* rep = new Table::Rep;
     rep->options = options;
     rep->file = file;
@@ -74,6 +97,10 @@ Status Table::Open(const Options& options, RandomAccessFile* file,
     rep->cache_id = (options.block_cache ? options.block_cache->NewId() : 0);
     rep->filter_data = nullptr;
     rep->filter = nullptr;
+    rep->partitioned = partitioned;
+    rep->index_handle = footer.index_handle();
+    rep->filter_index = nullptr;
+    rep->has_filter_index = false;
     *table = new Table(rep);
     (*table)->ReadMeta(footer);
   }
@@ -82,12 +109,12 @@ Status Table::Open(const Options& options, RandomAccessFile* file,
 }
 
 void Table::ReadMeta(const Footer& footer) {
-  if (rep_->options.filter_policy == nullptr) {
-    return;  // Do not need any metadata
+  // An empty metaindex block holds nothing but its restart array: one
+  // restart point and the number of restarts.
+  if (footer.metaindex_handle().size() <= 2 * sizeof(uint32_t)) {
+    return;
   }
 
-  // TODO(sanjay): Skip this if footer.metaindex_handle() size indicates
-  // it is an empty block.
   ReadOptions opt;
   if (rep_->options.paranoid_checks) {
     opt.verify_checksums = true;
@@ -100,16 +127,58 @@ void Table::ReadMeta(const Footer& footer) {
   Block* meta = new Block(contents);
 
   Iterator* iter = meta->NewIterator(BytewiseComparator());
-  std::string key = "filter.";
-  key.append(rep_->options.filter_policy->Name());
-  iter->Seek(key);
-  if (iter->Valid() && iter->key() == Slice(key)) {
-    ReadFilter(iter->value());
+  iter->Seek(kCompressionDictionaryKey);
+  if (iter->Valid() && iter->key() == Slice(kCompressionDictionaryKey)) {
+    ReadCompressionDictionary(iter->value());
+  }
+  iter->Seek(kPropertiesBlockKey);
+  if (iter->Valid() && iter->key() == Slice(kPropertiesBlockKey)) {
+    ReadProperties(iter->value());
+  }
+  if (rep_->options.filter_policy != nullptr) {
+    std::string key = "filter.";
+    key.append(rep_->options.filter_policy->Name());
+    iter->Seek(key);
+    if (iter->Valid() && iter->key() == Slice(key)) {
+      ReadFilter(iter->value());
+    }
+
+    key = kPartitionedFilterPrefix;
+    key.append(rep_->options.filter_policy->Name());
+    iter->Seek(key);
+    if (rep_->partitioned && iter->Valid() && iter->key() == Slice(key)) {
+      ReadFilterIndex(iter->value());
+    }
   }
   delete iter;
   delete meta;
 }
 
+void Table::ReadProperties(const Slice& properties_handle_value) {
+  Slice v = properties_handle_value;
+  BlockHandle properties_handle;
+  if (!properties_handle.DecodeFrom(&v).ok()) {
+    return;
+  }
+
+  ReadOptions opt;
+  if (rep_->options.paranoid_checks) {
+    opt.verify_checksums = true;
+  }
+  BlockContents block;
+  if (!ReadBlock(rep_->file, opt, properties_handle, &block).ok()) {
+    return;
+  }
+  rep_->has_properties = DecodeTableProperties(block.data, &rep_->properties);
+  if (block.heap_allocated) {
+    delete[] block.data.data();
+  }
+}
+
+const TableProperties* Table::GetProperties() const {
+  return rep_->has_properties ? &rep_->properties : nullptr;
+}
+
 void Table::ReadFilter(const Slice& filter_handle_value) {
   Slice v = filter_handle_value;
   BlockHandle filter_handle;
@@ -133,6 +202,50 @@ void Table::ReadFilter(const Slice& filter_handle_value) {
   rep_->filter = new FilterBlockReader(rep_->options.filter_policy, block.data);
 }
 
+void Table::ReadFilterIndex(const Slice& filter_index_handle_value) {
+  Slice v = filter_index_handle_value;
+  if (!rep_->filter_index_handle.DecodeFrom(&v).ok()) {
+    return;
+  }
+  rep_->has_filter_index = true;
+  if (!rep_->options.pin_top_level_index_and_filter &&
+      rep_->options.block_cache != nullptr) {
+    return;  // Read through the block cache
+  }
+
+  ReadOptions opt;
+  if (rep_->options.paranoid_checks) {
+    opt.verify_checksums = true;
+  }
+  BlockContents block;
+  if (!ReadBlock(rep_->file, opt, rep_->filter_index_handle, &block).ok()) {
+    rep_->has_filter_index = false;
+    return;
+  }
+  rep_->filter_index = new Block(block);
+}
+
+void Table::ReadCompressionDictionary(const Slice& dictionary_handle_value) {
+  Slice v = dictionary_handle_value;
+  BlockHandle dictionary_handle;
+  if (!dictionary_handle.DecodeFrom(&v).ok()) {
+    return;
+  }
+
+  // Without the dictionary its data blocks fail to decompress, which
+  // reports the table as corrupted.
+  ReadOptions opt;
+  opt.verify_checksums = true;
+  BlockContents block;
+  if (!ReadBlock(rep_->file, opt, dictionary_handle, &block).ok()) {
+    return;
+  }
+  rep_->compression_dictionary.assign(block.data.data(), block.data.size());
+  if (block.heap_allocated) {
+    delete[] block.data.data();
+  }
+}
+
 Table::~Table() { delete rep_; }
 
 static void DeleteBlock(void* arg, void* ignored) {
@@ -150,52 +263,78 @@ static void ReleaseBlock(void* arg, void* h) {
   cache->Release(handle);
 }
 
-// Convert an index iterator value (i.e., an encoded BlockHandle)
-// into an iterator over the contents of the corresponding block.
-Iterator* Table::BlockReader(void* arg, const ReadOptions& options,
-                             const Slice& index_value) {
-  Table* table = reinterpret_cast<Table*>(arg);
-  Cache* block_cache = table->rep_->options.block_cache;
+// Implements ReadOptions::readahead_size.  The file is split into windows
+// of that size and, whenever a block read crosses into a new window, the
+// window after it is read ahead, so that a scan keeps one window in flight.
+static void MaybeReadahead(RandomAccessFile* file, const ReadOptions& options,
+                           const BlockHandle& handle) {
+  const uint64_t window = options.readahead_size;
+  if (window == 0) {
+    return;
+  }
+  const uint64_t begin = handle.offset();
+  const uint64_t end = begin + handle.size() + kBlockTrailerSize;
+  if (begin == 0) {
+    file->Readahead(0, 2 * window);
+  } else if (begin / window != (end - 1) / window) {
+    file->Readahead(((end - 1) / window + 1) * window, window);
+  }
+}
+
+static void EncodeCacheKey(uint64_t cache_id, uint64_t offset,
+                           char (&buffer)[16]) {
+  EncodeFixed64(buffer, cache_id);
+  EncodeFixed64(buffer + 8, offset);
+}
+
+Iterator* Table::BlockIterator(const ReadOptions& options,
+                               const BlockHandle& handle, bool data_block,
+                               bool point_lookup) const {
+  Cache* block_cache = rep_->options.block_cache;
   Block* block = nullptr;
   Cache::Handle* cache_handle = nullptr;
+  const Slice dictionary =
+      data_block ? Slice(rep_->compression_dictionary) : Slice();
 
-  BlockHandle handle;
-  Slice input = index_value;
-  Status s = handle.DecodeFrom(&input);
-  // We intentionally allow extra stuff in index_value so that we
-  // can add more features in the future.
-
-  if (s.ok()) {
-    BlockContents contents;
-    if (block_cache != nullptr) {
-      char cache_key_buffer[16];
-      EncodeFixed64(cache_key_buffer, table->rep_->cache_id);
-      EncodeFixed64(cache_key_buffer + 8, handle.offset());
-      Slice key(cache_key_buffer, sizeof(cache_key_buffer));
-      cache_handle = block_cache->Lookup(key);
-      if (cache_handle != nullptr) {
-        block = reinterpret_cast<Block*>(block_cache->Value(cache_handle));
-      } else {
-        s = ReadBlock(table->rep_->file, options, handle, &contents);
-        if (s.ok()) {
-          block = new Block(contents);
-          if (contents.cachable && options.fill_cache) {
-            cache_handle = block_cache->Insert(key, block, block->size(),
-                                               &DeleteCachedBlock);
-          }
-        }
-      }
+  Status s;
+  BlockContents contents;
+  if (block_cache != nullptr) {
+    char cache_key_buffer[16];
+    EncodeCacheKey(rep_->cache_id, handle.offset(), cache_key_buffer);
+    Slice key(cache_key_buffer, sizeof(cache_key_buffer));
+    cache_handle = block_cache->Lookup(key);
+    if (cache_handle != nullptr) {
+      block = reinterpret_cast<Block*>(block_cache->Value(cache_handle));
     } else {
-      s = ReadBlock(table->rep_->file, options, handle, &contents);
+      if (data_block) {
+        MaybeReadahead(rep_->file, options, handle);
+      }
+      s = ReadBlock(rep_->file, options, handle, &contents, dictionary);
       if (s.ok()) {
         block = new Block(contents);
+        // Every read in the key range of an index block needs it again.
+        if (contents.cachable && (options.fill_cache || !data_block)) {
+          cache_handle = block_cache->Insert(
+              key, block, block->size(), &DeleteCachedBlock,
+              data_block && options.fill_cache_low_priority
+                  ? Cache::Priority::kLow
+                  : Cache::Priority::kHigh);
+        }
       }
     }
+  } else {
+    if (data_block) {
+      MaybeReadahead(rep_->file, options, handle);
+    }
+    s = ReadBlock(rep_->file, options, handle, &contents, dictionary);
+    if (s.ok()) {
+      block = new Block(contents);
+    }
   }
 
   Iterator* iter;
   if (block != nullptr) {
-    iter = block->NewIterator(table->rep_->options.comparator);
+    iter = block->NewIterator(rep_->options.comparator, point_lookup);
     if (cache_handle == nullptr) {
       iter->RegisterCleanup(&DeleteBlock, block, nullptr);
     } else {
@@ -207,27 +346,253 @@ Iterator* Table::BlockReader(void* arg, const ReadOptions& options,
   return iter;
 }
 
+// Convert an index iterator value (i.e., an encoded BlockHandle)
+// into an iterator over the contents of the corresponding block.
+Iterator* Table::BlockReader(void* arg, const ReadOptions& options,
+                             const Slice& index_value) {
+  return BlockReader(arg, options, index_value, false);
+}
+
+Iterator* Table::BlockReader(void* arg, const ReadOptions& options,
+                             const Slice& index_value, bool point_lookup) {
+  Table* table = reinterpret_cast<Table*>(arg);
+  BlockHandle handle;
+  Slice input = index_value;
+  Status s = handle.DecodeFrom(&input);
+  // We intentionally allow extra stuff in index_value so that we
+  // can add more features in the future.
+  if (!s.ok()) {
+    return NewErrorIterator(s);
+  }
+  return table->BlockIterator(options, handle, true, point_lookup);
+}
+
+Iterator* Table::IndexPartitionReader(void* arg, const ReadOptions& options,
+                                      const Slice& index_value) {
+  Table* table = reinterpret_cast<Table*>(arg);
+  BlockHandle handle;
+  Slice input = index_value;
+  Status s = handle.DecodeFrom(&input);
+  if (!s.ok()) {
+    return NewErrorIterator(s);
+  }
+  return table->BlockIterator(options, handle, false, false);
+}
+
+Iterator* Table::NewIndexIterator(const ReadOptions& options) const {
+  const Comparator* comparator = rep_->options.comparator;
+  if (!rep_->partitioned) {
+    return rep_->index_block->NewIterator(comparator);
+  }
+  Iterator* top_level =
+      rep_->index_block != nullptr
+          ? rep_->index_block->NewIterator(comparator)
+          : BlockIterator(options, rep_->index_handle, false, false);
+  return NewTwoLevelIterator(top_level, &Table::IndexPartitionReader,
+                             const_cast<Table*>(this), options);
+}
+
+namespace {
+
+// A filter partition held by the block cache.
+struct FilterPartition {
+  FilterPartition(const FilterPolicy* policy, const BlockContents& contents)
+      : reader(policy, contents.data),
+        data(contents.heap_allocated ? contents.data.data() : nullptr),
+        size(contents.data.size()) {}
+
+  ~FilterPartition() { delete[] data; }
+
+  FilterBlockReader reader;
+  const char* const data;  // Deleted with the partition, if not null
+  const size_t size;
+};
+
+void DeleteCachedFilterPartition(const Slice& key, void* value) {
+  delete reinterpret_cast<FilterPartition*>(value);
+}
+
+}  // namespace
+
+bool Table::HasFilter() const {
+  return rep_->filter != nullptr || rep_->has_filter_index;
+}
+
+bool Table::FilterMayMatch(const ReadOptions& options, uint64_t block_offset,
+                           const Slice& key, bool prefix) const {
+  if (rep_->filter != nullptr) {
+    return prefix ? rep_->filter->PrefixMayMatch(block_offset, key)
+                  : rep_->filter->KeyMayMatch(block_offset, key);
+  }
+  if (!rep_->has_filter_index) {
+    return true;
+  }
+
+  // The partition with the filter of the block is under the same key in
+  // the filter index as the index partition with the block in the index.
+  const Comparator* comparator = rep_->options.comparator;
+  Iterator* iter =
+      rep_->filter_index != nullptr
+          ? rep_->filter_index->NewIterator(comparator)
+          : BlockIterator(options, rep_->filter_index_handle, false, false);
+  iter->Seek(key);
+  bool may_match = true;
+  if (iter->Valid()) {
+    // The value is the handle of the partition and the offset of its first
+    // data block, which the offsets of its filters are relative to.
+    Slice input = iter->value();
+    BlockHandle handle;
+    uint64_t base;
+    if (handle.DecodeFrom(&input).ok() && GetVarint64(&input, &base) &&
+        block_offset >= base) {
+      may_match = FilterPartitionMayMatch(options, handle,
+                                          block_offset - base, key, prefix);
+    }
+  }
+  delete iter;
+  return may_match;
+}
+
+bool Table::FilterPartitionMayMatch(const ReadOptions& options,
+                                    const BlockHandle& handle,
+                                    uint64_t block_offset, const Slice& key,
+                                    bool prefix) const {
+  Cache* block_cache = rep_->options.block_cache;
+  Cache::Handle* cache_handle = nullptr;
+  FilterPartition* partition = nullptr;
+  char cache_key_buffer[16];
+  EncodeCacheKey(rep_->cache_id, handle.offset(), cache_key_buffer);
+  Slice cache_key(cache_key_buffer, sizeof(cache_key_buffer));
+  if (block_cache != nullptr) {
+    cache_handle = block_cache->Lookup(cache_key);
+    if (cache_handle != nullptr) {
+      partition =
+          reinterpret_cast<FilterPartition*>(block_cache->Value(cache_handle));
+    }
+  }
+
+  if (partition == nullptr) {
+    BlockContents contents;
+    if (!ReadBlock(rep_->file, options, handle, &contents).ok()) {
+      // Errors are reported by the read of the data block.
+      return true;
+    }
+    partition = new FilterPartition(rep_->options.filter_policy, contents);
+    if (block_cache != nullptr && contents.cachable) {
+      cache_handle = block_cache->Insert(cache_key, partition, partition->size,
+                                         &DeleteCachedFilterPartition,
+                                         Cache::Priority::kHigh);
+    }
+  }
+
+  FilterBlockReader* reader = &partition->reader;
+  const bool may_match = prefix ? reader->PrefixMayMatch(block_offset, key)
+                                : reader->KeyMayMatch(block_offset, key);
+  if (cache_handle != nullptr) {
+    block_cache->Release(cache_handle);
+  } else {
+    delete partition;
+  }
+  return may_match;
+}
+
+// Wraps a table iterator for ReadOptions::prefix_seek.  Seek() leaves the
+// iterator invalid without reading a data block if the filter of the block
+// that the target would be in rules out the target's prefix: since keys that
+// share a prefix are adjacent, that block holds the first such key at or
+// after the target, if there is one.
+class Table::PrefixSeekIterator : public Iterator {
+ public:
+  PrefixSeekIterator(Iterator* iter, const Table* table,
+                     const ReadOptions& options)
+      : iter_(iter),
+        index_iter_(table->NewIndexIterator(options)),
+        table_(table),
+        options_(options) {}
+
+  ~PrefixSeekIterator() override {
+    delete iter_;
+    delete index_iter_;
+  }
+
+  bool Valid() const override { return !filtered_ && iter_->Valid(); }
+  void Seek(const Slice& target) override {
+    filtered_ = !PrefixMayMatch(target);
+    if (!filtered_) {
+      iter_->Seek(target);
+    }
+  }
+  void SeekToFirst() override {
+    filtered_ = false;
+    iter_->SeekToFirst();
+  }
+  void SeekToLast() override {
+    filtered_ = false;
+    iter_->SeekToLast();
+  }
+  void Next() override {
+    assert(Valid());
+    iter_->Next();
+  }
+  void Prev() override {
+    assert(Valid());
+    iter_->Prev();
+  }
+  Slice key() const override {
+    assert(Valid());
+    return iter_->key();
+  }
+  Slice value() const override {
+    assert(Valid());
+    return iter_->value();
+  }
+  Status status() const override {
+    return filtered_ ? index_iter_->status() : iter_->status();
+  }
+
+ private:
+  bool PrefixMayMatch(const Slice& target) {
+    index_iter_->Seek(target);
+    if (!index_iter_->Valid()) {
+      return true;
+    }
+    Slice handle_value = index_iter_->value();
+    BlockHandle handle;
+    return !handle.DecodeFrom(&handle_value).ok() ||
+           table_->FilterMayMatch(options_, handle.offset(), target, true);
+  }
+
+  Iterator* const iter_;
+  Iterator* const index_iter_;
+  const Table* const table_;
+  const ReadOptions options_;
+  bool filtered_ = false;
+};
+
 Iterator* Table::NewIterator(const ReadOptions& options) const {
-  return NewTwoLevelIterator(
-      rep_->index_block->NewIterator(rep_->options.comparator),
-      &Table::BlockReader, const_cast<Table*>(this), options);
+  Iterator* iter = NewTwoLevelIterator(
+      NewIndexIterator(options), &Table::BlockReader, const_cast<Table*>(this),
+      options, rep_->options.comparator);
+  if (options.prefix_seek && HasFilter()) {
+    iter = new PrefixSeekIterator(iter, this, options);
+  }
+  return iter;
 }
 
 Status Table::InternalGet(const ReadOptions& options, const Slice& k, void* arg,
                           void (*handle_result)(void*, const Slice&,
                                                 const Slice&)) {
   Status s;
-  Iterator* iiter = rep_->index_block->NewIterator(rep_->options.comparator);
+  Iterator* iiter = NewIndexIterator(options);
   iiter->Seek(k);
   if (iiter->Valid()) {
     Slice handle_value = iiter->value();
-    FilterBlockReader* filter = rep_->filter;
     BlockHandle handle;
-    if (filter != nullptr && handle.DecodeFrom(&handle_value).ok() &&
-        !filter->KeyMayMatch(handle.offset(), k)) {
+    if (HasFilter() && handle.DecodeFrom(&handle_value).ok() &&
+        !FilterMayMatch(options, handle.offset(), k, false)) {
       // Not found
     } else {
-      Iterator* block_iter = BlockReader(this, options, iiter->value());
+      Iterator* block_iter = BlockReader(this, options, iiter->value(), true);
       block_iter->Seek(k);
       if (block_iter->Valid()) {
         (*handle_result)(arg, block_iter->key(), block_iter->value());
@@ -243,9 +608,54 @@ Status Table::InternalGet(const ReadOptions& options, const Slice& k, void* arg,
   return s;
 }
 
+Status Table::InternalMultiGet(const ReadOptions& options, const Slice* keys,
+                               size_t n, void* const* args,
+                               void (*handle_result)(void*, const Slice&,
+                                                     const Slice&)) {
+  Status s;
+  const Comparator* comparator = rep_->options.comparator;
+  Iterator* iiter = NewIndexIterator(options);
+  Iterator* block_iter = nullptr;
+  std::string block_handle_value;  // Of the block that block_iter is over
+  for (size_t i = 0; i < n && s.ok(); i++) {
+    const Slice& k = keys[i];
+    // The index entry of k is at or after that of the key before it, so
+    // the index only needs to be searched again once k is past that entry.
+    if (!iiter->Valid() || comparator->Compare(iiter->key(), k) < 0) {
+      iiter->Seek(k);
+      if (!iiter->Valid()) {
+        break;  // k and the keys after it are past the last block
+      }
+    }
+
+    Slice handle_value = iiter->value();
+    BlockHandle handle;
+    if (HasFilter() && handle.DecodeFrom(&handle_value).ok() &&
+        !FilterMayMatch(options, handle.offset(), k, false)) {
+      continue;  // Not found
+    }
+
+    if (block_iter == nullptr || iiter->value() != Slice(block_handle_value)) {
+      delete block_iter;
+      block_iter = BlockReader(this, options, iiter->value(), true);
+      block_handle_value.assign(iiter->value().data(), iiter->value().size());
+    }
+    block_iter->Seek(k);
+    if (block_iter->Valid()) {
+      (*handle_result)(args[i], block_iter->key(), block_iter->value());
+    }
+    s = block_iter->status();
+  }
+  delete block_iter;
+  if (s.ok()) {
+    s = iiter->status();
+  }
+  delete iiter;
+  return s;
+}
+
 uint64_t Table::ApproximateOffsetOf(const Slice& key) const {
-  Iterator* index_iter =
-      rep_->index_block->NewIterator(rep_->options.comparator);
+  Iterator* index_iter = NewIndexIterator(ReadOptions());
   index_iter->Seek(key);
   uint64_t result;
   if (index_iter->Valid()) {
@@ -10,6 +10,7 @@
 #include "leveldb/env.h"
 #include "leveldb/filter_policy.h"
 #include "leveldb/options.h"
+#include "leveldb/table.h"
 #include "table/block_builder.h"
 #include "table/filter_block.h"
 #include "table/format.h"
@@ -26,6 +27,9 @@ struct TableBuilder::Rep {
         offset(0),
         data_block(&options),
         index_block(&index_block_options),
+        partitioned(opt.partition_index_and_filters),
+        top_level_index_block(&index_block_options),
+        top_level_filter_index_block(&index_block_options),
         num_entries(0),
         closed(false),
         filter_block(opt.filter_policy == nullptr
@@ -33,6 +37,8 @@ struct TableBuilder::Rep {
                          : new FilterBlockBuilder(opt.filter_policy)),
         pending_index_entry(false) {
     index_block_options.block_restart_interval = 1;
+    index_block_options.data_block_hash_index = false;
+    index_block_options.adaptive_block_restarts = false;
   }
 
   Options options;
@@ -42,8 +48,19 @@ struct TableBuilder::Rep {
   Status status;
   BlockBuilder data_block;
   BlockBuilder index_block;
+
+  // With options.partition_index_and_filters, index_block and filter_block
+  // hold the index and filters of the data blocks since the last partition
+  // was written, with filter offsets relative to filter_base, and the
+  // top-level blocks have an entry for each partition written so far.
+  const bool partitioned;
+  BlockBuilder top_level_index_block;
+  BlockBuilder top_level_filter_index_block;
+  uint64_t filter_base = 0;
+
   std::string last_key;
   int64_t num_entries;
+  TableProperties properties;
   bool closed;  // Either Finish() or Abandon() has been called.
   FilterBlockBuilder* filter_block;
 
@@ -60,6 +77,10 @@ struct TableBuilder::Rep {
   BlockHandle pending_handle;  // Handle to add to index block
 
   std::string compressed_output;
+
+  // Whether a data block was compressed with options.compression_dictionary,
+  // which then has to be stored in the table.
+  bool used_dictionary = false;
 };
 
 TableBuilder::TableBuilder(const Options& options, WritableFile* file)
@@ -82,12 +103,24 @@ Status TableBuilder::ChangeOptions(const Options& options) {
   if (options.comparator != rep_->options.comparator) {
     return Status::InvalidArgument("changing comparator while building table");
   }
+  if (options.partition_index_and_filters != rep_->partitioned) {
+    return Status::InvalidArgument(
+        "changing index partitioning while building table");
+  }
+  if (options.compression_dictionary !=
+          rep_->options.compression_dictionary &&
+      rep_->used_dictionary) {
+    return Status::InvalidArgument(
+        "changing compression dictionary while building table");
+  }
 
   // Note that any live BlockBuilders point to rep_->options and therefore
   // will automatically pick up the updated options.
   rep_->options = options;
   rep_->index_block_options = options;
   rep_->index_block_options.block_restart_interval = 1;
+  rep_->index_block_options.data_block_hash_index = false;
+  rep_->index_block_options.adaptive_block_restarts = false;
   return Status::OK();
 }
 
@@ -106,6 +139,10 @@ void TableBuilder::Add(const Slice& key, const Slice& value) {
     r->pending_handle.EncodeTo(&handle_encoding);
     r->index_block.Add(r->last_key, Slice(handle_encoding));
     r->pending_index_entry = false;
+    if (r->partitioned &&
+        r->index_block.CurrentSizeEstimate() >= r->options.block_size) {
+      WritePartition();
+    }
   }
 
   if (r->filter_block != nullptr) {
@@ -114,6 +151,8 @@ void TableBuilder::Add(const Slice& key, const Slice& value) {
 
   r->last_key.assign(key.data(), key.size());
   r->num_entries++;
+  r->properties.raw_key_size += key.size();
+  r->properties.raw_value_size += value.size();
   r->data_block.Add(key, value);
 
   const size_t estimated_block_size = r->data_block.CurrentSizeEstimate();
@@ -128,13 +167,48 @@ void TableBuilder::Flush() {
   if (!ok()) return;
   if (r->data_block.empty()) return;
   assert(!r->pending_index_entry);
+  r->properties.num_data_blocks++;
+  r->properties.num_restarts += r->data_block.num_restarts();
+  r->properties.prefix_compressed_key_size +=
+      r->data_block.non_shared_key_bytes();
   WriteBlock(&r->data_block, &r->pending_handle);
   if (ok()) {
+    r->properties.data_size += r->pending_handle.size() + kBlockTrailerSize;
     r->pending_index_entry = true;
     r->status = r->file->Flush();
   }
   if (r->filter_block != nullptr) {
-    r->filter_block->StartBlock(r->offset);
+    r->filter_block->StartBlock(r->offset - r->filter_base);
+  }
+}
+
+void TableBuilder::WritePartition() {
+  Rep* r = rep_;
+  assert(r->partitioned && !r->index_block.empty());
+  // The partition is keyed by its last entry, the one just added.
+  BlockHandle handle;
+  WriteBlock(&r->index_block, &handle);
+  if (!ok()) return;
+  r->properties.index_size += handle.size() + kBlockTrailerSize;
+  std::string handle_encoding;
+  handle.EncodeTo(&handle_encoding);
+  r->top_level_index_block.Add(r->last_key, handle_encoding);
+
+  if (r->filter_block != nullptr) {
+    BlockHandle filter_handle;
+    WriteRawBlock(r->filter_block->Finish(), kNoCompression, &filter_handle);
+    if (!ok()) return;
+    r->properties.filter_size += filter_handle.size() + kBlockTrailerSize;
+    std::string filter_handle_encoding;
+    filter_handle.EncodeTo(&filter_handle_encoding);
+    PutVarint64(&filter_handle_encoding, r->filter_base);
+    r->top_level_filter_index_block.Add(r->last_key, filter_handle_encoding);
+
+    // The next data block starts past the blocks just written.
+    delete r->filter_block;
+    r->filter_block = new FilterBlockBuilder(r->options.filter_policy);
+    r->filter_base = r->offset;
+    r->filter_block->StartBlock(0);
   }
 }
 
@@ -168,6 +242,30 @@ void TableBuilder::WriteBlock(BlockBuilder* block, BlockHandle* handle) {
       }
       break;
     }
+
+    case kZstdCompression: {
+      // Only data blocks use the dictionary, so that the index and meta
+      // blocks can be read before it.
+      Slice dictionary;
+      if (block == &r->data_block &&
+          r->options.compression_dictionary != nullptr) {
+        dictionary = *r->options.compression_dictionary;
+      }
+      std::string* compressed = &r->compressed_output;
+      if (port::Zstd_Compress(r->options.zstd_compression_level,
+                              dictionary.data(), dictionary.size(),
+                              raw.data(), raw.size(), compressed) &&
+          compressed->size() < raw.size() - (raw.size() / 8u)) {
+        block_contents = *compressed;
+        r->used_dictionary |= !dictionary.empty();
+      } else {
+        // Zstd not supported, or compressed less than 12.5%, so just
+        // store uncompressed form
+        block_contents = raw;
+        type = kNoCompression;
+      }
+      break;
+    }
   }
   WriteRawBlock(block_contents, type, handle);
   r->compressed_output.clear();
@@ -201,31 +299,41 @@ Status TableBuilder::Finish() {
   assert(!r->closed);
   r->closed = true;
 
-  BlockHandle filter_block_handle, metaindex_block_handle, index_block_handle;
+  BlockHandle filter_block_handle, metaindex_block_handle, index_block_handle,
+      dictionary_block_handle, properties_block_handle;
 
-  // Write filter block
-  if (ok() && r->filter_block != nullptr) {
-    WriteRawBlock(r->filter_block->Finish(), kNoCompression,
-                  &filter_block_handle);
+  // Write the last index and filter partition
+  if (ok() && r->partitioned && r->pending_index_entry) {
+    r->options.comparator->FindShortSuccessor(&r->last_key);
+    std::string handle_encoding;
+    r->pending_handle.EncodeTo(&handle_encoding);
+    r->index_block.Add(r->last_key, Slice(handle_encoding));
+    r->pending_index_entry = false;
+    WritePartition();
   }
 
-  // Write metaindex block
-  if (ok()) {
-    BlockBuilder meta_index_block(&r->options);
-    if (r->filter_block != nullptr) {
-      // Add mapping from "filter.Name" to location of filter data
-      std::string key = "filter.";
-      key.append(r->options.filter_policy->Name());
-      std::string handle_encoding;
-      filter_block_handle.EncodeTo(&handle_encoding);
-      meta_index_block.Add(key, handle_encoding);
+  // Write filter block, or the top-level index of the filter partitions
+  if (ok() && r->filter_block != nullptr) {
+    if (r->partitioned) {
+      WriteBlock(&r->top_level_filter_index_block, &filter_block_handle);
+    } else {
+      WriteRawBlock(r->filter_block->Finish(), kNoCompression,
+                    &filter_block_handle);
+    }
+    if (ok()) {
+      r->properties.filter_size +=
+          filter_block_handle.size() + kBlockTrailerSize;
     }
+  }
 
-    // TODO(postrelease): Add stats and other meta blocks
-    WriteBlock(&meta_index_block, &metaindex_block_handle);
+  // Write compression dictionary block
+  if (ok() && r->used_dictionary) {
+    WriteRawBlock(*r->options.compression_dictionary, kNoCompression,
+                  &dictionary_block_handle);
   }
 
-  // Write index block
+  // Write index block.  It comes before the properties, which include its
+  // size.
   if (ok()) {
     if (r->pending_index_entry) {
       r->options.comparator->FindShortSuccessor(&r->last_key);
@@ -234,7 +342,53 @@ Status TableBuilder::Finish() {
       r->index_block.Add(r->last_key, Slice(handle_encoding));
       r->pending_index_entry = false;
     }
-    WriteBlock(&r->index_block, &index_block_handle);
+    WriteBlock(r->partitioned ? &r->top_level_index_block : &r->index_block,
+               &index_block_handle);
+    if (ok()) {
+      r->properties.index_size +=
+          index_block_handle.size() + kBlockTrailerSize;
+    }
+  }
+
+  // Write properties block
+  if (ok()) {
+    r->properties.num_entries = r->num_entries;
+    std::string properties_encoding;
+    EncodeTableProperties(r->properties, &properties_encoding);
+    WriteRawBlock(properties_encoding, kNoCompression,
+                  &properties_block_handle);
+  }
+
+  // Write metaindex block
+  if (ok()) {
+    Options meta_index_options = r->options;
+    meta_index_options.data_block_hash_index = false;
+    meta_index_options.adaptive_block_restarts = false;
+    meta_index_options.comparator = BytewiseComparator();
+    BlockBuilder meta_index_block(&meta_index_options);
+    if (r->used_dictionary) {
+      std::string handle_encoding;
+      dictionary_block_handle.EncodeTo(&handle_encoding);
+      meta_index_block.Add(kCompressionDictionaryKey, handle_encoding);
+    }
+    std::string filter_key;
+    std::string filter_handle_encoding;
+    if (r->filter_block != nullptr) {
+      // Add mapping from "filter.Name" to location of filter data
+      filter_key = r->partitioned ? kPartitionedFilterPrefix : "filter.";
+      filter_key.append(r->options.filter_policy->Name());
+      filter_block_handle.EncodeTo(&filter_handle_encoding);
+    }
+    if (!filter_key.empty() && !r->partitioned) {
+      meta_index_block.Add(filter_key, filter_handle_encoding);
+    }
+    std::string properties_handle_encoding;
+    properties_block_handle.EncodeTo(&properties_handle_encoding);
+    meta_index_block.Add(kPropertiesBlockKey, properties_handle_encoding);
+    if (!filter_key.empty() && r->partitioned) {
+      meta_index_block.Add(filter_key, filter_handle_encoding);
+    }
+    WriteBlock(&meta_index_block, &metaindex_block_handle);
   }
 
   // Write footer
@@ -242,6 +396,7 @@ Status TableBuilder::Finish() {
     Footer footer;
     footer.set_metaindex_handle(metaindex_block_handle);
     footer.set_index_handle(index_block_handle);
+    footer.set_partitioned_index(r->partitioned);
     std::string footer_encoding;
     footer.EncodeTo(&footer_encoding);
     r->status = r->file->Append(footer_encoding);
@@ -4,6 +4,7 @@
 
 #include "table/two_level_iterator.h"
 
+#include "leveldb/comparator.h"
 #include "leveldb/table.h"
 #include "table/block.h"
 #include "table/format.h"
@@ -18,7 +19,8 @@ typedef Iterator* (*BlockFunction)(void*, const ReadOptions&, const Slice&);
 class TwoLevelIterator : public Iterator {
  public:
   TwoLevelIterator(Iterator* index_iter, BlockFunction block_function,
-                   void* arg, const ReadOptions& options);
+                   void* arg, const ReadOptions& options,
+                   const Comparator* comparator);
 
   virtual ~TwoLevelIterator();
 
@@ -54,12 +56,14 @@ class TwoLevelIterator : public Iterator {
   }
   void SkipEmptyDataBlocksForward();
   void SkipEmptyDataBlocksBackward();
+  bool PastUpperBound() const;
   void SetDataIterator(Iterator* data_iter);
   void InitDataBlock();
 
   BlockFunction block_function_;
   void* arg_;
   const ReadOptions options_;
+  const Comparator* const comparator_;
   Status status_;
   IteratorWrapper index_iter_;
   IteratorWrapper data_iter_;  // May be nullptr
@@ -70,10 +74,13 @@ class TwoLevelIterator : public Iterator {
 
 TwoLevelIterator::TwoLevelIterator(Iterator* index_iter,
                                    BlockFunction block_function, void* arg,
-                                   const ReadOptions& options)
+                                   const ReadOptions& options,
+                                   const Comparator* comparator)
     : block_function_(block_function),
       arg_(arg),
       options_(options),
+      comparator_(options.iterate_upper_bound != nullptr ? comparator
+                                                         : nullptr),
       index_iter_(index_iter),
       data_iter_(nullptr) {}
 
@@ -115,7 +122,7 @@ void TwoLevelIterator::Prev() {
 void TwoLevelIterator::SkipEmptyDataBlocksForward() {
   while (data_iter_.iter() == nullptr || !data_iter_.Valid()) {
     // Move to next block
-    if (!index_iter_.Valid()) {
+    if (!index_iter_.Valid() || PastUpperBound()) {
       SetDataIterator(nullptr);
       return;
     }
@@ -125,6 +132,15 @@ void TwoLevelIterator::SkipEmptyDataBlocksForward() {
   }
 }
 
+// The index key of a block is at or past all of its keys and before all
+// keys of the next block, so once it reaches the bound no later block holds
+// a key before the bound.
+bool TwoLevelIterator::PastUpperBound() const {
+  return comparator_ != nullptr &&
+         comparator_->Compare(index_iter_.key(),
+                              *options_.iterate_upper_bound) >= 0;
+}
+
 void TwoLevelIterator::SkipEmptyDataBlocksBackward() {
   while (data_iter_.iter() == nullptr || !data_iter_.Valid()) {
     // Move to next block
@@ -164,8 +180,10 @@ void TwoLevelIterator::InitDataBlock() {
 
 Iterator* NewTwoLevelIterator(Iterator* index_iter,
                               BlockFunction block_function, void* arg,
-                              const ReadOptions& options) {
-  return new TwoLevelIterator(index_iter, block_function, arg, options);
+                              const ReadOptions& options,
+                              const Comparator* comparator) {
+  return new TwoLevelIterator(index_iter, block_function, arg, options,
+                              comparator);
 }
 
 }  // namespace leveldb
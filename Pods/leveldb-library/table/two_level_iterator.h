@@ -9,6 +9,7 @@
 
 namespace leveldb {
 
+class Comparator;
 struct ReadOptions;
 
 // Return a new two level iterator.  A two-level iterator contains an
@@ -20,11 +21,17 @@ struct ReadOptions;
 //
 // Uses a supplied function to convert an index_iter value into
 // an iterator over the contents of the corresponding block.
+//
+// If options.iterate_upper_bound is set and "comparator" (which orders
+// the index keys) is non-null, moving forward stops at the end of the
+// first block whose index key is at or past the bound rather than
+// reading the blocks after it.
 Iterator* NewTwoLevelIterator(
     Iterator* index_iter,
     Iterator* (*block_function)(void* arg, const ReadOptions& options,
                                 const Slice& index_value),
-    void* arg, const ReadOptions& options);
+    void* arg, const ReadOptions& options,
+    const Comparator* comparator = nullptr);
 
 }  // namespace leveldb
 
@@ -4,61 +4,168 @@
 
 #include "util/arena.h"
 
+#if defined(LEVELDB_PLATFORM_POSIX)
+#include <sys/mman.h>
+#endif  // defined(LEVELDB_PLATFORM_POSIX)
+
+#include <algorithm>
+#include <new>
+
+#include "util/mutexlock.h"
+
 namespace leveldb {
 
-static const int kBlockSize = 4096;
+static const size_t kAlign = (sizeof(void*) > 8) ? sizeof(void*) : 8;
+static_assert((kAlign & (kAlign - 1)) == 0,
+              "Pointer size should be a power of 2");
 
-Arena::Arena()
-    : alloc_ptr_(nullptr), alloc_bytes_remaining_(0), memory_usage_(0) {}
+static size_t RoundUp(size_t n, size_t multiple) {
+  return (n + multiple - 1) / multiple * multiple;
+}
+
+Arena::Arena() : Arena(kDefaultBlockSize, 0) {}
+
+Arena::Arena(size_t block_size, size_t huge_page_size)
+    : block_size_(huge_page_size == 0 ? block_size
+                                      : RoundUp(block_size, huge_page_size)),
+      huge_page_size_(huge_page_size),
+      current_(&empty_block_),
+      memory_usage_(0) {
+  empty_block_.used.store(0, std::memory_order_relaxed);
+  empty_block_.size = 0;
+}
 
 Arena::~Arena() {
-  for (size_t i = 0; i < blocks_.size(); i++) {
-    delete[] blocks_[i];
+  for (const Memory& memory : memory_) {
+#if defined(MAP_HUGETLB)
+    if (memory.mapped_size != 0) {
+      ::munmap(memory.data, memory.mapped_size);
+      continue;
+    }
+#endif  // defined(MAP_HUGETLB)
+    delete[] memory.data;
   }
 }
 
+size_t Arena::MemoryUsage() const {
+  // A block is counted in memory_usage_ before it becomes current_.
+  const Block* block = current_.load(std::memory_order_acquire);
+  const size_t unused =
+      block->size - block->used.load(std::memory_order_relaxed);
+  return memory_usage_.load(std::memory_order_relaxed) - unused;
+}
+
 char* Arena::AllocateFallback(size_t bytes) {
-  if (bytes > kBlockSize / 4) {
+  if (bytes > block_size_ / 4) {
     // Object is more than a quarter of our block size.  Allocate it separately
     // to avoid wasting too much space in leftover bytes.
-    char* result = AllocateNewBlock(bytes);
+    char* result = AllocateMemory(bytes, false);
     return result;
   }
 
   // We waste the remaining space in the current block.
-  alloc_ptr_ = AllocateNewBlock(kBlockSize);
-  alloc_bytes_remaining_ = kBlockSize;
-
-  char* result = alloc_ptr_;
-  alloc_ptr_ += bytes;
-  alloc_bytes_remaining_ -= bytes;
-  return result;
+  Block* block =
+      reinterpret_cast<Block*>(AllocateNewBlock(block_size_ - sizeof(Block)));
+  block->used.store(bytes, std::memory_order_relaxed);
+  current_.store(block, std::memory_order_release);
+  return block->data();
 }
 
 char* Arena::AllocateAligned(size_t bytes) {
-  const int align = (sizeof(void*) > 8) ? sizeof(void*) : 8;
-  static_assert((align & (align - 1)) == 0,
-                "Pointer size should be a power of 2");
-  size_t current_mod = reinterpret_cast<uintptr_t>(alloc_ptr_) & (align - 1);
-  size_t slop = (current_mod == 0 ? 0 : align - current_mod);
-  size_t needed = bytes + slop;
+  Block* block = current_.load(std::memory_order_relaxed);
+  const size_t used = block->used.load(std::memory_order_relaxed);
+  const size_t start = RoundUp(used, kAlign);
   char* result;
-  if (needed <= alloc_bytes_remaining_) {
-    result = alloc_ptr_ + slop;
-    alloc_ptr_ += needed;
-    alloc_bytes_remaining_ -= needed;
+  if (start + bytes <= block->size) {
+    block->used.store(start + bytes, std::memory_order_relaxed);
+    result = block->data() + start;
   } else {
     // AllocateFallback always returned aligned memory
     result = AllocateFallback(bytes);
   }
-  assert((reinterpret_cast<uintptr_t>(result) & (align - 1)) == 0);
+  assert((reinterpret_cast<uintptr_t>(result) & (kAlign - 1)) == 0);
   return result;
 }
 
+char* Arena::AllocateConcurrently(size_t bytes) {
+  return AllocateConcurrently(bytes, false);
+}
+
+char* Arena::AllocateAlignedConcurrently(size_t bytes) {
+  return AllocateConcurrently(bytes, true);
+}
+
+char* Arena::TryAllocateConcurrently(Block* block, size_t bytes,
+                                     bool aligned) {
+  size_t used = block->used.load(std::memory_order_relaxed);
+  while (true) {
+    const size_t start = aligned ? RoundUp(used, kAlign) : used;
+    if (start + bytes > block->size) {
+      return nullptr;
+    }
+    if (block->used.compare_exchange_weak(used, start + bytes,
+                                          std::memory_order_relaxed)) {
+      return block->data() + start;
+    }
+  }
+}
+
+char* Arena::AllocateConcurrently(size_t bytes, bool aligned) {
+  assert(bytes > 0);
+  const bool small = bytes <= block_size_ / 4;
+  if (small) {
+    char* result = TryAllocateConcurrently(
+        current_.load(std::memory_order_acquire), bytes, aligned);
+    if (result != nullptr) {
+      return result;
+    }
+  }
+
+  MutexLock l(&mutex_);
+  if (small) {
+    // Another thread may have replaced the block meanwhile.  current_ only
+    // changes under mutex_ now.
+    char* result = TryAllocateConcurrently(
+        current_.load(std::memory_order_relaxed), bytes, aligned);
+    if (result != nullptr) {
+      return result;
+    }
+  }
+  return AllocateFallback(bytes);
+}
+
 char* Arena::AllocateNewBlock(size_t block_bytes) {
-  char* result = new char[block_bytes];
-  blocks_.push_back(result);
-  memory_usage_.fetch_add(block_bytes + sizeof(char*),
+  char* result = AllocateMemory(sizeof(Block) + block_bytes,
+                                huge_page_size_ != 0);
+  Block* block = new (result) Block;
+  block->used.store(0, std::memory_order_relaxed);
+  block->size = block_bytes;
+  return result;
+}
+
+char* Arena::AllocateMemory(size_t bytes, bool huge_pages) {
+  char* result = nullptr;
+  size_t mapped_size = 0;
+#if defined(MAP_HUGETLB)
+  if (huge_pages) {
+    mapped_size = RoundUp(bytes, huge_page_size_);
+    void* memory = ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE,
+                          MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (memory == MAP_FAILED) {
+      // Huge pages are a scarce, separately reserved resource.
+      mapped_size = 0;
+    } else {
+      result = reinterpret_cast<char*>(memory);
+    }
+  }
+#else
+  (void)huge_pages;
+#endif  // defined(MAP_HUGETLB)
+  if (result == nullptr) {
+    result = new char[bytes];
+  }
+  memory_.push_back(Memory{result, mapped_size});
+  memory_usage_.fetch_add(std::max(bytes, mapped_size) + sizeof(Memory),
                           std::memory_order_relaxed);
   return result;
 }
@@ -11,12 +11,23 @@
 #include <cstdint>
 #include <vector>
 
+#include "port/port.h"
+#include "port/thread_annotations.h"
+
 namespace leveldb {
 
 class Arena {
  public:
+  static const size_t kDefaultBlockSize = 4096;
+
   Arena();
 
+  // Allocates memory in blocks of block_size bytes.  If huge_page_size is
+  // non-zero, blocks are rounded up to a multiple of it and backed by huge
+  // pages where the platform supports them, which saves TLB misses on
+  // large memtables.
+  Arena(size_t block_size, size_t huge_page_size);
+
   Arena(const Arena&) = delete;
   Arena& operator=(const Arena&) = delete;
 
@@ -28,28 +39,61 @@ class Arena {
   // Allocate memory with the normal alignment guarantees provided by malloc.
   char* AllocateAligned(size_t bytes);
 
+  // Like Allocate() and AllocateAligned(), but may be called from several
+  // threads at once, as long as none of them uses the variants above at the
+  // same time.  Allocations that fit into the current block take no lock.
+  char* AllocateConcurrently(size_t bytes) LOCKS_EXCLUDED(mutex_);
+  char* AllocateAlignedConcurrently(size_t bytes) LOCKS_EXCLUDED(mutex_);
+
   // Returns an estimate of the total memory usage of data allocated
-  // by the arena.
-  size_t MemoryUsage() const {
-    return memory_usage_.load(std::memory_order_relaxed);
-  }
+  // by the arena.  The unused tail of the current block is not counted, so
+  // that the estimate does not jump by a block at a time.  May be called
+  // concurrently with allocations.
+  size_t MemoryUsage() const;
 
  private:
+  // The header of a block that small allocations are carved from, followed
+  // by the memory of the block.
+  struct Block {
+    std::atomic<size_t> used;
+    size_t size;
+
+    char* data() { return reinterpret_cast<char*>(this + 1); }
+  };
+
+  // Memory of the arena, and the size it was mapped with if it is backed
+  // by huge pages, or zero.
+  struct Memory {
+    char* data;
+    size_t mapped_size;
+  };
+
   char* AllocateFallback(size_t bytes);
   char* AllocateNewBlock(size_t block_bytes);
+  char* AllocateMemory(size_t bytes, bool huge_pages);
+  char* AllocateConcurrently(size_t bytes, bool aligned)
+      LOCKS_EXCLUDED(mutex_);
+
+  // Carves bytes from block, or returns null if they do not fit.
+  static char* TryAllocateConcurrently(Block* block, size_t bytes,
+                                       bool aligned);
 
-  // Allocation state
-  char* alloc_ptr_;
-  size_t alloc_bytes_remaining_;
+  const size_t block_size_;
+  const size_t huge_page_size_;
 
-  // Array of new[] allocated memory blocks
-  std::vector<char*> blocks_;
+  // The block that small allocations are carved from.  Points to
+  // empty_block_ until the first of them.
+  std::atomic<Block*> current_;
+  Block empty_block_;
+
+  std::vector<Memory> memory_;
 
   // Total memory usage of the arena.
-  //
-  // TODO(costan): This member is accessed via atomics, but the others are
-  //               accessed without any locking. Is this OK?
   std::atomic<size_t> memory_usage_;
+
+  // Serializes the concurrent allocation variants when they need memory
+  // from outside the current block.
+  port::Mutex mutex_;
 };
 
 inline char* Arena::Allocate(size_t bytes) {
@@ -57,11 +101,11 @@ inline char* Arena::Allocate(size_t bytes) {
   // 0-byte allocations, so we disallow them here (we don't need
   // them for our internal use).
   assert(bytes > 0);
-  if (bytes <= alloc_bytes_remaining_) {
-    char* result = alloc_ptr_;
-    alloc_ptr_ += bytes;
-    alloc_bytes_remaining_ -= bytes;
-    return result;
+  Block* block = current_.load(std::memory_order_relaxed);
+  const size_t used = block->used.load(std::memory_order_relaxed);
+  if (used + bytes <= block->size) {
+    block->used.store(used + bytes, std::memory_order_relaxed);
+    return block->data() + used;
   }
   return AllocateFallback(bytes);
 }
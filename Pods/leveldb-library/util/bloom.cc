@@ -4,7 +4,10 @@
 
 #include "leveldb/filter_policy.h"
 
+#include <vector>
+
 #include "leveldb/slice.h"
+#include "util/coding.h"
 #include "util/hash.h"
 
 namespace leveldb {
@@ -14,74 +17,247 @@ static uint32_t BloomHash(const Slice& key) {
   return Hash(key.data(), key.size(), 0xbc9f1d34);
 }
 
+// Prefixes are hashed with another seed so that a prefix does not match a
+// whole key that is equal to it.
+static uint32_t PrefixBloomHash(const Slice& prefix) {
+  return Hash(prefix.data(), prefix.size(), 0x5f3759df);
+}
+
+// Use the bits per entry to compute the number of probes.
+static size_t ProbesPerEntry(int bits_per_key) {
+  // We intentionally round down to reduce probing cost a little bit
+  size_t k = static_cast<size_t>(bits_per_key * 0.69);  // 0.69 =~ ln(2)
+  if (k < 1) k = 1;
+  if (k > 30) k = 30;
+  return k;
+}
+
+// Append a bloom filter of the given hashes to *dst.
+static void AppendBloomFilter(const uint32_t* hashes, size_t n,
+                              size_t bits_per_key, size_t k,
+                              std::string* dst) {
+  // Compute bloom filter size (in both bits and bytes)
+  size_t bits = n * bits_per_key;
+
+  // For small n, we can see a very high false positive rate.  Fix it
+  // by enforcing a minimum bloom filter length.
+  if (bits < 64) bits = 64;
+
+  size_t bytes = (bits + 7) / 8;
+  bits = bytes * 8;
+
+  const size_t init_size = dst->size();
+  dst->resize(init_size + bytes, 0);
+  dst->push_back(static_cast<char>(k));  // Remember # of probes in filter
+  char* array = &(*dst)[init_size];
+  for (size_t i = 0; i < n; i++) {
+    // Use double-hashing to generate a sequence of hash values.
+    // See analysis in [Kirsch,Mitzenmacher 2006].
+    uint32_t h = hashes[i];
+    const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
+    for (size_t j = 0; j < k; j++) {
+      const uint32_t bitpos = h % bits;
+      array[bitpos / 8] |= (1 << (bitpos % 8));
+      h += delta;
+    }
+  }
+}
+
+static bool BloomFilterMayContain(uint32_t h, const Slice& bloom_filter) {
+  const size_t len = bloom_filter.size();
+  if (len < 2) return false;
+
+  const char* array = bloom_filter.data();
+  const size_t bits = (len - 1) * 8;
+
+  // Use the encoded k so that we can read filters generated by
+  // bloom filters created using different parameters.
+  const size_t k = array[len - 1];
+  if (k > 30) {
+    // Reserved for potentially new encodings for short bloom filters.
+    // Consider it a match.
+    return true;
+  }
+
+  const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
+  for (size_t j = 0; j < k; j++) {
+    const uint32_t bitpos = h % bits;
+    if ((array[bitpos / 8] & (1 << (bitpos % 8))) == 0) return false;
+    h += delta;
+  }
+  return true;
+}
+
 class BloomFilterPolicy : public FilterPolicy {
  public:
-  explicit BloomFilterPolicy(int bits_per_key) : bits_per_key_(bits_per_key) {
-    // We intentionally round down to reduce probing cost a little bit
-    k_ = static_cast<size_t>(bits_per_key * 0.69);  // 0.69 =~ ln(2)
-    if (k_ < 1) k_ = 1;
-    if (k_ > 30) k_ = 30;
-  }
+  explicit BloomFilterPolicy(int bits_per_key)
+      : bits_per_key_(bits_per_key), k_(ProbesPerEntry(bits_per_key)) {}
 
   virtual const char* Name() const { return "leveldb.BuiltinBloomFilter2"; }
 
   virtual void CreateFilter(const Slice* keys, int n, std::string* dst) const {
-    // Compute bloom filter size (in both bits and bytes)
-    size_t bits = n * bits_per_key_;
+    std::vector<uint32_t> hashes(n);
+    for (int i = 0; i < n; i++) {
+      hashes[i] = BloomHash(keys[i]);
+    }
+    AppendBloomFilter(hashes.data(), hashes.size(), bits_per_key_, k_, dst);
+  }
+
+  virtual bool KeyMayMatch(const Slice& key, const Slice& bloom_filter) const {
+    return BloomFilterMayContain(BloomHash(key), bloom_filter);
+  }
+
+ private:
+  size_t bits_per_key_;
+  size_t k_;
+};
+
+// A bloom filter made of 64-byte blocks the size of a cache line, each of
+// which is a small bloom filter of its own.  A key hashes to one block and
+// sets all its bits there, so a lookup touches a single cache line.
+//
+// The filter is followed by the number of probes per key.
+static const size_t kBloomBlockBytes = 64;
+static const size_t kBloomBlockWords = kBloomBlockBytes / 8;
 
-    // For small n, we can see a very high false positive rate.  Fix it
-    // by enforcing a minimum bloom filter length.
-    if (bits < 64) bits = 64;
+class BlockedBloomFilterPolicy : public FilterPolicy {
+ public:
+  explicit BlockedBloomFilterPolicy(int bits_per_key)
+      : bits_per_key_(bits_per_key), k_(ProbesPerEntry(bits_per_key)) {}
 
-    size_t bytes = (bits + 7) / 8;
-    bits = bytes * 8;
+  virtual const char* Name() const { return "leveldb.BlockedBloomFilter1"; }
+
+  virtual void CreateFilter(const Slice* keys, int n, std::string* dst) const {
+    size_t bits = n * bits_per_key_;
+    size_t blocks = (bits + kBloomBlockBytes * 8 - 1) / (kBloomBlockBytes * 8);
+    if (blocks < 1) blocks = 1;
 
     const size_t init_size = dst->size();
-    dst->resize(init_size + bytes, 0);
+    dst->resize(init_size + blocks * kBloomBlockBytes, 0);
     dst->push_back(static_cast<char>(k_));  // Remember # of probes in filter
     char* array = &(*dst)[init_size];
     for (int i = 0; i < n; i++) {
-      // Use double-hashing to generate a sequence of hash values.
-      // See analysis in [Kirsch,Mitzenmacher 2006].
-      uint32_t h = BloomHash(keys[i]);
-      const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
-      for (size_t j = 0; j < k_; j++) {
-        const uint32_t bitpos = h % bits;
-        array[bitpos / 8] |= (1 << (bitpos % 8));
-        h += delta;
+      const uint32_t h = BloomHash(keys[i]);
+      char* block = array + BlockIndex(h, blocks) * kBloomBlockBytes;
+      uint64_t masks[kBloomBlockWords];
+      ProbeMasks(h, k_, masks);
+      for (size_t w = 0; w < kBloomBlockWords; w++) {
+        EncodeFixed64(block + w * 8, DecodeFixed64(block + w * 8) | masks[w]);
       }
     }
   }
 
   virtual bool KeyMayMatch(const Slice& key, const Slice& bloom_filter) const {
     const size_t len = bloom_filter.size();
-    if (len < 2) return false;
-
-    const char* array = bloom_filter.data();
-    const size_t bits = (len - 1) * 8;
+    if (len < kBloomBlockBytes + 1) return false;
 
-    // Use the encoded k so that we can read filters generated by
-    // bloom filters created using different parameters.
-    const size_t k = array[len - 1];
-    if (k > 30) {
-      // Reserved for potentially new encodings for short bloom filters.
-      // Consider it a match.
+    const size_t blocks = (len - 1) / kBloomBlockBytes;
+    const size_t k = bloom_filter[len - 1];
+    if (k < 1 || k > 30) {
+      // Reserved for potentially new encodings.  Consider it a match.
       return true;
     }
 
-    uint32_t h = BloomHash(key);
-    const uint32_t delta = (h >> 17) | (h << 15);  // Rotate right 17 bits
+    const uint32_t h = BloomHash(key);
+    const char* block =
+        bloom_filter.data() + BlockIndex(h, blocks) * kBloomBlockBytes;
+    uint64_t masks[kBloomBlockWords];
+    ProbeMasks(h, k, masks);
+
+    // Check all words of the block without branching, which compilers can
+    // vectorize.
+    uint64_t missing = 0;
+    for (size_t w = 0; w < kBloomBlockWords; w++) {
+      missing |= masks[w] & ~DecodeFixed64(block + w * 8);
+    }
+    return missing == 0;
+  }
+
+ private:
+  // Map the hash uniformly onto [0, blocks) without a division.
+  static size_t BlockIndex(uint32_t h, size_t blocks) {
+    return static_cast<size_t>((static_cast<uint64_t>(h) * blocks) >> 32);
+  }
+
+  // Set the k bits of the block that the hash probes in masks, one word of
+  // the block per mask.
+  static void ProbeMasks(uint32_t h, size_t k,
+                         uint64_t masks[kBloomBlockWords]) {
+    for (size_t w = 0; w < kBloomBlockWords; w++) {
+      masks[w] = 0;
+    }
+    // Derive the probes from bits of the hash that BlockIndex() does not
+    // depend on as much, by double hashing a remix of it.
+    uint64_t a = static_cast<uint64_t>(h) * 0x9e3779b97f4a7c15ull;
+    const uint64_t b = (static_cast<uint64_t>(h) * 0xc2b2ae3d27d4eb4full) | 1;
     for (size_t j = 0; j < k; j++) {
-      const uint32_t bitpos = h % bits;
-      if ((array[bitpos / 8] & (1 << (bitpos % 8))) == 0) return false;
-      h += delta;
+      const uint32_t bitpos = static_cast<uint32_t>(a >> 55);  // 0..511
+      masks[bitpos / 64] |= uint64_t{1} << (bitpos % 64);
+      a += b;
     }
-    return true;
+  }
+
+  size_t bits_per_key_;
+  size_t k_;
+};
+
+class PrefixBloomFilterPolicy : public FilterPolicy {
+ public:
+  PrefixBloomFilterPolicy(int bits_per_key, const PrefixExtractor* extractor,
+                          bool whole_key_filtering)
+      : bits_per_key_(bits_per_key),
+        k_(ProbesPerEntry(bits_per_key)),
+        extractor_(extractor),
+        whole_key_filtering_(whole_key_filtering),
+        name_(std::string("leveldb.PrefixBloomFilter.") +
+              (whole_key_filtering ? "WholeKey." : "") + extractor->Name()) {}
+
+  virtual const char* Name() const { return name_.c_str(); }
+
+  virtual void CreateFilter(const Slice* keys, int n, std::string* dst) const {
+    std::vector<uint32_t> hashes;
+    hashes.reserve(whole_key_filtering_ ? 2 * n : n);
+    Slice last_prefix;
+    bool has_last_prefix = false;
+    for (int i = 0; i < n; i++) {
+      if (whole_key_filtering_) {
+        hashes.push_back(BloomHash(keys[i]));
+      }
+      if (extractor_->InDomain(keys[i])) {
+        // Keys are sorted, so keys that share a prefix are adjacent.
+        Slice prefix = extractor_->Transform(keys[i]);
+        if (!has_last_prefix || prefix != last_prefix) {
+          hashes.push_back(PrefixBloomHash(prefix));
+          last_prefix = prefix;
+          has_last_prefix = true;
+        }
+      }
+    }
+    AppendBloomFilter(hashes.data(), hashes.size(), bits_per_key_, k_, dst);
+  }
+
+  virtual bool KeyMayMatch(const Slice& key, const Slice& bloom_filter) const {
+    if (whole_key_filtering_) {
+      return BloomFilterMayContain(BloomHash(key), bloom_filter);
+    }
+    return PrefixMayMatch(key, bloom_filter);
+  }
+
+  virtual bool PrefixMayMatch(const Slice& key,
+                              const Slice& bloom_filter) const {
+    if (!extractor_->InDomain(key)) {
+      return true;
+    }
+    return BloomFilterMayContain(PrefixBloomHash(extractor_->Transform(key)),
+                                 bloom_filter);
   }
 
  private:
   size_t bits_per_key_;
   size_t k_;
+  const PrefixExtractor* extractor_;
+  bool whole_key_filtering_;
+  std::string name_;
 };
 }  // namespace
 
@@ -89,4 +265,15 @@ const FilterPolicy* NewBloomFilterPolicy(int bits_per_key) {
   return new BloomFilterPolicy(bits_per_key);
 }
 
+const FilterPolicy* NewBlockedBloomFilterPolicy(int bits_per_key) {
+  return new BlockedBloomFilterPolicy(bits_per_key);
+}
+
+const FilterPolicy* NewPrefixBloomFilterPolicy(int bits_per_key,
+                                               const PrefixExtractor* extractor,
+                                               bool whole_key_filtering) {
+  return new PrefixBloomFilterPolicy(bits_per_key, extractor,
+                                     whole_key_filtering);
+}
+
 }  // namespace leveldb
@@ -6,6 +6,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 
+#include <initializer_list>
+
 #include "leveldb/cache.h"
 #include "port/port.h"
 #include "port/thread_annotations.h"
@@ -33,9 +35,16 @@ namespace {
 //   removed the check, elements that would otherwise be on this list could be
 //   left as disconnected singleton lists.)
 // - LRU:  contains the items not currently referenced by clients, in LRU order
+// - probation:  like LRU, for the items that have not been looked up since
+//   they were inserted, if the cache is scan-resistant or they were inserted
+//   with low priority.  Eviction takes items from this list first.
 // Elements are moved between these lists by the Ref() and Unref() methods,
 // when they detect an element in the cache acquiring or losing its only
 // external reference.
+//
+// A scan-resistant cache also bounds the charge of the items that were looked
+// up (the protected segment), and moves the oldest of them back to probation
+// to stay within it.
 
 // An entry is a variable length heap-allocated structure.  Entries
 // are kept in a circular doubly linked list ordered by access time.
@@ -48,6 +57,8 @@ struct LRUHandle {
   size_t charge;  // TODO(opt): Only allow uint32_t?
   size_t key_length;
   bool in_cache;     // Whether entry is in the cache.
+  bool low_priority;  // Whether entry was inserted with Priority::kLow.
+  bool looked_up;    // Whether entry was looked up since it was inserted.
   uint32_t refs;     // References, including cache reference, if present.
   uint32_t hash;     // Hash of key(); used for fast sharding and comparisons
   char key_data[1];  // Beginning of key
@@ -153,12 +164,18 @@ class LRUCache {
   ~LRUCache();
 
   // Separate from constructor so caller can easily make an array of LRUCache
-  void SetCapacity(size_t capacity) { capacity_ = capacity; }
+  void SetCapacity(size_t capacity, bool scan_resistant) {
+    capacity_ = capacity;
+    scan_resistant_ = scan_resistant;
+    protected_capacity_ =
+        static_cast<size_t>(static_cast<double>(capacity) * 0.8);
+  }
 
   // Like Cache methods, but with an extra "hash" parameter.
   Cache::Handle* Insert(const Slice& key, uint32_t hash, void* value,
                         size_t charge,
-                        void (*deleter)(const Slice& key, void* value));
+                        void (*deleter)(const Slice& key, void* value),
+                        Cache::Priority priority);
   Cache::Handle* Lookup(const Slice& key, uint32_t hash);
   void Release(Cache::Handle* handle);
   void Erase(const Slice& key, uint32_t hash);
@@ -175,8 +192,19 @@ class LRUCache {
   void Unref(LRUHandle* e);
   bool FinishErase(LRUHandle* e) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
 
+  // Whether the unreferenced entry "e" belongs in probation_ rather than lru_.
+  bool OnProbation(const LRUHandle* e) const {
+    return !e->looked_up && (scan_resistant_ || e->low_priority);
+  }
+
+  // Moves the oldest looked up entries back to probation until the protected
+  // segment fits its capacity.
+  void DemoteProtected() EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
   // Initialized before use.
   size_t capacity_;
+  size_t protected_capacity_;
+  bool scan_resistant_;
 
   // mutex_ protects the following state.
   mutable port::Mutex mutex_;
@@ -187,6 +215,13 @@ class LRUCache {
   // Entries have refs==1 and in_cache==true.
   LRUHandle lru_ GUARDED_BY(mutex_);
 
+  // Dummy head of probation list, ordered like lru_.
+  LRUHandle probation_ GUARDED_BY(mutex_);
+
+  // The charge of the entries that are in the cache and were looked up, if
+  // the cache is scan-resistant.
+  size_t protected_usage_ GUARDED_BY(mutex_);
+
   // Dummy head of in-use list.
   // Entries are in use by clients, and have refs >= 2 and in_cache==true.
   LRUHandle in_use_ GUARDED_BY(mutex_);
@@ -194,23 +229,32 @@ class LRUCache {
   HandleTable table_ GUARDED_BY(mutex_);
 };
 
-LRUCache::LRUCache() : capacity_(0), usage_(0) {
+LRUCache::LRUCache()
+    : capacity_(0),
+      protected_capacity_(0),
+      scan_resistant_(false),
+      usage_(0),
+      protected_usage_(0) {
   // Make empty circular linked lists.
   lru_.next = &lru_;
   lru_.prev = &lru_;
+  probation_.next = &probation_;
+  probation_.prev = &probation_;
   in_use_.next = &in_use_;
   in_use_.prev = &in_use_;
 }
 
 LRUCache::~LRUCache() {
   assert(in_use_.next == &in_use_);  // Error if caller has an unreleased handle
-  for (LRUHandle* e = lru_.next; e != &lru_;) {
-    LRUHandle* next = e->next;
-    assert(e->in_cache);
-    e->in_cache = false;
-    assert(e->refs == 1);  // Invariant of lru_ list.
-    Unref(e);
-    e = next;
+  for (LRUHandle* list : {&probation_, &lru_}) {
+    for (LRUHandle* e = list->next; e != list;) {
+      LRUHandle* next = e->next;
+      assert(e->in_cache);
+      e->in_cache = false;
+      assert(e->refs == 1);  // Invariant of lru_ and probation_ lists.
+      Unref(e);
+      e = next;
+    }
   }
 }
 
@@ -230,9 +274,9 @@ void LRUCache::Unref(LRUHandle* e) {
     (*e->deleter)(e->key(), e->value);
     free(e);
   } else if (e->in_cache && e->refs == 1) {
-    // No longer in use; move to lru_ list.
+    // No longer in use; move to lru_ or probation_ list.
     LRU_Remove(e);
-    LRU_Append(&lru_, e);
+    LRU_Append(OnProbation(e) ? &probation_ : &lru_, e);
   }
 }
 
@@ -254,10 +298,28 @@ Cache::Handle* LRUCache::Lookup(const Slice& key, uint32_t hash) {
   LRUHandle* e = table_.Lookup(key, hash);
   if (e != nullptr) {
     Ref(e);
+    if (!e->looked_up) {
+      e->looked_up = true;
+      if (scan_resistant_) {
+        protected_usage_ += e->charge;
+        DemoteProtected();
+      }
+    }
   }
   return reinterpret_cast<Cache::Handle*>(e);
 }
 
+void LRUCache::DemoteProtected() {
+  while (protected_usage_ > protected_capacity_ && lru_.next != &lru_) {
+    LRUHandle* old = lru_.next;
+    assert(old->refs == 1 && old->looked_up);
+    old->looked_up = false;
+    protected_usage_ -= old->charge;
+    LRU_Remove(old);
+    LRU_Append(&probation_, old);
+  }
+}
+
 void LRUCache::Release(Cache::Handle* handle) {
   MutexLock l(&mutex_);
   Unref(reinterpret_cast<LRUHandle*>(handle));
@@ -266,7 +328,8 @@ void LRUCache::Release(Cache::Handle* handle) {
 Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value,
                                 size_t charge,
                                 void (*deleter)(const Slice& key,
-                                                void* value)) {
+                                                void* value),
+                                Cache::Priority priority) {
   MutexLock l(&mutex_);
 
   LRUHandle* e =
@@ -277,6 +340,8 @@ Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value,
   e->key_length = key.size();
   e->hash = hash;
   e->in_cache = false;
+  e->low_priority = priority == Cache::Priority::kLow;
+  e->looked_up = false;
   e->refs = 1;  // for the returned handle.
   memcpy(e->key_data, key.data(), key.size());
 
@@ -290,8 +355,10 @@ Cache::Handle* LRUCache::Insert(const Slice& key, uint32_t hash, void* value,
     // next is read by key() in an assert, so it must be initialized
     e->next = nullptr;
   }
-  while (usage_ > capacity_ && lru_.next != &lru_) {
-    LRUHandle* old = lru_.next;
+  while (usage_ > capacity_ &&
+         (probation_.next != &probation_ || lru_.next != &lru_)) {
+    LRUHandle* old =
+        probation_.next != &probation_ ? probation_.next : lru_.next;
     assert(old->refs == 1);
     bool erased = FinishErase(table_.Remove(old->key(), old->hash));
     if (!erased) {  // to avoid unused variable when compiled NDEBUG
@@ -310,6 +377,9 @@ bool LRUCache::FinishErase(LRUHandle* e) {
     LRU_Remove(e);
     e->in_cache = false;
     usage_ -= e->charge;
+    if (scan_resistant_ && e->looked_up) {
+      protected_usage_ -= e->charge;
+    }
     Unref(e);
   }
   return e != nullptr;
@@ -322,22 +392,26 @@ void LRUCache::Erase(const Slice& key, uint32_t hash) {
 
 void LRUCache::Prune() {
   MutexLock l(&mutex_);
-  while (lru_.next != &lru_) {
-    LRUHandle* e = lru_.next;
-    assert(e->refs == 1);
-    bool erased = FinishErase(table_.Remove(e->key(), e->hash));
-    if (!erased) {  // to avoid unused variable when compiled NDEBUG
-      assert(erased);
+  for (LRUHandle* list : {&probation_, &lru_}) {
+    while (list->next != list) {
+      LRUHandle* e = list->next;
+      assert(e->refs == 1);
+      bool erased = FinishErase(table_.Remove(e->key(), e->hash));
+      if (!erased) {  // to avoid unused variable when compiled NDEBUG
+        assert(erased);
+      }
     }
   }
 }
 
-static const int kNumShardBits = 4;
-static const int kNumShards = 1 << kNumShardBits;
+static const int kDefaultNumShardBits = 4;
+static const int kMaxNumShardBits = 12;
 
 class ShardedLRUCache : public Cache {
  private:
-  LRUCache shard_[kNumShards];
+  const int num_shard_bits_;
+  const int num_shards_;
+  LRUCache* shard_;
   port::Mutex id_mutex_;
   uint64_t last_id_;
 
@@ -345,20 +419,32 @@ class ShardedLRUCache : public Cache {
     return Hash(s.data(), s.size(), 0);
   }
 
-  static uint32_t Shard(uint32_t hash) { return hash >> (32 - kNumShardBits); }
+  uint32_t Shard(uint32_t hash) const {
+    return num_shard_bits_ == 0 ? 0 : hash >> (32 - num_shard_bits_);
+  }
 
  public:
-  explicit ShardedLRUCache(size_t capacity) : last_id_(0) {
-    const size_t per_shard = (capacity + (kNumShards - 1)) / kNumShards;
-    for (int s = 0; s < kNumShards; s++) {
-      shard_[s].SetCapacity(per_shard);
+  ShardedLRUCache(size_t capacity, int num_shard_bits, bool scan_resistant)
+      : num_shard_bits_(num_shard_bits),
+        num_shards_(1 << num_shard_bits),
+        shard_(new LRUCache[num_shards_]),
+        last_id_(0) {
+    const size_t per_shard = (capacity + (num_shards_ - 1)) / num_shards_;
+    for (int s = 0; s < num_shards_; s++) {
+      shard_[s].SetCapacity(per_shard, scan_resistant);
     }
   }
-  virtual ~ShardedLRUCache() {}
+  virtual ~ShardedLRUCache() { delete[] shard_; }
   virtual Handle* Insert(const Slice& key, void* value, size_t charge,
                          void (*deleter)(const Slice& key, void* value)) {
+    return Insert(key, value, charge, deleter, Priority::kHigh);
+  }
+  virtual Handle* Insert(const Slice& key, void* value, size_t charge,
+                         void (*deleter)(const Slice& key, void* value),
+                         Priority priority) {
     const uint32_t hash = HashSlice(key);
-    return shard_[Shard(hash)].Insert(key, hash, value, charge, deleter);
+    return shard_[Shard(hash)].Insert(key, hash, value, charge, deleter,
+                                      priority);
   }
   virtual Handle* Lookup(const Slice& key) {
     const uint32_t hash = HashSlice(key);
@@ -380,13 +466,13 @@ class ShardedLRUCache : public Cache {
     return ++(last_id_);
   }
   virtual void Prune() {
-    for (int s = 0; s < kNumShards; s++) {
+    for (int s = 0; s < num_shards_; s++) {
       shard_[s].Prune();
     }
   }
   virtual size_t TotalCharge() const {
     size_t total = 0;
-    for (int s = 0; s < kNumShards; s++) {
+    for (int s = 0; s < num_shards_; s++) {
       total += shard_[s].TotalCharge();
     }
     return total;
@@ -395,6 +481,18 @@ class ShardedLRUCache : public Cache {
 
 }  // end anonymous namespace
 
-Cache* NewLRUCache(size_t capacity) { return new ShardedLRUCache(capacity); }
+Cache* NewLRUCache(size_t capacity) {
+  return new ShardedLRUCache(capacity, kDefaultNumShardBits,
+                             /*scan_resistant=*/false);
+}
+
+Cache* NewLRUCache(size_t capacity, int num_shard_bits, bool scan_resistant) {
+  if (num_shard_bits < 0) {
+    num_shard_bits = 0;
+  } else if (num_shard_bits > kMaxNumShardBits) {
+    num_shard_bits = kMaxNumShardBits;
+  }
+  return new ShardedLRUCache(capacity, num_shard_bits, scan_resistant);
+}
 
 }  // namespace leveldb
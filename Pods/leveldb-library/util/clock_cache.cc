@@ -0,0 +1,458 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#include <assert.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <atomic>
+
+#include "leveldb/cache.h"
+#include "port/port.h"
+#include "port/thread_annotations.h"
+#include "util/hash.h"
+#include "util/mutexlock.h"
+
+namespace leveldb {
+
+namespace {
+
+// CLOCK cache implementation
+//
+// Each shard keeps its entries in a fixed-size open-addressing table with
+// linear probing.  Every slot of the table has an atomic "meta" word holding
+// the state of the slot, a reference count and the CLOCK usage bit, so that
+// Lookup() and Release() never take a lock: a lookup pins an entry with a
+// compare-and-swap on its slot and a release unpins it with a decrement.
+//
+// Insert(), Erase() and Prune() change which entries are in the table and
+// hold the shard's mutex, which also serializes the CLOCK hand.  Eviction
+// gives entries a second chance: the hand clears the usage bit that lookups
+// set, and evicts unreferenced entries whose bit is already clear.  Inserts
+// of low priority only evict entries whose bit is clear and are not admitted
+// if there are none, so that scans cannot flush the entries that are in use.
+//
+// A slot is in one of these states:
+// - empty:  holds no entry.
+// - exclusive:  being filled or freed by a single thread.
+// - visible:  holds an entry that lookups can find.  The reference count is
+//   the number of handles clients hold; the cache's own reference is implied
+//   by the state.
+// - invisible:  holds an entry that was erased from the cache while clients
+//   still referenced it.  The last Release() frees it.
+//
+// Each slot also counts the entries that passed over it while probing for a
+// free slot.  A lookup stops at the first mismatching slot that no entry has
+// passed over, so deleting entries does not require tombstones.
+
+class ClockCacheShard;
+
+struct ClockHandle {
+  void* value;
+  void (*deleter)(const Slice&, void* value);
+  ClockCacheShard* shard;  // Null if the entry was never inserted in a table.
+  size_t charge;
+  size_t key_length;
+  uint32_t hash;     // Hash of key(); used for sharding and probing.
+  uint32_t slot;     // Index of the slot holding this entry in shard's table.
+  char key_data[1];  // Beginning of key
+
+  Slice key() const { return Slice(key_data, key_length); }
+};
+
+constexpr uint64_t kStateMask = 3;
+constexpr uint64_t kStateEmpty = 0;
+constexpr uint64_t kStateExclusive = 1;
+constexpr uint64_t kStateVisible = 2;
+constexpr uint64_t kStateInvisible = 3;
+constexpr uint64_t kUsageBit = 4;
+constexpr int kRefShift = 8;
+constexpr uint64_t kOneRef = uint64_t{1} << kRefShift;
+
+inline uint64_t SlotState(uint64_t meta) { return meta & kStateMask; }
+inline uint64_t SlotRefs(uint64_t meta) { return meta >> kRefShift; }
+
+struct ClockSlot {
+  std::atomic<uint64_t> meta{kStateEmpty};
+
+  // The number of entries whose probe sequence passes over this slot.
+  std::atomic<uint32_t> displacements{0};
+
+  // The hash of the entry, read by lookups before they pin it.
+  std::atomic<uint32_t> hash{0};
+
+  // Written while the slot is exclusive; read while pinning the entry.
+  ClockHandle* handle = nullptr;
+};
+
+// Tables are kept at most this full so that probe sequences stay short.
+constexpr double kMaxLoadFactor = 0.7;
+
+// A single shard of sharded cache.
+class ClockCacheShard {
+ public:
+  ClockCacheShard();
+  ~ClockCacheShard();
+
+  // Separate from constructor so caller can easily make an array of shards.
+  void Init(size_t capacity, size_t estimated_entries);
+
+  // Like Cache methods, but with an extra "hash" parameter.
+  Cache::Handle* Insert(ClockHandle* e, Cache::Priority priority);
+  Cache::Handle* Lookup(const Slice& key, uint32_t hash);
+  void Release(ClockHandle* e);
+  void Erase(const Slice& key, uint32_t hash);
+  void Prune();
+  size_t TotalCharge() const { return usage_.load(std::memory_order_relaxed); }
+
+ private:
+  // Takes a reference on the entry in "slot" if it is visible.
+  static bool Pin(ClockSlot* slot);
+
+  // Returns the pinned visible entry for key, or nullptr.
+  ClockHandle* FindAndPin(const Slice& key, uint32_t hash);
+
+  // Frees the entry in the slot at "index", which must be exclusive.
+  void FreeSlot(uint32_t index);
+
+  void EraseLocked(const Slice& key, uint32_t hash)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Advances the CLOCK hand until it evicts an entry.  Returns false if no
+  // entry could be evicted because all of them are referenced, or, unless
+  // "second_chance" is true, because all the others were used since the hand
+  // last passed.  Only the sweeps of second_chance clear usage bits.
+  bool EvictOne(bool second_chance) EXCLUSIVE_LOCKS_REQUIRED(mutex_);
+
+  // Initialized before use.
+  size_t capacity_;
+  uint32_t mask_;
+  size_t max_occupancy_;
+  ClockSlot* slots_;
+
+  std::atomic<size_t> usage_;
+  std::atomic<size_t> occupancy_;
+
+  // mutex_ serializes the changes to the set of entries in the table.
+  port::Mutex mutex_;
+  uint32_t clock_hand_ GUARDED_BY(mutex_);
+};
+
+ClockCacheShard::ClockCacheShard()
+    : capacity_(0),
+      mask_(0),
+      max_occupancy_(0),
+      slots_(nullptr),
+      usage_(0),
+      occupancy_(0),
+      clock_hand_(0) {}
+
+ClockCacheShard::~ClockCacheShard() {
+  for (uint32_t i = 0; slots_ != nullptr && i <= mask_; i++) {
+    uint64_t meta = slots_[i].meta.load(std::memory_order_acquire);
+    if (SlotState(meta) == kStateEmpty) {
+      continue;
+    }
+    // Error if caller has an unreleased handle
+    assert(SlotState(meta) == kStateVisible && SlotRefs(meta) == 0);
+    slots_[i].meta.store(kStateExclusive, std::memory_order_relaxed);
+    FreeSlot(i);
+  }
+  delete[] slots_;
+}
+
+void ClockCacheShard::Init(size_t capacity, size_t estimated_entries) {
+  uint32_t length = 16;
+  while (length * kMaxLoadFactor < estimated_entries && length < (1u << 30)) {
+    length *= 2;
+  }
+  capacity_ = capacity;
+  mask_ = length - 1;
+  max_occupancy_ = static_cast<size_t>(length * kMaxLoadFactor);
+  slots_ = new ClockSlot[length];
+}
+
+bool ClockCacheShard::Pin(ClockSlot* slot) {
+  uint64_t meta = slot->meta.load(std::memory_order_acquire);
+  while (SlotState(meta) == kStateVisible) {
+    if (slot->meta.compare_exchange_weak(meta, meta + kOneRef,
+                                         std::memory_order_acq_rel,
+                                         std::memory_order_acquire)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+ClockHandle* ClockCacheShard::FindAndPin(const Slice& key, uint32_t hash) {
+  for (uint32_t i = 0; i <= mask_; i++) {
+    ClockSlot* slot = &slots_[(hash + i) & mask_];
+    if (slot->hash.load(std::memory_order_relaxed) == hash && Pin(slot)) {
+      ClockHandle* e = slot->handle;
+      if (e->hash == hash && e->key() == key) {
+        return e;
+      }
+      Release(e);
+    }
+    if (slot->displacements.load(std::memory_order_acquire) == 0) {
+      break;
+    }
+  }
+  return nullptr;
+}
+
+Cache::Handle* ClockCacheShard::Lookup(const Slice& key, uint32_t hash) {
+  ClockHandle* e = FindAndPin(key, hash);
+  if (e != nullptr) {
+    ClockSlot* slot = &slots_[e->slot];
+    // Avoid writing to the slot again if the bit is already set.
+    if ((slot->meta.load(std::memory_order_relaxed) & kUsageBit) == 0) {
+      slot->meta.fetch_or(kUsageBit, std::memory_order_relaxed);
+    }
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::Release(ClockHandle* e) {
+  ClockSlot* slot = &slots_[e->slot];
+  uint64_t old_meta = slot->meta.fetch_sub(kOneRef, std::memory_order_acq_rel);
+  assert(SlotRefs(old_meta) > 0);
+  if (SlotState(old_meta) == kStateInvisible && SlotRefs(old_meta) == 1) {
+    // Nothing else touches an invisible slot, so the last reference owns it.
+    slot->meta.store(kStateExclusive, std::memory_order_relaxed);
+    FreeSlot(e->slot);
+  }
+}
+
+Cache::Handle* ClockCacheShard::Insert(ClockHandle* e,
+                                       Cache::Priority priority) {
+  if (capacity_ == 0) {
+    // Don't cache. (capacity_==0 is supported and turns off caching.)
+    return reinterpret_cast<Cache::Handle*>(e);
+  }
+
+  MutexLock l(&mutex_);
+  EraseLocked(e->key(), e->hash);
+  const bool low_priority = priority == Cache::Priority::kLow;
+  auto full = [this, e]() {
+    return usage_.load(std::memory_order_relaxed) + e->charge > capacity_ ||
+           occupancy_.load(std::memory_order_relaxed) >= max_occupancy_;
+  };
+  while (full() && EvictOne(/*second_chance=*/!low_priority)) {
+  }
+  if (low_priority && full()) {
+    // Don't admit the entry rather than evict one that was used recently.
+    return reinterpret_cast<Cache::Handle*>(e);
+  }
+
+  const uint32_t home = e->hash & mask_;
+  for (uint32_t i = 0; i <= mask_; i++) {
+    const uint32_t index = (home + i) & mask_;
+    ClockSlot* slot = &slots_[index];
+    uint64_t expected = kStateEmpty;
+    if (slot->meta.compare_exchange_strong(expected, kStateExclusive,
+                                           std::memory_order_acq_rel)) {
+      e->shard = this;
+      e->slot = index;
+      slot->handle = e;
+      slot->hash.store(e->hash, std::memory_order_relaxed);
+      usage_.fetch_add(e->charge, std::memory_order_relaxed);
+      occupancy_.fetch_add(1, std::memory_order_relaxed);
+      // One reference for the returned handle.  Low priority entries get no
+      // second chance unless they are looked up again.
+      const uint64_t usage = low_priority ? 0 : kUsageBit;
+      slot->meta.store(kStateVisible | usage | kOneRef,
+                       std::memory_order_release);
+      return reinterpret_cast<Cache::Handle*>(e);
+    }
+    slot->displacements.fetch_add(1, std::memory_order_relaxed);
+  }
+
+  // Every slot is taken by a referenced entry: return the entry uncached.
+  for (uint32_t i = 0; i <= mask_; i++) {
+    slots_[i].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  return reinterpret_cast<Cache::Handle*>(e);
+}
+
+void ClockCacheShard::FreeSlot(uint32_t index) {
+  ClockSlot* slot = &slots_[index];
+  ClockHandle* e = slot->handle;
+  slot->handle = nullptr;
+  // Undo the displacements the entry added while probing for its slot.
+  for (uint32_t i = e->hash & mask_; i != index; i = (i + 1) & mask_) {
+    slots_[i].displacements.fetch_sub(1, std::memory_order_relaxed);
+  }
+  occupancy_.fetch_sub(1, std::memory_order_relaxed);
+  slot->meta.store(kStateEmpty, std::memory_order_release);
+
+  (*e->deleter)(e->key(), e->value);
+  free(e);
+}
+
+void ClockCacheShard::EraseLocked(const Slice& key, uint32_t hash) {
+  ClockHandle* e = FindAndPin(key, hash);
+  if (e == nullptr) {
+    return;
+  }
+
+  // Only the holders of mutex_ make visible entries invisible, so the entry
+  // stays visible until this succeeds.
+  ClockSlot* slot = &slots_[e->slot];
+  uint64_t meta = slot->meta.load(std::memory_order_acquire);
+  while (!slot->meta.compare_exchange_weak(
+      meta, (meta & ~kStateMask) | kStateInvisible, std::memory_order_acq_rel,
+      std::memory_order_acquire)) {
+  }
+  usage_.fetch_sub(e->charge, std::memory_order_relaxed);
+  Release(e);
+}
+
+void ClockCacheShard::Erase(const Slice& key, uint32_t hash) {
+  MutexLock l(&mutex_);
+  EraseLocked(key, hash);
+}
+
+bool ClockCacheShard::EvictOne(bool second_chance) {
+  // Two sweeps clear every usage bit and then find any unreferenced entry.
+  const uint32_t steps = second_chance ? 2 * mask_ + 2 : mask_ + 1;
+  for (uint32_t step = 0; step < steps; step++) {
+    const uint32_t index = clock_hand_++ & mask_;
+    ClockSlot* slot = &slots_[index];
+    uint64_t meta = slot->meta.load(std::memory_order_acquire);
+    if (SlotState(meta) != kStateVisible || SlotRefs(meta) != 0) {
+      continue;
+    }
+    if (meta & kUsageBit) {
+      if (second_chance) {
+        // A concurrent lookup may set the bit again.
+        slot->meta.compare_exchange_strong(meta, meta & ~kUsageBit,
+                                           std::memory_order_relaxed);
+      }
+      continue;
+    }
+    if (slot->meta.compare_exchange_strong(meta, kStateExclusive,
+                                           std::memory_order_acq_rel)) {
+      usage_.fetch_sub(slot->handle->charge, std::memory_order_relaxed);
+      FreeSlot(index);
+      return true;
+    }
+  }
+  return false;
+}
+
+void ClockCacheShard::Prune() {
+  MutexLock l(&mutex_);
+  for (uint32_t i = 0; i <= mask_; i++) {
+    ClockSlot* slot = &slots_[i];
+    uint64_t meta = slot->meta.load(std::memory_order_acquire);
+    if (SlotState(meta) == kStateVisible && SlotRefs(meta) == 0 &&
+        slot->meta.compare_exchange_strong(meta, kStateExclusive,
+                                           std::memory_order_acq_rel)) {
+      usage_.fetch_sub(slot->handle->charge, std::memory_order_relaxed);
+      FreeSlot(i);
+    }
+  }
+}
+
+class ShardedClockCache : public Cache {
+ private:
+  const int num_shard_bits_;
+  ClockCacheShard* shards_;
+  std::atomic<uint64_t> last_id_;
+
+  static inline uint32_t HashSlice(const Slice& s) {
+    return Hash(s.data(), s.size(), 0);
+  }
+
+  uint32_t Shard(uint32_t hash) const {
+    return num_shard_bits_ == 0 ? 0 : hash >> (32 - num_shard_bits_);
+  }
+
+ public:
+  ShardedClockCache(size_t capacity, int num_shard_bits,
+                    size_t estimated_entry_charge)
+      : num_shard_bits_(num_shard_bits), last_id_(0) {
+    const int num_shards = 1 << num_shard_bits_;
+    const size_t per_shard = (capacity + (num_shards - 1)) / num_shards;
+    const size_t entries_per_shard =
+        per_shard / (estimated_entry_charge > 0 ? estimated_entry_charge : 1);
+    shards_ = new ClockCacheShard[num_shards];
+    for (int s = 0; s < num_shards; s++) {
+      shards_[s].Init(per_shard, entries_per_shard);
+    }
+  }
+  ~ShardedClockCache() override { delete[] shards_; }
+
+  Handle* Insert(const Slice& key, void* value, size_t charge,
+                 void (*deleter)(const Slice& key, void* value)) override {
+    return Insert(key, value, charge, deleter, Priority::kHigh);
+  }
+  Handle* Insert(const Slice& key, void* value, size_t charge,
+                 void (*deleter)(const Slice& key, void* value),
+                 Priority priority) override {
+    ClockHandle* e = reinterpret_cast<ClockHandle*>(
+        malloc(sizeof(ClockHandle) - 1 + key.size()));
+    e->value = value;
+    e->deleter = deleter;
+    e->shard = nullptr;
+    e->charge = charge;
+    e->key_length = key.size();
+    e->hash = HashSlice(key);
+    e->slot = 0;
+    memcpy(e->key_data, key.data(), key.size());
+    return shards_[Shard(e->hash)].Insert(e, priority);
+  }
+  Handle* Lookup(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    return shards_[Shard(hash)].Lookup(key, hash);
+  }
+  void Release(Handle* handle) override {
+    ClockHandle* e = reinterpret_cast<ClockHandle*>(handle);
+    if (e->shard == nullptr) {
+      // The entry was returned without being cached.
+      (*e->deleter)(e->key(), e->value);
+      free(e);
+      return;
+    }
+    e->shard->Release(e);
+  }
+  void Erase(const Slice& key) override {
+    const uint32_t hash = HashSlice(key);
+    shards_[Shard(hash)].Erase(key, hash);
+  }
+  void* Value(Handle* handle) override {
+    return reinterpret_cast<ClockHandle*>(handle)->value;
+  }
+  uint64_t NewId() override {
+    return last_id_.fetch_add(1, std::memory_order_relaxed) + 1;
+  }
+  void Prune() override {
+    for (int s = 0; s < (1 << num_shard_bits_); s++) {
+      shards_[s].Prune();
+    }
+  }
+  size_t TotalCharge() const override {
+    size_t total = 0;
+    for (int s = 0; s < (1 << num_shard_bits_); s++) {
+      total += shards_[s].TotalCharge();
+    }
+    return total;
+  }
+};
+
+}  // end anonymous namespace
+
+Cache* NewClockCache(size_t capacity, int num_shard_bits,
+                     size_t estimated_entry_charge) {
+  if (num_shard_bits < 0) {
+    num_shard_bits = 0;
+  } else if (num_shard_bits > 20) {
+    num_shard_bits = 20;
+  }
+  return new ShardedClockCache(capacity, num_shard_bits,
+                               estimated_entry_charge);
+}
+
+}  // namespace leveldb
@@ -11,6 +11,7 @@
 
 #include "port/port.h"
 #include "util/coding.h"
+#include "util/crc32c_arm64.h"
 
 namespace leveldb {
 namespace crc32c {
@@ -278,6 +279,10 @@ uint32_t Extend(uint32_t crc, const char* data, size_t n) {
   if (accelerate) {
     return port::AcceleratedCRC32C(crc, data, n);
   }
+  static bool arm64 = CanUseArm64();
+  if (arm64) {
+    return ExtendArm64(crc, data, n);
+  }
 
   const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
   const uint8_t* e = p + n;
@@ -0,0 +1,140 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+//
+// crc32c computed with the ARMv8 CRC32 instructions.  Large inputs are
+// split into three interleaved streams, which keeps the CRC32 unit busy
+// despite the latency of each instruction, and the stream CRCs are merged
+// with carry-less multiplications.
+
+#include "util/crc32c_arm64.h"
+
+#if defined(__aarch64__)
+
+#include <arm_acle.h>
+#include <arm_neon.h>
+
+#if defined(__APPLE__)
+#include <sys/sysctl.h>
+#elif defined(__linux__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#include <string.h>
+
+#endif  // defined(__aarch64__)
+
+namespace leveldb {
+namespace crc32c {
+
+#if defined(__aarch64__)
+
+// The CRC32 and PMULL instructions are optional in ARMv8.0, so they are
+// enabled for the functions that use them only.
+#if defined(__clang__)
+#define LEVELDB_TARGET_CRC_CRYPTO __attribute__((target("crc,crypto")))
+#else
+#define LEVELDB_TARGET_CRC_CRYPTO __attribute__((target("+crc+crypto")))
+#endif
+
+namespace {
+
+// CRCs are pre- and post- conditioned by xoring with all ones.
+constexpr uint32_t kCRC32Xor = 0xffffffffU;
+
+// Each of the three streams covers this many bytes of a block.
+constexpr size_t kStreamBytes = 256;
+constexpr size_t kBlockBytes = 3 * kStreamBytes;
+
+// Carry-less multiplying a CRC by these and folding the product with a
+// CRC32 instruction advances it past kStreamBytes and 2 * kStreamBytes zero
+// bytes respectively.
+constexpr uint64_t kShiftOneStream = 0xb9e02b86;
+constexpr uint64_t kShiftTwoStreams = 0xdd7e3b0c;
+
+inline uint64_t LoadUint64(const uint8_t* p) {
+  uint64_t word;
+  memcpy(&word, p, sizeof(word));
+  return word;
+}
+
+LEVELDB_TARGET_CRC_CRYPTO inline uint32_t Shift(uint32_t crc,
+                                                uint64_t constant) {
+  const uint64_t product =
+      vgetq_lane_u64(vreinterpretq_u64_p128(vmull_p64(crc, constant)), 0);
+  return __crc32cd(0, product);
+}
+
+}  // namespace
+
+bool CanUseArm64() {
+#if defined(__APPLE__)
+  // Every Apple ARM64 CPU has PMULL, but the first ones lack CRC32.
+  int crc32 = 0;
+  size_t size = sizeof(crc32);
+  return ::sysctlbyname("hw.optional.armv8_crc32", &crc32, &size, nullptr,
+                        0) == 0 &&
+         crc32 != 0;
+#elif defined(__linux__) && defined(HWCAP_CRC32) && defined(HWCAP_PMULL)
+  const unsigned long hwcap = ::getauxval(AT_HWCAP);
+  return (hwcap & HWCAP_CRC32) != 0 && (hwcap & HWCAP_PMULL) != 0;
+#else
+  return false;
+#endif
+}
+
+LEVELDB_TARGET_CRC_CRYPTO uint32_t ExtendArm64(uint32_t crc, const char* data,
+                                               size_t n) {
+  const uint8_t* p = reinterpret_cast<const uint8_t*>(data);
+  const uint8_t* e = p + n;
+  uint32_t l = crc ^ kCRC32Xor;
+
+  // Align the 8-byte loads.
+  while (p != e && (reinterpret_cast<uintptr_t>(p) & 7) != 0) {
+    l = __crc32cb(l, *p++);
+  }
+
+  while (static_cast<size_t>(e - p) >= kBlockBytes) {
+    uint32_t crc0 = l;
+    uint32_t crc1 = 0;
+    uint32_t crc2 = 0;
+    for (size_t i = 0; i < kStreamBytes; i += 8) {
+      crc0 = __crc32cd(crc0, LoadUint64(p + i));
+      crc1 = __crc32cd(crc1, LoadUint64(p + kStreamBytes + i));
+      crc2 = __crc32cd(crc2, LoadUint64(p + 2 * kStreamBytes + i));
+    }
+    // The CRC of the block is that of its first stream followed by the
+    // zeros of the other two, xored with the CRCs of the later streams
+    // followed by the zeros of the streams after them.
+    l = Shift(crc0, kShiftTwoStreams) ^ Shift(crc1, kShiftOneStream) ^ crc2;
+    p += kBlockBytes;
+  }
+
+  while (static_cast<size_t>(e - p) >= 8) {
+    l = __crc32cd(l, LoadUint64(p));
+    p += 8;
+  }
+  while (p != e) {
+    l = __crc32cb(l, *p++);
+  }
+  return l ^ kCRC32Xor;
+}
+
+#undef LEVELDB_TARGET_CRC_CRYPTO
+
+#else  // !defined(__aarch64__)
+
+bool CanUseArm64() { return false; }
+
+uint32_t ExtendArm64(uint32_t crc, const char* data, size_t n) {
+  // Silence compiler warnings about unused arguments.
+  (void)data;
+  (void)n;
+  return crc;
+}
+
+#endif  // defined(__aarch64__)
+
+}  // namespace crc32c
+}  // namespace leveldb
@@ -0,0 +1,26 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#ifndef STORAGE_LEVELDB_UTIL_CRC32C_ARM64_H_
+#define STORAGE_LEVELDB_UTIL_CRC32C_ARM64_H_
+
+#include <stddef.h>
+#include <stdint.h>
+
+namespace leveldb {
+namespace crc32c {
+
+// Returns true if this is an ARM64 CPU with the CRC32 and PMULL
+// instructions, which ExtendArm64() requires.
+bool CanUseArm64();
+
+// Same as Extend(), computed with the ARMv8 CRC32 instructions.
+//
+// REQUIRES: CanUseArm64()
+uint32_t ExtendArm64(uint32_t crc, const char* data, size_t n);
+
+}  // namespace crc32c
+}  // namespace leveldb
+
+#endif  // STORAGE_LEVELDB_UTIL_CRC32C_ARM64_H_
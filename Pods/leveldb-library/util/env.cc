@@ -16,8 +16,14 @@ SequentialFile::~SequentialFile() {}
 
 RandomAccessFile::~RandomAccessFile() {}
 
+void RandomAccessFile::Readahead(uint64_t offset, size_t n) const {}
+
 WritableFile::~WritableFile() {}
 
+Status WritableFile::SyncFlushed() {
+  return Status::NotSupported("SyncFlushed");
+}
+
 Logger::~Logger() {}
 
 FileLock::~FileLock() {}
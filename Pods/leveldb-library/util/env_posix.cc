@@ -12,6 +12,7 @@
 #include <sys/types.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <atomic>
 #include <cerrno>
 #include <cstddef>
@@ -45,9 +46,14 @@ int g_open_read_only_file_limit = -1;
 // Up to 1000 mmap regions for 64-bit binaries; none for 32-bit.
 constexpr const int kDefaultMmapLimit = (sizeof(void*) >= 8) ? 1000 : 0;
 
-// Can be set using EnvPosixTestHelper::SetReadOnlyMMapLimit.
+// Can be set using EnvPosixTestHelper::SetReadOnlyMMapLimit and
+// ConfigureDefaultEnv().
 int g_mmap_limit = kDefaultMmapLimit;
 
+// Can be set using ConfigureDefaultEnv().
+FileAccessHint g_random_access_file_hint = FileAccessHint::kNormal;
+FileAccessHint g_sequential_file_hint = FileAccessHint::kNormal;
+
 constexpr const size_t kWritableFileBufferSize = 65536;
 
 Status PosixError(const std::string& context, int error_number) {
@@ -58,6 +64,42 @@ Status PosixError(const std::string& context, int error_number) {
   }
 }
 
+// Passes the access pattern of the whole file behind |fd| on to the OS.
+void AdviseFile(int fd, FileAccessHint hint) {
+#if defined(POSIX_FADV_RANDOM)
+  int advice = POSIX_FADV_NORMAL;
+  if (hint == FileAccessHint::kRandom) {
+    advice = POSIX_FADV_RANDOM;
+  } else if (hint == FileAccessHint::kSequential) {
+    advice = POSIX_FADV_SEQUENTIAL;
+  }
+  ::posix_fadvise(fd, 0, 0, advice);
+#elif defined(F_RDAHEAD)
+  // Darwin can only turn readahead on or off.
+  ::fcntl(fd, F_RDAHEAD, hint == FileAccessHint::kRandom ? 0 : 1);
+#else
+  (void)fd;
+  (void)hint;
+#endif
+}
+
+// Starts reading |fd|[offset, offset + n) into the page cache.
+void ReadaheadFile(int fd, uint64_t offset, size_t n) {
+#if defined(POSIX_FADV_WILLNEED)
+  ::posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(n),
+                  POSIX_FADV_WILLNEED);
+#elif defined(F_RDADVISE)
+  struct radvisory advice;
+  advice.ra_offset = static_cast<off_t>(offset);
+  advice.ra_count = static_cast<int>(n);
+  ::fcntl(fd, F_RDADVISE, &advice);
+#else
+  (void)fd;
+  (void)offset;
+  (void)n;
+#endif
+}
+
 // Helper class to limit resource usage to avoid exhaustion.
 // Currently used to limit read-only file descriptors and mmap file usage
 // so that we do not run out of file descriptors or virtual memory, or run into
@@ -150,6 +192,8 @@ class PosixRandomAccessFile final : public RandomAccessFile {
     if (!has_permanent_fd_) {
       assert(fd_ == -1);
       ::close(fd);  // The file will be opened on every read.
+    } else {
+      AdviseFile(fd_, g_random_access_file_hint);
     }
   }
 
@@ -188,6 +232,14 @@ class PosixRandomAccessFile final : public RandomAccessFile {
     return status;
   }
 
+  void Readahead(uint64_t offset, size_t n) const override {
+    // Files without a permanent descriptor lose the page cache hint along
+    // with the descriptor, so there is no point in giving it.
+    if (has_permanent_fd_) {
+      ReadaheadFile(fd_, offset, n);
+    }
+  }
+
  private:
   const bool has_permanent_fd_;  // If false, the file is opened on every read.
   const int fd_;                 // -1 if has_permanent_fd_ is false.
@@ -214,7 +266,15 @@ class PosixMmapReadableFile final : public RandomAccessFile {
       : mmap_base_(mmap_base),
         length_(length),
         mmap_limiter_(mmap_limiter),
-        filename_(std::move(filename)) {}
+        filename_(std::move(filename)) {
+    int advice = MADV_NORMAL;
+    if (g_random_access_file_hint == FileAccessHint::kRandom) {
+      advice = MADV_RANDOM;
+    } else if (g_random_access_file_hint == FileAccessHint::kSequential) {
+      advice = MADV_SEQUENTIAL;
+    }
+    ::madvise(mmap_base_, length_, advice);
+  }
 
   ~PosixMmapReadableFile() override {
     ::munmap(static_cast<void*>(mmap_base_), length_);
@@ -232,6 +292,17 @@ class PosixMmapReadableFile final : public RandomAccessFile {
     return Status::OK();
   }
 
+  void Readahead(uint64_t offset, size_t n) const override {
+    if (offset >= length_) {
+      return;
+    }
+    // madvise() wants a page-aligned start; the mapping itself is aligned.
+    static const uint64_t kPageSize = ::sysconf(_SC_PAGESIZE);
+    const uint64_t start = offset - offset % kPageSize;
+    const uint64_t end = std::min<uint64_t>(offset + n, length_);
+    ::madvise(mmap_base_ + start, end - start, MADV_WILLNEED);
+  }
+
  private:
   char* const mmap_base_;
   const size_t length_;
@@ -315,6 +386,11 @@ class PosixWritableFile final : public WritableFile {
     return SyncFd(fd_, filename_);
   }
 
+  Status SyncFlushed() override {
+    // Only reads fd_, so this is safe alongside Append() and Flush().
+    return SyncFd(fd_, filename_);
+  }
+
  private:
   Status FlushBuffer() {
     Status status = WriteUnbuffered(buf_, pos_);
@@ -497,6 +573,7 @@ class PosixEnv : public Env {
       return PosixError(filename, errno);
     }
 
+    AdviseFile(fd, g_sequential_file_hint);
     *result = new PosixSequentialFile(filename, fd);
     return Status::OK();
   }
@@ -858,6 +935,14 @@ void PosixEnv::StartThread(void (*thread_main)(void* thread_main_arg),
   new_thread.detach();
 }
 
+void ConfigureDefaultEnv(const DefaultEnvOptions& options) {
+  PosixDefaultEnv::AssertEnvNotInitialized();
+  g_mmap_limit = options.mmap_limit >= 0 ? options.mmap_limit
+                                         : kDefaultMmapLimit;
+  g_random_access_file_hint = options.random_access_file_hint;
+  g_sequential_file_hint = options.sequential_file_hint;
+}
+
 void EnvPosixTestHelper::SetReadOnlyFDLimit(int limit) {
   PosixDefaultEnv::AssertEnvNotInitialized();
   g_open_read_only_file_limit = limit;
@@ -8,4 +8,6 @@ namespace leveldb {
 
 FilterPolicy::~FilterPolicy() {}
 
+PrefixExtractor::~PrefixExtractor() {}
+
 }  // namespace leveldb
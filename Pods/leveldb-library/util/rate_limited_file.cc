@@ -0,0 +1,46 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#include "util/rate_limited_file.h"
+
+#include "leveldb/env.h"
+#include "leveldb/slice.h"
+
+namespace leveldb {
+
+namespace {
+
+class RateLimitedFile : public WritableFile {
+ public:
+  RateLimitedFile(WritableFile* file, RateLimiter* limiter,
+                  RateLimiter::Priority priority)
+      : file_(file), limiter_(limiter), priority_(priority) {}
+
+  ~RateLimitedFile() override { delete file_; }
+
+  Status Append(const Slice& data) override {
+    limiter_->Request(data.size(), priority_);
+    return file_->Append(data);
+  }
+  Status Close() override { return file_->Close(); }
+  Status Flush() override { return file_->Flush(); }
+  Status Sync() override { return file_->Sync(); }
+
+ private:
+  WritableFile* const file_;
+  RateLimiter* const limiter_;
+  const RateLimiter::Priority priority_;
+};
+
+}  // namespace
+
+WritableFile* NewRateLimitedFile(WritableFile* file, RateLimiter* limiter,
+                                 RateLimiter::Priority priority) {
+  if (limiter == nullptr) {
+    return file;
+  }
+  return new RateLimitedFile(file, limiter, priority);
+}
+
+}  // namespace leveldb
@@ -0,0 +1,22 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#ifndef STORAGE_LEVELDB_UTIL_RATE_LIMITED_FILE_H_
+#define STORAGE_LEVELDB_UTIL_RATE_LIMITED_FILE_H_
+
+#include "leveldb/rate_limiter.h"
+
+namespace leveldb {
+
+class WritableFile;
+
+// Return a file that passes each append to "file" through "limiter" first.
+// The result takes ownership of "file".  Returns "file" itself if "limiter"
+// is null.
+WritableFile* NewRateLimitedFile(WritableFile* file, RateLimiter* limiter,
+                                 RateLimiter::Priority priority);
+
+}  // namespace leveldb
+
+#endif  // STORAGE_LEVELDB_UTIL_RATE_LIMITED_FILE_H_
@@ -0,0 +1,155 @@
+// Copyright (c) 2022 The LevelDB Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style license that can be
+// found in the LICENSE file. See the AUTHORS file for names of contributors.
+
+#include "leveldb/rate_limiter.h"
+
+#include <algorithm>
+#include <deque>
+
+#include "leveldb/env.h"
+#include "port/port.h"
+#include "port/thread_annotations.h"
+#include "util/mutexlock.h"
+
+namespace leveldb {
+
+RateLimiter::~RateLimiter() {}
+
+namespace {
+
+// A token bucket refilled once per period.  Requests that cannot be served
+// right away queue up by priority; the first waiter sleeps until the next
+// refill and then hands out the new allowance, high priority queue first,
+// each queue in order of arrival.
+class TokenBucketRateLimiter : public RateLimiter {
+ public:
+  TokenBucketRateLimiter(int64_t bytes_per_second,
+                         int64_t refill_period_micros, Env* env)
+      : env_(env),
+        refill_period_micros_(std::max<int64_t>(refill_period_micros, 1)),
+        refill_bytes_(std::max<int64_t>(
+            bytes_per_second * refill_period_micros_ / 1000000, 1)),
+        available_bytes_(refill_bytes_),
+        next_refill_micros_(env_->NowMicros() + refill_period_micros_),
+        refilling_(false) {}
+
+  ~TokenBucketRateLimiter() override {
+    MutexLock l(&mutex_);
+    assert(queues_[0].empty() && queues_[1].empty());
+  }
+
+  void Request(size_t bytes, Priority priority) override {
+    MutexLock l(&mutex_);
+    // Larger requests than one period's allowance are admitted in parts.
+    while (bytes > 0) {
+      const int64_t part =
+          std::min<int64_t>(static_cast<int64_t>(bytes), refill_bytes_);
+      Acquire(part, priority);
+      bytes -= part;
+    }
+  }
+
+ private:
+  struct Waiter {
+    Waiter(int64_t b, port::Mutex* mu)
+        : bytes(b), granted(false), cv(mu) {}
+
+    const int64_t bytes;
+    bool granted;
+    port::CondVar cv;
+  };
+
+  void Acquire(int64_t bytes, Priority priority)
+      EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    if (queues_[0].empty() && queues_[1].empty() &&
+        available_bytes_ >= bytes) {
+      available_bytes_ -= bytes;
+      return;
+    }
+
+    Waiter w(bytes, &mutex_);
+    queues_[priority == Priority::kHigh ? 0 : 1].push_back(&w);
+    while (!w.granted) {
+      if (refilling_) {
+        w.cv.Wait();
+        continue;
+      }
+
+      refilling_ = true;
+      const uint64_t now = env_->NowMicros();
+      if (now < next_refill_micros_) {
+        mutex_.Unlock();
+        env_->SleepForMicroseconds(
+            static_cast<int>(next_refill_micros_ - now));
+        mutex_.Lock();
+      }
+      Refill();
+      refilling_ = false;
+
+      // Someone still waiting has to sleep until the next refill.
+      if (w.granted) {
+        Waiter* next = FirstWaiter();
+        if (next != nullptr) {
+          next->cv.Signal();
+        }
+      }
+    }
+  }
+
+  // Starts a new period and grants the waiters that fit into it.
+  void Refill() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    const uint64_t now = env_->NowMicros();
+    available_bytes_ = refill_bytes_;
+    next_refill_micros_ =
+        std::max(now, next_refill_micros_) + refill_period_micros_;
+    for (std::deque<Waiter*>& queue : queues_) {
+      while (!queue.empty() && queue.front()->bytes <= available_bytes_) {
+        Waiter* w = queue.front();
+        queue.pop_front();
+        available_bytes_ -= w->bytes;
+        w->granted = true;
+        w->cv.Signal();
+      }
+      if (!queue.empty()) {
+        // Keep the rest of the allowance for the head of this queue, so
+        // that lower priorities cannot starve it.
+        break;
+      }
+    }
+  }
+
+  Waiter* FirstWaiter() EXCLUSIVE_LOCKS_REQUIRED(mutex_) {
+    for (std::deque<Waiter*>& queue : queues_) {
+      if (!queue.empty()) {
+        return queue.front();
+      }
+    }
+    return nullptr;
+  }
+
+  Env* const env_;
+  const int64_t refill_period_micros_;
+  const int64_t refill_bytes_;
+
+  port::Mutex mutex_;
+  int64_t available_bytes_ GUARDED_BY(mutex_);
+  uint64_t next_refill_micros_ GUARDED_BY(mutex_);
+
+  // Set while a waiter sleeps until the next refill.
+  bool refilling_ GUARDED_BY(mutex_);
+
+  // Waiters of high and of low priority.
+  std::deque<Waiter*> queues_[2] GUARDED_BY(mutex_);
+};
+
+}  // namespace
+
+RateLimiter* NewRateLimiter(int64_t bytes_per_second,
+                            int64_t refill_period_micros, Env* env) {
+  return new TokenBucketRateLimiter(
+      bytes_per_second, refill_period_micros,
+      env != nullptr ? env : Env::Default());
+}
+
+}  // namespace leveldb
@@ -25,6 +25,7 @@ typedef bool (*pb_decoder_t)(pb_istream_t *stream, const pb_field_t *field, void
 
 static bool checkreturn buf_read(pb_istream_t *stream, pb_byte_t *buf, size_t count);
 static bool checkreturn read_raw_value(pb_istream_t *stream, pb_wire_type_t wire_type, pb_byte_t *buf, size_t *size);
+static void pb_dec_packed_fixed(pb_istream_t *stream, const pb_field_t *field, void *pData, pb_size_t *size);
 static bool checkreturn decode_static_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter);
 static bool checkreturn decode_callback_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter);
 static bool checkreturn decode_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter);
@@ -136,6 +137,21 @@ bool checkreturn pb_read(pb_istream_t *stream, pb_byte_t *buf, size_t count)
     return true;
 }
 
+/* True if the stream reads straight from a memory buffer, so that the
+ * decoders below can look at the bytes in place instead of pulling them
+ * through the callback one at a time. */
+#ifdef PB_BUFFER_ONLY
+#define PB_IS_BUFFER_STREAM(stream) true
+#else
+#define PB_IS_BUFFER_STREAM(stream) ((stream)->callback == &buf_read)
+#endif
+
+static void pb_advance_buffer(pb_istream_t *stream, size_t count)
+{
+    stream->state = (pb_byte_t*)stream->state + count;
+    stream->bytes_left -= count;
+}
+
 /* Read a single byte from input stream. buf may not be NULL.
  * This is an optimization for the varint decoding. */
 static bool checkreturn pb_readbyte(pb_istream_t *stream, pb_byte_t *buf)
@@ -189,6 +205,31 @@ static bool checkreturn pb_decode_varint32_eof(pb_istream_t *stream, uint32_t *d
     pb_byte_t byte;
     uint32_t result;
     
+    if (PB_IS_BUFFER_STREAM(stream) && stream->bytes_left > 0)
+    {
+        /* Fast path for varints of up to 5 bytes that fit in 32 bits and are
+         * all in the buffer, which covers every tag and length in practice.
+         * Everything else goes through the byte-at-a-time loop below. */
+        const pb_byte_t *p = (const pb_byte_t*)stream->state;
+        size_t limit = stream->bytes_left < 5 ? stream->bytes_left : 5;
+        size_t i;
+
+        result = 0;
+        for (i = 0; i < limit; i++)
+        {
+            result |= (uint32_t)(p[i] & 0x7F) << (7 * i);
+            if ((p[i] & 0x80) == 0)
+            {
+                if (i == 4 && (p[i] & 0x70) != 0)
+                    break;
+
+                pb_advance_buffer(stream, i + 1);
+                *dest = result;
+                return true;
+            }
+        }
+    }
+
     if (!pb_readbyte(stream, &byte))
     {
         if (stream->bytes_left == 0)
@@ -258,6 +299,26 @@ bool checkreturn pb_decode_varint(pb_istream_t *stream, uint64_t *dest)
     uint_fast8_t bitpos = 0;
     uint64_t result = 0;
     
+    if (PB_IS_BUFFER_STREAM(stream))
+    {
+        /* Same as the loop below, reading the buffer in place */
+        const pb_byte_t *p = (const pb_byte_t*)stream->state;
+        size_t limit = stream->bytes_left < 10 ? stream->bytes_left : 10;
+        size_t i;
+
+        for (i = 0; i < limit; i++)
+        {
+            result |= (uint64_t)(p[i] & 0x7F) << (7 * i);
+            if ((p[i] & 0x80) == 0)
+            {
+                pb_advance_buffer(stream, i + 1);
+                *dest = result;
+                return true;
+            }
+        }
+        result = 0;
+    }
+
     do
     {
         if (bitpos >= 64)
@@ -403,6 +464,50 @@ bool checkreturn pb_close_string_substream(pb_istream_t *stream, pb_istream_t *s
  * Decode a single field *
  *************************/
 
+/* Decode as many whole elements of a packed fixed32/fixed64 array as fit,
+ * straight from the buffer of a buffer stream. Whatever is left, including
+ * any error, is handled by the generic loop in decode_static_field(). */
+static void pb_dec_packed_fixed(pb_istream_t *stream, const pb_field_t *field, void *pData, pb_size_t *size)
+{
+    const pb_byte_t *p = (const pb_byte_t*)stream->state;
+    size_t count = 0;
+
+    if (PB_LTYPE(field->type) == PB_LTYPE_FIXED32 && field->data_size == 4)
+    {
+        uint32_t *dest = (uint32_t*)pData + *size;
+        while (stream->bytes_left - count * 4 >= 4 && *size < field->array_size)
+        {
+            const pb_byte_t *bytes = p + count * 4;
+            dest[count++] = ((uint32_t)bytes[0] << 0) |
+                            ((uint32_t)bytes[1] << 8) |
+                            ((uint32_t)bytes[2] << 16) |
+                            ((uint32_t)bytes[3] << 24);
+            (*size)++;
+        }
+        pb_advance_buffer(stream, count * 4);
+    }
+#ifndef PB_WITHOUT_64BIT
+    else if (PB_LTYPE(field->type) == PB_LTYPE_FIXED64 && field->data_size == 8)
+    {
+        uint64_t *dest = (uint64_t*)pData + *size;
+        while (stream->bytes_left - count * 8 >= 8 && *size < field->array_size)
+        {
+            const pb_byte_t *bytes = p + count * 8;
+            dest[count++] = ((uint64_t)bytes[0] << 0) |
+                            ((uint64_t)bytes[1] << 8) |
+                            ((uint64_t)bytes[2] << 16) |
+                            ((uint64_t)bytes[3] << 24) |
+                            ((uint64_t)bytes[4] << 32) |
+                            ((uint64_t)bytes[5] << 40) |
+                            ((uint64_t)bytes[6] << 48) |
+                            ((uint64_t)bytes[7] << 56);
+            (*size)++;
+        }
+        pb_advance_buffer(stream, count * 8);
+    }
+#endif
+}
+
 static bool checkreturn decode_static_field(pb_istream_t *stream, pb_wire_type_t wire_type, pb_field_iter_t *iter)
 {
     pb_type_t type;
@@ -433,6 +538,9 @@ static bool checkreturn decode_static_field(pb_istream_t *stream, pb_wire_type_t
                 if (!pb_make_string_substream(stream, &substream))
                     return false;
 
+                if (PB_IS_BUFFER_STREAM(&substream))
+                    pb_dec_packed_fixed(&substream, iter->pos, iter->pData, size);
+
                 while (substream.bytes_left > 0 && *size < iter->pos->array_size)
                 {
                     void *pItem = (char*)iter->pData + iter->pos->data_size * (*size);
@@ -97,6 +97,7 @@ pb_ostream_t pb_ostream_from_buffer(pb_byte_t *buf, size_t bufsize)
 #ifndef PB_NO_ERRMSG
     stream.errmsg = NULL;
 #endif
+    stream.size_cache = NULL;
     return stream;
 }
 
@@ -575,6 +576,32 @@ bool pb_get_encoded_size(size_t *size, const pb_field_t fields[], const void *sr
     return true;
 }
 
+bool pb_get_encoded_size_cached(size_t *size, const pb_field_t fields[], const void *src_struct, pb_size_cache_t *cache)
+{
+    pb_ostream_t stream = PB_OSTREAM_SIZING;
+    
+    cache->count = 0;
+    cache->next = 0;
+    stream.size_cache = cache;
+    if (!pb_encode(&stream, fields, src_struct))
+        return false;
+    
+    *size = stream.bytes_written;
+    return true;
+}
+
+bool pb_encode_cached(pb_ostream_t *stream, const pb_field_t fields[], const void *src_struct, pb_size_cache_t *cache)
+{
+    pb_size_cache_t *prev_cache = stream->size_cache;
+    bool status;
+    
+    cache->next = 0;
+    stream->size_cache = cache;
+    status = pb_encode(stream, fields, src_struct);
+    stream->size_cache = prev_cache;
+    return status;
+}
+
 /********************
  * Helper functions *
  ********************/
@@ -716,21 +743,52 @@ bool checkreturn pb_encode_string(pb_ostream_t *stream, const pb_byte_t *buffer,
 
 bool checkreturn pb_encode_submessage(pb_ostream_t *stream, const pb_field_t fields[], const void *src_struct)
 {
-    /* First calculate the message size using a non-writing substream. */
     pb_ostream_t substream = PB_OSTREAM_SIZING;
+    pb_size_cache_t *cache = stream->size_cache;
+    size_t cache_index = 0;
     size_t size;
     bool status;
     
-    if (!pb_encode(&substream, fields, src_struct))
+    /* Submessages are numbered in the order they are started in, which is
+     * the same while sizing and while writing. */
+    if (cache != NULL)
     {
+        if (stream->callback == NULL)
+            cache_index = cache->count++;
+        else
+            cache_index = cache->next++;
+    }
+    
+    if (cache != NULL && stream->callback != NULL &&
+        cache_index < cache->count && cache_index < cache->capacity)
+    {
+        /* Sized already by pb_get_encoded_size_cached() */
+        size = cache->sizes[cache_index];
+    }
+    else
+    {
+        /* First calculate the message size using a non-writing substream.
+         * When filling in a cache, the nested submessages are recorded too. */
+        if (stream->callback == NULL)
+            substream.size_cache = cache;
+        
+        if (!pb_encode(&substream, fields, src_struct))
+        {
 #ifndef PB_NO_ERRMSG
-        stream->errmsg = substream.errmsg;
+            stream->errmsg = substream.errmsg;
 #endif
-        return false;
+            return false;
+        }
+        
+        size = substream.bytes_written;
+        
+        if (cache != NULL && stream->callback == NULL &&
+            cache_index < cache->capacity)
+        {
+            cache->sizes[cache_index] = size;
+        }
     }
     
-    size = substream.bytes_written;
-    
     if (!pb_encode_varint(stream, (pb_uint64_t)size))
         return false;
     
@@ -749,6 +807,7 @@ bool checkreturn pb_encode_submessage(pb_ostream_t *stream, const pb_field_t fie
 #ifndef PB_NO_ERRMSG
     substream.errmsg = NULL;
 #endif
+    substream.size_cache = cache;
     
     status = pb_encode(&substream, fields, src_struct);
     
@@ -12,6 +12,20 @@
 extern "C" {
 #endif
 
+/* Sizes of the submessages of a message, recorded by
+ * pb_get_encoded_size_cached() so that pb_encode_cached() can write the
+ * message without sizing every submessage again at each level of nesting.
+ * The caller provides the storage; submessages beyond its capacity are
+ * still encoded correctly, they are just sized the usual way.
+ */
+typedef struct pb_size_cache_s
+{
+    size_t *sizes;    /* Storage for the sizes, in encoding order. */
+    size_t capacity;  /* Number of entries in sizes. */
+    size_t count;     /* Number of submessages seen while sizing. */
+    size_t next;      /* Next entry to use while writing. */
+} pb_size_cache_t;
+
 /* Structure for defining custom output streams. You will need to provide
  * a callback function to write the bytes to your storage, which can be
  * for example a file or a network socket.
@@ -44,6 +58,9 @@ struct pb_ostream_s
 #ifndef PB_NO_ERRMSG
     const char *errmsg;
 #endif
+
+    /* Submessage sizes to record or use, see pb_encode_cached(). */
+    pb_size_cache_t *size_cache;
 };
 
 /***************************
@@ -81,6 +98,20 @@ bool pb_encode_nullterminated(pb_ostream_t *stream, const pb_field_t fields[], c
  * the data. */
 bool pb_get_encoded_size(size_t *size, const pb_field_t fields[], const void *src_struct);
 
+/* Same as pb_get_encoded_size, but also records the size of every
+ * submessage in cache. If cache->count ends up larger than cache->capacity,
+ * the storage was too small; it can be grown and the sizing done again.
+ */
+bool pb_get_encoded_size_cached(size_t *size, const pb_field_t fields[], const void *src_struct, pb_size_cache_t *cache);
+
+/* Same as pb_encode, but takes submessage sizes from a cache filled in by
+ * pb_get_encoded_size_cached() for the same message. Plain pb_encode sizes
+ * each submessage before writing it, which for nested messages repeats the
+ * work once per level of nesting; with the cache every submessage is sized
+ * once.
+ */
+bool pb_encode_cached(pb_ostream_t *stream, const pb_field_t fields[], const void *src_struct, pb_size_cache_t *cache);
+
 /**************************************
  * Functions for manipulating streams *
  **************************************/
@@ -104,9 +135,9 @@ pb_ostream_t pb_ostream_from_buffer(pb_byte_t *buf, size_t bufsize);
  *    printf("Message size is %d\n", stream.bytes_written);
  */
 #ifndef PB_NO_ERRMSG
-#define PB_OSTREAM_SIZING {0,0,0,0,0}
+#define PB_OSTREAM_SIZING {0,0,0,0,0,0}
 #else
-#define PB_OSTREAM_SIZING {0,0,0,0}
+#define PB_OSTREAM_SIZING {0,0,0,0,0}
 #endif
 
 /* Function to write into a pb_ostream_t stream. You can use this if you need